@@ -204,6 +204,15 @@ struct dtCrowdAgentDebugInfo
 /// Type for the update callback.
 typedef void (*dtUpdateCallback)(bool positionUpdate, dtCrowdAgent* agent, float* pos, float dt);
 
+// Urho3D: Add parallel update support
+/// Type for the job executed over a range of agents by the parallel update callback.
+typedef void (*dtParallelJob)(void* data, int begin, int end, int threadIndex);
+
+/// Type for the parallel update callback. Must execute @p job over the range [0, count), possibly split
+/// into several ranges processed concurrently, and return only when all of them are complete.
+/// The thread index passed to the job must be less than the thread count given to dtCrowd::setParallelFor().
+typedef void (*dtParallelForCallback)(void* userData, int count, dtParallelJob job, void* data);
+
 /// Provides local steering behaviors for a group of agents. 
 /// @ingroup crowd
 class dtCrowd
@@ -234,6 +243,17 @@ class dtCrowd
 
 	dtNavMeshQuery* m_navquery;
 
+	// Urho3D: Add parallel update support
+	dtParallelForCallback m_parallelFor;
+	void* m_parallelForUserData;
+	int m_maxThreads;
+	dtNavMeshQuery** m_threadNavQueries;
+	dtObstacleAvoidanceQuery** m_threadObstacleQueries;
+	int* m_threadVelocitySampleCounts;
+
+	template <class Job> void parallelFor(const int count, Job& job);
+	void purgeThreads();
+
 	void updateTopologyOptimization(dtCrowdAgent** agents, const int nagents, const float dt);
 	void updateMoveRequest(const float dt);
 	void checkPathValidity(dtCrowdAgent** agents, const int nagents, const float dt);
@@ -256,6 +276,15 @@ public:
 	///  @param[in]		cb				The update callback.
 	/// @return True if the initialization succeeded.
 	bool init(const int maxAgents, const float maxAgentRadius, dtNavMesh* nav, dtUpdateCallback cb = 0);
+
+	// Urho3D: Add parallel update support
+	/// Enables parallel execution of the per-agent update stages. Must be called after #init().
+	/// The update callback is invoked concurrently for velocity updates, but always serially for position updates.
+	///  @param[in]		cb				The parallel update callback, or null to update serially.
+	///  @param[in]		userData		Opaque pointer passed to the parallel update callback.
+	///  @param[in]		maxThreads		The maximum number of threads the callback may use. [Limit: >= 1]
+	/// @return True if the per-thread query objects were successfully allocated.
+	bool setParallelFor(dtParallelForCallback cb, void* userData, const int maxThreads);
 	
 	/// Sets the shared avoidance configuration for the specified index.
 	///  @param[in]		idx		The index. [Limits: 0 <= value < #DT_CROWD_MAX_OBSTAVOIDANCE_PARAMS]
@@ -343,7 +343,13 @@ dtCrowd::dtCrowd() :
 	m_maxPathResult(0),
 	m_maxAgentRadius(0),
 	m_velocitySampleCount(0),
-	m_navquery(0)
+	m_navquery(0),
+	m_parallelFor(0), // Urho3D: Add parallel update support
+	m_parallelForUserData(0),
+	m_maxThreads(0),
+	m_threadNavQueries(0),
+	m_threadObstacleQueries(0),
+	m_threadVelocitySampleCounts(0)
 {
 	// Urho3D: initialize all class members
 	memset(&m_agentPlacementHalfExtents, 0, sizeof(m_agentPlacementHalfExtents));
@@ -357,6 +363,8 @@ dtCrowd::~dtCrowd()
 
 void dtCrowd::purge()
 {
+	purgeThreads(); // Urho3D
+
 	for (int i = 0; i < m_maxAgents; ++i)
 		m_agents[i].~dtCrowdAgent();
 	dtFree(m_agents);
@@ -382,6 +390,85 @@ void dtCrowd::purge()
 	m_navquery = 0;
 }
 
+// Urho3D: Add parallel update support
+void dtCrowd::purgeThreads()
+{
+	// Index 0 refers to the objects shared with the serial update.
+	for (int i = 1; i < m_maxThreads; ++i)
+	{
+		dtFreeNavMeshQuery(m_threadNavQueries[i]);
+		dtFreeObstacleAvoidanceQuery(m_threadObstacleQueries[i]);
+	}
+	dtFree(m_threadNavQueries);
+	m_threadNavQueries = 0;
+	dtFree(m_threadObstacleQueries);
+	m_threadObstacleQueries = 0;
+	dtFree(m_threadVelocitySampleCounts);
+	m_threadVelocitySampleCounts = 0;
+
+	m_parallelFor = 0;
+	m_parallelForUserData = 0;
+	m_maxThreads = 0;
+}
+
+/// @par
+///
+/// Each thread gets its own navmesh query and obstacle avoidance query, so that the neighbourhood,
+/// velocity planning and corridor movement stages can run concurrently.
+bool dtCrowd::setParallelFor(dtParallelForCallback cb, void* userData, const int maxThreads)
+{
+	purgeThreads();
+
+	if (!cb || maxThreads <= 1 || !m_navquery || !m_obstacleQuery)
+		return true;
+
+	m_threadNavQueries = (dtNavMeshQuery**)dtAlloc(sizeof(dtNavMeshQuery*)*maxThreads, DT_ALLOC_PERM);
+	m_threadObstacleQueries = (dtObstacleAvoidanceQuery**)dtAlloc(sizeof(dtObstacleAvoidanceQuery*)*maxThreads, DT_ALLOC_PERM);
+	m_threadVelocitySampleCounts = (int*)dtAlloc(sizeof(int)*maxThreads, DT_ALLOC_PERM);
+	if (!m_threadNavQueries || !m_threadObstacleQueries || !m_threadVelocitySampleCounts)
+	{
+		purgeThreads();
+		return false;
+	}
+	memset(m_threadNavQueries, 0, sizeof(dtNavMeshQuery*)*maxThreads);
+	memset(m_threadObstacleQueries, 0, sizeof(dtObstacleAvoidanceQuery*)*maxThreads);
+	m_maxThreads = maxThreads;
+
+	m_threadNavQueries[0] = m_navquery;
+	m_threadObstacleQueries[0] = m_obstacleQuery;
+	for (int i = 1; i < maxThreads; ++i)
+	{
+		m_threadNavQueries[i] = dtAllocNavMeshQuery();
+		m_threadObstacleQueries[i] = dtAllocObstacleAvoidanceQuery();
+		if (!m_threadNavQueries[i] || !m_threadObstacleQueries[i] ||
+			dtStatusFailed(m_threadNavQueries[i]->init(m_navquery->getAttachedNavMesh(), MAX_COMMON_NODES)) ||
+			!m_threadObstacleQueries[i]->init(6, 8))
+		{
+			purgeThreads();
+			return false;
+		}
+	}
+
+	m_parallelFor = cb;
+	m_parallelForUserData = userData;
+	return true;
+}
+
+template <class Job>
+static void invokeParallelJob(void* data, int begin, int end, int threadIndex)
+{
+	(*static_cast<Job*>(data))(begin, end, threadIndex);
+}
+
+template <class Job>
+void dtCrowd::parallelFor(const int count, Job& job)
+{
+	if (m_parallelFor && count > 1)
+		m_parallelFor(m_parallelForUserData, count, &invokeParallelJob<Job>, &job);
+	else if (count > 0)
+		job(0, count, 0);
+}
+
 // Urho3D: Add update callback support
 /// @par
 ///
@@ -1083,68 +1170,69 @@ void dtCrowd::update(const float dt, dtCrowdAgentDebugInfo* debug)
 		m_grid->addItem((unsigned short)i, p[0]-r, p[2]-r, p[0]+r, p[2]+r);
 	}
 	
-	// Get nearby navmesh segments and agents to collide with.
-	for (int i = 0; i < nagents; ++i)
-	{
-		dtCrowdAgent* ag = agents[i];
-		if (ag->state != DT_CROWDAGENT_STATE_WALKING)
-			continue;
-
-		// Update the collision boundary after certain distance has been passed or
-		// if it has become invalid.
-		const float updateThr = ag->params.collisionQueryRange*0.25f;
-		if (dtVdist2DSqr(ag->npos, ag->boundary.getCenter()) > dtSqr(updateThr) ||
-			!ag->boundary.isValid(m_navquery, &m_filters[ag->params.queryFilterType]))
-		{
-			ag->boundary.update(ag->corridor.getFirstPoly(), ag->npos, ag->params.collisionQueryRange,
-								m_navquery, &m_filters[ag->params.queryFilterType]);
-		}
-		// Query neighbour agents
-		ag->nneis = getNeighbours(ag->npos, ag->params.height, ag->params.collisionQueryRange,
-								  ag, ag->neis, DT_CROWDAGENT_MAX_NEIGHBOURS,
-								  agents, nagents, m_grid);
-		for (int j = 0; j < ag->nneis; j++)
-			ag->neis[j].idx = getAgentIndex(agents[ag->neis[j].idx]);
-	}
+	// Urho3D: The per-agent stages below only modify the agent being processed and are executed in parallel
+	// when a parallel update callback is set. Each thread uses its own navmesh and obstacle avoidance query.
+	const bool parallel = m_parallelFor != 0;
 	
-	// Find next corner to steer to.
-	for (int i = 0; i < nagents; ++i)
+	// Get nearby navmesh segments and agents to collide with, and find next corner to steer to.
+	auto updateNeighboursAndCorners = [&](int begin, int end, int threadIndex)
 	{
-		dtCrowdAgent* ag = agents[i];
-		
-		if (ag->state != DT_CROWDAGENT_STATE_WALKING)
-			continue;
-		if (ag->targetState == DT_CROWDAGENT_TARGET_NONE || ag->targetState == DT_CROWDAGENT_TARGET_VELOCITY)
-			continue;
-		
-		// Find corners for steering
-		ag->ncorners = ag->corridor.findCorners(ag->cornerVerts, ag->cornerFlags, ag->cornerPolys,
-												DT_CROWDAGENT_MAX_CORNERS, m_navquery, &m_filters[ag->params.queryFilterType]);
-		
-		// Check to see if the corner after the next corner is directly visible,
-		// and short cut to there.
-		if ((ag->params.updateFlags & DT_CROWD_OPTIMIZE_VIS) && ag->ncorners > 0)
+		dtNavMeshQuery* navquery = parallel ? m_threadNavQueries[threadIndex] : m_navquery;
+		for (int i = begin; i < end; ++i)
 		{
-			const float* target = &ag->cornerVerts[dtMin(1,ag->ncorners-1)*3];
-			ag->corridor.optimizePathVisibility(target, ag->params.pathOptimizationRange, m_navquery, &m_filters[ag->params.queryFilterType]);
+			dtCrowdAgent* ag = agents[i];
+			if (ag->state != DT_CROWDAGENT_STATE_WALKING)
+				continue;
+
+			// Update the collision boundary after certain distance has been passed or
+			// if it has become invalid.
+			const float updateThr = ag->params.collisionQueryRange*0.25f;
+			if (dtVdist2DSqr(ag->npos, ag->boundary.getCenter()) > dtSqr(updateThr) ||
+				!ag->boundary.isValid(navquery, &m_filters[ag->params.queryFilterType]))
+			{
+				ag->boundary.update(ag->corridor.getFirstPoly(), ag->npos, ag->params.collisionQueryRange,
+									navquery, &m_filters[ag->params.queryFilterType]);
+			}
+			// Query neighbour agents
+			ag->nneis = getNeighbours(ag->npos, ag->params.height, ag->params.collisionQueryRange,
+									  ag, ag->neis, DT_CROWDAGENT_MAX_NEIGHBOURS,
+									  agents, nagents, m_grid);
+			for (int j = 0; j < ag->nneis; j++)
+				ag->neis[j].idx = getAgentIndex(agents[ag->neis[j].idx]);
+
+			if (ag->targetState == DT_CROWDAGENT_TARGET_NONE || ag->targetState == DT_CROWDAGENT_TARGET_VELOCITY)
+				continue;
 			
-			// Copy data for debug purposes.
-			if (debugIdx == i)
+			// Find corners for steering
+			ag->ncorners = ag->corridor.findCorners(ag->cornerVerts, ag->cornerFlags, ag->cornerPolys,
+													DT_CROWDAGENT_MAX_CORNERS, navquery, &m_filters[ag->params.queryFilterType]);
+			
+			// Check to see if the corner after the next corner is directly visible,
+			// and short cut to there.
+			if ((ag->params.updateFlags & DT_CROWD_OPTIMIZE_VIS) && ag->ncorners > 0)
 			{
-				dtVcopy(debug->optStart, ag->corridor.getPos());
-				dtVcopy(debug->optEnd, target);
+				const float* target = &ag->cornerVerts[dtMin(1,ag->ncorners-1)*3];
+				ag->corridor.optimizePathVisibility(target, ag->params.pathOptimizationRange, navquery, &m_filters[ag->params.queryFilterType]);
+				
+				// Copy data for debug purposes.
+				if (debugIdx == i)
+				{
+					dtVcopy(debug->optStart, ag->corridor.getPos());
+					dtVcopy(debug->optEnd, target);
+				}
 			}
-		}
-		else
-		{
-			// Copy data for debug purposes.
-			if (debugIdx == i)
+			else
 			{
-				dtVset(debug->optStart, 0,0,0);
-				dtVset(debug->optEnd, 0,0,0);
+				// Copy data for debug purposes.
+				if (debugIdx == i)
+				{
+					dtVset(debug->optStart, 0,0,0);
+					dtVset(debug->optEnd, 0,0,0);
+				}
 			}
 		}
-	}
+	};
+	parallelFor(nagents, updateNeighboursAndCorners);
 	
 	// Trigger off-mesh connections (depends on corners).
 	for (int i = 0; i < nagents; ++i)
@@ -1188,169 +1276,195 @@ void dtCrowd::update(const float dt, dtCrowdAgentDebugInfo* debug)
 	}
 		
 	// Calculate steering.
-	for (int i = 0; i < nagents; ++i)
+	auto updateSteering = [&](int begin, int end, int /*threadIndex*/)
 	{
-		dtCrowdAgent* ag = agents[i];
+		for (int i = begin; i < end; ++i)
+		{
+			dtCrowdAgent* ag = agents[i];
 
-		if (ag->state != DT_CROWDAGENT_STATE_WALKING)
-			continue;
-		if (ag->targetState == DT_CROWDAGENT_TARGET_NONE)
-			continue;
+			if (ag->state != DT_CROWDAGENT_STATE_WALKING)
+				continue;
+			if (ag->targetState == DT_CROWDAGENT_TARGET_NONE)
+				continue;
 		
-		float dvel[3] = {0,0,0};
+			float dvel[3] = {0,0,0};
 
-		if (ag->targetState == DT_CROWDAGENT_TARGET_VELOCITY)
-		{
-			dtVcopy(dvel, ag->targetPos);
-			ag->desiredSpeed = dtVlen(ag->targetPos);
-		}
-		else
-		{
-			// Calculate steering direction.
-			if (ag->params.updateFlags & DT_CROWD_ANTICIPATE_TURNS)
-				calcSmoothSteerDirection(ag, dvel);
+			if (ag->targetState == DT_CROWDAGENT_TARGET_VELOCITY)
+			{
+				dtVcopy(dvel, ag->targetPos);
+				ag->desiredSpeed = dtVlen(ag->targetPos);
+			}
 			else
-				calcStraightSteerDirection(ag, dvel);
+			{
+				// Calculate steering direction.
+				if (ag->params.updateFlags & DT_CROWD_ANTICIPATE_TURNS)
+					calcSmoothSteerDirection(ag, dvel);
+				else
+					calcStraightSteerDirection(ag, dvel);
 			
-			// Calculate speed scale, which tells the agent to slowdown at the end of the path.
-			const float slowDownRadius = ag->params.radius*2;	// TODO: make less hacky.
-			const float speedScale = getDistanceToGoal(ag, slowDownRadius) / slowDownRadius;
+				// Calculate speed scale, which tells the agent to slowdown at the end of the path.
+				const float slowDownRadius = ag->params.radius*2;	// TODO: make less hacky.
+				const float speedScale = getDistanceToGoal(ag, slowDownRadius) / slowDownRadius;
 				
-			ag->desiredSpeed = ag->params.maxSpeed;
-			dtVscale(dvel, dvel, ag->desiredSpeed * speedScale);
-		}
+				ag->desiredSpeed = ag->params.maxSpeed;
+				dtVscale(dvel, dvel, ag->desiredSpeed * speedScale);
+			}
 
-		// Urho3D: Update velocity callback
-		if (m_updateCallback)
-			m_updateCallback(false, ag, dvel, dt);
+			// Urho3D: Update velocity callback
+			if (m_updateCallback)
+				m_updateCallback(false, ag, dvel, dt);
 
-		// Separation
-		if (ag->params.updateFlags & DT_CROWD_SEPARATION)
-		{
-			const float separationDist = ag->params.collisionQueryRange; 
-			const float invSeparationDist = 1.0f / separationDist; 
-			const float separationWeight = ag->params.separationWeight;
+			// Separation
+			if (ag->params.updateFlags & DT_CROWD_SEPARATION)
+			{
+				const float separationDist = ag->params.collisionQueryRange; 
+				const float invSeparationDist = 1.0f / separationDist; 
+				const float separationWeight = ag->params.separationWeight;
 			
-			float w = 0;
-			float disp[3] = {0,0,0};
+				float w = 0;
+				float disp[3] = {0,0,0};
 			
-			for (int j = 0; j < ag->nneis; ++j)
-			{
-				const dtCrowdAgent* nei = &m_agents[ag->neis[j].idx];
+				for (int j = 0; j < ag->nneis; ++j)
+				{
+					const dtCrowdAgent* nei = &m_agents[ag->neis[j].idx];
 				
-				float diff[3];
-				dtVsub(diff, ag->npos, nei->npos);
-				diff[1] = 0;
+					float diff[3];
+					dtVsub(diff, ag->npos, nei->npos);
+					diff[1] = 0;
 				
-				const float distSqr = dtVlenSqr(diff);
-				if (distSqr < 0.00001f)
-					continue;
-				if (distSqr > dtSqr(separationDist))
-					continue;
-				const float dist = dtMathSqrtf(distSqr);
-				const float weight = separationWeight * (1.0f - dtSqr(dist*invSeparationDist));
+					const float distSqr = dtVlenSqr(diff);
+					if (distSqr < 0.00001f)
+						continue;
+					if (distSqr > dtSqr(separationDist))
+						continue;
+					const float dist = dtMathSqrtf(distSqr);
+					const float weight = separationWeight * (1.0f - dtSqr(dist*invSeparationDist));
 				
-				dtVmad(disp, disp, diff, weight/dist);
-				w += 1.0f;
-			}
+					dtVmad(disp, disp, diff, weight/dist);
+					w += 1.0f;
+				}
 			
-			if (w > 0.0001f)
-			{
-				// Adjust desired velocity.
-				dtVmad(dvel, dvel, disp, 1.0f/w);
-				// Clamp desired velocity to desired speed.
-				const float speedSqr = dtVlenSqr(dvel);
-				const float desiredSqr = dtSqr(ag->desiredSpeed);
-				if (speedSqr > desiredSqr)
-					dtVscale(dvel, dvel, desiredSqr/speedSqr);
+				if (w > 0.0001f)
+				{
+					// Adjust desired velocity.
+					dtVmad(dvel, dvel, disp, 1.0f/w);
+					// Clamp desired velocity to desired speed.
+					const float speedSqr = dtVlenSqr(dvel);
+					const float desiredSqr = dtSqr(ag->desiredSpeed);
+					if (speedSqr > desiredSqr)
+						dtVscale(dvel, dvel, desiredSqr/speedSqr);
+				}
 			}
-		}
 		
-		// Set the desired velocity.
-		dtVcopy(ag->dvel, dvel);
-	}
+			// Set the desired velocity.
+			dtVcopy(ag->dvel, dvel);
+		}
+	};
+	parallelFor(nagents, updateSteering);
 
 	// Velocity planning.
-	for (int i = 0; i < nagents; ++i)
+	auto updateVelocityPlanning = [&](int begin, int end, int threadIndex)
 	{
-		dtCrowdAgent* ag = agents[i];
+		dtObstacleAvoidanceQuery* obstacleQuery = parallel ? m_threadObstacleQueries[threadIndex] : m_obstacleQuery;
+		int velocitySampleCount = 0;
+		for (int i = begin; i < end; ++i)
+		{
+			dtCrowdAgent* ag = agents[i];
 		
-		if (ag->state != DT_CROWDAGENT_STATE_WALKING)
-			continue;
+			if (ag->state != DT_CROWDAGENT_STATE_WALKING)
+				continue;
 		
-		if (ag->params.updateFlags & DT_CROWD_OBSTACLE_AVOIDANCE)
-		{
-			m_obstacleQuery->reset();
-			
-			// Add neighbours as obstacles.
-			for (int j = 0; j < ag->nneis; ++j)
+			if (ag->params.updateFlags & DT_CROWD_OBSTACLE_AVOIDANCE)
 			{
-				const dtCrowdAgent* nei = &m_agents[ag->neis[j].idx];
-				m_obstacleQuery->addCircle(nei->npos, nei->params.radius, nei->vel, nei->dvel);
-			}
+				obstacleQuery->reset();
+			
+				// Add neighbours as obstacles.
+				for (int j = 0; j < ag->nneis; ++j)
+				{
+					const dtCrowdAgent* nei = &m_agents[ag->neis[j].idx];
+					obstacleQuery->addCircle(nei->npos, nei->params.radius, nei->vel, nei->dvel);
+				}
 
-			// Append neighbour segments as obstacles.
-			for (int j = 0; j < ag->boundary.getSegmentCount(); ++j)
-			{
-				const float* s = ag->boundary.getSegment(j);
-				if (dtTriArea2D(ag->npos, s, s+3) < 0.0f)
-					continue;
-				m_obstacleQuery->addSegment(s, s+3);
-			}
+				// Append neighbour segments as obstacles.
+				for (int j = 0; j < ag->boundary.getSegmentCount(); ++j)
+				{
+					const float* s = ag->boundary.getSegment(j);
+					if (dtTriArea2D(ag->npos, s, s+3) < 0.0f)
+						continue;
+					obstacleQuery->addSegment(s, s+3);
+				}
 
-			dtObstacleAvoidanceDebugData* vod = 0;
-			if (debugIdx == i) 
-				vod = debug->vod;
+				dtObstacleAvoidanceDebugData* vod = 0;
+				if (debugIdx == i) 
+					vod = debug->vod;
 			
-			// Sample new safe velocity.
-			bool adaptive = true;
-			int ns = 0;
+				// Sample new safe velocity.
+				bool adaptive = true;
+				int ns = 0;
 
-			const dtObstacleAvoidanceParams* params = &m_obstacleQueryParams[ag->params.obstacleAvoidanceType];
+				const dtObstacleAvoidanceParams* params = &m_obstacleQueryParams[ag->params.obstacleAvoidanceType];
 				
-			if (adaptive)
-			{
-				ns = m_obstacleQuery->sampleVelocityAdaptive(ag->npos, ag->params.radius, ag->desiredSpeed,
-															 ag->vel, ag->dvel, ag->nvel, params, vod);
+				if (adaptive)
+				{
+					ns = obstacleQuery->sampleVelocityAdaptive(ag->npos, ag->params.radius, ag->desiredSpeed,
+															   ag->vel, ag->dvel, ag->nvel, params, vod);
+				}
+				else
+				{
+					ns = obstacleQuery->sampleVelocityGrid(ag->npos, ag->params.radius, ag->desiredSpeed,
+														   ag->vel, ag->dvel, ag->nvel, params, vod);
+				}
+				velocitySampleCount += ns;
 			}
 			else
 			{
-				ns = m_obstacleQuery->sampleVelocityGrid(ag->npos, ag->params.radius, ag->desiredSpeed,
-														 ag->vel, ag->dvel, ag->nvel, params, vod);
+				// If not using velocity planning, new velocity is directly the desired velocity.
+				dtVcopy(ag->nvel, ag->dvel);
 			}
-			m_velocitySampleCount += ns;
 		}
+		if (parallel)
+			m_threadVelocitySampleCounts[threadIndex] += velocitySampleCount;
 		else
-		{
-			// If not using velocity planning, new velocity is directly the desired velocity.
-			dtVcopy(ag->nvel, ag->dvel);
-		}
+			m_velocitySampleCount += velocitySampleCount;
+	};
+	if (parallel)
+		memset(m_threadVelocitySampleCounts, 0, sizeof(int)*m_maxThreads);
+	parallelFor(nagents, updateVelocityPlanning);
+	if (parallel)
+	{
+		for (int i = 0; i < m_maxThreads; ++i)
+			m_velocitySampleCount += m_threadVelocitySampleCounts[i];
 	}
 
 	// Integrate.
-	for (int i = 0; i < nagents; ++i)
+	auto updateIntegration = [&](int begin, int end, int /*threadIndex*/)
 	{
-		dtCrowdAgent* ag = agents[i];
-		if (ag->state != DT_CROWDAGENT_STATE_WALKING)
-			continue;
-		integrate(ag, dt);
-	}
-	
+		for (int i = begin; i < end; ++i)
+		{
+			dtCrowdAgent* ag = agents[i];
+			if (ag->state != DT_CROWDAGENT_STATE_WALKING)
+				continue;
+			integrate(ag, dt);
+		}
+	};
+	parallelFor(nagents, updateIntegration);
+
 	// Handle collisions.
 	static const float COLLISION_RESOLVE_FACTOR = 0.7f;
 	
-	for (int iter = 0; iter < 4; ++iter)
+	// Urho3D: Collision displacements only read the positions of the neighbours and are computed in parallel
+	auto updateCollisionDisplacement = [&](int begin, int end, int /*threadIndex*/)
 	{
-		for (int i = 0; i < nagents; ++i)
+		for (int i = begin; i < end; ++i)
 		{
 			dtCrowdAgent* ag = agents[i];
 			const int idx0 = getAgentIndex(ag);
-			
+		
 			if (ag->state != DT_CROWDAGENT_STATE_WALKING)
 				continue;
 
 			dtVset(ag->disp, 0,0,0);
-			
+		
 			float w = 0;
 
 			for (int j = 0; j < ag->nneis; ++j)
@@ -1361,7 +1475,7 @@ void dtCrowd::update(const float dt, dtCrowdAgentDebugInfo* debug)
 				float diff[3];
 				dtVsub(diff, ag->npos, nei->npos);
 				diff[1] = 0;
-				
+			
 				float dist = dtVlenSqr(diff);
 				if (dist > dtSqr(ag->params.radius + nei->params.radius))
 					continue;
@@ -1380,23 +1494,28 @@ void dtCrowd::update(const float dt, dtCrowdAgentDebugInfo* debug)
 				{
 					pen = (1.0f/dist) * (pen*0.5f) * COLLISION_RESOLVE_FACTOR;
 				}
-				
+			
 				// Urho3D: Avoid tremble when another agent can not move away
 				if (ag->params.separationWeight < 0.0001f) 
 					continue;
-				
+			
 				dtVmad(ag->disp, ag->disp, diff, pen);			
-				
+			
 				w += 1.0f;
 			}
-			
+		
 			if (w > 0.0001f)
 			{
 				const float iw = 1.0f / w;
 				dtVscale(ag->disp, ag->disp, iw);
 			}
 		}
-		
+	};
+
+	for (int iter = 0; iter < 4; ++iter)
+	{
+		parallelFor(nagents, updateCollisionDisplacement);
+
 		for (int i = 0; i < nagents; ++i)
 		{
 			dtCrowdAgent* ag = agents[i];
@@ -1407,27 +1526,40 @@ void dtCrowd::update(const float dt, dtCrowdAgentDebugInfo* debug)
 		}
 	}
 	
-	for (int i = 0; i < nagents; ++i)
+	auto updateMovement = [&](int begin, int end, int threadIndex)
 	{
-		dtCrowdAgent* ag = agents[i];
-		if (ag->state != DT_CROWDAGENT_STATE_WALKING)
-			continue;
-		
-		// Move along navmesh.
-		ag->corridor.movePosition(ag->npos, m_navquery, &m_filters[ag->params.queryFilterType]);
-		// Get valid constrained position back.
-		dtVcopy(ag->npos, ag->corridor.getPos());
-
-		// If not using path, truncate the corridor to just one poly.
-		if (ag->targetState == DT_CROWDAGENT_TARGET_NONE || ag->targetState == DT_CROWDAGENT_TARGET_VELOCITY)
+		dtNavMeshQuery* navquery = parallel ? m_threadNavQueries[threadIndex] : m_navquery;
+		for (int i = begin; i < end; ++i)
 		{
-			ag->corridor.reset(ag->corridor.getFirstPoly(), ag->npos);
-			ag->partial = false;
+			dtCrowdAgent* ag = agents[i];
+			if (ag->state != DT_CROWDAGENT_STATE_WALKING)
+				continue;
+			
+			// Move along navmesh.
+			ag->corridor.movePosition(ag->npos, navquery, &m_filters[ag->params.queryFilterType]);
+			// Get valid constrained position back.
+			dtVcopy(ag->npos, ag->corridor.getPos());
+
+			// If not using path, truncate the corridor to just one poly.
+			if (ag->targetState == DT_CROWDAGENT_TARGET_NONE || ag->targetState == DT_CROWDAGENT_TARGET_VELOCITY)
+			{
+				ag->corridor.reset(ag->corridor.getFirstPoly(), ag->npos);
+				ag->partial = false;
+			}
 		}
+	};
+	parallelFor(nagents, updateMovement);
 
-		// Urho3D: Update position callback support
-		if (m_updateCallback)
+	// Urho3D: Update position callback support. Always serial, as it moves scene nodes.
+	if (m_updateCallback)
+	{
+		for (int i = 0; i < nagents; ++i)
+		{
+			dtCrowdAgent* ag = agents[i];
+			if (ag->state != DT_CROWDAGENT_STATE_WALKING)
+				continue;
 			m_updateCallback(true, ag, ag->npos, dt);
+		}
 	}
 
 	// Update agents using off-mesh connection.
@@ -232,6 +232,10 @@ void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
     int global_idx_offset = 0;
     int global_vtx_offset = 0;
     ImVec2 clip_off = draw_data->DisplayPos;
+    // Skip redundant texture and scissor changes between commands
+    ID3D11ShaderResourceView* last_texture_srv = NULL;
+    D3D11_RECT last_rect = { -1, -1, -1, -1 };
+    bool cmd_state_valid = false;
     for (int n = 0; n < draw_data->CmdListsCount; n++)
     {
         const ImDrawList* cmd_list = draw_data->CmdLists[n];
@@ -246,16 +250,26 @@ void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
                     ImGui_ImplDX11_SetupRenderState(draw_data, ctx);
                 else
                     pcmd->UserCallback(cmd_list, pcmd);
+                cmd_state_valid = false;
             }
             else
             {
                 // Apply scissor/clipping rectangle
                 const D3D11_RECT r = { (LONG)(pcmd->ClipRect.x - clip_off.x), (LONG)(pcmd->ClipRect.y - clip_off.y), (LONG)(pcmd->ClipRect.z - clip_off.x), (LONG)(pcmd->ClipRect.w - clip_off.y) };
-                ctx->RSSetScissorRects(1, &r);
+                if (!cmd_state_valid || r.left != last_rect.left || r.top != last_rect.top || r.right != last_rect.right || r.bottom != last_rect.bottom)
+                {
+                    ctx->RSSetScissorRects(1, &r);
+                    last_rect = r;
+                }
 
                 // Bind texture, Draw
                 ID3D11ShaderResourceView* texture_srv = (ID3D11ShaderResourceView*)pcmd->TextureId;
-                ctx->PSSetShaderResources(0, 1, &texture_srv);
+                if (!cmd_state_valid || texture_srv != last_texture_srv)
+                {
+                    ctx->PSSetShaderResources(0, 1, &texture_srv);
+                    last_texture_srv = texture_srv;
+                }
+                cmd_state_valid = true;
                 ctx->DrawIndexed(pcmd->ElemCount, pcmd->IdxOffset + global_idx_offset, pcmd->VtxOffset + global_vtx_offset);
             }
         }
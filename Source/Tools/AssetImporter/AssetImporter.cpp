@@ -32,6 +32,7 @@
 #include <Urho3D/Graphics/IndexBuffer.h>
 #include <Urho3D/Graphics/Light.h>
 #include <Urho3D/Graphics/Material.h>
+#include <Urho3D/Graphics/MeshOptimizer.h>
 #include <Urho3D/Graphics/Octree.h>
 #include <Urho3D/Graphics/VertexBuffer.h>
 #include <Urho3D/Graphics/Zone.h>
@@ -176,6 +177,11 @@ float defaultTicksPerSecond_ = 4800.0f;
 float importStartTime_ = 0.0f;
 float importEndTime_ = 0.0f;
 bool suppressFbxPivotNodes_ = true;
+bool compressAnimations_ = false;
+float animationPositionError_ = DEFAULT_ANIMATION_POSITION_ERROR;
+float animationRotationError_ = DEFAULT_ANIMATION_ROTATION_ERROR;
+bool optimizeMeshes_ = false;
+MeshOptimizationSettings meshOptimizationSettings_;
 
 int main(int argc, char** argv);
 void Run(const ea::vector<ea::string>& arguments);
@@ -308,6 +314,19 @@ void Run(const ea::vector<ea::string>& arguments)
             "-split <start> <end> (animation model only)\n"
             "            Split animation, will only import from start frame to end frame\n"
             "-np         Do not suppress $fbx pivot nodes (FBX files only)\n"
+            "-ac [<position error> <rotation error>]\n"
+            "            Compress animations by removing keyframes that interpolation\n"
+            "            reproduces within the error. Rotation error is in degrees.\n"
+            "            Default 0.0005 and 0.05\n"
+            "-mo         Optimize meshes for vertex cache, overdraw and vertex fetch\n"
+            "-mq         Optimize meshes and store normals, tangents and texture\n"
+            "            coordinates in compact formats\n"
+            "-lods <n> [<reduction>]\n"
+            "            Optimize meshes and generate up to n simplified LOD levels, each\n"
+            "            keeping the given ratio of triangles of the previous one.\n"
+            "            Default reduction 0.5\n"
+            "-mc         Optimize meshes and split them into clusters for per-cluster\n"
+            "            culling\n"
         );
     }
 
@@ -463,6 +482,17 @@ void Run(const ea::vector<ea::string>& arguments)
                 checkUniqueModel_ = false;
             else if (argument == "bp")
                 moveToBindPose_ = true;
+            else if (argument == "ac")
+            {
+                compressAnimations_ = true;
+                ea::string value2 = i + 2 < arguments.size() ? arguments[i + 2] : EMPTY_STRING;
+                if (value.length() && value2.length() && (value[0] != '-') && (value2[0] != '-'))
+                {
+                    animationPositionError_ = ToFloat(value);
+                    animationRotationError_ = ToFloat(value2);
+                    i += 2;
+                }
+            }
             else if (argument == "split")
             {
                 ea::string value2 = i + 2 < arguments.size() ? arguments[i + 2] : EMPTY_STRING;
@@ -472,6 +502,30 @@ void Run(const ea::vector<ea::string>& arguments)
                     importEndTime_ = ToFloat(value2);
                 }
             }
+            else if (argument == "mo")
+                optimizeMeshes_ = true;
+            else if (argument == "mq")
+            {
+                optimizeMeshes_ = true;
+                meshOptimizationSettings_.quantizeVertices_ = true;
+            }
+            else if (argument == "mc")
+            {
+                optimizeMeshes_ = true;
+                meshOptimizationSettings_.generateClusters_ = true;
+            }
+            else if (argument == "lods" && !value.empty())
+            {
+                optimizeMeshes_ = true;
+                meshOptimizationSettings_.numLodLevels_ = ToUInt(value);
+                ++i;
+                ea::string value2 = i + 1 < arguments.size() ? arguments[i + 1] : EMPTY_STRING;
+                if (value2.length() && value2[0] != '-')
+                {
+                    meshOptimizationSettings_.lodReduction_ = Clamp(ToFloat(value2), 0.05f, 0.95f);
+                    ++i;
+                }
+            }
         }
     }
 
@@ -1227,6 +1281,12 @@ void BuildAndSaveModel(OutModel& model)
             outModel->SetGeometryBoneMappings(allBoneMappings);
     }
 
+    if (optimizeMeshes_)
+    {
+        PrintLine("Optimizing meshes");
+        OptimizeModel(outModel, meshOptimizationSettings_);
+    }
+
     File outFile(context_);
     if (!outFile.Open(model.outName_, FILE_WRITE))
         ErrorExit("Could not open output file " + model.outName_);
@@ -1496,6 +1556,13 @@ void BuildAndSaveAnimations(OutModel* model)
             }
         }
 
+        if (compressAnimations_)
+        {
+            const unsigned numRemoved = outAnim->RemoveRedundantKeyFrames(animationPositionError_, animationRotationError_,
+                animationPositionError_);
+            PrintLine("Removed " + ea::to_string(numRemoved) + " redundant keyframes from animation " + animName);
+        }
+
         File outFile(context_);
         if (!outFile.Open(animOutName, FILE_WRITE))
             ErrorExit("Could not open output file " + animOutName);
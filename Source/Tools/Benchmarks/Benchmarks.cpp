@@ -0,0 +1,421 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+// Command line utility always uses console.
+#define URHO3D_WIN32_CONSOLE
+
+#include <Urho3D/Core/CommandLine.h>
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/Engine/Application.h>
+#include <Urho3D/Engine/Engine.h>
+#include <Urho3D/Engine/EngineDefs.h>
+#include <Urho3D/Graphics/Octree.h>
+#include <Urho3D/Graphics/OctreeQuery.h>
+#include <Urho3D/Graphics/Zone.h>
+#include <Urho3D/IO/BinaryArchive.h>
+#include <Urho3D/IO/Log.h>
+#include <Urho3D/IO/MemoryBuffer.h>
+#include <Urho3D/IO/VectorBuffer.h>
+#include <Urho3D/Math/Random.h>
+#include <Urho3D/Resource/JSONArchive.h>
+#include <Urho3D/Resource/JSONFile.h>
+#include <Urho3D/Resource/XMLFile.h>
+#include <Urho3D/Scene/Scene.h>
+#ifdef URHO3D_PHYSICS
+#include <Urho3D/Physics/CollisionShape.h>
+#include <Urho3D/Physics/PhysicsWorld.h>
+#include <Urho3D/Physics/RigidBody.h>
+#endif
+
+#include <EASTL/sort.h>
+
+#include <functional>
+
+using namespace Urho3D;
+
+URHO3D_EVENT(E_BENCHMARKEVENT, BenchmarkEvent)
+{
+    URHO3D_PARAM(P_VALUE, Value);
+    URHO3D_PARAM(P_NAME, Name);
+}
+
+namespace
+{
+
+/// Benchmark body, called repeatedly. Returns number of operations done by one call.
+using BenchmarkBody = std::function<unsigned()>;
+
+/// Benchmark description. Setup creates the data set and returns the body.
+struct BenchmarkDesc
+{
+    ea::string name_;
+    std::function<BenchmarkBody(Context* context)> setup_;
+};
+
+/// Benchmark result.
+struct BenchmarkResult
+{
+    ea::string name_;
+    unsigned long long operations_{};
+    unsigned long long totalUSec_{};
+    /// Average and minimum time of one operation over repeats.
+    double meanNSec_{};
+    double minNSec_{};
+};
+
+/// Fixed seed so that every run works on the same data.
+static const unsigned BENCHMARK_SEED = 12345;
+
+/// Create scene with an octree of randomly placed zones. Zones are the simplest drawables with arbitrary bounds.
+SharedPtr<Scene> CreateOctreeScene(Context* context, unsigned count)
+{
+    SetRandomSeed(BENCHMARK_SEED);
+    auto scene = MakeShared<Scene>(context);
+    auto* octree = scene->CreateComponent<Octree>();
+    octree->SetSize(BoundingBox(-1000.0f, 1000.0f), 8);
+    for (unsigned i = 0; i < count; ++i)
+    {
+        Node* node = scene->CreateChild();
+        node->SetPosition(Vector3(Random(-900.0f, 900.0f), Random(-50.0f, 50.0f), Random(-900.0f, 900.0f)));
+        auto* zone = node->CreateComponent<Zone>();
+        zone->SetBoundingBox(BoundingBox(-Vector3::ONE * Random(0.5f, 5.0f), Vector3::ONE * Random(0.5f, 5.0f)));
+    }
+
+    FrameInfo frame{};
+    frame.frameNumber_ = 1;
+    octree->Update(frame);
+    return scene;
+}
+
+/// Create scene with node hierarchy of given depth and branching factor.
+SharedPtr<Scene> CreateHierarchyScene(Context* context, unsigned depth, unsigned branching, ea::vector<Node*>& leaves)
+{
+    SetRandomSeed(BENCHMARK_SEED);
+    auto scene = MakeShared<Scene>(context);
+    ea::vector<Node*> level{scene->CreateChild("Root")};
+    for (unsigned i = 0; i < depth; ++i)
+    {
+        ea::vector<Node*> nextLevel;
+        for (Node* parent : level)
+        {
+            for (unsigned j = 0; j < branching; ++j)
+            {
+                Node* child = parent->CreateChild();
+                child->SetPosition(Vector3(Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f)));
+                child->SetRotation(Quaternion(Random(360.0f), Vector3::UP));
+                nextLevel.push_back(child);
+            }
+        }
+        level = ea::move(nextLevel);
+    }
+    leaves = level;
+    return scene;
+}
+
+/// Create scene with plain nodes carrying attributes and variables, for serialization benchmarks.
+SharedPtr<Scene> CreateSerializationScene(Context* context, unsigned count)
+{
+    SetRandomSeed(BENCHMARK_SEED);
+    auto scene = MakeShared<Scene>(context);
+    scene->CreateComponent<Octree>();
+    for (unsigned i = 0; i < count; ++i)
+    {
+        Node* node = scene->CreateChild(Format("Node{}", i));
+        node->SetPosition(Vector3(Random(-100.0f, 100.0f), 0.0f, Random(-100.0f, 100.0f)));
+        node->SetVar("Health", Random(100));
+        node->SetVar("Tag", "Benchmark");
+        auto* zone = node->CreateComponent<Zone>();
+        zone->SetBoundingBox(BoundingBox(-Vector3::ONE, Vector3::ONE));
+    }
+    return scene;
+}
+
+ea::vector<BenchmarkDesc> CreateBenchmarks()
+{
+    ea::vector<BenchmarkDesc> benchmarks;
+
+    benchmarks.push_back({"OctreeSphereQuery", [](Context* context) -> BenchmarkBody
+    {
+        SharedPtr<Scene> scene = CreateOctreeScene(context, 20000);
+        auto result = ea::make_shared<ea::vector<Drawable*>>();
+        return [scene, result]()
+        {
+            auto* octree = scene->GetComponent<Octree>();
+            for (unsigned i = 0; i < 100; ++i)
+            {
+                result->clear();
+                SphereOctreeQuery query(*result, Sphere(Vector3(i * 17.0f - 850.0f, 0.0f, i * 13.0f - 650.0f), 60.0f));
+                octree->GetDrawables(query);
+            }
+            return 100u;
+        };
+    }});
+
+    benchmarks.push_back({"OctreeBoxQuery", [](Context* context) -> BenchmarkBody
+    {
+        SharedPtr<Scene> scene = CreateOctreeScene(context, 20000);
+        auto result = ea::make_shared<ea::vector<Drawable*>>();
+        return [scene, result]()
+        {
+            auto* octree = scene->GetComponent<Octree>();
+            for (unsigned i = 0; i < 100; ++i)
+            {
+                result->clear();
+                const Vector3 center(i * 17.0f - 850.0f, 0.0f, i * 13.0f - 650.0f);
+                BoxOctreeQuery query(*result, BoundingBox(center - Vector3::ONE * 50.0f, center + Vector3::ONE * 50.0f));
+                octree->GetDrawables(query);
+            }
+            return 100u;
+        };
+    }});
+
+    benchmarks.push_back({"EventDispatch", [](Context* context) -> BenchmarkBody
+    {
+        auto sender = MakeShared<Node>(context);
+        auto receiver = MakeShared<Node>(context);
+        auto counter = ea::make_shared<int>(0);
+        receiver->SubscribeToEvent(sender, E_BENCHMARKEVENT, [counter](StringHash, VariantMap& eventData)
+        {
+            *counter += eventData[BenchmarkEvent::P_VALUE].GetInt();
+        });
+        return [sender, receiver, counter]()
+        {
+            for (unsigned i = 0; i < 1000; ++i)
+            {
+                VariantMap& eventData = sender->GetEventDataMap();
+                eventData[BenchmarkEvent::P_VALUE] = 1;
+                eventData[BenchmarkEvent::P_NAME] = "Benchmark";
+                sender->SendEvent(E_BENCHMARKEVENT, eventData);
+            }
+            return 1000u;
+        };
+    }});
+
+    benchmarks.push_back({"NodeTransformUpdate", [](Context* context) -> BenchmarkBody
+    {
+        auto leaves = ea::make_shared<ea::vector<Node*>>();
+        SharedPtr<Scene> scene = CreateHierarchyScene(context, 5, 6, *leaves);
+        auto frame = ea::make_shared<unsigned>(0);
+        return [scene, leaves, frame]()
+        {
+            // Moving the root dirties the whole hierarchy, reading the leaves recalculates it
+            Node* root = scene->GetChild("Root");
+            root->SetPosition(Vector3(static_cast<float>(++*frame % 100), 0.0f, 0.0f));
+            for (Node* leaf : *leaves)
+                leaf->GetWorldTransform();
+            return static_cast<unsigned>(leaves->size());
+        };
+    }});
+
+    benchmarks.push_back({"BinaryArchiveSave", [](Context* context) -> BenchmarkBody
+    {
+        SharedPtr<Scene> scene = CreateSerializationScene(context, 1000);
+        auto buffer = ea::make_shared<VectorBuffer>();
+        return [scene, buffer, context]()
+        {
+            buffer->Clear();
+            BinaryOutputArchive archive(context, *buffer);
+            scene->Serialize(archive);
+            return 1u;
+        };
+    }});
+
+    benchmarks.push_back({"JSONArchiveSave", [](Context* context) -> BenchmarkBody
+    {
+        SharedPtr<Scene> scene = CreateSerializationScene(context, 1000);
+        return [scene, context]()
+        {
+            JSONFile file(context);
+            JSONOutputArchive archive(&file);
+            scene->Serialize(archive);
+            return 1u;
+        };
+    }});
+
+    benchmarks.push_back({"SceneXMLLoad", [](Context* context) -> BenchmarkBody
+    {
+        SharedPtr<Scene> source = CreateSerializationScene(context, 1000);
+        auto data = ea::make_shared<VectorBuffer>();
+        source->SaveXML(*data);
+        auto target = MakeShared<Scene>(context);
+        return [data, target, context]()
+        {
+            // Parse from memory to measure resource decoding without file system noise
+            MemoryBuffer buffer(data->GetData(), data->GetSize());
+            XMLFile file(context);
+            file.Load(buffer);
+            target->LoadXML(file.GetRoot());
+            return 1u;
+        };
+    }});
+
+#ifdef URHO3D_PHYSICS
+    benchmarks.push_back({"PhysicsStep", [](Context* context) -> BenchmarkBody
+    {
+        SetRandomSeed(BENCHMARK_SEED);
+        auto scene = MakeShared<Scene>(context);
+        auto* physicsWorld = scene->CreateComponent<PhysicsWorld>();
+        physicsWorld->SetFps(60);
+        physicsWorld->SetInterpolation(false);
+
+        Node* floorNode = scene->CreateChild("Floor");
+        floorNode->SetScale(Vector3(500.0f, 1.0f, 500.0f));
+        floorNode->CreateComponent<RigidBody>();
+        floorNode->CreateComponent<CollisionShape>()->SetBox(Vector3::ONE);
+
+        // Stacks of boxes that settle and keep colliding
+        for (unsigned i = 0; i < 1000; ++i)
+        {
+            Node* node = scene->CreateChild();
+            node->SetPosition(Vector3((i % 10) * 2.0f - 10.0f, 1.0f + (i / 100) * 1.1f, ((i / 10) % 10) * 2.0f - 10.0f));
+            auto* body = node->CreateComponent<RigidBody>();
+            body->SetMass(1.0f);
+            node->CreateComponent<CollisionShape>()->SetBox(Vector3::ONE);
+        }
+
+        return [scene, physicsWorld]()
+        {
+            physicsWorld->Update(1.0f / 60.0f);
+            return 1u;
+        };
+    }});
+#endif
+
+    return benchmarks;
+}
+
+}
+
+class BenchmarkApplication : public Application
+{
+    URHO3D_OBJECT(BenchmarkApplication, Application);
+public:
+    explicit BenchmarkApplication(Context* context) : Application(context)
+    {
+    }
+
+    void Setup() override
+    {
+        engineParameters_[EP_ENGINE_CLI_PARAMETERS] = false;
+        engineParameters_[EP_SOUND] = false;
+        engineParameters_[EP_HEADLESS] = true;
+        engineParameters_[EP_RESOURCE_PATHS] = "";
+        engineParameters_[EP_LOG_LEVEL] = LOG_WARNING;
+        // Worker threads make the timings depend on scheduling, run everything on the main thread
+        engineParameters_[EP_WORKER_THREADS] = false;
+
+        auto& app = GetCommandLineParser();
+        app.add_option("-f,--filter", filter_, "Run only benchmarks whose name contains this string.");
+        app.add_option("-j,--json", jsonFileName_, "Write results to JSON file.");
+        app.add_option("-r,--repeats", repeats_, "Number of timed repeats for each benchmark.");
+        app.add_option("-t,--min-time", minTime_, "Minimal time in seconds of each repeat.");
+    }
+
+    void Start() override
+    {
+        ea::vector<BenchmarkResult> results;
+        for (const BenchmarkDesc& desc : CreateBenchmarks())
+        {
+            if (!filter_.empty() && !desc.name_.contains(filter_, false))
+                continue;
+            results.push_back(RunBenchmark(desc));
+
+            const BenchmarkResult& result = results.back();
+            PrintLine(Format("{:<24} {:>14.1f} ns/op (min {:.1f}), {} ops", result.name_, result.meanNSec_,
+                result.minNSec_, result.operations_));
+        }
+
+        if (!jsonFileName_.empty())
+            SaveResults(results);
+
+        engine_->Exit();
+    }
+
+private:
+    /// Run one benchmark.
+    BenchmarkResult RunBenchmark(const BenchmarkDesc& desc)
+    {
+        BenchmarkBody body = desc.setup_(context_);
+
+        // Warm caches and lazily created state
+        body();
+
+        BenchmarkResult result;
+        result.name_ = desc.name_;
+        result.minNSec_ = M_LARGE_VALUE;
+
+        const long long minUSec = static_cast<long long>(minTime_ * 1000000.0f);
+        for (unsigned repeat = 0; repeat < Max(repeats_, 1u); ++repeat)
+        {
+            HiresTimer timer;
+            unsigned long long operations = 0;
+            long long elapsed = 0;
+            do
+            {
+                operations += body();
+                elapsed = timer.GetUSec(false);
+            } while (elapsed < minUSec);
+
+            const double nsecPerOperation = elapsed * 1000.0 / operations;
+            result.minNSec_ = Min(result.minNSec_, nsecPerOperation);
+            result.operations_ += operations;
+            result.totalUSec_ += elapsed;
+        }
+        result.meanNSec_ = result.totalUSec_ * 1000.0 / result.operations_;
+        return result;
+    }
+
+    /// Save results in JSON for regression tracking.
+    void SaveResults(const ea::vector<BenchmarkResult>& results)
+    {
+        JSONFile file(context_);
+        JSONValue& root = file.GetRoot();
+        root.Set("platform", GetPlatform());
+        root.Set("cpuFeatures", GetCPUFeaturesString());
+        root.Set("repeats", repeats_);
+
+        JSONValue benchmarks{JSON_ARRAY};
+        for (const BenchmarkResult& result : results)
+        {
+            JSONValue item;
+            item.Set("name", result.name_);
+            item.Set("operations", static_cast<double>(result.operations_));
+            item.Set("totalUSec", static_cast<double>(result.totalUSec_));
+            item.Set("meanNSec", result.meanNSec_);
+            item.Set("minNSec", result.minNSec_);
+            benchmarks.Push(item);
+        }
+        root.Set("benchmarks", benchmarks);
+
+        if (!file.SaveFile(jsonFileName_))
+            PrintLine(Format("Could not write '{}'.", jsonFileName_), true);
+    }
+
+    ea::string filter_;
+    ea::string jsonFileName_;
+    unsigned repeats_{5};
+    float minTime_{0.2f};
+};
+
+URHO3D_DEFINE_APPLICATION_MAIN(BenchmarkApplication);
@@ -58,6 +58,7 @@
 #include "Pipeline/Asset.h"
 #include "Pipeline/Commands/CookScene.h"
 #include "Pipeline/Commands/BuildAssets.h"
+#include "Pipeline/Commands/PrecacheShaders.h"
 #include "Pipeline/Importers/ModelImporter.h"
 #include "Pipeline/Importers/SceneConverter.h"
 #include "Pipeline/Importers/TextureImporter.h"
@@ -221,6 +222,7 @@ void Editor::Setup()
     // Subcommands
     RegisterSubcommand<CookScene>();
     RegisterSubcommand<BuildAssets>();
+    RegisterSubcommand<PrecacheShaders>();
 
     keyBindings_.Bind(ActionType::OpenProject, this, &Editor::OpenOrCreateProject);
     keyBindings_.Bind(ActionType::Exit, this, &Editor::OnExitHotkeyPressed);
@@ -37,6 +37,8 @@ URHO3D_EVENT(E_EDITORRESOURCESAVED, EditorResourceSaved)
 /// Event sent right before reloading user components.
 URHO3D_EVENT(E_EDITORUSERCODERELOADSTART, EditorUserCodeReloadStart)
 {
+    URHO3D_PARAM(P_PARTIAL, Partial);                   // bool, only components of reloaded types need to be saved
+    URHO3D_PARAM(P_TYPES, Types);                       // VariantVector of StringHash, types registered by reloaded plugins
 }
 
 /// Event sent right after reloading user components.
@@ -79,8 +79,8 @@ public:
     const ea::vector<SharedPtr<AssetImporter>>& GetImporters(Flavor* flavor) const;
     ///
     AssetImporter* GetImporter(Flavor* flavor, StringHash type) const;
-    /// Returns true when asset importers of any flavor are being executed in worker threads.
-    bool IsImporting() const { return importing_; }
+    /// Returns true when asset importers of any flavor are queued for execution or being executed in worker threads.
+    bool IsImporting() const { return importing_ > 0; }
 
 protected:
     ///
@@ -100,8 +100,8 @@ protected:
     ContentType contentType_ = CTYPE_BINARY;
     /// Map a flavor to a list of importers that this asset will be executing.
     AssetImporterMap importers_;
-    /// Flag indicating that asset is being imported.
-    std::atomic<bool> importing_{false};
+    /// Number of queued or running import jobs of this asset.
+    std::atomic<unsigned> importing_{0};
     /// Flag indicating that this asset is virtual, and should not be saved.
     bool virtual_ = false;
 
@@ -21,12 +21,15 @@
 //
 
 #include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/WorkQueue.h>
 #include <Urho3D/Engine/EngineDefs.h>
 #include <Urho3D/IO/FileSystem.h>
 #include <Urho3D/IO/Log.h>
 #include <Toolbox/IO/ContentUtilities.h>
 #include <Urho3D/Scene/Scene.h>
 #include <Urho3D/IO/File.h>
+#include <Urho3D/IO/VectorBuffer.h>
+#include <Urho3D/Resource/XMLFile.h>
 #include "Tabs/Scene/EditorSceneSettings.h"
 #include "Editor.h"
 #include "Project.h"
@@ -48,8 +51,8 @@ void CookScene::RegisterObject(Context* context)
 
 void CookScene::RegisterCommandLine(CLI::App& cli)
 {
-    cli.add_option("--input", input_, "XML scene file.")->required();
-    cli.add_option("--output", output_, "Resulting binary scene file.");
+    cli.add_option("--input", inputs_, "XML or JSON scene or prefab files.")->required();
+    cli.add_option("--output", outputs_, "Resulting binary files, one per input.")->required();
     cli.set_callback([this]() {
         GetSubsystem<Editor>()->GetEngineParameters()[EP_HEADLESS] = true;
     });
@@ -60,6 +63,7 @@ void CookScene::Execute()
     auto* project = GetSubsystem<Project>();
     auto* editor = GetSubsystem<Editor>();
     auto* fs = context_->GetSubsystem<FileSystem>();
+    auto* workQueue = GetSubsystem<WorkQueue>();
 
     if (project == nullptr)
     {
@@ -67,37 +71,92 @@ void CookScene::Execute()
         return;
     }
 
-    Scene scene(context_);
-    File file(context_);
-    if (file.Open(input_, FILE_READ))
+    if (inputs_.size() != outputs_.size())
+    {
+        editor->ErrorExit("CookScene subcommand requires one --output for each --input.");
+        return;
+    }
+
+    // Resources may only be loaded on the main thread, so content is loaded serially first
+    const unsigned numFiles = inputs_.size();
+    ea::vector<SharedPtr<Scene>> scenes(numFiles);
+    ea::vector<Node*> roots(numFiles);
+    for (unsigned i = 0; i < numFiles; ++i)
     {
-        if (scene.LoadXML(file))
+        scenes[i] = MakeShared<Scene>(context_);
+        roots[i] = LoadContent(scenes[i], inputs_[i].c_str());
+        if (roots[i] == nullptr)
         {
-            // Remove components that should not be shipped in the final product
-            if (auto* component = scene.GetComponent<EditorSceneSettings>())
-                component->Remove();
+            editor->ErrorExit(Format("Could not load '{}'.", inputs_[i].c_str()));
+            return;
+        }
+        fs->CreateDirsRecursive(GetPath(outputs_[i].c_str()));
+    }
 
-            // Cook scene
-            assert(input_.starts_with(project->GetResourcePath()));
-            auto resourceName = input_.substr(project->GetResourcePath().length());
-            fs->CreateDirsRecursive(GetPath(output_));
+    // Scenes are independent from each other, serialize and write them in parallel
+    ea::vector<ea::string> errors(numFiles);
+    workQueue->ParallelFor(numFiles, 1, [&](unsigned begin, unsigned end, unsigned)
+    {
+        for (unsigned i = begin; i < end; ++i)
+        {
+            const ea::string outputName = outputs_[i].c_str();
+            VectorBuffer buffer;
+            buffer.SetName(outputName);
 
-            File output(context_);
-            if (output.Open(output_, FILE_WRITE))
+            if (!roots[i]->Save(buffer))
             {
-                if (!scene.Save(output))
-                    editor->ErrorExit(Format("Could not convert '{}' to binary version.", input_));
-                else
-                    fs->SetLastModifiedTime(output_, fs->GetLastModifiedTime(input_));
+                errors[i] = Format("Could not convert '{}' to binary version.", inputs_[i].c_str());
+                continue;
             }
-            else
-                editor->ErrorExit(Format("Could not open '{}' for writing.", output_));
+
+            File output(context_);
+            if (!output.Open(outputName, FILE_WRITE) || output.Write(buffer.GetData(), buffer.GetSize()) != buffer.GetSize())
+                errors[i] = Format("Could not open '{}' for writing.", outputName);
+        }
+    });
+
+    for (unsigned i = 0; i < numFiles; ++i)
+    {
+        if (!errors[i].empty())
+        {
+            editor->ErrorExit(errors[i]);
+            return;
         }
-        else
-            editor->ErrorExit(Format("Could not open load scene '{}'.", input_));
+        fs->SetLastModifiedTime(outputs_[i].c_str(), fs->GetLastModifiedTime(inputs_[i].c_str()));
+    }
+}
+
+Node* CookScene::LoadContent(Scene* scene, const ea::string& fileName) const
+{
+    File file(context_);
+    if (!file.Open(fileName, FILE_READ))
+        return nullptr;
+
+    if (GetExtension(fileName) == ".json")
+    {
+        if (!scene->LoadJSON(file))
+            return nullptr;
     }
     else
-        editor->ErrorExit(Format("Could not open open '{}' for reading.", input_));
+    {
+        XMLFile xmlFile(context_);
+        if (!xmlFile.Load(file))
+            return nullptr;
+
+        // Prefabs are instantiated into an empty scene and saved without a scene header
+        const XMLElement root = xmlFile.GetRoot();
+        if (root.GetName() == "node")
+            return scene->InstantiateXML(root, Vector3::ZERO, Quaternion::IDENTITY);
+
+        if (!scene->LoadXML(root))
+            return nullptr;
+    }
+
+    // Remove components that should not be shipped in the final product
+    if (auto* component = scene->GetComponent<EditorSceneSettings>())
+        component->Remove();
+
+    return scene;
 }
 
 }
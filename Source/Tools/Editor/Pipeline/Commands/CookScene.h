@@ -28,6 +28,11 @@
 namespace Urho3D
 {
 
+class Node;
+class Scene;
+
+/// Converts XML or JSON scenes and prefabs to the binary format. Multiple files may be cooked at once: loading runs
+/// on the main thread because it loads resources, serialization and writing of the results run on worker threads.
 class CookScene : public SubCommand
 {
     URHO3D_OBJECT(CookScene, SubCommand);
@@ -42,10 +47,13 @@ public:
     void Execute() override;
 
 protected:
-    ///
-    ea::string input_;
-    ///
-    ea::string output_;
+    /// Load scene or prefab from the file. Editor-only components are removed. Return root node of the content.
+    Node* LoadContent(Scene* scene, const ea::string& fileName) const;
+
+    /// Scene or prefab files to cook.
+    std::vector<std::string> inputs_;
+    /// Resulting binary files, one per input.
+    std::vector<std::string> outputs_;
 };
 
 }
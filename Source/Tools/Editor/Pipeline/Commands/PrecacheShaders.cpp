@@ -0,0 +1,214 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#include <Urho3D/Engine/EngineDefs.h>
+#include <Urho3D/Graphics/Graphics.h>
+#include <Urho3D/Graphics/ShaderPrecache.h>
+#include <Urho3D/Graphics/Technique.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/IO/Log.h>
+#include <Urho3D/IO/MemoryBuffer.h>
+#include <Urho3D/Resource/ResourceCache.h>
+#include <Urho3D/Resource/XMLFile.h>
+#include "Editor.h"
+#include "Pipeline/Commands/PrecacheShaders.h"
+
+#include <EASTL/sort.h>
+
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Return whether every define of the pass is present in the variation defines.
+bool ContainsDefines(const ea::string& variationDefines, const ea::string& passDefines)
+{
+    const StringVector variationTokens = variationDefines.split(' ');
+    for (const ea::string& define : passDefines.split(' '))
+    {
+        if (!variationTokens.contains(define))
+            return false;
+    }
+    return true;
+}
+
+}
+
+PrecacheShaders::PrecacheShaders(Context* context)
+    : SubCommand(context)
+{
+}
+
+void PrecacheShaders::RegisterObject(Context* context)
+{
+    context->RegisterFactory<PrecacheShaders>();
+}
+
+void PrecacheShaders::RegisterCommandLine(CLI::App& cli)
+{
+    cli.add_option("--input", inputs_, "Shader usage files recorded by Graphics::BeginDumpShaders().")->required();
+    cli.add_option("--output", output_, "Resulting merged shader usage file.");
+    cli.add_option("--min-uses", minUses_, "Drop combinations used fewer times than this.");
+    cli.add_option("--top", numTop_, "Number of combinations listed in reports.");
+    cli.add_flag("--compile", compile_, "Compile merged combinations. Direct3D stores the bytecode in the shader cache.");
+    cli.add_flag("--report-techniques", reportTechniques_, "Report technique passes whose shader variations were never used.");
+    cli.set_callback([this]() {
+        // Compilation needs a graphics device
+        if (!compile_)
+            GetSubsystem<Editor>()->GetEngineParameters()[EP_HEADLESS] = true;
+    });
+}
+
+void PrecacheShaders::Execute()
+{
+    auto* editor = GetSubsystem<Editor>();
+
+    ea::vector<ShaderCombinationUsage> combinations;
+    for (const std::string& input : inputs_)
+    {
+        XMLFile xmlFile(context_);
+        File file(context_);
+        if (!file.Open(input.c_str(), FILE_READ) || !xmlFile.Load(file))
+        {
+            editor->ErrorExit(Format("Could not load shader usage file '{}'.", input.c_str()));
+            return;
+        }
+        ShaderPrecache::ReadCombinations(xmlFile.GetRoot(), combinations);
+    }
+
+    const unsigned numMerged = combinations.size();
+    combinations.erase(ea::remove_if(combinations.begin(), combinations.end(),
+        [this](const ShaderCombinationUsage& combination) { return combination.numUses_ < minUses_; }), combinations.end());
+    URHO3D_LOGINFO("Merged {} combinations from {} files, dropped {} used fewer than {} times", numMerged,
+        inputs_.size(), numMerged - combinations.size(), minUses_);
+
+    ReportCombinations(combinations);
+    if (reportTechniques_)
+        ReportUnusedPasses(combinations);
+
+    XMLFile merged(context_);
+    XMLElement root = merged.CreateRoot("shaders");
+    ShaderPrecache::WriteCombinations(root, combinations);
+
+    if (!output_.empty())
+    {
+        GetSubsystem<FileSystem>()->CreateDirsRecursive(GetPath(output_));
+        File output(context_);
+        if (!output.Open(output_, FILE_WRITE) || !merged.Save(output))
+        {
+            editor->ErrorExit(Format("Could not open '{}' for writing.", output_));
+            return;
+        }
+    }
+
+    if (compile_)
+    {
+        auto* graphics = GetSubsystem<Graphics>();
+        if (!graphics)
+        {
+            editor->ErrorExit("Shader compilation requires graphics.");
+            return;
+        }
+
+        const ea::string xmlData = merged.ToString();
+        MemoryBuffer source(xmlData.data(), xmlData.size());
+        graphics->PrecacheShaders(source);
+        URHO3D_LOGINFO("Compiled {} combinations", combinations.size());
+    }
+}
+
+void PrecacheShaders::ReportCombinations(const ea::vector<ShaderCombinationUsage>& combinations) const
+{
+    ea::vector<const ShaderCombinationUsage*> sorted;
+    for (const ShaderCombinationUsage& combination : combinations)
+        sorted.push_back(&combination);
+    const unsigned numListed = Min(numTop_, sorted.size());
+
+    ea::sort(sorted.begin(), sorted.end(), [](const ShaderCombinationUsage* lhs, const ShaderCombinationUsage* rhs)
+        { return lhs->numUses_ > rhs->numUses_; });
+    URHO3D_LOGINFO("Most used combinations:");
+    for (unsigned i = 0; i < numListed; ++i)
+        URHO3D_LOGINFO("  {} uses: {}", sorted[i]->numUses_, sorted[i]->GetKey());
+
+    ea::sort(sorted.begin(), sorted.end(), [](const ShaderCombinationUsage* lhs, const ShaderCombinationUsage* rhs)
+        { return lhs->vsCompileUSec_ + lhs->psCompileUSec_ > rhs->vsCompileUSec_ + rhs->psCompileUSec_; });
+    URHO3D_LOGINFO("Slowest to compile combinations:");
+    for (unsigned i = 0; i < numListed; ++i)
+    {
+        URHO3D_LOGINFO("  {:.2f} ms (vs {:.2f}, ps {:.2f}): {}",
+            (sorted[i]->vsCompileUSec_ + sorted[i]->psCompileUSec_) / 1000.0, sorted[i]->vsCompileUSec_ / 1000.0,
+            sorted[i]->psCompileUSec_ / 1000.0, sorted[i]->GetKey());
+    }
+}
+
+void PrecacheShaders::ReportUnusedPasses(const ea::vector<ShaderCombinationUsage>& combinations) const
+{
+    auto* cache = GetSubsystem<ResourceCache>();
+    auto* fs = GetSubsystem<FileSystem>();
+
+    StringVector techniqueNames;
+    for (const ea::string& resourceDir : cache->GetResourceDirs())
+    {
+        StringVector files;
+        fs->ScanDir(files, resourceDir + "Techniques/", "*.xml", SCAN_FILES, true);
+        for (const ea::string& file : files)
+        {
+            const ea::string name = "Techniques/" + file;
+            if (!techniqueNames.contains(name))
+                techniqueNames.push_back(name);
+        }
+    }
+
+    unsigned numUnused = 0;
+    for (const ea::string& techniqueName : techniqueNames)
+    {
+        auto* technique = cache->GetResource<Technique>(techniqueName);
+        if (!technique)
+            continue;
+
+        for (Pass* pass : technique->GetPasses())
+        {
+            const bool used = ea::any_of(combinations.begin(), combinations.end(),
+                [pass](const ShaderCombinationUsage& combination)
+            {
+                return combination.vs_ == pass->GetVertexShader() && combination.ps_ == pass->GetPixelShader()
+                    && ContainsDefines(combination.vsDefines_, pass->GetVertexShaderDefines())
+                    && ContainsDefines(combination.psDefines_, pass->GetPixelShaderDefines());
+            });
+
+            if (!used)
+            {
+                URHO3D_LOGINFO("Unused pass '{}' of '{}': {} ({}) {} ({})", pass->GetName(), techniqueName,
+                    pass->GetVertexShader(), pass->GetVertexShaderDefines(), pass->GetPixelShader(),
+                    pass->GetPixelShaderDefines());
+                ++numUnused;
+            }
+        }
+    }
+    URHO3D_LOGINFO("Found {} unused passes in {} techniques", numUnused, techniqueNames.size());
+}
+
+}
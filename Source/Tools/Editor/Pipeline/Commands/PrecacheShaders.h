@@ -0,0 +1,69 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#pragma once
+
+
+#include "Pipeline/Commands/SubCommand.h"
+
+namespace Urho3D
+{
+
+struct ShaderCombinationUsage;
+
+/// Merges shader usage files recorded with Graphics::BeginDumpShaders(), prunes rarely used combinations, reports
+/// technique passes whose variations were never used and optionally compiles the merged set into the shader cache.
+class PrecacheShaders : public SubCommand
+{
+    URHO3D_OBJECT(PrecacheShaders, SubCommand);
+public:
+    ///
+    explicit PrecacheShaders(Context* context);
+    ///
+    static void RegisterObject(Context* context);
+    ///
+    void RegisterCommandLine(CLI::App& cli) override;
+    ///
+    void Execute() override;
+
+protected:
+    /// Log the most used and the slowest to compile combinations.
+    void ReportCombinations(const ea::vector<ShaderCombinationUsage>& combinations) const;
+    /// Log technique passes none of whose shader variations were used.
+    void ReportUnusedPasses(const ea::vector<ShaderCombinationUsage>& combinations) const;
+
+    /// Usage files to merge.
+    std::vector<std::string> inputs_;
+    /// Merged usage file.
+    ea::string output_;
+    /// Combinations used fewer times are dropped.
+    unsigned minUses_ = 1;
+    /// Number of combinations listed in reports.
+    unsigned numTop_ = 10;
+    /// Compile the merged combinations.
+    bool compile_ = false;
+    /// Report unused technique passes.
+    bool reportTechniques_ = false;
+};
+
+}
@@ -0,0 +1,219 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#include <Urho3D/Core/Thread.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/Log.h>
+#include <Urho3D/Resource/JSONFile.h>
+
+#include "Project.h"
+#include "Pipeline/Asset.h"
+#include "Pipeline/Flavor.h"
+#include "Pipeline/ImportCache.h"
+#include "Pipeline/Importers/AssetImporter.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Name of the file listing byproducts of a cache entry.
+const char* manifestFileName = "manifest.json";
+
+/// Hash data with 64-bit FNV-1a.
+void HashBytes(unsigned long long& hash, const void* data, unsigned size)
+{
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (unsigned i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+}
+
+/// Hash string including terminator, so that consecutive strings do not run together.
+void HashString(unsigned long long& hash, const ea::string& value)
+{
+    HashBytes(hash, value.c_str(), value.length() + 1);
+}
+
+}
+
+ImportCache::ImportCache(Context* context)
+    : Object(context)
+{
+}
+
+ea::string ImportCache::GetKey(Asset* asset, AssetImporter* importer, Flavor* flavor) const
+{
+    File file(context_);
+    if (!file.Open(asset->GetResourcePath(), FILE_READ))
+        return EMPTY_STRING;
+
+    unsigned long long hash = 14695981039346656037ull;
+    unsigned char buffer[64 * 1024];
+    while (!file.IsEof())
+    {
+        const unsigned size = file.Read(buffer, sizeof(buffer));
+        if (!size)
+            break;
+        HashBytes(hash, buffer, size);
+    }
+
+    const unsigned fileSize = file.GetSize();
+    const unsigned version = importer->GetVersion();
+    const unsigned settingsHash = importer->HashEffectiveAttributeValues();
+    HashBytes(hash, &fileSize, sizeof(fileSize));
+    HashString(hash, asset->GetName());
+    HashString(hash, importer->GetTypeName());
+    HashBytes(hash, &version, sizeof(version));
+    HashBytes(hash, &settingsHash, sizeof(settingsHash));
+    HashString(hash, flavor->GetName());
+
+    return Format("{:016x}", hash);
+}
+
+bool ImportCache::Restore(const ea::string& key, AssetImporter* importer)
+{
+    if (key.empty())
+        return false;
+
+    if (!localPath_.empty() && RestoreFrom(localPath_, key, importer))
+    {
+        ++numHits_;
+        return true;
+    }
+
+    if (!sharedPath_.empty() && RestoreFrom(sharedPath_, key, importer))
+    {
+        // Keep a local copy to avoid network access next time
+        if (!localPath_.empty())
+            StoreTo(localPath_, key, importer);
+        ++numHits_;
+        return true;
+    }
+
+    ++numMisses_;
+    return false;
+}
+
+void ImportCache::Store(const ea::string& key, AssetImporter* importer)
+{
+    if (key.empty() || importer->GetByproducts().empty())
+        return;
+
+    if (!localPath_.empty())
+        StoreTo(localPath_, key, importer);
+    if (!sharedPath_.empty())
+        StoreTo(sharedPath_, key, importer);
+}
+
+bool ImportCache::RestoreFrom(const ea::string& cachePath, const ea::string& key, AssetImporter* importer)
+{
+    auto* fs = context_->GetSubsystem<FileSystem>();
+    auto* project = GetSubsystem<Project>();
+
+    const ea::string entryPath = GetEntryPath(cachePath, key);
+    JSONFile manifest(context_);
+    if (!fs->FileExists(entryPath + manifestFileName) || !manifest.LoadFile(entryPath + manifestFileName))
+        return false;
+
+    StringVector byproducts;
+    for (const JSONValue& value : manifest.GetRoot().Get("byproducts").GetArray())
+    {
+        const ea::string& byproduct = value.GetString();
+        // Entry is incomplete or damaged, treat it as a miss and let importer overwrite it
+        if (byproduct.empty() || !fs->FileExists(entryPath + byproduct))
+            return false;
+        byproducts.push_back(byproduct);
+    }
+    if (byproducts.empty())
+        return false;
+
+    importer->ClearByproducts();
+    for (const ea::string& byproduct : byproducts)
+    {
+        const ea::string destination = project->GetCachePath() + byproduct;
+        fs->CreateDirsRecursive(GetPath(destination));
+        if (!fs->Copy(entryPath + byproduct, destination))
+        {
+            URHO3D_LOGWARNING("Could not restore '{}' from import cache '{}'.", byproduct, cachePath);
+            importer->ClearByproducts();
+            return false;
+        }
+        importer->AddByproduct(byproduct);
+    }
+
+    importer->lastAttributeHash_ = importer->HashEffectiveAttributeValues();
+    return true;
+}
+
+bool ImportCache::StoreTo(const ea::string& cachePath, const ea::string& key, AssetImporter* importer)
+{
+    auto* fs = context_->GetSubsystem<FileSystem>();
+    auto* project = GetSubsystem<Project>();
+
+    const ea::string entryPath = GetEntryPath(cachePath, key);
+    if (fs->DirExists(entryPath))
+        return true;
+
+    // Fill a temporary directory and rename it in place, so that other machines never observe partial entries
+    const ea::string tempPath = Format("{}{}.{}.tmp/", cachePath, key, (uint64_t)Thread::GetCurrentThreadID());
+    fs->RemoveDir(tempPath, true);
+
+    JSONValue byproducts{JSON_ARRAY};
+    for (const ea::string& byproduct : importer->GetByproducts())
+    {
+        const ea::string destination = tempPath + byproduct;
+        fs->CreateDirsRecursive(GetPath(destination));
+        if (!fs->Copy(project->GetCachePath() + byproduct, destination))
+        {
+            URHO3D_LOGWARNING("Could not store '{}' in import cache '{}'.", byproduct, cachePath);
+            fs->RemoveDir(tempPath, true);
+            return false;
+        }
+        byproducts.Push(byproduct);
+    }
+
+    JSONFile manifest(context_);
+    manifest.GetRoot().Set("byproducts", byproducts);
+    if (!manifest.SaveFile(tempPath + manifestFileName))
+    {
+        fs->RemoveDir(tempPath, true);
+        return false;
+    }
+
+    fs->CreateDirsRecursive(cachePath + key.substr(0, 2) + "/");
+    // Another process may have stored the same entry in the meantime, which is fine as contents are identical
+    if (!fs->Rename(RemoveTrailingSlash(tempPath), RemoveTrailingSlash(entryPath)))
+        fs->RemoveDir(tempPath, true);
+    return true;
+}
+
+ea::string ImportCache::GetEntryPath(const ea::string& cachePath, const ea::string& key)
+{
+    return cachePath + key.substr(0, 2) + "/" + key + "/";
+}
+
+}
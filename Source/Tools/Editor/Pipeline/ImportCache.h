@@ -0,0 +1,88 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#pragma once
+
+#include <atomic>
+
+#include <Urho3D/Core/Object.h>
+#include <Urho3D/IO/FileSystem.h>
+
+namespace Urho3D
+{
+
+class Asset;
+class AssetImporter;
+class Flavor;
+
+/// Content-addressed cache of importer outputs. Entries are keyed by hash of source file contents, importer type,
+/// importer version, effective importer settings and flavor, so outputs stay valid across branch switches and can be
+/// shared between machines. Entries are looked up in the local cache first and in the optional shared cache second.
+class ImportCache : public Object
+{
+    URHO3D_OBJECT(ImportCache, Object);
+public:
+    ///
+    explicit ImportCache(Context* context);
+    /// Set local cache directory. Empty path disables the local cache.
+    void SetLocalPath(const ea::string& path) { localPath_ = path.empty() ? path : AddTrailingSlash(path); }
+    /// Set shared cache directory, for example on a network drive. Empty path disables the shared cache.
+    void SetSharedPath(const ea::string& path) { sharedPath_ = path.empty() ? path : AddTrailingSlash(path); }
+    /// Return local cache directory.
+    const ea::string& GetLocalPath() const { return localPath_; }
+    /// Return shared cache directory.
+    const ea::string& GetSharedPath() const { return sharedPath_; }
+    /// Return true if any cache directory is set.
+    bool IsEnabled() const { return !localPath_.empty() || !sharedPath_.empty(); }
+
+    /// Return cache key of importing the asset with specified importer. Returns empty string if asset can not be hashed.
+    ea::string GetKey(Asset* asset, AssetImporter* importer, Flavor* flavor) const;
+    /// Restore importer outputs into project cache. Returns true on cache hit. May be called from non-main thread.
+    bool Restore(const ea::string& key, AssetImporter* importer);
+    /// Store importer outputs from project cache. May be called from non-main thread.
+    void Store(const ea::string& key, AssetImporter* importer);
+
+    /// Return number of cache hits since editor start.
+    unsigned GetNumHits() const { return numHits_; }
+    /// Return number of cache misses since editor start.
+    unsigned GetNumMisses() const { return numMisses_; }
+
+private:
+    /// Restore entry from one cache directory.
+    bool RestoreFrom(const ea::string& cachePath, const ea::string& key, AssetImporter* importer);
+    /// Store entry into one cache directory.
+    bool StoreTo(const ea::string& cachePath, const ea::string& key, AssetImporter* importer);
+    /// Return directory of the entry.
+    static ea::string GetEntryPath(const ea::string& cachePath, const ea::string& key);
+
+    /// Local cache directory.
+    ea::string localPath_;
+    /// Shared cache directory.
+    ea::string sharedPath_;
+    /// Number of cache hits.
+    std::atomic<unsigned> numHits_{};
+    /// Number of cache misses.
+    std::atomic<unsigned> numMisses_{};
+};
+
+}
@@ -73,6 +73,12 @@ public:
     Variant GetInstanceDefault(const ea::string& name) const override;
     /// Returns flavor this importer belongs to.
     Flavor* GetFlavor() const { return flavor_; }
+    /// Returns version of importer output. Must be incremented when importer produces different output from the same input, as it invalidates import cache entries.
+    virtual unsigned GetVersion() const { return 1; }
+    /// Returns maximum number of instances of this importer that may execute concurrently. 0 means no limit. Importers that spawn heavy external processes should limit themselves.
+    virtual unsigned GetMaxConcurrency() const { return 0; }
+    /// Adds resource names this importer needs to be imported before it executes to `dependencies` vector.
+    virtual void GetDependencies(StringVector& dependencies) const { }
 
 protected:
     /// Sets needed asset information. Called after creating every importer.
@@ -109,6 +115,7 @@ protected:
     unsigned lastAttributeHash_ = 0;
 
     friend class Asset;
+    friend class ImportCache;
 };
 
 }
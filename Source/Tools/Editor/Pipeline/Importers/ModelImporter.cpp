@@ -20,9 +20,14 @@
 // THE SOFTWARE.
 //
 
+#include <Urho3D/Graphics/Model.h>
+#include <Urho3D/IO/File.h>
 #include <Urho3D/IO/FileSystem.h>
 #include <Urho3D/IO/Log.h>
 #include <Urho3D/Core/ProcessUtils.h>
+#ifdef URHO3D_PHYSICS
+#include <Urho3D/Physics/CookedCollisionGeometry.h>
+#endif
 
 #include "Project.h"
 #include "Pipeline/Asset.h"
@@ -40,6 +45,12 @@ static const char* MODEL_IMPORTER_MAX_BONES = "Max number of bones";
 static const char* MODEL_IMPORTER_ANIM_TICK = "Animation tick frequency";
 static const char* MODEL_IMPORTER_EMISSIVE_AO = "Emissive is ambient occlusion";
 static const char* MODEL_IMPORTER_FBX_PIVOT = "Suppress $fbx pivot nodes";
+static const char* MODEL_IMPORTER_COOK_COLLISION = "Cook collision geometry";
+static const char* MODEL_IMPORTER_OPTIMIZE_MESHES = "Optimize meshes";
+static const char* MODEL_IMPORTER_QUANTIZE_VERTICES = "Quantize vertices";
+static const char* MODEL_IMPORTER_LOD_LEVELS = "Generated LOD levels";
+static const char* MODEL_IMPORTER_LOD_REDUCTION = "LOD triangle reduction";
+static const char* MODEL_IMPORTER_GENERATE_CLUSTERS = "Generate clusters";
 
 ModelImporter::ModelImporter(Context* context)
     : AssetImporter(context)
@@ -59,6 +70,12 @@ void ModelImporter::RegisterObject(Context* context)
     URHO3D_ATTRIBUTE(MODEL_IMPORTER_ANIM_TICK, int, animationTick_, 4800, AM_DEFAULT);
     URHO3D_ATTRIBUTE(MODEL_IMPORTER_EMISSIVE_AO, bool, emissiveIsAmbientOcclusion_, false, AM_DEFAULT);
     URHO3D_ATTRIBUTE(MODEL_IMPORTER_FBX_PIVOT, bool, noFbxPivot_, false, AM_DEFAULT);
+    URHO3D_ATTRIBUTE(MODEL_IMPORTER_COOK_COLLISION, bool, cookCollisionGeometry_, false, AM_DEFAULT);
+    URHO3D_ATTRIBUTE(MODEL_IMPORTER_OPTIMIZE_MESHES, bool, optimizeMeshes_, true, AM_DEFAULT);
+    URHO3D_ATTRIBUTE(MODEL_IMPORTER_QUANTIZE_VERTICES, bool, quantizeVertices_, false, AM_DEFAULT);
+    URHO3D_ATTRIBUTE(MODEL_IMPORTER_LOD_LEVELS, int, numLodLevels_, 0, AM_DEFAULT);
+    URHO3D_ATTRIBUTE(MODEL_IMPORTER_LOD_REDUCTION, float, lodReduction_, 0.5f, AM_DEFAULT);
+    URHO3D_ATTRIBUTE(MODEL_IMPORTER_GENERATE_CLUSTERS, bool, generateClusters_, false, AM_DEFAULT);
 }
 
 bool ModelImporter::Execute(Urho3D::Asset* input, const ea::string& outputPath)
@@ -111,6 +128,22 @@ bool ModelImporter::Execute(Urho3D::Asset* input, const ea::string& outputPath)
     if (!GetAttribute(MODEL_IMPORTER_FBX_PIVOT).GetBool())
         args.emplace_back("-np");
 
+    if (GetAttribute(MODEL_IMPORTER_OPTIMIZE_MESHES).GetBool())
+        args.emplace_back("-mo");
+
+    if (GetAttribute(MODEL_IMPORTER_QUANTIZE_VERTICES).GetBool())
+        args.emplace_back("-mq");
+
+    if (GetAttribute(MODEL_IMPORTER_GENERATE_CLUSTERS).GetBool())
+        args.emplace_back("-mc");
+
+    if (GetAttribute(MODEL_IMPORTER_LOD_LEVELS).GetInt() > 0)
+    {
+        args.emplace_back("-lods");
+        args.emplace_back(ea::to_string(GetAttribute(MODEL_IMPORTER_LOD_LEVELS).GetInt()));
+        args.emplace_back(ea::to_string(GetAttribute(MODEL_IMPORTER_LOD_REDUCTION).GetFloat()));
+    }
+
     ea::string cmdOutput;
     int result = fs->SystemRun(fs->GetProgramDir() + "AssetImporter", args, cmdOutput);
 
@@ -123,6 +156,27 @@ bool ModelImporter::Execute(Urho3D::Asset* input, const ea::string& outputPath)
         return false;
     }
 
+#ifdef URHO3D_PHYSICS
+    // Precook convex hulls and triangle mesh BVHs next to every produced model, CollisionShape picks them up at runtime
+    if (GetAttribute(MODEL_IMPORTER_COOK_COLLISION).GetBool())
+    {
+        StringVector models;
+        fs->ScanDir(models, tempPath, "*.mdl", SCAN_FILES, true);
+        for (const ea::string& modelName : models)
+        {
+            const ea::string modelPath = tempPath + modelName;
+            Model model(context_);
+            File modelFile(context_, modelPath);
+            if (!model.Load(modelFile))
+                continue;
+
+            CookedCollisionGeometry cooked(context_);
+            if (cooked.Cook(&model) && !cooked.SaveFile(ReplaceExtension(modelPath, COOKED_COLLISION_EXTENSION)))
+                URHO3D_LOGERROR("Saving cooked collision geometry of 'res://{}' failed.", modelName);
+        }
+    }
+#endif
+
     unsigned mtime = fs->GetLastModifiedTime(input->GetResourcePath());
 
     StringVector tmpByproducts;
@@ -148,6 +202,12 @@ bool ModelImporter::Execute(Urho3D::Asset* input, const ea::string& outputPath)
     return !tmpByproducts.empty();
 }
 
+unsigned ModelImporter::GetMaxConcurrency() const
+{
+    // AssetImporter processes load entire scenes into memory, running one per CPU core easily exhausts RAM.
+    return Max(1u, GetNumLogicalCPUs() / 2);
+}
+
 bool ModelImporter::Accepts(const ea::string& path) const
 {
     if (path.ends_with(".fbx"))
@@ -38,6 +38,10 @@ public:
     bool Accepts(const ea::string& path) const override;
     ///
     bool Execute(Urho3D::Asset* input, const ea::string& outputPath) override;
+    /// Limits number of concurrently running external converter processes.
+    unsigned GetMaxConcurrency() const override;
+    /// Version 2 optimizes meshes.
+    unsigned GetVersion() const override { return 3; }
 
 protected:
     ///
@@ -58,6 +62,18 @@ protected:
     bool emissiveIsAmbientOcclusion_ = false;
     ///
     bool noFbxPivot_ = false;
+    ///
+    bool cookCollisionGeometry_ = false;
+    ///
+    bool optimizeMeshes_ = true;
+    ///
+    bool quantizeVertices_ = false;
+    ///
+    int numLodLevels_ = 0;
+    ///
+    float lodReduction_ = 0.5f;
+    ///
+    bool generateClusters_ = false;
 };
 
 }
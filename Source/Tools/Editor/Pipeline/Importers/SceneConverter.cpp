@@ -84,9 +84,10 @@ bool SceneConverter::Execute(Urho3D::Asset* input, const ea::string& outputPath)
 
 bool SceneConverter::Accepts(const ea::string& path) const
 {
-    if (!path.ends_with(".xml") && !path.ends_with(".scene"))
+    if (!path.ends_with(".xml") && !path.ends_with(".scene") && !path.ends_with(".node"))
         return false;
-    return GetContentType(context_, path) == CTYPE_SCENE;
+    const ContentType contentType = GetContentType(context_, path);
+    return contentType == CTYPE_SCENE || contentType == CTYPE_SCENEOBJECT;
 }
 
 }
@@ -38,6 +38,8 @@ public:
     bool Accepts(const ea::string& path) const override;
     ///
     bool Execute(Urho3D::Asset* input, const ea::string& outputPath) override;
+    /// Prefabs are cooked as well since version 2.
+    unsigned GetVersion() const override { return 2; }
 };
 
 }
@@ -20,9 +20,13 @@
 // THE SOFTWARE.
 //
 
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/IO/File.h>
 #include <Urho3D/IO/FileSystem.h>
 #include <Urho3D/IO/Log.h>
+#include <Urho3D/Resource/Image.h>
 #include "Pipeline/Asset.h"
+#include "Pipeline/Flavor.h"
 #include "Pipeline/Importers/TextureImporter.h"
 
 namespace Urho3D
@@ -120,11 +124,56 @@ void TextureImporter::RegisterObject(Context* context)
     URHO3D_ATTRIBUTE("Force Primary Encoding", bool, forcePrimaryEncoding_, false, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Use Transparent Indices For Black", bool, useTransparentIndicesForBlack_, false, AM_DEFAULT);
     URHO3D_ENUM_ATTRIBUTE("Pixel Format", pixelFormat_, pixelFormatNames, PixelFormat::None, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Auto Pixel Format", bool, autoPixelFormat_, true, AM_DEFAULT);
+}
+
+unsigned TextureImporter::GetMaxConcurrency() const
+{
+    // crunch is multithreaded by itself, see -helperThreads.
+    return Max(1u, GetNumLogicalCPUs() / 2);
 }
 
 bool TextureImporter::Accepts(const ea::string& path) const
 {
-    return path.ends_with(".png");
+    return path.ends_with(".png") || path.ends_with(".jpg") || path.ends_with(".jpeg") || path.ends_with(".tga") || path.ends_with(".bmp");
+}
+
+TextureImporter::PixelFormat TextureImporter::SelectPixelFormat(Asset* input) const
+{
+    bool desktop = false;
+    bool mobile = false;
+    bool web = false;
+    for (const ea::string& platform : flavor_->GetPlatforms())
+    {
+        if (platform == "Android" || platform == "iOS" || platform == "tvOS")
+            mobile = true;
+        else if (platform == "Web")
+            web = true;
+        else
+            desktop = true;
+    }
+    if (!mobile && !web)
+        desktop = true;
+
+    // Only pixels that are actually transparent require a format with alpha.
+    bool hasAlpha = false;
+    Image image(context_);
+    File file(context_, input->GetResourcePath());
+    if (file.IsOpen() && image.Load(file) && image.HasAlphaChannel() && !image.IsCompressed())
+    {
+        const unsigned char* data = image.GetData();
+        const unsigned numPixels = image.GetWidth() * image.GetHeight();
+        for (unsigned i = 0; i < numPixels && !hasAlpha; i++)
+            hasAlpha = data[i * image.GetComponents() + image.GetComponents() - 1] != 255;
+    }
+
+    // S3TC is not available on mobile GPUs and in mobile browsers and ETC2 is not available on desktop GPUs without GL3.
+    // Uncompressed textures with precomputed mips are still plain uploads.
+    if (desktop && !mobile && !web)
+        return hasAlpha ? PixelFormat::DXT5 : PixelFormat::DXT1;
+    if (mobile && !desktop && !web)
+        return hasAlpha ? PixelFormat::ETC2A : PixelFormat::ETC2;
+    return hasAlpha ? PixelFormat::A8R8G8B8 : PixelFormat::R8G8B8;
 }
 
 bool TextureImporter::Execute(Urho3D::Asset* input, const ea::string& outputPath)
@@ -135,15 +184,21 @@ bool TextureImporter::Execute(Urho3D::Asset* input, const ea::string& outputPath
     ea::string outputDirectory = outputPath + GetPath(input->GetName());
     ea::string outputFile = outputDirectory + GetFileName(input->GetName()) + ".dds";
     int pixelFormatValue = GetAttribute("Pixel Format").GetInt();
+    if (pixelFormatValue == (int)PixelFormat::None && GetAttribute("Auto Pixel Format").GetBool())
+        pixelFormatValue = (int)SelectPixelFormat(input);
 
     if (pixelFormatValue == (int)PixelFormat::None)
         return false;
     else
         context_->GetSubsystem<FileSystem>()->CreateDirsRecursive(outputDirectory);
 
+    // Several textures are compressed in parallel, crunch threads share remaining cores.
+    const unsigned numHelperThreads = Max(1u, GetNumLogicalCPUs() / GetMaxConcurrency()) - 1;
+
     ea::string output;
     StringVector arguments{
         "-fileformat", "dds", "-noprogress", "-nostats", "-quality", ea::to_string(GetAttribute("Quality").GetInt()),
+        "-helperThreads", ea::to_string(numHelperThreads),
         "-gamma", Format("{:.2f}", GetAttribute("Gamma").GetFloat()),
         "-blurriness", Format("{:.2f}", GetAttribute("Blur").GetFloat()),
         "-alphaThreshold", ea::to_string(GetAttribute("Alpha Threshold").GetInt()),
@@ -109,8 +109,14 @@ public:
     bool Accepts(const ea::string& path) const override;
     ///
     bool Execute(Urho3D::Asset* input, const ea::string& outputPath) override;
+    /// Limits number of concurrently running external converter processes.
+    unsigned GetMaxConcurrency() const override;
+    /// Version 2 selects pixel format automatically.
+    unsigned GetVersion() const override { return 2; }
 
 protected:
+    /// Returns a GPU-ready pixel format supported by all platforms of importer flavor.
+    PixelFormat SelectPixelFormat(Asset* input) const;
     ///
     void ApplyBlurLimit();
     ///
@@ -164,6 +170,8 @@ protected:
     bool useTransparentIndicesForBlack_ = false;
     ///
     PixelFormat pixelFormat_ = PixelFormat::None;
+    /// Select pixel format from flavor platforms and image contents when pixel format is not set.
+    bool autoPixelFormat_ = true;
     ///
     Logger logger_ = Log::GetLogger(ClassName::GetTypeNameStatic());
 };
@@ -23,11 +23,10 @@
 #include <EASTL/sort.h>
 
 #include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/Core/ProcessUtils.h>
 #include <Urho3D/Core/Thread.h>
 #include <Urho3D/IO/Log.h>
 #include <Urho3D/IO/FileSystem.h>
-#include <LZ4/lz4.h>
-#include <LZ4/lz4hc.h>
 
 #include "Project.h"
 #include "Pipeline/Pipeline.h"
@@ -42,7 +41,6 @@ Packager::Packager(Context* context)
     : Object(context)
     , output_(context)
 {
-    compressBuffer_.resize(LZ4_compressBound(blockSize_));
 }
 
 Packager::~Packager()
@@ -59,9 +57,16 @@ bool Packager::OpenPackage(const ea::string& path, Flavor* flavor, bool compress
     flavor_ = WeakPtr(flavor);
     compress_ = compress;
 
-    if (output_.Open(path, FILE_WRITE))
+    previousPackage_ = nullptr;
+    if (context_->GetSubsystem<FileSystem>()->FileExists(path))
+        previousPackage_ = MakeShared<PackageFile>(context_, path);
+
+    if (output_.Open(path + ".tmp", FILE_WRITE))
     {
-        WriteHeaders();
+        builder_.Create(&output_);
+        builder_.SetNumThreads(GetNumLogicalCPUs());
+        if (previousPackage_)
+            builder_.AddPreviousPackage(previousPackage_);
         return true;
     }
     logger_.Error("Opening '{}' failed, package was not created.", GetFileNameAndExtension(path));
@@ -93,7 +98,7 @@ void Packager::Start()
     {
         logger_.Warning("Resources directory is empty, package was not created.");
         output_.Close();
-        context_->GetSubsystem<FileSystem>()->Delete(outputPath_);
+        context_->GetSubsystem<FileSystem>()->Delete(outputPath_ + ".tmp");
         return;
     }
 
@@ -144,71 +149,51 @@ void Packager::WritePackage()
     AddFile(cachePath, "CacheInfo.json");   filesDone_++;
     AddFile(cachePath, "Settings.json");    filesDone_++;
 
-    entriesOffset_ = output_.GetSize();
-
-    for (const FileEntry& entry : entries_)
-    {
-        output_.WriteString(entry.name_);
-        output_.WriteUInt(entry.offset_);
-        output_.WriteUInt(entry.size_);
-        output_.WriteUInt(entry.checksum_);
-    }
-    // Write package size to the end of file to allow finding it linked to an executable file
-    unsigned currentSize = output_.GetSize();
-    output_.WriteUInt(currentSize + sizeof(unsigned));
-
-    WriteHeaders();
-
-    logger_.Info("Packaging completed.");
-}
+    const unsigned numReusedFiles = builder_.GetNumReusedFiles();
+    const bool finalized = builder_.Finalize();
+    output_.Close();
+    previousPackage_ = nullptr;
 
-void Packager::WriteHeaders()
-{
-    output_.Seek(0);
-    output_.WriteFileID(compress_ ? "RLZ4" : "RPAK");
-    output_.WriteUInt(entries_.size());
-    output_.WriteUInt(checksum_);
-    output_.WriteUInt(0);                                   // Version. Reserved for future use.
-    output_.WriteInt64(entriesOffset_);
+    auto* fs = context_->GetSubsystem<FileSystem>();
+    if (finalized && (!fs->FileExists(outputPath_) || fs->Delete(outputPath_)) && fs->Rename(outputPath_ + ".tmp", outputPath_))
+        logger_.Info("Packaging completed, {} files reused from previous package.", numReusedFiles);
+    else
+        logger_.Error("Packaging failed.");
 }
 
 bool Packager::AddFile(const ea::string& root, const ea::string& path)
 {
     assert(root.ends_with("/"));
 
-    FileEntry entry{};
     ea::string fileFullPath;
+    ea::string name;
 
     if (IsAbsolutePath(path))
     {
         assert(root.starts_with(root));
         fileFullPath = path;
-        entry.name_ = path.substr(root.length());
+        name = path.substr(root.length());
     }
     else
     {
         fileFullPath = root + path;
-        entry.name_ = path;
+        name = path;
     }
-    entry.checksum_ = 0;
-    entry.offset_ = 0;
-    entry.size_ = File(context_, fileFullPath).GetSize();
-    if (!entry.size_)
+
+    File srcFile(context_, fileFullPath);
+    unsigned dataSize = srcFile.GetSize();
+    if (!dataSize)
     {
         logger_.Warning("Skipped empty/missing file '{}'.", fileFullPath);
         return false;
     }
 
-    unsigned lastOffset = entry.offset_ = output_.GetSize();
-
-    File srcFile(context_, fileFullPath);
     if (!srcFile.IsOpen())
     {
         logger_.Error("Could not open file {}. Skipped!", fileFullPath);
         return false;
     }
 
-    unsigned dataSize = entry.size_;
     buffer_.resize(dataSize);
 
     if (srcFile.Read(&buffer_[0], dataSize) != dataSize)
@@ -218,45 +203,24 @@ bool Packager::AddFile(const ea::string& root, const ea::string& path)
     }
     srcFile.Close();
 
-    for (unsigned j = 0; j < dataSize; ++j)
+    if (!builder_.Append(name, buffer_.data(), dataSize, compress_ ? PACKAGE_CODEC_LZ4HC : PACKAGE_CODEC_NONE))
     {
-        checksum_ = SDBMHash(checksum_, buffer_[j]);
-        entry.checksum_ = SDBMHash(entry.checksum_, buffer_[j]);
+        logger_.Error("Could not write file {} to the package. Skipped!", name);
+        return false;
     }
 
-    entries_.push_back(entry);
-    if (!compress_)
+    const PackageEntry& entry = builder_.GetLastEntry();
+    if (builder_.IsLastEntryDuplicate())
+        logger_.Info("Added {} size {} as a duplicate", name, dataSize);
+    else if (builder_.IsLastEntryReused())
+        logger_.Info("Added {} size {} reused from previous package", name, dataSize);
+    else if (entry.codec_ != PACKAGE_CODEC_NONE)
     {
-        logger_.Info("Added {} size {}", entry.name_, dataSize);
-        output_.Write(&buffer_[0], entry.size_);
+        logger_.Info("{} in: {} out: {} ratio: {}", name, dataSize, entry.packedSize_,
+            entry.packedSize_ ? 1.f * dataSize / entry.packedSize_ : 0.f);
     }
     else
-    {
-        unsigned pos = 0;
-
-        // TODO: This could be parallelized.
-        while (pos < dataSize)
-        {
-            int unpackedSize = blockSize_;
-            if (pos + unpackedSize > dataSize)
-                unpackedSize = static_cast<int>(dataSize) - pos;
-
-            auto packedSize = (unsigned) LZ4_compress_HC((const char*) &buffer_[pos], (char*) compressBuffer_.data(), unpackedSize,
-                LZ4_compressBound(unpackedSize), 0);
-            if (!packedSize)
-                logger_.Error("LZ4 compression failed for file {} at offset {}.", entry.name_, pos);
-
-            output_.WriteUShort((unsigned short) unpackedSize);
-            output_.WriteUShort((unsigned short) packedSize);
-            output_.Write(compressBuffer_.data(), packedSize);
-
-            pos += unpackedSize;
-        }
-
-        unsigned totalPackedBytes = output_.GetSize() - lastOffset;
-        logger_.Info("{} in: {} out: {} ratio: {}", entry.name_, dataSize, totalPackedBytes,
-            totalPackedBytes ? 1.f * dataSize / totalPackedBytes : 0.f);
-    }
+        logger_.Info("Added {} size {}", name, dataSize);
     return true;
 }
 
@@ -25,6 +25,8 @@
 
 #include <Urho3D/Core/Object.h>
 #include <Urho3D/IO/File.h>
+#include <Urho3D/IO/PackageBuilder.h>
+#include <Urho3D/IO/PackageFile.h>
 
 
 namespace Urho3D
@@ -32,25 +34,14 @@ namespace Urho3D
 
 class Asset;
 
-struct FileEntry
-{
-    /// This is essentially a resource name.
-    ea::string name_;
-    /// Offset to the file data from the file start.
-    unsigned offset_{};
-    /// Size of file data.
-    unsigned size_{};
-    /// Checksum of file data.
-    unsigned checksum_{};
-};
-
 ///
-/// rbfx uses modified Urho3D pak file format. File header is modified and extended. Version field was added to facilitate easy modification
-/// of file structure in the future. Package entry list was moved to the end of the file (much like in a zip file) in order to allow
-/// creation of package files without knowing full list of files before-hand.
+/// rbfx uses modified Urho3D pak file format. The version 2 format written here stores a directory sorted by name hash at the end
+/// of the file (much like in a zip file), which allows creation of package files without knowing full list of files before-hand.
+/// Each entry chooses its own codec, file data is aligned for memory mapping and identical files are stored once.
+/// Compressed data of files that did not change since previous package was built is reused, so repackaging is incremental.
 ///
 
-/// %Packager is responsible for creating a package for specified flavor. Package will use new file format and have RPAK/RLZ4 file id.
+/// %Packager is responsible for creating a package for specified flavor. Package will use new file format and have RPK2 file id.
 class Packager : public Object
 {
     URHO3D_OBJECT(Packager, Object);
@@ -59,7 +50,7 @@ public:
     explicit Packager(Context* context);
     /// Destruct.
     ~Packager() override;
-    /// Opens pak file for writing.
+    /// Opens pak file for writing. Package is written to a temporary file and replaces existing package when completed.
     bool OpenPackage(const ea::string& path, Flavor* flavor, bool compress=true);
     /// Returns value between 0.0f and 1.0f.
     float GetProgress() const;
@@ -75,8 +66,6 @@ public:
 protected:
     /// Add a file to the package. This is a blocking operation.
     bool AddFile(const ea::string& root, const ea::string& path);
-    /// Writes file headter to the start of the file.
-    void WriteHeaders();
     /// A worker running in another thread that will handle writing the package.
     void WritePackage();
 
@@ -84,26 +73,20 @@ protected:
     Logger logger_{};
     /// Full path to output package file.
     ea::string outputPath_{};
-    /// Package file.
+    /// Temporary package file.
     File output_;
-    /// List of files that will be present in the package.
-    ea::vector<FileEntry> entries_{};
+    /// Previously built package whose compressed data is reused. Null when package did not exist.
+    SharedPtr<PackageFile> previousPackage_;
+    /// Package writer.
+    PackageBuilder builder_;
     /// Flavor that is being compressed.
     WeakPtr<Flavor> flavor_;
     /// A list of assets that are to be written into the package.
     ea::vector<SharedPtr<Asset>> queuedAssets_{};
     /// Flag indicating whether file content is compressed or not.
     bool compress_ = false;
-    /// Checksum of all file data (uncompressed).
-    unsigned checksum_ = 0;
-    /// Offset to the list of file entries in this package.
-    int64_t entriesOffset_ = 0;
-    /// LZ4 block size for data compression.
-    const int blockSize_ = 32768;
     /// Buffer that holds data that was read from file. It will be written to package or used in compression.
     ea::vector<uint8_t> buffer_{};
-    /// Buffer that holds compressed file data.
-    ea::vector<uint8_t> compressBuffer_{};
     /// Total number of assets to be processed. This number may be less than files written to the package as each asset may carry multiple byproducts.
     unsigned filesTotal_ = 0;
     /// A number of already completed written assets.
@@ -22,6 +22,7 @@
 
 #include <Urho3D/Core/Context.h>
 #include <Urho3D/Core/CoreEvents.h>
+#include <Urho3D/Core/Timer.h>
 #include <Urho3D/Core/WorkQueue.h>
 #include <Urho3D/Engine/Engine.h>
 #include <Urho3D/Engine/EngineDefs.h>
@@ -56,11 +57,16 @@ namespace Urho3D
 Pipeline::Pipeline(Context* context)
     : Object(context)
     , watcher_(context)
+    , importCache_(MakeShared<ImportCache>(context))
 {
     if (context_->GetSubsystem<Engine>()->IsHeadless())
+    {
+        SubscribeToEvent(E_ENDFRAME, [this](StringHash, VariantMap&) { DispatchImports(); });
         return;
+    }
 
     SubscribeToEvent(E_ENDFRAME, &Pipeline::OnEndFrame);
+    SubscribeToEvent(E_EDITORAPPLICATIONMENU, [this](StringHash, VariantMap&) { RenderImportProgress(); });
     SubscribeToEvent(E_RESOURCERENAMED, [this](StringHash, VariantMap& args) {
         using namespace ResourceRenamed;
         ea::string from = args[P_FROM].GetString();
@@ -141,6 +147,8 @@ void Pipeline::OnEndFrame(StringHash, VariantMap&)
         onResourceChanged_(this, entry);
     }
 
+    DispatchImports();
+
     if (!dirtyAssets_.empty())
     {
         auto* inspector = GetSubsystem<InspectorTab>();
@@ -276,33 +284,175 @@ bool Pipeline::RenameFlavor(const ea::string& oldName, const ea::string& newName
     return true;
 }
 
-SharedPtr<WorkItem> Pipeline::ScheduleImport(Asset* asset, Flavor* flavor, PipelineBuildFlags flags)
+bool Pipeline::ScheduleImport(Asset* asset, Flavor* flavor, PipelineBuildFlags flags)
 {
     assert(asset != nullptr);
-    if (asset->importing_)
-        return {};
-
     if (flavor == nullptr)
         flavor = GetDefaultFlavor();
 
+    if (importJobs_.contains(Format("{}:{}", flavor->GetName(), asset->GetName())))
+        return false;
+
+    return QueueImportJob(asset, flavor, flags) != nullptr;
+}
+
+ImportJob* Pipeline::QueueImportJob(Asset* asset, Flavor* flavor, PipelineBuildFlags flags)
+{
+    ea::string key = Format("{}:{}", flavor->GetName(), asset->GetName());
+    auto it = importJobs_.find(key);
+    if (it != importJobs_.end())
+        return it->second;
+
     if (flags & PipelineBuildFlag::SKIP_UP_TO_DATE && !asset->IsOutOfDate(flavor))
-        return {};
+        return nullptr;
 
-    asset->AddRef();
-    asset->importing_ = true;
-    return context_->GetSubsystem<WorkQueue>()->AddWorkItem([this, asset, flavor, flags]()
+    if (importJobs_.empty())
     {
-        if (ExecuteImport(asset, flavor, flags))
+        numCompletedImportJobs_ = 0;
+        numTotalImportJobs_ = 0;
+        importTimer_.Reset();
+    }
+
+    SharedPtr<ImportJob> job(new ImportJob());
+    job->asset_ = asset;
+    job->flavor_ = flavor;
+    job->flags_ = flags;
+    importJobs_[key] = job;
+    asset->importing_++;
+    numTotalImportJobs_++;
+
+    // Dependencies are queued first so that they are imported only once no matter how many assets refer to them.
+    StringVector dependencies;
+    for (AssetImporter* importer : asset->importers_[SharedPtr(flavor)])
+    {
+        if (importer->Accepts(asset->GetResourcePath()))
+            importer->GetDependencies(dependencies);
+    }
+
+    job->resolving_ = true;
+    for (const ea::string& dependency : dependencies)
+    {
+        Asset* dependencyAsset = GetAsset(dependency);
+        if (dependencyAsset == nullptr || dependencyAsset == asset)
+            continue;
+
+        ImportJob* dependencyJob = QueueImportJob(dependencyAsset, flavor, flags);
+        if (dependencyJob == nullptr)
+            continue;
+
+        if (dependencyJob->resolving_)
         {
-            MutexLock lock(mutex_);
-            dirtyAssets_.push_back(SharedPtr(asset));
+            logger_.Warning("res://{} and res://{} depend on each other, import order is not enforced.", asset->GetName(),
+                dependency);
+            continue;
         }
-        asset->importing_ = false;
-        asset->ReleaseRef();            // TODO: Chance to free asset on non-main thread.
-    }, 0);                              // Lowest possible priority.
+
+        dependencyJob->dependents_.push_back(job);
+        job->numDependencies_++;
+    }
+    job->resolving_ = false;
+
+    if (job->numDependencies_ == 0)
+        readyImportJobs_.push_back(job);
+
+    return job;
+}
+
+bool Pipeline::CanDispatch(ImportJob* job)
+{
+    job->limitedImporterTypes_.clear();
+    for (AssetImporter* importer : job->asset_->importers_[job->flavor_])
+    {
+        unsigned maxConcurrency = importer->GetMaxConcurrency();
+        if (maxConcurrency == 0 || !importer->Accepts(job->asset_->GetResourcePath()))
+            continue;
+
+        if (!(job->flags_ & PipelineBuildFlag::EXECUTE_OPTIONAL) && (importer->GetFlags() & AssetImporterFlag::IsOptional))
+            continue;
+
+        if (runningImporters_[importer->GetType()] >= maxConcurrency)
+            return false;
+
+        job->limitedImporterTypes_.push_back(importer->GetType());
+    }
+    return true;
 }
 
-bool Pipeline::ExecuteImport(Asset* asset, Flavor* flavor, PipelineBuildFlags flags)
+void Pipeline::DispatchImports()
+{
+    ea::vector<ImportJob*> completedJobs;
+    {
+        MutexLock lock(mutex_);
+        completedJobs.swap(completedImportJobs_);
+    }
+
+    for (ImportJob* job : completedJobs)
+        CompleteImportJob(job);
+
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    for (auto it = readyImportJobs_.begin(); it != readyImportJobs_.end();)
+    {
+        SharedPtr<ImportJob> job = *it;
+        if (!CanDispatch(job))
+        {
+            // Other jobs may be using different importers.
+            ++it;
+            continue;
+        }
+
+        it = readyImportJobs_.erase(it);
+        for (StringHash type : job->limitedImporterTypes_)
+            runningImporters_[type]++;
+        job->dispatched_ = true;
+        numRunningImportJobs_++;
+
+        // Job is captured by raw pointer, because reference counting is not thread-safe. `importJobs_` keeps it alive.
+        workQueue->AddWorkItem([this, job = job.Get()]()
+        {
+            HiresTimer timer;
+            job->imported_ = ExecuteImport(job->asset_, job->flavor_, job->flags_, job->byproducts_);
+            job->durationUSec_ = timer.GetUSec(false);
+
+            MutexLock lock(mutex_);
+            completedImportJobs_.push_back(job);
+        }, 0);                              // Lowest possible priority.
+    }
+}
+
+void Pipeline::CompleteImportJob(ImportJob* job)
+{
+    SharedPtr<ImportJob> jobRef(job);
+    for (StringHash type : job->limitedImporterTypes_)
+        runningImporters_[type]--;
+    numRunningImportJobs_--;
+    numCompletedImportJobs_++;
+
+    importJobs_.erase(Format("{}:{}", job->flavor_->GetName(), job->asset_->GetName()));
+    job->asset_->importing_--;
+
+    if (job->imported_)
+    {
+        MutexLock lock(mutex_);
+        dirtyAssets_.push_back(job->asset_);
+    }
+
+    for (ImportJob* dependent : job->dependents_)
+    {
+        // Dependents run even if this job failed, importer may still produce something useful.
+        if (--dependent->numDependencies_ == 0)
+            readyImportJobs_.push_back(SharedPtr(dependent));
+    }
+    job->dependents_.clear();
+
+    // Byproducts are imported as separate jobs. If byproduct is already queued, it is not imported twice.
+    for (const ea::string& byproduct : job->byproducts_)
+    {
+        if (Asset* byproductAsset = GetAsset(byproduct))
+            QueueImportJob(byproductAsset, job->flavor_, job->flags_);
+    }
+}
+
+bool Pipeline::ExecuteImport(Asset* asset, Flavor* flavor, PipelineBuildFlags flags, StringVector& byproducts)
 {
     bool importedAnything = false;
     auto* project = GetSubsystem<Project>();
@@ -320,22 +470,60 @@ bool Pipeline::ExecuteImport(Asset* asset, Flavor* flavor, PipelineBuildFlags fl
         if (!importer->Accepts(asset->GetResourcePath()))
             continue;
 
-        if (importer->Execute(asset, outputPath))
+        const ea::string cacheKey = importCache_->IsEnabled() ? importCache_->GetKey(asset, importer, flavor) : EMPTY_STRING;
+        bool imported = importCache_->Restore(cacheKey, importer);
+        if (imported)
+            logger_.Info("{} restored 'res://{}' from import cache.", importer->GetTypeName(), asset->GetName());
+        else if ((imported = importer->Execute(asset, outputPath)))
         {
+            importCache_->Store(cacheKey, importer);
             logger_.Info("{} imported 'res://{}'.", importer->GetTypeName(), asset->GetName());
+        }
 
+        if (imported)
+        {
             importedAnything = true;
-            for (const ea::string& byproduct : importer->GetByproducts())
-            {
-                if (Asset* byproductAsset = GetAsset(byproduct))
-                    ExecuteImport(byproductAsset, flavor, flags);
-            }
+            byproducts.insert(byproducts.end(), importer->GetByproducts().begin(), importer->GetByproducts().end());
         }
     }
 
     return importedAnything;
 }
 
+ImportProgress Pipeline::GetImportProgress() const
+{
+    ImportProgress progress;
+    progress.numCompleted_ = numCompletedImportJobs_;
+    progress.numTotal_ = numTotalImportJobs_;
+    progress.numRunning_ = numRunningImportJobs_;
+    progress.elapsedTime_ = importTimer_.GetMSec(false) / 1000.0f;
+    // Estimate is based on observed throughput, therefore it accounts for number of jobs running in parallel.
+    if (progress.numCompleted_ > 0)
+    {
+        const unsigned numRemaining = progress.numTotal_ - progress.numCompleted_;
+        progress.remainingTime_ = progress.elapsedTime_ / progress.numCompleted_ * numRemaining;
+    }
+    return progress;
+}
+
+void Pipeline::RenderImportProgress()
+{
+    if (!IsImporting())
+        return;
+
+    const ImportProgress progress = GetImportProgress();
+    const ea::string overlay = Format("{}/{} assets", progress.numCompleted_, progress.numTotal_);
+    ui::ProgressBar(static_cast<float>(progress.numCompleted_) / progress.numTotal_, ImVec2(150, 0), overlay.c_str());
+    if (ui::IsItemHovered())
+    {
+        if (progress.remainingTime_ > 0.0f)
+            ui::SetTooltip("Importing assets, %u running, %.0fs elapsed, ~%.0fs remaining.", progress.numRunning_,
+                progress.elapsedTime_, progress.remainingTime_);
+        else
+            ui::SetTooltip("Importing assets, %u running, %.0fs elapsed.", progress.numRunning_, progress.elapsedTime_);
+    }
+}
+
 void Pipeline::BuildCache(Flavor* flavor, PipelineBuildFlags flags)
 {
     auto* project = GetSubsystem<Project>();
@@ -357,9 +545,22 @@ void Pipeline::BuildCache(Flavor* flavor, PipelineBuildFlags flags)
     }
 }
 
-void Pipeline::WaitForCompletion() const
+void Pipeline::WaitForCompletion()
 {
-    context_->GetSubsystem<WorkQueue>()->Complete(0);
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    for (;;)
+    {
+        DispatchImports();
+        if (!IsImporting())
+            break;
+
+        if (workQueue->GetNumThreads() == 0)
+            // Nobody else is going to execute work items.
+            workQueue->Complete(0);
+        else
+            Time::Sleep(1);
+    }
+    workQueue->Complete(0);
 }
 
 void Pipeline::CreatePaksAsync(Flavor* flavor)
@@ -487,6 +688,10 @@ bool Pipeline::Serialize(Archive& archive)
 {
     if (auto block = archive.OpenUnorderedBlock("pipeline"))
     {
+        // Fine to not exist.
+        SerializeValue(archive, "localImportCache", useLocalImportCache_);
+        SerializeValue(archive, "sharedImportCache", sharedImportCachePath_);
+
         if (auto block = archive.OpenSequentialBlock("flavors"))
         {
             for (unsigned i = 0, num = archive.IsInput() ? block.GetSizeHint() : flavors_.size(); i < num; i++)
@@ -551,9 +756,19 @@ bool Pipeline::Serialize(Archive& archive)
     if (archive.IsInput() && (flavors_.empty() || GetDefaultFlavor()->GetName() != Flavor::DEFAULT))
         AddFlavor(Flavor::DEFAULT);
 
+    if (archive.IsInput())
+        UpdateImportCache();
+
     return true;
 }
 
+void Pipeline::UpdateImportCache()
+{
+    auto* project = GetSubsystem<Project>();
+    importCache_->SetLocalPath(useLocalImportCache_ && project ? project->GetProjectPath() + "ImportCache/" : EMPTY_STRING);
+    importCache_->SetSharedPath(sharedImportCachePath_);
+}
+
 void Pipeline::SortFlavors()
 {
     if (flavors_.size() < 2)
@@ -835,6 +1050,16 @@ void Pipeline::RenderSettingsUI()
     if (!canAdd)
         ui::PopStyleColor();
 
+    // Import cache
+    bool importCacheModified = ui::Checkbox("Local import cache", &useLocalImportCache_);
+    ui::SetHelpTooltip("Reuse importer outputs stored in project directory when source contents and settings match.", KEY_UNKNOWN);
+    importCacheModified |= ui::InputText("Shared import cache", &sharedImportCachePath_, ImGuiInputTextFlags_EnterReturnsTrue);
+    ui::SetHelpTooltip("Directory, usually on a network drive, where importer outputs are shared with other machines.", KEY_UNKNOWN);
+    if (importCacheModified)
+        UpdateImportCache();
+    ui::Text("Import cache hits %u, misses %u", importCache_->GetNumHits(), importCache_->GetNumMisses());
+    ui::Separator();
+
     // Flavor tabs
     if (ui::BeginTabBar("Flavors", ImGuiTabBarFlags_AutoSelectNewTabs))
     {
@@ -27,6 +27,7 @@
 #include <EASTL/unordered_map.h>
 
 #include <Urho3D/Core/Signal.h>
+#include <Urho3D/Core/Timer.h>
 #include <Urho3D/Core/WorkQueue.h>
 #include <Urho3D/IO/MultiFileWatcher.h>
 #include <Urho3D/IO/Archive.h>
@@ -41,6 +42,7 @@
 #include "Pipeline/Asset.h"
 #include "Pipeline/Packager.h"
 #include "Pipeline/Flavor.h"
+#include "Pipeline/ImportCache.h"
 
 namespace Urho3D
 {
@@ -56,6 +58,48 @@ enum class PipelineBuildFlag : unsigned
 };
 URHO3D_FLAGSET(PipelineBuildFlag, PipelineBuildFlags);
 
+/// A single node of import dependency graph. Job is dispatched to a worker thread once all jobs it depends on complete.
+struct ImportJob : public RefCounted
+{
+    /// Asset that is being imported.
+    SharedPtr<Asset> asset_;
+    /// Flavor that is being imported.
+    SharedPtr<Flavor> flavor_;
+    /// Import flags.
+    PipelineBuildFlags flags_;
+    /// Number of jobs that must complete before this job may be dispatched.
+    unsigned numDependencies_ = 0;
+    /// Jobs that wait for this job to complete.
+    ea::vector<SharedPtr<ImportJob>> dependents_;
+    /// Importer types with concurrency limit this job occupies while running.
+    ea::vector<StringHash> limitedImporterTypes_;
+    /// Flag indicating that job is looking up it's dependencies. Used for detecting dependency cycles.
+    bool resolving_ = false;
+    /// Flag indicating that job was dispatched to a worker thread.
+    bool dispatched_ = false;
+    /// Written by worker thread. Flag indicating that any importer produced output.
+    bool imported_ = false;
+    /// Written by worker thread. Byproducts that must be imported after this job.
+    StringVector byproducts_;
+    /// Written by worker thread. Time it took to execute importers.
+    long long durationUSec_ = 0;
+};
+
+/// Progress of import jobs scheduled since pipeline was idle last time.
+struct ImportProgress
+{
+    /// Number of completed jobs.
+    unsigned numCompleted_ = 0;
+    /// Number of all jobs, including completed ones.
+    unsigned numTotal_ = 0;
+    /// Number of jobs running on worker threads.
+    unsigned numRunning_ = 0;
+    /// Seconds passed since first job was scheduled.
+    float elapsedTime_ = 0.0f;
+    /// Estimated number of seconds until remaining jobs complete. 0 when not enough data is available.
+    float remainingTime_ = 0.0f;
+};
+
 class Pipeline : public Object
 {
     URHO3D_OBJECT(Pipeline, Object);
@@ -78,14 +122,20 @@ public:
     bool RemoveFlavor(const ea::string& name);
     /// Rename a custom flavor.
     bool RenameFlavor(const ea::string& oldName, const ea::string& newName);
-    /// Schedules import task to run on worker thread.
-    SharedPtr <WorkItem> ScheduleImport(Asset* asset, Flavor* flavor=nullptr, PipelineBuildFlags flags=PipelineBuildFlag::DEFAULT);
-    /// Executes importers of specified asset asychronously.
-    bool ExecuteImport(Asset* asset, Flavor* flavor, PipelineBuildFlags flags);
+    /// Schedules import task to run on worker thread once it's dependencies are imported. Returns false if asset is already scheduled or does not need importing.
+    bool ScheduleImport(Asset* asset, Flavor* flavor=nullptr, PipelineBuildFlags flags=PipelineBuildFlag::DEFAULT);
+    /// Executes importers of specified asset synchronously. Produced byproducts are added to `byproducts` vector.
+    bool ExecuteImport(Asset* asset, Flavor* flavor, PipelineBuildFlags flags, StringVector& byproducts);
+    /// Handles completed import jobs and dispatches ready ones to worker threads. Must be called from main thread.
+    void DispatchImports();
+    /// Returns true when there are queued or running import jobs.
+    bool IsImporting() const { return !importJobs_.empty(); }
+    /// Returns progress of current batch of import jobs.
+    ImportProgress GetImportProgress() const;
     /// Mass-schedule assets for importing.
     void BuildCache(Flavor* flavor=nullptr, PipelineBuildFlags flags=PipelineBuildFlag::DEFAULT);
-    /// Blocks calling thread until all pipeline tasks complete.
-    void WaitForCompletion() const;
+    /// Blocks calling thread until all pipeline tasks complete. Must be called from main thread.
+    void WaitForCompletion();
     /// Queue packaging of resources for specified flavor. This function returns immediately, however user will be blocked from interacting with editor by modal window until process is done.
     void CreatePaksAsync(Flavor* flavor);
     /// Returns true if resource or any of it's parent directories have non-default flavor settings.
@@ -102,6 +152,8 @@ public:
     bool CookCacheInfo() const;
     /// Watch directory for changed assets and automatically convert them.
     void EnableWatcher();
+    /// Returns content-addressed cache of importer outputs.
+    ImportCache* GetImportCache() const { return importCache_; }
 
     /// Emitted when changes are detected in any resource folder. Signal may fire multiple times per frame if multiple changes were detected (unlikely).
     Signal<void(const FileChange& change)> onResourceChanged_;
@@ -117,6 +169,16 @@ protected:
     void OnImporterModified(StringHash, VariantMap& args);
     /// Render a pipeline tab in settings window.
     void RenderSettingsUI();
+    /// Apply import cache settings.
+    void UpdateImportCache();
+    /// Returns existing job of importing asset in specified flavor or creates a new one along with jobs of it's dependencies. Returns null if asset does not need importing.
+    ImportJob* QueueImportJob(Asset* asset, Flavor* flavor, PipelineBuildFlags flags);
+    /// Returns true if job does not exceed concurrency limits of it's importers.
+    bool CanDispatch(ImportJob* job);
+    /// Handles import job completion on main thread.
+    void CompleteImportJob(ImportJob* job);
+    /// Render import progress in main menu bar.
+    void RenderImportProgress();
 
     /// List of file watchers responsible for watching game data folders for asset changes.
     MultiFileWatcher watcher_;
@@ -136,6 +198,22 @@ protected:
     Mutex mutex_;
     /// A list of assets that were modified in non-main thread and need to be saved on main thread.
     ea::vector<SharedPtr<Asset>> dirtyAssets_;
+    /// Queued and running import jobs. Key is "flavor:resource".
+    ea::unordered_map<ea::string, SharedPtr<ImportJob>> importJobs_;
+    /// Jobs whose dependencies are complete but which were not dispatched yet.
+    ea::vector<SharedPtr<ImportJob>> readyImportJobs_;
+    /// Jobs completed by worker threads. Protected by `mutex_`. Jobs are kept alive by `importJobs_`.
+    ea::vector<ImportJob*> completedImportJobs_;
+    /// Number of running instances of importers with concurrency limit, keyed by importer type.
+    ea::unordered_map<StringHash, unsigned> runningImporters_;
+    /// Number of jobs running on worker threads.
+    unsigned numRunningImportJobs_ = 0;
+    /// Number of jobs completed since pipeline was idle last time.
+    unsigned numCompletedImportJobs_ = 0;
+    /// Number of jobs scheduled since pipeline was idle last time.
+    unsigned numTotalImportJobs_ = 0;
+    /// Measures time since first job of current batch was scheduled.
+    mutable Timer importTimer_;
     /// A list of flavors that are yet to be packaged.
     ea::vector<SharedPtr<Flavor>> pendingPackageFlavor_{};
     /// Current active packager. Null when packaging is not in progress.
@@ -146,6 +224,12 @@ protected:
     Logger logger_ = Log::GetLogger("pipeline");
     /// Flavor that is to be removed (settings window).
     WeakPtr<Flavor> flavorPendingRemoval_;
+    /// Content-addressed cache of importer outputs.
+    SharedPtr<ImportCache> importCache_;
+    /// Flag indicating that importer outputs are cached in project directory.
+    bool useLocalImportCache_ = true;
+    /// Directory of import cache shared between machines. Empty when not used.
+    ea::string sharedImportCachePath_;
 
     friend class Project;
     friend class Asset;
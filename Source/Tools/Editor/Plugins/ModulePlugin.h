@@ -43,6 +43,8 @@ public:
     bool IsOutOfDate() const override;
     /// This function will block until plugin file is complete and ready to be loaded. Returns false if timeout exceeded, but file is still incomplete.
     bool WaitForCompleteFile(unsigned timeoutMs) const override;
+    /// Returns true if plugin can be reloaded while only components of its own types are saved and restored. Managed types are not tracked per plugin.
+    bool IsPartiallyReloadable() const override { return lastModuleType_ == MODULE_NATIVE; }
 
 protected:
     ///
@@ -60,6 +60,8 @@ public:
     virtual bool WaitForCompleteFile(unsigned timeoutMs) const { return true; }
     /// Returns true if user may configure loading or unloading plugin.
     bool IsManagedManually() const { return isManagedManually_; }
+    /// Returns true if plugin can be reloaded while only components of its own types are saved and restored.
+    virtual bool IsPartiallyReloadable() const { return false; }
 
 protected:
     /// Actually unloads the module. Called by %PluginManager at the end of frame when unloading_ flag is set.
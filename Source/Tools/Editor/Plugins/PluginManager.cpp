@@ -109,6 +109,10 @@ void PluginManager::OnEndFrame()
     if (checkOutOfDatePlugins)
         updateCheckTimer_.Reset();
 
+    // Find plugins that are going to be unloaded or reloaded this frame
+    ea::vector<Plugin*> outOfDatePlugins;
+    bool partialReload = true;
+    VariantVector reloadedTypes;
     for (Plugin* plugin : plugins_)
     {
         if (plugin->application_.Null())
@@ -124,11 +128,34 @@ void PluginManager::OnEndFrame()
                 pluginOutOfDate = checkOutOfDatePlugins && plugin->IsOutOfDate();
         }
 
+        if (pluginOutOfDate)
+            outOfDatePlugins.push_back(plugin);
+
+        if (plugin->unloading_ || pluginOutOfDate)
+        {
+            partialReload &= plugin->IsPartiallyReloadable();
+            for (const auto& type : plugin->application_->GetRegisteredTypes())
+                reloadedTypes.push_back(type.first);
+        }
+    }
+
+    for (Plugin* plugin : plugins_)
+    {
+        if (plugin->application_.Null())
+            continue;
+
+        const bool pluginOutOfDate = outOfDatePlugins.contains(plugin);
+
         if (plugin->unloading_ || pluginOutOfDate)
         {
             if (!eventSent)
             {
-                SendEvent(E_EDITORUSERCODERELOADSTART);
+                // Components of the reloaded types are saved and removed, so that no instances outlive their code
+                using namespace EditorUserCodeReloadStart;
+                VariantMap& eventData = GetEventDataMap();
+                eventData[P_PARTIAL] = partialReload;
+                eventData[P_TYPES] = reloadedTypes;
+                SendEvent(E_EDITORUSERCODERELOADSTART, eventData);
                 eventSent = true;
             }
 
@@ -115,13 +115,28 @@ void PreviewTab::OnReloadFinished(StringHash type, VariantMap& args)
 
 void PreviewTab::OnEditorUserCodeReloadStart(StringHash type, VariantMap& args)
 {
-    // On plugin code reload all scene state is serialized, plugin library is reloaded and scene state is unserialized.
-    // This way scene recreates all plugin-provided components on reload and gets to use new versions of them.
+    using namespace EditorUserCodeReloadStart;
+
     auto* tab = GetSubsystem<Editor>()->GetTab<SceneTab>();
     if (tab == nullptr || tab->GetScene() == nullptr)
         return;
 
     undo_->SetTrackingEnabled(false);
+
+    // Native plugins report the types they registered. Only components of these types are saved and recreated,
+    // the rest of the scene along with its resources and GPU state stays in place.
+    partialReload_ = args[P_PARTIAL].GetBool();
+    if (partialReload_)
+    {
+        ea::hash_set<StringHash> types;
+        for (const Variant& reloadedType : args[P_TYPES].GetVariantVector())
+            types.insert(reloadedType.GetStringHash());
+        pluginComponentsState_.Save(tab->GetScene(), types);
+        return;
+    }
+
+    // Otherwise all scene state is serialized, plugin library is reloaded and scene state is unserialized.
+    // This way scene recreates all plugin-provided components on reload and gets to use new versions of them.
     tab->SaveState(sceneReloadState_);
     tab->GetScene()->RemoveAllChildren();
     tab->GetScene()->RemoveAllComponents();
@@ -133,7 +148,10 @@ void PreviewTab::OnEditorUserCodeReloadEnd(StringHash type, VariantMap& args)
     if (tab == nullptr || tab->GetScene() == nullptr)
         return;
 
-    tab->RestoreState(sceneReloadState_);
+    if (partialReload_)
+        pluginComponentsState_.Load(tab->GetScene());
+    else
+        tab->RestoreState(sceneReloadState_);
     undo_->SetTrackingEnabled(true);
 }
 
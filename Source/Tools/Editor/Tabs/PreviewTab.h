@@ -109,6 +109,10 @@ protected:
     SceneState sceneState_;
     /// Temporary storage of scene data used when plugins are being reloaded.
     SceneState sceneReloadState_;
+    /// Temporary storage of plugin components used when native plugins are reloaded in place.
+    PluginComponentsState pluginComponentsState_;
+    /// Whether only plugin components were saved on plugin reload.
+    bool partialReload_ = false;
     /// Time since ESC was last pressed. Used for double-press ESC to exit scene simulation.
     unsigned lastEscPressTime_ = 0;
     /// Flag indicating game view assumed control of the input.
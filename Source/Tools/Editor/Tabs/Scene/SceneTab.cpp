@@ -503,6 +503,10 @@ void SceneTab::OnNodeSelectionChanged()
     {
         for (Component* component : lastInspectedNode->GetComponents())
             inspector->Inspect(component, GetScene());
+
+        // Reveal node selected in viewport.
+        if (Node* parent = lastInspectedNode->GetParent())
+            ExpandHierarchyNode(parent);
     }
 
     editor->GetTab<HierarchyTab>()->SetProvider(this);
@@ -510,60 +514,144 @@ void SceneTab::OnNodeSelectionChanged()
 
 void SceneTab::RenderHierarchy()
 {
-    if (performRangeSelectionFrame_ != ui::GetFrameCount())
-        selectionRect_ = {ui::GetMousePos(), ui::GetMousePos()};
-
     if (auto* scene = GetScene())
     {
+        bool analyze = false;
+        if (ui::Checkbox("Complexity heatmap", &showComplexityHeatmap_))
+            analyze = showComplexityHeatmap_;
+        if (showComplexityHeatmap_)
+        {
+            ui::SameLine();
+            analyze |= ui::Button("Refresh");
+        }
+        if (analyze)
+        {
+            if (!complexityAnalyzer_)
+                complexityAnalyzer_ = MakeShared<SceneComplexityAnalyzer>(context_);
+            complexityAnalyzer_->Analyze(scene);
+        }
+
+        if (hierarchyDirty_ || hierarchyScene_ != scene)
+            UpdateHierarchyRows();
+
+        // Only rows in the visible part of the window are rendered, so large scenes do not slow down the editor
         ui::PushStyleVar(ImGuiStyleVar_IndentSpacing, 10);
-        RenderNodeTree(scene);
+        const float rowsStartY = ui::GetCursorPosY();
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(hierarchyRows_.size()));
+        float rowHeight = 0.0f;
+        while (clipper.Step())
+        {
+            rowHeight = clipper.ItemsHeight;
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+                RenderHierarchyRow(static_cast<unsigned>(i));
+        }
         ui::PopStyleVar();
-    }
 
-    // Perform range selection on next frame. Only then we can have a rectangle covering selection ends
-    // which we need to do range selection.
-    if (ui::IsWindowHovered())
-    {
-        if (ui::IsMouseClicked(MOUSEB_LEFT) && ui::IsKeyDown(SCANCODE_SHIFT) && !selectedNodes_.empty())
-            performRangeSelectionFrame_ = ui::GetFrameCount() + 1;
+        if (scrollTo_ && !hierarchyDirty_ && rowHeight > 0.0f)
+        {
+            for (unsigned i = 0; i < hierarchyRows_.size(); ++i)
+            {
+                if (hierarchyRows_[i].node_ == scrollTo_ && !hierarchyRows_[i].component_)
+                {
+                    ui::SetScrollFromPosY(rowsStartY + i * rowHeight - ui::GetScrollY());
+                    break;
+                }
+            }
+            scrollTo_ = nullptr;
+        }
     }
 }
 
-void SceneTab::RenderNodeTree(Node* node)
+void SceneTab::RenderHierarchyRow(unsigned index)
 {
-    if (node == nullptr)
+    const SceneHierarchyRow& row = hierarchyRows_[index];
+    Node* node = row.node_;
+    Component* component = row.component_;
+    if (!node || (row.isComponent_ && !component))
+    {
+        // Removed during this frame, rows are rebuilt on the next one
+        ui::TextUnformatted("");
         return;
+    }
 
-    ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow
-        | ImGuiTreeNodeFlags_OpenOnDoubleClick
-        | ImGuiTreeNodeFlags_SpanAvailWidth;
-    if (node->GetParent() == nullptr)
-        flags |= ImGuiTreeNodeFlags_DefaultOpen;
+    ui::SetCursorPosX(ui::GetCursorPosX() + row.depth_ * ui::GetStyle().IndentSpacing);
 
-    if (node->IsTemporary() || node->HasTag("__EDITOR_OBJECT__"))
-        return;
+    if (row.isComponent_)
+    {
+        ui::PushID(component);
 
-    if (node == scrollTo_.Get())
-        ui::SetScrollHereY();
+        ui::Image(component->GetTypeName());
+        ui::SameLine();
 
-    ea::string name = node->GetName().empty() ? ToString("%s %d", node->GetTypeName().c_str(), node->GetID()) : node->GetName();
+        bool selected = selectedComponents_.contains(row.component_);
+        ui::Selectable(component->GetTypeName().c_str(), selected);
+
+        if (ui::IsItemHovered(ImGuiHoveredFlags_AllowWhenBlockedByPopup))
+        {
+            if (ui::IsMouseClicked(MOUSEB_LEFT))
+            {
+                if (!ui::IsKeyDown(SCANCODE_CTRL))
+                    ClearSelection();
+                Select(component);
+            }
+            else if (ui::IsMouseReleased(MOUSEB_RIGHT) && ImLengthSqr(ui::GetMouseDragDelta(MOUSEB_RIGHT)) == 0.0f)
+            {
+                if (!IsSelected(component))
+                {
+                    ClearSelection();
+                    Select(component);
+                }
+                ui::OpenPopupEx(ui::GetID("Node context menu"));
+            }
+        }
+
+        RenderNodeContextMenu();
+
+        ui::PopID();
+        return;
+    }
+
+    // Children are separate rows, so tree node does not push anything and expanded state is tracked by the tab
+    ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow
+        | ImGuiTreeNodeFlags_OpenOnDoubleClick
+        | ImGuiTreeNodeFlags_SpanAvailWidth
+        | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+    if (!row.hasChildren_)
+        flags |= ImGuiTreeNodeFlags_Leaf;
     if (IsSelected(node))
         flags |= ImGuiTreeNodeFlags_Selected;
 
+    ea::string name = node->GetName().empty() ? ToString("%s %d", node->GetTypeName().c_str(), node->GetID()) : node->GetName();
+
     ui::Image("Node");
     ui::SameLine();
     ui::PushID((void*)node);
-    auto opened = ui::TreeNodeEx(name.c_str(), flags);
-    ImRect treeNodeRect = {ui::GetItemRectMin(), ui::GetItemRectMax()};
-    auto it = openHierarchyNodes_.find(node);
-    if (it != openHierarchyNodes_.end())
+    const bool showHeat = showComplexityHeatmap_ && complexityAnalyzer_;
+    if (showHeat)
     {
-        if (!opened)
-        {
-            ui::OpenTreeNode(ui::GetCurrentWindow()->GetID(name.c_str()));
-            opened = true;
-        }
-        openHierarchyNodes_.erase(it);
+        // Blend from default text color to red by the node share of scene draw calls
+        const float heat = Sqrt(complexityAnalyzer_->GetHeat(node));
+        const ImVec4& textColor = ui::GetStyle().Colors[ImGuiCol_Text];
+        ui::PushStyleColor(ImGuiCol_Text, ImLerp(textColor, ImVec4(1.0f, 0.2f, 0.2f, 1.0f), heat));
+    }
+    const bool expanded = expandedNodes_.contains(row.node_);
+    ui::SetNextItemOpen(expanded);
+    const bool opened = ui::TreeNodeEx(name.c_str(), flags);
+    if (showHeat)
+    {
+        ui::PopStyleColor();
+        if (ui::IsItemHovered())
+            RenderNodeComplexity(node);
+    }
+
+    if (row.hasChildren_ && opened != expanded)
+    {
+        if (opened)
+            expandedNodes_.insert(row.node_);
+        else
+            expandedNodes_.erase(row.node_);
+        hierarchyDirty_ = true;
     }
 
     if (ui::BeginDragDropSource())
@@ -582,37 +670,48 @@ void SceneTab::RenderNodeTree(Node* node)
             if (child && child != node)
             {
                 node->AddChild(child);
-                if (!opened)
-                    openHierarchyNodes_.push_back(node);
+                ExpandHierarchyNode(node);
             }
         }
         ui::EndDragDropTarget();
     }
 
-    if (!opened)
-    {
-        // If TreeNode above is opened, it pushes it's label as an ID to the stack. However if it is not open then no
-        // ID is pushed. This creates a situation where context menu is not properly attached to said tree node due to
-        // missing ID on the stack. To correct this we ensure that ID is always pushed. This allows us to show context
-        // menus even for closed tree nodes.
-        ui::PushID(name.c_str());
-    }
-
-    // Popup may delete node. Weak reference will convey that information.
-    WeakPtr<Node> nodeRef(node);
-
     if (ui::IsItemHovered(ImGuiHoveredFlags_AllowWhenBlockedByPopup))
     {
         if (ui::IsMouseClicked(MOUSEB_LEFT))
         {
-            // Select single node.
-            if (!ui::IsKeyDown(SCANCODE_SHIFT) && !ui::IsKeyDown(SCANCODE_CTRL))
-                ClearSelection();
+            if (ui::IsKeyDown(SCANCODE_SHIFT) && hierarchyRangeAnchor_)
+            {
+                // Range-select all node rows between previously clicked node and this one.
+                unsigned anchorIndex = index;
+                for (unsigned i = 0; i < hierarchyRows_.size(); ++i)
+                {
+                    if (hierarchyRows_[i].node_ == hierarchyRangeAnchor_ && !hierarchyRows_[i].isComponent_)
+                    {
+                        anchorIndex = i;
+                        break;
+                    }
+                }
 
-            if (ui::IsKeyDown(SCANCODE_SHIFT))
-                Select(node);
+                if (!ui::IsKeyDown(SCANCODE_CTRL))
+                    ClearSelection();
+
+                ea::vector<Node*> rangeNodes;
+                for (unsigned i = Min(anchorIndex, index); i <= Max(anchorIndex, index); ++i)
+                {
+                    if (!hierarchyRows_[i].isComponent_ && hierarchyRows_[i].node_)
+                        rangeNodes.push_back(hierarchyRows_[i].node_);
+                }
+                Select(rangeNodes);
+            }
             else
+            {
+                // Select single node.
+                if (!ui::IsKeyDown(SCANCODE_CTRL))
+                    ClearSelection();
                 ToggleSelection(node);
+                hierarchyRangeAnchor_ = node;
+            }
         }
         else if (ui::IsMouseReleased(MOUSEB_RIGHT) && ImLengthSqr(ui::GetMouseDragDelta(MOUSEB_RIGHT)) == 0.0f)
         {
@@ -625,91 +724,98 @@ void SceneTab::RenderNodeTree(Node* node)
         }
     }
 
-    if (IsSelected(node))
-        selectionRect_.Add(treeNodeRect);
+    RenderNodeContextMenu();
 
-    // Range-select by shift-clicking an item.
-    if (performRangeSelectionFrame_ == ui::GetFrameCount())
-    {
-        if (selectionRect_.Contains(treeNodeRect.Min))
-        {
-            Select(node);
-            selectionRect_.Add(treeNodeRect.Min);
-        }
-    }
+    ui::PopID();
+}
 
-    RenderNodeContextMenu();
+void SceneTab::UpdateHierarchyRows()
+{
+    hierarchyRows_.clear();
+    hierarchyDirty_ = false;
 
-    if (opened)
+    Scene* scene = GetScene();
+    if (hierarchyScene_ != scene)
     {
-        if (!nodeRef.Expired())
-        {
-            ea::vector<SharedPtr<Component>> components = node->GetComponents();
-            for (const auto& component: components)
-            {
-                if (component->IsTemporary())
-                    continue;
-
-                ui::PushID(component);
+        // Scene root is expanded by default
+        hierarchyScene_ = scene;
+        expandedNodes_.clear();
+        expandedNodes_.insert(WeakPtr<Node>(scene));
+    }
 
-                ui::Image(component->GetTypeName());
-                ui::SameLine();
+    if (scene)
+        AddHierarchyRows(scene, 0);
+}
 
-                bool selected = selectedComponents_.contains(component);
-                ui::Selectable(component->GetTypeName().c_str(), selected);
+void SceneTab::AddHierarchyRows(Node* node, unsigned depth)
+{
+    if (node->IsTemporary() || node->HasTag("__EDITOR_OBJECT__"))
+        return;
 
-                if (ui::IsItemHovered(ImGuiHoveredFlags_AllowWhenBlockedByPopup))
-                {
-                    if (ui::IsMouseClicked(MOUSEB_LEFT))
-                    {
-                        if (!ui::IsKeyDown(SCANCODE_CTRL))
-                            ClearSelection();
-                        Select(component);
-                    }
-                    else if (ui::IsMouseReleased(MOUSEB_RIGHT) && ImLengthSqr(ui::GetMouseDragDelta(MOUSEB_RIGHT)) == 0.0f)
-                    {
-                        if (!IsSelected(component))
-                        {
-                            ClearSelection();
-                            Select(component);
-                        }
-                        ui::OpenPopupEx(ui::GetID("Node context menu"));
-                    }
-                }
+    WeakPtr<Node> nodeRef(node);
+    const unsigned rowIndex = hierarchyRows_.size();
+    hierarchyRows_.push_back({nodeRef, nullptr, depth});
 
+    // Collapsed nodes only need to know whether they have anything to expand
+    const bool expanded = expandedNodes_.contains(nodeRef);
+    bool hasChildren = false;
+    for (const SharedPtr<Component>& component : node->GetComponents())
+    {
+        if (component->IsTemporary())
+            continue;
 
-                RenderNodeContextMenu();
+        hasChildren = true;
+        if (!expanded)
+            break;
+        hierarchyRows_.push_back({nodeRef, WeakPtr<Component>(component), depth + 1, false, true});
+    }
 
-                ui::PopID();
-            }
+    for (const SharedPtr<Node>& child : node->GetChildren())
+    {
+        if (child->IsTemporary() || child->HasTag("__EDITOR_OBJECT__"))
+            continue;
 
-            // Do not use element->GetChildren() because child may be deleted during this loop.
-            ea::vector<Node*> children;
-            node->GetChildren(children);
-            for (Node* child : children)
-            {
-                // ensure the tree is expanded to the currently selected node if there is one node selected.
-                if (selectedNodes_.size() == 1)
-                {
-                    for (auto& selectedNode : selectedNodes_)
-                    {
-                        if (selectedNode.Expired())
-                            continue;
+        hasChildren = true;
+        if (!expanded)
+            break;
+        AddHierarchyRows(child, depth + 1);
+    }
 
-                        if (selectedNode->IsChildOf(child))
-                            ui::SetNextItemOpen(true);
-                    }
-                }
+    hierarchyRows_[rowIndex].hasChildren_ = hasChildren;
+}
 
-                //recursive call.
-                RenderNodeTree(child);
-            }
-        }
-        ui::TreePop();
+void SceneTab::ExpandHierarchyNode(Node* node)
+{
+    for (Node* parent = node; parent != nullptr; parent = parent->GetParent())
+    {
+        if (expandedNodes_.insert(WeakPtr<Node>(parent)).second)
+            hierarchyDirty_ = true;
     }
-    else
-        ui::PopID();
-    ui::PopID();
+}
+
+void SceneTab::RenderNodeComplexity(Node* node)
+{
+    const SceneComplexity* own = complexityAnalyzer_->GetNodeComplexity(node);
+    const SceneComplexity* subtree = complexityAnalyzer_->GetSubtreeComplexity(node);
+    if (!own || !subtree)
+        return;
+
+    ui::BeginTooltip();
+    ui::Text("Draw calls %u (subtree %u, %.0f%% of scene)", own->GetNumDrawCalls(), subtree->GetNumDrawCalls(),
+        complexityAnalyzer_->GetHeat(node) * 100.0f);
+    ui::Text("Drawables %u, materials %u, techniques %u", subtree->numDrawables_, subtree->numMaterials_,
+        subtree->numTechniques_);
+    ui::Text("Texture memory %.1f MB", subtree->textureMemory_ / (1024.0f * 1024.0f));
+    if (subtree->numLights_)
+        ui::Text("Lights %u, shadow casters %u, shadow draw calls %u", subtree->numLights_, subtree->numShadowCasters_,
+            subtree->numShadowBatches_);
+    if (subtree->numSkinnedBones_)
+        ui::Text("Skinned bones %u", subtree->numSkinnedBones_);
+    if (subtree->numCollisionShapes_)
+        ui::Text("Collision shapes %u (%u triangles)", subtree->numCollisionShapes_, subtree->numCollisionTriangles_);
+    if (subtree->numReplicatedAttributes_)
+        ui::Text("Replicated attributes %u (%u bytes)", subtree->numReplicatedAttributes_, subtree->replicatedBytes_);
+    ui::EndTooltip();
 }
 
 void SceneTab::RemoveSelection()
@@ -818,6 +924,78 @@ void SceneTab::OnUpdate(VariantMap& args)
     }
 }
 
+void PluginComponentsState::Save(Scene* scene, const ea::hash_set<StringHash>& types)
+{
+    componentsState_.Clear();
+    numComponents_ = 0;
+
+    ea::vector<Node*> nodes;
+    scene->GetChildren(nodes, true);
+    nodes.push_front(scene);
+
+    ea::vector<Component*> savedComponents;
+    VectorBuffer componentState;
+    for (Node* node : nodes)
+    {
+        const auto& components = node->GetComponents();
+        for (unsigned i = 0; i < components.size(); ++i)
+        {
+            Component* component = components[i];
+            if (!types.contains(component->GetType()))
+                continue;
+
+            componentState.Clear();
+            component->Save(componentState);
+            componentsState_.WriteUInt(node->GetID());
+            componentsState_.WriteVLE(i);
+            componentsState_.WriteVLE(componentState.GetSize());
+            componentsState_.Write(componentState.GetData(), componentState.GetSize());
+            savedComponents.push_back(component);
+            ++numComponents_;
+        }
+    }
+
+    for (Component* component : savedComponents)
+        component->Remove();
+}
+
+void PluginComponentsState::Load(Scene* scene)
+{
+    componentsState_.Seek(0);
+
+    // Components are restored in the order they were saved, so reordering puts each back to its original index
+    ea::vector<Component*> restoredComponents;
+    for (unsigned i = 0; i < numComponents_; ++i)
+    {
+        const unsigned nodeID = componentsState_.ReadUInt();
+        const unsigned index = componentsState_.ReadVLE();
+        VectorBuffer componentState(componentsState_, componentsState_.ReadVLE());
+
+        Node* node = scene->GetNode(nodeID);
+        if (!node)
+            continue;
+
+        const StringHash type = componentState.ReadStringHash();
+        const unsigned componentID = componentState.ReadUInt();
+        Component* component = node->CreateComponent(type, Scene::IsReplicatedID(componentID) ? REPLICATED : LOCAL, componentID);
+        if (!component)
+        {
+            URHO3D_LOGWARNING("Component of type {} was not restored after reloading plugins", type.ToString());
+            continue;
+        }
+
+        component->Load(componentState);
+        node->ReorderComponent(component, index);
+        restoredComponents.push_back(component);
+    }
+
+    for (Component* component : restoredComponents)
+        component->ApplyAttributes();
+
+    componentsState_.Clear();
+    numComponents_ = 0;
+}
+
 void SceneTab::SaveState(SceneState& destination)
 {
     UndoTrackGuard tracking(undo_, false);
@@ -842,6 +1020,7 @@ void SceneTab::SaveState(SceneState& destination)
 void SceneTab::RestoreState(SceneState& source)
 {
     UndoTrackGuard tracking(undo_, false);
+    hierarchyDirty_ = true;
 
     VectorBuffer editorObjectsState;
     if (Node* editorObjects = GetScene()->GetChild("EditorObjects"))
@@ -902,8 +1081,7 @@ void SceneTab::RenderNodeContextMenu()
                     if (!selectedNode.Expired())
                     {
                         newNodes.push_back(selectedNode->CreateChild(EMPTY_STRING, alternative ? LOCAL : REPLICATED));
-                        openHierarchyNodes_.push_back(selectedNode);
-                        openHierarchyNodes_.push_back(newNodes.back());
+                        ExpandHierarchyNode(selectedNode);
                         scrollTo_ = newNodes.back();
                     }
                 }
@@ -943,7 +1121,7 @@ void SceneTab::RenderNodeContextMenu()
                                     {
                                         if (selectedNode->CreateComponent(StringHash(component), alternative ? LOCAL : REPLICATED))
                                         {
-                                            openHierarchyNodes_.push_back(selectedNode);
+                                            ExpandHierarchyNode(selectedNode);
                                             OnNodeSelectionChanged();
                                         }
                                     }
@@ -1058,6 +1236,7 @@ void SceneTab::OnComponentAdded(VariantMap& args)
     using namespace ComponentAdded;
     auto* component = static_cast<Component*>(args[P_COMPONENT].GetPtr());
     AddComponentIcon(component);
+    hierarchyDirty_ = true;
 }
 
 void SceneTab::OnComponentRemoved(VariantMap& args)
@@ -1065,11 +1244,13 @@ void SceneTab::OnComponentRemoved(VariantMap& args)
     using namespace ComponentRemoved;
     auto* component = static_cast<Component*>(args[P_COMPONENT].GetPtr());
     RemoveComponentIcon(component);
+    hierarchyDirty_ = true;
 }
 
 void SceneTab::OnTemporaryChanged(VariantMap& args)
 {
     using namespace TemporaryChanged;
+    hierarchyDirty_ = true;
     if (Component* component = dynamic_cast<Component*>(args[P_SERIALIZABLE].GetPtr()))
     {
         if (component->IsTemporary())
@@ -1087,6 +1268,8 @@ void SceneTab::OnSceneActivated(VariantMap& args)
         SubscribeToEvent(scene, E_COMPONENTADDED, [this](StringHash, VariantMap& args) { OnComponentAdded(args); });
         SubscribeToEvent(scene, E_COMPONENTREMOVED, [this](StringHash, VariantMap& args) { OnComponentRemoved(args); });
         SubscribeToEvent(scene, E_TEMPORARYCHANGED, [this](StringHash, VariantMap& args) { OnTemporaryChanged(args); });
+        SubscribeToEvent(scene, E_NODEADDED, [this](StringHash, VariantMap&) { hierarchyDirty_ = true; });
+        SubscribeToEvent(scene, E_NODEREMOVED, [this](StringHash, VariantMap&) { hierarchyDirty_ = true; });
 
         undo_->Connect(scene, this);
 
@@ -1466,11 +1649,19 @@ void SceneTab::RenderDebugInfo()
     if (debug == nullptr)
         return;
 
-    auto renderDebugInfo = [debug](Component* component) {
+    // Large selections may contain many drawables outside of view, skip them before generating debug lines
+    Camera* camera = GetCamera();
+    const Frustum frustum = camera ? camera->GetFrustum() : Frustum{};
+
+    auto renderDebugInfo = [debug, camera, &frustum](Component* component) {
         if (auto* light = component->Cast<Light>())
             light->DrawDebugGeometry(debug, true);
         else if (auto* drawable = component->Cast<Drawable>())
-            debug->AddBoundingBox(drawable->GetWorldBoundingBox(), Color::WHITE);
+        {
+            const BoundingBox& boundingBox = drawable->GetWorldBoundingBox();
+            if (!camera || frustum.IsInsideFast(boundingBox) != OUTSIDE)
+                debug->AddBoundingBox(boundingBox, Color::WHITE);
+        }
         else if (!component->IsInstanceOf<Terrain>())
             component->DrawDebugGeometry(debug, true);
     };
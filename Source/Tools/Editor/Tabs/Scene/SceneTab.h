@@ -28,6 +28,7 @@
 #include <Toolbox/SystemUI/AttributeInspector.h>
 #include <Toolbox/SystemUI/Gizmo.h>
 #include <Toolbox/Graphics/SceneView.h>
+#include <Toolbox/Scene/SceneComplexity.h>
 #include "Tabs/BaseResourceTab.h"
 #include "Tabs/Scene/SceneClipboard.h"
 
@@ -60,6 +61,35 @@ struct SceneState
     VectorBuffer sceneState_;
 };
 
+/// Components of reloaded plugin types, saved while the plugin module is swapped. Rest of the scene stays in place.
+struct PluginComponentsState
+{
+    /// Save components of the specified types and remove them from the scene.
+    void Save(Scene* scene, const ea::hash_set<StringHash>& types);
+    /// Recreate saved components from the reloaded factories and restore their attributes.
+    void Load(Scene* scene);
+
+    /// Node ID, component index and component data of each saved component.
+    VectorBuffer componentsState_;
+    /// Number of saved components.
+    unsigned numComponents_{};
+};
+
+/// Single row of flattened scene hierarchy.
+struct SceneHierarchyRow
+{
+    ///
+    WeakPtr<Node> node_;
+    /// Component displayed by this row, only valid when isComponent_ is set.
+    WeakPtr<Component> component_;
+    ///
+    unsigned depth_{};
+    /// Node has visible children or components.
+    bool hasChildren_{};
+    ///
+    bool isComponent_{};
+};
+
 class SceneTab : public BaseResourceTab, public IHierarchyProvider
 {
     URHO3D_OBJECT(SceneTab, BaseResourceTab);
@@ -157,8 +187,16 @@ public:
     void Close() override;
 
 protected:
-    /// Render scene hierarchy window starting from specified node.
-    void RenderNodeTree(Node* node);
+    /// Render a single row of scene hierarchy.
+    void RenderHierarchyRow(unsigned index);
+    /// Rebuild flat list of visible hierarchy rows.
+    void UpdateHierarchyRows();
+    /// Append hierarchy rows of the node and its expanded children.
+    void AddHierarchyRows(Node* node, unsigned depth);
+    /// Expand hierarchy entries of the node and all its parents.
+    void ExpandHierarchyNode(Node* node);
+    /// Render complexity tooltip of a hierarchy node.
+    void RenderNodeComplexity(Node* node);
     /// Called when node selection changes.
     void OnNodeSelectionChanged();
     /// Render content of the tab window.
@@ -216,8 +254,16 @@ protected:
     bool isClickedLeft_ = false;
     /// Flag indicating that right mouse button was clicked on scene viewport.
     bool isClickedRight_ = false;
-    /// Nodes whose entries in hierarchy tree should be opened on next frame.
-    ea::vector<Node*> openHierarchyNodes_;
+    /// Flat list of hierarchy rows of expanded nodes.
+    ea::vector<SceneHierarchyRow> hierarchyRows_;
+    /// Nodes that are expanded in hierarchy tree.
+    ea::hash_set<WeakPtr<Node>> expandedNodes_;
+    /// Scene for which hierarchy rows were built.
+    WeakPtr<Scene> hierarchyScene_;
+    /// Flag indicating that hierarchy rows have to be rebuilt.
+    bool hierarchyDirty_ = true;
+    /// Node that was clicked last, used as a start of range selection.
+    WeakPtr<Node> hierarchyRangeAnchor_;
     /// Node to scroll to on next frame.
     WeakPtr<Node> scrollTo_;
     /// Selected camera preview texture.
@@ -232,14 +278,14 @@ protected:
     ea::vector<unsigned> savedComponentSelection_;
     ///
     bool debugHudVisible_ = false;
-    /// Rectangle encompassing all selected nodes.
-    ImRect selectionRect_{};
-    /// Frame on which range selection will be performed.
-    int performRangeSelectionFrame_ = -1;
     /// We have to use our own because drawlist splitter may be used by other widgets.
     ImDrawListSplitter viewportSplitter_{};
     /// Distance from the camera that manipulator will rotate around.
     float rotateAroundDistance_ = 1;
+    /// Scene complexity analyzer used for hierarchy heatmap.
+    SharedPtr<SceneComplexityAnalyzer> complexityAnalyzer_;
+    /// Flag indicating that hierarchy nodes are colored by their estimated cost.
+    bool showComplexityHeatmap_ = false;
 };
 
 };
@@ -0,0 +1,179 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+// Command line utility always uses console.
+#define URHO3D_WIN32_CONSOLE
+
+#include <Urho3D/Core/CommandLine.h>
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Engine/Application.h>
+#include <Urho3D/Engine/Engine.h>
+#include <Urho3D/Engine/EngineDefs.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/IO/Log.h>
+#include <Urho3D/Resource/ResourceCache.h>
+#include <Urho3D/Scene/Scene.h>
+#include <Toolbox/Scene/SceneComplexity.h>
+
+#include <EASTL/sort.h>
+
+using namespace Urho3D;
+
+class SceneAnalyzerApplication : public Application
+{
+    URHO3D_OBJECT(SceneAnalyzerApplication, Application);
+public:
+    explicit SceneAnalyzerApplication(Context* context) : Application(context)
+    {
+    }
+
+    void Setup() override
+    {
+        engineParameters_[EP_ENGINE_CLI_PARAMETERS] = false;
+        engineParameters_[EP_SOUND] = false;
+        engineParameters_[EP_HEADLESS] = true;
+        engineParameters_[EP_LOG_LEVEL] = LOG_WARNING;
+
+        auto& app = GetCommandLineParser();
+        app.add_option("-d,--resource-dir", resourceDirs_, "Resource directory used to load scene dependencies. May be repeated.");
+        app.add_option("-j,--json", jsonFileName_, "Write full report to JSON file.");
+        app.add_option("-r,--region-size", regionSize_, "Size of square regions on the XZ plane.");
+        app.add_option("-n,--top", numTop_, "Number of most expensive nodes and regions to print.");
+        app.add_option("scene", sceneFileName_, "Scene file (xml/json/binary).")->required();
+    }
+
+    void Start() override
+    {
+        auto* cache = GetSubsystem<ResourceCache>();
+        for (const std::string& dir : resourceDirs_)
+            cache->AddResourceDir(dir.c_str());
+
+        SharedPtr<Scene> scene = LoadScene();
+        if (!scene)
+        {
+            PrintLine(Format("Could not load scene '{}'.", sceneFileName_), true);
+            exitCode_ = EXIT_FAILURE;
+            engine_->Exit();
+            return;
+        }
+
+        auto analyzer = MakeShared<SceneComplexityAnalyzer>(context_);
+        analyzer->SetRegionSize(regionSize_);
+        analyzer->Analyze(scene);
+
+        PrintReport(scene, analyzer);
+
+        if (!jsonFileName_.empty() && !analyzer->SaveFile(jsonFileName_))
+            exitCode_ = EXIT_FAILURE;
+
+        engine_->Exit();
+    }
+
+private:
+    /// Load scene from file in any supported format.
+    SharedPtr<Scene> LoadScene()
+    {
+        auto scene = MakeShared<Scene>(context_);
+        File file(context_);
+        if (!file.Open(sceneFileName_))
+            return nullptr;
+
+        const ea::string extension = GetExtension(sceneFileName_);
+        bool loaded = false;
+        if (extension == ".xml")
+            loaded = scene->LoadXML(file);
+        else if (extension == ".json")
+            loaded = scene->LoadJSON(file);
+        else
+            loaded = scene->Load(file);
+        return loaded ? scene : nullptr;
+    }
+
+    /// Print summary, lights and the most expensive nodes and regions.
+    void PrintReport(Scene* scene, SceneComplexityAnalyzer* analyzer)
+    {
+        const SceneComplexity& total = analyzer->GetTotal();
+        PrintLine(Format("Nodes {}, drawables {}, estimated draw calls {} (base {}, lit {}, shadow {})",
+            total.numNodes_, total.numDrawables_, total.GetNumDrawCalls(), total.numBatches_, total.numLitBatches_,
+            total.numShadowBatches_));
+        PrintLine(Format("Materials {}, techniques {}, texture memory {:.1f} MB", total.numMaterials_,
+            total.numTechniques_, total.textureMemory_ / (1024.0 * 1024.0)));
+        PrintLine(Format("Lights {} (shadowed {}), skinned bones {}", total.numLights_, total.numShadowedLights_,
+            total.numSkinnedBones_));
+        PrintLine(Format("Collision shapes {} ({} triangles), replicated attributes {} ({} bytes)",
+            total.numCollisionShapes_, total.numCollisionTriangles_, total.numReplicatedAttributes_,
+            total.replicatedBytes_));
+
+        for (const LightComplexity& light : analyzer->GetLights())
+        {
+            PrintLine(Format("  Light {} '{}': lit drawables {}, shadow casters {}, shadow draw calls {}", light.nodeID_,
+                light.nodeName_, light.numLitDrawables_, light.numShadowCasters_, light.numShadowBatches_));
+        }
+
+        ea::vector<Node*> nodes;
+        scene->GetChildren(nodes, true);
+        // Temporary nodes are not analyzed
+        nodes.erase(ea::remove_if(nodes.begin(), nodes.end(),
+            [&](Node* node) { return !analyzer->GetNodeComplexity(node); }), nodes.end());
+        ea::sort(nodes.begin(), nodes.end(), [&](Node* lhs, Node* rhs)
+        {
+            return analyzer->GetNodeComplexity(lhs)->GetNumDrawCalls() > analyzer->GetNodeComplexity(rhs)->GetNumDrawCalls();
+        });
+
+        PrintLine("Most expensive nodes:");
+        for (unsigned i = 0; i < Min(numTop_, nodes.size()); ++i)
+        {
+            const SceneComplexity* own = analyzer->GetNodeComplexity(nodes[i]);
+            const SceneComplexity* subtree = analyzer->GetSubtreeComplexity(nodes[i]);
+            if (!own->GetNumDrawCalls())
+                break;
+            PrintLine(Format("  Node {} '{}': draw calls {} (subtree {}), drawables {}, bones {}", nodes[i]->GetID(),
+                nodes[i]->GetName(), own->GetNumDrawCalls(), subtree->GetNumDrawCalls(), own->numDrawables_,
+                own->numSkinnedBones_));
+        }
+
+        PrintLine("Most expensive regions:");
+        const ea::vector<RegionComplexity>& regions = analyzer->GetRegions();
+        for (unsigned i = 0; i < Min(numTop_, regions.size()); ++i)
+        {
+            const RegionComplexity& region = regions[i];
+            PrintLine(Format("  Region ({:g}, {:g})-({:g}, {:g}): draw calls {}, drawables {}, nodes {}", region.box_.min_.x_,
+                region.box_.min_.z_, region.box_.max_.x_, region.box_.max_.z_, region.complexity_.GetNumDrawCalls(),
+                region.complexity_.numDrawables_, region.complexity_.numNodes_));
+        }
+    }
+
+    /// Resource directories.
+    std::vector<std::string> resourceDirs_;
+    /// Scene file.
+    ea::string sceneFileName_;
+    /// JSON report file.
+    ea::string jsonFileName_;
+    /// Region size.
+    float regionSize_{50.0f};
+    /// Number of printed nodes and regions.
+    unsigned numTop_{10};
+};
+
+URHO3D_DEFINE_APPLICATION_MAIN(SceneAnalyzerApplication);
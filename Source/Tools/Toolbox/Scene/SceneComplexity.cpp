@@ -0,0 +1,488 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Graphics/AnimatedModel.h>
+#include <Urho3D/Graphics/Geometry.h>
+#include <Urho3D/Graphics/Light.h>
+#include <Urho3D/Graphics/Material.h>
+#include <Urho3D/Graphics/Model.h>
+#include <Urho3D/Graphics/Technique.h>
+#include <Urho3D/Graphics/Texture.h>
+#include <Urho3D/IO/Log.h>
+#include <Urho3D/IO/VectorBuffer.h>
+#include <Urho3D/Math/Sphere.h>
+#include <Urho3D/Resource/Image.h>
+#include <Urho3D/Resource/JSONFile.h>
+#include <Urho3D/Resource/ResourceCache.h>
+#include <Urho3D/Scene/Scene.h>
+#ifdef URHO3D_PHYSICS
+#include <Urho3D/Physics/CollisionShape.h>
+#endif
+
+#include <EASTL/sort.h>
+
+#include "SceneComplexity.h"
+
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Return serialized size of network attributes, or zero if the object has none.
+unsigned GetReplicatedSize(const Serializable* serializable, unsigned& numAttributes)
+{
+    const ea::vector<AttributeInfo>* attributes = serializable->GetNetworkAttributes();
+    if (!attributes)
+        return 0;
+
+    VectorBuffer buffer;
+    Variant value;
+    for (const AttributeInfo& attr : *attributes)
+    {
+        serializable->OnGetAttribute(attr, value);
+        buffer.WriteVariantData(value);
+    }
+    numAttributes += attributes->size();
+    return buffer.GetSize();
+}
+
+/// Return whether the drawable renders geometry.
+bool IsGeometry(Drawable* drawable)
+{
+    return drawable->IsEnabledEffective() && (drawable->GetDrawableFlags() & DRAWABLE_GEOMETRY);
+}
+
+/// Return number of batches with geometry.
+unsigned GetNumBatches(Drawable* drawable)
+{
+    unsigned numBatches = 0;
+    for (const SourceBatch& batch : drawable->GetBatches())
+    {
+        if (batch.geometry_)
+            ++numBatches;
+    }
+    return numBatches;
+}
+
+/// Return number of shadow map views of the light: cascade splits for directional light and cube faces for point light.
+unsigned GetNumShadowSplits(Light* light)
+{
+    switch (light->GetLightType())
+    {
+    case LIGHT_DIRECTIONAL:
+    {
+        const Vector4& splits = light->GetShadowCascade().splits_;
+        unsigned numSplits = 0;
+        for (unsigned i = 0; i < MAX_CASCADE_SPLITS; ++i)
+        {
+            if (splits.Data()[i] > 0.0f)
+                ++numSplits;
+        }
+        return Max(numSplits, 1u);
+    }
+    case LIGHT_POINT:
+        return 6;
+    default:
+        return 1;
+    }
+}
+
+/// Return whether the drawable is in range of the light.
+bool IsInLightRange(Light* light, Drawable* drawable)
+{
+    const BoundingBox& box = drawable->GetWorldBoundingBox();
+    switch (light->GetLightType())
+    {
+    case LIGHT_DIRECTIONAL:
+        return true;
+    case LIGHT_POINT:
+        return Sphere(light->GetNode()->GetWorldPosition(), light->GetRange()).IsInsideFast(box) != OUTSIDE;
+    default:
+        return light->GetFrustum().IsInsideFast(box) != OUTSIDE;
+    }
+}
+
+}
+
+void SceneComplexity::Accumulate(const SceneComplexity& rhs)
+{
+    numNodes_ += rhs.numNodes_;
+    numDrawables_ += rhs.numDrawables_;
+    numBatches_ += rhs.numBatches_;
+    numLitBatches_ += rhs.numLitBatches_;
+    numShadowBatches_ += rhs.numShadowBatches_;
+    numShadowCasters_ += rhs.numShadowCasters_;
+    numLights_ += rhs.numLights_;
+    numShadowedLights_ += rhs.numShadowedLights_;
+    numSkinnedBones_ += rhs.numSkinnedBones_;
+    numCollisionShapes_ += rhs.numCollisionShapes_;
+    numCollisionTriangles_ += rhs.numCollisionTriangles_;
+    numReplicatedAttributes_ += rhs.numReplicatedAttributes_;
+    replicatedBytes_ += rhs.replicatedBytes_;
+}
+
+void SceneComplexity::Save(JSONValue& dest) const
+{
+    dest.Set("nodes", numNodes_);
+    dest.Set("drawables", numDrawables_);
+    dest.Set("drawCalls", GetNumDrawCalls());
+    dest.Set("batches", numBatches_);
+    dest.Set("litBatches", numLitBatches_);
+    dest.Set("shadowBatches", numShadowBatches_);
+    dest.Set("shadowCasters", numShadowCasters_);
+    dest.Set("lights", numLights_);
+    dest.Set("shadowedLights", numShadowedLights_);
+    dest.Set("skinnedBones", numSkinnedBones_);
+    dest.Set("collisionShapes", numCollisionShapes_);
+    dest.Set("collisionTriangles", numCollisionTriangles_);
+    dest.Set("replicatedAttributes", numReplicatedAttributes_);
+    dest.Set("replicatedBytes", replicatedBytes_);
+    dest.Set("materials", numMaterials_);
+    dest.Set("techniques", numTechniques_);
+    dest.Set("textureMemory", static_cast<double>(textureMemory_));
+}
+
+SceneComplexityAnalyzer::SceneComplexityAnalyzer(Context* context)
+    : Object(context)
+{
+}
+
+void SceneComplexityAnalyzer::Analyze(Scene* scene)
+{
+    nodes_.clear();
+    lights_.clear();
+    regions_.clear();
+    textureMemory_.clear();
+    total_ = {};
+
+    if (!scene)
+        return;
+
+    // Light costs go into the light nodes before the subtree costs are summed up
+    AnalyzeLights(scene);
+
+    ea::hash_set<const void*> materials;
+    ea::hash_set<const void*> techniques;
+    ea::hash_set<const Texture*> textures;
+    total_ = AnalyzeNode(scene, materials, techniques, textures);
+
+    AnalyzeRegions(scene);
+}
+
+const SceneComplexity& SceneComplexityAnalyzer::AnalyzeNode(Node* node, ea::hash_set<const void*>& materials,
+    ea::hash_set<const void*>& techniques, ea::hash_set<const Texture*>& textures)
+{
+    NodeEntry& entry = nodes_[node->GetID()];
+    entry.name_ = node->GetName();
+
+    SceneComplexity& own = entry.own_;
+    own.numNodes_ = 1;
+
+    if (node->IsReplicated())
+        own.replicatedBytes_ += GetReplicatedSize(node, own.numReplicatedAttributes_);
+
+    for (Component* component : node->GetComponents())
+    {
+        if (component->IsReplicated())
+            own.replicatedBytes_ += GetReplicatedSize(component, own.numReplicatedAttributes_);
+
+        if (auto* drawable = dynamic_cast<Drawable*>(component))
+        {
+            if (!IsGeometry(drawable))
+                continue;
+
+            ++own.numDrawables_;
+            own.numBatches_ += GetNumBatches(drawable);
+
+            for (const SourceBatch& batch : drawable->GetBatches())
+            {
+                Material* material = batch.material_;
+                if (!material || !materials.insert(material).second)
+                    continue;
+
+                for (const TechniqueEntry& technique : material->GetTechniques())
+                {
+                    if (technique.original_)
+                        techniques.insert(technique.original_.Get());
+                }
+                for (const auto& unit : material->GetTextures())
+                {
+                    if (unit.second)
+                        textures.insert(unit.second.Get());
+                }
+            }
+
+            if (auto* animatedModel = dynamic_cast<AnimatedModel*>(drawable))
+                own.numSkinnedBones_ += animatedModel->GetSkeleton().GetNumBones();
+        }
+#ifdef URHO3D_PHYSICS
+        else if (auto* shape = dynamic_cast<CollisionShape*>(component))
+        {
+            ++own.numCollisionShapes_;
+
+            const ShapeType shapeType = shape->GetShapeType();
+            Model* model = shape->GetModel();
+            if (model && (shapeType == SHAPE_TRIANGLEMESH || shapeType == SHAPE_CONVEXHULL || shapeType == SHAPE_GIMPACTMESH))
+            {
+                for (unsigned i = 0; i < model->GetNumGeometries(); ++i)
+                {
+                    if (Geometry* geometry = model->GetGeometry(i, shape->GetLodLevel()))
+                        own.numCollisionTriangles_ += (geometry->GetIndexCount() ? geometry->GetIndexCount() : geometry->GetVertexCount()) / 3;
+                }
+            }
+        }
+#endif
+    }
+
+    own.numMaterials_ = materials.size();
+    own.numTechniques_ = techniques.size();
+    own.textureMemory_ = 0;
+    for (const Texture* texture : textures)
+        own.textureMemory_ += GetTextureMemory(texture);
+
+    SceneComplexity subtree = own;
+    for (Node* child : node->GetChildren())
+    {
+        if (child->IsTemporary())
+            continue;
+
+        ea::hash_set<const void*> childMaterials;
+        ea::hash_set<const void*> childTechniques;
+        ea::hash_set<const Texture*> childTextures;
+        subtree.Accumulate(AnalyzeNode(child, childMaterials, childTechniques, childTextures));
+
+        materials.insert(childMaterials.begin(), childMaterials.end());
+        techniques.insert(childTechniques.begin(), childTechniques.end());
+        textures.insert(childTextures.begin(), childTextures.end());
+    }
+
+    subtree.numMaterials_ = materials.size();
+    subtree.numTechniques_ = techniques.size();
+    subtree.textureMemory_ = 0;
+    for (const Texture* texture : textures)
+        subtree.textureMemory_ += GetTextureMemory(texture);
+
+    // Children may have rehashed the map, look the entry up again
+    NodeEntry& result = nodes_[node->GetID()];
+    result.subtree_ = subtree;
+    return result.subtree_;
+}
+
+void SceneComplexityAnalyzer::AnalyzeLights(Scene* scene)
+{
+    ea::vector<Drawable*> drawables;
+    scene->GetDerivedComponents<Drawable>(drawables, true);
+
+    ea::vector<Light*> lights;
+    scene->GetComponents<Light>(lights, true);
+
+    for (Light* light : lights)
+    {
+        if (!light->IsEnabledEffective() || light->GetNode()->IsTemporary())
+            continue;
+
+        const bool isShadowed = light->GetCastShadows();
+        const bool isPerVertex = light->GetPerVertex();
+        const unsigned lightMask = light->GetLightMask();
+        const unsigned numSplits = GetNumShadowSplits(light);
+
+        LightComplexity lightStats;
+        lightStats.nodeID_ = light->GetNode()->GetID();
+        lightStats.nodeName_ = light->GetNode()->GetName();
+
+        SceneComplexity& own = nodes_[lightStats.nodeID_].own_;
+        ++own.numLights_;
+        if (isShadowed)
+            ++own.numShadowedLights_;
+
+        for (Drawable* drawable : drawables)
+        {
+            if (drawable == light || !IsGeometry(drawable) || !IsInLightRange(light, drawable))
+                continue;
+
+            const unsigned numBatches = GetNumBatches(drawable);
+            if (drawable->GetLightMask() & lightMask)
+            {
+                ++lightStats.numLitDrawables_;
+                // Directional and per-vertex lights are usually merged into the base pass
+                if (light->GetLightType() != LIGHT_DIRECTIONAL && !isPerVertex)
+                    own.numLitBatches_ += numBatches;
+            }
+
+            if (isShadowed && drawable->GetCastShadows() && (drawable->GetShadowMask() & lightMask))
+            {
+                ++lightStats.numShadowCasters_;
+                lightStats.numShadowBatches_ += numBatches * numSplits;
+            }
+        }
+
+        own.numShadowCasters_ += lightStats.numShadowCasters_;
+        own.numShadowBatches_ += lightStats.numShadowBatches_;
+        lights_.push_back(lightStats);
+    }
+}
+
+void SceneComplexityAnalyzer::AnalyzeRegions(Scene* scene)
+{
+    ea::unordered_map<IntVector2, RegionComplexity> regions;
+    for (const auto& item : nodes_)
+    {
+        Node* node = scene->GetNode(item.first);
+        if (!node || node == scene)
+            continue;
+
+        const Vector3 position = node->GetWorldPosition();
+        const IntVector2 cell{FloorToInt(position.x_ / regionSize_), FloorToInt(position.z_ / regionSize_)};
+
+        RegionComplexity& region = regions[cell];
+        if (!region.complexity_.numNodes_)
+        {
+            region.box_.Define(Vector3(cell.x_ * regionSize_, position.y_, cell.y_ * regionSize_));
+            region.box_.Merge(Vector3((cell.x_ + 1) * regionSize_, position.y_, (cell.y_ + 1) * regionSize_));
+        }
+        else
+        {
+            region.box_.min_.y_ = Min(region.box_.min_.y_, position.y_);
+            region.box_.max_.y_ = Max(region.box_.max_.y_, position.y_);
+        }
+        region.complexity_.Accumulate(item.second.own_);
+    }
+
+    for (const auto& item : regions)
+        regions_.push_back(item.second);
+
+    ea::sort(regions_.begin(), regions_.end(), [](const RegionComplexity& lhs, const RegionComplexity& rhs)
+    {
+        return lhs.complexity_.GetNumDrawCalls() > rhs.complexity_.GetNumDrawCalls();
+    });
+}
+
+unsigned long long SceneComplexityAnalyzer::GetTextureMemory(const Texture* texture)
+{
+    auto iter = textureMemory_.find(texture);
+    if (iter != textureMemory_.end())
+        return iter->second;
+
+    unsigned long long memory = texture->GetMemoryUse();
+    if (!memory && !texture->GetName().empty())
+    {
+        // Textures are not loaded in headless mode, estimate from the image with full mip chain
+        auto* cache = GetSubsystem<ResourceCache>();
+        if (SharedPtr<Image> image = cache->GetTempResource<Image>(texture->GetName(), false))
+            memory = image->GetMemoryUse() * 4ull / 3ull;
+    }
+
+    textureMemory_[texture] = memory;
+    return memory;
+}
+
+const SceneComplexity* SceneComplexityAnalyzer::GetNodeComplexity(Node* node) const
+{
+    auto iter = node ? nodes_.find(node->GetID()) : nodes_.end();
+    return iter != nodes_.end() ? &iter->second.own_ : nullptr;
+}
+
+const SceneComplexity* SceneComplexityAnalyzer::GetSubtreeComplexity(Node* node) const
+{
+    auto iter = node ? nodes_.find(node->GetID()) : nodes_.end();
+    return iter != nodes_.end() ? &iter->second.subtree_ : nullptr;
+}
+
+float SceneComplexityAnalyzer::GetHeat(Node* node) const
+{
+    const SceneComplexity* subtree = GetSubtreeComplexity(node);
+    const unsigned totalDrawCalls = total_.GetNumDrawCalls();
+    if (!subtree || !totalDrawCalls)
+        return 0.0f;
+    return static_cast<float>(subtree->GetNumDrawCalls()) / totalDrawCalls;
+}
+
+void SceneComplexityAnalyzer::Save(JSONValue& dest) const
+{
+    JSONValue total;
+    total_.Save(total);
+    dest.Set("total", total);
+    dest.Set("regionSize", regionSize_);
+
+    JSONValue lights{JSON_ARRAY};
+    for (const LightComplexity& light : lights_)
+    {
+        JSONValue item;
+        item.Set("node", light.nodeID_);
+        item.Set("name", light.nodeName_);
+        item.Set("litDrawables", light.numLitDrawables_);
+        item.Set("shadowCasters", light.numShadowCasters_);
+        item.Set("shadowBatches", light.numShadowBatches_);
+        lights.Push(item);
+    }
+    dest.Set("lights", lights);
+
+    JSONValue regions{JSON_ARRAY};
+    for (const RegionComplexity& region : regions_)
+    {
+        JSONValue item;
+        item.Set("min", ToString("%g %g %g", region.box_.min_.x_, region.box_.min_.y_, region.box_.min_.z_));
+        item.Set("max", ToString("%g %g %g", region.box_.max_.x_, region.box_.max_.y_, region.box_.max_.z_));
+        region.complexity_.Save(item);
+        regions.Push(item);
+    }
+    dest.Set("regions", regions);
+
+    ea::vector<unsigned> nodeIDs;
+    for (const auto& item : nodes_)
+        nodeIDs.push_back(item.first);
+    ea::sort(nodeIDs.begin(), nodeIDs.end());
+
+    JSONValue nodes{JSON_ARRAY};
+    for (unsigned nodeID : nodeIDs)
+    {
+        const NodeEntry& entry = nodes_.find(nodeID)->second;
+        JSONValue item;
+        JSONValue own;
+        JSONValue subtree;
+        entry.own_.Save(own);
+        entry.subtree_.Save(subtree);
+        item.Set("id", nodeID);
+        item.Set("name", entry.name_);
+        item.Set("own", own);
+        item.Set("subtree", subtree);
+        nodes.Push(item);
+    }
+    dest.Set("nodes", nodes);
+}
+
+bool SceneComplexityAnalyzer::SaveFile(const ea::string& fileName) const
+{
+    JSONFile file(context_);
+    Save(file.GetRoot());
+    if (!file.SaveFile(fileName))
+    {
+        URHO3D_LOGERROR("Could not save scene complexity report to '{}'", fileName);
+        return false;
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,180 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#pragma once
+
+
+#include "ToolboxAPI.h"
+#include <Urho3D/Core/Object.h>
+#include <Urho3D/Math/BoundingBox.h>
+
+#include <EASTL/hash_set.h>
+#include <EASTL/unordered_map.h>
+
+namespace Urho3D
+{
+
+class JSONValue;
+class Light;
+class Node;
+class Scene;
+class Texture;
+
+/// Estimated rendering, physics and network cost of a node or a group of nodes.
+struct URHO3D_TOOLBOX_API SceneComplexity
+{
+    /// Accumulate counters. Unique material, technique and texture counts are not additive and are left unchanged.
+    void Accumulate(const SceneComplexity& rhs);
+    /// Return estimated draw calls of all passes.
+    unsigned GetNumDrawCalls() const { return numBatches_ + numLitBatches_ + numShadowBatches_; }
+    /// Save counters to JSON.
+    void Save(JSONValue& dest) const;
+
+    /// Number of nodes.
+    unsigned numNodes_{};
+    /// Number of drawables with geometry.
+    unsigned numDrawables_{};
+    /// Estimated base pass draw calls.
+    unsigned numBatches_{};
+    /// Estimated additional per-pixel light pass draw calls.
+    unsigned numLitBatches_{};
+    /// Estimated shadow map draw calls. Attributed to the light casting the shadows.
+    unsigned numShadowBatches_{};
+    /// Number of shadow casters in range of shadowed lights. Attributed to the light casting the shadows.
+    unsigned numShadowCasters_{};
+    /// Number of lights.
+    unsigned numLights_{};
+    /// Number of shadowed lights.
+    unsigned numShadowedLights_{};
+    /// Number of skinned bones.
+    unsigned numSkinnedBones_{};
+    /// Number of collision shapes.
+    unsigned numCollisionShapes_{};
+    /// Number of triangles in mesh and convex hull collision shapes.
+    unsigned numCollisionTriangles_{};
+    /// Number of replicated attributes.
+    unsigned numReplicatedAttributes_{};
+    /// Serialized size of replicated attributes in bytes.
+    unsigned replicatedBytes_{};
+    /// Number of unique materials.
+    unsigned numMaterials_{};
+    /// Number of unique techniques.
+    unsigned numTechniques_{};
+    /// Estimated memory of unique textures in bytes.
+    unsigned long long textureMemory_{};
+};
+
+/// Shadow and lighting cost of a single light.
+struct URHO3D_TOOLBOX_API LightComplexity
+{
+    /// ID of the light node.
+    unsigned nodeID_{};
+    /// Name of the light node.
+    ea::string nodeName_;
+    /// Number of drawables in light range.
+    unsigned numLitDrawables_{};
+    /// Number of shadow casters in light range.
+    unsigned numShadowCasters_{};
+    /// Estimated shadow map draw calls, counting every cascade split or cube face.
+    unsigned numShadowBatches_{};
+};
+
+/// Cost of a horizontal region of the scene.
+struct URHO3D_TOOLBOX_API RegionComplexity
+{
+    /// Region bounds on the XZ plane. Vertical extent covers the nodes assigned to the region.
+    BoundingBox box_;
+    /// Costs of the nodes positioned in the region.
+    SceneComplexity complexity_;
+};
+
+/// Offline analyzer of scene complexity for performance budgeting. Works on loaded scenes without rendering them.
+class URHO3D_TOOLBOX_API SceneComplexityAnalyzer : public Object
+{
+    URHO3D_OBJECT(SceneComplexityAnalyzer, Object);
+public:
+    /// Construct.
+    explicit SceneComplexityAnalyzer(Context* context);
+
+    /// Analyze the scene, replacing results of previous analysis.
+    void Analyze(Scene* scene);
+    /// Save results to JSON.
+    void Save(JSONValue& dest) const;
+    /// Save results to JSON file. Return true on success.
+    bool SaveFile(const ea::string& fileName) const;
+
+    /// Set size of the square regions on the XZ plane.
+    void SetRegionSize(float size) { regionSize_ = Max(size, M_EPSILON); }
+    /// Return size of the square regions on the XZ plane.
+    float GetRegionSize() const { return regionSize_; }
+
+    /// Return cost of the node itself, or null if the node was not analyzed.
+    const SceneComplexity* GetNodeComplexity(Node* node) const;
+    /// Return cost of the node and its children, or null if the node was not analyzed.
+    const SceneComplexity* GetSubtreeComplexity(Node* node) const;
+    /// Return share of scene draw calls estimated for the node and its children, from 0 to 1.
+    float GetHeat(Node* node) const;
+    /// Return cost of the whole scene.
+    const SceneComplexity& GetTotal() const { return total_; }
+    /// Return costs of lights.
+    const ea::vector<LightComplexity>& GetLights() const { return lights_; }
+    /// Return costs of non-empty regions.
+    const ea::vector<RegionComplexity>& GetRegions() const { return regions_; }
+
+private:
+    /// Complexity of the node and its subtree.
+    struct NodeEntry
+    {
+        /// Node name.
+        ea::string name_;
+        /// Cost of the node itself.
+        SceneComplexity own_;
+        /// Cost of the node and its children.
+        SceneComplexity subtree_;
+    };
+
+    /// Analyze node and its children and return the subtree cost.
+    const SceneComplexity& AnalyzeNode(Node* node, ea::hash_set<const void*>& materials,
+        ea::hash_set<const void*>& techniques, ea::hash_set<const Texture*>& textures);
+    /// Add per-light costs to the light nodes.
+    void AnalyzeLights(Scene* scene);
+    /// Assign node costs to regions.
+    void AnalyzeRegions(Scene* scene);
+    /// Return estimated memory of the texture, cached per analysis.
+    unsigned long long GetTextureMemory(const Texture* texture);
+
+    /// Size of the square regions on the XZ plane.
+    float regionSize_{50.0f};
+    /// Node costs by node ID.
+    ea::unordered_map<unsigned, NodeEntry> nodes_;
+    /// Cost of the whole scene.
+    SceneComplexity total_;
+    /// Light costs.
+    ea::vector<LightComplexity> lights_;
+    /// Estimated texture memory by texture.
+    ea::unordered_map<const Texture*, unsigned long long> textureMemory_;
+    /// Region costs.
+    ea::vector<RegionComplexity> regions_;
+};
+
+}
@@ -32,8 +32,14 @@
 #include "../Core/Profiler.h"
 #include "../IO/Log.h"
 
+#include <EASTL/sort.h>
+
 #include <SDL/SDL.h>
 
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#endif
+
 #include "../DebugNew.h"
 
 #ifdef _MSC_VER
@@ -55,8 +61,6 @@ static void SDLAudioCallback(void* userdata, Uint8* stream, int len);
 Audio::Audio(Context* context) :
     Object(context)
 {
-    context_->RequireSDL(SDL_INIT_AUDIO);
-
     // Set the master to the default value
     masterGain_[SOUND_MASTER_HASH] = 1.0f;
 
@@ -69,13 +73,22 @@ Audio::Audio(Context* context) :
 Audio::~Audio()
 {
     Release();
-    context_->ReleaseSDL();
+    if (sdlRequired_)
+        context_->ReleaseSDL();
 }
 
 bool Audio::SetMode(int bufferLengthMSec, int mixRate, bool stereo, bool interpolation)
 {
     Release();
 
+    // Initialize SDL audio only when output is actually requested, as device enumeration is slow on some platforms
+    if (!sdlRequired_)
+    {
+        URHO3D_PROFILE("InitSDLAudio");
+        context_->RequireSDL(SDL_INIT_AUDIO);
+        sdlRequired_ = true;
+    }
+
     bufferLengthMSec = Max(bufferLengthMSec, MIN_BUFFERLENGTH);
     mixRate = Clamp(mixRate, MIN_MIXRATE, MAX_MIXRATE);
 
@@ -133,6 +146,7 @@ bool Audio::SetMode(int bufferLengthMSec, int mixRate, bool stereo, bool interpo
     mixRate_ = obtained.freq;
     interpolation_ = interpolation;
     clipBuffer_.reset(new int[stereo ? fragmentSize_ << 1u : fragmentSize_]);
+    UpdateBusBuffers();
 
     URHO3D_LOGINFO("Set audio mode " + ea::to_string(mixRate_) + " Hz " + (stereo_ ? "stereo" : "mono") + " " + (interpolation_ ? " interpolated" : ""));
 
@@ -172,6 +186,12 @@ void Audio::Stop()
     playing_ = false;
 }
 
+void Audio::SetMaxRealVoices(unsigned count)
+{
+    maxRealVoices_ = count;
+    UpdateVoices();
+}
+
 void Audio::SetMasterGain(const ea::string& type, float gain)
 {
     masterGain_[type] = Clamp(gain, 0.0f, 1.0f);
@@ -202,6 +222,36 @@ void Audio::ResumeAll()
     UpdateInternal(0.0f);
 }
 
+void Audio::AddEffect(const ea::string& type, AudioEffect* effect)
+{
+    if (!effect)
+        return;
+
+    MutexLock lock(audioMutex_);
+    AudioBus& bus = buses_[StringHash(type)];
+    bus.effects_.push_back(SharedPtr<AudioEffect>(effect));
+    UpdateBusBuffers();
+}
+
+void Audio::RemoveEffect(const ea::string& type, AudioEffect* effect)
+{
+    MutexLock lock(audioMutex_);
+    auto i = buses_.find(StringHash(type));
+    if (i == buses_.end())
+        return;
+
+    ea::vector<SharedPtr<AudioEffect> >& effects = i->second.effects_;
+    effects.erase_first(SharedPtr<AudioEffect>(effect));
+    if (effects.empty())
+        buses_.erase(i);
+}
+
+void Audio::RemoveEffects(const ea::string& type)
+{
+    MutexLock lock(audioMutex_);
+    buses_.erase(StringHash(type));
+}
+
 void Audio::SetListener(SoundListener* listener)
 {
     listener_ = listener;
@@ -226,6 +276,13 @@ float Audio::GetMasterGain(const ea::string& type) const
     return findIt->second.GetFloat();
 }
 
+const ea::vector<SharedPtr<AudioEffect> >& Audio::GetEffects(const ea::string& type) const
+{
+    static const ea::vector<SharedPtr<AudioEffect> > noEffects;
+    auto i = buses_.find(StringHash(type));
+    return i != buses_.end() ? i->second.effects_ : noEffects;
+}
+
 bool Audio::IsSoundTypePaused(const ea::string& type) const
 {
     return pausedSoundTypes_.contains(type);
@@ -292,11 +349,16 @@ void Audio::MixOutput(void* dest, unsigned samples)
         if (stereo_)
             clipSamples <<= 1;
 
-        // Clear clip buffer
+        // Clear clip buffer and submix buffers
         int* clipPtr = clipBuffer_.get();
         memset(clipPtr, 0, clipSamples * sizeof(int));
+        for (auto& bus : buses_)
+        {
+            if (bus.first != SOUND_MASTER_HASH)
+                memset(bus.second.mixBuffer_.data(), 0, clipSamples * sizeof(int));
+        }
 
-        // Mix samples to clip buffer
+        // Mix samples to clip buffer, or to the bus of the sound type if it has effects
         for (auto i = soundSources_.begin(); i != soundSources_.end(); ++i)
         {
             SoundSource* source = *i;
@@ -308,10 +370,42 @@ void Audio::MixOutput(void* dest, unsigned samples)
                     continue;
             }
 
-            source->Mix(clipPtr, workSamples, mixRate_, stereo_, interpolation_);
+            int* sourceDest = clipPtr;
+            if (!buses_.empty())
+            {
+                auto bus = buses_.find(source->GetSoundTypeHash());
+                if (bus != buses_.end() && bus->first != SOUND_MASTER_HASH)
+                    sourceDest = bus->second.mixBuffer_.data();
+            }
+
+            source->Mix(sourceDest, workSamples, mixRate_, stereo_, interpolation_);
+        }
+
+        // Process each bus once and add it to the output, then process the whole output on the master bus
+        AudioBus* masterBus = nullptr;
+        for (auto& bus : buses_)
+        {
+            if (bus.first != SOUND_MASTER_HASH)
+                ProcessBus(bus.second, bus.second.mixBuffer_.data(), clipPtr, workSamples, true);
+            else
+                masterBus = &bus.second;
         }
+        if (masterBus)
+            ProcessBus(*masterBus, clipPtr, clipPtr, workSamples, false);
+
         // Copy output from clip buffer to destination
         auto* destPtr = (short*)dest;
+#ifdef URHO3D_SSE
+        // Saturating pack clips eight samples at once
+        for (; clipSamples >= 8; clipSamples -= 8)
+        {
+            const __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(clipPtr));
+            const __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(clipPtr + 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destPtr), _mm_packs_epi32(first, second));
+            clipPtr += 8;
+            destPtr += 8;
+        }
+#endif
         while (clipSamples--)
             *destPtr++ = (short)Clamp(*clipPtr++, -32768, 32767);
         samples -= workSamples;
@@ -319,6 +413,57 @@ void Audio::MixOutput(void* dest, unsigned samples)
     }
 }
 
+void Audio::ProcessBus(AudioBus& bus, const int* source, int* dest, unsigned workSamples, bool accumulate)
+{
+    const unsigned numChannels = stereo_ ? 2 : 1;
+    const unsigned numSamples = workSamples * numChannels;
+    float* samples = effectBuffer_.data();
+
+    // Convert to floats in the [-1, 1] range
+    const float toFloat = 1.0f / 32768.0f;
+    unsigned i = 0;
+#ifdef URHO3D_SSE
+    const __m128 toFloat4 = _mm_set1_ps(toFloat);
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+        _mm_storeu_ps(samples + i, _mm_mul_ps(_mm_cvtepi32_ps(value), toFloat4));
+    }
+#endif
+    for (; i < numSamples; ++i)
+        samples[i] = source[i] * toFloat;
+
+    for (AudioEffect* effect : bus.effects_)
+        effect->Process(samples, workSamples, numChannels, mixRate_);
+
+    // Convert back, rounding to nearest
+    const float toInt = 32768.0f;
+    i = 0;
+#ifdef URHO3D_SSE
+    const __m128 toInt4 = _mm_set1_ps(toInt);
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        __m128i value = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(samples + i), toInt4));
+        if (accumulate)
+            value = _mm_add_epi32(value, _mm_loadu_si128(reinterpret_cast<const __m128i*>(dest + i)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), value);
+    }
+#endif
+    for (; i < numSamples; ++i)
+    {
+        const int value = RoundToInt(samples[i] * toInt);
+        dest[i] = accumulate ? dest[i] + value : value;
+    }
+}
+
+void Audio::UpdateBusBuffers()
+{
+    const unsigned clipSize = stereo_ ? fragmentSize_ << 1u : fragmentSize_;
+    for (auto& bus : buses_)
+        bus.second.mixBuffer_.resize(bus.first != SOUND_MASTER_HASH ? clipSize : 0);
+    effectBuffer_.resize(clipSize);
+}
+
 void Audio::HandleRenderUpdate(StringHash eventType, VariantMap& eventData)
 {
     using namespace RenderUpdate;
@@ -356,6 +501,50 @@ void Audio::UpdateInternal(float timeStep)
 
         source->Update(timeStep);
     }
+
+    UpdateVoices();
+}
+
+void Audio::UpdateVoices()
+{
+    voiceCandidates_.clear();
+    numVirtualVoices_ = 0;
+
+    for (SoundSource* source : soundSources_)
+    {
+        if (!source->IsPlaying())
+        {
+            source->SetVirtual(false);
+            continue;
+        }
+
+        // Silent sources never need mixing
+        if (source->GetAudibility() <= 0.0f)
+        {
+            source->SetVirtual(true);
+            ++numVirtualVoices_;
+        }
+        else
+            voiceCandidates_.push_back(source);
+    }
+
+    unsigned numRealVoices = voiceCandidates_.size();
+    if (maxRealVoices_ && numRealVoices > maxRealVoices_)
+    {
+        // Keep the most important sources: higher priority first, then louder
+        ea::nth_element(voiceCandidates_.begin(), voiceCandidates_.begin() + maxRealVoices_, voiceCandidates_.end(),
+            [](SoundSource* lhs, SoundSource* rhs)
+        {
+            if (lhs->GetPriority() != rhs->GetPriority())
+                return lhs->GetPriority() > rhs->GetPriority();
+            return lhs->GetAudibility() > rhs->GetAudibility();
+        });
+        numRealVoices = maxRealVoices_;
+    }
+
+    for (unsigned i = 0; i < voiceCandidates_.size(); ++i)
+        voiceCandidates_[i]->SetVirtual(i >= numRealVoices);
+    numVirtualVoices_ += voiceCandidates_.size() - numRealVoices;
 }
 
 void RegisterAudioLibrary(Context* context)
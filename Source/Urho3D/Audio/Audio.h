@@ -26,6 +26,7 @@
 #include <EASTL/hash_set.h>
 
 #include "../Audio/AudioDefs.h"
+#include "../Audio/AudioEffect.h"
 #include "../Core/Mutex.h"
 #include "../Core/Object.h"
 
@@ -65,11 +66,20 @@ public:
     void ResumeSoundType(const ea::string& type);
     /// Resume playback of all sound types.
     void ResumeAll();
+    /// Add an effect to the end of the bus of a sound type. Sound sources of the type are mixed together and the bus is processed once. Effects of the master type process the whole output.
+    void AddEffect(const ea::string& type, AudioEffect* effect);
+    /// Remove an effect from the bus of a sound type.
+    void RemoveEffect(const ea::string& type, AudioEffect* effect);
+    /// Remove all effects from the bus of a sound type.
+    void RemoveEffects(const ea::string& type);
     /// Set active sound listener for 3D sounds.
     /// @property
     void SetListener(SoundListener* listener);
     /// Stop any sound source playing a certain sound clip.
     void StopSound(Sound* sound);
+    /// Set maximum number of sound sources mixed at once. Sources with lower priority and audibility become virtual and only advance their playback position. 0 (default) is unlimited.
+    /// @property
+    void SetMaxRealVoices(unsigned count);
 
     /// Return byte size of one sample.
     /// @property
@@ -91,6 +101,14 @@ public:
     /// @property
     bool IsPlaying() const { return playing_; }
 
+    /// Return maximum number of sound sources mixed at once.
+    /// @property
+    unsigned GetMaxRealVoices() const { return maxRealVoices_; }
+
+    /// Return number of sound sources currently playing as virtual voices.
+    /// @property
+    unsigned GetNumVirtualVoices() const { return numVirtualVoices_; }
+
     /// Return whether an audio stream has been reserved.
     /// @property
     bool IsInitialized() const { return deviceID_ != 0; }
@@ -99,6 +117,9 @@ public:
     /// @property
     float GetMasterGain(const ea::string& type) const;
 
+    /// Return effects on the bus of a sound type.
+    const ea::vector<SharedPtr<AudioEffect> >& GetEffects(const ea::string& type) const;
+
     /// Return whether specific sound type has been paused.
     bool IsSoundTypePaused(const ea::string& type) const;
 
@@ -133,6 +154,22 @@ private:
     void Release();
     /// Actually update sound sources with the specific timestep. Called internally.
     void UpdateInternal(float timeStep);
+    /// Choose which playing sound sources are mixed and which play as virtual voices. Called internally.
+    void UpdateVoices();
+    /// Resize mix buffers of the audio buses after a mode change. Called internally.
+    void UpdateBusBuffers();
+
+    /// Submix bus of a sound type.
+    struct AudioBus
+    {
+        /// Effects in processing order.
+        ea::vector<SharedPtr<AudioEffect> > effects_;
+        /// Mixed output of sound sources routed to the bus.
+        ea::vector<int> mixBuffer_;
+    };
+
+    /// Run effects of a bus over mixed samples and write or add the result to the destination.
+    void ProcessBus(AudioBus& bus, const int* source, int* dest, unsigned workSamples, bool accumulate);
 
     /// Clipping buffer for mixing.
     ea::unique_ptr<int[]> clipBuffer_;
@@ -152,6 +189,8 @@ private:
     bool stereo_{};
     /// Playing flag.
     bool playing_{};
+    /// Whether the SDL audio subsystem has been required. Deferred until the first SetMode() call.
+    bool sdlRequired_{};
     /// Master gain by sound source type.
     ea::unordered_map<StringHash, Variant> masterGain_;
     /// Paused sound types.
@@ -160,6 +199,16 @@ private:
     ea::vector<SoundSource*> soundSources_;
     /// Sound listener.
     WeakPtr<SoundListener> listener_;
+    /// Maximum number of real voices, 0 if unlimited.
+    unsigned maxRealVoices_{};
+    /// Number of virtual voices after the last update.
+    unsigned numVirtualVoices_{};
+    /// Playing sound sources competing for real voices.
+    ea::vector<SoundSource*> voiceCandidates_;
+    /// Audio buses with effects by sound type.
+    ea::unordered_map<StringHash, AudioBus> buses_;
+    /// Float samples processed by bus effects.
+    ea::vector<float> effectBuffer_;
 };
 
 /// Register Audio library objects.
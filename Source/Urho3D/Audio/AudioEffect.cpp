@@ -0,0 +1,275 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#include "../Precompiled.h"
+
+#include "../Audio/AudioEffect.h"
+#include "../Math/MathDefs.h"
+
+#include <cmath>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+/// Comb filter delays in samples at 44.1 kHz.
+static const unsigned REVERB_COMB_DELAYS[] = { 1116, 1188, 1277, 1356 };
+/// Allpass filter delays in samples at 44.1 kHz.
+static const unsigned REVERB_ALLPASS_DELAYS[] = { 556, 441 };
+/// Extra delay of the right channel for stereo width.
+static const unsigned REVERB_STEREO_SPREAD = 23;
+/// Input gain of the reverb network.
+static const float REVERB_INPUT_GAIN = 0.03f;
+
+BiquadFilterEffect::BiquadFilterEffect(BiquadFilterType type, float frequency, float q) :
+    type_(type),
+    frequency_(frequency),
+    q_(q)
+{
+}
+
+void BiquadFilterEffect::SetFilterType(BiquadFilterType type)
+{
+    type_ = type;
+    coefficientsMixRate_ = 0;
+}
+
+void BiquadFilterEffect::SetFrequency(float frequency)
+{
+    frequency_ = Max(frequency, 1.0f);
+    coefficientsMixRate_ = 0;
+}
+
+void BiquadFilterEffect::SetQ(float q)
+{
+    q_ = Max(q, 0.01f);
+    coefficientsMixRate_ = 0;
+}
+
+void BiquadFilterEffect::Process(float* samples, unsigned numFrames, unsigned numChannels, int mixRate)
+{
+    if (coefficientsMixRate_ != mixRate)
+        UpdateCoefficients(mixRate);
+
+    numChannels = Min(numChannels, 2u);
+    for (unsigned channel = 0; channel < numChannels; ++channel)
+    {
+        // Transposed direct form II
+        float z1 = z1_[channel];
+        float z2 = z2_[channel];
+        float* sample = samples + channel;
+        for (unsigned i = 0; i < numFrames; ++i, sample += numChannels)
+        {
+            const float x = *sample;
+            const float y = b0_ * x + z1;
+            z1 = b1_ * x - a1_ * y + z2;
+            z2 = b2_ * x - a2_ * y;
+            *sample = y;
+        }
+        z1_[channel] = z1;
+        z2_[channel] = z2;
+    }
+}
+
+void BiquadFilterEffect::Reset()
+{
+    for (unsigned channel = 0; channel < 2; ++channel)
+        z1_[channel] = z2_[channel] = 0.0f;
+}
+
+void BiquadFilterEffect::UpdateCoefficients(int mixRate)
+{
+    const float w0 = 2.0f * M_PI * Min(frequency_, mixRate * 0.49f) / mixRate;
+    const float cosW0 = cosf(w0);
+    const float alpha = sinf(w0) / (2.0f * q_);
+
+    float b0, b1, b2;
+    switch (type_)
+    {
+    case BIQUAD_HIGHPASS:
+        b0 = (1.0f + cosW0) * 0.5f;
+        b1 = -(1.0f + cosW0);
+        b2 = b0;
+        break;
+
+    case BIQUAD_BANDPASS:
+        b0 = alpha;
+        b1 = 0.0f;
+        b2 = -alpha;
+        break;
+
+    case BIQUAD_LOWPASS:
+    default:
+        b0 = (1.0f - cosW0) * 0.5f;
+        b1 = 1.0f - cosW0;
+        b2 = b0;
+        break;
+    }
+
+    const float invA0 = 1.0f / (1.0f + alpha);
+    b0_ = b0 * invA0;
+    b1_ = b1 * invA0;
+    b2_ = b2 * invA0;
+    a1_ = -2.0f * cosW0 * invA0;
+    a2_ = (1.0f - alpha) * invA0;
+    coefficientsMixRate_ = mixRate;
+}
+
+CompressorEffect::CompressorEffect(float thresholdDb, float ratio) :
+    thresholdDb_(thresholdDb),
+    ratio_(Max(ratio, 1.0f))
+{
+}
+
+void CompressorEffect::Process(float* samples, unsigned numFrames, unsigned numChannels, int mixRate)
+{
+    const float attack = expf(-1.0f / (Max(attackTime_, M_EPSILON) * mixRate));
+    const float release = expf(-1.0f / (Max(releaseTime_, M_EPSILON) * mixRate));
+    const float slope = 1.0f - 1.0f / ratio_;
+    const float makeup = powf(10.0f, makeupGainDb_ / 20.0f);
+
+    float envelope = envelope_;
+    for (unsigned i = 0; i < numFrames; ++i, samples += numChannels)
+    {
+        float peak = 0.0f;
+        for (unsigned channel = 0; channel < numChannels; ++channel)
+            peak = Max(peak, Abs(samples[channel]));
+
+        const float coeff = peak > envelope ? attack : release;
+        envelope = coeff * envelope + (1.0f - coeff) * peak;
+
+        // Gain reduction is only evaluated when the envelope is above the threshold
+        float gain = makeup;
+        const float envelopeDb = 20.0f * log10f(envelope + M_EPSILON);
+        if (envelopeDb > thresholdDb_)
+            gain *= powf(10.0f, -(envelopeDb - thresholdDb_) * slope / 20.0f);
+
+        for (unsigned channel = 0; channel < numChannels; ++channel)
+            samples[channel] *= gain;
+    }
+    envelope_ = envelope;
+}
+
+ReverbEffect::ReverbEffect(float roomSize, float damping, float wet, float dry) :
+    roomSize_(Clamp(roomSize, 0.0f, 1.0f)),
+    damping_(Clamp(damping, 0.0f, 1.0f)),
+    wet_(wet),
+    dry_(dry)
+{
+}
+
+void ReverbEffect::SetRoomSize(float roomSize)
+{
+    roomSize_ = Clamp(roomSize, 0.0f, 1.0f);
+}
+
+void ReverbEffect::SetDamping(float damping)
+{
+    damping_ = Clamp(damping, 0.0f, 1.0f);
+}
+
+void ReverbEffect::Process(float* samples, unsigned numFrames, unsigned numChannels, int mixRate)
+{
+    if (delayMixRate_ != mixRate)
+        AllocateDelayLines(mixRate);
+
+    const float feedback = 0.7f + 0.28f * roomSize_;
+    const float damping = damping_ * 0.4f;
+    numChannels = Min(numChannels, 2u);
+
+    for (unsigned channel = 0; channel < numChannels; ++channel)
+    {
+        DelayLine* combs = combs_[channel];
+        DelayLine* allpasses = allpasses_[channel];
+        float* sample = samples + channel;
+
+        for (unsigned i = 0; i < numFrames; ++i, sample += numChannels)
+        {
+            const float input = *sample * REVERB_INPUT_GAIN;
+            float output = 0.0f;
+
+            for (unsigned j = 0; j < NUM_COMBS; ++j)
+            {
+                DelayLine& comb = combs[j];
+                const float delayed = comb.buffer_[comb.position_];
+                comb.filterState_ = delayed * (1.0f - damping) + comb.filterState_ * damping;
+                comb.buffer_[comb.position_] = input + comb.filterState_ * feedback;
+                if (++comb.position_ >= comb.buffer_.size())
+                    comb.position_ = 0;
+                output += delayed;
+            }
+
+            for (unsigned j = 0; j < NUM_ALLPASSES; ++j)
+            {
+                DelayLine& allpass = allpasses[j];
+                const float delayed = allpass.buffer_[allpass.position_];
+                allpass.buffer_[allpass.position_] = output + delayed * 0.5f;
+                if (++allpass.position_ >= allpass.buffer_.size())
+                    allpass.position_ = 0;
+                output = delayed - output;
+            }
+
+            *sample = *sample * dry_ + output * wet_;
+        }
+    }
+}
+
+void ReverbEffect::Reset()
+{
+    for (unsigned channel = 0; channel < 2; ++channel)
+    {
+        for (DelayLine& comb : combs_[channel])
+        {
+            ea::fill(comb.buffer_.begin(), comb.buffer_.end(), 0.0f);
+            comb.filterState_ = 0.0f;
+        }
+        for (DelayLine& allpass : allpasses_[channel])
+            ea::fill(allpass.buffer_.begin(), allpass.buffer_.end(), 0.0f);
+    }
+}
+
+void ReverbEffect::AllocateDelayLines(int mixRate)
+{
+    const float scale = mixRate / 44100.0f;
+    for (unsigned channel = 0; channel < 2; ++channel)
+    {
+        const unsigned spread = channel ? REVERB_STEREO_SPREAD : 0;
+        for (unsigned j = 0; j < NUM_COMBS; ++j)
+        {
+            DelayLine& comb = combs_[channel][j];
+            comb.buffer_.assign(Max(RoundToInt((REVERB_COMB_DELAYS[j] + spread) * scale), 1), 0.0f);
+            comb.position_ = 0;
+            comb.filterState_ = 0.0f;
+        }
+        for (unsigned j = 0; j < NUM_ALLPASSES; ++j)
+        {
+            DelayLine& allpass = allpasses_[channel][j];
+            allpass.buffer_.assign(Max(RoundToInt((REVERB_ALLPASS_DELAYS[j] + spread) * scale), 1), 0.0f);
+            allpass.position_ = 0;
+        }
+    }
+    delayMixRate_ = mixRate;
+}
+
+}
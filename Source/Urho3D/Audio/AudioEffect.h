@@ -0,0 +1,236 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#pragma once
+
+#include "../Container/RefCounted.h"
+
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+/// Base class for effects processing the mixed output of an audio bus.
+class URHO3D_API AudioEffect : public RefCounted
+{
+public:
+    /// Process interleaved samples in place. Samples are in the [-1, 1] range. Called from the mixing thread.
+    virtual void Process(float* samples, unsigned numFrames, unsigned numChannels, int mixRate) = 0;
+    /// Clear internal state such as delay lines.
+    virtual void Reset() { }
+};
+
+/// Biquad filter type.
+enum BiquadFilterType
+{
+    BIQUAD_LOWPASS = 0,
+    BIQUAD_HIGHPASS,
+    BIQUAD_BANDPASS,
+};
+
+/// Second order IIR filter.
+class URHO3D_API BiquadFilterEffect : public AudioEffect
+{
+public:
+    /// Construct.
+    BiquadFilterEffect(BiquadFilterType type = BIQUAD_LOWPASS, float frequency = 1000.0f, float q = 0.7071f);
+
+    /// Set filter type.
+    /// @property
+    void SetFilterType(BiquadFilterType type);
+    /// Set cutoff or center frequency in Hz.
+    /// @property
+    void SetFrequency(float frequency);
+    /// Set quality factor.
+    /// @property{set_Q}
+    void SetQ(float q);
+
+    /// Return filter type.
+    /// @property
+    BiquadFilterType GetFilterType() const { return type_; }
+    /// Return cutoff or center frequency in Hz.
+    /// @property
+    float GetFrequency() const { return frequency_; }
+    /// Return quality factor.
+    /// @property{get_Q}
+    float GetQ() const { return q_; }
+
+    /// Process samples.
+    void Process(float* samples, unsigned numFrames, unsigned numChannels, int mixRate) override;
+    /// Clear filter history.
+    void Reset() override;
+
+private:
+    /// Recalculate coefficients for the mixing rate.
+    void UpdateCoefficients(int mixRate);
+
+    /// Filter type.
+    BiquadFilterType type_;
+    /// Cutoff or center frequency.
+    float frequency_;
+    /// Quality factor.
+    float q_;
+    /// Mixing rate the coefficients were calculated for, 0 if dirty.
+    int coefficientsMixRate_{};
+    /// Normalized feedforward coefficients.
+    float b0_{}, b1_{}, b2_{};
+    /// Normalized feedback coefficients.
+    float a1_{}, a2_{};
+    /// Filter state per channel.
+    float z1_[2]{}, z2_[2]{};
+};
+
+/// Dynamic range compressor with stereo linked peak detection.
+class URHO3D_API CompressorEffect : public AudioEffect
+{
+public:
+    /// Construct.
+    CompressorEffect(float thresholdDb = -12.0f, float ratio = 4.0f);
+
+    /// Set threshold in decibels.
+    /// @property
+    void SetThreshold(float thresholdDb) { thresholdDb_ = thresholdDb; }
+    /// Set compression ratio above the threshold.
+    /// @property
+    void SetRatio(float ratio) { ratio_ = ratio < 1.0f ? 1.0f : ratio; }
+    /// Set attack time in seconds.
+    /// @property
+    void SetAttackTime(float time) { attackTime_ = time; }
+    /// Set release time in seconds.
+    /// @property
+    void SetReleaseTime(float time) { releaseTime_ = time; }
+    /// Set gain applied after compression in decibels.
+    /// @property
+    void SetMakeupGain(float gainDb) { makeupGainDb_ = gainDb; }
+
+    /// Return threshold in decibels.
+    /// @property
+    float GetThreshold() const { return thresholdDb_; }
+    /// Return compression ratio.
+    /// @property
+    float GetRatio() const { return ratio_; }
+    /// Return attack time in seconds.
+    /// @property
+    float GetAttackTime() const { return attackTime_; }
+    /// Return release time in seconds.
+    /// @property
+    float GetReleaseTime() const { return releaseTime_; }
+    /// Return gain applied after compression in decibels.
+    /// @property
+    float GetMakeupGain() const { return makeupGainDb_; }
+
+    /// Process samples.
+    void Process(float* samples, unsigned numFrames, unsigned numChannels, int mixRate) override;
+    /// Reset envelope.
+    void Reset() override { envelope_ = 0.0f; }
+
+private:
+    /// Threshold.
+    float thresholdDb_;
+    /// Ratio.
+    float ratio_;
+    /// Attack time.
+    float attackTime_{0.005f};
+    /// Release time.
+    float releaseTime_{0.1f};
+    /// Makeup gain.
+    float makeupGainDb_{};
+    /// Peak envelope.
+    float envelope_{};
+};
+
+/// Algorithmic reverb made of parallel comb filters followed by allpass filters.
+class URHO3D_API ReverbEffect : public AudioEffect
+{
+public:
+    /// Construct.
+    ReverbEffect(float roomSize = 0.5f, float damping = 0.5f, float wet = 0.3f, float dry = 1.0f);
+
+    /// Set room size from 0 to 1. Larger rooms have longer decay.
+    /// @property
+    void SetRoomSize(float roomSize);
+    /// Set high frequency damping from 0 to 1.
+    /// @property
+    void SetDamping(float damping);
+    /// Set reverberated signal level.
+    /// @property
+    void SetWet(float wet) { wet_ = wet; }
+    /// Set original signal level.
+    /// @property
+    void SetDry(float dry) { dry_ = dry; }
+
+    /// Return room size.
+    /// @property
+    float GetRoomSize() const { return roomSize_; }
+    /// Return high frequency damping.
+    /// @property
+    float GetDamping() const { return damping_; }
+    /// Return reverberated signal level.
+    /// @property
+    float GetWet() const { return wet_; }
+    /// Return original signal level.
+    /// @property
+    float GetDry() const { return dry_; }
+
+    /// Process samples.
+    void Process(float* samples, unsigned numFrames, unsigned numChannels, int mixRate) override;
+    /// Clear delay lines.
+    void Reset() override;
+
+private:
+    /// Number of comb filters per channel.
+    static const unsigned NUM_COMBS = 4;
+    /// Number of allpass filters per channel.
+    static const unsigned NUM_ALLPASSES = 2;
+
+    /// Feedback delay line.
+    struct DelayLine
+    {
+        /// Samples.
+        ea::vector<float> buffer_;
+        /// Current position.
+        unsigned position_{};
+        /// Lowpass filter state for comb damping.
+        float filterState_{};
+    };
+
+    /// Allocate delay lines for the mixing rate.
+    void AllocateDelayLines(int mixRate);
+
+    /// Room size.
+    float roomSize_;
+    /// Damping.
+    float damping_;
+    /// Wet level.
+    float wet_;
+    /// Dry level.
+    float dry_;
+    /// Mixing rate delay lines were allocated for.
+    int delayMixRate_{};
+    /// Comb filters per channel.
+    DelayLine combs_[2][NUM_COMBS];
+    /// Allpass filters per channel.
+    DelayLine allpasses_[2][NUM_ALLPASSES];
+};
+
+}
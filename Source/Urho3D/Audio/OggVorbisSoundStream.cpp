@@ -24,14 +24,20 @@
 
 #include "../Audio/OggVorbisSoundStream.h"
 #include "../Audio/Sound.h"
+#include "../Core/WorkQueue.h"
 
 #include <STB/stb_vorbis.h>
 
+#include <thread>
+
 #include "../DebugNew.h"
 
 namespace Urho3D
 {
 
+/// Size of decoded data kept ahead of the mixer in bytes.
+static const unsigned PREFETCH_BUFFER_SIZE = 65536;
+
 OggVorbisSoundStream::OggVorbisSoundStream(const Sound* sound)
 {
     assert(sound && sound->IsCompressed());
@@ -49,6 +55,16 @@ OggVorbisSoundStream::OggVorbisSoundStream(const Sound* sound)
 
 OggVorbisSoundStream::~OggVorbisSoundStream()
 {
+    // Cancel or wait for the prefetch, as it refers to this stream
+    if (prefetchPending_)
+    {
+        if (!workQueue_ || !workQueue_->RemoveWorkItem(prefetchItem_))
+        {
+            while (prefetchPending_)
+                std::this_thread::yield();
+        }
+    }
+
     // Close decoder
     if (decoder_)
     {
@@ -66,6 +82,13 @@ bool OggVorbisSoundStream::Seek(unsigned sample_number)
 
     auto* vorbis = static_cast<stb_vorbis*>(decoder_);
 
+    MutexLock decoderLock(decoderMutex_);
+    {
+        // Prefetched data is no longer valid
+        MutexLock bufferLock(bufferMutex_);
+        prefetchReadPos_ = 0;
+        prefetchSize_ = 0;
+    }
     return stb_vorbis_seek(vorbis, sample_number) == 1;
 }
 
@@ -74,6 +97,47 @@ unsigned OggVorbisSoundStream::GetData(signed char* dest, unsigned numBytes)
     if (!decoder_)
         return 0;
 
+    unsigned outBytes = ReadPrefetched(dest, numBytes);
+    if (outBytes < numBytes)
+    {
+        // Prefetch fell behind: wait for a running decode, then decode the rest inline
+        MutexLock decoderLock(decoderMutex_);
+        outBytes += ReadPrefetched(dest + outBytes, numBytes - outBytes);
+        if (outBytes < numBytes)
+            outBytes += DecodeLockless(dest + outBytes, numBytes - outBytes);
+    }
+
+    return outBytes;
+}
+
+void OggVorbisSoundStream::Prefetch(WorkQueue* workQueue)
+{
+    if (!decoder_ || !workQueue || prefetchPending_)
+        return;
+
+    {
+        MutexLock bufferLock(bufferMutex_);
+        if (prefetchSize_ > PREFETCH_BUFFER_SIZE / 2)
+            return;
+
+        if (!prefetchBuffer_)
+        {
+            prefetchBuffer_ = ea::make_unique<signed char[]>(PREFETCH_BUFFER_SIZE);
+            decodeBuffer_ = ea::make_unique<signed char[]>(PREFETCH_BUFFER_SIZE);
+        }
+    }
+
+    prefetchPending_ = true;
+    workQueue_ = workQueue;
+    prefetchItem_ = workQueue->AddWorkItem([this]()
+    {
+        FillPrefetchBuffer();
+        prefetchPending_ = false;
+    });
+}
+
+unsigned OggVorbisSoundStream::DecodeLockless(signed char* dest, unsigned numBytes)
+{
     auto* vorbis = static_cast<stb_vorbis*>(decoder_);
 
     unsigned channels = stereo_ ? 2 : 1;
@@ -93,4 +157,45 @@ unsigned OggVorbisSoundStream::GetData(signed char* dest, unsigned numBytes)
     return outBytes;
 }
 
+unsigned OggVorbisSoundStream::ReadPrefetched(signed char* dest, unsigned numBytes)
+{
+    MutexLock bufferLock(bufferMutex_);
+    if (!prefetchBuffer_)
+        return 0;
+
+    const unsigned outBytes = Min(numBytes, prefetchSize_);
+    const unsigned firstPart = Min(outBytes, PREFETCH_BUFFER_SIZE - prefetchReadPos_);
+    memcpy(dest, prefetchBuffer_.get() + prefetchReadPos_, firstPart);
+    memcpy(dest + firstPart, prefetchBuffer_.get(), outBytes - firstPart);
+
+    prefetchReadPos_ = (prefetchReadPos_ + outBytes) % PREFETCH_BUFFER_SIZE;
+    prefetchSize_ -= outBytes;
+    return outBytes;
+}
+
+void OggVorbisSoundStream::FillPrefetchBuffer()
+{
+    MutexLock decoderLock(decoderMutex_);
+
+    unsigned freeBytes;
+    {
+        MutexLock bufferLock(bufferMutex_);
+        freeBytes = PREFETCH_BUFFER_SIZE - prefetchSize_;
+    }
+
+    // Decode whole sample frames outside of the buffer lock, so the mixer can keep reading meanwhile
+    const unsigned frameSize = GetSampleSize();
+    freeBytes -= freeBytes % frameSize;
+    const unsigned outBytes = freeBytes ? DecodeLockless(decodeBuffer_.get(), freeBytes) : 0;
+    if (!outBytes)
+        return;
+
+    MutexLock bufferLock(bufferMutex_);
+    const unsigned writePos = (prefetchReadPos_ + prefetchSize_) % PREFETCH_BUFFER_SIZE;
+    const unsigned firstPart = Min(outBytes, PREFETCH_BUFFER_SIZE - writePos);
+    memcpy(prefetchBuffer_.get() + writePos, decodeBuffer_.get(), firstPart);
+    memcpy(prefetchBuffer_.get(), decodeBuffer_.get() + firstPart, outBytes - firstPart);
+    prefetchSize_ += outBytes;
+}
+
 }
@@ -23,13 +23,19 @@
 #pragma once
 
 #include <EASTL/shared_array.h>
+#include <EASTL/unique_ptr.h>
+
+#include <atomic>
 
 #include "../Audio/SoundStream.h"
+#include "../Container/Ptr.h"
+#include "../Core/Mutex.h"
 
 namespace Urho3D
 {
 
 class Sound;
+struct WorkItem;
 
 /// Ogg Vorbis sound stream.
 class URHO3D_API OggVorbisSoundStream : public SoundStream
@@ -45,14 +51,42 @@ public:
 
     /// Produce sound data into destination. Return number of bytes produced. Called by SoundSource from the mixing thread.
     unsigned GetData(signed char* dest, unsigned numBytes) override;
+    /// Decode sound data ahead of the mixer on a worker thread when the prefetch buffer runs low. Called by SoundSource from the main thread.
+    void Prefetch(WorkQueue* workQueue) override;
 
 protected:
+    /// Decode sound data into destination, rewinding if looped. Requires the decoder mutex. Return number of bytes produced.
+    unsigned DecodeLockless(signed char* dest, unsigned numBytes);
+    /// Copy prefetched sound data into destination. Return number of bytes copied.
+    unsigned ReadPrefetched(signed char* dest, unsigned numBytes);
+    /// Decode sound data into the prefetch buffer until it is full. Called from a worker thread.
+    void FillPrefetchBuffer();
+
+
     /// Decoder state.
     void* decoder_;
     /// Compressed sound data.
     ea::shared_array<signed char> data_;
     /// Compressed sound data size in bytes.
     unsigned dataSize_;
+    /// Decoder mutex. Acquired before the prefetch buffer mutex when both are needed.
+    Mutex decoderMutex_;
+    /// Prefetch buffer mutex.
+    Mutex bufferMutex_;
+    /// Ring buffer of decoded sound data.
+    ea::unique_ptr<signed char[]> prefetchBuffer_;
+    /// Read position in the prefetch buffer.
+    unsigned prefetchReadPos_{};
+    /// Number of decoded bytes in the prefetch buffer.
+    unsigned prefetchSize_{};
+    /// Temporary buffer for data decoded on a worker thread.
+    ea::unique_ptr<signed char[]> decodeBuffer_;
+    /// Work queue running the prefetch.
+    WeakPtr<WorkQueue> workQueue_;
+    /// Last queued prefetch work item.
+    SharedPtr<WorkItem> prefetchItem_;
+    /// Whether a prefetch is queued or running.
+    std::atomic<bool> prefetchPending_{};
 };
 
 }
@@ -28,11 +28,16 @@
 #include "../Audio/SoundSource.h"
 #include "../Audio/SoundStream.h"
 #include "../Core/Context.h"
+#include "../Core/WorkQueue.h"
 #include "../IO/Log.h"
 #include "../Resource/ResourceCache.h"
 #include "../Scene/Node.h"
 #include "../Scene/ReplicationState.h"
 
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#endif
+
 #include "../DebugNew.h"
 
 namespace Urho3D
@@ -94,6 +99,47 @@ namespace Urho3D
 
 #define GET_IP_SAMPLE_RIGHT() (((((int)pos[3] - (int)pos[1]) * fractPos) / 65536) + (int)pos[1])
 
+#ifdef URHO3D_SSE
+/// Add 16-bit samples scaled by interleaved left and right volumes (in 1/256 units) to the clip buffer. Source samples are
+/// duplicated to both channels if upmixing. Return the number of destination values written, the rest is left to scalar code.
+static unsigned MixSamples16SSE(int* dest, const short* src, unsigned numDest, int leftVol, int rightVol, bool upmix)
+{
+    const __m128i vol = _mm_set_epi16((short)rightVol, (short)leftVol, (short)rightVol, (short)leftVol, (short)rightVol,
+        (short)leftVol, (short)rightVol, (short)leftVol);
+    const __m128i roundBias = _mm_set1_epi32(255);
+
+    unsigned i = 0;
+    for (; i + 8 <= numDest; i += 8)
+    {
+        __m128i samples;
+        if (upmix)
+        {
+            const __m128i mono = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + (i >> 1u)));
+            samples = _mm_unpacklo_epi16(mono, mono);
+        }
+        else
+            samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+
+        // Full 32-bit products from the low and high halves of the 16-bit multiplications
+        const __m128i productLow = _mm_mullo_epi16(samples, vol);
+        const __m128i productHigh = _mm_mulhi_epi16(samples, vol);
+        __m128i product0 = _mm_unpacklo_epi16(productLow, productHigh);
+        __m128i product1 = _mm_unpackhi_epi16(productLow, productHigh);
+
+        // Divide by 256 rounding towards zero like the scalar code
+        product0 = _mm_add_epi32(product0, _mm_and_si128(_mm_srai_epi32(product0, 31), roundBias));
+        product1 = _mm_add_epi32(product1, _mm_and_si128(_mm_srai_epi32(product1, 31), roundBias));
+        const __m128i scaled0 = _mm_srai_epi32(product0, 8);
+        const __m128i scaled1 = _mm_srai_epi32(product1, 8);
+
+        auto* out = reinterpret_cast<__m128i*>(dest + i);
+        _mm_storeu_si128(out, _mm_add_epi32(_mm_loadu_si128(out), scaled0));
+        _mm_storeu_si128(out + 1, _mm_add_epi32(_mm_loadu_si128(out + 1), scaled1));
+    }
+    return i;
+}
+#endif
+
 static const int STREAM_SAFETY_SAMPLES = 4;
 
 extern const char* AUDIO_CATEGORY;
@@ -109,6 +155,8 @@ SoundSource::SoundSource(Context* context) :
     panning_(0.0f),
     sendFinishedEvent_(false),
     autoRemove_(REMOVE_DISABLED),
+    priority_(0),
+    virtual_(false),
     position_(nullptr),
     fractPosition_(0),
     timePosition_(0.0f),
@@ -139,6 +187,7 @@ void SoundSource::RegisterObject(Context* context)
     URHO3D_ATTRIBUTE("Gain", float, gain_, 1.0f, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Attenuation", float, attenuation_, 1.0f, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Panning", float, panning_, 0.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Priority", GetPriority, SetPriority, int, 0, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Is Playing", IsPlaying, SetPlayingAttr, bool, false, AM_DEFAULT);
     URHO3D_ENUM_ATTRIBUTE("Autoremove Mode", autoRemove_, autoRemoveModeNames, REMOVE_DISABLED, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Play Position", GetPositionAttr, SetPositionAttr, int, 0, AM_FILE);
@@ -305,6 +354,12 @@ void SoundSource::SetPanning(float panning)
     MarkNetworkUpdate();
 }
 
+void SoundSource::SetPriority(int priority)
+{
+    priority_ = priority;
+    MarkNetworkUpdate();
+}
+
 void SoundSource::SetAutoRemoveMode(AutoRemoveMode mode)
 {
     autoRemove_ = mode;
@@ -335,9 +390,11 @@ void SoundSource::Update(float timeStep)
     if (!audio_->IsInitialized())
         MixNull(timeStep);
 
-    // Free the stream if playback has stopped
+    // Free the stream if playback has stopped, otherwise keep decoding ahead of the mixer
     if (soundStream_ && !position_)
         StopLockless();
+    else if (soundStream_)
+        soundStream_->Prefetch(GetSubsystem<WorkQueue>());
 
     bool playing = IsPlaying();
 
@@ -401,8 +458,11 @@ void SoundSource::Mix(int dest[], unsigned samples, int mixRate, bool stereo, bo
     if (!sound)
         return;
 
+    // Virtual voices only advance the playback position
+    if (virtual_)
+        MixZeroVolume(sound, samples, mixRate);
     // Choose the correct mixing routine
-    if (!sound->IsStereo())
+    else if (!sound->IsStereo())
     {
         if (interpolation)
         {
@@ -611,6 +671,8 @@ void SoundSource::MixMonoToMono(Sound* sound, int dest[], unsigned samples, int
         MixZeroVolume(sound, samples, mixRate);
         return;
     }
+    if (MixSameRate16(sound, dest, samples, mixRate, vol, vol, false))
+        return;
 
     float add = frequency_ / (float)mixRate;
     auto intAdd = (int)add;
@@ -684,6 +746,8 @@ void SoundSource::MixMonoToStereo(Sound* sound, int dest[], unsigned samples, in
         MixZeroVolume(sound, samples, mixRate);
         return;
     }
+    if (MixSameRate16(sound, dest, samples, mixRate, leftVol, rightVol, true))
+        return;
 
     float add = frequency_ / (float)mixRate;
     auto intAdd = (int)add;
@@ -765,6 +829,8 @@ void SoundSource::MixMonoToMonoIP(Sound* sound, int dest[], unsigned samples, in
         MixZeroVolume(sound, samples, mixRate);
         return;
     }
+    if (MixSameRate16(sound, dest, samples, mixRate, vol, vol, false))
+        return;
 
     float add = frequency_ / (float)mixRate;
     auto intAdd = (int)add;
@@ -839,6 +905,8 @@ void SoundSource::MixMonoToStereoIP(Sound* sound, int dest[], unsigned samples,
         MixZeroVolume(sound, samples, mixRate);
         return;
     }
+    if (MixSameRate16(sound, dest, samples, mixRate, leftVol, rightVol, true))
+        return;
 
     float add = frequency_ / (float)mixRate;
     auto intAdd = (int)add;
@@ -1001,6 +1069,8 @@ void SoundSource::MixStereoToStereo(Sound* sound, int dest[], unsigned samples,
         MixZeroVolume(sound, samples, mixRate);
         return;
     }
+    if (MixSameRate16(sound, dest, samples, mixRate, vol, vol, true))
+        return;
 
     float add = frequency_ / (float)mixRate;
     auto intAdd = (int)add;
@@ -1159,6 +1229,8 @@ void SoundSource::MixStereoToStereoIP(Sound* sound, int dest[], unsigned samples
         MixZeroVolume(sound, samples, mixRate);
         return;
     }
+    if (MixSameRate16(sound, dest, samples, mixRate, vol, vol, true))
+        return;
 
     float add = frequency_ / (float)mixRate;
     auto intAdd = (int)add;
@@ -1231,6 +1303,56 @@ void SoundSource::MixStereoToStereoIP(Sound* sound, int dest[], unsigned samples
     fractPosition_ = fractPos;
 }
 
+bool SoundSource::MixSameRate16(Sound* sound, int dest[], unsigned samples, int mixRate, int leftVol, int rightVol, bool stereo)
+{
+    // Only 16-bit sounds played back at the output rate from a whole sample position qualify, so no resampling is needed
+    if (!sound->IsSixteenBit() || frequency_ != (float)mixRate || fractPosition_ || Abs(leftVol) > 32767 || Abs(rightVol) > 32767)
+        return false;
+    if (sound->IsStereo() && !stereo)
+        return false;
+
+    const unsigned srcChannels = sound->IsStereo() ? 2 : 1;
+    const unsigned destChannels = stereo ? 2 : 1;
+    const bool upmix = destChannels > srcChannels;
+
+    auto* pos = (short*)position_;
+    auto* end = (short*)sound->GetEnd();
+    auto* repeat = (short*)sound->GetRepeat();
+
+    while (samples)
+    {
+        // Mix the contiguous part of the sound in one go, then handle the end of the sound
+        const unsigned run = Min(samples, (unsigned)(end - pos) / srcChannels);
+        const unsigned numDest = run * destChannels;
+        unsigned i = 0;
+#ifdef URHO3D_SSE
+        i = MixSamples16SSE(dest, pos, numDest, leftVol, rightVol, upmix);
+#endif
+        for (; i < numDest; ++i)
+        {
+            const int s = upmix ? pos[i >> 1u] : pos[i];
+            dest[i] = dest[i] + (s * ((i & 1u) ? rightVol : leftVol)) / 256;
+        }
+
+        dest += numDest;
+        pos += run * srcChannels;
+        samples -= run;
+
+        if (!run || pos >= end)
+        {
+            if (!sound->IsLooped())
+            {
+                pos = nullptr;
+                break;
+            }
+            pos -= (end - repeat);
+        }
+    }
+
+    position_ = (signed char*)pos;
+    return true;
+}
+
 void SoundSource::MixZeroVolume(Sound* sound, unsigned samples, int mixRate)
 {
     float add = frequency_ * (float)samples / (float)mixRate;
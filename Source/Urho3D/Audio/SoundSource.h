@@ -82,6 +82,9 @@ public:
     void SetAutoRemoveMode(AutoRemoveMode mode);
     /// Set new playback position.
     void SetPlayPosition(signed char* pos);
+    /// Set priority for keeping the sound source mixed when Audio limits the number of real voices. Higher is more important. Default 0.
+    /// @property
+    void SetPriority(int priority);
 
     /// Return sound.
     /// @property
@@ -94,6 +97,9 @@ public:
     /// @property
     ea::string GetSoundType() const { return soundType_; }
 
+    /// Return hash of the sound type.
+    StringHash GetSoundTypeHash() const { return soundTypeHash_; }
+
     /// Return playback time position.
     /// @property
     float GetTimePosition() const { return timePosition_; }
@@ -122,12 +128,25 @@ public:
     /// @property
     bool IsPlaying() const;
 
+    /// Return priority for keeping the sound source mixed.
+    /// @property
+    int GetPriority() const { return priority_; }
+
+    /// Return whether playing as a virtual voice that only tracks playback position.
+    /// @property
+    bool IsVirtual() const { return virtual_; }
+
+    /// Return effective gain used to rank sound sources for real voices.
+    float GetAudibility() const { return masterGain_ * attenuation_ * gain_; }
+
     /// Update the sound source. Perform subclass specific operations. Called by Audio.
     virtual void Update(float timeStep);
     /// Mix sound source output to a 32-bit clipping buffer. Called by Audio.
     void Mix(int dest[], unsigned samples, int mixRate, bool stereo, bool interpolation);
     /// Update the effective master gain. Called internally and by Audio when the master gain changes.
     void UpdateMasterGain();
+    /// Set whether to play as a virtual voice. Called by Audio.
+    void SetVirtual(bool enable) { virtual_ = enable; }
 
     /// Set sound attribute.
     void SetSoundAttr(const ResourceRef& value);
@@ -161,6 +180,10 @@ protected:
     bool sendFinishedEvent_;
     /// Automatic removal mode.
     AutoRemoveMode autoRemove_;
+    /// Priority for real voices.
+    int priority_;
+    /// Virtual voice flag.
+    bool virtual_;
 
 private:
     /// Play a sound without locking the audio mutex. Called internally.
@@ -187,6 +210,8 @@ private:
     void MixStereoToMonoIP(Sound* sound, int dest[], unsigned samples, int mixRate);
     /// Mix stereo sample to stereo buffer interpolated.
     void MixStereoToStereoIP(Sound* sound, int dest[], unsigned samples, int mixRate);
+    /// Mix 16-bit sample played back at the output rate without resampling. Return false if not applicable.
+    bool MixSameRate16(Sound* sound, int dest[], unsigned samples, int mixRate, int leftVol, int rightVol, bool stereo);
     /// Advance playback pointer without producing audible output.
     void MixZeroVolume(Sound* sound, unsigned samples, int mixRate);
     /// Advance playback pointer to simulate audio playback in headless mode.
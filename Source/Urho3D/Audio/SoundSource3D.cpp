@@ -38,6 +38,7 @@ static const float DEFAULT_FARDISTANCE = 100.0f;
 static const float DEFAULT_ROLLOFF = 2.0f;
 static const float DEFAULT_ANGLE = 360.0f;
 static const float MIN_ROLLOFF = 0.1f;
+static const float DEFAULT_OCCLUSION_ATTENUATION = 0.25f;
 static const Color INNER_COLOR(1.0f, 0.5f, 1.0f);
 static const Color OUTER_COLOR(1.0f, 0.0f, 1.0f);
 
@@ -49,7 +50,9 @@ SoundSource3D::SoundSource3D(Context* context) :
     farDistance_(DEFAULT_FARDISTANCE),
     innerAngle_(DEFAULT_ANGLE),
     outerAngle_(DEFAULT_ANGLE),
-    rolloffFactor_(DEFAULT_ROLLOFF)
+    rolloffFactor_(DEFAULT_ROLLOFF),
+    occlusionAttenuation_(DEFAULT_OCCLUSION_ATTENUATION),
+    occlusion_(0.0f)
 {
     // Start from zero volume until attenuation properly calculated
     attenuation_ = 0.0f;
@@ -68,6 +71,7 @@ void SoundSource3D::RegisterObject(Context* context)
     URHO3D_ATTRIBUTE("Inner Angle", float, innerAngle_, DEFAULT_ANGLE, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Outer Angle", float, outerAngle_, DEFAULT_ANGLE, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Rolloff Factor", float, rolloffFactor_, DEFAULT_ROLLOFF, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Occlusion Attenuation", float, occlusionAttenuation_, DEFAULT_OCCLUSION_ATTENUATION, AM_DEFAULT);
 }
 
 void SoundSource3D::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
@@ -140,6 +144,17 @@ void SoundSource3D::SetOuterAngle(float angle)
     MarkNetworkUpdate();
 }
 
+void SoundSource3D::SetOcclusionAttenuation(float attenuation)
+{
+    occlusionAttenuation_ = Clamp(attenuation, 0.0f, 1.0f);
+    MarkNetworkUpdate();
+}
+
+void SoundSource3D::SetOcclusion(float occlusion)
+{
+    occlusion_ = Clamp(occlusion, 0.0f, 1.0f);
+}
+
 void SoundSource3D::SetRolloffFactor(float factor)
 {
     rolloffFactor_ = Max(factor, MIN_ROLLOFF);
@@ -196,6 +211,10 @@ void SoundSource3D::CalculateAttenuation()
 
                 attenuation_ *= angleAttenuation;
             }
+
+            // Occlusion attenuation
+            if (occlusion_ > 0.0f)
+                attenuation_ *= Lerp(1.0f, occlusionAttenuation_, occlusion_);
         }
         else
             attenuation_ = 0.0f;
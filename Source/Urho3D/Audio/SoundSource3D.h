@@ -65,6 +65,12 @@ public:
     /// Set rolloff power factor, defines attenuation function shape.
     /// @property
     void SetRolloffFactor(float factor);
+    /// Set attenuation applied when the sound is fully occluded. 1.0 disables the effect of occlusion, 0.0 silences occluded sound.
+    /// @property
+    void SetOcclusionAttenuation(float attenuation);
+    /// Set amount of occlusion between the sound and the listener from 0 to 1. Usually set by SoundOcclusion.
+    /// @property
+    void SetOcclusion(float occlusion);
     /// Calculate attenuation and panning based on current position and listener position.
     void CalculateAttenuation();
 
@@ -88,6 +94,14 @@ public:
     /// @property{get_rolloffFactor}
     float RollAngleoffFactor() const { return rolloffFactor_; }
 
+    /// Return attenuation applied when the sound is fully occluded.
+    /// @property
+    float GetOcclusionAttenuation() const { return occlusionAttenuation_; }
+
+    /// Return amount of occlusion between the sound and the listener.
+    /// @property
+    float GetOcclusion() const { return occlusion_; }
+
 protected:
     /// Near distance.
     float nearDistance_;
@@ -99,6 +113,10 @@ protected:
     float outerAngle_;
     /// Rolloff power factor.
     float rolloffFactor_;
+    /// Attenuation when fully occluded.
+    float occlusionAttenuation_;
+    /// Current occlusion amount.
+    float occlusion_;
 };
 
 }
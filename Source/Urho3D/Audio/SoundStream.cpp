@@ -42,6 +42,10 @@ bool SoundStream::Seek(unsigned int sample_number)
     return false;
 }
 
+void SoundStream::Prefetch(WorkQueue* workQueue)
+{
+}
+
 void SoundStream::SetFormat(unsigned frequency, bool sixteenBit, bool stereo)
 {
     frequency_ = frequency;
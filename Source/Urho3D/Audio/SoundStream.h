@@ -27,6 +27,8 @@
 namespace Urho3D
 {
 
+class WorkQueue;
+
 /// Base class for sound streams.
 class URHO3D_API SoundStream : public RefCounted
 {
@@ -41,6 +43,8 @@ public:
 
     /// Produce sound data into destination. Return number of bytes produced. Called by SoundSource from the mixing thread.
     virtual unsigned GetData(signed char* dest, unsigned numBytes) = 0;
+    /// Produce sound data ahead of the mixer using worker threads. Called by SoundSource from the main thread. Need not be implemented by all streams.
+    virtual void Prefetch(WorkQueue* workQueue);
 
     /// Set sound data format.
     void SetFormat(unsigned frequency, bool sixteenBit, bool stereo);
@@ -42,7 +42,7 @@ namespace Urho3DNet
         private static void EventHandlerCallback(IntPtr actionHandle, uint eventHash, IntPtr argMap)
         {
             var eventHandler = (Action<StringHash, VariantMap>)GCHandle.FromIntPtr(actionHandle).Target;
-            eventHandler(new StringHash(eventHash), VariantMap.wrap(argMap, false));
+            eventHandler(new StringHash(eventHash), VariantMap.GetEventWrapper(argMap));
         }
         private static readonly EventCallbackDelegate EventHandlerCallbackInstance = EventHandlerCallback;
 
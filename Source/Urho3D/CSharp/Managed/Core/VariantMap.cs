@@ -0,0 +1,137 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+using System;
+using System.Runtime.InteropServices;
+using System.Security;
+
+namespace Urho3DNet
+{
+    public partial class VariantMap
+    {
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(global::Urho3DNet.Urho3DPINVOKE.DllImportModule, EntryPoint = "Urho3D_VariantMap_GetInt")]
+        private static extern int Urho3D_VariantMap_GetInt(HandleRef map, uint key, int defaultValue);
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(global::Urho3DNet.Urho3DPINVOKE.DllImportModule, EntryPoint = "Urho3D_VariantMap_GetUInt")]
+        private static extern uint Urho3D_VariantMap_GetUInt(HandleRef map, uint key, uint defaultValue);
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(global::Urho3DNet.Urho3DPINVOKE.DllImportModule, EntryPoint = "Urho3D_VariantMap_GetBool")]
+        private static extern int Urho3D_VariantMap_GetBool(HandleRef map, uint key, int defaultValue);
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(global::Urho3DNet.Urho3DPINVOKE.DllImportModule, EntryPoint = "Urho3D_VariantMap_GetFloat")]
+        private static extern float Urho3D_VariantMap_GetFloat(HandleRef map, uint key, float defaultValue);
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(global::Urho3DNet.Urho3DPINVOKE.DllImportModule, EntryPoint = "Urho3D_VariantMap_GetVector2")]
+        private static extern void Urho3D_VariantMap_GetVector2(HandleRef map, uint key, ref Vector2 result);
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(global::Urho3DNet.Urho3DPINVOKE.DllImportModule, EntryPoint = "Urho3D_VariantMap_GetVector3")]
+        private static extern void Urho3D_VariantMap_GetVector3(HandleRef map, uint key, ref Vector3 result);
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(global::Urho3DNet.Urho3DPINVOKE.DllImportModule, EntryPoint = "Urho3D_VariantMap_GetQuaternion")]
+        private static extern void Urho3D_VariantMap_GetQuaternion(HandleRef map, uint key, ref Quaternion result);
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(global::Urho3DNet.Urho3DPINVOKE.DllImportModule, EntryPoint = "Urho3D_VariantMap_GetObject")]
+        private static extern IntPtr Urho3D_VariantMap_GetObject(HandleRef map, uint key);
+
+        /// <summary>
+        /// Number of recently delivered event data maps whose wrappers are reused.
+        /// </summary>
+        private const int EventWrapperPoolSize = 8;
+        [ThreadStatic]
+        private static VariantMap[] _eventWrapperPool;
+        [ThreadStatic]
+        private static int _nextEventWrapper;
+
+        /// <summary>
+        /// Return non-owning wrapper of event data map. Context reuses one map per event nesting level, so wrappers of
+        /// recently seen maps are kept and per-frame events do not allocate. Wrapper is valid only during event delivery.
+        /// </summary>
+        internal static VariantMap GetEventWrapper(IntPtr map)
+        {
+            var pool = _eventWrapperPool;
+            if (pool == null)
+                _eventWrapperPool = pool = new VariantMap[EventWrapperPoolSize];
+
+            for (int i = 0; i < pool.Length; ++i)
+            {
+                if (pool[i] != null && pool[i].swigCPtr.Handle == map)
+                    return pool[i];
+            }
+
+            var wrapper = wrap(map, false);
+            pool[_nextEventWrapper] = wrapper;
+            _nextEventWrapper = (_nextEventWrapper + 1) % pool.Length;
+            return wrapper;
+        }
+
+        public int GetInt(StringHash key, int defaultValue = 0)
+        {
+            return Urho3D_VariantMap_GetInt(swigCPtr, key.Hash, defaultValue);
+        }
+
+        public uint GetUInt(StringHash key, uint defaultValue = 0)
+        {
+            return Urho3D_VariantMap_GetUInt(swigCPtr, key.Hash, defaultValue);
+        }
+
+        public bool GetBool(StringHash key, bool defaultValue = false)
+        {
+            return Urho3D_VariantMap_GetBool(swigCPtr, key.Hash, defaultValue ? 1 : 0) != 0;
+        }
+
+        public float GetFloat(StringHash key, float defaultValue = 0.0f)
+        {
+            return Urho3D_VariantMap_GetFloat(swigCPtr, key.Hash, defaultValue);
+        }
+
+        public Vector2 GetVector2(StringHash key)
+        {
+            var result = Vector2.ZERO;
+            Urho3D_VariantMap_GetVector2(swigCPtr, key.Hash, ref result);
+            return result;
+        }
+
+        public Vector3 GetVector3(StringHash key)
+        {
+            var result = Vector3.Zero;
+            Urho3D_VariantMap_GetVector3(swigCPtr, key.Hash, ref result);
+            return result;
+        }
+
+        public Quaternion GetQuaternion(StringHash key)
+        {
+            var result = Quaternion.IDENTITY;
+            Urho3D_VariantMap_GetQuaternion(swigCPtr, key.Hash, ref result);
+            return result;
+        }
+
+        /// <summary>
+        /// Return object stored in the map. Wrappers of engine objects are cached, so this does not allocate for objects
+        /// that were already seen by managed code.
+        /// </summary>
+        public T GetObject<T>(StringHash key) where T : Object
+        {
+            return Object.wrap(Urho3D_VariantMap_GetObject(swigCPtr, key.Hash), false) as T;
+        }
+    }
+}
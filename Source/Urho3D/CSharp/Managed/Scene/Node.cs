@@ -20,10 +20,169 @@
 // THE SOFTWARE.
 //
 
+using System;
+using System.Runtime.InteropServices;
+using System.Security;
+
 namespace Urho3DNet
 {
     public partial class Node
     {
+        /// <summary>
+        /// Number of node pointers marshaled on the stack per native call of batched transform accessors.
+        /// </summary>
+        private const int TransformBatchSize = 256;
+
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(global::Urho3DNet.Urho3DPINVOKE.DllImportModule, EntryPoint = "Urho3D_Node_GetPositions")]
+        private static extern unsafe void Urho3D_Node_GetPositions(IntPtr* nodes, int count, Vector3* positions);
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(global::Urho3DNet.Urho3DPINVOKE.DllImportModule, EntryPoint = "Urho3D_Node_SetPositions")]
+        private static extern unsafe void Urho3D_Node_SetPositions(IntPtr* nodes, int count, Vector3* positions);
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(global::Urho3DNet.Urho3DPINVOKE.DllImportModule, EntryPoint = "Urho3D_Node_GetWorldPositions")]
+        private static extern unsafe void Urho3D_Node_GetWorldPositions(IntPtr* nodes, int count, Vector3* positions);
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(global::Urho3DNet.Urho3DPINVOKE.DllImportModule, EntryPoint = "Urho3D_Node_GetTransforms")]
+        private static extern unsafe void Urho3D_Node_GetTransforms(IntPtr* nodes, int count, Vector3* positions, Quaternion* rotations);
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(global::Urho3DNet.Urho3DPINVOKE.DllImportModule, EntryPoint = "Urho3D_Node_SetTransforms")]
+        private static extern unsafe void Urho3D_Node_SetTransforms(IntPtr* nodes, int count, Vector3* positions, Quaternion* rotations);
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(global::Urho3DNet.Urho3DPINVOKE.DllImportModule, EntryPoint = "Urho3D_Node_GetWorldTransforms")]
+        private static extern unsafe void Urho3D_Node_GetWorldTransforms(IntPtr* nodes, int count, Matrix3x4* transforms);
+
+        /// <summary>
+        /// Validate arguments of batched transform accessors.
+        /// </summary>
+        private static void CheckTransformBatch(Node[] nodes, int valuesLength)
+        {
+            if (nodes == null)
+                throw new ArgumentNullException(nameof(nodes));
+            if (valuesLength < nodes.Length)
+                throw new ArgumentException("Value array is shorter than node array.");
+        }
+
+        /// <summary>
+        /// Copy native pointers of the next batch of nodes starting at offset. Returns number of copied pointers.
+        /// </summary>
+        private static unsafe int GetTransformBatch(Node[] nodes, int offset, IntPtr* pointers)
+        {
+            int count = Math.Min(TransformBatchSize, nodes.Length - offset);
+            for (int i = 0; i < count; ++i)
+            {
+                IntPtr pointer = getCPtr(nodes[offset + i]).Handle;
+                if (pointer == IntPtr.Zero)
+                    throw new ArgumentNullException(nameof(nodes), "Node array contains null or disposed nodes.");
+                pointers[i] = pointer;
+            }
+            return count;
+        }
+
+        /// <summary>
+        /// Get local positions of many nodes with a single native call per batch.
+        /// </summary>
+        public static unsafe void GetPositions(Node[] nodes, Vector3[] positions)
+        {
+            CheckTransformBatch(nodes, positions.Length);
+            IntPtr* pointers = stackalloc IntPtr[TransformBatchSize];
+            fixed (Vector3* pPositions = positions)
+            {
+                for (int offset = 0; offset < nodes.Length; offset += TransformBatchSize)
+                {
+                    int count = GetTransformBatch(nodes, offset, pointers);
+                    Urho3D_Node_GetPositions(pointers, count, pPositions + offset);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Set local positions of many nodes with a single native call per batch.
+        /// </summary>
+        public static unsafe void SetPositions(Node[] nodes, Vector3[] positions)
+        {
+            CheckTransformBatch(nodes, positions.Length);
+            IntPtr* pointers = stackalloc IntPtr[TransformBatchSize];
+            fixed (Vector3* pPositions = positions)
+            {
+                for (int offset = 0; offset < nodes.Length; offset += TransformBatchSize)
+                {
+                    int count = GetTransformBatch(nodes, offset, pointers);
+                    Urho3D_Node_SetPositions(pointers, count, pPositions + offset);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Get world positions of many nodes with a single native call per batch.
+        /// </summary>
+        public static unsafe void GetWorldPositions(Node[] nodes, Vector3[] positions)
+        {
+            CheckTransformBatch(nodes, positions.Length);
+            IntPtr* pointers = stackalloc IntPtr[TransformBatchSize];
+            fixed (Vector3* pPositions = positions)
+            {
+                for (int offset = 0; offset < nodes.Length; offset += TransformBatchSize)
+                {
+                    int count = GetTransformBatch(nodes, offset, pointers);
+                    Urho3D_Node_GetWorldPositions(pointers, count, pPositions + offset);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Get local positions and rotations of many nodes with a single native call per batch.
+        /// </summary>
+        public static unsafe void GetTransforms(Node[] nodes, Vector3[] positions, Quaternion[] rotations)
+        {
+            CheckTransformBatch(nodes, Math.Min(positions.Length, rotations.Length));
+            IntPtr* pointers = stackalloc IntPtr[TransformBatchSize];
+            fixed (Vector3* pPositions = positions)
+            fixed (Quaternion* pRotations = rotations)
+            {
+                for (int offset = 0; offset < nodes.Length; offset += TransformBatchSize)
+                {
+                    int count = GetTransformBatch(nodes, offset, pointers);
+                    Urho3D_Node_GetTransforms(pointers, count, pPositions + offset, pRotations + offset);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Set local positions and rotations of many nodes with a single native call per batch.
+        /// </summary>
+        public static unsafe void SetTransforms(Node[] nodes, Vector3[] positions, Quaternion[] rotations)
+        {
+            CheckTransformBatch(nodes, Math.Min(positions.Length, rotations.Length));
+            IntPtr* pointers = stackalloc IntPtr[TransformBatchSize];
+            fixed (Vector3* pPositions = positions)
+            fixed (Quaternion* pRotations = rotations)
+            {
+                for (int offset = 0; offset < nodes.Length; offset += TransformBatchSize)
+                {
+                    int count = GetTransformBatch(nodes, offset, pointers);
+                    Urho3D_Node_SetTransforms(pointers, count, pPositions + offset, pRotations + offset);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Get world transforms of many nodes with a single native call per batch.
+        /// </summary>
+        public static unsafe void GetWorldTransforms(Node[] nodes, Matrix3x4[] transforms)
+        {
+            CheckTransformBatch(nodes, transforms.Length);
+            IntPtr* pointers = stackalloc IntPtr[TransformBatchSize];
+            fixed (Matrix3x4* pTransforms = transforms)
+            {
+                for (int offset = 0; offset < nodes.Length; offset += TransformBatchSize)
+                {
+                    int count = GetTransformBatch(nodes, offset, pointers);
+                    Urho3D_Node_GetWorldTransforms(pointers, count, pTransforms + offset);
+                }
+            }
+        }
+
         public T CreateComponent<T>(CreateMode mode = CreateMode.Replicated, uint id = 0) where T: Component
         {
             return (T)CreateComponent(typeof(T).Name, mode, id);
@@ -0,0 +1,77 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#include <Urho3D/Scene/Node.h>
+#include <Urho3D/Script/Script.h>
+
+namespace Urho3D
+{
+
+extern "C"
+{
+
+// Batched transform accessors let managed code update many nodes with a single P/Invoke transition instead of
+// one call per node and property.
+
+URHO3D_EXPORT_API void SWIGSTDCALL Urho3D_Node_GetPositions(Node** nodes, int count, Vector3* positions)
+{
+    for (int i = 0; i < count; ++i)
+        positions[i] = nodes[i]->GetPosition();
+}
+
+URHO3D_EXPORT_API void SWIGSTDCALL Urho3D_Node_SetPositions(Node** nodes, int count, const Vector3* positions)
+{
+    for (int i = 0; i < count; ++i)
+        nodes[i]->SetPosition(positions[i]);
+}
+
+URHO3D_EXPORT_API void SWIGSTDCALL Urho3D_Node_GetWorldPositions(Node** nodes, int count, Vector3* positions)
+{
+    for (int i = 0; i < count; ++i)
+        positions[i] = nodes[i]->GetWorldPosition();
+}
+
+URHO3D_EXPORT_API void SWIGSTDCALL Urho3D_Node_GetTransforms(Node** nodes, int count, Vector3* positions, Quaternion* rotations)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        positions[i] = nodes[i]->GetPosition();
+        rotations[i] = nodes[i]->GetRotation();
+    }
+}
+
+URHO3D_EXPORT_API void SWIGSTDCALL Urho3D_Node_SetTransforms(Node** nodes, int count, const Vector3* positions, const Quaternion* rotations)
+{
+    for (int i = 0; i < count; ++i)
+        nodes[i]->SetTransform(positions[i], rotations[i]);
+}
+
+URHO3D_EXPORT_API void SWIGSTDCALL Urho3D_Node_GetWorldTransforms(Node** nodes, int count, Matrix3x4* transforms)
+{
+    for (int i = 0; i < count; ++i)
+        transforms[i] = nodes[i]->GetWorldTransform();
+}
+
+}   // extern "C"
+
+}   // namespace Urho3D
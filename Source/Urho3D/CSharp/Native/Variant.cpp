@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#include <Urho3D/Core/Object.h>
+#include <Urho3D/Core/Variant.h>
+#include <Urho3D/Script/Script.h>
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Return value stored in the map or null if key is missing.
+const Variant* FindValue(const VariantMap* map, unsigned key)
+{
+    auto it = map->find(StringHash(key));
+    return it != map->end() ? &it->second : nullptr;
+}
+
+}
+
+extern "C"
+{
+
+// Typed accessors read event parameters without allocating managed Variant wrappers.
+
+URHO3D_EXPORT_API int SWIGSTDCALL Urho3D_VariantMap_GetInt(const VariantMap* map, unsigned key, int defaultValue)
+{
+    const Variant* value = FindValue(map, key);
+    return value ? value->GetInt() : defaultValue;
+}
+
+URHO3D_EXPORT_API unsigned SWIGSTDCALL Urho3D_VariantMap_GetUInt(const VariantMap* map, unsigned key, unsigned defaultValue)
+{
+    const Variant* value = FindValue(map, key);
+    return value ? value->GetUInt() : defaultValue;
+}
+
+URHO3D_EXPORT_API int SWIGSTDCALL Urho3D_VariantMap_GetBool(const VariantMap* map, unsigned key, int defaultValue)
+{
+    const Variant* value = FindValue(map, key);
+    return value ? value->GetBool() : defaultValue;
+}
+
+URHO3D_EXPORT_API float SWIGSTDCALL Urho3D_VariantMap_GetFloat(const VariantMap* map, unsigned key, float defaultValue)
+{
+    const Variant* value = FindValue(map, key);
+    return value ? value->GetFloat() : defaultValue;
+}
+
+URHO3D_EXPORT_API void SWIGSTDCALL Urho3D_VariantMap_GetVector2(const VariantMap* map, unsigned key, Vector2* result)
+{
+    if (const Variant* value = FindValue(map, key))
+        *result = value->GetVector2();
+}
+
+URHO3D_EXPORT_API void SWIGSTDCALL Urho3D_VariantMap_GetVector3(const VariantMap* map, unsigned key, Vector3* result)
+{
+    if (const Variant* value = FindValue(map, key))
+        *result = value->GetVector3();
+}
+
+URHO3D_EXPORT_API void SWIGSTDCALL Urho3D_VariantMap_GetQuaternion(const VariantMap* map, unsigned key, Quaternion* result)
+{
+    if (const Variant* value = FindValue(map, key))
+        *result = value->GetQuaternion();
+}
+
+URHO3D_EXPORT_API Object* SWIGSTDCALL Urho3D_VariantMap_GetObject(const VariantMap* map, unsigned key)
+{
+    const Variant* value = FindValue(map, key);
+    return value ? dynamic_cast<Object*>(value->GetPtr()) : nullptr;
+}
+
+}   // extern "C"
+
+}   // namespace Urho3D
@@ -117,6 +117,8 @@ using namespace Urho3D;
 #endif
 
 #define URHO3D_TYPE_TRAIT(...)
+#define URHO3D_POOLED_OBJECT()
+#define URHO3D_SINGLE_THREADED_REFCOUNT()
 
 %apply void* VOID_INT_PTR {
 	SDL_Cursor*,
@@ -348,15 +350,21 @@ namespace SDL
 
 // --------------------------------------- Engine ---------------------------------------
 %ignore Urho3D::Engine::DefineParameters;
+%ignore Urho3D::Engine::QueuePipelinedWork;
 %ignore Urho3D::Application::engine_;
 %ignore Urho3D::Application::GetCommandLineParser;
 %ignore Urho3D::PluginApplication::PluginApplicationMain;
 %ignore Urho3D::PluginApplication::InitializeReloadablePlugin;
 %ignore Urho3D::PluginApplication::UninitializeReloadablePlugin;
+%ignore Urho3D::QualityKnob::apply_;
+%ignore Urho3D::PerformanceGovernor::AddKnob;
+%ignore Urho3D::PerformanceGovernor::GetKnobs;
 
 %include "generated/Urho3D/_pre_engine.i"
 %include "Urho3D/Engine/EngineDefs.h"
 %include "Urho3D/Engine/Engine.h"
+%include "Urho3D/Engine/HitchDetector.h"
+%include "Urho3D/Engine/PerformanceGovernor.h"
 %include "Urho3D/Engine/Application.h"
 %include "Urho3D/Engine/PluginApplication.h"
 %include "generated/Urho3D/_pre_script.i"
@@ -378,6 +386,7 @@ namespace SDL
 
 %ignore Urho3D::TouchState::GetTouchedElement;
 %ignore Urho3D::Input::OnRawInput;
+%ignore Urho3D::Input::InjectSDLEvent;
 
 %include "generated/Urho3D/_pre_input.i"
 %include "Urho3D/Input/InputConstants.h"
@@ -388,6 +397,20 @@ namespace SDL
 %ignore Urho3D::GetWideNativePath;
 %ignore Urho3D::logLevelNames;
 %ignore Urho3D::LOG_LEVEL_COLORS;
+%ignore Urho3D::Deserializer::GetMemoryData;
+%ignore Urho3D::File::GetMemoryData;
+%ignore Urho3D::MemoryBuffer::GetMemoryData;
+%ignore Urho3D::VectorBuffer::GetMemoryData;
+%ignore Urho3D::PackageDirectoryEntry;
+%ignore Urho3D::AsyncFileRead;
+%ignore Urho3D::AsyncFileReader;
+%ignore Urho3D::FileSystem::ReadFileAsync;
+%ignore Urho3D::ResourceCache::ReadFileAsync;
+%ignore Urho3D::ResourceCache::GetLoadGraph;
+%ignore Urho3D::ResourceLoadGraph;
+%ignore Urho3D::ResourceLoadNode;
+%ignore Urho3D::ResourceIndexShard;
+%ignore Urho3D::NUM_RESOURCE_INDEX_SHARDS;
 
 %extend Urho3D::Log {
 public:
@@ -452,7 +475,6 @@ public:
 
 // These expose iterators of underlying collection. Iterate object through GetObject() instead.
 %ignore Urho3D::BackgroundLoadItem;
-%ignore Urho3D::BackgroundLoader::ThreadFunction;
 %ignore Urho3D::ImageCube::CalculateSphericalHarmonics;
 %rename(GetValueType) Urho3D::PListValue::GetType;
 
@@ -487,6 +509,7 @@ public:
 %ignore Urho3D::Serializable::instanceDefaultValues_;
 %ignore Urho3D::Serializable::temporary_;
 %ignore Urho3D::ReplicationState::connection_;
+%ignore Urho3D::NetworkState::encodeMutex_;
 %ignore Urho3D::Component::CleanupConnection;
 %ignore Urho3D::Scene::CleanupConnection;
 %ignore Urho3D::Node::CleanupConnection;
@@ -495,6 +518,11 @@ public:
 %ignore Urho3D::Node::SetEntity;
 %ignore Urho3D::Scene::GetRegistry;
 %ignore Urho3D::Scene::GetComponentIndex;
+%ignore Urho3D::Scene::ScheduleCall;
+%ignore Urho3D::Scene::CancelCall;
+%ignore Urho3D::TimerHandle;
+%ignore Urho3D::TimerWheel;
+%ignore Urho3D::SceneComponentIndex;
 %ignore Urho3D::Animatable::animationEnabled_;
 %ignore Urho3D::Animatable::objectAnimation_;
 %ignore Urho3D::Component::node_;
@@ -522,9 +550,15 @@ public:
 %ignore Urho3D::BufferedSoundStream::AddData(const ea::shared_array<signed char>& data, unsigned numBytes);
 %ignore Urho3D::BufferedSoundStream::AddData(const ea::shared_array<signed short>& data, unsigned numBytes);
 %ignore Urho3D::Sound::GetData;
+%ignore Urho3D::Audio::GetEffects;
+%ignore Urho3D::AudioEffect::Process;
+%ignore Urho3D::BiquadFilterEffect::Process;
+%ignore Urho3D::CompressorEffect::Process;
+%ignore Urho3D::ReverbEffect::Process;
 
 %include "generated/Urho3D/_pre_audio.i"
 %include "Urho3D/Audio/AudioDefs.h"
+%include "Urho3D/Audio/AudioEffect.h"
 %include "Urho3D/Audio/Audio.h"
 %include "Urho3D/Audio/Sound.h"
 %include "Urho3D/Audio/SoundStream.h"
@@ -537,6 +571,7 @@ public:
 // --------------------------------------- IK ---------------------------------------
 #if defined(URHO3D_IK)
 %{ using Algorithm = Urho3D::IKSolver::Algorithm; %}
+%ignore Urho3D::IKSolver::SolveAll;
 
 %include "generated/Urho3D/_pre_ik.i"
 %include "Urho3D/IK/IKConstraint.h"
@@ -551,7 +586,6 @@ public:
 %ignore Urho3D::PointOctreeQuery::TestDrawables;
 %ignore Urho3D::BoxOctreeQuery::TestDrawables;
 %ignore Urho3D::OctreeQuery::TestDrawables;
-%ignore Urho3D::UpdateDrawablesWork;
 %ignore Urho3D::ProcessLightWork;
 %ignore Urho3D::CheckVisibilityWork;
 %ignore Urho3D::CheckDrawableVisibilityWork;
@@ -566,7 +600,17 @@ public:
 %ignore Urho3D::IndexBufferDesc;
 %ignore Urho3D::VertexBufferDesc;
 %ignore Urho3D::GPUObject::GetGraphics;
+%ignore Urho3D::GPUProfileZone;
+%ignore Urho3D::Graphics::AddUploadedBytes;
+%ignore Urho3D::Graphics::QueueUpload;
+%ignore Urho3D::Texture2D::SetDataAsync;
+%ignore Urho3D::VertexBuffer::SetDataRangeAsync;
+%ignore Urho3D::IndexBuffer::SetDataRangeAsync;
 %ignore Urho3D::Terrain::GetHeightData; // eastl::shared_array<float>
+%ignore Urho3D::TerrainPatchGeometryData;
+%ignore Urho3D::AnimationPose;
+%ignore Urho3D::AnimationState::Apply(AnimationPose& pose);
+%ignore Urho3D::Octree::GetAnimationPoseCache;
 %ignore Urho3D::Geometry::GetRawData;
 %ignore Urho3D::Geometry::SetRawVertexData;
 %ignore Urho3D::Geometry::SetRawIndexData;
@@ -585,11 +629,18 @@ public:
 %ignore Urho3D::CustomGeometry::DrawOcclusion;
 %ignore Urho3D::CustomGeometry::MakeCircleGraph;
 %ignore Urho3D::CustomGeometry::ProcessRayQuery;
+%ignore Urho3D::CustomGeometry::SetStreamGenerator;
+%ignore Urho3D::CustomGeometry::BeginStreamGeometry;
+%ignore Urho3D::CustomGeometry::BeginStreamRange;
+%ignore Urho3D::CustomGeometry::UpdateGeometry;
+%ignore Urho3D::CustomGeometry::FinishUpdateGeometry;
 %ignore Urho3D::OcclusionBufferData::dataWithSafety_;
 %ignore Urho3D::ScenePassInfo::batchQueue_;
 %ignore Urho3D::LightQueryResult;
 %ignore Urho3D::View::GetLightQueues;
-%ignore Urho3D::Drawable::GetMutableLightProbeTetrahedronHint;
+%ignore Urho3D::Drawable::GetMutableLightProbeCache;
+%ignore Urho3D::Drawable::GetLightProbeCache;
+%ignore Urho3D::DrawableLightProbeCache;
 %ignore Urho3D::Skybox::GetImage;   // Needs ImageCube
 %ignore Urho3D::Drawable2D::layer_;
 %ignore Urho3D::Drawable2D::orderInLayer_;
@@ -619,6 +670,8 @@ public:
 %ignore Urho3D::Drawable::lights_;
 %ignore Urho3D::Drawable::vertexLights_;
 %ignore Urho3D::GlobalIllumination::SampleAmbientSH;
+%ignore Urho3D::GlobalIllumination::UpdateLightProbeCache;
+%ignore Urho3D::GlobalIllumination::SampleAverageAmbient(const DrawableLightProbeCache& cache) const;
 %rename(DrawableFlags) Urho3D::DrawableFlag;
 
 %apply void* VOID_INT_PTR {
@@ -647,19 +700,26 @@ public:
 %include "Urho3D/Graphics/TextureCube.h"
 //%include "Urho3D/Graphics/Batch.h"
 %include "Urho3D/Graphics/Skeleton.h"
+%ignore Urho3D::Model::SetGeometryClusters;
+%ignore Urho3D::Model::GetGeometryClusters;
 %include "Urho3D/Graphics/Model.h"
+%ignore Urho3D::StaticModelClusterData;
 %include "Urho3D/Graphics/StaticModel.h"
 %include "Urho3D/Graphics/StaticModelGroup.h"
+%include "Urho3D/Graphics/HierarchicalLod.h"
+%include "Urho3D/Graphics/ImpostorGroup.h"
 %include "Urho3D/Graphics/Animation.h"
 %include "Urho3D/Graphics/AnimationState.h"
 %include "Urho3D/Graphics/AnimationController.h"
 %include "Urho3D/Graphics/AnimatedModel.h"
 %include "Urho3D/Graphics/BillboardSet.h"
 %include "Urho3D/Graphics/DecalSet.h"
+%include "Urho3D/Graphics/DeferredDecalSet.h"
 %include "Urho3D/Graphics/Light.h"
 %include "Urho3D/Graphics/ConstantBuffer.h"
 %include "Urho3D/Graphics/ShaderVariation.h"
 %include "Urho3D/Graphics/ShaderPrecache.h"
+%template(ShaderCombinationUsageVector) eastl::vector<Urho3D::ShaderCombinationUsage>;
 #if defined(URHO3D_OPENGL)
 %include "Urho3D/Graphics/OpenGL/OGLShaderProgram.h"
 #elif defined(URHO3D_D3D11)
@@ -668,10 +728,17 @@ public:
 %include "Urho3D/Graphics/Direct3D9/D3D9ShaderProgram.h"
 #endif
 %include "Urho3D/Graphics/Tangent.h"
+%ignore Urho3D::OptimizeVertexCache;
+%ignore Urho3D::OptimizeOverdraw;
+%ignore Urho3D::CalculateVertexCacheMissRatio;
+%ignore Urho3D::SimplifyMesh;
+%ignore Urho3D::GenerateClusters;
+%include "Urho3D/Graphics/MeshOptimizer.h"
 //%include "Urho3D/Graphics/VertexDeclaration.h"
 %include "Urho3D/Graphics/Camera.h"
 %include "Urho3D/Graphics/GlobalIllumination.h"
 %include "Urho3D/Graphics/View.h"
+%template(RenderPathCommandStatisticsVector) eastl::vector<Urho3D::RenderPathCommandStatistics>;
 %include "Urho3D/Graphics/Material.h"
 %include "Urho3D/Graphics/CustomGeometry.h"
 %include "Urho3D/Graphics/ParticleEffect.h"
@@ -682,6 +749,7 @@ public:
 %include "Urho3D/Graphics/Skybox.h"
 %include "Urho3D/Graphics/TerrainPatch.h"
 %include "Urho3D/Graphics/Terrain.h"
+%ignore Urho3D::DebugPrimitives;
 %include "Urho3D/Graphics/DebugRenderer.h"
 %include "Urho3D/Graphics/Zone.h"
 %include "Urho3D/Graphics/Renderer.h"
@@ -723,6 +791,7 @@ public:
 %ignore Urho3D::Network::MakeHttpRequest;
 %ignore Urho3D::PackageDownload;
 %ignore Urho3D::PackageUpload;
+%ignore Urho3D::NetworkTrafficStats;
 
 // These methods use forward-declared types from SLikeNet.
 %ignore Urho3D::Connection::Connection;
@@ -740,6 +809,7 @@ public:
 %include "Urho3D/Network/Connection.h"
 %include "Urho3D/Network/Network.h"
 %include "Urho3D/Network/NetworkPriority.h"
+%include "Urho3D/Network/TransformHistory.h"
 %include "Urho3D/Network/Protocol.h"
 
 %template(ConnectionVector) eastl::vector<Urho3D::SharedPtr<Urho3D::Connection>>;
@@ -750,6 +820,10 @@ public:
 %ignore Urho3D::TriangleMeshData::meshInterface_;
 %ignore Urho3D::TriangleMeshData::shape_;
 %ignore Urho3D::TriangleMeshData::infoMap_;
+%ignore Urho3D::TriangleMeshData::cookedGeometry_;
+%ignore Urho3D::CookedCollisionGeometry::GetTriangleMeshBvh;
+%ignore Urho3D::CookedCollisionGeometry::GetConvexHull;
+%ignore Urho3D::CookedConvexHull;
 %ignore Urho3D::GImpactMeshData::meshInterface_;
 %ignore Urho3D::HeightfieldData::heightData_;
 %ignore Urho3D::ConvexData::indexData_;
@@ -757,6 +831,7 @@ public:
 %ignore Urho3D::PhysicsWorld::GetTriMeshCache;
 %ignore Urho3D::PhysicsWorld::GetGImpactTrimeshCache;
 %ignore Urho3D::PhysicsWorld::GetConvexCache;
+%ignore Urho3D::PhysicsWorld::GetLodAnchors;
 %ignore Urho3D::RigidBody::getWorldTransform;
 %ignore Urho3D::RigidBody::setWorldTransform;
 %apply void* VOID_INT_PTR {
@@ -777,10 +852,12 @@ public:
 
 %include "generated/Urho3D/_pre_physics.i"
 %include "Urho3D/Physics/CollisionShape.h"
+%include "Urho3D/Physics/CookedCollisionGeometry.h"
 %include "Urho3D/Physics/Constraint.h"
 %include "Urho3D/Physics/PhysicsWorld.h"
 %include "Urho3D/Physics/RaycastVehicle.h"
 %include "Urho3D/Physics/RigidBody.h"
+%include "Urho3D/Physics/SoundOcclusion.h"
 %template(PhysicsRaycastResultVector)   eastl::vector<Urho3D::PhysicsRaycastResult>;
 %template(RigidBodyVector)              eastl::vector<Urho3D::RigidBody*>;
 #endif
@@ -817,6 +894,18 @@ using ImGuiConfigFlags = unsigned;
 %ignore Urho3D::UIElement::GetBatches;
 %ignore Urho3D::UIElement::GetDebugDrawBatches;
 %ignore Urho3D::UIElement::GetBatchesWithOffset;
+%ignore Urho3D::UI::GetTextureAtlas;
+%ignore Urho3D::UI::DeferLayoutUpdate;
+%ignore Urho3D::VirtualListView::SetItemFactory;
+%ignore Urho3D::VirtualListView::SetItemBinder;
+%ignore Urho3D::UIElement::IsBatchCacheValid;
+%ignore Urho3D::UIElement::SetCachedBatches;
+%ignore Urho3D::UIElement::AppendCachedBatches;
+%ignore Urho3D::UIElement::IsBitmapCacheValid;
+%ignore Urho3D::UIElement::SetCachedBitmap;
+%ignore Urho3D::UIElement::GetCachedBitmap;
+%ignore Urho3D::UIElement::GetCachedBatches;
+%ignore Urho3D::UIElement::GetCachedVertexData;
 
 %include "generated/Urho3D/_pre_ui.i"
 %include "Urho3D/UI/UI.h"
@@ -840,6 +929,7 @@ using ImGuiConfigFlags = unsigned;
 %include "Urho3D/UI/Cursor.h"
 %include "Urho3D/UI/FileSelector.h"
 %include "Urho3D/UI/ListView.h"
+%include "Urho3D/UI/VirtualListView.h"
 %include "Urho3D/UI/MessageBox.h"
 %include "Urho3D/UI/ScrollBar.h"
 %include "Urho3D/UI/Slider.h"
@@ -857,6 +947,10 @@ using ImGuiConfigFlags = unsigned;
 
 %ignore Urho3D::AnimationSet2D::GetSpriterData;
 %ignore Urho3D::PhysicsWorld2D::DrawTransform;
+%ignore Urho3D::PhysicsWorld2D::ContactInfo;
+%ignore Urho3D::PhysicsWorld2D::GetBeginContacts;
+%ignore Urho3D::PhysicsWorld2D::GetEndContacts;
+%ignore Urho3D::PhysicsWorld2D::UpdateWorlds;
 
 // SWIG applies `override new` modifier by mistake.
 %csmethodmodifiers Urho3D::Drawable2D::OnSceneSet "protected override";
@@ -901,6 +995,7 @@ using ImGuiConfigFlags = unsigned;
 %include "Urho3D/Urho2D/ParticleEffect2D.h"
 %include "Urho3D/Urho2D/Renderer2D.h"
 %include "Urho3D/Urho2D/SpriteSheet2D.h"
+%include "Urho3D/Urho2D/TileMapChunk2D.h"
 %include "Urho3D/Urho2D/TileMapLayer2D.h"
 %include "Urho3D/Urho2D/ParticleEmitter2D.h"
 %include "Urho3D/Urho2D/Sprite2D.h"
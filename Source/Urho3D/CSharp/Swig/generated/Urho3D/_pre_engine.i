@@ -113,6 +113,11 @@
 %csattribute(Urho3D::Engine, %arg(bool), IsInitialized, IsInitialized);
 %csattribute(Urho3D::Engine, %arg(bool), IsExiting, IsExiting);
 %csattribute(Urho3D::Engine, %arg(bool), IsHeadless, IsHeadless);
+%csconstvalue("0") Urho3D::HITCH_CAUSE_NONE;
+%typemap(csattributes) Urho3D::HitchCause "[global::System.Flags]";
+using HitchCauseFlags = Urho3D::HitchCause;
+%typemap(ctype) HitchCauseFlags "size_t";
+%typemap(out) HitchCauseFlags "$result = (size_t)$1.AsInteger();"
 %pragma(csharp) moduleimports=%{
 public static partial class E
 {
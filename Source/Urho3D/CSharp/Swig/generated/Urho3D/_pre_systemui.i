@@ -4,7 +4,10 @@
 %csconstvalue("0") Urho3D::DEBUGHUD_SHOW_NONE;
 %csconstvalue("1") Urho3D::DEBUGHUD_SHOW_STATS;
 %csconstvalue("2") Urho3D::DEBUGHUD_SHOW_MODE;
-%csconstvalue("7") Urho3D::DEBUGHUD_SHOW_ALL;
+%csconstvalue("4") Urho3D::DEBUGHUD_SHOW_NETWORK;
+%csconstvalue("8") Urho3D::DEBUGHUD_SHOW_RENDER;
+%csconstvalue("16") Urho3D::DEBUGHUD_SHOW_THREADS;
+%csconstvalue("31") Urho3D::DEBUGHUD_SHOW_ALL;
 %typemap(csattributes) Urho3D::DebugHudMode "[global::System.Flags]";
 using DebugHudModeFlags = Urho3D::DebugHudMode;
 %typemap(ctype) DebugHudModeFlags "size_t";
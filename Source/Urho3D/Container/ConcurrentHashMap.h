@@ -0,0 +1,154 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#pragma once
+
+#include "../Container/ConcurrentQueue.h"
+#include "../Core/Mutex.h"
+
+#include <EASTL/array.h>
+#include <EASTL/optional.h>
+#include <EASTL/unordered_map.h>
+
+namespace Urho3D
+{
+
+/// Hash map safe for concurrent access from multiple threads.
+/// Keys are distributed over independently locked shards, so threads touching different shards never contend.
+/// Values are returned by copy because references would not be protected once the shard is unlocked.
+template <class Key, class Value, unsigned NumShards = 16, class Hash = ea::hash<Key>>
+class ConcurrentHashMap : private NonCopyable
+{
+    static_assert(NumShards > 0 && (NumShards & (NumShards - 1)) == 0, "Number of shards must be a power of two");
+
+public:
+    /// Insert or replace value. Return true if the key was not present.
+    template <class V> bool Insert(const Key& key, V&& value)
+    {
+        Shard& shard = GetShard(key);
+        MutexLock<SpinLockMutex> lock(shard.mutex_);
+        const auto result = shard.map_.insert_or_assign(key, ea::forward<V>(value));
+        return result.second;
+    }
+
+    /// Insert value if the key is not present. Return true if inserted.
+    template <class V> bool TryInsert(const Key& key, V&& value)
+    {
+        Shard& shard = GetShard(key);
+        MutexLock<SpinLockMutex> lock(shard.mutex_);
+        return shard.map_.emplace(key, ea::forward<V>(value)).second;
+    }
+
+    /// Return copy of the value if the key is present.
+    ea::optional<Value> Find(const Key& key) const
+    {
+        const Shard& shard = GetShard(key);
+        MutexLock<SpinLockMutex> lock(shard.mutex_);
+        const auto iter = shard.map_.find(key);
+        if (iter == shard.map_.end())
+            return ea::nullopt;
+        return iter->second;
+    }
+
+    /// Return whether the key is present.
+    bool Contains(const Key& key) const
+    {
+        const Shard& shard = GetShard(key);
+        MutexLock<SpinLockMutex> lock(shard.mutex_);
+        return shard.map_.find(key) != shard.map_.end();
+    }
+
+    /// Erase value. Return true if the key was present.
+    bool Erase(const Key& key)
+    {
+        Shard& shard = GetShard(key);
+        MutexLock<SpinLockMutex> lock(shard.mutex_);
+        return shard.map_.erase(key) != 0;
+    }
+
+    /// Modify value under the shard lock, inserting default value if the key is not present.
+    /// The callback must not access this map.
+    template <class Callback> void Update(const Key& key, Callback callback)
+    {
+        Shard& shard = GetShard(key);
+        MutexLock<SpinLockMutex> lock(shard.mutex_);
+        callback(shard.map_[key]);
+    }
+
+    /// Call callback for each key and value. Shards are locked one at a time, so the iteration is not an atomic snapshot.
+    /// The callback must not access this map.
+    template <class Callback> void ForEach(Callback callback) const
+    {
+        for (const Shard& shard : shards_)
+        {
+            MutexLock<SpinLockMutex> lock(shard.mutex_);
+            for (const auto& item : shard.map_)
+                callback(item.first, item.second);
+        }
+    }
+
+    /// Remove all elements.
+    void Clear()
+    {
+        for (Shard& shard : shards_)
+        {
+            MutexLock<SpinLockMutex> lock(shard.mutex_);
+            shard.map_.clear();
+        }
+    }
+
+    /// Return number of elements. Not an atomic snapshot if other threads modify the map.
+    unsigned Size() const
+    {
+        unsigned size = 0;
+        for (const Shard& shard : shards_)
+        {
+            MutexLock<SpinLockMutex> lock(shard.mutex_);
+            size += shard.map_.size();
+        }
+        return size;
+    }
+
+private:
+    /// Independently locked part of the map.
+    struct alignas(CONCURRENT_CACHE_LINE_SIZE) Shard
+    {
+        mutable SpinLockMutex mutex_;
+        ea::unordered_map<Key, Value, Hash> map_;
+    };
+
+    /// Return shard for key. Upper hash bits are used because lower ones also select the bucket inside the shard.
+    Shard& GetShard(const Key& key) { return shards_[ShardIndex(key)]; }
+    const Shard& GetShard(const Key& key) const { return shards_[ShardIndex(key)]; }
+    static unsigned ShardIndex(const Key& key)
+    {
+        const size_t hash = Hash{}(key);
+        const unsigned mixed = static_cast<unsigned>(hash ^ (hash >> 16)) * 0x9e3779b1u;
+        return (mixed >> 24) & (NumShards - 1);
+    }
+
+    /// Shards.
+    ea::array<Shard, NumShards> shards_;
+};
+
+}
@@ -0,0 +1,208 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#pragma once
+
+#include "../Core/NonCopyable.h"
+#include "../Math/MathDefs.h"
+
+#include <EASTL/unique_ptr.h>
+
+#include <atomic>
+#include <cstddef>
+
+namespace Urho3D
+{
+
+/// Size of cache line used to separate counters modified by different threads.
+static const unsigned CONCURRENT_CACHE_LINE_SIZE = 64;
+
+/// Bounded lock-free multi-producer multi-consumer queue. Capacity is rounded up to the next power of two.
+/// Push fails instead of blocking when the queue is full, Pop fails when it is empty.
+template <class T>
+class MPMCQueue : private NonCopyable
+{
+public:
+    /// Construct with capacity.
+    explicit MPMCQueue(unsigned capacity)
+        : capacity_(NextPowerOfTwo(Max(capacity, 2u)))
+        , mask_(capacity_ - 1)
+        , cells_(new Cell[capacity_])
+    {
+        for (unsigned i = 0; i < capacity_; ++i)
+            cells_[i].sequence_.store(i, std::memory_order_relaxed);
+    }
+
+    /// Try to push value. Return false if the queue is full, the value is left untouched in this case.
+    template <class U> bool Push(U&& value)
+    {
+        Cell* cell = nullptr;
+        unsigned pos = enqueuePos_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &cells_[pos & mask_];
+            const unsigned sequence = cell->sequence_.load(std::memory_order_acquire);
+            const int diff = static_cast<int>(sequence - pos);
+            if (diff == 0)
+            {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return false;
+            else
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+
+        cell->value_ = ea::forward<U>(value);
+        cell->sequence_.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Try to pop value. Return false if the queue is empty.
+    bool Pop(T& value)
+    {
+        Cell* cell = nullptr;
+        unsigned pos = dequeuePos_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &cells_[pos & mask_];
+            const unsigned sequence = cell->sequence_.load(std::memory_order_acquire);
+            const int diff = static_cast<int>(sequence - (pos + 1));
+            if (diff == 0)
+            {
+                if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return false;
+            else
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+        }
+
+        value = ea::move(cell->value_);
+        cell->value_ = T{};
+        cell->sequence_.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Return capacity.
+    unsigned GetCapacity() const { return capacity_; }
+    /// Return approximate number of elements. Exact only when no other thread modifies the queue.
+    unsigned GetSizeApprox() const
+    {
+        const unsigned enqueuePos = enqueuePos_.load(std::memory_order_relaxed);
+        const unsigned dequeuePos = dequeuePos_.load(std::memory_order_relaxed);
+        return Min(enqueuePos - dequeuePos, capacity_);
+    }
+
+private:
+    /// Queue cell. Sequence number tells whether the cell is ready for push or pop at given position.
+    struct Cell
+    {
+        std::atomic<unsigned> sequence_;
+        T value_{};
+    };
+
+    /// Capacity.
+    const unsigned capacity_;
+    /// Mask to convert position to cell index.
+    const unsigned mask_;
+    /// Cells.
+    ea::unique_ptr<Cell[]> cells_;
+    /// Position of next push.
+    alignas(CONCURRENT_CACHE_LINE_SIZE) std::atomic<unsigned> enqueuePos_{};
+    /// Position of next pop.
+    alignas(CONCURRENT_CACHE_LINE_SIZE) std::atomic<unsigned> dequeuePos_{};
+};
+
+/// Bounded lock-free single-producer single-consumer queue. Capacity is rounded up to the next power of two.
+/// Exactly one thread may push and exactly one (possibly different) thread may pop at a time.
+template <class T>
+class SPSCQueue : private NonCopyable
+{
+public:
+    /// Construct with capacity.
+    explicit SPSCQueue(unsigned capacity)
+        : capacity_(NextPowerOfTwo(Max(capacity, 2u)))
+        , mask_(capacity_ - 1)
+        , values_(new T[capacity_])
+    {
+    }
+
+    /// Try to push value. Return false if the queue is full, the value is left untouched in this case. Producer thread only.
+    template <class U> bool Push(U&& value)
+    {
+        const unsigned tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ == capacity_)
+        {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ == capacity_)
+                return false;
+        }
+
+        values_[tail & mask_] = ea::forward<U>(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Try to pop value. Return false if the queue is empty. Consumer thread only.
+    bool Pop(T& value)
+    {
+        const unsigned head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_)
+        {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_)
+                return false;
+        }
+
+        value = ea::move(values_[head & mask_]);
+        values_[head & mask_] = T{};
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Return capacity.
+    unsigned GetCapacity() const { return capacity_; }
+    /// Return approximate number of elements.
+    unsigned GetSizeApprox() const { return tail_.load(std::memory_order_relaxed) - head_.load(std::memory_order_relaxed); }
+
+private:
+    /// Capacity.
+    const unsigned capacity_;
+    /// Mask to convert position to element index.
+    const unsigned mask_;
+    /// Elements.
+    ea::unique_ptr<T[]> values_;
+    /// Position of next pop, written by consumer.
+    alignas(CONCURRENT_CACHE_LINE_SIZE) std::atomic<unsigned> head_{};
+    /// Last observed push position, consumer only.
+    unsigned cachedTail_{};
+    /// Position of next push, written by producer.
+    alignas(CONCURRENT_CACHE_LINE_SIZE) std::atomic<unsigned> tail_{};
+    /// Last observed pop position, producer only.
+    unsigned cachedHead_{};
+};
+
+}
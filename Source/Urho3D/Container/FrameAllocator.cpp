@@ -0,0 +1,130 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#include "../Precompiled.h"
+
+#include "../Container/FrameAllocator.h"
+
+#include <EASTL/algorithm.h>
+
+#include <atomic>
+#include <cstdlib>
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Default size of the first block.
+const size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+/// Index of the current frame.
+std::atomic<unsigned> currentFrameIndex{0};
+
+}
+
+FrameAllocator::FrameAllocator() :
+    frameIndex_(currentFrameIndex.load(std::memory_order_relaxed))
+{
+}
+
+FrameAllocator::~FrameAllocator()
+{
+    FreeBlocks();
+}
+
+void* FrameAllocator::Allocate(size_t size, size_t alignment)
+{
+    if (block_)
+    {
+        auto* data = reinterpret_cast<unsigned char*>(block_ + 1);
+        const uintptr_t address = reinterpret_cast<uintptr_t>(data) + offset_;
+        const size_t padding = (alignment - (address & (alignment - 1))) & (alignment - 1);
+        if (offset_ + padding + size <= block_->size_)
+        {
+            offset_ += padding + size;
+            used_ += padding + size;
+            return data + offset_ - size;
+        }
+    }
+
+    // Block headers are aligned for max_align_t, so larger alignments need extra space
+    AddBlock(size + (alignment > alignof(std::max_align_t) ? alignment : 0));
+    return Allocate(size, alignment);
+}
+
+void FrameAllocator::Reset()
+{
+    frameIndex_ = currentFrameIndex.load(std::memory_order_relaxed);
+
+    // Replace multiple blocks with a single one, so that a steady workload uses one contiguous block
+    if (block_ && block_->previous_)
+    {
+        const size_t totalSize = capacity_;
+        FreeBlocks();
+        AddBlock(totalSize);
+    }
+
+    offset_ = 0;
+    used_ = 0;
+}
+
+FrameAllocator& FrameAllocator::GetThreadInstance()
+{
+    thread_local FrameAllocator instance;
+    if (instance.frameIndex_ != currentFrameIndex.load(std::memory_order_relaxed))
+        instance.Reset();
+    return instance;
+}
+
+void FrameAllocator::EndFrame()
+{
+    currentFrameIndex.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FrameAllocator::AddBlock(size_t minSize)
+{
+    const size_t size = ea::max(minSize, block_ ? block_->size_ * 2 : DEFAULT_BLOCK_SIZE);
+    auto* block = static_cast<Block*>(malloc(sizeof(Block) + size));
+    block->previous_ = block_;
+    block->size_ = size;
+
+    block_ = block;
+    offset_ = 0;
+    capacity_ += size;
+}
+
+void FrameAllocator::FreeBlocks()
+{
+    while (block_)
+    {
+        Block* previous = block_->previous_;
+        free(block_);
+        block_ = previous;
+    }
+
+    capacity_ = 0;
+}
+
+}
@@ -0,0 +1,127 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#pragma once
+
+#include "../Core/NonCopyable.h"
+
+#include <Urho3D/Urho3D.h>
+
+#include <EASTL/vector.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Urho3D
+{
+
+/// Linear allocator for temporary memory that is valid until the end of the current frame. Each thread has its own
+/// instance, so allocation needs no locking. Deallocation is a no-op: all memory is reclaimed at once on the first
+/// allocation after the frame has ended. Must not be used for memory that may outlive the frame, e.g. in background tasks.
+class URHO3D_API FrameAllocator : private NonCopyable
+{
+public:
+    /// Construct.
+    FrameAllocator();
+    /// Destruct. Frees all blocks.
+    ~FrameAllocator();
+
+    /// Allocate memory. Alignment must be a power of two.
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    /// Reclaim all memory allocated so far. Blocks are merged into a single one large enough for the whole frame.
+    void Reset();
+
+    /// Return number of bytes allocated since the last reset.
+    size_t GetUsedSize() const { return used_; }
+    /// Return total size of the allocated blocks.
+    size_t GetCapacity() const { return capacity_; }
+
+    /// Return allocator of the calling thread. Resets it if the frame has ended since its last use.
+    static FrameAllocator& GetThreadInstance();
+    /// Mark the end of a frame. All frame allocators are reset on their next use. Called by Time::EndFrame().
+    static void EndFrame();
+
+private:
+    /// Memory block header. Block data follows.
+    struct Block
+    {
+        /// Previous block.
+        Block* previous_;
+        /// Size of the block data.
+        size_t size_;
+    };
+
+    /// Allocate a new block with at least the given data size and make it current.
+    void AddBlock(size_t minSize);
+    /// Free all blocks.
+    void FreeBlocks();
+
+    /// Current block.
+    Block* block_{};
+    /// Allocation offset in the current block.
+    size_t offset_{};
+    /// Bytes allocated since the last reset.
+    size_t used_{};
+    /// Total size of all blocks.
+    size_t capacity_{};
+    /// Frame index at the last reset.
+    unsigned frameIndex_{};
+};
+
+/// EASTL allocator that takes memory from the frame allocator of the calling thread.
+class FrameAllocatorAdapter
+{
+public:
+    /// Construct.
+    explicit FrameAllocatorAdapter(const char* = nullptr) {}
+    /// Construct from another adapter.
+    FrameAllocatorAdapter(const FrameAllocatorAdapter&, const char*) {}
+
+    /// Allocate memory.
+    void* allocate(size_t n, int = 0) { return FrameAllocator::GetThreadInstance().Allocate(n); }
+    /// Allocate aligned memory such that the address plus offset is aligned.
+    void* allocate(size_t n, size_t alignment, size_t offset, int = 0)
+    {
+        if (offset == 0)
+            return FrameAllocator::GetThreadInstance().Allocate(n, alignment);
+        auto base = reinterpret_cast<uintptr_t>(FrameAllocator::GetThreadInstance().Allocate(n + alignment, 1));
+        return reinterpret_cast<void*>(((base + offset + alignment - 1) & ~(uintptr_t)(alignment - 1)) - offset);
+    }
+    /// Deallocate memory. Does nothing, memory is reclaimed at the end of the frame.
+    void deallocate(void*, size_t) {}
+
+    /// Return allocator name.
+    const char* get_name() const { return "FrameAllocator"; }
+    /// Set allocator name. Ignored.
+    void set_name(const char*) {}
+};
+
+/// Frame allocator adapters are interchangeable.
+inline bool operator ==(const FrameAllocatorAdapter&, const FrameAllocatorAdapter&) { return true; }
+/// Frame allocator adapters are interchangeable.
+inline bool operator !=(const FrameAllocatorAdapter&, const FrameAllocatorAdapter&) { return false; }
+
+/// Vector for temporary data that lives no longer than the current frame.
+template <class T> using FrameVector = ea::vector<T, FrameAllocatorAdapter>;
+
+}
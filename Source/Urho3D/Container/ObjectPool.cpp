@@ -0,0 +1,128 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Container/ObjectPool.h"
+
+#include <EASTL/algorithm.h>
+
+#include <new>
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Registry of all object pools for statistics.
+struct ObjectPoolRegistry
+{
+    /// Registered pools.
+    ea::vector<ObjectPool*> pools_;
+    /// Registry lock.
+    SpinLockMutex mutex_;
+};
+
+ObjectPoolRegistry& GetObjectPoolRegistry()
+{
+    static ObjectPoolRegistry registry;
+    return registry;
+}
+
+}
+
+ObjectPool::ObjectPool(const char* name, unsigned objectSize, unsigned initialCapacity) :
+    name_(name),
+    objectSize_(objectSize),
+    initialCapacity_(ea::max(initialCapacity, 1u))
+{
+    ObjectPoolRegistry& registry = GetObjectPoolRegistry();
+    MutexLock<SpinLockMutex> lock(registry.mutex_);
+    registry.pools_.push_back(this);
+}
+
+ObjectPool::~ObjectPool()
+{
+    {
+        ObjectPoolRegistry& registry = GetObjectPoolRegistry();
+        MutexLock<SpinLockMutex> lock(registry.mutex_);
+        registry.pools_.erase_first(this);
+    }
+
+    // Objects outliving static destruction still point into the blocks, so leave them to the OS in that case
+    if (!used_)
+        AllocatorUninitialize(allocator_);
+}
+
+void* ObjectPool::Allocate(size_t size)
+{
+    if (size != objectSize_)
+        return ::operator new(size);
+
+    MutexLock<SpinLockMutex> lock(mutex_);
+    if (!allocator_)
+        allocator_ = AllocatorInitialize(objectSize_, initialCapacity_);
+    ++used_;
+    return AllocatorReserve(allocator_);
+}
+
+void ObjectPool::Free(void* ptr, size_t size)
+{
+    if (!ptr)
+        return;
+
+    if (size != objectSize_)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+
+    MutexLock<SpinLockMutex> lock(mutex_);
+    AllocatorFree(allocator_, ptr);
+    --used_;
+}
+
+ObjectPoolStats ObjectPool::GetStats() const
+{
+    MutexLock<SpinLockMutex> lock(mutex_);
+    ObjectPoolStats stats;
+    stats.name_ = name_;
+    stats.objectSize_ = objectSize_;
+    stats.capacity_ = allocator_ ? allocator_->capacity_ : 0;
+    stats.used_ = used_;
+    return stats;
+}
+
+ea::vector<ObjectPoolStats> ObjectPool::GetAllStats()
+{
+    ObjectPoolRegistry& registry = GetObjectPoolRegistry();
+    MutexLock<SpinLockMutex> lock(registry.mutex_);
+
+    ea::vector<ObjectPoolStats> stats;
+    stats.reserve(registry.pools_.size());
+    for (ObjectPool* pool : registry.pools_)
+        stats.push_back(pool->GetStats());
+    return stats;
+}
+
+}
@@ -0,0 +1,109 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Container/Allocator.h"
+#include "../Core/Mutex.h"
+
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+/// Occupancy statistics of an object pool.
+struct ObjectPoolStats
+{
+    /// Name of the pooled type.
+    const char* name_{};
+    /// Size of one pooled object in bytes.
+    unsigned objectSize_{};
+    /// Number of objects that fit into the currently allocated blocks.
+    unsigned capacity_{};
+    /// Number of objects currently allocated from the pool.
+    unsigned used_{};
+};
+
+/// Thread-safe fixed-size memory pool backing the class-level allocation of pooled object types. Requests of any other
+/// size, e.g. from a derived class that is not pooled itself, fall back to the global heap.
+class URHO3D_API ObjectPool : private NonCopyable
+{
+public:
+    /// Construct and register for statistics.
+    ObjectPool(const char* name, unsigned objectSize, unsigned initialCapacity);
+    /// Destruct. Memory is released only if no pooled objects are alive anymore.
+    ~ObjectPool();
+
+    /// Allocate memory for an object.
+    void* Allocate(size_t size);
+    /// Free memory of an object. Size must match the one passed to Allocate().
+    void Free(void* ptr, size_t size);
+
+    /// Return occupancy statistics.
+    ObjectPoolStats GetStats() const;
+    /// Return occupancy statistics of all object pools.
+    static ea::vector<ObjectPoolStats> GetAllStats();
+
+private:
+    /// Name of the pooled type.
+    const char* name_;
+    /// Size of one pooled object.
+    unsigned objectSize_;
+    /// Initial block capacity.
+    unsigned initialCapacity_;
+    /// Underlying fixed-size allocator. Created on first use.
+    AllocatorBlock* allocator_{};
+    /// Number of objects currently allocated.
+    unsigned used_{};
+    /// Allocation lock.
+    mutable SpinLockMutex mutex_;
+};
+
+}
+
+#if defined(_MSC_VER) && defined(_DEBUG)
+#   define URHO3D_POOLED_OBJECT_DEBUG_NEW() \
+        static void* operator new(size_t size, int, const char*, int) { return operator new(size); }
+#else
+#   define URHO3D_POOLED_OBJECT_DEBUG_NEW()
+#endif
+
+/// Declare class-level allocation of an object type from its own ObjectPool. Place inside the class declaration and
+/// pair with URHO3D_IMPLEMENT_POOLED_OBJECT() in the implementation file. Objects are still deleted through the usual
+/// RefCounted path, which returns their memory to the pool.
+#define URHO3D_POOLED_OBJECT() \
+    public: \
+        static void* operator new(size_t size) { return GetObjectPool().Allocate(size); } \
+        static void operator delete(void* ptr, size_t size) { GetObjectPool().Free(ptr, size); } \
+        static void* operator new(size_t, void* place) noexcept { return place; } \
+        static void operator delete(void*, void*) noexcept { } \
+        URHO3D_POOLED_OBJECT_DEBUG_NEW() \
+        /* Return the object pool of this type. */ \
+        static Urho3D::ObjectPool& GetObjectPool()
+
+/// Implement class-level allocation declared with URHO3D_POOLED_OBJECT().
+#define URHO3D_IMPLEMENT_POOLED_OBJECT(typeName, initialCapacity) \
+    Urho3D::ObjectPool& typeName::GetObjectPool() \
+    { \
+        static Urho3D::ObjectPool pool(#typeName, sizeof(typeName), initialCapacity); \
+        return pool; \
+    }
@@ -71,6 +71,13 @@ public:
         AddRef();
     }
 
+    /// Move-construct from another shared pointer allowing implicit upcasting.
+    template <class U> SharedPtr(SharedPtr<U>&& rhs) noexcept :    // NOLINT(google-explicit-constructor)
+        ptr_(rhs.ptr_)
+    {
+        rhs.ptr_ = nullptr;
+    }
+
     /// Construct from a raw pointer.
     explicit SharedPtr(T* ptr) noexcept :
         ptr_(ptr)
@@ -117,6 +124,15 @@ public:
         return *this;
     }
 
+    /// Move-assign from another shared pointer allowing implicit upcasting.
+    template <class U> SharedPtr<T>& operator =(SharedPtr<U>&& rhs)
+    {
+        SharedPtr<T> copy(std::move(rhs));
+        Swap(copy);
+
+        return *this;
+    }
+
     /// Assign from a raw pointer.
     SharedPtr<T>& operator =(T* ptr)
     {
@@ -228,7 +244,12 @@ private:
     void AddRef()
     {
         if (ptr_)
-            ptr_->AddRef();
+        {
+            if constexpr (IsSingleThreadedRefCounted<T>::value)
+                ptr_->AddRefSingleThreaded();
+            else
+                ptr_->AddRef();
+        }
     }
 
     /// Release the object reference and delete it if necessary.
@@ -236,7 +257,10 @@ private:
     {
         if (ptr_)
         {
-            ptr_->ReleaseRef();
+            if constexpr (IsSingleThreadedRefCounted<T>::value)
+                ptr_->ReleaseRefSingleThreaded();
+            else
+                ptr_->ReleaseRef();
             ptr_ = nullptr;
         }
     }
@@ -87,7 +87,16 @@ RefCounted::~RefCounted()
 
 int RefCounted::AddRef()
 {
-    int refs = ea::Internal::atomic_increment(&refCount_->refs_);
+    return OnRefAdded(ea::Internal::atomic_increment(&refCount_->refs_));
+}
+
+int RefCounted::AddRefSingleThreaded()
+{
+    return OnRefAdded(++refCount_->refs_);
+}
+
+int RefCounted::OnRefAdded(int refs)
+{
     assert(refs > 0);
 #if URHO3D_CSHARP
     if (URHO3D_UNLIKELY(scriptObject_ && !isScriptStrongRef_))
@@ -105,7 +114,16 @@ int RefCounted::AddRef()
 
 int RefCounted::ReleaseRef()
 {
-    int refs = ea::Internal::atomic_decrement(&refCount_->refs_);
+    return OnRefReleased(ea::Internal::atomic_decrement(&refCount_->refs_));
+}
+
+int RefCounted::ReleaseRefSingleThreaded()
+{
+    return OnRefReleased(--refCount_->refs_);
+}
+
+int RefCounted::OnRefReleased(int refs)
+{
     assert(refs >= 0);
 #if URHO3D_CSHARP
     if (refs == 0)
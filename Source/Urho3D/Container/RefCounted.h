@@ -23,6 +23,7 @@
 #pragma once
 
 #include <EASTL/allocator.h>
+#include <EASTL/type_traits.h>
 
 #include <Urho3D/Urho3D.h>
 
@@ -58,6 +59,20 @@ public:
     int weakRefs_ = 0;
 };
 
+/// Mark class as referenced from the main thread only. SharedPtr of this class and its subclasses updates
+/// reference counts with plain arithmetic instead of atomic instructions. Not applied in C# builds, where managed
+/// finalizers may release references from another thread.
+#if URHO3D_CSHARP
+#define URHO3D_SINGLE_THREADED_REFCOUNT() static constexpr bool SingleThreadedRefCount = false
+#else
+#define URHO3D_SINGLE_THREADED_REFCOUNT() static constexpr bool SingleThreadedRefCount = true
+#endif
+
+/// Return whether class is marked with URHO3D_SINGLE_THREADED_REFCOUNT.
+template <class T, class = void> struct IsSingleThreadedRefCounted : ea::false_type {};
+template <class T> struct IsSingleThreadedRefCounted<T, ea::void_t<decltype(T::SingleThreadedRefCount)>>
+    : ea::bool_constant<T::SingleThreadedRefCount> {};
+
 /// Base class for intrusively reference-counted objects. These are noncopyable and non-assignable.
 class URHO3D_API RefCounted
 {
@@ -78,6 +93,12 @@ public:
     /// Decrement reference count and delete self if no more references. Can also be called outside of a SharedPtr for traditional reference counting. Returns new reference count value. Operation is atomic.
     /// @manualbind
     int ReleaseRef();
+    /// Increment reference count without atomic instruction. For objects that are only referenced from one thread.
+    /// @nobind
+    int AddRefSingleThreaded();
+    /// Decrement reference count without atomic instruction and delete self if no more references. For objects that are only referenced from one thread.
+    /// @nobind
+    int ReleaseRefSingleThreaded();
     /// Return reference count.
     /// @property
     int Refs() const;
@@ -102,6 +123,11 @@ protected:
     void ResetScriptObject();
 #endif
 private:
+    /// Handle incremented reference count.
+    int OnRefAdded(int refs);
+    /// Handle decremented reference count. Delete self if no more references.
+    int OnRefReleased(int refs);
+
     /// Pointer to the reference count structure.
     RefCount* refCount_ = nullptr;
 #if URHO3D_CSHARP
@@ -0,0 +1,205 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/AllocationStats.h"
+#include "../Core/Profiler.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Counters updated by global allocation functions. Plain atomics are constant-initialized, so they are safe to use
+/// from allocations made during static initialization.
+std::atomic<unsigned long long> totalAllocations{};
+std::atomic<unsigned long long> totalDeallocations{};
+std::atomic<unsigned long long> totalAllocatedBytes{};
+
+/// Total counters at the end of the previous frame.
+AllocationStats previousFrameEnd;
+/// Counters of the last completed frame.
+AllocationStats lastFrameStats;
+
+}
+
+#if URHO3D_PROFILING_MEMORY
+static void TrackAllocation(void* ptr, size_t size)
+{
+    totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    totalAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    TracySecureAlloc(ptr, size);
+}
+
+static void TrackDeallocation(void* ptr)
+{
+    totalDeallocations.fetch_add(1, std::memory_order_relaxed);
+    TracySecureFree(ptr);
+}
+
+static void* AllocateTracked(size_t size)
+{
+    void* ptr = malloc(size ? size : 1);
+    if (ptr)
+        TrackAllocation(ptr, size);
+    return ptr;
+}
+
+static void* AllocateTrackedAligned(size_t size, size_t alignment)
+{
+    if (!size)
+        size = 1;
+#ifdef _WIN32
+    void* ptr = _aligned_malloc(size, alignment);
+#else
+    // aligned_alloc requires size to be multiple of alignment
+    void* ptr = aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+#endif
+    if (ptr)
+        TrackAllocation(ptr, size);
+    return ptr;
+}
+
+static void DeallocateTracked(void* ptr)
+{
+    if (!ptr)
+        return;
+    TrackDeallocation(ptr);
+    free(ptr);
+}
+
+static void DeallocateTrackedAligned(void* ptr)
+{
+    if (!ptr)
+        return;
+    TrackDeallocation(ptr);
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+#endif
+
+bool IsAllocationTrackingEnabled()
+{
+#if URHO3D_PROFILING_MEMORY
+    return true;
+#else
+    return false;
+#endif
+}
+
+AllocationStats GetTotalAllocationStats()
+{
+    AllocationStats stats;
+    stats.numAllocations_ = totalAllocations.load(std::memory_order_relaxed);
+    stats.numDeallocations_ = totalDeallocations.load(std::memory_order_relaxed);
+    stats.allocatedBytes_ = totalAllocatedBytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+AllocationStats GetFrameAllocationStats()
+{
+    return lastFrameStats;
+}
+
+void EndAllocationStatsFrame()
+{
+    if (!IsAllocationTrackingEnabled())
+        return;
+
+    const AllocationStats total = GetTotalAllocationStats();
+    lastFrameStats.numAllocations_ = total.numAllocations_ - previousFrameEnd.numAllocations_;
+    lastFrameStats.numDeallocations_ = total.numDeallocations_ - previousFrameEnd.numDeallocations_;
+    lastFrameStats.allocatedBytes_ = total.allocatedBytes_ - previousFrameEnd.allocatedBytes_;
+    previousFrameEnd = total;
+
+    URHO3D_PROFILE_VALUE("Allocations per frame", static_cast<int64_t>(lastFrameStats.numAllocations_));
+    URHO3D_PROFILE_VALUE("Allocated bytes per frame", static_cast<int64_t>(lastFrameStats.allocatedBytes_));
+}
+
+}
+
+#if URHO3D_PROFILING_MEMORY
+// Replace global allocation functions. EASTL containers allocate through global operator new[] as well, so they are
+// covered too. Note that on Windows the replacement only affects allocations made by the engine module itself.
+void* operator new(size_t size)
+{
+    if (void* ptr = Urho3D::AllocateTracked(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    if (void* ptr = Urho3D::AllocateTracked(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return Urho3D::AllocateTracked(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return Urho3D::AllocateTracked(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    if (void* ptr = Urho3D::AllocateTrackedAligned(size, static_cast<size_t>(alignment)))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    if (void* ptr = Urho3D::AllocateTrackedAligned(size, static_cast<size_t>(alignment)))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { Urho3D::DeallocateTracked(ptr); }
+void operator delete[](void* ptr) noexcept { Urho3D::DeallocateTracked(ptr); }
+void operator delete(void* ptr, size_t) noexcept { Urho3D::DeallocateTracked(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { Urho3D::DeallocateTracked(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { Urho3D::DeallocateTracked(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { Urho3D::DeallocateTracked(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { Urho3D::DeallocateTrackedAligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { Urho3D::DeallocateTrackedAligned(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { Urho3D::DeallocateTrackedAligned(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { Urho3D::DeallocateTrackedAligned(ptr); }
+#endif
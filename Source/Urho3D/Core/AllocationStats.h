@@ -0,0 +1,51 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#pragma once
+
+#include "../Urho3D.h"
+
+namespace Urho3D
+{
+
+/// Memory allocation counters.
+struct AllocationStats
+{
+    /// Number of allocations.
+    unsigned long long numAllocations_{};
+    /// Number of deallocations.
+    unsigned long long numDeallocations_{};
+    /// Total size of allocations in bytes.
+    unsigned long long allocatedBytes_{};
+};
+
+/// Return whether global allocations are tracked. Requires URHO3D_PROFILING_MEMORY build option.
+URHO3D_API bool IsAllocationTrackingEnabled();
+/// Return allocation counters since application start.
+URHO3D_API AllocationStats GetTotalAllocationStats();
+/// Return allocation counters of the last completed frame.
+URHO3D_API AllocationStats GetFrameAllocationStats();
+/// Complete allocation counters of the current frame and plot them in the profiler. Called by Engine.
+URHO3D_API void EndAllocationStatsFrame();
+
+}
@@ -68,6 +68,10 @@ public:
     virtual void Get(const Serializable* ptr, Variant& dest) const = 0;
     /// Set the attribute.
     virtual void Set(Serializable* ptr, const Variant& src) = 0;
+    /// Return address of the attribute value if it is stored in a member variable of the attribute's exact native type, null otherwise. Allows reading fixed-size values without Variant boxing.
+    virtual const void* GetValuePtr(const Serializable* ptr) const { return nullptr; }
+    /// Return address of the attribute value if it may also be written directly, i.e. there is no post-set callback, null otherwise.
+    virtual void* GetMutableValuePtr(Serializable* ptr) const { return nullptr; }
 };
 
 /// Description of an automatically serializable variable.
@@ -74,6 +74,9 @@ static void HandleIKLog(const char* msg)
 // Global context instance. Set in Context constructor.
 static Context* contextInstance = nullptr;
 
+/// Approximate number of object types registered by the engine, used to presize lookup tables.
+static const unsigned NUM_EXPECTED_OBJECT_TYPES = 512;
+
 void EventReceiverGroup::BeginSendEvent()
 {
     ++inSend_;
@@ -153,6 +156,10 @@ Context::Context() :
 
     // Set the main thread ID (assuming the Context is created in it)
     Thread::SetMainThread();
+
+    // Avoid rehashing while the engine registers its object factories and attributes on startup
+    factories_.reserve(NUM_EXPECTED_OBJECT_TYPES);
+    attributes_.reserve(NUM_EXPECTED_OBJECT_TYPES);
 }
 
 Context::~Context()
@@ -205,15 +212,16 @@ void Context::RegisterFactory(ObjectFactory* factory)
     if (!factory)
         return;
 
-    auto it = factories_.find(factory->GetType());
-    if (it != factories_.end())
+    // Look up the slot only once, it is filled below if the type is not registered yet
+    SharedPtr<ObjectFactory>& slot = factories_[factory->GetType()];
+    if (slot)
     {
         URHO3D_LOGERRORF("Failed to register '%s' because type '%s' is already registered with same type hash.",
-            factory->GetTypeName().c_str(), it->second->GetTypeName().c_str());
+            factory->GetTypeName().c_str(), slot->GetTypeName().c_str());
         assert(false);
         return;
     }
-    factories_[factory->GetType()] = factory;
+    slot = factory;
 }
 
 void Context::RegisterFactory(ObjectFactory* factory, const char* category)
@@ -330,6 +330,15 @@ void Object::SendEvent(StringHash eventType, VariantMap& eventData)
     if (blockEvents_)
         return;
 
+    Context* context = context_;
+
+    // Early out without touching the sender stack or profiler when there are no receivers at all
+    EventReceiverGroup* specificReceivers = context->GetEventReceivers(this, eventType);
+    EventReceiverGroup* nonSpecificReceivers = context->GetEventReceivers(eventType);
+    if ((!specificReceivers || specificReceivers->receivers_.empty()) &&
+        (!nonSpecificReceivers || nonSpecificReceivers->receivers_.empty()))
+        return;
+
 #if URHO3D_PROFILING
     URHO3D_PROFILE_C("SendEvent", PROFILER_COLOR_EVENTS);
     const auto& eventName = GetEventNameRegister().GetString(eventType);
@@ -338,13 +347,12 @@ void Object::SendEvent(StringHash eventType, VariantMap& eventData)
 
     // Make a weak pointer to self to check for destruction during event handling
     WeakPtr<Object> self(this);
-    Context* context = context_;
 
     context->BeginSendEvent(this, eventType);
 
     // Check first the specific event receivers
     // Note: group is held alive with a shared ptr, as it may get destroyed along with the sender
-    SharedPtr<EventReceiverGroup> group(context->GetEventReceivers(this, eventType));
+    SharedPtr<EventReceiverGroup> group(specificReceivers);
     if (group)
     {
         group->BeginSendEvent();
@@ -372,6 +380,7 @@ void Object::SendEvent(StringHash eventType, VariantMap& eventData)
     }
 
     // Then the non-specific receivers
+    // Note: look up again, as handlers may have added the first receiver of this event type
     SharedPtr<EventReceiverGroup> groupNonSpec(context->GetEventReceivers(eventType));
     if (groupNonSpec)
     {
@@ -401,6 +410,23 @@ void Object::SendEvent(StringHash eventType, VariantMap& eventData)
     context->EndSendEvent();
 }
 
+bool Object::HasEventReceivers(StringHash eventType) const
+{
+    // Let SendEvent() report the error when called from a worker thread
+    if (!Thread::IsMainThread())
+        return true;
+
+    if (blockEvents_)
+        return false;
+
+    auto* self = const_cast<Object*>(this);
+    EventReceiverGroup* group = context_->GetEventReceivers(self, eventType);
+    if (group && !group->receivers_.empty())
+        return true;
+    group = context_->GetEventReceivers(eventType);
+    return group && !group->receivers_.empty();
+}
+
 VariantMap& Object::GetEventDataMap() const
 {
     return context_->GetEventDataMap();
@@ -161,8 +161,13 @@ public:
     /// Send event with variadic parameter pairs to all subscribers. The parameter pairs is a list of paramID and paramValue separated by comma, one pair after another.
     template <typename... Args> void SendEvent(StringHash eventType, Args... args)
     {
+        // Skip populating the event data map when nobody would receive the event
+        if (!HasEventReceivers(eventType))
+            return;
         SendEvent(eventType, GetEventDataMap().populate(args...));
     }
+    /// Return whether sending an event from this object would reach any receiver. Use to skip building event data for events nobody listens to. Always true outside the main thread.
+    bool HasEventReceivers(StringHash eventType) const;
 
     /// Return execution context.
     Context* GetContext() const { return context_; }
@@ -415,9 +420,18 @@ inline void Object::SubscribeToEvent(Object* sender, StringHash eventType, void(
 URHO3D_API StringHashRegister& GetEventNameRegister();
 
 /// Describe an event's hash ID and begin a namespace in which to define its parameters.
+/// Event names are registered for reverse lookup only when profiling or when debugging hashes, otherwise the hashes are compile-time constants.
+#if URHO3D_PROFILING || defined(URHO3D_HASH_DEBUG)
 #define URHO3D_EVENT(eventID, eventName) static const Urho3D::StringHash eventID(Urho3D::GetEventNameRegister().RegisterString(#eventName)); namespace eventName
+#else
+#define URHO3D_EVENT(eventID, eventName) static constexpr Urho3D::StringHash eventID{#eventName}; namespace eventName
+#endif
 /// Describe an event's parameter hash ID. Should be used inside an event namespace.
+#ifndef URHO3D_HASH_DEBUG
+#define URHO3D_PARAM(paramID, paramName) static constexpr Urho3D::StringHash paramID{#paramName}
+#else
 #define URHO3D_PARAM(paramID, paramName) static const Urho3D::StringHash paramID = #paramName
+#endif
 /// Convenience macro to construct an EventHandler that points to a receiver object and its member function.
 #define URHO3D_HANDLER(className, function) (new Urho3D::EventHandlerImpl<className>(this, &className::function))
 /// Convenience macro to construct an EventHandler that points to a receiver object and its member function, and also defines a userdata pointer.
@@ -73,6 +73,9 @@ extern "C" unsigned SDL_TVOS_GetActiveProcessorCount();
 #ifndef _WIN32
 #include <unistd.h>
 #endif
+#ifdef __linux__
+#include <sched.h>
+#endif
 
 #if defined(__EMSCRIPTEN__) && defined(__EMSCRIPTEN_PTHREADS__)
 #include <emscripten/threading.h>
@@ -528,6 +531,78 @@ unsigned GetNumLogicalCPUs()
 #endif
 }
 
+static CPUFeatureFlags DetectCPUFeatures()
+{
+    CPUFeatureFlags features;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    features |= CPU_NEON;
+#elif !defined(__linux__) && !defined(__EMSCRIPTEN__) && !defined(UWP) && !defined(IOS) && !defined(TVOS)
+    struct cpu_id_t data;
+    if (cpu_identify(nullptr, &data) >= 0)
+    {
+        if (data.flags[::CPU_FEATURE_SSE2])
+            features |= CPU_SSE2;
+        if (data.flags[::CPU_FEATURE_SSE4_1])
+            features |= CPU_SSE41;
+        if (data.flags[::CPU_FEATURE_AVX])
+            features |= CPU_AVX;
+        if (data.flags[::CPU_FEATURE_AVX2])
+            features |= CPU_AVX2;
+        if (data.flags[::CPU_FEATURE_FMA3])
+            features |= CPU_FMA3;
+        if (data.flags[::CPU_FEATURE_AVX512F])
+            features |= CPU_AVX512F;
+    }
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__i386__) || defined(__x86_64__))
+    // LibCpuId is not built on Linux, the compiler builtins also check OS support for the extended registers
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2"))
+        features |= CPU_SSE2;
+    if (__builtin_cpu_supports("sse4.1"))
+        features |= CPU_SSE41;
+    if (__builtin_cpu_supports("avx"))
+        features |= CPU_AVX;
+    if (__builtin_cpu_supports("avx2"))
+        features |= CPU_AVX2;
+    if (__builtin_cpu_supports("fma"))
+        features |= CPU_FMA3;
+    if (__builtin_cpu_supports("avx512f"))
+        features |= CPU_AVX512F;
+#endif
+    return features;
+}
+
+CPUFeatureFlags GetCPUFeatures()
+{
+    static const CPUFeatureFlags features = DetectCPUFeatures();
+    return features;
+}
+
+ea::string GetCPUFeaturesString()
+{
+    static const ea::pair<CPUFeature, const char*> names[] = {
+        {CPU_SSE2, "SSE2"},
+        {CPU_SSE41, "SSE4.1"},
+        {CPU_AVX, "AVX"},
+        {CPU_AVX2, "AVX2"},
+        {CPU_FMA3, "FMA3"},
+        {CPU_AVX512F, "AVX512F"},
+        {CPU_NEON, "NEON"},
+    };
+
+    const CPUFeatureFlags features = GetCPUFeatures();
+    ea::string result;
+    for (const auto& item : names)
+    {
+        if (!features.Test(item.first))
+            continue;
+        if (!result.empty())
+            result += ' ';
+        result += item.second;
+    }
+    return result.empty() ? ea::string("none") : result;
+}
+
 void SetMiniDumpDir(const ea::string& pathName)
 {
     miniDumpDir = AddTrailingSlash(pathName);
@@ -840,4 +915,25 @@ URHO3D_API unsigned GetCurrentProcessID()
 #endif
 }
 
+URHO3D_API bool SetCurrentThreadAffinity(unsigned long long cpuMask)
+{
+    if (!cpuMask)
+        return false;
+
+#if defined(_WIN32) && !defined(UWP)
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)cpuMask) != 0;
+#elif defined(__linux__)
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (unsigned i = 0; i < 64 && i < CPU_SETSIZE; ++i)
+    {
+        if (cpuMask & (1ULL << i))
+            CPU_SET(i, &cpuSet);
+    }
+    return sched_setaffinity(0, sizeof(cpuSet), &cpuSet) == 0;
+#else
+    return false;
+#endif
+}
+
 }
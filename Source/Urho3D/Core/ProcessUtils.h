@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "../Container/FlagSet.h"
 #include "../Container/Str.h"
 
 #include <cstdlib>
@@ -31,6 +32,20 @@ namespace Urho3D
 
 class Mutex;
 
+/// CPU instruction set extensions detected at runtime.
+enum CPUFeature : unsigned
+{
+    CPU_NONE = 0x0,
+    CPU_SSE2 = 0x1,
+    CPU_SSE41 = 0x2,
+    CPU_AVX = 0x4,
+    CPU_AVX2 = 0x8,
+    CPU_FMA3 = 0x10,
+    CPU_AVX512F = 0x20,
+    CPU_NEON = 0x40,
+};
+URHO3D_FLAGSET(CPUFeature, CPUFeatureFlags);
+
 #if _WIN32
 static const char* DYN_LIB_SUFFIX = ".dll";
 #elif __APPLE__
@@ -75,6 +90,10 @@ URHO3D_API ea::string GetPlatform();
 URHO3D_API unsigned GetNumPhysicalCPUs();
 /// Return the number of logical CPUs (different from physical if hyperthreading is used).
 URHO3D_API unsigned GetNumLogicalCPUs();
+/// Return instruction set extensions supported by the CPU and the OS. Detected once and cached.
+URHO3D_API CPUFeatureFlags GetCPUFeatures();
+/// Return supported instruction set extensions as a human-readable string, e.g. "SSE2 SSE4.1 AVX AVX2 FMA3".
+URHO3D_API ea::string GetCPUFeaturesString();
 /// Set minidump write location as an absolute path. If empty, uses default (UserProfile/AppData/Roaming/urho3D/crashdumps) Minidumps are only supported on MSVC compiler.
 URHO3D_API void SetMiniDumpDir(const ea::string& pathName);
 /// Return minidump write location.
@@ -91,5 +110,7 @@ URHO3D_API ea::string GetOSVersion();
 URHO3D_API ea::string GenerateUUID();
 /// Return current process ID.
 URHO3D_API unsigned GetCurrentProcessID();
+/// Restrict the calling thread to the logical CPUs set in the bitmask. Return true on success. Supported on Windows and Linux.
+URHO3D_API bool SetCurrentThreadAffinity(unsigned long long cpuMask);
 
 }
@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Container/FrameAllocator.h"
 #include "../Core/Spline.h"
 #include "../IO/Log.h"
 
@@ -73,22 +74,21 @@ Variant Spline::GetPoint(float f) const
         return LinearInterpolation(knots_, f);
     case CATMULL_ROM_FULL_CURVE:
         {
-            /// \todo Do not allocate a new vector each time
-            ea::vector<Variant> fullKnots;
+            FrameVector<Variant> fullKnots;
             if (knots_.size() > 1)
             {
                 // Non-cyclic case: duplicate start and end
                 if (knots_.front() != knots_.back())
                 {
                     fullKnots.push_back(knots_.front());
-                    fullKnots.push_back(knots_);
+                    fullKnots.insert(fullKnots.end(), knots_.begin(), knots_.end());
                     fullKnots.push_back(knots_.back());
                 }
                 // Cyclic case: smooth the tangents
                 else
                 {
                     fullKnots.push_back(knots_[knots_.size() - 2]);
-                    fullKnots.push_back(knots_);
+                    fullKnots.insert(fullKnots.end(), knots_.begin(), knots_.end());
                     fullKnots.push_back(knots_[1]);
                 }
             }
@@ -140,45 +140,37 @@ void Spline::AddKnot(const Variant& knot, unsigned index)
             knots_[0].GetTypeName().c_str());
 }
 
-Variant Spline::BezierInterpolation(const ea::vector<Variant>& knots, float t) const
+Variant Spline::BezierInterpolation(ea::span<const Variant> knots, float t) const
 {
-    if (knots.size() == 2)
+    if (knots.size() < 2)
+        return Variant::EMPTY;
+
+    switch (knots[0].GetType())
     {
-        switch (knots[0].GetType())
-        {
-        case VAR_FLOAT:
-        case VAR_VECTOR2:
-        case VAR_VECTOR3:
-        case VAR_VECTOR4:
-        case VAR_COLOR:
-        case VAR_DOUBLE:
-            return LinearInterpolation(knots[0], knots[1], t);
-        default:
-            return Variant::EMPTY;
-        }
+    case VAR_FLOAT:
+    case VAR_VECTOR2:
+    case VAR_VECTOR3:
+    case VAR_VECTOR4:
+    case VAR_COLOR:
+    case VAR_DOUBLE:
+        break;
+    default:
+        return Variant::EMPTY;
     }
-    else
+
+    if (knots.size() == 2)
+        return LinearInterpolation(knots[0], knots[1], t);
+
+    // De Casteljau reduction in place, one level per pass
+    FrameVector<Variant> interpolatedKnots(knots.size() - 1);
+    for (unsigned i = 0; i < interpolatedKnots.size(); ++i)
+        interpolatedKnots[i] = LinearInterpolation(knots[i], knots[i + 1], t);
+    for (unsigned count = interpolatedKnots.size(); count > 2; --count)
     {
-        /// \todo Do not allocate a new vector each time
-        ea::vector<Variant> interpolatedKnots;
-        for (unsigned i = 1; i < knots.size(); i++)
-        {
-            switch (knots[0].GetType())
-            {
-            case VAR_FLOAT:
-            case VAR_VECTOR2:
-            case VAR_VECTOR3:
-            case VAR_VECTOR4:
-            case VAR_COLOR:
-            case VAR_DOUBLE:
-                interpolatedKnots.push_back(LinearInterpolation(knots[i - 1], knots[i], t));
-                break;
-            default:
-                return Variant::EMPTY;
-            }
-        }
-        return BezierInterpolation(interpolatedKnots, t);
+        for (unsigned i = 0; i < count - 1; ++i)
+            interpolatedKnots[i] = LinearInterpolation(interpolatedKnots[i], interpolatedKnots[i + 1], t);
     }
+    return LinearInterpolation(interpolatedKnots[0], interpolatedKnots[1], t);
 }
 
 template <typename T> Variant CalculateCatmullRom(const T& p0, const T& p1, const T& p2, const T& p3, float t, float t2, float t3)
@@ -188,7 +180,7 @@ template <typename T> Variant CalculateCatmullRom(const T& p0, const T& p1, cons
         (-p0 + 3.0f * p1 - 3.0f * p2 + p3) * t3));
 }
 
-Variant Spline::CatmullRomInterpolation(const ea::vector<Variant>& knots, float t) const
+Variant Spline::CatmullRomInterpolation(ea::span<const Variant> knots, float t) const
 {
     if (knots.size() < 4)
         return Variant::EMPTY;
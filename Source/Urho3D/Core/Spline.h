@@ -30,6 +30,8 @@
 #include "../Math/Vector3.h"
 #include "../Math/Vector4.h"
 
+#include <EASTL/span.h>
+
 namespace Urho3D
 {
 
@@ -112,9 +114,9 @@ public:
 
 private:
     /// Perform Bezier interpolation on the spline.
-    Variant BezierInterpolation(const ea::vector<Variant>& knots, float t) const;
+    Variant BezierInterpolation(ea::span<const Variant> knots, float t) const;
     /// Perform Spline interpolation on the spline.
-    Variant CatmullRomInterpolation(const ea::vector<Variant>& knots, float t) const;
+    Variant CatmullRomInterpolation(ea::span<const Variant> knots, float t) const;
     /// Perform linear interpolation on the spline.
     Variant LinearInterpolation(const ea::vector<Variant>& knots, float t) const;
     /// Linear interpolation between two Variants based on underlying type.
@@ -758,9 +758,20 @@ unsigned GetStringListIndex(const char* value, const char* const* strings, unsig
 
 ea::string ToString(const char* formatString, ...)
 {
-    ea::string ret;
+    // Most formatted strings are short, try a stack buffer first to avoid formatting twice
+    char buffer[256];
     va_list args;
     va_start(args, formatString);
+    const int length = vsnprintf(buffer, sizeof(buffer), formatString, args);
+    va_end(args);
+
+    if (length < 0)
+        return EMPTY_STRING;
+    if (static_cast<unsigned>(length) < sizeof(buffer))
+        return ea::string(buffer, static_cast<unsigned>(length));
+
+    ea::string ret;
+    va_start(args, formatString);
     ret.append_sprintf_va_list(formatString, args);
     va_end(args);
     return ret;
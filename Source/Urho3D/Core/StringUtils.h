@@ -182,9 +182,10 @@ template <class T> T FromString(const ea::string& source) { return FromString<T>
 /// Return a formatted string.
 template<typename... Args> inline ea::string Format(ea::string_view formatString, const Args&... args)
 {
-    ea::string ret;
-    fmt::format_to(std::back_inserter(ret), formatString, args...);
-    return ret;
+    // Format into a stack buffer first so that the result is allocated once with the final size
+    fmt::basic_memory_buffer<char, 256> buffer;
+    fmt::format_to(buffer, formatString, args...);
+    return ea::string(buffer.data(), buffer.size());
 }
 
 }
@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Container/FrameAllocator.h"
 #include "../Core/CoreEvents.h"
 #include "../Core/Profiler.h"
 #include "../Core/Timer.h"
@@ -143,6 +144,9 @@ void Time::EndFrame()
         // Internal frame end event used only by the engine/tools
         SendEvent(E_ENDFRAMEPRIVATE);
     }
+
+    // Temporary memory of this frame is no longer referenced
+    FrameAllocator::EndFrame();
 }
 
 void Time::SetTimerPeriod(unsigned mSec)
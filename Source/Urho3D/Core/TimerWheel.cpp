@@ -0,0 +1,194 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/TimerWheel.h"
+#include "../Math/MathDefs.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+TimerWheel::TimerWheel()
+{
+    for (auto& level : slots_)
+        level.fill(INVALID_INDEX);
+}
+
+TimerHandle TimerWheel::Schedule(unsigned long long delay, Callback callback)
+{
+    static const unsigned long long maxDelay = (1ull << (NUM_LEVELS * LEVEL_BITS)) - 1;
+
+    const unsigned index = AllocateNode();
+    Node& node = nodes_[index];
+    node.callback_ = ea::move(callback);
+    node.expiry_ = currentTick_ + Clamp(delay, 1ull, maxDelay);
+    node.scheduled_ = true;
+    InsertNode(index);
+    ++numScheduled_;
+
+    return {index, node.generation_};
+}
+
+bool TimerWheel::Cancel(const TimerHandle& handle)
+{
+    if (!IsScheduled(handle))
+        return false;
+
+    UnlinkNode(handle.index_);
+    ReleaseNode(handle.index_);
+    --numScheduled_;
+    return true;
+}
+
+bool TimerWheel::IsScheduled(const TimerHandle& handle) const
+{
+    if (handle.index_ >= nodes_.size())
+        return false;
+
+    const Node& node = nodes_[handle.index_];
+    return node.scheduled_ && node.generation_ == handle.generation_;
+}
+
+void TimerWheel::Clear()
+{
+    for (unsigned i = 0; i < nodes_.size(); ++i)
+    {
+        if (nodes_[i].scheduled_)
+            ReleaseNode(i);
+    }
+    for (auto& level : slots_)
+        level.fill(INVALID_INDEX);
+    numScheduled_ = 0;
+}
+
+void TimerWheel::Advance(unsigned long long ticks)
+{
+    for (unsigned long long i = 0; i < ticks; ++i)
+    {
+        ++currentTick_;
+
+        // When a level wraps around, bring the timers of the next level slot down. Higher levels first,
+        // so that their timers can cascade further in the same tick
+        unsigned cascadeLevels = 0;
+        while (cascadeLevels + 1 < NUM_LEVELS && ((currentTick_ >> (LEVEL_BITS * (cascadeLevels + 1)) << (LEVEL_BITS * (cascadeLevels + 1))) == currentTick_))
+            ++cascadeLevels;
+        for (unsigned level = cascadeLevels; level > 0; --level)
+            Cascade(level);
+
+        // Fire expired timers. The list head is re-read every time because callbacks may modify the wheel
+        unsigned& head = slots_[0][currentTick_ & (NUM_SLOTS - 1)];
+        while (head != INVALID_INDEX)
+        {
+            const unsigned index = head;
+            UnlinkNode(index);
+            Callback callback = ea::move(nodes_[index].callback_);
+            ReleaseNode(index);
+            --numScheduled_;
+            callback();
+        }
+
+        // Skip empty stretches quickly when nothing is scheduled
+        if (!numScheduled_)
+        {
+            currentTick_ += ticks - i - 1;
+            break;
+        }
+    }
+}
+
+unsigned TimerWheel::AllocateNode()
+{
+    if (freeList_ != INVALID_INDEX)
+    {
+        const unsigned index = freeList_;
+        freeList_ = nodes_[index].prev_;
+        return index;
+    }
+
+    nodes_.emplace_back();
+    return nodes_.size() - 1;
+}
+
+void TimerWheel::ReleaseNode(unsigned index)
+{
+    Node& node = nodes_[index];
+    node.callback_ = nullptr;
+    node.scheduled_ = false;
+    node.next_ = INVALID_INDEX;
+    node.prev_ = freeList_;
+    // Skip zero so that default handles never match
+    if (++node.generation_ == 0)
+        node.generation_ = 1;
+    freeList_ = index;
+}
+
+void TimerWheel::InsertNode(unsigned index)
+{
+    Node& node = nodes_[index];
+    const unsigned long long delta = node.expiry_ - currentTick_;
+
+    unsigned level = 0;
+    while (level + 1 < NUM_LEVELS && delta >= (1ull << (LEVEL_BITS * (level + 1))))
+        ++level;
+
+    node.level_ = level;
+    node.slot_ = static_cast<unsigned>(node.expiry_ >> (LEVEL_BITS * level)) & (NUM_SLOTS - 1);
+
+    unsigned& head = slots_[node.level_][node.slot_];
+    node.prev_ = INVALID_INDEX;
+    node.next_ = head;
+    if (head != INVALID_INDEX)
+        nodes_[head].prev_ = index;
+    head = index;
+}
+
+void TimerWheel::UnlinkNode(unsigned index)
+{
+    Node& node = nodes_[index];
+    if (node.prev_ != INVALID_INDEX)
+        nodes_[node.prev_].next_ = node.next_;
+    else
+        slots_[node.level_][node.slot_] = node.next_;
+    if (node.next_ != INVALID_INDEX)
+        nodes_[node.next_].prev_ = node.prev_;
+    node.prev_ = INVALID_INDEX;
+    node.next_ = INVALID_INDEX;
+}
+
+void TimerWheel::Cascade(unsigned level)
+{
+    unsigned& head = slots_[level][(currentTick_ >> (LEVEL_BITS * level)) & (NUM_SLOTS - 1)];
+    unsigned index = head;
+    head = INVALID_INDEX;
+    while (index != INVALID_INDEX)
+    {
+        const unsigned next = nodes_[index].next_;
+        InsertNode(index);
+        index = next;
+    }
+}
+
+}
@@ -0,0 +1,129 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#pragma once
+
+#include <Urho3D/Urho3D.h>
+
+#include <EASTL/array.h>
+#include <EASTL/vector.h>
+
+#include <functional>
+
+namespace Urho3D
+{
+
+/// Handle of a scheduled timer. Stays safe to use after the timer has fired or been cancelled.
+struct TimerHandle
+{
+    /// Return whether the handle refers to a timer ever scheduled.
+    bool IsValid() const { return generation_ != 0; }
+
+    /// Index of the timer node.
+    unsigned index_{};
+    /// Generation of the timer node, zero for invalid handle.
+    unsigned generation_{};
+};
+
+/// Hierarchical timer wheel. Scheduling and cancelling are O(1), expired timers are dispatched in tick batches.
+/// Time is measured in abstract integer ticks, the owner decides the tick duration and advances the wheel.
+/// Delays longer than 2^32 - 1 ticks are clamped.
+class URHO3D_API TimerWheel
+{
+public:
+    /// Timer callback.
+    using Callback = std::function<void()>;
+
+    /// Construct.
+    TimerWheel();
+
+    /// Schedule callback after specified number of ticks. Zero delay fires on the next tick.
+    TimerHandle Schedule(unsigned long long delay, Callback callback);
+    /// Cancel scheduled timer. Return false if it has already fired or been cancelled.
+    bool Cancel(const TimerHandle& handle);
+    /// Return whether the timer is still scheduled.
+    bool IsScheduled(const TimerHandle& handle) const;
+    /// Cancel all timers.
+    void Clear();
+    /// Advance by specified number of ticks and call expired timers in the order of expiry.
+    /// Callbacks may schedule and cancel timers.
+    void Advance(unsigned long long ticks);
+
+    /// Return current tick.
+    unsigned long long GetCurrentTick() const { return currentTick_; }
+    /// Return number of scheduled timers.
+    unsigned GetNumScheduled() const { return numScheduled_; }
+
+private:
+    /// Number of wheel levels.
+    static const unsigned NUM_LEVELS = 4;
+    /// Number of bits of tick used by each level.
+    static const unsigned LEVEL_BITS = 8;
+    /// Number of slots per level.
+    static const unsigned NUM_SLOTS = 1u << LEVEL_BITS;
+    /// Marker of list end.
+    static const unsigned INVALID_INDEX = 0xffffffffu;
+
+    /// Timer node.
+    struct Node
+    {
+        /// Callback.
+        Callback callback_;
+        /// Tick when the timer expires.
+        unsigned long long expiry_{};
+        /// Previous node in the slot list, or next free node.
+        unsigned prev_{INVALID_INDEX};
+        /// Next node in the slot list.
+        unsigned next_{INVALID_INDEX};
+        /// Generation, incremented every time the node is released.
+        unsigned generation_{1};
+        /// Level and slot of the list the node is in.
+        unsigned level_{}, slot_{};
+        /// Whether the node is scheduled.
+        bool scheduled_{};
+    };
+
+    /// Allocate node.
+    unsigned AllocateNode();
+    /// Release node back to the free list.
+    void ReleaseNode(unsigned index);
+    /// Insert node to the slot matching its expiry.
+    void InsertNode(unsigned index);
+    /// Unlink node from its slot.
+    void UnlinkNode(unsigned index);
+    /// Move timers of the higher level slot to the lower levels.
+    void Cascade(unsigned level);
+
+    /// Nodes.
+    ea::vector<Node> nodes_;
+    /// First free node.
+    unsigned freeList_{INVALID_INDEX};
+    /// Heads of the slot lists.
+    ea::array<ea::array<unsigned, NUM_SLOTS>, NUM_LEVELS> slots_;
+    /// Current tick.
+    unsigned long long currentTick_{};
+    /// Number of scheduled timers.
+    unsigned numScheduled_{};
+};
+
+}
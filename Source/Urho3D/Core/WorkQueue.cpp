@@ -33,6 +33,17 @@
 namespace Urho3D
 {
 
+/// Utilization counters of a worker thread. Written by the worker thread, read and reset by the main thread.
+struct WorkerThreadCounters
+{
+    /// Time spent executing work items.
+    std::atomic<long long> busyUSec_{};
+    /// Time spent waiting for the queue mutex held by another thread.
+    std::atomic<long long> contentionUSec_{};
+    /// Number of executed work items.
+    std::atomic<unsigned> numItems_{};
+};
+
 /// Worker thread managed by the work queue.
 class WorkerThread : public Thread, public RefCounted
 {
@@ -50,17 +61,21 @@ public:
         URHO3D_PROFILE_THREAD(Format("WorkerThread {}", (uint64_t)GetCurrentThreadID()).c_str());
         // Init FPU state first
         InitFPU();
-        owner_->ProcessItems(index_);
+        owner_->ProcessItems(index_, counters_);
     }
 
     /// Return thread index.
     unsigned GetIndex() const { return index_; }
+    /// Return utilization counters.
+    WorkerThreadCounters& GetCounters() { return counters_; }
 
 private:
     /// Work queue.
     WorkQueue* owner_;
     /// Thread index.
     unsigned index_;
+    /// Utilization counters.
+    WorkerThreadCounters counters_;
 };
 
 WorkQueue::WorkQueue(Context* context) :
@@ -167,6 +182,9 @@ void WorkQueue::AddWorkItem(const SharedPtr<WorkItem>& item)
             queue_.push_back(item.Get());
     }
 
+    const unsigned queueDepth = queue_.size();
+    maxQueueDepth_ = Max(maxQueueDepth_, queueDepth);
+
     if (threads_.size())
     {
         queueMutex_.Release();
@@ -184,7 +202,7 @@ SharedPtr<WorkItem> WorkQueue::AddWorkItem(std::function<void()> workFunction, u
     return item;
 }
 
-bool WorkQueue::RemoveWorkItem(SharedPtr<WorkItem> item)
+bool WorkQueue::RemoveWorkItem(const SharedPtr<WorkItem>& item)
 {
     if (!item)
         return false;
@@ -199,7 +217,7 @@ bool WorkQueue::RemoveWorkItem(SharedPtr<WorkItem> item)
         if (j != workItems_.end())
         {
             queue_.erase(i);
-            ReturnToPool(item);
+            ReturnToPool(*j);
             workItems_.erase(j);
             return true;
         }
@@ -258,6 +276,7 @@ void WorkQueue::Resume()
 void WorkQueue::Complete(unsigned priority)
 {
     completing_ = true;
+    ++numCompletes_;
 
     if (threads_.size())
     {
@@ -272,8 +291,7 @@ void WorkQueue::Complete(unsigned priority)
                 WorkItem* item = queue_.front();
                 queue_.pop_front();
                 queueMutex_.Release();
-                item->workFunction_(item, 0);
-                item->completed_ = true;
+                ExecuteItem(item, 0);
             }
             else
             {
@@ -283,9 +301,11 @@ void WorkQueue::Complete(unsigned priority)
         }
 
         // Wait for threaded work to complete
+        HiresTimer waitTimer;
         while (!IsCompleted(priority))
         {
         }
+        mainThreadCounters_.idleUSec_ += waitTimer.GetUSec(false);
 
         // If no work at all remaining, pause worker threads by leaving the mutex locked
         if (queue_.empty())
@@ -298,8 +318,7 @@ void WorkQueue::Complete(unsigned priority)
         {
             WorkItem* item = queue_.front();
             queue_.pop_front();
-            item->workFunction_(item, 0);
-            item->completed_ = true;
+            ExecuteItem(item, 0);
         }
     }
 
@@ -307,6 +326,52 @@ void WorkQueue::Complete(unsigned priority)
     completing_ = false;
 }
 
+void WorkQueue::ParallelFor(unsigned count, unsigned batchSize, const std::function<void(unsigned, unsigned, unsigned)>& function)
+{
+    if (!count)
+        return;
+
+    batchSize = Max(batchSize, 1U);
+    const unsigned numBatches = (count + batchSize - 1) / batchSize;
+    const unsigned numItems = Min(threads_.size() + 1, numBatches); // Worker threads + main thread
+
+    if (numItems <= 1)
+    {
+        function(0, count, 0);
+        return;
+    }
+
+    // Each work item keeps claiming batches from a shared counter until none are left
+    std::atomic<unsigned> nextBatch{0};
+    std::function<void(unsigned)> processBatches = [&](unsigned threadIndex)
+    {
+        for (;;)
+        {
+            const unsigned batch = nextBatch.fetch_add(1, std::memory_order_relaxed);
+            if (batch >= numBatches)
+                break;
+
+            const unsigned begin = batch * batchSize;
+            function(begin, Min(begin + batchSize, count), threadIndex);
+        }
+    };
+
+    for (unsigned i = 0; i < numItems; ++i)
+    {
+        SharedPtr<WorkItem> item = GetFreeItem();
+        item->priority_ = M_MAX_UNSIGNED;
+        item->name_ = "ParallelFor";
+        item->aux_ = &processBatches;
+        item->workFunction_ = [](const WorkItem* item, unsigned threadIndex)
+        {
+            (*static_cast<std::function<void(unsigned)>*>(item->aux_))(threadIndex);
+        };
+        AddWorkItem(item);
+    }
+
+    Complete(M_MAX_UNSIGNED);
+}
+
 unsigned WorkQueue::GetNumIncomplete(unsigned priority) const
 {
     unsigned incomplete = 0;
@@ -330,7 +395,28 @@ bool WorkQueue::IsCompleted(unsigned priority) const
     return true;
 }
 
-void WorkQueue::ProcessItems(unsigned threadIndex)
+long long WorkQueue::ExecuteItem(WorkItem* item, unsigned threadIndex)
+{
+    URHO3D_PROFILE("ExecuteWorkItem");
+    HiresTimer timer;
+#if URHO3D_PROFILING
+    if (item->name_)
+        URHO3D_PROFILE_ZONENAME(item->name_, strlen(item->name_));
+#endif
+
+    item->workFunction_(item, threadIndex);
+    item->completed_ = true;
+
+    const long long elapsedUSec = timer.GetUSec(false);
+    if (threadIndex == 0)
+    {
+        mainThreadCounters_.busyUSec_ += elapsedUSec;
+        ++mainThreadCounters_.numItems_;
+    }
+    return elapsedUSec;
+}
+
+void WorkQueue::ProcessItems(unsigned threadIndex, WorkerThreadCounters& counters)
 {
     bool wasActive = false;
 
@@ -343,7 +429,16 @@ void WorkQueue::ProcessItems(unsigned threadIndex)
             Time::Sleep(0);
         else
         {
-            queueMutex_.Acquire();
+            if (!queueMutex_.TryAcquire())
+            {
+                // Blocking on a paused queue is idle time rather than contention
+                const bool wasPaused = paused_;
+                HiresTimer lockTimer;
+                queueMutex_.Acquire();
+                if (!wasPaused)
+                    counters.contentionUSec_.fetch_add(lockTimer.GetUSec(false), std::memory_order_relaxed);
+            }
+
             if (!queue_.empty())
             {
                 wasActive = true;
@@ -351,8 +446,9 @@ void WorkQueue::ProcessItems(unsigned threadIndex)
                 WorkItem* item = queue_.front();
                 queue_.pop_front();
                 queueMutex_.Release();
-                item->workFunction_(item, threadIndex);
-                item->completed_ = true;
+
+                counters.busyUSec_.fetch_add(ExecuteItem(item, threadIndex), std::memory_order_relaxed);
+                counters.numItems_.fetch_add(1, std::memory_order_relaxed);
             }
             else
             {
@@ -415,6 +511,7 @@ void WorkQueue::ReturnToPool(SharedPtr<WorkItem>& item)
         item->start_ = nullptr;
         item->end_ = nullptr;
         item->aux_ = nullptr;
+        item->name_ = nullptr;
         item->workFunction_ = nullptr;
         item->priority_ = M_MAX_UNSIGNED;
         item->sendEvent_ = false;
@@ -437,14 +534,50 @@ void WorkQueue::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
         {
             WorkItem* item = queue_.front();
             queue_.pop_front();
-            item->workFunction_(item, 0);
-            item->completed_ = true;
+            ExecuteItem(item, 0);
+            ++numNonThreadedItems_;
         }
     }
 
     // Complete and signal items down to the lowest priority
     PurgeCompleted(0);
     PurgePool();
+    UpdateStatistics();
+}
+
+void WorkQueue::UpdateStatistics()
+{
+    statistics_.frameUSec_ = frameTimer_.GetUSec(true);
+    statistics_.maxQueueDepth_ = maxQueueDepth_;
+    statistics_.numCompletes_ = numCompletes_;
+    statistics_.numNonThreadedItems_ = numNonThreadedItems_;
+    statistics_.threads_.resize(threads_.size() + 1);
+    statistics_.threads_[0] = mainThreadCounters_;
+
+    long long totalBusyUSec = 0;
+    for (unsigned i = 0; i < threads_.size(); ++i)
+    {
+        WorkerThreadCounters& counters = threads_[i]->GetCounters();
+        WorkQueueThreadStatistics& threadStats = statistics_.threads_[i + 1];
+        threadStats.busyUSec_ = counters.busyUSec_.exchange(0, std::memory_order_relaxed);
+        threadStats.contentionUSec_ = counters.contentionUSec_.exchange(0, std::memory_order_relaxed);
+        threadStats.numItems_ = counters.numItems_.exchange(0, std::memory_order_relaxed);
+        threadStats.idleUSec_ = Max(statistics_.frameUSec_ - threadStats.busyUSec_ - threadStats.contentionUSec_, 0LL);
+        totalBusyUSec += threadStats.busyUSec_;
+    }
+
+    URHO3D_PROFILE_VALUE("WorkQueue max depth", static_cast<int64_t>(maxQueueDepth_));
+    URHO3D_PROFILE_VALUE("WorkQueue complete wait (ms)", mainThreadCounters_.idleUSec_ / 1000.0);
+    if (!threads_.empty() && statistics_.frameUSec_ > 0)
+    {
+        const double utilization = 100.0 * totalBusyUSec / (statistics_.frameUSec_ * threads_.size());
+        URHO3D_PROFILE_VALUE("WorkQueue worker utilization (%)", utilization);
+    }
+
+    mainThreadCounters_ = WorkQueueThreadStatistics{};
+    maxQueueDepth_ = queue_.size();
+    numCompletes_ = 0;
+    numNonThreadedItems_ = 0;
 }
 
 }
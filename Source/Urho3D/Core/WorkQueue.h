@@ -27,6 +27,7 @@
 
 #include "../Core/Mutex.h"
 #include "../Core/Object.h"
+#include "../Core/Timer.h"
 
 #include <atomic>
 
@@ -40,6 +41,35 @@ URHO3D_EVENT(E_WORKITEMCOMPLETED, WorkItemCompleted)
 }
 
 class WorkerThread;
+struct WorkerThreadCounters;
+
+/// Work queue utilization of a single thread over one frame.
+struct WorkQueueThreadStatistics
+{
+    /// Time spent executing work items, in microseconds.
+    long long busyUSec_{};
+    /// Time spent without work, in microseconds. For the main thread this is the time Complete() spent waiting for worker threads.
+    long long idleUSec_{};
+    /// Time spent waiting for the queue mutex held by another thread, in microseconds.
+    long long contentionUSec_{};
+    /// Number of executed work items.
+    unsigned numItems_{};
+};
+
+/// Work queue statistics over one frame.
+struct WorkQueueStatistics
+{
+    /// Per-thread utilization. Index 0 is the main thread, followed by the worker threads.
+    ea::vector<WorkQueueThreadStatistics> threads_;
+    /// Frame duration the statistics were gathered over, in microseconds.
+    long long frameUSec_{};
+    /// Maximum number of queued items.
+    unsigned maxQueueDepth_{};
+    /// Number of Complete() calls.
+    unsigned numCompletes_{};
+    /// Number of low-priority items executed in the main thread due to having no worker threads.
+    unsigned numNonThreadedItems_{};
+};
 
 /// Work queue item.
 /// @nobind
@@ -58,6 +88,8 @@ public:
     void* aux_{};
     /// Priority. Higher value = will be completed first.
     unsigned priority_{};
+    /// Optional name shown for the work item in the profiler. Must outlive the work item.
+    const char* name_{};
     /// Whether to send event on completion.
     bool sendEvent_{};
     /// Completed flag.
@@ -91,7 +123,7 @@ public:
     /// Add a work item and resume worker threads.
     SharedPtr<WorkItem> AddWorkItem(std::function<void()> workFunction, unsigned priority = 0);
     /// Remove a work item before it has started executing. Return true if successfully removed.
-    bool RemoveWorkItem(SharedPtr<WorkItem> item);
+    bool RemoveWorkItem(const SharedPtr<WorkItem>& item);
     /// Remove a number of work items before they have started executing. Return the number of items successfully removed.
     unsigned RemoveWorkItems(const ea::vector<SharedPtr<WorkItem> >& items);
     /// Pause worker threads.
@@ -100,6 +132,8 @@ public:
     void Resume();
     /// Finish all queued work which has at least the specified priority. Main thread will also execute priority work. Pause worker threads if no more work remains.
     void Complete(unsigned priority);
+    /// Execute function over range [0, count) split into batches, on worker threads and the main thread, and wait for completion. Batches are claimed dynamically so that idle threads take over remaining work. The function receives the batch begin, end and thread index. Must be called from the main thread.
+    void ParallelFor(unsigned count, unsigned batchSize, const std::function<void(unsigned, unsigned, unsigned)>& function);
 
     /// Set the pool telerance before it starts deleting pool items.
     void SetTolerance(int tolerance) { tolerance_ = tolerance; }
@@ -122,10 +156,16 @@ public:
 
     /// Return how many milliseconds maximum to spend on non-threaded low-priority work.
     int GetNonThreadedWorkMs() const { return maxNonThreadedWorkMs_; }
+    /// Return utilization statistics of the previous frame.
+    const WorkQueueStatistics& GetStatistics() const { return statistics_; }
 
 private:
     /// Process work items until shut down. Called by the worker threads.
-    void ProcessItems(unsigned threadIndex);
+    void ProcessItems(unsigned threadIndex, WorkerThreadCounters& counters);
+    /// Execute work item and mark it completed. Return execution time in microseconds.
+    long long ExecuteItem(WorkItem* item, unsigned threadIndex);
+    /// Gather statistics of the finished frame and reset the counters.
+    void UpdateStatistics();
     /// Purge completed work items which have at least the specified priority, and send completion events as necessary.
     void PurgeCompleted(unsigned priority);
     /// Purge the pool to reduce allocation where its unneeded.
@@ -150,7 +190,7 @@ private:
     /// Pausing flag. Indicates the worker threads should not contend for the queue mutex.
     std::atomic<bool> pausing_;
     /// Paused flag. Indicates the queue mutex being locked to prevent worker threads using up CPU time.
-    bool paused_;
+    std::atomic<bool> paused_;
     /// Completing work in the main thread flag.
     bool completing_;
     /// Tolerance for the shared pool before it begins to deallocate.
@@ -159,6 +199,18 @@ private:
     unsigned lastSize_;
     /// Maximum milliseconds per frame to spend on low-priority work, when there are no worker threads.
     int maxNonThreadedWorkMs_;
+    /// Main thread utilization counters of the current frame.
+    WorkQueueThreadStatistics mainThreadCounters_;
+    /// Maximum queue depth of the current frame.
+    unsigned maxQueueDepth_{};
+    /// Number of Complete() calls in the current frame.
+    unsigned numCompletes_{};
+    /// Number of non-threaded items executed in the current frame.
+    unsigned numNonThreadedItems_{};
+    /// Timer measuring the current frame.
+    HiresTimer frameTimer_;
+    /// Statistics of the previous frame.
+    WorkQueueStatistics statistics_;
 };
 
 }
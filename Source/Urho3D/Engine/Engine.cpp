@@ -23,6 +23,7 @@
 #include "../Precompiled.h"
 
 #include "../Audio/Audio.h"
+#include "../Core/AllocationStats.h"
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
 #include "../Core/Profiler.h"
@@ -36,6 +37,9 @@
 #endif
 #include "../Engine/Engine.h"
 #include "../Engine/EngineDefs.h"
+#include "../Engine/FrameReplay.h"
+#include "../Engine/HitchDetector.h"
+#include "../Engine/PerformanceGovernor.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Renderer.h"
 #include "../Input/Input.h"
@@ -77,6 +81,8 @@
 
 #include <Urho3D/Core/CommandLine.h>
 
+#include <thread>
+
 #include "../DebugNew.h"
 
 
@@ -102,6 +108,28 @@ namespace Urho3D
 
 extern const char* logLevelNames[];
 
+/// Work queue priority of pipelined work. Just below the priority used by rendering.
+static const unsigned PIPELINED_WORK_PRIORITY = M_MAX_UNSIGNED - 1;
+
+/// Scoped timer that reports the duration of an engine startup stage to the log.
+class StartupStageTimer
+{
+public:
+    /// Construct and start timing. Name must be a string literal.
+    explicit StartupStageTimer(const char* name) : name_(name) { }
+    /// Stop timing and log.
+    ~StartupStageTimer() { URHO3D_LOGDEBUG("Startup stage {} took {:.2f} ms", name_, timer_.GetUSec(false) / 1000.0f); }
+
+private:
+    /// Stage name.
+    const char* name_;
+    /// High resolution timer.
+    HiresTimer timer_;
+};
+
+/// Open a profiler zone and a startup timer for the enclosing scope.
+#define URHO3D_STARTUP_STAGE(name) URHO3D_PROFILE(name); StartupStageTimer startupStageTimer(name)
+
 Engine::Engine(Context* context) :
     Object(context),
     timeStep_(0.0f),
@@ -129,45 +157,57 @@ Engine::Engine(Context* context) :
     context_->RegisterSubsystem(this);
 
     // Create subsystems which do not depend on engine initialization or startup parameters
-    context_->RegisterSubsystem(new Time(context_));
-    context_->RegisterSubsystem(new WorkQueue(context_));
-    context_->RegisterSubsystem(new FileSystem(context_));
+    {
+        URHO3D_STARTUP_STAGE("CreateCoreSubsystems");
+        context_->RegisterSubsystem(new Time(context_));
+        context_->RegisterSubsystem(new WorkQueue(context_));
+        context_->RegisterSubsystem(new FileSystem(context_));
 #ifdef URHO3D_LOGGING
-    context_->RegisterSubsystem(new Log(context_));
+        context_->RegisterSubsystem(new Log(context_));
 #endif
-    context_->RegisterSubsystem(new ResourceCache(context_));
-    context_->RegisterSubsystem(new Localization(context_));
+        context_->RegisterSubsystem(new ResourceCache(context_));
+        context_->RegisterSubsystem(new Localization(context_));
 #ifdef URHO3D_NETWORK
-    context_->RegisterSubsystem(new Network(context_));
+        context_->RegisterSubsystem(new Network(context_));
 #endif
-    // Register UI library object factories before creation of subsystem. This is not done inside subsystem because
-    // there may exist multiple instances of UI.
-    RegisterUILibrary(context_);
-    context_->RegisterSubsystem(new UI(context_));
+    }
+    {
+        URHO3D_STARTUP_STAGE("CreateUI");
+        // Register UI library object factories before creation of subsystem. This is not done inside subsystem because
+        // there may exist multiple instances of UI.
+        RegisterUILibrary(context_);
+        context_->RegisterSubsystem(new UI(context_));
+    }
 #ifdef URHO3D_RMLUI
-    RegisterRmlUILibrary(context_);
-    context_->RegisterSubsystem(new RmlUI(context_));
+    {
+        URHO3D_STARTUP_STAGE("CreateRmlUI");
+        RegisterRmlUILibrary(context_);
+        context_->RegisterSubsystem(new RmlUI(context_));
+    }
 #endif
-    // Register object factories for libraries which are not automatically registered along with subsystem creation
-    RegisterSceneLibrary(context_);
+    {
+        URHO3D_STARTUP_STAGE("RegisterLibraries");
+        // Register object factories for libraries which are not automatically registered along with subsystem creation
+        RegisterSceneLibrary(context_);
 
 #ifdef URHO3D_GLOW
-    // Light baker needs only one class so far, so register it directly.
-    // Extract this code into function if you are adding more.
-    StaticModelForLightmap::RegisterObject(context_);
+        // Light baker needs only one class so far, so register it directly.
+        // Extract this code into function if you are adding more.
+        StaticModelForLightmap::RegisterObject(context_);
 #endif
 
 #ifdef URHO3D_IK
-    RegisterIKLibrary(context_);
+        RegisterIKLibrary(context_);
 #endif
 
 #ifdef URHO3D_PHYSICS
-    RegisterPhysicsLibrary(context_);
+        RegisterPhysicsLibrary(context_);
 #endif
 
 #ifdef URHO3D_NAVIGATION
-    RegisterNavigationLibrary(context_);
+        RegisterNavigationLibrary(context_);
 #endif
+    }
 
     SubscribeToEvent(E_EXITREQUESTED, URHO3D_HANDLER(Engine, HandleExitRequested));
     SubscribeToEvent(E_ENDFRAME, URHO3D_HANDLER(Engine, HandleEndFrame));
@@ -181,6 +221,7 @@ bool Engine::Initialize(const VariantMap& parameters)
         return true;
 
     URHO3D_PROFILE("InitEngine");
+    HiresTimer initTimer;
 
     // Start logging
     auto* log = GetSubsystem<Log>();
@@ -189,6 +230,7 @@ bool Engine::Initialize(const VariantMap& parameters)
         if (HasParameter(parameters, EP_LOG_LEVEL))
             log->SetLevel(static_cast<LogLevel>(GetParameter(parameters, EP_LOG_LEVEL).GetInt()));
         log->SetQuiet(GetParameter(parameters, EP_LOG_QUIET, false).GetBool());
+        log->SetAsync(GetParameter(parameters, EP_LOG_ASYNC, false).GetBool());
         log->Open(GetParameter(parameters, EP_LOG_NAME, "Urho3D.log").GetString());
     }
 
@@ -196,23 +238,28 @@ bool Engine::Initialize(const VariantMap& parameters)
     headless_ = GetParameter(parameters, EP_HEADLESS, false).GetBool();
 
     // Register the rest of the subsystems
-    context_->RegisterSubsystem(new Input(context_));
-    context_->RegisterSubsystem(new Audio(context_));
-    if (!headless_)
-    {
-        context_->RegisterSubsystem(new Graphics(context_));
-        context_->RegisterSubsystem(new Renderer(context_));
-    }
-    else
     {
-        // Register graphics library objects explicitly in headless mode to allow them to work without using actual GPU resources
-        RegisterGraphicsLibrary(context_);
-    }
+        URHO3D_STARTUP_STAGE("CreateSubsystems");
+        context_->RegisterSubsystem(new Input(context_));
+        if (!headless_)
+        {
+            context_->RegisterSubsystem(new Audio(context_));
+            context_->RegisterSubsystem(new Graphics(context_));
+            context_->RegisterSubsystem(new Renderer(context_));
+        }
+        else
+        {
+            // Register graphics and audio library objects explicitly in headless mode to allow them to work without using
+            // actual GPU or audio resources
+            RegisterGraphicsLibrary(context_);
+            RegisterAudioLibrary(context_);
+        }
 
 #ifdef URHO3D_URHO2D
-    // 2D graphics library is dependent on 3D graphics library
-    RegisterUrho2DLibrary(context_);
+        // 2D graphics library is dependent on 3D graphics library
+        RegisterUrho2DLibrary(context_);
 #endif
+    }
 
     // Set maximally accurate low res timer
     GetSubsystem<Time>()->SetTimerPeriod(1);
@@ -220,6 +267,16 @@ bool Engine::Initialize(const VariantMap& parameters)
     // Configure max FPS
     if (GetParameter(parameters, EP_FRAME_LIMITER, true) == false)
         SetMaxFps(0);
+    if (HasParameter(parameters, EP_TICK_RATE))
+        SetTickRate(GetParameter(parameters, EP_TICK_RATE).GetInt());
+    SetPipelinedFrame(GetParameter(parameters, EP_PIPELINED_FRAME, false).GetBool());
+
+    // Pin the main thread, for example to keep a dedicated server off the cores used by other processes
+    if (HasParameter(parameters, EP_MAIN_THREAD_AFFINITY))
+    {
+        if (!SetCurrentThreadAffinity(GetParameter(parameters, EP_MAIN_THREAD_AFFINITY).GetUInt64()))
+            URHO3D_LOGWARNING("Failed to set main thread affinity");
+    }
 
     // Set amount of worker threads according to the available physical CPU cores. Using also hyperthreaded cores results in
     // unpredictable extra synchronization overhead. Also reserve one core for the main thread
@@ -227,15 +284,20 @@ bool Engine::Initialize(const VariantMap& parameters)
     unsigned numThreads = GetParameter(parameters, EP_WORKER_THREADS, true).GetBool() ? GetNumPhysicalCPUs() - 1 : 0;
     if (numThreads)
     {
+        URHO3D_STARTUP_STAGE("CreateWorkerThreads");
         GetSubsystem<WorkQueue>()->CreateThreads(numThreads);
 
         URHO3D_LOGINFOF("Created %u worker thread%s", numThreads, numThreads > 1 ? "s" : "");
     }
 #endif
+    URHO3D_LOGINFO("CPU features: {}", GetCPUFeaturesString());
 
     // Add resource paths
-    if (!InitializeResourceCache(parameters, false))
-        return false;
+    {
+        URHO3D_STARTUP_STAGE("InitResourceCache");
+        if (!InitializeResourceCache(parameters, false))
+            return false;
+    }
 
     auto* cache = GetSubsystem<ResourceCache>();
     auto* fileSystem = GetSubsystem<FileSystem>();
@@ -243,6 +305,7 @@ bool Engine::Initialize(const VariantMap& parameters)
     // Initialize graphics & audio output
     if (!headless_)
     {
+        URHO3D_STARTUP_STAGE("InitGraphicsAndAudio");
         auto* graphics = GetSubsystem<Graphics>();
         auto* renderer = GetSubsystem<Renderer>();
 
@@ -326,13 +389,45 @@ bool Engine::Initialize(const VariantMap& parameters)
     if (!headless_)
     {
 #ifdef URHO3D_SYSTEMUI
+        URHO3D_STARTUP_STAGE("CreateSystemUI");
         context_->RegisterSubsystem(new SystemUI(context_,
             GetParameter(parameters, EP_SYSTEMUI_FLAGS, 0).GetUInt()));
 #endif
     }
+    // Record or play back session for performance regression testing
+    if (HasParameter(parameters, EP_REPLAY_RECORD) || HasParameter(parameters, EP_REPLAY_PLAY))
+    {
+        auto* replay = new FrameReplay(context_);
+        context_->RegisterSubsystem(replay);
+        if (HasParameter(parameters, EP_REPLAY_PLAY))
+        {
+            replay->SetExitOnFinish(true);
+            if (replay->LoadFile(GetParameter(parameters, EP_REPLAY_PLAY).GetString()))
+                replay->StartPlayback(GetParameter(parameters, EP_REPLAY_REPORT, EMPTY_STRING).GetString());
+        }
+        else
+            replay->StartRecording(GetParameter(parameters, EP_REPLAY_RECORD).GetString());
+    }
+
+    // Detect slow frames and optionally dump the frames around them
+    auto* hitchDetector = new HitchDetector(context_);
+    context_->RegisterSubsystem(hitchDetector);
+    hitchDetector->SetThreshold(GetParameter(parameters, EP_HITCH_THRESHOLD, 100).GetInt());
+    hitchDetector->SetDumpDir(GetParameter(parameters, EP_HITCH_DUMP_DIR, EMPTY_STRING).GetString());
+
+    // Scale quality to hold a frame budget. Inactive until a target frame time is set
+    auto* governor = new PerformanceGovernor(context_);
+    context_->RegisterSubsystem(governor);
+    const float targetFrameTime = GetParameter(parameters, EP_QUALITY_TARGET_FRAME_TIME, 0.0f).GetFloat();
+    if (targetFrameTime > 0.0f && !headless_)
+    {
+        governor->SetTargetFrameTime(targetFrameTime);
+        governor->AddRendererKnobs();
+    }
+
     frameTimer_.Reset();
 
-    URHO3D_LOGINFO("Initialized engine");
+    URHO3D_LOGINFO("Initialized engine in {:.2f} ms", initTimer.GetUSec(false) / 1000.0f);
     initialized_ = true;
     SendEvent(E_ENGINEINITIALIZED);
     return true;
@@ -359,6 +454,8 @@ bool Engine::InitializeResourceCache(const VariantMap& parameters, bool removeOl
             cache->RemovePackageFile(packageFiles[i].Get());
     }
 
+    cache->SetMemoryMapPackages(GetParameter(parameters, EP_MEMORY_MAP_PACKAGES, false).GetBool());
+
     // Add resource paths
     ea::vector<ea::string> resourcePrefixPaths = GetParameter(parameters, EP_RESOURCE_PREFIX_PATHS,
         EMPTY_STRING).GetString().split(';', true);
@@ -514,15 +611,23 @@ void Engine::RunFrame()
     auto* time = GetSubsystem<Time>();
     auto* input = GetSubsystem<Input>();
     auto* audio = GetSubsystem<Audio>();
+    auto* hitchDetector = GetSubsystem<HitchDetector>();
+    auto* governor = GetSubsystem<PerformanceGovernor>();
 
+    HiresTimer phaseTimer;
+    long long updateTime = 0;
+    long long renderTime = 0;
     {
         URHO3D_PROFILE("DoFrame");
         time->BeginFrame(timeStep_);
 
+        // Work that overlapped rendering of the previous frame has to be done before the scene is updated again
+        CompletePipelinedWork();
+
         // If pause when minimized -mode is in use, stop updates and audio as necessary
         if (pauseMinimized_ && input->IsMinimized())
         {
-            if (audio->IsPlaying())
+            if (audio && audio->IsPlaying())
             {
                 audio->Stop();
                 audioPaused_ = true;
@@ -531,7 +636,7 @@ void Engine::RunFrame()
         else
         {
             // Only unpause when it was paused by the engine
-            if (audioPaused_)
+            if (audioPaused_ && audio)
             {
                 audio->Play();
                 audioPaused_ = false;
@@ -539,13 +644,27 @@ void Engine::RunFrame()
 
             Update();
         }
+        DispatchPipelinedWork();
+        if (!pipelinedFrame_)
+            CompletePipelinedWork();
+        updateTime = phaseTimer.GetUSec(true);
 
         Render();
+        renderTime = phaseTimer.GetUSec(true);
+        if (auto* renderer = GetSubsystem<Renderer>())
+            renderer->UpdateDynamicResolution(renderTime / 1000000.0f);
     }
     ApplyFrameLimit();
 
+    if (hitchDetector)
+        hitchDetector->EndFrame(time->GetFrameNumber(), updateTime, renderTime, phaseTimer.GetUSec(false));
+    if (governor)
+        governor->EndFrame(updateTime, renderTime);
+
     time->EndFrame();
 
+    EndAllocationStatsFrame();
+
     // Mark a frame for profiling
     URHO3D_PROFILE_FRAME();
 }
@@ -749,6 +868,9 @@ void Engine::Render()
     if (!graphics->BeginFrame())
         return;
 
+    // Execute GPU uploads queued by background loading and worker jobs
+    graphics->ProcessUploads();
+
     GetSubsystem<Renderer>()->Render();
 
     // Render UI after scene is rendered, but only do so if user has not rendered it manually
@@ -763,11 +885,63 @@ void Engine::Render()
     graphics->EndFrame();
 }
 
+void Engine::SetTickRate(int rate)
+{
+    tickRate_ = (unsigned)Max(rate, 0);
+    tickDebt_ = 0;
+    numTickOverruns_ = 0;
+}
+
+void Engine::SetPipelinedFrame(bool enable)
+{
+    if (!enable)
+        CompletePipelinedWork();
+    pipelinedFrame_ = enable;
+}
+
+void Engine::QueuePipelinedWork(std::function<void()> work)
+{
+    assert(Thread::IsMainThread());
+    pipelinedWork_.push_back(std::move(work));
+}
+
+void Engine::DispatchPipelinedWork()
+{
+    if (pipelinedWork_.empty())
+        return;
+
+    URHO3D_PROFILE("DispatchPipelinedWork");
+
+    // Rendering work uses the maximum priority, so it is taken first and its completion never waits for pipelined work
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    for (std::function<void()>& work : pipelinedWork_)
+        workQueue->AddWorkItem(std::move(work), PIPELINED_WORK_PRIORITY);
+    pipelinedWork_.clear();
+    pipelinedWorkPending_ = true;
+}
+
+void Engine::CompletePipelinedWork()
+{
+    if (!pipelinedWorkPending_)
+        return;
+
+    URHO3D_PROFILE("CompletePipelinedWork");
+
+    GetSubsystem<WorkQueue>()->Complete(PIPELINED_WORK_PRIORITY);
+    pipelinedWorkPending_ = false;
+}
+
 void Engine::ApplyFrameLimit()
 {
     if (!initialized_)
         return;
 
+    if (tickRate_)
+    {
+        ApplyTickLimit();
+        return;
+    }
+
     unsigned maxFps = maxFps_;
     auto* input = GetSubsystem<Input>();
     if (input && !input->HasFocus())
@@ -838,6 +1012,49 @@ void Engine::ApplyFrameLimit()
         timeStep_ = lastTimeSteps_.back();
 }
 
+void Engine::ApplyTickLimit()
+{
+    URHO3D_PROFILE("ApplyTickLimit");
+
+    const long long tickTime = 1000000LL / tickRate_;
+    // Make up for the previous tick being late, so that the average rate stays exact
+    const long long targetTime = tickTime - tickDebt_;
+
+    tickWorkTime_ = frameTimer_.GetUSec(false);
+    if (tickWorkTime_ > tickTime)
+        ++numTickOverruns_;
+
+    long long elapsed;
+    for (;;)
+    {
+        elapsed = frameTimer_.GetUSec(false);
+        if (elapsed >= targetTime)
+            break;
+
+        // OS sleep may overshoot by a millisecond or more, so sleep only well before the deadline and yield for the rest
+        const long long remaining = targetTime - elapsed;
+        if (remaining >= 2000LL)
+            Time::Sleep((unsigned)(remaining / 1000LL - 1));
+        else
+            std::this_thread::yield();
+    }
+
+    elapsed = frameTimer_.GetUSec(true);
+    tickDebt_ = Clamp(elapsed - targetTime, 0LL, tickTime);
+#ifdef URHO3D_TESTING
+    if (timeOut_ > 0)
+    {
+        timeOut_ -= elapsed;
+        if (timeOut_ <= 0)
+            Exit();
+    }
+#endif
+
+    // Simulation advances by exactly one tick regardless of the measured time
+    timeStep_ = 1.0f / tickRate_;
+    lastTimeSteps_.clear();
+}
+
 #if DESKTOP
 void Engine::DefineParameters(CLI::App& commandLine, VariantMap& engineParameters)
 {
@@ -905,7 +1122,7 @@ void Engine::DefineParameters(CLI::App& commandLine, VariantMap& engineParameter
         return ToString(format, ea::string::joined(items, "|").to_lower().replaced('_', '-').c_str());
     };
 
-    addFlag("--headless", EP_HEADLESS, true, "Do not initialize graphics subsystem");
+    addFlag("--headless", EP_HEADLESS, true, "Do not initialize graphics and audio subsystems");
     addFlag("--nolimit", EP_FRAME_LIMITER, false, "Disable frame limiter");
     addFlag("--flushgpu", EP_FLUSH_GPU, true, "Enable GPU flushing");
     addFlag("--gl2", EP_FORCE_GL2, true, "Force OpenGL2");
@@ -939,6 +1156,7 @@ void Engine::DefineParameters(CLI::App& commandLine, VariantMap& engineParameter
         return true;
     })->set_custom_option(createOptions("string in {%s}", logLevelNames).c_str());
     addOptionString("--log-file", EP_LOG_NAME, "Log output file");
+    addFlag("--log-async", EP_LOG_ASYNC, true, "Write log output from a background thread");
     addOptionInt("-x,--width", EP_WINDOW_WIDTH, "Window width");
     addOptionInt("-y,--height", EP_WINDOW_HEIGHT, "Window height");
     addOptionInt("--monitor", EP_MONITOR, "Create window on the specified monitor");
@@ -949,6 +1167,7 @@ void Engine::DefineParameters(CLI::App& commandLine, VariantMap& engineParameter
     addOptionString("--pp,--prefix-paths", EP_RESOURCE_PREFIX_PATHS, "Resource prefix paths")->envname("URHO3D_PREFIX_PATH")->set_custom_option("path1;path2;...");
     addOptionString("--pr,--resource-paths", EP_RESOURCE_PATHS, "Resource paths")->set_custom_option("path1;path2;...");
     addOptionString("--pf,--resource-packages", EP_RESOURCE_PACKAGES, "Resource packages")->set_custom_option("path1;path2;...");
+    addFlag("--mmap-packages", EP_MEMORY_MAP_PACKAGES, true, "Map resource packages to memory");
     addOptionString("--ap,--autoload-paths", EP_AUTOLOAD_PATHS, "Resource autoload paths")->set_custom_option("path1;path2;...");
     addOptionString("--ds,--dump-shaders", EP_DUMP_SHADERS, "Dump shaders")->set_custom_option("filename");
     addFlagInternal("--mq,--material-quality", "Material quality", [&](CLI::results_t res) {
@@ -987,6 +1206,14 @@ void Engine::DefineParameters(CLI::App& commandLine, VariantMap& engineParameter
         return false;
     })->set_custom_option("int");
     addFlag("--touch", EP_TOUCH_EMULATION, true, "Enable touch emulation");
+    addOptionInt("--tick-rate", EP_TICK_RATE, "Run frames at a fixed tick rate");
+    addFlag("--pipelined", EP_PIPELINED_FRAME, true, "Overlap pipelined work with rendering");
+    addOptionString("--replay-record", EP_REPLAY_RECORD, "Record input and time steps into replay file");
+    addOptionString("--replay-play", EP_REPLAY_PLAY, "Play back replay file and exit when finished");
+    addOptionString("--replay-report", EP_REPLAY_REPORT, "Write frame time report of replay playback into JSON file");
+    addOptionInt("--hitch-threshold", EP_HITCH_THRESHOLD, "Report frames slower than specified milliseconds, 0 to disable");
+    addOptionString("--hitch-dump-dir", EP_HITCH_DUMP_DIR, "Save JSON reports of frames around hitches into directory");
+    addOptionInt("--quality-target-frame-time", EP_QUALITY_TARGET_FRAME_TIME, "Scale quality settings to hold specified milliseconds per frame");
 #ifdef URHO3D_TESTING
     addOptionInt("--timeout", EP_TIME_OUT, "Quit application after specified time");
 #endif
@@ -1023,6 +1250,12 @@ void Engine::HandleEndFrame(StringHash eventType, VariantMap& eventData)
 
 void Engine::DoExit()
 {
+    CompletePipelinedWork();
+
+    // Finish recording while the file system is still available
+    if (auto* replay = GetSubsystem<FrameReplay>())
+        replay->Stop();
+
     auto* graphics = GetSubsystem<Graphics>();
     if (graphics)
         graphics->Close();
@@ -25,6 +25,8 @@
 #include "../Core/Object.h"
 #include "../Core/Timer.h"
 
+#include <functional>
+
 namespace CLI
 {
 
@@ -77,6 +79,15 @@ public:
     /// Set whether to exit automatically on exit request (window close button).
     /// @property
     void SetAutoExit(bool enable);
+    /// Set fixed tick rate. Frames then run at exactly this rate with a constant timestep, using precise waiting, as suited for dedicated servers. Zero (default) uses the variable rate frame limiter.
+    /// @property
+    void SetTickRate(int rate);
+    /// Set whether work queued with QueuePipelinedWork() overlaps rendering of the frame and completes before the next frame update. Results of that work then arrive one frame later.
+    /// @property
+    void SetPipelinedFrame(bool enable);
+    /// Queue work to run on worker threads after the frame update. The work must not touch scene data read by rendering and runs in parallel with rendering in pipelined frame mode, otherwise it completes before rendering. Must be called from the main thread.
+    /// @nobind
+    void QueuePipelinedWork(std::function<void()> work);
     /// Override timestep of the next frame. Should be called in between RunFrame() calls.
     void SetNextTimeStep(float seconds);
     /// Close the graphics window and set the exit flag. No-op on iOS/tvOS, as an iOS/tvOS application can not legally exit.
@@ -106,6 +117,26 @@ public:
     /// @property
     int GetMaxInactiveFps() const { return maxInactiveFps_; }
 
+    /// Return fixed tick rate, or zero if not used.
+    /// @property
+    int GetTickRate() const { return tickRate_; }
+
+    /// Return time in microseconds spent on the last tick before waiting for the next one.
+    /// @property
+    long long GetTickWorkTime() const { return tickWorkTime_; }
+
+    /// Return fraction of the tick budget used by the last tick. Values over 1 mean the tick overran.
+    /// @property
+    float GetTickBudgetUsage() const { return tickRate_ ? tickWorkTime_ * tickRate_ / 1000000.0f : 0.0f; }
+
+    /// Return number of ticks that overran their budget since the tick rate was set.
+    /// @property
+    unsigned GetNumTickOverruns() const { return numTickOverruns_; }
+
+    /// Return whether pipelined frame mode is enabled.
+    /// @property
+    bool GetPipelinedFrame() const { return pipelinedFrame_; }
+
     /// Return how many frames to average for timestep smoothing.
     /// @property
     int GetTimeStepSmoothing() const { return timeStepSmoothing_; }
@@ -136,6 +167,12 @@ public:
     void Render();
     /// Get the timestep for the next frame and sleep for frame limiting if necessary.
     void ApplyFrameLimit();
+    /// Wait for the next tick when a fixed tick rate is set. Called by ApplyFrameLimit().
+    void ApplyTickLimit();
+    /// Hand work queued during the frame update over to worker threads.
+    void DispatchPipelinedWork();
+    /// Wait until dispatched pipelined work is finished.
+    void CompletePipelinedWork();
 
 #if DESKTOP
     /// Parse the engine startup parameters map from command line arguments.
@@ -171,6 +208,20 @@ private:
     unsigned maxFps_;
     /// Maximum frames per second when the application does not have input focus.
     unsigned maxInactiveFps_;
+    /// Fixed tick rate.
+    unsigned tickRate_{};
+    /// Time in microseconds the last tick was late, subtracted from the next tick's wait.
+    long long tickDebt_{};
+    /// Time in microseconds spent on the last tick.
+    long long tickWorkTime_{};
+    /// Number of overrun ticks.
+    unsigned numTickOverruns_{};
+    /// Pipelined frame mode flag.
+    bool pipelinedFrame_{};
+    /// Work queued during the frame update.
+    ea::vector<std::function<void()>> pipelinedWork_;
+    /// Whether dispatched pipelined work may still be running.
+    bool pipelinedWorkPending_{};
     /// Pause when minimized flag.
     bool pauseMinimized_;
 #ifdef URHO3D_TESTING
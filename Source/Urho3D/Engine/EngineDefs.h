@@ -40,19 +40,29 @@ static const ea::string EP_FRAME_LIMITER = "FrameLimiter";
 static const ea::string EP_FULL_SCREEN = "FullScreen";
 static const ea::string EP_HEADLESS = "Headless";
 static const ea::string EP_HIGH_DPI = "HighDPI";
+static const ea::string EP_HITCH_DUMP_DIR = "HitchDumpDir";
+static const ea::string EP_HITCH_THRESHOLD = "HitchThreshold";
+static const ea::string EP_LOG_ASYNC = "LogAsync";
 static const ea::string EP_LOG_LEVEL = "LogLevel";
 static const ea::string EP_LOG_NAME = "LogName";
 static const ea::string EP_LOG_QUIET = "LogQuiet";
 static const ea::string EP_LOW_QUALITY_SHADOWS = "LowQualityShadows";
 static const ea::string EP_MATERIAL_QUALITY = "MaterialQuality";
+static const ea::string EP_MAIN_THREAD_AFFINITY = "MainThreadAffinity";
+static const ea::string EP_MEMORY_MAP_PACKAGES = "MemoryMapPackages";
 static const ea::string EP_MONITOR = "Monitor";
 static const ea::string EP_MULTI_SAMPLE = "MultiSample";
 static const ea::string EP_ORGANIZATION_NAME = "OrganizationName";
 static const ea::string EP_APPLICATION_NAME = "ApplicationName";
 static const ea::string EP_ORIENTATIONS = "Orientations";
 static const ea::string EP_PACKAGE_CACHE_DIR = "PackageCacheDir";
+static const ea::string EP_PIPELINED_FRAME = "PipelinedFrame";
+static const ea::string EP_QUALITY_TARGET_FRAME_TIME = "QualityTargetFrameTime";
 static const ea::string EP_RENDER_PATH = "RenderPath";
 static const ea::string EP_REFRESH_RATE = "RefreshRate";
+static const ea::string EP_REPLAY_PLAY = "ReplayPlay";
+static const ea::string EP_REPLAY_RECORD = "ReplayRecord";
+static const ea::string EP_REPLAY_REPORT = "ReplayReport";
 static const ea::string EP_RESOURCE_PACKAGES = "ResourcePackages";
 static const ea::string EP_RESOURCE_PATHS = "ResourcePaths";
 static const ea::string EP_RESOURCE_PREFIX_PATHS = "ResourcePrefixPaths";
@@ -66,6 +76,7 @@ static const ea::string EP_SOUND_STEREO = "SoundStereo";
 static const ea::string EP_TEXTURE_ANISOTROPY = "TextureAnisotropy";
 static const ea::string EP_TEXTURE_FILTER_MODE = "TextureFilterMode";
 static const ea::string EP_TEXTURE_QUALITY = "TextureQuality";
+static const ea::string EP_TICK_RATE = "TickRate";
 static const ea::string EP_TIME_OUT = "TimeOut";
 static const ea::string EP_TOUCH_EMULATION = "TouchEmulation";
 static const ea::string EP_TRIPLE_BUFFER = "TripleBuffer";
@@ -51,6 +51,21 @@ URHO3D_EVENT(E_APPLICATIONSTARTED, ApplicationStarted)
 {
 }
 
+/// A frame took longer than the hitch detector threshold.
+URHO3D_EVENT(E_FRAMEHITCH, FrameHitch)
+{
+    URHO3D_PARAM(P_FRAMENUMBER, FrameNumber);      // unsigned
+    URHO3D_PARAM(P_FRAMETIME, FrameTime);          // float, milliseconds
+    URHO3D_PARAM(P_CAUSES, Causes);                // unsigned, HitchCauseFlags
+}
+
+/// Performance governor changed the level of a quality knob.
+URHO3D_EVENT(E_QUALITYKNOBCHANGED, QualityKnobChanged)
+{
+    URHO3D_PARAM(P_NAME, Name);                    // String
+    URHO3D_PARAM(P_LEVEL, Level);                  // unsigned
+}
+
 /// Plugin::Load() is about to get called.
 URHO3D_EVENT(E_PLUGINLOAD, PluginLoad)
 {
@@ -0,0 +1,349 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/CoreEvents.h"
+#include "../Engine/Engine.h"
+#include "../Engine/FrameReplay.h"
+#include "../Input/Input.h"
+#include "../IO/File.h"
+#include "../IO/Log.h"
+#include "../Math/Random.h"
+#include "../Resource/JSONFile.h"
+
+#include <EASTL/sort.h>
+
+#include <SDL/SDL.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+static const char* REPLAY_FILE_ID = "URPL";
+static const unsigned REPLAY_VERSION = 1;
+
+/// Return whether the event is user input that is recorded and replayed. Events carrying pointers are never recorded.
+static bool IsReplayedEvent(const SDL_Event& evt)
+{
+    switch (evt.type)
+    {
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+    case SDL_TEXTEDITING:
+    case SDL_TEXTINPUT:
+    case SDL_MOUSEMOTION:
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+    case SDL_MOUSEWHEEL:
+    case SDL_JOYAXISMOTION:
+    case SDL_JOYHATMOTION:
+    case SDL_JOYBUTTONDOWN:
+    case SDL_JOYBUTTONUP:
+    case SDL_CONTROLLERAXISMOTION:
+    case SDL_CONTROLLERBUTTONDOWN:
+    case SDL_CONTROLLERBUTTONUP:
+    case SDL_FINGERDOWN:
+    case SDL_FINGERUP:
+    case SDL_FINGERMOTION:
+        return true;
+    default:
+        return false;
+    }
+}
+
+FrameReplay::FrameReplay(Context* context)
+    : Object(context)
+{
+    if (auto* input = GetSubsystem<Input>())
+        input->OnRawInput.Subscribe(this, RawInputPriority::Highest, &FrameReplay::OnRawInput);
+}
+
+FrameReplay::~FrameReplay()
+{
+    if (auto* input = GetSubsystem<Input>())
+        input->OnRawInput.Unsubscribe(this);
+}
+
+void FrameReplay::StartRecording(const ea::string& fileName)
+{
+    Stop();
+
+    frames_.clear();
+    pendingEvents_.clear();
+    recordFileName_ = fileName;
+
+    // Random sequence is restored on playback
+    randomSeed_ = GetRandomSeed();
+    recording_ = true;
+
+    SubscribeToEvent(E_BEGINFRAME, URHO3D_HANDLER(FrameReplay, HandleBeginFrame));
+    SubscribeToEvent(E_ENDFRAME, URHO3D_HANDLER(FrameReplay, HandleEndFrame));
+}
+
+bool FrameReplay::StartPlayback(const ea::string& reportFileName)
+{
+    Stop();
+
+    if (frames_.empty())
+    {
+        URHO3D_LOGERROR("Can not play back empty replay");
+        return false;
+    }
+
+    auto* engine = GetSubsystem<Engine>();
+    reportFileName_ = reportFileName;
+    playbackFrame_ = 0;
+    frameTimes_.clear();
+    frameTimes_.reserve(frames_.size());
+    playing_ = true;
+
+    // Recorded time steps replace the measured ones, so run unthrottled to measure actual frame cost
+    savedMaxFps_ = engine->GetMaxFps();
+    savedTickRate_ = engine->GetTickRate();
+    engine->SetTickRate(0);
+    engine->SetMaxFps(0);
+    engine->SetNextTimeStep(frames_[0].timeStep_);
+    SetRandomSeed(randomSeed_);
+    frameTimer_.Reset();
+
+    SubscribeToEvent(E_INPUTEND, URHO3D_HANDLER(FrameReplay, HandleInputEnd));
+    SubscribeToEvent(E_ENDFRAME, URHO3D_HANDLER(FrameReplay, HandleEndFrame));
+    return true;
+}
+
+void FrameReplay::Stop()
+{
+    if (recording_)
+    {
+        recording_ = false;
+        UnsubscribeFromAllEvents();
+
+        if (!recordFileName_.empty())
+            SaveFile(recordFileName_);
+    }
+
+    if (playing_)
+        FinishPlayback();
+}
+
+bool FrameReplay::SaveFile(const ea::string& fileName) const
+{
+    File file(context_);
+    if (!file.Open(fileName, FILE_WRITE) || !Save(file))
+    {
+        URHO3D_LOGERROR("Could not save replay '{}'", fileName);
+        return false;
+    }
+
+    URHO3D_LOGINFO("Saved replay of {} frames to '{}'", frames_.size(), fileName);
+    return true;
+}
+
+bool FrameReplay::LoadFile(const ea::string& fileName)
+{
+    File file(context_);
+    if (!file.Open(fileName, FILE_READ) || !Load(file))
+    {
+        URHO3D_LOGERROR("Could not load replay '{}'", fileName);
+        return false;
+    }
+    return true;
+}
+
+bool FrameReplay::Save(Serializer& dest) const
+{
+    if (!dest.WriteFileID(REPLAY_FILE_ID))
+        return false;
+
+    dest.WriteUInt(REPLAY_VERSION);
+    dest.WriteUInt(sizeof(SDL_Event));
+    dest.WriteUInt(randomSeed_);
+    dest.WriteVLE(frames_.size());
+    for (const ReplayFrame& frame : frames_)
+    {
+        dest.WriteFloat(frame.timeStep_);
+        dest.WriteVLE(frame.events_.size() / sizeof(SDL_Event));
+        if (!frame.events_.empty() && dest.Write(frame.events_.data(), frame.events_.size()) != frame.events_.size())
+            return false;
+    }
+    return true;
+}
+
+bool FrameReplay::Load(Deserializer& source)
+{
+    if (source.ReadFileID() != REPLAY_FILE_ID)
+    {
+        URHO3D_LOGERROR("{} is not a valid replay file", source.GetName());
+        return false;
+    }
+
+    // Events are stored as raw SDL structures, so the replay is only valid for the same SDL build
+    const unsigned version = source.ReadUInt();
+    const unsigned eventSize = source.ReadUInt();
+    if (version != REPLAY_VERSION || eventSize != sizeof(SDL_Event))
+    {
+        URHO3D_LOGERROR("Replay {} has incompatible version or event format", source.GetName());
+        return false;
+    }
+
+    Stop();
+
+    randomSeed_ = source.ReadUInt();
+    frames_.resize(source.ReadVLE());
+    for (ReplayFrame& frame : frames_)
+    {
+        frame.timeStep_ = source.ReadFloat();
+        frame.events_.resize(source.ReadVLE() * sizeof(SDL_Event));
+        if (!frame.events_.empty() && source.Read(frame.events_.data(), frame.events_.size()) != frame.events_.size())
+        {
+            frames_.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FrameReplay::SaveReport(const ea::string& fileName) const
+{
+    if (frameTimes_.empty())
+        return false;
+
+    ea::vector<float> sortedTimes = frameTimes_;
+    ea::sort(sortedTimes.begin(), sortedTimes.end());
+    const auto percentile = [&](float fraction)
+    {
+        return sortedTimes[Min(static_cast<unsigned>(fraction * sortedTimes.size()), sortedTimes.size() - 1)] * 1000.0f;
+    };
+
+    float totalTime = 0.0f;
+    for (float frameTime : frameTimes_)
+        totalTime += frameTime;
+
+    JSONFile file(context_);
+    JSONValue& root = file.GetRoot();
+    root.Set("frames", frameTimes_.size());
+    root.Set("totalMs", totalTime * 1000.0f);
+    root.Set("meanMs", totalTime * 1000.0f / frameTimes_.size());
+    root.Set("minMs", sortedTimes.front() * 1000.0f);
+    root.Set("maxMs", sortedTimes.back() * 1000.0f);
+    root.Set("p50Ms", percentile(0.5f));
+    root.Set("p95Ms", percentile(0.95f));
+    root.Set("p99Ms", percentile(0.99f));
+
+    JSONValue frameTimesMs{JSON_ARRAY};
+    for (float frameTime : frameTimes_)
+        frameTimesMs.Push(frameTime * 1000.0f);
+    root.Set("frameTimesMs", frameTimesMs);
+
+    return file.SaveFile(fileName);
+}
+
+void FrameReplay::OnRawInput(SDL_Event& evt, bool& consumed)
+{
+    if (consumed || injecting_ || !IsReplayedEvent(evt))
+        return;
+
+    if (recording_)
+    {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(&evt);
+        pendingEvents_.insert(pendingEvents_.end(), bytes, bytes + sizeof(SDL_Event));
+    }
+    else if (playing_)
+    {
+        // Live input would make the session diverge from the recording
+        consumed = true;
+    }
+}
+
+void FrameReplay::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
+{
+    using namespace BeginFrame;
+
+    ReplayFrame& frame = frames_.emplace_back();
+    frame.timeStep_ = eventData[P_TIMESTEP].GetFloat();
+}
+
+void FrameReplay::HandleInputEnd(StringHash eventType, VariantMap& eventData)
+{
+    // Inject recorded events after the input update has reset accumulated state, so that they are seen by this frame
+    auto* input = GetSubsystem<Input>();
+    const ea::vector<unsigned char>& events = frames_[playbackFrame_].events_;
+    injecting_ = true;
+    for (unsigned offset = 0; offset + sizeof(SDL_Event) <= events.size(); offset += sizeof(SDL_Event))
+    {
+        SDL_Event evt;
+        memcpy(&evt, events.data() + offset, sizeof(SDL_Event));
+        input->InjectSDLEvent(evt);
+    }
+    injecting_ = false;
+}
+
+void FrameReplay::HandleEndFrame(StringHash eventType, VariantMap& eventData)
+{
+    if (recording_)
+    {
+        if (!frames_.empty())
+            frames_.back().events_.swap(pendingEvents_);
+        pendingEvents_.clear();
+    }
+    else if (playing_)
+    {
+        // Measure whole frames between frame ends, including rendering and present
+        frameTimes_.push_back(frameTimer_.GetUSec(true) / 1000000.0f);
+
+        ++playbackFrame_;
+        if (playbackFrame_ < frames_.size())
+            GetSubsystem<Engine>()->SetNextTimeStep(frames_[playbackFrame_].timeStep_);
+        else
+            FinishPlayback();
+    }
+}
+
+void FrameReplay::FinishPlayback()
+{
+    playing_ = false;
+    UnsubscribeFromAllEvents();
+
+    auto* engine = GetSubsystem<Engine>();
+    engine->SetMaxFps(savedMaxFps_);
+    engine->SetTickRate(savedTickRate_);
+
+    if (!frameTimes_.empty())
+    {
+        float totalTime = 0.0f;
+        for (float frameTime : frameTimes_)
+            totalTime += frameTime;
+        URHO3D_LOGINFO("Replay finished: {} frames, {:.3f} ms average frame time", frameTimes_.size(),
+            totalTime * 1000.0f / frameTimes_.size());
+    }
+
+    if (!reportFileName_.empty() && !SaveReport(reportFileName_))
+        URHO3D_LOGERROR("Could not save replay report '{}'", reportFileName_);
+
+    if (exitOnFinish_)
+        engine->Exit();
+}
+
+}
@@ -0,0 +1,134 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#pragma once
+
+#include "../Core/Object.h"
+#include "../Core/Timer.h"
+
+#include <EASTL/vector.h>
+
+union SDL_Event;
+
+namespace Urho3D
+{
+
+class Deserializer;
+class Serializer;
+
+/// Recorded frame of a replay.
+struct ReplayFrame
+{
+    /// Frame time step in seconds.
+    float timeStep_{};
+    /// Raw input events received during the frame. Stored as raw bytes of SDL_Event.
+    ea::vector<unsigned char> events_;
+};
+
+/// Records time steps and input events of a session and plays them back deterministically, measuring frame times.
+class URHO3D_API FrameReplay : public Object
+{
+    URHO3D_OBJECT(FrameReplay, Object);
+
+public:
+    /// Construct.
+    explicit FrameReplay(Context* context);
+    /// Destruct.
+    ~FrameReplay() override;
+
+    /// Start recording. Previously recorded frames are discarded. If file name is not empty, the replay is saved there when stopped.
+    void StartRecording(const ea::string& fileName = EMPTY_STRING);
+    /// Start playback of loaded frames. Should be called between frames, e.g. on application start. If report file name is not empty, frame time report is saved there when playback ends.
+    bool StartPlayback(const ea::string& reportFileName = EMPTY_STRING);
+    /// Stop recording or playback.
+    void Stop();
+    /// Set whether to exit the engine when playback ends.
+    void SetExitOnFinish(bool enable) { exitOnFinish_ = enable; }
+
+    /// Save recorded frames to file. Return true if successful.
+    bool SaveFile(const ea::string& fileName) const;
+    /// Load frames from file. Return true if successful.
+    bool LoadFile(const ea::string& fileName);
+    /// Save recorded frames to stream. Return true if successful.
+    bool Save(Serializer& dest) const;
+    /// Load frames from stream. Return true if successful.
+    bool Load(Deserializer& source);
+    /// Save frame time report of the last playback as JSON. Return true if successful.
+    bool SaveReport(const ea::string& fileName) const;
+
+    /// Return whether recording.
+    bool IsRecording() const { return recording_; }
+    /// Return whether playing back.
+    bool IsPlaying() const { return playing_; }
+    /// Return whether to exit the engine when playback ends.
+    bool GetExitOnFinish() const { return exitOnFinish_; }
+    /// Return recorded or loaded frames.
+    const ea::vector<ReplayFrame>& GetFrames() const { return frames_; }
+    /// Return index of the frame being played back.
+    unsigned GetPlaybackFrame() const { return playbackFrame_; }
+    /// Return measured frame times in seconds of the last playback.
+    const ea::vector<float>& GetFrameTimes() const { return frameTimes_; }
+
+private:
+    /// Handle raw input event.
+    void OnRawInput(SDL_Event& evt, bool& consumed);
+    /// Handle frame begin when recording.
+    void HandleBeginFrame(StringHash eventType, VariantMap& eventData);
+    /// Handle input update end when playing back.
+    void HandleInputEnd(StringHash eventType, VariantMap& eventData);
+    /// Handle frame end.
+    void HandleEndFrame(StringHash eventType, VariantMap& eventData);
+    /// Finish playback: restore engine settings and save report.
+    void FinishPlayback();
+
+    /// Frames.
+    ea::vector<ReplayFrame> frames_;
+    /// Input events of the frame being recorded.
+    ea::vector<unsigned char> pendingEvents_;
+    /// Random seed at the beginning of recording.
+    unsigned randomSeed_{};
+    /// Recording flag.
+    bool recording_{};
+    /// Playback flag.
+    bool playing_{};
+    /// Whether events are being injected by playback.
+    bool injecting_{};
+    /// Exit the engine when playback ends.
+    bool exitOnFinish_{};
+    /// File to save recording to.
+    ea::string recordFileName_;
+    /// File to save playback report to.
+    ea::string reportFileName_;
+    /// Index of the frame being played back.
+    unsigned playbackFrame_{};
+    /// Engine frame limit before playback.
+    int savedMaxFps_{};
+    /// Engine tick rate before playback.
+    int savedTickRate_{};
+    /// Timer measuring played back frames.
+    HiresTimer frameTimer_;
+    /// Measured frame times of the last playback.
+    ea::vector<float> frameTimes_;
+};
+
+}
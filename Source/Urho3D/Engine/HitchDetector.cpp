@@ -0,0 +1,212 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Profiler.h"
+#include "../Engine/EngineEvents.h"
+#include "../Engine/HitchDetector.h"
+#include "../Graphics/Graphics.h"
+#include "../IO/FileSystem.h"
+#include "../IO/Log.h"
+#ifdef URHO3D_NETWORK
+#include "../Network/Network.h"
+#endif
+#include "../Resource/JSONFile.h"
+#include "../Resource/ResourceCache.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+static const unsigned DEFAULT_HITCH_HISTORY_SIZE = 120;
+
+static const char* hitchCauseNames[] =
+{
+    "ShaderCompile",
+    "ResourceLoad",
+    "NetworkBacklog",
+    "GarbageCollection",
+    nullptr
+};
+
+HitchDetector::HitchDetector(Context* context) :
+    Object(context)
+{
+    SetHistorySize(DEFAULT_HITCH_HISTORY_SIZE);
+}
+
+HitchDetector::~HitchDetector() = default;
+
+void HitchDetector::SetFramesAfterHitch(unsigned numFrames)
+{
+    framesAfterHitch_ = numFrames;
+    SetHistorySize(historySize_);
+}
+
+void HitchDetector::SetHistorySize(unsigned numFrames)
+{
+    historySize_ = Max(numFrames, 1U);
+    // Frames after the hitch are kept in the same buffer
+    frames_.clear();
+    frames_.resize(historySize_ + framesAfterHitch_);
+    nextFrame_ = 0;
+    numFrames_ = 0;
+    hitchPending_ = false;
+}
+
+void HitchDetector::EndFrame(unsigned frameNumber, long long updateUSec, long long renderUSec, long long limiterUSec)
+{
+    if (thresholdMs_ <= 0.0f)
+        return;
+
+    FrameTimingSample& sample = frames_[nextFrame_];
+    sample.frameNumber_ = frameNumber;
+    sample.updateMs_ = updateUSec / 1000.0f;
+    sample.renderMs_ = renderUSec / 1000.0f;
+    sample.limiterMs_ = limiterUSec / 1000.0f;
+    sample.causes_ = pendingCauses_;
+    pendingCauses_ = HITCH_CAUSE_NONE;
+
+    auto* graphics = GetSubsystem<Graphics>();
+    sample.numShaderCompiles_ = graphics ? graphics->GetFrameStatistics().numShaderCompiles_ : 0;
+    if (sample.numShaderCompiles_)
+        sample.causes_ |= HITCH_CAUSE_SHADER_COMPILE;
+
+    auto* cache = GetSubsystem<ResourceCache>();
+    const unsigned numSyncLoads = cache ? cache->GetNumSyncLoads() : 0;
+    sample.numResourceLoads_ = numSyncLoads - lastNumSyncLoads_;
+    lastNumSyncLoads_ = numSyncLoads;
+    if (sample.numResourceLoads_)
+        sample.causes_ |= HITCH_CAUSE_RESOURCE_LOAD;
+
+    sample.numNetworkPackets_ = 0;
+#ifdef URHO3D_NETWORK
+    if (auto* network = GetSubsystem<Network>())
+        sample.numNetworkPackets_ = network->GetNumProcessedPackets();
+#endif
+    if (networkBacklogPackets_ && sample.numNetworkPackets_ >= networkBacklogPackets_)
+        sample.causes_ |= HITCH_CAUSE_NETWORK_BACKLOG;
+
+    nextFrame_ = (nextFrame_ + 1) % frames_.size();
+    numFrames_ = Min(numFrames_ + 1, static_cast<unsigned>(frames_.size()));
+
+    const float workMs = sample.GetWorkMs();
+    if (workMs > thresholdMs_)
+    {
+        ++numHitches_;
+
+        ea::string causes;
+        for (unsigned i = 0; hitchCauseNames[i]; ++i)
+        {
+            if (!(sample.causes_.AsInteger() & (1u << i)))
+                continue;
+            if (!causes.empty())
+                causes += " ";
+            causes += hitchCauseNames[i];
+        }
+        const ea::string message = Format("Frame {} hitch {:.1f} ms (update {:.1f} ms, render {:.1f} ms) {}", frameNumber,
+            workMs, sample.updateMs_, sample.renderMs_, causes.empty() ? "unknown cause" : causes.c_str());
+        URHO3D_LOGWARNING(message);
+        URHO3D_PROFILE_MESSAGE(message.c_str(), message.length());
+
+        // Keep recording until the frames after the hitch are captured. A later hitch in that window is part of the same dump
+        if (!hitchPending_)
+        {
+            hitchPending_ = true;
+            pendingHitchFrame_ = frameNumber;
+            pendingFramesLeft_ = framesAfterHitch_ + 1;
+        }
+
+        using namespace FrameHitch;
+        VariantMap& eventData = GetEventDataMap();
+        eventData[P_FRAMENUMBER] = frameNumber;
+        eventData[P_FRAMETIME] = workMs;
+        eventData[P_CAUSES] = sample.causes_.AsInteger();
+        SendEvent(E_FRAMEHITCH, eventData);
+    }
+
+    if (hitchPending_ && --pendingFramesLeft_ == 0)
+    {
+        hitchPending_ = false;
+        if (!dumpDir_.empty())
+        {
+            auto* fileSystem = GetSubsystem<FileSystem>();
+            const ea::string dir = AddTrailingSlash(dumpDir_);
+            fileSystem->CreateDirsRecursive(dir);
+
+            const ea::string fileName = Format("{}Hitch_{}.json", dir, pendingHitchFrame_);
+            if (SaveReport(fileName, pendingHitchFrame_))
+                lastReportFileName_ = fileName;
+            else
+                URHO3D_LOGERROR("Could not save hitch report '{}'", fileName);
+        }
+    }
+}
+
+ea::vector<FrameTimingSample> HitchDetector::GetRecentFrames() const
+{
+    ea::vector<FrameTimingSample> result;
+    result.reserve(numFrames_);
+    const unsigned first = (nextFrame_ + frames_.size() - numFrames_) % frames_.size();
+    for (unsigned i = 0; i < numFrames_; ++i)
+        result.push_back(frames_[(first + i) % frames_.size()]);
+    return result;
+}
+
+bool HitchDetector::SaveReport(const ea::string& fileName, unsigned hitchFrameNumber) const
+{
+    JSONFile file(context_);
+    JSONValue& root = file.GetRoot();
+    root.Set("hitchFrame", hitchFrameNumber);
+    root.Set("thresholdMs", thresholdMs_);
+
+    JSONValue frames{JSON_ARRAY};
+    for (const FrameTimingSample& sample : GetRecentFrames())
+    {
+        JSONValue frame{JSON_OBJECT};
+        frame.Set("frame", sample.frameNumber_);
+        frame.Set("workMs", sample.GetWorkMs());
+        frame.Set("updateMs", sample.updateMs_);
+        frame.Set("renderMs", sample.renderMs_);
+        frame.Set("limiterMs", sample.limiterMs_);
+        frame.Set("shaderCompiles", sample.numShaderCompiles_);
+        frame.Set("resourceLoads", sample.numResourceLoads_);
+        frame.Set("networkPackets", sample.numNetworkPackets_);
+
+        JSONValue causes{JSON_ARRAY};
+        for (unsigned i = 0; hitchCauseNames[i]; ++i)
+        {
+            if (sample.causes_.AsInteger() & (1u << i))
+                causes.Push(hitchCauseNames[i]);
+        }
+        frame.Set("causes", causes);
+        frames.Push(frame);
+    }
+    root.Set("frames", frames);
+
+    return file.SaveFile(fileName);
+}
+
+}
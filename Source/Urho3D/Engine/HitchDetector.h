@@ -0,0 +1,165 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#pragma once
+
+#include "../Container/FlagSet.h"
+#include "../Core/Object.h"
+
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+/// Likely causes of a slow frame.
+enum HitchCause : unsigned
+{
+    HITCH_CAUSE_NONE = 0x0,
+    /// Shader variations were compiled on demand.
+    HITCH_CAUSE_SHADER_COMPILE = 0x1,
+    /// Resources were loaded synchronously on the main thread.
+    HITCH_CAUSE_RESOURCE_LOAD = 0x2,
+    /// Large amount of incoming network packets was processed.
+    HITCH_CAUSE_NETWORK_BACKLOG = 0x4,
+    /// Garbage collection in the script host, reported externally.
+    HITCH_CAUSE_GARBAGE_COLLECTION = 0x8,
+};
+URHO3D_FLAGSET(HitchCause, HitchCauseFlags);
+
+/// Timings and workload counters of a single frame.
+struct FrameTimingSample
+{
+    /// Frame number.
+    unsigned frameNumber_{};
+    /// Time spent in update events in milliseconds.
+    float updateMs_{};
+    /// Time spent in rendering in milliseconds.
+    float renderMs_{};
+    /// Time spent waiting in the frame limiter in milliseconds.
+    float limiterMs_{};
+    /// Number of shader variations compiled.
+    unsigned numShaderCompiles_{};
+    /// Number of resources loaded synchronously.
+    unsigned numResourceLoads_{};
+    /// Number of incoming network packets processed.
+    unsigned numNetworkPackets_{};
+    /// Detected causes.
+    HitchCauseFlags causes_;
+
+    /// Return frame work time excluding the frame limiter.
+    float GetWorkMs() const { return updateMs_ + renderMs_; }
+};
+
+/// Always-on detector of slow frames. Keeps a ring buffer of recent frame timings and dumps the frames around a hitch to JSON.
+class URHO3D_API HitchDetector : public Object
+{
+    URHO3D_OBJECT(HitchDetector, Object);
+
+public:
+    /// Construct.
+    explicit HitchDetector(Context* context);
+    /// Destruct.
+    ~HitchDetector() override;
+
+    /// Set frame work time in milliseconds above which a frame is a hitch. Zero disables detection.
+    /// @property
+    void SetThreshold(float thresholdMs) { thresholdMs_ = thresholdMs; }
+    /// Set number of frames kept before a hitch.
+    /// @property
+    void SetHistorySize(unsigned numFrames);
+    /// Set number of frames recorded after a hitch before it is dumped.
+    /// @property
+    void SetFramesAfterHitch(unsigned numFrames);
+    /// Set directory to dump hitch reports into. Reports are not saved if empty.
+    /// @property
+    void SetDumpDir(const ea::string& dir) { dumpDir_ = dir; }
+    /// Set number of network packets processed in one frame that is considered a backlog.
+    /// @property
+    void SetNetworkBacklogPackets(unsigned numPackets) { networkBacklogPackets_ = numPackets; }
+    /// Report a cause for the current frame that the engine can not detect itself, e.g. garbage collection.
+    void ReportCause(HitchCauseFlags causes) { pendingCauses_ |= causes; }
+
+    /// Record timings of the frame that just ended. Called by the engine.
+    void EndFrame(unsigned frameNumber, long long updateUSec, long long renderUSec, long long limiterUSec);
+
+    /// Return threshold in milliseconds.
+    /// @property
+    float GetThreshold() const { return thresholdMs_; }
+    /// Return number of frames kept before a hitch.
+    /// @property
+    unsigned GetHistorySize() const { return historySize_; }
+    /// Return number of frames recorded after a hitch.
+    /// @property
+    unsigned GetFramesAfterHitch() const { return framesAfterHitch_; }
+    /// Return dump directory.
+    /// @property
+    const ea::string& GetDumpDir() const { return dumpDir_; }
+    /// Return number of network packets considered a backlog.
+    /// @property
+    unsigned GetNetworkBacklogPackets() const { return networkBacklogPackets_; }
+    /// Return number of hitches detected so far.
+    /// @property
+    unsigned GetNumHitches() const { return numHitches_; }
+    /// Return file name of the last saved report.
+    /// @property
+    const ea::string& GetLastReportFileName() const { return lastReportFileName_; }
+    /// Return recent frames from oldest to newest.
+    ea::vector<FrameTimingSample> GetRecentFrames() const;
+
+    /// Save recent frames around a hitch as JSON. Return true if successful.
+    bool SaveReport(const ea::string& fileName, unsigned hitchFrameNumber) const;
+
+private:
+    /// Frame timing ring buffer.
+    ea::vector<FrameTimingSample> frames_;
+    /// Index of the next frame to write in the ring buffer.
+    unsigned nextFrame_{};
+    /// Number of valid frames in the ring buffer.
+    unsigned numFrames_{};
+    /// Hitch threshold in milliseconds.
+    float thresholdMs_{100.0f};
+    /// Frames kept before a hitch.
+    unsigned historySize_{};
+    /// Frames recorded after a hitch.
+    unsigned framesAfterHitch_{30};
+    /// Network packets per frame considered a backlog.
+    unsigned networkBacklogPackets_{256};
+    /// Dump directory.
+    ea::string dumpDir_;
+    /// Frame number of the hitch waiting to be dumped.
+    unsigned pendingHitchFrame_{};
+    /// Frames left to record before the pending hitch is dumped.
+    unsigned pendingFramesLeft_{};
+    /// Whether a hitch is waiting to be dumped.
+    bool hitchPending_{};
+    /// Externally reported causes for the current frame.
+    HitchCauseFlags pendingCauses_;
+    /// Number of hitches detected.
+    unsigned numHitches_{};
+    /// Resource cache synchronous load counter at the end of the previous frame.
+    unsigned lastNumSyncLoads_{};
+    /// Last saved report file name.
+    ea::string lastReportFileName_;
+};
+
+}
@@ -0,0 +1,358 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+#include "../Precompiled.h"
+
+#include "../Engine/EngineEvents.h"
+#include "../Engine/PerformanceGovernor.h"
+#include "../Graphics/Camera.h"
+#include "../Graphics/Graphics.h"
+#include "../Graphics/Renderer.h"
+#include "../IO/Log.h"
+#ifdef URHO3D_PHYSICS
+#include "../Physics/PhysicsWorld.h"
+#endif
+
+#include <EASTL/sort.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+/// Maximum growth of the restore delay after failed restores.
+static const unsigned MAX_RESTORE_BACKOFF = 16;
+/// Smallest shadow map size the governor selects.
+static const int MIN_SHADOW_MAP_SIZE = 256;
+
+/// Return median of samples. Reorders the samples.
+static float GetMedian(ea::vector<float>& samples)
+{
+    ea::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+/// Return the baseline followed by the candidates that are cheaper than it.
+template <class T, class Cheaper> static ea::vector<T> MakeLevels(T baseline, std::initializer_list<T> candidates, Cheaper isCheaper)
+{
+    ea::vector<T> levels{baseline};
+    for (T candidate : candidates)
+    {
+        if (isCheaper(candidate, levels.back()))
+            levels.push_back(candidate);
+    }
+    return levels;
+}
+
+PerformanceGovernor::PerformanceGovernor(Context* context) :
+    Object(context)
+{
+}
+
+PerformanceGovernor::~PerformanceGovernor() = default;
+
+void PerformanceGovernor::SetRestoreDelay(unsigned numEvaluations)
+{
+    restoreDelay_ = Max(numEvaluations, 1U);
+    currentRestoreDelay_ = restoreDelay_;
+}
+
+bool PerformanceGovernor::AddKnob(const ea::string& name, unsigned numLevels, int priority,
+    const std::function<void(unsigned level)>& apply, FrameBoundFlags bound)
+{
+    if (FindKnob(name))
+    {
+        URHO3D_LOGWARNING("Quality knob {} is already registered", name);
+        return false;
+    }
+    if (numLevels < 2 || !apply)
+        return false;
+
+    QualityKnob knob;
+    knob.name_ = name;
+    knob.numLevels_ = numLevels;
+    knob.priority_ = priority;
+    knob.bound_ = bound;
+    knob.apply_ = apply;
+
+    // Keep knobs with equal priority in registration order
+    auto it = ea::upper_bound(knobs_.begin(), knobs_.end(), priority,
+        [](int value, const QualityKnob& other) { return value < other.priority_; });
+    knobs_.insert(it, knob);
+    return true;
+}
+
+void PerformanceGovernor::AddRendererKnobs()
+{
+    WeakPtr<Renderer> renderer(GetSubsystem<Renderer>());
+    if (!renderer)
+        return;
+
+    const auto lessThan = [](auto value, auto previous) { return value < previous; };
+
+    // Zero pixel lights is unlimited
+    const ea::vector<int> pixelLights = MakeLevels(renderer->GetMaxPixelLights(), {4, 2, 1},
+        [](int value, int previous) { return previous == 0 || value < previous; });
+    AddKnob("MaxPixelLights", pixelLights.size(), QUALITY_PRIORITY_PIXEL_LIGHTS,
+        [renderer, pixelLights](unsigned level) { if (renderer) renderer->SetMaxPixelLights(pixelLights[level]); },
+        FRAME_BOUND_ALL);
+
+    const ea::vector<ShadowQuality> shadowQualities = MakeLevels(renderer->GetShadowQuality(),
+        {SHADOWQUALITY_PCF_16BIT, SHADOWQUALITY_SIMPLE_16BIT}, lessThan);
+    AddKnob("ShadowQuality", shadowQualities.size(), QUALITY_PRIORITY_SHADOW_QUALITY,
+        [renderer, shadowQualities](unsigned level) { if (renderer) renderer->SetShadowQuality(shadowQualities[level]); },
+        FRAME_BOUND_GPU);
+
+    const int shadowMapSize = renderer->GetShadowMapSize();
+    const ea::vector<int> shadowMapSizes = MakeLevels(shadowMapSize, {shadowMapSize / 2, shadowMapSize / 4},
+        [](int value, int previous) { return value >= MIN_SHADOW_MAP_SIZE && value < previous; });
+    AddKnob("ShadowMapSize", shadowMapSizes.size(), QUALITY_PRIORITY_SHADOW_MAP_SIZE,
+        [renderer, shadowMapSizes](unsigned level) { if (renderer) renderer->SetShadowMapSize(shadowMapSizes[level]); },
+        FRAME_BOUND_GPU);
+
+    const int occluderTriangles = renderer->GetMaxOccluderTriangles();
+    const ea::vector<int> occluderTriangleCounts = MakeLevels(occluderTriangles, {occluderTriangles / 2, occluderTriangles / 4},
+        [](int value, int previous) { return value > 0 && value < previous; });
+    AddKnob("MaxOccluderTriangles", occluderTriangleCounts.size(), QUALITY_PRIORITY_OCCLUDER_TRIANGLES,
+        [renderer, occluderTriangleCounts](unsigned level)
+        { if (renderer) renderer->SetMaxOccluderTriangles(occluderTriangleCounts[level]); },
+        FRAME_BOUND_CPU);
+
+    if (renderer->GetDrawShadows())
+    {
+        AddKnob("DrawShadows", 2, QUALITY_PRIORITY_DRAW_SHADOWS,
+            [renderer](unsigned level) { if (renderer) renderer->SetDrawShadows(level == 0); }, FRAME_BOUND_ALL);
+    }
+
+    const ea::vector<MaterialQuality> materialQualities = MakeLevels(renderer->GetMaterialQuality(),
+        {QUALITY_MEDIUM, QUALITY_LOW}, lessThan);
+    AddKnob("MaterialQuality", materialQualities.size(), QUALITY_PRIORITY_MATERIAL_QUALITY,
+        [renderer, materialQualities](unsigned level) { if (renderer) renderer->SetMaterialQuality(materialQualities[level]); },
+        FRAME_BOUND_GPU);
+
+    // Changing texture quality reloads all textures, so it is the last resort
+    const ea::vector<MaterialQuality> textureQualities = MakeLevels(renderer->GetTextureQuality(),
+        {QUALITY_MEDIUM, QUALITY_LOW}, lessThan);
+    AddKnob("TextureQuality", textureQualities.size(), QUALITY_PRIORITY_TEXTURE_QUALITY,
+        [renderer, textureQualities](unsigned level) { if (renderer) renderer->SetTextureQuality(textureQualities[level]); },
+        FRAME_BOUND_GPU);
+}
+
+void PerformanceGovernor::AddCameraKnob(Camera* camera)
+{
+    if (!camera)
+        return;
+
+    // Lower bias selects lower geometry LODs and updates animations less often
+    WeakPtr<Camera> cameraPtr(camera);
+    const float lodBias = camera->GetLodBias();
+    AddKnob("LodBias", 3, QUALITY_PRIORITY_LOD_BIAS,
+        [cameraPtr, lodBias](unsigned level)
+        {
+            static const float lodBiasScales[] = {1.0f, 0.75f, 0.5f};
+            if (cameraPtr)
+                cameraPtr->SetLodBias(lodBias * lodBiasScales[level]);
+        },
+        FRAME_BOUND_ALL);
+}
+
+void PerformanceGovernor::AddPhysicsKnob(PhysicsWorld* physicsWorld)
+{
+#ifdef URHO3D_PHYSICS
+    if (!physicsWorld)
+        return;
+
+    // Capping the substeps slows down the simulation instead of spiralling when over budget. Zero is unlimited
+    WeakPtr<PhysicsWorld> physicsWorldPtr(physicsWorld);
+    const ea::vector<int> subSteps = MakeLevels(physicsWorld->GetMaxSubSteps(), {2, 1},
+        [](int value, int previous) { return previous <= 0 || value < previous; });
+    AddKnob("MaxPhysicsSubSteps", subSteps.size(), QUALITY_PRIORITY_PHYSICS_SUBSTEPS,
+        [physicsWorldPtr, subSteps](unsigned level) { if (physicsWorldPtr) physicsWorldPtr->SetMaxSubSteps(subSteps[level]); },
+        FRAME_BOUND_CPU);
+#else
+    URHO3D_LOGERROR("Physics is not enabled");
+#endif
+}
+
+void PerformanceGovernor::RemoveKnob(const ea::string& name)
+{
+    knobs_.erase(ea::remove_if(knobs_.begin(), knobs_.end(), [&name](const QualityKnob& knob) { return knob.name_ == name; }),
+        knobs_.end());
+}
+
+void PerformanceGovernor::RemoveAllKnobs()
+{
+    knobs_.clear();
+}
+
+void PerformanceGovernor::SetKnobLevel(const ea::string& name, unsigned level)
+{
+    QualityKnob* knob = FindKnob(name);
+    if (!knob)
+    {
+        URHO3D_LOGERROR("Quality knob {} not found", name);
+        return;
+    }
+
+    ApplyLevel(*knob, Min(level, knob->numLevels_ - 1));
+}
+
+void PerformanceGovernor::ResetKnobs()
+{
+    for (QualityKnob& knob : knobs_)
+    {
+        if (knob.level_ != 0)
+            ApplyLevel(knob, 0);
+    }
+    numGoodEvaluations_ = 0;
+    currentRestoreDelay_ = restoreDelay_;
+    restoredLast_ = false;
+}
+
+unsigned PerformanceGovernor::GetKnobLevel(const ea::string& name) const
+{
+    for (const QualityKnob& knob : knobs_)
+    {
+        if (knob.name_ == name)
+            return knob.level_;
+    }
+    return 0;
+}
+
+void PerformanceGovernor::EndFrame(long long updateUSec, long long renderUSec)
+{
+    if (targetFrameTime_ <= 0.0f || knobs_.empty())
+        return;
+
+    if (settleFramesLeft_)
+    {
+        --settleFramesLeft_;
+        return;
+    }
+
+    // GPU time lags a few frames behind, which the median over the evaluation absorbs
+    auto* graphics = GetSubsystem<Graphics>();
+    cpuSamples_.push_back((updateUSec + renderUSec) / 1000.0f);
+    gpuSamples_.push_back(graphics && graphics->GetGPUFrameTimingSupport() ? graphics->GetGPUFrameTime() : 0.0f);
+    if (cpuSamples_.size() < evaluationFrames_)
+        return;
+
+    // Median is not skewed by single frame hitches, e.g. shader compiles
+    cpuFrameTime_ = GetMedian(cpuSamples_);
+    gpuFrameTime_ = GetMedian(gpuSamples_);
+    cpuSamples_.clear();
+    gpuSamples_.clear();
+    Evaluate();
+}
+
+void PerformanceGovernor::Evaluate()
+{
+    const float frameTime = Max(cpuFrameTime_, gpuFrameTime_);
+    const bool restoredLast = restoredLast_;
+    restoredLast_ = false;
+
+    if (frameTime > targetFrameTime_ * degradeThreshold_)
+    {
+        numGoodEvaluations_ = 0;
+        // Wait longer before the next attempt when restored quality did not fit the budget, so that it does not oscillate
+        if (restoredLast)
+            currentRestoreDelay_ = Min(currentRestoreDelay_ * 2, restoreDelay_ * MAX_RESTORE_BACKOFF);
+        Degrade(gpuFrameTime_ > cpuFrameTime_ ? FRAME_BOUND_GPU : FRAME_BOUND_CPU);
+        return;
+    }
+
+    if (restoredLast)
+        currentRestoreDelay_ = restoreDelay_;
+
+    if (frameTime < targetFrameTime_ * restoreThreshold_)
+    {
+        if (++numGoodEvaluations_ >= currentRestoreDelay_)
+        {
+            numGoodEvaluations_ = 0;
+            restoredLast_ = Restore();
+        }
+    }
+    else
+        numGoodEvaluations_ = 0;
+}
+
+bool PerformanceGovernor::Degrade(FrameBoundFlags bound)
+{
+    // Prefer knobs that reduce the bottleneck, fall back to any knob
+    for (bool matchBound : {true, false})
+    {
+        for (QualityKnob& knob : knobs_)
+        {
+            if (knob.level_ + 1 < knob.numLevels_ && (!matchBound || (knob.bound_ & bound)))
+            {
+                ApplyLevel(knob, knob.level_ + 1);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool PerformanceGovernor::Restore()
+{
+    for (auto it = knobs_.rbegin(); it != knobs_.rend(); ++it)
+    {
+        if (it->level_ > 0)
+        {
+            ApplyLevel(*it, it->level_ - 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void PerformanceGovernor::ApplyLevel(QualityKnob& knob, unsigned level)
+{
+    if (knob.level_ == level)
+        return;
+
+    knob.level_ = level;
+    knob.apply_(level);
+    URHO3D_LOGDEBUG("Quality knob {} set to level {}", knob.name_, level);
+
+    // Measure the new settings from scratch
+    cpuSamples_.clear();
+    gpuSamples_.clear();
+    settleFramesLeft_ = settleFrames_;
+
+    using namespace QualityKnobChanged;
+    VariantMap& eventData = GetEventDataMap();
+    eventData[P_NAME] = knob.name_;
+    eventData[P_LEVEL] = level;
+    SendEvent(E_QUALITYKNOBCHANGED, eventData);
+}
+
+QualityKnob* PerformanceGovernor::FindKnob(const ea::string& name)
+{
+    for (QualityKnob& knob : knobs_)
+    {
+        if (knob.name_ == name)
+            return &knob;
+    }
+    return nullptr;
+}
+
+}
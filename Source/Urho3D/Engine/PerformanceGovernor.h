@@ -0,0 +1,201 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+#pragma once
+
+#include "../Container/FlagSet.h"
+#include "../Core/Object.h"
+
+#include <EASTL/vector.h>
+
+#include <functional>
+
+namespace Urho3D
+{
+
+class Camera;
+class PhysicsWorld;
+
+/// Frame time components that a quality knob reduces.
+enum FrameBound : unsigned
+{
+    FRAME_BOUND_NONE = 0x0,
+    FRAME_BOUND_CPU = 0x1,
+    FRAME_BOUND_GPU = 0x2,
+    FRAME_BOUND_ALL = FRAME_BOUND_CPU | FRAME_BOUND_GPU,
+};
+URHO3D_FLAGSET(FrameBound, FrameBoundFlags);
+
+/// Quality setting adjusted by the performance governor.
+struct QualityKnob
+{
+    /// Name.
+    ea::string name_;
+    /// Number of levels. Level 0 is the configured quality, higher levels are cheaper.
+    unsigned numLevels_{};
+    /// Priority. Knobs with lower priority are degraded first and restored last.
+    int priority_{};
+    /// Frame time components the knob reduces.
+    FrameBoundFlags bound_{FRAME_BOUND_ALL};
+    /// Current level.
+    unsigned level_{};
+    /// Function applying a level.
+    std::function<void(unsigned level)> apply_;
+};
+
+/// Priorities of the built-in knobs.
+static const int QUALITY_PRIORITY_PIXEL_LIGHTS = 100;
+static const int QUALITY_PRIORITY_LOD_BIAS = 150;
+static const int QUALITY_PRIORITY_SHADOW_QUALITY = 200;
+static const int QUALITY_PRIORITY_SHADOW_MAP_SIZE = 300;
+static const int QUALITY_PRIORITY_OCCLUDER_TRIANGLES = 400;
+static const int QUALITY_PRIORITY_PHYSICS_SUBSTEPS = 500;
+static const int QUALITY_PRIORITY_DRAW_SHADOWS = 600;
+static const int QUALITY_PRIORITY_MATERIAL_QUALITY = 700;
+static const int QUALITY_PRIORITY_TEXTURE_QUALITY = 800;
+
+/// Adjusts registered quality knobs one level at a time to hold a target frame time. Measures CPU work time and GPU frame time, and degrades a knob matching the slower one. Quality is restored only after several evaluations with clear headroom, and a restore that immediately goes over budget doubles the wait before the next one.
+class URHO3D_API PerformanceGovernor : public Object
+{
+    URHO3D_OBJECT(PerformanceGovernor, Object);
+
+public:
+    /// Construct.
+    explicit PerformanceGovernor(Context* context);
+    /// Destruct.
+    ~PerformanceGovernor() override;
+
+    /// Set target frame time in milliseconds. Zero (default) disables the governor.
+    /// @property
+    void SetTargetFrameTime(float timeMs) { targetFrameTime_ = Max(timeMs, 0.0f); }
+    /// Set number of frames measured for one evaluation. Default 30.
+    /// @property
+    void SetEvaluationFrames(unsigned numFrames) { evaluationFrames_ = Max(numFrames, 1U); }
+    /// Set number of frames not measured after a knob changes, to skip reloads and warm-up. Default 10.
+    /// @property
+    void SetSettleFrames(unsigned numFrames) { settleFrames_ = numFrames; }
+    /// Set ratio of the target frame time above which quality is degraded. Default 1.0.
+    /// @property
+    void SetDegradeThreshold(float ratio) { degradeThreshold_ = Max(ratio, 0.0f); }
+    /// Set ratio of the target frame time below which quality may be restored. Default 0.8.
+    /// @property
+    void SetRestoreThreshold(float ratio) { restoreThreshold_ = Max(ratio, 0.0f); }
+    /// Set number of consecutive evaluations below the restore threshold before quality is restored. Default 4.
+    /// @property
+    void SetRestoreDelay(unsigned numEvaluations);
+
+    /// Register a quality knob. Return false if a knob with the same name exists.
+    /// @nobind
+    bool AddKnob(const ea::string& name, unsigned numLevels, int priority, const std::function<void(unsigned level)>& apply,
+        FrameBoundFlags bound = FRAME_BOUND_ALL);
+    /// Register knobs for the renderer quality settings, starting from their current values.
+    void AddRendererKnobs();
+    /// Register knob for the geometry and animation LOD bias of a camera, starting from its current value.
+    void AddCameraKnob(Camera* camera);
+    /// Register knob for the maximum physics substeps per frame of a physics world, starting from its current value.
+    void AddPhysicsKnob(PhysicsWorld* physicsWorld);
+    /// Unregister a knob. Its current level stays applied.
+    void RemoveKnob(const ea::string& name);
+    /// Unregister all knobs.
+    void RemoveAllKnobs();
+    /// Set and apply level of a knob.
+    void SetKnobLevel(const ea::string& name, unsigned level);
+    /// Restore all knobs to level 0.
+    void ResetKnobs();
+
+    /// Measure the frame that just ended and adjust quality when due. Called by the engine.
+    void EndFrame(long long updateUSec, long long renderUSec);
+
+    /// Return target frame time in milliseconds.
+    /// @property
+    float GetTargetFrameTime() const { return targetFrameTime_; }
+    /// Return number of frames measured for one evaluation.
+    /// @property
+    unsigned GetEvaluationFrames() const { return evaluationFrames_; }
+    /// Return number of frames not measured after a knob changes.
+    /// @property
+    unsigned GetSettleFrames() const { return settleFrames_; }
+    /// Return degrade threshold ratio.
+    /// @property
+    float GetDegradeThreshold() const { return degradeThreshold_; }
+    /// Return restore threshold ratio.
+    /// @property
+    float GetRestoreThreshold() const { return restoreThreshold_; }
+    /// Return number of consecutive evaluations with headroom before quality is restored.
+    /// @property
+    unsigned GetRestoreDelay() const { return restoreDelay_; }
+    /// Return median CPU work time of the last evaluation in milliseconds.
+    /// @property
+    float GetCPUFrameTime() const { return cpuFrameTime_; }
+    /// Return median GPU frame time of the last evaluation in milliseconds. Zero if not measured.
+    /// @property
+    float GetGPUFrameTime() const { return gpuFrameTime_; }
+    /// Return registered knobs ordered by priority.
+    /// @nobind
+    const ea::vector<QualityKnob>& GetKnobs() const { return knobs_; }
+    /// Return level of a knob, or zero if not found.
+    unsigned GetKnobLevel(const ea::string& name) const;
+
+private:
+    /// Adjust quality based on the median frame times.
+    void Evaluate();
+    /// Degrade the lowest priority knob that reduces the bottleneck. Return true if a knob changed.
+    bool Degrade(FrameBoundFlags bound);
+    /// Restore the highest priority degraded knob. Return true if a knob changed.
+    bool Restore();
+    /// Apply a knob level, notify and restart measurement.
+    void ApplyLevel(QualityKnob& knob, unsigned level);
+    /// Return knob by name.
+    QualityKnob* FindKnob(const ea::string& name);
+
+    /// Knobs ordered by priority.
+    ea::vector<QualityKnob> knobs_;
+    /// CPU work times of the current evaluation.
+    ea::vector<float> cpuSamples_;
+    /// GPU frame times of the current evaluation.
+    ea::vector<float> gpuSamples_;
+    /// Target frame time in milliseconds.
+    float targetFrameTime_{};
+    /// Frames per evaluation.
+    unsigned evaluationFrames_{30};
+    /// Frames skipped after a change.
+    unsigned settleFrames_{10};
+    /// Degrade threshold ratio.
+    float degradeThreshold_{1.0f};
+    /// Restore threshold ratio.
+    float restoreThreshold_{0.8f};
+    /// Base number of evaluations with headroom before restoring.
+    unsigned restoreDelay_{4};
+    /// Current number of evaluations with headroom before restoring, grown after failed restores.
+    unsigned currentRestoreDelay_{4};
+    /// Consecutive evaluations with headroom.
+    unsigned numGoodEvaluations_{};
+    /// Frames left to skip after a change.
+    unsigned settleFramesLeft_{};
+    /// Whether the last change was a restore.
+    bool restoredLast_{};
+    /// Median CPU work time of the last evaluation.
+    float cpuFrameTime_{};
+    /// Median GPU frame time of the last evaluation.
+    float gpuFrameTime_{};
+};
+
+}
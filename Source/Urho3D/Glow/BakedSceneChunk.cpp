@@ -25,6 +25,10 @@
 #include "../Glow/BakedSceneChunk.h"
 
 #include "../Glow/LightTracer.h"
+#include "../Graphics/Material.h"
+#include "../Graphics/Model.h"
+#include "../Graphics/StaticModel.h"
+#include "../Graphics/Terrain.h"
 #include "../IO/Log.h"
 
 #include <EASTL/sort.h>
@@ -198,10 +202,98 @@ ea::vector<unsigned> CollectLightmapsRequiredForChunk(const ea::vector<Raytracer
     return ea::vector<unsigned>(requiredDirectLightmaps.begin(), requiredDirectLightmaps.end());
 }
 
+/// Calculate hash of geometry that affects baking.
+unsigned HashGeometry(Component* geometry)
+{
+    unsigned hash = geometry->GetType().Value();
+    CombineHash(hash, geometry->GetNode()->GetWorldTransform().ToHash());
+
+    if (auto staticModel = dynamic_cast<StaticModel*>(geometry))
+    {
+        if (Model* model = staticModel->GetModel())
+            CombineHash(hash, model->GetNameHash().Value());
+        for (unsigned i = 0; i < staticModel->GetNumGeometries(); ++i)
+        {
+            if (Material* material = staticModel->GetMaterial(i))
+                CombineHash(hash, material->GetNameHash().Value());
+        }
+        CombineHash(hash, staticModel->GetBakeLightmapEffective());
+        CombineHash(hash, staticModel->GetLightmapIndex());
+        CombineHash(hash, staticModel->GetLightmapScaleOffset().ToHash());
+    }
+    else if (auto terrain = dynamic_cast<Terrain*>(geometry))
+    {
+        if (Material* material = terrain->GetMaterial())
+            CombineHash(hash, material->GetNameHash().Value());
+        CombineHash(hash, terrain->GetSpacing().ToHash());
+        CombineHash(hash, terrain->GetBakeLightmapEffective());
+        CombineHash(hash, terrain->GetLightmapIndex());
+        CombineHash(hash, terrain->GetLightmapScaleOffset().ToHash());
+
+        // Terrain may be edited in memory, hash actual heights
+        const IntVector2& numVertices = terrain->GetNumVertices();
+        const float* heightData = terrain->GetHeightData().get();
+        const unsigned numHeights = heightData ? numVertices.x_ * numVertices.y_ : 0;
+        for (unsigned i = 0; i < numHeights; ++i)
+            CombineHash(hash, FloatToRawIntBits(heightData[i]));
+    }
+
+    return hash;
+}
+
+/// Calculate hash of baked light.
+unsigned HashBakedLight(const BakedLight& bakedLight)
+{
+    unsigned hash = bakedLight.lightType_;
+    CombineHash(hash, bakedLight.lightMode_);
+    CombineHash(hash, bakedLight.color_.ToVector4().ToHash());
+    CombineHash(hash, FloatToRawIntBits(bakedLight.indirectBrightness_));
+    CombineHash(hash, FloatToRawIntBits(bakedLight.fov_));
+    CombineHash(hash, FloatToRawIntBits(bakedLight.distance_));
+    CombineHash(hash, FloatToRawIntBits(bakedLight.radius_));
+    CombineHash(hash, FloatToRawIntBits(bakedLight.angle_));
+    CombineHash(hash, bakedLight.position_.ToHash());
+    CombineHash(hash, bakedLight.rotation_.ToHash());
+    return hash;
+}
+
+/// Calculate hash of all chunk inputs. Order of non-unique objects is not preserved, so hashes are sorted.
+unsigned HashChunkInputs(const ea::vector<Component*>& geometriesInChunk, unsigned numUniqueGeometries,
+    const ea::vector<BakedLight>& bakedLights, const LightProbeCollection& lightProbesCollection,
+    const ea::vector<unsigned>& lightmapsInChunk)
+{
+    unsigned hash = 0;
+
+    for (unsigned lightmapIndex : lightmapsInChunk)
+        CombineHash(hash, lightmapIndex);
+
+    for (unsigned i = 0; i < numUniqueGeometries; ++i)
+        CombineHash(hash, HashGeometry(geometriesInChunk[i]));
+
+    ea::vector<unsigned> objectHashes;
+    for (unsigned i = numUniqueGeometries; i < geometriesInChunk.size(); ++i)
+        objectHashes.push_back(HashGeometry(geometriesInChunk[i]));
+    ea::sort(objectHashes.begin(), objectHashes.end());
+    for (unsigned objectHash : objectHashes)
+        CombineHash(hash, objectHash);
+
+    objectHashes.clear();
+    for (const BakedLight& bakedLight : bakedLights)
+        objectHashes.push_back(HashBakedLight(bakedLight));
+    ea::sort(objectHashes.begin(), objectHashes.end());
+    for (unsigned objectHash : objectHashes)
+        CombineHash(hash, objectHash);
+
+    for (const Vector3& position : lightProbesCollection.worldPositions_)
+        CombineHash(hash, position.ToHash());
+
+    return hash;
+}
+
 }
 
-BakedSceneChunk CreateBakedSceneChunk(Context* context,
-    BakedSceneCollector& collector, const IntVector3& chunk, const LightBakingSettings& settings)
+BakedSceneChunk CreateBakedSceneChunk(Context* context, BakedSceneCollector& collector,
+    const IntVector3& chunk, const LightBakingSettings& settings, RaytracerResourceCache* raytracerCache)
 {
     // Collect objects
     const ea::vector<Component*> uniqueGeometries = collector.GetUniqueGeometries(chunk);
@@ -234,7 +326,7 @@ BakedSceneChunk CreateBakedSceneChunk(Context* context,
 
     const unsigned uvChannel = settings.geometryBufferBaking_.uvChannel_;
     const SharedPtr<RaytracerScene> raytracerScene = CreateRaytracingScene(
-        context, geometriesInChunk, uvChannel, raytracingBackground);
+        context, geometriesInChunk, uvChannel, raytracingBackground, raytracerCache);
 
     // Match raytracer geometries and geometry buffer
     ea::vector<unsigned> geometryBufferToRaytracerGeometry = CreateGeometryMapping(
@@ -257,6 +349,8 @@ BakedSceneChunk CreateBakedSceneChunk(Context* context,
     bakedChunk.bakedLights_ = CreateBakedLights(lightsInChunk);
     bakedChunk.lightProbesCollection_ = ea::move(lightProbesCollection);
     bakedChunk.numUniqueLightProbes_ = uniqueLightProbeGroups.size();
+    bakedChunk.inputHash_ = HashChunkInputs(geometriesInChunk, uniqueGeometries.size(),
+        bakedChunk.bakedLights_, bakedChunk.lightProbesCollection_, bakedChunk.lightmaps_);
 
     return bakedChunk;
 }
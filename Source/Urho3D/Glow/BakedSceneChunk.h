@@ -52,10 +52,13 @@ struct BakedSceneChunk
     LightProbeCollection lightProbesCollection_;
     /// Number of unique light probe groups. Used for saving results.
     unsigned numUniqueLightProbes_{};
+    /// Hash of geometries, materials, lights and light probes used to bake this chunk.
+    /// If the hash is unchanged, previously baked results of the chunk are still valid.
+    unsigned inputHash_{};
 };
 
-/// Create baked scene chunk.
-URHO3D_API BakedSceneChunk CreateBakedSceneChunk(Context* context,
-    BakedSceneCollector& collector, const IntVector3& chunk, const LightBakingSettings& settings);
+/// Create baked scene chunk. Raytracer resources are shared between chunks if cache is provided.
+URHO3D_API BakedSceneChunk CreateBakedSceneChunk(Context* context, BakedSceneCollector& collector,
+    const IntVector3& chunk, const LightBakingSettings& settings, RaytracerResourceCache* raytracerCache = nullptr);
 
 }
@@ -36,6 +36,7 @@
 #include "../Graphics/Graphics.h"
 #include "../Graphics/LightProbeGroup.h"
 #include "../Graphics/Model.h"
+#include "../IO/File.h"
 #include "../IO/FileSystem.h"
 #include "../IO/Log.h"
 #include "../Math/TetrahedralMesh.h"
@@ -93,6 +94,52 @@ unsigned long long Swizzle(const IntVector3& vec, const IntVector3& base = IntVe
     return result;
 }
 
+/// Calculate hash of filter settings.
+unsigned HashFilterSettings(const EdgeStoppingGaussFilterParameters& settings)
+{
+    unsigned hash = settings.kernelRadius_;
+    CombineHash(hash, settings.upscale_);
+    CombineHash(hash, FloatToRawIntBits(settings.luminanceSigma_));
+    CombineHash(hash, FloatToRawIntBits(settings.normalPower_));
+    CombineHash(hash, FloatToRawIntBits(settings.positionSigma_));
+    return hash;
+}
+
+/// Calculate hash of settings that affect baked lightmaps and light probes.
+unsigned HashBakingSettings(const LightBakingSettings& settings)
+{
+    unsigned hash = settings.charting_.lightmapSize_;
+    CombineHash(hash, settings.charting_.padding_);
+    CombineHash(hash, FloatToRawIntBits(settings.charting_.texelDensity_));
+    CombineHash(hash, FloatToRawIntBits(settings.charting_.minObjectScale_));
+    CombineHash(hash, settings.charting_.defaultChartSize_);
+    CombineHash(hash, settings.geometryBufferBaking_.uvChannel_);
+
+    CombineHash(hash, settings.directChartTracing_.maxSamples_);
+    CombineHash(hash, settings.directProbesTracing_.maxSamples_);
+    CombineHash(hash, settings.indirectChartTracing_.maxSamples_);
+    CombineHash(hash, settings.indirectChartTracing_.maxBounces_);
+    CombineHash(hash, settings.indirectProbesTracing_.maxSamples_);
+    CombineHash(hash, settings.indirectProbesTracing_.maxBounces_);
+
+    CombineHash(hash, HashFilterSettings(settings.directFilter_));
+    CombineHash(hash, HashFilterSettings(settings.indirectFilter_));
+    CombineHash(hash, settings.stitching_.numIterations_);
+    CombineHash(hash, FloatToRawIntBits(settings.stitching_.blendFactor_));
+
+    CombineHash(hash, FloatToRawIntBits(settings.properties_.emissionBrightness_));
+    CombineHash(hash, settings.properties_.backgroundColor_.ToHash());
+    CombineHash(hash, FloatToRawIntBits(settings.properties_.backgroundBrightness_));
+    CombineHash(hash, StringHash(GetResourceName(settings.properties_.backgroundImage_)).Value());
+
+    CombineHash(hash, settings.incremental_.chunkSize_.ToHash());
+    CombineHash(hash, FloatToRawIntBits(settings.incremental_.indirectPadding_));
+    CombineHash(hash, FloatToRawIntBits(settings.incremental_.directionalLightShadowDistance_));
+    CombineHash(hash, StringHash(settings.incremental_.lightmapNameFormat_).Value());
+    CombineHash(hash, settings.incremental_.compressLightmaps_);
+    return hash;
+}
+
 }
 
 /// Incremental light baker implementation.
@@ -105,6 +152,7 @@ struct IncrementalLightBaker::Impl
         , scene_(scene)
         , collector_(collector)
         , cache_(cache)
+        , raytracerCache_(MakeShared<RaytracerResourceCache>(context_))
     {
     }
 
@@ -230,20 +278,64 @@ struct IncrementalLightBaker::Impl
         }
     }
 
-    /// Generate baking chunks.
+    /// Generate baking chunks and find chunks that have to be baked.
     void GenerateBakingChunks()
     {
+        const unsigned settingsHash = HashBakingSettings(settings_);
+        const ea::unordered_map<IntVector3, unsigned> previousChunkHashes = LoadChunkHashes();
+
+        chunkHashes_.clear();
+        changedChunks_.clear();
+        bakedChunks_.clear();
+
+        ea::unordered_map<unsigned, IntVector3> lightmapToChunk;
+        ea::hash_set<unsigned> requiredDirectLightmaps;
         for (const IntVector3& chunk : chunks_)
         {
-            BakedSceneChunk bakedChunk = CreateBakedSceneChunk(context_, *collector_, chunk, settings_);
+            BakedSceneChunk bakedChunk = CreateBakedSceneChunk(context_, *collector_, chunk, settings_, raytracerCache_);
+
+            unsigned chunkHash = bakedChunk.inputHash_;
+            CombineHash(chunkHash, settingsHash);
+            chunkHashes_[chunk] = chunkHash;
+
+            for (unsigned lightmapIndex : bakedChunk.lightmaps_)
+                lightmapToChunk[lightmapIndex] = chunk;
+
+            // Re-bake chunk if anything changed or if baked files are missing
+            const auto iter = previousChunkHashes.find(chunk);
+            if (iter == previousChunkHashes.end() || iter->second != chunkHash || !HasBakedFiles(chunk, bakedChunk))
+            {
+                changedChunks_.push_back(chunk);
+                requiredDirectLightmaps.insert(
+                    bakedChunk.requiredDirectLightmaps_.begin(), bakedChunk.requiredDirectLightmaps_.end());
+            }
+
             cache_->StoreBakedChunk(chunk, ea::move(bakedChunk));
         }
+
+        // Direct light is needed for changed chunks and for all charts they gather indirect light from
+        ea::hash_set<IntVector3> directLightChunks;
+        for (unsigned lightmapIndex : requiredDirectLightmaps)
+        {
+            const auto iter = lightmapToChunk.find(lightmapIndex);
+            if (iter != lightmapToChunk.end())
+                directLightChunks.insert(iter->second);
+        }
+
+        directLightChunks_.clear();
+        for (const IntVector3& chunk : chunks_)
+        {
+            if (directLightChunks.contains(chunk))
+                directLightChunks_.push_back(chunk);
+        }
+
+        URHO3D_LOGINFO("{} of {} chunks are changed and will be baked", changedChunks_.size(), chunks_.size());
     }
 
     /// Step direct light for charts.
-    bool BakeDirectCharts(StopToken stopToken)
+    bool BakeDirectCharts(StopToken stopToken, const ea::vector<IntVector3>& chunks)
     {
-        for (const IntVector3 chunk : chunks_)
+        for (const IntVector3 chunk : chunks)
         {
             const ea::shared_ptr<const BakedSceneChunk> bakedChunk = cache_->LoadBakedChunk(chunk);
 
@@ -277,7 +369,7 @@ struct IncrementalLightBaker::Impl
     }
 
     /// Bake indirect light, filter baked direct and indirect, bake direct light probes.
-    bool BakeIndirectAndFilter(StopToken stopToken)
+    bool BakeIndirectAndFilter(StopToken stopToken, const ea::vector<IntVector3>& chunks)
     {
         const unsigned numTexels = settings_.charting_.lightmapSize_ * settings_.charting_.lightmapSize_;
         ea::vector<Vector3> directFilterBuffer(numTexels);
@@ -285,7 +377,7 @@ struct IncrementalLightBaker::Impl
         LightProbeCollectionBakedData lightProbesBakedData;
         LightmapChartBakedIndirect bakedIndirect{ settings_.charting_.lightmapSize_ };
 
-        for (const IntVector3 chunk : chunks_)
+        for (const IntVector3 chunk : chunks)
         {
             if (stopToken.IsStopped())
                 return false;
@@ -359,6 +451,8 @@ struct IncrementalLightBaker::Impl
                 cache_->StoreLightmap(lightmapIndex, ea::move(bakedLightmap));
             }
 
+            bakedChunks_.insert(chunk);
+
             // Bake direct lights for light probes
             for (const BakedLight& bakedLight : bakedChunk->bakedLights_)
             {
@@ -383,6 +477,13 @@ struct IncrementalLightBaker::Impl
         return true;
     }
 
+    /// Return all chunks.
+    const ea::vector<IntVector3>& GetChunks() const { return chunks_; }
+    /// Return changed chunks.
+    const ea::vector<IntVector3>& GetChangedChunks() const { return changedChunks_; }
+    /// Return chunks that need direct light to bake changed chunks.
+    const ea::vector<IntVector3>& GetDirectLightChunks() const { return directLightChunks_; }
+
     // Stitch and save lightmaps.
     void StitchAndSaveImages()
     {
@@ -412,6 +513,10 @@ struct IncrementalLightBaker::Impl
                 const ea::shared_ptr<const BakedLightmap> bakedLightmap = cache_->LoadLightmap(lightmapIndex);
                 const LightmapChartGeometryBuffer& geometryBuffer = bakedChunk->geometryBuffers_[i];
 
+                // Keep previously saved image if lightmap was not baked
+                if (!bakedLightmap)
+                    continue;
+
                 // Stitch seams or just copy data to buffer
                 if (settings_.stitching_.numIterations_ > 0 && !geometryBuffer.seams_.empty())
                 {
@@ -442,18 +547,102 @@ struct IncrementalLightBaker::Impl
                 // Save image to destination folder
                 const ea::string fileName = GetLightmapFileName(lightmapIndex);
                 context_->GetSubsystem<FileSystem>()->CreateDirsRecursive(GetPath(fileName));
-                lightmapImage->SaveFile(fileName);
+                if (settings_.incremental_.compressLightmaps_)
+                {
+                    const SharedPtr<Image> compressedImage = lightmapImage->GetCompressedImage(CF_DXT1);
+                    lightmapImage->CleanupLevels();
+                    if (compressedImage)
+                        compressedImage->SaveDDS(fileName);
+                }
+                else
+                    lightmapImage->SaveFile(fileName);
             }
         }
     }
 
+    /// Save hashes of chunks that are up to date.
+    void SaveChunkHashes()
+    {
+        ea::vector<IntVector3> upToDateChunks;
+        for (const IntVector3& chunk : chunks_)
+        {
+            const bool isChanged = ea::find(changedChunks_.begin(), changedChunks_.end(), chunk) != changedChunks_.end();
+            if (!isChanged || bakedChunks_.contains(chunk))
+                upToDateChunks.push_back(chunk);
+        }
+
+        const ea::string fileName = GetChunkHashesFileName();
+        context_->GetSubsystem<FileSystem>()->CreateDirsRecursive(GetPath(fileName));
+
+        File file(context_);
+        if (!file.Open(fileName, FILE_WRITE))
+        {
+            URHO3D_LOGERROR("Cannot save chunk hashes to \"{}\"", fileName);
+            return;
+        }
+
+        file.WriteUInt(upToDateChunks.size());
+        for (const IntVector3& chunk : upToDateChunks)
+        {
+            file.WriteIntVector3(chunk);
+            file.WriteUInt(chunkHashes_[chunk]);
+        }
+    }
+
 private:
+    /// Load hashes of chunks saved after previous bake.
+    ea::unordered_map<IntVector3, unsigned> LoadChunkHashes()
+    {
+        ea::unordered_map<IntVector3, unsigned> chunkHashes;
+
+        const ea::string fileName = GetChunkHashesFileName();
+        if (!context_->GetSubsystem<FileSystem>()->FileExists(fileName))
+            return chunkHashes;
+
+        File file(context_);
+        if (!file.Open(fileName, FILE_READ))
+            return chunkHashes;
+
+        const unsigned numChunks = file.ReadUInt();
+        for (unsigned i = 0; i < numChunks && !file.IsEof(); ++i)
+        {
+            const IntVector3 chunk = file.ReadIntVector3();
+            chunkHashes[chunk] = file.ReadUInt();
+        }
+        return chunkHashes;
+    }
+
+    /// Return whether all lightmaps and light probes of the chunk are saved.
+    bool HasBakedFiles(const IntVector3& chunk, const BakedSceneChunk& bakedChunk)
+    {
+        auto fileSystem = context_->GetSubsystem<FileSystem>();
+        for (unsigned lightmapIndex : bakedChunk.lightmaps_)
+        {
+            if (!fileSystem->FileExists(GetLightmapFileName(lightmapIndex)))
+                return false;
+        }
+        for (unsigned groupIndex = 0; groupIndex < bakedChunk.numUniqueLightProbes_; ++groupIndex)
+        {
+            if (!fileSystem->FileExists(GetLightProbeBakedDataFileName(chunk, groupIndex)))
+                return false;
+        }
+        return true;
+    }
+
+    /// Return chunk hashes file name.
+    ea::string GetChunkHashesFileName()
+    {
+        return settings_.incremental_.outputDirectory_ + settings_.incremental_.chunkHashesFileName_;
+    }
+
     /// Return lightmap file name.
     ea::string GetLightmapFileName(unsigned lightmapIndex)
     {
         ea::string fileName;
         fileName += settings_.incremental_.outputDirectory_;
         fileName += Format(settings_.incremental_.lightmapNameFormat_, lightmapIndex);
+        if (settings_.incremental_.compressLightmaps_)
+            return ReplaceExtension(fileName, ".dds");
         return fileName;
     }
 
@@ -477,8 +666,18 @@ private:
     BakedSceneCollector* collector_{};
     /// Lightmap cache.
     BakedLightCache* cache_{};
+    /// Raytracer resources shared between chunks.
+    SharedPtr<RaytracerResourceCache> raytracerCache_;
     /// List of all chunks.
     ea::vector<IntVector3> chunks_;
+    /// Input hashes of all chunks.
+    ea::unordered_map<IntVector3, unsigned> chunkHashes_;
+    /// Chunks that changed since last bake.
+    ea::vector<IntVector3> changedChunks_;
+    /// Chunks that need direct light to bake changed chunks.
+    ea::vector<IntVector3> directLightChunks_;
+    /// Chunks baked by this baker.
+    ea::hash_set<IntVector3> bakedChunks_;
     /// Number of lightmap charts.
     unsigned numLightmapCharts_{};
 };
@@ -502,18 +701,39 @@ void IncrementalLightBaker::ProcessScene()
 
 bool IncrementalLightBaker::Bake(StopToken stopToken)
 {
-    if (!impl_->BakeDirectCharts(stopToken))
+    if (!impl_->BakeDirectCharts(stopToken, impl_->GetDirectLightChunks()))
         return false;
 
-    if (!impl_->BakeIndirectAndFilter(stopToken))
+    if (!impl_->BakeIndirectAndFilter(stopToken, impl_->GetChangedChunks()))
         return false;
 
     return true;
 }
 
+const ea::vector<IntVector3>& IncrementalLightBaker::GetChunks() const
+{
+    return impl_->GetChunks();
+}
+
+const ea::vector<IntVector3>& IncrementalLightBaker::GetChangedChunks() const
+{
+    return impl_->GetChangedChunks();
+}
+
+bool IncrementalLightBaker::BakeDirect(StopToken stopToken, const ea::vector<IntVector3>& chunks)
+{
+    return impl_->BakeDirectCharts(stopToken, chunks);
+}
+
+bool IncrementalLightBaker::BakeIndirect(StopToken stopToken, const ea::vector<IntVector3>& chunks)
+{
+    return impl_->BakeIndirectAndFilter(stopToken, chunks);
+}
+
 void IncrementalLightBaker::CommitScene()
 {
     impl_->StitchAndSaveImages();
+    impl_->SaveChunkHashes();
 }
 
 }
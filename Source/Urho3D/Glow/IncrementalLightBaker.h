@@ -48,11 +48,25 @@ public:
         Scene* scene, BakedSceneCollector* collector, BakedLightCache* cache);
     /// Process and update the scene. Scene collector is used here.
     void ProcessScene();
-    /// Bake lighting and save results.
+    /// Bake lighting and save results. Only changed chunks are baked.
     /// It is safe to call Bake from another thread as long as lightmap cache is safe to use from said thread.
     /// Return false if canceled.
     bool Bake(StopToken stopToken);
-    /// Commit the rest of changes to scene. Scene collector is used here.
+
+    /// Return all chunks of the scene in baking order. Valid after Initialize.
+    const ea::vector<IntVector3>& GetChunks() const;
+    /// Return chunks whose inputs changed since last bake, or whose baked files are missing. Valid after ProcessScene.
+    const ea::vector<IntVector3>& GetChangedChunks() const;
+    /// Bake direct light for the charts of given chunks and store it in the cache.
+    /// Together with BakeIndirect, allows to split baking between several bakers that share the cache,
+    /// e.g. processes running on different machines that have processed the same scene with the same settings.
+    /// Return false if canceled.
+    bool BakeDirect(StopToken stopToken, const ea::vector<IntVector3>& chunks);
+    /// Bake indirect light and light probes for given chunks, filter and store lightmaps in the cache.
+    /// Direct light of all charts must be stored in the cache first.
+    /// Return false if canceled.
+    bool BakeIndirect(StopToken stopToken, const ea::vector<IntVector3>& chunks);
+    /// Commit the rest of changes to scene and save hashes of baked chunks. Scene collector is used here.
     void CommitScene();
 
 private:
@@ -556,12 +556,12 @@ void TraceDirectLight(T sharedKernel, U sharedGenerator,
         Vector3 incomingLightIntensity;
         rayContext.incomingLight_ = &incomingLightIntensity;
 
-        RTCRayHit rayHit;
-        rayHit.ray.mask = sharedKernel.GetGeometryMask();
-        rayHit.ray.tnear = 0.0f;
-        rayHit.ray.time = 0.0f;
-        rayHit.ray.id = 0;
-        rayHit.ray.flags = 0;
+        RTCRay ray;
+        ray.mask = sharedKernel.GetGeometryMask();
+        ray.tnear = 0.0f;
+        ray.time = 0.0f;
+        ray.id = 0;
+        ray.flags = 0;
 
         for (unsigned elementIndex = fromIndex; elementIndex < toIndex; ++elementIndex)
         {
@@ -578,18 +578,19 @@ void TraceDirectLight(T sharedKernel, U sharedGenerator,
                 if (!generator.Generate(position, rayOffset, incomingLightIntensity, incomingLightDirection))
                     continue;
 
-                // Cast direct ray
-                rayHit.ray.dir_x = rayOffset.x_;
-                rayHit.ray.dir_y = rayOffset.y_;
-                rayHit.ray.dir_z = rayOffset.z_;
-                rayHit.ray.org_x = position.x_ - rayOffset.x_;
-                rayHit.ray.org_y = position.y_ - rayOffset.y_;
-                rayHit.ray.org_z = position.z_ - rayOffset.z_;
-                rayHit.ray.tfar = 1.0f;
-                rayHit.hit.geomID = RTC_INVALID_GEOMETRY_ID;
-                rtcIntersect1(scene, &rayContext, &rayHit);
-
-                if (rayHit.hit.geomID == RTC_INVALID_GEOMETRY_ID)
+                // Cast direct ray. Only visibility matters, so stop at the first opaque hit instead of finding the closest one.
+                // Transparent hits are still accumulated by the filter function, which is also invoked for occlusion rays
+                ray.dir_x = rayOffset.x_;
+                ray.dir_y = rayOffset.y_;
+                ray.dir_z = rayOffset.z_;
+                ray.org_x = position.x_ - rayOffset.x_;
+                ray.org_y = position.y_ - rayOffset.y_;
+                ray.org_z = position.z_ - rayOffset.z_;
+                ray.tfar = 1.0f;
+                rtcOccluded1(scene, &rayContext, &ray);
+
+                // Embree sets far distance to negative infinity if anything was hit
+                if (ray.tfar >= 0.0f)
                     kernel.EndSample(incomingLightIntensity, incomingLightDirection);
             }
 
@@ -609,19 +610,45 @@ struct IndirectTracingContext : public RTCIntersectContext
 void TracingFilterIndirect(const RTCFilterFunctionNArguments* args)
 {
     const auto& ctx = *static_cast<const IndirectTracingContext*>(args->context);
-    auto& hit = *reinterpret_cast<RTCHit*>(args->hit);
-    assert(args->N == 1);
 
-    // Ignore invalid
-    if (args->valid[0] == 0)
-        return;
-
-    // Ignore if transparent
-    const RaytracerGeometry& hitGeometry = (*ctx.geometryIndex_)[hit.geomID];
-    if (IsTransparentForIndirect(hitGeometry, hit))
-        args->valid[0] = 0;
+    // Rays may be traced as streams or packets, check each of them
+    for (unsigned i = 0; i < args->N; ++i)
+    {
+        // Ignore invalid
+        if (args->valid[i] == 0)
+            continue;
+
+        // Ignore if transparent
+        const RTCHit hit = rtcGetHitFromHitN(args->hit, args->N, i);
+        const RaytracerGeometry& hitGeometry = (*ctx.geometryIndex_)[hit.geomID];
+        if (IsTransparentForIndirect(hitGeometry, hit))
+            args->valid[i] = 0;
+    }
 }
 
+/// State of indirect light sample traced as part of ray stream.
+struct IndirectLightSample
+{
+    /// Current position.
+    Vector3 position_;
+    /// Current normal of actual geometry face.
+    Vector3 faceNormal_;
+    /// Current smooth interpolated normal.
+    Vector3 smoothNormal_;
+    /// Current ray direction.
+    Vector3 rayDirection_;
+    /// Albedo of surfaces along the path.
+    Vector3 albedo_[IndirectLightTracingSettings::MaxBounces];
+    /// Incoming light for each bounce.
+    Vector3 incomingSamples_[IndirectLightTracingSettings::MaxBounces];
+    /// Incoming light factors for each bounce.
+    float incomingFactors_[IndirectLightTracingSettings::MaxBounces];
+    /// Number of traced bounces.
+    unsigned numBounces_{};
+    /// Whether the path ends in the background.
+    bool hitBackground_{};
+};
+
 /// Indirect light tracing for charts: tracing kernel.
 struct ChartIndirectTracingKernel
 {
@@ -702,7 +729,7 @@ struct ChartIndirectTracingKernel
     }
 
     /// End sample.
-    void EndSample(const Vector3& light)
+    void EndSample(unsigned /*sampleIndex*/, const Vector3& light, const Vector3& /*backgroundTransfer*/)
     {
         accumulatedIndirectLight_ += Vector4(light, 1.0f);
     }
@@ -727,11 +754,13 @@ struct LightProbeIndirectTracingKernel
     /// Current position.
     Vector3 currentPosition_;
 
-    /// Current sample direction.
-    Vector3 currentSampleDirection_;
+    /// Sample directions of current element.
+    ea::vector<Vector3> sampleDirections_;
 
     /// Accumulated indirect light (SH).
     SphericalHarmonicsColor9 accumulatedLightSH_;
+    /// Accumulated light from unit white background (SH).
+    SphericalHarmonicsColor9 accumulatedBackgroundSH_;
 
     /// Return number of elements to trace.
     unsigned GetNumElements() const { return bakedData_->Size(); }
@@ -743,28 +772,32 @@ struct LightProbeIndirectTracingKernel
     bool BeginElement(unsigned elementIndex)
     {
         currentPosition_ = collection_->worldPositions_[elementIndex];
+        sampleDirections_.resize(GetNumSamples());
 
         accumulatedLightSH_ = {};
+        accumulatedBackgroundSH_ = {};
         return true;
     };
 
     /// Begin sample. Return position, normal and initial ray direction.
-    void BeginSample(unsigned /*sampleIndex*/,
+    void BeginSample(unsigned sampleIndex,
         Vector3& position, Vector3& faceNormal, Vector3& smoothNormal, Vector3& rayDirection, Vector3& albedo)
     {
-        RandomDirection3(currentSampleDirection_);
+        Vector3& sampleDirection = sampleDirections_[sampleIndex];
+        RandomDirection3(sampleDirection);
 
         position = currentPosition_;
-        faceNormal = currentSampleDirection_;
-        smoothNormal = currentSampleDirection_;
-        rayDirection = currentSampleDirection_;
+        faceNormal = sampleDirection;
+        smoothNormal = sampleDirection;
+        rayDirection = sampleDirection;
         albedo = Vector3::ONE;
     }
 
     /// End sample.
-    void EndSample(const Vector3& light)
+    void EndSample(unsigned sampleIndex, const Vector3& light, const Vector3& backgroundTransfer)
     {
-        accumulatedLightSH_ += SphericalHarmonicsColor9(currentSampleDirection_, light);
+        accumulatedLightSH_ += SphericalHarmonicsColor9(sampleDirections_[sampleIndex], light);
+        accumulatedBackgroundSH_ += SphericalHarmonicsColor9(sampleDirections_[sampleIndex], backgroundTransfer);
     }
 
     /// End tracing element.
@@ -773,6 +806,9 @@ struct LightProbeIndirectTracingKernel
         const float weight = M_PI / GetNumSamples();
         const SphericalHarmonicsDot9 sh{ accumulatedLightSH_ * weight };
         bakedData_->sphericalHarmonics_[elementIndex] += sh;
+
+        const SphericalHarmonicsDot9 backgroundSH{ accumulatedBackgroundSH_ * weight };
+        bakedData_->backgroundSphericalHarmonics_[elementIndex] += backgroundSH;
     }
 };
 
@@ -793,61 +829,80 @@ void TraceIndirectLight(T sharedKernel, const ea::vector<const LightmapChartBake
         const auto& geometryIndex = raytracerScene.GetGeometries();
         const RaytracingBackground& background = raytracerScene.GetBackground();
 
-        Vector3 albedo[IndirectLightTracingSettings::MaxBounces];
-        Vector3 incomingSamples[IndirectLightTracingSettings::MaxBounces];
-        float incomingFactors[IndirectLightTracingSettings::MaxBounces];
+        ea::vector<IndirectLightSample> samples;
+        ea::vector<unsigned> activeSamples;
+        ea::vector<unsigned> nextActiveSamples;
+        ea::vector<RTCRayHit> rayHits;
 
-        RTCRayHit rayHit;
         IndirectTracingContext rayContext;
         rtcInitIntersectContext(&rayContext);
         rayContext.geometryIndex_ = &geometryIndex;
         rayContext.filter = TracingFilterIndirect;
 
-        rayHit.ray.tnear = 0.0f;
-        rayHit.ray.time = 0.0f;
-        rayHit.ray.id = 0;
-        rayHit.ray.mask = RaytracerScene::PrimaryLODGeometry;
-        rayHit.ray.flags = 0;
-
         for (unsigned elementIndex = fromIndex; elementIndex < toIndex; ++elementIndex)
         {
             if (!kernel.BeginElement(elementIndex))
                 continue;
 
-            for (unsigned sampleIndex = 0; sampleIndex < kernel.GetNumSamples(); ++sampleIndex)
+            // Begin all samples of the element and trace them bounce by bounce as one ray stream
+            const unsigned numSamples = kernel.GetNumSamples();
+            samples.resize(numSamples);
+            activeSamples.clear();
+            for (unsigned sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
             {
-                Vector3 currentPosition;
-                Vector3 currentFaceNormal;
-                Vector3 currentSmoothNormal;
-                Vector3 currentRayDirection;
+                IndirectLightSample& sample = samples[sampleIndex];
                 kernel.BeginSample(sampleIndex,
-                    currentPosition, currentFaceNormal, currentSmoothNormal, currentRayDirection, albedo[0]);
+                    sample.position_, sample.faceNormal_, sample.smoothNormal_, sample.rayDirection_, sample.albedo_[0]);
+                sample.numBounces_ = 0;
+                sample.hitBackground_ = false;
+                activeSamples.push_back(sampleIndex);
+            }
 
-                int numBounces = 0;
-                for (unsigned bounceIndex = 0; bounceIndex < settings.maxBounces_; ++bounceIndex)
+            for (unsigned bounceIndex = 0; bounceIndex < settings.maxBounces_ && !activeSamples.empty(); ++bounceIndex)
+            {
+                const unsigned numRays = activeSamples.size();
+                rayHits.resize(numRays);
+                for (unsigned rayIndex = 0; rayIndex < numRays; ++rayIndex)
                 {
-                    rayHit.ray.org_x = currentPosition.x_;
-                    rayHit.ray.org_y = currentPosition.y_;
-                    rayHit.ray.org_z = currentPosition.z_;
-                    rayHit.ray.dir_x = currentRayDirection.x_;
-                    rayHit.ray.dir_y = currentRayDirection.y_;
-                    rayHit.ray.dir_z = currentRayDirection.z_;
+                    const IndirectLightSample& sample = samples[activeSamples[rayIndex]];
+                    RTCRayHit& rayHit = rayHits[rayIndex];
+                    rayHit.ray.org_x = sample.position_.x_;
+                    rayHit.ray.org_y = sample.position_.y_;
+                    rayHit.ray.org_z = sample.position_.z_;
+                    rayHit.ray.tnear = 0.0f;
+                    rayHit.ray.dir_x = sample.rayDirection_.x_;
+                    rayHit.ray.dir_y = sample.rayDirection_.y_;
+                    rayHit.ray.dir_z = sample.rayDirection_.z_;
+                    rayHit.ray.time = 0.0f;
                     rayHit.ray.tfar = maxDistance;
+                    rayHit.ray.mask = RaytracerScene::PrimaryLODGeometry;
+                    rayHit.ray.id = rayIndex;
+                    rayHit.ray.flags = 0;
                     rayHit.hit.geomID = RTC_INVALID_GEOMETRY_ID;
-                    rtcIntersect1(scene, &rayContext, &rayHit);
+                    rayHit.hit.instID[0] = RTC_INVALID_GEOMETRY_ID;
+                }
+                rtcIntersect1M(scene, &rayContext, rayHits.data(), numRays, sizeof(RTCRayHit));
+
+                nextActiveSamples.clear();
+                for (unsigned rayIndex = 0; rayIndex < numRays; ++rayIndex)
+                {
+                    const unsigned sampleIndex = activeSamples[rayIndex];
+                    IndirectLightSample& sample = samples[sampleIndex];
+                    const RTCRayHit& rayHit = rayHits[rayIndex];
 
-                    // If hit background, pick light and break
+                    // If hit background, pick light and stop
                     if (rayHit.hit.geomID == RTC_INVALID_GEOMETRY_ID)
                     {
-                        incomingSamples[bounceIndex] = background.SampleBackground(currentRayDirection);
-                        incomingFactors[bounceIndex] = 1.0f;
-                        ++numBounces;
-                        break;
+                        sample.incomingSamples_[bounceIndex] = background.SampleBackground(sample.rayDirection_);
+                        sample.incomingFactors_[bounceIndex] = 1.0f;
+                        sample.hitBackground_ = true;
+                        ++sample.numBounces_;
+                        continue;
                     }
 
                     // Check normal orientation
-                    if (currentRayDirection.DotProduct({ rayHit.hit.Ng_x, rayHit.hit.Ng_y, rayHit.hit.Ng_z }) > 0.0f)
-                        break;
+                    if (sample.rayDirection_.DotProduct({ rayHit.hit.Ng_x, rayHit.hit.Ng_y, rayHit.hit.Ng_z }) > 0.0f)
+                        continue;
 
                     // Sample lightmap UV
                     const RaytracerGeometry& geometry = geometryIndex[rayHit.hit.geomID];
@@ -857,55 +912,65 @@ void TraceIndirectLight(T sharedKernel, const ea::vector<const LightmapChartBake
 
                     // Modify incoming flux
                     const float probability = 1 / (2 * M_PI);
-                    const float cosTheta = ea::max(0.0f, currentRayDirection.DotProduct(currentSmoothNormal));
+                    const float cosTheta = ea::max(0.0f, sample.rayDirection_.DotProduct(sample.smoothNormal_));
                     const float reflectance = 1 / M_PI;
                     const float brdf = reflectance / M_PI;
 
                     const unsigned lightmapIndex = geometry.lightmapIndex_;
                     const IntVector2 sampleLocation = bakedDirect[lightmapIndex]->GetNearestLocation(lightmapUV);
-                    incomingSamples[bounceIndex] = bakedDirect[lightmapIndex]->GetSurfaceLight(sampleLocation);
-                    incomingFactors[bounceIndex] = brdf * cosTheta / probability;
-                    ++numBounces;
+                    sample.incomingSamples_[bounceIndex] = bakedDirect[lightmapIndex]->GetSurfaceLight(sampleLocation);
+                    sample.incomingFactors_[bounceIndex] = brdf * cosTheta / probability;
+                    ++sample.numBounces_;
 
                     // Go to next hemisphere
-                    if (numBounces < settings.maxBounces_)
+                    if (sample.numBounces_ < settings.maxBounces_)
                     {
                         // Update albedo for hit surface
-                        albedo[bounceIndex + 1] = bakedDirect[lightmapIndex]->GetAlbedo(sampleLocation);
+                        sample.albedo_[bounceIndex + 1] = bakedDirect[lightmapIndex]->GetAlbedo(sampleLocation);
 
                         // Move to hit position
-                        currentPosition.x_ = rayHit.ray.org_x + rayHit.ray.dir_x * rayHit.ray.tfar;
-                        currentPosition.y_ = rayHit.ray.org_y + rayHit.ray.dir_y * rayHit.ray.tfar;
-                        currentPosition.z_ = rayHit.ray.org_z + rayHit.ray.dir_z * rayHit.ray.tfar;
+                        Vector3& position = sample.position_;
+                        position.x_ = rayHit.ray.org_x + rayHit.ray.dir_x * rayHit.ray.tfar;
+                        position.y_ = rayHit.ray.org_y + rayHit.ray.dir_y * rayHit.ray.tfar;
+                        position.z_ = rayHit.ray.org_z + rayHit.ray.dir_z * rayHit.ray.tfar;
 
                         // Offset position a bit
                         const Vector3 hitNormal = Vector3(rayHit.hit.Ng_x, rayHit.hit.Ng_y, rayHit.hit.Ng_z).Normalized();
-                        const float bias = settings.scaledPositionBounceBias_ * CalculateBiasScale(currentPosition);
-                        currentPosition.x_ += Sign(hitNormal.x_) * bias + hitNormal.x_ * settings.constPositionBounceBias_;
-                        currentPosition.y_ += Sign(hitNormal.y_) * bias + hitNormal.y_ * settings.constPositionBounceBias_;
-                        currentPosition.z_ += Sign(hitNormal.z_) * bias + hitNormal.z_ * settings.constPositionBounceBias_;
+                        const float bias = settings.scaledPositionBounceBias_ * CalculateBiasScale(position);
+                        position.x_ += Sign(hitNormal.x_) * bias + hitNormal.x_ * settings.constPositionBounceBias_;
+                        position.y_ += Sign(hitNormal.y_) * bias + hitNormal.y_ * settings.constPositionBounceBias_;
+                        position.z_ += Sign(hitNormal.z_) * bias + hitNormal.z_ * settings.constPositionBounceBias_;
 
                         // Update smooth normal
                         rtcInterpolate0(geometry.embreeGeometry_, rayHit.hit.primID, rayHit.hit.u, rayHit.hit.v,
-                            RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, RaytracerScene::NormalAttribute, &currentSmoothNormal.x_, 3);
-                        currentSmoothNormal = currentSmoothNormal.Normalized();
+                            RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, RaytracerScene::NormalAttribute, &sample.smoothNormal_.x_, 3);
+                        sample.smoothNormal_ = sample.smoothNormal_.Normalized();
 
                         // Update face normal and find new direction to sample
-                        currentFaceNormal = hitNormal;
-                        currentRayDirection = RandomHemisphereDirection(currentFaceNormal);
+                        sample.faceNormal_ = hitNormal;
+                        sample.rayDirection_ = RandomHemisphereDirection(sample.faceNormal_);
+                        nextActiveSamples.push_back(sampleIndex);
                     }
                 }
+                ea::swap(activeSamples, nextActiveSamples);
+            }
 
-                // Accumulate samples back-to-front
+            // Accumulate samples back-to-front
+            for (unsigned sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+            {
+                const IndirectLightSample& sample = samples[sampleIndex];
                 Vector3 sampleIndirectLight;
-                for (int bounceIndex = numBounces - 1; bounceIndex >= 0; --bounceIndex)
+                Vector3 sampleBackgroundTransfer = sample.hitBackground_ ? Vector3::ONE : Vector3::ZERO;
+                for (int bounceIndex = static_cast<int>(sample.numBounces_) - 1; bounceIndex >= 0; --bounceIndex)
                 {
-                    sampleIndirectLight += incomingSamples[bounceIndex];
-                    sampleIndirectLight *= incomingFactors[bounceIndex];
-                    sampleIndirectLight *= albedo[bounceIndex];
+                    sampleIndirectLight += sample.incomingSamples_[bounceIndex];
+                    sampleIndirectLight *= sample.incomingFactors_[bounceIndex];
+                    sampleIndirectLight *= sample.albedo_[bounceIndex];
+                    sampleBackgroundTransfer *= sample.incomingFactors_[bounceIndex];
+                    sampleBackgroundTransfer *= sample.albedo_[bounceIndex];
                 }
 
-                kernel.EndSample(sampleIndirectLight);
+                kernel.EndSample(sampleIndex, sampleIndirectLight, sampleBackgroundTransfer);
             }
             kernel.EndElement(elementIndex);
         }
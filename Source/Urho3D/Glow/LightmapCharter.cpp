@@ -86,7 +86,7 @@ LightmapChartRegion AllocateLightmapChartRegion(const LightmapChartingSettings&
     for (LightmapChart& lightmapDesc : charts)
     {
         IntVector2 paddedPosition;
-        if (lightmapDesc.allocator_.Allocate(paddedSize.x_, paddedSize.y_, paddedPosition.x_, paddedPosition.y_))
+        if (lightmapDesc.Allocate(paddedSize, paddedPosition))
         {
             const IntVector2 position = paddedPosition + padding * IntVector2::ONE;
             return { chartIndex, position, size, settings.lightmapSize_ };
@@ -99,7 +99,7 @@ LightmapChartRegion AllocateLightmapChartRegion(const LightmapChartingSettings&
 
     // Allocate region from the new chart
     IntVector2 paddedPosition;
-    const bool success = chart.allocator_.Allocate(paddedSize.x_, paddedSize.y_, paddedPosition.x_, paddedPosition.y_);
+    const bool success = chart.Allocate(paddedSize, paddedPosition);
 
     assert(success);
     assert(paddedPosition == IntVector2::ZERO);
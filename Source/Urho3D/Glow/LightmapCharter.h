@@ -93,6 +93,10 @@ struct LightmapChart
     AreaAllocator allocator_;
     /// Allocated elements.
     ea::vector<LightmapChartElement> elements_;
+    /// Number of texels not allocated yet.
+    int freeArea_{};
+    /// Smallest size that failed to allocate. Regions not smaller than this in both dimensions are rejected quickly.
+    IntVector2 rejectedSize_{ M_MAX_INT, M_MAX_INT };
 
     /// Construct default.
     LightmapChart() = default;
@@ -101,8 +105,26 @@ struct LightmapChart
         : index_(index)
         , lightmapSize_{ size }
         , allocator_{ static_cast<int>(size), static_cast<int>(size), 0, 0, false }
+        , freeArea_(static_cast<int>(size * size))
     {
     }
+
+    /// Try to allocate region of given size.
+    bool Allocate(const IntVector2& size, IntVector2& position)
+    {
+        if (size.x_ * size.y_ > freeArea_ || (size.x_ >= rejectedSize_.x_ && size.y_ >= rejectedSize_.y_))
+            return false;
+
+        if (!allocator_.Allocate(size.x_, size.y_, position.x_, position.y_))
+        {
+            if (static_cast<long long>(size.x_) * size.y_ < static_cast<long long>(rejectedSize_.x_) * rejectedSize_.y_)
+                rejectedSize_ = size;
+            return false;
+        }
+
+        freeArea_ -= size.x_ * size.y_;
+        return true;
+    }
 };
 
 /// Vector of lightmap charts.
@@ -63,14 +63,51 @@ float GetLuminance(const T& color)
     return Color{ color.x_, color.y_, color.z_ }.Luma();
 }
 
+/// Precomputed tap of filter kernel.
+struct FilterKernelTap
+{
+    /// Offset in texels.
+    IntVector2 offset_;
+    /// Gauss kernel weight.
+    float kernelWeight_{};
+    /// Inverse position sigma. Zero if position difference is ignored.
+    float invPositionSigma_{};
+};
+
+/// Precompute kernel taps, except the center one.
+ea::vector<FilterKernelTap> GetKernelTaps(const EdgeStoppingGaussFilterParameters& params)
+{
+    const ea::span<const float> kernelWeights = GetKernel(params.kernelRadius_);
+
+    ea::vector<FilterKernelTap> taps;
+    for (int dy = -params.kernelRadius_; dy <= params.kernelRadius_; ++dy)
+    {
+        for (int dx = -params.kernelRadius_; dx <= params.kernelRadius_; ++dx)
+        {
+            if (dx == 0 && dy == 0)
+                continue;
+
+            const float dxdy = Vector2{ static_cast<float>(dx), static_cast<float>(dy) }.Length();
+            const float positionSigma = dxdy * params.positionSigma_;
+
+            FilterKernelTap tap;
+            tap.offset_ = IntVector2{ dx, dy } * params.upscale_;
+            tap.kernelWeight_ = kernelWeights[Abs(dx)] * kernelWeights[Abs(dy)];
+            tap.invPositionSigma_ = positionSigma > M_EPSILON ? 1.0f / positionSigma : 0.0f;
+            taps.push_back(tap);
+        }
+    }
+    return taps;
+}
+
 /// Calculate edge-stopping weight.
 float CalculateEdgeWeight(
-    float luminance1, float luminance2, float luminanceSigma,
-    const Vector3& position1, const Vector3& position2, float positionSigma,
+    float luminance1, float luminance2, float invLuminanceSigma,
+    const Vector3& position1, const Vector3& position2, float invPositionSigma,
     const Vector3& normal1, const Vector3& normal2, float normalPower)
 {
-    const float colorWeight = Abs(luminance1 - luminance2) / luminanceSigma;
-    const float positionWeight = positionSigma > M_EPSILON ? (position1 - position2).LengthSquared() / positionSigma : 0.0f;
+    const float colorWeight = Abs(luminance1 - luminance2) * invLuminanceSigma;
+    const float positionWeight = (position1 - position2).LengthSquared() * invPositionSigma;
     const float normalWeight = Pow(ea::max(0.0f, normal1.DotProduct(normal2)), normalPower);
 
     return std::exp(0.0f - colorWeight - positionWeight) * normalWeight;
@@ -83,6 +120,18 @@ void FilterArray(const ea::vector<T>& input, ea::vector<T>& output,
     const EdgeStoppingGaussFilterParameters& params, unsigned numTasks)
 {
     const ea::span<const float> kernelWeights = GetKernel(params.kernelRadius_);
+    const ea::vector<FilterKernelTap> taps = GetKernelTaps(params);
+    const float invLuminanceSigma = 1.0f / params.luminanceSigma_;
+
+    // Calculate luminance once per texel instead of once per tap
+    ea::vector<float> luminance(input.size());
+    ParallelFor(input.size(), numTasks,
+        [&](unsigned fromIndex, unsigned toIndex)
+    {
+        for (unsigned index = fromIndex; index < toIndex; ++index)
+            luminance[index] = GetLuminance(input[index]);
+    });
+
     ParallelFor(input.size(), numTasks,
         [&](unsigned fromIndex, unsigned toIndex)
     {
@@ -98,40 +147,29 @@ void FilterArray(const ea::vector<T>& input, ea::vector<T>& output,
             const IntVector2 centerLocation = geometryBuffer.IndexToLocation(index);
 
             const T centerColor = input[index];
-            const float centerLuminance = GetLuminance(centerColor);
+            const float centerLuminance = luminance[index];
             const Vector3 centerPosition = geometryBuffer.positions_[index];
             const Vector3 centerNormal = geometryBuffer.smoothNormals_[index];
 
             float colorWeight = kernelWeights[0] * kernelWeights[0];
             T colorSum = centerColor * colorWeight;
-            for (int dy = -params.kernelRadius_; dy <= params.kernelRadius_; ++dy)
+            for (const FilterKernelTap& tap : taps)
             {
-                for (int dx = -params.kernelRadius_; dx <= params.kernelRadius_; ++dx)
-                {
-                    if (dx == 0 && dy == 0)
-                        continue;
-
-                    const IntVector2 offset = IntVector2{ dx, dy } * params.upscale_;
-                    const IntVector2 otherLocation = centerLocation + offset;
-                    if (!geometryBuffer.IsValidLocation(otherLocation))
-                        continue;
-
-                    const float dxdy = Vector2{ static_cast<float>(dx), static_cast<float>(dy) }.Length();
-                    const float kernel = kernelWeights[Abs(dx)] * kernelWeights[Abs(dy)];
-
-                    const unsigned otherIndex = geometryBuffer.LocationToIndex(otherLocation);
-                    const unsigned otherGeometryId = geometryBuffer.geometryIds_[otherIndex];
-                    if (!otherGeometryId)
-                        continue;
-
-                    const T otherColor = input[otherIndex];
-                    const float weight = CalculateEdgeWeight(centerLuminance, GetLuminance(otherColor), params.luminanceSigma_,
-                        centerPosition, geometryBuffer.positions_[otherIndex], dxdy * params.positionSigma_,
-                        centerNormal, geometryBuffer.smoothNormals_[otherIndex], params.normalPower_);
-
-                    colorSum += otherColor * weight * kernel;
-                    colorWeight += weight * kernel;
-                }
+                const IntVector2 otherLocation = centerLocation + tap.offset_;
+                if (!geometryBuffer.IsValidLocation(otherLocation))
+                    continue;
+
+                const unsigned otherIndex = geometryBuffer.LocationToIndex(otherLocation);
+                const unsigned otherGeometryId = geometryBuffer.geometryIds_[otherIndex];
+                if (!otherGeometryId)
+                    continue;
+
+                const float weight = CalculateEdgeWeight(centerLuminance, luminance[otherIndex], invLuminanceSigma,
+                    centerPosition, geometryBuffer.positions_[otherIndex], tap.invPositionSigma_,
+                    centerNormal, geometryBuffer.smoothNormals_[otherIndex], params.normalPower_);
+
+                colorSum += input[otherIndex] * (weight * tap.kernelWeight_);
+                colorWeight += weight * tap.kernelWeight_;
             }
 
             output[index] = colorSum / ea::max(M_EPSILON, colorWeight);
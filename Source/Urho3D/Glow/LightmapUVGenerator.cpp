@@ -22,6 +22,10 @@
 
 #include "../Glow/LightmapUVGenerator.h"
 
+#include "../Glow/Helpers.h"
+
+#include <EASTL/unordered_map.h>
+
 #include <xatlas.h>
 
 namespace Urho3D
@@ -126,4 +130,95 @@ bool GenerateLightmapUV(ModelView& modelView, const LightmapUVGenerationSettings
     return true;
 }
 
+unsigned GetLightmapUVInputHash(const ModelView& model, const LightmapUVGenerationSettings& settings)
+{
+    unsigned hash = static_cast<unsigned>(FloatToRawIntBits(settings.texelPerUnit_));
+    CombineHash(hash, settings.uvChannel_);
+
+    // ModelVertex consists of floats only, so raw data is hashed
+    static_assert(sizeof(ModelVertex) % sizeof(unsigned) == 0, "ModelVertex must be hashable as array of unsigned");
+    for (const GeometryView& geometryView : model.GetGeometries())
+    {
+        CombineHash(hash, geometryView.lods_.size());
+        for (const GeometryLODView& geometryLodView : geometryView.lods_)
+        {
+            CombineHash(hash, FloatToRawIntBits(geometryLodView.lodDistance_));
+            CombineHash(hash, geometryLodView.vertices_.size());
+            CombineHash(hash, geometryLodView.indices_.size());
+
+            const auto vertexData = reinterpret_cast<const unsigned*>(geometryLodView.vertices_.data());
+            const unsigned vertexDataSize = geometryLodView.vertices_.size() * sizeof(ModelVertex) / sizeof(unsigned);
+            for (unsigned i = 0; i < vertexDataSize; ++i)
+                CombineHash(hash, vertexData[i]);
+            for (unsigned index : geometryLodView.indices_)
+                CombineHash(hash, index);
+        }
+    }
+    return hash;
+}
+
+ea::vector<bool> GenerateLightmapUVs(const ea::vector<ModelView*>& models,
+    const LightmapUVGenerationSettings& settings, unsigned numTasks)
+{
+    const unsigned numModels = models.size();
+
+    // Find unique models
+    ea::vector<unsigned> sourceModels(numModels);
+    ea::vector<unsigned> uniqueModels;
+    ea::unordered_map<unsigned, unsigned> hashToModel;
+    for (unsigned i = 0; i < numModels; ++i)
+    {
+        const unsigned hash = GetLightmapUVInputHash(*models[i], settings);
+        const auto iter = hashToModel.find(hash);
+        if (iter != hashToModel.end())
+            sourceModels[i] = iter->second;
+        else
+        {
+            hashToModel.emplace(hash, i);
+            sourceModels[i] = i;
+            uniqueModels.push_back(i);
+        }
+    }
+
+    // Generate UVs for unique models
+    ea::vector<bool> result(numModels);
+    ParallelFor(uniqueModels.size(), ea::max(1u, ea::min(numTasks, uniqueModels.size())),
+        [&](unsigned fromIndex, unsigned toIndex)
+    {
+        for (unsigned i = fromIndex; i < toIndex; ++i)
+        {
+            const unsigned modelIndex = uniqueModels[i];
+            result[modelIndex] = GenerateLightmapUV(*models[modelIndex], settings);
+        }
+    });
+
+    // Copy results to duplicates
+    for (unsigned i = 0; i < numModels; ++i)
+    {
+        const unsigned sourceIndex = sourceModels[i];
+        if (sourceIndex == i)
+            continue;
+
+        result[i] = result[sourceIndex];
+        if (!result[i])
+            continue;
+
+        const ModelView& sourceModel = *models[sourceIndex];
+        ModelView& model = *models[i];
+
+        ModelVertexFormat vertexFormat = model.GetVertexFormat();
+        vertexFormat.uv_[settings.uvChannel_] = TYPE_VECTOR2;
+        model.SetVertexFormat(vertexFormat);
+        model.GetGeometries() = sourceModel.GetGeometries();
+
+        for (const ea::string& key : { LightmapUVGenerationSettings::LightmapSizeKey,
+            LightmapUVGenerationSettings::LightmapDensityKey, LightmapUVGenerationSettings::LightmapSharedUV })
+        {
+            model.AddMetadata(key, sourceModel.GetMetadata(key));
+        }
+    }
+
+    return result;
+}
+
 }
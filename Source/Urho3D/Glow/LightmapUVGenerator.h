@@ -50,4 +50,13 @@ struct URHO3D_API LightmapUVGenerationSettings
 /// Generate lightmap UVs for the model.
 bool URHO3D_API GenerateLightmapUV(ModelView& model, const LightmapUVGenerationSettings& settings);
 
+/// Return hash of model geometry and settings used for lightmap UV generation.
+unsigned URHO3D_API GetLightmapUVInputHash(const ModelView& model, const LightmapUVGenerationSettings& settings);
+
+/// Generate lightmap UVs for multiple models in parallel.
+/// Models with equal geometry are processed once, and the result is copied to the others.
+/// Return whether generation succeeded for each model.
+ea::vector<bool> URHO3D_API GenerateLightmapUVs(const ea::vector<ModelView*>& models,
+    const LightmapUVGenerationSettings& settings, unsigned numTasks);
+
 }
@@ -139,11 +139,16 @@ struct ModelModelViewPair
 };
 
 /// Parse model data.
-ModelModelViewPair ParseModelForRaytracer(Model* model, bool needLightmapUVAndNormal, unsigned uvChannel)
+ModelModelViewPair ParseModelForRaytracer(Model* model)
 {
     auto modelView = MakeShared<ModelView>(model->GetContext());
     modelView->ImportModel(model);
+    return { model, modelView };
+}
 
+/// Return whether the parsed model has vertex attributes required for raytracing.
+bool CheckModelForRaytracer(const Model* model, const ModelView* modelView, bool needLightmapUVAndNormal, unsigned uvChannel)
+{
     const ModelVertexFormat vertexFormat = modelView->GetVertexFormat();
     const bool missingPosition = vertexFormat.position_ == ModelVertexFormat::Undefined;
     const bool missingNormal = vertexFormat.normal_ == ModelVertexFormat::Undefined;
@@ -152,10 +157,10 @@ ModelModelViewPair ParseModelForRaytracer(Model* model, bool needLightmapUVAndNo
     if (missingPosition || (needLightmapUVAndNormal && (missingNormal || missingUv1)))
     {
         URHO3D_LOGERROR("Model \"{}\" doesn't have required vertex attributes", model->GetName());
-        return {};
+        return false;
     }
 
-    return { model, modelView };
+    return true;
 }
 
 /// Create Embree geometry from geometry view.
@@ -243,11 +248,9 @@ RTCGeometry CreateEmbreeGeometryForGeometryView(RTCDevice embreeDevice, const Ra
         }
     }
 
-    unsigned* indices = reinterpret_cast<unsigned*>(rtcSetNewGeometryBuffer(embreeGeometry, RTC_BUFFER_TYPE_INDEX,
-        0, RTC_FORMAT_UINT3, sizeof(unsigned) * 3, numIndices / 3));
-
-    for (unsigned i = 0; i < numIndices; ++i)
-        indices[i] = params.geometry_->indices_[i];
+    // Index buffer is owned by parsed model and shared between all instances of the model
+    rtcSetSharedGeometryBuffer(embreeGeometry, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3,
+        params.geometry_->indices_.data(), 0, sizeof(unsigned) * 3, numIndices / 3);
 
     rtcSetGeometryMask(embreeGeometry, params.lightmapping_.GetMask());
     rtcCommitGeometry(embreeGeometry);
@@ -376,7 +379,7 @@ ea::vector<RaytracerGeometry> CreateRaytracerGeometriesForStaticModel(RTCDevice
 
     ea::vector<RaytracerGeometry> result;
 
-    const ea::vector<GeometryView> geometries = modelView->GetGeometries();
+    const ea::vector<GeometryView>& geometries = modelView->GetGeometries();
     for (unsigned geometryIndex = 0; geometryIndex < geometries.size(); ++geometryIndex)
     {
         const Material* material = staticModel->GetMaterial(geometryIndex);
@@ -449,17 +452,57 @@ ea::vector<RaytracerGeometry> CreateRaytracerGeometriesForTerrain(RTCDevice embr
 
 }
 
+RaytracerResourceCache::RaytracerResourceCache(Context* context)
+    : context_(context)
+    , device_(rtcNewDevice(""))
+{
+}
+
+RaytracerResourceCache::~RaytracerResourceCache()
+{
+    // Parsed models may be referenced by geometries, release device last
+    parsedModels_.clear();
+    if (device_)
+        rtcReleaseDevice(device_);
+}
+
+void RaytracerResourceCache::ParseModels(const ea::vector<Model*>& models)
+{
+    // Start model parsing
+    ea::vector<std::future<ModelModelViewPair>> modelParseTasks;
+    for (Model* model : models)
+    {
+        if (!parsedModels_.contains(model))
+            modelParseTasks.push_back(std::async(ParseModelForRaytracer, model));
+    }
+
+    // Finish model parsing
+    for (auto& task : modelParseTasks)
+    {
+        const ModelModelViewPair& parsedModel = task.get();
+        parsedModels_.emplace(parsedModel.model_, ParsedModel{ SharedPtr<Model>(parsedModel.model_), parsedModel.parsedModel_ });
+    }
+}
+
+ModelView* RaytracerResourceCache::GetParsedModel(Model* model) const
+{
+    const auto iter = parsedModels_.find(model);
+    return iter != parsedModels_.end() ? iter->second.modelView_.Get() : nullptr;
+}
+
 RaytracerScene::~RaytracerScene()
 {
     if (scene_)
         rtcReleaseScene(scene_);
-    if (device_)
-        rtcReleaseDevice(device_);
 }
 
 SharedPtr<RaytracerScene> CreateRaytracingScene(Context* context, const ea::vector<Component*>& geometries,
-    unsigned lightmapUVChannel, const RaytracingBackground& background)
+    unsigned lightmapUVChannel, const RaytracingBackground& background, RaytracerResourceCache* resourceCache)
 {
+    SharedPtr<RaytracerResourceCache> sharedResourceCache(resourceCache);
+    if (!sharedResourceCache)
+        sharedResourceCache = MakeShared<RaytracerResourceCache>(context);
+
     // Queue models for parsing.
     // Value determines whether the model needs lightmap UV and smooth normal.
     ea::hash_map<Model*, bool> modelsToParse;
@@ -473,21 +516,22 @@ SharedPtr<RaytracerScene> CreateRaytracingScene(Context* context, const ea::vect
         }
     }
 
-    // Start model parsing
-    ea::vector<std::future<ModelModelViewPair>> modelParseTasks;
+    // Parse models that are not cached yet
+    ea::vector<Model*> models;
     for (const auto& item : modelsToParse)
-        modelParseTasks.push_back(std::async(ParseModelForRaytracer, item.first, item.second, lightmapUVChannel));
+        models.push_back(item.first);
+    sharedResourceCache->ParseModels(models);
 
-    // Finish model parsing
-    ea::unordered_map<Model*, SharedPtr<ModelView>> parsedModelCache;
-    for (auto& task : modelParseTasks)
+    ea::unordered_map<Model*, ModelView*> parsedModelCache;
+    for (const auto& item : modelsToParse)
     {
-        const ModelModelViewPair& parsedModel = task.get();
-        parsedModelCache.emplace(parsedModel.model_, parsedModel.parsedModel_);
+        ModelView* parsedModel = sharedResourceCache->GetParsedModel(item.first);
+        if (parsedModel && CheckModelForRaytracer(item.first, parsedModel, item.second, lightmapUVChannel))
+            parsedModelCache.emplace(item.first, parsedModel);
     }
 
     // Prepare Embree scene
-    const RTCDevice device = rtcNewDevice("");
+    const RTCDevice device = sharedResourceCache->GetEmbreeDevice();
     const RTCScene scene = rtcNewScene(device);
     rtcSetSceneFlags(scene, RTC_SCENE_FLAG_CONTEXT_FILTER_FUNCTION);
 
@@ -565,7 +609,7 @@ SharedPtr<RaytracerScene> CreateRaytracingScene(Context* context, const ea::vect
     const Vector3 sceneSize = boundingBox.Size();
     const float maxDistance = ea::max({ sceneSize.x_, sceneSize.y_, sceneSize.z_ });
 
-    return MakeShared<RaytracerScene>(context, device, scene, ea::move(geometryIndex), background, maxDistance);
+    return MakeShared<RaytracerScene>(context, sharedResourceCache, scene, ea::move(geometryIndex), background, maxDistance);
 }
 
 }
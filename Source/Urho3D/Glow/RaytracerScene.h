@@ -32,6 +32,7 @@
 #include "../Resource/Image.h"
 #include "../Resource/ImageCube.h"
 
+#include <EASTL/unordered_map.h>
 #include <EASTL/vector.h>
 
 namespace Urho3D
@@ -40,6 +41,8 @@ namespace Urho3D
 class Context;
 class Node;
 class Component;
+class Model;
+class ModelView;
 
 /// Raytracer scene background description.
 struct RaytracingBackground
@@ -136,6 +139,44 @@ inline bool CompareRaytracerGeometryByObject(const RaytracerGeometry& lhs, const
     return lhs.lodIndex_ < rhs.lodIndex_;
 }
 
+/// Resources shared between raytracer scenes, e.g. scenes of different baked chunks.
+/// Owns Embree device and keeps parsed models alive, so they are imported once and index buffers are shared.
+class URHO3D_API RaytracerResourceCache : public RefCounted
+{
+public:
+    /// Construct.
+    explicit RaytracerResourceCache(Context* context);
+    /// Destruct.
+    ~RaytracerResourceCache() override;
+
+    /// Parse models that are not cached yet.
+    void ParseModels(const ea::vector<Model*>& models);
+    /// Return parsed model or null if model is not parsed.
+    ModelView* GetParsedModel(Model* model) const;
+
+    /// Return context.
+    Context* GetContext() const { return context_; }
+    /// Return Embree device.
+    embree3::RTCDevice GetEmbreeDevice() const { return device_; }
+
+private:
+    /// Parsed model entry.
+    struct ParsedModel
+    {
+        /// Model is referenced to keep the key valid.
+        SharedPtr<Model> model_;
+        /// Parsed model.
+        SharedPtr<ModelView> modelView_;
+    };
+
+    /// Context.
+    Context* context_{};
+    /// Embree device.
+    embree3::RTCDevice device_{};
+    /// Parsed models.
+    ea::unordered_map<Model*, ParsedModel> parsedModels_;
+};
+
 /// Scene for ray tracing.
 class URHO3D_API RaytracerScene : public RefCounted
 {
@@ -159,10 +200,10 @@ public:
     static const unsigned AllGeometry = 0xffffffff;
 
     /// Construct.
-    RaytracerScene(Context* context, embree3::RTCDevice embreeDevice, embree3::RTCScene raytracerScene,
+    RaytracerScene(Context* context, RaytracerResourceCache* resourceCache, embree3::RTCScene raytracerScene,
         ea::vector<RaytracerGeometry> geometries, const RaytracingBackground& background, float maxDistance)
         : context_(context)
-        , device_(embreeDevice)
+        , resourceCache_(resourceCache)
         , scene_(raytracerScene)
         , geometries_(ea::move(geometries))
         , background_(background)
@@ -175,7 +216,7 @@ public:
     /// Return context.
     Context* GetContext() const { return context_; }
     /// Return Embree device.
-    embree3::RTCDevice GetEmbreeDevice() const { return device_; }
+    embree3::RTCDevice GetEmbreeDevice() const { return resourceCache_->GetEmbreeDevice(); }
     /// Return Embree scene.
     embree3::RTCScene GetEmbreeScene() const { return scene_; }
     /// Return geometries.
@@ -188,8 +229,8 @@ public:
 private:
     /// Context.
     Context* context_{};
-    /// Embree device.
-    embree3::RTCDevice device_{};
+    /// Shared resources. Keep Embree device and shared geometry buffers alive.
+    SharedPtr<RaytracerResourceCache> resourceCache_;
     /// Embree scene.
     embree3::RTCScene scene_{};
     /// Geometries.
@@ -200,8 +241,9 @@ private:
     float maxDistance_{};
 };
 
-// Create scene for raytracing.
+// Create scene for raytracing. Resources are shared with other scenes if cache is provided.
 URHO3D_API SharedPtr<RaytracerScene> CreateRaytracingScene(Context* context,
-    const ea::vector<Component*>& geometries, unsigned uvChannel, const RaytracingBackground& background);
+    const ea::vector<Component*>& geometries, unsigned uvChannel, const RaytracingBackground& background,
+    RaytracerResourceCache* resourceCache = nullptr);
 
 }
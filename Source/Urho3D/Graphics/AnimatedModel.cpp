@@ -24,10 +24,12 @@
 
 #include <EASTL/sort.h>
 
+#include "../Container/FrameAllocator.h"
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
 #include "../Graphics/AnimatedModel.h"
 #include "../Graphics/Animation.h"
+#include "../Graphics/AnimationPoseCache.h"
 #include "../Graphics/AnimationState.h"
 #include "../Graphics/Batch.h"
 #include "../Graphics/Camera.h"
@@ -42,6 +44,7 @@
 #include "../Graphics/SoftwareModelAnimator.h"
 #include "../Graphics/VertexBuffer.h"
 #include "../IO/Log.h"
+#include "../Math/MathBatch.h"
 #include "../Resource/ResourceCache.h"
 #include "../Resource/ResourceEvents.h"
 #include "../Scene/Scene.h"
@@ -122,7 +125,12 @@ void AnimatedModel::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Draw Distance", GetDrawDistance, SetDrawDistance, float, 0.0f, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Shadow Distance", GetShadowDistance, SetShadowDistance, float, 0.0f, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("LOD Bias", GetLodBias, SetLodBias, float, 1.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("LOD Hysteresis", GetLodHysteresis, SetLodHysteresis, float, 0.0f, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Animation LOD Bias", GetAnimationLodBias, SetAnimationLodBias, float, 1.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Animation Detail Distance", GetAnimationDetailDistance, SetAnimationDetailDistance, float, 0.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Animation Detail Bone Depth", GetAnimationDetailBoneDepth, SetAnimationDetailBoneDepth, unsigned,
+        DEFAULT_ANIMATION_DETAIL_BONE_DEPTH, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Pose Cache Time Step", GetPoseCacheTimeStep, SetPoseCacheTimeStep, float, 0.0f, AM_DEFAULT);
     URHO3D_COPY_BASE_ATTRIBUTES(Drawable);
     URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Bone Animation Enabled", GetBonesEnabledAttr, SetBonesEnabledAttr, VariantVector,
         Variant::emptyVariantVector, AM_FILE | AM_NOEDIT);
@@ -301,7 +309,7 @@ void AnimatedModel::UpdateBatches(const FrameInfo& frame)
     // determination so that animation does not change the scale
     BoundingBox transformedBoundingBox = boundingBox_.Transformed(worldTransform);
     float scale = transformedBoundingBox.Size().DotProduct(DOT_SCALE);
-    float newLodDistance = frame.camera_->GetLodDistance(distance_, scale, lodBias_);
+    float newLodDistance = frame.camera_->GetLodDistance(distance_, scale, lodBias_, frame.viewSize_);
 
     // If model is rendered from several views, use the minimum LOD distance for animation LOD
     if (frame.frameNumber_ != animationLodFrameNumber_)
@@ -331,7 +339,8 @@ void AnimatedModel::UpdateGeometry(const FrameInfo& frame)
     if (skinningDirty_)
         UpdateSkinning();
 
-    if (morphsDirty_)
+    // Distant models keep the morphs from when they were last in detail
+    if (morphsDirty_ && !IsAnimationDetailReduced())
         UpdateMorphs();
 }
 
@@ -572,6 +581,24 @@ void AnimatedModel::SetAnimationLodBias(float bias)
     MarkNetworkUpdate();
 }
 
+void AnimatedModel::SetAnimationDetailDistance(float distance)
+{
+    animationDetailDistance_ = Max(distance, 0.0f);
+    MarkNetworkUpdate();
+}
+
+void AnimatedModel::SetAnimationDetailBoneDepth(unsigned depth)
+{
+    animationDetailBoneDepth_ = depth;
+    MarkNetworkUpdate();
+}
+
+void AnimatedModel::SetPoseCacheTimeStep(float timeStep)
+{
+    poseCacheTimeStep_ = Max(timeStep, 0.0f);
+    MarkNetworkUpdate();
+}
+
 void AnimatedModel::SetUpdateInvisible(bool enable)
 {
     updateInvisible_ = enable;
@@ -735,6 +762,8 @@ void AnimatedModel::SetSkeleton(const Skeleton& skeleton, bool createBones)
         return;
     }
 
+    pose_.InvalidateDepths();
+
     if (isMaster_)
     {
         // Check if bone structure has stayed compatible (reloading the model). In that case retain the old bones and animations
@@ -1221,10 +1250,45 @@ void AnimatedModel::ApplyAnimation()
     // (first AnimatedModel in a node)
     if (isMaster_)
     {
-        skeleton_.ResetSilent();
-        for (auto i = animationStates_.begin(); i !=
-            animationStates_.end(); ++i)
-            (*i)->Apply();
+        // Blend all animations into the pose first, so that each bone node is written only once
+        const bool reducedDetail = IsAnimationDetailReduced();
+        const unsigned maxDepth = reducedDetail ? animationDetailBoneDepth_ : M_MAX_UNSIGNED;
+
+        // Reuse the pose sampled by another model playing the same animations this frame, if any
+        AnimationPoseCache* poseCache = nullptr;
+        AnimationPoseKey poseKey;
+        if (poseCacheTimeStep_ > 0.0f && octant_)
+        {
+            poseCache = octant_->GetRoot()->GetAnimationPoseCache();
+            poseKey.model_ = model_;
+            poseKey.maxDepth_ = maxDepth;
+            for (const SharedPtr<AnimationState>& state : animationStates_)
+            {
+                if (!state->IsEnabled() || (reducedDetail && state->GetBlendMode() == ABM_ADDITIVE))
+                    continue;
+
+                Bone* startBone = state->GetStartBone();
+                poseKey.states_.push_back(AnimationPoseStateKey{state->GetAnimation(),
+                    FloorToInt(state->GetTime() / poseCacheTimeStep_), state->GetWeight(),
+                    startBone ? startBone->nameHash_.Value() : 0, state->GetBlendMode(), state->IsLooped()});
+            }
+        }
+
+        if (!poseCache || !poseCache->GetPose(poseKey, pose_))
+        {
+            pose_.Reset(skeleton_);
+            pose_.maxDepth_ = maxDepth;
+            for (auto i = animationStates_.begin(); i !=
+                animationStates_.end(); ++i)
+            {
+                if (!reducedDetail || (*i)->GetBlendMode() != ABM_ADDITIVE)
+                    (*i)->Apply(pose_);
+            }
+
+            if (poseCache)
+                poseCache->StorePose(poseKey, pose_);
+        }
+        pose_.Commit(skeleton_);
 
         // Skeleton reset and animations apply the node transforms "silently" to avoid repeated marking dirty. Mark dirty now
         node_->MarkDirty();
@@ -1243,30 +1307,31 @@ void AnimatedModel::UpdateSkinning()
     // Use model's world transform in case a bone is missing
     const Matrix3x4& worldTransform = node_->GetWorldTransform();
 
-    // Skinning with global matrices only
-    if (!geometrySkinMatrices_.size())
+    // Gather bone and offset matrices into contiguous arrays, then multiply them in one batch
+    const unsigned numBones = bones.size();
+    FrameVector<Matrix3x4> offsetMatrices(numBones);
+    for (unsigned i = 0; i < numBones; ++i)
     {
-        for (unsigned i = 0; i < bones.size(); ++i)
+        const Bone& bone = bones[i];
+        if (bone.node_)
         {
-            const Bone& bone = bones[i];
-            if (bone.node_)
-                skinMatrices_[i] = bone.node_->GetWorldTransform() * bone.offsetMatrix_;
-            else
-                skinMatrices_[i] = worldTransform;
+            skinMatrices_[i] = bone.node_->GetWorldTransform();
+            offsetMatrices[i] = bone.offsetMatrix_;
+        }
+        else
+        {
+            // Identity offset leaves the model's world transform as is
+            skinMatrices_[i] = worldTransform;
+            offsetMatrices[i] = Matrix3x4::IDENTITY;
         }
     }
-    // Skinning with per-geometry matrices
-    else
+    MultiplyMatrices(skinMatrices_.data(), skinMatrices_.data(), offsetMatrices.data(), numBones);
+
+    // Copy the skin matrices to per-geometry matrices as needed
+    if (geometrySkinMatrices_.size())
     {
-        for (unsigned i = 0; i < bones.size(); ++i)
+        for (unsigned i = 0; i < numBones; ++i)
         {
-            const Bone& bone = bones[i];
-            if (bone.node_)
-                skinMatrices_[i] = bone.node_->GetWorldTransform() * bone.offsetMatrix_;
-            else
-                skinMatrices_[i] = worldTransform;
-
-            // Copy the skin matrix to per-geometry matrices as needed
             for (unsigned j = 0; j < geometrySkinMatrixPtrs_[i].size(); ++j)
                 *geometrySkinMatrixPtrs_[i][j] = skinMatrices_[i];
         }
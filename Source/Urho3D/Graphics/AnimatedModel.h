@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "../Graphics/AnimationState.h"
 #include "../Graphics/Model.h"
 #include "../Graphics/Skeleton.h"
 #include "../Graphics/StaticModel.h"
@@ -30,9 +31,11 @@ namespace Urho3D
 {
 
 class Animation;
-class AnimationState;
 class SoftwareModelAnimator;
 
+/// Default maximum depth of animated bones when animation detail is reduced.
+static const unsigned DEFAULT_ANIMATION_DETAIL_BONE_DEPTH = 4;
+
 /// Animated model component.
 class URHO3D_API AnimatedModel : public StaticModel
 {
@@ -94,6 +97,15 @@ public:
     /// Set animation LOD bias.
     /// @property
     void SetAnimationLodBias(float bias);
+    /// Set animation LOD distance beyond which animation detail is reduced: bones deeper than the detail bone depth are not animated, additive animations are skipped, vertex morphs are frozen and animation controller fades complete instantly. LOD distance is the view distance divided by the model's screen-space size, as used for geometry LOD. 0 (default) disables.
+    /// @property
+    void SetAnimationDetailDistance(float distance);
+    /// Set maximum depth of animated bones when animation detail is reduced. Root bone has depth 0.
+    /// @property
+    void SetAnimationDetailBoneDepth(unsigned depth);
+    /// Set time step for sharing sampled poses between models with the same model resource that play the same animations at the same time, weight and start bone. Animation times within one step are considered equal. Per-bone animation enable flags and track weights are not compared, so enable only on models that do not customize them. 0 (default) disables.
+    /// @property
+    void SetPoseCacheTimeStep(float timeStep);
     /// Set whether to update animation and the bounding box when not visible. Recommended to enable for physically controlled models like ragdolls.
     /// @property
     void SetUpdateInvisible(bool enable);
@@ -134,6 +146,25 @@ public:
     /// @property
     float GetAnimationLodBias() const { return animationLodBias_; }
 
+    /// Return animation LOD distance beyond which animation detail is reduced.
+    /// @property
+    float GetAnimationDetailDistance() const { return animationDetailDistance_; }
+
+    /// Return maximum depth of animated bones when animation detail is reduced.
+    /// @property
+    unsigned GetAnimationDetailBoneDepth() const { return animationDetailBoneDepth_; }
+
+    /// Return animation LOD distance, the minimum of all LOD view distances last frame.
+    /// @property
+    float GetAnimationLodDistance() const { return animationLodDistance_; }
+
+    /// Return whether animation detail is currently reduced due to the LOD distance.
+    bool IsAnimationDetailReduced() const { return animationDetailDistance_ > 0.0f && animationLodDistance_ > animationDetailDistance_; }
+
+    /// Return time step for sharing sampled poses between models.
+    /// @property
+    float GetPoseCacheTimeStep() const { return poseCacheTimeStep_; }
+
     /// Return whether to update animation when not visible.
     /// @property
     bool GetUpdateInvisible() const { return updateInvisible_; }
@@ -223,6 +254,8 @@ private:
 
     /// Skeleton.
     Skeleton skeleton_;
+    /// Bone transforms evaluated by the animation states before being committed to the bone nodes.
+    AnimationPose pose_;
     /// Software model animator.
     SharedPtr<SoftwareModelAnimator> modelAnimator_;
     /// Vertex morphs.
@@ -249,6 +282,12 @@ private:
     float animationLodTimer_;
     /// Animation LOD distance, the minimum of all LOD view distances last frame.
     float animationLodDistance_;
+    /// Animation LOD distance beyond which animation detail is reduced.
+    float animationDetailDistance_{};
+    /// Maximum depth of animated bones when animation detail is reduced.
+    unsigned animationDetailBoneDepth_{DEFAULT_ANIMATION_DETAIL_BONE_DEPTH};
+    /// Time step for sharing sampled poses between models.
+    float poseCacheTimeStep_{};
     /// Update animation when invisible flag.
     bool updateInvisible_;
     /// Animation dirty flag.
@@ -112,6 +112,67 @@ bool AnimationTrack::GetKeyFrameIndex(float time, unsigned& index) const
     return true;
 }
 
+unsigned AnimationTrack::RemoveRedundantKeyFrames(float positionError, float rotationError, float scaleError)
+{
+    const unsigned numKeyFrames = keyFrames_.size();
+    if (numKeyFrames < 2)
+        return 0;
+
+    // Rotation error is compared as the cosine of the half angle between quaternions
+    const float minRotationDot = Cos(Max(rotationError, 0.0f) * 0.5f);
+
+    const auto isWithinError = [&](const AnimationKeyFrame& keyFrame, const Vector3& position, const Quaternion& rotation,
+        const Vector3& scale)
+    {
+        if ((channelMask_ & CHANNEL_POSITION) && (keyFrame.position_ - position).Length() > positionError)
+            return false;
+        if ((channelMask_ & CHANNEL_ROTATION) && Abs(keyFrame.rotation_.DotProduct(rotation)) < minRotationDot)
+            return false;
+        if ((channelMask_ & CHANNEL_SCALE) && (keyFrame.scale_ - scale).Length() > scaleError)
+            return false;
+        return true;
+    };
+
+    // Check whether the keyframes between two keyframes are reproduced by interpolating between them
+    const auto canSkip = [&](unsigned first, unsigned last)
+    {
+        const AnimationKeyFrame& firstKeyFrame = keyFrames_[first];
+        const AnimationKeyFrame& lastKeyFrame = keyFrames_[last];
+        const float timeInterval = lastKeyFrame.time_ - firstKeyFrame.time_;
+        for (unsigned i = first + 1; i < last; ++i)
+        {
+            const AnimationKeyFrame& keyFrame = keyFrames_[i];
+            const float t = timeInterval > 0.0f ? (keyFrame.time_ - firstKeyFrame.time_) / timeInterval : 1.0f;
+            if (!isWithinError(keyFrame, firstKeyFrame.position_.Lerp(lastKeyFrame.position_, t),
+                firstKeyFrame.rotation_.Slerp(lastKeyFrame.rotation_, t), firstKeyFrame.scale_.Lerp(lastKeyFrame.scale_, t)))
+                return false;
+        }
+        return true;
+    };
+
+    // Greedily extend each interpolated segment as far as the error allows. The first and last keyframes are always kept
+    ea::vector<AnimationKeyFrame> keptKeyFrames;
+    keptKeyFrames.push_back(keyFrames_[0]);
+    unsigned segmentStart = 0;
+    for (unsigned i = 2; i < numKeyFrames; ++i)
+    {
+        if (!canSkip(segmentStart, i))
+        {
+            segmentStart = i - 1;
+            keptKeyFrames.push_back(keyFrames_[segmentStart]);
+        }
+    }
+    keptKeyFrames.push_back(keyFrames_.back());
+
+    // Collapse constant track
+    const AnimationKeyFrame& lastKeyFrame = keptKeyFrames.back();
+    if (keptKeyFrames.size() == 2 && isWithinError(keptKeyFrames[0], lastKeyFrame.position_, lastKeyFrame.rotation_, lastKeyFrame.scale_))
+        keptKeyFrames.pop_back();
+
+    keyFrames_ = ea::move(keptKeyFrames);
+    return numKeyFrames - keyFrames_.size();
+}
+
 Animation::Animation(Context* context) :
     ResourceWithMetadata(context),
     length_(0.f)
@@ -130,12 +191,16 @@ bool Animation::BeginLoad(Deserializer& source)
     unsigned memoryUse = sizeof(Animation);
 
     // Check ID
-    if (source.ReadFileID() != "UANI")
+    ea::string fileID = source.ReadFileID();
+    if (fileID != "UANI" && fileID != "UAN2")
     {
         URHO3D_LOGERROR(source.GetName() + " is not a valid animation file");
         return false;
     }
 
+    // Cooked animations store the keyframes in their memory layout, so that they can be read in one go
+    bool hasKeyFrameBlocks = (fileID == "UAN2");
+
     // Read name and length
     animationName_ = source.ReadString();
     animationNameHash_ = animationName_;
@@ -156,6 +221,12 @@ bool Animation::BeginLoad(Deserializer& source)
         memoryUse += keyFrames * sizeof(AnimationKeyFrame);
 
         // Read keyframes of the track
+        if (hasKeyFrameBlocks)
+        {
+            source.Read(newTrack->keyFrames_.data(), keyFrames * sizeof(AnimationKeyFrame));
+            continue;
+        }
+
         for (unsigned j = 0; j < keyFrames; ++j)
         {
             AnimationKeyFrame& newKeyFrame = newTrack->keyFrames_[j];
@@ -230,7 +301,7 @@ bool Animation::BeginLoad(Deserializer& source)
 bool Animation::Save(Serializer& dest) const
 {
     // Write ID, name and length
-    dest.WriteFileID("UANI");
+    dest.WriteFileID("UAN2");
     dest.WriteString(animationName_);
     dest.WriteFloat(length_);
 
@@ -244,17 +315,7 @@ bool Animation::Save(Serializer& dest) const
         dest.WriteUInt(track.keyFrames_.size());
 
         // Write keyframes of the track
-        for (unsigned j = 0; j < track.keyFrames_.size(); ++j)
-        {
-            const AnimationKeyFrame& keyFrame = track.keyFrames_[j];
-            dest.WriteFloat(keyFrame.time_);
-            if (track.channelMask_ & CHANNEL_POSITION)
-                dest.WriteVector3(keyFrame.position_);
-            if (track.channelMask_ & CHANNEL_ROTATION)
-                dest.WriteQuaternion(keyFrame.rotation_);
-            if (track.channelMask_ & CHANNEL_SCALE)
-                dest.WriteVector3(keyFrame.scale_);
-        }
+        dest.Write(track.keyFrames_.data(), track.keyFrames_.size() * sizeof(AnimationKeyFrame));
     }
 
     // If triggers have been defined, write an XML file for them
@@ -372,6 +433,14 @@ void Animation::SetNumTriggers(unsigned num)
     triggers_.resize(num);
 }
 
+unsigned Animation::RemoveRedundantKeyFrames(float positionError, float rotationError, float scaleError)
+{
+    unsigned numRemoved = 0;
+    for (auto i = tracks_.begin(); i != tracks_.end(); ++i)
+        numRemoved += i->second.RemoveRedundantKeyFrames(positionError, rotationError, scaleError);
+    return numRemoved;
+}
+
 SharedPtr<Animation> Animation::Clone(const ea::string& cloneName) const
 {
     SharedPtr<Animation> ret(context_->CreateObject<Animation>());
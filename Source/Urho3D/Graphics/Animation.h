@@ -42,6 +42,13 @@ enum AnimationChannel : unsigned char
 };
 URHO3D_FLAGSET(AnimationChannel, AnimationChannelFlags);
 
+/// Default position error for keyframe reduction.
+static const float DEFAULT_ANIMATION_POSITION_ERROR = 0.0005f;
+/// Default rotation error in degrees for keyframe reduction.
+static const float DEFAULT_ANIMATION_ROTATION_ERROR = 0.05f;
+/// Default scale error for keyframe reduction.
+static const float DEFAULT_ANIMATION_SCALE_ERROR = 0.0005f;
+
 /// Skeletal animation keyframe.
 struct AnimationKeyFrame
 {
@@ -74,6 +81,8 @@ struct AnimationKeyFrame
     Vector3 scale_;
 };
 
+static_assert(sizeof(AnimationKeyFrame) == 11 * sizeof(float), "Cooked animation files store keyframes in their memory layout");
+
 /// Skeletal animation track, stores keyframes of a single bone.
 /// @fakeref
 struct URHO3D_API AnimationTrack
@@ -102,6 +111,8 @@ struct URHO3D_API AnimationTrack
     unsigned GetNumKeyFrames() const { return keyFrames_.size(); }
     /// Return keyframe index based on time and previous index. Return false if animation is empty.
     bool GetKeyFrameIndex(float time, unsigned& index) const;
+    /// Remove keyframes that interpolation between the remaining keyframes reproduces within the given errors. Position and scale errors are absolute, rotation error is in degrees. A track that stays constant collapses to a single keyframe. Return number of removed keyframes.
+    unsigned RemoveRedundantKeyFrames(float positionError, float rotationError, float scaleError);
 
     /// Bone or scene node name.
     ea::string name_;
@@ -197,6 +208,9 @@ public:
     /// Resize trigger point vector.
     /// @property
     void SetNumTriggers(unsigned num);
+    /// Remove redundant keyframes from all tracks to reduce memory use and sampling cost. Return number of removed keyframes. This is unsafe if the animation is currently used in playback.
+    unsigned RemoveRedundantKeyFrames(float positionError = DEFAULT_ANIMATION_POSITION_ERROR,
+        float rotationError = DEFAULT_ANIMATION_ROTATION_ERROR, float scaleError = DEFAULT_ANIMATION_SCALE_ERROR);
     /// Clone the animation.
     SharedPtr<Animation> Clone(const ea::string& cloneName = EMPTY_STRING) const;
 
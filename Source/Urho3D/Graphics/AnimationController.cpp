@@ -87,6 +87,10 @@ void AnimationController::OnSetEnabled()
 
 void AnimationController::Update(float timeStep)
 {
+    // Fades are not noticeable on models with reduced animation detail, so complete them at once
+    auto* model = GetComponent<AnimatedModel>();
+    const bool skipFades = model && model->IsAnimationDetailReduced();
+
     // Loop through animations
     for (unsigned i = 0; i < animations_.size();)
     {
@@ -116,7 +120,7 @@ void AnimationController::Update(float timeStep)
             float currentWeight = state->GetWeight();
             if (currentWeight != targetWeight)
             {
-                if (fadeTime > 0.0f)
+                if (fadeTime > 0.0f && !skipFades)
                 {
                     float weightDelta = 1.0f / fadeTime * timeStep;
                     if (currentWeight < targetWeight)
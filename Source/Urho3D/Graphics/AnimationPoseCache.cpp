@@ -0,0 +1,78 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Graphics/AnimationPoseCache.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+unsigned AnimationPoseKey::ToHash() const
+{
+    unsigned hash = 0;
+    CombineHash(hash, MakeHash(model_));
+    CombineHash(hash, maxDepth_);
+    for (const AnimationPoseStateKey& state : states_)
+    {
+        CombineHash(hash, MakeHash(state.animation_));
+        CombineHash(hash, (unsigned)state.time_);
+        CombineHash(hash, MakeHash(state.weight_));
+        CombineHash(hash, state.startBone_);
+    }
+    return hash;
+}
+
+void AnimationPoseCache::Clear()
+{
+    MutexLock lock(poseMutex_);
+    poses_.clear();
+}
+
+bool AnimationPoseCache::GetPose(const AnimationPoseKey& key, AnimationPose& pose) const
+{
+    const AnimationPose* cachedPose = nullptr;
+    {
+        MutexLock lock(poseMutex_);
+        const auto iter = poses_.find(key);
+        if (iter == poses_.end())
+            return false;
+        cachedPose = iter->second.get();
+    }
+
+    // Stored poses are never modified until the cache is cleared, so they can be copied without the lock
+    pose.positions_ = cachedPose->positions_;
+    pose.rotations_ = cachedPose->rotations_;
+    pose.scales_ = cachedPose->scales_;
+    return true;
+}
+
+void AnimationPoseCache::StorePose(const AnimationPoseKey& key, const AnimationPose& pose)
+{
+    auto cachedPose = ea::make_unique<AnimationPose>(pose);
+    MutexLock lock(poseMutex_);
+    poses_.emplace(key, ea::move(cachedPose));
+}
+
+}
@@ -0,0 +1,106 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include <EASTL/unique_ptr.h>
+#include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
+
+#include "../Core/Mutex.h"
+#include "../Graphics/AnimationState.h"
+
+namespace Urho3D
+{
+
+class Animation;
+class Model;
+
+/// Animation state parameters that determine the sampled pose.
+struct AnimationPoseStateKey
+{
+    /// Animation.
+    const Animation* animation_{};
+    /// Quantized time position.
+    int time_{};
+    /// Blending weight.
+    float weight_{};
+    /// Start bone name hash.
+    unsigned startBone_{};
+    /// Blending mode.
+    AnimationBlendMode blendMode_{};
+    /// Looped flag.
+    bool looped_{};
+
+    /// Test for equality.
+    bool operator ==(const AnimationPoseStateKey& rhs) const
+    {
+        return animation_ == rhs.animation_ && time_ == rhs.time_ && weight_ == rhs.weight_ && startBone_ == rhs.startBone_
+            && blendMode_ == rhs.blendMode_ && looped_ == rhs.looped_;
+    }
+};
+
+/// Key of a cached pose: the model providing the skeleton and all applied animation states in order.
+struct AnimationPoseKey
+{
+    /// Model.
+    const Model* model_{};
+    /// Maximum depth of animated bones.
+    unsigned maxDepth_{};
+    /// Applied animation states.
+    ea::vector<AnimationPoseStateKey> states_;
+
+    /// Test for equality.
+    bool operator ==(const AnimationPoseKey& rhs) const
+    {
+        return model_ == rhs.model_ && maxDepth_ == rhs.maxDepth_ && states_ == rhs.states_;
+    }
+
+    /// Return hash value.
+    unsigned ToHash() const;
+};
+
+/// Per-frame cache of sampled skeleton poses, shared by the animated models of an octree. Models that play the same animations at the same quantized time reuse one sampled pose instead of evaluating the animation tracks again. Safe to use from drawable updates in worker threads.
+/// @nobind
+class URHO3D_API AnimationPoseCache
+{
+public:
+    /// Discard poses of the previous frame.
+    void Clear();
+    /// Copy the cached pose for the key into the destination. Return false if not found.
+    bool GetPose(const AnimationPoseKey& key, AnimationPose& pose) const;
+    /// Store a sampled pose. Does nothing if the key is already cached.
+    void StorePose(const AnimationPoseKey& key, const AnimationPose& pose);
+
+    /// Return number of cached poses.
+    unsigned GetNumPoses() const { return poses_.size(); }
+
+private:
+    /// Cached poses.
+    ea::unordered_map<AnimationPoseKey, ea::unique_ptr<AnimationPose>> poses_;
+    /// Mutex for access from worker threads.
+    mutable Mutex poseMutex_;
+};
+
+}
@@ -36,6 +36,7 @@ namespace Urho3D
 AnimationStateTrack::AnimationStateTrack() :
     track_(nullptr),
     bone_(nullptr),
+    boneIndex_(0),
     weight_(1.0f),
     keyFrame_(0)
 {
@@ -43,6 +44,46 @@ AnimationStateTrack::AnimationStateTrack() :
 
 AnimationStateTrack::~AnimationStateTrack() = default;
 
+void AnimationPose::Reset(const Skeleton& skeleton)
+{
+    const ea::vector<Bone>& bones = skeleton.GetBones();
+    positions_.resize(bones.size());
+    rotations_.resize(bones.size());
+    scales_.resize(bones.size());
+
+    for (unsigned i = 0; i < bones.size(); ++i)
+    {
+        positions_[i] = bones[i].initialPosition_;
+        rotations_[i] = bones[i].initialRotation_;
+        scales_[i] = bones[i].initialScale_;
+    }
+
+    if (depths_.size() != bones.size())
+    {
+        depths_.resize(bones.size());
+        for (unsigned i = 0; i < bones.size(); ++i)
+        {
+            // Walk up to the root. Guard against malformed hierarchies with a depth limit
+            unsigned depth = 0;
+            for (unsigned index = i; bones[index].parentIndex_ != index && bones[index].parentIndex_ < bones.size()
+                && depth < bones.size(); index = bones[index].parentIndex_)
+                ++depth;
+            depths_[i] = depth;
+        }
+    }
+}
+
+void AnimationPose::Commit(Skeleton& skeleton) const
+{
+    ea::vector<Bone>& bones = skeleton.GetModifiableBones();
+    for (unsigned i = 0; i < bones.size() && i < positions_.size(); ++i)
+    {
+        Bone& bone = bones[i];
+        if (bone.animated_ && bone.node_)
+            bone.node_->SetTransformSilent(positions_[i], rotations_[i], scales_[i]);
+    }
+}
+
 AnimationState::AnimationState(AnimatedModel* model, Animation* animation) :
     model_(model),
     animation_(animation),
@@ -150,6 +191,7 @@ void AnimationState::SetStartBone(Bone* startBone)
         if (trackBone && trackBone->node_)
         {
             stateTrack.bone_ = trackBone;
+            stateTrack.boneIndex_ = (unsigned)(trackBone - skeleton.GetModifiableBones().data());
             stateTrack.node_ = trackBone->node_;
             stateTracks_.push_back(stateTrack);
         }
@@ -453,6 +495,34 @@ void AnimationState::Apply()
         ApplyToNodes();
 }
 
+void AnimationState::Apply(AnimationPose& pose)
+{
+    if (!animation_ || !IsEnabled())
+        return;
+
+    if (!model_)
+    {
+        ApplyToNodes();
+        return;
+    }
+
+    for (auto i = stateTracks_.begin(); i != stateTracks_.end(); ++i)
+    {
+        AnimationStateTrack& stateTrack = *i;
+        float finalWeight = weight_ * stateTrack.weight_;
+
+        // Do not apply if zero effective weight, the bone has animation disabled or its node is gone
+        if (Equals(finalWeight, 0.0f) || !stateTrack.bone_->animated_ || !stateTrack.node_ || stateTrack.boneIndex_ >= pose.positions_.size())
+            continue;
+
+        const unsigned index = stateTrack.boneIndex_;
+        if (pose.depths_[index] > pose.maxDepth_)
+            continue;
+
+        BlendTrack(stateTrack, finalWeight, pose.positions_[index], pose.rotations_[index], pose.scales_[index]);
+    }
+}
+
 void AnimationState::ApplyToModel()
 {
     for (auto i = stateTracks_.begin(); i != stateTracks_.end(); ++i)
@@ -477,12 +547,44 @@ void AnimationState::ApplyToNodes()
 
 void AnimationState::ApplyTrack(AnimationStateTrack& stateTrack, float weight, bool silent)
 {
-    const AnimationTrack* track = stateTrack.track_;
     Node* node = stateTrack.node_;
+    if (!node)
+        return;
 
-    if (track->keyFrames_.empty() || !node)
+    Vector3 newPosition = node->GetPosition();
+    Quaternion newRotation = node->GetRotation();
+    Vector3 newScale = node->GetScale();
+    if (!BlendTrack(stateTrack, weight, newPosition, newRotation, newScale))
         return;
 
+    const AnimationChannelFlags channelMask = stateTrack.track_->channelMask_;
+    if (silent)
+    {
+        if (channelMask & CHANNEL_POSITION)
+            node->SetPositionSilent(newPosition);
+        if (channelMask & CHANNEL_ROTATION)
+            node->SetRotationSilent(newRotation);
+        if (channelMask & CHANNEL_SCALE)
+            node->SetScaleSilent(newScale);
+    }
+    else
+    {
+        if (channelMask & CHANNEL_POSITION)
+            node->SetPosition(newPosition);
+        if (channelMask & CHANNEL_ROTATION)
+            node->SetRotation(newRotation);
+        if (channelMask & CHANNEL_SCALE)
+            node->SetScale(newScale);
+    }
+}
+
+bool AnimationState::BlendTrack(AnimationStateTrack& stateTrack, float weight, Vector3& position, Quaternion& rotation,
+    Vector3& scale)
+{
+    const AnimationTrack* track = stateTrack.track_;
+    if (track->keyFrames_.empty())
+        return false;
+
     unsigned& frame = stateTrack.keyFrame_;
     track->GetKeyFrameIndex(time_, frame);
 
@@ -537,19 +639,19 @@ void AnimationState::ApplyTrack(AnimationStateTrack& stateTrack, float weight, b
         if (channelMask & CHANNEL_POSITION)
         {
             Vector3 delta = newPosition - stateTrack.bone_->initialPosition_;
-            newPosition = node->GetPosition() + delta * weight;
+            newPosition = position + delta * weight;
         }
         if (channelMask & CHANNEL_ROTATION)
         {
             Quaternion delta = newRotation * stateTrack.bone_->initialRotation_.Inverse();
-            newRotation = (delta * node->GetRotation()).Normalized();
+            newRotation = (delta * rotation).Normalized();
             if (!Equals(weight, 1.0f))
-                newRotation = node->GetRotation().Slerp(newRotation, weight);
+                newRotation = rotation.Slerp(newRotation, weight);
         }
         if (channelMask & CHANNEL_SCALE)
         {
             Vector3 delta = newScale - stateTrack.bone_->initialScale_;
-            newScale = node->GetScale() + delta * weight;
+            newScale = scale + delta * weight;
         }
     }
     else
@@ -557,32 +659,21 @@ void AnimationState::ApplyTrack(AnimationStateTrack& stateTrack, float weight, b
         if (!Equals(weight, 1.0f)) // not full weight
         {
             if (channelMask & CHANNEL_POSITION)
-                newPosition = node->GetPosition().Lerp(newPosition, weight);
+                newPosition = position.Lerp(newPosition, weight);
             if (channelMask & CHANNEL_ROTATION)
-                newRotation = node->GetRotation().Slerp(newRotation, weight);
+                newRotation = rotation.Slerp(newRotation, weight);
             if (channelMask & CHANNEL_SCALE)
-                newScale = node->GetScale().Lerp(newScale, weight);
+                newScale = scale.Lerp(newScale, weight);
         }
     }
 
-    if (silent)
-    {
-        if (channelMask & CHANNEL_POSITION)
-            node->SetPositionSilent(newPosition);
-        if (channelMask & CHANNEL_ROTATION)
-            node->SetRotationSilent(newRotation);
-        if (channelMask & CHANNEL_SCALE)
-            node->SetScaleSilent(newScale);
-    }
-    else
-    {
-        if (channelMask & CHANNEL_POSITION)
-            node->SetPosition(newPosition);
-        if (channelMask & CHANNEL_ROTATION)
-            node->SetRotation(newRotation);
-        if (channelMask & CHANNEL_SCALE)
-            node->SetScale(newScale);
-    }
+    if (channelMask & CHANNEL_POSITION)
+        position = newPosition;
+    if (channelMask & CHANNEL_ROTATION)
+        rotation = newRotation;
+    if (channelMask & CHANNEL_SCALE)
+        scale = newScale;
+    return true;
 }
 
 }
@@ -25,8 +25,11 @@
 #pragma once
 
 #include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
 
 #include "../Container/Ptr.h"
+#include "../Math/MathDefs.h"
+#include "../Math/Quaternion.h"
 #include "../Math/StringHash.h"
 
 namespace Urho3D
@@ -74,6 +77,8 @@ struct URHO3D_API AnimationStateTrack
     const AnimationTrack* track_;
     /// Bone pointer.
     Bone* bone_;
+    /// Bone index in the skeleton.
+    unsigned boneIndex_;
     /// Scene node pointer.
     WeakPtr<Node> node_;
     /// Blending weight.
@@ -82,6 +87,29 @@ struct URHO3D_API AnimationStateTrack
     unsigned keyFrame_;
 };
 
+/// Local bone transforms of a skeleton, evaluated by the animation states before being committed to the bone nodes in one pass. Positions, rotations and scales are kept in separate arrays indexed by bone.
+/// @nobind
+struct URHO3D_API AnimationPose
+{
+    /// Reset to the initial transforms of the skeleton bones.
+    void Reset(const Skeleton& skeleton);
+    /// Write the transforms of the animated bones to their scene nodes silently.
+    void Commit(Skeleton& skeleton) const;
+    /// Discard cached bone depths after the skeleton has changed.
+    void InvalidateDepths() { depths_.clear(); }
+
+    /// Maximum depth of animated bones in the hierarchy. Deeper bones keep their initial transforms.
+    unsigned maxDepth_{M_MAX_UNSIGNED};
+    /// Bone depths in the hierarchy, root is zero.
+    ea::vector<unsigned> depths_;
+    /// Bone positions.
+    ea::vector<Vector3> positions_;
+    /// Bone rotations.
+    ea::vector<Quaternion> rotations_;
+    /// Bone scales.
+    ea::vector<Vector3> scales_;
+};
+
 /// %Animation instance.
 class URHO3D_API AnimationState : public RefCounted
 {
@@ -179,6 +207,9 @@ public:
 
     /// Apply the animation at the current time position.
     void Apply();
+    /// Apply the animation at the current time position to the pose of the animated model's skeleton instead of the bone nodes. Node hierarchy animations are applied to the nodes as usual.
+    /// @nobind
+    void Apply(AnimationPose& pose);
 
 private:
     /// Apply animation to a skeleton. Transform changes are applied silently, so the model needs to dirty its root model afterward.
@@ -187,6 +218,8 @@ private:
     void ApplyToNodes();
     /// Apply track.
     void ApplyTrack(AnimationStateTrack& stateTrack, float weight, bool silent);
+    /// Sample track at the current time position and blend the result into the transform. Return false if the track is empty.
+    bool BlendTrack(AnimationStateTrack& stateTrack, float weight, Vector3& position, Quaternion& rotation, Vector3& scale);
 
     /// Animated model (model mode).
     WeakPtr<AnimatedModel> model_;
@@ -83,6 +83,62 @@ inline bool CompareBatchGroupOrder(const BatchGroup* lhs, const BatchGroup* rhs)
     return lhs->renderOrder_ < rhs->renderOrder_;
 }
 
+/// Minimum number of batches to use radix sort instead of comparison sort.
+static const unsigned MIN_RADIX_SORT_BATCHES = 64;
+
+/// Convert float to unsigned integer with the same ordering.
+inline unsigned long long FloatToSortKey(float value)
+{
+    unsigned bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+/// Return render order and distance sort key for front to back order.
+inline unsigned long long GetFrontToBackKey(const Batch* batch)
+{
+    return (((unsigned long long)batch->renderOrder_) << 32u) | FloatToSortKey(batch->distance_);
+}
+
+/// Return render order and distance sort key for back to front order.
+inline unsigned long long GetBackToFrontKey(const Batch* batch)
+{
+    return (((unsigned long long)batch->renderOrder_) << 32u) | (~FloatToSortKey(batch->distance_) & 0xffffffffu);
+}
+
+/// Stable LSD radix sort of elements by the given number of low key bytes. Bytes that are the same for all keys are skipped.
+static void RadixSortElements(ea::vector<BatchSortElement>& elements, ea::vector<BatchSortElement>& temp, unsigned numKeyBytes)
+{
+    const unsigned count = elements.size();
+    temp.resize(count);
+
+    unsigned offsets[256];
+    for (unsigned byte = 0; byte < numKeyBytes; ++byte)
+    {
+        const unsigned shift = byte * 8;
+
+        memset(offsets, 0, sizeof(offsets));
+        for (const BatchSortElement& element : elements)
+            ++offsets[(element.key_ >> shift) & 0xffu];
+
+        if (offsets[(elements[0].key_ >> shift) & 0xffu] == count)
+            continue;
+
+        unsigned offset = 0;
+        for (unsigned& bucket : offsets)
+        {
+            const unsigned bucketSize = bucket;
+            bucket = offset;
+            offset += bucketSize;
+        }
+
+        for (const BatchSortElement& element : elements)
+            temp[offsets[(element.key_ >> shift) & 0xffu]++] = element;
+
+        elements.swap(temp);
+    }
+}
+
 void CalculateShadowMatrix(Matrix4& dest, LightBatchQueue* queue, unsigned split, Renderer* renderer)
 {
     Camera* shadowCamera = queue->shadowSplits_[split].shadowCamera_;
@@ -187,7 +243,9 @@ void Batch::CalculateSortKey()
 
     auto lightQueueID = (unsigned)((*((unsigned*)&lightQueue_) / sizeof(LightBatchQueue)) & 0xffffu);
     auto materialID = (unsigned)((*((unsigned*)&material_) / sizeof(Material)) & 0xffffu);
-    auto geometryID = (unsigned)((*((unsigned*)&geometry_) / sizeof(Geometry)) & 0xffffu);
+    // Geometries drawn from a shared pool are sorted by the pool buffer to avoid rebinding it
+    const void* geometryKey = geometry_->IsPooled() ? static_cast<const void*>(geometry_->GetDrawIndexBuffer()) : geometry_;
+    auto geometryID = (unsigned)((*((unsigned*)&geometryKey) / sizeof(Geometry)) & 0xffffu);
 
     sortKey_ = (((unsigned long long)shaderID) << 48u) | (((unsigned long long)lightQueueID) << 32u) |
                (((unsigned long long)materialID) << 16u) | geometryID;
@@ -205,41 +263,47 @@ void Batch::Prepare(View* view, Camera* camera, bool setModelTransform, bool all
     Texture2D* shadowMap = lightQueue_ ? lightQueue_->shadowMap_ : nullptr;
 
     // Set shaders first. The available shader parameters and their register/uniform positions depend on the currently set shaders
-    graphics->SetShaders(vertexShader_, pixelShader_);
-
-    // Set pass / material-specific renderstates
     if (pass_ && material_)
     {
-        BlendMode blend = pass_->GetBlendMode();
+        // Set pass / material-specific renderstates together with the shaders
+        PipelineState state;
+        state.vertexShader_ = vertexShader_;
+        state.pixelShader_ = pixelShader_;
+
+        state.blendMode_ = pass_->GetBlendMode();
         // Turn additive blending into subtract if the light is negative
         if (light && light->IsNegative())
         {
-            if (blend == BLEND_ADD)
-                blend = BLEND_SUBTRACT;
-            else if (blend == BLEND_ADDALPHA)
-                blend = BLEND_SUBTRACTALPHA;
+            if (state.blendMode_ == BLEND_ADD)
+                state.blendMode_ = BLEND_SUBTRACT;
+            else if (state.blendMode_ == BLEND_ADDALPHA)
+                state.blendMode_ = BLEND_SUBTRACTALPHA;
         }
-        graphics->SetBlendMode(blend, pass_->GetAlphaToCoverage() || material_->GetAlphaToCoverage());
-        graphics->SetLineAntiAlias(material_->GetLineAntiAlias());
+        state.alphaToCoverage_ = pass_->GetAlphaToCoverage() || material_->GetAlphaToCoverage();
+        state.lineAntiAlias_ = material_->GetLineAntiAlias();
 
         bool isShadowPass = pass_->GetIndex() == Technique::shadowPassIndex;
         CullMode effectiveCullMode = pass_->GetCullMode();
         // Get cull mode from material if pass doesn't override it
         if (effectiveCullMode == MAX_CULLMODES)
             effectiveCullMode = isShadowPass ? material_->GetShadowCullMode() : material_->GetCullMode();
+        state.cullMode_ = renderer->GetEffectiveCullMode(effectiveCullMode, camera);
+
+        // Use the "least filled" fill mode combined from camera & material
+        state.fillMode_ = (FillMode)(Max(camera->GetFillMode(), material_->GetFillMode()));
+        state.depthTestMode_ = pass_->GetDepthTestMode();
+        state.depthWrite_ = pass_->GetDepthWrite() && allowDepthWrite;
+
+        graphics->SetPipelineState(state);
 
-        renderer->SetCullMode(effectiveCullMode, camera);
         if (!isShadowPass)
         {
             const BiasParameters& depthBias = material_->GetDepthBias();
             graphics->SetDepthBias(depthBias.constantBias_, depthBias.slopeScaledBias_);
         }
-
-        // Use the "least filled" fill mode combined from camera & material
-        graphics->SetFillMode((FillMode)(Max(camera->GetFillMode(), material_->GetFillMode())));
-        graphics->SetDepthTest(pass_->GetDepthTestMode());
-        graphics->SetDepthWrite(pass_->GetDepthWrite() && allowDepthWrite);
     }
+    else
+        graphics->SetShaders(vertexShader_, pixelShader_);
 
     // Set global (per-frame) shader parameters
     if (graphics->NeedParameterUpdate(SP_FRAME, nullptr))
@@ -253,8 +317,12 @@ void Batch::Prepare(View* view, Camera* camera, bool setModelTransform, bool all
     if (graphics->NeedParameterUpdate(SP_CAMERA, reinterpret_cast<const void*>(cameraHash + viewportHash)))
     {
         view->SetCameraShaderParameters(camera);
-        // During renderpath commands the G-Buffer or viewport texture is assumed to always be viewport-sized
-        view->SetGBufferShaderParameters(viewSize, IntRect(0, 0, viewSize.x_, viewSize.y_));
+        // During renderpath commands the G-Buffer or viewport texture is assumed to always be viewport-sized, or to span
+        // both eyes in stereo rendering
+        if (view->GetRightEyeCamera())
+            view->SetGBufferShaderParameters(view->GetViewSize(), view->GetStereoEyeRect());
+        else
+            view->SetGBufferShaderParameters(viewSize, IntRect(0, 0, viewSize.x_, viewSize.y_));
     }
 
     // Set model or skinning transforms
@@ -720,8 +788,8 @@ void BatchGroup::Draw(View* view, Camera* camera, bool allowDepthWrite) const
         {
             Batch::Prepare(view, camera, false, allowDepthWrite);
 
-            graphics->SetIndexBuffer(geometry_->GetIndexBuffer());
-            graphics->SetVertexBuffers(geometry_->GetVertexBuffers());
+            graphics->SetIndexBuffer(geometry_->GetDrawIndexBuffer());
+            graphics->SetVertexBuffers(geometry_->GetDrawVertexBuffers());
 
             for (unsigned i = 0; i < instances_.size(); ++i)
             {
@@ -731,8 +799,16 @@ void BatchGroup::Draw(View* view, Camera* camera, bool allowDepthWrite) const
                     SetInstanceShaderParameters(graphics, instances_[i].shaderParameters_);
                 }
 
-                graphics->Draw(geometry_->GetPrimitiveType(), geometry_->GetIndexStart(), geometry_->GetIndexCount(),
-                    geometry_->GetVertexStart(), geometry_->GetVertexCount());
+                if (geometry_->IsPooled())
+                {
+                    graphics->Draw(geometry_->GetPrimitiveType(), geometry_->GetDrawIndexStart(), geometry_->GetIndexCount(),
+                        geometry_->GetBaseVertex(), geometry_->GetVertexStart(), geometry_->GetVertexCount());
+                }
+                else
+                {
+                    graphics->Draw(geometry_->GetPrimitiveType(), geometry_->GetIndexStart(), geometry_->GetIndexCount(),
+                        geometry_->GetVertexStart(), geometry_->GetVertexCount());
+                }
             }
         }
         else
@@ -742,13 +818,21 @@ void BatchGroup::Draw(View* view, Camera* camera, bool allowDepthWrite) const
             // Get the geometry vertex buffers, then add the instancing stream buffer
             // Hack: use a const_cast to avoid dynamic allocation of new temp vectors
             auto& vertexBuffers = const_cast<ea::vector<SharedPtr<VertexBuffer> >&>(
-                geometry_->GetVertexBuffers());
+                geometry_->GetDrawVertexBuffers());
             vertexBuffers.push_back(SharedPtr<VertexBuffer>(instanceBuffer));
 
-            graphics->SetIndexBuffer(geometry_->GetIndexBuffer());
+            graphics->SetIndexBuffer(geometry_->GetDrawIndexBuffer());
             graphics->SetVertexBuffers(vertexBuffers, startIndex_);
-            graphics->DrawInstanced(geometry_->GetPrimitiveType(), geometry_->GetIndexStart(), geometry_->GetIndexCount(),
-                geometry_->GetVertexStart(), geometry_->GetVertexCount(), instances_.size());
+            if (geometry_->IsPooled())
+            {
+                graphics->DrawInstanced(geometry_->GetPrimitiveType(), geometry_->GetDrawIndexStart(), geometry_->GetIndexCount(),
+                    geometry_->GetBaseVertex(), geometry_->GetVertexStart(), geometry_->GetVertexCount(), instances_.size());
+            }
+            else
+            {
+                graphics->DrawInstanced(geometry_->GetPrimitiveType(), geometry_->GetIndexStart(), geometry_->GetIndexCount(),
+                    geometry_->GetVertexStart(), geometry_->GetVertexCount(), instances_.size());
+            }
 
             // Remove the instancing buffer & element mask now
             vertexBuffers.pop_back();
@@ -762,11 +846,30 @@ unsigned BatchGroupKey::ToHash() const
                       (size_t)material_ / sizeof(Material) + (size_t)geometry_ / sizeof(Geometry)) + renderOrder_;
 }
 
-void BatchQueue::Clear(int maxSortedInstances)
+void BatchQueue::Clear(int maxSortedInstances, bool retainBatchGroups)
 {
     batches_.clear();
     sortedBatches_.clear();
-    batchGroups_.clear();
+    sortedBatchGroups_.clear();
+
+    if (retainBatchGroups)
+    {
+        // Keep the groups that received instances on the last frame along with their instance storage.
+        // Groups that stayed empty are assumed to be stale and are removed
+        for (auto i = batchGroups_.begin(); i != batchGroups_.end();)
+        {
+            if (i->second.instances_.empty())
+                i = batchGroups_.erase(i);
+            else
+            {
+                i->second.instances_.clear();
+                ++i;
+            }
+        }
+    }
+    else
+        batchGroups_.clear();
+
     maxSortedInstances_ = (unsigned)maxSortedInstances;
 }
 
@@ -777,13 +880,21 @@ void BatchQueue::SortBackToFront()
     for (unsigned i = 0; i < batches_.size(); ++i)
         sortedBatches_[i] = &batches_[i];
 
-    ea::quick_sort(sortedBatches_.begin(), sortedBatches_.end(), CompareBatchesBackToFront);
-
-    sortedBatchGroups_.resize(batchGroups_.size());
+    if (sortedBatches_.size() >= MIN_RADIX_SORT_BATCHES)
+    {
+        RadixSortBatches(sortedBatches_, [](const Batch* batch) { return batch->sortKey_; }, 8,
+            GetBackToFrontKey, 5);
+    }
+    else
+        ea::quick_sort(sortedBatches_.begin(), sortedBatches_.end(), CompareBatchesBackToFront);
 
-    unsigned index = 0;
+    sortedBatchGroups_.clear();
     for (auto i = batchGroups_.begin(); i != batchGroups_.end(); ++i)
-        sortedBatchGroups_[index++] = &i->second;
+    {
+        // Skip groups retained from the previous frame that did not receive instances
+        if (!i->second.instances_.empty())
+            sortedBatchGroups_.push_back(&i->second);
+    }
 
     ea::quick_sort(sortedBatchGroups_.begin(), sortedBatchGroups_.end(), CompareBatchGroupOrder);
 }
@@ -816,12 +927,13 @@ void BatchQueue::SortFrontToBack()
         }
     }
 
-    sortedBatchGroups_.resize(batchGroups_.size());
-
-    unsigned index = 0;
+    sortedBatchGroups_.clear();
     for (auto i = batchGroups_.begin(); i != batchGroups_.end(); ++i)
-        sortedBatchGroups_[index++] = &i->second;
-
+    {
+        // Skip groups retained from the previous frame that did not receive instances
+        if (!i->second.instances_.empty())
+            sortedBatchGroups_.push_back(&i->second);
+    }
 
     SortFrontToBack2Pass(sortedBatchGroups_);
 }
@@ -834,7 +946,11 @@ template <class T> void BatchQueue::SortFrontToBack2Pass(ea::vector<T>& batches)
     ea::quick_sort(batches.begin(), batches.end(), CompareBatchesState);
 #else
     // For desktop, first sort by distance and remap shader/material/geometry IDs in the sort key
-    ea::quick_sort(batches.begin(), batches.end(), CompareBatchesFrontToBack);
+    const bool useRadixSort = batches.size() >= MIN_RADIX_SORT_BATCHES;
+    if (useRadixSort)
+        RadixSortBatches(batches, [](const Batch* batch) { return batch->sortKey_; }, 8, GetFrontToBackKey, 5);
+    else
+        ea::quick_sort(batches.begin(), batches.end(), CompareBatchesFrontToBack);
 
     unsigned freeShaderID = 0;
     unsigned short freeMaterialID = 0;
@@ -881,11 +997,38 @@ template <class T> void BatchQueue::SortFrontToBack2Pass(ea::vector<T>& batches)
     materialRemapping_.clear();
     geometryRemapping_.clear();
 
-    // Finally sort again with the rewritten ID's
-    ea::quick_sort(batches.begin(), batches.end(), CompareBatchesState);
+    // Finally sort again with the rewritten ID's. Radix sort is stable, so the distance order is kept for equal states
+    if (useRadixSort)
+    {
+        RadixSortBatches(batches, [](const Batch* batch) { return batch->sortKey_; }, 8,
+            [](const Batch* batch) { return (unsigned long long)batch->renderOrder_; }, 1);
+    }
+    else
+        ea::quick_sort(batches.begin(), batches.end(), CompareBatchesState);
 #endif
 }
 
+template <class T, class U, class V> void BatchQueue::RadixSortBatches(ea::vector<T>& batches,
+    const U& getSecondaryKey, unsigned numSecondaryKeyBytes, const V& getPrimaryKey, unsigned numPrimaryKeyBytes)
+{
+    sortBuffer_.resize(batches.size());
+    for (unsigned i = 0; i < batches.size(); ++i)
+    {
+        sortBuffer_[i].key_ = getSecondaryKey(batches[i]);
+        sortBuffer_[i].batch_ = batches[i];
+    }
+
+    RadixSortElements(sortBuffer_, sortTempBuffer_, numSecondaryKeyBytes);
+
+    for (BatchSortElement& element : sortBuffer_)
+        element.key_ = getPrimaryKey(element.batch_);
+
+    RadixSortElements(sortBuffer_, sortTempBuffer_, numPrimaryKeyBytes);
+
+    for (unsigned i = 0; i < batches.size(); ++i)
+        batches[i] = static_cast<T>(sortBuffer_[i].batch_);
+}
+
 void BatchQueue::SetInstancingData(void* lockedData, unsigned stride, unsigned& freeIndex)
 {
     for (auto i = batchGroups_.begin(); i != batchGroups_.end(); ++i)
@@ -935,6 +1078,49 @@ void BatchQueue::Draw(View* view, Camera* camera, bool markToStencil, bool using
     }
 }
 
+void BatchQueue::DrawStereo(View* view, bool markToStencil, bool allowDepthWrite) const
+{
+    Graphics* graphics = view->GetContext()->GetSubsystem<Graphics>();
+    Renderer* renderer = view->GetContext()->GetSubsystem<Renderer>();
+
+    graphics->SetScissorTest(false);
+    if (!markToStencil)
+        graphics->SetStencilTest(false);
+
+    // Draw each batch to both eyes before moving on, so that only the camera changes in between
+    for (auto i = sortedBatchGroups_.begin(); i != sortedBatchGroups_.end(); ++i)
+    {
+        BatchGroup* group = *i;
+        if (markToStencil)
+            graphics->SetStencilTest(true, CMP_ALWAYS, OP_REF, OP_KEEP, OP_KEEP, group->lightMask_);
+
+        for (unsigned eye = 0; eye < 2; ++eye)
+        {
+            view->SetStereoEye(eye);
+            group->Draw(view, view->GetCamera(), allowDepthWrite);
+        }
+    }
+    for (auto i = sortedBatches_.begin(); i != sortedBatches_.end(); ++i)
+    {
+        Batch* batch = *i;
+        if (markToStencil)
+            graphics->SetStencilTest(true, CMP_ALWAYS, OP_REF, OP_KEEP, OP_KEEP, batch->lightMask_);
+
+        for (unsigned eye = 0; eye < 2; ++eye)
+        {
+            view->SetStereoEye(eye);
+
+            // If drawing an alpha batch, we can optimize fillrate by scissor test
+            if (!batch->isBase_ && batch->lightQueue_)
+                renderer->OptimizeLightByScissor(batch->lightQueue_->light_, view->GetCamera());
+            else
+                graphics->SetScissorTest(false);
+
+            batch->Draw(view, view->GetCamera(), allowDepthWrite);
+        }
+    }
+}
+
 unsigned BatchQueue::GetNumInstances() const
 {
     unsigned total = 0;
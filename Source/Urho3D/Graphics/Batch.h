@@ -251,22 +251,36 @@ struct BatchGroupKey
     unsigned ToHash() const;
 };
 
+/// Batch pointer with a key for radix sorting.
+struct BatchSortElement
+{
+    /// Sort key.
+    unsigned long long key_;
+    /// Batch.
+    Batch* batch_;
+};
+
 /// Queue that contains both instanced and non-instanced draw calls.
 struct BatchQueue
 {
 public:
-    /// Clear for new frame by clearing all groups and batches.
-    void Clear(int maxSortedInstances);
+    /// Clear for new frame by clearing all groups and batches. Optionally keep the batch groups used on the last frame.
+    void Clear(int maxSortedInstances, bool retainBatchGroups = false);
     /// Sort non-instanced draw calls back to front.
     void SortBackToFront();
     /// Sort instanced and non-instanced draw calls front to back.
     void SortFrontToBack();
     /// Sort batches front to back while also maintaining state sorting.
     template <class T> void SortFrontToBack2Pass(ea::vector<T>& batches);
+    /// Stable sort batches by secondary and then by primary key using radix sort. Only the given number of low key bytes are sorted.
+    template <class T, class U, class V> void RadixSortBatches(ea::vector<T>& batches,
+        const U& getSecondaryKey, unsigned numSecondaryKeyBytes, const V& getPrimaryKey, unsigned numPrimaryKeyBytes);
     /// Pre-set instance data of all groups. The vertex buffer must be big enough to hold all data.
     void SetInstancingData(void* lockedData, unsigned stride, unsigned& freeIndex);
     /// Draw.
     void Draw(View* view, Camera* camera, bool markToStencil, bool usingLightOptimization, bool allowDepthWrite) const;
+    /// Draw each batch to both eyes of a stereo view in turn.
+    void DrawStereo(View* view, bool markToStencil, bool allowDepthWrite) const;
     /// Return the combined amount of instances.
     unsigned GetNumInstances() const;
 
@@ -288,6 +302,10 @@ public:
     ea::vector<Batch*> sortedBatches_;
     /// Sorted instanced draw calls.
     ea::vector<BatchGroup*> sortedBatchGroups_;
+    /// Radix sort buffer.
+    ea::vector<BatchSortElement> sortBuffer_;
+    /// Radix sort temporary buffer.
+    ea::vector<BatchSortElement> sortTempBuffer_;
     /// Maximum sorted instances.
     unsigned maxSortedInstances_;
     /// Whether the pass command contains extra shader defines.
@@ -326,6 +344,8 @@ struct LightBatchQueue
     bool negative_;
     /// Shadow map depth texture.
     Texture2D* shadowMap_;
+    /// Hash of the shadow cameras and shadow caster batches for shadow map caching. Zero if the shadow map must be rendered.
+    unsigned shadowMapHash_;
     /// Lit geometry draw calls, base (replace blend mode).
     BatchQueue litBaseBatches_;
     /// Lit geometry draw calls, non-base (additive).
@@ -71,11 +71,62 @@ static const StringVector billboardsStructureElementNames =
     "   Is Enabled"
 };
 
+/// Billboard count below which comparison sort is used instead of radix sort.
+static const unsigned MIN_RADIX_SORTED_BILLBOARDS = 64;
+
 inline bool CompareBillboards(Billboard* lhs, Billboard* rhs)
 {
     return lhs->sortDistance_ > rhs->sortDistance_;
 }
 
+/// Return radix sort key that orders billboards back to front. Sort distances are never negative, so the float bits are monotonic.
+inline unsigned GetBillboardSortKey(const Billboard* billboard)
+{
+    unsigned bits;
+    memcpy(&bits, &billboard->sortDistance_, sizeof(bits));
+    return ~bits;
+}
+
+/// Sort billboards back to front using 8-bit LSD radix sort.
+static void RadixSortBillboards(ea::vector<Billboard*>& billboards, ea::vector<Billboard*>& tempBillboards,
+    ea::vector<unsigned>& keys, ea::vector<unsigned>& tempKeys)
+{
+    const unsigned count = billboards.size();
+    keys.resize(count);
+    tempKeys.resize(count);
+    tempBillboards.resize(count);
+    for (unsigned i = 0; i < count; ++i)
+        keys[i] = GetBillboardSortKey(billboards[i]);
+
+    for (unsigned shift = 0; shift < 32; shift += 8)
+    {
+        unsigned offsets[256] = {};
+        for (unsigned i = 0; i < count; ++i)
+            ++offsets[(keys[i] >> shift) & 0xff];
+
+        // Skip the pass if all keys share the same digit
+        if (offsets[(keys[0] >> shift) & 0xff] == count)
+            continue;
+
+        unsigned sum = 0;
+        for (unsigned& offset : offsets)
+        {
+            const unsigned digitCount = offset;
+            offset = sum;
+            sum += digitCount;
+        }
+
+        for (unsigned i = 0; i < count; ++i)
+        {
+            const unsigned dest = offsets[(keys[i] >> shift) & 0xff]++;
+            tempKeys[dest] = keys[i];
+            tempBillboards[dest] = billboards[i];
+        }
+        keys.swap(tempKeys);
+        billboards.swap(tempBillboards);
+    }
+}
+
 BillboardSet::BillboardSet(Context* context) :
     Drawable(context, DRAWABLE_GEOMETRY),
     animationLodBias_(1.0f),
@@ -629,7 +680,10 @@ void BillboardSet::UpdateVertexBuffer(const FrameInfo& frame)
 
     if (sorted_)
     {
-        ea::quick_sort(sortedBillboards_.begin(), sortedBillboards_.end(), CompareBillboards);
+        if (enabledBillboards < MIN_RADIX_SORTED_BILLBOARDS)
+            ea::quick_sort(sortedBillboards_.begin(), sortedBillboards_.end(), CompareBillboards);
+        else
+            RadixSortBillboards(sortedBillboards_, sortTempBillboards_, sortKeys_, sortTempKeys_);
         Vector3 worldPos = node_->GetWorldPosition();
         // Store the "last sorted position" now
         previousOffset_ = (worldPos - frame.camera_->GetNode()->GetWorldPosition());
@@ -639,126 +693,56 @@ void BillboardSet::UpdateVertexBuffer(const FrameInfo& frame)
     if (!dest)
         return;
 
-    if (faceCameraMode_ != FC_DIRECTION)
-    {
-        for (unsigned i = 0; i < enabledBillboards; ++i)
-        {
-            Billboard& billboard = *sortedBillboards_[i];
-
-            Vector2 size(billboard.size_.x_ * billboardScale.x_, billboard.size_.y_ * billboardScale.y_);
-            unsigned color = billboard.color_.ToUInt();
-            if (fixedScreenSize_)
-                size *= billboard.screenScaleFactor_;
-
-            float rotationMatrix[2][2];
-            SinCos(billboard.rotation_, rotationMatrix[0][1], rotationMatrix[0][0]);
-            rotationMatrix[1][0] = -rotationMatrix[0][1];
-            rotationMatrix[1][1] = rotationMatrix[0][0];
-
-            dest[0] = billboard.position_.x_;
-            dest[1] = billboard.position_.y_;
-            dest[2] = billboard.position_.z_;
-            ((unsigned&)dest[3]) = color;
-            dest[4] = billboard.uv_.min_.x_;
-            dest[5] = billboard.uv_.min_.y_;
-            dest[6] = -size.x_ * rotationMatrix[0][0] + size.y_ * rotationMatrix[0][1];
-            dest[7] = -size.x_ * rotationMatrix[1][0] + size.y_ * rotationMatrix[1][1];
-
-            dest[8] = billboard.position_.x_;
-            dest[9] = billboard.position_.y_;
-            dest[10] = billboard.position_.z_;
-            ((unsigned&)dest[11]) = color;
-            dest[12] = billboard.uv_.max_.x_;
-            dest[13] = billboard.uv_.min_.y_;
-            dest[14] = size.x_ * rotationMatrix[0][0] + size.y_ * rotationMatrix[0][1];
-            dest[15] = size.x_ * rotationMatrix[1][0] + size.y_ * rotationMatrix[1][1];
-
-            dest[16] = billboard.position_.x_;
-            dest[17] = billboard.position_.y_;
-            dest[18] = billboard.position_.z_;
-            ((unsigned&)dest[19]) = color;
-            dest[20] = billboard.uv_.max_.x_;
-            dest[21] = billboard.uv_.max_.y_;
-            dest[22] = size.x_ * rotationMatrix[0][0] - size.y_ * rotationMatrix[0][1];
-            dest[23] = size.x_ * rotationMatrix[1][0] - size.y_ * rotationMatrix[1][1];
-
-            dest[24] = billboard.position_.x_;
-            dest[25] = billboard.position_.y_;
-            dest[26] = billboard.position_.z_;
-            ((unsigned&)dest[27]) = color;
-            dest[28] = billboard.uv_.min_.x_;
-            dest[29] = billboard.uv_.max_.y_;
-            dest[30] = -size.x_ * rotationMatrix[0][0] - size.y_ * rotationMatrix[0][1];
-            dest[31] = -size.x_ * rotationMatrix[1][0] - size.y_ * rotationMatrix[1][1];
-
-            dest += 32;
-        }
-    }
-    else
+    // The rotated corner offsets of a quad are symmetric: the third and fourth corners are the negated first and second
+    const bool hasDirection = faceCameraMode_ == FC_DIRECTION;
+    const unsigned vertexSize = hasDirection ? 11 : 8;
+    for (unsigned i = 0; i < enabledBillboards; ++i)
     {
-        for (unsigned i = 0; i < enabledBillboards; ++i)
+        const Billboard& billboard = *sortedBillboards_[i];
+
+        Vector2 size(billboard.size_.x_ * billboardScale.x_, billboard.size_.y_ * billboardScale.y_);
+        const unsigned color = billboard.color_.ToUInt();
+        if (fixedScreenSize_)
+            size *= billboard.screenScaleFactor_;
+
+        float sine, cosine;
+        SinCos(billboard.rotation_, sine, cosine);
+        const float sx = size.x_ * cosine;
+        const float sy = size.y_ * sine;
+        const float tx = size.x_ * sine;
+        const float ty = size.y_ * cosine;
+        const float offsets[4][2] = {
+            { -sx + sy, tx + ty },
+            { sx + sy, -tx + ty },
+            { sx - sy, -tx - ty },
+            { -sx - sy, tx - ty }
+        };
+        const float uvs[4][2] = {
+            { billboard.uv_.min_.x_, billboard.uv_.min_.y_ },
+            { billboard.uv_.max_.x_, billboard.uv_.min_.y_ },
+            { billboard.uv_.max_.x_, billboard.uv_.max_.y_ },
+            { billboard.uv_.min_.x_, billboard.uv_.max_.y_ }
+        };
+
+        for (unsigned j = 0; j < 4; ++j)
         {
-            Billboard& billboard = *sortedBillboards_[i];
-
-            Vector2 size(billboard.size_.x_ * billboardScale.x_, billboard.size_.y_ * billboardScale.y_);
-            unsigned color = billboard.color_.ToUInt();
-            if (fixedScreenSize_)
-                size *= billboard.screenScaleFactor_;
-
-            float rot2D[2][2];
-            SinCos(billboard.rotation_, rot2D[0][1], rot2D[0][0]);
-            rot2D[1][0] = -rot2D[0][1];
-            rot2D[1][1] = rot2D[0][0];
-
-            dest[0] = billboard.position_.x_;
-            dest[1] = billboard.position_.y_;
-            dest[2] = billboard.position_.z_;
-            dest[3] = billboard.direction_.x_;
-            dest[4] = billboard.direction_.y_;
-            dest[5] = billboard.direction_.z_;
-            ((unsigned&)dest[6]) = color;
-            dest[7] = billboard.uv_.min_.x_;
-            dest[8] = billboard.uv_.min_.y_;
-            dest[9] = -size.x_ * rot2D[0][0] + size.y_ * rot2D[0][1];
-            dest[10] = -size.x_ * rot2D[1][0] + size.y_ * rot2D[1][1];
-
-            dest[11] = billboard.position_.x_;
-            dest[12] = billboard.position_.y_;
-            dest[13] = billboard.position_.z_;
-            dest[14] = billboard.direction_.x_;
-            dest[15] = billboard.direction_.y_;
-            dest[16] = billboard.direction_.z_;
-            ((unsigned&)dest[17]) = color;
-            dest[18] = billboard.uv_.max_.x_;
-            dest[19] = billboard.uv_.min_.y_;
-            dest[20] = size.x_ * rot2D[0][0] + size.y_ * rot2D[0][1];
-            dest[21] = size.x_ * rot2D[1][0] + size.y_ * rot2D[1][1];
-
-            dest[22] = billboard.position_.x_;
-            dest[23] = billboard.position_.y_;
-            dest[24] = billboard.position_.z_;
-            dest[25] = billboard.direction_.x_;
-            dest[26] = billboard.direction_.y_;
-            dest[27] = billboard.direction_.z_;
-            ((unsigned&)dest[28]) = color;
-            dest[29] = billboard.uv_.max_.x_;
-            dest[30] = billboard.uv_.max_.y_;
-            dest[31] = size.x_ * rot2D[0][0] - size.y_ * rot2D[0][1];
-            dest[32] = size.x_ * rot2D[1][0] - size.y_ * rot2D[1][1];
-
-            dest[33] = billboard.position_.x_;
-            dest[34] = billboard.position_.y_;
-            dest[35] = billboard.position_.z_;
-            dest[36] = billboard.direction_.x_;
-            dest[37] = billboard.direction_.y_;
-            dest[38] = billboard.direction_.z_;
-            ((unsigned&)dest[39]) = color;
-            dest[40] = billboard.uv_.min_.x_;
-            dest[41] = billboard.uv_.max_.y_;
-            dest[42] = -size.x_ * rot2D[0][0] - size.y_ * rot2D[0][1];
-            dest[43] = -size.x_ * rot2D[1][0] - size.y_ * rot2D[1][1];
-
-            dest += 44;
+            float* vertex = dest;
+            vertex[0] = billboard.position_.x_;
+            vertex[1] = billboard.position_.y_;
+            vertex[2] = billboard.position_.z_;
+            if (hasDirection)
+            {
+                vertex[3] = billboard.direction_.x_;
+                vertex[4] = billboard.direction_.y_;
+                vertex[5] = billboard.direction_.z_;
+                vertex += 3;
+            }
+            ((unsigned&)vertex[3]) = color;
+            vertex[4] = uvs[j][0];
+            vertex[5] = uvs[j][1];
+            vertex[6] = offsets[j][0];
+            vertex[7] = offsets[j][1];
+            dest += vertexSize;
         }
     }
 
@@ -238,6 +238,12 @@ private:
     Vector3 previousOffset_;
     /// Billboard pointers for sorting.
     ea::vector<Billboard*> sortedBillboards_;
+    /// Temporary billboard pointers for radix sort.
+    ea::vector<Billboard*> sortTempBillboards_;
+    /// Billboard sort keys for radix sort.
+    ea::vector<unsigned> sortKeys_;
+    /// Temporary billboard sort keys for radix sort.
+    ea::vector<unsigned> sortTempKeys_;
     /// Attribute buffer for network replication.
     mutable VectorBuffer attrBuffer_;
 };
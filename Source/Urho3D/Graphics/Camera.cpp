@@ -91,6 +91,7 @@ void Camera::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Orthographic Size", GetOrthoSize, SetOrthoSizeAttr, float, DEFAULT_ORTHOSIZE, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Zoom", GetZoom, SetZoom, float, 1.0f, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("LOD Bias", GetLodBias, SetLodBias, float, 1.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Screen Space LOD", GetScreenSpaceLod, SetScreenSpaceLod, bool, false, AM_DEFAULT);
     URHO3D_ATTRIBUTE("View Mask", int, viewMask_, DEFAULT_VIEWMASK, AM_DEFAULT);
     URHO3D_ATTRIBUTE("View Override Flags", unsigned, viewOverrideFlags_.AsInteger(), VO_NONE, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Projection Offset", GetProjectionOffset, SetProjectionOffset, Vector2, Vector2::ZERO, AM_DEFAULT);
@@ -176,6 +177,12 @@ void Camera::SetLodBias(float bias)
     MarkNetworkUpdate();
 }
 
+void Camera::SetScreenSpaceLod(bool enable)
+{
+    screenSpaceLod_ = enable;
+    MarkNetworkUpdate();
+}
+
 void Camera::SetViewMask(unsigned mask)
 {
     viewMask_ = mask;
@@ -533,6 +540,19 @@ float Camera::GetLodDistance(float distance, float scale, float bias) const
         return orthoSize_ / d;
 }
 
+float Camera::GetLodDistance(float distance, float scale, float bias, const IntVector2& viewSize) const
+{
+    const float lodDistance = GetLodDistance(distance, scale, bias);
+    if (!screenSpaceLod_ || viewSize.y_ <= 0)
+        return lodDistance;
+
+    // Projected size shrinks with wider field of view and grows with view height
+    float screenScale = LOD_REFERENCE_VIEW_HEIGHT / viewSize.y_;
+    if (!orthographic_)
+        screenScale *= Tan(fov_ * 0.5f) / Tan(LOD_REFERENCE_FOV * 0.5f);
+    return lodDistance * screenScale;
+}
+
 Quaternion Camera::GetFaceCameraRotation(const Vector3& position, const Quaternion& rotation, FaceCameraMode mode, float minAngle)
 {
     if (!node_)
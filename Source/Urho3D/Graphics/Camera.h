@@ -37,6 +37,10 @@ static const float DEFAULT_NEARCLIP = 0.1f;
 static const float DEFAULT_FARCLIP = 1000.0f;
 static const float DEFAULT_CAMERA_FOV = 45.0f;
 static const float DEFAULT_ORTHOSIZE = 20.0f;
+/// Vertical field of view at which screen space LOD distances equal plain LOD distances.
+static const float LOD_REFERENCE_FOV = DEFAULT_CAMERA_FOV;
+/// View height in pixels at which screen space LOD distances equal plain LOD distances.
+static const float LOD_REFERENCE_VIEW_HEIGHT = 1080.0f;
 
 enum ViewOverride : unsigned
 {
@@ -90,6 +94,9 @@ public:
     /// Set LOD bias.
     /// @property
     void SetLodBias(float bias);
+    /// Set whether LOD distances are scaled by field of view and view height, so that LOD levels switch at the same screen space error regardless of them.
+    /// @property
+    void SetScreenSpaceLod(bool enable);
     /// Set view mask. Will be and'ed with object's view mask to see if the object should be rendered.
     /// @property
     void SetViewMask(unsigned mask);
@@ -154,6 +161,10 @@ public:
     /// @property
     float GetLodBias() const { return lodBias_; }
 
+    /// Return whether LOD distances are scaled by field of view and view height.
+    /// @property
+    bool GetScreenSpaceLod() const { return screenSpaceLod_; }
+
     /// Return view mask.
     /// @property
     unsigned GetViewMask() const { return viewMask_; }
@@ -243,6 +254,8 @@ public:
     float GetDistanceSquared(const Vector3& worldPos) const;
     /// Return a scene node's LOD scaled distance.
     float GetLodDistance(float distance, float scale, float bias) const;
+    /// Return LOD distance for the view of given size. Same as above unless screen space LOD is enabled.
+    float GetLodDistance(float distance, float scale, float bias, const IntVector2& viewSize) const;
     /// Return a world rotation for facing a camera on certain axes based on the existing world rotation.
     Quaternion GetFaceCameraRotation(const Vector3& position, const Quaternion& rotation, FaceCameraMode mode, float minAngle = 0.0f);
     /// Get effective world transform for matrix and frustum calculations including reflection but excluding node scaling.
@@ -322,6 +335,8 @@ private:
     float zoom_;
     /// LOD bias.
     float lodBias_;
+    /// Screen space LOD flag.
+    bool screenSpaceLod_{};
     /// View mask.
     unsigned viewMask_;
     /// View override flags.
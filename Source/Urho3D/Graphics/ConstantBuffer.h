@@ -67,6 +67,12 @@ public:
     /// Return whether has unapplied data.
     bool IsDirty() const { return dirty_; }
 
+    /// Return CPU-side copy of the buffer data.
+    const unsigned char* GetShadowData() const { return shadowData_.get(); }
+
+    /// Mark the data applied when it was uploaded by other means than Apply().
+    void ClearDirty() { dirty_ = false; }
+
 private:
     /// Shadow data.
     ea::unique_ptr<unsigned char[]> shadowData_;
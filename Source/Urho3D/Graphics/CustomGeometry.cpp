@@ -24,6 +24,8 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/Thread.h"
+#include "../Core/Timer.h"
 #include "../Graphics/Batch.h"
 #include "../Graphics/Camera.h"
 #include "../Graphics/CustomGeometry.h"
@@ -326,6 +328,12 @@ void CustomGeometry::DefineGeometry(unsigned index, PrimitiveType type, unsigned
 
 void CustomGeometry::Commit()
 {
+    if (streamCapacity_)
+    {
+        URHO3D_LOGWARNING("Commit is not used for custom geometry in streaming mode");
+        return;
+    }
+
     URHO3D_PROFILE("CommitCustomGeometry");
 
     unsigned totalVertices = 0;
@@ -409,6 +417,208 @@ void CustomGeometry::Commit()
     vertexBuffer_->ClearDataLost();
 }
 
+void CustomGeometry::SetStreaming(unsigned capacity, VertexMaskFlags elementMask)
+{
+    streamCapacity_ = capacity;
+    streamOffset_ = 0;
+    streamBoxes_.clear();
+    streamFrames_.clear();
+    boundingBox_.Clear();
+
+    if (capacity)
+    {
+        // Without shadow data, the dynamic vertex buffer is locked directly
+        elementMask_ = elementMask | MASK_POSITION;
+        vertexBuffer_->SetShadowed(false);
+        vertexBuffer_->SetSize(capacity, elementMask_, true);
+        if (streamGenerator_)
+            stagingData_.resize(capacity * vertexBuffer_->GetVertexSize());
+    }
+    else
+    {
+        vertexBuffer_->SetShadowed(true);
+        vertexBuffer_->SetSize(0, elementMask_, dynamic_);
+        stagingData_.clear();
+    }
+
+    for (unsigned i = 0; i < geometries_.size(); ++i)
+    {
+        geometries_[i]->SetVertexBuffer(0, vertexBuffer_);
+        geometries_[i]->SetDrawRange(primitiveTypes_[i], 0, 0, 0, 0);
+    }
+
+    OnMarkedDirty(node_);
+}
+
+void CustomGeometry::SetStreamGenerator(const std::function<void(CustomGeometry* geometry, const FrameInfo& frame)>& generator)
+{
+    streamGenerator_ = generator;
+    if (streamGenerator_ && streamCapacity_)
+        stagingData_.resize(streamCapacity_ * vertexBuffer_->GetVertexSize());
+    else
+        stagingData_.clear();
+}
+
+void* CustomGeometry::BeginStreamGeometry(unsigned index, PrimitiveType type, unsigned numVertices)
+{
+    if (!streamCapacity_ || index >= geometries_.size() || streamLocked_)
+    {
+        URHO3D_LOGERROR("Custom geometry is not streaming, geometry index out of bounds or already streaming");
+        return nullptr;
+    }
+    if (!numVertices || numVertices > streamCapacity_)
+    {
+        URHO3D_LOGERROR("Illegal vertex count for streaming custom geometry");
+        return nullptr;
+    }
+
+    streamBoxes_.resize(geometries_.size());
+    streamFrames_.resize(geometries_.size(), M_MAX_UNSIGNED);
+
+    // Continue after the previous reservation, wrapping to the beginning of the ring when out of space
+    const unsigned frameNumber = staging_ ? generatedFrameNumber_ : GetSubsystem<Time>()->GetFrameNumber();
+    unsigned start = streamOffset_;
+    if (start + numVertices > streamCapacity_)
+        start = 0;
+
+    // Geometries streamed this frame may still be drawn and must not be overwritten. Older ones are dropped
+    for (unsigned i = 0; i < geometries_.size(); ++i)
+    {
+        Geometry* geometry = geometries_[i];
+        const unsigned vertexStart = geometry->GetVertexStart();
+        const unsigned vertexEnd = vertexStart + geometry->GetVertexCount();
+        if (i == index || vertexEnd <= start || vertexStart >= start + numVertices)
+            continue;
+
+        if (streamFrames_[i] == frameNumber)
+        {
+            URHO3D_LOGERROR("Custom geometry streaming capacity exceeded this frame");
+            return nullptr;
+        }
+        geometry->SetDrawRange(primitiveTypes_[i], 0, 0, 0, 0);
+        streamBoxes_[i].Clear();
+    }
+
+    streamOffset_ = start + numVertices;
+    streamFrames_[index] = frameNumber;
+    streamBoxes_[index].Clear();
+    primitiveTypes_[index] = type;
+    geometries_[index]->SetVertexBuffer(0, vertexBuffer_);
+    geometries_[index]->SetDrawRange(type, 0, 0, start, numVertices);
+
+    return LockStream(index, start, numVertices);
+}
+
+void* CustomGeometry::BeginStreamRange(unsigned index, unsigned start, unsigned count)
+{
+    if (!streamCapacity_ || index >= geometries_.size() || index >= streamBoxes_.size() || streamLocked_)
+    {
+        URHO3D_LOGERROR("Custom geometry is not streaming, geometry index out of bounds or already streaming");
+        return nullptr;
+    }
+
+    Geometry* geometry = geometries_[index];
+    if (!count || start + count > geometry->GetVertexCount())
+    {
+        URHO3D_LOGERROR("Illegal range for streaming custom geometry");
+        return nullptr;
+    }
+
+    return LockStream(index, geometry->GetVertexStart() + start, count);
+}
+
+void CustomGeometry::EndStream(const BoundingBox& boundingBox)
+{
+    if (streamLocked_)
+    {
+        vertexBuffer_->Unlock();
+        streamLocked_ = false;
+    }
+
+    if (streamIndex_ >= streamBoxes_.size())
+        return;
+
+    streamBoxes_[streamIndex_].Merge(boundingBox);
+    boundingBox_.Clear();
+    for (unsigned i = 0; i < streamBoxes_.size(); ++i)
+    {
+        if (geometries_[i]->GetVertexCount())
+            boundingBox_.Merge(streamBoxes_[i]);
+    }
+
+    // Worker threads must not touch the octree, so mark dirty after the upload instead
+    if (staging_)
+        stagingBoundsDirty_ = true;
+    else
+        OnMarkedDirty(node_);
+}
+
+unsigned CustomGeometry::GetStreamVertexSize() const
+{
+    return VertexBuffer::GetVertexSize(elementMask_);
+}
+
+void* CustomGeometry::LockStream(unsigned index, unsigned start, unsigned count)
+{
+    streamIndex_ = index;
+
+    if (staging_)
+    {
+        // Grow the range to upload after the worker thread updates
+        if (stagingStart_ >= stagingEnd_)
+        {
+            stagingStart_ = start;
+            stagingEnd_ = start + count;
+        }
+        else
+        {
+            stagingStart_ = Min(stagingStart_, start);
+            stagingEnd_ = Max(stagingEnd_, start + count);
+        }
+        return stagingData_.data() + start * vertexBuffer_->GetVertexSize();
+    }
+
+    void* dest = vertexBuffer_->Lock(start, count);
+    if (!dest)
+        URHO3D_LOGERROR("Failed to lock custom geometry vertex buffer");
+    streamLocked_ = dest != nullptr;
+    return dest;
+}
+
+void CustomGeometry::UpdateGeometry(const FrameInfo& frame)
+{
+    if (!streamGenerator_ || !streamCapacity_ || frame.frameNumber_ == generatedFrameNumber_)
+        return;
+
+    // Stage the vertices when in a worker thread, as the vertex buffer can only be locked from the main thread
+    generatedFrameNumber_ = frame.frameNumber_;
+    staging_ = !Thread::IsMainThread() && !stagingData_.empty();
+    streamGenerator_(this, frame);
+    staging_ = false;
+}
+
+void CustomGeometry::FinishUpdateGeometry(const FrameInfo& frame)
+{
+    if (stagingStart_ < stagingEnd_)
+    {
+        const unsigned vertexSize = vertexBuffer_->GetVertexSize();
+        vertexBuffer_->SetDataRange(stagingData_.data() + stagingStart_ * vertexSize, stagingStart_, stagingEnd_ - stagingStart_);
+        stagingStart_ = 0;
+        stagingEnd_ = 0;
+    }
+
+    if (stagingBoundsDirty_)
+    {
+        OnMarkedDirty(node_);
+        stagingBoundsDirty_ = false;
+    }
+}
+
+UpdateGeometryType CustomGeometry::GetUpdateGeometryType()
+{
+    return streamGenerator_ && streamCapacity_ ? UPDATE_WORKER_THREAD : UPDATE_NONE;
+}
+
 void CustomGeometry::SetMaterial(Material* material)
 {
     for (unsigned i = 0; i < batches_.size(); ++i)
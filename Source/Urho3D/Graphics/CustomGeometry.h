@@ -24,6 +24,8 @@
 
 #include "../Graphics/Drawable.h"
 
+#include <functional>
+
 namespace Urho3D
 {
 
@@ -79,6 +81,12 @@ public:
     unsigned GetNumOccluderTriangles() override;
     /// Draw to occlusion buffer. Return true if did not run out of triangles.
     bool DrawOcclusion(OcclusionBuffer* buffer) override;
+    /// Prepare geometry for rendering. Runs the stream generator if set. May be called from a worker thread.
+    void UpdateGeometry(const FrameInfo& frame) override;
+    /// Upload vertices streamed by the generator in a worker thread.
+    void FinishUpdateGeometry(const FrameInfo& frame) override;
+    /// Return whether a geometry update is necessary, and if it can happen in a worker thread.
+    UpdateGeometryType GetUpdateGeometryType() override;
 
     /// Clear all geometries.
     void Clear();
@@ -104,8 +112,20 @@ public:
     void DefineGeometry
         (unsigned index, PrimitiveType type, unsigned numVertices, bool hasNormals, bool hasColors, bool hasTexCoords,
             bool hasTangents);
-    /// Update vertex buffer and calculate the bounding box. Call after finishing defining geometry.
+    /// Update vertex buffer and calculate the bounding box. Call after finishing defining geometry. Not used in streaming mode.
     void Commit();
+
+    /// Enable streaming mode with a vertex buffer ring of the given capacity in vertices, or disable with zero capacity. Streamed geometries are written directly in the vertex buffer layout without the vertex lists. They support only bounding box ray queries and are not drawn to the occlusion buffer.
+    void SetStreaming(unsigned capacity, VertexMaskFlags elementMask);
+    /// Set a function that streams the geometries once per frame when in view. It runs in a worker thread: the vertices are then staged in memory and uploaded on the main thread after the worker thread updates.
+    /// @nobind
+    void SetStreamGenerator(const std::function<void(CustomGeometry* geometry, const FrameInfo& frame)>& generator);
+    /// Begin streaming a geometry. Reserve its vertices from the ring and return memory to write them to, or null if the ring is out of space for this frame. Geometries overwritten by the reservation become empty. Call EndStream() after writing.
+    void* BeginStreamGeometry(unsigned index, PrimitiveType type, unsigned numVertices);
+    /// Begin rewriting a vertex range of a streamed geometry in place. Return memory to write the vertices to, or null if out of bounds. Call EndStream() after writing.
+    void* BeginStreamRange(unsigned index, unsigned start, unsigned count);
+    /// Finish writing streamed vertices and merge their local space bounding box into the geometry.
+    void EndStream(const BoundingBox& boundingBox);
     /// Set material on all geometries.
     /// @property
     void SetMaterial(Material* material);
@@ -124,6 +144,12 @@ public:
     /// Return whether vertex buffer dynamic mode is enabled.
     /// @property
     bool IsDynamic() const { return dynamic_; }
+    /// Return whether streaming mode is enabled.
+    bool IsStreaming() const { return streamCapacity_ != 0; }
+    /// Return streaming ring buffer capacity in vertices, zero if not streaming.
+    unsigned GetStreamCapacity() const { return streamCapacity_; }
+    /// Return vertex size in bytes for writing streamed vertices.
+    unsigned GetStreamVertexSize() const;
 
     /// Return material by geometry index.
     /// @property{get_materials}
@@ -149,6 +175,9 @@ protected:
     void OnWorldBoundingBoxUpdate() override;
 
 private:
+    /// Return memory for writing streamed vertices, either the locked vertex buffer or the staging memory.
+    void* LockStream(unsigned index, unsigned start, unsigned count);
+
     /// Primitive type per geometry.
     ea::vector<PrimitiveType> primitiveTypes_;
     /// Source vertices per geometry.
@@ -165,6 +194,32 @@ private:
     mutable ResourceRefList materialsAttr_;
     /// Vertex buffer dynamic flag.
     bool dynamic_;
+    /// Streaming ring buffer capacity in vertices, zero if not streaming.
+    unsigned streamCapacity_{};
+    /// Next vertex to reserve from the streaming ring buffer.
+    unsigned streamOffset_{};
+    /// Local space bounding box per streamed geometry.
+    ea::vector<BoundingBox> streamBoxes_;
+    /// Frame number of the last reservation per streamed geometry.
+    ea::vector<unsigned> streamFrames_;
+    /// Geometry being streamed to.
+    unsigned streamIndex_{};
+    /// Whether the vertex buffer is locked for streaming.
+    bool streamLocked_{};
+    /// Stream generator function.
+    std::function<void(CustomGeometry* geometry, const FrameInfo& frame)> streamGenerator_;
+    /// Frame number of the last generation.
+    unsigned generatedFrameNumber_{};
+    /// Whether the generator is writing to the staging memory.
+    bool staging_{};
+    /// Whether the bounding box changed while staging.
+    bool stagingBoundsDirty_{};
+    /// Staging memory for vertices generated in a worker thread.
+    ea::vector<unsigned char> stagingData_;
+    /// Start of the staged vertex range to upload.
+    unsigned stagingStart_{};
+    /// End of the staged vertex range to upload.
+    unsigned stagingEnd_{};
 };
 
 }
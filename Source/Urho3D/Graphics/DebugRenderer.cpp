@@ -25,6 +25,7 @@
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
 #include "../Core/Profiler.h"
+#include "../Core/Thread.h"
 #include "../Graphics/AnimatedModel.h"
 #include "../Graphics/Camera.h"
 #include "../Graphics/DebugRenderer.h"
@@ -37,6 +38,8 @@
 #include "../Math/Polyhedron.h"
 #include "../Resource/ResourceCache.h"
 
+#include <atomic>
+
 #include "../DebugNew.h"
 
 namespace Urho3D
@@ -48,12 +51,85 @@ extern const char* SUBSYSTEM_CATEGORY;
 static const unsigned MAX_LINES = 1000000;
 // Cap the amount of triangles to prevent crash.
 static const unsigned MAX_TRIANGLES = 100000;
+// Maximum number of threads that can add debug geometry. Geometry from further threads is dropped.
+static const unsigned MAX_DEBUG_THREADS = 64;
+
+// Next free thread slot. Slot 0 is reserved for the main thread.
+static std::atomic<unsigned> nextThreadSlot{1};
+
+static unsigned GetThreadSlot()
+{
+    static thread_local const unsigned slot = Thread::IsMainThread() ? 0 : nextThreadSlot.fetch_add(1, std::memory_order_relaxed);
+    return slot;
+}
+
+static float* WriteLines(float* dest, const ea::vector<DebugLine>& lines)
+{
+    for (const DebugLine& line : lines)
+    {
+        dest[0] = line.start_.x_;
+        dest[1] = line.start_.y_;
+        dest[2] = line.start_.z_;
+        ((unsigned&)dest[3]) = line.color_;
+        dest[4] = line.end_.x_;
+        dest[5] = line.end_.y_;
+        dest[6] = line.end_.z_;
+        ((unsigned&)dest[7]) = line.color_;
+
+        dest += 8;
+    }
+    return dest;
+}
+
+static float* WriteTriangles(float* dest, const ea::vector<DebugTriangle>& triangles)
+{
+    for (const DebugTriangle& triangle : triangles)
+    {
+        dest[0] = triangle.v1_.x_;
+        dest[1] = triangle.v1_.y_;
+        dest[2] = triangle.v1_.z_;
+        ((unsigned&)dest[3]) = triangle.color_;
+
+        dest[4] = triangle.v2_.x_;
+        dest[5] = triangle.v2_.y_;
+        dest[6] = triangle.v2_.z_;
+        ((unsigned&)dest[7]) = triangle.color_;
+
+        dest[8] = triangle.v3_.x_;
+        dest[9] = triangle.v3_.y_;
+        dest[10] = triangle.v3_.z_;
+        ((unsigned&)dest[11]) = triangle.color_;
+
+        dest += 12;
+    }
+    return dest;
+}
+
+template <class T> static void ClearAndShrink(ea::vector<T>& vector)
+{
+    // When the amount of debug geometry is reduced, release memory
+    const unsigned size = vector.size();
+    vector.clear();
+    if (vector.capacity() > size * 2)
+        vector.reserve(size);
+}
+
+void DebugPrimitives::Clear()
+{
+    ClearAndShrink(lines_);
+    ClearAndShrink(noDepthLines_);
+    ClearAndShrink(triangles_);
+    ClearAndShrink(noDepthTriangles_);
+}
 
 DebugRenderer::DebugRenderer(Context* context) :
     Component(context),
     lineAntiAlias_(false)
 {
+    // Preallocate all thread slots so that worker threads never resize the vector
+    threadPrimitives_.resize(MAX_DEBUG_THREADS);
     vertexBuffer_ = context_->CreateObject<VertexBuffer>();
+    retainedVertexBuffer_ = context_->CreateObject<VertexBuffer>();
 
     SubscribeToEvent(E_ENDFRAME, URHO3D_HANDLER(DebugRenderer, HandleEndFrame));
 }
@@ -94,13 +170,14 @@ void DebugRenderer::AddLine(const Vector3& start, const Vector3& end, const Colo
 
 void DebugRenderer::AddLine(const Vector3& start, const Vector3& end, unsigned color, bool depthTest)
 {
-    if (lines_.size() + noDepthLines_.size() >= MAX_LINES)
+    DebugPrimitives* primitives = GetThreadPrimitives();
+    if (!primitives || primitives->lines_.size() + primitives->noDepthLines_.size() >= MAX_LINES)
         return;
 
     if (depthTest)
-        lines_.push_back(DebugLine(start, end, color));
+        primitives->lines_.push_back(DebugLine(start, end, color));
     else
-        noDepthLines_.push_back(DebugLine(start, end, color));
+        primitives->noDepthLines_.push_back(DebugLine(start, end, color));
 }
 
 void DebugRenderer::AddLine2D(const Vector2& start, const Vector2& end, const Color& color, bool depthTest)
@@ -124,13 +201,14 @@ void DebugRenderer::AddTriangle(const Vector3& v1, const Vector3& v2, const Vect
 
 void DebugRenderer::AddTriangle(const Vector3& v1, const Vector3& v2, const Vector3& v3, unsigned color, bool depthTest)
 {
-    if (triangles_.size() + noDepthTriangles_.size() >= MAX_TRIANGLES)
+    DebugPrimitives* primitives = GetThreadPrimitives();
+    if (!primitives || primitives->triangles_.size() + primitives->noDepthTriangles_.size() >= MAX_TRIANGLES)
         return;
 
     if (depthTest)
-        triangles_.push_back(DebugTriangle(v1, v2, v3, color));
+        primitives->triangles_.push_back(DebugTriangle(v1, v2, v3, color));
     else
-        noDepthTriangles_.push_back(DebugTriangle(v1, v2, v3, color));
+        primitives->noDepthTriangles_.push_back(DebugTriangle(v1, v2, v3, color));
 }
 
 void DebugRenderer::AddPolygon(const Vector3& v1, const Vector3& v2, const Vector3& v3, const Vector3& v4, const Color& color, bool depthTest)
@@ -538,6 +616,24 @@ void DebugRenderer::AddQuad(const Vector3& center, float width, float height, co
     AddLine(v3, v0, uintColor, depthTest);
 }
 
+void DebugRenderer::BeginRetained()
+{
+    assert(Thread::IsMainThread());
+    addingRetained_ = true;
+}
+
+void DebugRenderer::EndRetained()
+{
+    addingRetained_ = false;
+    retainedDirty_ = true;
+}
+
+void DebugRenderer::ClearRetained()
+{
+    retained_.Clear();
+    retainedDirty_ = true;
+}
+
 void DebugRenderer::Render()
 {
     if (!HasContent())
@@ -552,120 +648,133 @@ void DebugRenderer::Render()
     ShaderVariation* vs = graphics->GetShader(VS, "Basic", "VERTEXCOLOR");
     ShaderVariation* ps = graphics->GetShader(PS, "Basic", "VERTEXCOLOR");
 
-    unsigned numVertices = (lines_.size() + noDepthLines_.size()) * 2 + (triangles_.size() + noDepthTriangles_.size()) * 3;
-    // Resize the vertex buffer if too small or much too large
-    if (vertexBuffer_->GetVertexCount() < numVertices || vertexBuffer_->GetVertexCount() > numVertices * 2)
-        vertexBuffer_->SetSize(numVertices, MASK_POSITION | MASK_COLOR, true);
+    graphics->SetColorWrite(true);
+    graphics->SetCullMode(CULL_NONE);
+    graphics->SetLineAntiAlias(lineAntiAlias_);
+    graphics->SetScissorTest(false);
+    graphics->SetStencilTest(false);
+    graphics->SetShaders(vs, ps);
+    graphics->SetShaderParameter(VSP_MODEL, Matrix3x4::IDENTITY);
+    graphics->SetShaderParameter(VSP_VIEW, view_);
+    graphics->SetShaderParameter(VSP_VIEWINV, view_.Inverse());
+    graphics->SetShaderParameter(VSP_VIEWPROJ, gpuProjection_ * view_);
+    graphics->SetShaderParameter(PSP_MATDIFFCOLOR, Color(1.0f, 1.0f, 1.0f, 1.0f));
 
-    auto* dest = (float*)vertexBuffer_->Lock(0, numVertices, true);
-    if (!dest)
-        return;
+    if (UpdateRetainedVertexBuffer())
+    {
+        graphics->SetVertexBuffer(retainedVertexBuffer_);
+        DrawPrimitives(retained_.lines_.size(), retained_.noDepthLines_.size(), retained_.triangles_.size(),
+            retained_.noDepthTriangles_.size());
+    }
 
-    for (unsigned i = 0; i < lines_.size(); ++i)
+    if (UpdateVertexBuffer())
     {
-        const DebugLine& line = lines_[i];
+        graphics->SetVertexBuffer(vertexBuffer_);
+        DrawPrimitives(uploadedCounts_[0], uploadedCounts_[1], uploadedCounts_[2], uploadedCounts_[3]);
+    }
 
-        dest[0] = line.start_.x_;
-        dest[1] = line.start_.y_;
-        dest[2] = line.start_.z_;
-        ((unsigned&)dest[3]) = line.color_;
-        dest[4] = line.end_.x_;
-        dest[5] = line.end_.y_;
-        dest[6] = line.end_.z_;
-        ((unsigned&)dest[7]) = line.color_;
+    graphics->SetLineAntiAlias(false);
+}
 
-        dest += 8;
-    }
+DebugPrimitives* DebugRenderer::GetThreadPrimitives()
+{
+    const unsigned slot = GetThreadSlot();
+    if (slot == 0)
+        return addingRetained_ ? &retained_ : &threadPrimitives_[0];
+    return slot < threadPrimitives_.size() ? &threadPrimitives_[slot] : nullptr;
+}
 
-    for (unsigned i = 0; i < noDepthLines_.size(); ++i)
+bool DebugRenderer::UpdateVertexBuffer()
+{
+    unsigned counts[4]{};
+    for (const DebugPrimitives& primitives : threadPrimitives_)
     {
-        const DebugLine& line = noDepthLines_[i];
+        counts[0] += primitives.lines_.size();
+        counts[1] += primitives.noDepthLines_.size();
+        counts[2] += primitives.triangles_.size();
+        counts[3] += primitives.noDepthTriangles_.size();
+    }
 
-        dest[0] = line.start_.x_;
-        dest[1] = line.start_.y_;
-        dest[2] = line.start_.z_;
-        ((unsigned&)dest[3]) = line.color_;
-        dest[4] = line.end_.x_;
-        dest[5] = line.end_.y_;
-        dest[6] = line.end_.z_;
-        ((unsigned&)dest[7]) = line.color_;
+    const unsigned numVertices = (counts[0] + counts[1]) * 2 + (counts[2] + counts[3]) * 3;
+    if (!numVertices)
+        return false;
 
-        dest += 8;
-    }
+    // Upload once per frame, unless geometry was added after the previous upload
+    if (uploaded_ && ea::equal(ea::begin(counts), ea::end(counts), uploadedCounts_))
+        return true;
 
-    for (unsigned i = 0; i < triangles_.size(); ++i)
-    {
-        const DebugTriangle& triangle = triangles_[i];
+    // Resize the vertex buffer if too small or much too large
+    if (vertexBuffer_->GetVertexCount() < numVertices || vertexBuffer_->GetVertexCount() > numVertices * 2)
+        vertexBuffer_->SetSize(numVertices, MASK_POSITION | MASK_COLOR, true);
 
-        dest[0] = triangle.v1_.x_;
-        dest[1] = triangle.v1_.y_;
-        dest[2] = triangle.v1_.z_;
-        ((unsigned&)dest[3]) = triangle.color_;
+    auto* dest = (float*)vertexBuffer_->Lock(0, numVertices, true);
+    if (!dest)
+        return false;
 
-        dest[4] = triangle.v2_.x_;
-        dest[5] = triangle.v2_.y_;
-        dest[6] = triangle.v2_.z_;
-        ((unsigned&)dest[7]) = triangle.color_;
+    for (const DebugPrimitives& primitives : threadPrimitives_)
+        dest = WriteLines(dest, primitives.lines_);
+    for (const DebugPrimitives& primitives : threadPrimitives_)
+        dest = WriteLines(dest, primitives.noDepthLines_);
+    for (const DebugPrimitives& primitives : threadPrimitives_)
+        dest = WriteTriangles(dest, primitives.triangles_);
+    for (const DebugPrimitives& primitives : threadPrimitives_)
+        dest = WriteTriangles(dest, primitives.noDepthTriangles_);
 
-        dest[8] = triangle.v3_.x_;
-        dest[9] = triangle.v3_.y_;
-        dest[10] = triangle.v3_.z_;
-        ((unsigned&)dest[11]) = triangle.color_;
+    vertexBuffer_->Unlock();
 
-        dest += 12;
-    }
+    uploaded_ = true;
+    ea::copy(ea::begin(counts), ea::end(counts), uploadedCounts_);
+    return true;
+}
 
-    for (unsigned i = 0; i < noDepthTriangles_.size(); ++i)
-    {
-        const DebugTriangle& triangle = noDepthTriangles_[i];
+bool DebugRenderer::UpdateRetainedVertexBuffer()
+{
+    const unsigned numVertices = retained_.GetNumVertices();
+    if (!numVertices)
+        return false;
 
-        dest[0] = triangle.v1_.x_;
-        dest[1] = triangle.v1_.y_;
-        dest[2] = triangle.v1_.z_;
-        ((unsigned&)dest[3]) = triangle.color_;
+    if (!retainedDirty_ && !retainedVertexBuffer_->IsDataLost())
+        return true;
 
-        dest[4] = triangle.v2_.x_;
-        dest[5] = triangle.v2_.y_;
-        dest[6] = triangle.v2_.z_;
-        ((unsigned&)dest[7]) = triangle.color_;
+    // Retained geometry changes rarely, so use a static buffer of exact size
+    if (retainedVertexBuffer_->GetVertexCount() != numVertices)
+        retainedVertexBuffer_->SetSize(numVertices, MASK_POSITION | MASK_COLOR, false);
 
-        dest[8] = triangle.v3_.x_;
-        dest[9] = triangle.v3_.y_;
-        dest[10] = triangle.v3_.z_;
-        ((unsigned&)dest[11]) = triangle.color_;
+    auto* dest = (float*)retainedVertexBuffer_->Lock(0, numVertices, true);
+    if (!dest)
+        return false;
 
-        dest += 12;
-    }
+    dest = WriteLines(dest, retained_.lines_);
+    dest = WriteLines(dest, retained_.noDepthLines_);
+    dest = WriteTriangles(dest, retained_.triangles_);
+    WriteTriangles(dest, retained_.noDepthTriangles_);
 
-    vertexBuffer_->Unlock();
+    retainedVertexBuffer_->Unlock();
+    retainedVertexBuffer_->ClearDataLost();
+
+    retainedDirty_ = false;
+    return true;
+}
+
+void DebugRenderer::DrawPrimitives(unsigned numLines, unsigned numNoDepthLines, unsigned numTriangles, unsigned numNoDepthTriangles)
+{
+    auto* graphics = GetSubsystem<Graphics>();
 
     graphics->SetBlendMode(lineAntiAlias_ ? BLEND_ALPHA : BLEND_REPLACE);
-    graphics->SetColorWrite(true);
-    graphics->SetCullMode(CULL_NONE);
     graphics->SetDepthWrite(true);
-    graphics->SetLineAntiAlias(lineAntiAlias_);
-    graphics->SetScissorTest(false);
-    graphics->SetStencilTest(false);
-    graphics->SetShaders(vs, ps);
-    graphics->SetShaderParameter(VSP_MODEL, Matrix3x4::IDENTITY);
-    graphics->SetShaderParameter(VSP_VIEW, view_);
-    graphics->SetShaderParameter(VSP_VIEWINV, view_.Inverse());
-    graphics->SetShaderParameter(VSP_VIEWPROJ, gpuProjection_ * view_);
-    graphics->SetShaderParameter(PSP_MATDIFFCOLOR, Color(1.0f, 1.0f, 1.0f, 1.0f));
-    graphics->SetVertexBuffer(vertexBuffer_);
 
     unsigned start = 0;
     unsigned count = 0;
-    if (lines_.size())
+    if (numLines)
     {
-        count = lines_.size() * 2;
+        count = numLines * 2;
         graphics->SetDepthTest(CMP_LESSEQUAL);
         graphics->Draw(LINE_LIST, start, count);
         start += count;
     }
-    if (noDepthLines_.size())
+    if (numNoDepthLines)
     {
-        count = noDepthLines_.size() * 2;
+        count = numNoDepthLines * 2;
         graphics->SetDepthTest(CMP_ALWAYS);
         graphics->Draw(LINE_LIST, start, count);
         start += count;
@@ -674,21 +783,19 @@ void DebugRenderer::Render()
     graphics->SetBlendMode(BLEND_ALPHA);
     graphics->SetDepthWrite(false);
 
-    if (triangles_.size())
+    if (numTriangles)
     {
-        count = triangles_.size() * 3;
+        count = numTriangles * 3;
         graphics->SetDepthTest(CMP_LESSEQUAL);
         graphics->Draw(TRIANGLE_LIST, start, count);
         start += count;
     }
-    if (noDepthTriangles_.size())
+    if (numNoDepthTriangles)
     {
-        count = noDepthTriangles_.size() * 3;
+        count = numNoDepthTriangles * 3;
         graphics->SetDepthTest(CMP_ALWAYS);
         graphics->Draw(TRIANGLE_LIST, start, count);
     }
-
-    graphics->SetLineAntiAlias(false);
 }
 
 bool DebugRenderer::IsInside(const BoundingBox& box) const
@@ -698,30 +805,22 @@ bool DebugRenderer::IsInside(const BoundingBox& box) const
 
 bool DebugRenderer::HasContent() const
 {
-    return !(lines_.empty() && noDepthLines_.empty() && triangles_.empty() && noDepthTriangles_.empty());
+    if (!retained_.IsEmpty())
+        return true;
+
+    for (const DebugPrimitives& primitives : threadPrimitives_)
+    {
+        if (!primitives.IsEmpty())
+            return true;
+    }
+    return false;
 }
 
 void DebugRenderer::HandleEndFrame(StringHash eventType, VariantMap& eventData)
 {
-    // When the amount of debug geometry is reduced, release memory
-    unsigned linesSize = lines_.size();
-    unsigned noDepthLinesSize = noDepthLines_.size();
-    unsigned trianglesSize = triangles_.size();
-    unsigned noDepthTrianglesSize = noDepthTriangles_.size();
-
-    lines_.clear();
-    noDepthLines_.clear();
-    triangles_.clear();
-    noDepthTriangles_.clear();
-
-    if (lines_.capacity() > linesSize * 2)
-        lines_.reserve(linesSize);
-    if (noDepthLines_.capacity() > noDepthLinesSize * 2)
-        noDepthLines_.reserve(noDepthLinesSize);
-    if (triangles_.capacity() > trianglesSize * 2)
-        triangles_.reserve(trianglesSize);
-    if (noDepthTriangles_.capacity() > noDepthTrianglesSize * 2)
-        noDepthTriangles_.reserve(noDepthTrianglesSize);
+    for (DebugPrimitives& primitives : threadPrimitives_)
+        primitives.Clear();
+    uploaded_ = false;
 }
 
 }
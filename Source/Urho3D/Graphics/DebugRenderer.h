@@ -87,7 +87,31 @@ struct DebugTriangle
     unsigned color_{};
 };
 
+/// Debug geometry owned by one producer thread, or retained across frames.
+struct DebugPrimitives
+{
+    /// Return whether has no geometry.
+    bool IsEmpty() const { return lines_.empty() && noDepthLines_.empty() && triangles_.empty() && noDepthTriangles_.empty(); }
+    /// Return vertex count of all geometry.
+    unsigned GetNumVertices() const
+    {
+        return (lines_.size() + noDepthLines_.size()) * 2 + (triangles_.size() + noDepthTriangles_.size()) * 3;
+    }
+    /// Remove all geometry. Release memory when the amount of geometry has reduced.
+    void Clear();
+
+    /// Lines rendered with depth test.
+    ea::vector<DebugLine> lines_;
+    /// Lines rendered without depth test.
+    ea::vector<DebugLine> noDepthLines_;
+    /// Triangles rendered with depth test.
+    ea::vector<DebugTriangle> triangles_;
+    /// Triangles rendered without depth test.
+    ea::vector<DebugTriangle> noDepthTriangles_;
+};
+
 /// Debug geometry rendering component. Should be added only to the root scene node.
+/// Geometry may be added from worker threads: each thread writes into its own buffer without locking, and all buffers are merged when rendering. Worker jobs must complete before the frame is rendered.
 class URHO3D_API DebugRenderer : public Component
 {
     URHO3D_OBJECT(DebugRenderer, Component);
@@ -158,6 +182,13 @@ public:
     /// Add a quad on the XZ plane.
     void AddQuad(const Vector3& center, float width, float height, const Color& color, bool depthTest = true);
 
+    /// Begin adding retained geometry from the main thread. Retained geometry is kept across frames until ClearRetained() and is uploaded only when changed.
+    void BeginRetained();
+    /// End adding retained geometry.
+    void EndRetained();
+    /// Remove all retained geometry.
+    void ClearRetained();
+
     /// Update vertex buffer and render all debug lines. The viewport and rendertarget should be set before.
     void Render();
 
@@ -178,19 +209,33 @@ public:
     bool IsInside(const BoundingBox& box) const;
     /// Return whether has something to render.
     bool HasContent() const;
+    /// Return whether has retained geometry.
+    bool HasRetainedContent() const { return !retained_.IsEmpty(); }
 
 private:
     /// Handle end of frame. Clear debug geometry.
     void HandleEndFrame(StringHash eventType, VariantMap& eventData);
+    /// Return primitive buffer of the calling thread, or null if out of thread slots.
+    DebugPrimitives* GetThreadPrimitives();
+    /// Upload transient geometry of all threads into the vertex buffer if changed since last upload.
+    bool UpdateVertexBuffer();
+    /// Upload retained geometry into the retained vertex buffer if changed.
+    bool UpdateRetainedVertexBuffer();
+    /// Draw geometry from the currently set vertex buffer.
+    void DrawPrimitives(unsigned numLines, unsigned numNoDepthLines, unsigned numTriangles, unsigned numNoDepthTriangles);
 
-    /// Lines rendered with depth test.
-    ea::vector<DebugLine> lines_;
-    /// Lines rendered without depth test.
-    ea::vector<DebugLine> noDepthLines_;
-    /// Triangles rendered with depth test.
-    ea::vector<DebugTriangle> triangles_;
-    /// Triangles rendered without depth test.
-    ea::vector<DebugTriangle> noDepthTriangles_;
+    /// Primitive buffers indexed by thread slot. Slot 0 is the main thread.
+    ea::vector<DebugPrimitives> threadPrimitives_;
+    /// Retained primitives.
+    DebugPrimitives retained_;
+    /// Whether adding retained geometry from the main thread.
+    bool addingRetained_{};
+    /// Whether retained geometry has changed since last upload.
+    bool retainedDirty_{};
+    /// Whether transient geometry has been uploaded this frame.
+    bool uploaded_{};
+    /// Uploaded transient primitive counts: lines, no depth lines, triangles, no depth triangles.
+    unsigned uploadedCounts_[4]{};
     /// View transform.
     Matrix3x4 view_;
     /// Projection transform.
@@ -199,8 +244,10 @@ private:
     Matrix4 gpuProjection_;
     /// View frustum.
     Frustum frustum_;
-    /// Vertex buffer.
+    /// Vertex buffer for transient geometry.
     SharedPtr<VertexBuffer> vertexBuffer_;
+    /// Vertex buffer for retained geometry.
+    SharedPtr<VertexBuffer> retainedVertexBuffer_;
     /// Line antialiasing flag.
     bool lineAntiAlias_;
     /// Active camera.
@@ -0,0 +1,319 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Graphics/Batch.h"
+#include "../Graphics/Camera.h"
+#include "../Graphics/DeferredDecalSet.h"
+#include "../Graphics/Material.h"
+#include "../Graphics/Model.h"
+#include "../IO/MemoryBuffer.h"
+#include "../IO/VectorBuffer.h"
+#include "../Resource/ResourceCache.h"
+#include "../Scene/Scene.h"
+#include "../Scene/SceneEvents.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+extern const char* GEOMETRY_CATEGORY;
+
+static const unsigned DEFAULT_MAX_DECALS = 1024;
+static const BoundingBox UNIT_VOLUME(Vector3(-0.5f, -0.5f, -0.5f), Vector3(0.5f, 0.5f, 0.5f));
+
+DeferredDecalSet::DeferredDecalSet(Context* context) :
+    Drawable(context, DRAWABLE_GEOMETRY),
+    maxDecals_(DEFAULT_MAX_DECALS)
+{
+    batches_.resize(1);
+    batches_[0].worldTransform_ = &Matrix3x4::IDENTITY;
+    batches_[0].numWorldTransforms_ = 0;
+}
+
+DeferredDecalSet::~DeferredDecalSet() = default;
+
+void DeferredDecalSet::RegisterObject(Context* context)
+{
+    context->RegisterFactory<DeferredDecalSet>(GEOMETRY_CATEGORY);
+
+    URHO3D_ACCESSOR_ATTRIBUTE("Is Enabled", IsEnabled, SetEnabled, bool, true, AM_DEFAULT);
+    URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Material", GetMaterialAttr, SetMaterialAttr, ResourceRef, ResourceRef(Material::GetTypeStatic()),
+        AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Max Decals", GetMaxDecals, SetMaxDecals, unsigned, DEFAULT_MAX_DECALS, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Can Be Occluded", IsOccludee, SetOccludee, bool, true, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Draw Distance", GetDrawDistance, SetDrawDistance, float, 0.0f, AM_DEFAULT);
+    URHO3D_COPY_BASE_ATTRIBUTES(Drawable);
+    URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Decals", GetDecalsAttr, SetDecalsAttr, ea::vector<unsigned char>, Variant::emptyBuffer,
+        AM_FILE | AM_NOEDIT);
+}
+
+void DeferredDecalSet::OnSetEnabled()
+{
+    Drawable::OnSetEnabled();
+
+    UpdateEventSubscription(true);
+}
+
+void DeferredDecalSet::ProcessRayQuery(const RayOctreeQuery& query, ea::vector<RayQueryResult>& results)
+{
+    // Do not return raycast hits
+}
+
+void DeferredDecalSet::UpdateBatches(const FrameInfo& frame)
+{
+    // Getting the world bounding box ensures the transforms are updated
+    const BoundingBox& worldBoundingBox = GetWorldBoundingBox();
+    distance_ = frame.camera_->GetDistance(worldBoundingBox.Center());
+
+    batches_[0].distance_ = distance_;
+    batches_[0].worldTransform_ = !worldTransforms_.empty() ? &worldTransforms_[0] : &Matrix3x4::IDENTITY;
+    batches_[0].numWorldTransforms_ = worldTransforms_.size();
+}
+
+void DeferredDecalSet::SetMaterial(Material* material)
+{
+    batches_[0].material_ = material;
+    MarkNetworkUpdate();
+}
+
+void DeferredDecalSet::SetMaxDecals(unsigned num)
+{
+    maxDecals_ = Max(num, 1u);
+    while (decals_.size() > maxDecals_)
+        RemoveDecal(0);
+    nextDecal_ = 0;
+    MarkNetworkUpdate();
+}
+
+void DeferredDecalSet::AddDecal(const Vector3& worldPosition, const Quaternion& worldRotation, float size, float aspectRatio,
+    float depth, float timeToLive)
+{
+    if (!node_)
+        return;
+
+    DeferredDecal decal;
+    decal.transform_ = node_->GetWorldTransform().Inverse() * Matrix3x4(worldPosition, worldRotation,
+        Vector3(size * aspectRatio, size, depth));
+    decal.timeToLive_ = timeToLive;
+    AddDecalInternal(decal);
+
+    if (timeToLive > 0.0f)
+        UpdateEventSubscription(false);
+
+    MarkNetworkUpdate();
+}
+
+void DeferredDecalSet::RemoveAllDecals()
+{
+    decals_.clear();
+    worldTransforms_.clear();
+    nextDecal_ = 0;
+    OnMarkedDirty(node_);
+    UpdateEventSubscription(true);
+    MarkNetworkUpdate();
+}
+
+Material* DeferredDecalSet::GetMaterial() const
+{
+    return batches_[0].material_;
+}
+
+void DeferredDecalSet::SetMaterialAttr(const ResourceRef& value)
+{
+    auto* cache = GetSubsystem<ResourceCache>();
+    SetMaterial(cache->GetResource<Material>(value.name_));
+}
+
+void DeferredDecalSet::SetDecalsAttr(const ea::vector<unsigned char>& value)
+{
+    decals_.clear();
+    worldTransforms_.clear();
+    nextDecal_ = 0;
+
+    MemoryBuffer buffer(value);
+    unsigned numDecals = !value.empty() ? buffer.ReadVLE() : 0;
+    while (numDecals--)
+    {
+        DeferredDecal decal;
+        decal.timer_ = buffer.ReadFloat();
+        decal.timeToLive_ = buffer.ReadFloat();
+        decal.transform_ = Matrix3x4(buffer.ReadVector3(), buffer.ReadQuaternion(), buffer.ReadVector3());
+        decals_.push_back(decal);
+    }
+
+    OnMarkedDirty(node_);
+    UpdateEventSubscription(true);
+}
+
+ResourceRef DeferredDecalSet::GetMaterialAttr() const
+{
+    return GetResourceRef(batches_[0].material_, Material::GetTypeStatic());
+}
+
+ea::vector<unsigned char> DeferredDecalSet::GetDecalsAttr() const
+{
+    VectorBuffer ret;
+
+    ret.WriteVLE(decals_.size());
+    for (const DeferredDecal& decal : decals_)
+    {
+        Vector3 position;
+        Quaternion rotation;
+        Vector3 scale;
+        decal.transform_.Decompose(position, rotation, scale);
+
+        ret.WriteFloat(decal.timer_);
+        ret.WriteFloat(decal.timeToLive_);
+        ret.WriteVector3(position);
+        ret.WriteQuaternion(rotation);
+        ret.WriteVector3(scale);
+    }
+
+    return ret.GetBuffer();
+}
+
+void DeferredDecalSet::OnSceneSet(Scene* scene)
+{
+    Drawable::OnSceneSet(scene);
+
+    if (scene)
+    {
+        // Decal volumes share the geometry, so that they can be instanced with other decal sets
+        if (!volumeModel_)
+        {
+            auto* cache = GetSubsystem<ResourceCache>();
+            volumeModel_ = cache->GetResource<Model>("Models/Box.mdl");
+            batches_[0].geometry_ = volumeModel_ ? volumeModel_->GetGeometry(0, 0) : nullptr;
+        }
+        UpdateEventSubscription(true);
+    }
+    else
+    {
+        UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
+        subscribed_ = false;
+    }
+}
+
+void DeferredDecalSet::OnWorldBoundingBoxUpdate()
+{
+    const Matrix3x4& worldTransform = node_->GetWorldTransform();
+
+    BoundingBox worldBox;
+    worldTransforms_.resize(decals_.size());
+    for (unsigned i = 0; i < decals_.size(); ++i)
+    {
+        worldTransforms_[i] = worldTransform * decals_[i].transform_;
+        worldBox.Merge(UNIT_VOLUME.Transformed(worldTransforms_[i]));
+    }
+
+    // Always merge the node's own position so that the bounding box is defined without decals
+    worldBox.Merge(node_->GetWorldPosition());
+    worldBoundingBox_ = worldBox;
+}
+
+void DeferredDecalSet::AddDecalInternal(const DeferredDecal& decal)
+{
+    // Keep the cached world data in sync without recalculating all decals, so that adding a decal has constant cost
+    const Matrix3x4 worldTransform = node_->GetWorldTransform() * decal.transform_;
+    if (decals_.size() < maxDecals_)
+    {
+        decals_.push_back(decal);
+        if (!worldBoundingBoxDirty_)
+            worldTransforms_.push_back(worldTransform);
+    }
+    else
+    {
+        decals_[nextDecal_] = decal;
+        if (!worldBoundingBoxDirty_)
+            worldTransforms_[nextDecal_] = worldTransform;
+        nextDecal_ = (nextDecal_ + 1) % maxDecals_;
+    }
+
+    if (!worldBoundingBoxDirty_)
+    {
+        worldBoundingBox_.Merge(UNIT_VOLUME.Transformed(worldTransform));
+        // Reinsert to octree with the grown bounding box
+        MarkForUpdate();
+    }
+}
+
+void DeferredDecalSet::RemoveDecal(unsigned index)
+{
+    // Order of decals only matters for replacing the oldest one, so removal swaps with the last
+    decals_[index] = decals_.back();
+    decals_.pop_back();
+    if (nextDecal_ >= decals_.size())
+        nextDecal_ = 0;
+    OnMarkedDirty(node_);
+}
+
+void DeferredDecalSet::UpdateEventSubscription(bool checkAllDecals)
+{
+    Scene* scene = GetScene();
+    if (!scene)
+        return;
+
+    bool enabled = IsEnabledEffective();
+
+    if (enabled && checkAllDecals)
+    {
+        // If no time limited decals, no need to subscribe to scene update
+        enabled = ea::any_of(decals_.begin(), decals_.end(), [](const DeferredDecal& decal) { return decal.timeToLive_ > 0.0f; });
+    }
+
+    if (enabled && !subscribed_)
+    {
+        SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(DeferredDecalSet, HandleScenePostUpdate));
+        subscribed_ = true;
+    }
+    else if (!enabled && subscribed_)
+    {
+        UnsubscribeFromEvent(scene, E_SCENEPOSTUPDATE);
+        subscribed_ = false;
+    }
+}
+
+void DeferredDecalSet::HandleScenePostUpdate(StringHash eventType, VariantMap& eventData)
+{
+    using namespace ScenePostUpdate;
+
+    const float timeStep = eventData[P_TIMESTEP].GetFloat();
+
+    for (unsigned i = 0; i < decals_.size();)
+    {
+        DeferredDecal& decal = decals_[i];
+        decal.timer_ += timeStep;
+
+        // Remove the decal if time to live expired
+        if (decal.timeToLive_ > 0.0f && decal.timer_ > decal.timeToLive_)
+            RemoveDecal(i);
+        else
+            ++i;
+    }
+}
+
+}
@@ -0,0 +1,126 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Graphics/Drawable.h"
+#include "../Math/Matrix3x4.h"
+
+namespace Urho3D
+{
+
+class Model;
+
+/// One decal volume in a deferred decal set.
+struct URHO3D_API DeferredDecal
+{
+    /// Transform of the unit decal volume relative to the decal set node. Decal is projected along the Z axis of the volume.
+    Matrix3x4 transform_;
+    /// Decal age timer.
+    float timer_{};
+    /// Maximum time to live in seconds (0 = infinite).
+    float timeToLive_{};
+};
+
+/// Deferred decal renderer component. Decal volumes are projected onto the scene depth in the "decal" pass of deferred render paths and blended into the G-buffer, so adding a decal does not touch scene geometry. All decals are drawn as instances of one batch.
+class URHO3D_API DeferredDecalSet : public Drawable
+{
+    URHO3D_OBJECT(DeferredDecalSet, Drawable);
+
+public:
+    /// Construct.
+    explicit DeferredDecalSet(Context* context);
+    /// Destruct.
+    ~DeferredDecalSet() override;
+    /// Register object factory.
+    /// @nobind
+    static void RegisterObject(Context* context);
+
+    /// Handle enabled/disabled state change.
+    void OnSetEnabled() override;
+    /// Process octree raycast. May be called from a worker thread.
+    void ProcessRayQuery(const RayOctreeQuery& query, ea::vector<RayQueryResult>& results) override;
+    /// Calculate distance and prepare batches for rendering. May be called from worker thread(s), possibly re-entrantly.
+    void UpdateBatches(const FrameInfo& frame) override;
+
+    /// Set material. The material should use a technique with the "decal" pass, such as DiffDecal.
+    /// @property
+    void SetMaterial(Material* material);
+    /// Set maximum number of decals. When exceeded, the oldest decal is replaced.
+    /// @property
+    void SetMaxDecals(unsigned num);
+    /// Add a decal centered at world coordinates and projected along the forward axis of the world rotation, like DecalSet decals. Depth is the extent of the projection volume across the surface.
+    void AddDecal(const Vector3& worldPosition, const Quaternion& worldRotation, float size, float aspectRatio, float depth,
+        float timeToLive = 0.0f);
+    /// Remove all decals.
+    void RemoveAllDecals();
+
+    /// Return material.
+    /// @property
+    Material* GetMaterial() const;
+    /// Return number of decals.
+    /// @property
+    unsigned GetNumDecals() const { return decals_.size(); }
+    /// Return maximum number of decals.
+    /// @property
+    unsigned GetMaxDecals() const { return maxDecals_; }
+
+    /// Set material attribute.
+    void SetMaterialAttr(const ResourceRef& value);
+    /// Set decals attribute.
+    void SetDecalsAttr(const ea::vector<unsigned char>& value);
+    /// Return material attribute.
+    ResourceRef GetMaterialAttr() const;
+    /// Return decals attribute.
+    ea::vector<unsigned char> GetDecalsAttr() const;
+
+protected:
+    /// Handle scene being assigned.
+    void OnSceneSet(Scene* scene) override;
+    /// Recalculate the world-space bounding box.
+    void OnWorldBoundingBoxUpdate() override;
+
+private:
+    /// Add decal with transform relative to the node.
+    void AddDecalInternal(const DeferredDecal& decal);
+    /// Remove decal by index.
+    void RemoveDecal(unsigned index);
+    /// Subscribe to or unsubscribe from scene post-update depending on time limited decals.
+    void UpdateEventSubscription(bool checkAllDecals);
+    /// Handle scene post-update event.
+    void HandleScenePostUpdate(StringHash eventType, VariantMap& eventData);
+
+    /// Unit box model used as decal volume.
+    SharedPtr<Model> volumeModel_;
+    /// Decals.
+    ea::vector<DeferredDecal> decals_;
+    /// World transforms of decals.
+    ea::vector<Matrix3x4> worldTransforms_;
+    /// Maximum number of decals.
+    unsigned maxDecals_;
+    /// Index of the decal to be replaced next when the maximum is reached.
+    unsigned nextDecal_{};
+    /// Subscribed to scene post update event flag.
+    bool subscribed_{};
+};
+
+}
@@ -91,6 +91,7 @@ void ConstantBuffer::Apply()
     if (dirty_ && object_.ptr_)
     {
         graphics_->GetImpl()->GetDeviceContext()->UpdateSubresource((ID3D11Buffer*)object_.ptr_, 0, 0, shadowData_.get(), 0, 0);
+        graphics_->AddUploadedBytes(size_);
         dirty_ = false;
     }
 }
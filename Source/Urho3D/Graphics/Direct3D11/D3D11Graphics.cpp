@@ -25,6 +25,7 @@
 #include "../../Core/Context.h"
 #include "../../Core/ProcessUtils.h"
 #include "../../Core/Profiler.h"
+#include "../../Core/Timer.h"
 #include "../../Graphics/ConstantBuffer.h"
 #include "../../Graphics/Geometry.h"
 #include "../../Graphics/Graphics.h"
@@ -232,6 +233,11 @@ Graphics::Graphics(Context* context) :
 
 Graphics::~Graphics()
 {
+    CleanupTextureReadbacks();
+
+    // Drop uploads that were never executed, releasing their owners while the graphics context still exists
+    queuedUploads_.clear();
+
     {
         MutexLock lock(gpuObjectMutex_);
 
@@ -267,6 +273,23 @@ Graphics::~Graphics()
     URHO3D_SAFE_RELEASE(impl_->defaultDepthStencilView_);
     URHO3D_SAFE_RELEASE(impl_->defaultDepthTexture_);
     URHO3D_SAFE_RELEASE(impl_->resolveTexture_);
+    for (unsigned i = 0; i < NUM_GPU_FRAME_QUERIES; ++i)
+    {
+        URHO3D_SAFE_RELEASE(impl_->gpuFrameDisjointQueries_[i]);
+        URHO3D_SAFE_RELEASE(impl_->gpuFrameBeginQueries_[i]);
+        URHO3D_SAFE_RELEASE(impl_->gpuFrameEndQueries_[i]);
+    }
+#ifdef URHO3D_GPU_PROFILING
+    for (unsigned i = 0; i < Min(gpuZoneDepth_, MAX_GPU_ZONE_DEPTH); ++i)
+        impl_->gpuZones_[i].reset();
+    gpuZoneDepth_ = 0;
+    if (impl_->gpuProfilerContext_)
+    {
+        TracyD3D11Destroy(impl_->gpuProfilerContext_);
+        impl_->gpuProfilerContext_ = nullptr;
+    }
+#endif
+
     URHO3D_SAFE_RELEASE(impl_->swapChain_);
     URHO3D_SAFE_RELEASE(impl_->deviceContext_);
     URHO3D_SAFE_RELEASE(impl_->device_);
@@ -485,6 +508,16 @@ bool Graphics::BeginFrame()
 
     numPrimitives_ = 0;
     numBatches_ = 0;
+    frameStatistics_ = DrawCallStatistics();
+
+    // Skip measuring when the GPU is so far behind that all queries are still in flight
+    const unsigned queryIndex = impl_->gpuFrameQueryIndex_;
+    if (gpuFrameTimingSupport_ && !impl_->gpuFrameQueryPending_[queryIndex])
+    {
+        impl_->deviceContext_->Begin(impl_->gpuFrameDisjointQueries_[queryIndex]);
+        impl_->deviceContext_->End(impl_->gpuFrameBeginQueries_[queryIndex]);
+        impl_->gpuFrameQueryActive_ = true;
+    }
 
     SendEvent(E_BEGINRENDERING);
     return true;
@@ -499,9 +532,57 @@ void Graphics::EndFrame()
         URHO3D_PROFILE("Present");
 
         SendEvent(E_ENDRENDERING);
+
+        if (impl_->gpuFrameQueryActive_)
+        {
+            const unsigned queryIndex = impl_->gpuFrameQueryIndex_;
+            impl_->deviceContext_->End(impl_->gpuFrameEndQueries_[queryIndex]);
+            impl_->deviceContext_->End(impl_->gpuFrameDisjointQueries_[queryIndex]);
+            impl_->gpuFrameQueryPending_[queryIndex] = true;
+            impl_->gpuFrameQueryIndex_ = (queryIndex + 1) % NUM_GPU_FRAME_QUERIES;
+            impl_->gpuFrameQueryActive_ = false;
+        }
+
         impl_->swapChain_->Present(screenParams_.vsync_ ? 1 : 0, 0);
     }
 
+    // Read back finished frame time queries from oldest to newest without waiting for the GPU
+    for (unsigned i = 0; i < NUM_GPU_FRAME_QUERIES; ++i)
+    {
+        const unsigned index = (impl_->gpuFrameQueryIndex_ + i) % NUM_GPU_FRAME_QUERIES;
+        if (!impl_->gpuFrameQueryPending_[index])
+            continue;
+
+        D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+        UINT64 beginTime = 0;
+        UINT64 endTime = 0;
+        if (impl_->deviceContext_->GetData(impl_->gpuFrameDisjointQueries_[index], &disjoint, sizeof disjoint,
+                D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+            impl_->deviceContext_->GetData(impl_->gpuFrameBeginQueries_[index], &beginTime, sizeof beginTime,
+                D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+            impl_->deviceContext_->GetData(impl_->gpuFrameEndQueries_[index], &endTime, sizeof endTime,
+                D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+            break;
+
+        // Timestamps are unreliable if the GPU clock changed during the frame
+        if (!disjoint.Disjoint && disjoint.Frequency && endTime >= beginTime)
+            gpuFrameTime_ = static_cast<float>((endTime - beginTime) * 1000.0 / disjoint.Frequency);
+        impl_->gpuFrameQueryPending_[index] = false;
+    }
+
+#ifdef URHO3D_GPU_PROFILING
+    if (gpuZoneDepth_ != 0)
+    {
+        URHO3D_LOGWARNING("GPU timing zones were not ended before EndFrame");
+        while (gpuZoneDepth_ != 0)
+            EndGPUZone();
+    }
+    if (impl_->gpuProfilerContext_)
+        TracyD3D11Collect(impl_->gpuProfilerContext_);
+#endif
+
+    UpdateTextureReadbacks();
+
     // Clean up too large scratch buffers
     CleanupScratchBuffers();
 
@@ -516,6 +597,88 @@ void Graphics::EndFrame()
     }
 }
 
+void Graphics::UpdateTextureReadbacks()
+{
+    ea::vector<PendingTextureReadback>& readbacks = impl_->pendingTextureReadbacks_;
+    for (unsigned i = 0; i < readbacks.size();)
+    {
+        PendingTextureReadback& readback = readbacks[i];
+
+        D3D11_MAPPED_SUBRESOURCE mappedData;
+        mappedData.pData = nullptr;
+        HRESULT hr = impl_->deviceContext_->Map((ID3D11Resource*)readback.stagingTexture_, 0, D3D11_MAP_READ,
+            D3D11_MAP_FLAG_DO_NOT_WAIT, &mappedData);
+        if (hr == DXGI_ERROR_WAS_STILL_DRAWING)
+        {
+            ++i;
+            continue;
+        }
+
+        ea::vector<unsigned char> data;
+        if (SUCCEEDED(hr) && mappedData.pData)
+        {
+            data.resize(readback.rowSize_ * readback.numRows_);
+            for (unsigned row = 0; row < readback.numRows_; ++row)
+            {
+                memcpy(data.data() + row * readback.rowSize_, (unsigned char*)mappedData.pData + row * mappedData.RowPitch,
+                    readback.rowSize_);
+            }
+            impl_->deviceContext_->Unmap((ID3D11Resource*)readback.stagingTexture_, 0);
+        }
+        else
+            URHO3D_LOGD3DERROR("Failed to map staging texture for GetDataAsync", hr);
+
+        URHO3D_SAFE_RELEASE(readback.stagingTexture_);
+
+        // Remove before invoking, the callback may start new readbacks
+        TextureReadbackCallback callback = ea::move(readback.callback_);
+        readbacks.erase(readbacks.begin() + i);
+        if (callback)
+            callback(data);
+    }
+}
+
+void Graphics::CleanupTextureReadbacks()
+{
+    ea::vector<PendingTextureReadback> readbacks = ea::move(impl_->pendingTextureReadbacks_);
+    impl_->pendingTextureReadbacks_.clear();
+
+    const ea::vector<unsigned char> emptyData;
+    for (PendingTextureReadback& readback : readbacks)
+    {
+        URHO3D_SAFE_RELEASE(readback.stagingTexture_);
+        if (readback.callback_)
+            readback.callback_(emptyData);
+    }
+}
+
+void Graphics::BeginGPUZone(const char* name)
+{
+#ifdef URHO3D_GPU_PROFILING
+    if (gpuZoneDepth_ < MAX_GPU_ZONE_DEPTH)
+    {
+        impl_->gpuZones_[gpuZoneDepth_].emplace(impl_->gpuProfilerContext_, __LINE__, __FILE__, strlen(__FILE__),
+            __FUNCTION__, strlen(__FUNCTION__), name, strlen(name), gpuProfilingSupport_);
+    }
+    ++gpuZoneDepth_;
+#endif
+}
+
+void Graphics::EndGPUZone()
+{
+#ifdef URHO3D_GPU_PROFILING
+    if (gpuZoneDepth_ == 0)
+    {
+        URHO3D_LOGERROR("EndGPUZone called without matching BeginGPUZone");
+        return;
+    }
+
+    --gpuZoneDepth_;
+    if (gpuZoneDepth_ < MAX_GPU_ZONE_DEPTH)
+        impl_->gpuZones_[gpuZoneDepth_].reset();
+#endif
+}
+
 void Graphics::Clear(ClearTargetFlags flags, const Color& color, float depth, unsigned stencil)
 {
     IntVector2 rtSize = GetRenderTargetDimensions();
@@ -705,6 +868,8 @@ void Graphics::Draw(PrimitiveType type, unsigned vertexStart, unsigned vertexCou
 
     numPrimitives_ += primitiveCount;
     ++numBatches_;
+    ++frameStatistics_.numDraws_;
+    frameStatistics_.numPrimitives_ += primitiveCount;
 }
 
 void Graphics::Draw(PrimitiveType type, unsigned indexStart, unsigned indexCount, unsigned minVertex, unsigned vertexCount)
@@ -730,6 +895,8 @@ void Graphics::Draw(PrimitiveType type, unsigned indexStart, unsigned indexCount
 
     numPrimitives_ += primitiveCount;
     ++numBatches_;
+    ++frameStatistics_.numDraws_;
+    frameStatistics_.numPrimitives_ += primitiveCount;
 }
 
 void Graphics::Draw(PrimitiveType type, unsigned indexStart, unsigned indexCount, unsigned baseVertexIndex, unsigned minVertex, unsigned vertexCount)
@@ -755,6 +922,8 @@ void Graphics::Draw(PrimitiveType type, unsigned indexStart, unsigned indexCount
 
     numPrimitives_ += primitiveCount;
     ++numBatches_;
+    ++frameStatistics_.numDraws_;
+    frameStatistics_.numPrimitives_ += primitiveCount;
 }
 
 void Graphics::DrawInstanced(PrimitiveType type, unsigned indexStart, unsigned indexCount, unsigned minVertex, unsigned vertexCount,
@@ -781,6 +950,10 @@ void Graphics::DrawInstanced(PrimitiveType type, unsigned indexStart, unsigned i
 
     numPrimitives_ += instanceCount * primitiveCount;
     ++numBatches_;
+    ++frameStatistics_.numDraws_;
+    ++frameStatistics_.numInstancedDraws_;
+    frameStatistics_.numInstances_ += instanceCount;
+    frameStatistics_.numPrimitives_ += instanceCount * primitiveCount;
 }
 
 void Graphics::DrawInstanced(PrimitiveType type, unsigned indexStart, unsigned indexCount, unsigned baseVertexIndex, unsigned minVertex, unsigned vertexCount,
@@ -807,6 +980,10 @@ void Graphics::DrawInstanced(PrimitiveType type, unsigned indexStart, unsigned i
 
     numPrimitives_ += instanceCount * primitiveCount;
     ++numBatches_;
+    ++frameStatistics_.numDraws_;
+    ++frameStatistics_.numInstancedDraws_;
+    frameStatistics_.numInstances_ += instanceCount;
+    frameStatistics_.numPrimitives_ += instanceCount * primitiveCount;
 }
 
 void Graphics::SetVertexBuffer(VertexBuffer* buffer)
@@ -912,6 +1089,8 @@ void Graphics::SetShaders(ShaderVariation* vs, ShaderVariation* ps)
     if (vs == vertexShader_ && ps == pixelShader_)
         return;
 
+    ++frameStatistics_.numShaderChanges_;
+
     if (vs != vertexShader_)
     {
         // Create the shader now if not yet created. If already attempted, do not retry
@@ -921,7 +1100,11 @@ void Graphics::SetShaders(ShaderVariation* vs, ShaderVariation* ps)
             {
                 URHO3D_PROFILE("CompileVertexShader");
 
+                HiresTimer compileTimer;
                 bool success = vs->Create();
+                ++frameStatistics_.numShaderCompiles_;
+                if (shaderPrecache_)
+                    shaderPrecache_->StoreCompileTime(vs, compileTimer.GetUSec(false));
                 if (!success)
                 {
                     URHO3D_LOGERROR("Failed to compile vertex shader " + vs->GetFullName() + ":\n" + vs->GetCompilerOutput());
@@ -945,7 +1128,11 @@ void Graphics::SetShaders(ShaderVariation* vs, ShaderVariation* ps)
             {
                 URHO3D_PROFILE("CompilePixelShader");
 
+                HiresTimer compileTimer;
                 bool success = ps->Create();
+                ++frameStatistics_.numShaderCompiles_;
+                if (shaderPrecache_)
+                    shaderPrecache_->StoreCompileTime(ps, compileTimer.GetUSec(false));
                 if (!success)
                 {
                     URHO3D_LOGERROR("Failed to compile pixel shader " + ps->GetFullName() + ":\n" + ps->GetCompilerOutput());
@@ -1229,6 +1416,7 @@ void Graphics::SetTexture(unsigned index, Texture* texture)
         }
 
         textures_[index] = texture;
+        ++frameStatistics_.numTextureChanges_;
         impl_->shaderResourceViews_[index] = texture ? (ID3D11ShaderResourceView*)texture->GetShaderResourceView() : nullptr;
         impl_->samplers_[index] = texture ? (ID3D11SamplerState*)texture->GetSampler() : nullptr;
         impl_->texturesDirty_ = true;
@@ -1967,6 +2155,11 @@ bool Graphics::GetGL3Support()
     return gl3Support;
 }
 
+bool Graphics::GetBaseVertexSupport()
+{
+    return true;
+}
+
 bool Graphics::OpenWindow(int width, int height, bool resizable, bool borderless)
 {
     if (!externalWindow_)
@@ -2093,6 +2286,25 @@ bool Graphics::CreateDevice(int width, int height)
         CheckFeatureSupport();
         // Set the flush mode now as the device has been created
         SetFlushGPU(flushGPU_);
+
+        D3D11_QUERY_DESC disjointDesc = {D3D11_QUERY_TIMESTAMP_DISJOINT, 0};
+        D3D11_QUERY_DESC timestampDesc = {D3D11_QUERY_TIMESTAMP, 0};
+        gpuFrameTimingSupport_ = true;
+        for (unsigned i = 0; i < NUM_GPU_FRAME_QUERIES && gpuFrameTimingSupport_; ++i)
+        {
+            gpuFrameTimingSupport_ = SUCCEEDED(impl_->device_->CreateQuery(&disjointDesc, &impl_->gpuFrameDisjointQueries_[i])) &&
+                SUCCEEDED(impl_->device_->CreateQuery(&timestampDesc, &impl_->gpuFrameBeginQueries_[i])) &&
+                SUCCEEDED(impl_->device_->CreateQuery(&timestampDesc, &impl_->gpuFrameEndQueries_[i]));
+        }
+        if (!gpuFrameTimingSupport_)
+            URHO3D_LOGWARNING("Failed to create GPU frame timing queries");
+
+#ifdef URHO3D_GPU_PROFILING
+        // Timestamp queries are always available on D3D11
+        impl_->gpuProfilerContext_ = TracyD3D11Context(impl_->device_, impl_->deviceContext_);
+        TracyD3D11ContextName(impl_->gpuProfilerContext_, "D3D11", 5);
+        gpuProfilingSupport_ = true;
+#endif
     }
 
     // Check that multisample level is supported
@@ -2519,6 +2731,7 @@ void Graphics::PrepareDraw()
 
             impl_->deviceContext_->OMSetBlendState(i->second, nullptr, M_MAX_UNSIGNED);
             impl_->blendStateHash_ = newBlendStateHash;
+            ++frameStatistics_.numStateChanges_;
         }
 
         impl_->blendStateDirty_ = false;
@@ -2567,6 +2780,7 @@ void Graphics::PrepareDraw()
 
             impl_->deviceContext_->OMSetDepthStencilState(i->second, stencilRef_);
             impl_->depthStateHash_ = newDepthStateHash;
+            ++frameStatistics_.numStateChanges_;
         }
 
         impl_->depthStateDirty_ = false;
@@ -2616,6 +2830,7 @@ void Graphics::PrepareDraw()
 
             impl_->deviceContext_->RSSetState(i->second);
             impl_->rasterizerStateHash_ = newRasterizerStateHash;
+            ++frameStatistics_.numStateChanges_;
         }
 
         impl_->rasterizerStateDirty_ = false;
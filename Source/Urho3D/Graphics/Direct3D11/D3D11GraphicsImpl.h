@@ -25,12 +25,19 @@
 #include "../../Graphics/ConstantBuffer.h"
 #include "../../Graphics/GraphicsDefs.h"
 #include "../../Graphics/ShaderProgram.h"
+#include "../../Graphics/Texture2D.h"
 #include "../../Graphics/VertexDeclaration.h"
 #include "../../Math/Color.h"
 
 #include <d3d11.h>
 #include <dxgi1_2.h>
 
+#if URHO3D_PROFILING
+#define URHO3D_GPU_PROFILING 1
+#include <EASTL/optional.h>
+#include <tracy/TracyD3D11.hpp>
+#endif
+
 namespace Urho3D
 {
 
@@ -42,6 +49,19 @@ using ShaderProgramMap = ea::unordered_map<ea::pair<ShaderVariation*, ShaderVari
 using VertexDeclarationMap = ea::unordered_map<unsigned long long, SharedPtr<VertexDeclaration> >;
 using ConstantBufferMap = ea::unordered_map<unsigned, SharedPtr<ConstantBuffer> >;
 
+/// Asynchronous texture readback waiting for the GPU.
+struct PendingTextureReadback
+{
+    /// Staging texture receiving the data.
+    ID3D11Texture2D* stagingTexture_{};
+    /// Size of one row of data in bytes.
+    unsigned rowSize_{};
+    /// Number of rows.
+    unsigned numRows_{};
+    /// Callback to invoke with the data.
+    TextureReadbackCallback callback_;
+};
+
 /// %Graphics implementation. Holds API-specific objects.
 class URHO3D_API GraphicsImpl
 {
@@ -72,6 +92,9 @@ public:
     /// Mark render targets as dirty. Must be called if render targets were set using DX11 device directly.
     void MarkRenderTargetsDirty() { renderTargetsDirty_ = true; }
 
+    /// Return asynchronous texture readbacks waiting for the GPU.
+    ea::vector<PendingTextureReadback>& GetPendingTextureReadbacks() { return pendingTextureReadbacks_; }
+
 private:
     /// Graphics device.
     ID3D11Device* device_;
@@ -149,6 +172,26 @@ private:
     ShaderProgramMap shaderPrograms_;
     /// Shader program in use.
     ShaderProgram* shaderProgram_;
+    /// Asynchronous texture readbacks waiting for the GPU.
+    ea::vector<PendingTextureReadback> pendingTextureReadbacks_;
+    /// Disjoint queries for measuring GPU frame time.
+    ID3D11Query* gpuFrameDisjointQueries_[NUM_GPU_FRAME_QUERIES]{};
+    /// Timestamp queries at the beginning of frames.
+    ID3D11Query* gpuFrameBeginQueries_[NUM_GPU_FRAME_QUERIES]{};
+    /// Timestamp queries at the end of frames.
+    ID3D11Query* gpuFrameEndQueries_[NUM_GPU_FRAME_QUERIES]{};
+    /// Whether each frame time query is waiting for its result.
+    bool gpuFrameQueryPending_[NUM_GPU_FRAME_QUERIES]{};
+    /// Frame time query to use next.
+    unsigned gpuFrameQueryIndex_{};
+    /// Whether a frame time query is open.
+    bool gpuFrameQueryActive_{};
+#ifdef URHO3D_GPU_PROFILING
+    /// Profiler GPU context owning the timestamp queries.
+    tracy::D3D11Ctx* gpuProfilerContext_{};
+    /// Open GPU timing zones.
+    ea::optional<tracy::D3D11ZoneScope> gpuZones_[MAX_GPU_ZONE_DEPTH];
+#endif
 };
 
 }
@@ -72,6 +72,7 @@ bool IndexBuffer::SetData(const void* data)
 
     if (object_.ptr_)
     {
+        graphics_->AddUploadedBytes(indexCount_ * indexSize_);
         if (dynamic_)
         {
             void* hwData = MapBuffer(0, indexCount_, true);
@@ -131,6 +132,7 @@ bool IndexBuffer::SetDataRange(const void* data, unsigned start, unsigned count,
 
     if (object_.ptr_)
     {
+        graphics_->AddUploadedBytes(count * indexSize_);
         if (dynamic_)
         {
             void* hwData = MapBuffer(start, count, discard);
@@ -187,7 +189,10 @@ void* IndexBuffer::Lock(unsigned start, unsigned count, bool discard)
 
     // Because shadow data must be kept in sync, can only lock hardware buffer if not shadowed
     if (object_.ptr_ && !shadowData_ && dynamic_)
+    {
+        graphics_->AddUploadedBytes(count * indexSize_);
         return MapBuffer(start, count, discard);
+    }
     else if (shadowData_)
     {
         lockState_ = LOCK_SHADOW;
@@ -274,12 +279,13 @@ void* IndexBuffer::MapBuffer(unsigned start, unsigned count, bool discard)
         mappedData.pData = nullptr;
 
         HRESULT hr = graphics_->GetImpl()->GetDeviceContext()->Map((ID3D11Buffer*)object_.ptr_, 0, discard ? D3D11_MAP_WRITE_DISCARD :
-            D3D11_MAP_WRITE, 0, &mappedData);
+            D3D11_MAP_WRITE_NO_OVERWRITE, 0, &mappedData);
         if (FAILED(hr) || !mappedData.pData)
             URHO3D_LOGD3DERROR("Failed to map index buffer", hr);
         else
         {
-            hwData = mappedData.pData;
+            // The whole buffer is mapped, so offset to the start of the range
+            hwData = static_cast<unsigned char*>(mappedData.pData) + start * indexSize_;
             lockState_ = LOCK_HARDWARE;
         }
     }
@@ -369,6 +369,74 @@ bool Texture2D::GetData(unsigned level, void* dest) const
     }
 }
 
+bool Texture2D::GetDataAsync(unsigned level, TextureReadbackCallback callback) const
+{
+    if (!object_.ptr_)
+    {
+        URHO3D_LOGERROR("No texture created, can not get data");
+        return false;
+    }
+
+    if (level >= levels_)
+    {
+        URHO3D_LOGERROR("Illegal mip level for getting data");
+        return false;
+    }
+
+    if (multiSample_ > 1 && !autoResolve_)
+    {
+        URHO3D_LOGERROR("Can not get data from multisampled texture without autoresolve");
+        return false;
+    }
+
+    if (resolveDirty_)
+        graphics_->ResolveToTexture(const_cast<Texture2D*>(this));
+
+    int levelWidth = GetLevelWidth(level);
+    int levelHeight = GetLevelHeight(level);
+
+    D3D11_TEXTURE2D_DESC textureDesc;
+    memset(&textureDesc, 0, sizeof textureDesc);
+    textureDesc.Width = (UINT)levelWidth;
+    textureDesc.Height = (UINT)levelHeight;
+    textureDesc.MipLevels = 1;
+    textureDesc.ArraySize = 1;
+    textureDesc.Format = (DXGI_FORMAT)format_;
+    textureDesc.SampleDesc.Count = 1;
+    textureDesc.SampleDesc.Quality = 0;
+    textureDesc.Usage = D3D11_USAGE_STAGING;
+    textureDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+
+    PendingTextureReadback readback;
+    HRESULT hr = graphics_->GetImpl()->GetDevice()->CreateTexture2D(&textureDesc, nullptr, &readback.stagingTexture_);
+    if (FAILED(hr))
+    {
+        URHO3D_LOGD3DERROR("Failed to create staging texture for GetDataAsync", hr);
+        URHO3D_SAFE_RELEASE(readback.stagingTexture_);
+        return false;
+    }
+
+    ID3D11Resource* srcResource = (ID3D11Resource*)(resolveTexture_ ? resolveTexture_ : object_.ptr_);
+    unsigned srcSubResource = D3D11CalcSubresource(level, 0, levels_);
+
+    D3D11_BOX srcBox;
+    srcBox.left = 0;
+    srcBox.right = (UINT)levelWidth;
+    srcBox.top = 0;
+    srcBox.bottom = (UINT)levelHeight;
+    srcBox.front = 0;
+    srcBox.back = 1;
+    graphics_->GetImpl()->GetDeviceContext()->CopySubresourceRegion(readback.stagingTexture_, 0, 0, 0, 0, srcResource,
+        srcSubResource, &srcBox);
+
+    // The staging texture is mapped without waiting once the copy has finished
+    readback.rowSize_ = GetRowDataSize(levelWidth);
+    readback.numRows_ = (unsigned)(IsCompressed() ? (levelHeight + 3) >> 2 : levelHeight);
+    readback.callback_ = ea::move(callback);
+    graphics_->GetImpl()->GetPendingTextureReadbacks().push_back(ea::move(readback));
+    return true;
+}
+
 bool Texture2D::Create()
 {
     Release();
@@ -77,6 +77,7 @@ bool VertexBuffer::SetData(const void* data)
 
     if (object_.ptr_)
     {
+        graphics_->AddUploadedBytes(vertexCount_ * vertexSize_);
         if (dynamic_)
         {
             void* hwData = MapBuffer(0, vertexCount_, true);
@@ -136,6 +137,7 @@ bool VertexBuffer::SetDataRange(const void* data, unsigned start, unsigned count
 
     if (object_.ptr_)
     {
+        graphics_->AddUploadedBytes(count * vertexSize_);
         if (dynamic_)
         {
             void* hwData = MapBuffer(start, count, discard);
@@ -192,7 +194,10 @@ void* VertexBuffer::Lock(unsigned start, unsigned count, bool discard)
 
     // Because shadow data must be kept in sync, can only lock hardware buffer if not shadowed
     if (object_.ptr_ && !shadowData_ && dynamic_)
+    {
+        graphics_->AddUploadedBytes(count * vertexSize_);
         return MapBuffer(start, count, discard);
+    }
     else if (shadowData_)
     {
         lockState_ = LOCK_SHADOW;
@@ -279,12 +284,13 @@ void* VertexBuffer::MapBuffer(unsigned start, unsigned count, bool discard)
         mappedData.pData = nullptr;
 
         HRESULT hr = graphics_->GetImpl()->GetDeviceContext()->Map((ID3D11Buffer*)object_.ptr_, 0, discard ? D3D11_MAP_WRITE_DISCARD :
-            D3D11_MAP_WRITE, 0, &mappedData);
+            D3D11_MAP_WRITE_NO_OVERWRITE, 0, &mappedData);
         if (FAILED(hr) || !mappedData.pData)
             URHO3D_LOGD3DERROR("Failed to map vertex buffer", hr);
         else
         {
-            hwData = mappedData.pData;
+            // The whole buffer is mapped, so offset to the start of the range
+            hwData = static_cast<unsigned char*>(mappedData.pData) + start * vertexSize_;
             lockState_ = LOCK_HARDWARE;
         }
     }
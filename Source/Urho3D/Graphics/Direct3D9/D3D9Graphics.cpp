@@ -25,6 +25,7 @@
 #include "../../Core/Context.h"
 #include "../../Core/ProcessUtils.h"
 #include "../../Core/Profiler.h"
+#include "../../Core/Timer.h"
 #include "../../Graphics/Graphics.h"
 #include "../../Graphics/GraphicsEvents.h"
 #include "../../Graphics/GraphicsImpl.h"
@@ -270,6 +271,9 @@ Graphics::Graphics(Context* context) :
 
 Graphics::~Graphics()
 {
+    // Drop uploads that were never executed, releasing their owners while the graphics context still exists
+    queuedUploads_.clear();
+
     {
         MutexLock lock(gpuObjectMutex_);
 
@@ -655,6 +659,7 @@ bool Graphics::BeginFrame()
 
     numPrimitives_ = 0;
     numBatches_ = 0;
+    frameStatistics_ = DrawCallStatistics();
 
     SendEvent(E_BEGINRENDERING);
 
@@ -711,6 +716,24 @@ void Graphics::EndFrame()
     }
 }
 
+void Graphics::UpdateTextureReadbacks()
+{
+    // Readbacks are always synchronous on Direct3D9
+}
+
+void Graphics::CleanupTextureReadbacks()
+{
+}
+
+void Graphics::BeginGPUZone(const char* name)
+{
+    // Not supported by the profiler on Direct3D9
+}
+
+void Graphics::EndGPUZone()
+{
+}
+
 void Graphics::Clear(ClearTargetFlags flags, const Color& color, float depth, unsigned stencil)
 {
     DWORD d3dFlags = 0;
@@ -861,6 +884,8 @@ void Graphics::Draw(PrimitiveType type, unsigned vertexStart, unsigned vertexCou
 
     numPrimitives_ += primitiveCount;
     ++numBatches_;
+    ++frameStatistics_.numDraws_;
+    frameStatistics_.numPrimitives_ += primitiveCount;
 }
 
 void Graphics::Draw(PrimitiveType type, unsigned indexStart, unsigned indexCount, unsigned minVertex, unsigned vertexCount)
@@ -878,6 +903,8 @@ void Graphics::Draw(PrimitiveType type, unsigned indexStart, unsigned indexCount
 
     numPrimitives_ += primitiveCount;
     ++numBatches_;
+    ++frameStatistics_.numDraws_;
+    frameStatistics_.numPrimitives_ += primitiveCount;
 }
 
 void Graphics::Draw(PrimitiveType type, unsigned indexStart, unsigned indexCount, unsigned baseVertexIndex, unsigned minVertex, unsigned vertexCount)
@@ -895,6 +922,8 @@ void Graphics::Draw(PrimitiveType type, unsigned indexStart, unsigned indexCount
 
     numPrimitives_ += primitiveCount;
     ++numBatches_;
+    ++frameStatistics_.numDraws_;
+    frameStatistics_.numPrimitives_ += primitiveCount;
 }
 
 void Graphics::DrawInstanced(PrimitiveType type, unsigned indexStart, unsigned indexCount, unsigned minVertex, unsigned vertexCount,
@@ -925,6 +954,10 @@ void Graphics::DrawInstanced(PrimitiveType type, unsigned indexStart, unsigned i
 
     numPrimitives_ += instanceCount * primitiveCount;
     ++numBatches_;
+    ++frameStatistics_.numDraws_;
+    ++frameStatistics_.numInstancedDraws_;
+    frameStatistics_.numInstances_ += instanceCount;
+    frameStatistics_.numPrimitives_ += instanceCount * primitiveCount;
 }
 
 void Graphics::DrawInstanced(PrimitiveType type, unsigned indexStart, unsigned indexCount, unsigned baseVertexIndex, unsigned minVertex,
@@ -955,6 +988,10 @@ void Graphics::DrawInstanced(PrimitiveType type, unsigned indexStart, unsigned i
 
     numPrimitives_ += instanceCount * primitiveCount;
     ++numBatches_;
+    ++frameStatistics_.numDraws_;
+    ++frameStatistics_.numInstancedDraws_;
+    frameStatistics_.numInstances_ += instanceCount;
+    frameStatistics_.numPrimitives_ += instanceCount * primitiveCount;
 }
 
 void Graphics::SetVertexBuffer(VertexBuffer* buffer)
@@ -1061,6 +1098,8 @@ void Graphics::SetShaders(ShaderVariation* vs, ShaderVariation* ps)
     if (vs == vertexShader_ && ps == pixelShader_)
         return;
 
+    ++frameStatistics_.numShaderChanges_;
+
     ClearParameterSources();
 
     if (vs != vertexShader_)
@@ -1072,7 +1111,11 @@ void Graphics::SetShaders(ShaderVariation* vs, ShaderVariation* ps)
             {
                 URHO3D_PROFILE("CompileVertexShader");
 
+                HiresTimer compileTimer;
                 bool success = vs->Create();
+                ++frameStatistics_.numShaderCompiles_;
+                if (shaderPrecache_)
+                    shaderPrecache_->StoreCompileTime(vs, compileTimer.GetUSec(false));
                 if (!success)
                 {
                     URHO3D_LOGERROR("Failed to compile vertex shader " + vs->GetFullName() + ":\n" + vs->GetCompilerOutput());
@@ -1102,7 +1145,11 @@ void Graphics::SetShaders(ShaderVariation* vs, ShaderVariation* ps)
             {
                 URHO3D_PROFILE("CompilePixelShader");
 
+                HiresTimer compileTimer;
                 bool success = ps->Create();
+                ++frameStatistics_.numShaderCompiles_;
+                if (shaderPrecache_)
+                    shaderPrecache_->StoreCompileTime(ps, compileTimer.GetUSec(false));
                 if (!success)
                 {
                     URHO3D_LOGERROR("Failed to compile pixel shader " + ps->GetFullName() + ":\n" + ps->GetCompilerOutput());
@@ -1373,6 +1420,7 @@ void Graphics::SetTexture(unsigned index, Texture* texture)
             impl_->device_->SetTexture(index, nullptr);
 
         textures_[index] = texture;
+        ++frameStatistics_.numTextureChanges_;
     }
 
     if (texture)
@@ -1641,6 +1689,7 @@ void Graphics::SetBlendMode(BlendMode mode, bool /* alphaToCoverage */)
         }
 
         blendMode_ = mode;
+        ++frameStatistics_.numStateChanges_;
     }
 }
 
@@ -1652,6 +1701,7 @@ void Graphics::SetColorWrite(bool enable)
             enable ? D3DCOLORWRITEENABLE_RED | D3DCOLORWRITEENABLE_GREEN | D3DCOLORWRITEENABLE_BLUE | D3DCOLORWRITEENABLE_ALPHA :
                 0);
         colorWrite_ = enable;
+        ++frameStatistics_.numStateChanges_;
     }
 }
 
@@ -1661,6 +1711,7 @@ void Graphics::SetCullMode(CullMode mode)
     {
         impl_->device_->SetRenderState(D3DRS_CULLMODE, d3dCullMode[mode]);
         cullMode_ = mode;
+        ++frameStatistics_.numStateChanges_;
     }
 }
 
@@ -1684,6 +1735,7 @@ void Graphics::SetDepthTest(CompareMode mode)
     {
         impl_->device_->SetRenderState(D3DRS_ZFUNC, d3dCmpFunc[mode]);
         depthTestMode_ = mode;
+        ++frameStatistics_.numStateChanges_;
     }
 }
 
@@ -1693,6 +1745,7 @@ void Graphics::SetDepthWrite(bool enable)
     {
         impl_->device_->SetRenderState(D3DRS_ZWRITEENABLE, enable ? TRUE : FALSE);
         depthWrite_ = enable;
+        ++frameStatistics_.numStateChanges_;
     }
 }
 
@@ -1815,6 +1868,7 @@ void Graphics::SetStencilTest(bool enable, CompareMode mode, StencilOp pass, Ste
     {
         impl_->device_->SetRenderState(D3DRS_STENCILENABLE, enable ? TRUE : FALSE);
         stencilTest_ = enable;
+        ++frameStatistics_.numStateChanges_;
     }
 
     if (enable)
@@ -2209,6 +2263,11 @@ bool Graphics::GetGL3Support()
     return gl3Support;
 }
 
+bool Graphics::GetBaseVertexSupport()
+{
+    return true;
+}
+
 void Graphics::SetStreamFrequency(unsigned index, unsigned frequency)
 {
     if (index < MAX_VERTEX_STREAMS && impl_->streamFrequencies_[index] != frequency)
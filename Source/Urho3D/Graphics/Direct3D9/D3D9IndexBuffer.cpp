@@ -83,6 +83,7 @@ bool IndexBuffer::SetData(const void* data)
 
     if (object_.ptr_)
     {
+        graphics_->AddUploadedBytes(indexCount_ * indexSize_);
         if (graphics_->IsDeviceLost())
         {
             URHO3D_LOGWARNING("Index buffer data assignment while device is lost");
@@ -135,6 +136,7 @@ bool IndexBuffer::SetDataRange(const void* data, unsigned start, unsigned count,
 
     if (object_.ptr_)
     {
+        graphics_->AddUploadedBytes(count * indexSize_);
         if (graphics_->IsDeviceLost())
         {
             URHO3D_LOGWARNING("Index buffer data assignment while device is lost");
@@ -183,7 +185,10 @@ void* IndexBuffer::Lock(unsigned start, unsigned count, bool discard)
 
     // Because shadow data must be kept in sync, can only lock hardware buffer if not shadowed
     if (object_.ptr_ && !shadowData_ && !graphics_->IsDeviceLost())
+    {
+        graphics_->AddUploadedBytes(count * indexSize_);
         return MapBuffer(start, count, discard);
+    }
     else if (shadowData_)
     {
         lockState_ = LOCK_SHADOW;
@@ -496,6 +496,24 @@ bool Texture2D::GetData(unsigned level, void* dest) const
     return true;
 }
 
+bool Texture2D::GetDataAsync(unsigned level, TextureReadbackCallback callback) const
+{
+    // Direct3D9 has no non-blocking readback, read synchronously
+    if (level >= levels_)
+    {
+        URHO3D_LOGERROR("Illegal mip level for getting data");
+        return false;
+    }
+
+    ea::vector<unsigned char> data(GetDataSize(GetLevelWidth(level), GetLevelHeight(level)));
+    if (!GetData(level, data.data()))
+        return false;
+
+    if (callback)
+        callback(data);
+    return true;
+}
+
 bool Texture2D::Create()
 {
     Release();
@@ -88,6 +88,7 @@ bool VertexBuffer::SetData(const void* data)
 
     if (object_.ptr_)
     {
+        graphics_->AddUploadedBytes(vertexCount_ * vertexSize_);
         if (graphics_->IsDeviceLost())
         {
             URHO3D_LOGWARNING("Vertex buffer data assignment while device is lost");
@@ -140,6 +141,7 @@ bool VertexBuffer::SetDataRange(const void* data, unsigned start, unsigned count
 
     if (object_.ptr_)
     {
+        graphics_->AddUploadedBytes(count * vertexSize_);
         if (graphics_->IsDeviceLost())
         {
             URHO3D_LOGWARNING("Vertex buffer data assignment while device is lost");
@@ -188,7 +190,10 @@ void* VertexBuffer::Lock(unsigned start, unsigned count, bool discard)
 
     // Because shadow data must be kept in sync, can only lock hardware buffer if not shadowed
     if (object_.ptr_ && !shadowData_ && !graphics_->IsDeviceLost())
+    {
+        graphics_->AddUploadedBytes(count * vertexSize_);
         return MapBuffer(start, count, discard);
+    }
     else if (shadowData_)
     {
         lockState_ = LOCK_SHADOW;
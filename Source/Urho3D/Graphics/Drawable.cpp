@@ -30,6 +30,7 @@
 #include "../Graphics/DebugRenderer.h"
 #include "../IO/File.h"
 #include "../Graphics/Geometry.h"
+#include "../Graphics/HierarchicalLod.h"
 #include "../Graphics/Material.h"
 #include "../Graphics/Octree.h"
 #include "../Graphics/Renderer.h"
@@ -142,7 +143,7 @@ void Drawable::UpdateBatches(const FrameInfo& frame)
     }
 
     float scale = worldBoundingBox.Size().DotProduct(DOT_SCALE);
-    float newLodDistance = frame.camera_->GetLodDistance(distance_, scale, lodBias_);
+    float newLodDistance = frame.camera_->GetLodDistance(distance_, scale, lodBias_, frame.viewSize_);
 
     if (newLodDistance != lodDistance_)
         lodDistance_ = newLodDistance;
@@ -279,6 +280,11 @@ bool Drawable::IsInView(const FrameInfo& frame, bool anyCamera) const
     return viewFrameNumber_ == frame.frameNumber_ && (anyCamera || viewCameras_.contains(frame.camera_));
 }
 
+bool Drawable::IsHierarchicalLodVisible(const FrameInfo& frame) const
+{
+    return !hierarchicalLod_ || !frame.camera_ || hierarchicalLod_->IsDrawableVisible(this, frame);
+}
+
 void Drawable::SetZone(Zone* zone, bool temporary)
 {
     zone_ = zone;
@@ -318,10 +324,13 @@ void Drawable::MarkInView(unsigned frameNumber)
     }
 }
 
-void Drawable::LimitLights()
+void Drawable::LimitLights(unsigned globalMaxLights)
 {
     // Maximum lights value 0 means unlimited
-    if (!maxLights_ || lights_.size() <= maxLights_)
+    unsigned maxLights = maxLights_;
+    if (globalMaxLights && (!maxLights || globalMaxLights < maxLights))
+        maxLights = globalMaxLights;
+    if (!maxLights || lights_.size() <= maxLights)
         return;
 
     // If more lights than allowed, move to vertex lights and cut the list
@@ -330,8 +339,8 @@ void Drawable::LimitLights()
         lights_[i]->SetIntensitySortValue(box);
 
     ea::quick_sort(lights_.begin(), lights_.end(), CompareDrawables);
-    vertexLights_.insert(vertexLights_.end(), lights_.begin() + maxLights_, lights_.end());
-    lights_.resize(maxLights_);
+    vertexLights_.insert(vertexLights_.end(), lights_.begin() + maxLights, lights_.end());
+    lights_.resize(maxLights);
 }
 
 void Drawable::LimitVertexLights(bool removeConvertedLights)
@@ -414,6 +423,7 @@ void Drawable::RemoveFromOctree()
         // Perform subclass specific deinitialization if necessary
         OnRemoveFromOctree();
 
+        octree->MarkRemoved(worldBoundingBox_);
         octant_->RemoveDrawable(this);
     }
 }
@@ -26,6 +26,7 @@
 
 #include "../Graphics/GraphicsDefs.h"
 #include "../Math/BoundingBox.h"
+#include "../Math/Vector4.h"
 #include "../Scene/Component.h"
 
 namespace Urho3D
@@ -52,6 +53,7 @@ static const float ANIMATION_LOD_BASESCALE = 2500.0f;
 class Camera;
 class File;
 class Geometry;
+class HierarchicalLod;
 class Light;
 class Material;
 class OcclusionBuffer;
@@ -59,7 +61,6 @@ class Octant;
 class RayOctreeQuery;
 class Zone;
 struct RayQueryResult;
-struct WorkItem;
 
 /// Geometry update type.
 enum UpdateGeometryType
@@ -82,6 +83,19 @@ struct FrameInfo
     Camera* camera_;
 };
 
+/// Cached light probe sample of drawable.
+struct DrawableLightProbeCache
+{
+    /// Sampled position.
+    Vector3 position_;
+    /// Interpolation factors within tetrahedron.
+    Vector4 factors_;
+    /// Tetrahedron index. Also used as the hint for next lookup.
+    unsigned tetIndex_{ M_MAX_UNSIGNED };
+    /// Revision of light probes mesh used for sampling.
+    unsigned revision_{ M_MAX_UNSIGNED };
+};
+
 /// Source data for a 3D geometry draw call.
 struct URHO3D_API SourceBatch
 {
@@ -138,7 +152,6 @@ class URHO3D_API Drawable : public Component
 
     friend class Octant;
     friend class Octree;
-    friend void UpdateDrawablesWork(const WorkItem* item, unsigned threadIndex);
 
 public:
     /// Construct.
@@ -159,6 +172,8 @@ public:
     virtual void UpdateBatches(const FrameInfo& frame);
     /// Prepare geometry for rendering.
     virtual void UpdateGeometry(const FrameInfo& frame) { }
+    /// Finish a worker thread geometry update on the main thread, for example to upload the generated data. Called after all worker thread updates of the view have completed.
+    virtual void FinishUpdateGeometry(const FrameInfo& frame) { }
 
     /// Return whether a geometry update is necessary, and if it can happen in a worker thread.
     virtual UpdateGeometryType GetUpdateGeometryType() { return UPDATE_NONE; }
@@ -290,8 +305,8 @@ public:
     void MarkInView(const FrameInfo& frame);
     /// Mark in view without specifying a camera. Used for shadow casters.
     void MarkInView(unsigned frameNumber);
-    /// Sort and limit per-pixel lights to maximum allowed. Convert extra lights into vertex lights.
-    void LimitLights();
+    /// Sort and limit per-pixel lights to maximum allowed, optionally further limited by a global maximum (0 = none). Convert extra lights into vertex lights.
+    void LimitLights(unsigned globalMaxLights = 0);
     /// Sort and limit per-vertex lights to maximum allowed.
     void LimitVertexLights(bool removeConvertedLights);
 
@@ -320,6 +335,13 @@ public:
     /// Return whether is in view on the current frame. Called by View.
     bool IsInView(const FrameInfo& frame, bool anyCamera = false) const;
 
+    /// Set hierarchical LOD cell that decides whether to draw this drawable or the cell proxy. Called by HierarchicalLod.
+    void SetHierarchicalLod(HierarchicalLod* cell) { hierarchicalLod_ = cell; }
+    /// Return hierarchical LOD cell.
+    HierarchicalLod* GetHierarchicalLod() const { return hierarchicalLod_; }
+    /// Return whether hierarchical LOD allows drawing from the camera of the frame. Called by View.
+    bool IsHierarchicalLodVisible(const FrameInfo& frame) const;
+
     /// Return whether has a base pass.
     bool HasBasePass(unsigned batchIndex) const { return (basePassFlags_ & (1u << batchIndex)) != 0; }
 
@@ -338,8 +360,10 @@ public:
     /// Return the maximum view-space depth.
     float GetMaxZ() const { return maxZ_; }
 
-    /// Return mutable light probe tetrahedron hint.
-    unsigned& GetMutableLightProbeTetrahedronHint() { return lightProbeTetrahedronHint_; }
+    /// Return mutable light probe sample cache.
+    DrawableLightProbeCache& GetMutableLightProbeCache() { return lightProbeCache_; }
+    /// Return light probe sample cache.
+    const DrawableLightProbeCache& GetLightProbeCache() const { return lightProbeCache_; }
 
     /// Add a per-pixel light affecting the object this frame.
     void AddLight(Light* light)
@@ -402,8 +426,12 @@ protected:
     bool zoneDirty_;
     /// Octree octant.
     Octant* octant_;
+    /// Index in the drawable list of the octree octant.
+    unsigned octantIndex_{ M_MAX_UNSIGNED };
     /// Current zone.
     Zone* zone_;
+    /// Hierarchical LOD cell.
+    HierarchicalLod* hierarchicalLod_{};
     /// View mask.
     unsigned viewMask_;
     /// Light mask.
@@ -430,8 +458,8 @@ protected:
     float maxZ_;
     /// LOD bias.
     float lodBias_;
-    /// Light probe tetrahedron hint.
-    unsigned lightProbeTetrahedronHint_{ M_MAX_UNSIGNED };
+    /// Light probe sample cache.
+    DrawableLightProbeCache lightProbeCache_;
     /// Base pass flags, bit per batch.
     unsigned basePassFlags_;
     /// Maximum per-pixel lights.
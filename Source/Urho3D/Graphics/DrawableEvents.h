@@ -65,4 +65,11 @@ URHO3D_EVENT(E_TERRAINCREATED, TerrainCreated)
     URHO3D_PARAM(P_NODE, Node);                    // Node pointer
 }
 
+/// Terrain heights changed within a region, without recreating the whole geometry.
+URHO3D_EVENT(E_TERRAINMODIFIED, TerrainModified)
+{
+    URHO3D_PARAM(P_NODE, Node);                    // Node pointer
+    URHO3D_PARAM(P_REGION, Region);                // IntRect of changed vertices, inclusive. Vertex rows are reversed vertically from heightmap pixel rows
+}
+
 }
@@ -26,6 +26,8 @@
 
 #include "../Container/Ptr.h"
 
+#include <atomic>
+
 namespace Urho3D
 {
 
@@ -70,6 +72,8 @@ public:
     bool IsDataLost() const { return dataLost_; }
     /// Return whether has pending data assigned while graphics context was lost.
     bool HasPendingData() const { return dataPending_; }
+    /// Return whether has data queued for upload with Graphics::QueueUpload. The GPU object is ready once all queued uploads have been executed.
+    bool IsUploadPending() const { return pendingUploads_.load(std::memory_order_acquire) != 0; }
 
 protected:
     /// Graphics subsystem.
@@ -80,6 +84,11 @@ protected:
     bool dataLost_{};
     /// Data pending flag.
     bool dataPending_{};
+
+private:
+    friend class Graphics;
+    /// Number of uploads queued in Graphics.
+    std::atomic<unsigned> pendingUploads_{};
 };
 
 }
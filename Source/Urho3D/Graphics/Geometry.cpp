@@ -48,7 +48,9 @@ Geometry::Geometry(Context* context) :
     vertexCount_(0),
     rawVertexSize_(0),
     rawIndexSize_(0),
-    lodDistance_(0.0f)
+    lodDistance_(0.0f),
+    pooledIndexOffset_(0),
+    baseVertex_(0)
 {
     SetNumVertexBuffers(1);
 }
@@ -83,17 +85,20 @@ bool Geometry::SetVertexBuffer(unsigned index, VertexBuffer* buffer)
     }
 
     vertexBuffers_[index] = buffer;
+    ResetPooledBuffers();
     return true;
 }
 
 void Geometry::SetVertexBuffers(const ea::vector<SharedPtr<VertexBuffer>>& vertexBuffers)
 {
     vertexBuffers_ = vertexBuffers;
+    ResetPooledBuffers();
 }
 
 void Geometry::SetIndexBuffer(IndexBuffer* buffer)
 {
     indexBuffer_ = buffer;
+    ResetPooledBuffers();
 }
 
 bool Geometry::SetDrawRange(PrimitiveType type, unsigned indexStart, unsigned indexCount, bool getUsedVertexRange)
@@ -188,9 +193,38 @@ void Geometry::SetRawIndexData(const ea::shared_array<unsigned char>& data, unsi
     rawIndexSize_ = indexSize;
 }
 
+void Geometry::SetPooledBuffers(VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, unsigned indexOffset, unsigned baseVertex)
+{
+    if (!vertexBuffer || !indexBuffer)
+    {
+        ResetPooledBuffers();
+        return;
+    }
+
+    pooledVertexBuffers_.clear();
+    pooledVertexBuffers_.push_back(SharedPtr<VertexBuffer>(vertexBuffer));
+    pooledIndexBuffer_ = indexBuffer;
+    pooledIndexOffset_ = indexOffset;
+    baseVertex_ = baseVertex;
+}
+
+void Geometry::ResetPooledBuffers()
+{
+    pooledVertexBuffers_.clear();
+    pooledIndexBuffer_.Reset();
+    pooledIndexOffset_ = 0;
+    baseVertex_ = 0;
+}
+
 void Geometry::Draw(Graphics* graphics)
 {
-    if (indexBuffer_ && indexCount_ > 0)
+    if (pooledIndexBuffer_ && indexCount_ > 0)
+    {
+        graphics->SetIndexBuffer(pooledIndexBuffer_);
+        graphics->SetVertexBuffers(pooledVertexBuffers_);
+        graphics->Draw(primitiveType_, pooledIndexOffset_ + indexStart_, indexCount_, baseVertex_, vertexStart_, vertexCount_);
+    }
+    else if (indexBuffer_ && indexCount_ > 0)
     {
         graphics->SetIndexBuffer(indexBuffer_);
         graphics->SetVertexBuffers(vertexBuffers_);
@@ -73,6 +73,10 @@ public:
     void SetRawVertexData(const ea::shared_array<unsigned char>& data, unsigned elementMask);
     /// Override raw index data to be returned for CPU-side operations.
     void SetRawIndexData(const ea::shared_array<unsigned char>& data, unsigned indexSize);
+    /// Set shared pool buffers to draw from instead of own buffers. CPU-side data is still read from own buffers.
+    void SetPooledBuffers(VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, unsigned indexOffset, unsigned baseVertex);
+    /// Stop drawing from shared pool buffers.
+    void ResetPooledBuffers();
     /// Draw.
     void Draw(Graphics* graphics);
 
@@ -115,6 +119,17 @@ public:
     /// @property
     float GetLodDistance() const { return lodDistance_; }
 
+    /// Return whether draws from shared pool buffers.
+    bool IsPooled() const { return pooledIndexBuffer_ != nullptr; }
+    /// Return vertex buffers used for drawing.
+    const ea::vector<SharedPtr<VertexBuffer> >& GetDrawVertexBuffers() const { return IsPooled() ? pooledVertexBuffers_ : vertexBuffers_; }
+    /// Return index buffer used for drawing.
+    IndexBuffer* GetDrawIndexBuffer() const { return IsPooled() ? pooledIndexBuffer_ : indexBuffer_; }
+    /// Return start index used for drawing.
+    unsigned GetDrawIndexStart() const { return pooledIndexOffset_ + indexStart_; }
+    /// Return base vertex used for drawing.
+    unsigned GetBaseVertex() const { return baseVertex_; }
+
     /// Return buffers' combined hash value for state sorting.
     unsigned short GetBufferHash() const;
     /// Return raw vertex and index data for CPU operations, or null pointers if not available. Will return data of the first vertex buffer if override data not set.
@@ -158,6 +173,14 @@ private:
     unsigned rawVertexSize_;
     /// Raw index data override size.
     unsigned rawIndexSize_;
+    /// Shared pool vertex buffers used for drawing.
+    ea::vector<SharedPtr<VertexBuffer> > pooledVertexBuffers_;
+    /// Shared pool index buffer used for drawing.
+    SharedPtr<IndexBuffer> pooledIndexBuffer_;
+    /// Offset of own indices in the shared pool index buffer.
+    unsigned pooledIndexOffset_;
+    /// Offset of own vertices in the shared pool vertex buffer.
+    unsigned baseVertex_;
 };
 
 }
@@ -0,0 +1,312 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Graphics/Geometry.h"
+#include "../Graphics/GeometryPool.h"
+#include "../Graphics/Graphics.h"
+#include "../Graphics/IndexBuffer.h"
+#include "../Graphics/Model.h"
+#include "../Graphics/VertexBuffer.h"
+#include "../IO/Log.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Return index of buffer in array or M_MAX_UNSIGNED if not found.
+template <class T> unsigned FindBufferIndex(const ea::vector<SharedPtr<T>>& buffers, T* buffer)
+{
+    for (unsigned i = 0; i < buffers.size(); ++i)
+    {
+        if (buffers[i] == buffer)
+            return i;
+    }
+    return M_MAX_UNSIGNED;
+}
+
+/// Allocate range from sorted free ranges using first fit. Return false if there is no space.
+bool AllocateRange(ea::vector<GeometryPoolRange>& freeRanges, unsigned count, GeometryPoolRange& range)
+{
+    for (auto i = freeRanges.begin(); i != freeRanges.end(); ++i)
+    {
+        if (i->count_ >= count)
+        {
+            range.start_ = i->start_;
+            range.count_ = count;
+            i->start_ += count;
+            i->count_ -= count;
+            if (!i->count_)
+                freeRanges.erase(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Return range to sorted free ranges, merging it with adjacent ones.
+void FreeRange(ea::vector<GeometryPoolRange>& freeRanges, const GeometryPoolRange& range)
+{
+    if (!range.count_)
+        return;
+
+    auto i = freeRanges.begin();
+    while (i != freeRanges.end() && i->start_ < range.start_)
+        ++i;
+    i = freeRanges.insert(i, range);
+
+    auto next = i + 1;
+    if (next != freeRanges.end() && i->start_ + i->count_ == next->start_)
+    {
+        i->count_ += next->count_;
+        freeRanges.erase(next);
+    }
+    if (i != freeRanges.begin())
+    {
+        auto prev = i - 1;
+        if (prev->start_ + prev->count_ == i->start_)
+        {
+            prev->count_ += i->count_;
+            freeRanges.erase(i);
+        }
+    }
+}
+
+}
+
+GeometryPool::GeometryPool(Context* context) :
+    Object(context)
+{
+}
+
+GeometryPool::~GeometryPool()
+{
+    for (const auto& item : models_)
+    {
+        for (const WeakPtr<Geometry>& geometry : item.second.geometries_)
+        {
+            if (geometry)
+                geometry->ResetPooledBuffers();
+        }
+    }
+}
+
+void GeometryPool::SetPageSize(unsigned vertices, unsigned indices)
+{
+    pageVertices_ = Max(vertices, 1U);
+    pageIndices_ = Max(indices, 1U);
+}
+
+bool GeometryPool::AddModel(Model* model)
+{
+    if (!model || !Graphics::GetBaseVertexSupport())
+        return false;
+
+    RemoveModel(model);
+
+    const ea::vector<SharedPtr<VertexBuffer>>& vertexBuffers = model->GetVertexBuffers();
+    const ea::vector<SharedPtr<IndexBuffer>>& indexBuffers = model->GetIndexBuffers();
+    // Morphed models draw from cloned geometries, so pooling them would only waste memory
+    if (vertexBuffers.empty() || indexBuffers.empty() || !model->GetMorphs().empty())
+        return false;
+
+    // All buffers must share one vertex layout and index size to fit into one page
+    if (!vertexBuffers[0] || !indexBuffers[0])
+        return false;
+    const ea::vector<VertexElement> elements = vertexBuffers[0]->GetElements();
+    const unsigned indexSize = indexBuffers[0]->GetIndexSize();
+
+    unsigned numVertices = 0;
+    for (VertexBuffer* buffer : vertexBuffers)
+    {
+        if (!buffer || !buffer->GetShadowData() || buffer->IsDynamic() || buffer->GetElements() != elements)
+            return false;
+        numVertices += buffer->GetVertexCount();
+    }
+
+    unsigned numIndices = 0;
+    for (IndexBuffer* buffer : indexBuffers)
+    {
+        if (!buffer || !buffer->GetShadowData() || buffer->IsDynamic() || buffer->GetIndexSize() != indexSize)
+            return false;
+        numIndices += buffer->GetIndexCount();
+    }
+
+    if (numVertices > pageVertices_ || numIndices > pageIndices_)
+        return false;
+
+    // Each geometry must draw one of the model vertex buffers with one of the model index buffers
+    for (const ea::vector<SharedPtr<Geometry>>& lodLevels : model->GetGeometries())
+    {
+        for (Geometry* geometry : lodLevels)
+        {
+            if (!geometry || geometry->GetNumVertexBuffers() != 1 || !geometry->GetIndexCount() ||
+                FindBufferIndex(vertexBuffers, geometry->GetVertexBuffer(0)) == M_MAX_UNSIGNED ||
+                FindBufferIndex(indexBuffers, geometry->GetIndexBuffer()) == M_MAX_UNSIGNED)
+                return false;
+        }
+    }
+
+    // Find a page with enough free space or create a new one
+    GeometryPoolModelData data;
+    bool allocated = false;
+    for (unsigned i = 0; i < pages_.size() && !allocated; ++i)
+        allocated = AllocateInPage(i, model, data);
+
+    if (!allocated)
+    {
+        if (!CreatePage(elements, indexSize > sizeof(unsigned short)))
+            return false;
+        if (!AllocateInPage(pages_.size() - 1, model, data))
+            return false;
+    }
+
+    GeometryPoolPage& page = pages_[data.page_];
+    for (const ea::vector<SharedPtr<Geometry>>& lodLevels : model->GetGeometries())
+    {
+        for (Geometry* geometry : lodLevels)
+        {
+            const unsigned vertexBufferIndex = FindBufferIndex(vertexBuffers, geometry->GetVertexBuffer(0));
+            const unsigned indexBufferIndex = FindBufferIndex(indexBuffers, geometry->GetIndexBuffer());
+            geometry->SetPooledBuffers(page.vertexBuffer_, page.indexBuffer_, data.indexRanges_[indexBufferIndex].start_,
+                data.vertexRanges_[vertexBufferIndex].start_);
+            data.geometries_.emplace_back(geometry);
+        }
+    }
+
+    models_[model] = ea::move(data);
+    return true;
+}
+
+void GeometryPool::RemoveModel(Model* model)
+{
+    auto iter = models_.find(model);
+    if (iter == models_.end())
+        return;
+
+    for (const WeakPtr<Geometry>& geometry : iter->second.geometries_)
+    {
+        if (geometry)
+            geometry->ResetPooledBuffers();
+    }
+
+    FreeInPage(iter->second);
+    models_.erase(iter);
+}
+
+bool GeometryPool::CreatePage(const ea::vector<VertexElement>& elements, bool largeIndices)
+{
+    GeometryPoolPage page;
+    page.vertexBuffer_ = MakeShared<VertexBuffer>(context_);
+    page.vertexBuffer_->SetShadowed(true);
+    page.indexBuffer_ = MakeShared<IndexBuffer>(context_);
+    page.indexBuffer_->SetShadowed(true);
+
+    if (!page.vertexBuffer_->SetSize(pageVertices_, elements) || !page.indexBuffer_->SetSize(pageIndices_, largeIndices))
+    {
+        URHO3D_LOGERROR("Failed to create geometry pool page");
+        return false;
+    }
+
+    page.freeVertices_.push_back({ 0, pageVertices_ });
+    page.freeIndices_.push_back({ 0, pageIndices_ });
+    pages_.push_back(ea::move(page));
+    return true;
+}
+
+bool GeometryPool::AllocateInPage(unsigned pageIndex, Model* model, GeometryPoolModelData& data)
+{
+    GeometryPoolPage& page = pages_[pageIndex];
+    const ea::vector<SharedPtr<VertexBuffer>>& vertexBuffers = model->GetVertexBuffers();
+    const ea::vector<SharedPtr<IndexBuffer>>& indexBuffers = model->GetIndexBuffers();
+
+    if (page.vertexBuffer_->GetElements() != vertexBuffers[0]->GetElements() ||
+        page.indexBuffer_->GetIndexSize() != indexBuffers[0]->GetIndexSize())
+        return false;
+
+    data.page_ = pageIndex;
+    data.vertexRanges_.clear();
+    data.indexRanges_.clear();
+
+    bool success = true;
+    for (VertexBuffer* buffer : vertexBuffers)
+    {
+        GeometryPoolRange range;
+        if (!AllocateRange(page.freeVertices_, buffer->GetVertexCount(), range))
+        {
+            success = false;
+            break;
+        }
+        data.vertexRanges_.push_back(range);
+    }
+    for (unsigned i = 0; i < indexBuffers.size() && success; ++i)
+    {
+        GeometryPoolRange range;
+        if (!AllocateRange(page.freeIndices_, indexBuffers[i]->GetIndexCount(), range))
+        {
+            success = false;
+            break;
+        }
+        data.indexRanges_.push_back(range);
+    }
+
+    if (!success)
+    {
+        FreeInPage(data);
+        data.vertexRanges_.clear();
+        data.indexRanges_.clear();
+        return false;
+    }
+
+    // Copy model data into the shared buffers. Index values stay relative to the base vertex
+    for (unsigned i = 0; i < vertexBuffers.size(); ++i)
+    {
+        const GeometryPoolRange& range = data.vertexRanges_[i];
+        page.vertexBuffer_->SetDataRange(vertexBuffers[i]->GetShadowData(), range.start_, range.count_);
+    }
+    for (unsigned i = 0; i < indexBuffers.size(); ++i)
+    {
+        const GeometryPoolRange& range = data.indexRanges_[i];
+        page.indexBuffer_->SetDataRange(indexBuffers[i]->GetShadowData(), range.start_, range.count_);
+    }
+
+    return true;
+}
+
+void GeometryPool::FreeInPage(const GeometryPoolModelData& data)
+{
+    if (data.page_ >= pages_.size())
+        return;
+
+    GeometryPoolPage& page = pages_[data.page_];
+    for (const GeometryPoolRange& range : data.vertexRanges_)
+        FreeRange(page.freeVertices_, range);
+    for (const GeometryPoolRange& range : data.indexRanges_)
+        FreeRange(page.freeIndices_, range);
+}
+
+}
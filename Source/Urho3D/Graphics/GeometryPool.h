@@ -0,0 +1,125 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Core/Object.h"
+#include "../Graphics/GraphicsDefs.h"
+
+#include <EASTL/unordered_map.h>
+
+namespace Urho3D
+{
+
+class Geometry;
+class IndexBuffer;
+class Model;
+class VertexBuffer;
+
+/// Range of vertices or indices in a geometry pool page.
+struct GeometryPoolRange
+{
+    /// First vertex or index.
+    unsigned start_{};
+    /// Number of vertices or indices.
+    unsigned count_{};
+};
+
+/// Geometry pool page. Contains one vertex buffer and one index buffer shared by models with the same vertex layout and index size.
+struct GeometryPoolPage
+{
+    /// Shared vertex buffer.
+    SharedPtr<VertexBuffer> vertexBuffer_;
+    /// Shared index buffer.
+    SharedPtr<IndexBuffer> indexBuffer_;
+    /// Free vertex ranges sorted by start.
+    ea::vector<GeometryPoolRange> freeVertices_;
+    /// Free index ranges sorted by start.
+    ea::vector<GeometryPoolRange> freeIndices_;
+};
+
+/// Allocations of a model in the geometry pool.
+struct GeometryPoolModelData
+{
+    /// Page index.
+    unsigned page_{};
+    /// Vertex range of each model vertex buffer.
+    ea::vector<GeometryPoolRange> vertexRanges_;
+    /// Index range of each model index buffer.
+    ea::vector<GeometryPoolRange> indexRanges_;
+    /// Geometries drawn from the pool.
+    ea::vector<WeakPtr<Geometry>> geometries_;
+};
+
+/// Opt-in subsystem that suballocates static model geometry into a few large vertex and index buffers grouped by vertex layout.
+/// Geometries then draw from the shared buffers using base vertex draws, which avoids rebinding buffers between models.
+/// Models keep their own shadowed buffers for CPU-side access, so the GPU memory of pooled geometry is duplicated.
+class URHO3D_API GeometryPool : public Object
+{
+    URHO3D_OBJECT(GeometryPool, Object);
+
+public:
+    /// Default number of vertices in a page.
+    static const unsigned DEFAULT_PAGE_VERTICES = 256 * 1024;
+    /// Default number of indices in a page.
+    static const unsigned DEFAULT_PAGE_INDICES = 1024 * 1024;
+
+    /// Construct.
+    explicit GeometryPool(Context* context);
+    /// Destruct. Geometries go back to drawing from own buffers.
+    ~GeometryPool() override;
+
+    /// Set number of vertices and indices in a new page. Models larger than a page are not pooled.
+    void SetPageSize(unsigned vertices, unsigned indices);
+    /// Add model geometries to the pool. Return true if successful. Models with vertex morphs, mixed vertex layouts or no shadow data are not pooled.
+    bool AddModel(Model* model);
+    /// Remove model geometries from the pool.
+    void RemoveModel(Model* model);
+
+    /// Return number of vertices in a new page.
+    unsigned GetPageVertices() const { return pageVertices_; }
+    /// Return number of indices in a new page.
+    unsigned GetPageIndices() const { return pageIndices_; }
+    /// Return number of pages.
+    unsigned GetNumPages() const { return pages_.size(); }
+    /// Return number of pooled models.
+    unsigned GetNumModels() const { return models_.size(); }
+
+private:
+    /// Create a new page.
+    bool CreatePage(const ea::vector<VertexElement>& elements, bool largeIndices);
+    /// Try to allocate model buffers in a page. Return true if successful.
+    bool AllocateInPage(unsigned pageIndex, Model* model, GeometryPoolModelData& data);
+    /// Free model buffers in its page.
+    void FreeInPage(const GeometryPoolModelData& data);
+
+    /// Pages.
+    ea::vector<GeometryPoolPage> pages_;
+    /// Pooled models.
+    ea::unordered_map<Model*, GeometryPoolModelData> models_;
+    /// Number of vertices in a new page.
+    unsigned pageVertices_{DEFAULT_PAGE_VERTICES};
+    /// Number of indices in a new page.
+    unsigned pageIndices_{DEFAULT_PAGE_INDICES};
+};
+
+}
@@ -25,6 +25,7 @@
 #include "../Graphics/GlobalIllumination.h"
 
 #include "../Core/Context.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../IO/ArchiveSerialization.h"
 #include "../IO/BinaryArchive.h"
@@ -37,6 +38,27 @@ namespace Urho3D
 
 extern const char* SUBSYSTEM_CATEGORY;
 
+static const unsigned RELIGHT_BATCH_SIZE = 256;
+
+namespace
+{
+
+/// Scale color channels of spherical harmonics.
+SphericalHarmonicsDot9 ScaleSphericalHarmonics(const SphericalHarmonicsDot9& sh, const Vector3& color)
+{
+    SphericalHarmonicsDot9 result;
+    result.Ar_ = sh.Ar_ * color.x_;
+    result.Ag_ = sh.Ag_ * color.y_;
+    result.Ab_ = sh.Ab_ * color.z_;
+    result.Br_ = sh.Br_ * color.x_;
+    result.Bg_ = sh.Bg_ * color.y_;
+    result.Bb_ = sh.Bb_ * color.z_;
+    result.C_ = Vector4(static_cast<Vector3>(sh.C_) * color, 0.0f);
+    return result;
+}
+
+}
+
 GlobalIllumination::GlobalIllumination(Context* context) :
     Component(context)
 {
@@ -49,8 +71,9 @@ void GlobalIllumination::RegisterObject(Context* context)
     context->RegisterFactory<GlobalIllumination>(SUBSYSTEM_CATEGORY);
 
     URHO3D_ATTRIBUTE("Emission Brightness", float, emissionBrightness_, 1.0f, AM_DEFAULT);
-    URHO3D_ATTRIBUTE("Is Background Static", bool, backgroundStatic_, false, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Is Background Static", GetBackgroundStatic, SetBackgroundStatic, bool, false, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Background Brightness", float, backgroundBrightness_, 0.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Background Color", GetBackgroundColor, SetBackgroundColor, Color, Color::BLACK, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Data File", GetFileRef, SetFileRef, ResourceRef, ResourceRef{ BinaryFile::GetTypeStatic() }, AM_DEFAULT | AM_NOEDIT);
 }
 
@@ -84,7 +107,9 @@ void GlobalIllumination::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
 void GlobalIllumination::ResetLightProbes()
 {
     lightProbesBakedData_.Clear();
+    lightProbesData_.Clear();
     lightProbesMesh_ = {};
+    ++lightProbesRevision_;
 }
 
 void GlobalIllumination::CompileLightProbes()
@@ -99,6 +124,7 @@ void GlobalIllumination::CompileLightProbes()
 
     // Add padding to avoid vertex collision
     lightProbesMesh_.Define(collection.worldPositions_);
+    RelightLightProbes();
 
     // Store in file
     auto cache = context_->GetSubsystem<ResourceCache>();
@@ -127,12 +153,45 @@ void GlobalIllumination::CompileLightProbes()
 
 SphericalHarmonicsDot9 GlobalIllumination::SampleAmbientSH(const Vector3& position, unsigned& hint) const
 {
-    return lightProbesMesh_.Sample(lightProbesBakedData_.sphericalHarmonics_, position, hint);
+    return lightProbesMesh_.Sample(lightProbesData_.sphericalHarmonics_, position, hint);
 }
 
 Vector3 GlobalIllumination::SampleAverageAmbient(const Vector3& position, unsigned& hint) const
 {
-    return lightProbesMesh_.Sample(lightProbesBakedData_.ambient_, position, hint);
+    return lightProbesMesh_.Sample(lightProbesData_.ambient_, position, hint);
+}
+
+void GlobalIllumination::UpdateLightProbeCache(
+    DrawableLightProbeCache& cache, const Vector3& position, float tolerance) const
+{
+    if (cache.revision_ == lightProbesRevision_ && (cache.position_ - position).LengthSquared() <= tolerance * tolerance)
+        return;
+
+    if (cache.revision_ != lightProbesRevision_)
+        cache.tetIndex_ = M_MAX_UNSIGNED;
+
+    cache.position_ = position;
+    cache.revision_ = lightProbesRevision_;
+    cache.factors_ = lightProbesMesh_.GetInterpolationFactors(position, cache.tetIndex_);
+}
+
+SphericalHarmonicsDot9 GlobalIllumination::SampleAmbientSH(const DrawableLightProbeCache& cache) const
+{
+    return lightProbesMesh_.Sample(lightProbesData_.sphericalHarmonics_, cache.tetIndex_, cache.factors_);
+}
+
+Vector3 GlobalIllumination::SampleAverageAmbient(const DrawableLightProbeCache& cache) const
+{
+    return lightProbesMesh_.Sample(lightProbesData_.ambient_, cache.tetIndex_, cache.factors_);
+}
+
+void GlobalIllumination::SetBackgroundColor(const Color& color)
+{
+    if (backgroundColor_ != color)
+    {
+        backgroundColor_ = color;
+        RelightLightProbes();
+    }
 }
 
 void GlobalIllumination::SetFileRef(const ResourceRef& fileRef)
@@ -183,6 +242,34 @@ void GlobalIllumination::ReloadData()
         lightProbesMesh_ = {};
         lightProbesBakedData_.Clear();
     }
+
+    ++lightProbesRevision_;
+    RelightLightProbes();
+}
+
+void GlobalIllumination::RelightLightProbes()
+{
+    lightProbesData_ = lightProbesBakedData_;
+
+    // Static background is already baked into light probes
+    const Vector3 backgroundLight = backgroundColor_.ToVector3();
+    if (backgroundStatic_ || backgroundLight == Vector3::ZERO)
+        return;
+
+    const unsigned numLightProbes = lightProbesData_.Size();
+    if (lightProbesBakedData_.backgroundSphericalHarmonics_.size() != numLightProbes)
+        return;
+
+    auto workQueue = GetSubsystem<WorkQueue>();
+    workQueue->ParallelFor(numLightProbes, RELIGHT_BATCH_SIZE, [&](unsigned begin, unsigned end, unsigned /*threadIndex*/)
+    {
+        for (unsigned i = begin; i < end; ++i)
+        {
+            SphericalHarmonicsDot9& sh = lightProbesData_.sphericalHarmonics_[i];
+            sh += ScaleSphericalHarmonics(lightProbesBakedData_.backgroundSphericalHarmonics_[i], backgroundLight);
+            lightProbesData_.ambient_[i] = sh.GetDebugColor().ToVector3();
+        }
+    });
 }
 
 }
@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include "../Graphics/Drawable.h"
 #include "../Graphics/LightProbeGroup.h"
 #include "../Math/Matrix3.h"
 #include "../Math/Sphere.h"
@@ -59,19 +60,30 @@ public:
     SphericalHarmonicsDot9 SampleAmbientSH(const Vector3& position, unsigned& hint) const;
     /// Sample average ambient lighting.
     Vector3 SampleAverageAmbient(const Vector3& position, unsigned& hint) const;
+    /// Update cached light probe sample if position moved further than tolerance or light probes were changed.
+    /// Safe to call from worker threads for different caches.
+    void UpdateLightProbeCache(DrawableLightProbeCache& cache, const Vector3& position, float tolerance) const;
+    /// Sample ambient spherical harmonics from cached light probe sample.
+    SphericalHarmonicsDot9 SampleAmbientSH(const DrawableLightProbeCache& cache) const;
+    /// Sample average ambient lighting from cached light probe sample.
+    Vector3 SampleAverageAmbient(const DrawableLightProbeCache& cache) const;
 
     /// Set emission brightness.
     void SetEmissionBrightness(float emissionBrightness) { emissionBrightness_ = emissionBrightness; }
     /// Return emission brightness.
     float GetEmissionBrightness() const { return emissionBrightness_; }
     /// Set background static.
-    void SetBackgroundStatic(bool backgroundStatic) { backgroundStatic_ = backgroundStatic; }
+    void SetBackgroundStatic(bool backgroundStatic) { backgroundStatic_ = backgroundStatic; RelightLightProbes(); }
     /// Return whether the background is static.
     bool GetBackgroundStatic() const { return backgroundStatic_; }
     /// Set background brightness.
     void SetBackgroundBrightness(float brightness) { backgroundBrightness_ = brightness; }
     /// Return background brightness.
     float GetBackgroundBrightness() const { return backgroundBrightness_; }
+    /// Set color of dynamic background. Light probes are relit with it if background is not static.
+    void SetBackgroundColor(const Color& color);
+    /// Return color of dynamic background.
+    const Color& GetBackgroundColor() const { return backgroundColor_; }
 
     /// Set reference on file with baked data.
     void SetFileRef(const ResourceRef& fileRef);
@@ -84,6 +96,8 @@ public:
 private:
     /// Reload GI data.
     void ReloadData();
+    /// Recompose light probes from baked data and dynamic background.
+    void RelightLightProbes();
 
     /// Emission indirect brightness.
     float emissionBrightness_{ 1.0f };
@@ -91,14 +105,20 @@ private:
     bool backgroundStatic_{};
     /// Background brightness multiplier.
     float backgroundBrightness_{};
+    /// Color of dynamic background.
+    Color backgroundColor_{ Color::BLACK };
 
     /// Reference on file with GI data.
     ResourceRef fileRef_{ BinaryFile::GetTypeStatic() };
 
     /// Light probes mesh.
     TetrahedralMesh lightProbesMesh_;
+    /// Revision of light probes mesh. Incremented whenever the mesh is changed.
+    unsigned lightProbesRevision_{};
     /// Baked light probes data.
     LightProbeCollectionBakedData lightProbesBakedData_;
+    /// Light probes data relit with dynamic background. Sampled at runtime.
+    LightProbeCollectionBakedData lightProbesData_;
 };
 
 }
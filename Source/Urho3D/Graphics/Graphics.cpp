@@ -29,9 +29,12 @@
 #include "../Graphics/Camera.h"
 #include "../Graphics/ConstantBuffer.h"
 #include "../Graphics/Geometry.h"
+#include "../Graphics/HierarchicalLod.h"
+#include "../Graphics/ImpostorGroup.h"
 #include "../Graphics/CustomGeometry.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/DecalSet.h"
+#include "../Graphics/DeferredDecalSet.h"
 #include "../Graphics/GlobalIllumination.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/GraphicsEvents.h"
@@ -391,6 +394,23 @@ void Graphics::SetGlobalShaderDefines(const ea::string& globalShaderDefines)
     globalShaderDefinesHash_ = globalShaderDefines_;
 }
 
+void Graphics::SetPipelineState(const PipelineState& state)
+{
+    // Check the whole state at once, as most consecutive draw calls share it
+    if (state.vertexShader_ == vertexShader_ && state.pixelShader_ == pixelShader_ && state.blendMode_ == blendMode_ &&
+        state.alphaToCoverage_ == alphaToCoverage_ && state.cullMode_ == cullMode_ && state.depthTestMode_ == depthTestMode_ &&
+        state.depthWrite_ == depthWrite_ && state.fillMode_ == fillMode_ && state.lineAntiAlias_ == lineAntiAlias_)
+        return;
+
+    SetShaders(state.vertexShader_, state.pixelShader_);
+    SetBlendMode(state.blendMode_, state.alphaToCoverage_);
+    SetCullMode(state.cullMode_);
+    SetDepthTest(state.depthTestMode_);
+    SetDepthWrite(state.depthWrite_);
+    SetFillMode(state.fillMode_);
+    SetLineAntiAlias(state.lineAntiAlias_);
+}
+
 void Graphics::SetShaderCacheDir(const ea::string& path)
 {
     ea::string trimmedPath = path.trimmed();
@@ -412,6 +432,54 @@ void Graphics::RemoveGPUObject(GPUObject* object)
     gpuObjects_.erase_first(object);
 }
 
+void Graphics::QueueUpload(RefCounted* owner, GPUObject* object, unsigned size, std::function<void()> upload)
+{
+    MutexLock lock(uploadMutex_);
+
+    object->pendingUploads_.fetch_add(1, std::memory_order_relaxed);
+    queuedUploads_.push_back(QueuedUpload{ SharedPtr<RefCounted>(owner), object, size, ea::move(upload) });
+}
+
+void Graphics::ProcessUploads()
+{
+    ea::vector<QueuedUpload> uploads;
+    {
+        MutexLock lock(uploadMutex_);
+
+        if (queuedUploads_.empty())
+            return;
+
+        // Take uploads within the budget, but always at least one so that large uploads make progress
+        unsigned numUploads = 0;
+        unsigned totalSize = 0;
+        while (numUploads < queuedUploads_.size())
+        {
+            totalSize += queuedUploads_[numUploads].size_;
+            if (uploadBudget_ && numUploads > 0 && totalSize > uploadBudget_)
+                break;
+            ++numUploads;
+        }
+
+        uploads.assign(ea::make_move_iterator(queuedUploads_.begin()), ea::make_move_iterator(queuedUploads_.begin() + numUploads));
+        queuedUploads_.erase(queuedUploads_.begin(), queuedUploads_.begin() + numUploads);
+    }
+
+    URHO3D_PROFILE("ProcessUploads");
+
+    // Execute outside the lock so that worker threads can keep queueing
+    for (QueuedUpload& upload : uploads)
+    {
+        upload.upload_();
+        upload.object_->pendingUploads_.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+unsigned Graphics::GetNumQueuedUploads() const
+{
+    MutexLock lock(uploadMutex_);
+    return queuedUploads_.size();
+}
+
 void* Graphics::ReserveScratchBuffer(unsigned size)
 {
     if (!size)
@@ -632,6 +700,8 @@ void RegisterGraphicsLibrary(Context* context)
     GlobalIllumination::RegisterObject(context);
     StaticModel::RegisterObject(context);
     StaticModelGroup::RegisterObject(context);
+    HierarchicalLod::RegisterObject(context);
+    ImpostorGroup::RegisterObject(context);
     Skybox::RegisterObject(context);
     AnimatedModel::RegisterObject(context);
     AnimationController::RegisterObject(context);
@@ -641,6 +711,7 @@ void RegisterGraphicsLibrary(Context* context)
     RibbonTrail::RegisterObject(context);
     CustomGeometry::RegisterObject(context);
     DecalSet::RegisterObject(context);
+    DeferredDecalSet::RegisterObject(context);
     Terrain::RegisterObject(context);
     TerrainPatch::RegisterObject(context);
     DebugRenderer::RegisterObject(context);
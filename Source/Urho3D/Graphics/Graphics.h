@@ -25,6 +25,8 @@
 #include <EASTL/unique_ptr.h>
 #include <EASTL/unique_ptr.h>
 
+#include <functional>
+
 #include "../Core/Mutex.h"
 #include "../Core/Object.h"
 #include "../Graphics/GraphicsDefs.h"
@@ -78,6 +80,29 @@ struct ScratchBuffer
     bool reserved_;
 };
 
+/// Shaders and render states of a draw call, applied together with Graphics::SetPipelineState().
+struct PipelineState
+{
+    /// Vertex shader.
+    ShaderVariation* vertexShader_{};
+    /// Pixel shader.
+    ShaderVariation* pixelShader_{};
+    /// Blending mode.
+    BlendMode blendMode_{BLEND_REPLACE};
+    /// Alpha-to-coverage flag.
+    bool alphaToCoverage_{};
+    /// Hardware culling mode.
+    CullMode cullMode_{CULL_CCW};
+    /// Depth compare mode.
+    CompareMode depthTestMode_{CMP_LESSEQUAL};
+    /// Depth write flag.
+    bool depthWrite_{true};
+    /// Polygon fill mode.
+    FillMode fillMode_{FILL_SOLID};
+    /// Line antialiasing flag.
+    bool lineAntiAlias_{};
+};
+
 /// Screen mode parameters.
 struct ScreenModeParams
 {
@@ -200,6 +225,10 @@ public:
     bool BeginFrame();
     /// End frame rendering and swap buffers.
     void EndFrame();
+    /// Begin GPU timing zone measured with timestamp queries and reported to the profiler. Zones must be nested and ended before EndFrame(). Name is copied.
+    void BeginGPUZone(const char* name);
+    /// End innermost GPU timing zone.
+    void EndGPUZone();
     /// Clear any or all of rendertarget, depth buffer and stencil buffer.
     void Clear(ClearTargetFlags flags, const Color& color = Color::TRANSPARENT_BLACK, float depth = 1.0f, unsigned stencil = 0);
     /// Resolve multisampled backbuffer to a texture rendertarget. The texture's size should match the viewport size.
@@ -231,6 +260,8 @@ public:
     void SetIndexBuffer(IndexBuffer* buffer);
     /// Set shaders.
     void SetShaders(ShaderVariation* vs, ShaderVariation* ps);
+    /// Set shaders and render states in one call. Does nothing if they all match the current state.
+    void SetPipelineState(const PipelineState& state);
     /// Set shader float constants.
     void SetShaderParameter(StringHash param, const float data[], unsigned count);
     /// Set shader float constant.
@@ -328,11 +359,14 @@ public:
     void EndDumpShaders();
     /// Precache shader variations from an XML file generated with BeginDumpShaders().
     void PrecacheShaders(Deserializer& source);
-    /// Set shader cache directory, Direct3D only. This can either be an absolute path or a path within the resource system.
+    /// Set shader cache directory for Direct3D shader bytecode and OpenGL program binaries. This can either be an absolute path or a path within the resource system.
     /// @property
     void SetShaderCacheDir(const ea::string& path);
     /// Set global shader defines.
     void SetGlobalShaderDefines(const ea::string& globalShaderDefines);
+    /// Set per-frame byte budget for queued GPU uploads. When nonzero, textures finishing background loading are uploaded through the queue. Zero (default) executes all queued uploads on the next frame.
+    /// @property
+    void SetUploadBudget(unsigned bytes) { uploadBudget_ = bytes; }
 
     /// Return whether rendering initialized.
     /// @property
@@ -438,6 +472,13 @@ public:
     /// @property
     unsigned GetNumBatches() const { return numBatches_; }
 
+    /// Return draw call and state change statistics of this frame so far.
+    const DrawCallStatistics& GetFrameStatistics() const { return frameStatistics_; }
+
+    /// Add bytes uploaded to a GPU buffer to the frame statistics. Called by GPU buffer objects.
+    /// @nobind
+    void AddUploadedBytes(unsigned bytes) { frameStatistics_.uploadedBytes_ += bytes; }
+
     /// Return dummy color texture format for shadow maps. Is "NULL" (consume no video memory) if supported.
     unsigned GetDummyColorFormat() const { return dummyColorFormat_; }
 
@@ -478,6 +519,13 @@ public:
     /// @property
     bool GetSRGBWriteSupport() const { return sRGBWriteSupport_; }
 
+    /// Return whether GPU timing zones are supported. Requires profiling build and timestamp queries.
+    bool GetGPUProfilingSupport() const { return gpuProfilingSupport_; }
+    /// Return whether GPU frame time is measured. Requires timestamp queries.
+    bool GetGPUFrameTimingSupport() const { return gpuFrameTimingSupport_; }
+    /// Return GPU time of the latest frame whose timing queries have completed in milliseconds, or zero if not measured. Lags a few frames behind.
+    float GetGPUFrameTime() const { return gpuFrameTime_; }
+
     /// Return max vertex shader uniforms support.
     unsigned GetMaxVertexShaderUniforms() const { return maxVertexShaderUniforms_; }
 
@@ -615,13 +663,19 @@ public:
     /// Return whether a custom clipping plane is in use.
     bool GetUseClipPlane() const { return useClipPlane_; }
 
-    /// Return shader cache directory, Direct3D only.
+    /// Return shader cache directory.
     /// @property
     const ea::string& GetShaderCacheDir() const { return shaderCacheDir_; }
 
     /// Return global shader defines.
     const ea::string& GetGlobalShaderDefines() const { return globalShaderDefines_; }
 
+    /// Return per-frame byte budget for queued GPU uploads.
+    /// @property
+    unsigned GetUploadBudget() const { return uploadBudget_; }
+    /// Return number of queued GPU uploads.
+    unsigned GetNumQueuedUploads() const;
+
     /// Return global shader defines hash.
     StringHash GetGlobalShaderDefinesHash() const { return globalShaderDefinesHash_; }
 
@@ -645,6 +699,11 @@ public:
     void AddGPUObject(GPUObject* object);
     /// Remove a GPU object. Called by GPUObject.
     void RemoveGPUObject(GPUObject* object);
+    /// Queue a GPU data upload to be executed on the main thread. Can be called from any thread. The owner is kept alive until the upload has been executed.
+    /// @nobind
+    void QueueUpload(RefCounted* owner, GPUObject* object, unsigned size, std::function<void()> upload);
+    /// Execute queued GPU uploads within the per-frame byte budget. At least one upload is executed per frame. Called by Engine.
+    void ProcessUploads();
     /// Reserve a CPU-side scratch buffer.
     void* ReserveScratchBuffer(unsigned size);
     /// Free a CPU-side scratch buffer.
@@ -711,6 +770,8 @@ public:
     static unsigned GetMaxBones();
     /// Return whether is using an OpenGL 3 context. Return always false on Direct3D9 & Direct3D11.
     static bool GetGL3Support();
+    /// Return whether indexed draws with a base vertex index are supported.
+    static bool GetBaseVertexSupport();
 
     /// Get the SDL_Window as a void* to avoid having to include the graphics implementation
     void* GetSDLWindow() { return window_; }
@@ -752,6 +813,10 @@ private:
     void SetTextureUnitMappings();
     /// Process dirtied state before draw.
     void PrepareDraw();
+    /// Invoke callbacks of asynchronous texture readbacks the GPU has finished.
+    void UpdateTextureReadbacks();
+    /// Discard pending asynchronous texture readbacks, invoking their callbacks with empty data.
+    void CleanupTextureReadbacks();
     /// Create intermediate texture for multisampled backbuffer resolve. No-op if already exists.
     void CreateResolveTexture();
     /// Clean up all framebuffers. Called when destroying the context. Used only on OpenGL.
@@ -775,8 +840,27 @@ private:
     /// Release/clear GPU objects and optionally close the window. Used only on OpenGL.
     void Release(bool clearGPUObjects, bool closeWindow);
 
+    /// Queued GPU upload.
+    struct QueuedUpload
+    {
+        /// Object owning the GPU object, kept alive until uploaded.
+        SharedPtr<RefCounted> owner_;
+        /// GPU object.
+        GPUObject* object_{};
+        /// Upload size in bytes.
+        unsigned size_{};
+        /// Upload function.
+        std::function<void()> upload_;
+    };
+
     /// Mutex for accessing the GPU objects vector from several threads.
     Mutex gpuObjectMutex_;
+    /// Mutex for accessing the upload queue from several threads.
+    mutable Mutex uploadMutex_;
+    /// Queued GPU uploads.
+    ea::vector<QueuedUpload> queuedUploads_;
+    /// Per-frame byte budget for queued GPU uploads.
+    unsigned uploadBudget_{};
     /// Implementation.
     GraphicsImpl* impl_;
     /// SDL window.
@@ -828,6 +912,14 @@ private:
     bool sRGBSupport_{};
     /// sRGB conversion on write support flag.
     bool sRGBWriteSupport_{};
+    /// GPU timing zones support flag.
+    bool gpuProfilingSupport_{};
+    /// Depth of currently open GPU timing zones.
+    unsigned gpuZoneDepth_{};
+    /// GPU frame timing support flag.
+    bool gpuFrameTimingSupport_{};
+    /// Latest measured GPU frame time in milliseconds.
+    float gpuFrameTime_{};
     /// Max number of vertex shader uniforms.
     unsigned maxVertexShaderUniforms_{};
     /// Max number of pixel shader uniforms.
@@ -836,6 +928,8 @@ private:
     unsigned numPrimitives_{};
     /// Number of batches this frame.
     unsigned numBatches_{};
+    /// Draw call and state change statistics this frame.
+    DrawCallStatistics frameStatistics_;
     /// Largest scratch buffer request this frame.
     unsigned maxScratchBufferRequest_{};
     /// GPU objects.
@@ -947,6 +1041,27 @@ private:
     static bool gl3Support;
 };
 
+/// Scoped GPU timing zone.
+class GPUProfileZone
+{
+public:
+    /// Construct and begin zone.
+    GPUProfileZone(Graphics* graphics, const char* name)
+        : graphics_(graphics)
+    {
+        graphics_->BeginGPUZone(name);
+    }
+    /// Destruct and end zone.
+    ~GPUProfileZone() { graphics_->EndGPUZone(); }
+
+    GPUProfileZone(const GPUProfileZone&) = delete;
+    GPUProfileZone& operator=(const GPUProfileZone&) = delete;
+
+private:
+    /// Graphics subsystem.
+    Graphics* graphics_{};
+};
+
 /// Register Graphics library objects.
 /// @nobind
 void URHO3D_API RegisterGraphicsLibrary(Context* context);
@@ -161,6 +161,12 @@ enum VertexElementType
     TYPE_VECTOR4,
     TYPE_UBYTE4,
     TYPE_UBYTE4_NORM,
+    /// Two half floats.
+    TYPE_HALF2,
+    /// Four half floats.
+    TYPE_HALF4,
+    /// Four signed shorts normalized to [-1, 1].
+    TYPE_SHORT4_NORM,
     MAX_VERTEX_ELEMENT_TYPES
 };
 
@@ -496,6 +502,63 @@ URHO3D_FLAGSET(VertexMask, VertexMaskFlags);
 static const int MAX_RENDERTARGETS = 8;
 static const int MAX_VERTEX_STREAMS = 4;
 static const int MAX_CONSTANT_REGISTERS = 256;
+static const unsigned MAX_GPU_ZONE_DEPTH = 32;
+static const unsigned NUM_GPU_FRAME_QUERIES = 4;
 
 static const int BITS_PER_COMPONENT = 8;
+
+/// Draw call and GPU state change counters accumulated by Graphics.
+struct URHO3D_API DrawCallStatistics
+{
+    /// Accumulate counters of another set of statistics.
+    DrawCallStatistics& operator +=(const DrawCallStatistics& rhs)
+    {
+        numDraws_ += rhs.numDraws_;
+        numInstancedDraws_ += rhs.numInstancedDraws_;
+        numInstances_ += rhs.numInstances_;
+        numPrimitives_ += rhs.numPrimitives_;
+        numShaderChanges_ += rhs.numShaderChanges_;
+        numTextureChanges_ += rhs.numTextureChanges_;
+        numStateChanges_ += rhs.numStateChanges_;
+        numShaderCompiles_ += rhs.numShaderCompiles_;
+        uploadedBytes_ += rhs.uploadedBytes_;
+        return *this;
+    }
+
+    /// Return difference of counters, used to measure a section of the frame.
+    DrawCallStatistics operator -(const DrawCallStatistics& rhs) const
+    {
+        DrawCallStatistics result;
+        result.numDraws_ = numDraws_ - rhs.numDraws_;
+        result.numInstancedDraws_ = numInstancedDraws_ - rhs.numInstancedDraws_;
+        result.numInstances_ = numInstances_ - rhs.numInstances_;
+        result.numPrimitives_ = numPrimitives_ - rhs.numPrimitives_;
+        result.numShaderChanges_ = numShaderChanges_ - rhs.numShaderChanges_;
+        result.numTextureChanges_ = numTextureChanges_ - rhs.numTextureChanges_;
+        result.numStateChanges_ = numStateChanges_ - rhs.numStateChanges_;
+        result.numShaderCompiles_ = numShaderCompiles_ - rhs.numShaderCompiles_;
+        result.uploadedBytes_ = uploadedBytes_ - rhs.uploadedBytes_;
+        return result;
+    }
+
+    /// Number of draw calls, including instanced ones.
+    unsigned numDraws_{};
+    /// Number of instanced draw calls.
+    unsigned numInstancedDraws_{};
+    /// Number of instances drawn by instanced draw calls.
+    unsigned numInstances_{};
+    /// Number of primitives drawn.
+    unsigned numPrimitives_{};
+    /// Number of vertex and pixel shader changes.
+    unsigned numShaderChanges_{};
+    /// Number of texture unit changes.
+    unsigned numTextureChanges_{};
+    /// Number of blend, depth, stencil and rasterizer state changes.
+    unsigned numStateChanges_{};
+    /// Number of shader variations compiled on demand.
+    unsigned numShaderCompiles_{};
+    /// Bytes uploaded to vertex, index and constant buffers.
+    unsigned long long uploadedBytes_{};
+};
+
 }
@@ -0,0 +1,440 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Graphics/AnimatedModel.h"
+#include "../Graphics/Camera.h"
+#include "../Graphics/Geometry.h"
+#include "../Graphics/HierarchicalLod.h"
+#include "../Graphics/IndexBuffer.h"
+#include "../Graphics/Material.h"
+#include "../Graphics/MeshOptimizer.h"
+#include "../Graphics/Model.h"
+#include "../Graphics/StaticModelGroup.h"
+#include "../Graphics/VertexBuffer.h"
+#include "../Resource/ResourceCache.h"
+#include "../Scene/Node.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+extern const char* GEOMETRY_CATEGORY;
+
+namespace
+{
+
+/// Vertex of merged proxy geometry.
+struct ProxyVertex
+{
+    Vector3 position_;
+    Vector3 normal_;
+    Vector2 texCoord_;
+};
+
+/// Merged triangles of the cell that use one material.
+struct ProxyGeometry
+{
+    Material* material_{};
+    ea::vector<ProxyVertex> vertices_;
+    ea::vector<unsigned> indices_;
+};
+
+/// Append triangles of the geometry transformed into cell space.
+void AppendGeometry(ProxyGeometry& dest, Geometry* geometry, const ea::vector<Matrix3x4>& transforms)
+{
+    VertexBuffer* vertexBuffer = geometry->GetVertexBuffer(0);
+    IndexBuffer* indexBuffer = geometry->GetIndexBuffer();
+    const VertexElement* positionElement = vertexBuffer->GetElement(SEM_POSITION);
+    const VertexElement* normalElement = vertexBuffer->GetElement(SEM_NORMAL);
+    const VertexElement* texCoordElement = vertexBuffer->GetElement(SEM_TEXCOORD);
+
+    const unsigned vertexStart = geometry->GetVertexStart();
+    const unsigned vertexCount = geometry->GetVertexCount();
+    const unsigned vertexSize = vertexBuffer->GetVertexSize();
+    ea::vector<Vector4> positions(vertexCount);
+    ea::vector<Vector4> normals(vertexCount, Vector4(0.0f, 1.0f, 0.0f, 0.0f));
+    ea::vector<Vector4> texCoords(vertexCount, Vector4::ZERO);
+    VertexBuffer::UnpackVertexData(vertexBuffer->GetShadowData(), vertexSize, *positionElement, vertexStart, vertexCount,
+        positions.data(), sizeof(Vector4));
+    if (normalElement)
+    {
+        VertexBuffer::UnpackVertexData(vertexBuffer->GetShadowData(), vertexSize, *normalElement, vertexStart, vertexCount,
+            normals.data(), sizeof(Vector4));
+    }
+    if (texCoordElement)
+    {
+        VertexBuffer::UnpackVertexData(vertexBuffer->GetShadowData(), vertexSize, *texCoordElement, vertexStart, vertexCount,
+            texCoords.data(), sizeof(Vector4));
+    }
+
+    const ea::vector<unsigned> indices = indexBuffer->GetUnpackedData(geometry->GetIndexStart(), geometry->GetIndexCount());
+    for (const Matrix3x4& transform : transforms)
+    {
+        const unsigned baseVertex = dest.vertices_.size();
+        const Matrix3 normalTransform = transform.ToMatrix3().Inverse().Transpose();
+        for (unsigned i = 0; i < vertexCount; ++i)
+        {
+            const Vector3 normal = normalTransform * static_cast<Vector3>(normals[i]);
+            dest.vertices_.push_back({ transform * static_cast<Vector3>(positions[i]), normal.Normalized(),
+                static_cast<Vector2>(texCoords[i]) });
+        }
+        for (unsigned index : indices)
+            dest.indices_.push_back(baseVertex + index - vertexStart);
+    }
+}
+
+}
+
+HierarchicalLod::HierarchicalLod(Context* context) :
+    Component(context),
+    proxyMaterialsAttr_(Material::GetTypeStatic())
+{
+}
+
+HierarchicalLod::~HierarchicalLod()
+{
+    ClearCell();
+}
+
+void HierarchicalLod::RegisterObject(Context* context)
+{
+    context->RegisterFactory<HierarchicalLod>(GEOMETRY_CATEGORY);
+
+    URHO3D_ACCESSOR_ATTRIBUTE("Is Enabled", IsEnabled, SetEnabled, bool, true, AM_DEFAULT);
+    URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Proxy Model", GetProxyModelAttr, SetProxyModelAttr, ResourceRef, ResourceRef(Model::GetTypeStatic()), AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Proxy Material", GetProxyMaterialsAttr, SetProxyMaterialsAttr, ResourceRefList,
+        ResourceRefList(Material::GetTypeStatic()), AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Switch Distance", GetSwitchDistance, SetSwitchDistance, float, 0.0f, AM_DEFAULT);
+}
+
+void HierarchicalLod::ApplyAttributes()
+{
+    UpdateCell();
+}
+
+void HierarchicalLod::OnSetEnabled()
+{
+    UpdateCell();
+}
+
+void HierarchicalLod::UpdateCell()
+{
+    ClearCell();
+    if (!node_ || !proxy_)
+        return;
+
+    const bool enabled = IsEnabledEffective() && proxyModel_ && switchDistance_ > 0.0f;
+    proxy_->SetEnabled(enabled);
+    if (!enabled)
+        return;
+
+    // Nested cells are not supported, models already owned by another cell are left to it
+    ea::vector<StaticModel*> staticModels;
+    node_->GetDerivedComponents(staticModels, true);
+    BoundingBox worldBoundingBox;
+    for (StaticModel* staticModel : staticModels)
+    {
+        if (staticModel == proxy_ || staticModel->IsInstanceOf<AnimatedModel>() || staticModel->GetHierarchicalLod())
+            continue;
+
+        staticModel->SetHierarchicalLod(this);
+        drawables_.emplace_back(staticModel);
+        worldBoundingBox.Merge(staticModel->GetWorldBoundingBox());
+    }
+
+    proxy_->SetHierarchicalLod(this);
+    if (!worldBoundingBox.Defined())
+        worldBoundingBox = proxy_->GetWorldBoundingBox();
+
+    localCenter_ = node_->GetWorldTransform().Inverse() * worldBoundingBox.Center();
+    worldCenter_ = worldBoundingBox.Center();
+}
+
+SharedPtr<Model> HierarchicalLod::BakeProxy(float reduction, float maxError)
+{
+    if (!node_)
+        return nullptr;
+
+    // Collect cell contents even if the proxy is not active yet
+    ea::vector<StaticModel*> staticModels;
+    node_->GetDerivedComponents(staticModels, true);
+
+    const Matrix3x4 cellInverse = node_->GetWorldTransform().Inverse();
+    ea::vector<ProxyGeometry> proxyGeometries;
+    ea::vector<Matrix3x4> transforms;
+    BoundingBox boundingBox;
+    for (StaticModel* staticModel : staticModels)
+    {
+        Model* model = staticModel->GetModel();
+        if (staticModel == proxy_ || !model || !staticModel->IsEnabledEffective() || staticModel->IsInstanceOf<AnimatedModel>())
+            continue;
+        if (staticModel->GetHierarchicalLod() && staticModel->GetHierarchicalLod() != this)
+            continue;
+
+        transforms.clear();
+        if (auto* group = staticModel->Cast<StaticModelGroup>())
+        {
+            for (unsigned i = 0; i < group->GetNumInstanceNodes(); ++i)
+            {
+                if (Node* instanceNode = group->GetInstanceNode(i))
+                    transforms.push_back(cellInverse * instanceNode->GetWorldTransform());
+            }
+        }
+        else
+            transforms.push_back(cellInverse * staticModel->GetNode()->GetWorldTransform());
+
+        for (unsigned i = 0; i < model->GetNumGeometries(); ++i)
+        {
+            // The coarsest LOD level is closest to what the proxy needs
+            const unsigned numLodLevels = model->GetNumGeometryLodLevels(i);
+            Geometry* geometry = numLodLevels ? model->GetGeometry(i, numLodLevels - 1) : nullptr;
+            if (!geometry || geometry->GetPrimitiveType() != TRIANGLE_LIST || geometry->GetNumVertexBuffers() != 1)
+                continue;
+            VertexBuffer* vertexBuffer = geometry->GetVertexBuffer(0);
+            IndexBuffer* indexBuffer = geometry->GetIndexBuffer();
+            if (!vertexBuffer->GetShadowData() || !vertexBuffer->GetElement(SEM_POSITION) || !indexBuffer || !indexBuffer->GetShadowData())
+                continue;
+
+            Material* material = staticModel->GetMaterial(i);
+            auto iter = ea::find_if(proxyGeometries.begin(), proxyGeometries.end(),
+                [material](const ProxyGeometry& proxyGeometry) { return proxyGeometry.material_ == material; });
+            if (iter == proxyGeometries.end())
+            {
+                proxyGeometries.emplace_back();
+                proxyGeometries.back().material_ = material;
+                iter = proxyGeometries.end() - 1;
+            }
+            AppendGeometry(*iter, geometry, transforms);
+        }
+    }
+
+    // Simplify merged geometries and drop vertices that are no longer referenced
+    ea::vector<ProxyVertex> vertices;
+    ea::vector<unsigned> indices;
+    ea::vector<ea::pair<unsigned, unsigned>> vertexRanges;
+    ea::vector<ea::pair<unsigned, unsigned>> indexRanges;
+    for (ProxyGeometry& proxyGeometry : proxyGeometries)
+    {
+        ea::vector<Vector3> positions(proxyGeometry.vertices_.size());
+        for (unsigned i = 0; i < positions.size(); ++i)
+        {
+            positions[i] = proxyGeometry.vertices_[i].position_;
+            boundingBox.Merge(positions[i]);
+        }
+
+        const auto targetNumIndices = Max(static_cast<unsigned>(proxyGeometry.indices_.size() / 3 * reduction), 1u) * 3;
+        const float geometrySize = BoundingBox(positions.data(), positions.size()).Size().Length();
+        const ea::vector<unsigned> simplifiedIndices = SimplifyMesh(proxyGeometry.indices_.data(), proxyGeometry.indices_.size(),
+            positions.data(), positions.size(), targetNumIndices, maxError * geometrySize);
+
+        ea::vector<unsigned> vertexRemap(proxyGeometry.vertices_.size(), M_MAX_UNSIGNED);
+        const unsigned vertexStart = vertices.size();
+        const unsigned indexStart = indices.size();
+        for (unsigned index : simplifiedIndices)
+        {
+            if (vertexRemap[index] == M_MAX_UNSIGNED)
+            {
+                vertexRemap[index] = vertices.size();
+                vertices.push_back(proxyGeometry.vertices_[index]);
+            }
+            indices.push_back(vertexRemap[index]);
+        }
+        vertexRanges.emplace_back(vertexStart, vertices.size() - vertexStart);
+        indexRanges.emplace_back(indexStart, indices.size() - indexStart);
+    }
+
+    if (indices.empty())
+        return nullptr;
+
+    const bool largeIndices = vertices.size() > 0xffff;
+    auto vertexBuffer = MakeShared<VertexBuffer>(context_);
+    vertexBuffer->SetShadowed(true);
+    vertexBuffer->SetSize(vertices.size(), { VertexElement(TYPE_VECTOR3, SEM_POSITION), VertexElement(TYPE_VECTOR3, SEM_NORMAL),
+        VertexElement(TYPE_VECTOR2, SEM_TEXCOORD) });
+    vertexBuffer->SetData(vertices.data());
+
+    auto indexBuffer = MakeShared<IndexBuffer>(context_);
+    indexBuffer->SetShadowed(true);
+    indexBuffer->SetSize(indices.size(), largeIndices);
+    if (largeIndices)
+        indexBuffer->SetData(indices.data());
+    else
+    {
+        ea::vector<unsigned short> shortIndices(indices.begin(), indices.end());
+        indexBuffer->SetData(shortIndices.data());
+    }
+
+    auto model = MakeShared<Model>(context_);
+    model->SetNumGeometries(proxyGeometries.size());
+    for (unsigned i = 0; i < proxyGeometries.size(); ++i)
+    {
+        auto geometry = MakeShared<Geometry>(context_);
+        geometry->SetVertexBuffer(0, vertexBuffer);
+        geometry->SetIndexBuffer(indexBuffer);
+        geometry->SetDrawRange(TRIANGLE_LIST, indexRanges[i].first, indexRanges[i].second, vertexRanges[i].first,
+            vertexRanges[i].second);
+
+        BoundingBox geometryBox;
+        for (unsigned j = 0; j < vertexRanges[i].second; ++j)
+            geometryBox.Merge(vertices[vertexRanges[i].first + j].position_);
+
+        model->SetNumGeometryLodLevels(i, 1);
+        model->SetGeometry(i, 0, geometry);
+        model->SetGeometryCenter(i, geometryBox.Defined() ? geometryBox.Center() : Vector3::ZERO);
+    }
+    model->SetBoundingBox(boundingBox);
+    model->SetVertexBuffers({ vertexBuffer }, { 0 }, { 0 });
+    model->SetIndexBuffers({ indexBuffer });
+
+    proxyMaterials_.clear();
+    for (unsigned i = 0; i < proxyGeometries.size(); ++i)
+        proxyMaterials_.emplace_back(proxyGeometries[i].material_);
+    SetProxyModel(model);
+    return model;
+}
+
+void HierarchicalLod::SetProxyModel(Model* model)
+{
+    proxyModel_ = model;
+    UpdateProxy();
+    UpdateCell();
+    MarkNetworkUpdate();
+}
+
+void HierarchicalLod::SetProxyMaterial(unsigned index, Material* material)
+{
+    if (index >= proxyMaterials_.size())
+        proxyMaterials_.resize(index + 1);
+    proxyMaterials_[index] = material;
+    UpdateProxy();
+    MarkNetworkUpdate();
+}
+
+void HierarchicalLod::SetSwitchDistance(float distance)
+{
+    const bool wasActive = switchDistance_ > 0.0f;
+    switchDistance_ = Max(distance, 0.0f);
+    if (wasActive != (switchDistance_ > 0.0f))
+        UpdateCell();
+    MarkNetworkUpdate();
+}
+
+Material* HierarchicalLod::GetProxyMaterial(unsigned index) const
+{
+    return index < proxyMaterials_.size() ? proxyMaterials_[index] : nullptr;
+}
+
+bool HierarchicalLod::IsDrawableVisible(const Drawable* drawable, const FrameInfo& frame) const
+{
+    // Whole cell switches at once, so contents and proxy never overlap or leave gaps
+    const bool useProxy = frame.camera_->GetDistance(worldCenter_) > switchDistance_;
+    return (drawable == proxy_.Get()) == useProxy;
+}
+
+void HierarchicalLod::SetProxyModelAttr(const ResourceRef& value)
+{
+    auto* cache = GetSubsystem<ResourceCache>();
+    proxyModel_ = cache->GetResource<Model>(value.name_);
+    UpdateProxy();
+}
+
+void HierarchicalLod::SetProxyMaterialsAttr(const ResourceRefList& value)
+{
+    auto* cache = GetSubsystem<ResourceCache>();
+    proxyMaterials_.resize(value.names_.size());
+    for (unsigned i = 0; i < value.names_.size(); ++i)
+        proxyMaterials_[i] = cache->GetResource<Material>(value.names_[i]);
+    UpdateProxy();
+}
+
+ResourceRef HierarchicalLod::GetProxyModelAttr() const
+{
+    return GetResourceRef(proxyModel_, Model::GetTypeStatic());
+}
+
+const ResourceRefList& HierarchicalLod::GetProxyMaterialsAttr() const
+{
+    proxyMaterialsAttr_.names_ = GetResourceNames(proxyMaterials_);
+    return proxyMaterialsAttr_;
+}
+
+void HierarchicalLod::OnNodeSet(Node* node)
+{
+    if (node)
+    {
+        // Proxy is recreated from attributes on load, so it is not saved itself
+        auto* proxy = node->CreateComponent<StaticModel>(LOCAL);
+        proxy->SetTemporary(true);
+        proxy->SetCastShadows(true);
+        proxy_ = proxy;
+        node->AddListener(this);
+        UpdateProxy();
+        UpdateCell();
+    }
+    else
+    {
+        ClearCell();
+        if (proxy_)
+            proxy_->Remove();
+        proxy_ = nullptr;
+    }
+}
+
+void HierarchicalLod::OnMarkedDirty(Node* node)
+{
+    worldCenter_ = node->GetWorldTransform() * localCenter_;
+}
+
+void HierarchicalLod::ClearCell()
+{
+    for (Drawable* drawable : drawables_)
+    {
+        if (drawable && drawable->GetHierarchicalLod() == this)
+            drawable->SetHierarchicalLod(nullptr);
+    }
+    drawables_.clear();
+
+    if (proxy_)
+        proxy_->SetHierarchicalLod(nullptr);
+}
+
+void HierarchicalLod::UpdateProxy()
+{
+    if (!proxy_)
+        return;
+
+    if (proxy_->GetModel() != proxyModel_)
+        proxy_->SetModel(proxyModel_);
+    for (unsigned i = 0; i < proxyMaterials_.size(); ++i)
+        proxy_->SetMaterial(i, proxyMaterials_[i]);
+
+    // Proxy must not be visible until the cell is set up
+    if (!proxy_->GetHierarchicalLod())
+        proxy_->SetEnabled(false);
+}
+
+}
@@ -0,0 +1,124 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#pragma once
+
+#include "../Scene/Component.h"
+
+namespace Urho3D
+{
+
+class Drawable;
+class Material;
+class Model;
+class StaticModel;
+struct FrameInfo;
+
+/// Hierarchical LOD cell. Static models in child nodes are replaced by a single merged proxy model when the camera is farther than the switch distance from the cell center.
+class URHO3D_API HierarchicalLod : public Component
+{
+    URHO3D_OBJECT(HierarchicalLod, Component);
+
+public:
+    /// Construct.
+    explicit HierarchicalLod(Context* context);
+    /// Destruct.
+    ~HierarchicalLod() override;
+    /// Register object factory. StaticModel must be registered first.
+    /// @nobind
+    static void RegisterObject(Context* context);
+
+    /// Apply attribute changes that can not be applied immediately. Called after scene load or a network update.
+    void ApplyAttributes() override;
+    /// Handle enabled/disabled state change.
+    void OnSetEnabled() override;
+
+    /// Collect static models of child nodes that are replaced by the proxy. Should be called after the cell contents change.
+    void UpdateCell();
+    /// Merge static models of the cell into a proxy model in cell node space, simplify it and start using it. Geometries are merged per material, so proxy has one batch per distinct material. Triangle count is reduced by the given ratio within maximum error relative to the cell size. Return null if there was nothing to merge.
+    SharedPtr<Model> BakeProxy(float reduction = 0.25f, float maxError = 0.02f);
+
+    /// Set proxy model.
+    /// @property
+    void SetProxyModel(Model* model);
+    /// Set proxy material by geometry index.
+    void SetProxyMaterial(unsigned index, Material* material);
+    /// Set distance from the camera to cell center beyond which the proxy is drawn instead of the cell contents. Zero disables the proxy.
+    /// @property
+    void SetSwitchDistance(float distance);
+
+    /// Return proxy model.
+    /// @property
+    Model* GetProxyModel() const { return proxyModel_; }
+    /// Return proxy material by geometry index.
+    Material* GetProxyMaterial(unsigned index) const;
+    /// Return switch distance.
+    /// @property
+    float GetSwitchDistance() const { return switchDistance_; }
+    /// Return number of static models replaced by the proxy.
+    /// @property
+    unsigned GetNumDrawables() const { return drawables_.size(); }
+
+    /// Return whether the drawable of this cell should be drawn from the camera of the frame. May be called from worker threads.
+    bool IsDrawableVisible(const Drawable* drawable, const FrameInfo& frame) const;
+
+    /// Set proxy model attribute.
+    void SetProxyModelAttr(const ResourceRef& value);
+    /// Set proxy materials attribute.
+    void SetProxyMaterialsAttr(const ResourceRefList& value);
+    /// Return proxy model attribute.
+    ResourceRef GetProxyModelAttr() const;
+    /// Return proxy materials attribute.
+    const ResourceRefList& GetProxyMaterialsAttr() const;
+
+protected:
+    /// Handle node being assigned.
+    void OnNodeSet(Node* node) override;
+    /// Handle node transform being dirtied.
+    void OnMarkedDirty(Node* node) override;
+
+private:
+    /// Detach the cell from its drawables.
+    void ClearCell();
+    /// Apply model and materials to the proxy drawable.
+    void UpdateProxy();
+
+    /// Drawable that renders the proxy model.
+    WeakPtr<StaticModel> proxy_;
+    /// Proxy model.
+    SharedPtr<Model> proxyModel_;
+    /// Proxy materials.
+    ea::vector<SharedPtr<Material>> proxyMaterials_;
+    /// Drawables replaced by the proxy.
+    ea::vector<WeakPtr<Drawable>> drawables_;
+    /// Switch distance.
+    float switchDistance_{};
+    /// Cell center in node space.
+    Vector3 localCenter_;
+    /// Cell center in world space.
+    Vector3 worldCenter_;
+    /// Proxy materials attribute.
+    mutable ResourceRefList proxyMaterialsAttr_;
+};
+
+}
@@ -0,0 +1,205 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Graphics/Camera.h"
+#include "../Graphics/Graphics.h"
+#include "../Graphics/ImpostorBaker.h"
+#include "../Graphics/Material.h"
+#include "../Graphics/Model.h"
+#include "../Graphics/Octree.h"
+#include "../Graphics/RenderPath.h"
+#include "../Graphics/Renderer.h"
+#include "../Graphics/StaticModel.h"
+#include "../Graphics/Texture2D.h"
+#include "../Graphics/View.h"
+#include "../Graphics/Viewport.h"
+#include "../IO/Log.h"
+#include "../Resource/Image.h"
+#include "../Resource/ResourceCache.h"
+#include "../Resource/XMLFile.h"
+#include "../Scene/Scene.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Read RGBA32 float texture to vector.
+void ReadTextureRGBA32Float(Texture* texture, ea::vector<Vector4>& dest)
+{
+    auto texture2D = dynamic_cast<Texture2D*>(texture);
+    dest.resize(texture->GetDataSize(texture->GetWidth(), texture->GetHeight()) / sizeof(Vector4));
+    texture2D->GetData(0, dest.data());
+}
+
+/// Decode linear depth written by the deferred pass.
+float DecodeLinearDepth(const Vector4& data)
+{
+#ifdef URHO3D_OPENGL
+    // OpenGL 2 packs depth into RGB
+    if (!Graphics::GetGL3Support())
+        return data.x_ + data.y_ / 255.0f + data.z_ / (255.0f * 255.0f);
+#endif
+    return data.x_;
+}
+
+}
+
+Vector2 EncodeImpostorDirection(const Vector3& direction)
+{
+    const Vector3 dir = direction / (Abs(direction.x_) + Abs(direction.y_) + Abs(direction.z_));
+    Vector2 uv{ dir.x_, dir.z_ };
+    // Lower hemisphere is folded over the diagonals
+    if (dir.y_ < 0.0f)
+        uv = { (1.0f - Abs(dir.z_)) * Sign(dir.x_), (1.0f - Abs(dir.x_)) * Sign(dir.z_) };
+    return uv * 0.5f + Vector2(0.5f, 0.5f);
+}
+
+Vector3 DecodeImpostorDirection(const Vector2& uv)
+{
+    const Vector2 pos = uv * 2.0f - Vector2::ONE;
+    Vector3 dir{ pos.x_, 1.0f - Abs(pos.x_) - Abs(pos.y_), pos.y_ };
+    if (dir.y_ < 0.0f)
+    {
+        dir.x_ = (1.0f - Abs(pos.y_)) * Sign(pos.x_);
+        dir.z_ = (1.0f - Abs(pos.x_)) * Sign(pos.y_);
+    }
+    return dir.Normalized();
+}
+
+ImpostorAtlas BakeImpostorAtlas(Context* context, Model* model, const ea::vector<SharedPtr<Material>>& materials,
+    const ImpostorBakingSettings& settings)
+{
+    if (!model || !settings.numFrames_ || !settings.frameSize_)
+        return {};
+
+    auto graphics = context->GetSubsystem<Graphics>();
+    auto renderer = context->GetSubsystem<Renderer>();
+    auto cache = context->GetSubsystem<ResourceCache>();
+
+    auto renderPath = MakeShared<RenderPath>();
+    if (!renderPath->Load(cache->GetResource<XMLFile>(settings.renderPathName_)))
+    {
+        URHO3D_LOGERROR("Cannot load render path \"{}\"", settings.renderPathName_);
+        return {};
+    }
+
+    // Setup baking scene
+    auto scene = MakeShared<Scene>(context);
+    scene->CreateComponent<Octree>();
+    auto staticModel = scene->CreateComponent<StaticModel>();
+    staticModel->SetModel(model);
+    for (unsigned i = 0; i < materials.size(); ++i)
+        staticModel->SetMaterial(i, materials[i]);
+
+    // Camera is kept outside of the bounding sphere, depth range covers the whole sphere
+    const Sphere bounds = GetImpostorBounds(model->GetBoundingBox());
+    const float radius = Max(bounds.radius_, M_EPSILON);
+    Node* cameraNode = scene->CreateChild("Camera");
+    auto camera = cameraNode->CreateComponent<Camera>();
+    camera->SetOrthographic(true);
+    camera->SetOrthoSize(radius * 2.0f);
+    camera->SetAspectRatio(1.0f);
+    camera->SetNearClip(radius);
+    camera->SetFarClip(radius * 3.0f);
+
+    if (!graphics->BeginFrame())
+    {
+        URHO3D_LOGERROR("Failed to begin impostor baking");
+        return {};
+    }
+
+    const int frameSize = static_cast<int>(settings.frameSize_);
+    const int atlasSize = static_cast<int>(settings.numFrames_ * settings.frameSize_);
+
+    ImpostorAtlas atlas;
+    atlas.numFrames_ = settings.numFrames_;
+    atlas.albedo_ = MakeShared<Image>(context);
+    atlas.albedo_->SetSize(atlasSize, atlasSize, 4);
+    atlas.normal_ = MakeShared<Image>(context);
+    atlas.normal_->SetSize(atlasSize, atlasSize, 3);
+    atlas.depth_ = MakeShared<Image>(context);
+    atlas.depth_->SetSize(atlasSize, atlasSize, 1);
+
+    Texture* renderTexture = renderer->GetScreenBuffer(frameSize, frameSize, Graphics::GetRGBAFormat(), 1, true, false, false, false);
+    RenderSurface* renderSurface = static_cast<Texture2D*>(renderTexture)->GetRenderSurface();
+
+    Viewport viewport(context);
+    viewport.SetCamera(camera);
+    viewport.SetRect(IntRect::ZERO);
+    viewport.SetRenderPath(renderPath);
+    viewport.SetScene(scene);
+
+    View view(context);
+    ea::vector<Vector4> albedoData;
+    ea::vector<Vector4> normalData;
+    ea::vector<Vector4> depthData;
+    for (unsigned frameY = 0; frameY < settings.numFrames_; ++frameY)
+    {
+        for (unsigned frameX = 0; frameX < settings.numFrames_; ++frameX)
+        {
+            const Vector2 frameCenter{ (frameX + 0.5f) / settings.numFrames_, (frameY + 0.5f) / settings.numFrames_ };
+            const Vector3 direction = DecodeImpostorDirection(frameCenter);
+            cameraNode->SetPosition(bounds.center_ + direction * radius * 2.0f);
+            cameraNode->LookAt(bounds.center_, Abs(direction.y_) > 0.999f ? Vector3::FORWARD : Vector3::UP);
+
+            view.Define(renderSurface, &viewport);
+            view.Update(FrameInfo());
+            view.Render();
+
+            ReadTextureRGBA32Float(view.GetExtraRenderTarget("albedo"), albedoData);
+            ReadTextureRGBA32Float(view.GetExtraRenderTarget("normal"), normalData);
+            ReadTextureRGBA32Float(view.GetExtraRenderTarget("depth"), depthData);
+
+            for (int y = 0; y < frameSize; ++y)
+            {
+                for (int x = 0; x < frameSize; ++x)
+                {
+                    const unsigned index = y * frameSize + x;
+                    const Vector4& albedo = albedoData[index];
+                    const Vector4& normal = normalData[index];
+                    // Packed normals are never zero, so cleared pixels are not covered
+                    const bool covered = normal.x_ != 0.0f || normal.y_ != 0.0f || normal.z_ != 0.0f;
+                    const float depth = (DecodeLinearDepth(depthData[index]) * radius * 3.0f - radius) / (radius * 2.0f);
+
+                    const int atlasX = frameX * frameSize + x;
+                    const int atlasY = frameY * frameSize + y;
+                    atlas.albedo_->SetPixel(atlasX, atlasY, Color(albedo.x_, albedo.y_, albedo.z_, covered ? 1.0f : 0.0f));
+                    atlas.normal_->SetPixel(atlasX, atlasY, Color(normal.x_, normal.y_, normal.z_));
+                    atlas.depth_->SetPixel(atlasX, atlasY, Color(covered ? Clamp(depth, 0.0f, 1.0f) : 1.0f, 0.0f, 0.0f));
+                }
+            }
+        }
+    }
+
+    graphics->EndFrame();
+    return atlas;
+}
+
+}
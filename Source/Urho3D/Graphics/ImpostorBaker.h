@@ -0,0 +1,83 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include "../Container/Ptr.h"
+#include "../Math/BoundingBox.h"
+#include "../Math/Sphere.h"
+#include "../Math/Vector2.h"
+
+#include <EASTL/string.h>
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+class Context;
+class Image;
+class Material;
+class Model;
+
+/// Impostor atlas baking settings.
+struct ImpostorBakingSettings
+{
+    /// Number of frames along each side of the octahedral atlas.
+    unsigned numFrames_{ 8 };
+    /// Size of one frame in pixels.
+    unsigned frameSize_{ 128 };
+    /// Baking render path. Should fill albedo, normal and depth targets from the deferred pass.
+    ea::string renderPathName_{ "RenderPaths/ImpostorBaker.xml" };
+};
+
+/// Baked impostor atlas. Each frame is the model viewed from the direction at the frame center in octahedral mapping.
+struct ImpostorAtlas
+{
+    /// Albedo in RGB, coverage in alpha.
+    SharedPtr<Image> albedo_;
+    /// Model space normal packed into RGB.
+    SharedPtr<Image> normal_;
+    /// Depth relative to the bounding sphere: zero at the front of the sphere, one at the back.
+    SharedPtr<Image> depth_;
+    /// Number of frames along each side.
+    unsigned numFrames_{};
+};
+
+/// Return bounding sphere that impostor frames are fitted into.
+inline Sphere GetImpostorBounds(const BoundingBox& boundingBox)
+{
+    return Sphere(boundingBox.Center(), boundingBox.HalfSize().Length());
+}
+
+/// Encode direction into octahedral mapping coordinates in range [0, 1].
+URHO3D_API Vector2 EncodeImpostorDirection(const Vector3& direction);
+/// Decode direction from octahedral mapping coordinates in range [0, 1].
+URHO3D_API Vector3 DecodeImpostorDirection(const Vector2& uv);
+
+/// Render model from all atlas directions into albedo, normal and depth atlases. Materials are applied per geometry.
+/// Must be called from the main thread outside of frame rendering.
+URHO3D_API ImpostorAtlas BakeImpostorAtlas(Context* context, Model* model, const ea::vector<SharedPtr<Material>>& materials,
+    const ImpostorBakingSettings& settings);
+
+}
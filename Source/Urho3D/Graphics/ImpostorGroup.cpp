@@ -0,0 +1,336 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Graphics/Batch.h"
+#include "../Graphics/Camera.h"
+#include "../Graphics/Geometry.h"
+#include "../Graphics/ImpostorBaker.h"
+#include "../Graphics/ImpostorGroup.h"
+#include "../Graphics/IndexBuffer.h"
+#include "../Graphics/Material.h"
+#include "../Graphics/Model.h"
+#include "../Graphics/StaticModelGroup.h"
+#include "../Graphics/VertexBuffer.h"
+#include "../Resource/ResourceCache.h"
+#include "../Scene/Scene.h"
+#include "../Scene/SceneEvents.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+extern const char* GEOMETRY_CATEGORY;
+
+ImpostorGroup::ImpostorGroup(Context* context) :
+    Drawable(context, DRAWABLE_GEOMETRY),
+    geometry_(context->CreateObject<Geometry>()),
+    vertexBuffer_(context->CreateObject<VertexBuffer>()),
+    indexBuffer_(context->CreateObject<IndexBuffer>())
+{
+    geometry_->SetVertexBuffer(0, vertexBuffer_);
+    geometry_->SetIndexBuffer(indexBuffer_);
+
+    batches_.resize(1);
+    batches_[0].geometry_ = geometry_;
+    batches_[0].geometryType_ = GEOM_BILLBOARD;
+    batches_[0].worldTransform_ = &transforms_[0];
+}
+
+ImpostorGroup::~ImpostorGroup() = default;
+
+void ImpostorGroup::RegisterObject(Context* context)
+{
+    context->RegisterFactory<ImpostorGroup>(GEOMETRY_CATEGORY);
+
+    URHO3D_ACCESSOR_ATTRIBUTE("Is Enabled", IsEnabled, SetEnabled, bool, true, AM_DEFAULT);
+    URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Material", GetMaterialAttr, SetMaterialAttr, ResourceRef, ResourceRef(Material::GetTypeStatic()),
+        AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Num Frames", GetNumFrames, SetNumFrames, unsigned, 8, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Impostor Distance", GetImpostorDistance, SetImpostorDistance, float, 0.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Transition Distance", GetTransitionDistance, SetTransitionDistance, float, 0.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Can Be Occluded", IsOccludee, SetOccludee, bool, true, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Cast Shadows", GetCastShadows, SetCastShadows, bool, false, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Draw Distance", GetDrawDistance, SetDrawDistance, float, 0.0f, AM_DEFAULT);
+    URHO3D_COPY_BASE_ATTRIBUTES(Drawable);
+}
+
+void ImpostorGroup::OnSetEnabled()
+{
+    Drawable::OnSetEnabled();
+
+    Scene* scene = GetScene();
+    if (scene)
+    {
+        if (IsEnabledEffective())
+            SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(ImpostorGroup, HandleScenePostUpdate));
+        else
+            UnsubscribeFromEvent(scene, E_SCENEPOSTUPDATE);
+    }
+}
+
+void ImpostorGroup::Update(const FrameInfo& frame)
+{
+    if (!needUpdate_)
+        return;
+    needUpdate_ = false;
+    bufferDirty_ = true;
+    impostors_.clear();
+
+    auto* group = node_->GetComponent<StaticModelGroup>();
+    Model* model = group ? group->GetModel() : nullptr;
+    if (!model || !frame.camera_ || impostorDistance_ <= 0.0f || !numFrames_)
+        return;
+
+    const Sphere bounds = GetImpostorBounds(model->GetBoundingBox());
+    const Vector3 cameraPosition = frame.camera_->GetNode()->GetWorldPosition();
+    const float frameSize = 1.0f / numFrames_;
+    for (unsigned i = 0; i < group->GetNumInstanceNodes(); ++i)
+    {
+        Node* instanceNode = group->GetInstanceNode(i);
+        if (!instanceNode || !instanceNode->IsEnabled())
+            continue;
+
+        const Matrix3x4& worldTransform = instanceNode->GetWorldTransform();
+        const Vector3 center = worldTransform * bounds.center_;
+        const float distance = frame.camera_->GetDistance(center);
+        if (distance <= impostorDistance_)
+            continue;
+
+        // Pick the frame baked from the direction closest to the camera in instance space
+        const Vector3 localDirection = instanceNode->GetWorldRotation().Inverse() * (cameraPosition - center);
+        const Vector2 uv = EncodeImpostorDirection(localDirection.Normalized());
+        const int frameX = Clamp(FloorToInt(uv.x_ * numFrames_), 0, static_cast<int>(numFrames_) - 1);
+        const int frameY = Clamp(FloorToInt(uv.y_ * numFrames_), 0, static_cast<int>(numFrames_) - 1);
+
+        const Vector3 scale = worldTransform.Scale();
+        const float size = bounds.radius_ * Max(scale.x_, Max(scale.y_, scale.z_));
+        const float fade = transitionDistance_ > 0.0f ? Min((distance - impostorDistance_) / transitionDistance_, 1.0f) : 1.0f;
+
+        Billboard& impostor = impostors_.emplace_back();
+        impostor.position_ = center;
+        impostor.size_ = Vector2(size, size);
+        impostor.uv_ = Rect(frameX * frameSize, frameY * frameSize, (frameX + 1) * frameSize, (frameY + 1) * frameSize);
+        impostor.color_ = Color(1.0f, 1.0f, 1.0f, fade);
+        impostor.rotation_ = 0.0f;
+        impostor.enabled_ = true;
+    }
+}
+
+void ImpostorGroup::UpdateBatches(const FrameInfo& frame)
+{
+    distance_ = frame.camera_->GetDistance(GetWorldBoundingBox().Center());
+
+    batches_[0].distance_ = distance_;
+    batches_[0].numWorldTransforms_ = 2;
+    // Impostor positions are in world space
+    transforms_[0] = Matrix3x4::IDENTITY;
+    transforms_[1] = Matrix3x4(Vector3::ZERO, frame.camera_->GetFaceCameraRotation(node_->GetWorldPosition(),
+        node_->GetWorldRotation(), FC_ROTATE_XYZ), Vector3::ONE);
+}
+
+void ImpostorGroup::UpdateGeometry(const FrameInfo& frame)
+{
+    // Re-update the rotation for the current view
+    transforms_[1] = Matrix3x4(Vector3::ZERO, frame.camera_->GetFaceCameraRotation(node_->GetWorldPosition(),
+        node_->GetWorldRotation(), FC_ROTATE_XYZ), Vector3::ONE);
+
+    if (vertexBuffer_->GetVertexCount() < impostors_.size() * 4 || indexBuffer_->IsDataLost())
+        UpdateBufferSize();
+
+    if (bufferDirty_ || vertexBuffer_->IsDataLost())
+        UpdateVertexBuffer();
+}
+
+UpdateGeometryType ImpostorGroup::GetUpdateGeometryType()
+{
+    // Impostors always face the camera
+    return UPDATE_MAIN_THREAD;
+}
+
+void ImpostorGroup::SetMaterial(Material* material)
+{
+    batches_[0].material_ = material;
+    MarkNetworkUpdate();
+}
+
+void ImpostorGroup::SetNumFrames(unsigned numFrames)
+{
+    numFrames_ = Max(numFrames, 1u);
+    MarkNetworkUpdate();
+}
+
+void ImpostorGroup::SetImpostorDistance(float distance)
+{
+    impostorDistance_ = Max(distance, 0.0f);
+    MarkNetworkUpdate();
+}
+
+void ImpostorGroup::SetTransitionDistance(float distance)
+{
+    transitionDistance_ = Max(distance, 0.0f);
+    MarkNetworkUpdate();
+}
+
+Material* ImpostorGroup::GetMaterial() const
+{
+    return batches_[0].material_;
+}
+
+void ImpostorGroup::SetMaterialAttr(const ResourceRef& value)
+{
+    auto* cache = GetSubsystem<ResourceCache>();
+    SetMaterial(cache->GetResource<Material>(value.name_));
+}
+
+ResourceRef ImpostorGroup::GetMaterialAttr() const
+{
+    return GetResourceRef(batches_[0].material_, Material::GetTypeStatic());
+}
+
+void ImpostorGroup::OnSceneSet(Scene* scene)
+{
+    Drawable::OnSceneSet(scene);
+
+    if (scene && IsEnabledEffective())
+        SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(ImpostorGroup, HandleScenePostUpdate));
+    else if (!scene)
+        UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
+}
+
+void ImpostorGroup::OnWorldBoundingBoxUpdate()
+{
+    // Impostors never extend beyond the instances of the group
+    auto* group = node_->GetComponent<StaticModelGroup>();
+    worldBoundingBox_ = group ? group->GetWorldBoundingBox() : BoundingBox(node_->GetWorldPosition(), node_->GetWorldPosition());
+}
+
+void ImpostorGroup::HandleScenePostUpdate(StringHash eventType, VariantMap& eventData)
+{
+    auto* group = node_->GetComponent<StaticModelGroup>();
+    if (!group)
+        return;
+
+    // The group draws instances until impostors are fully faded in
+    const float instanceDrawDistance = impostorDistance_ > 0.0f ? impostorDistance_ + transitionDistance_ : 0.0f;
+    if (group->GetInstanceDrawDistance() != instanceDrawDistance)
+        group->SetInstanceDrawDistance(instanceDrawDistance);
+
+    // Follow instances moving
+    if (group->GetWorldBoundingBox() != worldBoundingBox_)
+        Drawable::OnMarkedDirty(node_);
+
+    // Only update if was in view since the last update
+    if (viewFrameNumber_ != lastUpdateFrameNumber_)
+    {
+        lastUpdateFrameNumber_ = viewFrameNumber_;
+        needUpdate_ = true;
+        MarkForUpdate();
+    }
+}
+
+void ImpostorGroup::UpdateBufferSize()
+{
+    const unsigned numImpostors = impostors_.size();
+    vertexBuffer_->SetSize(numImpostors * 4, MASK_POSITION | MASK_COLOR | MASK_TEXCOORD1 | MASK_TEXCOORD2, true);
+    geometry_->SetVertexBuffer(0, vertexBuffer_);
+
+    const bool largeIndices = numImpostors * 4 >= 65536;
+    indexBuffer_->SetSize(numImpostors * 6, largeIndices);
+    bufferDirty_ = true;
+    if (!numImpostors)
+        return;
+
+    // Indices do not change for a given impostor capacity
+    void* destPtr = indexBuffer_->Lock(0, numImpostors * 6, true);
+    if (!destPtr)
+        return;
+
+    for (unsigned i = 0; i < numImpostors; ++i)
+    {
+        const unsigned vertexIndex = i * 4;
+        const unsigned indices[6] = { vertexIndex, vertexIndex + 1, vertexIndex + 2, vertexIndex + 2, vertexIndex + 3, vertexIndex };
+        for (unsigned j = 0; j < 6; ++j)
+        {
+            if (largeIndices)
+                static_cast<unsigned*>(destPtr)[i * 6 + j] = indices[j];
+            else
+                static_cast<unsigned short*>(destPtr)[i * 6 + j] = static_cast<unsigned short>(indices[j]);
+        }
+    }
+
+    indexBuffer_->Unlock();
+    indexBuffer_->ClearDataLost();
+}
+
+void ImpostorGroup::UpdateVertexBuffer()
+{
+    const unsigned numImpostors = impostors_.size();
+    geometry_->SetDrawRange(TRIANGLE_LIST, 0, numImpostors * 6, false);
+
+    bufferDirty_ = false;
+    if (!numImpostors)
+        return;
+
+    auto* dest = (float*)vertexBuffer_->Lock(0, numImpostors * 4, true);
+    if (!dest)
+        return;
+
+    for (const Billboard& impostor : impostors_)
+    {
+        const unsigned color = impostor.color_.ToUInt();
+        const float offsets[4][2] = {
+            { -impostor.size_.x_, impostor.size_.y_ },
+            { impostor.size_.x_, impostor.size_.y_ },
+            { impostor.size_.x_, -impostor.size_.y_ },
+            { -impostor.size_.x_, -impostor.size_.y_ }
+        };
+        const float uvs[4][2] = {
+            { impostor.uv_.min_.x_, impostor.uv_.min_.y_ },
+            { impostor.uv_.max_.x_, impostor.uv_.min_.y_ },
+            { impostor.uv_.max_.x_, impostor.uv_.max_.y_ },
+            { impostor.uv_.min_.x_, impostor.uv_.max_.y_ }
+        };
+
+        for (unsigned j = 0; j < 4; ++j)
+        {
+            dest[0] = impostor.position_.x_;
+            dest[1] = impostor.position_.y_;
+            dest[2] = impostor.position_.z_;
+            ((unsigned&)dest[3]) = color;
+            dest[4] = uvs[j][0];
+            dest[5] = uvs[j][1];
+            dest[6] = offsets[j][0];
+            dest[7] = offsets[j][1];
+            dest += 8;
+        }
+    }
+
+    vertexBuffer_->Unlock();
+    vertexBuffer_->ClearDataLost();
+}
+
+}
@@ -0,0 +1,129 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Graphics/BillboardSet.h"
+
+namespace Urho3D
+{
+
+class StaticModelGroup;
+
+/// Draws distant instances of the StaticModelGroup in the same node as camera-facing impostors in a single batch. Impostor frames are picked from an octahedral atlas baked with BakeImpostorAtlas(). Instances closer than impostor distance plus transition distance are left to the group.
+class URHO3D_API ImpostorGroup : public Drawable
+{
+    URHO3D_OBJECT(ImpostorGroup, Drawable);
+
+public:
+    /// Construct.
+    explicit ImpostorGroup(Context* context);
+    /// Destruct.
+    ~ImpostorGroup() override;
+    /// Register object factory.
+    /// @nobind
+    static void RegisterObject(Context* context);
+
+    /// Handle enabled/disabled state change.
+    void OnSetEnabled() override;
+    /// Update impostors from the instances of the group. Called once per frame from a worker thread.
+    void Update(const FrameInfo& frame) override;
+    /// Calculate distance and prepare batches for rendering. May be called from worker thread(s), possibly re-entrantly.
+    void UpdateBatches(const FrameInfo& frame) override;
+    /// Prepare geometry for rendering.
+    void UpdateGeometry(const FrameInfo& frame) override;
+    /// Return whether a geometry update is necessary, and if it can happen in a worker thread.
+    UpdateGeometryType GetUpdateGeometryType() override;
+
+    /// Set impostor material. Should sample the albedo atlas with a billboard technique.
+    /// @property
+    void SetMaterial(Material* material);
+    /// Set number of frames along each side of the atlas.
+    /// @property
+    void SetNumFrames(unsigned numFrames);
+    /// Set distance from the camera beyond which instances are drawn as impostors. Zero disables impostors.
+    /// @property
+    void SetImpostorDistance(float distance);
+    /// Set distance over which impostors fade in while the group still draws the instances.
+    /// @property
+    void SetTransitionDistance(float distance);
+
+    /// Return impostor material.
+    /// @property
+    Material* GetMaterial() const;
+    /// Return number of frames along each side of the atlas.
+    /// @property
+    unsigned GetNumFrames() const { return numFrames_; }
+    /// Return impostor distance.
+    /// @property
+    float GetImpostorDistance() const { return impostorDistance_; }
+    /// Return transition distance.
+    /// @property
+    float GetTransitionDistance() const { return transitionDistance_; }
+    /// Return number of impostors drawn on the last update.
+    /// @property
+    unsigned GetNumImpostors() const { return impostors_.size(); }
+
+    /// Set material attribute.
+    void SetMaterialAttr(const ResourceRef& value);
+    /// Return material attribute.
+    ResourceRef GetMaterialAttr() const;
+
+protected:
+    /// Handle scene being assigned.
+    void OnSceneSet(Scene* scene) override;
+    /// Recalculate the world-space bounding box.
+    void OnWorldBoundingBoxUpdate() override;
+
+private:
+    /// Handle scene post-update event.
+    void HandleScenePostUpdate(StringHash eventType, VariantMap& eventData);
+    /// Resize vertex and index buffers to fit the impostors.
+    void UpdateBufferSize();
+    /// Rewrite vertex buffer.
+    void UpdateVertexBuffer();
+
+    /// Geometry.
+    SharedPtr<Geometry> geometry_;
+    /// Vertex buffer.
+    SharedPtr<VertexBuffer> vertexBuffer_;
+    /// Index buffer.
+    SharedPtr<IndexBuffer> indexBuffer_;
+    /// Transform matrices for position and billboard orientation.
+    Matrix3x4 transforms_[2];
+    /// Impostors of the instances beyond impostor distance.
+    ea::vector<Billboard> impostors_;
+    /// Number of frames along each side of the atlas.
+    unsigned numFrames_{ 8 };
+    /// Impostor distance.
+    float impostorDistance_{};
+    /// Transition distance.
+    float transitionDistance_{};
+    /// Frame number on which impostors were last updated.
+    unsigned lastUpdateFrameNumber_{ M_MAX_UNSIGNED };
+    /// Impostors need update flag.
+    bool needUpdate_{};
+    /// Vertex buffer needs rewrite flag.
+    bool bufferDirty_{ true };
+};
+
+}
@@ -97,6 +97,18 @@ bool IndexBuffer::SetSize(unsigned indexCount, bool largeIndices, bool dynamic)
     return Create();
 }
 
+bool IndexBuffer::SetDataRangeAsync(const ea::shared_array<unsigned char>& data, unsigned start, unsigned count)
+{
+    if (!graphics_ || !data)
+        return false;
+
+    graphics_->QueueUpload(this, this, count * indexSize_, [this, data, start, count]()
+    {
+        SetDataRange(data.get(), start, count);
+    });
+    return true;
+}
+
 bool IndexBuffer::GetUsedVertexRange(unsigned start, unsigned count, unsigned& minVertex, unsigned& vertexCount)
 {
     if (!shadowData_)
@@ -187,10 +187,15 @@ struct IncrementalLightBakerSettings
     /// Lightmap name format string.
     /// Placeholder 1: global lightmap index.
     ea::string lightmapNameFormat_{ "Textures/Lightmap-{}.png" };
+    /// Whether to save lightmaps as DXT1 compressed DDS images with mip levels.
+    /// Lightmaps are loaded directly into compressed textures. Extension of lightmap name format is replaced with "dds".
+    bool compressLightmaps_{};
     /// Light probe group name format string.
     /// Placeholders 1-3: x, y and z components of chunk index.
     /// Placeholder 4: light probe group index within chunk.
     ea::string lightProbeGroupNameFormat_{ "Binary/LightProbeGroup-{}-{}-{}-{}.bin" };
+    /// Chunk hashes file name. Used to skip baking of chunks that didn't change since last bake.
+    ea::string chunkHashesFileName_{ "Binary/ChunkHashes.bin" };
 };
 
 /// Aggregated light baking settings.
@@ -52,17 +52,22 @@ bool SerializeValue(Archive& archive, const char* name, LightProbeCollectionBake
 {
     if (ArchiveBlock block = archive.OpenUnorderedBlock(name))
     {
-        static const unsigned currentVersion = 1;
+        static const unsigned currentVersion = 2;
         const unsigned version = archive.SerializeVersion(currentVersion);
-        if (version == currentVersion)
+        if (version >= 1 && version <= currentVersion)
         {
             SerializeVector(archive, "SH9", "Element", value.sphericalHarmonics_);
 
+            // Background transfer is not present in old versions
+            if (version >= 2)
+                SerializeVector(archive, "BackgroundSH9", "Element", value.backgroundSphericalHarmonics_);
+
             // Generate ambient if loading
             if (archive.IsInput())
             {
                 const unsigned numLightProbes = value.Size();
                 value.ambient_.resize(numLightProbes);
+                value.backgroundSphericalHarmonics_.resize(numLightProbes, SphericalHarmonicsDot9::ZERO);
                 for (unsigned i = 0; i < numLightProbes; ++i)
                     value.ambient_[i] = value.sphericalHarmonics_[i].GetDebugColor().ToVector3();
             }
@@ -151,6 +156,7 @@ void LightProbeGroup::CollectLightProbes(const ea::vector<LightProbeGroup*>& lig
         {
             bakedData->sphericalHarmonics_.append(group->bakedData_.sphericalHarmonics_);
             bakedData->ambient_.append(group->bakedData_.ambient_);
+            bakedData->backgroundSphericalHarmonics_.append(group->bakedData_.backgroundSphericalHarmonics_);
         }
     }
 }
@@ -186,8 +192,10 @@ bool LightProbeGroup::SaveLightProbesBakedData(Context* context,
 
     auto sphericalHarmonicsBegin = bakedData.sphericalHarmonics_.begin() + offset;
     auto ambientBegin = bakedData.ambient_.begin() + offset;
+    auto backgroundBegin = bakedData.backgroundSphericalHarmonics_.begin() + offset;
     copy.sphericalHarmonics_.assign(sphericalHarmonicsBegin, sphericalHarmonicsBegin + count);
     copy.ambient_.assign(ambientBegin, ambientBegin + count);
+    copy.backgroundSphericalHarmonics_.assign(backgroundBegin, backgroundBegin + count);
 
     BinaryFile bakedDataFile(context);
 
@@ -366,6 +374,7 @@ void LightProbeGroup::UpdateBakedData()
         {
             bakedData_.sphericalHarmonics_[i] = SphericalHarmonicsDot9::ZERO;
             bakedData_.ambient_[i] = Vector3::ZERO;
+            bakedData_.backgroundSphericalHarmonics_[i] = SphericalHarmonicsDot9::ZERO;
         }
     }
 }
@@ -54,6 +54,9 @@ struct LightProbeCollectionBakedData
     ea::vector<SphericalHarmonicsDot9> sphericalHarmonics_;
     /// Baked ambient light.
     ea::vector<Vector3> ambient_;
+    /// Incoming light from unit white background, baked into spherical harmonics.
+    /// Used to relight light probes when background is not static.
+    ea::vector<SphericalHarmonicsDot9> backgroundSphericalHarmonics_;
 
     /// Return whether the collection is empty.
     bool Empty() const { return sphericalHarmonics_.empty(); }
@@ -66,6 +69,7 @@ struct LightProbeCollectionBakedData
     {
         sphericalHarmonics_.resize(size);
         ambient_.resize(size);
+        backgroundSphericalHarmonics_.resize(size);
     }
 
     /// Clear collection.
@@ -73,6 +77,7 @@ struct LightProbeCollectionBakedData
     {
         sphericalHarmonics_.clear();
         ambient_.clear();
+        backgroundSphericalHarmonics_.clear();
     }
 };
 
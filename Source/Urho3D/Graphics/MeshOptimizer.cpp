@@ -0,0 +1,1006 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Graphics/Camera.h"
+#include "../Graphics/Geometry.h"
+#include "../Graphics/IndexBuffer.h"
+#include "../Graphics/MeshOptimizer.h"
+#include "../Graphics/Model.h"
+#include "../Graphics/VertexBuffer.h"
+#include "../Math/Vector4.h"
+
+#include <EASTL/numeric.h>
+#include <EASTL/sort.h>
+#include <EASTL/unordered_map.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Size of vertex cache modelled by Forsyth's algorithm.
+const unsigned FORSYTH_CACHE_SIZE = 32;
+/// Size of vertex cache used to split triangle list into clusters for overdraw optimization.
+const unsigned OVERDRAW_CACHE_SIZE = 16;
+/// Texture coordinates within this range are stored as half floats when quantizing.
+const float MAX_HALF_TEXCOORD = 64.0f;
+
+float CalculateForsythVertexScore(int cachePosition, unsigned numActiveTriangles)
+{
+    if (numActiveTriangles == 0)
+        return -1.0f;
+
+    float score = 0.0f;
+    if (cachePosition >= 0)
+    {
+        // Vertices of the last triangle get fixed score so that the direction of traversal doesn't matter
+        if (cachePosition < 3)
+            score = 0.75f;
+        else
+            score = powf(1.0f - static_cast<float>(cachePosition - 3) / (FORSYTH_CACHE_SIZE - 3), 1.5f);
+    }
+
+    // Prefer vertices with few remaining triangles so that lone triangles are not left behind
+    score += 2.0f / sqrtf(static_cast<float>(numActiveTriangles));
+    return score;
+}
+
+/// Symmetric quadric of squared distances to a set of planes.
+struct Quadric
+{
+    /// Add plane with given normal and distance from origin.
+    void AddPlane(const Vector3& normal, float distance, float weight)
+    {
+        const double x = normal.x_, y = normal.y_, z = normal.z_, d = distance, w = weight;
+        a00_ += w * x * x;
+        a01_ += w * x * y;
+        a02_ += w * x * z;
+        a11_ += w * y * y;
+        a12_ += w * y * z;
+        a22_ += w * z * z;
+        b0_ += w * x * d;
+        b1_ += w * y * d;
+        b2_ += w * z * d;
+        c_ += w * d * d;
+        weight_ += w;
+    }
+
+    /// Add other quadric.
+    Quadric& operator +=(const Quadric& rhs)
+    {
+        a00_ += rhs.a00_;
+        a01_ += rhs.a01_;
+        a02_ += rhs.a02_;
+        a11_ += rhs.a11_;
+        a12_ += rhs.a12_;
+        a22_ += rhs.a22_;
+        b0_ += rhs.b0_;
+        b1_ += rhs.b1_;
+        b2_ += rhs.b2_;
+        c_ += rhs.c_;
+        weight_ += rhs.weight_;
+        return *this;
+    }
+
+    /// Return mean squared distance from point to the planes.
+    double Evaluate(const Vector3& point) const
+    {
+        if (weight_ <= 0.0)
+            return 0.0;
+
+        const double x = point.x_, y = point.y_, z = point.z_;
+        const double error = a00_ * x * x + a11_ * y * y + a22_ * z * z
+            + 2.0 * (a01_ * x * y + a02_ * x * z + a12_ * y * z)
+            + 2.0 * (b0_ * x + b1_ * y + b2_ * z) + c_;
+        return Max(0.0, error / weight_);
+    }
+
+    double a00_{}, a01_{}, a02_{}, a11_{}, a12_{}, a22_{};
+    double b0_{}, b1_{}, b2_{};
+    double c_{};
+    double weight_{};
+};
+
+/// Edge collapse candidate between welded points.
+struct EdgeCollapse
+{
+    unsigned from_;
+    unsigned to_;
+    double error_;
+};
+
+/// Build compact adjacency lists of items by key.
+void BuildAdjacency(const ea::vector<unsigned>& keys, unsigned numKeys, unsigned itemDivisor,
+    ea::vector<unsigned>& offsets, ea::vector<unsigned>& items)
+{
+    offsets.assign(numKeys + 1, 0);
+    for (unsigned key : keys)
+        ++offsets[key + 1];
+    for (unsigned i = 0; i < numKeys; ++i)
+        offsets[i + 1] += offsets[i];
+
+    items.resize(keys.size());
+    ea::vector<unsigned> fill(offsets.begin(), offsets.end() - 1);
+    for (unsigned i = 0; i < keys.size(); ++i)
+        items[fill[keys[i]]++] = i / itemDivisor;
+}
+
+/// Create cluster from range of triangle list and calculate its bounding sphere and normal cone.
+GeometryCluster CreateCluster(const unsigned indices[], unsigned indexStart, unsigned indexCount, const Vector3 positions[])
+{
+    GeometryCluster cluster;
+    cluster.indexStart_ = indexStart;
+    cluster.indexCount_ = indexCount;
+
+    BoundingBox boundingBox;
+    for (unsigned i = indexStart; i < indexStart + indexCount; ++i)
+        boundingBox.Merge(positions[indices[i]]);
+
+    const Vector3 center = boundingBox.Center();
+    float radiusSquared = 0.0f;
+    for (unsigned i = indexStart; i < indexStart + indexCount; ++i)
+        radiusSquared = Max(radiusSquared, (positions[indices[i]] - center).LengthSquared());
+    cluster.boundingSphere_.Define(center, sqrtf(radiusSquared));
+
+    const auto getTriangleNormal = [&](unsigned i)
+    {
+        const Vector3& p0 = positions[indices[i]];
+        const Vector3& p1 = positions[indices[i + 1]];
+        const Vector3& p2 = positions[indices[i + 2]];
+        return (p1 - p0).CrossProduct(p2 - p0).Normalized();
+    };
+
+    Vector3 coneAxis;
+    for (unsigned i = indexStart; i < indexStart + indexCount; i += 3)
+        coneAxis += getTriangleNormal(i);
+    coneAxis.Normalize();
+
+    float minDot = 1.0f;
+    for (unsigned i = indexStart; i < indexStart + indexCount; i += 3)
+    {
+        const Vector3 normal = getTriangleNormal(i);
+        if (normal != Vector3::ZERO)
+            minDot = Min(minDot, normal.DotProduct(coneAxis));
+    }
+
+    // Wide cones are never back facing, don't bother testing them
+    cluster.coneAxis_ = coneAxis;
+    cluster.coneCutoff_ = minDot <= 0.1f ? 1.0f : sqrtf(1.0f - minDot * minDot);
+    return cluster;
+}
+
+}
+
+void OptimizeVertexCache(unsigned indices[], unsigned numIndices, unsigned numVertices)
+{
+    const unsigned numTriangles = numIndices / 3;
+    if (numTriangles < 2)
+        return;
+
+    // Build vertex to triangle adjacency, active part of each list shrinks as triangles are emitted
+    ea::vector<unsigned> numActiveTriangles(numVertices, 0);
+    for (unsigned i = 0; i < numTriangles * 3; ++i)
+        ++numActiveTriangles[indices[i]];
+
+    ea::vector<unsigned> adjacencyOffsets(numVertices + 1, 0);
+    for (unsigned i = 0; i < numVertices; ++i)
+        adjacencyOffsets[i + 1] = adjacencyOffsets[i] + numActiveTriangles[i];
+
+    ea::vector<unsigned> adjacency(numTriangles * 3);
+    {
+        ea::vector<unsigned> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (unsigned i = 0; i < numTriangles * 3; ++i)
+            adjacency[fill[indices[i]]++] = i / 3;
+    }
+
+    ea::vector<int> cachePositions(numVertices, -1);
+    ea::vector<float> vertexScores(numVertices);
+    for (unsigned i = 0; i < numVertices; ++i)
+        vertexScores[i] = CalculateForsythVertexScore(-1, numActiveTriangles[i]);
+
+    ea::vector<float> triangleScores(numTriangles);
+    unsigned bestTriangle = 0;
+    for (unsigned i = 0; i < numTriangles; ++i)
+    {
+        triangleScores[i] = vertexScores[indices[i * 3]] + vertexScores[indices[i * 3 + 1]] + vertexScores[indices[i * 3 + 2]];
+        if (triangleScores[i] > triangleScores[bestTriangle])
+            bestTriangle = i;
+    }
+
+    ea::vector<bool> emitted(numTriangles, false);
+    ea::vector<unsigned> result;
+    result.reserve(numTriangles * 3);
+
+    unsigned cache[FORSYTH_CACHE_SIZE + 3];
+    unsigned newCache[FORSYTH_CACHE_SIZE + 3];
+    unsigned cacheSize = 0;
+    unsigned nextTriangle = 0;
+
+    for (unsigned numEmitted = 0; numEmitted < numTriangles; ++numEmitted)
+    {
+        if (bestTriangle == M_MAX_UNSIGNED)
+        {
+            // Dead end, continue from the first triangle not emitted yet
+            while (emitted[nextTriangle])
+                ++nextTriangle;
+            bestTriangle = nextTriangle;
+        }
+
+        const unsigned* triangle = &indices[bestTriangle * 3];
+        emitted[bestTriangle] = true;
+        result.insert(result.end(), triangle, triangle + 3);
+
+        unsigned newCacheSize = 0;
+        for (unsigned i = 0; i < 3; ++i)
+        {
+            const unsigned vertex = triangle[i];
+
+            // Remove emitted triangle from the active part of adjacency list
+            unsigned* begin = &adjacency[adjacencyOffsets[vertex]];
+            unsigned* end = begin + numActiveTriangles[vertex];
+            unsigned* iter = ea::find(begin, end, bestTriangle);
+            if (iter != end)
+            {
+                *iter = *(end - 1);
+                --numActiveTriangles[vertex];
+            }
+
+            if (ea::find(newCache, newCache + newCacheSize, vertex) == newCache + newCacheSize)
+                newCache[newCacheSize++] = vertex;
+        }
+
+        // Push triangle vertices to the front of the cache
+        for (unsigned i = 0; i < cacheSize; ++i)
+        {
+            const unsigned vertex = cache[i];
+            if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+                newCache[newCacheSize++] = vertex;
+        }
+
+        // Update scores of the vertices in cache, including evicted ones
+        for (unsigned i = 0; i < newCacheSize; ++i)
+        {
+            const unsigned vertex = newCache[i];
+            cachePositions[vertex] = i < FORSYTH_CACHE_SIZE ? static_cast<int>(i) : -1;
+
+            const float score = CalculateForsythVertexScore(cachePositions[vertex], numActiveTriangles[vertex]);
+            const float delta = score - vertexScores[vertex];
+            vertexScores[vertex] = score;
+
+            const unsigned* begin = &adjacency[adjacencyOffsets[vertex]];
+            for (unsigned j = 0; j < numActiveTriangles[vertex]; ++j)
+                triangleScores[begin[j]] += delta;
+        }
+
+        cacheSize = Min(newCacheSize, FORSYTH_CACHE_SIZE);
+        ea::copy(newCache, newCache + cacheSize, cache);
+
+        // Pick the best triangle adjacent to the cache
+        bestTriangle = M_MAX_UNSIGNED;
+        float bestScore = -M_INFINITY;
+        for (unsigned i = 0; i < cacheSize; ++i)
+        {
+            const unsigned vertex = cache[i];
+            const unsigned* begin = &adjacency[adjacencyOffsets[vertex]];
+            for (unsigned j = 0; j < numActiveTriangles[vertex]; ++j)
+            {
+                if (triangleScores[begin[j]] > bestScore)
+                {
+                    bestScore = triangleScores[begin[j]];
+                    bestTriangle = begin[j];
+                }
+            }
+        }
+    }
+
+    ea::copy(result.begin(), result.end(), indices);
+}
+
+float CalculateVertexCacheMissRatio(const unsigned indices[], unsigned numIndices, unsigned numVertices, unsigned cacheSize)
+{
+    const unsigned numTriangles = numIndices / 3;
+    if (numTriangles == 0)
+        return 0.0f;
+
+    // FIFO cache is modelled with timestamps: vertex is cached if it was pushed less than cacheSize pushes ago
+    ea::vector<unsigned> timestamps(numVertices, 0);
+    unsigned time = cacheSize + 1;
+    unsigned numMisses = 0;
+    for (unsigned i = 0; i < numTriangles * 3; ++i)
+    {
+        const unsigned vertex = indices[i];
+        if (time - timestamps[vertex] > cacheSize)
+        {
+            timestamps[vertex] = time++;
+            ++numMisses;
+        }
+    }
+
+    return static_cast<float>(numMisses) / numTriangles;
+}
+
+void OptimizeOverdraw(unsigned indices[], unsigned numIndices, const Vector3 positions[], unsigned numVertices, float threshold)
+{
+    const unsigned numTriangles = numIndices / 3;
+    if (numTriangles < 2)
+        return;
+
+    // Split triangle list into clusters where vertex cache is restarted, so reordering clusters keeps cache efficiency
+    ea::vector<unsigned> clusterStarts;
+    ea::vector<unsigned> timestamps(numVertices, 0);
+    unsigned time = OVERDRAW_CACHE_SIZE + 1;
+    for (unsigned i = 0; i < numTriangles; ++i)
+    {
+        unsigned numMisses = 0;
+        for (unsigned j = 0; j < 3; ++j)
+        {
+            const unsigned vertex = indices[i * 3 + j];
+            if (time - timestamps[vertex] > OVERDRAW_CACHE_SIZE)
+            {
+                timestamps[vertex] = time++;
+                ++numMisses;
+            }
+        }
+
+        if (i == 0 || numMisses == 3)
+            clusterStarts.push_back(i);
+    }
+
+    if (clusterStarts.size() < 2)
+        return;
+    clusterStarts.push_back(numTriangles);
+
+    Vector3 meshCenter;
+    for (unsigned i = 0; i < numTriangles * 3; ++i)
+        meshCenter += positions[indices[i]];
+    meshCenter /= static_cast<float>(numTriangles * 3);
+
+    // Clusters that face away from the center are likely to occlude the rest of the mesh, so draw them first
+    const unsigned numClusters = clusterStarts.size() - 1;
+    ea::vector<ea::pair<float, unsigned>> clusterOrder(numClusters);
+    for (unsigned i = 0; i < numClusters; ++i)
+    {
+        Vector3 clusterCenter;
+        Vector3 clusterNormal;
+        float clusterArea = 0.0f;
+        for (unsigned j = clusterStarts[i]; j < clusterStarts[i + 1]; ++j)
+        {
+            const Vector3& p0 = positions[indices[j * 3]];
+            const Vector3& p1 = positions[indices[j * 3 + 1]];
+            const Vector3& p2 = positions[indices[j * 3 + 2]];
+            const Vector3 normal = (p1 - p0).CrossProduct(p2 - p0);
+            const float area = normal.Length();
+            clusterCenter += (p0 + p1 + p2) * (area / 3.0f);
+            clusterNormal += normal;
+            clusterArea += area;
+        }
+
+        if (clusterArea > M_EPSILON)
+            clusterCenter /= clusterArea;
+        else
+            clusterCenter = positions[indices[clusterStarts[i] * 3]];
+
+        clusterOrder[i] = { -(clusterCenter - meshCenter).DotProduct(clusterNormal.Normalized()), i };
+    }
+    ea::sort(clusterOrder.begin(), clusterOrder.end());
+
+    ea::vector<unsigned> result;
+    result.reserve(numTriangles * 3);
+    for (const auto& item : clusterOrder)
+    {
+        const unsigned* begin = &indices[clusterStarts[item.second] * 3];
+        const unsigned* end = &indices[clusterStarts[item.second + 1] * 3];
+        result.insert(result.end(), begin, end);
+    }
+
+    const float oldMissRatio = CalculateVertexCacheMissRatio(indices, numTriangles * 3, numVertices);
+    const float newMissRatio = CalculateVertexCacheMissRatio(result.data(), result.size(), numVertices);
+    if (newMissRatio > oldMissRatio * threshold)
+        return;
+
+    ea::copy(result.begin(), result.end(), indices);
+}
+
+ea::vector<unsigned> SimplifyMesh(const unsigned indices[], unsigned numIndices, const Vector3 positions[], unsigned numVertices,
+    unsigned targetNumIndices, float maxError, float* resultError)
+{
+    if (resultError)
+        *resultError = 0.0f;
+
+    ea::vector<unsigned> result(indices, indices + numIndices / 3 * 3);
+    if (result.size() <= targetNumIndices)
+        return result;
+
+    // Weld vertices with equal positions into points, vertices of one point differ only in other attributes
+    ea::vector<unsigned> vertexOrder(numVertices);
+    ea::iota(vertexOrder.begin(), vertexOrder.end(), 0u);
+    ea::sort(vertexOrder.begin(), vertexOrder.end(), [&](unsigned lhs, unsigned rhs)
+    {
+        const Vector3& a = positions[lhs];
+        const Vector3& b = positions[rhs];
+        if (a.x_ != b.x_)
+            return a.x_ < b.x_;
+        if (a.y_ != b.y_)
+            return a.y_ < b.y_;
+        return a.z_ < b.z_;
+    });
+
+    ea::vector<unsigned> vertexToPoint(numVertices);
+    ea::vector<Vector3> pointPositions;
+    for (unsigned i = 0; i < numVertices; ++i)
+    {
+        const unsigned vertex = vertexOrder[i];
+        if (i == 0 || positions[vertex] != positions[vertexOrder[i - 1]])
+            pointPositions.push_back(positions[vertex]);
+        vertexToPoint[vertex] = pointPositions.size() - 1;
+    }
+    const unsigned numPoints = pointPositions.size();
+
+    // Accumulate plane quadrics and find open or non-manifold edges
+    ea::vector<Quadric> quadrics(numPoints);
+    ea::unordered_map<unsigned long long, unsigned> edgeCounts;
+    for (unsigned i = 0; i < result.size(); i += 3)
+    {
+        const unsigned points[3] = { vertexToPoint[result[i]], vertexToPoint[result[i + 1]], vertexToPoint[result[i + 2]] };
+        if (points[0] == points[1] || points[1] == points[2] || points[0] == points[2])
+            continue;
+
+        Vector3 normal = (pointPositions[points[1]] - pointPositions[points[0]]).CrossProduct(pointPositions[points[2]] - pointPositions[points[0]]);
+        const float area = normal.Length();
+        if (area > M_EPSILON)
+        {
+            normal /= area;
+            const float distance = -normal.DotProduct(pointPositions[points[0]]);
+            for (unsigned point : points)
+                quadrics[point].AddPlane(normal, distance, area);
+        }
+
+        for (unsigned j = 0; j < 3; ++j)
+        {
+            const unsigned a = Min(points[j], points[(j + 1) % 3]);
+            const unsigned b = Max(points[j], points[(j + 1) % 3]);
+            ++edgeCounts[(static_cast<unsigned long long>(a) << 32) | b];
+        }
+    }
+
+    // Points on borders are never moved so that holes and mesh boundaries keep their shape
+    ea::vector<bool> pointLocked(numPoints, false);
+    for (const auto& item : edgeCounts)
+    {
+        if (item.second != 2)
+        {
+            pointLocked[item.first >> 32] = true;
+            pointLocked[item.first & 0xffffffffu] = true;
+        }
+    }
+
+    const double maxErrorSquared = static_cast<double>(maxError) * maxError;
+    double appliedErrorSquared = 0.0;
+    ea::vector<unsigned> vertexRemap(numVertices);
+    ea::vector<bool> pointDirty(numPoints);
+    ea::vector<unsigned> cornerPoints;
+    ea::vector<unsigned> adjacencyOffsets;
+    ea::vector<unsigned> adjacency;
+    ea::vector<EdgeCollapse> collapses;
+    ea::vector<ea::pair<unsigned, unsigned>> vertexPairs;
+
+    while (result.size() > targetNumIndices)
+    {
+        cornerPoints.resize(result.size());
+        for (unsigned i = 0; i < result.size(); ++i)
+            cornerPoints[i] = vertexToPoint[result[i]];
+        BuildAdjacency(cornerPoints, numPoints, 3, adjacencyOffsets, adjacency);
+
+        // Collect collapses that stay within error bound, each edge is visited once from the triangle where it goes in ascending order
+        collapses.clear();
+        for (unsigned i = 0; i < result.size(); i += 3)
+        {
+            for (unsigned j = 0; j < 3; ++j)
+            {
+                const unsigned a = cornerPoints[i + j];
+                const unsigned b = cornerPoints[i + (j + 1) % 3];
+                if (a >= b)
+                    continue;
+
+                Quadric quadric = quadrics[a];
+                quadric += quadrics[b];
+                if (!pointLocked[a])
+                {
+                    const double error = quadric.Evaluate(pointPositions[b]);
+                    if (error <= maxErrorSquared)
+                        collapses.push_back({ a, b, error });
+                }
+                if (!pointLocked[b])
+                {
+                    const double error = quadric.Evaluate(pointPositions[a]);
+                    if (error <= maxErrorSquared)
+                        collapses.push_back({ b, a, error });
+                }
+            }
+        }
+
+        ea::sort(collapses.begin(), collapses.end(),
+            [](const EdgeCollapse& lhs, const EdgeCollapse& rhs) { return lhs.error_ < rhs.error_; });
+
+        ea::iota(vertexRemap.begin(), vertexRemap.end(), 0u);
+        ea::fill(pointDirty.begin(), pointDirty.end(), false);
+
+        const unsigned numTrianglesToRemove = (result.size() - targetNumIndices + 2) / 3;
+        unsigned numTrianglesRemoved = 0;
+        unsigned numCollapses = 0;
+        for (const EdgeCollapse& collapse : collapses)
+        {
+            if (numTrianglesRemoved >= numTrianglesToRemove)
+                break;
+            if (pointDirty[collapse.from_] || pointDirty[collapse.to_])
+                continue;
+
+            const unsigned* begin = &adjacency[adjacencyOffsets[collapse.from_]];
+            const unsigned* end = &adjacency[adjacencyOffsets[collapse.from_ + 1]];
+
+            // Each vertex of the collapsed point must map onto exactly one vertex of the target point
+            // via shared edge, otherwise the collapse would tear attribute seam
+            vertexPairs.clear();
+            unsigned numSharedTriangles = 0;
+            bool valid = true;
+            for (const unsigned* iter = begin; iter != end && valid; ++iter)
+            {
+                const unsigned* triangle = &result[*iter * 3];
+                const unsigned* points = &cornerPoints[*iter * 3];
+                const unsigned fromIndex = points[0] == collapse.from_ ? 0 : points[1] == collapse.from_ ? 1 : 2;
+                const unsigned toIndex = points[0] == collapse.to_ ? 0 : points[1] == collapse.to_ ? 1 : points[2] == collapse.to_ ? 2 : 3;
+
+                if (toIndex == 3)
+                {
+                    // Reject collapse that flips or degenerates remaining triangle
+                    const Vector3& p0 = pointPositions[points[(fromIndex + 1) % 3]];
+                    const Vector3& p1 = pointPositions[points[(fromIndex + 2) % 3]];
+                    const Vector3 oldNormal = (p0 - pointPositions[collapse.from_]).CrossProduct(p1 - pointPositions[collapse.from_]);
+                    const Vector3 newNormal = (p0 - pointPositions[collapse.to_]).CrossProduct(p1 - pointPositions[collapse.to_]);
+                    if (newNormal.DotProduct(oldNormal) <= 0.1f * oldNormal.Length() * newNormal.Length())
+                        valid = false;
+                    continue;
+                }
+
+                ++numSharedTriangles;
+                const ea::pair<unsigned, unsigned> vertexPair{ triangle[fromIndex], triangle[toIndex] };
+                for (const auto& existingPair : vertexPairs)
+                {
+                    if (existingPair.first == vertexPair.first && existingPair.second != vertexPair.second)
+                        valid = false;
+                }
+                vertexPairs.push_back(vertexPair);
+            }
+
+            if (!valid || numSharedTriangles == 0)
+                continue;
+
+            // Vertices of the collapsed point that are used only by remaining triangles have nowhere to go
+            ea::vector<unsigned> fromVertices;
+            ea::vector<unsigned> toVertices;
+            for (const unsigned* iter = begin; iter != end; ++iter)
+            {
+                for (unsigned j = 0; j < 3; ++j)
+                {
+                    if (cornerPoints[*iter * 3 + j] == collapse.from_ && !fromVertices.contains(result[*iter * 3 + j]))
+                        fromVertices.push_back(result[*iter * 3 + j]);
+                }
+            }
+            for (const auto& vertexPair : vertexPairs)
+            {
+                if (!toVertices.contains(vertexPair.second))
+                    toVertices.push_back(vertexPair.second);
+            }
+
+            bool allMapped = true;
+            for (unsigned vertex : fromVertices)
+            {
+                const auto iter = ea::find_if(vertexPairs.begin(), vertexPairs.end(),
+                    [&](const ea::pair<unsigned, unsigned>& vertexPair) { return vertexPair.first == vertex; });
+                if (iter == vertexPairs.end())
+                    allMapped = false;
+            }
+
+            // Seam may only be collapsed along itself
+            if (!allMapped || (fromVertices.size() > 1 && toVertices.size() != fromVertices.size()))
+                continue;
+
+            for (const auto& vertexPair : vertexPairs)
+                vertexRemap[vertexPair.first] = vertexPair.second;
+            quadrics[collapse.to_] += quadrics[collapse.from_];
+
+            for (const unsigned* iter = begin; iter != end; ++iter)
+            {
+                for (unsigned j = 0; j < 3; ++j)
+                    pointDirty[cornerPoints[*iter * 3 + j]] = true;
+            }
+
+            numTrianglesRemoved += numSharedTriangles;
+            appliedErrorSquared = Max(appliedErrorSquared, collapse.error_);
+            ++numCollapses;
+        }
+
+        if (numCollapses == 0)
+            break;
+
+        // Apply collapses and remove degenerate triangles
+        unsigned numResultIndices = 0;
+        for (unsigned i = 0; i < result.size(); i += 3)
+        {
+            const unsigned i0 = vertexRemap[result[i]];
+            const unsigned i1 = vertexRemap[result[i + 1]];
+            const unsigned i2 = vertexRemap[result[i + 2]];
+            const unsigned p0 = vertexToPoint[i0];
+            const unsigned p1 = vertexToPoint[i1];
+            const unsigned p2 = vertexToPoint[i2];
+            if (p0 == p1 || p1 == p2 || p0 == p2)
+                continue;
+
+            result[numResultIndices++] = i0;
+            result[numResultIndices++] = i1;
+            result[numResultIndices++] = i2;
+        }
+        result.resize(numResultIndices);
+    }
+
+    if (resultError)
+        *resultError = static_cast<float>(sqrt(appliedErrorSquared));
+    return result;
+}
+
+ea::vector<GeometryCluster> GenerateClusters(const unsigned indices[], unsigned numIndices, const Vector3 positions[], unsigned numVertices,
+    unsigned maxVertices, unsigned maxTriangles)
+{
+    ea::vector<GeometryCluster> clusters;
+    const unsigned numTriangles = numIndices / 3;
+    maxVertices = Max(maxVertices, 3u);
+    maxTriangles = Max(maxTriangles, 1u);
+
+    // Vertices are marked with the index of the cluster they were last added to
+    ea::vector<unsigned> vertexClusters(numVertices, M_MAX_UNSIGNED);
+    unsigned clusterStart = 0;
+    unsigned numClusterVertices = 0;
+    Vector3 clusterNormal;
+
+    for (unsigned i = 0; i < numTriangles; ++i)
+    {
+        const unsigned* triangle = &indices[i * 3];
+        const Vector3 normal = (positions[triangle[1]] - positions[triangle[0]]).CrossProduct(
+            positions[triangle[2]] - positions[triangle[0]]).Normalized();
+
+        unsigned numNewVertices = 0;
+        for (unsigned j = 0; j < 3; ++j)
+        {
+            if (vertexClusters[triangle[j]] != clusters.size())
+                ++numNewVertices;
+        }
+
+        // Start new cluster when the current one is full or when the triangle would make its normal cone too wide
+        const unsigned numClusterTriangles = i - clusterStart;
+        const bool isFull = numClusterVertices + numNewVertices > maxVertices || numClusterTriangles >= maxTriangles;
+        const bool isDivergent = numClusterTriangles >= maxTriangles / 4 && normal.DotProduct(clusterNormal.Normalized()) < 0.0f;
+        if (numClusterTriangles > 0 && (isFull || isDivergent))
+        {
+            clusters.push_back(CreateCluster(indices, clusterStart * 3, numClusterTriangles * 3, positions));
+            clusterStart = i;
+            numClusterVertices = 0;
+            clusterNormal = Vector3::ZERO;
+        }
+
+        for (unsigned j = 0; j < 3; ++j)
+        {
+            if (vertexClusters[triangle[j]] != clusters.size())
+            {
+                vertexClusters[triangle[j]] = clusters.size();
+                ++numClusterVertices;
+            }
+        }
+        clusterNormal += normal;
+    }
+
+    if (clusterStart < numTriangles)
+        clusters.push_back(CreateCluster(indices, clusterStart * 3, (numTriangles - clusterStart) * 3, positions));
+
+    return clusters;
+}
+
+bool OptimizeModel(Model* model, const MeshOptimizationSettings& settings)
+{
+    if (!model)
+        return false;
+
+    Context* context = model->GetContext();
+    const auto& geometries = model->GetGeometries();
+
+    // Morphs are applied on CPU to float vertex data by vertex index, so morphed buffers only get their triangles reordered
+    const bool hasMorphs = model->GetNumMorphs() > 0;
+    const bool reorderVertices = settings.optimizeVertexFetch_ && !hasMorphs;
+    const bool quantizeVertices = settings.quantizeVertices_ && !hasMorphs;
+
+    const float modelSize = model->GetBoundingBox().Size().Length();
+    const float lodMaxError = settings.lodMaxError_ * modelSize;
+
+    // LOD distance is camera distance divided by drawable scale, pick the one where simplification error
+    // projects to the given number of pixels in the reference view
+    const float lodScale = Max(model->GetBoundingBox().Size().DotProduct(DOT_SCALE), M_EPSILON);
+    const float pixelsPerUnitAtUnitDistance = LOD_REFERENCE_VIEW_HEIGHT / (2.0f * Tan(LOD_REFERENCE_FOV * 0.5f));
+    const auto getLodDistance = [&](unsigned level, float error, float previousDistance)
+    {
+        if (settings.lodDistance_ > 0.0f)
+            return settings.lodDistance_ * level;
+        const float distance = error * pixelsPerUnitAtUnitDistance / Max(settings.lodPixelError_, M_EPSILON) / lodScale;
+        return Max(distance, previousDistance);
+    };
+
+    ea::vector<SharedPtr<VertexBuffer>> vertexBuffers = model->GetVertexBuffers();
+    ea::vector<SharedPtr<IndexBuffer>> indexBuffers = model->GetIndexBuffers();
+    bool modified = false;
+
+    for (unsigned bufferIndex = 0; bufferIndex < vertexBuffers.size(); ++bufferIndex)
+    {
+        VertexBuffer* vertexBuffer = vertexBuffers[bufferIndex];
+        const VertexElement* positionElement = vertexBuffer->GetElement(SEM_POSITION);
+        if (!vertexBuffer->GetShadowData() || !positionElement)
+            continue;
+
+        // Find geometries using this vertex buffer, all of them must share single index buffer
+        IndexBuffer* indexBuffer = nullptr;
+        ea::vector<unsigned> geometryIndices;
+        bool supported = true;
+        for (unsigned i = 0; i < geometries.size(); ++i)
+        {
+            for (Geometry* geometry : geometries[i])
+            {
+                if (!geometry || !geometry->GetVertexBuffers().contains(SharedPtr<VertexBuffer>(vertexBuffer)))
+                    continue;
+
+                IndexBuffer* geometryIndexBuffer = geometry->GetIndexBuffer();
+                if (geometry->GetNumVertexBuffers() != 1 || geometry->GetPrimitiveType() != TRIANGLE_LIST || !geometryIndexBuffer
+                    || !geometryIndexBuffer->GetShadowData() || (indexBuffer && indexBuffer != geometryIndexBuffer))
+                    supported = false;
+
+                indexBuffer = geometryIndexBuffer;
+                if (!geometryIndices.contains(i))
+                    geometryIndices.push_back(i);
+            }
+        }
+
+        if (!supported || !indexBuffer)
+            continue;
+
+        for (unsigned i = 0; i < geometries.size() && supported; ++i)
+        {
+            for (Geometry* geometry : geometries[i])
+            {
+                if (geometry && geometry->GetIndexBuffer() == indexBuffer && !geometryIndices.contains(i))
+                    supported = false;
+            }
+        }
+
+        if (!supported)
+            continue;
+
+        const unsigned numVertices = vertexBuffer->GetVertexCount();
+        const unsigned vertexSize = vertexBuffer->GetVertexSize();
+
+        ea::vector<Vector4> unpackedPositions(numVertices);
+        VertexBuffer::UnpackVertexData(vertexBuffer->GetShadowData(), vertexSize, *positionElement, 0, numVertices,
+            unpackedPositions.data(), sizeof(Vector4));
+        ea::vector<Vector3> positions(numVertices);
+        for (unsigned i = 0; i < numVertices; ++i)
+            positions[i] = static_cast<Vector3>(unpackedPositions[i]);
+
+        // Gather index data of existing LOD levels and generate new ones
+        ea::vector<ea::vector<ea::vector<unsigned>>> lodIndices(geometryIndices.size());
+        ea::vector<ea::vector<float>> lodDistances(geometryIndices.size());
+        for (unsigned i = 0; i < geometryIndices.size(); ++i)
+        {
+            for (Geometry* geometry : geometries[geometryIndices[i]])
+            {
+                lodIndices[i].push_back(indexBuffer->GetUnpackedData(geometry->GetIndexStart(), geometry->GetIndexCount()));
+                lodDistances[i].push_back(geometry->GetLodDistance());
+            }
+
+            if (lodIndices[i].size() != 1 || settings.numLodLevels_ == 0)
+                continue;
+
+            const ea::vector<unsigned>& sourceIndices = lodIndices[i][0];
+            for (unsigned level = 1; level <= settings.numLodLevels_; ++level)
+            {
+                const auto numTargetTriangles = static_cast<unsigned>(sourceIndices.size() / 3 * powf(settings.lodReduction_, static_cast<float>(level)));
+                float error = 0.0f;
+                ea::vector<unsigned> simplifiedIndices = SimplifyMesh(sourceIndices.data(), sourceIndices.size(), positions.data(), numVertices,
+                    Max(numTargetTriangles, 1u) * 3, lodMaxError, &error);
+
+                // Stop once simplification is stuck at the error bound
+                if (simplifiedIndices.empty() || simplifiedIndices.size() > lodIndices[i].back().size() * 9 / 10)
+                    break;
+
+                lodIndices[i].push_back(ea::move(simplifiedIndices));
+                lodDistances[i].push_back(getLodDistance(level, error, lodDistances[i].back()));
+            }
+        }
+
+        for (auto& geometryLods : lodIndices)
+        {
+            for (ea::vector<unsigned>& indices : geometryLods)
+            {
+                if (settings.optimizeVertexCache_)
+                    OptimizeVertexCache(indices.data(), indices.size(), numVertices);
+                if (settings.optimizeOverdraw_)
+                    OptimizeOverdraw(indices.data(), indices.size(), positions.data(), numVertices, settings.overdrawThreshold_);
+            }
+        }
+
+        ea::vector<ea::vector<GeometryCluster>> geometryClusters(geometryIndices.size());
+        if (settings.generateClusters_)
+        {
+            for (unsigned i = 0; i < geometryIndices.size(); ++i)
+            {
+                const ea::vector<unsigned>& indices = lodIndices[i][0];
+                geometryClusters[i] = GenerateClusters(indices.data(), indices.size(), positions.data(), numVertices,
+                    settings.clusterMaxVertices_, settings.clusterMaxTriangles_);
+            }
+        }
+
+        // Reorder vertices in the order of first use and drop unused ones
+        const unsigned char* vertexData = vertexBuffer->GetShadowData();
+        ea::vector<unsigned char> reorderedVertexData;
+        unsigned newNumVertices = numVertices;
+        if (reorderVertices)
+        {
+            ea::vector<unsigned> vertexRemap(numVertices, M_MAX_UNSIGNED);
+            newNumVertices = 0;
+            for (auto& geometryLods : lodIndices)
+            {
+                for (ea::vector<unsigned>& indices : geometryLods)
+                {
+                    for (unsigned& index : indices)
+                    {
+                        if (vertexRemap[index] == M_MAX_UNSIGNED)
+                            vertexRemap[index] = newNumVertices++;
+                        index = vertexRemap[index];
+                    }
+                }
+            }
+
+            reorderedVertexData.resize(newNumVertices * vertexSize);
+            for (unsigned i = 0; i < numVertices; ++i)
+            {
+                if (vertexRemap[i] != M_MAX_UNSIGNED)
+                    memcpy(&reorderedVertexData[vertexRemap[i] * vertexSize], vertexData + i * vertexSize, vertexSize);
+            }
+            vertexData = reorderedVertexData.data();
+        }
+
+        // Create new vertex buffer, optionally with compact element types
+        const ea::vector<VertexElement>& elements = vertexBuffer->GetElements();
+        auto newVertexBuffer = MakeShared<VertexBuffer>(context);
+        newVertexBuffer->SetShadowed(true);
+        newVertexBuffer->SetSize(newNumVertices, elements);
+        newVertexBuffer->SetData(vertexData);
+
+        if (quantizeVertices)
+        {
+            const ea::vector<Vector4> unpackedData = newVertexBuffer->GetUnpackedData();
+            ea::vector<VertexElement> quantizedElements = elements;
+            bool quantized = false;
+            for (unsigned i = 0; i < quantizedElements.size(); ++i)
+            {
+                VertexElement& element = quantizedElements[i];
+                if ((element.semantic_ == SEM_NORMAL && element.type_ == TYPE_VECTOR3)
+                    || (element.semantic_ == SEM_TANGENT && element.type_ == TYPE_VECTOR4))
+                {
+                    element.type_ = TYPE_SHORT4_NORM;
+                    quantized = true;
+                }
+                else if (element.semantic_ == SEM_TEXCOORD && element.type_ == TYPE_VECTOR2)
+                {
+                    bool inRange = true;
+                    for (unsigned j = 0; j < newNumVertices && inRange; ++j)
+                    {
+                        const Vector4& value = unpackedData[j * elements.size() + i];
+                        inRange = Abs(value.x_) <= MAX_HALF_TEXCOORD && Abs(value.y_) <= MAX_HALF_TEXCOORD;
+                    }
+                    if (inRange)
+                    {
+                        element.type_ = TYPE_HALF2;
+                        quantized = true;
+                    }
+                }
+            }
+
+            if (quantized)
+            {
+                newVertexBuffer = MakeShared<VertexBuffer>(context);
+                newVertexBuffer->SetShadowed(true);
+                newVertexBuffer->SetSize(newNumVertices, quantizedElements);
+                newVertexBuffer->SetUnpackedData(unpackedData.data());
+            }
+        }
+
+        // Create new index buffer with LOD levels of all geometries
+        ea::vector<unsigned> newIndices;
+        for (const auto& geometryLods : lodIndices)
+        {
+            for (const ea::vector<unsigned>& indices : geometryLods)
+                newIndices.insert(newIndices.end(), indices.begin(), indices.end());
+        }
+
+        auto newIndexBuffer = MakeShared<IndexBuffer>(context);
+        newIndexBuffer->SetShadowed(true);
+        newIndexBuffer->SetSize(newIndices.size(), newNumVertices > 0xffff);
+        newIndexBuffer->SetUnpackedData(newIndices.data());
+
+        unsigned indexStart = 0;
+        for (unsigned i = 0; i < geometryIndices.size(); ++i)
+        {
+            // Cluster index ranges are relative to the first LOD level, which comes first in the new index buffer
+            for (GeometryCluster& cluster : geometryClusters[i])
+                cluster.indexStart_ += indexStart;
+            model->SetGeometryClusters(geometryIndices[i], geometryClusters[i]);
+
+            model->SetNumGeometryLodLevels(geometryIndices[i], lodIndices[i].size());
+            for (unsigned level = 0; level < lodIndices[i].size(); ++level)
+            {
+                const unsigned indexCount = lodIndices[i][level].size();
+                auto geometry = MakeShared<Geometry>(context);
+                geometry->SetNumVertexBuffers(1);
+                geometry->SetVertexBuffer(0, newVertexBuffer);
+                geometry->SetIndexBuffer(newIndexBuffer);
+                geometry->SetDrawRange(TRIANGLE_LIST, indexStart, indexCount);
+                geometry->SetLodDistance(lodDistances[i][level]);
+                geometry->SetRawVertexData(newVertexBuffer->GetShadowDataShared(), newVertexBuffer->GetElements());
+                geometry->SetRawIndexData(newIndexBuffer->GetShadowDataShared(), newIndexBuffer->GetIndexSize());
+                model->SetGeometry(geometryIndices[i], level, geometry);
+                indexStart += indexCount;
+            }
+        }
+
+        vertexBuffers[bufferIndex] = newVertexBuffer;
+        for (SharedPtr<IndexBuffer>& buffer : indexBuffers)
+        {
+            if (buffer == indexBuffer)
+                buffer = newIndexBuffer;
+        }
+        modified = true;
+    }
+
+    if (modified)
+    {
+        const ea::vector<unsigned> morphRangeStarts = model->GetMorphRangeStarts();
+        const ea::vector<unsigned> morphRangeCounts = model->GetMorphRangeCounts();
+        model->SetVertexBuffers(vertexBuffers, morphRangeStarts, morphRangeCounts);
+        model->SetIndexBuffers(indexBuffers);
+    }
+
+    return modified;
+}
+
+}
@@ -0,0 +1,79 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#pragma once
+
+#include "../Graphics/Model.h"
+
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+/// Model optimization settings.
+struct MeshOptimizationSettings
+{
+    /// Reorder triangles for post-transform vertex cache.
+    bool optimizeVertexCache_{true};
+    /// Reorder triangle clusters to reduce overdraw.
+    bool optimizeOverdraw_{true};
+    /// Maximum allowed ratio of vertex cache miss rate after overdraw optimization to the rate before it.
+    float overdrawThreshold_{1.05f};
+    /// Reorder vertices in order of first use and remove unused ones.
+    bool optimizeVertexFetch_{true};
+    /// Store normals and tangents as normalized shorts and texture coordinates as half floats.
+    bool quantizeVertices_{false};
+    /// Number of generated LOD levels. Geometries that already have LOD levels are left as is.
+    unsigned numLodLevels_{0};
+    /// Ratio of triangles kept by each LOD level relative to the previous one.
+    float lodReduction_{0.5f};
+    /// Maximum simplification error relative to the model bounding box size.
+    float lodMaxError_{0.05f};
+    /// Distance of the first LOD level, subsequent levels use its multiples. Zero means calculate from simplification error.
+    float lodDistance_{0.0f};
+    /// Simplification error in pixels at which LOD levels switch when LOD distances are calculated from error. Measured at the reference view of screen space LOD.
+    float lodPixelError_{1.0f};
+    /// Split the first LOD level of geometries into clusters for per-cluster culling.
+    bool generateClusters_{false};
+    /// Maximum number of vertices in a cluster.
+    unsigned clusterMaxVertices_{64};
+    /// Maximum number of triangles in a cluster.
+    unsigned clusterMaxTriangles_{124};
+};
+
+/// Reorder triangles of indexed triangle list for post-transform vertex cache using Tom Forsyth's algorithm.
+URHO3D_API void OptimizeVertexCache(unsigned indices[], unsigned numIndices, unsigned numVertices);
+/// Reorder vertex cache optimized triangle list so that outer triangle clusters are drawn first. Reordering is discarded if vertex cache miss rate grows more than threshold times.
+URHO3D_API void OptimizeOverdraw(unsigned indices[], unsigned numIndices, const Vector3 positions[], unsigned numVertices, float threshold);
+/// Return average number of vertex cache misses per triangle for FIFO cache of given size.
+URHO3D_API float CalculateVertexCacheMissRatio(const unsigned indices[], unsigned numIndices, unsigned numVertices, unsigned cacheSize = 16);
+/// Simplify indexed triangle list by collapsing edges in order of quadric error until target index count or maximum error is reached. No vertices are created. Open borders and attribute seams are preserved. Optionally return the largest error of applied collapses.
+URHO3D_API ea::vector<unsigned> SimplifyMesh(const unsigned indices[], unsigned numIndices, const Vector3 positions[], unsigned numVertices,
+    unsigned targetNumIndices, float maxError, float* resultError = nullptr);
+/// Split triangle list into clusters of consecutive triangles and calculate their bounds. Triangles are not reordered, so the list should be optimized for vertex cache first. Cluster index starts are relative to the list start.
+URHO3D_API ea::vector<GeometryCluster> GenerateClusters(const unsigned indices[], unsigned numIndices, const Vector3 positions[], unsigned numVertices,
+    unsigned maxVertices, unsigned maxTriangles);
+/// Optimize geometries of the model in place: reorder triangles and vertices, quantize vertex elements, generate LOD levels and clusters. Return true if the model was changed.
+URHO3D_API bool OptimizeModel(Model* model, const MeshOptimizationSettings& settings);
+
+}
@@ -25,6 +25,7 @@
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
 #include "../Graphics/Geometry.h"
+#include "../Graphics/GeometryPool.h"
 #include "../Graphics/IndexBuffer.h"
 #include "../Graphics/Model.h"
 #include "../Graphics/Graphics.h"
@@ -32,6 +33,7 @@
 #include "../IO/Log.h"
 #include "../IO/File.h"
 #include "../IO/FileSystem.h"
+#include "../IO/VectorBuffer.h"
 #include "../Resource/ResourceCache.h"
 #include "../Resource/XMLFile.h"
 
@@ -40,6 +42,27 @@
 namespace Urho3D
 {
 
+namespace
+{
+
+/// Skip the padding before aligned data in a cooked model file.
+void SkipAlignmentPadding(Deserializer& source)
+{
+    const unsigned position = source.GetPosition();
+    const unsigned alignedPosition = (position + MODEL_DATA_ALIGNMENT - 1) & ~(MODEL_DATA_ALIGNMENT - 1);
+    if (alignedPosition != position)
+        source.Seek(alignedPosition);
+}
+
+/// Write padding before aligned data in a cooked model file.
+void WriteAlignmentPadding(VectorBuffer& dest)
+{
+    while (dest.GetPosition() & (MODEL_DATA_ALIGNMENT - 1))
+        dest.WriteUByte(0);
+}
+
+}
+
 unsigned LookupVertexBuffer(VertexBuffer* buffer, const ea::vector<SharedPtr<VertexBuffer> >& buffers)
 {
     for (unsigned i = 0; i < buffers.size(); ++i)
@@ -65,7 +88,11 @@ Model::Model(Context* context) :
 {
 }
 
-Model::~Model() = default;
+Model::~Model()
+{
+    if (geometryPool_)
+        geometryPool_->RemoveModel(this);
+}
 
 void Model::RegisterObject(Context* context)
 {
@@ -76,24 +103,38 @@ bool Model::BeginLoad(Deserializer& source)
 {
     // Check ID
     ea::string fileID = source.ReadFileID();
-    if (fileID != "UMDL" && fileID != "UMD2")
+    if (fileID != "UMDL" && fileID != "UMD2" && fileID != "UMD3")
     {
         URHO3D_LOGERROR(source.GetName() + " is not a valid model file");
         return false;
     }
 
-    bool hasVertexDeclarations = (fileID == "UMD2");
+    bool hasVertexDeclarations = (fileID != "UMDL");
+    // Cooked models have the vertex and index data aligned, so that it can be used in place
+    bool hasAlignedData = (fileID == "UMD3");
 
     geometries_.clear();
     geometryBoneMappings_.clear();
     geometryCenters_.clear();
+    geometryClusters_.clear();
     morphs_.clear();
     vertexBuffers_.clear();
     indexBuffers_.clear();
+    loadSource_.Reset();
 
     unsigned memoryUse = sizeof(Model);
     bool async = GetAsyncLoadState() == ASYNC_LOADING;
 
+    // When background loading from a memory mapped file, keep the file open until EndLoad() and upload the vertex
+    // and index data from the mapping instead of copying it. Only files owned by a shared pointer can be kept open
+    const unsigned char* sourceData = nullptr;
+    auto* sourceFile = dynamic_cast<File*>(&source);
+    if (async && sourceFile && sourceFile->Refs() > 0 && sourceFile->GetMemoryData())
+    {
+        loadSource_ = sourceFile;
+        sourceData = sourceFile->GetMemoryData();
+    }
+
     // Read vertex buffers
     unsigned numVertexBuffers = source.ReadUInt();
     vertexBuffers_.reserve(numVertexBuffers);
@@ -131,8 +172,18 @@ bool Model::BeginLoad(Deserializer& source)
         unsigned vertexSize = VertexBuffer::GetVertexSize(desc.vertexElements_);
         desc.dataSize_ = desc.vertexCount_ * vertexSize;
 
+        if (hasAlignedData)
+            SkipAlignmentPadding(source);
+
         // Prepare vertex buffer data to be uploaded during EndLoad()
-        if (async)
+        desc.mappedData_ = nullptr;
+        if (async && sourceData && source.GetPosition() + desc.dataSize_ <= source.GetSize())
+        {
+            desc.data_.reset();
+            desc.mappedData_ = sourceData + source.GetPosition();
+            source.Seek(source.GetPosition() + desc.dataSize_);
+        }
+        else if (async)
         {
             desc.data_ = new unsigned char[desc.dataSize_];
             source.Read(desc.data_.get(), desc.dataSize_);
@@ -163,19 +214,33 @@ bool Model::BeginLoad(Deserializer& source)
 
         SharedPtr<IndexBuffer> buffer(context_->CreateObject<IndexBuffer>());
 
+        if (hasAlignedData)
+            SkipAlignmentPadding(source);
+
         // Prepare index buffer data to be uploaded during EndLoad()
+        IndexBufferDesc& desc = loadIBData_[i];
+        desc.mappedData_ = nullptr;
         if (async)
         {
-            loadIBData_[i].indexCount_ = indexCount;
-            loadIBData_[i].indexSize_ = indexSize;
-            loadIBData_[i].dataSize_ = indexCount * indexSize;
-            loadIBData_[i].data_ = new unsigned char[loadIBData_[i].dataSize_];
-            source.Read(loadIBData_[i].data_.get(), loadIBData_[i].dataSize_);
+            desc.indexCount_ = indexCount;
+            desc.indexSize_ = indexSize;
+            desc.dataSize_ = indexCount * indexSize;
+            if (sourceData && source.GetPosition() + desc.dataSize_ <= source.GetSize())
+            {
+                desc.data_.reset();
+                desc.mappedData_ = sourceData + source.GetPosition();
+                source.Seek(source.GetPosition() + desc.dataSize_);
+            }
+            else
+            {
+                desc.data_ = new unsigned char[desc.dataSize_];
+                source.Read(desc.data_.get(), desc.dataSize_);
+            }
         }
         else
         {
             // If not async loading, use locking to avoid extra allocation & copy
-            loadIBData_[i].data_.reset(); // Make sure no previous data
+            desc.data_.reset(); // Make sure no previous data
             buffer->SetShadowed(true);
             buffer->SetSize(indexCount, indexSize > sizeof(unsigned short));
             void* dest = buffer->Lock(0, indexCount);
@@ -198,9 +263,8 @@ bool Model::BeginLoad(Deserializer& source)
         // Read bone mappings
         unsigned boneMappingCount = source.ReadUInt();
         ea::vector<unsigned> boneMapping(boneMappingCount);
-        for (unsigned j = 0; j < boneMappingCount; ++j)
-            boneMapping[j] = source.ReadUInt();
-        geometryBoneMappings_.push_back(boneMapping);
+        source.Read(boneMapping.data(), boneMappingCount * sizeof(unsigned));
+        geometryBoneMappings_.push_back(ea::move(boneMapping));
 
         unsigned numLodLevels = source.ReadUInt();
         ea::vector<SharedPtr<Geometry> > geometryLodLevels;
@@ -223,6 +287,7 @@ bool Model::BeginLoad(Deserializer& source)
                 loadVBData_.clear();
                 loadIBData_.clear();
                 loadGeometries_.clear();
+                loadSource_.Reset();
                 return false;
             }
             if (ibRef >= indexBuffers_.size())
@@ -231,6 +296,7 @@ bool Model::BeginLoad(Deserializer& source)
                 loadVBData_.clear();
                 loadIBData_.clear();
                 loadGeometries_.clear();
+                loadSource_.Reset();
                 return false;
             }
 
@@ -307,6 +373,27 @@ bool Model::BeginLoad(Deserializer& source)
         geometryCenters_.push_back(Vector3::ZERO);
     memoryUse += sizeof(Vector3) * geometries_.size();
 
+    // Read optional triangle clusters
+    geometryClusters_.resize(geometries_.size());
+    if (!source.IsEof() && source.ReadFileID() == "CLST")
+    {
+        for (unsigned i = 0; i < geometries_.size(); ++i)
+        {
+            unsigned numClusters = source.ReadUInt();
+            geometryClusters_[i].resize(numClusters);
+            for (GeometryCluster& cluster : geometryClusters_[i])
+            {
+                cluster.indexStart_ = source.ReadUInt();
+                cluster.indexCount_ = source.ReadUInt();
+                cluster.boundingSphere_.center_ = source.ReadVector3();
+                cluster.boundingSphere_.radius_ = source.ReadFloat();
+                cluster.coneAxis_ = source.ReadVector3();
+                cluster.coneCutoff_ = source.ReadFloat();
+            }
+            memoryUse += sizeof(GeometryCluster) * numClusters;
+        }
+    }
+
     // Read metadata
     auto* cache = GetSubsystem<ResourceCache>();
     ea::string xmlName = ReplaceExtension(GetName(), ".xml");
@@ -325,11 +412,12 @@ bool Model::EndLoad()
     {
         VertexBuffer* buffer = vertexBuffers_[i];
         VertexBufferDesc& desc = loadVBData_[i];
-        if (desc.data_)
+        const unsigned char* data = desc.data_ ? desc.data_.get() : desc.mappedData_;
+        if (data)
         {
             buffer->SetShadowed(true);
             buffer->SetSize(desc.vertexCount_, desc.vertexElements_);
-            buffer->SetData(desc.data_.get());
+            buffer->SetData(data);
         }
     }
 
@@ -338,11 +426,12 @@ bool Model::EndLoad()
     {
         IndexBuffer* buffer = indexBuffers_[i];
         IndexBufferDesc& desc = loadIBData_[i];
-        if (desc.data_)
+        const unsigned char* data = desc.data_ ? desc.data_.get() : desc.mappedData_;
+        if (data)
         {
             buffer->SetShadowed(true);
             buffer->SetSize(desc.indexCount_, desc.indexSize_ > sizeof(unsigned short));
-            buffer->SetData(desc.data_.get());
+            buffer->SetData(data);
         }
     }
 
@@ -362,80 +451,94 @@ bool Model::EndLoad()
     loadVBData_.clear();
     loadIBData_.clear();
     loadGeometries_.clear();
+    loadSource_.Reset();
+
+    // Suballocate geometry into shared buffers if the geometry pool is in use
+    if (geometryPool_)
+        geometryPool_->RemoveModel(this);
+    auto* geometryPool = GetSubsystem<GeometryPool>();
+    if (geometryPool && geometryPool->AddModel(this))
+        geometryPool_ = geometryPool;
+    else
+        geometryPool_.Reset();
+
     return true;
 }
 
 bool Model::Save(Serializer& dest) const
 {
+    // Write to memory first, so that the vertex and index data can be aligned relative to the start of the file
+    VectorBuffer fileData;
+
     // Write ID
-    if (!dest.WriteFileID("UMD2"))
-        return false;
+    fileData.WriteFileID("UMD3");
 
     // Write vertex buffers
-    dest.WriteUInt(vertexBuffers_.size());
+    fileData.WriteUInt(vertexBuffers_.size());
     for (unsigned i = 0; i < vertexBuffers_.size(); ++i)
     {
         VertexBuffer* buffer = vertexBuffers_[i];
-        dest.WriteUInt(buffer->GetVertexCount());
+        fileData.WriteUInt(buffer->GetVertexCount());
         const ea::vector<VertexElement>& elements = buffer->GetElements();
-        dest.WriteUInt(elements.size());
+        fileData.WriteUInt(elements.size());
         for (unsigned j = 0; j < elements.size(); ++j)
         {
             unsigned elementDesc = ((unsigned)elements[j].type_) |
                 (((unsigned)elements[j].semantic_) << 8u) |
                 (((unsigned)elements[j].index_) << 16u);
-            dest.WriteUInt(elementDesc);
+            fileData.WriteUInt(elementDesc);
         }
-        dest.WriteUInt(morphRangeStarts_[i]);
-        dest.WriteUInt(morphRangeCounts_[i]);
-        dest.Write(buffer->GetShadowData(), buffer->GetVertexCount() * buffer->GetVertexSize());
+        fileData.WriteUInt(morphRangeStarts_[i]);
+        fileData.WriteUInt(morphRangeCounts_[i]);
+        WriteAlignmentPadding(fileData);
+        fileData.Write(buffer->GetShadowData(), buffer->GetVertexCount() * buffer->GetVertexSize());
     }
     // Write index buffers
-    dest.WriteUInt(indexBuffers_.size());
+    fileData.WriteUInt(indexBuffers_.size());
     for (unsigned i = 0; i < indexBuffers_.size(); ++i)
     {
         IndexBuffer* buffer = indexBuffers_[i];
-        dest.WriteUInt(buffer->GetIndexCount());
-        dest.WriteUInt(buffer->GetIndexSize());
-        dest.Write(buffer->GetShadowData(), buffer->GetIndexCount() * buffer->GetIndexSize());
+        fileData.WriteUInt(buffer->GetIndexCount());
+        fileData.WriteUInt(buffer->GetIndexSize());
+        WriteAlignmentPadding(fileData);
+        fileData.Write(buffer->GetShadowData(), buffer->GetIndexCount() * buffer->GetIndexSize());
     }
     // Write geometries
-    dest.WriteUInt(geometries_.size());
+    fileData.WriteUInt(geometries_.size());
     for (unsigned i = 0; i < geometries_.size(); ++i)
     {
         // Write bone mappings
-        dest.WriteUInt(geometryBoneMappings_[i].size());
-        for (unsigned j = 0; j < geometryBoneMappings_[i].size(); ++j)
-            dest.WriteUInt(geometryBoneMappings_[i][j]);
+        fileData.WriteUInt(geometryBoneMappings_[i].size());
+        fileData.Write(geometryBoneMappings_[i].data(), geometryBoneMappings_[i].size() * sizeof(unsigned));
 
         // Write the LOD levels
-        dest.WriteUInt(geometries_[i].size());
+        fileData.WriteUInt(geometries_[i].size());
         for (unsigned j = 0; j < geometries_[i].size(); ++j)
         {
             Geometry* geometry = geometries_[i][j];
-            dest.WriteFloat(geometry->GetLodDistance());
-            dest.WriteUInt(geometry->GetPrimitiveType());
-            dest.WriteUInt(LookupVertexBuffer(geometry->GetVertexBuffer(0), vertexBuffers_));
-            dest.WriteUInt(LookupIndexBuffer(geometry->GetIndexBuffer(), indexBuffers_));
-            dest.WriteUInt(geometry->GetIndexStart());
-            dest.WriteUInt(geometry->GetIndexCount());
+            fileData.WriteFloat(geometry->GetLodDistance());
+            fileData.WriteUInt(geometry->GetPrimitiveType());
+            fileData.WriteUInt(LookupVertexBuffer(geometry->GetVertexBuffer(0), vertexBuffers_));
+            fileData.WriteUInt(LookupIndexBuffer(geometry->GetIndexBuffer(), indexBuffers_));
+            fileData.WriteUInt(geometry->GetIndexStart());
+            fileData.WriteUInt(geometry->GetIndexCount());
         }
     }
 
     // Write morphs
-    dest.WriteUInt(morphs_.size());
+    fileData.WriteUInt(morphs_.size());
     for (unsigned i = 0; i < morphs_.size(); ++i)
     {
-        dest.WriteString(morphs_[i].name_);
-        dest.WriteUInt(morphs_[i].buffers_.size());
+        fileData.WriteString(morphs_[i].name_);
+        fileData.WriteUInt(morphs_[i].buffers_.size());
 
         // Write morph vertex buffers
         for (auto j = morphs_[i].buffers_.begin();
              j != morphs_[i].buffers_.end(); ++j)
         {
-            dest.WriteUInt(j->first);
-            dest.WriteUInt(j->second.elementMask_);
-            dest.WriteUInt(j->second.vertexCount_);
+            fileData.WriteUInt(j->first);
+            fileData.WriteUInt(j->second.elementMask_);
+            fileData.WriteUInt(j->second.vertexCount_);
 
             // Base size: size of each vertex index
             unsigned vertexSize = sizeof(unsigned);
@@ -447,19 +550,42 @@ bool Model::Save(Serializer& dest) const
             if (j->second.elementMask_ & MASK_TANGENT)
                 vertexSize += sizeof(Vector3);
 
-            dest.Write(j->second.morphData_.get(), vertexSize * j->second.vertexCount_);
+            fileData.Write(j->second.morphData_.get(), vertexSize * j->second.vertexCount_);
         }
     }
 
     // Write skeleton
-    skeleton_.Save(dest);
+    skeleton_.Save(fileData);
 
     // Write bounding box
-    dest.WriteBoundingBox(boundingBox_);
+    fileData.WriteBoundingBox(boundingBox_);
 
     // Write geometry centers
     for (unsigned i = 0; i < geometryCenters_.size(); ++i)
-        dest.WriteVector3(geometryCenters_[i]);
+        fileData.WriteVector3(geometryCenters_[i]);
+
+    // Write triangle clusters, older versions of the engine ignore them
+    if (HasGeometryClusters())
+    {
+        fileData.WriteFileID("CLST");
+        for (unsigned i = 0; i < geometries_.size(); ++i)
+        {
+            const ea::vector<GeometryCluster>& clusters = GetGeometryClusters(i);
+            fileData.WriteUInt(clusters.size());
+            for (const GeometryCluster& cluster : clusters)
+            {
+                fileData.WriteUInt(cluster.indexStart_);
+                fileData.WriteUInt(cluster.indexCount_);
+                fileData.WriteVector3(cluster.boundingSphere_.center_);
+                fileData.WriteFloat(cluster.boundingSphere_.radius_);
+                fileData.WriteVector3(cluster.coneAxis_);
+                fileData.WriteFloat(cluster.coneCutoff_);
+            }
+        }
+    }
+
+    if (dest.Write(fileData.GetData(), fileData.GetSize()) != fileData.GetSize())
+        return false;
 
     // Write metadata
     if (HasMetadata())
@@ -505,6 +631,11 @@ bool Model::SetVertexBuffers(const ea::vector<SharedPtr<VertexBuffer> >& buffers
         }
     }
 
+    if (geometryPool_)
+    {
+        geometryPool_->RemoveModel(this);
+        geometryPool_.Reset();
+    }
     vertexBuffers_ = buffers;
     morphRangeStarts_.resize(buffers.size());
     morphRangeCounts_.resize(buffers.size());
@@ -535,6 +666,11 @@ bool Model::SetIndexBuffers(const ea::vector<SharedPtr<IndexBuffer> >& buffers)
         }
     }
 
+    if (geometryPool_)
+    {
+        geometryPool_->RemoveModel(this);
+        geometryPool_.Reset();
+    }
     indexBuffers_ = buffers;
     return true;
 }
@@ -544,6 +680,7 @@ void Model::SetNumGeometries(unsigned num)
     geometries_.resize(num);
     geometryBoneMappings_.resize(num);
     geometryCenters_.resize(num);
+    geometryClusters_.resize(num);
 
     // For easier creation of from-scratch geometry, ensure that all geometries start with at least 1 LOD level (0 makes no sense)
     for (unsigned i = 0; i < geometries_.size(); ++i)
@@ -611,9 +748,27 @@ void Model::SetGeometryBoneMappings(const ea::vector<ea::vector<unsigned> >& geo
 
 void Model::SetMorphs(const ea::vector<ModelMorph>& morphs)
 {
+    if (geometryPool_)
+    {
+        geometryPool_->RemoveModel(this);
+        geometryPool_.Reset();
+    }
     morphs_ = morphs;
 }
 
+bool Model::SetGeometryClusters(unsigned index, const ea::vector<GeometryCluster>& clusters)
+{
+    if (index >= geometries_.size())
+    {
+        URHO3D_LOGERROR("Geometry index out of bounds");
+        return false;
+    }
+
+    geometryClusters_.resize(geometries_.size());
+    geometryClusters_[index] = clusters;
+    return true;
+}
+
 SharedPtr<Model> Model::Clone(const ea::string& cloneName) const
 {
     SharedPtr<Model> ret(context_->CreateObject<Model>());
@@ -623,6 +778,7 @@ SharedPtr<Model> Model::Clone(const ea::string& cloneName) const
     ret->skeleton_ = skeleton_;
     ret->geometryBoneMappings_ = geometryBoneMappings_;
     ret->geometryCenters_ = geometryCenters_;
+    ret->geometryClusters_ = geometryClusters_;
     ret->morphs_ = morphs_;
     ret->morphRangeStarts_ = morphRangeStarts_;
     ret->morphRangeCounts_ = morphRangeCounts_;
@@ -750,6 +906,22 @@ Geometry* Model::GetGeometry(unsigned index, unsigned lodLevel) const
     return geometries_[index][lodLevel];
 }
 
+const ea::vector<GeometryCluster>& Model::GetGeometryClusters(unsigned index) const
+{
+    static const ea::vector<GeometryCluster> emptyClusters;
+    return index < geometryClusters_.size() ? geometryClusters_[index] : emptyClusters;
+}
+
+bool Model::HasGeometryClusters() const
+{
+    for (const ea::vector<GeometryCluster>& clusters : geometryClusters_)
+    {
+        if (!clusters.empty())
+            return true;
+    }
+    return false;
+}
+
 const ModelMorph* Model::GetMorph(unsigned index) const
 {
     return index < morphs_.size() ? &morphs_[index] : nullptr;
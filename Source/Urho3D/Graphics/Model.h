@@ -28,16 +28,22 @@
 #include "../Graphics/GraphicsDefs.h"
 #include "../Graphics/Skeleton.h"
 #include "../Math/BoundingBox.h"
+#include "../Math/Sphere.h"
 #include "../Resource/Resource.h"
 
 namespace Urho3D
 {
 
+class File;
 class Geometry;
+class GeometryPool;
 class IndexBuffer;
 class Graphics;
 class VertexBuffer;
 
+/// Alignment of the vertex and index data in cooked model files.
+static const unsigned MODEL_DATA_ALIGNMENT = 16;
+
 /// Vertex buffer morph data.
 struct VertexBufferMorph
 {
@@ -76,6 +82,21 @@ struct ModelMorph
     ea::unordered_map<unsigned, VertexBufferMorph> buffers_;
 };
 
+/// Cluster of adjacent geometry triangles that can be culled separately.
+struct GeometryCluster
+{
+    /// Start of the cluster in the index buffer.
+    unsigned indexStart_{};
+    /// Number of indices in the cluster.
+    unsigned indexCount_{};
+    /// Bounding sphere in model space.
+    Sphere boundingSphere_;
+    /// Average direction of triangle normals.
+    Vector3 coneAxis_;
+    /// Sine of the normal cone half angle. Cluster faces away from the camera if dot(center - camera, axis) >= cutoff * |center - camera| + radius. Value 1 means the cluster is never back facing.
+    float coneCutoff_{ 1.0f };
+};
+
 /// Description of vertex buffer data for asynchronous loading.
 struct VertexBufferDesc
 {
@@ -87,6 +108,8 @@ struct VertexBufferDesc
     unsigned dataSize_;
     /// Vertex data.
     ea::shared_array<unsigned char> data_;
+    /// Vertex data used in place from a memory mapped file, if data_ is null.
+    const unsigned char* mappedData_{};
 };
 
 /// Description of index buffer data for asynchronous loading.
@@ -100,6 +123,8 @@ struct IndexBufferDesc
     unsigned dataSize_;
     /// Index data.
     ea::shared_array<unsigned char> data_;
+    /// Index data used in place from a memory mapped file, if data_ is null.
+    const unsigned char* mappedData_{};
 };
 
 /// Description of a geometry for asynchronous loading.
@@ -163,6 +188,8 @@ public:
     void SetGeometryBoneMappings(const ea::vector<ea::vector<unsigned> >& geometryBoneMappings);
     /// Set vertex morphs.
     void SetMorphs(const ea::vector<ModelMorph>& morphs);
+    /// Set triangle clusters of the first LOD level of a geometry.
+    bool SetGeometryClusters(unsigned index, const ea::vector<GeometryCluster>& clusters);
     /// Clone the model. The geometry data is deep-copied and can be modified in the clone without affecting the original.
     SharedPtr<Model> Clone(const ea::string& cloneName = EMPTY_STRING) const;
 
@@ -207,6 +234,11 @@ public:
     /// Return geometery bone mappings.
     const ea::vector<ea::vector<unsigned> >& GetGeometryBoneMappings() const { return geometryBoneMappings_; }
 
+    /// Return triangle clusters of the first LOD level of a geometry. Empty if the geometry is not clustered.
+    const ea::vector<GeometryCluster>& GetGeometryClusters(unsigned index) const;
+    /// Return whether any geometry has triangle clusters.
+    bool HasGeometryClusters() const;
+
     /// Return vertex morphs.
     const ea::vector<ModelMorph>& GetMorphs() const { return morphs_; }
 
@@ -246,6 +278,8 @@ private:
     ea::vector<ea::vector<unsigned> > geometryBoneMappings_;
     /// Geometry centers.
     ea::vector<Vector3> geometryCenters_;
+    /// Geometry triangle clusters.
+    ea::vector<ea::vector<GeometryCluster> > geometryClusters_;
     /// Vertex morphs.
     ea::vector<ModelMorph> morphs_;
     /// Vertex buffer morph range start.
@@ -258,6 +292,10 @@ private:
     ea::vector<IndexBufferDesc> loadIBData_;
     /// Geometry definitions for asynchronous loading.
     ea::vector<ea::vector<GeometryDesc> > loadGeometries_;
+    /// Memory mapped file that the vertex and index data for asynchronous loading is used from in place.
+    SharedPtr<File> loadSource_;
+    /// Geometry pool the model geometries are drawn from, if any.
+    WeakPtr<GeometryPool> geometryPool_;
 };
 
 }
@@ -29,6 +29,10 @@
 #include "../Graphics/OcclusionBuffer.h"
 #include "../IO/Log.h"
 
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#endif
+
 #include "../DebugNew.h"
 
 namespace Urho3D
@@ -45,6 +49,59 @@ enum ClipMask : unsigned
 };
 URHO3D_FLAGSET(ClipMask, ClipMaskFlags);
 
+/// Rasterize a horizontal span of depth values, keeping the closest value in each pixel.
+static inline void DrawDepthSpan(int* dest, int* end, int invZ, int dInvZdX)
+{
+#ifdef URHO3D_SSE
+    if (end - dest >= 4)
+    {
+        __m128i depth = _mm_setr_epi32(invZ, invZ + dInvZdX, invZ + 2 * dInvZdX, invZ + 3 * dInvZdX);
+        const __m128i step = _mm_set1_epi32(4 * dInvZdX);
+        while (end - dest >= 4)
+        {
+            __m128i old = _mm_loadu_si128(reinterpret_cast<__m128i*>(dest));
+            __m128i closer = _mm_cmplt_epi32(depth, old);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_or_si128(_mm_and_si128(closer, depth), _mm_andnot_si128(closer, old)));
+            depth = _mm_add_epi32(depth, step);
+            dest += 4;
+        }
+        invZ = _mm_cvtsi128_si32(depth);
+    }
+#endif
+
+    while (dest < end)
+    {
+        if (invZ < *dest)
+            *dest = invZ;
+        invZ += dInvZdX;
+        ++dest;
+    }
+}
+
+/// Return whether any depth value in a horizontal span is farther than or equal to the given depth.
+static inline bool IsSpanVisible(const int* src, const int* end, int z)
+{
+#ifdef URHO3D_SSE
+    const __m128i depth = _mm_set1_epi32(z - 1);
+    while (end - src >= 4)
+    {
+        // z <= value is equal to value > z - 1
+        __m128i visible = _mm_cmpgt_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)), depth);
+        if (_mm_movemask_epi8(visible))
+            return true;
+        src += 4;
+    }
+#endif
+
+    while (src < end)
+    {
+        if (z <= *src)
+            return true;
+        ++src;
+    }
+    return false;
+}
+
 void DrawOcclusionBatchWork(const WorkItem* item, unsigned threadIndex)
 {
     URHO3D_PROFILE("DrawOcclusionBatchWork");
@@ -448,14 +505,8 @@ bool OcclusionBuffer::IsVisible(const BoundingBox& worldSpaceBox) const
     int* endRow = buffers_[0].data_ + rect.bottom_ * width_;
     while (row <= endRow)
     {
-        int* src = row + rect.left_;
-        int* end = row + rect.right_;
-        while (src <= end)
-        {
-            if (z <= *src)
-                return true;
-            ++src;
-        }
+        if (IsSpanVisible(row + rect.left_, row + rect.right_ + 1, z))
+            return true;
         row += width_;
     }
 
@@ -911,13 +962,7 @@ void OcclusionBuffer::DrawTriangle2D(const Vector3* vertices, bool clockwise, un
                 int invZ = topToBottom.invZ_;
                 int* dest = row + (topToBottom.x_ >> 16u);
                 int* end = row + (topToMiddle.x_ >> 16u);
-                while (dest < end)
-                {
-                    if (invZ < *dest)
-                        *dest = invZ;
-                    invZ += gradients.dInvZdXInt_;
-                    ++dest;
-                }
+                DrawDepthSpan(dest, end, invZ, gradients.dInvZdXInt_);
 
                 topToBottom.x_ += topToBottom.xStep_;
                 topToBottom.invZ_ += topToBottom.invZStep_;
@@ -937,13 +982,7 @@ void OcclusionBuffer::DrawTriangle2D(const Vector3* vertices, bool clockwise, un
                 int invZ = topToBottom.invZ_;
                 int* dest = row + (topToBottom.x_ >> 16u);
                 int* end = row + (middleToBottom.x_ >> 16u);
-                while (dest < end)
-                {
-                    if (invZ < *dest)
-                        *dest = invZ;
-                    invZ += gradients.dInvZdXInt_;
-                    ++dest;
-                }
+                DrawDepthSpan(dest, end, invZ, gradients.dInvZdXInt_);
 
                 topToBottom.x_ += topToBottom.xStep_;
                 topToBottom.invZ_ += topToBottom.invZStep_;
@@ -965,13 +1004,7 @@ void OcclusionBuffer::DrawTriangle2D(const Vector3* vertices, bool clockwise, un
                 int invZ = topToMiddle.invZ_;
                 int* dest = row + (topToMiddle.x_ >> 16u);
                 int* end = row + (topToBottom.x_ >> 16u);
-                while (dest < end)
-                {
-                    if (invZ < *dest)
-                        *dest = invZ;
-                    invZ += gradients.dInvZdXInt_;
-                    ++dest;
-                }
+                DrawDepthSpan(dest, end, invZ, gradients.dInvZdXInt_);
 
                 topToMiddle.x_ += topToMiddle.xStep_;
                 topToMiddle.invZ_ += topToMiddle.invZStep_;
@@ -991,13 +1024,7 @@ void OcclusionBuffer::DrawTriangle2D(const Vector3* vertices, bool clockwise, un
                 int invZ = middleToBottom.invZ_;
                 int* dest = row + (middleToBottom.x_ >> 16u);
                 int* end = row + (topToBottom.x_ >> 16u);
-                while (dest < end)
-                {
-                    if (invZ < *dest)
-                        *dest = invZ;
-                    invZ += gradients.dInvZdXInt_;
-                    ++dest;
-                }
+                DrawDepthSpan(dest, end, invZ, gradients.dInvZdXInt_);
 
                 middleToBottom.x_ += middleToBottom.xStep_;
                 middleToBottom.invZ_ += middleToBottom.invZStep_;
@@ -1021,6 +1048,18 @@ void OcclusionBuffer::MergeBuffers()
         int* dest = buffers_[0].data_;
         int count = width_ * height_;
 
+#ifdef URHO3D_SSE
+        for (; count >= 4; count -= 4)
+        {
+            __m128i srcValue = _mm_loadu_si128(reinterpret_cast<__m128i*>(src));
+            __m128i destValue = _mm_loadu_si128(reinterpret_cast<__m128i*>(dest));
+            __m128i closer = _mm_cmplt_epi32(srcValue, destValue);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_or_si128(_mm_and_si128(closer, srcValue), _mm_andnot_si128(closer, destValue)));
+            src += 4;
+            dest += 4;
+        }
+#endif
+
         while (count--)
         {
             // If thread buffer's depth value is closer, overwrite the original
@@ -1041,6 +1080,15 @@ void OcclusionBuffer::ClearBuffer(unsigned threadIndex)
     int count = width_ * height_;
     auto fillValue = (int)OCCLUSION_Z_SCALE;
 
+#ifdef URHO3D_SSE
+    const __m128i fill = _mm_set1_epi32(fillValue);
+    for (; count >= 4; count -= 4)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), fill);
+        dest += 4;
+    }
+#endif
+
     while (count--)
         *dest++ = fillValue;
 }
@@ -29,6 +29,7 @@
 #include "../Core/Profiler.h"
 #include "../Core/Thread.h"
 #include "../Core/WorkQueue.h"
+#include "../Graphics/AnimationPoseCache.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Octree.h"
@@ -150,21 +151,10 @@ static const int DEFAULT_OCTREE_LEVELS = 8;
 
 extern const char* SUBSYSTEM_CATEGORY;
 
-void UpdateDrawablesWork(const WorkItem* item, unsigned threadIndex)
-{
-    URHO3D_PROFILE("UpdateDrawablesWork");
-    const FrameInfo& frame = *(reinterpret_cast<FrameInfo*>(item->aux_));
-    auto** start = reinterpret_cast<Drawable**>(item->start_);
-    auto** end = reinterpret_cast<Drawable**>(item->end_);
-
-    while (start != end)
-    {
-        Drawable* drawable = *start;
-        if (drawable)
-            drawable->Update(frame);
-        ++start;
-    }
-}
+/// Number of drawables updated per work queue batch.
+static const unsigned DRAWABLE_UPDATE_BATCH_SIZE = 8;
+/// Maximum number of removed drawable bounds kept between updates before they are merged.
+static const unsigned MAX_PENDING_CHANGED_BOXES = 256;
 
 inline bool CompareRayQueryResults(const RayQueryResult& lhs, const RayQueryResult& rhs)
 {
@@ -188,6 +178,7 @@ Octant::~Octant()
         for (auto i = drawables_.begin(); i != drawables_.end(); ++i)
         {
             (*i)->SetOctant(root_);
+            (*i)->octantIndex_ = root_->drawables_.size();
             root_->drawables_.push_back(*i);
             root_->QueueUpdate(*i);
         }
@@ -252,9 +243,10 @@ void Octant::InsertDrawable(Drawable* drawable)
         if (oldOctant != this)
         {
             // Add first, then remove, because drawable count going to zero deletes the octree branch in question
+            const unsigned oldIndex = drawable->octantIndex_;
             AddDrawable(drawable);
             if (oldOctant)
-                oldOctant->RemoveDrawable(drawable, false);
+                oldOctant->RemoveDrawableAt(oldIndex);
         }
     }
     else
@@ -298,7 +290,10 @@ void Octant::ResetRoot()
 
     // The whole octree is being destroyed, just detach the drawables
     for (auto i = drawables_.begin(); i != drawables_.end(); ++i)
+    {
         (*i)->SetOctant(nullptr);
+        (*i)->octantIndex_ = M_MAX_UNSIGNED;
+    }
 
     for (auto& child : children_)
     {
@@ -414,7 +409,8 @@ void Octant::GetDrawablesOnlyInternal(RayOctreeQuery& query, ea::vector<Drawable
 Octree::Octree(Context* context) :
     Component(context),
     Octant(BoundingBox(-DEFAULT_OCTREE_SIZE, DEFAULT_OCTREE_SIZE), 0, nullptr, this),
-    numLevels_(DEFAULT_OCTREE_LEVELS)
+    numLevels_(DEFAULT_OCTREE_LEVELS),
+    animationPoseCache_(ea::make_unique<AnimationPoseCache>())
 {
     // If the engine is running headless, subscribe to RenderUpdate events for manually updating the octree
     // to allow raycasts and animation update
@@ -472,6 +468,13 @@ void Octree::Update(const FrameInfo& frame)
         return;
     }
 
+    // Poses are only shared within a frame
+    animationPoseCache_->Clear();
+
+    // Changes are tracked per update, starting from the drawables removed since the last one
+    changedBoxes_.swap(pendingChangedBoxes_);
+    pendingChangedBoxes_.clear();
+
     // Let drawables update themselves before reinsertion. This can be used for animation
     if (!drawableUpdates_.empty())
     {
@@ -483,30 +486,19 @@ void Octree::Update(const FrameInfo& frame)
         auto* queue = GetSubsystem<WorkQueue>();
         scene->BeginThreadedUpdate();
 
-        int numWorkItems = queue->GetNumThreads() + 1; // Worker threads + main thread
-        int drawablesPerItem = Max((int)(drawableUpdates_.size() / numWorkItems), 1);
-
-        auto start = drawableUpdates_.begin();
-        // Create a work item for each thread
-        for (int i = 0; i < numWorkItems; ++i)
+        // Update cost varies a lot between drawables (for example animated models), so let idle threads claim
+        // small batches instead of splitting the list evenly
+        queue->ParallelFor(drawableUpdates_.size(), DRAWABLE_UPDATE_BATCH_SIZE,
+            [this, &frame](unsigned begin, unsigned end, unsigned /*threadIndex*/)
         {
-            SharedPtr<WorkItem> item = queue->GetFreeItem();
-            item->priority_ = M_MAX_UNSIGNED;
-            item->workFunction_ = UpdateDrawablesWork;
-            item->aux_ = const_cast<FrameInfo*>(&frame);
-
-            auto end = drawableUpdates_.end();
-            if (i < numWorkItems - 1 && end - start > drawablesPerItem)
-                end = start + drawablesPerItem;
-
-            item->start_ = &(*start);
-            item->end_ = &(*end);
-            queue->AddWorkItem(item);
-
-            start = end;
-        }
-
-        queue->Complete(M_MAX_UNSIGNED);
+            URHO3D_PROFILE("UpdateDrawablesWork");
+            for (unsigned i = begin; i < end; ++i)
+            {
+                Drawable* drawable = drawableUpdates_[i];
+                if (drawable)
+                    drawable->Update(frame);
+            }
+        });
         scene->EndThreadedUpdate();
     }
 
@@ -553,6 +545,7 @@ void Octree::Update(const FrameInfo& frame)
             drawable->updateQueued_ = false;
             Octant* octant = drawable->GetOctant();
             const BoundingBox& box = drawable->GetWorldBoundingBox();
+            changedBoxes_.push_back(box);
 
             // Skip if no octant or does not belong to this octree anymore
             if (!octant || octant->GetRoot() != this)
@@ -561,7 +554,16 @@ void Octree::Update(const FrameInfo& frame)
             if (drawable->IsOccludee() && octant->GetCullingBox().IsInside(box) == INSIDE && octant->CheckDrawableFit(box))
                 continue;
 
-            InsertDrawable(drawable);
+            // Reinsert starting from the closest ancestor that still encloses the drawable instead of the root.
+            // Non-occludees are always kept at the root, so they go through the full insertion
+            Octant* insertionOctant = this;
+            if (drawable->IsOccludee())
+            {
+                insertionOctant = octant;
+                while (insertionOctant != this && insertionOctant->GetCullingBox().IsInside(box) != INSIDE)
+                    insertionOctant = insertionOctant->GetParent();
+            }
+            insertionOctant->InsertDrawable(drawable);
 
 #ifdef _DEBUG
             // Verify that the drawable will be culled correctly
@@ -680,6 +682,25 @@ void Octree::QueueUpdate(Drawable* drawable)
     drawable->updateQueued_ = true;
 }
 
+void Octree::MarkRemoved(const BoundingBox& box)
+{
+    // If the octree is not being updated, coarsen instead of accumulating boxes without bound
+    if (pendingChangedBoxes_.size() >= MAX_PENDING_CHANGED_BOXES)
+        pendingChangedBoxes_.back().Merge(box);
+    else
+        pendingChangedBoxes_.push_back(box);
+}
+
+bool Octree::HasChangesInside(const Sphere& sphere) const
+{
+    for (const BoundingBox& box : changedBoxes_)
+    {
+        if (sphere.IsInsideFast(box) != OUTSIDE)
+            return true;
+    }
+    return false;
+}
+
 void Octree::CancelUpdate(Drawable* drawable)
 {
     // This doesn't have to take into account scene being in threaded update, because it is called only
@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include <EASTL/unique_ptr.h>
+
 #include "../Core/Mutex.h"
 #include "../Graphics/Drawable.h"
 #include "../Graphics/OctreeQuery.h"
@@ -29,6 +31,7 @@
 namespace Urho3D
 {
 
+class AnimationPoseCache;
 class Octree;
 class Skybox;
 class Zone;
@@ -59,6 +62,7 @@ public:
     void AddDrawable(Drawable* drawable)
     {
         drawable->SetOctant(this);
+        drawable->octantIndex_ = drawables_.size();
         drawables_.push_back(drawable);
         IncDrawableCount();
     }
@@ -66,13 +70,15 @@ public:
     /// Remove a drawable object from this octant.
     void RemoveDrawable(Drawable* drawable, bool resetOctant = true)
     {
-        auto it = drawables_.find(drawable);
-        if (it != drawables_.end())
+        const unsigned index = drawable->octantIndex_;
+        if (index < drawables_.size() && drawables_[index] == drawable)
         {
-            drawables_.erase(it);
             if (resetOctant)
+            {
                 drawable->SetOctant(nullptr);
-            DecDrawableCount();
+                drawable->octantIndex_ = M_MAX_UNSIGNED;
+            }
+            RemoveDrawableAt(index);
         }
     }
 
@@ -114,6 +120,16 @@ protected:
     /// Return drawable objects only for a threaded ray query, called internally.
     void GetDrawablesOnlyInternal(RayOctreeQuery& query, ea::vector<Drawable*>& drawables) const;
 
+    /// Remove drawable object at given index in O(1) by moving the last drawable into its place.
+    void RemoveDrawableAt(unsigned index)
+    {
+        Drawable* lastDrawable = drawables_.back();
+        drawables_[index] = lastDrawable;
+        lastDrawable->octantIndex_ = index;
+        drawables_.pop_back();
+        DecDrawableCount();
+    }
+
     /// Increase drawable object count recursively.
     void IncDrawableCount()
     {
@@ -205,10 +221,18 @@ public:
     /// @property
     unsigned GetNumLevels() const { return numLevels_; }
 
+    /// Return per-frame cache of animation poses shared by the animated models.
+    /// @nobind
+    AnimationPoseCache* GetAnimationPoseCache() const { return animationPoseCache_.get(); }
+
     /// Mark drawable object as requiring an update and a reinsertion.
     void QueueUpdate(Drawable* drawable);
     /// Cancel drawable object's update.
     void CancelUpdate(Drawable* drawable);
+    /// Record the bounds of a drawable removed from the octree as a change for the next update. Called by Drawable.
+    void MarkRemoved(const BoundingBox& box);
+    /// Return whether drawables were updated, moved, added or removed within a sphere during the last update.
+    bool HasChangesInside(const Sphere& sphere) const;
     /// Visualize the component as debug geometry.
     void DrawDebugGeometry(bool depthTest);
 
@@ -222,12 +246,18 @@ private:
     ea::vector<Drawable*> drawableUpdates_;
     /// Drawable objects that were inserted during threaded update phase.
     ea::vector<Drawable*> threadedDrawableUpdates_;
+    /// Bounds of the drawables changed during the last update.
+    ea::vector<BoundingBox> changedBoxes_;
+    /// Bounds of the drawables removed since the last update.
+    ea::vector<BoundingBox> pendingChangedBoxes_;
     /// Mutex for octree reinsertions.
     Mutex octreeMutex_;
     /// Ray query temporary list of drawables.
     mutable ea::vector<Drawable*> rayQueryDrawables_;
     /// Subdivision level.
     unsigned numLevels_;
+    /// Per-frame cache of animation poses.
+    ea::unique_ptr<AnimationPoseCache> animationPoseCache_;
 };
 
 }
@@ -105,19 +105,12 @@ Intersection FrustumOctreeQuery::TestOctant(const BoundingBox& box, bool inside)
 
 void FrustumOctreeQuery::TestDrawables(Drawable** start, Drawable** end, bool inside)
 {
-    while (start != end)
+    TestDrawablesBatched(start, end, inside, [this](Drawable* drawable)
     {
-        Drawable* drawable = *start++;
-
-        if ((drawable->GetDrawableFlags() & drawableFlags_) && (drawable->GetViewMask() & viewMask_))
-        {
-            if (inside || frustum_.IsInsideFast(drawable->GetWorldBoundingBox()))
-                result_.push_back(drawable);
-        }
-    }
+        return (drawable->GetDrawableFlags() & drawableFlags_) && (drawable->GetViewMask() & viewMask_);
+    });
 }
 
-
 Intersection AllContentOctreeQuery::TestOctant(const BoundingBox& box, bool inside)
 {
     return INSIDE;
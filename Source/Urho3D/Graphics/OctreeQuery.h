@@ -151,6 +151,52 @@ public:
 
     /// Frustum.
     Frustum frustum_;
+
+protected:
+    /// Test drawables that pass the filter against the frustum four bounding boxes at a time.
+    template <class T> void TestDrawablesBatched(Drawable** start, Drawable** end, bool inside, const T& filter)
+    {
+        if (inside)
+        {
+            while (start != end)
+            {
+                Drawable* drawable = *start++;
+                if (filter(drawable))
+                    result_.push_back(drawable);
+            }
+            return;
+        }
+
+        Drawable* candidates[4];
+        const BoundingBox* boxes[4];
+        unsigned numCandidates = 0;
+
+        while (start != end)
+        {
+            Drawable* drawable = *start++;
+            if (!filter(drawable))
+                continue;
+
+            candidates[numCandidates] = drawable;
+            boxes[numCandidates] = &drawable->GetWorldBoundingBox();
+            if (++numCandidates == 4)
+            {
+                const unsigned mask = frustum_.IsInsideFast4(boxes);
+                for (unsigned i = 0; i < 4; ++i)
+                {
+                    if (mask & (1u << i))
+                        result_.push_back(candidates[i]);
+                }
+                numCandidates = 0;
+            }
+        }
+
+        for (unsigned i = 0; i < numCandidates; ++i)
+        {
+            if (frustum_.IsInsideFast(*boxes[i]))
+                result_.push_back(candidates[i]);
+        }
+    }
 };
 
 /// General octree query result. Used for Lua bindings only.
@@ -94,6 +94,7 @@ void ConstantBuffer::Apply()
         graphics_->SetUBO(object_.name_);
         glBufferData(GL_UNIFORM_BUFFER, size_, shadowData_.get(), GL_DYNAMIC_DRAW);
 #endif
+        graphics_->AddUploadedBytes(size_);
         dirty_ = false;
     }
 }
@@ -26,6 +26,7 @@
 #include "../../Core/Mutex.h"
 #include "../../Core/ProcessUtils.h"
 #include "../../Core/Profiler.h"
+#include "../../Core/Timer.h"
 #include "../../Graphics/ConstantBuffer.h"
 #include "../../Graphics/Graphics.h"
 #include "../../Graphics/GraphicsEvents.h"
@@ -162,6 +163,9 @@ extern "C"
 namespace Urho3D
 {
 
+/// Size of the uniform buffer that constant buffer data is suballocated from. It is orphaned and refilled when full.
+static const unsigned UNIFORM_RING_BUFFER_SIZE = 4 * 1024 * 1024;
+
 static const unsigned glCmpFunc[] =
 {
     GL_ALWAYS,
@@ -230,6 +234,13 @@ static const unsigned glStencilOps[] =
 };
 #endif
 
+#if defined(GL_ES_VERSION_2_0) && !defined(GL_ES_VERSION_3_0)
+// Requires OES_vertex_half_float
+static const unsigned glHalfFloatType = GL_HALF_FLOAT_OES;
+#else
+static const unsigned glHalfFloatType = GL_HALF_FLOAT;
+#endif
+
 static const unsigned glElementTypes[] =
 {
     GL_INT,
@@ -238,7 +249,10 @@ static const unsigned glElementTypes[] =
     GL_FLOAT,
     GL_FLOAT,
     GL_UNSIGNED_BYTE,
-    GL_UNSIGNED_BYTE
+    GL_UNSIGNED_BYTE,
+    glHalfFloatType,
+    glHalfFloatType,
+    GL_SHORT
 };
 
 static const unsigned glElementComponents[] =
@@ -249,6 +263,9 @@ static const unsigned glElementComponents[] =
     3,
     4,
     4,
+    4,
+    2,
+    4,
     4
 };
 
@@ -330,6 +347,9 @@ Graphics::Graphics(Context* context) :
 
 Graphics::~Graphics()
 {
+    // Drop uploads that were never executed, releasing their owners while the graphics context still exists
+    queuedUploads_.clear();
+
     Close();
 
     delete impl_;
@@ -631,6 +651,18 @@ bool Graphics::BeginFrame()
 
     numPrimitives_ = 0;
     numBatches_ = 0;
+    frameStatistics_ = DrawCallStatistics();
+
+#ifndef GL_ES_VERSION_2_0
+    // Skip measuring when the GPU is so far behind that all queries are still in flight
+    if (gpuFrameTimingSupport_ && !impl_->gpuFrameQueryPending_[impl_->gpuFrameQueryIndex_])
+    {
+        if (!impl_->gpuFrameQueries_[0])
+            glGenQueries(NUM_GPU_FRAME_QUERIES, impl_->gpuFrameQueries_);
+        glBeginQuery(GL_TIME_ELAPSED, impl_->gpuFrameQueries_[impl_->gpuFrameQueryIndex_]);
+        impl_->gpuFrameQueryActive_ = true;
+    }
+#endif
 
     SendEvent(E_BEGINRENDERING);
 
@@ -646,8 +678,51 @@ void Graphics::EndFrame()
 
     SendEvent(E_ENDRENDERING);
 
+#ifndef GL_ES_VERSION_2_0
+    if (impl_->gpuFrameQueryActive_)
+    {
+        glEndQuery(GL_TIME_ELAPSED);
+        impl_->gpuFrameQueryPending_[impl_->gpuFrameQueryIndex_] = true;
+        impl_->gpuFrameQueryIndex_ = (impl_->gpuFrameQueryIndex_ + 1) % NUM_GPU_FRAME_QUERIES;
+        impl_->gpuFrameQueryActive_ = false;
+    }
+#endif
+
     SDL_GL_SwapWindow(window_);
 
+#ifndef GL_ES_VERSION_2_0
+    // Read back finished frame time queries from oldest to newest without waiting for the GPU
+    for (unsigned i = 0; i < NUM_GPU_FRAME_QUERIES; ++i)
+    {
+        const unsigned index = (impl_->gpuFrameQueryIndex_ + i) % NUM_GPU_FRAME_QUERIES;
+        if (!impl_->gpuFrameQueryPending_[index])
+            continue;
+
+        GLint available = 0;
+        glGetQueryObjectiv(impl_->gpuFrameQueries_[index], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            break;
+
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(impl_->gpuFrameQueries_[index], GL_QUERY_RESULT, &elapsed);
+        gpuFrameTime_ = static_cast<float>(elapsed / 1000000.0);
+        impl_->gpuFrameQueryPending_[index] = false;
+    }
+#endif
+
+#ifdef URHO3D_GPU_PROFILING
+    if (gpuZoneDepth_ != 0)
+    {
+        URHO3D_LOGWARNING("GPU timing zones were not ended before EndFrame");
+        while (gpuZoneDepth_ != 0)
+            EndGPUZone();
+    }
+    if (gpuProfilingSupport_)
+        TracyGpuCollect;
+#endif
+
+    UpdateTextureReadbacks();
+
     // Clean up too large scratch buffers
     CleanupScratchBuffers();
 
@@ -662,6 +737,93 @@ void Graphics::EndFrame()
     }
 }
 
+void Graphics::BeginGPUZone(const char* name)
+{
+#ifdef URHO3D_GPU_PROFILING
+    if (gpuZoneDepth_ < MAX_GPU_ZONE_DEPTH)
+    {
+        impl_->gpuZones_[gpuZoneDepth_].emplace(__LINE__, __FILE__, strlen(__FILE__), __FUNCTION__, strlen(__FUNCTION__),
+            name, strlen(name), gpuProfilingSupport_);
+    }
+    ++gpuZoneDepth_;
+#endif
+}
+
+void Graphics::EndGPUZone()
+{
+#ifdef URHO3D_GPU_PROFILING
+    if (gpuZoneDepth_ == 0)
+    {
+        URHO3D_LOGERROR("EndGPUZone called without matching BeginGPUZone");
+        return;
+    }
+
+    --gpuZoneDepth_;
+    if (gpuZoneDepth_ < MAX_GPU_ZONE_DEPTH)
+        impl_->gpuZones_[gpuZoneDepth_].reset();
+#endif
+}
+
+void Graphics::UpdateTextureReadbacks()
+{
+#ifndef GL_ES_VERSION_2_0
+    ea::vector<PendingTextureReadback>& readbacks = impl_->pendingTextureReadbacks_;
+    for (unsigned i = 0; i < readbacks.size();)
+    {
+        PendingTextureReadback& readback = readbacks[i];
+        const GLenum status = glClientWaitSync(readback.fence_, 0, 0);
+        if (status == GL_TIMEOUT_EXPIRED)
+        {
+            ++i;
+            continue;
+        }
+
+        ea::vector<unsigned char> data;
+        if (status != GL_WAIT_FAILED)
+        {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer_);
+            const void* mappedData = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, readback.size_, GL_MAP_READ_BIT);
+            if (mappedData)
+            {
+                data.resize(readback.size_);
+                memcpy(data.data(), mappedData, readback.size_);
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            }
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        }
+
+        glDeleteSync(readback.fence_);
+        glDeleteBuffers(1, &readback.buffer_);
+
+        // Remove before invoking, the callback may start new readbacks
+        TextureReadbackCallback callback = ea::move(readback.callback_);
+        readbacks.erase(readbacks.begin() + i);
+        if (callback)
+            callback(data);
+    }
+#endif
+}
+
+void Graphics::CleanupTextureReadbacks()
+{
+#ifndef GL_ES_VERSION_2_0
+    ea::vector<PendingTextureReadback> readbacks = ea::move(impl_->pendingTextureReadbacks_);
+    impl_->pendingTextureReadbacks_.clear();
+
+    const ea::vector<unsigned char> emptyData;
+    for (PendingTextureReadback& readback : readbacks)
+    {
+        if (!IsDeviceLost())
+        {
+            glDeleteSync(readback.fence_);
+            glDeleteBuffers(1, &readback.buffer_);
+        }
+        if (readback.callback_)
+            readback.callback_(emptyData);
+    }
+#endif
+}
+
 void Graphics::Clear(ClearTargetFlags flags, const Color& color, float depth, unsigned stencil)
 {
     PrepareDraw();
@@ -881,6 +1043,8 @@ void Graphics::Draw(PrimitiveType type, unsigned vertexStart, unsigned vertexCou
 
     numPrimitives_ += primitiveCount;
     ++numBatches_;
+    ++frameStatistics_.numDraws_;
+    frameStatistics_.numPrimitives_ += primitiveCount;
 }
 
 void Graphics::Draw(PrimitiveType type, unsigned indexStart, unsigned indexCount, unsigned minVertex, unsigned vertexCount)
@@ -900,6 +1064,8 @@ void Graphics::Draw(PrimitiveType type, unsigned indexStart, unsigned indexCount
 
     numPrimitives_ += primitiveCount;
     ++numBatches_;
+    ++frameStatistics_.numDraws_;
+    frameStatistics_.numPrimitives_ += primitiveCount;
 }
 
 void Graphics::Draw(PrimitiveType type, unsigned indexStart, unsigned indexCount, unsigned baseVertexIndex, unsigned minVertex, unsigned vertexCount)
@@ -920,6 +1086,8 @@ void Graphics::Draw(PrimitiveType type, unsigned indexStart, unsigned indexCount
 
     numPrimitives_ += primitiveCount;
     ++numBatches_;
+    ++frameStatistics_.numDraws_;
+    frameStatistics_.numPrimitives_ += primitiveCount;
 #endif
 }
 
@@ -956,6 +1124,10 @@ void Graphics::DrawInstanced(PrimitiveType type, unsigned indexStart, unsigned i
 
     numPrimitives_ += instanceCount * primitiveCount;
     ++numBatches_;
+    ++frameStatistics_.numDraws_;
+    ++frameStatistics_.numInstancedDraws_;
+    frameStatistics_.numInstances_ += instanceCount;
+    frameStatistics_.numPrimitives_ += instanceCount * primitiveCount;
 #endif
 }
 
@@ -980,6 +1152,10 @@ void Graphics::DrawInstanced(PrimitiveType type, unsigned indexStart, unsigned i
 
     numPrimitives_ += instanceCount * primitiveCount;
     ++numBatches_;
+    ++frameStatistics_.numDraws_;
+    ++frameStatistics_.numInstancedDraws_;
+    frameStatistics_.numInstances_ += instanceCount;
+    frameStatistics_.numPrimitives_ += instanceCount * primitiveCount;
 #endif
 }
 
@@ -1043,6 +1219,8 @@ void Graphics::SetShaders(ShaderVariation* vs, ShaderVariation* ps)
     if (vs == vertexShader_ && ps == pixelShader_)
         return;
 
+    ++frameStatistics_.numShaderChanges_;
+
     // Compile the shaders now if not yet compiled. If already attempted, do not retry
     if (vs && !vs->GetGPUObjectName())
     {
@@ -1050,7 +1228,11 @@ void Graphics::SetShaders(ShaderVariation* vs, ShaderVariation* ps)
         {
             URHO3D_PROFILE("CompileVertexShader");
 
+            HiresTimer compileTimer;
             bool success = vs->Create();
+            ++frameStatistics_.numShaderCompiles_;
+            if (shaderPrecache_)
+                shaderPrecache_->StoreCompileTime(vs, compileTimer.GetUSec(false));
             if (success)
                 URHO3D_LOGDEBUG("Compiled vertex shader " + vs->GetFullName());
             else
@@ -1069,7 +1251,11 @@ void Graphics::SetShaders(ShaderVariation* vs, ShaderVariation* ps)
         {
             URHO3D_PROFILE("CompilePixelShader");
 
+            HiresTimer compileTimer;
             bool success = ps->Create();
+            ++frameStatistics_.numShaderCompiles_;
+            if (shaderPrecache_)
+                shaderPrecache_->StoreCompileTime(ps, compileTimer.GetUSec(false));
             if (success)
                 URHO3D_LOGDEBUG("Compiled pixel shader " + ps->GetFullName());
             else
@@ -1146,11 +1332,9 @@ void Graphics::SetShaders(ShaderVariation* vs, ShaderVariation* ps)
             ConstantBuffer* buffer = constantBuffers[i];
             if (buffer != impl_->constantBuffers_[i])
             {
-                unsigned object = buffer ? buffer->GetGPUObjectName() : 0;
-                glBindBufferBase(GL_UNIFORM_BUFFER, i, object);
-                // Calling glBindBufferBase also affects the generic buffer binding point
-                impl_->boundUBO_ = object;
+                // The buffer range is bound from the uniform ring buffer when the data is uploaded before drawing
                 impl_->constantBuffers_[i] = buffer;
+                impl_->constantBufferRangesDirty_[i] = true;
                 ShaderProgram::ClearGlobalParameterSource((ShaderParameterGroup)(i % MAX_SHADER_PARAMETER_GROUPS));
             }
         }
@@ -1570,6 +1754,7 @@ void Graphics::SetTexture(unsigned index, Texture* texture)
         }
 
         textures_[index] = texture;
+        ++frameStatistics_.numTextureChanges_;
     }
     else
     {
@@ -1787,6 +1972,7 @@ void Graphics::SetBlendMode(BlendMode mode, bool alphaToCoverage)
         }
 
         blendMode_ = mode;
+        ++frameStatistics_.numStateChanges_;
     }
 
     if (alphaToCoverage != alphaToCoverage_)
@@ -1810,6 +1996,7 @@ void Graphics::SetColorWrite(bool enable)
             glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
 
         colorWrite_ = enable;
+        ++frameStatistics_.numStateChanges_;
     }
 }
 
@@ -1827,6 +2014,7 @@ void Graphics::SetCullMode(CullMode mode)
         }
 
         cullMode_ = mode;
+        ++frameStatistics_.numStateChanges_;
     }
 }
 
@@ -1858,6 +2046,7 @@ void Graphics::SetDepthTest(CompareMode mode)
     {
         glDepthFunc(glCmpFunc[mode]);
         depthTestMode_ = mode;
+        ++frameStatistics_.numStateChanges_;
     }
 }
 
@@ -1867,6 +2056,7 @@ void Graphics::SetDepthWrite(bool enable)
     {
         glDepthMask(enable ? GL_TRUE : GL_FALSE);
         depthWrite_ = enable;
+        ++frameStatistics_.numStateChanges_;
     }
 }
 
@@ -2027,6 +2217,7 @@ void Graphics::SetStencilTest(bool enable, CompareMode mode, StencilOp pass, Ste
         else
             glDisable(GL_STENCIL_TEST);
         stencilTest_ = enable;
+        ++frameStatistics_.numStateChanges_;
     }
 
     if (enable)
@@ -2151,6 +2342,15 @@ bool Graphics::GetGL3Support()
     return gl3Support;
 }
 
+bool Graphics::GetBaseVertexSupport()
+{
+#ifndef GL_ES_VERSION_2_0
+    return gl3Support;
+#else
+    return false;
+#endif
+}
+
 ShaderVariation* Graphics::GetShader(ShaderType type, const ea::string& name, const ea::string& defines) const
 {
     return GetShader(type, name.c_str(), defines.c_str());
@@ -2412,8 +2612,19 @@ void Graphics::Release(bool clearGPUObjects, bool closeWindow)
     }
 
     CleanupFramebuffers();
+    CleanupTextureReadbacks();
     impl_->depthTextures_.clear();
 
+#ifndef GL_ES_VERSION_2_0
+    if (impl_->uniformRingBuffer_)
+    {
+        if (!IsDeviceLost())
+            glDeleteBuffers(1, &impl_->uniformRingBuffer_);
+        impl_->uniformRingBuffer_ = 0;
+        impl_->uniformRingBufferOffset_ = 0;
+    }
+#endif
+
     // End fullscreen mode first to counteract transition and getting stuck problems on OS X
 #if defined(__APPLE__) && !defined(IOS) && !defined(TVOS)
     if (closeWindow && screenParams_.fullscreen_ && !externalWindow_)
@@ -2426,6 +2637,33 @@ void Graphics::Release(bool clearGPUObjects, bool closeWindow)
         if (!clearGPUObjects)
             URHO3D_LOGINFO("OpenGL context lost");
 
+#ifndef GL_ES_VERSION_2_0
+        if (impl_->gpuFrameQueries_[0])
+            glDeleteQueries(NUM_GPU_FRAME_QUERIES, impl_->gpuFrameQueries_);
+        for (unsigned i = 0; i < NUM_GPU_FRAME_QUERIES; ++i)
+        {
+            impl_->gpuFrameQueries_[i] = 0;
+            impl_->gpuFrameQueryPending_[i] = false;
+        }
+        impl_->gpuFrameQueryActive_ = false;
+        gpuFrameTimingSupport_ = false;
+#endif
+
+#ifdef URHO3D_GPU_PROFILING
+        // Timestamp queries are destroyed together with the context
+        for (unsigned i = 0; i < Min(gpuZoneDepth_, MAX_GPU_ZONE_DEPTH); ++i)
+            impl_->gpuZones_[i].reset();
+        gpuZoneDepth_ = 0;
+        if (gpuProfilingSupport_)
+        {
+            tracy::GpuCtx* gpuContext = tracy::GetGpuCtx().ptr;
+            gpuContext->~GpuCtx();
+            tracy::tracy_free(gpuContext);
+            tracy::GetGpuCtx().ptr = nullptr;
+            gpuProfilingSupport_ = false;
+        }
+#endif
+
         SDL_GL_DeleteContext(impl_->context_);
         impl_->context_ = nullptr;
     }
@@ -2564,6 +2802,19 @@ void Graphics::Restore()
         // In case of trouble or for wanting maximum compatibility, simply remove the glEnable below.
         if (gl3Support || GLEW_ARB_seamless_cube_map)
             glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+
+        // Time elapsed queries are core since OpenGL 3.3
+        gpuFrameTimingSupport_ = gl3Support && GLEW_ARB_timer_query;
+
+#ifdef URHO3D_GPU_PROFILING
+        // Timestamp queries are core since OpenGL 3.3
+        gpuProfilingSupport_ = gl3Support && GLEW_ARB_timer_query;
+        if (gpuProfilingSupport_)
+        {
+            TracyGpuContext;
+            TracyGpuContextName(apiName_.c_str(), apiName_.length());
+        }
+#endif
 #elif defined(GL_ES_VERSION_3_0)
         if (forceGL2_)
         {
@@ -2911,9 +3162,56 @@ void Graphics::PrepareDraw()
 #ifndef GL_ES_VERSION_2_0
     if (gl3Support)
     {
-        for (auto i = impl_->dirtyConstantBuffers_.begin(); i !=
-            impl_->dirtyConstantBuffers_.end(); ++i)
-            (*i)->Apply();
+        // Copy changed constant buffers to consecutive ranges of one large uniform buffer, instead of respecifying the storage
+        // of each small buffer on every draw call
+        const unsigned alignMask = impl_->uniformBufferAlignment_ - 1;
+        unsigned requiredSize = 0;
+        for (unsigned i = 0; i < MAX_SHADER_PARAMETER_GROUPS * 2; ++i)
+        {
+            ConstantBuffer* buffer = impl_->constantBuffers_[i];
+            if (buffer && (buffer->IsDirty() || impl_->constantBufferRangesDirty_[i]))
+                requiredSize += (buffer->GetSize() + alignMask) & ~alignMask;
+        }
+
+        if (requiredSize)
+        {
+            if (!impl_->uniformRingBuffer_ || impl_->uniformRingBufferOffset_ + requiredSize > UNIFORM_RING_BUFFER_SIZE)
+            {
+                if (!impl_->uniformRingBuffer_)
+                {
+                    GLint alignment = 0;
+                    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+                    if (alignment > 0)
+                        impl_->uniformBufferAlignment_ = (unsigned)alignment;
+                    glGenBuffers(1, &impl_->uniformRingBuffer_);
+                }
+
+                // Orphan the old storage. Ranges bound from it must be uploaded again
+                SetUBO(impl_->uniformRingBuffer_);
+                glBufferData(GL_UNIFORM_BUFFER, UNIFORM_RING_BUFFER_SIZE, nullptr, GL_STREAM_DRAW);
+                impl_->uniformRingBufferOffset_ = 0;
+                for (unsigned i = 0; i < MAX_SHADER_PARAMETER_GROUPS * 2; ++i)
+                    impl_->constantBufferRangesDirty_[i] = impl_->constantBuffers_[i] != nullptr;
+            }
+
+            SetUBO(impl_->uniformRingBuffer_);
+            const unsigned newAlignMask = impl_->uniformBufferAlignment_ - 1;
+            for (unsigned i = 0; i < MAX_SHADER_PARAMETER_GROUPS * 2; ++i)
+            {
+                ConstantBuffer* buffer = impl_->constantBuffers_[i];
+                if (!buffer || (!buffer->IsDirty() && !impl_->constantBufferRangesDirty_[i]))
+                    continue;
+
+                unsigned size = buffer->GetSize();
+                unsigned offset = impl_->uniformRingBufferOffset_;
+                glBufferSubData(GL_UNIFORM_BUFFER, offset, size, buffer->GetShadowData());
+                glBindBufferRange(GL_UNIFORM_BUFFER, i, impl_->uniformRingBuffer_, offset, size);
+                impl_->uniformRingBufferOffset_ = (offset + size + newAlignMask) & ~newAlignMask;
+                impl_->constantBufferRangesDirty_[i] = false;
+                buffer->ClearDirty();
+            }
+        }
+
         impl_->dirtyConstantBuffers_.clear();
     }
 #endif
@@ -3195,7 +3493,8 @@ void Graphics::PrepareDraw()
 
                     SetVBO(buffer->GetGPUObjectName());
                     glVertexAttribPointer(location, glElementComponents[element.type_], glElementTypes[element.type_],
-                        element.type_ == TYPE_UBYTE4_NORM ? GL_TRUE : GL_FALSE, (unsigned)buffer->GetVertexSize(),
+                        element.type_ == TYPE_UBYTE4_NORM || element.type_ == TYPE_SHORT4_NORM ? GL_TRUE : GL_FALSE,
+                        (unsigned)buffer->GetVertexSize(),
                         (const void *)(size_t)dataStart);
                 }
             }
@@ -3307,6 +3606,8 @@ void Graphics::ResetCachedState()
 
     for (auto& constantBuffer : impl_->constantBuffers_)
         constantBuffer = nullptr;
+    for (bool& rangeDirty : impl_->constantBufferRangesDirty_)
+        rangeDirty = false;
     impl_->dirtyConstantBuffers_.clear();
 }
 
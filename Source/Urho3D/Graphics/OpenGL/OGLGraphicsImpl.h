@@ -50,6 +50,12 @@
 #include <GL/glew.h>
 #endif
 
+#if URHO3D_PROFILING && !defined(GL_ES_VERSION_2_0) && !defined(__APPLE__)
+#define URHO3D_GPU_PROFILING 1
+#include <EASTL/optional.h>
+#include <tracy/TracyOpenGL.hpp>
+#endif
+
 #ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
 #define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83f1
 #endif
@@ -106,6 +112,21 @@ struct FrameBufferObject
     unsigned drawBuffers_{M_MAX_UNSIGNED};
 };
 
+#ifndef GL_ES_VERSION_2_0
+/// Asynchronous texture readback waiting for the GPU.
+struct PendingTextureReadback
+{
+    /// Pixel pack buffer receiving the data.
+    unsigned buffer_{};
+    /// Fence signaled when the data has been written.
+    GLsync fence_{};
+    /// Data size in bytes.
+    unsigned size_{};
+    /// Callback to invoke with the data.
+    TextureReadbackCallback callback_;
+};
+#endif
+
 /// %Graphics subsystem implementation. Holds API-specific objects.
 class URHO3D_API GraphicsImpl
 {
@@ -117,6 +138,10 @@ public:
 
     /// Return the GL Context.
     const SDL_GLContext& GetGLContext() { return context_; }
+#ifndef GL_ES_VERSION_2_0
+    /// Return asynchronous texture readbacks waiting for the GPU.
+    ea::vector<PendingTextureReadback>& GetPendingTextureReadbacks() { return pendingTextureReadbacks_; }
+#endif
 
 private:
     /// SDL OpenGL context.
@@ -155,6 +180,14 @@ private:
     ConstantBuffer* constantBuffers_[MAX_SHADER_PARAMETER_GROUPS * 2]{};
     /// Dirty constant buffers.
     ea::vector<ConstantBuffer*> dirtyConstantBuffers_;
+    /// Bindings whose constant buffer must be copied to the uniform ring buffer before the next draw.
+    bool constantBufferRangesDirty_[MAX_SHADER_PARAMETER_GROUPS * 2]{};
+    /// Uniform buffer object that constant buffer data of all draw calls is suballocated from.
+    unsigned uniformRingBuffer_{};
+    /// Next free byte offset in the uniform ring buffer.
+    unsigned uniformRingBufferOffset_{};
+    /// Required alignment of uniform buffer ranges.
+    unsigned uniformBufferAlignment_{256};
     /// Last used instance data offset.
     unsigned lastInstanceOffset_{};
     /// Map for additional depth textures, to emulate Direct3D9 ability to mix render texture and backbuffer rendering.
@@ -169,6 +202,22 @@ private:
     bool vertexBuffersDirty_{};
     /// sRGB write mode flag.
     bool sRGBWrite_{};
+#ifndef GL_ES_VERSION_2_0
+    /// Asynchronous texture readbacks waiting for the GPU.
+    ea::vector<PendingTextureReadback> pendingTextureReadbacks_;
+    /// Elapsed time queries for measuring GPU frame time.
+    unsigned gpuFrameQueries_[NUM_GPU_FRAME_QUERIES]{};
+    /// Whether each frame time query is waiting for its result.
+    bool gpuFrameQueryPending_[NUM_GPU_FRAME_QUERIES]{};
+    /// Frame time query to use next.
+    unsigned gpuFrameQueryIndex_{};
+    /// Whether a frame time query is open.
+    bool gpuFrameQueryActive_{};
+#endif
+#ifdef URHO3D_GPU_PROFILING
+    /// Open GPU timing zones.
+    ea::optional<tracy::GpuCtxScope> gpuZones_[MAX_GPU_ZONE_DEPTH];
+#endif
 };
 
 }
@@ -94,6 +94,7 @@ bool IndexBuffer::SetData(const void* data)
 
     if (object_.name_)
     {
+        graphics_->AddUploadedBytes(indexCount_ * indexSize_);
         if (!graphics_->IsDeviceLost())
         {
             graphics_->SetIndexBuffer(this);
@@ -141,13 +142,14 @@ bool IndexBuffer::SetDataRange(const void* data, unsigned start, unsigned count,
 
     if (object_.name_)
     {
+        graphics_->AddUploadedBytes(count * indexSize_);
         if (!graphics_->IsDeviceLost())
         {
             graphics_->SetIndexBuffer(this);
-            if (!discard || start != 0)
-                glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, start * (size_t)indexSize_, count * indexSize_, data);
-            else
-                glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * (size_t)indexSize_, data, dynamic_ ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+            // Discard by orphaning the whole buffer, so that its size is kept
+            if (discard)
+                glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount_ * (size_t)indexSize_, nullptr, dynamic_ ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, start * (size_t)indexSize_, count * indexSize_, data);
         }
         else
         {
@@ -25,9 +25,13 @@
 #include "../../Graphics/ConstantBuffer.h"
 #include "../../Graphics/Graphics.h"
 #include "../../Graphics/GraphicsImpl.h"
+#include "../../Graphics/Shader.h"
 #include "../../Graphics/ShaderProgram.h"
 #include "../../Graphics/ShaderVariation.h"
+#include "../../IO/File.h"
+#include "../../IO/FileSystem.h"
 #include "../../IO/Log.h"
+#include "../../Resource/ResourceCache.h"
 
 #include "../../DebugNew.h"
 
@@ -127,12 +131,29 @@ bool ShaderProgram::Link()
         return false;
     }
 
-    glAttachShader(object_.name_, vertexShader_->GetGPUObjectName());
-    glAttachShader(object_.name_, pixelShader_->GetGPUObjectName());
-    glLinkProgram(object_.name_);
+    bool linkedFromBinary = false;
+#ifndef GL_ES_VERSION_2_0
+    // Check for a cached program binary first, as linking is often the most expensive part of shader compilation
+    ea::string binaryFileName;
+    ea::string binaryKey;
+    if (GLEW_ARB_get_program_binary && !graphics_->GetShaderCacheDir().empty())
+    {
+        binaryKey = GetProgramBinaryKey();
+        binaryFileName = graphics_->GetShaderCacheDir() + "Program_" + StringHash(binaryKey).ToString() + ".glp";
+        glProgramParameteri(object_.name_, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        linkedFromBinary = LoadProgramBinary(binaryFileName, binaryKey);
+    }
+#endif
+
+    int linked = 1, length;
+    if (!linkedFromBinary)
+    {
+        glAttachShader(object_.name_, vertexShader_->GetGPUObjectName());
+        glAttachShader(object_.name_, pixelShader_->GetGPUObjectName());
+        glLinkProgram(object_.name_);
+        glGetProgramiv(object_.name_, GL_LINK_STATUS, &linked);
+    }
 
-    int linked, length;
-    glGetProgramiv(object_.name_, GL_LINK_STATUS, &linked);
     if (!linked)
     {
         glGetProgramiv(object_.name_, GL_INFO_LOG_LENGTH, &length);
@@ -148,6 +169,11 @@ bool ShaderProgram::Link()
     if (!object_.name_)
         return false;
 
+#ifndef GL_ES_VERSION_2_0
+    if (!linkedFromBinary && !binaryFileName.empty())
+        SaveProgramBinary(binaryFileName, binaryKey);
+#endif
+
     const int MAX_NAME_LENGTH = 256;
     char nameBuffer[MAX_NAME_LENGTH];
     int attributeCount, uniformCount, elementCount, nameLength;
@@ -320,6 +346,105 @@ bool ShaderProgram::Link()
     return true;
 }
 
+#ifndef GL_ES_VERSION_2_0
+ea::string ShaderProgram::GetProgramBinaryKey() const
+{
+    ea::string key;
+    for (ShaderVariation* variation : {vertexShader_.Get(), pixelShader_.Get()})
+    {
+        Shader* owner = variation->GetOwner();
+        key += variation->GetFullName() + " ";
+        key += StringHash(owner ? owner->GetSourceCode(variation->GetShaderType()) : EMPTY_STRING).ToString() + "\n";
+    }
+
+    // Program binaries are only valid for the exact driver that produced them
+    key += reinterpret_cast<const char*>(glGetString(GL_VENDOR));
+    key += " ";
+    key += reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+    key += " ";
+    key += reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    key += " MAXBONES=" + ea::to_string(Graphics::GetMaxBones());
+    if (Graphics::GetGL3Support())
+        key += " GL3";
+
+    return key;
+}
+
+bool ShaderProgram::LoadProgramBinary(const ea::string& binaryFileName, const ea::string& binaryKey)
+{
+    auto* cache = graphics_->GetSubsystem<ResourceCache>();
+    if (!cache->Exists(binaryFileName))
+        return false;
+
+    SharedPtr<File> file = cache->GetFile(binaryFileName, false);
+    if (!file || file->ReadFileID() != "UGLP" || file->ReadString() != binaryKey)
+        return false;
+
+    auto format = (GLenum)file->ReadUInt();
+    unsigned size = file->ReadUInt();
+    if (!size)
+        return false;
+
+    ea::vector<unsigned char> binary(size);
+    if (file->Read(binary.data(), size) != size)
+        return false;
+
+    glProgramBinary(object_.name_, format, binary.data(), (GLsizei)size);
+
+    // The driver may reject the binary, for example after an update. Then link normally
+    int linked;
+    glGetProgramiv(object_.name_, GL_LINK_STATUS, &linked);
+    if (!linked)
+        return false;
+
+    URHO3D_LOGDEBUG("Loaded cached shader program " + vertexShader_->GetFullName() + " " + pixelShader_->GetFullName());
+    return true;
+}
+
+void ShaderProgram::SaveProgramBinary(const ea::string& binaryFileName, const ea::string& binaryKey)
+{
+    int size = 0;
+    glGetProgramiv(object_.name_, GL_PROGRAM_BINARY_LENGTH, &size);
+    if (size <= 0)
+        return;
+
+    ea::vector<unsigned char> binary((unsigned)size);
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(object_.name_, size, &written, &format, binary.data());
+    if (written <= 0)
+        return;
+
+    auto* cache = graphics_->GetSubsystem<ResourceCache>();
+    auto* fileSystem = graphics_->GetSubsystem<FileSystem>();
+
+    // Filename may or may not be inside the resource system
+    ea::string fullName = binaryFileName;
+    if (!IsAbsolutePath(fullName))
+    {
+        // If not absolute, use the resource dir of the vertex shader
+        Shader* owner = vertexShader_->GetOwner();
+        ea::string shaderFileName = owner ? cache->GetResourceFileName(owner->GetName()) : EMPTY_STRING;
+        if (shaderFileName.empty())
+            return;
+        fullName = shaderFileName.substr(0, shaderFileName.find(owner->GetName())) + binaryFileName;
+    }
+    ea::string path = GetPath(fullName);
+    if (!fileSystem->DirExists(path))
+        fileSystem->CreateDir(path);
+
+    SharedPtr<File> file(new File(graphics_->GetContext(), fullName, FILE_WRITE));
+    if (!file->IsOpen())
+        return;
+
+    file->WriteFileID("UGLP");
+    file->WriteString(binaryKey);
+    file->WriteUInt(format);
+    file->WriteUInt((unsigned)written);
+    file->Write(binary.data(), (unsigned)written);
+}
+#endif
+
 ShaderVariation* ShaderProgram::GetVertexShader() const
 {
     return vertexShader_;
@@ -88,6 +88,15 @@ public:
     static void ClearGlobalParameterSource(ShaderParameterGroup group);
 
 private:
+#ifndef GL_ES_VERSION_2_0
+    /// Return the string that identifies a program binary: shader names, defines, source code hashes and driver.
+    ea::string GetProgramBinaryKey() const;
+    /// Load the program from a cached binary. Return true if the program is linked.
+    bool LoadProgramBinary(const ea::string& binaryFileName, const ea::string& binaryKey);
+    /// Save the linked program binary to the cache.
+    void SaveProgramBinary(const ea::string& binaryFileName, const ea::string& binaryKey);
+#endif
+
     /// Vertex shader.
     WeakPtr<ShaderVariation> vertexShader_;
     /// Pixel shader.
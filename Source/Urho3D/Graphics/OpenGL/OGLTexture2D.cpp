@@ -369,6 +369,79 @@ bool Texture2D::GetData(unsigned level, void* dest) const
 #endif
 }
 
+bool Texture2D::GetDataAsync(unsigned level, TextureReadbackCallback callback) const
+{
+#ifndef GL_ES_VERSION_2_0
+    if (Graphics::GetGL3Support())
+    {
+        if (!object_.name_ || !graphics_)
+        {
+            URHO3D_LOGERROR("No texture created, can not get data");
+            return false;
+        }
+
+        if (level >= levels_)
+        {
+            URHO3D_LOGERROR("Illegal mip level for getting data");
+            return false;
+        }
+
+        if (graphics_->IsDeviceLost())
+        {
+            URHO3D_LOGWARNING("Getting texture data while device is lost");
+            return false;
+        }
+
+        if (multiSample_ > 1 && !autoResolve_)
+        {
+            URHO3D_LOGERROR("Can not get data from multisampled texture without autoresolve");
+            return false;
+        }
+
+        if (resolveDirty_)
+            graphics_->ResolveToTexture(const_cast<Texture2D*>(this));
+
+        // Copy into a pixel pack buffer and fence it, the data is mapped once the fence has been signaled
+        PendingTextureReadback readback;
+        readback.size_ = GetDataSize(GetLevelWidth(level), GetLevelHeight(level));
+        readback.callback_ = ea::move(callback);
+
+        glGenBuffers(1, &readback.buffer_);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer_);
+        glBufferData(GL_PIXEL_PACK_BUFFER, readback.size_, nullptr, GL_STREAM_READ);
+
+        graphics_->SetTextureForUpdate(const_cast<Texture2D*>(this));
+
+        if (!IsCompressed())
+            glGetTexImage(target_, level, GetExternalFormat(format_), GetDataType(format_), nullptr);
+        else
+            glGetCompressedTexImage(target_, level, nullptr);
+
+        graphics_->SetTexture(0, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        readback.fence_ = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        graphics_->GetImpl()->GetPendingTextureReadbacks().push_back(ea::move(readback));
+        return true;
+    }
+#endif
+
+    // Fall back to synchronous readback
+    if (level >= levels_)
+    {
+        URHO3D_LOGERROR("Illegal mip level for getting data");
+        return false;
+    }
+
+    ea::vector<unsigned char> data(GetDataSize(GetLevelWidth(level), GetLevelHeight(level)));
+    if (!GetData(level, data.data()))
+        return false;
+
+    if (callback)
+        callback(data);
+    return true;
+}
+
 bool Texture2D::Create()
 {
     Release();
@@ -97,6 +97,7 @@ bool VertexBuffer::SetData(const void* data)
 
     if (object_.name_)
     {
+        graphics_->AddUploadedBytes(vertexCount_ * vertexSize_);
         if (!graphics_->IsDeviceLost())
         {
             graphics_->SetVBO(object_.name_);
@@ -144,13 +145,14 @@ bool VertexBuffer::SetDataRange(const void* data, unsigned start, unsigned count
 
     if (object_.name_)
     {
+        graphics_->AddUploadedBytes(count * vertexSize_);
         if (!graphics_->IsDeviceLost())
         {
             graphics_->SetVBO(object_.name_);
-            if (!discard || start != 0)
-                glBufferSubData(GL_ARRAY_BUFFER, start * (size_t)vertexSize_, count * vertexSize_, data);
-            else
-                glBufferData(GL_ARRAY_BUFFER, count * (size_t)vertexSize_, data, dynamic_ ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+            // Discard by orphaning the whole buffer, so that its size is kept
+            if (discard)
+                glBufferData(GL_ARRAY_BUFFER, vertexCount_ * (size_t)vertexSize_, nullptr, dynamic_ ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+            glBufferSubData(GL_ARRAY_BUFFER, start * (size_t)vertexSize_, count * vertexSize_, data);
         }
         else
         {
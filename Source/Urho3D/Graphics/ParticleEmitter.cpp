@@ -165,14 +165,31 @@ void ParticleEmitter::Update(const FrameInfo& frame)
         }
     }
 
-    // Update existing particles
-    Vector3 relativeConstantForce = node_->GetWorldRotation().Inverse() * effect_->GetConstantForce();
+    // Update existing particles. Read the effect parameters once, as they stay constant for the whole loop
+    const Vector3& constantForce = effect_->GetConstantForce();
+    const bool hasConstantForce = constantForce != Vector3::ZERO;
+    const Vector3 velocityAdd = lastTimeStep_ * (relative_ ? node_->GetWorldRotation().Inverse() * constantForce : constantForce);
+    const float dampingForce = effect_->GetDampingForce();
+    const float velocityScale = 1.0f - lastTimeStep_ * dampingForce;
+    const float sizeAdd = effect_->GetSizeAdd();
+    const float sizeMul = effect_->GetSizeMul();
+    const bool hasScaling = sizeAdd != 0.0f || sizeMul != 1.0f;
+    const float scaleAdd = lastTimeStep_ * sizeAdd;
+    const float scaleMul = (lastTimeStep_ * (sizeMul - 1.0f)) + 1.0f;
+    const ea::vector<ColorFrame>& colorFrames = effect_->GetColorFrames();
+    const unsigned numColorFrames = colorFrames.size();
+    const ea::vector<TextureFrame>& textureFrames = effect_->GetTextureFrames();
+    const unsigned numTextureFrames = textureFrames.size();
+    // Direction is only used by the vertex data of direction-facing billboards
+    const bool needDirection = faceCameraMode_ == FC_DIRECTION;
+
     // If billboards are not relative, apply scaling to the position update
     Vector3 scaleVector = Vector3::ONE;
     if (scaled_ && !relative_)
         scaleVector = node_->GetWorldScale();
 
-    for (unsigned i = 0; i < particles_.size(); ++i)
+    const unsigned numParticles = particles_.size();
+    for (unsigned i = 0; i < numParticles; ++i)
     {
         Particle& particle = particles_[i];
         Billboard& billboard = billboards_[i];
@@ -190,64 +207,50 @@ void ParticleEmitter::Update(const FrameInfo& frame)
             particle.timer_ += lastTimeStep_;
 
             // Velocity & position
-            const Vector3& constantForce = effect_->GetConstantForce();
-            if (constantForce != Vector3::ZERO)
-            {
-                if (relative_)
-                    particle.velocity_ += lastTimeStep_ * relativeConstantForce;
-                else
-                    particle.velocity_ += lastTimeStep_ * constantForce;
-            }
-
-            float dampingForce = effect_->GetDampingForce();
+            if (hasConstantForce)
+                particle.velocity_ += velocityAdd;
             if (dampingForce != 0.0f)
-            {
-                Vector3 force = -dampingForce * particle.velocity_;
-                particle.velocity_ += lastTimeStep_ * force;
-            }
+                particle.velocity_ *= velocityScale;
             billboard.position_ += lastTimeStep_ * particle.velocity_ * scaleVector;
-            billboard.direction_ = particle.velocity_.Normalized();
+            if (needDirection)
+                billboard.direction_ = particle.velocity_.Normalized();
 
             // Rotation
             billboard.rotation_ += lastTimeStep_ * particle.rotationSpeed_;
 
             // Scaling
-            float sizeAdd = effect_->GetSizeAdd();
-            float sizeMul = effect_->GetSizeMul();
-            if (sizeAdd != 0.0f || sizeMul != 1.0f)
+            if (hasScaling)
             {
-                particle.scale_ += lastTimeStep_ * sizeAdd;
+                particle.scale_ += scaleAdd;
                 if (particle.scale_ < 0.0f)
                     particle.scale_ = 0.0f;
                 if (sizeMul != 1.0f)
-                    particle.scale_ *= (lastTimeStep_ * (sizeMul - 1.0f)) + 1.0f;
+                    particle.scale_ *= scaleMul;
                 billboard.size_ = particle.size_ * particle.scale_;
             }
 
             // Color interpolation
             unsigned& index = particle.colorIndex_;
-            const ea::vector<ColorFrame>& colorFrames_ = effect_->GetColorFrames();
-            if (index < colorFrames_.size())
+            if (index < numColorFrames)
             {
-                if (index < colorFrames_.size() - 1)
+                if (index < numColorFrames - 1)
                 {
-                    if (particle.timer_ >= colorFrames_[index + 1].time_)
+                    if (particle.timer_ >= colorFrames[index + 1].time_)
                         ++index;
                 }
-                if (index < colorFrames_.size() - 1)
-                    billboard.color_ = colorFrames_[index].Interpolate(colorFrames_[index + 1], particle.timer_);
+                if (index < numColorFrames - 1)
+                    billboard.color_ = colorFrames[index].Interpolate(colorFrames[index + 1], particle.timer_);
                 else
-                    billboard.color_ = colorFrames_[index].color_;
+                    billboard.color_ = colorFrames[index].color_;
             }
 
             // Texture animation
             unsigned& texIndex = particle.texIndex_;
-            const ea::vector<TextureFrame>& textureFrames_ = effect_->GetTextureFrames();
-            if (textureFrames_.size() && texIndex < textureFrames_.size() - 1)
+            if (numTextureFrames && texIndex < numTextureFrames - 1)
             {
-                if (particle.timer_ >= textureFrames_[texIndex + 1].time_)
+                if (particle.timer_ >= textureFrames[texIndex + 1].time_)
                 {
-                    billboard.uv_ = textureFrames_[texIndex + 1].uv_;
+                    billboard.uv_ = textureFrames[texIndex + 1].uv_;
                     ++texIndex;
                 }
             }
@@ -25,9 +25,11 @@
 #include "../Graphics/Camera.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/GraphicsImpl.h"
+#include "../Graphics/Octree.h"
 #include "../Graphics/Renderer.h"
 #include "../Graphics/RenderSurface.h"
 #include "../Graphics/Texture.h"
+#include "../Scene/Scene.h"
 
 #include "../DebugNew.h"
 
@@ -84,6 +86,65 @@ void RenderSurface::ResetUpdateQueued()
     updateQueued_ = false;
 }
 
+bool RenderSurface::IsUpdateDue(unsigned frameNumber)
+{
+    // Track changes on every frame, as the update may be postponed by the interval or by not being visible
+    if (updateRange_ > 0.0f && !changedSinceUpdate_)
+        changedSinceUpdate_ = HasViewportChanges();
+
+    if (updateMode_ != SURFACE_UPDATEALWAYS && !updateQueued_)
+        return false;
+    // Keep the request queued until the interval has passed
+    if (hasUpdated_ && frameNumber - lastUpdateFrame_ < updateInterval_)
+        return false;
+    // Nothing to update if the previous result is still valid
+    if (updateRange_ > 0.0f && !changedSinceUpdate_)
+    {
+        updateQueued_ = false;
+        return false;
+    }
+
+    return true;
+}
+
+void RenderSurface::MarkUpdated(unsigned frameNumber)
+{
+    updateQueued_ = false;
+    hasUpdated_ = true;
+    lastUpdateFrame_ = frameNumber;
+    changedSinceUpdate_ = false;
+
+    lastViewProjs_.resize(viewports_.size());
+    for (unsigned i = 0; i < viewports_.size(); ++i)
+    {
+        Camera* camera = viewports_[i] ? viewports_[i]->GetCamera() : nullptr;
+        lastViewProjs_[i] = camera ? camera->GetViewProj() : Matrix4::ZERO;
+    }
+}
+
+bool RenderSurface::HasViewportChanges() const
+{
+    if (lastViewProjs_.size() != viewports_.size())
+        return true;
+
+    for (unsigned i = 0; i < viewports_.size(); ++i)
+    {
+        Viewport* viewport = viewports_[i];
+        Camera* camera = viewport ? viewport->GetCamera() : nullptr;
+        Scene* scene = viewport ? viewport->GetScene() : nullptr;
+        if (!camera || !scene)
+            continue;
+        if (camera->GetViewProj() != lastViewProjs_[i])
+            return true;
+
+        auto* octree = scene->GetComponent<Octree>();
+        if (octree && octree->HasChangesInside(Sphere(camera->GetNode()->GetWorldPosition(), updateRange_)))
+            return true;
+    }
+
+    return false;
+}
+
 int RenderSurface::GetWidth() const
 {
     return parentTexture_->GetWidth();
@@ -52,6 +52,12 @@ public:
     /// Set viewport update mode. Default is to update when visible.
     /// @property
     void SetUpdateMode(RenderSurfaceUpdateMode mode);
+    /// Set minimum number of frames between viewport updates. Default 1 (every frame).
+    /// @property
+    void SetUpdateInterval(unsigned interval) { updateInterval_ = Max(interval, 1U); }
+    /// Set range around the viewport cameras within which scene changes cause an update. While the cameras and the scene within range stay unchanged, updates are skipped. Default 0 (update regardless of changes).
+    /// @property
+    void SetUpdateRange(float range) { updateRange_ = Max(range, 0.0f); }
     /// Set linked color rendertarget.
     /// @property
     void SetLinkedRenderTarget(RenderSurface* renderTarget);
@@ -97,6 +103,14 @@ public:
     /// @property
     RenderSurfaceUpdateMode GetUpdateMode() const { return updateMode_; }
 
+    /// Return minimum number of frames between viewport updates.
+    /// @property
+    unsigned GetUpdateInterval() const { return updateInterval_; }
+
+    /// Return range around the viewport cameras within which scene changes cause an update.
+    /// @property
+    float GetUpdateRange() const { return updateRange_; }
+
     /// Return linked color rendertarget.
     /// @property
     RenderSurface* GetLinkedRenderTarget() const { return linkedRenderTarget_; }
@@ -111,6 +125,12 @@ public:
     /// Reset update queued flag. Called internally.
     void ResetUpdateQueued();
 
+    /// Return whether the viewports should be updated this frame according to the update mode, interval and range. Called internally.
+    bool IsUpdateDue(unsigned frameNumber);
+
+    /// Record that the viewports were queued for update this frame. Called internally.
+    void MarkUpdated(unsigned frameNumber);
+
     /// Return parent texture.
     /// @property
     Texture* GetParentTexture() const { return parentTexture_; }
@@ -178,6 +198,20 @@ private:
     RenderSurfaceUpdateMode updateMode_{SURFACE_UPDATEVISIBLE};
     /// Update queued flag.
     bool updateQueued_{};
+    /// Minimum number of frames between updates.
+    unsigned updateInterval_{1};
+    /// Range of scene changes that cause an update.
+    float updateRange_{};
+    /// Frame number of the last update.
+    unsigned lastUpdateFrame_{};
+    /// Whether the viewports have been updated at least once.
+    bool hasUpdated_{};
+    /// Whether the cameras or the scene within range changed since the last update.
+    bool changedSinceUpdate_{true};
+    /// View-projection matrices of the viewport cameras at the last update.
+    ea::vector<Matrix4> lastViewProjs_;
+    /// Return whether a viewport camera moved or the scene changed within range during the last octree update.
+    bool HasViewportChanges() const;
     /// Multisampled resolve dirty flag.
     bool resolveDirty_{};
 };
@@ -483,6 +483,7 @@ void Renderer::SetShadowMapFilter(Object* instance, ShadowMapFilter functionPtr)
 void Renderer::SetReuseShadowMaps(bool enable)
 {
     reuseShadowMaps_ = enable;
+    shadowMapCache_.clear();
 }
 
 void Renderer::SetMaxShadowMaps(int shadowMaps)
@@ -499,6 +500,17 @@ void Renderer::SetMaxShadowMaps(int shadowMaps)
     }
 }
 
+void Renderer::SetCacheShadowMaps(bool enable)
+{
+    cacheShadowMaps_ = enable;
+    shadowMapCache_.clear();
+}
+
+void Renderer::SetMaxPixelLights(int lights)
+{
+    maxPixelLights_ = Max(lights, 0);
+}
+
 void Renderer::SetDynamicInstancing(bool enable)
 {
     if (!instancingBuffer_)
@@ -552,6 +564,38 @@ void Renderer::SetMobileNormalOffsetMul(float mul)
     mobileNormalOffsetMul_ = mul;
 }
 
+void Renderer::SetDynamicResolution(bool enable)
+{
+    dynamicResolution_ = enable;
+    resolutionScale_ = 1.0f;
+    averageRenderTime_ = 0.0f;
+    resolutionScaleFrames_ = 0;
+}
+
+void Renderer::UpdateDynamicResolution(float renderTime)
+{
+    if (!dynamicResolution_)
+        return;
+
+    // Smooth out single frame spikes, and only adjust the scale periodically so that it does not oscillate
+    averageRenderTime_ = averageRenderTime_ > 0.0f ? Lerp(averageRenderTime_, renderTime, 0.1f) : renderTime;
+    if (++resolutionScaleFrames_ < RESOLUTION_SCALE_ADJUST_FRAMES)
+        return;
+    resolutionScaleFrames_ = 0;
+
+    // Rendering cost is roughly proportional to the pixel count, so correct the scale by the square root of the budget
+    // ratio when over budget. Step up only when there is clear headroom. Quantize the scale so that screen buffers of the
+    // same size can be reused from frame to frame
+    const float ratio = averageRenderTime_ * dynamicResolutionTargetFps_;
+    float scale = resolutionScale_;
+    if (ratio > 1.0f)
+        scale = Floor(scale / Sqrt(ratio) / RESOLUTION_SCALE_STEP + 0.001f) * RESOLUTION_SCALE_STEP;
+    else if (ratio < 0.85f)
+        scale = Round(scale / RESOLUTION_SCALE_STEP + 1.0f) * RESOLUTION_SCALE_STEP;
+
+    resolutionScale_ = Clamp(scale, minResolutionScale_, 1.0f);
+}
+
 void Renderer::SetSphericalHarmonics(bool enable)
 {
     if (sphericalHarmonics_ != enable)
@@ -734,6 +778,9 @@ void Renderer::Update(float timeStep)
     for (unsigned i = viewports_.size() - 1; i < viewports_.size(); --i)
         QueueViewport(nullptr, viewports_[i]);
 
+    // Find the main viewports that can share culling before any views are updated
+    PrepareSharedCulling();
+
     // Update main viewports. This may queue further views
     unsigned numMainViewports = queuedViewports_.size();
     for (unsigned i = 0; i < numMainViewports; ++i)
@@ -747,6 +794,7 @@ void Renderer::Update(float timeStep)
         UpdateQueuedViewport(i);
 
     queuedViewports_.clear();
+    sharedCullQueries_.clear();
     resetViews_ = false;
 }
 
@@ -802,6 +850,7 @@ void Renderer::Render()
     // Copy the number of batches & primitives from Graphics so that we can account for 3D geometry only
     numPrimitives_ = graphics_->GetNumPrimitives();
     numBatches_ = graphics_->GetNumBatches();
+    frameStatistics_ = graphics_->GetFrameStatistics();
 
     // Remove unused occlusion buffers and renderbuffers
     RemoveUnusedBuffers();
@@ -1057,6 +1106,36 @@ Texture2D* Renderer::GetShadowMap(Light* light, Camera* camera, unsigned viewWid
     return newShadowMap;
 }
 
+bool Renderer::IsShadowMapCached(Texture2D* shadowMap, Light* light, unsigned hash) const
+{
+    if (!hash || !shadowMap || shadowMap->IsDataLost())
+        return false;
+
+    auto i = shadowMapCache_.find(shadowMap);
+    if (i == shadowMapCache_.end())
+        return false;
+
+    const ShadowMapCacheEntry& entry = i->second;
+    return entry.shadowMap_ == shadowMap && entry.light_ == light && entry.hash_ == hash;
+}
+
+void Renderer::SetShadowMapCached(Texture2D* shadowMap, Light* light, unsigned hash)
+{
+    if (!shadowMap)
+        return;
+
+    if (!hash)
+    {
+        shadowMapCache_.erase(shadowMap);
+        return;
+    }
+
+    ShadowMapCacheEntry& entry = shadowMapCache_[shadowMap];
+    entry.shadowMap_ = shadowMap;
+    entry.light_ = light;
+    entry.hash_ = hash;
+}
+
 Texture* Renderer::GetScreenBuffer(int width, int height, unsigned format, int multiSample, bool autoResolve, bool cubemap, bool filtered, bool srgb,
     unsigned persistentKey)
 {
@@ -1394,6 +1473,11 @@ void Renderer::SetLightVolumeBatchShaders(Batch& batch, Camera* camera, const ea
 }
 
 void Renderer::SetCullMode(CullMode mode, Camera* camera)
+{
+    graphics_->SetCullMode(GetEffectiveCullMode(mode, camera));
+}
+
+CullMode Renderer::GetEffectiveCullMode(CullMode mode, Camera* camera) const
 {
     // If a camera is specified, check whether it reverses culling due to vertical flipping or reflection
     if (camera && camera->GetReverseCulling())
@@ -1404,7 +1488,7 @@ void Renderer::SetCullMode(CullMode mode, Camera* camera)
             mode = CULL_CW;
     }
 
-    graphics_->SetCullMode(mode);
+    return mode;
 }
 
 bool Renderer::ResizeInstancingBuffer(unsigned numInstances)
@@ -1433,6 +1517,15 @@ bool Renderer::ResizeInstancingBuffer(unsigned numInstances)
     return true;
 }
 
+void Renderer::SwitchInstancingBuffer()
+{
+    if (!instancingBuffer_)
+        return;
+
+    instancingBufferIndex_ = (instancingBufferIndex_ + 1) % NUM_INSTANCING_BUFFERS;
+    instancingBuffer_ = instancingBuffers_[instancingBufferIndex_];
+}
+
 void Renderer::OptimizeLightByScissor(Light* light, Camera* camera)
 {
     if (light && light->GetLightType() != LIGHT_DIRECTIONAL)
@@ -1536,6 +1629,68 @@ const Rect& Renderer::GetLightScissor(Light* light, Camera* camera)
     }
 }
 
+void Renderer::PrepareSharedCulling()
+{
+    sharedCullQueries_.clear();
+    if (!sharedCulling_)
+        return;
+
+    // Use the culling cameras of the previous frame, as views have not been defined yet. If a view's frustum has since
+    // grown outside the shared bounds, it falls back to querying the octree itself
+    for (const auto& queuedViewport : queuedViewports_)
+    {
+        Viewport* viewport = queuedViewport.second;
+        Scene* scene = viewport ? viewport->GetScene() : nullptr;
+        Camera* camera = viewport ? (viewport->GetCullCamera() ? viewport->GetCullCamera() : viewport->GetCamera()) : nullptr;
+        auto* octree = scene ? scene->GetComponent<Octree>() : nullptr;
+        if (!octree || !camera)
+            continue;
+
+        const BoundingBox box(camera->GetFrustum());
+        const Vector3 size = box.Size();
+
+        auto queryIt = ea::find_if(sharedCullQueries_.begin(), sharedCullQueries_.end(),
+            [octree](const SharedCullQuery& query) { return query.octree_ == octree; });
+        SharedCullQuery& query = queryIt != sharedCullQueries_.end() ? *queryIt : sharedCullQueries_.emplace_back();
+        query.octree_ = octree;
+        query.bounds_.Merge(box);
+        query.volume_ += size.x_ * size.y_ * size.z_;
+        ++query.numViews_;
+    }
+
+    // Share only between several views that overlap enough: if the union bounds are larger than the views' bounds combined,
+    // separate octree queries visit less drawables
+    sharedCullQueries_.erase(ea::remove_if(sharedCullQueries_.begin(), sharedCullQueries_.end(), [](const SharedCullQuery& query)
+    {
+        const Vector3 size = query.bounds_.Size();
+        return query.numViews_ < 2 || size.x_ * size.y_ * size.z_ > query.volume_;
+    }), sharedCullQueries_.end());
+}
+
+const ea::vector<Drawable*>* Renderer::GetSharedCullDrawables(Octree* octree, const Frustum& frustum)
+{
+    for (SharedCullQuery& query : sharedCullQueries_)
+    {
+        if (query.octree_ != octree)
+            continue;
+        if (query.bounds_.IsInside(BoundingBox(frustum)) != INSIDE)
+            return nullptr;
+
+        // Query on first use, as the octree is updated just before the first view of it
+        if (!query.executed_)
+        {
+            URHO3D_PROFILE("SharedCullQuery");
+
+            BoxOctreeQuery octreeQuery(query.drawables_, query.bounds_, DRAWABLE_GEOMETRY | DRAWABLE_LIGHT | DRAWABLE_ZONE);
+            octree->GetDrawables(octreeQuery);
+            query.executed_ = true;
+        }
+        return &query.drawables_;
+    }
+
+    return nullptr;
+}
+
 void Renderer::UpdateQueuedViewport(unsigned index)
 {
     WeakPtr<RenderSurface>& renderTarget = queuedViewports_[index].first;
@@ -1951,23 +2106,35 @@ void Renderer::CreateInstancingBuffer()
     if (!graphics_->GetInstancingSupport())
     {
         instancingBuffer_.Reset();
+        for (SharedPtr<VertexBuffer>& buffer : instancingBuffers_)
+            buffer.Reset();
         dynamicInstancing_ = false;
         return;
     }
 
-    instancingBuffer_ = context_->CreateObject<VertexBuffer>();
     const ea::vector<VertexElement> instancingBufferElements = CreateInstancingBufferElements(numExtraInstancingBufferElements_);
-    if (!instancingBuffer_->SetSize(INSTANCING_BUFFER_DEFAULT_SIZE, instancingBufferElements, true))
+    for (SharedPtr<VertexBuffer>& buffer : instancingBuffers_)
     {
-        instancingBuffer_.Reset();
-        dynamicInstancing_ = false;
+        buffer = context_->CreateObject<VertexBuffer>();
+        if (!buffer->SetSize(INSTANCING_BUFFER_DEFAULT_SIZE, instancingBufferElements, true))
+        {
+            instancingBuffer_.Reset();
+            for (SharedPtr<VertexBuffer>& bufferToReset : instancingBuffers_)
+                bufferToReset.Reset();
+            dynamicInstancing_ = false;
+            return;
+        }
     }
+
+    instancingBufferIndex_ = 0;
+    instancingBuffer_ = instancingBuffers_[instancingBufferIndex_];
 }
 
 void Renderer::ResetShadowMaps()
 {
     shadowMaps_.clear();
     shadowMapAllocations_.clear();
+    shadowMapCache_.clear();
     colorShadowMaps_.clear();
 }
 
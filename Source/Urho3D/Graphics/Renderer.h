@@ -60,6 +60,9 @@ struct BatchQueue;
 
 static const int SHADOW_MIN_PIXELS = 64;
 static const int INSTANCING_BUFFER_DEFAULT_SIZE = 1024;
+static const unsigned NUM_INSTANCING_BUFFERS = 3;
+static const float RESOLUTION_SCALE_STEP = 0.05f;
+static const unsigned RESOLUTION_SCALE_ADJUST_FRAMES = 15;
 
 /// Light vertex shader variations.
 enum LightVSVariation
@@ -181,6 +184,34 @@ enum SkinningMode
     SKINNING_SOFTWARE,
 };
 
+/// Last contents rendered into a shadow map. Used to skip re-rendering shadow maps whose light and casters have not changed.
+struct ShadowMapCacheEntry
+{
+    /// Shadow map texture.
+    WeakPtr<Texture2D> shadowMap_;
+    /// Light rendered into the shadow map.
+    WeakPtr<Light> light_;
+    /// Hash of the shadow cameras and shadow caster batches.
+    unsigned hash_{};
+};
+
+/// Drawables of an octree gathered once per frame for culling several views with overlapping frusta.
+struct SharedCullQuery
+{
+    /// Octree queried.
+    Octree* octree_{};
+    /// Union of the bounding boxes of the views' frusta.
+    BoundingBox bounds_;
+    /// Sum of the volumes of the views' frustum bounding boxes.
+    float volume_{};
+    /// Number of views expected to use the query.
+    unsigned numViews_{};
+    /// Whether the octree has been queried this frame.
+    bool executed_{};
+    /// Geometries, lights and zones inside the bounds.
+    ea::vector<Drawable*> drawables_;
+};
+
 /// High-level rendering subsystem. Manages drawing of 3D views.
 class URHO3D_API Renderer : public Object
 {
@@ -254,6 +285,12 @@ public:
     /// Set maximum number of shadow maps created for one resolution. Only has effect if reuse of shadow maps is disabled.
     /// @property
     void SetMaxShadowMaps(int shadowMaps);
+    /// Set whether to skip re-rendering shadow maps of lights whose shadow cameras and casters have not changed since the last frame. Only has effect if reuse of shadow maps is disabled. Default false.
+    /// @property
+    void SetCacheShadowMaps(bool enable);
+    /// Set maximum number of per-pixel lights per drawable. Excess lights, dimmest first, are converted to vertex lights. Default 0 (unlimited). A drawable's own maximum lights setting takes precedence if it is lower.
+    /// @property
+    void SetMaxPixelLights(int lights);
     /// Set dynamic instancing on/off. When on (default), drawables using the same static-type geometry and material will be automatically combined to an instanced draw call.
     /// @property
     void SetDynamicInstancing(bool enable);
@@ -266,6 +303,12 @@ public:
     /// Set maximum number of sorted instances per batch group. If exceeded, instances are rendered unsorted.
     /// @property
     void SetMaxSortedInstances(int instances);
+    /// Set whether views retain instanced batch groups between frames. Default is false. Saves recreating the groups and reallocating their instance storage when the visible content mostly stays the same.
+    /// @property
+    void SetRetainBatchGroups(bool enable) { retainBatchGroups_ = enable; }
+    /// Set whether views of the same octree with overlapping frusta share one octree query per frame and only filter its results. Default true.
+    /// @property
+    void SetSharedCulling(bool enable) { sharedCulling_ = enable; }
     /// Set maximum number of occluder triangles.
     /// @property
     void SetMaxOccluderTriangles(int triangles);
@@ -278,6 +321,9 @@ public:
     /// Set whether to thread occluder rendering. Default false.
     /// @property
     void SetThreadedOcclusion(bool enable);
+    /// Set whether views pick additional occluders automatically from the largest geometries visible on the previous frame. Default false.
+    /// @property
+    void SetAutoOccluders(bool enable) { autoOccluders_ = enable; }
     /// Set shadow depth bias multiplier for mobile platforms to counteract possible worse shadow map precision. Default 1.0 (no effect).
     /// @property
     void SetMobileShadowBiasMul(float mul);
@@ -287,6 +333,18 @@ public:
     /// Set shadow normal offset multiplier for mobile platforms to counteract possible worse shadow map precision. Default 1.0 (no effect).
     /// @property
     void SetMobileNormalOffsetMul(float mul);
+    /// Set whether backbuffer views adapt their rendering resolution to hold the target frame rate. Default false.
+    /// @property
+    void SetDynamicResolution(bool enable);
+    /// Set target frame rate for dynamic resolution. Default 60.
+    /// @property
+    void SetDynamicResolutionTargetFps(float fps) { dynamicResolutionTargetFps_ = Max(fps, 1.0f); }
+    /// Set minimum resolution scale for dynamic resolution. Default 0.5.
+    /// @property
+    void SetMinResolutionScale(float scale) { minResolutionScale_ = Clamp(scale, RESOLUTION_SCALE_STEP, 1.0f); }
+    /// Set whether dynamic resolution views are upscaled and antialiased with jittered temporal accumulation instead of bilinear filtering. Default true.
+    /// @property
+    void SetTemporalUpscale(bool enable) { temporalUpscale_ = enable; }
     /// Set whether to enable spherical harmonics.
     void SetSphericalHarmonics(bool enable);
     /// Set skinning mode.
@@ -371,6 +429,14 @@ public:
     /// @property
     int GetMaxShadowMaps() const { return maxShadowMaps_; }
 
+    /// Return whether unchanged shadow maps are cached.
+    /// @property
+    bool GetCacheShadowMaps() const { return cacheShadowMaps_; }
+
+    /// Return maximum number of per-pixel lights per drawable.
+    /// @property
+    int GetMaxPixelLights() const { return maxPixelLights_; }
+
     /// Return whether dynamic instancing is in use.
     /// @property
     bool GetDynamicInstancing() const { return dynamicInstancing_; }
@@ -387,6 +453,14 @@ public:
     /// @property
     int GetMaxSortedInstances() const { return maxSortedInstances_; }
 
+    /// Return whether views retain instanced batch groups between frames.
+    /// @property
+    bool GetRetainBatchGroups() const { return retainBatchGroups_; }
+
+    /// Return whether views of the same octree share culling queries.
+    /// @property
+    bool GetSharedCulling() const { return sharedCulling_; }
+
     /// Return maximum number of occluder triangles.
     /// @property
     int GetMaxOccluderTriangles() const { return maxOccluderTriangles_; }
@@ -403,6 +477,10 @@ public:
     /// @property
     bool GetThreadedOcclusion() const { return threadedOcclusion_; }
 
+    /// Return whether occluders are picked automatically.
+    /// @property
+    bool GetAutoOccluders() const { return autoOccluders_; }
+
     /// Return shadow depth bias multiplier for mobile platforms.
     /// @property
     float GetMobileShadowBiasMul() const { return mobileShadowBiasMul_; }
@@ -415,6 +493,26 @@ public:
     /// @property
     float GetMobileNormalOffsetMul() const { return mobileNormalOffsetMul_; }
 
+    /// Return whether dynamic resolution is enabled.
+    /// @property
+    bool GetDynamicResolution() const { return dynamicResolution_; }
+
+    /// Return target frame rate for dynamic resolution.
+    /// @property
+    float GetDynamicResolutionTargetFps() const { return dynamicResolutionTargetFps_; }
+
+    /// Return minimum resolution scale for dynamic resolution.
+    /// @property
+    float GetMinResolutionScale() const { return minResolutionScale_; }
+
+    /// Return whether reduced resolution views are upscaled temporally.
+    /// @property
+    bool GetTemporalUpscale() const { return temporalUpscale_; }
+
+    /// Return current resolution scale of backbuffer views. Always 1 when dynamic resolution is disabled.
+    /// @property
+    float GetResolutionScale() const { return resolutionScale_; }
+
     /// Return whether to enable spherical harmonics.
     float GetSphericalHarmonics() const { return sphericalHarmonics_; }
 
@@ -436,6 +534,12 @@ public:
     /// @property
     unsigned GetNumBatches() const { return numBatches_; }
 
+    /// Return draw call and state change statistics of 3D rendering.
+    const DrawCallStatistics& GetFrameStatistics() const { return frameStatistics_; }
+
+    /// Return view by index. Views are in the order they were queued, auxiliary views after the main views they are used by.
+    View* GetView(unsigned index) const { return index < views_.size() ? views_[index].Get() : nullptr; }
+
     /// Return number of geometries rendered.
     /// @property
     unsigned GetNumGeometries(bool allViews = false) const;
@@ -479,6 +583,10 @@ public:
 
     /// Update for rendering. Called by HandleRenderUpdate().
     void Update(float timeStep);
+    /// Return drawables of a shared culling query enclosing the frustum, or null if the view has to query the octree itself. Called by View.
+    const ea::vector<Drawable*>* GetSharedCullDrawables(Octree* octree, const Frustum& frustum);
+    /// Adjust dynamic resolution scale from the measured render and present time of the last frame. Called by Engine.
+    void UpdateDynamicResolution(float renderTime);
     /// Render. Called by Engine.
     void Render();
     /// Add debug geometry to the debug renderer.
@@ -494,6 +602,10 @@ public:
     Geometry* GetQuadGeometry();
     /// Allocate a shadow map. If shadow map reuse is disabled, a different map is returned each time.
     Texture2D* GetShadowMap(Light* light, Camera* camera, unsigned viewWidth, unsigned viewHeight);
+    /// Return whether a shadow map already holds the light's shadows with the given contents hash. Zero hash is never cached.
+    bool IsShadowMapCached(Texture2D* shadowMap, Light* light, unsigned hash) const;
+    /// Record the light and contents hash last rendered into a shadow map.
+    void SetShadowMapCached(Texture2D* shadowMap, Light* light, unsigned hash);
     /// Allocate a rendertarget or depth-stencil texture for deferred rendering or postprocessing. Should only be called during actual rendering, not before.
     Texture* GetScreenBuffer
         (int width, int height, unsigned format, int multiSample, bool autoResolve, bool cubemap, bool filtered, bool srgb, unsigned persistentKey = 0);
@@ -514,8 +626,12 @@ public:
         (Batch& batch, Camera* camera, const ea::string& vsName, const ea::string& psName, const ea::string& vsDefines, const ea::string& psDefines);
     /// Set cull mode while taking possible projection flipping into account.
     void SetCullMode(CullMode mode, Camera* camera);
+    /// Return cull mode adjusted for possible projection flipping of the camera.
+    CullMode GetEffectiveCullMode(CullMode mode, Camera* camera) const;
     /// Ensure sufficient size of the instancing vertex buffer. Return true if successful.
     bool ResizeInstancingBuffer(unsigned numInstances);
+    /// Switch to the next instancing vertex buffer in the ring, so that buffers still in use by the GPU are not overwritten.
+    void SwitchInstancingBuffer();
     /// Optimize a light by scissor rectangle.
     void OptimizeLightByScissor(Light* light, Camera* camera);
     /// Optimize a light by marking it to the stencil buffer and setting a stencil test.
@@ -545,6 +661,8 @@ private:
     void SetIndirectionTextureData();
     /// Update a queued viewport for rendering.
     void UpdateQueuedViewport(unsigned index);
+    /// Collect the main viewports whose views can share culling queries.
+    void PrepareSharedCulling();
     /// Prepare for rendering of a new view.
     void PrepareViewRender();
     /// Remove unused occlusion and screen buffers.
@@ -580,8 +698,12 @@ private:
     SharedPtr<Geometry> spotLightGeometry_;
     /// Point light volume geometry.
     SharedPtr<Geometry> pointLightGeometry_;
-    /// Instance stream vertex buffer.
+    /// Current instance stream vertex buffer.
     SharedPtr<VertexBuffer> instancingBuffer_;
+    /// Ring of instance stream vertex buffers.
+    SharedPtr<VertexBuffer> instancingBuffers_[NUM_INSTANCING_BUFFERS];
+    /// Index of the current instance stream vertex buffer in the ring.
+    unsigned instancingBufferIndex_{};
     /// Default material.
     SharedPtr<Material> defaultMaterial_;
     /// Default range attenuation texture.
@@ -602,6 +724,8 @@ private:
     ea::unordered_map<int, SharedPtr<Texture2D> > colorShadowMaps_;
     /// Shadow map allocations by resolution.
     ea::unordered_map<int, ea::vector<Light*> > shadowMapAllocations_;
+    /// Last rendered contents of shadow maps.
+    ea::unordered_map<Texture2D*, ShadowMapCacheEntry> shadowMapCache_;
     /// Instance of shadow map filter.
     Object* shadowMapFilterInstance_{};
     /// Function pointer of shadow map filter.
@@ -622,6 +746,8 @@ private:
     ea::unordered_map<Camera*, WeakPtr<View> > preparedViews_;
     /// Octrees that have been updated during the frame.
     ea::hash_set<Octree*> updatedOctrees_;
+    /// Shared culling queries of the frame.
+    ea::vector<SharedCullQuery> sharedCullQueries_;
     /// Techniques for which missing shader error has been displayed.
     ea::hash_set<Technique*> shaderErrorDisplayed_;
     /// Mutex for shadow camera allocation.
@@ -654,6 +780,8 @@ private:
     int vsmMultiSample_{1};
     /// Maximum number of shadow maps per resolution.
     int maxShadowMaps_{1};
+    /// Maximum number of per-pixel lights per drawable, 0 for unlimited.
+    int maxPixelLights_{};
     /// Minimum number of instances required in a batch group to render as instanced.
     int minInstances_{2};
     /// Maximum sorted instances per batch group.
@@ -680,6 +808,8 @@ private:
     unsigned numPrimitives_{};
     /// Number of batches (3D geometry only).
     unsigned numBatches_{};
+    /// Draw call and state change statistics (3D geometry only).
+    DrawCallStatistics frameStatistics_;
     /// Frame number on which shaders last changed.
     unsigned shadersChangedFrameNumber_{M_MAX_UNSIGNED};
     /// Current stencil value for light optimization.
@@ -692,12 +822,34 @@ private:
     bool drawShadows_{true};
     /// Shadow map reuse flag.
     bool reuseShadowMaps_{true};
+    /// Shadow map caching flag.
+    bool cacheShadowMaps_{};
     /// Dynamic instancing flag.
     bool dynamicInstancing_{true};
+    /// Dynamic resolution flag.
+    bool dynamicResolution_{};
+    /// Temporal upscale flag.
+    bool temporalUpscale_{true};
+    /// Dynamic resolution target frame rate.
+    float dynamicResolutionTargetFps_{60.0f};
+    /// Minimum dynamic resolution scale.
+    float minResolutionScale_{0.5f};
+    /// Current resolution scale of backbuffer views.
+    float resolutionScale_{1.0f};
+    /// Smoothed render time used by the dynamic resolution controller.
+    float averageRenderTime_{};
+    /// Frames since the resolution scale was last adjusted.
+    unsigned resolutionScaleFrames_{};
+    /// Batch group retention flag.
+    bool retainBatchGroups_{};
+    /// Shared culling flag.
+    bool sharedCulling_{true};
     /// Number of extra instancing data elements.
     int numExtraInstancingBufferElements_{};
     /// Threaded occlusion rendering flag.
     bool threadedOcclusion_{};
+    /// Automatic occluder selection flag.
+    bool autoOccluders_{};
     /// Shaders need reloading flag.
     bool shadersDirty_{true};
     /// Initialized flag.
@@ -82,6 +82,7 @@ RibbonTrail::RibbonTrail(Context* context) :
     endColor_(Color(1.0f, 1.0f, 1.0f, 0.0f)),
     startColor_(Color(1.0f, 1.0f, 1.0f, 1.0f)),
     lastUpdateFrameNumber_(M_MAX_UNSIGNED),
+    vertexDataPoints_(0),
     needUpdate_(false),
     sorted_(false),
     previousOffset_(Vector3::ZERO),
@@ -208,6 +209,9 @@ void RibbonTrail::Update(const FrameInfo &frame)
         return;
 
     UpdateTail(frame.timeStep_);
+    // Generate camera-independent vertex data here, as the update runs in worker threads
+    if (!sorted_)
+        UpdateVertexData(nullptr);
     OnMarkedDirty(node_);
     needUpdate_ = false;
 }
@@ -548,43 +552,65 @@ void RibbonTrail::UpdateVertexBuffer(const FrameInfo& frame)
     unsigned indexPerSegment = 6 + (tailColumn_ - 1) * 6;
     unsigned vertexPerSegment = 4 + (tailColumn_ - 1) * 2;
 
+    // Unsorted vertex data does not depend on the camera and is usually generated by the threaded update already.
+    // Regenerate if the trail settings have changed since
+    unsigned vertexSize = trailType_ == TT_BONE ? 13 : 10;
+    if (sorted_ || vertexDataPoints_ != numPoints_ || vertexData_.size() != (numPoints_ - 1) * vertexPerSegment * vertexSize)
+        UpdateVertexData(sorted_ ? frame.camera_ : nullptr);
+
+    batches_[0].geometry_->SetDrawRange(TRIANGLE_LIST, 0, (numPoints_ - 1) * indexPerSegment, false);
+    bufferDirty_ = false;
+    forceUpdate_ = false;
+
+    if (vertexBuffer_->SetDataRange(vertexData_.data(), 0, (numPoints_ - 1) * vertexPerSegment, true))
+        vertexBuffer_->ClearDataLost();
+
+    // The data has been consumed, regenerate it on the next update
+    vertexDataPoints_ = 0;
+}
+
+void RibbonTrail::UpdateVertexData(Camera* sortCamera)
+{
+    const unsigned numPoints = points_.size();
+    vertexDataPoints_ = numPoints;
+    if (numPoints < 2)
+        return;
+
+    unsigned vertexPerSegment = 4 + (tailColumn_ - 1) * 2;
+    unsigned vertexSize = trailType_ == TT_BONE ? 13 : 10;
+    vertexData_.resize((numPoints - 1) * vertexPerSegment * vertexSize);
+
     // Fill sorted points vector
-    sortedPoints_.resize(numPoints_);
-    for (unsigned i = 0; i < numPoints_; ++i)
+    sortedPoints_.resize(numPoints);
+    for (unsigned i = 0; i < numPoints; ++i)
     {
         TrailPoint& point = points_[i];
         sortedPoints_[i] = &point;
-        if (sorted_)
-            point.sortDistance_ = frame.camera_->GetDistanceSquared(point.position_);
+        if (sortCamera)
+            point.sortDistance_ = sortCamera->GetDistanceSquared(point.position_);
     }
 
     // Sort points
-    if (sorted_)
+    if (sortCamera)
         ea::quick_sort(sortedPoints_.begin(), sortedPoints_.end(), CompareTails);
 
     // Update individual trail elapsed length
     float trailLength = 0.0f;
-    for(unsigned i = 0; i < numPoints_; ++i)
+    for(unsigned i = 0; i < numPoints; ++i)
     {
         float length = i == 0 ? 0.0f : (points_[i].position_ - points_[i-1].position_).Length();
         trailLength += length;
         points_[i].elapsedLength_ = trailLength;
-        if (i < numPoints_ - 1)
+        if (i < numPoints - 1)
             points_[i].next_ = &points_[i+1];
     }
 
-    batches_[0].geometry_->SetDrawRange(TRIANGLE_LIST, 0, (numPoints_ - 1) * indexPerSegment, false);
-    bufferDirty_ = false;
-    forceUpdate_ = false;
-
-    auto* dest = (float*)vertexBuffer_->Lock(0, (numPoints_ - 1) * vertexPerSegment, true);
-    if (!dest)
-        return;
+    float* dest = vertexData_.data();
 
     // Generate trail mesh
     if (trailType_ == TT_FACE_CAMERA)
     {
-        for (unsigned i = 0; i < numPoints_; ++i)
+        for (unsigned i = 0; i < numPoints; ++i)
         {
             TrailPoint& point = *sortedPoints_[i];
 
@@ -685,7 +711,7 @@ void RibbonTrail::UpdateVertexBuffer(const FrameInfo& frame)
     }
     else if (trailType_ == TT_BONE)
     {
-        for (unsigned i = 0; i < numPoints_; ++i)
+        for (unsigned i = 0; i < numPoints; ++i)
         {
             TrailPoint& point = *sortedPoints_[i];
 
@@ -806,9 +832,6 @@ void RibbonTrail::UpdateVertexBuffer(const FrameInfo& frame)
             dest += 26;
         }
     }
-
-    vertexBuffer_->Unlock();
-    vertexBuffer_->ClearDataLost();
 }
 
 void RibbonTrail::SetLifetime(float time)
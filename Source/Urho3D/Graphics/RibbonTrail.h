@@ -228,6 +228,8 @@ private:
     void UpdateBufferSize();
     /// Rewrite RibbonTrail vertex buffer.
     void UpdateVertexBuffer(const FrameInfo& frame);
+    /// Generate vertex data from the trail points, sorted back to front if a camera is given. Does not access the GPU.
+    void UpdateVertexData(Camera* sortCamera);
     /// Update/Rebuild tail mesh only if position changed (called by UpdateBatches()).
     void UpdateTail(float timeStep);
     /// Geometry.
@@ -272,6 +274,10 @@ private:
     Vector3 previousOffset_;
     /// Trail pointers for sorting.
     ea::vector<TrailPoint*> sortedPoints_;
+    /// Generated vertex data.
+    ea::vector<float> vertexData_;
+    /// Number of points the vertex data was generated from, zero if not generated.
+    unsigned vertexDataPoints_;
     /// Force update flag (ignore animation LOD momentarily).
     bool forceUpdate_;
     /// Currently emitting flag.
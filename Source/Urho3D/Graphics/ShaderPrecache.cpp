@@ -37,30 +37,20 @@ namespace Urho3D
 
 ShaderPrecache::ShaderPrecache(Context* context, const ea::string& fileName) :
     Object(context),
-    fileName_(fileName),
-    xmlFile_(context)
+    fileName_(fileName)
 {
     if (GetSubsystem<FileSystem>()->FileExists(fileName))
     {
         // If file exists, read the already listed combinations
+        XMLFile xmlFile(context_);
         File source(context_, fileName);
-        xmlFile_.Load(source);
+        if (xmlFile.Load(source))
+            ReadCombinations(xmlFile.GetRoot(), combinations_);
 
-        XMLElement shader = xmlFile_.GetRoot().GetChild("shader");
-        while (shader)
-        {
-            ea::string oldCombination = shader.GetAttribute("vs") + " " + shader.GetAttribute("vsdefines") + " " +
-                                    shader.GetAttribute("ps") + " " + shader.GetAttribute("psdefines");
-            usedCombinations_.insert(oldCombination);
-
-            shader = shader.GetNext("shader");
-        }
+        for (unsigned i = 0; i < combinations_.size(); ++i)
+            combinationIndices_[combinations_[i].GetKey()] = i;
     }
 
-    // If no file yet or loading failed, create the root element now
-    if (!xmlFile_.GetRoot())
-        xmlFile_.CreateRoot("shaders");
-
     URHO3D_LOGINFO("Begin dumping shaders to " + fileName_);
 }
 
@@ -68,11 +58,15 @@ ShaderPrecache::~ShaderPrecache()
 {
     URHO3D_LOGINFO("End dumping shaders");
 
-    if (usedCombinations_.empty())
+    if (combinations_.empty())
         return;
 
+    XMLFile xmlFile(context_);
+    XMLElement root = xmlFile.CreateRoot("shaders");
+    WriteCombinations(root, combinations_);
+
     File dest(context_, fileName_, FILE_WRITE);
-    xmlFile_.Save(dest);
+    xmlFile.Save(dest);
 }
 
 void ShaderPrecache::StoreShaders(ShaderVariation* vs, ShaderVariation* ps)
@@ -82,26 +76,99 @@ void ShaderPrecache::StoreShaders(ShaderVariation* vs, ShaderVariation* ps)
 
     // Check for duplicate using pointers first (fast)
     ea::pair<ShaderVariation*, ShaderVariation*> shaderPair = ea::make_pair(vs, ps);
-    if (usedPtrCombinations_.contains(shaderPair))
+    auto ptrIter = ptrCombinationIndices_.find(shaderPair);
+    if (ptrIter != ptrCombinationIndices_.end())
+    {
+        ++combinations_[ptrIter->second].numUses_;
         return;
-    usedPtrCombinations_.insert(shaderPair);
+    }
 
-    ea::string vsName = vs->GetName();
-    ea::string psName = ps->GetName();
-    const ea::string& vsDefines = vs->GetDefines();
-    const ea::string& psDefines = ps->GetDefines();
+    ShaderCombinationUsage combination;
+    combination.vs_ = vs->GetName();
+    combination.vsDefines_ = vs->GetDefines();
+    combination.ps_ = ps->GetName();
+    combination.psDefines_ = ps->GetDefines();
 
     // Check for duplicate using strings (needed for combinations loaded from existing file)
-    ea::string newCombination = vsName + " " + vsDefines + " " + psName + " " + psDefines;
-    if (usedCombinations_.contains(newCombination))
-        return;
-    usedCombinations_.insert(newCombination);
+    const ea::string key = combination.GetKey();
+    auto iter = combinationIndices_.find(key);
+    if (iter == combinationIndices_.end())
+    {
+        iter = combinationIndices_.emplace(key, combinations_.size()).first;
+        combinations_.push_back(combination);
+    }
+    ptrCombinationIndices_[shaderPair] = iter->second;
+
+    ShaderCombinationUsage& usage = combinations_[iter->second];
+    ++usage.numUses_;
+
+    // Shaders are compiled before they are set, so the compile times are known by now
+    auto vsTime = compileTimes_.find(vs);
+    if (vsTime != compileTimes_.end())
+        usage.vsCompileUSec_ = vsTime->second;
+    auto psTime = compileTimes_.find(ps);
+    if (psTime != compileTimes_.end())
+        usage.psCompileUSec_ = psTime->second;
+}
 
-    XMLElement shaderElem = xmlFile_.GetRoot().CreateChild("shader");
-    shaderElem.SetAttribute("vs", vsName);
-    shaderElem.SetAttribute("vsdefines", vsDefines);
-    shaderElem.SetAttribute("ps", psName);
-    shaderElem.SetAttribute("psdefines", psDefines);
+void ShaderPrecache::StoreCompileTime(ShaderVariation* variation, long long compileUSec)
+{
+    if (variation)
+        compileTimes_[variation] = compileUSec;
+}
+
+void ShaderPrecache::ReadCombinations(const XMLElement& root, ea::vector<ShaderCombinationUsage>& combinations)
+{
+    ea::unordered_map<ea::string, unsigned> indices;
+    for (unsigned i = 0; i < combinations.size(); ++i)
+        indices[combinations[i].GetKey()] = i;
+
+    XMLElement shader = root.GetChild("shader");
+    while (shader)
+    {
+        ShaderCombinationUsage combination;
+        combination.vs_ = shader.GetAttribute("vs");
+        combination.vsDefines_ = shader.GetAttribute("vsdefines");
+        combination.ps_ = shader.GetAttribute("ps");
+        combination.psDefines_ = shader.GetAttribute("psdefines");
+        // Files written before usage was recorded still list every combination as used
+        combination.numUses_ = shader.HasAttribute("uses") ? shader.GetUInt64("uses") : 1;
+        combination.vsCompileUSec_ = shader.GetInt64("vstime");
+        combination.psCompileUSec_ = shader.GetInt64("pstime");
+
+        auto iter = indices.find(combination.GetKey());
+        if (iter == indices.end())
+        {
+            indices[combination.GetKey()] = combinations.size();
+            combinations.push_back(combination);
+        }
+        else
+        {
+            ShaderCombinationUsage& existing = combinations[iter->second];
+            existing.numUses_ += combination.numUses_;
+            existing.vsCompileUSec_ = Max(existing.vsCompileUSec_, combination.vsCompileUSec_);
+            existing.psCompileUSec_ = Max(existing.psCompileUSec_, combination.psCompileUSec_);
+        }
+
+        shader = shader.GetNext("shader");
+    }
+}
+
+void ShaderPrecache::WriteCombinations(XMLElement& root, const ea::vector<ShaderCombinationUsage>& combinations)
+{
+    for (const ShaderCombinationUsage& combination : combinations)
+    {
+        XMLElement shaderElem = root.CreateChild("shader");
+        shaderElem.SetAttribute("vs", combination.vs_);
+        shaderElem.SetAttribute("vsdefines", combination.vsDefines_);
+        shaderElem.SetAttribute("ps", combination.ps_);
+        shaderElem.SetAttribute("psdefines", combination.psDefines_);
+        shaderElem.SetUInt64("uses", combination.numUses_);
+        if (combination.vsCompileUSec_)
+            shaderElem.SetInt64("vstime", combination.vsCompileUSec_);
+        if (combination.psCompileUSec_)
+            shaderElem.SetInt64("pstime", combination.psCompileUSec_);
+    }
 }
 
 void ShaderPrecache::LoadShaders(Graphics* graphics, Deserializer& source)
@@ -22,7 +22,7 @@
 
 #pragma once
 
-#include <EASTL/hash_set.h>
+#include <EASTL/unordered_map.h>
 
 #include "../Core/Object.h"
 #include "../Resource/XMLFile.h"
@@ -33,6 +33,28 @@ namespace Urho3D
 class Graphics;
 class ShaderVariation;
 
+/// Recorded usage of a vertex and pixel shader combination.
+struct URHO3D_API ShaderCombinationUsage
+{
+    /// Return unique key of the combination.
+    ea::string GetKey() const { return vs_ + " " + vsDefines_ + " " + ps_ + " " + psDefines_; }
+
+    /// Vertex shader name.
+    ea::string vs_;
+    /// Vertex shader defines.
+    ea::string vsDefines_;
+    /// Pixel shader name.
+    ea::string ps_;
+    /// Pixel shader defines.
+    ea::string psDefines_;
+    /// Number of times the combination was set, accumulated over recording sessions.
+    unsigned long long numUses_{};
+    /// Vertex shader compile time in microseconds. Zero if unknown.
+    long long vsCompileUSec_{};
+    /// Pixel shader compile time in microseconds. Zero if unknown.
+    long long psCompileUSec_{};
+};
+
 /// Utility class for collecting used shader combinations during runtime for precaching.
 class URHO3D_API ShaderPrecache : public Object
 {
@@ -46,19 +68,30 @@ public:
 
     /// Collect a shader combination. Called by Graphics when shaders have been set.
     void StoreShaders(ShaderVariation* vs, ShaderVariation* ps);
+    /// Collect compile time of a shader variation. Called by Graphics when a shader has been compiled.
+    void StoreCompileTime(ShaderVariation* variation, long long compileUSec);
+
+    /// Return collected combinations, including ones loaded from the existing file.
+    const ea::vector<ShaderCombinationUsage>& GetCombinations() const { return combinations_; }
 
     /// Load shaders from an XML file.
     static void LoadShaders(Graphics* graphics, Deserializer& source);
+    /// Read combinations from XML root element. Usage of already present combinations is accumulated.
+    static void ReadCombinations(const XMLElement& root, ea::vector<ShaderCombinationUsage>& combinations);
+    /// Write combinations to XML root element.
+    static void WriteCombinations(XMLElement& root, const ea::vector<ShaderCombinationUsage>& combinations);
 
 private:
     /// XML file name.
     ea::string fileName_;
-    /// XML file.
-    XMLFile xmlFile_;
-    /// Already encountered shader combinations, pointer version for fast queries.
-    ea::hash_set<ea::pair<ShaderVariation*, ShaderVariation*> > usedPtrCombinations_;
-    /// Already encountered shader combinations.
-    ea::hash_set<ea::string> usedCombinations_;
+    /// Encountered shader combinations.
+    ea::vector<ShaderCombinationUsage> combinations_;
+    /// Index of combination by shader pointers, for fast queries.
+    ea::unordered_map<ea::pair<ShaderVariation*, ShaderVariation*>, unsigned> ptrCombinationIndices_;
+    /// Index of combination by key, needed for combinations loaded from existing file.
+    ea::unordered_map<ea::string, unsigned> combinationIndices_;
+    /// Compile times of variations compiled while recording.
+    ea::unordered_map<ShaderVariation*, long long> compileTimes_;
 };
 
 }
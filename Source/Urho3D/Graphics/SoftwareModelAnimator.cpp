@@ -149,9 +149,20 @@ void SoftwareModelAnimator::ApplyVertexBufferSkinning(VertexBuffer* clonedBuffer
     Matrix3x4 matrix;
     for (unsigned vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
     {
-        matrix = worldTransforms[indicesData[0]] * weightsData[0];
-        for (unsigned boneIndex = 1; boneIndex < numBones_; ++boneIndex)
-            matrix = matrix + worldTransforms[indicesData[boneIndex]] * weightsData[boneIndex];
+        // Skip influences with zero weight, most vertices are affected by fewer bones than allowed
+        unsigned firstBone = 0;
+        while (firstBone + 1 < numBones_ && weightsData[firstBone] == 0.0f)
+            ++firstBone;
+
+        if (weightsData[firstBone] == 1.0f)
+            matrix = worldTransforms[indicesData[firstBone]];
+        else
+            matrix = worldTransforms[indicesData[firstBone]] * weightsData[firstBone];
+        for (unsigned boneIndex = firstBone + 1; boneIndex < numBones_; ++boneIndex)
+        {
+            if (weightsData[boneIndex] != 0.0f)
+                matrix = matrix + worldTransforms[indicesData[boneIndex]] * weightsData[boneIndex];
+        }
 
         Vector3& position = *reinterpret_cast<Vector3*>(positionsData);
         position = matrix * position;
@@ -183,9 +194,22 @@ void SoftwareModelAnimator::ApplyVertexBufferSkinning(VertexBuffer* clonedBuffer
 
 void SoftwareModelAnimator::Commit()
 {
-    for (VertexBuffer* clonedVertexBuffer : vertexBuffers_)
+    for (unsigned i = 0; i < vertexBuffers_.size(); ++i)
     {
-        if (clonedVertexBuffer)
+        VertexBuffer* clonedVertexBuffer = vertexBuffers_[i];
+        if (!clonedVertexBuffer)
+            continue;
+
+        // If only morphing, upload just the morphed range of vertices
+        const unsigned morphRangeStart = originalModel_->GetMorphRangeStart(i);
+        const unsigned morphRangeCount = originalModel_->GetMorphRangeCount(i);
+        if (!skinned_ && morphRangeCount)
+        {
+            const unsigned char* rangeData = clonedVertexBuffer->GetShadowData()
+                + morphRangeStart * clonedVertexBuffer->GetVertexSize();
+            clonedVertexBuffer->SetDataRange(rangeData, morphRangeStart, morphRangeCount);
+        }
+        else
             clonedVertexBuffer->SetData(clonedVertexBuffer->GetShadowData());
     }
 }
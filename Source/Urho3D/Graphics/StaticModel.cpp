@@ -28,6 +28,7 @@
 #include "../Graphics/Batch.h"
 #include "../Graphics/Camera.h"
 #include "../Graphics/Geometry.h"
+#include "../Graphics/IndexBuffer.h"
 #include "../Graphics/Material.h"
 #include "../Graphics/OcclusionBuffer.h"
 #include "../Graphics/OctreeQuery.h"
@@ -67,6 +68,8 @@ void StaticModel::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Draw Distance", GetDrawDistance, SetDrawDistance, float, 0.0f, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Shadow Distance", GetShadowDistance, SetShadowDistance, float, 0.0f, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("LOD Bias", GetLodBias, SetLodBias, float, 1.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("LOD Hysteresis", GetLodHysteresis, SetLodHysteresis, float, 0.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Cluster Culling", GetClusterCulling, SetClusterCulling, bool, false, AM_DEFAULT);
     URHO3D_COPY_BASE_ATTRIBUTES(Drawable);
     URHO3D_ATTRIBUTE("Occlusion LOD Level", int, occlusionLodLevel_, M_MAX_UNSIGNED, AM_DEFAULT);
     URHO3D_ATTRIBUTE_EX("Bake Lightmap", bool, bakeLightmap_, UpdateBatchesLightmaps, false, AM_DEFAULT);
@@ -101,7 +104,7 @@ void StaticModel::ProcessRayQuery(const RayOctreeQuery& query, ea::vector<RayQue
 
             for (unsigned i = 0; i < batches_.size(); ++i)
             {
-                Geometry* geometry = batches_[i].geometry_;
+                Geometry* geometry = geometries_[i][geometryData_[i].lodLevel_];
                 if (geometry)
                 {
                     Vector3 geometryNormal;
@@ -148,13 +151,59 @@ void StaticModel::UpdateBatches(const FrameInfo& frame)
     }
 
     float scale = worldBoundingBox.Size().DotProduct(DOT_SCALE);
-    float newLodDistance = frame.camera_->GetLodDistance(distance_, scale, lodBias_);
+    float newLodDistance = frame.camera_->GetLodDistance(distance_, scale, lodBias_, frame.viewSize_);
 
     if (newLodDistance != lodDistance_)
     {
         lodDistance_ = newLodDistance;
         CalculateLodLevels();
     }
+
+    if (!clusterData_.empty())
+        CullClusters(frame);
+}
+
+void StaticModel::UpdateGeometry(const FrameInfo& frame)
+{
+    ea::vector<unsigned char> indexData;
+    for (unsigned i = 0; i < clusterData_.size(); ++i)
+    {
+        StaticModelClusterData& data = clusterData_[i];
+        if (!data.indexBuffer_ || !(data.dirty_ || data.indexBuffer_->IsDataLost()))
+            continue;
+
+        // Copy index ranges of the visible clusters from the original geometry
+        Geometry* sourceGeometry = geometries_[i][0];
+        const IndexBuffer* sourceBuffer = sourceGeometry->GetIndexBuffer();
+        const unsigned indexSize = sourceBuffer->GetIndexSize();
+        const ea::vector<GeometryCluster>& clusters = model_->GetGeometryClusters(i);
+
+        unsigned numIndices = 0;
+        indexData.resize(data.indexBuffer_->GetIndexCount() * indexSize);
+        for (unsigned clusterIndex : data.visibleClusters_)
+        {
+            const GeometryCluster& cluster = clusters[clusterIndex];
+            memcpy(&indexData[numIndices * indexSize], sourceBuffer->GetShadowData() + cluster.indexStart_ * indexSize,
+                cluster.indexCount_ * indexSize);
+            numIndices += cluster.indexCount_;
+        }
+
+        if (numIndices)
+            data.indexBuffer_->SetDataRange(indexData.data(), 0, numIndices, true);
+        data.geometry_->SetDrawRange(sourceGeometry->GetPrimitiveType(), 0, numIndices, sourceGeometry->GetVertexStart(),
+            sourceGeometry->GetVertexCount());
+        data.dirty_ = false;
+    }
+}
+
+UpdateGeometryType StaticModel::GetUpdateGeometryType()
+{
+    for (const StaticModelClusterData& data : clusterData_)
+    {
+        if (data.dirty_ || (data.indexBuffer_ && data.indexBuffer_->IsDataLost()))
+            return UPDATE_MAIN_THREAD;
+    }
+    return UPDATE_NONE;
 }
 
 Geometry* StaticModel::GetLodGeometry(unsigned batchIndex, unsigned level)
@@ -162,11 +211,11 @@ Geometry* StaticModel::GetLodGeometry(unsigned batchIndex, unsigned level)
     if (batchIndex >= geometries_.size())
         return nullptr;
 
-    // If level is out of range, use visible geometry
+    // If level is out of range, use visible geometry. Batch geometry may contain only part of the triangles due to cluster culling
     if (level < geometries_[batchIndex].size())
         return geometries_[batchIndex][level];
     else
-        return batches_[batchIndex].geometry_;
+        return geometries_[batchIndex][geometryData_[batchIndex].lodLevel_];
 }
 
 unsigned StaticModel::GetNumOccluderTriangles()
@@ -273,6 +322,7 @@ void StaticModel::SetModel(Model* model)
         SetBoundingBox(BoundingBox());
     }
 
+    UpdateClusterData();
     MarkNetworkUpdate();
 }
 
@@ -303,6 +353,22 @@ void StaticModel::SetOcclusionLodLevel(unsigned level)
     MarkNetworkUpdate();
 }
 
+void StaticModel::SetLodHysteresis(float hysteresis)
+{
+    lodHysteresis_ = Clamp(hysteresis, 0.0f, 0.5f);
+    MarkNetworkUpdate();
+}
+
+void StaticModel::SetClusterCulling(bool enable)
+{
+    if (enable == clusterCulling_)
+        return;
+
+    clusterCulling_ = enable;
+    UpdateClusterData();
+    MarkNetworkUpdate();
+}
+
 void StaticModel::ApplyMaterialList(const ea::string& fileName)
 {
     ea::string useFileName = fileName;
@@ -350,7 +416,7 @@ bool StaticModel::IsInsideLocal(const Vector3& point) const
 
     for (unsigned i = 0; i < batches_.size(); ++i)
     {
-        Geometry* geometry = batches_[i].geometry_;
+        Geometry* geometry = geometries_[i][geometryData_[i].lodLevel_];
         if (geometry)
         {
             if (geometry->IsInside(localRay))
@@ -434,11 +500,16 @@ void StaticModel::CalculateLodLevels()
         if (batchGeometries.size() <= 1)
             continue;
 
+        // Boundaries are pushed away from the current level, so small camera movement does not flip it back and forth
+        const unsigned currentLodLevel = geometryData_[i].lodLevel_;
         unsigned j;
 
         for (j = 1; j < batchGeometries.size(); ++j)
         {
-            if (batchGeometries[j] && lodDistance_ <= batchGeometries[j]->GetLodDistance())
+            if (!batchGeometries[j])
+                continue;
+            const float hysteresis = j > currentLodLevel ? 1.0f + lodHysteresis_ : 1.0f - lodHysteresis_;
+            if (lodDistance_ <= batchGeometries[j]->GetLodDistance() * hysteresis)
                 break;
         }
 
@@ -451,6 +522,112 @@ void StaticModel::CalculateLodLevels()
     }
 }
 
+void StaticModel::UpdateClusterData()
+{
+    // Restore original geometries before dropping cluster geometries
+    for (unsigned i = 0; i < clusterData_.size() && i < batches_.size(); ++i)
+    {
+        if (batches_[i].geometry_ == clusterData_[i].geometry_)
+            batches_[i].geometry_ = geometries_[i][geometryData_[i].lodLevel_];
+    }
+    clusterData_.clear();
+
+    if (!clusterCulling_ || !model_ || !model_->HasGeometryClusters())
+        return;
+
+    clusterData_.resize(geometries_.size());
+    for (unsigned i = 0; i < geometries_.size(); ++i)
+    {
+        Geometry* sourceGeometry = geometries_[i][0];
+        if (!sourceGeometry || model_->GetGeometryClusters(i).empty())
+            continue;
+
+        IndexBuffer* sourceBuffer = sourceGeometry->GetIndexBuffer();
+        if (!sourceBuffer || !sourceBuffer->GetShadowData())
+            continue;
+
+        StaticModelClusterData& data = clusterData_[i];
+        data.indexBuffer_ = context_->CreateObject<IndexBuffer>();
+        data.indexBuffer_->SetSize(sourceGeometry->GetIndexCount(), sourceBuffer->GetIndexSize() == sizeof(unsigned), true);
+
+        data.geometry_ = context_->CreateObject<Geometry>();
+        data.geometry_->SetNumVertexBuffers(sourceGeometry->GetNumVertexBuffers());
+        for (unsigned j = 0; j < sourceGeometry->GetNumVertexBuffers(); ++j)
+            data.geometry_->SetVertexBuffer(j, sourceGeometry->GetVertexBuffer(j));
+        data.geometry_->SetIndexBuffer(data.indexBuffer_);
+        data.geometry_->SetLodDistance(sourceGeometry->GetLodDistance());
+    }
+}
+
+void StaticModel::CullClusters(const FrameInfo& frame)
+{
+    // Batch geometry is shared by all views, so model seen by several cameras in one frame is drawn whole
+    if (frame.frameNumber_ != clusterCullFrameNumber_)
+    {
+        clusterCullFrameNumber_ = frame.frameNumber_;
+        clusterCullCamera_ = frame.camera_;
+        clusterCullSkipped_ = false;
+    }
+    else if (frame.camera_ != clusterCullCamera_)
+        clusterCullSkipped_ = true;
+
+    // Shadow casters reuse the batches of the main view, so their hidden clusters still cast shadows
+    const bool cullClusters = !clusterCullSkipped_ && !castShadows_;
+
+    const Matrix3x4 inverseWorldTransform = node_->GetWorldTransform().Inverse();
+    const Frustum localFrustum = frame.camera_->GetFrustum().Transformed(inverseWorldTransform);
+    const Vector3 localCameraPosition = inverseWorldTransform * frame.camera_->GetNode()->GetWorldPosition();
+    const Vector3 localCameraDirection = (inverseWorldTransform * Vector4(frame.camera_->GetNode()->GetWorldDirection(), 0.0f)).Normalized();
+    const bool isOrthographic = frame.camera_->IsOrthographic();
+
+    for (unsigned i = 0; i < clusterData_.size(); ++i)
+    {
+        StaticModelClusterData& data = clusterData_[i];
+        if (!data.geometry_)
+            continue;
+
+        Geometry* lodGeometry = geometries_[i][geometryData_[i].lodLevel_];
+        bool useClusters = cullClusters && geometryData_[i].lodLevel_ == 0;
+        if (useClusters)
+        {
+            const ea::vector<GeometryCluster>& clusters = model_->GetGeometryClusters(i);
+            data.newVisibleClusters_.clear();
+            for (unsigned j = 0; j < clusters.size(); ++j)
+            {
+                const GeometryCluster& cluster = clusters[j];
+                const Sphere& sphere = cluster.boundingSphere_;
+                if (localFrustum.IsInsideFast(sphere) == OUTSIDE)
+                    continue;
+
+                if (cluster.coneCutoff_ < 1.0f)
+                {
+                    const Vector3 offset = isOrthographic ? localCameraDirection : sphere.center_ - localCameraPosition;
+                    const float distance = isOrthographic ? 1.0f : offset.Length();
+                    const float radius = isOrthographic ? 0.0f : sphere.radius_;
+                    if (offset.DotProduct(cluster.coneAxis_) >= cluster.coneCutoff_ * distance + radius)
+                        continue;
+                }
+
+                data.newVisibleClusters_.push_back(j);
+            }
+
+            if (data.newVisibleClusters_.size() == clusters.size())
+                useClusters = false;
+            else if (data.newVisibleClusters_ != data.visibleClusters_)
+            {
+                data.visibleClusters_.swap(data.newVisibleClusters_);
+                data.dirty_ = true;
+            }
+        }
+
+        // Nothing to draw if all clusters are culled
+        if (!useClusters)
+            batches_[i].geometry_ = lodGeometry;
+        else
+            batches_[i].geometry_ = data.visibleClusters_.empty() ? nullptr : data.geometry_.Get();
+    }
+}
+
 void StaticModel::UpdateBatchesLightmaps()
 {
     if (GetBakeLightmapEffective())
@@ -27,6 +27,7 @@
 namespace Urho3D
 {
 
+class IndexBuffer;
 class Model;
 
 /// Static model per-geometry extra data.
@@ -38,6 +39,21 @@ struct StaticModelGeometryData
     unsigned lodLevel_;
 };
 
+/// Static model per-geometry cluster culling data.
+struct StaticModelClusterData
+{
+    /// Geometry drawing only the visible clusters.
+    SharedPtr<Geometry> geometry_;
+    /// Dynamic index buffer of the visible clusters.
+    SharedPtr<IndexBuffer> indexBuffer_;
+    /// Indices of the clusters currently in the index buffer.
+    ea::vector<unsigned> visibleClusters_;
+    /// Indices of the clusters visible in the latest cull pass.
+    ea::vector<unsigned> newVisibleClusters_;
+    /// Whether the index buffer needs to be updated.
+    bool dirty_{};
+};
+
 /// Static model component.
 class URHO3D_API StaticModel : public Drawable
 {
@@ -56,6 +72,10 @@ public:
     void ProcessRayQuery(const RayOctreeQuery& query, ea::vector<RayQueryResult>& results) override;
     /// Calculate distance and prepare batches for rendering. May be called from worker thread(s), possibly re-entrantly.
     void UpdateBatches(const FrameInfo& frame) override;
+    /// Prepare geometry for rendering. Called from a worker thread if possible (no GPU update).
+    void UpdateGeometry(const FrameInfo& frame) override;
+    /// Return whether a geometry update is necessary, and if it can happen in a worker thread.
+    UpdateGeometryType GetUpdateGeometryType() override;
     /// Return the geometry for a specific LOD level.
     Geometry* GetLodGeometry(unsigned batchIndex, unsigned level) override;
     /// Return number of occlusion geometry triangles.
@@ -75,6 +95,12 @@ public:
     /// Set occlusion LOD level. By default (M_MAX_UNSIGNED) same as visible.
     /// @property
     void SetOcclusionLodLevel(unsigned level);
+    /// Set whether to draw only the triangle clusters that are inside the view frustum and face the camera. Requires a model with clusters, has no effect on shadow casters.
+    /// @property
+    void SetClusterCulling(bool enable);
+    /// Set relative margin around LOD distances that has to be crossed before LOD level changes, to avoid switching back and forth at the boundary.
+    /// @property
+    void SetLodHysteresis(float hysteresis);
     /// Apply default materials from a material list file. If filename is empty (default), the model's resource name with extension .txt will be used.
     void ApplyMaterialList(const ea::string& fileName = EMPTY_STRING);
 
@@ -96,6 +122,12 @@ public:
     /// Return occlusion LOD level.
     /// @property
     unsigned GetOcclusionLodLevel() const { return occlusionLodLevel_; }
+    /// Return whether cluster culling is enabled.
+    /// @property
+    bool GetClusterCulling() const { return clusterCulling_; }
+    /// Return relative LOD hysteresis.
+    /// @property
+    float GetLodHysteresis() const { return lodHysteresis_; }
 
     /// Determines if the given world space point is within the model geometry.
     bool IsInside(const Vector3& point) const;
@@ -143,6 +175,10 @@ protected:
     void CalculateLodLevels();
     /// Update lightmaps in batches.
     void UpdateBatchesLightmaps();
+    /// Create geometries for cluster culling.
+    void UpdateClusterData();
+    /// Cull clusters of the first LOD level against the camera and select batch geometries.
+    void CullClusters(const FrameInfo& frame);
 
     /// Extra per-geometry data.
     ea::vector<StaticModelGeometryData> geometryData_;
@@ -154,6 +190,18 @@ protected:
     unsigned occlusionLodLevel_;
     /// Material list attribute.
     mutable ResourceRefList materialsAttr_;
+    /// Relative LOD hysteresis.
+    float lodHysteresis_{};
+    /// Whether cluster culling is enabled.
+    bool clusterCulling_{};
+    /// Per-geometry cluster culling data, empty if cluster culling is not used.
+    ea::vector<StaticModelClusterData> clusterData_;
+    /// Frame number of the latest cull pass.
+    unsigned clusterCullFrameNumber_{ M_MAX_UNSIGNED };
+    /// Camera of the latest cull pass.
+    Camera* clusterCullCamera_{};
+    /// Whether clusters are not culled this frame, because the model is seen by several cameras.
+    bool clusterCullSkipped_{};
 
     /// Whether the lightmap is enabled.
     bool bakeLightmap_{};
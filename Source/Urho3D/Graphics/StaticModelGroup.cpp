@@ -60,6 +60,7 @@ void StaticModelGroup::RegisterObject(Context* context)
     context->RegisterFactory<StaticModelGroup>(GEOMETRY_CATEGORY);
 
     URHO3D_COPY_BASE_ATTRIBUTES(StaticModel);
+    URHO3D_ACCESSOR_ATTRIBUTE("Instance Draw Distance", GetInstanceDrawDistance, SetInstanceDrawDistance, float, 0.0f, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Instance Nodes", GetNodeIDsAttr, SetNodeIDsAttr,
         VariantVector, Variant::emptyVariantVector, AM_DEFAULT | AM_NODEIDVECTOR)
         .SetMetadata(AttributeMetadata::P_VECTOR_STRUCT_ELEMENTS, instanceNodesStructureElementNames);
@@ -173,24 +174,33 @@ void StaticModelGroup::UpdateBatches(const FrameInfo& frame)
     const Matrix3x4& worldTransform = node_->GetWorldTransform();
     distance_ = frame.camera_->GetDistance(worldBoundingBox.Center());
 
+    const Matrix3x4* transforms = numWorldTransforms_ ? &worldTransforms_[0] : &Matrix3x4::IDENTITY;
+    unsigned numTransforms = numWorldTransforms_;
+    if (instanceDrawDistance_ > 0.0f)
+    {
+        UpdateVisibleTransforms(frame);
+        transforms = !visibleTransforms_.empty() ? &visibleTransforms_[0] : &Matrix3x4::IDENTITY;
+        numTransforms = visibleTransforms_.size();
+    }
+
     if (batches_.size() > 1)
     {
         for (unsigned i = 0; i < batches_.size(); ++i)
         {
             batches_[i].distance_ = frame.camera_->GetDistance(worldTransform * geometryData_[i].center_);
-            batches_[i].worldTransform_ = numWorldTransforms_ ? &worldTransforms_[0] : &Matrix3x4::IDENTITY;
-            batches_[i].numWorldTransforms_ = numWorldTransforms_;
+            batches_[i].worldTransform_ = transforms;
+            batches_[i].numWorldTransforms_ = numTransforms;
         }
     }
     else if (batches_.size() == 1)
     {
         batches_[0].distance_ = distance_;
-        batches_[0].worldTransform_ = numWorldTransforms_ ? &worldTransforms_[0] : &Matrix3x4::IDENTITY;
-        batches_[0].numWorldTransforms_ = numWorldTransforms_;
+        batches_[0].worldTransform_ = transforms;
+        batches_[0].numWorldTransforms_ = numTransforms;
     }
 
     float scale = worldBoundingBox.Size().DotProduct(DOT_SCALE);
-    float newLodDistance = frame.camera_->GetLodDistance(distance_, scale, lodBias_);
+    float newLodDistance = frame.camera_->GetLodDistance(distance_, scale, lodBias_, frame.viewSize_);
 
     if (newLodDistance != lodDistance_)
     {
@@ -313,6 +323,13 @@ void StaticModelGroup::RemoveAllInstanceNodes()
     UpdateNumTransforms();
 }
 
+void StaticModelGroup::SetInstanceDrawDistance(float distance)
+{
+    instanceDrawDistance_ = Max(distance, 0.0f);
+    visibleTransformsFrameNumber_ = M_MAX_UNSIGNED;
+    MarkNetworkUpdate();
+}
+
 Node* StaticModelGroup::GetInstanceNode(unsigned index) const
 {
     return index < instanceNodes_.size() ? instanceNodes_[index].Get() : nullptr;
@@ -416,4 +433,22 @@ void StaticModelGroup::UpdateNodeIDs() const
     nodeIDsDirty_ = false;
 }
 
+void StaticModelGroup::UpdateVisibleTransforms(const FrameInfo& frame)
+{
+    // Batches of all views and shadow casters of the frame point to the same transforms, so the storage must not be
+    // reallocated after the first view of the frame
+    MutexLock lock(visibleTransformsMutex_);
+    if (visibleTransformsFrameNumber_ == frame.frameNumber_)
+        return;
+
+    visibleTransformsFrameNumber_ = frame.frameNumber_;
+    visibleTransforms_.clear();
+    for (unsigned i = 0; i < numWorldTransforms_; ++i)
+    {
+        const Matrix3x4& transform = worldTransforms_[i];
+        if (frame.camera_->GetDistance(transform * boundingBox_.Center()) <= instanceDrawDistance_)
+            visibleTransforms_.push_back(transform);
+    }
+}
+
 }
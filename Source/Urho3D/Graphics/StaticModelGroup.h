@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "../Core/Mutex.h"
 #include "../Graphics/StaticModel.h"
 
 namespace Urho3D
@@ -58,6 +59,9 @@ public:
     void RemoveInstanceNode(Node* node);
     /// Remove all instance scene nodes.
     void RemoveAllInstanceNodes();
+    /// Set distance from the camera beyond which individual instances are not drawn, e.g. when they are replaced by impostors. Zero disables. Evaluated once per frame from the first camera that sees the group.
+    /// @property
+    void SetInstanceDrawDistance(float distance);
 
     /// Return number of instance nodes.
     /// @property
@@ -67,6 +71,10 @@ public:
     /// @property{get_instanceNodes}
     Node* GetInstanceNode(unsigned index) const;
 
+    /// Return instance draw distance.
+    /// @property
+    float GetInstanceDrawDistance() const { return instanceDrawDistance_; }
+
     /// Set node IDs attribute.
     void SetNodeIDsAttr(const VariantVector& value);
 
@@ -84,6 +92,8 @@ private:
     void UpdateNumTransforms();
     /// Update node IDs attribute from the actual nodes.
     void UpdateNodeIDs() const;
+    /// Collect transforms of instances within instance draw distance, once per frame.
+    void UpdateVisibleTransforms(const FrameInfo& frame);
 
     /// Instance nodes.
     ea::vector<WeakPtr<Node> > instanceNodes_;
@@ -93,6 +103,14 @@ private:
     mutable VariantVector nodeIDsAttr_;
     /// Number of valid instance node transforms.
     unsigned numWorldTransforms_{};
+    /// Instance draw distance.
+    float instanceDrawDistance_{};
+    /// World transforms of instances within instance draw distance.
+    ea::vector<Matrix3x4> visibleTransforms_;
+    /// Frame number on which visible transforms were collected.
+    unsigned visibleTransformsFrameNumber_{ M_MAX_UNSIGNED };
+    /// Mutex for collecting visible transforms from worker threads.
+    Mutex visibleTransformsMutex_;
     /// Whether node IDs have been set and nodes should be searched for during ApplyAttributes.
     mutable bool nodesDirty_{};
     /// Whether nodes have been manipulated by the API and node ID attribute should be refreshed.
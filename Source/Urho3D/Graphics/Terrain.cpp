@@ -24,6 +24,7 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DrawableEvents.h"
 #include "../Graphics/Geometry.h"
 #include "../Graphics/IndexBuffer.h"
@@ -57,6 +58,15 @@ static const unsigned STITCH_SOUTH = 2;
 static const unsigned STITCH_WEST = 4;
 static const unsigned STITCH_EAST = 8;
 
+inline float GetHeightMapPixel(const unsigned char* pixel, unsigned imgComps, float verticalSpacing)
+{
+    // If more than 1 component, use the green channel for more accuracy
+    if (imgComps == 1)
+        return (float)pixel[0] * verticalSpacing;
+    else
+        return ((float)pixel[0] + (float)pixel[1] / 256.0f) * verticalSpacing;
+}
+
 inline void GrowUpdateRegion(IntRect& updateRegion, int x, int y)
 {
     if (updateRegion.left_ < 0)
@@ -524,6 +534,91 @@ void Terrain::ApplyHeightMap()
         CreateGeometry();
 }
 
+void Terrain::ApplyHeightMapRegion(const IntRect& region)
+{
+    if (!heightMap_)
+        return;
+
+    // Region updates require the existing geometry to match the heightmap size
+    const IntVector2 numPatches((heightMap_->GetWidth() - 1) / patchSize_, (heightMap_->GetHeight() - 1) / patchSize_);
+    if (recreateTerrain_ || !heightData_ || numPatches != numPatches_ || patches_.size() != (unsigned)(numPatches_.x_ * numPatches_.y_)
+        || (smoothing_ && !sourceHeightData_))
+    {
+        ApplyHeightMap();
+        return;
+    }
+
+    URHO3D_PROFILE("ApplyHeightMapRegion");
+
+    // Convert from image pixels to height data vertices, which are reversed vertically
+    const int left = Max(region.left_, 0);
+    const int right = Min(region.right_, numVertices_.x_);
+    const int top = Max(region.top_, 0);
+    const int bottom = Min(region.bottom_, numVertices_.y_);
+    if (left >= right || top >= bottom)
+        return;
+
+    const unsigned char* src = heightMap_->GetData();
+    const unsigned imgComps = heightMap_->GetComponents();
+    const unsigned imgRow = heightMap_->GetWidth() * imgComps;
+    float* dest = smoothing_ ? sourceHeightData_.get() : heightData_.get();
+    IntRect updateRegion(-1, -1, -1, -1);
+
+    for (int y = top; y < bottom; ++y)
+    {
+        const int z = numVertices_.y_ - 1 - y;
+        for (int x = left; x < right; ++x)
+        {
+            const float newHeight = GetHeightMapPixel(&src[imgRow * y + imgComps * x], imgComps, spacing_.y_);
+            float& height = dest[z * numVertices_.x_ + x];
+            if (height != newHeight)
+            {
+                height = newHeight;
+                GrowUpdateRegion(updateRegion, x, z);
+            }
+        }
+    }
+
+    if (updateRegion.left_ < 0)
+        return;
+
+    // Smoothed heights depend on the neighboring source heights
+    if (smoothing_)
+    {
+        updateRegion.left_ = Max(updateRegion.left_ - 1, 0);
+        updateRegion.right_ = Min(updateRegion.right_ + 1, numVertices_.x_ - 1);
+        updateRegion.top_ = Max(updateRegion.top_ - 1, 0);
+        updateRegion.bottom_ = Min(updateRegion.bottom_ + 1, numVertices_.y_ - 1);
+
+        for (int z = updateRegion.top_; z <= updateRegion.bottom_; ++z)
+        {
+            for (int x = updateRegion.left_; x <= updateRegion.right_; ++x)
+            {
+                float smoothedHeight = (
+                    GetSourceHeight(x - 1, z - 1) + GetSourceHeight(x, z - 1) * 2.0f + GetSourceHeight(x + 1, z - 1) +
+                    GetSourceHeight(x - 1, z) * 2.0f + GetSourceHeight(x, z) * 4.0f + GetSourceHeight(x + 1, z) * 2.0f +
+                    GetSourceHeight(x - 1, z + 1) + GetSourceHeight(x, z + 1) * 2.0f + GetSourceHeight(x + 1, z + 1)
+                ) / 16.0f;
+
+                heightData_[z * numVertices_.x_ + x] = smoothedHeight;
+            }
+        }
+    }
+
+    const IntRect changedRegion = updateRegion;
+    RebuildPatches(GetDirtyPatches(updateRegion));
+
+    if (node_)
+    {
+        using namespace TerrainModified;
+
+        VariantMap& eventData = GetEventDataMap();
+        eventData[P_NODE] = node_;
+        eventData[P_REGION] = changedRegion;
+        node_->SendEvent(E_TERRAINMODIFIED, eventData);
+    }
+}
+
 Image* Terrain::GetHeightMap() const
 {
     return heightMap_;
@@ -668,107 +763,125 @@ void Terrain::CreatePatchGeometry(TerrainPatch* patch)
 {
     URHO3D_PROFILE("CreatePatchGeometry");
 
-    auto row = (unsigned)(patchSize_ + 1);
-    VertexBuffer* vertexBuffer = patch->GetVertexBuffer();
-    Geometry* geometry = patch->GetGeometry();
-    Geometry* maxLodGeometry = patch->GetMaxLodGeometry();
-    Geometry* occlusionGeometry = patch->GetOcclusionGeometry();
+    TerrainPatchGeometryData data;
+    BuildPatchGeometry(patch, data);
+    CommitPatchGeometry(patch, data);
+}
 
-    // Scale in lightmap is intentionally ignored here
-    // because lightmapper itself needs Terrain with lightmap UV but without lightmapping during rendering
-    VertexMaskFlags vertexMask{ MASK_POSITION | MASK_NORMAL | MASK_TEXCOORD1 | MASK_TANGENT };
-    if (bakeLightmap_)
-        vertexMask |= MASK_TEXCOORD2;
+void Terrain::BuildPatchGeometry(TerrainPatch* patch, TerrainPatchGeometryData& data) const
+{
+    URHO3D_PROFILE("BuildPatchGeometry");
 
-    if (vertexBuffer->GetVertexCount() != row * row || vertexBuffer->GetElementMask() != vertexMask)
-        vertexBuffer->SetSize(row * row, vertexMask);
+    auto row = (unsigned)(patchSize_ + 1);
+    const unsigned vertexSize = bakeLightmap_ ? 14 : 12;
 
-    ea::shared_array<unsigned char> cpuVertexData(new unsigned char[row * row * sizeof(Vector3)]);
-    ea::shared_array<unsigned char> occlusionCpuVertexData(new unsigned char[row * row * sizeof(Vector3)]);
+    data.vertexData_.resize(row * row * vertexSize);
+    data.positionData_.reset(new unsigned char[row * row * sizeof(Vector3)]);
+    data.occlusionPositionData_.reset(new unsigned char[row * row * sizeof(Vector3)]);
+    data.boundingBox_.Clear();
 
-    auto* vertexData = (float*)vertexBuffer->Lock(0, vertexBuffer->GetVertexCount());
-    auto* positionData = (float*)cpuVertexData.get();
-    auto* occlusionData = (float*)occlusionCpuVertexData.get();
-    BoundingBox box;
+    float* vertexData = data.vertexData_.data();
+    auto* positionData = (float*)data.positionData_.get();
+    auto* occlusionData = (float*)data.occlusionPositionData_.get();
+    BoundingBox& box = data.boundingBox_;
 
     unsigned occlusionLevel = occlusionLodLevel_;
     if (occlusionLevel > numLodLevels_ - 1)
         occlusionLevel = numLodLevels_ - 1;
 
-    if (vertexData)
-    {
-        const IntVector2& coords = patch->GetCoordinates();
-        unsigned lodExpand = (1u << (occlusionLevel)) - 1;
-        unsigned halfLodExpand = (1u << (occlusionLevel)) / 2;
+    const IntVector2& coords = patch->GetCoordinates();
+    unsigned lodExpand = (1u << (occlusionLevel)) - 1;
+    unsigned halfLodExpand = (1u << (occlusionLevel)) / 2;
 
-        for (unsigned z = 0; z <= patchSize_; ++z)
+    for (unsigned z = 0; z <= patchSize_; ++z)
+    {
+        for (unsigned x = 0; x <= patchSize_; ++x)
         {
-            for (unsigned x = 0; x <= patchSize_; ++x)
+            int xPos = coords.x_ * patchSize_ + x;
+            int zPos = coords.y_ * patchSize_ + z;
+
+            // Position
+            Vector3 position((float)x * spacing_.x_, GetRawHeight(xPos, zPos), (float)z * spacing_.z_);
+            *vertexData++ = position.x_;
+            *vertexData++ = position.y_;
+            *vertexData++ = position.z_;
+            *positionData++ = position.x_;
+            *positionData++ = position.y_;
+            *positionData++ = position.z_;
+
+            box.Merge(position);
+
+            // For vertices that are part of the occlusion LOD, calculate the minimum height in the neighborhood
+            // to prevent false positive occlusion due to inaccuracy between occlusion LOD & visible LOD
+            float minHeight = position.y_;
+            if (halfLodExpand > 0 && (x & lodExpand) == 0 && (z & lodExpand) == 0)
             {
-                int xPos = coords.x_ * patchSize_ + x;
-                int zPos = coords.y_ * patchSize_ + z;
-
-                // Position
-                Vector3 position((float)x * spacing_.x_, GetRawHeight(xPos, zPos), (float)z * spacing_.z_);
-                *vertexData++ = position.x_;
-                *vertexData++ = position.y_;
-                *vertexData++ = position.z_;
-                *positionData++ = position.x_;
-                *positionData++ = position.y_;
-                *positionData++ = position.z_;
-
-                box.Merge(position);
-
-                // For vertices that are part of the occlusion LOD, calculate the minimum height in the neighborhood
-                // to prevent false positive occlusion due to inaccuracy between occlusion LOD & visible LOD
-                float minHeight = position.y_;
-                if (halfLodExpand > 0 && (x & lodExpand) == 0 && (z & lodExpand) == 0)
+                int minX = Max(xPos - halfLodExpand, 0);
+                int maxX = Min(xPos + halfLodExpand, numVertices_.x_ - 1);
+                int minZ = Max(zPos - halfLodExpand, 0);
+                int maxZ = Min(zPos + halfLodExpand, numVertices_.y_ - 1);
+                for (int nZ = minZ; nZ <= maxZ; ++nZ)
                 {
-                    int minX = Max(xPos - halfLodExpand, 0);
-                    int maxX = Min(xPos + halfLodExpand, numVertices_.x_ - 1);
-                    int minZ = Max(zPos - halfLodExpand, 0);
-                    int maxZ = Min(zPos + halfLodExpand, numVertices_.y_ - 1);
-                    for (int nZ = minZ; nZ <= maxZ; ++nZ)
-                    {
-                        for (int nX = minX; nX <= maxX; ++nX)
-                            minHeight = Min(minHeight, GetRawHeight(nX, nZ));
-                    }
+                    for (int nX = minX; nX <= maxX; ++nX)
+                        minHeight = Min(minHeight, GetRawHeight(nX, nZ));
                 }
-                *occlusionData++ = position.x_;
-                *occlusionData++ = minHeight;
-                *occlusionData++ = position.z_;
-
-                // Normal
-                Vector3 normal = GetRawNormal(xPos, zPos);
-                *vertexData++ = normal.x_;
-                *vertexData++ = normal.y_;
-                *vertexData++ = normal.z_;
-
-                // Texture coordinate(s)
-                const Vector2 texCoord = HeightMapToUV({ xPos, numVertices_.y_ - 1 - zPos });
+            }
+            *occlusionData++ = position.x_;
+            *occlusionData++ = minHeight;
+            *occlusionData++ = position.z_;
+
+            // Normal
+            Vector3 normal = GetRawNormal(xPos, zPos);
+            *vertexData++ = normal.x_;
+            *vertexData++ = normal.y_;
+            *vertexData++ = normal.z_;
+
+            // Texture coordinate(s)
+            const Vector2 texCoord = HeightMapToUV({ xPos, numVertices_.y_ - 1 - zPos });
+            *vertexData++ = texCoord.x_;
+            *vertexData++ = texCoord.y_;
+
+            if (bakeLightmap_)
+            {
                 *vertexData++ = texCoord.x_;
                 *vertexData++ = texCoord.y_;
-
-                if (bakeLightmap_)
-                {
-                    *vertexData++ = texCoord.x_;
-                    *vertexData++ = texCoord.y_;
-                }
-
-                // Tangent
-                Vector3 xyz = (Vector3::RIGHT - normal * normal.DotProduct(Vector3::RIGHT)).Normalized();
-                *vertexData++ = xyz.x_;
-                *vertexData++ = xyz.y_;
-                *vertexData++ = xyz.z_;
-                *vertexData++ = 1.0f;
             }
+
+            // Tangent
+            Vector3 xyz = (Vector3::RIGHT - normal * normal.DotProduct(Vector3::RIGHT)).Normalized();
+            *vertexData++ = xyz.x_;
+            *vertexData++ = xyz.y_;
+            *vertexData++ = xyz.z_;
+            *vertexData++ = 1.0f;
         }
+    }
+}
 
-        vertexBuffer->Unlock();
+void Terrain::CommitPatchGeometry(TerrainPatch* patch, const TerrainPatchGeometryData& data)
+{
+    auto row = (unsigned)(patchSize_ + 1);
+    VertexBuffer* vertexBuffer = patch->GetVertexBuffer();
+    Geometry* geometry = patch->GetGeometry();
+    Geometry* maxLodGeometry = patch->GetMaxLodGeometry();
+    Geometry* occlusionGeometry = patch->GetOcclusionGeometry();
+
+    // Scale in lightmap is intentionally ignored here
+    // because lightmapper itself needs Terrain with lightmap UV but without lightmapping during rendering
+    VertexMaskFlags vertexMask{ MASK_POSITION | MASK_NORMAL | MASK_TEXCOORD1 | MASK_TANGENT };
+    if (bakeLightmap_)
+        vertexMask |= MASK_TEXCOORD2;
+
+    if (vertexBuffer->GetVertexCount() != row * row || vertexBuffer->GetElementMask() != vertexMask)
+        vertexBuffer->SetSize(row * row, vertexMask);
+
+    if (vertexBuffer->SetData(data.vertexData_.data()))
         vertexBuffer->ClearDataLost();
-    }
 
-    patch->SetBoundingBox(box);
+    patch->SetBoundingBox(data.boundingBox_);
+
+    unsigned occlusionLevel = occlusionLodLevel_;
+    if (occlusionLevel > numLodLevels_ - 1)
+        occlusionLevel = numLodLevels_ - 1;
 
     if (drawRanges_.size())
     {
@@ -776,18 +889,74 @@ void Terrain::CreatePatchGeometry(TerrainPatch* patch)
 
         geometry->SetIndexBuffer(indexBuffer_);
         geometry->SetDrawRange(TRIANGLE_LIST, drawRanges_[0].first, drawRanges_[0].second, false);
-        geometry->SetRawVertexData(cpuVertexData, MASK_POSITION);
+        geometry->SetRawVertexData(data.positionData_, MASK_POSITION);
         maxLodGeometry->SetIndexBuffer(indexBuffer_);
         maxLodGeometry->SetDrawRange(TRIANGLE_LIST, drawRanges_[0].first, drawRanges_[0].second, false);
-        maxLodGeometry->SetRawVertexData(cpuVertexData, MASK_POSITION);
+        maxLodGeometry->SetRawVertexData(data.positionData_, MASK_POSITION);
         occlusionGeometry->SetIndexBuffer(indexBuffer_);
         occlusionGeometry->SetDrawRange(TRIANGLE_LIST, drawRanges_[occlusionDrawRange].first, drawRanges_[occlusionDrawRange].second, false);
-        occlusionGeometry->SetRawVertexData(occlusionCpuVertexData, MASK_POSITION);
+        occlusionGeometry->SetRawVertexData(data.occlusionPositionData_, MASK_POSITION);
     }
 
     patch->ResetLod();
 }
 
+void Terrain::RebuildPatches(const ea::vector<unsigned>& patchIndices)
+{
+    // Generate the geometry in worker threads, then upload it in the main thread
+    ea::vector<TerrainPatchGeometryData> patchGeometryData(patchIndices.size());
+    auto buildPatches = [&](unsigned begin, unsigned end, unsigned /*threadIndex*/)
+    {
+        for (unsigned i = begin; i < end; ++i)
+        {
+            TerrainPatch* patch = patches_[patchIndices[i]];
+            BuildPatchGeometry(patch, patchGeometryData[i]);
+            CalculateLodErrors(patch);
+        }
+    };
+
+    {
+        URHO3D_PROFILE("BuildPatches");
+
+        auto* queue = GetSubsystem<WorkQueue>();
+        if (queue)
+            queue->ParallelFor(patchIndices.size(), 1, buildPatches);
+        else
+            buildPatches(0, patchIndices.size(), 0);
+    }
+
+    {
+        URHO3D_PROFILE("CommitPatches");
+
+        for (unsigned i = 0; i < patchIndices.size(); ++i)
+            CommitPatchGeometry(patches_[patchIndices[i]], patchGeometryData[i]);
+    }
+}
+
+ea::vector<unsigned> Terrain::GetDirtyPatches(IntRect updateRegion) const
+{
+    ea::vector<unsigned> dirtyPatches;
+
+    int lodExpand = 1u << (numLodLevels_ - 1);
+    // Expand the right & bottom 1 pixel more, as patches share vertices at the edge
+    updateRegion.left_ -= lodExpand;
+    updateRegion.right_ += lodExpand + 1;
+    updateRegion.top_ -= lodExpand;
+    updateRegion.bottom_ += lodExpand + 1;
+
+    int sX = Max(updateRegion.left_ / patchSize_, 0);
+    int eX = Min(updateRegion.right_ / patchSize_, numPatches_.x_ - 1);
+    int sY = Max(updateRegion.top_ / patchSize_, 0);
+    int eY = Min(updateRegion.bottom_ / patchSize_, numPatches_.y_ - 1);
+    for (int y = sY; y <= eY; ++y)
+    {
+        for (int x = sX; x <= eX; ++x)
+            dirtyPatches.push_back(y * numPatches_.x_ + x);
+    }
+
+    return dirtyPatches;
+}
+
 void Terrain::UpdatePatchLod(TerrainPatch* patch)
 {
     Geometry* geometry = patch->GetGeometry();
@@ -1048,24 +1217,10 @@ void Terrain::CreateGeometry()
         }
 
         // If updating a region of the heightmap, check which patches change
-        if (!updateAll)
+        if (!updateAll && updateRegion.left_ >= 0)
         {
-            int lodExpand = 1u << (numLodLevels_ - 1);
-            // Expand the right & bottom 1 pixel more, as patches share vertices at the edge
-            updateRegion.left_ -= lodExpand;
-            updateRegion.right_ += lodExpand + 1;
-            updateRegion.top_ -= lodExpand;
-            updateRegion.bottom_ += lodExpand + 1;
-
-            int sX = Max(updateRegion.left_ / patchSize_, 0);
-            int eX = Min(updateRegion.right_ / patchSize_, numPatches_.x_ - 1);
-            int sY = Max(updateRegion.top_ / patchSize_, 0);
-            int eY = Min(updateRegion.bottom_ / patchSize_, numPatches_.y_ - 1);
-            for (int y = sY; y <= eY; ++y)
-            {
-                for (int x = sX; x <= eX; ++x)
-                    dirtyPatches[y * numPatches_.x_ + x] = true;
-            }
+            for (unsigned index : GetDirtyPatches(updateRegion))
+                dirtyPatches[index] = true;
         }
 
         patches_.reserve((unsigned) (numPatches_.x_ * numPatches_.y_));
@@ -1164,18 +1319,16 @@ void Terrain::CreateGeometry()
             }
         }
 
+        ea::vector<unsigned> dirtyPatchIndices;
         for (unsigned i = 0; i < patches_.size(); ++i)
         {
-            TerrainPatch* patch = patches_[i];
-
             if (dirtyPatches[i])
-            {
-                CreatePatchGeometry(patch);
-                CalculateLodErrors(patch);
-            }
-
-            SetPatchNeighbors(patch);
+                dirtyPatchIndices.push_back(i);
         }
+        RebuildPatches(dirtyPatchIndices);
+
+        for (unsigned i = 0; i < patches_.size(); ++i)
+            SetPatchNeighbors(patches_[i]);
     }
 
     // Send event only if new geometry was generated, or the old was cleared
@@ -24,6 +24,7 @@
 
 #include <EASTL/shared_array.h>
 
+#include "../Math/BoundingBox.h"
 #include "../Scene/Component.h"
 
 namespace Urho3D
@@ -35,6 +36,20 @@ class Material;
 class Node;
 class TerrainPatch;
 
+/// Terrain patch geometry generated on the CPU, possibly in a worker thread, before committing it to the patch.
+/// @nobind
+struct TerrainPatchGeometryData
+{
+    /// Interleaved GPU vertex data.
+    ea::vector<float> vertexData_;
+    /// Vertex positions for raycasts.
+    ea::shared_array<unsigned char> positionData_;
+    /// Vertex positions for occlusion rendering.
+    ea::shared_array<unsigned char> occlusionPositionData_;
+    /// Bounding box.
+    BoundingBox boundingBox_;
+};
+
 /// Heightmap terrain component.
 class URHO3D_API Terrain : public Component
 {
@@ -128,6 +143,8 @@ public:
     void SetEnableDebug(bool enable);
     /// Apply changes from the heightmap image.
     void ApplyHeightMap();
+    /// Apply changes from a region of the heightmap image, given in pixel coordinates. Only the patches affected by the changed heights are rebuilt. Falls back to ApplyHeightMap() if the terrain geometry is not up to date with the heightmap size.
+    void ApplyHeightMapRegion(const IntRect& region);
 
     /// Return patch quads per side.
     /// @property
@@ -301,6 +318,14 @@ private:
     float GetLodHeight(int x, int z, unsigned lodLevel) const;
     /// Get slope-based terrain normal at position.
     Vector3 GetRawNormal(int x, int z) const;
+    /// Generate vertex data and bounding box for a patch. Does not modify the terrain, so it is safe to call for different patches in parallel.
+    void BuildPatchGeometry(TerrainPatch* patch, TerrainPatchGeometryData& data) const;
+    /// Upload generated vertex data to a patch and set up its geometries.
+    void CommitPatchGeometry(TerrainPatch* patch, const TerrainPatchGeometryData& data);
+    /// Rebuild geometry and LOD errors of patches by index, generating the vertex data in worker threads.
+    void RebuildPatches(const ea::vector<unsigned>& patchIndices);
+    /// Return patch indices that need to be rebuilt after heights within a region of vertices have changed.
+    ea::vector<unsigned> GetDirtyPatches(IntRect updateRegion) const;
     /// Calculate LOD errors for a patch.
     void CalculateLodErrors(TerrainPatch* patch);
     /// Set neighbors for a patch.
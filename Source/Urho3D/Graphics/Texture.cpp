@@ -284,4 +284,23 @@ void Texture::CheckTextureBudget(StringHash type)
         cache->ReleaseResources(Material::GetTypeStatic());
 }
 
+unsigned Texture::GetBudgetMipsToSkip(StringHash type, unsigned long long memoryUse) const
+{
+    auto* cache = GetSubsystem<ResourceCache>();
+    unsigned long long textureBudget = cache->GetMemoryBudget(type);
+    if (!textureBudget)
+        return 0;
+
+    // Each skipped mip level reduces the memory use to roughly a quarter
+    unsigned long long textureUse = cache->GetMemoryUse(type);
+    unsigned mipsToSkip = 0;
+    while (mipsToSkip < MAX_BUDGET_MIPS_TO_SKIP && textureUse + memoryUse > textureBudget)
+    {
+        memoryUse /= 4;
+        ++mipsToSkip;
+    }
+
+    return mipsToSkip;
+}
+
 }
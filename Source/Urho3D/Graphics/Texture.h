@@ -31,6 +31,7 @@ namespace Urho3D
 {
 
 static const int MAX_TEXTURE_QUALITY_LEVELS = 3;
+static const unsigned MAX_BUDGET_MIPS_TO_SKIP = 2;
 
 class XMLElement;
 class XMLFile;
@@ -228,6 +229,8 @@ public:
 protected:
     /// Check whether texture memory budget has been exceeded. Free unused materials in that case to release the texture references.
     void CheckTextureBudget(StringHash type);
+    /// Return how many extra mip levels to skip so that a texture of the given full memory use fits the texture memory budget, at most MAX_BUDGET_MIPS_TO_SKIP.
+    unsigned GetBudgetMipsToSkip(StringHash type, unsigned long long memoryUse) const;
     /// Create the GPU texture. Implemented in subclasses.
     virtual bool Create() { return true; }
 
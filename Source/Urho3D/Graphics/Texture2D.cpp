@@ -97,11 +97,21 @@ bool Texture2D::EndLoad()
     if (!graphics_ || graphics_->IsDeviceLost())
         return true;
 
-    // If over the texture budget, see if materials can be freed to allow textures to be freed
-    CheckTextureBudget(GetTypeStatic());
-
     SetParameters(loadParameters_);
-    bool success = SetData(loadImage_);
+
+    bool success = true;
+    if (loadImage_ && graphics_->GetUploadBudget() && GetAsyncLoadState() == ASYNC_SUCCESS)
+    {
+        // Finishing a background load: queue the upload so that uploads of several textures are spread over frames
+        unsigned long long memoryUse = loadImage_->GetMemoryUse();
+        if (!loadImage_->IsCompressed())
+            memoryUse = memoryUse * 4 / 3;
+
+        SharedPtr<Image> image = loadImage_;
+        graphics_->QueueUpload(this, this, (unsigned)memoryUse, [this, image]() { UploadLoadedImage(image); });
+    }
+    else
+        success = UploadLoadedImage(loadImage_);
 
     loadImage_.Reset();
     loadParameters_.Reset();
@@ -109,6 +119,51 @@ bool Texture2D::EndLoad()
     return success;
 }
 
+bool Texture2D::UploadLoadedImage(Image* image)
+{
+    // If over the texture budget, see if materials can be freed to allow textures to be freed
+    CheckTextureBudget(GetTypeStatic());
+
+    // If still over the budget, load the texture with reduced detail. Compressed images include their mip levels, for others
+    // the full mip chain is about 4/3 of the top level
+    unsigned budgetMipsToSkip = 0;
+    if (image)
+    {
+        unsigned long long memoryUse = image->GetMemoryUse();
+        if (!image->IsCompressed())
+            memoryUse = memoryUse * 4 / 3;
+        budgetMipsToSkip = GetBudgetMipsToSkip(GetTypeStatic(), memoryUse);
+    }
+    unsigned mipsToSkip[MAX_TEXTURE_QUALITY_LEVELS];
+    for (unsigned i = 0; i < MAX_TEXTURE_QUALITY_LEVELS; ++i)
+    {
+        mipsToSkip[i] = mipsToSkip_[i];
+        mipsToSkip_[i] += budgetMipsToSkip;
+    }
+    if (budgetMipsToSkip)
+        URHO3D_LOGDEBUGF("Skipping %u extra mip levels of texture %s to fit texture memory budget", budgetMipsToSkip, GetName().c_str());
+
+    bool success = SetData(image);
+
+    // Restore the configured mip skip so that a later reload within the budget gets full detail again
+    for (unsigned i = 0; i < MAX_TEXTURE_QUALITY_LEVELS; ++i)
+        mipsToSkip_[i] = mipsToSkip[i];
+
+    return success;
+}
+
+bool Texture2D::SetDataAsync(unsigned level, int x, int y, int width, int height, const ea::shared_array<unsigned char>& data)
+{
+    if (!graphics_ || !data)
+        return false;
+
+    graphics_->QueueUpload(this, this, GetDataSize(width, height), [this, level, x, y, width, height, data]()
+    {
+        SetData(level, x, y, width, height, data.get());
+    });
+    return true;
+}
+
 bool Texture2D::SetSize(int width, int height, unsigned format, TextureUsage usage, int multiSample, bool autoResolve)
 {
     if (width <= 0 || height <= 0)
@@ -183,12 +238,13 @@ SharedPtr<Image> Texture2D::GetImage() const
 
 void Texture2D::HandleRenderSurfaceUpdate(StringHash eventType, VariantMap& eventData)
 {
-    if (renderSurface_ && (renderSurface_->GetUpdateMode() == SURFACE_UPDATEALWAYS || renderSurface_->IsUpdateQueued()))
+    auto* renderer = GetSubsystem<Renderer>();
+    const unsigned frameNumber = renderer ? renderer->GetFrameInfo().frameNumber_ : 0;
+    if (renderSurface_ && renderSurface_->IsUpdateDue(frameNumber))
     {
-        auto* renderer = GetSubsystem<Renderer>();
         if (renderer)
             renderer->QueueRenderSurface(renderSurface_);
-        renderSurface_->ResetUpdateQueued();
+        renderSurface_->MarkUpdated(frameNumber);
     }
 }
 
@@ -26,12 +26,19 @@
 #include "../Graphics/RenderSurface.h"
 #include "../Graphics/Texture.h"
 
+#include <EASTL/shared_array.h>
+
+#include <functional>
+
 namespace Urho3D
 {
 
 class Image;
 class XMLFile;
 
+/// Callback for asynchronous texture readback. Data is empty if the readback failed.
+using TextureReadbackCallback = std::function<void(const ea::vector<unsigned char>& data)>;
+
 /// 2D texture resource.
 class URHO3D_API Texture2D : public Texture
 {
@@ -66,9 +73,14 @@ public:
     bool SetData(unsigned level, int x, int y, int width, int height, const void* data);
     /// Set data from an image. Return true if successful. Optionally make a single channel image alpha-only.
     bool SetData(Image* image, bool useAlpha = false);
+    /// Queue data for upload to a mip level, to be executed on the main thread within the Graphics upload budget. Can be called from any thread, e.g. after filling the data in a worker job. The texture size must be set when the upload executes. Return true if queued.
+    /// @nobind
+    bool SetDataAsync(unsigned level, int x, int y, int width, int height, const ea::shared_array<unsigned char>& data);
 
     /// Get data from a mip level. The destination buffer must be big enough. Return true if successful.
     bool GetData(unsigned level, void* dest) const;
+    /// Get data from a mip level without stalling for the GPU. The callback is invoked at the end of a later frame once the data has arrived, or immediately if the backend can only read synchronously. Return true if the readback was started.
+    bool GetDataAsync(unsigned level, TextureReadbackCallback callback) const;
     /// Get image data from zero mip level. Only RGB and RGBA textures are supported.
     bool GetImage(Image& image) const;
     /// Get image data from zero mip level. Only RGB and RGBA textures are supported.
@@ -85,6 +97,8 @@ protected:
 private:
     /// Handle render surface update event.
     void HandleRenderSurfaceUpdate(StringHash eventType, VariantMap& eventData);
+    /// Upload a loaded image, skipping extra mip levels if over the texture memory budget.
+    bool UploadLoadedImage(Image* image);
 
     /// Render surface.
     SharedPtr<RenderSurface> renderSurface_;
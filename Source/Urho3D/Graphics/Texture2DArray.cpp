@@ -197,12 +197,13 @@ bool Texture2DArray::SetSize(unsigned layers, int width, int height, unsigned fo
 
 void Texture2DArray::HandleRenderSurfaceUpdate(StringHash eventType, VariantMap& eventData)
 {
-    if (renderSurface_ && (renderSurface_->GetUpdateMode() == SURFACE_UPDATEALWAYS || renderSurface_->IsUpdateQueued()))
+    auto* renderer = GetSubsystem<Renderer>();
+    const unsigned frameNumber = renderer ? renderer->GetFrameInfo().frameNumber_ : 0;
+    if (renderSurface_ && renderSurface_->IsUpdateDue(frameNumber))
     {
-        auto* renderer = GetSubsystem<Renderer>();
         if (renderer)
             renderer->QueueRenderSurface(renderSurface_);
-        renderSurface_->ResetUpdateQueued();
+        renderSurface_->MarkUpdated(frameNumber);
     }
 }
 
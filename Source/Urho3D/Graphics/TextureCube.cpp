@@ -215,15 +215,26 @@ SharedPtr<Image> TextureCube::GetImage(CubeMapFace face) const
 void TextureCube::HandleRenderSurfaceUpdate(StringHash eventType, VariantMap& eventData)
 {
     auto* renderer = GetSubsystem<Renderer>();
+    const unsigned frameNumber = renderer ? renderer->GetFrameInfo().frameNumber_ : 0;
 
-    for (auto& renderSurface : renderSurfaces_)
+    // Start from the face after the last one updated, so that time-sliced updates cycle through all faces
+    unsigned numFaceUpdates = 0;
+    const unsigned firstFace = nextFaceUpdate_;
+    for (unsigned i = 0; i < MAX_CUBEMAP_FACES; ++i)
     {
-        if (renderSurface && (renderSurface->GetUpdateMode() == SURFACE_UPDATEALWAYS || renderSurface->IsUpdateQueued()))
-        {
-            if (renderer)
-                renderer->QueueRenderSurface(renderSurface);
-            renderSurface->ResetUpdateQueued();
-        }
+        const unsigned face = (firstFace + i) % MAX_CUBEMAP_FACES;
+        RenderSurface* renderSurface = renderSurfaces_[face];
+        if (!renderSurface || !renderSurface->IsUpdateDue(frameNumber))
+            continue;
+        // Faces over the limit stay queued for the next frames
+        if (maxFaceUpdates_ && numFaceUpdates >= maxFaceUpdates_)
+            continue;
+
+        if (renderer)
+            renderer->QueueRenderSurface(renderSurface);
+        renderSurface->MarkUpdated(frameNumber);
+        nextFaceUpdate_ = (face + 1) % MAX_CUBEMAP_FACES;
+        ++numFaceUpdates;
     }
 }
 
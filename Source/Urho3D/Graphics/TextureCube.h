@@ -68,6 +68,10 @@ public:
     /// Set data of one face from an image. Return true if successful. Optionally make a single channel image alpha-only.
     bool SetData(CubeMapFace face, Image* image, bool useAlpha = false);
 
+    /// Set maximum number of rendertarget faces updated per frame, cycling through the faces due for update. Default 0 (update all faces at once).
+    /// @property
+    void SetMaxFaceUpdates(unsigned faces) { maxFaceUpdates_ = faces; }
+
     /// Get data from a face's mip level. The destination buffer must be big enough. Return true if successful.
     bool GetData(CubeMapFace face, unsigned level, void* dest) const;
     /// Get image data from a face's zero mip level. Only RGB and RGBA textures are supported.
@@ -77,6 +81,10 @@ public:
     /// @property{get_renderSurfaces}
     RenderSurface* GetRenderSurface(CubeMapFace face) const { return renderSurfaces_[face]; }
 
+    /// Return maximum number of rendertarget faces updated per frame.
+    /// @property
+    unsigned GetMaxFaceUpdates() const { return maxFaceUpdates_; }
+
 protected:
     /// Create the GPU texture.
     bool Create() override;
@@ -89,6 +97,10 @@ private:
     SharedPtr<RenderSurface> renderSurfaces_[MAX_CUBEMAP_FACES];
     /// Memory use per face.
     unsigned faceMemoryUse_[MAX_CUBEMAP_FACES]{};
+    /// Maximum number of faces updated per frame.
+    unsigned maxFaceUpdates_{};
+    /// Face to consider first on the next update.
+    unsigned nextFaceUpdate_{};
     /// Face image files acquired during BeginLoad.
     SharedPtr<ImageCube> loadImageCube_;
 };
@@ -86,6 +86,19 @@ Ubyte4 Vector4ToUbyte4(const Vector4& value)
     };
 }
 
+/// Helper types for half float and signed short vectors.
+/// @{
+using Half2 = ea::array<unsigned short, 2>;
+using Half4 = ea::array<unsigned short, 4>;
+using Short4 = ea::array<short, 4>;
+/// @}
+
+/// Convert float in [-1, 1] to signed normalized short (with clamping).
+short FloatToShortNorm(float value)
+{
+    return static_cast<short>(Clamp(RoundToInt(value * 32767.0f), -32767, 32767));
+}
+
 /// No-op converter from float vector to float vector.
 Vector4 Vector4ToVector4(const Vector4& value) { return { value.x_, value.y_, value.z_, value.w_ }; }
 
@@ -96,12 +109,36 @@ Vector4 FloatToVector4(float value) { return { value, 0.0f, 0.0f, 0.0f }; }
 Vector4 Vector2ToVector4(const Vector2& value) { return { value.x_, value.y_, 0.0f, 0.0f }; }
 Vector4 Vector3ToVector4(const Vector3& value) { return { value.x_, value.y_, value.z_, 0.0f }; }
 Vector4 Ubyte4NormToVector4(const Ubyte4& value) { return Ubyte4ToVector4(value) / 255.0f; }
+Vector4 Half2ToVector4(const Half2& value) { return { HalfToFloat(value[0]), HalfToFloat(value[1]), 0.0f, 0.0f }; }
+Vector4 Half4ToVector4(const Half4& value)
+{
+    return { HalfToFloat(value[0]), HalfToFloat(value[1]), HalfToFloat(value[2]), HalfToFloat(value[3]) };
+}
+Vector4 Short4NormToVector4(const Short4& value)
+{
+    // Both -32768 and -32767 map to -1
+    return {
+        Max(value[0] / 32767.0f, -1.0f),
+        Max(value[1] / 32767.0f, -1.0f),
+        Max(value[2] / 32767.0f, -1.0f),
+        Max(value[3] / 32767.0f, -1.0f)
+    };
+}
 
 int Vector4ToInt(const Vector4& value) { return static_cast<int>(value.x_); }
 float Vector4ToFloat(const Vector4& value) { return value.x_; }
 Vector2 Vector4ToVector2(const Vector4& value) { return { value.x_, value.y_ }; }
 Vector3 Vector4ToVector3(const Vector4& value) { return { value.x_, value.y_, value.z_ }; }
 Ubyte4 Vector4ToUbyte4Norm(const Vector4& value) { return Vector4ToUbyte4(value * 255.0f); }
+Half2 Vector4ToHalf2(const Vector4& value) { return { FloatToHalf(value.x_), FloatToHalf(value.y_) }; }
+Half4 Vector4ToHalf4(const Vector4& value)
+{
+    return { FloatToHalf(value.x_), FloatToHalf(value.y_), FloatToHalf(value.z_), FloatToHalf(value.w_) };
+}
+Short4 Vector4ToShort4Norm(const Vector4& value)
+{
+    return { FloatToShortNorm(value.x_), FloatToShortNorm(value.y_), FloatToShortNorm(value.z_), FloatToShortNorm(value.w_) };
+}
 /// @}
 
 }
@@ -169,6 +206,18 @@ bool VertexBuffer::SetSize(unsigned vertexCount, const ea::vector<VertexElement>
     return Create();
 }
 
+bool VertexBuffer::SetDataRangeAsync(const ea::shared_array<unsigned char>& data, unsigned start, unsigned count)
+{
+    if (!graphics_ || !data)
+        return false;
+
+    graphics_->QueueUpload(this, this, count * vertexSize_, [this, data, start, count]()
+    {
+        SetDataRange(data.get(), start, count);
+    });
+    return true;
+}
+
 void VertexBuffer::UpdateOffsets()
 {
     unsigned elementOffset = 0;
@@ -350,6 +399,15 @@ void VertexBuffer::UnpackVertexData(const void* source, unsigned sourceStride,
     case TYPE_UBYTE4_NORM:
         ConvertArray<Vector4, Ubyte4>(destBytes, sourceBytes, destStride, sourceStride, count, Ubyte4NormToVector4);
         break;
+    case TYPE_HALF2:
+        ConvertArray<Vector4, Half2>(destBytes, sourceBytes, destStride, sourceStride, count, Half2ToVector4);
+        break;
+    case TYPE_HALF4:
+        ConvertArray<Vector4, Half4>(destBytes, sourceBytes, destStride, sourceStride, count, Half4ToVector4);
+        break;
+    case TYPE_SHORT4_NORM:
+        ConvertArray<Vector4, Short4>(destBytes, sourceBytes, destStride, sourceStride, count, Short4NormToVector4);
+        break;
     default:
         assert(0);
         break;
@@ -385,6 +443,15 @@ void VertexBuffer::PackVertexData(const Vector4 source[], unsigned sourceStride,
     case TYPE_UBYTE4_NORM:
         ConvertArray<Ubyte4, Vector4>(destBytes, sourceBytes, destStride, sourceStride, count, Vector4ToUbyte4Norm);
         break;
+    case TYPE_HALF2:
+        ConvertArray<Half2, Vector4>(destBytes, sourceBytes, destStride, sourceStride, count, Vector4ToHalf2);
+        break;
+    case TYPE_HALF4:
+        ConvertArray<Half4, Vector4>(destBytes, sourceBytes, destStride, sourceStride, count, Vector4ToHalf4);
+        break;
+    case TYPE_SHORT4_NORM:
+        ConvertArray<Short4, Vector4>(destBytes, sourceBytes, destStride, sourceStride, count, Vector4ToShort4Norm);
+        break;
     default:
         assert(0);
         break;
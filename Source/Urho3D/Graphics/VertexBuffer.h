@@ -66,6 +66,9 @@ public:
     bool SetData(const void* data);
     /// Set a data range in the buffer. Optionally discard data outside the range.
     bool SetDataRange(const void* data, unsigned start, unsigned count, bool discard = false);
+    /// Queue a data range for upload, to be executed on the main thread within the Graphics upload budget. Can be called from any thread, but the buffer size must not change until the upload executes. Return true if queued.
+    /// @nobind
+    bool SetDataRangeAsync(const ea::shared_array<unsigned char>& data, unsigned start, unsigned count);
     /// Lock the buffer for write-only editing. Return data pointer if successful. Optionally discard data outside the range.
     void* Lock(unsigned start, unsigned count, bool discard = false);
     /// Unlock the buffer and apply changes to the GPU buffer.
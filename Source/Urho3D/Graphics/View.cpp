@@ -61,17 +61,73 @@
 namespace Urho3D
 {
 
-/// Update ambient for Drawable.
+/// Maximum number of occluders picked automatically per view.
+static const unsigned MAX_AUTO_OCCLUDERS = 32;
+/// Distance a drawable may move before light probes are looked up again.
+static const float LIGHT_PROBE_CACHE_TOLERANCE = 0.05f;
+/// Minimum number of visible zones to look up zones from a grid instead of testing each zone.
+static const unsigned MIN_ZONES_FOR_GRID = 8;
+/// Maximum number of zone grid cells along each axis.
+static const int MAX_ZONE_GRID_SIZE = 16;
+/// Number of subpixel jitter positions cycled through by temporal upscaling.
+static const unsigned NUM_JITTER_SAMPLES = 8;
+/// Weight of the current frame when accumulating the temporal history.
+static const float TEMPORAL_BLEND = 0.1f;
+/// Display names of render path commands without tag or pass, used for GPU timing zones and statistics.
+static const char* commandTypeNames[] =
+{
+    "None",
+    "Clear",
+    "ScenePass",
+    "Quad",
+    "ForwardLights",
+    "LightVolumes",
+    "RenderUI",
+    "SendEvent"
+};
+
+/// Return display name for render path command.
+static const char* GetCommandDisplayName(const RenderPathCommand& command)
+{
+    if (!command.tag_.empty())
+        return command.tag_.c_str();
+    if (!command.pass_.empty())
+        return command.pass_.c_str();
+    return commandTypeNames[command.type_];
+}
+
+/// Return element of the Halton low discrepancy sequence in range [0, 1).
+static float Halton(unsigned index, unsigned base)
+{
+    float result = 0.0f;
+    float fraction = 1.0f / base;
+    while (index > 0)
+    {
+        result += fraction * (index % base);
+        index /= base;
+        fraction /= base;
+    }
+    return result;
+}
+
+/// Return left or right half of a viewport for stereo rendering.
+static IntRect GetEyeViewport(const IntRect& viewport, unsigned eye)
+{
+    const int middle = viewport.left_ + viewport.Width() / 2;
+    return eye == 0 ? IntRect(viewport.left_, viewport.top_, middle, viewport.bottom_) :
+        IntRect(middle, viewport.top_, viewport.right_, viewport.bottom_);
+}
+
+/// Update ambient for Drawable. Light probe sample cache is updated during visibility check.
 static void UpdateBatchAmbient(Batch& destBatch, GlobalIllumination* gi, Drawable* drawable)
 {
     if (gi && !destBatch.lightmapScaleOffset_)
     {
-        unsigned& hint = drawable->GetMutableLightProbeTetrahedronHint();
-        const Vector3& samplePosition = drawable->GetWorldBoundingBox().Center();
+        const DrawableLightProbeCache& cache = drawable->GetLightProbeCache();
 #if URHO3D_SPHERICAL_HARMONICS
-        destBatch.shaderParameters_.ambient_ = gi->SampleAmbientSH(samplePosition, hint);
+        destBatch.shaderParameters_.ambient_ = gi->SampleAmbientSH(cache);
 #else
-        destBatch.shaderParameters_.ambient_ = gi->SampleAverageAmbient(samplePosition, hint);
+        destBatch.shaderParameters_.ambient_ = gi->SampleAverageAmbient(cache);
 #endif
     }
 }
@@ -90,17 +146,11 @@ public:
     /// Intersection test for drawables.
     void TestDrawables(Drawable** start, Drawable** end, bool inside) override
     {
-        while (start != end)
+        TestDrawablesBatched(start, end, inside, [this](Drawable* drawable)
         {
-            Drawable* drawable = *start++;
-
-            if (drawable->GetCastShadows() && (drawable->GetDrawableFlags() & drawableFlags_) &&
-                (drawable->GetViewMask() & viewMask_))
-            {
-                if (inside || frustum_.IsInsideFast(drawable->GetWorldBoundingBox()))
-                    result_.push_back(drawable);
-            }
-        }
+            return drawable->GetCastShadows() && (drawable->GetDrawableFlags() & drawableFlags_) &&
+                (drawable->GetViewMask() & viewMask_);
+        });
     }
 };
 
@@ -133,7 +183,7 @@ public:
     }
 };
 
-/// %Frustum octree query with occlusion.
+/// %Frustum octree query with occlusion. Note: drawable occlusion is performed later in worker threads.
 class OccludedFrustumOctreeQuery : public FrustumOctreeQuery
 {
 public:
@@ -159,21 +209,6 @@ public:
         }
     }
 
-    /// Intersection test for drawables. Note: drawable occlusion is performed later in worker threads.
-    void TestDrawables(Drawable** start, Drawable** end, bool inside) override
-    {
-        while (start != end)
-        {
-            Drawable* drawable = *start++;
-
-            if ((drawable->GetDrawableFlags() & drawableFlags_) && (drawable->GetViewMask() & viewMask_))
-            {
-                if (inside || frustum_.IsInsideFast(drawable->GetWorldBoundingBox()))
-                    result_.push_back(drawable);
-            }
-        }
-    }
-
     /// Occlusion buffer.
     OcclusionBuffer* buffer_;
 };
@@ -195,8 +230,11 @@ void CheckVisibilityWork(const WorkItem* item, unsigned threadIndex)
     while (start != end)
     {
         Drawable* drawable = *start++;
+        bool testOcclusion = buffer && drawable->IsOccludee();
+        if (testOcclusion)
+            ++result.numOcclusionTested_;
 
-        if (!buffer || !drawable->IsOccludee() || buffer->IsVisible(drawable->GetWorldBoundingBox()))
+        if (!testOcclusion || buffer->IsVisible(drawable->GetWorldBoundingBox()))
         {
             drawable->UpdateBatches(view->frame_);
             // If draw distance non-zero, update and check it
@@ -204,7 +242,17 @@ void CheckVisibilityWork(const WorkItem* item, unsigned threadIndex)
             if (maxDistance > 0.0f)
             {
                 if (drawable->GetDistance() > maxDistance)
+                {
+                    ++result.numDistanceCulled_;
                     continue;
+                }
+            }
+
+            // Hierarchical LOD cell draws either its contents or its proxy
+            if (!drawable->IsHierarchicalLodVisible(view->frame_))
+            {
+                ++result.numDistanceCulled_;
+                continue;
             }
 
             drawable->MarkInView(view->frame_);
@@ -236,6 +284,13 @@ void CheckVisibilityWork(const WorkItem* item, unsigned threadIndex)
                     drawable->SetMinMaxZ(M_LARGE_VALUE, M_LARGE_VALUE);
 
                 result.geometries_.push_back(drawable);
+
+                // Find light probes on worker thread, batches will reuse the sample
+                if (view->globalIllumination_)
+                {
+                    view->globalIllumination_->UpdateLightProbeCache(
+                        drawable->GetMutableLightProbeCache(), center, LIGHT_PROBE_CACHE_TOLERANCE);
+                }
             }
             else if (drawable->GetDrawableFlags() & DRAWABLE_LIGHT)
             {
@@ -245,6 +300,8 @@ void CheckVisibilityWork(const WorkItem* item, unsigned threadIndex)
                     result.lights_.push_back(light);
             }
         }
+        else
+            ++result.numOcclusionCulled_;
     }
 }
 
@@ -360,11 +417,40 @@ bool View::Define(RenderSurface* renderTarget, Viewport* viewport)
     }
 #endif
 
+    // With dynamic resolution, backbuffer views render the scene into buffers scaled down from the viewport, which are
+    // upscaled into the viewport rectangle at the end of the render path
+    temporalUpscale_ = !renderTarget_ && renderer_->GetDynamicResolution() && renderer_->GetTemporalUpscale() &&
+        !viewport->GetRightEyeCamera();
+    if (!renderTarget_ && renderer_->GetResolutionScale() < 1.0f)
+    {
+        const float scale = renderer_->GetResolutionScale();
+        viewSize_.x_ = Max(RoundToInt(viewSize_.x_ * scale), 1);
+        viewSize_.y_ = Max(RoundToInt(viewSize_.y_ * scale), 1);
+    }
+    if (!temporalUpscale_)
+        historySize_ = IntVector2::ZERO;
+
     scene_ = viewport->GetScene();
     cullCamera_ = viewport->GetCullCamera();
     camera_ = viewport->GetCamera();
+    eyeCameras_[0] = camera_;
+    eyeCameras_[1] = camera_ ? viewport->GetRightEyeCamera() : nullptr;
+    stereoEye_ = 0;
     if (!cullCamera_)
+    {
         cullCamera_ = camera_;
+        if (eyeCameras_[1])
+        {
+            // Cull both eyes at once against a camera enclosing them
+            if (!stereoCullNode_)
+            {
+                stereoCullNode_ = MakeShared<Node>(context_);
+                stereoCullCamera_ = stereoCullNode_->CreateComponent<Camera>();
+                stereoCullCamera_->SetAutoAspectRatio(false);
+            }
+            cullCamera_ = stereoCullCamera_;
+        }
+    }
     else
     {
         // If view specifies a culling camera (view preparation sharing), check if already prepared
@@ -567,6 +653,7 @@ void View::Update(const FrameInfo& frame)
     SendViewEvent(E_BEGINVIEWUPDATE);
 
     int maxSortedInstances = renderer_->GetMaxSortedInstances();
+    bool retainBatchGroups = renderer_->GetRetainBatchGroups();
 
     // Clear buffers, geometry, light, occluder & batch list
     renderTargets_.clear();
@@ -575,9 +662,10 @@ void View::Update(const FrameInfo& frame)
     zones_.clear();
     occluders_.clear();
     activeOccluders_ = 0;
+    statistics_ = ViewStatistics();
     vertexLightQueues_.clear();
     for (auto i = batchQueues_.begin(); i != batchQueues_.end(); ++i)
-        i->second.Clear(maxSortedInstances);
+        i->second.Clear(maxSortedInstances, retainBatchGroups);
 
     if (hasScenePasses_ && (!cullCamera_ || !octree_))
     {
@@ -587,7 +675,9 @@ void View::Update(const FrameInfo& frame)
 
     // Set automatic aspect ratio if required
     if (cullCamera_ && cullCamera_->GetAutoAspectRatio())
-        cullCamera_->SetAspectRatioInternal((float)frame_.viewSize_.x_ / (float)frame_.viewSize_.y_);
+        cullCamera_->SetAspectRatioInternal(GetEyeAspectRatio());
+    if (eyeCameras_[1] && cullCamera_ == stereoCullCamera_)
+        UpdateStereoCullCamera();
 
     GetDrawables();
     GetBatches();
@@ -608,6 +698,14 @@ void View::Render()
 
     UpdateGeometries();
 
+    // Culling statistics come from the view that was actually updated
+    if (sourceView_)
+        statistics_ = sourceView_->statistics_;
+    statistics_.shadowMaps_ = DrawCallStatistics();
+    statistics_.drawCalls_ = DrawCallStatistics();
+    statistics_.commands_.clear();
+    const DrawCallStatistics viewStartStatistics = graphics_->GetFrameStatistics();
+
     // Allocate screen buffers as necessary
     AllocateScreenBuffers();
     SendViewEvent(E_VIEWBUFFERSREADY);
@@ -620,8 +718,11 @@ void View::Render()
 
     // It is possible, though not recommended, that the same camera is used for multiple main views. Set automatic aspect ratio
     // to ensure correct projection will be used
-    if (camera_ && camera_->GetAutoAspectRatio())
-        camera_->SetAspectRatioInternal((float)(viewSize_.x_) / (float)(viewSize_.y_));
+    for (Camera* eyeCamera : eyeCameras_)
+    {
+        if (eyeCamera && eyeCamera->GetAutoAspectRatio())
+            eyeCamera->SetAspectRatioInternal(GetEyeAspectRatio());
+    }
 
     // Bind the face selection and indirection cube maps for point light shadows
 #ifndef GL_ES_VERSION_2_0
@@ -646,6 +747,24 @@ void View::Render()
     }
 #endif
 
+    // Offset the projection by a subpixel amount each frame so that temporal upscaling accumulates samples from different
+    // positions. Remember the unjittered view-projection for reprojecting the history
+    if (temporalUpscale_ && camera_)
+    {
+        savedProjectionOffset_ = camera_->GetProjectionOffset();
+        viewProj_ = camera_->GetGPUProjection() * camera_->GetView();
+
+        jitterIndex_ = (jitterIndex_ + 1) % NUM_JITTER_SAMPLES;
+        const Vector2 jitter(Halton(jitterIndex_ + 1, 2) - 0.5f, Halton(jitterIndex_ + 1, 3) - 0.5f);
+        const Vector2 offset(jitter.x_ / viewSize_.x_, jitter.y_ / viewSize_.y_);
+        camera_->SetProjectionOffset(savedProjectionOffset_ + offset);
+#ifdef URHO3D_OPENGL
+        jitterOffset_ = offset;
+#else
+        jitterOffset_ = Vector2(offset.x_, -offset.y_);
+#endif
+    }
+
     // Render
     ExecuteRenderPathCommands();
 
@@ -685,11 +804,28 @@ void View::Render()
                 rtSizeNow.y_);
             graphics_->SetViewport(viewport);
 
-            debug->SetView(camera_);
-            debug->Render();
+            if (eyeCameras_[1])
+            {
+                stereoViewport_ = viewport;
+                for (unsigned eye = 0; eye < 2; ++eye)
+                {
+                    SetStereoEye(eye);
+                    debug->SetView(camera_);
+                    debug->Render();
+                }
+                EndStereoEyes();
+            }
+            else
+            {
+                debug->SetView(camera_);
+                debug->Render();
+            }
         }
     }
 
+    if (temporalUpscale_ && camera_)
+        camera_->SetProjectionOffset(savedProjectionOffset_);
+
 #ifdef URHO3D_OPENGL
     if (renderTarget_)
     {
@@ -702,7 +838,14 @@ void View::Render()
     // Run framebuffer blitting if necessary. If scene was resolved from backbuffer, do not touch depth
     // (backbuffer should contain proper depth already)
     if (currentRenderTarget_ != renderTarget_)
-        BlitFramebuffer(currentRenderTarget_->GetParentTexture(), renderTarget_, !usedResolve_);
+    {
+        if (temporalUpscale_ && camera_)
+            TemporalUpscale(currentRenderTarget_->GetParentTexture());
+        else
+            BlitFramebuffer(currentRenderTarget_->GetParentTexture(), renderTarget_, !usedResolve_);
+    }
+
+    statistics_.drawCalls_ = graphics_->GetFrameStatistics() - viewStartStatistics;
 
     SendViewEvent(E_ENDVIEWRENDER);
 }
@@ -815,6 +958,69 @@ void View::SetGBufferShaderParameters(const IntVector2& texSize, const IntRect&
     graphics_->SetShaderParameter(PSP_GBUFFERINVSIZE, Vector2(invSizeX, invSizeY));
 }
 
+void View::SetStereoEye(unsigned eye)
+{
+    stereoEye_ = eye;
+    camera_ = eyeCameras_[eye];
+    graphics_->SetViewport(GetEyeViewport(stereoViewport_, eye));
+    graphics_->SetClipPlane(camera_->GetUseClipping(), camera_->GetClipPlane(), camera_->GetView(), camera_->GetGPUProjection());
+}
+
+IntRect View::GetStereoEyeRect() const
+{
+    // G-buffer and viewport textures span both eyes
+    return GetEyeViewport(IntRect(IntVector2::ZERO, viewSize_), stereoEye_);
+}
+
+void View::EndStereoEyes()
+{
+    stereoEye_ = 0;
+    camera_ = eyeCameras_[0];
+    graphics_->SetViewport(stereoViewport_);
+    graphics_->SetClipPlane(camera_->GetUseClipping(), camera_->GetClipPlane(), camera_->GetView(), camera_->GetGPUProjection());
+}
+
+float View::GetEyeAspectRatio() const
+{
+    const float aspectRatio = (float)viewRect_.Width() / (float)viewRect_.Height();
+    return eyeCameras_[1] ? aspectRatio * 0.5f : aspectRatio;
+}
+
+void View::UpdateStereoCullCamera()
+{
+    Camera* leftEye = eyeCameras_[0];
+    Camera* rightEye = eyeCameras_[1];
+    const float aspectRatio = GetEyeAspectRatio();
+
+    float tanHalfFov = 0.0f;
+    float nearClip = M_INFINITY;
+    float farClip = 0.0f;
+    for (Camera* eyeCamera : eyeCameras_)
+    {
+        if (eyeCamera->GetAutoAspectRatio())
+            eyeCamera->SetAspectRatioInternal(aspectRatio);
+        tanHalfFov = Max(tanHalfFov, Tan(eyeCamera->GetFov() * 0.5f) / eyeCamera->GetZoom());
+        nearClip = Min(nearClip, eyeCamera->GetNearClip());
+        farClip = Max(farClip, eyeCamera->GetFarClip());
+    }
+
+    // Pull the camera back from between the eyes until its horizontal field of view encloses both eye frusta
+    const Vector3 leftPosition = leftEye->GetNode()->GetWorldPosition();
+    const Vector3 rightPosition = rightEye->GetNode()->GetWorldPosition();
+    const Quaternion rotation = leftEye->GetNode()->GetWorldRotation();
+    const float halfSeparation = (rightPosition - leftPosition).Length() * 0.5f;
+    const float backOffset = halfSeparation / Max(tanHalfFov * aspectRatio, M_EPSILON);
+    stereoCullNode_->SetTransform((leftPosition + rightPosition) * 0.5f - rotation * Vector3::FORWARD * backOffset, rotation);
+
+    stereoCullCamera_->SetFov(2.0f * Atan(tanHalfFov));
+    stereoCullCamera_->SetAspectRatio(aspectRatio);
+    stereoCullCamera_->SetNearClip(backOffset + nearClip);
+    stereoCullCamera_->SetFarClip(backOffset + farClip);
+    stereoCullCamera_->SetLodBias(leftEye->GetLodBias());
+    stereoCullCamera_->SetViewMask(leftEye->GetViewMask());
+    stereoCullCamera_->SetViewOverrideFlags(leftEye->GetViewOverrideFlags());
+}
+
 void View::GetDrawables()
 {
     if (!octree_ || !cullCamera_)
@@ -824,11 +1030,27 @@ void View::GetDrawables()
 
     auto* queue = GetSubsystem<WorkQueue>();
     ea::vector<Drawable*>& tempDrawables = tempDrawables_[0];
+    const Frustum& frustum = cullCamera_->GetFrustum();
+    const unsigned viewMask = cullCamera_->GetViewMask();
+
+    // If other views of the octree overlap this one, filter the drawables they share instead of querying the octree
+    const ea::vector<Drawable*>* sharedDrawables = renderer_->GetSharedCullDrawables(octree_, frustum);
 
     // Get zones and occluders first
+    if (sharedDrawables)
     {
-        ZoneOccluderOctreeQuery
-            query(tempDrawables, cullCamera_->GetFrustum(), DRAWABLE_GEOMETRY | DRAWABLE_ZONE, cullCamera_->GetViewMask());
+        tempDrawables.clear();
+        for (Drawable* drawable : *sharedDrawables)
+        {
+            unsigned char flags = drawable->GetDrawableFlags();
+            if ((flags == DRAWABLE_ZONE || (flags == DRAWABLE_GEOMETRY && drawable->IsOccluder())) &&
+                (drawable->GetViewMask() & viewMask) && frustum.IsInsideFast(drawable->GetWorldBoundingBox()))
+                tempDrawables.push_back(drawable);
+        }
+    }
+    else
+    {
+        ZoneOccluderOctreeQuery query(tempDrawables, frustum, DRAWABLE_GEOMETRY | DRAWABLE_ZONE, viewMask);
         octree_->GetDrawables(query);
     }
 
@@ -859,6 +1081,21 @@ void View::GetDrawables()
             occluders_.push_back(drawable);
     }
 
+    UpdateZoneGrid();
+
+    // Add the automatic occluders picked on the previous frame, if they are still valid for this view
+    if (maxOccluderTriangles_ > 0 && renderer_->GetAutoOccluders())
+    {
+        for (const WeakPtr<Drawable>& drawable : autoOccluders_)
+        {
+            if (!drawable || drawable->IsOccluder() || !drawable->GetOctant() || drawable->GetOctant()->GetRoot() != octree_)
+                continue;
+            if (!(drawable->GetViewMask() & viewMask) || frustum.IsInsideFast(drawable->GetWorldBoundingBox()) == OUTSIDE)
+                continue;
+            occluders_.push_back(drawable.Get());
+        }
+    }
+
     // Determine the zone at far clip distance. If not found, or camera zone has override mode, use camera zone
     cameraZoneOverride_ = cameraZone_->GetOverride();
     if (!cameraZoneOverride_)
@@ -895,16 +1132,27 @@ void View::GetDrawables()
     else
         occluders_.clear();
 
-    // Get lights and geometries. Coarse occlusion for octants is used at this point
-    if (occlusionBuffer_)
+    // Get lights and geometries. Coarse occlusion for octants is used at this point, except for shared drawables, which are
+    // only occlusion tested individually
+    if (sharedDrawables)
+    {
+        tempDrawables.clear();
+        for (Drawable* drawable : *sharedDrawables)
+        {
+            if ((drawable->GetDrawableFlags() & (DRAWABLE_GEOMETRY | DRAWABLE_LIGHT)) && (drawable->GetViewMask() & viewMask) &&
+                frustum.IsInsideFast(drawable->GetWorldBoundingBox()))
+                tempDrawables.push_back(drawable);
+        }
+    }
+    else if (occlusionBuffer_)
     {
         OccludedFrustumOctreeQuery query
-            (tempDrawables, cullCamera_->GetFrustum(), occlusionBuffer_, DRAWABLE_GEOMETRY | DRAWABLE_LIGHT, cullCamera_->GetViewMask());
+            (tempDrawables, frustum, occlusionBuffer_, DRAWABLE_GEOMETRY | DRAWABLE_LIGHT, viewMask);
         octree_->GetDrawables(query);
     }
     else
     {
-        FrustumOctreeQuery query(tempDrawables, cullCamera_->GetFrustum(), DRAWABLE_GEOMETRY | DRAWABLE_LIGHT, cullCamera_->GetViewMask());
+        FrustumOctreeQuery query(tempDrawables, frustum, DRAWABLE_GEOMETRY | DRAWABLE_LIGHT, viewMask);
         octree_->GetDrawables(query);
     }
 
@@ -918,8 +1166,12 @@ void View::GetDrawables()
             result.lights_.clear();
             result.minZ_ = M_INFINITY;
             result.maxZ_ = 0.0f;
+            result.numOcclusionTested_ = 0;
+            result.numOcclusionCulled_ = 0;
+            result.numDistanceCulled_ = 0;
         }
 
+        statistics_.numFrustumDrawables_ = tempDrawables.size();
         int numWorkItems = queue->GetNumThreads() + 1; // Worker threads + main thread
         int drawablesPerItem = tempDrawables.size() / numWorkItems;
 
@@ -952,6 +1204,13 @@ void View::GetDrawables()
     minZ_ = M_INFINITY;
     maxZ_ = 0.0f;
 
+    for (const PerThreadSceneResult& result : sceneResults_)
+    {
+        statistics_.numOcclusionTested_ += result.numOcclusionTested_;
+        statistics_.numOcclusionCulled_ += result.numOcclusionCulled_;
+        statistics_.numDistanceCulled_ += result.numDistanceCulled_;
+    }
+
     if (sceneResults_.size() > 1)
     {
         for (unsigned i = 0; i < sceneResults_.size(); ++i)
@@ -985,6 +1244,15 @@ void View::GetDrawables()
     }
 
     ea::quick_sort(lights_.begin(), lights_.end(), CompareLights);
+
+    statistics_.numGeometries_ = geometries_.size();
+    statistics_.numLights_ = lights_.size();
+    statistics_.numOccluders_ = activeOccluders_;
+
+    if (renderer_->GetAutoOccluders())
+        UpdateAutoOccluders();
+    else
+        autoOccluders_.clear();
 }
 
 void View::GetBatches()
@@ -1029,6 +1297,7 @@ void View::ProcessLights()
 void View::GetLightBatches()
 {
     BatchQueue* alphaQueue = batchQueues_.contains(alphaPassIndex_) ? &batchQueues_[alphaPassIndex_] : nullptr;
+    const auto maxPixelLights = (unsigned)renderer_->GetMaxPixelLights();
 
     // Build light queues and lit batches
     {
@@ -1047,6 +1316,7 @@ void View::GetLightBatches()
         lightQueues_.resize(numLightQueues);
         maxLightsDrawables_.clear();
         auto maxSortedInstances = (unsigned)renderer_->GetMaxSortedInstances();
+        bool retainBatchGroups = renderer_->GetRetainBatchGroups();
 
         for (auto i = lightQueryResults_.begin(); i != lightQueryResults_.end(); ++i)
         {
@@ -1069,8 +1339,8 @@ void View::GetLightBatches()
                 lightQueue.light_ = light;
                 lightQueue.negative_ = light->IsNegative();
                 lightQueue.shadowMap_ = nullptr;
-                lightQueue.litBaseBatches_.Clear(maxSortedInstances);
-                lightQueue.litBatches_.Clear(maxSortedInstances);
+                lightQueue.litBaseBatches_.Clear(maxSortedInstances, retainBatchGroups);
+                lightQueue.litBatches_.Clear(maxSortedInstances, retainBatchGroups);
                 if (forwardLightsCommand_)
                 {
                     SetQueueShaderDefines(lightQueue.litBaseBatches_, *forwardLightsCommand_);
@@ -1092,6 +1362,18 @@ void View::GetLightBatches()
                         shadowSplits = 0;
                 }
 
+                // If shadow maps are cached, hash everything that affects the shadow map contents
+                bool cacheShadowMap = lightQueue.shadowMap_ && renderer_->GetCacheShadowMaps() && !renderer_->GetReuseShadowMaps();
+                unsigned shadowMapHash = 0;
+                if (cacheShadowMap)
+                {
+                    const BiasParameters& bias = light->GetShadowBias();
+                    shadowMapHash = MakeHash(light);
+                    CombineHash(shadowMapHash, shadowSplits);
+                    CombineHash(shadowMapHash, FloatToRawIntBits(bias.constantBias_));
+                    CombineHash(shadowMapHash, FloatToRawIntBits(bias.slopeScaledBias_));
+                }
+
                 // Setup shadow batch queues
                 lightQueue.shadowSplits_.resize(shadowSplits);
                 for (unsigned j = 0; j < shadowSplits; ++j)
@@ -1101,11 +1383,17 @@ void View::GetLightBatches()
                     shadowQueue.shadowCamera_ = shadowCamera;
                     shadowQueue.nearSplit_ = query.shadowNearSplits_[j];
                     shadowQueue.farSplit_ = query.shadowFarSplits_[j];
-                    shadowQueue.shadowBatches_.Clear(maxSortedInstances);
+                    shadowQueue.shadowBatches_.Clear(maxSortedInstances, retainBatchGroups);
 
                     // Setup the shadow split viewport and finalize shadow camera parameters
                     shadowQueue.shadowViewport_ = GetShadowMapViewport(light, j, lightQueue.shadowMap_);
                     FinalizeShadowCamera(shadowCamera, light, shadowQueue.shadowViewport_, query.shadowCasterBox_[j]);
+                    if (cacheShadowMap)
+                    {
+                        CombineHash(shadowMapHash, shadowQueue.shadowViewport_.ToHash());
+                        CombineHash(shadowMapHash, shadowCamera->GetView().ToHash());
+                        CombineHash(shadowMapHash, shadowCamera->GetProjection().ToHash());
+                    }
 
                     // Loop through shadow casters
                     for (auto k = query.shadowCasters_.begin() + query.shadowCasterBegin_[j];
@@ -1123,6 +1411,10 @@ void View::GetLightBatches()
                                 threadedGeometries_.push_back(drawable);
                         }
 
+                        // Casters that update their geometry every frame (skinning, billboards etc.) prevent caching
+                        if (cacheShadowMap && drawable->GetUpdateGeometryType() != UPDATE_NONE)
+                            cacheShadowMap = false;
+
                         const ea::vector<SourceBatch>& batches = drawable->GetBatches();
 
                         for (unsigned l = 0; l < batches.size(); ++l)
@@ -1138,6 +1430,14 @@ void View::GetLightBatches()
                             if (!pass)
                                 continue;
 
+                            if (cacheShadowMap)
+                            {
+                                CombineHash(shadowMapHash, MakeHash(srcBatch.geometry_));
+                                CombineHash(shadowMapHash, MakeHash(srcBatch.material_.Get()));
+                                for (unsigned m = 0; m < srcBatch.numWorldTransforms_; ++m)
+                                    CombineHash(shadowMapHash, srcBatch.worldTransform_[m].ToHash());
+                            }
+
                             Batch destBatch(srcBatch);
                             destBatch.pass_ = pass;
                             destBatch.zone_ = nullptr;
@@ -1147,6 +1447,9 @@ void View::GetLightBatches()
                     }
                 }
 
+                // Zero hash means the shadow map must be rendered
+                lightQueue.shadowMapHash_ = cacheShadowMap ? Max(shadowMapHash, 1u) : 0;
+
                 // Process lit geometries
                 for (auto j = query.litGeometries_.begin(); j !=
                     query.litGeometries_.end(); ++j)
@@ -1154,8 +1457,8 @@ void View::GetLightBatches()
                     Drawable* drawable = *j;
                     drawable->AddLight(light);
 
-                    // If drawable limits maximum lights, only record the light, and check maximum count / build batches later
-                    if (!drawable->GetMaxLights())
+                    // If drawable or renderer limits maximum lights, only record the light, and check maximum count / build batches later
+                    if (!drawable->GetMaxLights() && !maxPixelLights)
                         GetLitBatches(drawable, lightQueue, alphaQueue);
                     else
                         maxLightsDrawables_.insert(drawable);
@@ -1203,7 +1506,7 @@ void View::GetLightBatches()
         for (auto i = maxLightsDrawables_.begin(); i != maxLightsDrawables_.end(); ++i)
         {
             Drawable* drawable = *i;
-            drawable->LimitLights();
+            drawable->LimitLights(maxPixelLights);
             const ea::vector<Light*>& lights = drawable->GetLights();
 
             for (unsigned i = 0; i < lights.size(); ++i)
@@ -1405,6 +1708,13 @@ void View::UpdateGeometries()
 
     // Finally ensure all threaded work has completed
     queue->Complete(M_MAX_UNSIGNED);
+
+    // Finish the threaded updates on the main thread
+    for (Drawable* drawable : threadedGeometries_)
+    {
+        if (drawable)
+            drawable->FinishUpdateGeometry(frame_);
+    }
     geometriesUpdated_ = true;
 }
 
@@ -1489,13 +1799,20 @@ void View::ExecuteRenderPathCommands()
     if (!renderer_->GetReuseShadowMaps() && renderer_->GetDrawShadows() && !actualView->lightQueues_.empty())
     {
         URHO3D_PROFILE("RenderShadowMaps");
+        GPUProfileZone gpuZone(graphics_, "ShadowMaps");
+        const DrawCallStatistics startStatistics = graphics_->GetFrameStatistics();
 
         for (auto i = actualView->lightQueues_.begin(); i !=
             actualView->lightQueues_.end(); ++i)
         {
-            if (NeedRenderShadowMap(*i))
+            if (NeedRenderShadowMap(*i) && !renderer_->IsShadowMapCached(i->shadowMap_, i->light_, i->shadowMapHash_))
+            {
                 RenderShadowMap(*i);
+                renderer_->SetShadowMapCached(i->shadowMap_, i->light_, i->shadowMapHash_);
+            }
         }
+
+        statistics_.shadowMaps_ = graphics_->GetFrameStatistics() - startStatistics;
     }
 
     {
@@ -1596,6 +1913,9 @@ void View::ExecuteRenderPathCommands()
                     currentRenderTarget_ = substituteRenderTarget_ ? substituteRenderTarget_ : renderTarget_;
             }
 
+            GPUProfileZone gpuZone(graphics_, GetCommandDisplayName(command));
+            const DrawCallStatistics commandStartStatistics = graphics_->GetFrameStatistics();
+
             switch (command.type_)
             {
             case CMD_CLEAR:
@@ -1631,7 +1951,13 @@ void View::ExecuteRenderPathCommands()
                             passCommand_ = &command;
                         }
 
-                        queue.Draw(this, camera_, command.markToStencil_, false, allowDepthWrite);
+                        if (eyeCameras_[1])
+                        {
+                            queue.DrawStereo(this, command.markToStencil_, allowDepthWrite);
+                            EndStereoEyes();
+                        }
+                        else
+                            queue.Draw(this, camera_, command.markToStencil_, false, allowDepthWrite);
 
                         passCommand_ = nullptr;
                     }
@@ -1676,17 +2002,28 @@ void View::ExecuteRenderPathCommands()
                             passCommand_ = &command;
                         }
 
-                        // Draw base (replace blend) batches first
-                        i->litBaseBatches_.Draw(this, camera_, false, false, allowDepthWrite);
-
-                        // Then, if there are additive passes, optimize the light and draw them
-                        if (!i->litBatches_.IsEmpty())
+                        // In stereo, the shadow map is shared and the light is drawn to each eye in turn, as the light
+                        // optimizations depend on the camera
+                        const unsigned numEyes = eyeCameras_[1] ? 2 : 1;
+                        for (unsigned eye = 0; eye < numEyes; ++eye)
                         {
-                            renderer_->OptimizeLightByScissor(i->light_, camera_);
-                            if (!noStencil_)
-                                renderer_->OptimizeLightByStencil(i->light_, camera_);
-                            i->litBatches_.Draw(this, camera_, false, true, allowDepthWrite);
+                            if (eyeCameras_[1])
+                                SetStereoEye(eye);
+
+                            // Draw base (replace blend) batches first
+                            i->litBaseBatches_.Draw(this, camera_, false, false, allowDepthWrite);
+
+                            // Then, if there are additive passes, optimize the light and draw them
+                            if (!i->litBatches_.IsEmpty())
+                            {
+                                renderer_->OptimizeLightByScissor(i->light_, camera_);
+                                if (!noStencil_)
+                                    renderer_->OptimizeLightByStencil(i->light_, camera_);
+                                i->litBatches_.Draw(this, camera_, false, true, allowDepthWrite);
+                            }
                         }
+                        if (eyeCameras_[1])
+                            EndStereoEyes();
 
                         passCommand_ = nullptr;
                     }
@@ -1721,11 +2058,20 @@ void View::ExecuteRenderPathCommands()
                             passCommand_ = &command;
                         }
 
-                        for (unsigned j = 0; j < i->volumeBatches_.size(); ++j)
+                        const unsigned numEyes = eyeCameras_[1] ? 2 : 1;
+                        for (unsigned eye = 0; eye < numEyes; ++eye)
                         {
-                            SetupLightVolumeBatch(i->volumeBatches_[j]);
-                            i->volumeBatches_[j].Draw(this, camera_, false);
+                            if (eyeCameras_[1])
+                                SetStereoEye(eye);
+
+                            for (unsigned j = 0; j < i->volumeBatches_.size(); ++j)
+                            {
+                                SetupLightVolumeBatch(i->volumeBatches_[j]);
+                                i->volumeBatches_[j].Draw(this, camera_, false);
+                            }
                         }
+                        if (eyeCameras_[1])
+                            EndStereoEyes();
 
                         passCommand_ = nullptr;
                     }
@@ -1756,6 +2102,10 @@ void View::ExecuteRenderPathCommands()
                 break;
             }
 
+            RenderPathCommandStatistics& commandStatistics = statistics_.commands_.emplace_back();
+            commandStatistics.name_ = GetCommandDisplayName(command);
+            commandStatistics.drawCalls_ = graphics_->GetFrameStatistics() - commandStartStatistics;
+
             // If current command output to the viewport, mark it modified
             if (viewportWrite)
                 viewportModified = true;
@@ -1832,6 +2182,7 @@ void View::SetRenderTargets(RenderPathCommand& command)
         graphics_->SetDepthStencil(GetDepthStencil(graphics_->GetRenderTarget(0)));
     graphics_->SetViewport(viewport);
     graphics_->SetColorWrite(useColorWrite);
+    stereoViewport_ = viewport;
 }
 
 bool View::SetTextures(RenderPathCommand& command)
@@ -2036,6 +2387,9 @@ void View::AllocateScreenBuffers()
     if (!renderTarget_ && hasCustomDepth)
         needSubstitute = true;
 #endif
+    // If rendering at a reduced resolution or accumulating temporally, need to reserve a buffer to upscale from
+    if (temporalUpscale_ || viewSize_ != viewRect_.Size())
+        needSubstitute = true;
     // If backbuffer is antialiased when using deferred rendering, need to reserve a buffer
     if (deferred_ && !renderTarget_ && graphics_->GetMultiSample() > 1)
         needSubstitute = true;
@@ -2173,6 +2527,74 @@ void View::BlitFramebuffer(Texture* source, RenderSurface* destination, bool dep
     DrawFullscreenQuad(true);
 }
 
+void View::TemporalUpscale(Texture* source)
+{
+    URHO3D_PROFILE("TemporalUpscale");
+
+    static const StringHash jitterOffsetParam("JitterOffset");
+    static const StringHash sourceInvSizeParam("SourceInvSize");
+    static const StringHash temporalBlendParam("TemporalBlend");
+    static const StringHash reprojectionParam("Reprojection");
+    static const StringHash depthName("depth");
+    static const unsigned historyKey = StringHash("TemporalHistory").Value();
+
+    // Accumulate into viewport sized history buffers, which swap roles each frame
+    const IntVector2 outputSize = viewRect_.Size();
+    const unsigned persistentKey = historyKey + (unsigned)(size_t)this;
+    Texture* readHistory = renderer_->GetScreenBuffer(outputSize.x_, outputSize.y_, source->GetFormat(), 1, false, false, true,
+        source->GetSRGB(), persistentKey + (jitterIndex_ & 1u));
+    Texture* writeHistory = renderer_->GetScreenBuffer(outputSize.x_, outputSize.y_, source->GetFormat(), 1, false, false, true,
+        source->GetSRGB(), persistentKey + (~jitterIndex_ & 1u));
+    RenderSurface* historySurface = GetRenderSurfaceFromTexture(writeHistory);
+
+    // Reproject the history by camera motion when the render path provides a readable hardware depth buffer
+    Texture* depth = nullptr;
+    auto depthIt = renderTargets_.find(depthName);
+    if (depthIt != renderTargets_.end() && depthIt->second && depthIt->second->GetFormat() == Graphics::GetReadableDepthFormat())
+        depth = depthIt->second;
+
+    // Discard the history when it has not been accumulated for this camera and size
+    const bool historyValid = historySize_ == outputSize && historyCamera_ == camera_;
+
+    graphics_->SetBlendMode(BLEND_REPLACE);
+    graphics_->SetDepthTest(CMP_ALWAYS);
+    graphics_->SetDepthWrite(false);
+    graphics_->SetFillMode(FILL_SOLID);
+    graphics_->SetLineAntiAlias(false);
+    graphics_->SetClipPlane(false);
+    graphics_->SetScissorTest(false);
+    graphics_->SetStencilTest(false);
+    graphics_->SetRenderTarget(0, historySurface);
+    for (unsigned i = 1; i < MAX_RENDERTARGETS; ++i)
+        graphics_->SetRenderTarget(i, (RenderSurface*)nullptr);
+    graphics_->SetDepthStencil(GetDepthStencil(historySurface));
+    graphics_->SetViewport(IntRect(IntVector2::ZERO, outputSize));
+
+    static const char* shaderName = "TemporalUpscale";
+    const char* defines = depth ? "REPROJECT" : "";
+    graphics_->SetShaders(graphics_->GetShader(VS, shaderName, defines), graphics_->GetShader(PS, shaderName, defines));
+
+    SetGBufferShaderParameters(outputSize, IntRect(IntVector2::ZERO, outputSize));
+    graphics_->SetShaderParameter(jitterOffsetParam, jitterOffset_);
+    graphics_->SetShaderParameter(sourceInvSizeParam, Vector2(1.0f / source->GetWidth(), 1.0f / source->GetHeight()));
+    graphics_->SetShaderParameter(temporalBlendParam, historyValid ? TEMPORAL_BLEND : 1.0f);
+    if (depth)
+        graphics_->SetShaderParameter(reprojectionParam, previousViewProj_ * viewProj_.Inverse());
+
+    graphics_->SetTexture(TU_DIFFUSE, source);
+    graphics_->SetTexture(TU_NORMAL, readHistory);
+    graphics_->SetTexture(TU_DEPTHBUFFER, depth);
+    DrawFullscreenQuad(true);
+    graphics_->SetTexture(TU_NORMAL, nullptr);
+    graphics_->SetTexture(TU_DEPTHBUFFER, nullptr);
+
+    historySize_ = outputSize;
+    historyCamera_ = camera_;
+    previousViewProj_ = viewProj_;
+
+    BlitFramebuffer(writeHistory, renderTarget_, !usedResolve_);
+}
+
 void View::DrawFullscreenQuad(bool setIdentityProjection)
 {
     Geometry* geometry = renderer_->GetQuadGeometry();
@@ -2265,6 +2687,48 @@ void View::UpdateOccluders(ea::vector<Drawable*>& occluders, Camera* camera)
         ea::quick_sort(occluders.begin(), occluders.end(), CompareDrawables);
 }
 
+void View::UpdateAutoOccluders()
+{
+    URHO3D_PROFILE("UpdateAutoOccluders");
+
+    autoOccluders_.clear();
+    if (maxOccluderTriangles_ <= 0)
+        return;
+
+    float occluderSizeThreshold = renderer_->GetOccluderSizeThreshold();
+    float halfViewSize = cullCamera_->GetHalfViewSize();
+    float invOrthoSize = 1.0f / cullCamera_->GetOrthoSize();
+    bool orthographic = cullCamera_->IsOrthographic();
+
+    autoOccluderCandidates_.clear();
+    for (Drawable* drawable : geometries_)
+    {
+        // User-flagged occluders were already gathered by the occluder query
+        if (drawable->IsOccluder() || !drawable->GetNumOccluderTriangles())
+            continue;
+
+        float diagonal = drawable->GetWorldBoundingBox().Size().Length();
+        float screenSize = orthographic ? diagonal * invOrthoSize : diagonal * halfViewSize / Max(drawable->GetDistance(), M_EPSILON);
+        if (screenSize >= occluderSizeThreshold)
+            autoOccluderCandidates_.emplace_back(screenSize, drawable);
+    }
+
+    const auto compareCandidates = [](const ea::pair<float, Drawable*>& lhs, const ea::pair<float, Drawable*>& rhs)
+    {
+        return lhs.first > rhs.first;
+    };
+
+    auto last = autoOccluderCandidates_.end();
+    if (autoOccluderCandidates_.size() > MAX_AUTO_OCCLUDERS)
+    {
+        last = autoOccluderCandidates_.begin() + MAX_AUTO_OCCLUDERS;
+        ea::nth_element(autoOccluderCandidates_.begin(), last, autoOccluderCandidates_.end(), compareCandidates);
+    }
+
+    for (auto i = autoOccluderCandidates_.begin(); i != last; ++i)
+        autoOccluders_.emplace_back(i->second);
+}
+
 void View::DrawOccluders(OcclusionBuffer* buffer, const ea::vector<Drawable*>& occluders)
 {
     buffer->SetMaxTriangles((unsigned)maxOccluderTriangles_);
@@ -2470,6 +2934,8 @@ void View::ProcessShadowCasters(LightQueryResult& query, const ea::vector<Drawab
             maxShadowDistance = drawDistance;
         if (maxShadowDistance > 0.0f && drawable->GetDistance() > maxShadowDistance)
             continue;
+        if (!drawable->IsHierarchicalLodVisible(frame_))
+            continue;
 
         // Project shadow caster bounding box to light view space for visibility check
         lightViewBox = drawable->GetWorldBoundingBox().Transformed(lightView);
@@ -2830,6 +3296,23 @@ void View::FindZone(Drawable* drawable)
     if (lastZone && (lastZone->GetViewMask() & cullCamera_->GetViewMask()) && lastZone->GetPriority() >= highestZonePriority_ &&
         (drawable->GetZoneMask() & lastZone->GetZoneMask()) && lastZone->IsInside(center))
         newZone = lastZone;
+    else if (!zoneGridCells_.empty())
+    {
+        // Zones of the cell are sorted by priority, so the first matching zone wins
+        if (zoneGridBox_.IsInside(center) != OUTSIDE)
+        {
+            const ea::pair<unsigned, unsigned>& cell = zoneGridCells_[GetZoneGridCellIndex(center)];
+            for (unsigned i = cell.first; i < cell.first + cell.second; ++i)
+            {
+                Zone* zone = zoneGridZones_[i];
+                if ((drawable->GetZoneMask() & zone->GetZoneMask()) && zone->IsInside(center))
+                {
+                    newZone = zone;
+                    break;
+                }
+            }
+        }
+    }
     else
     {
         for (auto i = zones_.begin(); i != zones_.end(); ++i)
@@ -2847,6 +3330,73 @@ void View::FindZone(Drawable* drawable)
     drawable->SetZone(newZone, temporary);
 }
 
+void View::UpdateZoneGrid()
+{
+    zoneGridCells_.clear();
+    zoneGridZones_.clear();
+    if (zones_.size() < MIN_ZONES_FOR_GRID)
+        return;
+
+    // Stable sort keeps the first zone among equal priorities, same as the linear search
+    ea::vector<Zone*> sortedZones = zones_;
+    ea::stable_sort(sortedZones.begin(), sortedZones.end(),
+        [](const Zone* lhs, const Zone* rhs) { return lhs->GetPriority() > rhs->GetPriority(); });
+
+    zoneGridBox_.Clear();
+    for (Zone* zone : sortedZones)
+        zoneGridBox_.Merge(zone->GetWorldBoundingBox());
+
+    zoneGridSize_ = Clamp(CeilToInt(powf(static_cast<float>(sortedZones.size()), 1.0f / 3.0f) * 2.0f), 1, MAX_ZONE_GRID_SIZE);
+    const Vector3 gridSize = VectorMax(zoneGridBox_.Size(), Vector3::ONE * M_EPSILON);
+    zoneGridCellScale_ = Vector3::ONE * static_cast<float>(zoneGridSize_) / gridSize;
+    zoneGridCells_.resize(zoneGridSize_ * zoneGridSize_ * zoneGridSize_);
+
+    // Count zones per cell first, then fill the cells in priority order
+    for (unsigned pass = 0; pass < 2; ++pass)
+    {
+        for (Zone* zone : sortedZones)
+        {
+            const BoundingBox& zoneBox = zone->GetWorldBoundingBox();
+            const IntVector3 minCell = VectorFloorToInt((zoneBox.min_ - zoneGridBox_.min_) * zoneGridCellScale_);
+            const IntVector3 maxCell = VectorFloorToInt((zoneBox.max_ - zoneGridBox_.min_) * zoneGridCellScale_);
+            for (int z = Max(minCell.z_, 0); z <= Min(maxCell.z_, zoneGridSize_ - 1); ++z)
+            {
+                for (int y = Max(minCell.y_, 0); y <= Min(maxCell.y_, zoneGridSize_ - 1); ++y)
+                {
+                    for (int x = Max(minCell.x_, 0); x <= Min(maxCell.x_, zoneGridSize_ - 1); ++x)
+                    {
+                        ea::pair<unsigned, unsigned>& cell = zoneGridCells_[(z * zoneGridSize_ + y) * zoneGridSize_ + x];
+                        if (pass == 1)
+                            zoneGridZones_[cell.first + cell.second] = zone;
+                        ++cell.second;
+                    }
+                }
+            }
+        }
+
+        if (pass == 0)
+        {
+            unsigned start = 0;
+            for (ea::pair<unsigned, unsigned>& cell : zoneGridCells_)
+            {
+                cell.first = start;
+                start += cell.second;
+                cell.second = 0;
+            }
+            zoneGridZones_.resize(start);
+        }
+    }
+}
+
+unsigned View::GetZoneGridCellIndex(const Vector3& position) const
+{
+    const IntVector3 cell = VectorFloorToInt((position - zoneGridBox_.min_) * zoneGridCellScale_);
+    const int x = Clamp(cell.x_, 0, zoneGridSize_ - 1);
+    const int y = Clamp(cell.y_, 0, zoneGridSize_ - 1);
+    const int z = Clamp(cell.z_, 0, zoneGridSize_ - 1);
+    return (z * zoneGridSize_ + y) * zoneGridSize_ + x;
+}
+
 Technique* View::GetTechnique(Drawable* drawable, Material* material)
 {
     if (!material)
@@ -2956,11 +3506,23 @@ void View::AddBatchToQueue(BatchQueue& queue, Batch& batch, Technique* tech, boo
             newGroup.CalculateSortKey();
             i = queue.batchGroups_.insert(ea::make_pair(key, newGroup)).first;
         }
+        else if (i->second.instances_.empty())
+        {
+            // Refresh a group retained from the previous frame the same way as if it was just created
+            BatchGroup& group = i->second;
+            static_cast<Batch&>(group) = batch;
+            group.geometryType_ = GEOM_STATIC;
+            group.startIndex_ = M_MAX_UNSIGNED;
+            renderer_->SetBatchShaders(group, tech, allowShadows, queue);
+            group.CalculateSortKey();
+        }
 
         int oldSize = i->second.instances_.size();
         i->second.AddTransforms(batch);
-        // Convert to using instancing shaders when the instancing limit is reached
-        if (oldSize < minInstances_ && (int) i->second.instances_.size() >= minInstances_)
+        // Convert to using instancing shaders when the instancing limit is reached. Batches with custom per-instance data
+        // are converted right away, because that data only reaches the shaders through the instancing buffer
+        const int minInstances = batch.instancingData_ ? 1 : minInstances_;
+        if (oldSize < minInstances && (int) i->second.instances_.size() >= minInstances)
         {
             i->second.geometryType_ = GEOM_INSTANCED;
             renderer_->SetBatchShaders(i->second, tech, allowShadows, queue);
@@ -3002,37 +3564,76 @@ void View::PrepareInstancingBuffer()
     URHO3D_PROFILE("PrepareInstancingBuffer");
 
     unsigned totalInstances = 0;
+    instancingQueues_.clear();
+
+    const auto addQueue = [&](BatchQueue& queue)
+    {
+        const unsigned numInstances = queue.GetNumInstances();
+        if (numInstances)
+        {
+            instancingQueues_.emplace_back(&queue, numInstances);
+            totalInstances += numInstances;
+        }
+    };
 
     for (auto i = batchQueues_.begin(); i != batchQueues_.end(); ++i)
-        totalInstances += i->second.GetNumInstances();
+        addQueue(i->second);
 
     for (auto i = lightQueues_.begin(); i != lightQueues_.end(); ++i)
     {
         for (unsigned j = 0; j < i->shadowSplits_.size(); ++j)
-            totalInstances += i->shadowSplits_[j].shadowBatches_.GetNumInstances();
-        totalInstances += i->litBaseBatches_.GetNumInstances();
-        totalInstances += i->litBatches_.GetNumInstances();
+            addQueue(i->shadowSplits_[j].shadowBatches_);
+        addQueue(i->litBaseBatches_);
+        addQueue(i->litBatches_);
     }
 
-    if (!totalInstances || !renderer_->ResizeInstancingBuffer(totalInstances))
+    if (!totalInstances)
         return;
 
+    renderer_->SwitchInstancingBuffer();
+    if (!renderer_->ResizeInstancingBuffer(totalInstances))
+        return;
+
+    // The buffer at this ring position was last used some frames ago. On OpenGL it can be updated in place, which avoids having
+    // the driver orphan and reallocate it on every fill. Direct3D dynamic buffers must always be mapped with discard
+#ifdef URHO3D_OPENGL
+    const bool discard = false;
+#else
+    const bool discard = true;
+#endif
+
     VertexBuffer* instancingBuffer = renderer_->GetInstancingBuffer();
-    unsigned freeIndex = 0;
-    void* dest = instancingBuffer->Lock(0, totalInstances, true);
+    void* dest = instancingBuffer->Lock(0, totalInstances, discard);
     if (!dest)
         return;
 
     const unsigned stride = instancingBuffer->GetVertexSize();
-    for (auto i = batchQueues_.begin(); i != batchQueues_.end(); ++i)
-        i->second.SetInstancingData(dest, stride, freeIndex);
+    auto* workQueue = GetSubsystem<WorkQueue>();
 
-    for (auto i = lightQueues_.begin(); i != lightQueues_.end(); ++i)
+    // Each batch queue occupies a contiguous range of the buffer, so the ranges can be filled in worker threads.
+    // Only the buffer lock and unlock need to happen on the main thread
+    unsigned freeIndex = 0;
+    if (workQueue->GetNumThreads() && instancingQueues_.size() > 1)
     {
-        for (unsigned j = 0; j < i->shadowSplits_.size(); ++j)
-            i->shadowSplits_[j].shadowBatches_.SetInstancingData(dest, stride, freeIndex);
-        i->litBaseBatches_.SetInstancingData(dest, stride, freeIndex);
-        i->litBatches_.SetInstancingData(dest, stride, freeIndex);
+        for (const auto& item : instancingQueues_)
+        {
+            BatchQueue* batchQueue = item.first;
+            const unsigned startIndex = freeIndex;
+            workQueue->AddWorkItem([=]()
+            {
+                URHO3D_PROFILE("FillInstancingBufferWork");
+                unsigned queueFreeIndex = startIndex;
+                batchQueue->SetInstancingData(dest, stride, queueFreeIndex);
+            }, M_MAX_UNSIGNED);
+            freeIndex += item.second;
+        }
+
+        workQueue->Complete(M_MAX_UNSIGNED);
+    }
+    else
+    {
+        for (const auto& item : instancingQueues_)
+            item.first->SetInstancingData(dest, stride, freeIndex);
     }
 
     instancingBuffer->Unlock();
@@ -3097,6 +3698,7 @@ bool View::NeedRenderShadowMap(const LightBatchQueue& queue)
 void View::RenderShadowMap(const LightBatchQueue& queue)
 {
     URHO3D_PROFILE("RenderShadowMap");
+    GPUProfileZone gpuZone(graphics_, "ShadowMap");
 
     Texture2D* shadowMap = queue.shadowMap_;
     graphics_->SetTexture(TU_SHADOWMAP, nullptr);
@@ -103,6 +103,46 @@ struct PerThreadSceneResult
     float minZ_;
     /// Scene maximum Z value.
     float maxZ_;
+    /// Number of drawables tested against the occlusion buffer.
+    unsigned numOcclusionTested_;
+    /// Number of drawables rejected by the occlusion buffer.
+    unsigned numOcclusionCulled_;
+    /// Number of drawables rejected by draw distance.
+    unsigned numDistanceCulled_;
+};
+
+/// Draw call statistics of a render path command.
+struct RenderPathCommandStatistics
+{
+    /// Command tag, pass name or type name.
+    ea::string name_;
+    /// Draw calls and state changes issued by the command.
+    DrawCallStatistics drawCalls_;
+};
+
+/// Culling and draw call statistics of a view.
+struct ViewStatistics
+{
+    /// Number of drawables returned by the octree frustum query.
+    unsigned numFrustumDrawables_{};
+    /// Number of drawables tested against the occlusion buffer.
+    unsigned numOcclusionTested_{};
+    /// Number of drawables rejected by the occlusion buffer.
+    unsigned numOcclusionCulled_{};
+    /// Number of drawables rejected by draw distance.
+    unsigned numDistanceCulled_{};
+    /// Number of visible geometries.
+    unsigned numGeometries_{};
+    /// Number of visible lights.
+    unsigned numLights_{};
+    /// Number of occluders rendered to the occlusion buffer.
+    unsigned numOccluders_{};
+    /// Draw calls of shadow maps rendered before the render path commands.
+    DrawCallStatistics shadowMaps_;
+    /// Draw calls of the whole view.
+    DrawCallStatistics drawCalls_;
+    /// Draw calls of executed render path commands.
+    ea::vector<RenderPathCommandStatistics> commands_;
 };
 
 static const unsigned MAX_VIEWPORT_TEXTURES = 2;
@@ -146,6 +186,9 @@ public:
     /// Return culling camera. Normally same as the viewport camera.
     Camera* GetCullCamera() const { return cullCamera_; }
 
+    /// Return right eye camera when rendering in stereo, otherwise null.
+    Camera* GetRightEyeCamera() const { return eyeCameras_[1]; }
+
     /// Return information of the frame being rendered.
     const FrameInfo& GetFrameInfo() const { return frame_; }
 
@@ -165,7 +208,7 @@ public:
     /// Return view rectangle.
     const IntRect& GetViewRect() const { return viewRect_; }
 
-    /// Return view dimensions.
+    /// Return view dimensions. May be smaller than the view rectangle when dynamic resolution is in use.
     const IntVector2& GetViewSize() const { return viewSize_; }
 
     /// Return geometry objects.
@@ -186,6 +229,9 @@ public:
     /// Return number of occluders that were actually rendered. Occluders may be rejected if running out of triangles or if behind other occluders.
     unsigned GetNumActiveOccluders() const { return activeOccluders_; }
 
+    /// Return culling and draw call statistics of the last update and render.
+    const ViewStatistics& GetStatistics() const { return statistics_; }
+
     /// Return the source view that was already prepared. Used when viewports specify the same culling camera.
     View* GetSourceView() const;
 
@@ -197,6 +243,10 @@ public:
     void SetCommandShaderParameters(const RenderPathCommand& command);
     /// Set G-buffer offset and inverse size shader parameters. Called by Batch and internally by View.
     void SetGBufferShaderParameters(const IntVector2& texSize, const IntRect& viewRect);
+    /// Select the eye to render in stereo: its camera, clip plane and half of the current viewport. Called by BatchQueue and internally by View.
+    void SetStereoEye(unsigned eye);
+    /// Return the G-buffer rectangle of the eye being rendered in stereo. Called by Batch.
+    IntRect GetStereoEyeRect() const;
 
     /// Draw a fullscreen quad. Shaders and renderstates must have been set beforehand. Quad will be drawn to the middle of depth range, similarly to deferred directional lights.
     void DrawFullscreenQuad(bool setIdentityProjection = false);
@@ -239,10 +289,20 @@ private:
     void AllocateScreenBuffers();
     /// Blit the viewport from one surface to another.
     void BlitFramebuffer(Texture* source, RenderSurface* destination, bool depthWrite);
+    /// Return aspect ratio of each eye, or of the whole view when not rendering in stereo.
+    float GetEyeAspectRatio() const;
+    /// Place the combined culling camera so that its frustum encloses both eyes.
+    void UpdateStereoCullCamera();
+    /// Return to the left eye and the whole viewport after rendering a stereo command.
+    void EndStereoEyes();
+    /// Accumulate the jittered, possibly scaled down viewport into the temporal history and blit the result to the destination.
+    void TemporalUpscale(Texture* source);
     /// Query for occluders as seen from a camera.
     void UpdateOccluders(ea::vector<Drawable*>& occluders, Camera* camera);
     /// Draw occluders to occlusion buffer.
     void DrawOccluders(OcclusionBuffer* buffer, const ea::vector<Drawable*>& occluders);
+    /// Pick the largest visible geometries as automatic occluders for the next frame.
+    void UpdateAutoOccluders();
     /// Query for lit geometries and shadow casters for a light.
     void ProcessLight(LightQueryResult& query, unsigned threadIndex);
     /// Process shadow casters' visibilities and build their combined view- or projection-space bounding box.
@@ -262,6 +322,10 @@ private:
         const Frustum& lightViewFrustum, const BoundingBox& lightViewFrustumBox);
     /// Return the viewport for a shadow map split.
     IntRect GetShadowMapViewport(Light* light, int splitIndex, Texture2D* shadowMap);
+    /// Build the zone grid from the visible zones if there are enough of them to benefit.
+    void UpdateZoneGrid();
+    /// Return zone grid cell index of a position inside the grid bounds.
+    unsigned GetZoneGridCellIndex(const Vector3& position) const;
     /// Find and set a new zone for a drawable when it has moved.
     void FindZone(Drawable* drawable);
     /// Return material technique, considering the drawable's LOD distance.
@@ -401,6 +465,16 @@ private:
     ea::vector<PerThreadSceneResult> sceneResults_;
     /// Visible zones.
     ea::vector<Zone*> zones_;
+    /// Bounds of the zone grid.
+    BoundingBox zoneGridBox_;
+    /// Number of zone grid cells along each axis.
+    int zoneGridSize_{};
+    /// Zone grid cells per world unit along each axis.
+    Vector3 zoneGridCellScale_;
+    /// Start and count of zones in each zone grid cell. Empty when the grid is not in use.
+    ea::vector<ea::pair<unsigned, unsigned>> zoneGridCells_;
+    /// Zones overlapping each cell, sorted by descending priority within a cell.
+    ea::vector<Zone*> zoneGridZones_;
     /// Visible geometry objects.
     ea::vector<Drawable*> geometries_;
     /// Geometry objects that will be updated in the main thread.
@@ -411,8 +485,14 @@ private:
     ea::vector<Drawable*> occluders_;
     /// Lights.
     ea::vector<Light*> lights_;
+    /// Geometries picked on the previous frame to be used as occluders in addition to the ones flagged by the user.
+    ea::vector<WeakPtr<Drawable> > autoOccluders_;
+    /// Automatic occluder candidates and their screen sizes.
+    ea::vector<ea::pair<float, Drawable*> > autoOccluderCandidates_;
     /// Number of active occluders.
     unsigned activeOccluders_{};
+    /// Culling and draw call statistics.
+    ViewStatistics statistics_;
 
     /// Drawables that limit their maximum light count.
     ea::hash_set<Drawable*> maxLightsDrawables_;
@@ -428,6 +508,8 @@ private:
     ea::unordered_map<unsigned long long, LightBatchQueue> vertexLightQueues_;
     /// Batch queues by pass index.
     ea::unordered_map<unsigned, BatchQueue> batchQueues_;
+    /// Batch queues with instanced draw calls and their instance counts, used when filling the instancing buffer.
+    ea::vector<ea::pair<BatchQueue*, unsigned> > instancingQueues_;
     /// Index of the GBuffer pass.
     unsigned gBufferPassIndex_{};
     /// Index of the opaque forward base pass.
@@ -448,6 +530,32 @@ private:
     const RenderPathCommand* passCommand_{};
     /// Flag for scene being resolved from the backbuffer.
     bool usedResolve_{};
+    /// Flag for jittering the camera and upscaling the viewport temporally.
+    bool temporalUpscale_{};
+    /// Index of the current subpixel jitter position.
+    unsigned jitterIndex_{};
+    /// Subpixel jitter of the current frame in texture coordinates.
+    Vector2 jitterOffset_;
+    /// Camera projection offset before jitter was applied.
+    Vector2 savedProjectionOffset_;
+    /// Unjittered view-projection matrix of the current frame.
+    Matrix4 viewProj_;
+    /// Unjittered view-projection matrix the temporal history was rendered with.
+    Matrix4 previousViewProj_;
+    /// Size of the temporal history. Zero if there is no valid history.
+    IntVector2 historySize_;
+    /// Camera the temporal history was rendered with.
+    WeakPtr<Camera> historyCamera_;
+    /// Left and right eye cameras when rendering in stereo. The right eye camera is null otherwise.
+    Camera* eyeCameras_[2]{};
+    /// Eye being rendered in stereo.
+    unsigned stereoEye_{};
+    /// Viewport spanning both eyes for the current render path command.
+    IntRect stereoViewport_;
+    /// Scene node of the culling camera enclosing both eyes.
+    SharedPtr<Node> stereoCullNode_;
+    /// Culling camera enclosing both eyes. Created when rendering in stereo without a culling camera.
+    Camera* stereoCullCamera_{};
 };
 
 }
@@ -88,6 +88,11 @@ void Viewport::SetCullCamera(Camera* camera)
     cullCamera_ = camera;
 }
 
+void Viewport::SetRightEyeCamera(Camera* camera)
+{
+    rightEyeCamera_ = camera;
+}
+
 void Viewport::SetRect(const IntRect& rect)
 {
     rect_ = rect;
@@ -136,6 +141,11 @@ Camera* Viewport::GetCullCamera() const
     return cullCamera_;
 }
 
+Camera* Viewport::GetRightEyeCamera() const
+{
+    return rightEyeCamera_;
+}
+
 View* Viewport::GetView() const
 {
     return view_;
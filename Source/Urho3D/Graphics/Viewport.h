@@ -75,6 +75,9 @@ public:
     /// Set separate camera to use for culling. Sharing a culling camera between several viewports allows to prepare the view only once, saving in CPU use. The culling camera's frustum should cover all the viewport cameras' frusta or else objects may be missing from the rendered view.
     /// @property
     void SetCullCamera(Camera* camera);
+    /// Set right eye camera for single pass stereo rendering. When set, the viewport camera renders the left half of the view rectangle and this camera the right half, sharing culling, batches and shadow maps. Without a culling camera, the view is culled against a camera enclosing both eyes, which assumes the eyes share orientation and projection.
+    /// @property
+    void SetRightEyeCamera(Camera* camera);
 
     /// Return scene.
     /// @property
@@ -101,6 +104,10 @@ public:
     /// @property
     Camera* GetCullCamera() const;
 
+    /// Return the right eye camera for stereo rendering. If null, the viewport renders a single view.
+    /// @property
+    Camera* GetRightEyeCamera() const;
+
     /// Return ray corresponding to normalized screen coordinates.
     Ray GetScreenRay(int x, int y) const;
     /// Convert a world space point to normalized screen coordinates.
@@ -118,6 +125,8 @@ private:
     WeakPtr<Camera> camera_;
     /// Culling camera pointer.
     WeakPtr<Camera> cullCamera_;
+    /// Right eye camera pointer.
+    WeakPtr<Camera> rightEyeCamera_;
     /// Viewport rectangle.
     IntRect rect_;
     /// Rendering path.
@@ -28,10 +28,12 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/Animation.h"
 #include "../Graphics/AnimationState.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../IO/Log.h"
+#include "../Scene/Scene.h"
 #include "../Scene/SceneEvents.h"
 
 #include <ik/effector.h>
@@ -52,7 +54,8 @@ IKSolver::IKSolver(Context* context) :
     features_(AUTO_SOLVE | JOINT_ROTATIONS | UPDATE_ACTIVE_POSE),
     chainTreesNeedUpdating_(false),
     treeNeedsRebuild(true),
-    solverTreeValid_(false)
+    solverTreeValid_(false),
+    autoSolved_(false)
 {
     context_->RequireIK();
 
@@ -400,6 +403,54 @@ void IKSolver::Solve()
 {
     URHO3D_PROFILE("IKSolve");
 
+    if (!PrepareSolve())
+        return;
+
+    SolvePose();
+    ApplyActivePoseToScene();
+}
+
+// ----------------------------------------------------------------------------
+void IKSolver::SolveAll(const ea::vector<IKSolver*>& solvers)
+{
+    URHO3D_PROFILE("IKSolveAll");
+
+    if (solvers.empty())
+        return;
+
+    // Solvers below another solver need its solution applied to the scene first
+    ea::vector<IKSolver*> independentSolvers;
+    ea::vector<IKSolver*> dependentSolvers;
+    for (IKSolver* solver : solvers)
+    {
+        if (solver->HasParentSolver())
+            dependentSolvers.push_back(solver);
+        else if (solver->PrepareSolve())
+            independentSolvers.push_back(solver);
+    }
+
+    auto* queue = solvers.front()->GetSubsystem<WorkQueue>();
+    auto solveBatch = [&independentSolvers](unsigned begin, unsigned end, unsigned /*threadIndex*/)
+    {
+        for (unsigned i = begin; i < end; ++i)
+            independentSolvers[i]->SolvePose();
+    };
+
+    if (queue)
+        queue->ParallelFor(independentSolvers.size(), 1, solveBatch);
+    else
+        solveBatch(0, independentSolvers.size(), 0);
+
+    for (IKSolver* solver : independentSolvers)
+        solver->ApplyActivePoseToScene();
+
+    for (IKSolver* solver : dependentSolvers)
+        solver->Solve();
+}
+
+// ----------------------------------------------------------------------------
+bool IKSolver::PrepareSolve()
+{
     if (treeNeedsRebuild)
         RebuildTree();
 
@@ -407,7 +458,7 @@ void IKSolver::Solve()
         RebuildChainTrees();
 
     if (IsSolverTreeValid() == false)
-        return;
+        return false;
 
     if (features_ & UPDATE_ORIGINAL_POSE)
         ApplySceneToOriginalPose();
@@ -423,12 +474,27 @@ void IKSolver::Solve()
         (*it)->UpdateTargetNodePosition();
     }
 
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+void IKSolver::SolvePose()
+{
     ik_solver_solve(solver_);
 
     if (features_ & JOINT_ROTATIONS)
         ik_solver_calculate_joint_rotations(solver_);
+}
 
-    ApplyActivePoseToScene();
+// ----------------------------------------------------------------------------
+bool IKSolver::HasParentSolver() const
+{
+    for (Node* parent = node_ ? node_->GetParent() : nullptr; parent; parent = parent->GetParent())
+    {
+        if (parent->GetComponent<IKSolver>())
+            return true;
+    }
+    return false;
 }
 
 // ----------------------------------------------------------------------------
@@ -722,7 +788,34 @@ void IKSolver::HandleNodeRemoved(StringHash eventType, VariantMap& eventData)
 // ----------------------------------------------------------------------------
 void IKSolver::HandleSceneDrawableUpdateFinished(StringHash eventType, VariantMap& eventData)
 {
-    Solve();
+    // Already solved by another solver of the scene this frame
+    if (autoSolved_)
+    {
+        autoSolved_ = false;
+        return;
+    }
+
+    // If the scene indexes the solvers, the first one to receive the event solves all of them at once
+    Scene* scene = GetScene();
+    const SceneComponentIndex& solverIndex = scene->GetComponentIndex<IKSolver>();
+    if (!solverIndex.contains(this))
+    {
+        Solve();
+        return;
+    }
+
+    ea::vector<IKSolver*> solvers;
+    for (Component* component : solverIndex)
+    {
+        auto* solver = static_cast<IKSolver*>(component);
+        if (solver->features_ & AUTO_SOLVE)
+        {
+            solvers.push_back(solver);
+            solver->autoSolved_ = solver != this;
+        }
+    }
+
+    SolveAll(solvers);
 }
 
 // ----------------------------------------------------------------------------
@@ -278,6 +278,17 @@ public:
      */
     void Solve();
 
+    /*!
+     * @brief Invokes several solvers at once. The scene graph is read and
+     * written on the calling thread, while the solvers themselves run in
+     * parallel on the work queue. Must be called from the main thread.
+     * @note Solvers placed below the node of another solver depend on its
+     * solution and are solved afterwards one by one, in the given order.
+     * Auto-solving uses this for all solvers in a scene that has a component
+     * index for IKSolver (see Scene::CreateComponentIndex()).
+     */
+    static void SolveAll(const ea::vector<IKSolver*>& solvers);
+
     /*!
      * Copies the original pose into the scene graph. This will reset the pose
      * to whatever state it had when the IKSolver component was first created,
@@ -326,6 +337,12 @@ private:
     void MarkTreeNeedsRebuild();
     /// Returns false if calling Solve() would cause the IK library to abort. Urho3D's error handling philosophy is to log an error and continue, not crash.
     bool IsSolverTreeValid() const;
+    /// Rebuilds the tree if needed and reads the scene graph into the solver's poses. Return false if there is nothing to solve.
+    bool PrepareSolve();
+    /// Runs the IK library on the prepared poses. Does not access the scene graph, so different solvers may run in parallel.
+    void SolvePose();
+    /// Return whether the node of another solver is above this solver's node.
+    bool HasParentSolver() const;
 
     /// Subscribe to drawable update finished event here.
     void OnSceneSet(Scene* scene) override;
@@ -398,6 +415,8 @@ private:
     bool chainTreesNeedUpdating_;
     bool treeNeedsRebuild;
     bool solverTreeValid_;
+    /// Whether this frame's automatic solve was already done together with the other solvers of the scene.
+    bool autoSolved_;
 };
 
 } // namespace Urho3D
@@ -38,6 +38,7 @@
 
 #include <EASTL/string.h>
 
+#include <tuple>
 #include <type_traits>
 
 namespace Urho3D
@@ -877,4 +878,95 @@ inline bool SerializeCustomEnum(Archive& archive, const char* name, const char*
         return SerializeEnum(archive, name, enumConstants, const_cast<T&>(value));
 }
 
+/// Description of a struct field for SerializeStruct.
+template <class T, class M>
+struct ArchiveStructField
+{
+    /// Field name.
+    const char* name_{};
+    /// Pointer to member.
+    M T::* member_{};
+    /// Struct version the field was added in. Loading older data leaves the field unchanged.
+    unsigned sinceVersion_{};
+};
+
+/// Describe a struct field for SerializeStruct.
+template <class T, class M>
+constexpr ArchiveStructField<T, M> MakeArchiveStructField(const char* name, M T::* member, unsigned sinceVersion = 1)
+{
+    return { name, member, sinceVersion };
+}
+
+namespace Detail
+{
+
+/// Serialize single struct field. Trivially copyable fields are copied as is in binary archives.
+template <class T, class M>
+inline bool SerializeStructField(Archive& archive, T& value, unsigned version, const ArchiveStructField<T, M>& field)
+{
+    if (archive.IsInput() && version < field.sinceVersion_)
+        return true;
+
+    M& member = value.*field.member_;
+    if constexpr (std::is_trivially_copyable<M>::value)
+    {
+        if (!archive.IsHumanReadable())
+            return archive.SerializeBytes(field.name_, &member, sizeof(M));
+    }
+    return SerializeValue(archive, field.name_, member);
+}
+
+/// Return whether the fields cover the whole struct in declaration order without padding.
+template <class T, class Tuple>
+inline bool IsArchiveStructPacked(const T& value, const Tuple& fields)
+{
+    const auto base = reinterpret_cast<const unsigned char*>(&value);
+    unsigned offset = 0;
+    bool packed = true;
+    std::apply([&](const auto&... field)
+    {
+        ((packed = packed && static_cast<unsigned>(reinterpret_cast<const unsigned char*>(&(value.*field.member_)) - base) == offset,
+            offset += sizeof(value.*field.member_)), ...);
+    }, fields);
+    return packed && offset == sizeof(T);
+}
+
+}
+
+/// Serialize struct described by T::GetArchiveFields() with version T::ArchiveVersion.
+/// - GetArchiveFields is a static constexpr function returning a tuple of MakeArchiveStructField.
+/// - Fields are serialized in the order of description. New fields should be appended with new version.
+/// - Binary archives store fields back to back with no per-field blocks. Trivially copyable fields are copied as bytes,
+///   and the current version of a tightly packed trivially copyable struct is copied with one call.
+template <class T>
+inline bool SerializeStruct(Archive& archive, const char* name, T& value)
+{
+    static constexpr unsigned currentVersion = T::ArchiveVersion;
+    static constexpr auto fields = T::GetArchiveFields();
+    static_assert(currentVersion > 0, "Struct version must be positive");
+
+    if (ArchiveBlock block = archive.OpenUnorderedBlock(name))
+    {
+        const unsigned version = archive.SerializeVersion(currentVersion);
+        if (!version || version > currentVersion)
+        {
+            archive.SetError(Format("Unsupported version {0} of struct '{1}'", version, name));
+            return false;
+        }
+
+        if constexpr (std::is_trivially_copyable<T>::value)
+        {
+            // Same bytes as serialized field by field
+            if (!archive.IsHumanReadable() && version == currentVersion && Detail::IsArchiveStructPacked(value, fields))
+                return archive.SerializeBytes("data", &value, sizeof(T));
+        }
+
+        return std::apply([&](const auto&... field)
+        {
+            return (Detail::SerializeStructField(archive, value, version, field) && ...);
+        }, fields);
+    }
+    return false;
+}
+
 }
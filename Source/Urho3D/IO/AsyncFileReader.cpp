@@ -0,0 +1,238 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include <EASTL/sort.h>
+
+#include "../Core/Profiler.h"
+#include "../Core/Thread.h"
+#include "../IO/AsyncFileReader.h"
+#include "../IO/File.h"
+#include "../IO/Log.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+/// Maximum number of requests an I/O thread takes at once.
+static const unsigned MAX_ASYNC_READ_BATCH = 16;
+
+/// I/O thread of the asynchronous file reader.
+class AsyncFileReaderThread : public Thread
+{
+public:
+    /// Construct.
+    explicit AsyncFileReaderThread(AsyncFileReader* reader) :
+        reader_(reader)
+    {
+    }
+
+    /// Serve requests until shutdown.
+    void ThreadFunction() override
+    {
+        URHO3D_PROFILE_THREAD("AsyncFileReader Thread");
+
+        while (reader_->ProcessBatch())
+        {
+        }
+    }
+
+private:
+    /// Owner reader.
+    AsyncFileReader* reader_;
+};
+
+AsyncFileRead::AsyncFileRead(const ea::string& fileName, unsigned offset, unsigned size) :
+    fileName_(fileName),
+    offset_(offset),
+    size_(size)
+{
+}
+
+AsyncFileRead::AsyncFileRead(File* file) :
+    fileName_(file ? file->GetName() : EMPTY_STRING),
+    file_(file),
+    offset_(file ? file->GetPosition() : 0),
+    size_(M_MAX_UNSIGNED)
+{
+}
+
+AsyncFileRead::~AsyncFileRead() = default;
+
+bool AsyncFileRead::Wait()
+{
+    if (!IsCompleted())
+    {
+        std::unique_lock<std::mutex> lock(waitMutex_);
+        waitCondition_.wait(lock, [this] { return IsCompleted(); });
+    }
+    return success_;
+}
+
+void AsyncFileRead::Execute(Context* context, File* openFile)
+{
+    File* file = file_;
+    SharedPtr<File> ownFile;
+    if (!file)
+    {
+        file = openFile;
+        if (!file)
+        {
+            ownFile = MakeShared<File>(context);
+            if (!ownFile->Open(fileName_))
+            {
+                Complete(false);
+                return;
+            }
+            file = ownFile;
+        }
+        if (file->Seek(offset_) != offset_)
+        {
+            Complete(false);
+            return;
+        }
+    }
+
+    const unsigned available = file->GetSize() - file->GetPosition();
+    const unsigned size = Min(size_, available);
+    data_.resize(size);
+    const bool success = file->Read(data_.data(), size) == size;
+    // Release the file from the thread that used it
+    file_.Reset();
+    Complete(success);
+}
+
+void AsyncFileRead::Complete(bool success)
+{
+    {
+        std::lock_guard<std::mutex> lock(waitMutex_);
+        success_ = success;
+        completed_.store(true, std::memory_order_release);
+    }
+    waitCondition_.notify_all();
+}
+
+AsyncFileReader::AsyncFileReader(Context* context) :
+    context_(context),
+    numThreads_(DEFAULT_ASYNC_IO_THREADS)
+{
+}
+
+AsyncFileReader::~AsyncFileReader()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        shutdown_ = true;
+    }
+    queueCondition_.notify_all();
+    threads_.clear();
+}
+
+void AsyncFileReader::SetNumThreads(unsigned numThreads)
+{
+    numThreads_ = Max(numThreads, 1u);
+}
+
+void AsyncFileReader::Queue(AsyncFileRead* request)
+{
+    if (!request)
+        return;
+
+#ifdef URHO3D_THREADING
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        queue_.push_back(SharedPtr<AsyncFileRead>(request));
+    }
+    queueCondition_.notify_one();
+
+    while (threads_.size() < numThreads_)
+    {
+        threads_.push_back(ea::make_unique<AsyncFileReaderThread>(this));
+        threads_.back()->Run();
+    }
+#else
+    request->Execute(context_, nullptr);
+#endif
+}
+
+unsigned AsyncFileReader::GetNumQueuedRequests() const
+{
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    return queue_.size();
+}
+
+bool AsyncFileReader::ProcessBatch()
+{
+    ea::vector<SharedPtr<AsyncFileRead> > batch;
+    {
+        std::unique_lock<std::mutex> lock(queueMutex_);
+        queueCondition_.wait(lock, [this] { return shutdown_ || !queue_.empty(); });
+        if (queue_.empty())
+            return false;
+
+        // Take the oldest requests first
+        const unsigned count = Min(queue_.size(), MAX_ASYNC_READ_BATCH);
+        batch.assign(queue_.begin(), queue_.begin() + count);
+        queue_.erase(queue_.begin(), queue_.begin() + count);
+    }
+
+    URHO3D_PROFILE("AsyncFileRead");
+
+    // Serve reads of the same file in offset order, so that it is opened once and read mostly sequentially
+    ea::stable_sort(batch.begin(), batch.end(), [](const SharedPtr<AsyncFileRead>& lhs, const SharedPtr<AsyncFileRead>& rhs)
+    {
+        // Requests with their own open file go first, in queue order
+        if (!lhs->file_ != !rhs->file_)
+            return lhs->file_ != nullptr;
+        if (lhs->file_)
+            return false;
+        return lhs->fileName_ != rhs->fileName_ ? lhs->fileName_ < rhs->fileName_ : lhs->offset_ < rhs->offset_;
+    });
+
+    SharedPtr<File> openFile;
+    for (AsyncFileRead* request : batch)
+    {
+        if (request->file_)
+        {
+            request->Execute(context_, nullptr);
+            continue;
+        }
+
+        if (!openFile || openFile->GetName() != request->fileName_)
+        {
+            openFile = MakeShared<File>(context_);
+            if (!openFile->Open(request->fileName_))
+            {
+                openFile.Reset();
+                request->Complete(false);
+                continue;
+            }
+        }
+        request->Execute(context_, openFile);
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,143 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include <EASTL/unique_ptr.h>
+#include <EASTL/vector.h>
+
+#include "../Container/ByteVector.h"
+#include "../Container/Ptr.h"
+#include "../Container/RefCounted.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+namespace Urho3D
+{
+
+class AsyncFileReaderThread;
+class Context;
+class File;
+
+/// Default number of asynchronous I/O threads.
+static const unsigned DEFAULT_ASYNC_IO_THREADS = 2;
+
+/// Asynchronous file read request. Created by FileSystem::ReadFileAsync() and completed by the I/O threads.
+class URHO3D_API AsyncFileRead : public RefCounted
+{
+    friend class AsyncFileReader;
+    friend class FileSystem;
+
+public:
+    /// Construct a request to read a range of a file. Size M_MAX_UNSIGNED reads to the end.
+    AsyncFileRead(const ea::string& fileName, unsigned offset, unsigned size);
+    /// Construct a request to read the remaining contents of an open file. The file must not be used elsewhere until completion.
+    explicit AsyncFileRead(File* file);
+    /// Destruct.
+    ~AsyncFileRead() override;
+
+    /// Return whether the read has finished, successfully or not.
+    bool IsCompleted() const { return completed_.load(std::memory_order_acquire); }
+    /// Block until the read has finished. Return true if it was successful.
+    bool Wait();
+    /// Return whether the read was successful. Valid after completion.
+    bool IsSuccess() const { return IsCompleted() && success_; }
+    /// Return the data read. Valid after completion.
+    const ByteVector& GetData() const { return data_; }
+    /// Move the data read out of the request. Valid after completion.
+    ByteVector TakeData() { return ea::move(data_); }
+    /// Return the file name.
+    const ea::string& GetFileName() const { return fileName_; }
+    /// Return the offset the read starts from.
+    unsigned GetOffset() const { return offset_; }
+
+private:
+    /// Perform the read on the calling thread. An already open file of the same name may be passed in to avoid reopening it.
+    void Execute(Context* context, File* openFile);
+    /// Mark as completed and wake up waiting threads.
+    void Complete(bool success);
+
+    /// File name.
+    ea::string fileName_;
+    /// Open file to read from instead of opening by name.
+    SharedPtr<File> file_;
+    /// Start offset.
+    unsigned offset_;
+    /// Requested size.
+    unsigned size_;
+    /// Data read.
+    ByteVector data_;
+    /// Success flag.
+    bool success_{};
+    /// Completion flag.
+    std::atomic<bool> completed_{};
+    /// Mutex for waiting on completion.
+    std::mutex waitMutex_;
+    /// Completion condition.
+    std::condition_variable waitCondition_;
+};
+
+/// Pool of I/O threads serving asynchronous file reads in batches. Owned by FileSystem.
+/// @nobind
+class URHO3D_API AsyncFileReader
+{
+    friend class AsyncFileReaderThread;
+
+public:
+    /// Construct.
+    explicit AsyncFileReader(Context* context);
+    /// Destruct. Finish the queued requests and stop the threads.
+    ~AsyncFileReader();
+
+    /// Set number of I/O threads. Threads are started on the first request.
+    void SetNumThreads(unsigned numThreads);
+    /// Queue a request.
+    void Queue(AsyncFileRead* request);
+
+    /// Return number of I/O threads.
+    unsigned GetNumThreads() const { return numThreads_; }
+    /// Return number of requests waiting to be served.
+    unsigned GetNumQueuedRequests() const;
+
+private:
+    /// Take a batch of requests and serve them, reading requests to the same file through one opened file. Return false when shutting down.
+    bool ProcessBatch();
+
+    /// Execution context.
+    Context* context_;
+    /// I/O threads.
+    ea::vector<ea::unique_ptr<AsyncFileReaderThread> > threads_;
+    /// Number of I/O threads to use.
+    unsigned numThreads_;
+    /// Queued requests.
+    ea::vector<SharedPtr<AsyncFileRead> > queue_;
+    /// Mutex for the queue.
+    mutable std::mutex queueMutex_;
+    /// Condition signaled when requests are queued or on shutdown.
+    std::condition_variable queueCondition_;
+    /// Shutdown flag.
+    bool shutdown_{};
+};
+
+}
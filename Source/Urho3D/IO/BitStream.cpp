@@ -0,0 +1,156 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../IO/BitStream.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Largest magnitude of the three smaller components of a unit quaternion.
+const float SMALLEST_THREE_RANGE = 0.70710678f;
+
+unsigned QuantizeFloat(float value, float minValue, float maxValue, unsigned numBits)
+{
+    const unsigned maxQuantized = numBits >= 32 ? M_MAX_UNSIGNED : (1u << numBits) - 1;
+    const float normalized = Clamp((value - minValue) / (maxValue - minValue), 0.0f, 1.0f);
+    return static_cast<unsigned>(Round(normalized * static_cast<float>(maxQuantized)));
+}
+
+float DequantizeFloat(unsigned value, float minValue, float maxValue, unsigned numBits)
+{
+    const unsigned maxQuantized = numBits >= 32 ? M_MAX_UNSIGNED : (1u << numBits) - 1;
+    return minValue + (maxValue - minValue) * static_cast<float>(value) / static_cast<float>(maxQuantized);
+}
+
+}
+
+void BitStreamWriter::WriteBits(unsigned value, unsigned numBits)
+{
+    while (numBits > 0)
+    {
+        if (bitOffset_ == 0)
+            dest_.push_back(0);
+
+        const unsigned bitsToWrite = Min(numBits, 8 - bitOffset_);
+        const unsigned mask = (1u << bitsToWrite) - 1;
+        dest_.back() |= static_cast<unsigned char>((value & mask) << bitOffset_);
+
+        value >>= bitsToWrite;
+        numBits -= bitsToWrite;
+        bitOffset_ = (bitOffset_ + bitsToWrite) & 7u;
+    }
+}
+
+void BitStreamWriter::WriteQuantizedFloat(float value, float minValue, float maxValue, unsigned numBits)
+{
+    WriteBits(QuantizeFloat(value, minValue, maxValue, numBits), numBits);
+}
+
+void BitStreamWriter::WriteQuantizedVector3(const Vector3& value, float minValue, float maxValue, unsigned numBits)
+{
+    WriteQuantizedFloat(value.x_, minValue, maxValue, numBits);
+    WriteQuantizedFloat(value.y_, minValue, maxValue, numBits);
+    WriteQuantizedFloat(value.z_, minValue, maxValue, numBits);
+}
+
+void BitStreamWriter::WriteQuaternion(const Quaternion& value, unsigned bitsPerComponent)
+{
+    const Quaternion norm = value.Normalized();
+    const float components[4] = { norm.w_, norm.x_, norm.y_, norm.z_ };
+
+    unsigned largest = 0;
+    for (unsigned i = 1; i < 4; ++i)
+    {
+        if (Abs(components[i]) > Abs(components[largest]))
+            largest = i;
+    }
+
+    // q and -q are the same rotation, so flip the sign to make the omitted component positive
+    const float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+    WriteBits(largest, 2);
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        if (i != largest)
+            WriteQuantizedFloat(components[i] * sign, -SMALLEST_THREE_RANGE, SMALLEST_THREE_RANGE, bitsPerComponent);
+    }
+}
+
+unsigned BitStreamReader::ReadBits(unsigned numBits)
+{
+    unsigned value = 0;
+    unsigned shift = 0;
+    while (numBits > 0 && position_ < size_ * 8)
+    {
+        const unsigned bitOffset = position_ & 7u;
+        const unsigned bitsToRead = Min(numBits, 8 - bitOffset);
+        const unsigned mask = (1u << bitsToRead) - 1;
+        value |= ((data_[position_ >> 3u] >> bitOffset) & mask) << shift;
+
+        shift += bitsToRead;
+        numBits -= bitsToRead;
+        position_ += bitsToRead;
+    }
+    return value;
+}
+
+float BitStreamReader::ReadQuantizedFloat(float minValue, float maxValue, unsigned numBits)
+{
+    return DequantizeFloat(ReadBits(numBits), minValue, maxValue, numBits);
+}
+
+Vector3 BitStreamReader::ReadQuantizedVector3(float minValue, float maxValue, unsigned numBits)
+{
+    Vector3 value;
+    value.x_ = ReadQuantizedFloat(minValue, maxValue, numBits);
+    value.y_ = ReadQuantizedFloat(minValue, maxValue, numBits);
+    value.z_ = ReadQuantizedFloat(minValue, maxValue, numBits);
+    return value;
+}
+
+Quaternion BitStreamReader::ReadQuaternion(unsigned bitsPerComponent)
+{
+    const unsigned largest = ReadBits(2);
+
+    float components[4];
+    float sumSquares = 0.0f;
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        if (i != largest)
+        {
+            components[i] = ReadQuantizedFloat(-SMALLEST_THREE_RANGE, SMALLEST_THREE_RANGE, bitsPerComponent);
+            sumSquares += components[i] * components[i];
+        }
+    }
+    components[largest] = sqrtf(Max(1.0f - sumSquares, 0.0f));
+
+    return Quaternion(components[0], components[1], components[2], components[3]).Normalized();
+}
+
+}
@@ -0,0 +1,96 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Container/ByteVector.h"
+#include "../Math/Quaternion.h"
+#include "../Math/Vector3.h"
+
+namespace Urho3D
+{
+
+/// Writer of tightly bit-packed, quantized values into a byte vector.
+/// @nobind
+class URHO3D_API BitStreamWriter
+{
+public:
+    /// Construct and append to the vector, which must not go out of scope before the writer.
+    explicit BitStreamWriter(ByteVector& dest) : dest_(dest), startSize_(dest.size()) { }
+
+    /// Write the lowest bits of a value. Up to 32 bits.
+    void WriteBits(unsigned value, unsigned numBits);
+    /// Write a bool as a single bit.
+    void WriteBool(bool value) { WriteBits(value ? 1u : 0u, 1); }
+    /// Write a float quantized to the given range with given number of bits. Values are clamped to the range.
+    void WriteQuantizedFloat(float value, float minValue, float maxValue, unsigned numBits);
+    /// Write a vector quantized per component to the given range.
+    void WriteQuantizedVector3(const Vector3& value, float minValue, float maxValue, unsigned numBits);
+    /// Write a rotation with smallest-three encoding: index of the largest component and the other three quantized.
+    void WriteQuaternion(const Quaternion& value, unsigned bitsPerComponent);
+
+    /// Return number of bits written.
+    unsigned GetNumBits() const { return (dest_.size() - startSize_) * 8 - (bitOffset_ ? 8 - bitOffset_ : 0); }
+
+private:
+    /// Destination.
+    ByteVector& dest_;
+    /// Size of the destination when the writer was created.
+    unsigned startSize_;
+    /// Number of bits used in the last byte, zero if the last byte is full.
+    unsigned bitOffset_{};
+};
+
+/// Reader of values written by BitStreamWriter.
+/// @nobind
+class URHO3D_API BitStreamReader
+{
+public:
+    /// Construct with a pointer and size.
+    BitStreamReader(const void* data, unsigned size) : data_(static_cast<const unsigned char*>(data)), size_(size) { }
+    /// Construct from a vector, which must not go out of scope before the reader.
+    explicit BitStreamReader(const ByteVector& data) : BitStreamReader(data.data(), data.size()) { }
+
+    /// Read bits. Return zero bits past the end.
+    unsigned ReadBits(unsigned numBits);
+    /// Read a single bit as bool.
+    bool ReadBool() { return ReadBits(1) != 0; }
+    /// Read a quantized float.
+    float ReadQuantizedFloat(float minValue, float maxValue, unsigned numBits);
+    /// Read a quantized vector.
+    Vector3 ReadQuantizedVector3(float minValue, float maxValue, unsigned numBits);
+    /// Read a smallest-three encoded rotation.
+    Quaternion ReadQuaternion(unsigned bitsPerComponent);
+
+    /// Return whether all data has been read.
+    bool IsEof() const { return position_ >= size_ * 8; }
+
+private:
+    /// Source data.
+    const unsigned char* data_;
+    /// Source size in bytes.
+    unsigned size_;
+    /// Read position in bits.
+    unsigned position_{};
+};
+
+}
@@ -444,15 +444,19 @@ StringVector Deserializer::ReadStringVector()
 VariantMap Deserializer::ReadVariantMap()
 {
     VariantMap ret;
+    ReadVariantMap(ret);
+    return ret;
+}
+
+void Deserializer::ReadVariantMap(VariantMap& dest)
+{
     unsigned num = ReadVLE();
 
     for (unsigned i = 0; i < num; ++i)
     {
         StringHash key = ReadStringHash();
-        ret[key] = ReadVariant();
+        dest[key] = ReadVariant();
     }
-
-    return ret;
 }
 
 unsigned Deserializer::ReadVLE()
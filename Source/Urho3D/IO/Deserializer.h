@@ -56,6 +56,9 @@ public:
     /// Return whether the end of stream has been reached.
     /// @property
     virtual bool IsEof() const { return position_ >= size_; }
+    /// Return the whole data if it resides in memory, so that it can be parsed without copying, otherwise null. Does not change the position.
+    /// @nobind
+    virtual const unsigned char* GetMemoryData() const { return nullptr; }
 
     /// Set position relative to current position. Return actual new position.
     unsigned SeekRelative(int delta);
@@ -143,6 +146,8 @@ public:
     StringVector ReadStringVector();
     /// Read a variant map.
     VariantMap ReadVariantMap();
+    /// Read a variant map into an existing map, adding to or replacing its elements.
+    void ReadVariantMap(VariantMap& dest);
     /// Read a variable-length encoded unsigned integer, which can use 29 bits maximum.
     unsigned ReadVLE();
     /// Read a 24-bit network object ID.
@@ -31,9 +31,16 @@
 
 #ifdef __ANDROID__
 #include <SDL/SDL_rwops.h>
+#include <SDL/SDL_system.h>
+#include <android/asset_manager_jni.h>
 #endif
 
 #include <cstdio>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 #include <LZ4/lz4.h>
 
 #include "../DebugNew.h"
@@ -64,6 +71,68 @@ static const unsigned READ_BUFFER_SIZE = 32768;
 #endif
 static const unsigned SKIP_BUFFER_SIZE = 1024;
 
+#ifdef __ANDROID__
+static AAssetManager* GetAndroidAssetManager()
+{
+    static AAssetManager* assetManager = []() -> AAssetManager*
+    {
+        auto* env = (JNIEnv*)SDL_AndroidGetJNIEnv();
+        auto activity = (jobject)SDL_AndroidGetActivity();
+        if (!env || !activity)
+            return nullptr;
+
+        jclass cls = env->GetObjectClass(activity);
+        jmethodID getAssets = env->GetMethodID(cls, "getAssets", "()Landroid/content/res/AssetManager;");
+        jobject assets = env->CallObjectMethod(activity, getAssets);
+        // Keep a global reference so that the native asset manager stays valid
+        jobject globalAssets = env->NewGlobalRef(assets);
+
+        env->DeleteLocalRef(assets);
+        env->DeleteLocalRef(cls);
+        env->DeleteLocalRef(activity);
+        return AAssetManager_fromJava(env, globalAssets);
+    }();
+    return assetManager;
+}
+
+const unsigned char* MapAndroidAsset(const ea::string& fileName, unsigned& size, void*& mapping, unsigned& mappingSize)
+{
+    AAssetManager* assetManager = GetAndroidAssetManager();
+    if (!assetManager)
+        return nullptr;
+
+    AAsset* asset = AAssetManager_open(assetManager, URHO3D_ASSET(fileName), AASSET_MODE_RANDOM);
+    if (!asset)
+        return nullptr;
+
+    // A file descriptor is only available for assets stored uncompressed in the APK
+    off64_t start = 0;
+    off64_t length = 0;
+    const int fd = AAsset_openFileDescriptor64(asset, &start, &length);
+    AAsset_close(asset);
+    if (fd < 0 || length <= 0 || length > M_MAX_UNSIGNED)
+    {
+        if (fd >= 0)
+            close(fd);
+        return nullptr;
+    }
+
+    const off64_t pageSize = sysconf(_SC_PAGESIZE);
+    const off64_t alignedStart = start - start % pageSize;
+    const unsigned alignment = (unsigned)(start - alignedStart);
+    void* data = mmap64(nullptr, (size_t)length + alignment, PROT_READ, MAP_PRIVATE, fd, alignedStart);
+    // The mapping keeps the APK open
+    close(fd);
+    if (data == MAP_FAILED)
+        return nullptr;
+
+    size = (unsigned)length;
+    mapping = data;
+    mappingSize = (unsigned)length + alignment;
+    return static_cast<const unsigned char*>(data) + alignment;
+}
+#endif
+
 File::File(Context* context) :
     Object(context),
     mode_(FILE_READ),
@@ -136,18 +205,34 @@ bool File::Open(PackageFile* package, const ea::string& fileName)
     if (!entry)
         return false;
 
-    bool success = OpenInternal(package->GetName(), FILE_READ, true);
-    if (!success)
+    if (package->IsMemoryMapped())
     {
-        URHO3D_LOGERROR("Could not open package file " + fileName);
-        return false;
+        // No file handle is needed: reads are served from the mapping, which the package keeps alive
+        Close();
+        mappedPackage_ = package;
+        mappedData_ = package->GetMappedData();
+        mappedSize_ = package->GetTotalSize();
+        absoluteFileName_ = package->GetName();
+        mode_ = FILE_READ;
+        position_ = 0;
+        readSyncNeeded_ = false;
+        writeSyncNeeded_ = false;
+    }
+    else
+    {
+        bool success = OpenInternal(package->GetName(), FILE_READ, true);
+        if (!success)
+        {
+            URHO3D_LOGERROR("Could not open package file " + fileName);
+            return false;
+        }
     }
 
     name_ = fileName;
     offset_ = entry->offset_;
     checksum_ = entry->checksum_;
     size_ = entry->size_;
-    compressed_ = package->IsCompressed();
+    compressed_ = entry->codec_ != PACKAGE_CODEC_NONE;
 
     // Seek to beginning of package entry's file data
     SeekInternal(offset_);
@@ -227,12 +312,20 @@ unsigned File::Read(void* dest, unsigned size)
                 if (!readBuffer_)
                 {
                     readBuffer_ = new unsigned char[unpackedSize];
-                    inputBuffer_ = new unsigned char[LZ4_compressBound(unpackedSize)];
+                    if (!mappedData_)
+                        inputBuffer_ = new unsigned char[LZ4_compressBound(unpackedSize)];
                 }
 
                 /// \todo Handle errors
-                ReadInternal(inputBuffer_.get(), packedSize);
-                LZ4_decompress_fast((const char*)inputBuffer_.get(), (char*)readBuffer_.get(), unpackedSize);
+                const unsigned char* packedData = mappedData_ + mappedPosition_;
+                if (mappedData_)
+                    mappedPosition_ += packedSize;
+                else
+                {
+                    ReadInternal(inputBuffer_.get(), packedSize);
+                    packedData = inputBuffer_.get();
+                }
+                LZ4_decompress_fast((const char*)packedData, (char*)readBuffer_.get(), unpackedSize);
 
                 readBufferSize_ = unpackedSize;
                 readBufferOffset_ = 0;
@@ -356,7 +449,7 @@ unsigned File::GetChecksum()
     if (offset_ || checksum_)
         return checksum_;
 #ifdef __ANDROID__
-    if ((!handle_ && !assetHandle_) || mode_ == FILE_WRITE)
+    if ((!handle_ && !assetHandle_ && !mappedData_) || mode_ == FILE_WRITE)
 #else
     if (!handle_ || mode_ == FILE_WRITE)
 #endif
@@ -388,15 +481,26 @@ void File::Close()
         SDL_RWclose(assetHandle_);
         assetHandle_ = 0;
     }
+    if (assetMapping_)
+    {
+        munmap(assetMapping_, assetMappingSize_);
+        assetMapping_ = nullptr;
+        assetMappingSize_ = 0;
+    }
 #endif
 
     readBuffer_.reset();
     inputBuffer_.reset();
 
-    if (handle_)
+    if (handle_ || mappedData_)
     {
-        fclose((FILE*)handle_);
+        if (handle_)
+            fclose((FILE*)handle_);
         handle_ = nullptr;
+        mappedPackage_.Reset();
+        mappedData_ = nullptr;
+        mappedPosition_ = 0;
+        mappedSize_ = 0;
         position_ = 0;
         size_ = 0;
         offset_ = 0;
@@ -410,12 +514,34 @@ void File::Flush()
         fflush((FILE*)handle_);
 }
 
+void File::Prefetch()
+{
+    if (mode_ != FILE_READ || !size_)
+        return;
+
+#ifndef _WIN32
+    if (mappedData_)
+    {
+        // Compressed entries are smaller than their size, so clamp to the mapping
+        const unsigned size = Min(size_, mappedSize_ - offset_);
+        const uintptr_t pageSize = sysconf(_SC_PAGESIZE);
+        const auto start = reinterpret_cast<uintptr_t>(mappedData_ + offset_);
+        const uintptr_t alignedStart = start - start % pageSize;
+        madvise(reinterpret_cast<void*>(alignedStart), size + (start - alignedStart), MADV_WILLNEED);
+    }
+#if defined(__linux__) || defined(__ANDROID__)
+    else if (handle_)
+        posix_fadvise(fileno((FILE*)handle_), offset_, size_, POSIX_FADV_WILLNEED);
+#endif
+#endif
+}
+
 bool File::IsOpen() const
 {
 #ifdef __ANDROID__
-    return handle_ != 0 || assetHandle_ != 0;
+    return handle_ != 0 || assetHandle_ != 0 || mappedData_;
 #else
-    return handle_ != nullptr;
+    return handle_ != nullptr || mappedData_;
 #endif
 }
 
@@ -449,6 +575,25 @@ bool File::OpenInternal(const ea::string& fileName, FileMode mode, bool fromPack
             return false;
         }
 
+        // Map assets stored uncompressed in the APK, so that they are read without copies through SDL
+        if (!fromPackage)
+        {
+            unsigned size = 0;
+            if (const unsigned char* data = MapAndroidAsset(fileName, size, assetMapping_, assetMappingSize_))
+            {
+                mappedData_ = data;
+                mappedSize_ = size;
+                name_ = fileName;
+                absoluteFileName_ = fileName;
+                mode_ = mode;
+                position_ = 0;
+                size_ = size;
+                offset_ = 0;
+                checksum_ = 0;
+                return true;
+            }
+        }
+
         assetHandle_ = SDL_RWFromFile(URHO3D_ASSET(fileName), "rb");
         if (!assetHandle_)
         {
@@ -521,6 +666,15 @@ bool File::OpenInternal(const ea::string& fileName, FileMode mode, bool fromPack
 
 bool File::ReadInternal(void* dest, unsigned size)
 {
+    if (mappedData_)
+    {
+        if (mappedPosition_ + size > mappedSize_)
+            return false;
+        memcpy(dest, mappedData_ + mappedPosition_, size);
+        mappedPosition_ += size;
+        return true;
+    }
+
 #ifdef __ANDROID__
     if (assetHandle_)
     {
@@ -533,6 +687,12 @@ bool File::ReadInternal(void* dest, unsigned size)
 
 void File::SeekInternal(unsigned newPosition)
 {
+    if (mappedData_)
+    {
+        mappedPosition_ = newPosition;
+        return;
+    }
+
 #ifdef __ANDROID__
     if (assetHandle_)
     {
@@ -50,6 +50,11 @@ static const char* APK = "/apk/";
 static const char* APK = "";
 #endif
 
+#ifdef __ANDROID__
+/// Memory map an Android APK asset read-only without copying. Return the start of the asset contents and output its size and the page aligned mapping to release with munmap(), or return null if the asset is compressed within the APK or cannot be opened.
+URHO3D_API const unsigned char* MapAndroidAsset(const ea::string& fileName, unsigned& size, void*& mapping, unsigned& mappingSize);
+#endif
+
 /// File open mode.
 enum FileMode
 {
@@ -87,6 +92,8 @@ public:
 
     /// Return a checksum of the file contents using the SDBM hash algorithm.
     unsigned GetChecksum() override;
+    /// Return the file contents in memory when opened from an uncompressed memory mapped package or Android asset, otherwise null.
+    const unsigned char* GetMemoryData() const override { return mappedData_ && !compressed_ ? mappedData_ + offset_ : nullptr; }
 
     /// Open a filesystem file. Return true if successful.
     bool Open(const ea::string& fileName, FileMode mode = FILE_READ);
@@ -96,6 +103,8 @@ public:
     void Close();
     /// Flush any buffered output to the file.
     void Flush();
+    /// Hint the operating system to read the file contents into memory ahead of use, without blocking. No-op where unsupported.
+    void Prefetch();
 
     /// Return the open mode.
     /// @property
@@ -112,6 +121,9 @@ public:
     /// @property
     bool IsPackaged() const { return offset_ != 0; }
 
+    /// Return whether the file is read from a memory mapped package or Android asset.
+    bool IsMemoryMapped() const { return mappedData_ != nullptr; }
+
     /// Reads a binary file to buffer.
     void ReadBinary(ea::vector<unsigned char>& buffer);
 
@@ -145,6 +157,20 @@ private:
 #ifdef __ANDROID__
     /// SDL RWops context for Android asset loading.
     SDL_RWops* assetHandle_;
+#endif
+    /// Memory mapped package the file is read from.
+    SharedPtr<PackageFile> mappedPackage_;
+    /// Start of the memory mapped package contents.
+    const unsigned char* mappedData_{};
+    /// Read position within the memory mapped package.
+    unsigned mappedPosition_{};
+    /// Size of the memory mapped contents.
+    unsigned mappedSize_{};
+#ifdef __ANDROID__
+    /// Page aligned mapping of an Android asset owned by the file.
+    void* assetMapping_{};
+    /// Size of the Android asset mapping.
+    unsigned assetMappingSize_{};
 #endif
     /// Read buffer for Android asset or compressed file loading.
     ea::shared_array<unsigned char> readBuffer_;
@@ -402,6 +402,9 @@ FileSystem::FileSystem(Context* context) :
 
 FileSystem::~FileSystem()
 {
+    // Finish pending asynchronous reads first
+    asyncFileReader_.reset();
+
     // If any async exec items pending, delete them
     if (asyncExecQueue_.size())
     {
@@ -412,6 +415,49 @@ FileSystem::~FileSystem()
     }
 }
 
+SharedPtr<AsyncFileRead> FileSystem::ReadFileAsync(const ea::string& fileName, unsigned offset, unsigned size)
+{
+    auto request = MakeShared<AsyncFileRead>(fileName, offset, size);
+    if (!CheckAccess(GetPath(fileName)))
+    {
+        URHO3D_LOGERRORF("Access denied to %s", fileName.c_str());
+        request->Complete(false);
+        return request;
+    }
+
+    if (!asyncFileReader_)
+        asyncFileReader_ = ea::make_unique<AsyncFileReader>(context_);
+    asyncFileReader_->Queue(request);
+    return request;
+}
+
+SharedPtr<AsyncFileRead> FileSystem::ReadFileAsync(File* file)
+{
+    auto request = MakeShared<AsyncFileRead>(file);
+    if (!file || !file->IsOpen())
+    {
+        request->Complete(false);
+        return request;
+    }
+
+    if (!asyncFileReader_)
+        asyncFileReader_ = ea::make_unique<AsyncFileReader>(context_);
+    asyncFileReader_->Queue(request);
+    return request;
+}
+
+void FileSystem::SetNumAsyncIOThreads(unsigned numThreads)
+{
+    if (!asyncFileReader_)
+        asyncFileReader_ = ea::make_unique<AsyncFileReader>(context_);
+    asyncFileReader_->SetNumThreads(numThreads);
+}
+
+unsigned FileSystem::GetNumAsyncIOThreads() const
+{
+    return asyncFileReader_ ? asyncFileReader_->GetNumThreads() : DEFAULT_ASYNC_IO_THREADS;
+}
+
 bool FileSystem::SetCurrentDir(const ea::string& pathName)
 {
     if (!CheckAccess(pathName))
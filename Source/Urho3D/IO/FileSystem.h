@@ -26,6 +26,7 @@
 #include <EASTL/hash_set.h>
 
 #include "../Core/Object.h"
+#include "../IO/AsyncFileReader.h"
 
 namespace Urho3D
 {
@@ -133,6 +134,17 @@ public:
     /// @property
     ea::string GetTemporaryDir() const;
 
+    /// Read a file, or a range of it, on the asynchronous I/O threads. Size M_MAX_UNSIGNED reads to the end. Wait on the returned request or poll it for completion.
+    SharedPtr<AsyncFileRead> ReadFileAsync(const ea::string& fileName, unsigned offset = 0, unsigned size = M_MAX_UNSIGNED);
+    /// Read the remaining contents of an open file, such as a package entry, on the asynchronous I/O threads. The file must not be used until the request completes.
+    SharedPtr<AsyncFileRead> ReadFileAsync(File* file);
+    /// Set number of asynchronous I/O threads.
+    /// @property
+    void SetNumAsyncIOThreads(unsigned numThreads);
+    /// Return number of asynchronous I/O threads.
+    /// @property
+    unsigned GetNumAsyncIOThreads() const;
+
 private:
     /// Scan directory, called internally.
     void ScanDirInternal
@@ -150,6 +162,8 @@ private:
     unsigned nextAsyncExecID_{1};
     /// Flag for executing engine console commands as OS-specific system command. Default to true.
     bool executeConsoleCommands_{};
+    /// Asynchronous file reader, created on first use.
+    ea::unique_ptr<AsyncFileReader> asyncFileReader_;
 };
 
 /// Split a full path to path, filename and extension. The extension will be converted to lowercase by default.
@@ -34,6 +34,7 @@
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/dist_sink.h>
 #include <spdlog/sinks/base_sink.h>
+#include <spdlog/details/log_msg_buffer.h>
 #if DESKTOP
 #include <spdlog/sinks/stdout_color_sinks.h>
 #else
@@ -41,7 +42,9 @@
 #endif
 #include <spdlog/details/null_mutex.h>
 
+#include <condition_variable>
 #include <mutex>
+#include <thread>
 #include <cstdio>
 
 #ifdef __ANDROID__
@@ -146,11 +149,101 @@ protected:
 using MessageForwarderSink_mt = MessageForwarderSink<std::mutex>;
 using MessageForwarderSink_st = MessageForwarderSink<spdlog::details::null_mutex>;
 
+/// Sink that hands messages over to a background thread, which writes them to the wrapped sink.
+/// Logging threads only copy the message into a lock-free queue. If the queue is full the message is written
+/// synchronously instead of being dropped.
+class AsyncSink : public spdlog::sinks::sink
+{
+public:
+    explicit AsyncSink(std::shared_ptr<spdlog::sinks::sink> target)
+        : target_(ea::move(target))
+        , queue_(4096)
+        , thread_([this] { Run(); })
+    {
+    }
+
+    ~AsyncSink() override
+    {
+        shouldStop_.store(true, std::memory_order_relaxed);
+        wakeUp_.notify_one();
+        thread_.join();
+    }
+
+    void log(const spdlog::details::log_msg& msg) override
+    {
+        spdlog::details::log_msg_buffer buffer(msg);
+        if (!queue_.Push(ea::move(buffer)))
+        {
+            target_->log(msg);
+            return;
+        }
+        wakeUp_.notify_one();
+    }
+
+    void flush() override { flushRequested_.store(true, std::memory_order_relaxed); wakeUp_.notify_one(); }
+    void set_pattern(const eastl::string& pattern) override { target_->set_pattern(pattern); }
+    void set_formatter(std::unique_ptr<spdlog::formatter> formatter) override { target_->set_formatter(std::move(formatter)); }
+
+private:
+    void Run()
+    {
+        spdlog::details::log_msg_buffer buffer;
+        for (;;)
+        {
+            bool wroteAny = false;
+            while (queue_.Pop(buffer))
+            {
+                target_->log(buffer);
+                wroteAny = true;
+            }
+
+            if (flushRequested_.exchange(false, std::memory_order_relaxed))
+                target_->flush();
+
+            // Messages pushed after the stop request are still drained above before exiting
+            if (shouldStop_.load(std::memory_order_relaxed) && !wroteAny)
+                break;
+
+            if (!wroteAny)
+            {
+                // Producers notify without locking, so a wakeup may be missed. The timeout bounds the latency in this case
+                std::unique_lock<std::mutex> lock(wakeUpMutex_);
+                wakeUp_.wait_for(lock, std::chrono::milliseconds(5));
+            }
+        }
+        target_->flush();
+    }
+
+    /// Sink that does actual writing.
+    std::shared_ptr<spdlog::sinks::sink> target_;
+    /// Messages waiting to be written.
+    MPMCQueue<spdlog::details::log_msg_buffer> queue_;
+    /// Whether the writer thread should exit.
+    std::atomic<bool> shouldStop_{};
+    /// Whether the wrapped sink should be flushed.
+    std::atomic<bool> flushRequested_{};
+    /// Mutex for the wakeup condition.
+    std::mutex wakeUpMutex_;
+    /// Wakeup condition of the writer thread.
+    std::condition_variable wakeUp_;
+    /// Writer thread. Must be the last member so that everything else is constructed before it starts.
+    std::thread thread_;
+};
+
 Logger::Logger(void* logger)
     : logger_(logger)
 {
 }
 
+bool Logger::IsEnabled(LogLevel level) const
+{
+    if (logger_ == nullptr)
+        return false;
+
+    auto* logger = reinterpret_cast<spdlog::logger*>(logger_);
+    return logger->should_log(ConvertLogLevel(level));
+}
+
 void Logger::Write(LogLevel level, const ea::string& message) const
 {
     if (logger_ == nullptr)
@@ -189,6 +282,7 @@ public:
     explicit LogImpl(Context* context) : Object(context)
     {
         sinkProxy_ = std::make_shared<spdlog::sinks::dist_sink_mt>();
+        ioSinks_ = std::make_shared<spdlog::sinks::dist_sink_mt>();
 #if defined(__ANDROID__)
         platformSink_ = std::make_shared<spdlog::sinks::android_sink_mt>("Urho3D");
 #elif defined(IOS) || defined(TVOS)
@@ -202,10 +296,32 @@ public:
 #else   // Non-desktop platforms like WEB/UWP.
         platformSink_ = std::make_shared<spdlog::sinks::stdout_sink_mt>();
 #endif
-        sinkProxy_->add_sink(platformSink_);
+        ioSinks_->add_sink(platformSink_);
+        sinkProxy_->add_sink(ioSinks_);
         sinkProxy_->add_sink(std::make_shared<MessageForwarderSink_mt>());
     }
 
+    /// Switch between writing to the platform and file sinks directly or from the background thread.
+    void SetAsync(bool enable)
+    {
+        if (enable == (asyncSink_ != nullptr))
+            return;
+
+        if (enable)
+        {
+            asyncSink_ = std::make_shared<AsyncSink>(ioSinks_);
+            sinkProxy_->remove_sink(ioSinks_);
+            sinkProxy_->add_sink(asyncSink_);
+        }
+        else
+        {
+            sinkProxy_->remove_sink(asyncSink_);
+            sinkProxy_->add_sink(ioSinks_);
+            // Destroying the sink writes out all queued messages
+            asyncSink_ = nullptr;
+        }
+    }
+
 #ifdef __ANDROID__
     /// Android adb logcat sink
     std::shared_ptr<spdlog::sinks::android_sink_mt> platformSink_;
@@ -226,6 +342,10 @@ public:
 #endif  // defined(IOS) || defined(TVOS)
     /// Sink that forwards messages to all other sinks.
     std::shared_ptr<spdlog::sinks::dist_sink_mt> sinkProxy_;
+    /// Sinks that write to the platform output and the log file.
+    std::shared_ptr<spdlog::sinks::dist_sink_mt> ioSinks_;
+    /// Sink that writes to the platform output and the log file from the background thread. Null if async mode is disabled.
+    std::shared_ptr<AsyncSink> asyncSink_;
 };
 
 Log::Log(Context* context) :
@@ -257,7 +377,7 @@ void Log::Open(const ea::string& fileName)
 
     impl_->fileSink_ = std::make_shared<spdlog::sinks::basic_file_sink_mt>(fileName.c_str());
     impl_->fileSink_->set_pattern(formatPattern_.c_str());
-    impl_->sinkProxy_->add_sink(impl_->fileSink_);
+    impl_->ioSinks_->add_sink(impl_->fileSink_);
 #endif
 }
 
@@ -266,7 +386,7 @@ void Log::Close()
 #if defined(DESKTOP)
     if (impl_->fileSink_)
     {
-        impl_->sinkProxy_->remove_sink(impl_->fileSink_);
+        impl_->ioSinks_->remove_sink(impl_->fileSink_);
         impl_->fileSink_ = nullptr;
     }
 #endif
@@ -290,6 +410,14 @@ void Log::SetQuiet(bool quiet)
     impl_->platformSink_->set_level(ConvertLogLevel(quiet ? LOG_NONE : level_));
 }
 
+void Log::SetAsync(bool enable)
+{
+#if !__EMSCRIPTEN__
+    impl_->SetAsync(enable);
+    async_ = enable;
+#endif
+}
+
 void Log::SetLogFormat(const ea::string& format)
 {
     formatPattern_ = format;
@@ -351,8 +479,12 @@ void Log::SendMessageEvent(LogLevel level, time_t timestamp, const ea::string& l
     // If not in the main thread, store message for later processing
     if (!Thread::IsMainThread())
     {
-        MutexLock lock(logMutex_);
-        threadMessages_.push_back(StoredLogMessage(level, timestamp, logger, message));
+        StoredLogMessage stored(level, timestamp, logger, message);
+        if (!threadMessages_.Push(ea::move(stored)))
+        {
+            MutexLock lock(logMutex_);
+            overflowThreadMessages_.push_back(ea::move(stored));
+        }
         return;
     }
 
@@ -387,15 +519,20 @@ void Log::PumpThreadMessages()
         return;
     }
 
-    MutexLock lock(logMutex_);
+    // Process messages accumulated from other threads (if any). Don't process more than the queue holds,
+    // otherwise threads that keep logging could stall the main thread here
+    StoredLogMessage stored;
+    for (unsigned i = 0; i < threadMessages_.GetCapacity() && threadMessages_.Pop(stored); ++i)
+        SendMessageEvent(stored.level_, stored.timestamp_, stored.logger_, stored.message_);
 
-    // Process messages accumulated from other threads (if any)
-    while (!threadMessages_.empty())
+    // Overflow is rare, take the lock only to grab the messages so that logging threads are not blocked by event handlers
+    ea::list<StoredLogMessage> overflowMessages;
     {
-        const StoredLogMessage& stored = threadMessages_.front();
-        SendMessageEvent(stored.level_, stored.timestamp_, stored.logger_, stored.message_);
-        threadMessages_.pop_front();
+        MutexLock lock(logMutex_);
+        overflowMessages.swap(overflowThreadMessages_);
     }
+    for (const StoredLogMessage& overflowStored : overflowMessages)
+        SendMessageEvent(overflowStored.level_, overflowStored.timestamp_, overflowStored.logger_, overflowStored.message_);
 }
 
 }
@@ -24,6 +24,7 @@
 
 #include <EASTL/list.h>
 
+#include "../Container/ConcurrentQueue.h"
 #include "../Core/Macros.h"
 #include "../Core/Mutex.h"
 #include "../Core/Object.h"
@@ -123,7 +124,9 @@ public:
     template<typename... Args> void Info(const char* format, Args... args) const    { Write(LOG_INFO, format, args...); }
     template<typename... Args> void Warning(const char* format, Args... args) const { Write(LOG_WARNING, format, args...); }
     template<typename... Args> void Error(const char* format, Args... args) const   { Write(LOG_ERROR, format, args...); }
-    template<typename... Args> void Write(LogLevel level, const char* format, Args... args) const { Write(level, Format(format, args...)); }
+    template<typename... Args> void Write(LogLevel level, const char* format, Args... args) const { if (IsEnabled(level)) Write(level, Format(format, args...)); }
+    /// Format printf-style message and write it. Formatting is skipped if the level is filtered out.
+    template<typename... Args> void WriteF(LogLevel level, const char* format, Args... args) const { if (IsEnabled(level)) Write(level, ToString(format, args...)); }
 
     template<typename... Args> void Trace(const ea::string& message) const   { Write(LOG_TRACE, message.c_str()); }
     template<typename... Args> void Debug(const ea::string& message) const   { Write(LOG_DEBUG, message.c_str()); }
@@ -132,6 +135,8 @@ public:
     template<typename... Args> void Error(const ea::string& message) const   { Write(LOG_ERROR, message.c_str()); }
 
     void Write(LogLevel level, const ea::string& message) const;
+    /// Return whether messages of specified level pass the level filter.
+    bool IsEnabled(LogLevel level) const;
 
 protected:
     /// Instance of spdlog logger.
@@ -161,6 +166,10 @@ public:
     /// Set whether to timestamp log messages.
     /// @property
     void SetLogFormat(const ea::string& format);
+    /// Set whether log output is written from a background thread. Logging threads then only queue messages,
+    /// which avoids stalls on slow consoles and disks. Log message events are sent on the main thread in both modes.
+    /// @property
+    void SetAsync(bool enable);
     /// Set quiet mode ie. only print error entries to standard error stream (which is normally redirected to console also). Output to log file is not affected by this mode.
     /// @property
     void SetQuiet(bool quiet);
@@ -169,6 +178,10 @@ public:
     /// @property
     LogLevel GetLevel() const { return level_; }
 
+    /// Return whether log output is written from a background thread.
+    /// @property
+    bool IsAsync() const { return async_; }
+
     /// Return whether log is in quiet mode (only errors printed to standard error stream).
     /// @property
     bool IsQuiet() const { return quiet_; }
@@ -192,7 +205,9 @@ private:
     /// Mutex for threaded operation.
     Mutex logMutex_{};
     /// Log messages from other threads.
-    ea::list<StoredLogMessage> threadMessages_{};
+    MPMCQueue<StoredLogMessage> threadMessages_{1024};
+    /// Log messages from other threads that did not fit into the queue. Protected by logMutex_.
+    ea::list<StoredLogMessage> overflowThreadMessages_{};
     /// Logging level.
 #ifdef _DEBUG
     LogLevel level_ = LOG_DEBUG;
@@ -203,6 +218,8 @@ private:
     bool inWrite_ = false;
     /// Quiet mode flag.
     bool quiet_ = false;
+    /// Async mode flag.
+    bool async_ = false;
 };
 
 #ifdef URHO3D_LOGGING
@@ -211,11 +228,11 @@ private:
 #define URHO3D_LOGINFO(message, ...) Urho3D::Log::GetLogger().Info(message, ##__VA_ARGS__)
 #define URHO3D_LOGWARNING(message, ...) Urho3D::Log::GetLogger().Warning(message, ##__VA_ARGS__)
 #define URHO3D_LOGERROR(message, ...) Urho3D::Log::GetLogger().Error(message, ##__VA_ARGS__)
-#define URHO3D_LOGTRACEF(format, ...) Urho3D::Log::GetLogger().Write(Urho3D::LOG_TRACE, Urho3D::ToString(format, ##__VA_ARGS__))
-#define URHO3D_LOGDEBUGF(format, ...) Urho3D::Log::GetLogger().Write(Urho3D::LOG_DEBUG, Urho3D::ToString(format, ##__VA_ARGS__))
-#define URHO3D_LOGINFOF(format, ...) Urho3D::Log::GetLogger().Write(Urho3D::LOG_INFO, Urho3D::ToString(format, ##__VA_ARGS__))
-#define URHO3D_LOGWARNINGF(format, ...) Urho3D::Log::GetLogger().Write(Urho3D::LOG_WARNING, Urho3D::ToString(format, ##__VA_ARGS__))
-#define URHO3D_LOGERRORF(format, ...) Urho3D::Log::GetLogger().Write(Urho3D::LOG_ERROR, Urho3D::ToString(format, ##__VA_ARGS__))
+#define URHO3D_LOGTRACEF(format, ...) Urho3D::Log::GetLogger().WriteF(Urho3D::LOG_TRACE, format, ##__VA_ARGS__)
+#define URHO3D_LOGDEBUGF(format, ...) Urho3D::Log::GetLogger().WriteF(Urho3D::LOG_DEBUG, format, ##__VA_ARGS__)
+#define URHO3D_LOGINFOF(format, ...) Urho3D::Log::GetLogger().WriteF(Urho3D::LOG_INFO, format, ##__VA_ARGS__)
+#define URHO3D_LOGWARNINGF(format, ...) Urho3D::Log::GetLogger().WriteF(Urho3D::LOG_WARNING, format, ##__VA_ARGS__)
+#define URHO3D_LOGERRORF(format, ...) Urho3D::Log::GetLogger().WriteF(Urho3D::LOG_ERROR, format, ##__VA_ARGS__)
 #else
 #define URHO3D_LOGTRACE(...) ((void)0)
 #define URHO3D_LOGDEBUG(...) ((void)0)
@@ -51,6 +51,8 @@ public:
 
     /// Return memory area.
     unsigned char* GetData() { return buffer_; }
+    /// Return memory area for parsing in place.
+    const unsigned char* GetMemoryData() const override { return buffer_; }
 
     /// Return whether buffer is read-only.
     bool IsReadOnly() { return readOnly_; }
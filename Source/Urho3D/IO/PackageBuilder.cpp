@@ -0,0 +1,391 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include <EASTL/sort.h>
+
+#include "../IO/AbstractFile.h"
+#include "../IO/File.h"
+#include "../IO/Log.h"
+#include "../IO/PackageBuilder.h"
+
+#include <LZ4/lz4.h>
+#include <LZ4/lz4hc.h>
+
+#include <atomic>
+#ifdef URHO3D_THREADING
+#include <thread>
+#endif
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+/// Minimum share of the size that compression must save for a file to be stored compressed.
+static const float MIN_COMPRESSION_SAVING = 0.05f;
+
+/// Minimum number of blocks per thread for compressing a file on multiple threads.
+static const unsigned MIN_BLOCKS_PER_THREAD = 4;
+
+/// Return 64-bit FNV-1a hash of the data, used to detect identical files.
+static unsigned long long HashContent(const unsigned char* data, unsigned size)
+{
+    unsigned long long hash = 14695981039346656037ull;
+    for (unsigned i = 0; i < size; ++i)
+    {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/// Append a block header and the LZ4 compressed block to the destination. Return false if compression failed.
+static bool CompressBlock(const unsigned char* data, unsigned size, PackageCodec codec, ea::vector<unsigned char>& dest)
+{
+    unsigned char blockBuffer[LZ4_COMPRESSBOUND(PACKAGE_COMPRESSED_BLOCK_SIZE)];
+    const auto source = reinterpret_cast<const char*>(data);
+    const auto blockDest = reinterpret_cast<char*>(blockBuffer);
+    const int packedSize = codec == PACKAGE_CODEC_LZ4HC ?
+        LZ4_compress_HC(source, blockDest, size, sizeof blockBuffer, 0) :
+        LZ4_compress_default(source, blockDest, size, sizeof blockBuffer);
+    if (packedSize <= 0)
+        return false;
+
+    // Block header: unpacked and packed size, as read by File
+    dest.push_back((unsigned char)(size & 0xff));
+    dest.push_back((unsigned char)(size >> 8));
+    dest.push_back((unsigned char)(packedSize & 0xff));
+    dest.push_back((unsigned char)(packedSize >> 8));
+    dest.insert(dest.end(), blockBuffer, blockBuffer + packedSize);
+    return true;
+}
+
+/// Decompress LZ4 blocks written by CompressBlock(). Return false if the data is malformed.
+static bool DecompressBlocks(const ea::vector<unsigned char>& source, unsigned size, ea::vector<unsigned char>& dest)
+{
+    dest.resize(size);
+    unsigned destPos = 0;
+    for (unsigned pos = 0; pos + 4 <= source.size();)
+    {
+        const unsigned unpackedSize = source[pos] | (source[pos + 1] << 8);
+        const unsigned packedSize = source[pos + 2] | (source[pos + 3] << 8);
+        pos += 4;
+        if (pos + packedSize > source.size() || destPos + unpackedSize > size)
+            return false;
+
+        const int result = LZ4_decompress_safe(reinterpret_cast<const char*>(&source[pos]), reinterpret_cast<char*>(&dest[destPos]),
+            packedSize, unpackedSize);
+        if (result != (int)unpackedSize)
+            return false;
+
+        pos += packedSize;
+        destPos += unpackedSize;
+    }
+    return destPos == size;
+}
+
+PackageBuilder::PackageBuilder() = default;
+
+PackageBuilder::~PackageBuilder() = default;
+
+bool PackageBuilder::AddPreviousPackage(PackageFile* package)
+{
+    if (!package || !package->GetNumFiles())
+        return false;
+
+    auto file = MakeShared<File>(package->GetContext(), package->GetName());
+    if (!file->IsOpen())
+        return false;
+
+    const unsigned fileIndex = previousFiles_.size();
+    previousFiles_.push_back(file);
+
+    for (const auto& item : package->GetEntries())
+    {
+        // Compressed entries of older package formats do not store their size and can not be reused
+        const PackageEntry& entry = item.second;
+        if (entry.codec_ == PACKAGE_CODEC_NONE || entry.packedSize_)
+            previousEntries_.emplace(ea::make_pair(entry.checksum_, entry.size_), ea::make_pair(fileIndex, entry));
+    }
+    previousCompressed_ |= package->IsCompressed();
+    return true;
+}
+
+bool PackageBuilder::Create(AbstractFile* dest)
+{
+    if (!dest)
+        return false;
+
+    dest_ = dest;
+    startPosition_ = dest->GetPosition();
+    entries_.clear();
+    contentHashes_.clear();
+    totalDataSize_ = 0;
+    checksum_ = 0;
+    numReusedFiles_ = 0;
+
+    // The directory offset is not known yet, the header is rewritten by Finalize()
+    WriteHeader(0);
+    return true;
+}
+
+bool PackageBuilder::Append(const ea::string& name, const unsigned char* data, unsigned size, PackageCodec codec)
+{
+    if (!dest_ || (size && !data))
+        return false;
+
+    BuildEntry& item = entries_.emplace_back();
+    item.name_ = name;
+    item.nameHash_ = StringHash(name);
+    item.entry_.size_ = size;
+
+    for (unsigned i = 0; i < size; ++i)
+    {
+        checksum_ = SDBMHash(checksum_, data[i]);
+        item.entry_.checksum_ = SDBMHash(item.entry_.checksum_, data[i]);
+    }
+    totalDataSize_ += size;
+
+    // Identical files share their data
+    const ea::pair<unsigned long long, unsigned> contentKey{HashContent(data, size), size};
+    auto existing = contentHashes_.find(contentKey);
+    lastEntryDuplicate_ = existing != contentHashes_.end();
+    lastEntryReused_ = false;
+    if (lastEntryDuplicate_)
+    {
+        const PackageEntry& original = entries_[existing->second].entry_;
+        item.entry_.offset_ = original.offset_;
+        item.entry_.packedSize_ = original.packedSize_;
+        item.entry_.codec_ = original.codec_;
+        return true;
+    }
+
+    const unsigned char* storedData = data;
+    unsigned storedSize = size;
+    if (ReusePreviousData(data, size, item.entry_.checksum_, codec))
+    {
+        lastEntryReused_ = true;
+        ++numReusedFiles_;
+        if (codec != PACKAGE_CODEC_NONE)
+        {
+            storedData = compressBuffer_.data();
+            storedSize = compressBuffer_.size();
+        }
+    }
+    else if (codec != PACKAGE_CODEC_NONE && size)
+    {
+        if (!CompressBlocks(data, size, codec))
+        {
+            URHO3D_LOGERROR("LZ4 compression failed for file " + name);
+            entries_.pop_back();
+            return false;
+        }
+
+        if (compressBuffer_.size() <= size * (1.0f - MIN_COMPRESSION_SAVING))
+        {
+            storedData = compressBuffer_.data();
+            storedSize = compressBuffer_.size();
+        }
+        else
+            codec = PACKAGE_CODEC_NONE;
+    }
+    else
+        codec = PACKAGE_CODEC_NONE;
+
+    // Align file data so that it can be parsed in place from a memory mapped package
+    static const unsigned char padding[PACKAGE_ENTRY_ALIGNMENT] = {};
+    const unsigned position = dest_->GetPosition() - startPosition_;
+    const unsigned paddingSize = (PACKAGE_ENTRY_ALIGNMENT - position % PACKAGE_ENTRY_ALIGNMENT) % PACKAGE_ENTRY_ALIGNMENT;
+    dest_->Write(padding, paddingSize);
+
+    item.entry_.offset_ = position + paddingSize;
+    item.entry_.packedSize_ = storedSize;
+    item.entry_.codec_ = codec;
+    if (storedSize && dest_->Write(storedData, storedSize) != storedSize)
+    {
+        URHO3D_LOGERROR("Could not write file " + name + " to package");
+        entries_.pop_back();
+        return false;
+    }
+
+    contentHashes_[contentKey] = entries_.size() - 1;
+    return true;
+}
+
+bool PackageBuilder::Finalize()
+{
+    if (!dest_)
+        return false;
+
+    // Sort by name hash for binary search, and by name within hash collisions for reproducible packages
+    ea::vector<BuildEntry*> sortedEntries;
+    sortedEntries.reserve(entries_.size());
+    for (BuildEntry& item : entries_)
+        sortedEntries.push_back(&item);
+    ea::sort(sortedEntries.begin(), sortedEntries.end(), [](const BuildEntry* lhs, const BuildEntry* rhs)
+    {
+        return lhs->nameHash_ != rhs->nameHash_ ? lhs->nameHash_ < rhs->nameHash_ : lhs->name_ < rhs->name_;
+    });
+
+    const unsigned directoryOffset = dest_->GetPosition() - startPosition_;
+
+    unsigned nameOffset = 0;
+    for (const BuildEntry* item : sortedEntries)
+    {
+        dest_->WriteUInt(item->nameHash_.Value());
+        dest_->WriteUInt(nameOffset);
+        dest_->WriteUInt(item->entry_.offset_);
+        dest_->WriteUInt(item->entry_.size_);
+        dest_->WriteUInt(item->entry_.packedSize_);
+        dest_->WriteUInt(item->entry_.checksum_);
+        dest_->WriteUInt(item->entry_.codec_);
+        nameOffset += item->name_.length() + 1;
+    }
+
+    dest_->WriteUInt(nameOffset);
+    for (const BuildEntry* item : sortedEntries)
+        dest_->Write(item->name_.c_str(), item->name_.length() + 1);
+
+    // Write package size to the end of file to allow finding it linked to an executable file
+    const unsigned packageSize = dest_->GetPosition() - startPosition_ + sizeof(unsigned);
+    dest_->WriteUInt(packageSize);
+
+    const unsigned endPosition = dest_->GetPosition();
+    dest_->Seek(startPosition_);
+    WriteHeader(directoryOffset);
+    dest_->Seek(endPosition);
+
+    dest_ = nullptr;
+    previousFiles_.clear();
+    previousEntries_.clear();
+    previousCompressed_ = false;
+    return true;
+}
+
+void PackageBuilder::WriteHeader(long long directoryOffset)
+{
+    dest_->WriteFileID("RPK2");
+    dest_->WriteUInt(entries_.size());
+    dest_->WriteUInt(checksum_);
+    dest_->WriteUInt(PACKAGE_FORMAT_VERSION);
+    dest_->WriteInt64(directoryOffset);
+}
+
+bool PackageBuilder::CompressBlocks(const unsigned char* data, unsigned size, PackageCodec codec)
+{
+    compressBuffer_.clear();
+
+    const unsigned numBlocks = (size + PACKAGE_COMPRESSED_BLOCK_SIZE - 1) / PACKAGE_COMPRESSED_BLOCK_SIZE;
+#ifdef URHO3D_THREADING
+    const unsigned numThreads = Min(numThreads_, numBlocks / MIN_BLOCKS_PER_THREAD);
+#else
+    const unsigned numThreads = 1;
+#endif
+
+    if (numThreads <= 1)
+    {
+        for (unsigned pos = 0; pos < size; pos += PACKAGE_COMPRESSED_BLOCK_SIZE)
+        {
+            if (!CompressBlock(data + pos, Min(size - pos, PACKAGE_COMPRESSED_BLOCK_SIZE), codec, compressBuffer_))
+                return false;
+        }
+        return true;
+    }
+
+#ifdef URHO3D_THREADING
+    // Blocks are independent, so they are compressed in parallel and concatenated in order, producing identical output
+    if (blockBuffers_.size() < numBlocks)
+        blockBuffers_.resize(numBlocks);
+
+    std::atomic<unsigned> nextBlock{0};
+    std::atomic<bool> failed{false};
+    const auto compressBlocks = [&]()
+    {
+        for (;;)
+        {
+            const unsigned block = nextBlock.fetch_add(1, std::memory_order_relaxed);
+            if (block >= numBlocks)
+                break;
+
+            const unsigned pos = block * PACKAGE_COMPRESSED_BLOCK_SIZE;
+            blockBuffers_[block].clear();
+            if (!CompressBlock(data + pos, Min(size - pos, PACKAGE_COMPRESSED_BLOCK_SIZE), codec, blockBuffers_[block]))
+                failed = true;
+        }
+    };
+
+    ea::vector<std::thread> threads;
+    for (unsigned i = 1; i < numThreads; ++i)
+        threads.emplace_back(compressBlocks);
+    compressBlocks();
+    for (std::thread& thread : threads)
+        thread.join();
+
+    if (failed)
+        return false;
+
+    for (unsigned i = 0; i < numBlocks; ++i)
+        compressBuffer_.insert(compressBuffer_.end(), blockBuffers_[i].begin(), blockBuffers_[i].end());
+#endif
+    return true;
+}
+
+bool PackageBuilder::ReusePreviousData(const unsigned char* data, unsigned size, unsigned checksum, PackageCodec& codec)
+{
+    if (previousEntries_.empty() || !size)
+        return false;
+
+    auto it = previousEntries_.find(ea::make_pair(checksum, size));
+    if (it == previousEntries_.end())
+        return false;
+
+    File* previousFile = previousFiles_[it->second.first];
+    const PackageEntry& previous = it->second.second;
+    if (previous.codec_ == PACKAGE_CODEC_NONE)
+    {
+        // Compressing the file did not pay off last time. Without compression the new data is stored as is, so the previous
+        // data does not have to be read and compared. A package built without compression tells nothing about compressibility though.
+        if (codec != PACKAGE_CODEC_NONE && !previousCompressed_)
+            return false;
+        codec = PACKAGE_CODEC_NONE;
+        return true;
+    }
+
+    if (codec == PACKAGE_CODEC_NONE)
+        return false;
+
+    compressBuffer_.resize(previous.packedSize_);
+    if (previousFile->Seek(previous.offset_) != previous.offset_ ||
+        previousFile->Read(compressBuffer_.data(), previous.packedSize_) != previous.packedSize_)
+        return false;
+
+    // Checksum is not strong enough to tell files apart, so compare the contents. Decompression is much faster than compression.
+    if (!DecompressBlocks(compressBuffer_, size, verifyBuffer_) || memcmp(verifyBuffer_.data(), data, size) != 0)
+        return false;
+
+    codec = previous.codec_;
+    return true;
+}
+
+}
@@ -0,0 +1,129 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
+
+#include "../Container/Ptr.h"
+#include "../IO/PackageFile.h"
+
+namespace Urho3D
+{
+
+class AbstractFile;
+class File;
+
+/// Size of the LZ4 blocks compressed package entries are split into.
+static const unsigned PACKAGE_COMPRESSED_BLOCK_SIZE = 32768;
+
+/// Writes format version 2 packages: file data aligned for memory mapping, a codec chosen per entry, identical files stored once and a directory sorted by name hash.
+/// @nobind
+class URHO3D_API PackageBuilder
+{
+public:
+    /// Construct.
+    PackageBuilder();
+    /// Destruct.
+    ~PackageBuilder();
+
+    /// Begin writing a package at the current position of the destination, which must stay open until Finalize(). Return true if successful.
+    bool Create(AbstractFile* dest);
+    /// Add a file. The codec is a request: the entry is stored uncompressed when compression does not pay off. Return true if successful.
+    bool Append(const ea::string& name, const unsigned char* data, unsigned size, PackageCodec codec);
+    /// Write the directory and the final header and release the previous packages. Return true if successful.
+    bool Finalize();
+    /// Set number of threads that compress blocks of large files. 1 compresses on the calling thread only.
+    void SetNumThreads(unsigned numThreads) { numThreads_ = Max(numThreads, 1U); }
+    /// Reuse compressed data of unchanged files from a previously built package instead of compressing them again. May be called multiple times for split packages. The package file must not be the destination. Return true if successful.
+    bool AddPreviousPackage(PackageFile* package);
+
+    /// Return the entry added last.
+    const PackageEntry& GetLastEntry() const { return entries_.back().entry_; }
+    /// Return whether the entry added last shares the data of an identical earlier file.
+    bool IsLastEntryDuplicate() const { return lastEntryDuplicate_; }
+    /// Return whether the entry added last reused the data of the previous package.
+    bool IsLastEntryReused() const { return lastEntryReused_; }
+    /// Return number of files whose data was reused from the previous package.
+    unsigned GetNumReusedFiles() const { return numReusedFiles_; }
+    /// Return number of files added.
+    unsigned GetNumFiles() const { return entries_.size(); }
+    /// Return total uncompressed size of the added files.
+    unsigned GetTotalDataSize() const { return totalDataSize_; }
+    /// Return checksum of the added file contents.
+    unsigned GetChecksum() const { return checksum_; }
+
+private:
+    /// Directory entry under construction.
+    struct BuildEntry
+    {
+        /// File name.
+        ea::string name_;
+        /// File name hash.
+        StringHash nameHash_;
+        /// File entry.
+        PackageEntry entry_;
+    };
+
+    /// Write the package header.
+    void WriteHeader(long long directoryOffset);
+    /// Write file data compressed in LZ4 blocks to the compression buffer. Return false if compression failed.
+    bool CompressBlocks(const unsigned char* data, unsigned size, PackageCodec codec);
+    /// Look up identical file data in the previous package. Compressed data is read to the compression buffer and the codec is updated. Return true if found.
+    bool ReusePreviousData(const unsigned char* data, unsigned size, unsigned checksum, PackageCodec& codec);
+
+    /// Destination stream.
+    AbstractFile* dest_{};
+    /// Position of the package start in the destination.
+    unsigned startPosition_{};
+    /// Files added so far.
+    ea::vector<BuildEntry> entries_;
+    /// Indices of stored file data by content hash and size, for storing identical files once.
+    ea::unordered_map<ea::pair<unsigned long long, unsigned>, unsigned> contentHashes_;
+    /// Compressed data of the current file.
+    ea::vector<unsigned char> compressBuffer_;
+    /// Compressed blocks of the current file when compressing on multiple threads.
+    ea::vector<ea::vector<unsigned char>> blockBuffers_;
+    /// Decompressed data of a previous package entry, for verifying that it is identical.
+    ea::vector<unsigned char> verifyBuffer_;
+    /// Previous package files.
+    ea::vector<SharedPtr<File>> previousFiles_;
+    /// Entries of the previous packages and indices of their files by checksum and size.
+    ea::unordered_map<ea::pair<unsigned, unsigned>, ea::pair<unsigned, PackageEntry>> previousEntries_;
+    /// Whether any file of the previous packages is compressed.
+    bool previousCompressed_{};
+    /// Number of threads compressing blocks.
+    unsigned numThreads_{1};
+    /// Number of files whose data was reused from the previous package.
+    unsigned numReusedFiles_{};
+    /// Total uncompressed size of the added files.
+    unsigned totalDataSize_{};
+    /// Checksum of the added file contents.
+    unsigned checksum_{};
+    /// Whether the entry added last is a duplicate.
+    bool lastEntryDuplicate_{};
+    /// Whether the entry added last reused data of the previous package.
+    bool lastEntryReused_{};
+};
+
+}
@@ -24,9 +24,18 @@
 
 #include "../IO/File.h"
 #include "../IO/Log.h"
+#include "../IO/MemoryBuffer.h"
 #include "../IO/PackageFile.h"
 #include "../IO/FileSystem.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 namespace Urho3D
 {
 
@@ -49,7 +58,87 @@ PackageFile::PackageFile(Context* context, const ea::string& fileName, unsigned
     Open(fileName, startOffset);
 }
 
-PackageFile::~PackageFile() = default;
+PackageFile::~PackageFile()
+{
+    if (!mappedData_)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(mappedData_);
+    CloseHandle((HANDLE)mappingHandle_);
+#elif defined(__ANDROID__)
+    if (assetMapping_)
+        munmap(assetMapping_, assetMappingSize_);
+    else
+        munmap(const_cast<unsigned char*>(mappedData_), mappedSize_);
+#else
+    munmap(const_cast<unsigned char*>(mappedData_), mappedSize_);
+#endif
+}
+
+bool PackageFile::MapMemory()
+{
+    if (mappedData_)
+        return true;
+    if (fileName_.empty() || !totalSize_)
+        return false;
+
+#ifdef __ANDROID__
+    // APK assets are not plain files, but can be mapped directly from the APK when stored uncompressed
+    if (URHO3D_IS_ASSET(fileName_))
+    {
+        unsigned size = 0;
+        const unsigned char* data = MapAndroidAsset(fileName_, size, assetMapping_, assetMappingSize_);
+        if (!data)
+            return false;
+        if (size < totalSize_)
+        {
+            munmap(assetMapping_, assetMappingSize_);
+            assetMapping_ = nullptr;
+            assetMappingSize_ = 0;
+            return false;
+        }
+
+        mappedData_ = data;
+        mappedSize_ = totalSize_;
+        URHO3D_LOGDEBUG("Mapped package file " + fileName_ + " to memory from the APK");
+        return true;
+    }
+#endif
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(GetWideNativePath(fileName_).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    // The mapping keeps the file open
+    CloseHandle(file);
+    if (!mapping)
+        return false;
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, totalSize_);
+    if (!data)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+    mappingHandle_ = mapping;
+#else
+    int file = open(GetNativePath(fileName_).c_str(), O_RDONLY);
+    if (file < 0)
+        return false;
+    void* data = mmap(nullptr, totalSize_, PROT_READ, MAP_PRIVATE, file, 0);
+    // The mapping keeps the file open
+    close(file);
+    if (data == MAP_FAILED)
+        return false;
+#endif
+
+    mappedData_ = static_cast<const unsigned char*>(data);
+    mappedSize_ = totalSize_;
+    URHO3D_LOGDEBUG("Mapped package file " + fileName_ + " to memory");
+    return true;
+}
 
 bool PackageFile::Open(const ea::string& fileName, unsigned startOffset)
 {
@@ -60,7 +149,7 @@ bool PackageFile::Open(const ea::string& fileName, unsigned startOffset)
     // Check ID, then read the directory
     file->Seek(startOffset);
     ea::string id = file->ReadFileID();
-    if (id != "UPAK" && id != "ULZ4" && id != "RPAK" && id != "RLZ4")
+    if (id != "UPAK" && id != "ULZ4" && id != "RPAK" && id != "RLZ4" && id != "RPK2")
     {
         // If start offset has not been explicitly specified, also try to read package size from the end of file
         // to know how much we must rewind to find the package start
@@ -77,7 +166,7 @@ bool PackageFile::Open(const ea::string& fileName, unsigned startOffset)
             }
         }
 
-        if (id != "UPAK" && id != "ULZ4" && id != "RPAK" && id != "RLZ4")
+        if (id != "UPAK" && id != "ULZ4" && id != "RPAK" && id != "RLZ4" && id != "RPK2")
         {
             URHO3D_LOGERROR(fileName + " is not a valid package file");
             return false;
@@ -102,6 +191,27 @@ bool PackageFile::Open(const ea::string& fileName, unsigned startOffset)
         int64_t fileListOffset = file->ReadInt64();                 // New format has file list at the end of the file.
         file->Seek(fileListOffset);                                 // TODO: Serializer/Deserializer do not support files bigger than 4 GB
     }
+    else if (id == "RPK2")
+    {
+        // Format version 2: sorted hashed directory at the end of the file, with per-entry codecs
+        unsigned version = file->ReadUInt();
+        if (version != PACKAGE_FORMAT_VERSION)
+        {
+            URHO3D_LOGERROR(fileName + " has unsupported package format version " + ea::to_string(version));
+            return false;
+        }
+        int64_t directoryOffset = file->ReadInt64();
+        file->Seek((unsigned)directoryOffset + startOffset);
+        if (!ReadDirectory(*file, numFiles, startOffset))
+        {
+            URHO3D_LOGERROR(fileName + " has a corrupted package directory");
+            directory_.clear();
+            nameTable_.clear();
+            return false;
+        }
+        numFiles_ = numFiles;
+        return true;
+    }
 
     for (unsigned i = 0; i < numFiles; ++i)
     {
@@ -110,6 +220,8 @@ bool PackageFile::Open(const ea::string& fileName, unsigned startOffset)
         newEntry.offset_ = file->ReadUInt() + startOffset;
         totalDataSize_ += (newEntry.size_ = file->ReadUInt());
         newEntry.checksum_ = file->ReadUInt();
+        newEntry.codec_ = compressed_ ? PACKAGE_CODEC_LZ4 : PACKAGE_CODEC_NONE;
+        newEntry.packedSize_ = compressed_ ? 0 : newEntry.size_;
         if (!compressed_ && newEntry.offset_ + newEntry.size_ > totalSize_)
         {
             URHO3D_LOGERROR("File entry " + entryName + " outside package file");
@@ -119,33 +231,98 @@ bool PackageFile::Open(const ea::string& fileName, unsigned startOffset)
             entries_[entryName] = newEntry;
     }
 
+    numFiles_ = entries_.size();
     return true;
 }
 
-bool PackageFile::Exists(const ea::string& fileName) const
+bool PackageFile::ReadDirectory(File& file, unsigned numFiles, unsigned startOffset)
+{
+    ea::vector<unsigned char> records(numFiles * PACKAGE_DIRECTORY_RECORD_SIZE);
+    if (!records.empty() && file.Read(records.data(), records.size()) != records.size())
+        return false;
+
+    const unsigned nameTableSize = file.ReadUInt();
+    nameTable_.resize(nameTableSize);
+    if (nameTableSize && file.Read(nameTable_.data(), nameTableSize) != nameTableSize)
+        return false;
+    if (numFiles && (nameTable_.empty() || nameTable_.back() != '\0'))
+        return false;
+
+    MemoryBuffer buffer(records);
+    directory_.resize(numFiles);
+    for (unsigned i = 0; i < numFiles; ++i)
+    {
+        PackageDirectoryEntry& item = directory_[i];
+        item.nameHash_ = StringHash(buffer.ReadUInt());
+        item.nameOffset_ = buffer.ReadUInt();
+        item.entry_.offset_ = buffer.ReadUInt() + startOffset;
+        item.entry_.size_ = buffer.ReadUInt();
+        item.entry_.packedSize_ = buffer.ReadUInt();
+        item.entry_.checksum_ = buffer.ReadUInt();
+        const unsigned codec = buffer.ReadUInt();
+
+        // The binary search relies on the order, so verify it along with the bounds
+        if (item.nameOffset_ >= nameTableSize || codec >= MAX_PACKAGE_CODECS ||
+            item.entry_.offset_ + item.entry_.packedSize_ > totalSize_ ||
+            (i > 0 && item.nameHash_ < directory_[i - 1].nameHash_))
+            return false;
+
+        item.entry_.codec_ = (PackageCodec)codec;
+        compressed_ |= item.entry_.codec_ != PACKAGE_CODEC_NONE;
+        totalDataSize_ += item.entry_.size_;
+    }
+
+    return true;
+}
+
+const PackageEntry* PackageFile::FindDirectoryEntry(const ea::string& fileName) const
 {
-    bool found = entries_.find(fileName) != entries_.end();
+    const StringHash nameHash(fileName);
+    auto i = ea::lower_bound(directory_.begin(), directory_.end(), nameHash,
+        [](const PackageDirectoryEntry& item, StringHash hash) { return item.nameHash_ < hash; });
+    for (; i != directory_.end() && i->nameHash_ == nameHash; ++i)
+    {
+        if (fileName == &nameTable_[i->nameOffset_])
+            return &i->entry_;
+    }
 
 #ifdef _WIN32
     // On Windows perform a fallback case-insensitive search
-    if (!found)
+    for (const PackageDirectoryEntry& item : directory_)
     {
-        for (auto i = entries_.begin(); i != entries_.end(); ++i)
+        if (!fileName.comparei(&nameTable_[item.nameOffset_]))
+            return &item.entry_;
+    }
+#endif
+
+    return nullptr;
+}
+
+const ea::unordered_map<ea::string, PackageEntry>& PackageFile::GetEntries() const
+{
+    if (!directory_.empty())
+    {
+        MutexLock lock(entriesMutex_);
+        if (entries_.empty())
         {
-            if (!i->first.comparei(fileName))
-            {
-                found = true;
-                break;
-            }
+            for (const PackageDirectoryEntry& item : directory_)
+                entries_[&nameTable_[item.nameOffset_]] = item.entry_;
         }
     }
-#endif
 
-    return found;
+    return entries_;
+}
+
+bool PackageFile::Exists(const ea::string& fileName) const
+{
+    return GetEntry(fileName) != nullptr;
 }
 
 const PackageEntry* PackageFile::GetEntry(const ea::string& fileName) const
 {
+    if (!directory_.empty())
+        return FindDirectoryEntry(fileName);
+
     auto i = entries_.find(fileName);
     if (i != entries_.end())
         return &i->second;
@@ -22,11 +22,32 @@
 
 #pragma once
 
+#include "../Core/Mutex.h"
 #include "../Core/Object.h"
 
 namespace Urho3D
 {
 
+/// Compression codec of a package file entry.
+enum PackageCodec
+{
+    /// Stored as is.
+    PACKAGE_CODEC_NONE = 0,
+    /// LZ4 compressed blocks.
+    PACKAGE_CODEC_LZ4,
+    /// LZ4 compressed blocks, compressed with the high compression mode. Decompresses like PACKAGE_CODEC_LZ4.
+    PACKAGE_CODEC_LZ4HC,
+    /// Number of codecs.
+    MAX_PACKAGE_CODECS
+};
+
+/// Version of the hashed directory package format, which has the "RPK2" file ID.
+static const unsigned PACKAGE_FORMAT_VERSION = 2;
+/// Alignment of file data within format version 2 packages, allowing mapped file data to be parsed in place.
+static const unsigned PACKAGE_ENTRY_ALIGNMENT = 16;
+/// Size of a format version 2 directory record: name hash, name offset, data offset, size, packed size, checksum and codec.
+static const unsigned PACKAGE_DIRECTORY_RECORD_SIZE = 7 * sizeof(unsigned);
+
 /// %File entry within the package file.
 struct PackageEntry
 {
@@ -36,8 +57,25 @@ struct PackageEntry
     unsigned size_;
     /// File checksum.
     unsigned checksum_;
+    /// Stored size of the file data. Zero if unknown, which is the case for compressed entries of older package formats.
+    unsigned packedSize_;
+    /// Compression codec.
+    PackageCodec codec_;
 };
 
+/// %File entry of the hashed directory of format version 2 packages.
+struct PackageDirectoryEntry
+{
+    /// File name hash.
+    StringHash nameHash_;
+    /// Offset of the file name in the name table.
+    unsigned nameOffset_;
+    /// File entry.
+    PackageEntry entry_;
+};
+
+class File;
+
 /// Stores files of a directory tree sequentially for convenient access.
 class URHO3D_API PackageFile : public Object
 {
@@ -58,8 +96,8 @@ public:
     /// Return the file entry corresponding to the name, or null if not found. This will be case-insensitive on Windows and case-sensitive on other platforms.
     const PackageEntry* GetEntry(const ea::string& fileName) const;
 
-    /// Return all file entries.
-    const ea::unordered_map<ea::string, PackageEntry>& GetEntries() const { return entries_; }
+    /// Return all file entries. For format version 2 packages the map is built on first use.
+    const ea::unordered_map<ea::string, PackageEntry>& GetEntries() const;
 
     /// Return the package file name.
     /// @property
@@ -70,7 +108,7 @@ public:
 
     /// Return number of files.
     /// @property
-    unsigned GetNumFiles() const { return entries_.size(); }
+    unsigned GetNumFiles() const { return numFiles_; }
 
     /// Return total size of the package file.
     /// @property
@@ -84,18 +122,30 @@ public:
     /// @property
     unsigned GetChecksum() const { return checksum_; }
 
-    /// Return whether the files are compressed.
+    /// Return whether any of the files are compressed.
     /// @property
     bool IsCompressed() const { return compressed_; }
+    /// Return whether the package uses the format version 2 hashed directory.
+    bool IsHashedDirectory() const { return !directory_.empty(); }
+
+    /// Map the package file to memory, so that files are opened and read without file I/O, and uncompressed files can be parsed in place. On Android, packages stored uncompressed in the APK are mapped from it directly. Stays mapped until destruction. Return true if successful.
+    bool MapMemory();
+    /// Return whether the package file is mapped to memory.
+    /// @property
+    bool IsMemoryMapped() const { return mappedData_ != nullptr; }
+    /// Return the mapped package file contents, or null if not mapped. Entry offsets are relative to this.
+    /// @nobind
+    const unsigned char* GetMappedData() const { return mappedData_; }
 
     /// Return list of file names in the package.
-    const ea::vector<ea::string> GetEntryNames() const { return entries_.keys(); }
+    const ea::vector<ea::string> GetEntryNames() const { return GetEntries().keys(); }
 
     /// Return a file name in the package at the specified index
     const ea::string& GetEntryName(unsigned index) const
     {
+        const ea::unordered_map<ea::string, PackageEntry>& entries = GetEntries();
         unsigned nn = 0;
-        for (auto j = entries_.begin(); j != entries_.end(); ++j)
+        for (auto j = entries.begin(); j != entries.end(); ++j)
         {
             if (nn == index) return j->first;
             nn++;
@@ -107,8 +157,21 @@ public:
     void Scan(ea::vector<ea::string>& result, const ea::string& pathName, const ea::string& filter, bool recursive) const;
 
 private:
-    /// File entries.
-    ea::unordered_map<ea::string, PackageEntry> entries_;
+    /// Read the format version 2 hashed directory. Return true if successful.
+    bool ReadDirectory(File& file, unsigned numFiles, unsigned startOffset);
+    /// Find an entry from the hashed directory.
+    const PackageEntry* FindDirectoryEntry(const ea::string& fileName) const;
+
+    /// File entries. Built on demand for format version 2 packages.
+    mutable ea::unordered_map<ea::string, PackageEntry> entries_;
+    /// Mutex for building the file entries on demand.
+    mutable Mutex entriesMutex_;
+    /// Format version 2 directory, sorted by name hash.
+    ea::vector<PackageDirectoryEntry> directory_;
+    /// Format version 2 file names, zero terminated.
+    ea::vector<char> nameTable_;
+    /// Number of files.
+    unsigned numFiles_{};
     /// File name.
     ea::string fileName_;
     /// Package file name hash.
@@ -121,6 +184,19 @@ private:
     unsigned checksum_;
     /// Compressed flag.
     bool compressed_;
+    /// Memory mapped package file contents.
+    const unsigned char* mappedData_{};
+    /// Size of the memory mapping.
+    unsigned mappedSize_{};
+#ifdef _WIN32
+    /// File mapping object handle.
+    void* mappingHandle_{};
+#elif defined(__ANDROID__)
+    /// Page aligned mapping when mapped from an APK asset.
+    void* assetMapping_{};
+    /// Size of the APK asset mapping.
+    unsigned assetMappingSize_{};
+#endif
 };
 
 }
@@ -64,6 +64,8 @@ public:
 
     /// Return data.
     const unsigned char* GetData() const { return size_ ? &buffer_[0] : nullptr; }
+    /// Return data buffer for parsing in place.
+    const unsigned char* GetMemoryData() const override { return GetData(); }
 
     /// Return non-const data.
     unsigned char* GetModifiableData() { return size_ ? &buffer_[0] : nullptr; }
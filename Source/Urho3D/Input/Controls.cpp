@@ -30,7 +30,8 @@ namespace Urho3D
 Controls::Controls() :
     buttons_(0),
     yaw_(0.f),
-    pitch_(0.f)
+    pitch_(0.f),
+    sampleTime_(0)
 {
 }
 
@@ -42,6 +43,7 @@ void Controls::Reset()
     yaw_ = 0.0f;
     pitch_ = 0.0f;
     extraData_.clear();
+    sampleTime_ = 0;
 }
 
 }
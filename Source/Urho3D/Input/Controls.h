@@ -68,6 +68,8 @@ public:
     float pitch_;
     /// Extra control data.
     VariantMap extraData_;
+    /// Time in milliseconds at which the controls were sampled, on the input event clock. See Input::GetLastInputTime().
+    unsigned sampleTime_;
 };
 
 }
@@ -367,6 +367,7 @@ Input::Input(Context* context) :
     mousePressPosition_(MOUSE_POSITION_OFFSCREEN),
     lastVisibleMousePosition_(MOUSE_POSITION_OFFSCREEN),
     mouseMoveWheel_(0),
+    lastInputTime_(0),
     inputScale_(Vector2::ONE),
     windowID_(0),
     toggleFullscreen_(true),
@@ -436,9 +437,7 @@ void Input::Update()
 
     ResetInputAccumulation();
 
-    SDL_Event evt;
-    while (SDL_PollEvent(&evt))
-        HandleSDLEvent(&evt);
+    PollEvents();
 
     if (!enabled_)
         return;
@@ -1908,6 +1907,20 @@ void Input::OnSDLRawInput(SDL_Event& evt, bool& consumed)
     consumed = eventData[P_CONSUMED].GetBool();
 }
 
+void Input::PollEvents()
+{
+#ifndef __EMSCRIPTEN__
+    SDL_Event evt;
+    while (SDL_PollEvent(&evt))
+        HandleSDLEvent(&evt);
+#endif
+}
+
+void Input::InjectSDLEvent(SDL_Event& evt)
+{
+    HandleSDLEvent(&evt);
+}
+
 void Input::HandleSDLEvent(void* sdlEvent)
 {
     SDL_Event& evt = *static_cast<SDL_Event*>(sdlEvent);
@@ -1962,6 +1975,10 @@ void Input::HandleSDLEvent(void* sdlEvent)
         }
     }
 
+    // Key, mouse, joystick, controller, touch and gesture events occupy a contiguous range of event types
+    if (evt.type >= SDL_KEYDOWN && evt.type < SDL_CLIPBOARDUPDATE)
+        lastInputTime_ = evt.common.timestamp;
+
     // While not having input focus, skip key/mouse/touch/joystick events, except for the "click to focus" mechanism
     if (!inputFocus_ && evt.type >= SDL_KEYDOWN && evt.type <= SDL_MULTIGESTURE)
     {
@@ -181,6 +181,11 @@ public:
 
     /// Poll for window messages. Called by HandleBeginFrame().
     void Update();
+    /// Process SDL event as if it was received from the operating system. Used to replay recorded input.
+    /// @nobind
+    void InjectSDLEvent(SDL_Event& evt);
+    /// Process pending operating system events without starting a new input frame. Can be called between frames' updates to sample input, and timestamp it, more often than once per frame. Input events are sent immediately.
+    void PollEvents();
     /// Set whether ALT-ENTER fullscreen toggle is enabled.
     /// @property
     void SetToggleFullscreen(bool enable);
@@ -310,6 +315,9 @@ public:
     /// Return mouse wheel movement since last frame.
     /// @property
     int GetMouseMoveWheel() const { return mouseMoveWheel_; }
+    /// Return timestamp in milliseconds of the latest processed key, mouse, touch or joystick event.
+    /// @property
+    unsigned GetLastInputTime() const { return lastInputTime_; }
     /// Return input coordinate scaling. Should return non-unity on High DPI display.
     /// @property
     Vector2 GetInputScale() const { return inputScale_; }
@@ -479,6 +487,8 @@ private:
     IntVector2 mouseMove_;
     /// Mouse wheel movement since last frame.
     int mouseMoveWheel_;
+    /// Timestamp of the latest input event.
+    unsigned lastInputTime_;
     /// Input coordinate scaling. Non-unity when window and backbuffer have different sizes (e.g. Retina display).
     Vector2 inputScale_;
     /// SDL window ID.
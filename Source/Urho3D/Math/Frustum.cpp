@@ -24,6 +24,10 @@
 
 #include "../Math/Frustum.h"
 
+#ifdef URHO3D_SSE
+#include <xmmintrin.h>
+#endif
+
 #include "../DebugNew.h"
 
 namespace Urho3D
@@ -186,6 +190,56 @@ void Frustum::Transform(const Matrix3x4& transform)
     UpdatePlanes();
 }
 
+unsigned Frustum::IsInsideFast4(const BoundingBox* const boxes[4]) const
+{
+#ifdef URHO3D_SSE
+    // Bounding box min and max are padded to four floats, so they can be loaded as rows and transposed into SoA form
+    __m128 minX = _mm_loadu_ps(&boxes[0]->min_.x_);
+    __m128 minY = _mm_loadu_ps(&boxes[1]->min_.x_);
+    __m128 minZ = _mm_loadu_ps(&boxes[2]->min_.x_);
+    __m128 minW = _mm_loadu_ps(&boxes[3]->min_.x_);
+    __m128 maxX = _mm_loadu_ps(&boxes[0]->max_.x_);
+    __m128 maxY = _mm_loadu_ps(&boxes[1]->max_.x_);
+    __m128 maxZ = _mm_loadu_ps(&boxes[2]->max_.x_);
+    __m128 maxW = _mm_loadu_ps(&boxes[3]->max_.x_);
+    _MM_TRANSPOSE4_PS(minX, minY, minZ, minW);
+    _MM_TRANSPOSE4_PS(maxX, maxY, maxZ, maxW);
+
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 centerX = _mm_mul_ps(_mm_add_ps(maxX, minX), half);
+    const __m128 centerY = _mm_mul_ps(_mm_add_ps(maxY, minY), half);
+    const __m128 centerZ = _mm_mul_ps(_mm_add_ps(maxZ, minZ), half);
+    const __m128 edgeX = _mm_sub_ps(centerX, minX);
+    const __m128 edgeY = _mm_sub_ps(centerY, minY);
+    const __m128 edgeZ = _mm_sub_ps(centerZ, minZ);
+
+    __m128 outside = _mm_setzero_ps();
+    for (const auto& plane : planes_)
+    {
+        __m128 dist = _mm_add_ps(_mm_add_ps(
+            _mm_mul_ps(centerX, _mm_set1_ps(plane.normal_.x_)),
+            _mm_mul_ps(centerY, _mm_set1_ps(plane.normal_.y_))),
+            _mm_add_ps(_mm_mul_ps(centerZ, _mm_set1_ps(plane.normal_.z_)), _mm_set1_ps(plane.d_)));
+        __m128 absDist = _mm_add_ps(_mm_add_ps(
+            _mm_mul_ps(edgeX, _mm_set1_ps(plane.absNormal_.x_)),
+            _mm_mul_ps(edgeY, _mm_set1_ps(plane.absNormal_.y_))),
+            _mm_mul_ps(edgeZ, _mm_set1_ps(plane.absNormal_.z_)));
+        // dist < -absDist is the same as dist + absDist < 0
+        outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(dist, absDist), _mm_setzero_ps()));
+    }
+
+    return ~static_cast<unsigned>(_mm_movemask_ps(outside)) & 0xfu;
+#else
+    unsigned mask = 0;
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        if (IsInsideFast(*boxes[i]) != OUTSIDE)
+            mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
 Frustum Frustum::Transformed(const Matrix3& transform) const
 {
     Frustum transformed;
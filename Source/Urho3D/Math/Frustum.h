@@ -158,6 +158,10 @@ public:
         return INSIDE;
     }
 
+    /// Test four bounding boxes at once. Return bit mask with a bit set for each box that is (partially) inside.
+    /// @nobind
+    unsigned IsInsideFast4(const BoundingBox* const boxes[4]) const;
+
     /// Return distance of a point to the frustum, or 0 if inside.
     float Distance(const Vector3& point) const
     {
@@ -0,0 +1,298 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/ProcessUtils.h"
+#include "../Math/MathBatch.h"
+
+#ifdef URHO3D_SSE
+#include <immintrin.h>
+#endif
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+#ifdef URHO3D_SSE
+namespace
+{
+
+/// Multiply one row of the left-hand matrix by the right-hand matrix rows. The fourth row of rhs is implicit (0, 0, 0, 1).
+inline __m128 MultiplyRow(__m128 l, __m128 r0, __m128 r1, __m128 r2, __m128 r3)
+{
+    __m128 t0 = _mm_mul_ps(_mm_shuffle_ps(l, l, _MM_SHUFFLE(0, 0, 0, 0)), r0);
+    __m128 t1 = _mm_mul_ps(_mm_shuffle_ps(l, l, _MM_SHUFFLE(1, 1, 1, 1)), r1);
+    __m128 t2 = _mm_mul_ps(_mm_shuffle_ps(l, l, _MM_SHUFFLE(2, 2, 2, 2)), r2);
+    __m128 t3 = _mm_mul_ps(l, r3);
+    return _mm_add_ps(_mm_add_ps(t0, t1), _mm_add_ps(t2, t3));
+}
+
+}
+#endif
+
+namespace
+{
+
+
+void MultiplyMatricesDefault(Matrix3x4* dest, const Matrix3x4* lhs, const Matrix3x4* rhs, unsigned count)
+{
+#ifdef URHO3D_SSE
+    const __m128 r3 = _mm_set_ps(1.f, 0.f, 0.f, 0.f);
+    for (unsigned i = 0; i < count; ++i)
+    {
+        const __m128 r0 = _mm_loadu_ps(&rhs[i].m00_);
+        const __m128 r1 = _mm_loadu_ps(&rhs[i].m10_);
+        const __m128 r2 = _mm_loadu_ps(&rhs[i].m20_);
+        const __m128 l0 = _mm_loadu_ps(&lhs[i].m00_);
+        const __m128 l1 = _mm_loadu_ps(&lhs[i].m10_);
+        const __m128 l2 = _mm_loadu_ps(&lhs[i].m20_);
+        _mm_storeu_ps(&dest[i].m00_, MultiplyRow(l0, r0, r1, r2, r3));
+        _mm_storeu_ps(&dest[i].m10_, MultiplyRow(l1, r0, r1, r2, r3));
+        _mm_storeu_ps(&dest[i].m20_, MultiplyRow(l2, r0, r1, r2, r3));
+    }
+#else
+    for (unsigned i = 0; i < count; ++i)
+        dest[i] = lhs[i] * rhs[i];
+#endif
+}
+
+void MultiplyMatricesCommonDefault(Matrix3x4* dest, const Matrix3x4& lhs, const Matrix3x4* rhs, unsigned count)
+{
+#ifdef URHO3D_SSE
+    // Splat the left-hand matrix once, it stays in registers for the whole array
+    const __m128 l0 = _mm_loadu_ps(&lhs.m00_);
+    const __m128 l1 = _mm_loadu_ps(&lhs.m10_);
+    const __m128 l2 = _mm_loadu_ps(&lhs.m20_);
+    const __m128 l00 = _mm_shuffle_ps(l0, l0, _MM_SHUFFLE(0, 0, 0, 0));
+    const __m128 l01 = _mm_shuffle_ps(l0, l0, _MM_SHUFFLE(1, 1, 1, 1));
+    const __m128 l02 = _mm_shuffle_ps(l0, l0, _MM_SHUFFLE(2, 2, 2, 2));
+    const __m128 l10 = _mm_shuffle_ps(l1, l1, _MM_SHUFFLE(0, 0, 0, 0));
+    const __m128 l11 = _mm_shuffle_ps(l1, l1, _MM_SHUFFLE(1, 1, 1, 1));
+    const __m128 l12 = _mm_shuffle_ps(l1, l1, _MM_SHUFFLE(2, 2, 2, 2));
+    const __m128 l20 = _mm_shuffle_ps(l2, l2, _MM_SHUFFLE(0, 0, 0, 0));
+    const __m128 l21 = _mm_shuffle_ps(l2, l2, _MM_SHUFFLE(1, 1, 1, 1));
+    const __m128 l22 = _mm_shuffle_ps(l2, l2, _MM_SHUFFLE(2, 2, 2, 2));
+    const __m128 mask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+    const __m128 t0 = _mm_and_ps(l0, mask);
+    const __m128 t1 = _mm_and_ps(l1, mask);
+    const __m128 t2 = _mm_and_ps(l2, mask);
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        const __m128 r0 = _mm_loadu_ps(&rhs[i].m00_);
+        const __m128 r1 = _mm_loadu_ps(&rhs[i].m10_);
+        const __m128 r2 = _mm_loadu_ps(&rhs[i].m20_);
+        _mm_storeu_ps(&dest[i].m00_, _mm_add_ps(_mm_add_ps(_mm_mul_ps(l00, r0), _mm_mul_ps(l01, r1)),
+            _mm_add_ps(_mm_mul_ps(l02, r2), t0)));
+        _mm_storeu_ps(&dest[i].m10_, _mm_add_ps(_mm_add_ps(_mm_mul_ps(l10, r0), _mm_mul_ps(l11, r1)),
+            _mm_add_ps(_mm_mul_ps(l12, r2), t1)));
+        _mm_storeu_ps(&dest[i].m20_, _mm_add_ps(_mm_add_ps(_mm_mul_ps(l20, r0), _mm_mul_ps(l21, r1)),
+            _mm_add_ps(_mm_mul_ps(l22, r2), t2)));
+    }
+#else
+    for (unsigned i = 0; i < count; ++i)
+        dest[i] = lhs * rhs[i];
+#endif
+}
+
+void TransformPointsDefault(Vector3* dest, const Matrix3x4& transform, const Vector3* src, unsigned count)
+{
+#ifdef URHO3D_SSE
+    // Transpose the matrix once so that each point is a sum of splatted columns
+    __m128 c0 = _mm_loadu_ps(&transform.m00_);
+    __m128 c1 = _mm_loadu_ps(&transform.m10_);
+    __m128 c2 = _mm_loadu_ps(&transform.m20_);
+    __m128 c3 = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        const Vector3& p = src[i];
+        const __m128 result = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.x_), c0), _mm_mul_ps(_mm_set1_ps(p.y_), c1)),
+            _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.z_), c2), c3));
+
+        // Store x and y together, then z, to avoid writing past the end of the array
+        _mm_storel_pi(reinterpret_cast<__m64*>(&dest[i].x_), result);
+        _mm_store_ss(&dest[i].z_, _mm_movehl_ps(result, result));
+    }
+#else
+    for (unsigned i = 0; i < count; ++i)
+        dest[i] = transform * src[i];
+#endif
+}
+
+#ifdef URHO3D_SSE
+// FMA kernels are compiled for AVX2/FMA3 regardless of the global target and only called when the CPU supports them
+#if defined(__GNUC__) || defined(__clang__)
+#define URHO3D_TARGET_FMA __attribute__((target("avx2,fma")))
+#else
+#define URHO3D_TARGET_FMA
+#endif
+
+URHO3D_TARGET_FMA inline __m128 MultiplyRowFMA(__m128 l, __m128 r0, __m128 r1, __m128 r2, __m128 r3)
+{
+    __m128 result = _mm_mul_ps(l, r3);
+    result = _mm_fmadd_ps(_mm_shuffle_ps(l, l, _MM_SHUFFLE(0, 0, 0, 0)), r0, result);
+    result = _mm_fmadd_ps(_mm_shuffle_ps(l, l, _MM_SHUFFLE(1, 1, 1, 1)), r1, result);
+    return _mm_fmadd_ps(_mm_shuffle_ps(l, l, _MM_SHUFFLE(2, 2, 2, 2)), r2, result);
+}
+
+URHO3D_TARGET_FMA void MultiplyMatricesFMA(Matrix3x4* dest, const Matrix3x4* lhs, const Matrix3x4* rhs, unsigned count)
+{
+    const __m128 r3 = _mm_set_ps(1.f, 0.f, 0.f, 0.f);
+    for (unsigned i = 0; i < count; ++i)
+    {
+        const __m128 r0 = _mm_loadu_ps(&rhs[i].m00_);
+        const __m128 r1 = _mm_loadu_ps(&rhs[i].m10_);
+        const __m128 r2 = _mm_loadu_ps(&rhs[i].m20_);
+        const __m128 l0 = _mm_loadu_ps(&lhs[i].m00_);
+        const __m128 l1 = _mm_loadu_ps(&lhs[i].m10_);
+        const __m128 l2 = _mm_loadu_ps(&lhs[i].m20_);
+        _mm_storeu_ps(&dest[i].m00_, MultiplyRowFMA(l0, r0, r1, r2, r3));
+        _mm_storeu_ps(&dest[i].m10_, MultiplyRowFMA(l1, r0, r1, r2, r3));
+        _mm_storeu_ps(&dest[i].m20_, MultiplyRowFMA(l2, r0, r1, r2, r3));
+    }
+}
+
+URHO3D_TARGET_FMA void MultiplyMatricesCommonFMA(Matrix3x4* dest, const Matrix3x4& lhs, const Matrix3x4* rhs, unsigned count)
+{
+    const __m128 l0 = _mm_loadu_ps(&lhs.m00_);
+    const __m128 l1 = _mm_loadu_ps(&lhs.m10_);
+    const __m128 l2 = _mm_loadu_ps(&lhs.m20_);
+    const __m128 l00 = _mm_shuffle_ps(l0, l0, _MM_SHUFFLE(0, 0, 0, 0));
+    const __m128 l01 = _mm_shuffle_ps(l0, l0, _MM_SHUFFLE(1, 1, 1, 1));
+    const __m128 l02 = _mm_shuffle_ps(l0, l0, _MM_SHUFFLE(2, 2, 2, 2));
+    const __m128 l10 = _mm_shuffle_ps(l1, l1, _MM_SHUFFLE(0, 0, 0, 0));
+    const __m128 l11 = _mm_shuffle_ps(l1, l1, _MM_SHUFFLE(1, 1, 1, 1));
+    const __m128 l12 = _mm_shuffle_ps(l1, l1, _MM_SHUFFLE(2, 2, 2, 2));
+    const __m128 l20 = _mm_shuffle_ps(l2, l2, _MM_SHUFFLE(0, 0, 0, 0));
+    const __m128 l21 = _mm_shuffle_ps(l2, l2, _MM_SHUFFLE(1, 1, 1, 1));
+    const __m128 l22 = _mm_shuffle_ps(l2, l2, _MM_SHUFFLE(2, 2, 2, 2));
+    const __m128 mask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+    const __m128 t0 = _mm_and_ps(l0, mask);
+    const __m128 t1 = _mm_and_ps(l1, mask);
+    const __m128 t2 = _mm_and_ps(l2, mask);
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        const __m128 r0 = _mm_loadu_ps(&rhs[i].m00_);
+        const __m128 r1 = _mm_loadu_ps(&rhs[i].m10_);
+        const __m128 r2 = _mm_loadu_ps(&rhs[i].m20_);
+        _mm_storeu_ps(&dest[i].m00_, _mm_fmadd_ps(l02, r2, _mm_fmadd_ps(l01, r1, _mm_fmadd_ps(l00, r0, t0))));
+        _mm_storeu_ps(&dest[i].m10_, _mm_fmadd_ps(l12, r2, _mm_fmadd_ps(l11, r1, _mm_fmadd_ps(l10, r0, t1))));
+        _mm_storeu_ps(&dest[i].m20_, _mm_fmadd_ps(l22, r2, _mm_fmadd_ps(l21, r1, _mm_fmadd_ps(l20, r0, t2))));
+    }
+}
+
+URHO3D_TARGET_FMA void TransformPointsFMA(Vector3* dest, const Matrix3x4& transform, const Vector3* src, unsigned count)
+{
+    __m128 c0 = _mm_loadu_ps(&transform.m00_);
+    __m128 c1 = _mm_loadu_ps(&transform.m10_);
+    __m128 c2 = _mm_loadu_ps(&transform.m20_);
+    __m128 c3 = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        const Vector3& p = src[i];
+        const __m128 result = _mm_fmadd_ps(_mm_set1_ps(p.z_), c2,
+            _mm_fmadd_ps(_mm_set1_ps(p.y_), c1, _mm_fmadd_ps(_mm_set1_ps(p.x_), c0, c3)));
+        _mm_storel_pi(reinterpret_cast<__m64*>(&dest[i].x_), result);
+        _mm_store_ss(&dest[i].z_, _mm_movehl_ps(result, result));
+    }
+}
+#endif
+
+/// Kernel table. Starts with the baseline kernels so that calls from other static initializers are safe.
+struct BatchKernels
+{
+    void (*multiplyMatrices_)(Matrix3x4* dest, const Matrix3x4* lhs, const Matrix3x4* rhs, unsigned count);
+    void (*multiplyMatricesCommon_)(Matrix3x4* dest, const Matrix3x4& lhs, const Matrix3x4* rhs, unsigned count);
+    void (*transformPoints_)(Vector3* dest, const Matrix3x4& transform, const Vector3* src, unsigned count);
+};
+
+BatchKernels kernels{&MultiplyMatricesDefault, &MultiplyMatricesCommonDefault, &TransformPointsDefault};
+
+bool SelectKernels()
+{
+#ifdef URHO3D_SSE
+    const CPUFeatureFlags features = GetCPUFeatures();
+    if (features.Test(CPU_AVX2) && features.Test(CPU_FMA3))
+    {
+        kernels.multiplyMatrices_ = &MultiplyMatricesFMA;
+        kernels.multiplyMatricesCommon_ = &MultiplyMatricesCommonFMA;
+        kernels.transformPoints_ = &TransformPointsFMA;
+        return true;
+    }
+#endif
+    return false;
+}
+
+const bool kernelsSelected = SelectKernels();
+
+}
+
+void MultiplyMatrices(Matrix3x4* dest, const Matrix3x4* lhs, const Matrix3x4* rhs, unsigned count)
+{
+    kernels.multiplyMatrices_(dest, lhs, rhs, count);
+}
+
+void MultiplyMatrices(Matrix3x4* dest, const Matrix3x4& lhs, const Matrix3x4* rhs, unsigned count)
+{
+    kernels.multiplyMatricesCommon_(dest, lhs, rhs, count);
+}
+
+void TransformPoints(Vector3* dest, const Matrix3x4& transform, const Vector3* src, unsigned count)
+{
+    kernels.transformPoints_(dest, transform, src, count);
+}
+
+void NormalizeQuaternions(Quaternion* quaternions, unsigned count)
+{
+    for (unsigned i = 0; i < count; ++i)
+        quaternions[i].Normalize();
+}
+
+void DecomposeMatrices(const Matrix3x4* src, Vector3* translations, Quaternion* rotations, Vector3* scales, unsigned count)
+{
+    for (unsigned i = 0; i < count; ++i)
+    {
+        const Matrix3x4& matrix = src[i];
+        if (translations && rotations && scales)
+        {
+            matrix.Decompose(translations[i], rotations[i], scales[i]);
+            continue;
+        }
+        if (translations)
+            translations[i] = matrix.Translation();
+        if (rotations)
+            rotations[i] = matrix.Rotation();
+        if (scales)
+            scales[i] = matrix.Scale();
+    }
+}
+
+}
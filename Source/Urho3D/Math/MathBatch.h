@@ -0,0 +1,44 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+/// \file
+
+#pragma once
+
+#include "../Math/Matrix3x4.h"
+
+namespace Urho3D
+{
+
+/// Multiply arrays of matrices pairwise: dest[i] = lhs[i] * rhs[i]. Destination may alias either source.
+URHO3D_API void MultiplyMatrices(Matrix3x4* dest, const Matrix3x4* lhs, const Matrix3x4* rhs, unsigned count);
+/// Multiply an array of matrices by a common left-hand matrix: dest[i] = lhs * rhs[i]. Destination may alias the source.
+URHO3D_API void MultiplyMatrices(Matrix3x4* dest, const Matrix3x4& lhs, const Matrix3x4* rhs, unsigned count);
+/// Transform an array of points by a matrix. Destination may alias the source.
+URHO3D_API void TransformPoints(Vector3* dest, const Matrix3x4& transform, const Vector3* src, unsigned count);
+/// Normalize an array of quaternions in place.
+URHO3D_API void NormalizeQuaternions(Quaternion* quaternions, unsigned count);
+/// Decompose an array of matrices to translation, rotation and scale. Any of the output arrays may be null.
+URHO3D_API void DecomposeMatrices(const Matrix3x4* src, Vector3* translations, Quaternion* rotations, Vector3* scales, unsigned count);
+
+}
@@ -37,7 +37,7 @@ class URHO3D_API StringHash
 {
 public:
     /// Construct with zero value.
-    StringHash() noexcept :
+    constexpr StringHash() noexcept :
         value_(0)
     {
     }
@@ -46,7 +46,7 @@ public:
     StringHash(const StringHash& rhs) noexcept = default;
 
     /// Construct with an initial value.
-    explicit StringHash(unsigned value) noexcept :
+    constexpr explicit StringHash(unsigned value) noexcept :
         value_(value)
     {
     }
@@ -84,23 +84,23 @@ public:
     }
 
     /// Test for equality with another hash.
-    bool operator ==(const StringHash& rhs) const { return value_ == rhs.value_; }
+    constexpr bool operator ==(const StringHash& rhs) const { return value_ == rhs.value_; }
 
     /// Test for inequality with another hash.
-    bool operator !=(const StringHash& rhs) const { return value_ != rhs.value_; }
+    constexpr bool operator !=(const StringHash& rhs) const { return value_ != rhs.value_; }
 
     /// Test if less than another hash.
-    bool operator <(const StringHash& rhs) const { return value_ < rhs.value_; }
+    constexpr bool operator <(const StringHash& rhs) const { return value_ < rhs.value_; }
 
     /// Test if greater than another hash.
-    bool operator >(const StringHash& rhs) const { return value_ > rhs.value_; }
+    constexpr bool operator >(const StringHash& rhs) const { return value_ > rhs.value_; }
 
     /// Return true if nonzero hash value.
-    explicit operator bool() const { return value_ != 0; }
+    constexpr explicit operator bool() const { return value_ != 0; }
 
     /// Return hash value.
     /// @property
-    unsigned Value() const { return value_; }
+    constexpr unsigned Value() const { return value_; }
 
     /// Return as string.
     ea::string ToString() const;
@@ -109,7 +109,7 @@ public:
     ea::string Reverse() const;
 
     /// Return hash value for HashSet & HashMap.
-    unsigned ToHash() const { return value_; }
+    constexpr unsigned ToHash() const { return value_; }
 #ifndef URHO3D_HASH_DEBUG
     /// Calculate hash value from a C string.
     static constexpr unsigned Calculate(const char* str, unsigned hash = 0)
@@ -136,4 +136,13 @@ private:
 
 static_assert(sizeof(StringHash) == sizeof(unsigned), "Unexpected StringHash size.");
 
+#ifndef URHO3D_HASH_DEBUG
+/// Create StringHash from string literal. Calculated at compile time.
+constexpr StringHash operator"" _sh(const char* str, size_t) { return StringHash{str}; }
+
+#else
+/// Create StringHash from string literal. Registered for reverse lookup.
+inline StringHash operator"" _sh(const char* str, size_t) { return StringHash{str}; }
+#endif
+
 }
@@ -153,6 +153,7 @@ void TetrahedralMesh::Define(ea::span<const Vector3> positions)
     boundingBox.max_ += Vector3::ONE;
     InitializeSuperMesh(boundingBox);
     BuildTetrahedrons(positions);
+    BuildLookupGrid();
 }
 
 void TetrahedralMesh::CollectEdges(ea::vector<ea::pair<unsigned, unsigned>>& edges)
@@ -269,6 +270,63 @@ Vector4 TetrahedralMesh::GetInterpolationFactors(const Vector3& position, unsign
     if (tetrahedrons_.empty())
         return Vector4::ZERO;
 
+    // Hint is good enough if the position didn't leave the tetrahedron
+    if (tetIndexHint < tetrahedrons_.size())
+    {
+        const Vector4 weights = GetBarycentricCoords(tetIndexHint, position);
+        if (weights.x_ >= 0.0f && weights.y_ >= 0.0f && weights.z_ >= 0.0f && weights.w_ >= 0.0f)
+            return weights;
+    }
+
+    // Start from nearby tetrahedron otherwise
+    if (!lookupGrid_.empty())
+        tetIndexHint = lookupGrid_[GetLookupGridCell(position)];
+
+    return WalkToTetrahedron(position, tetIndexHint);
+}
+
+void TetrahedralMesh::BuildLookupGrid()
+{
+    lookupGrid_.clear();
+    lookupGridSize_ = 0;
+    if (numInnerTetrahedrons_ == 0)
+        return;
+
+    lookupGridBox_ = BoundingBox(vertices_.data(), vertices_.size());
+    lookupGridSize_ = Clamp(static_cast<unsigned>(std::cbrt(static_cast<float>(numInnerTetrahedrons_))), 1u, MaxLookupGridSize);
+
+    const Vector3 cellSize = lookupGridBox_.Size() / static_cast<float>(lookupGridSize_);
+    lookupGrid_.resize(lookupGridSize_ * lookupGridSize_ * lookupGridSize_);
+
+    unsigned tetIndex = 0;
+    for (unsigned z = 0; z < lookupGridSize_; ++z)
+    {
+        for (unsigned y = 0; y < lookupGridSize_; ++y)
+        {
+            for (unsigned x = 0; x < lookupGridSize_; ++x)
+            {
+                const Vector3 cellIndex{ static_cast<float>(x), static_cast<float>(y), static_cast<float>(z) };
+                const Vector3 cellCenter = lookupGridBox_.min_ + (cellIndex + Vector3::ONE * 0.5f) * cellSize;
+                WalkToTetrahedron(cellCenter, tetIndex);
+                lookupGrid_[(z * lookupGridSize_ + y) * lookupGridSize_ + x] = tetIndex;
+            }
+        }
+    }
+}
+
+unsigned TetrahedralMesh::GetLookupGridCell(const Vector3& position) const
+{
+    const Vector3 size = lookupGridBox_.Size();
+    const Vector3 localPosition = (position - lookupGridBox_.min_) / VectorMax(size, Vector3::ONE * M_EPSILON);
+    const int maxCell = static_cast<int>(lookupGridSize_) - 1;
+    const int x = Clamp(static_cast<int>(localPosition.x_ * lookupGridSize_), 0, maxCell);
+    const int y = Clamp(static_cast<int>(localPosition.y_ * lookupGridSize_), 0, maxCell);
+    const int z = Clamp(static_cast<int>(localPosition.z_ * lookupGridSize_), 0, maxCell);
+    return (z * lookupGridSize_ + y) * lookupGridSize_ + x;
+}
+
+Vector4 TetrahedralMesh::WalkToTetrahedron(const Vector3& position, unsigned& tetIndexHint) const
+{
     const unsigned maxIters = tetrahedrons_.size();
     if (tetIndexHint >= maxIters)
         tetIndexHint = 0;
@@ -1244,6 +1302,10 @@ bool SerializeValue(Archive& archive, const char* name, TetrahedralMesh& value)
         SerializeVector(archive, "Tetrahedrons", "Tetrahedron", value.tetrahedrons_);
         SerializeVector(archive, "HullNormals", "Hulls", value.hullNormals_);
         SerializeValue(archive, "NumInnerTetrahedrons", value.numInnerTetrahedrons_);
+
+        // Lookup grid is not serialized
+        if (archive.IsInput())
+            value.BuildLookupGrid();
         return true;
     }
     return false;
@@ -319,26 +319,37 @@ public:
     Vector4 GetBarycentricCoords(unsigned tetIndex, const Vector3& position) const;
 
     /// Find tetrahedron containing given position and calculate barycentric coordinates within this tetrahedron.
+    /// If hint tetrahedron doesn't contain the position, the search starts from the lookup grid cell.
     Vector4 GetInterpolationFactors(const Vector3& position, unsigned& tetIndexHint) const;
 
-    /// Sample value at given position from the arbitrary container of per-vertex data.
+    /// Build uniform lookup grid used to find starting tetrahedron for the search.
+    void BuildLookupGrid();
+
+    /// Sample value from the arbitrary container of per-vertex data using precomputed interpolation factors.
     template <class Container>
-    auto Sample(const Container& container, const Vector3& position, unsigned& tetIndexHint) const
+    auto Sample(const Container& container, unsigned tetIndex, const Vector4& weights) const
     {
         typename Container::value_type result{};
 
-        const Vector4& weights = GetInterpolationFactors(position, tetIndexHint);
-        if (tetIndexHint < tetrahedrons_.size())
+        if (tetIndex < tetrahedrons_.size())
         {
-            const Tetrahedron& tetrahedron = tetrahedrons_[tetIndexHint];
+            const Tetrahedron& tetrahedron = tetrahedrons_[tetIndex];
             for (unsigned i = 0; i < 3; ++i)
                 result += container[tetrahedron.indices_[i]] * weights[i];
-            if (tetIndexHint < numInnerTetrahedrons_)
+            if (tetIndex < numInnerTetrahedrons_)
                 result += container[tetrahedron.indices_[3]] * weights[3];
         }
         return result;
     }
 
+    /// Sample value at given position from the arbitrary container of per-vertex data.
+    template <class Container>
+    auto Sample(const Container& container, const Vector3& position, unsigned& tetIndexHint) const
+    {
+        const Vector4 weights = GetInterpolationFactors(position, tetIndexHint);
+        return Sample(container, tetIndexHint, weights);
+    }
+
 private:
     /// Solve cubic equation x^3 + a*x^2 + b*x + c = 0.
     static int SolveCubicEquation(double result[], double a, double b, double c, double eps);
@@ -353,6 +364,13 @@ private:
         const Vector3& p1, const Vector3& p2, const Vector3& p3);
     /// Find tetrahedron for given position. Ignore removed tetrahedrons. Return invalid index if cannot find.
     unsigned FindTetrahedron(const Vector3& position, ea::vector<bool>& removed) const;
+    /// Walk from given tetrahedron towards the one containing given position and calculate barycentric coordinates.
+    Vector4 WalkToTetrahedron(const Vector3& position, unsigned& tetIndex) const;
+    /// Return index of lookup grid cell for given position.
+    unsigned GetLookupGridCell(const Vector3& position) const;
+
+    /// Max number of lookup grid cells along each axis.
+    static const unsigned MaxLookupGridSize = 32;
 
     /// Number of initial super-mesh vertices.
     static const unsigned NumSuperMeshVertices = 8;
@@ -426,6 +444,14 @@ public:
 
     /// Debug array of edges related to errors in generation.
     mutable ea::vector<ea::pair<unsigned, unsigned>> debugHighlightEdges_;
+
+private:
+    /// Bounding box of lookup grid.
+    BoundingBox lookupGridBox_;
+    /// Number of lookup grid cells along each axis.
+    unsigned lookupGridSize_{};
+    /// Tetrahedron containing the center of each lookup grid cell.
+    ea::vector<unsigned> lookupGrid_;
 };
 
 /// Serialize tetrahedron to archive.
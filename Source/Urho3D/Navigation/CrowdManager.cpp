@@ -23,6 +23,7 @@
 #include "../Precompiled.h"
 
 #include "../Core/Context.h"
+#include "../Core/WorkQueue.h"
 #include "../Core/Profiler.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../IO/Log.h"
@@ -45,6 +46,8 @@ extern const char* NAVIGATION_CATEGORY;
 
 static const unsigned DEFAULT_MAX_AGENTS = 512;
 static const float DEFAULT_MAX_AGENT_RADIUS = 0.f;
+/// Number of crowd agents processed by one work item of the parallel update.
+static const unsigned CROWD_UPDATE_BATCH_SIZE = 32;
 
 static const StringVector filterTypesStructureElementNames =
 {
@@ -78,6 +81,15 @@ void CrowdAgentUpdateCallback(bool positionUpdate, dtCrowdAgent* ag, float* pos,
         crowdAgent->OnCrowdVelocityUpdate(ag, pos, dt);
 }
 
+static void CrowdParallelFor(void* userData, int count, dtParallelJob job, void* data)
+{
+    auto* workQueue = static_cast<WorkQueue*>(userData);
+    workQueue->ParallelFor(count, CROWD_UPDATE_BATCH_SIZE, [&](unsigned begin, unsigned end, unsigned threadIndex)
+    {
+        job(data, begin, end, threadIndex);
+    });
+}
+
 CrowdManager::CrowdManager(Context* context) :
     Component(context),
     maxAgents_(DEFAULT_MAX_AGENTS),
@@ -101,6 +113,7 @@ void CrowdManager::RegisterObject(Context* context)
 
     URHO3D_ATTRIBUTE("Max Agents", unsigned, maxAgents_, DEFAULT_MAX_AGENTS, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Max Agent Radius", float, maxAgentRadius_, DEFAULT_MAX_AGENT_RADIUS, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Parallel Update", GetParallelUpdate, SetParallelUpdate, bool, false, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Navigation Mesh", unsigned, navigationMeshId_, 0, AM_DEFAULT | AM_COMPONENTID);
     URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Filter Types", GetQueryFilterTypesAttr, SetQueryFilterTypesAttr,
         VariantVector, Variant::emptyVariantVector, AM_DEFAULT)
@@ -257,6 +270,16 @@ void CrowdManager::SetMaxAgentRadius(float maxAgentRadius)
     }
 }
 
+void CrowdManager::SetParallelUpdate(bool enable)
+{
+    if (enable != parallelUpdate_)
+    {
+        parallelUpdate_ = enable;
+        UpdateCrowdParallelUpdate();
+        MarkNetworkUpdate();
+    }
+}
+
 void CrowdManager::SetNavigationMesh(NavigationMesh* navMesh)
 {
     UnsubscribeFromEvent(E_COMPONENTADDED);
@@ -594,6 +617,8 @@ bool CrowdManager::CreateCrowd()
         return false;
     }
 
+    UpdateCrowdParallelUpdate();
+
     // Reconfigure the newly initialized crowd
     SetQueryFilterTypesAttr(queryFilterTypeConfiguration);
     SetObstacleAvoidanceTypesAttr(obstacleAvoidanceTypeConfiguration);
@@ -613,6 +638,22 @@ bool CrowdManager::CreateCrowd()
     return true;
 }
 
+void CrowdManager::UpdateCrowdParallelUpdate()
+{
+    if (!crowd_)
+        return;
+
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    if (parallelUpdate_ && workQueue && workQueue->GetNumThreads() > 0)
+    {
+        // Worker threads + main thread
+        if (!crowd_->setParallelFor(CrowdParallelFor, workQueue, workQueue->GetNumThreads() + 1))
+            URHO3D_LOGERROR("Could not initialize DetourCrowd parallel update");
+    }
+    else
+        crowd_->setParallelFor(nullptr, nullptr, 1);
+}
+
 int CrowdManager::AddAgent(CrowdAgent* agent, const Vector3& pos)
 {
     if (!crowd_ || !navigationMesh_ || !agent)
@@ -82,7 +82,7 @@ public:
     /// Add debug geometry to the debug renderer.
     void DrawDebugGeometry(bool depthTest);
 
-    /// Set velocity shader.
+    /// Set velocity shader. When the parallel update is enabled, the shader is invoked concurrently from the work queue threads and must not modify shared state.
     void SetVelocityShader(const CrowdAgentVelocityShader& shader) { velocityShader_ = shader; }
     /// Update agent velocity using velocity shader.
     void UpdateAgentVelocity(CrowdAgent* agent, float timeStep, Vector3& desiredVelocity, float& desiredSpeed) const { if (velocityShader_) velocityShader_(agent, timeStep, desiredVelocity, desiredSpeed); }
@@ -99,6 +99,9 @@ public:
     /// Set the maximum radius of any agent.
     /// @property
     void SetMaxAgentRadius(float maxAgentRadius);
+    /// Set whether to update the crowd agents in parallel on the work queue threads. The velocity shader must be thread-safe when enabled. Disabled by default.
+    /// @property
+    void SetParallelUpdate(bool enable);
     /// Assigns the navigation mesh for the crowd.
     /// @property{set_navMesh}
     void SetNavigationMesh(NavigationMesh* navMesh);
@@ -140,6 +143,10 @@ public:
     /// @property
     float GetMaxAgentRadius() const { return maxAgentRadius_; }
 
+    /// Return whether the crowd agents are updated in parallel.
+    /// @property
+    bool GetParallelUpdate() const { return parallelUpdate_; }
+
     /// Get the Navigation mesh assigned to the crowd.
     /// @property{get_navMesh}
     NavigationMesh* GetNavigationMesh() const { return navigationMesh_; }
@@ -172,6 +179,8 @@ public:
 protected:
     /// Create and initialized internal Detour crowd object. When it is a recreate, it preserves the configuration and attempts to re-add existing agents in the previous crowd back to the newly created crowd.
     bool CreateCrowd();
+    /// Enable or disable the parallel update of the internal Detour crowd object.
+    void UpdateCrowdParallelUpdate();
     /// Create and adds an detour crowd agent, Agent's radius and height is set through the navigation mesh. Return -1 on error, agent ID on success.
     int AddAgent(CrowdAgent* agent, const Vector3& pos);
     /// Removes the detour crowd agent.
@@ -210,6 +219,8 @@ private:
     unsigned maxAgents_{};
     /// The maximum radius of any agent that will be added to the crowd.
     float maxAgentRadius_{};
+    /// Whether to update the crowd agents in parallel.
+    bool parallelUpdate_{};
     /// Number of query filter types configured in the crowd. Limit to DT_CROWD_MAX_QUERY_FILTER_TYPE.
     unsigned numQueryFilterTypes_{};
     /// Number of configured area in each filter type. Limit to DT_MAX_AREAS.
@@ -27,6 +27,7 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../IO/Log.h"
 #include "../IO/MemoryBuffer.h"
@@ -60,6 +61,7 @@ extern const char* NAVIGATION_CATEGORY;
 
 static const int DEFAULT_MAX_OBSTACLES = 1024;
 static const int DEFAULT_MAX_LAYERS = 16;
+static const unsigned DEFAULT_MAX_ASYNC_TILES_PER_FRAME = 4;
 
 struct DynamicNavigationMesh::TileCacheData
 {
@@ -67,6 +69,39 @@ struct DynamicNavigationMesh::TileCacheData
     int dataSize;
 };
 
+struct DynamicNavigationMesh::TileBuildTask
+{
+    explicit TileBuildTask(dtTileCacheAlloc* allocator) :
+        build_(ea::make_unique<DynamicNavBuildData>(allocator))
+    {
+    }
+
+    ~TileBuildTask()
+    {
+        for (TileCacheData& layer : layers_)
+            dtFree(layer.data);
+    }
+
+    /// Tile index.
+    IntVector2 tile_;
+    /// Tile bounding box.
+    BoundingBox tileBoundingBox_;
+    /// Recast configuration.
+    rcConfig config_{};
+    /// Partition type.
+    NavmeshPartitionType partitionType_{};
+    /// Geometry and intermediate data. Released after rasterization.
+    ea::unique_ptr<DynamicNavBuildData> build_;
+    /// Compressed layers, owned by the task until added to the tile cache.
+    ea::vector<TileCacheData> layers_;
+    /// Whether the build has succeeded.
+    bool succeeded_{};
+    /// Whether the build has been superseded or discarded. Accessed only by the main thread.
+    bool cancelled_{};
+    /// Completed flag, set by the worker thread.
+    std::atomic<bool> completed_{};
+};
+
 struct TileCompressor : public dtTileCacheCompressor
 {
     int maxCompressedSize(const int bufferSize) override
@@ -212,7 +247,8 @@ struct LinearAllocator : public dtTileCacheAlloc
 
 DynamicNavigationMesh::DynamicNavigationMesh(Context* context) :
     NavigationMesh(context),
-    maxLayers_(DEFAULT_MAX_LAYERS)
+    maxLayers_(DEFAULT_MAX_LAYERS),
+    maxAsyncTilesPerFrame_(DEFAULT_MAX_ASYNC_TILES_PER_FRAME)
 {
     // 64 is the largest tile-size that DetourTileCache will tolerate without silently failing
     tileSize_ = 64;
@@ -234,6 +270,7 @@ void DynamicNavigationMesh::RegisterObject(Context* context)
     URHO3D_COPY_BASE_ATTRIBUTES(NavigationMesh);
     URHO3D_ACCESSOR_ATTRIBUTE("Max Obstacles", GetMaxObstacles, SetMaxObstacles, unsigned, DEFAULT_MAX_OBSTACLES, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Max Layers", GetMaxLayers, SetMaxLayers, unsigned, DEFAULT_MAX_LAYERS, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Max Async Tiles Per Frame", GetMaxAsyncTilesPerFrame, SetMaxAsyncTilesPerFrame, unsigned, DEFAULT_MAX_ASYNC_TILES_PER_FRAME, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Draw Obstacles", GetDrawObstacles, SetDrawObstacles, bool, false, AM_DEFAULT);
 }
 
@@ -540,6 +577,80 @@ bool DynamicNavigationMesh::Build(const IntVector2& from, const IntVector2& to)
     return true;
 }
 
+bool DynamicNavigationMesh::BuildAsync(const BoundingBox& boundingBox)
+{
+    if (!node_ || !navMesh_)
+        return BuildAsync(IntVector2::ZERO, IntVector2::ZERO);
+
+    const BoundingBox localSpaceBox = boundingBox.Transformed(node_->GetWorldTransform().Inverse());
+    const float tileEdgeLength = (float)tileSize_ * cellSize_;
+
+    const int sx = Clamp((int)((localSpaceBox.min_.x_ - boundingBox_.min_.x_) / tileEdgeLength), 0, numTilesX_ - 1);
+    const int sz = Clamp((int)((localSpaceBox.min_.z_ - boundingBox_.min_.z_) / tileEdgeLength), 0, numTilesZ_ - 1);
+    const int ex = Clamp((int)((localSpaceBox.max_.x_ - boundingBox_.min_.x_) / tileEdgeLength), 0, numTilesX_ - 1);
+    const int ez = Clamp((int)((localSpaceBox.max_.z_ - boundingBox_.min_.z_) / tileEdgeLength), 0, numTilesZ_ - 1);
+
+    return BuildAsync(IntVector2(sx, sz), IntVector2(ex, ez));
+}
+
+bool DynamicNavigationMesh::BuildAsync(const IntVector2& from, const IntVector2& to)
+{
+    URHO3D_PROFILE("BuildNavigationMeshAsync");
+
+    if (!node_)
+        return false;
+
+    if (!navMesh_ || !tileCache_)
+    {
+        URHO3D_LOGERROR("Navigation mesh must first be built fully before it can be partially rebuilt");
+        return false;
+    }
+
+    if (!node_->GetWorldScale().Equals(Vector3::ONE))
+        URHO3D_LOGWARNING("Navigation mesh root node has scaling. Agent parameters may not work as intended");
+
+    auto* workQueue = GetSubsystem<WorkQueue>();
+
+    // Geometry is read from the scene, so it is collected on the main thread up front
+    ea::vector<NavigationGeometryInfo> geometryList;
+    CollectGeometries(geometryList);
+
+    const IntVector2 begin = VectorMax(VectorMin(from, to), IntVector2::ZERO);
+    const IntVector2 end = VectorMin(VectorMax(from, to), IntVector2(numTilesX_ - 1, numTilesZ_ - 1));
+    for (int z = begin.y_; z <= end.y_; ++z)
+    {
+        for (int x = begin.x_; x <= end.x_; ++x)
+        {
+            const IntVector2 tile{x, z};
+            CancelAsyncTileBuild(tile);
+
+            auto task = ea::make_shared<TileBuildTask>(allocator_.get());
+            asyncTileBuilds_.push_back(task);
+
+            // Tile without geometry is cleared when integrated
+            if (!PrepareTileBuild(*task, geometryList, tile))
+                task->completed_ = true;
+            else if (workQueue)
+            {
+                workQueue->AddWorkItem([task]()
+                {
+                    task->succeeded_ = RasterizeTile(*task);
+                    task->build_ = nullptr;
+                    task->completed_ = true;
+                });
+            }
+            else
+            {
+                task->succeeded_ = RasterizeTile(*task);
+                task->build_ = nullptr;
+                task->completed_ = true;
+            }
+        }
+    }
+
+    return true;
+}
+
 ea::vector<unsigned char> DynamicNavigationMesh::GetTileData(const IntVector2& tile) const
 {
     VectorBuffer ret;
@@ -825,12 +936,30 @@ int DynamicNavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometr
 
     tileCache_->removeTile(navMesh_->getTileRefAt(x, z, 0), nullptr, nullptr);
 
-    const BoundingBox tileBoundingBox = GetTileBoundingBox(IntVector2(x, z));
+    TileBuildTask task(allocator_.get());
+    if (!PrepareTileBuild(task, geometryList, IntVector2(x, z)))
+        return 0; // Nothing to do
 
-    DynamicNavBuildData build(allocator_.get());
+    if (!RasterizeTile(task))
+        return 0;
+
+    // Transfer ownership of the layers to the caller
+    const int retCt = task.layers_.size();
+    for (int i = 0; i < retCt; ++i)
+        tiles[i] = task.layers_[i];
+    task.layers_.clear();
+
+    SendTileRebuiltEvent(task.tileBoundingBox_);
+    return retCt;
+}
+
+bool DynamicNavigationMesh::PrepareTileBuild(TileBuildTask& task, ea::vector<NavigationGeometryInfo>& geometryList, const IntVector2& tile)
+{
+    task.tile_ = tile;
+    task.tileBoundingBox_ = GetTileBoundingBox(tile);
+    task.partitionType_ = partitionType_;
 
-    rcConfig cfg;   // NOLINT(hicpp-member-init)
-    memset(&cfg, 0, sizeof cfg);
+    rcConfig& cfg = task.config_;
     cfg.cs = cellSize_;
     cfg.ch = cellHeight_;
     cfg.walkableSlopeAngle = agentMaxSlope_;
@@ -849,117 +978,125 @@ int DynamicNavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometr
     cfg.detailSampleDist = detailSampleDistance_ < 0.9f ? 0.0f : cellSize_ * detailSampleDistance_;
     cfg.detailSampleMaxError = cellHeight_ * detailSampleMaxError_;
 
-    rcVcopy(cfg.bmin, &tileBoundingBox.min_.x_);
-    rcVcopy(cfg.bmax, &tileBoundingBox.max_.x_);
+    rcVcopy(cfg.bmin, &task.tileBoundingBox_.min_.x_);
+    rcVcopy(cfg.bmax, &task.tileBoundingBox_.max_.x_);
     cfg.bmin[0] -= cfg.borderSize * cfg.cs;
     cfg.bmin[2] -= cfg.borderSize * cfg.cs;
     cfg.bmax[0] += cfg.borderSize * cfg.cs;
     cfg.bmax[2] += cfg.borderSize * cfg.cs;
 
     BoundingBox expandedBox(*reinterpret_cast<Vector3*>(cfg.bmin), *reinterpret_cast<Vector3*>(cfg.bmax));
-    GetTileGeometry(&build, geometryList, expandedBox);
+    GetTileGeometry(task.build_.get(), geometryList, expandedBox);
 
-    if (build.vertices_.empty() || build.indices_.empty())
-        return 0; // Nothing to do
+    return !task.build_->vertices_.empty() && !task.build_->indices_.empty();
+}
+
+bool DynamicNavigationMesh::RasterizeTile(TileBuildTask& task)
+{
+    URHO3D_PROFILE("RasterizeNavigationMeshTile");
+
+    DynamicNavBuildData* build = task.build_.get();
+    const rcConfig& cfg = task.config_;
 
-    build.heightField_ = rcAllocHeightfield();
-    if (!build.heightField_)
+    build->heightField_ = rcAllocHeightfield();
+    if (!build->heightField_)
     {
         URHO3D_LOGERROR("Could not allocate heightfield");
-        return 0;
+        return false;
     }
 
-    if (!rcCreateHeightfield(build.ctx_, *build.heightField_, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs,
+    if (!rcCreateHeightfield(build->ctx_, *build->heightField_, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs,
         cfg.ch))
     {
         URHO3D_LOGERROR("Could not create heightfield");
-        return 0;
+        return false;
     }
 
-    unsigned numTriangles = build.indices_.size() / 3;
+    unsigned numTriangles = build->indices_.size() / 3;
     ea::shared_array<unsigned char> triAreas(new unsigned char[numTriangles]);
     memset(triAreas.get(), 0, numTriangles);
 
-    rcMarkWalkableTriangles(build.ctx_, cfg.walkableSlopeAngle, &build.vertices_[0].x_, build.vertices_.size(),
-        &build.indices_[0], numTriangles, triAreas.get());
-    rcRasterizeTriangles(build.ctx_, &build.vertices_[0].x_, build.vertices_.size(), &build.indices_[0],
-        triAreas.get(), numTriangles, *build.heightField_, cfg.walkableClimb);
-    rcFilterLowHangingWalkableObstacles(build.ctx_, cfg.walkableClimb, *build.heightField_);
+    rcMarkWalkableTriangles(build->ctx_, cfg.walkableSlopeAngle, &build->vertices_[0].x_, build->vertices_.size(),
+        &build->indices_[0], numTriangles, triAreas.get());
+    rcRasterizeTriangles(build->ctx_, &build->vertices_[0].x_, build->vertices_.size(), &build->indices_[0],
+        triAreas.get(), numTriangles, *build->heightField_, cfg.walkableClimb);
+    rcFilterLowHangingWalkableObstacles(build->ctx_, cfg.walkableClimb, *build->heightField_);
 
-    rcFilterLedgeSpans(build.ctx_, cfg.walkableHeight, cfg.walkableClimb, *build.heightField_);
-    rcFilterWalkableLowHeightSpans(build.ctx_, cfg.walkableHeight, *build.heightField_);
+    rcFilterLedgeSpans(build->ctx_, cfg.walkableHeight, cfg.walkableClimb, *build->heightField_);
+    rcFilterWalkableLowHeightSpans(build->ctx_, cfg.walkableHeight, *build->heightField_);
 
-    build.compactHeightField_ = rcAllocCompactHeightfield();
-    if (!build.compactHeightField_)
+    build->compactHeightField_ = rcAllocCompactHeightfield();
+    if (!build->compactHeightField_)
     {
         URHO3D_LOGERROR("Could not allocate create compact heightfield");
-        return 0;
+        return false;
     }
-    if (!rcBuildCompactHeightfield(build.ctx_, cfg.walkableHeight, cfg.walkableClimb, *build.heightField_,
-        *build.compactHeightField_))
+    if (!rcBuildCompactHeightfield(build->ctx_, cfg.walkableHeight, cfg.walkableClimb, *build->heightField_,
+        *build->compactHeightField_))
     {
         URHO3D_LOGERROR("Could not build compact heightfield");
-        return 0;
+        return false;
     }
-    if (!rcErodeWalkableArea(build.ctx_, cfg.walkableRadius, *build.compactHeightField_))
+    if (!rcErodeWalkableArea(build->ctx_, cfg.walkableRadius, *build->compactHeightField_))
     {
         URHO3D_LOGERROR("Could not erode compact heightfield");
-        return 0;
+        return false;
     }
 
     // area volumes
-    for (unsigned i = 0; i < build.navAreas_.size(); ++i)
-        rcMarkBoxArea(build.ctx_, &build.navAreas_[i].bounds_.min_.x_, &build.navAreas_[i].bounds_.max_.x_,
-            build.navAreas_[i].areaID_, *build.compactHeightField_);
+    for (unsigned i = 0; i < build->navAreas_.size(); ++i)
+        rcMarkBoxArea(build->ctx_, &build->navAreas_[i].bounds_.min_.x_, &build->navAreas_[i].bounds_.max_.x_,
+            build->navAreas_[i].areaID_, *build->compactHeightField_);
 
-    if (this->partitionType_ == NAVMESH_PARTITION_WATERSHED)
+    if (task.partitionType_ == NAVMESH_PARTITION_WATERSHED)
     {
-        if (!rcBuildDistanceField(build.ctx_, *build.compactHeightField_))
+        if (!rcBuildDistanceField(build->ctx_, *build->compactHeightField_))
         {
             URHO3D_LOGERROR("Could not build distance field");
-            return 0;
+            return false;
         }
-        if (!rcBuildRegions(build.ctx_, *build.compactHeightField_, cfg.borderSize, cfg.minRegionArea,
+        if (!rcBuildRegions(build->ctx_, *build->compactHeightField_, cfg.borderSize, cfg.minRegionArea,
             cfg.mergeRegionArea))
         {
             URHO3D_LOGERROR("Could not build regions");
-            return 0;
+            return false;
         }
     }
     else
     {
-        if (!rcBuildRegionsMonotone(build.ctx_, *build.compactHeightField_, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
+        if (!rcBuildRegionsMonotone(build->ctx_, *build->compactHeightField_, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
         {
             URHO3D_LOGERROR("Could not build monotone regions");
-            return 0;
+            return false;
         }
     }
 
-    build.heightFieldLayers_ = rcAllocHeightfieldLayerSet();
-    if (!build.heightFieldLayers_)
+    build->heightFieldLayers_ = rcAllocHeightfieldLayerSet();
+    if (!build->heightFieldLayers_)
     {
         URHO3D_LOGERROR("Could not allocate height field layer set");
-        return 0;
+        return false;
     }
 
-    if (!rcBuildHeightfieldLayers(build.ctx_, *build.compactHeightField_, cfg.borderSize, cfg.walkableHeight,
-        *build.heightFieldLayers_))
+    if (!rcBuildHeightfieldLayers(build->ctx_, *build->compactHeightField_, cfg.borderSize, cfg.walkableHeight,
+        *build->heightFieldLayers_))
     {
         URHO3D_LOGERROR("Could not build height field layers");
-        return 0;
+        return false;
     }
 
-    int retCt = 0;
-    for (int i = 0; i < build.heightFieldLayers_->nlayers; ++i)
+    // The compressor is stateless, use a local copy so that the task doesn't reference the component
+    TileCompressor compressor;
+    for (int i = 0; i < build->heightFieldLayers_->nlayers; ++i)
     {
         dtTileCacheLayerHeader header;      // NOLINT(hicpp-member-init)
         header.magic = DT_TILECACHE_MAGIC;
         header.version = DT_TILECACHE_VERSION;
-        header.tx = x;
-        header.ty = z;
+        header.tx = task.tile_.x_;
+        header.ty = task.tile_.y_;
         header.tlayer = i;
 
-        rcHeightfieldLayer* layer = &build.heightFieldLayers_->layers[i];
+        rcHeightfieldLayer* layer = &build->heightFieldLayers_->layers[i];
 
         // Tile info.
         rcVcopy(header.bmin, layer->bmin);
@@ -973,29 +1110,111 @@ int DynamicNavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometr
         header.hmin = (unsigned short)layer->hmin;
         header.hmax = (unsigned short)layer->hmax;
 
+        TileCacheData tile{};
         if (dtStatusFailed(
-            dtBuildTileCacheLayer(compressor_.get()/*compressor*/, &header, layer->heights, layer->areas/*areas*/, layer->cons,
-                &(tiles[retCt].data), &tiles[retCt].dataSize)))
+            dtBuildTileCacheLayer(&compressor, &header, layer->heights, layer->areas/*areas*/, layer->cons,
+                &tile.data, &tile.dataSize)))
         {
             URHO3D_LOGERROR("Failed to build tile cache layers");
-            return 0;
+            return false;
         }
         else
-            ++retCt;
+            task.layers_.push_back(tile);
     }
 
-    // Send a notification of the rebuild of this tile to anyone interested
+    return true;
+}
+
+unsigned DynamicNavigationMesh::AddBuiltTile(TileBuildTask& task)
+{
+    const int x = task.tile_.x_;
+    const int z = task.tile_.y_;
+
+    dtCompressedTileRef existing[TILECACHE_MAXLAYERS];
+    const int existingCt = tileCache_->getTilesAt(x, z, existing, maxLayers_);
+    for (int i = 0; i < existingCt; ++i)
     {
-        using namespace NavigationAreaRebuilt;
-        VariantMap& eventData = GetContext()->GetEventDataMap();
-        eventData[P_NODE] = GetNode();
-        eventData[P_MESH] = this;
-        eventData[P_BOUNDSMIN] = Variant(tileBoundingBox.min_);
-        eventData[P_BOUNDSMAX] = Variant(tileBoundingBox.max_);
-        SendEvent(E_NAVIGATION_AREA_REBUILT, eventData);
+        unsigned char* data = nullptr;
+        if (!dtStatusFailed(tileCache_->removeTile(existing[i], &data, nullptr)) && data != nullptr)
+            dtFree(data);
     }
 
-    return retCt;
+    // Layers that are not rebuilt must not linger in the navigation mesh
+    for (unsigned i = 0; i < maxLayers_; ++i)
+    {
+        if (dtTileRef tileRef = navMesh_->getTileRefAt(x, z, i))
+            navMesh_->removeTile(tileRef, nullptr, nullptr);
+    }
+
+    unsigned numLayers = 0;
+    for (TileCacheData& layer : task.layers_)
+    {
+        dtCompressedTileRef tileRef;
+        int status = tileCache_->addTile(layer.data, layer.dataSize, DT_COMPRESSEDTILE_FREE_DATA, &tileRef);
+        if (dtStatusFailed((dtStatus)status))
+            dtFree(layer.data);
+        else
+        {
+            tileCache_->buildNavMeshTile(tileRef, navMesh_);
+            ++numLayers;
+        }
+        layer.data = nullptr;
+    }
+    task.layers_.clear();
+
+    if (task.succeeded_)
+        SendTileRebuiltEvent(task.tileBoundingBox_);
+    return numLayers;
+}
+
+void DynamicNavigationMesh::CancelAsyncTileBuild(const IntVector2& tile)
+{
+    for (const auto& task : asyncTileBuilds_)
+    {
+        if (task->tile_ == tile)
+            task->cancelled_ = true;
+    }
+}
+
+void DynamicNavigationMesh::IntegrateAsyncTiles()
+{
+    if (asyncTileBuilds_.empty())
+        return;
+
+    URHO3D_PROFILE("IntegrateNavigationMeshTiles");
+
+    unsigned numIntegrated = 0;
+    for (auto iter = asyncTileBuilds_.begin(); iter != asyncTileBuilds_.end();)
+    {
+        TileBuildTask& task = **iter;
+        if (task.cancelled_)
+        {
+            // A running worker keeps its own reference to the task
+            iter = asyncTileBuilds_.erase(iter);
+            continue;
+        }
+
+        if (numIntegrated < maxAsyncTilesPerFrame_ && task.completed_)
+        {
+            AddBuiltTile(task);
+            ++numIntegrated;
+            iter = asyncTileBuilds_.erase(iter);
+            continue;
+        }
+
+        ++iter;
+    }
+}
+
+void DynamicNavigationMesh::SendTileRebuiltEvent(const BoundingBox& tileBoundingBox)
+{
+    using namespace NavigationAreaRebuilt;
+    VariantMap& eventData = GetContext()->GetEventDataMap();
+    eventData[P_NODE] = GetNode();
+    eventData[P_MESH] = this;
+    eventData[P_BOUNDSMIN] = Variant(tileBoundingBox.min_);
+    eventData[P_BOUNDSMAX] = Variant(tileBoundingBox.max_);
+    SendEvent(E_NAVIGATION_AREA_REBUILT, eventData);
 }
 
 unsigned DynamicNavigationMesh::BuildTiles(ea::vector<NavigationGeometryInfo>& geometryList, const IntVector2& from, const IntVector2& to)
@@ -1006,6 +1225,9 @@ unsigned DynamicNavigationMesh::BuildTiles(ea::vector<NavigationGeometryInfo>& g
     {
         for (int x = from.x_; x <= to.x_; ++x)
         {
+            // Synchronous build supersedes the pending asynchronous one
+            CancelAsyncTileBuild(IntVector2(x, z));
+
             dtCompressedTileRef existing[TILECACHE_MAXLAYERS];
             const int existingCt = tileCache_->getTilesAt(x, z, existing, maxLayers_);
             for (int i = 0; i < existingCt; ++i)
@@ -1058,6 +1280,8 @@ ea::vector<OffMeshConnection*> DynamicNavigationMesh::CollectOffMeshConnections(
 
 void DynamicNavigationMesh::ReleaseNavigationMesh()
 {
+    // Pending tiles refer to the released tile layout. Running workers keep their tasks alive until done
+    asyncTileBuilds_.clear();
     NavigationMesh::ReleaseNavigationMesh();
     ReleaseTileCache();
 }
@@ -1157,7 +1381,11 @@ void DynamicNavigationMesh::HandleSceneSubsystemUpdate(StringHash eventType, Var
     using namespace SceneSubsystemUpdate;
 
     if (tileCache_ && navMesh_ && IsEnabledEffective())
+    {
+        // Obstacle requests are processed before the asynchronously built tiles are added
         tileCache_->update(eventData[P_TIMESTEP].GetFloat(), navMesh_);
+        IntegrateAsyncTiles();
+    }
 }
 
 }
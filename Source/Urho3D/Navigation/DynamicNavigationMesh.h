@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <EASTL/shared_ptr.h>
 #include <EASTL/unique_ptr.h>
 
 #include "../Navigation/NavigationMesh.h"
@@ -65,6 +66,10 @@ public:
     bool Build(const BoundingBox& boundingBox) override;
     /// Rebuild part of the navigation mesh in the rectangular area. Return true if successful.
     bool Build(const IntVector2& from, const IntVector2& to) override;
+    /// Rebuild part of the navigation mesh in the rectangular area asynchronously. Geometry is collected immediately, tiles are rasterized on the work queue threads and added to the navigation mesh during the scene subsystem update. Return true if successful.
+    bool BuildAsync(const IntVector2& from, const IntVector2& to);
+    /// Rebuild part of the navigation mesh contained by the bounding box asynchronously. Return true if successful.
+    bool BuildAsync(const BoundingBox& boundingBox);
     /// Return tile data.
     ea::vector<unsigned char> GetTileData(const IntVector2& tile) const override;
     /// Return whether the Obstacle is touching the given tile.
@@ -99,6 +104,16 @@ public:
     /// @property
     unsigned GetMaxLayers() const { return maxLayers_; }
 
+    /// Set the maximum number of asynchronously built tiles added to the navigation mesh per frame.
+    /// @property
+    void SetMaxAsyncTilesPerFrame(unsigned maxTiles) { maxAsyncTilesPerFrame_ = Max(maxTiles, 1U); }
+    /// Return the maximum number of asynchronously built tiles added to the navigation mesh per frame.
+    /// @property
+    unsigned GetMaxAsyncTilesPerFrame() const { return maxAsyncTilesPerFrame_; }
+    /// Return the number of asynchronously built tiles not yet added to the navigation mesh.
+    /// @property
+    unsigned GetNumPendingAsyncTiles() const { return asyncTileBuilds_.size(); }
+
     /// Draw debug geometry for Obstacles.
     /// @property
     void SetDrawObstacles(bool enable) { drawObstacles_ = enable; }
@@ -109,6 +124,7 @@ public:
 
 protected:
     struct TileCacheData;
+    struct TileBuildTask;
 
     /// Subscribe to events when assigned to a scene.
     void OnSceneSet(Scene* scene) override;
@@ -124,6 +140,18 @@ protected:
 
     /// Build one tile of the navigation mesh. Return true if successful.
     int BuildTile(ea::vector<NavigationGeometryInfo>& geometryList, int x, int z, TileCacheData* tiles);
+    /// Compute the build configuration and collect the geometry of one tile. Return false if the tile has no geometry.
+    bool PrepareTileBuild(TileBuildTask& task, ea::vector<NavigationGeometryInfo>& geometryList, const IntVector2& tile);
+    /// Rasterize the collected geometry into compressed tile cache layers. Doesn't access the component and is safe to call from worker threads. Return true if successful.
+    static bool RasterizeTile(TileBuildTask& task);
+    /// Replace the tile cache layers of the tile with the result of a build. Return number of added layers.
+    unsigned AddBuiltTile(TileBuildTask& task);
+    /// Discard the pending asynchronous build of the tile, if any.
+    void CancelAsyncTileBuild(const IntVector2& tile);
+    /// Add completed asynchronous tile builds to the navigation mesh, within the per-frame budget.
+    void IntegrateAsyncTiles();
+    /// Send the tile rebuilt notification event.
+    void SendTileRebuiltEvent(const BoundingBox& tileBoundingBox);
     /// Build tiles in the rectangular area. Return number of built tiles.
     unsigned BuildTiles(ea::vector<NavigationGeometryInfo>& geometryList, const IntVector2& from, const IntVector2& to);
     /// Off-mesh connections to be rebuilt in the mesh processor.
@@ -155,6 +183,10 @@ private:
     bool drawObstacles_{};
     /// Queue of tiles to be built.
     ea::vector<IntVector2> tileQueue_;
+    /// Maximum number of asynchronously built tiles added per frame.
+    unsigned maxAsyncTilesPerFrame_{};
+    /// Pending asynchronous tile builds, in the order of submission.
+    ea::vector<ea::shared_ptr<TileBuildTask>> asyncTileBuilds_;
 };
 
 }
@@ -24,6 +24,8 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/Thread.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Drawable.h"
 #include "../Graphics/Geometry.h"
@@ -40,6 +42,7 @@
 #include "../Navigation/Navigable.h"
 #include "../Navigation/NavigationEvents.h"
 #include "../Navigation/NavigationMesh.h"
+#include "../Navigation/NavigationPathHierarchy.h"
 #include "../Navigation/Obstacle.h"
 #include "../Navigation/OffMeshConnection.h"
 #ifdef URHO3D_PHYSICS
@@ -82,6 +85,9 @@ static const float DEFAULT_DETAIL_SAMPLE_DISTANCE = 6.0f;
 static const float DEFAULT_DETAIL_SAMPLE_MAX_ERROR = 1.0f;
 
 static const int MAX_POLYS = 2048;
+static const unsigned DEFAULT_PATH_CACHE_SIZE = 0;
+/// Number of path queries processed by one work item of the batched path finding.
+static const unsigned PATH_BATCH_SIZE = 8;
 
 
 /// Temporary data for finding a path.
@@ -97,12 +103,244 @@ struct FindPathData
     unsigned char pathFlags_[MAX_POLYS]{};
 };
 
+/// Navigation area snapshot used to assign area IDs to path points.
+struct PathAreaInfo
+{
+    /// World-space bounding box.
+    BoundingBox bounds_;
+    /// World-space center.
+    Vector3 center_;
+    /// Area ID.
+    unsigned areaID_;
+};
+
+/// Key of the path corridor cache.
+struct PathCacheKey
+{
+    /// Start polygon.
+    dtPolyRef startRef_{};
+    /// End polygon.
+    dtPolyRef endRef_{};
+    /// Query filter.
+    const dtQueryFilter* filter_{};
+
+    /// Test for equality with another key.
+    bool operator ==(const PathCacheKey& rhs) const
+    {
+        return startRef_ == rhs.startRef_ && endRef_ == rhs.endRef_ && filter_ == rhs.filter_;
+    }
+
+    /// Return hash value.
+    unsigned ToHash() const
+    {
+        unsigned result = 0;
+        CombineHash(result, MakeHash(startRef_));
+        CombineHash(result, MakeHash(endRef_));
+        CombineHash(result, MakeHash(filter_));
+        return result;
+    }
+};
+
+/// Cached path corridors.
+using PathCache = ea::unordered_map<PathCacheKey, ea::vector<dtPolyRef>>;
+
+/// Time-sliced path request.
+struct PathRequest
+{
+    /// Request ID.
+    unsigned id_{};
+    /// Query.
+    NavigationPathQuery query_;
+    /// State.
+    NavigationPathRequestState state_{};
+    /// Start polygon, resolved when the search starts.
+    dtPolyRef startRef_{};
+    /// End polygon, resolved when the search starts.
+    dtPolyRef endRef_{};
+    /// Resulting path.
+    ea::vector<NavigationPathPoint> path_;
+};
+
+/// Read-only state shared by path queries executed in parallel.
+struct PathQueryContext
+{
+    /// Navigation mesh world transform.
+    Matrix3x4 transform_;
+    /// Inverse navigation mesh world transform.
+    Matrix3x4 inverse_;
+    /// Default query filter.
+    const dtQueryFilter* defaultFilter_{};
+    /// Navigation areas.
+    ea::vector<PathAreaInfo> areas_;
+    /// Path corridor cache, or null if disabled.
+    const PathCache* cache_{};
+    /// Hierarchical path finding graph, or null if disabled.
+    const NavigationPathHierarchy* hierarchy_{};
+};
+
+/// Query pool, path cache and time-sliced requests.
+struct PathQueryData
+{
+    /// Destruct.
+    ~PathQueryData() { ReleaseQueries(); }
+
+    /// Free the queries bound to the navigation mesh.
+    void ReleaseQueries()
+    {
+        for (dtNavMeshQuery* query : threadQueries_)
+            dtFreeNavMeshQuery(query);
+        threadQueries_.clear();
+        threadPathData_.clear();
+        dtFreeNavMeshQuery(slicedQuery_);
+        slicedQuery_ = nullptr;
+        activeRequestId_ = 0;
+        cache_.clear();
+    }
+
+    /// Queries for worker threads. Main thread uses the query of the navigation mesh.
+    ea::vector<dtNavMeshQuery*> threadQueries_;
+    /// Temporary data for worker threads.
+    ea::vector<ea::unique_ptr<FindPathData>> threadPathData_;
+    /// Query dedicated to time-sliced requests.
+    dtNavMeshQuery* slicedQuery_{};
+    /// Temporary data for time-sliced requests.
+    FindPathData slicedPathData_;
+    /// Time-sliced requests in the order of submission.
+    ea::vector<PathRequest> requests_;
+    /// ID of the request being searched by the sliced query.
+    unsigned activeRequestId_{};
+    /// Next request ID.
+    unsigned nextRequestId_{1};
+    /// Path corridor cache.
+    PathCache cache_;
+    /// Maximum number of cached path corridors.
+    unsigned cacheSize_{DEFAULT_PATH_CACHE_SIZE};
+};
+
+/// Allocate and initialize navigation mesh query.
+static dtNavMeshQuery* CreateNavMeshQuery(const dtNavMesh* navMesh)
+{
+    dtNavMeshQuery* query = dtAllocNavMeshQuery();
+    if (query && dtStatusFailed(query->init(navMesh, MAX_POLYS)))
+    {
+        dtFreeNavMeshQuery(query);
+        query = nullptr;
+    }
+    if (!query)
+        URHO3D_LOGERROR("Could not create navigation mesh query");
+    return query;
+}
+
+/// Return whether all polygons of the cached path corridor are still valid.
+static bool IsPathCorridorValid(dtNavMeshQuery* navMeshQuery, const ea::vector<dtPolyRef>& polys, const dtQueryFilter* filter)
+{
+    for (dtPolyRef polyRef : polys)
+    {
+        if (!navMeshQuery->isValidPolyRef(polyRef, filter))
+            return false;
+    }
+    return true;
+}
+
+/// Convert the path corridor stored in the temporary data to world-space path points.
+static void BuildPathPoints(ea::vector<NavigationPathPoint>& dest, dtNavMeshQuery* navMeshQuery, FindPathData& data, int numPolys,
+    dtPolyRef endRef, const Vector3& localStart, const Vector3& localEnd, const PathQueryContext& context)
+{
+    Vector3 actualLocalEnd = localEnd;
+
+    // If full path was not found, clamp end point to the end polygon
+    if (data.polys_[numPolys - 1] != endRef)
+        navMeshQuery->closestPointOnPoly(data.polys_[numPolys - 1], &localEnd.x_, &actualLocalEnd.x_, nullptr);
+
+    int numPathPoints = 0;
+    navMeshQuery->findStraightPath(&localStart.x_, &actualLocalEnd.x_, data.polys_, numPolys,
+        &data.pathPoints_[0].x_, data.pathFlags_, data.pathPolys_, &numPathPoints, MAX_POLYS);
+
+    // Transform path result back to world space
+    for (int i = 0; i < numPathPoints; ++i)
+    {
+        NavigationPathPoint pt;
+        pt.position_ = context.transform_ * data.pathPoints_[i];
+        pt.flag_ = (NavigationPathPointFlag)data.pathFlags_[i];
+
+        // Walk through all NavAreas and find nearest
+        unsigned nearestNavAreaID = 0;       // 0 is the default nav area ID
+        float nearestDistance = M_LARGE_VALUE;
+        for (const PathAreaInfo& area : context.areas_)
+        {
+            if (area.bounds_.IsInside(pt.position_) == INSIDE)
+            {
+                float distance = (area.center_ - pt.position_).LengthSquared();
+                if (distance < nearestDistance)
+                {
+                    nearestDistance = distance;
+                    nearestNavAreaID = area.areaID_;
+                }
+            }
+        }
+        pt.areaID_ = (unsigned char)nearestNavAreaID;
+
+        dest.push_back(pt);
+    }
+}
+
+/// Find path with the given query object. Safe to call from worker threads when each thread has its own query object and temporary data. Newly found corridor is returned in cacheEntry if caching is enabled.
+static void FindPathWithQuery(ea::vector<NavigationPathPoint>& dest, dtNavMeshQuery* navMeshQuery, FindPathData& data,
+    const NavigationPathQuery& query, const PathQueryContext& context, ea::pair<PathCacheKey, ea::vector<dtPolyRef>>* cacheEntry)
+{
+    // Navigation data is in local space. Transform path points from world to local
+    const Vector3 localStart = context.inverse_ * query.start_;
+    const Vector3 localEnd = context.inverse_ * query.end_;
+
+    const dtQueryFilter* queryFilter = query.filter_ ? query.filter_ : context.defaultFilter_;
+    dtPolyRef startRef;
+    dtPolyRef endRef;
+    navMeshQuery->findNearestPoly(&localStart.x_, &query.extents_.x_, queryFilter, &startRef, nullptr);
+    navMeshQuery->findNearestPoly(&localEnd.x_, &query.extents_.x_, queryFilter, &endRef, nullptr);
+
+    if (!startRef || !endRef)
+        return;
+
+    const PathCacheKey key{startRef, endRef, queryFilter};
+    int numPolys = 0;
+    if (context.cache_)
+    {
+        const auto iter = context.cache_->find(key);
+        if (iter != context.cache_->end() && IsPathCorridorValid(navMeshQuery, iter->second, queryFilter))
+        {
+            numPolys = iter->second.size();
+            ea::copy(iter->second.begin(), iter->second.end(), data.polys_);
+        }
+    }
+
+    if (!numPolys)
+    {
+        if (!context.hierarchy_ || !context.hierarchy_->FindPath(navMeshQuery, startRef, endRef, localStart, localEnd,
+            queryFilter, data.polys_, numPolys, MAX_POLYS))
+        {
+            navMeshQuery->findPath(startRef, endRef, &localStart.x_, &localEnd.x_, queryFilter, data.polys_, &numPolys,
+                MAX_POLYS);
+        }
+        if (!numPolys)
+            return;
+
+        if (context.cache_ && cacheEntry)
+        {
+            cacheEntry->first = key;
+            cacheEntry->second.assign(data.polys_, data.polys_ + numPolys);
+        }
+    }
+
+    BuildPathPoints(dest, navMeshQuery, data, numPolys, endRef, localStart, localEnd, context);
+}
+
 NavigationMesh::NavigationMesh(Context* context) :
     Component(context),
     navMesh_(nullptr),
     navMeshQuery_(nullptr),
     queryFilter_(new dtQueryFilter()),
     pathData_(new FindPathData()),
+    pathQueries_(new PathQueryData()),
     tileSize_(DEFAULT_TILE_SIZE),
     cellSize_(DEFAULT_CELL_SIZE),
     cellHeight_(DEFAULT_CELL_HEIGHT),
@@ -155,6 +393,8 @@ void NavigationMesh::RegisterObject(Context* context)
         Variant::emptyBuffer, AM_FILE | AM_NOEDIT);
     URHO3D_ENUM_ACCESSOR_ATTRIBUTE("Partition Type", GetPartitionType, SetPartitionType, NavmeshPartitionType, navmeshPartitionTypeNames,
         NAVMESH_PARTITION_WATERSHED, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Path Cache Size", GetPathCacheSize, SetPathCacheSize, unsigned, DEFAULT_PATH_CACHE_SIZE, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Hierarchical Pathfinding", GetHierarchicalPathfinding, SetHierarchicalPathfinding, bool, false, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Draw OffMeshConnections", GetDrawOffMeshConnections, SetDrawOffMeshConnections, bool, false, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Draw NavAreas", GetDrawNavAreas, SetDrawNavAreas, bool, false, AM_DEFAULT);
 }
@@ -670,73 +910,230 @@ void NavigationMesh::FindPath(ea::vector<NavigationPathPoint>& dest, const Vecto
     if (!InitializeQuery())
         return;
 
-    // Navigation data is in local space. Transform path points from world to local
-    const Matrix3x4& transform = node_->GetWorldTransform();
-    Matrix3x4 inverse = transform.Inverse();
+    PathQueryContext context;
+    InitializePathQueryContext(context);
 
-    Vector3 localStart = inverse * start;
-    Vector3 localEnd = inverse * end;
+    ea::pair<PathCacheKey, ea::vector<dtPolyRef>> cacheEntry;
+    FindPathWithQuery(dest, navMeshQuery_, *pathData_, NavigationPathQuery{start, end, extents, filter}, context, &cacheEntry);
+    if (cacheEntry.first.startRef_)
+        AddCachedPath(cacheEntry.first, ea::move(cacheEntry.second));
+}
 
-    const dtQueryFilter* queryFilter = filter ? filter : queryFilter_.get();
-    dtPolyRef startRef;
-    dtPolyRef endRef;
-    navMeshQuery_->findNearestPoly(&localStart.x_, &extents.x_, queryFilter, &startRef, nullptr);
-    navMeshQuery_->findNearestPoly(&localEnd.x_, &extents.x_, queryFilter, &endRef, nullptr);
+void NavigationMesh::FindPaths(ea::vector<ea::vector<NavigationPathPoint>>& dest, const ea::vector<NavigationPathQuery>& queries)
+{
+    URHO3D_PROFILE("FindPaths");
+    dest.clear();
+    dest.resize(queries.size());
 
-    if (!startRef || !endRef)
+    if (queries.empty() || !InitializeQuery())
         return;
 
-    int numPolys = 0;
-    int numPathPoints = 0;
+    PathQueryContext context;
+    InitializePathQueryContext(context);
 
-    navMeshQuery_->findPath(startRef, endRef, &localStart.x_, &localEnd.x_, queryFilter, pathData_->polys_, &numPolys,
-        MAX_POLYS);
-    if (!numPolys)
+    ea::vector<ea::pair<PathCacheKey, ea::vector<dtPolyRef>>> cacheEntries(context.cache_ ? queries.size() : 0);
+
+    // Each worker thread gets its own query object and temporary data, the main thread uses the ones of the mesh
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    const unsigned numThreads = workQueue && Thread::IsMainThread() ? workQueue->GetNumThreads() : 0;
+    while (pathQueries_->threadQueries_.size() < numThreads)
+    {
+        dtNavMeshQuery* query = CreateNavMeshQuery(navMesh_);
+        if (!query)
+            break;
+        pathQueries_->threadQueries_.push_back(query);
+        pathQueries_->threadPathData_.push_back(ea::make_unique<FindPathData>());
+    }
+
+    const auto processQueries = [&](unsigned begin, unsigned end, unsigned threadIndex)
+    {
+        dtNavMeshQuery* navMeshQuery = threadIndex ? pathQueries_->threadQueries_[threadIndex - 1] : navMeshQuery_;
+        FindPathData& data = threadIndex ? *pathQueries_->threadPathData_[threadIndex - 1] : *pathData_;
+        for (unsigned i = begin; i < end; ++i)
+            FindPathWithQuery(dest[i], navMeshQuery, data, queries[i], context, context.cache_ ? &cacheEntries[i] : nullptr);
+    };
+
+    if (numThreads && pathQueries_->threadQueries_.size() == numThreads)
+        workQueue->ParallelFor(queries.size(), PATH_BATCH_SIZE, processQueries);
+    else
+        processQueries(0, queries.size(), 0);
+
+    // The cache is read-only while the queries run in parallel
+    for (auto& entry : cacheEntries)
+    {
+        if (entry.first.startRef_)
+            AddCachedPath(entry.first, ea::move(entry.second));
+    }
+}
+
+unsigned NavigationMesh::RequestPath(const NavigationPathQuery& query)
+{
+    PathRequest request;
+    request.id_ = pathQueries_->nextRequestId_++;
+    if (!pathQueries_->nextRequestId_)
+        pathQueries_->nextRequestId_ = 1;
+    request.query_ = query;
+    request.state_ = NAVPATHREQUEST_PENDING;
+    pathQueries_->requests_.push_back(ea::move(request));
+    return pathQueries_->requests_.back().id_;
+}
+
+void NavigationMesh::UpdatePathRequests(unsigned maxIterations)
+{
+    if (pathQueries_->requests_.empty() || !InitializeQuery())
         return;
 
-    Vector3 actualLocalEnd = localEnd;
+    URHO3D_PROFILE("UpdatePathRequests");
 
-    // If full path was not found, clamp end point to the end polygon
-    if (pathData_->polys_[numPolys - 1] != endRef)
-        navMeshQuery_->closestPointOnPoly(pathData_->polys_[numPolys - 1], &localEnd.x_, &actualLocalEnd.x_, nullptr);
+    if (!pathQueries_->slicedQuery_)
+    {
+        pathQueries_->slicedQuery_ = CreateNavMeshQuery(navMesh_);
+        if (!pathQueries_->slicedQuery_)
+            return;
+    }
 
-    navMeshQuery_->findStraightPath(&localStart.x_, &actualLocalEnd.x_, pathData_->polys_, numPolys,
-        &pathData_->pathPoints_[0].x_, pathData_->pathFlags_, pathData_->pathPolys_, &numPathPoints, MAX_POLYS);
+    dtNavMeshQuery* navMeshQuery = pathQueries_->slicedQuery_;
+    FindPathData& data = pathQueries_->slicedPathData_;
 
-    // Transform path result back to world space
-    for (int i = 0; i < numPathPoints; ++i)
+    PathQueryContext context;
+    InitializePathQueryContext(context);
+
+    int iterationsLeft = (int)maxIterations;
+    for (PathRequest& request : pathQueries_->requests_)
     {
-        NavigationPathPoint pt;
-        pt.position_ = transform * pathData_->pathPoints_[i];
-        pt.flag_ = (NavigationPathPointFlag)pathData_->pathFlags_[i];
+        if (iterationsLeft <= 0)
+            break;
+        if (request.state_ != NAVPATHREQUEST_PENDING)
+            continue;
 
-        // Walk through all NavAreas and find nearest
-        unsigned nearestNavAreaID = 0;       // 0 is the default nav area ID
-        float nearestDistance = M_LARGE_VALUE;
-        for (unsigned j = 0; j < areas_.size(); j++)
+        const NavigationPathQuery& query = request.query_;
+        const Vector3 localStart = context.inverse_ * query.start_;
+        const Vector3 localEnd = context.inverse_ * query.end_;
+        const dtQueryFilter* queryFilter = query.filter_ ? query.filter_ : context.defaultFilter_;
+
+        if (pathQueries_->activeRequestId_ != request.id_)
         {
-            NavArea* area = areas_[j];
-            if (area && area->IsEnabledEffective())
+            dtPolyRef& startRef = request.startRef_;
+            dtPolyRef& endRef = request.endRef_;
+            navMeshQuery->findNearestPoly(&localStart.x_, &query.extents_.x_, queryFilter, &startRef, nullptr);
+            navMeshQuery->findNearestPoly(&localEnd.x_, &query.extents_.x_, queryFilter, &endRef, nullptr);
+            if (!startRef || !endRef)
             {
-                BoundingBox bb = area->GetWorldBoundingBox();
-                if (bb.IsInside(pt.position_) == INSIDE)
+                request.state_ = NAVPATHREQUEST_FAILED;
+                continue;
+            }
+
+            // Cached corridor completes the request without searching
+            if (context.cache_)
+            {
+                const auto iter = context.cache_->find(PathCacheKey{startRef, endRef, queryFilter});
+                if (iter != context.cache_->end() && IsPathCorridorValid(navMeshQuery, iter->second, queryFilter))
                 {
-                    Vector3 areaWorldCenter = area->GetNode()->GetWorldPosition();
-                    float distance = (areaWorldCenter - pt.position_).LengthSquared();
-                    if (distance < nearestDistance)
-                    {
-                        nearestDistance = distance;
-                        nearestNavAreaID = area->GetAreaID();
-                    }
+                    ea::copy(iter->second.begin(), iter->second.end(), data.polys_);
+                    BuildPathPoints(request.path_, navMeshQuery, data, iter->second.size(), endRef, localStart, localEnd, context);
+                    request.state_ = NAVPATHREQUEST_COMPLETE;
+                    continue;
                 }
             }
+
+            if (dtStatusFailed(navMeshQuery->initSlicedFindPath(startRef, endRef, &localStart.x_, &localEnd.x_, queryFilter)))
+            {
+                request.state_ = NAVPATHREQUEST_FAILED;
+                continue;
+            }
+            pathQueries_->activeRequestId_ = request.id_;
         }
-        pt.areaID_ = (unsigned char)nearestNavAreaID;
 
-        dest.push_back(pt);
+        int doneIterations = 0;
+        dtStatus status = navMeshQuery->updateSlicedFindPath(iterationsLeft, &doneIterations);
+        iterationsLeft -= Max(doneIterations, 1);
+        if (dtStatusInProgress(status))
+            break;
+
+        pathQueries_->activeRequestId_ = 0;
+
+        int numPolys = 0;
+        if (dtStatusSucceed(status))
+            status = navMeshQuery->finalizeSlicedFindPath(data.polys_, &numPolys, MAX_POLYS);
+        if (dtStatusFailed(status) || !numPolys)
+        {
+            request.state_ = NAVPATHREQUEST_FAILED;
+            continue;
+        }
+
+        BuildPathPoints(request.path_, navMeshQuery, data, numPolys, request.endRef_, localStart, localEnd, context);
+        if (context.cache_)
+        {
+            AddCachedPath(PathCacheKey{request.startRef_, request.endRef_, queryFilter},
+                ea::vector<dtPolyRef>(data.polys_, data.polys_ + numPolys));
+        }
+        request.state_ = NAVPATHREQUEST_COMPLETE;
     }
 }
 
+NavigationPathRequestState NavigationMesh::GetPathRequestResult(unsigned requestId, ea::vector<NavigationPathPoint>& dest)
+{
+    dest.clear();
+
+    auto& requests = pathQueries_->requests_;
+    const auto iter = ea::find_if(requests.begin(), requests.end(),
+        [requestId](const PathRequest& request) { return request.id_ == requestId; });
+    if (iter == requests.end())
+        return NAVPATHREQUEST_INVALID;
+
+    const NavigationPathRequestState state = iter->state_;
+    if (state != NAVPATHREQUEST_PENDING)
+    {
+        dest = ea::move(iter->path_);
+        requests.erase(iter);
+    }
+    return state;
+}
+
+void NavigationMesh::CancelPathRequest(unsigned requestId)
+{
+    if (pathQueries_->activeRequestId_ == requestId)
+        pathQueries_->activeRequestId_ = 0;
+
+    auto& requests = pathQueries_->requests_;
+    requests.erase(ea::remove_if(requests.begin(), requests.end(),
+        [requestId](const PathRequest& request) { return request.id_ == requestId; }), requests.end());
+}
+
+unsigned NavigationMesh::GetNumPathRequests() const
+{
+    return pathQueries_->requests_.size();
+}
+
+void NavigationMesh::SetPathCacheSize(unsigned size)
+{
+    pathQueries_->cacheSize_ = size;
+    if (pathQueries_->cache_.size() > size)
+        pathQueries_->cache_.clear();
+}
+
+unsigned NavigationMesh::GetPathCacheSize() const
+{
+    return pathQueries_->cacheSize_;
+}
+
+void NavigationMesh::ClearPathCache()
+{
+    pathQueries_->cache_.clear();
+}
+
+void NavigationMesh::SetHierarchicalPathfinding(bool enable)
+{
+    if (enable == GetHierarchicalPathfinding())
+        return;
+
+    if (enable)
+        pathHierarchy_ = ea::make_unique<NavigationPathHierarchy>();
+    else
+        pathHierarchy_.reset();
+    ClearPathCache();
+}
+
 Vector3 NavigationMesh::GetRandomPoint(const dtQueryFilter* filter, dtPolyRef* randomRef)
 {
     if (!InitializeQuery())
@@ -862,6 +1259,8 @@ void NavigationMesh::SetAreaCost(unsigned areaID, float cost)
 {
     if (queryFilter_)
         queryFilter_->setAreaCost((int)areaID, cost);
+    // Cached corridors were found with the old costs
+    ClearPathCache();
 }
 
 BoundingBox NavigationMesh::GetWorldBoundingBox() const
@@ -1566,6 +1965,34 @@ bool NavigationMesh::InitializeQuery()
     return true;
 }
 
+void NavigationMesh::InitializePathQueryContext(PathQueryContext& context)
+{
+    context.transform_ = node_->GetWorldTransform();
+    context.inverse_ = context.transform_.Inverse();
+    context.defaultFilter_ = queryFilter_.get();
+    context.cache_ = pathQueries_->cacheSize_ ? &pathQueries_->cache_ : nullptr;
+
+    if (pathHierarchy_)
+    {
+        pathHierarchy_->Update(navMesh_);
+        context.hierarchy_ = pathHierarchy_.get();
+    }
+
+    for (const WeakPtr<NavArea>& area : areas_)
+    {
+        if (area && area->IsEnabledEffective())
+            context.areas_.push_back(PathAreaInfo{area->GetWorldBoundingBox(), area->GetNode()->GetWorldPosition(), area->GetAreaID()});
+    }
+}
+
+void NavigationMesh::AddCachedPath(const PathCacheKey& key, ea::vector<dtPolyRef> polys)
+{
+    // Start over when full, entries are cheap to recompute
+    if (pathQueries_->cache_.size() >= pathQueries_->cacheSize_)
+        pathQueries_->cache_.clear();
+    pathQueries_->cache_[key] = ea::move(polys);
+}
+
 void NavigationMesh::ReleaseNavigationMesh()
 {
     dtFreeNavMesh(navMesh_);
@@ -1573,6 +2000,9 @@ void NavigationMesh::ReleaseNavigationMesh()
 
     dtFreeNavMeshQuery(navMeshQuery_);
     navMeshQuery_ = nullptr;
+    pathQueries_->ReleaseQueries();
+    if (pathHierarchy_)
+        pathHierarchy_->Clear();
 
     numTilesX_ = 0;
     numTilesZ_ = 0;
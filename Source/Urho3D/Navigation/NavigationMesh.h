@@ -51,9 +51,13 @@ enum NavmeshPartitionType
 
 class Geometry;
 class NavArea;
+class NavigationPathHierarchy;
 
 struct FindPathData;
 struct NavBuildData;
+struct PathCacheKey;
+struct PathQueryContext;
+struct PathQueryData;
 
 /// Description of a navigation mesh geometry component, with transform and bounds information.
 struct NavigationGeometryInfo
@@ -88,6 +92,28 @@ struct URHO3D_API NavigationPathPoint
     unsigned char areaID_;
 };
 
+/// Path query for batched and time-sliced path finding.
+struct URHO3D_API NavigationPathQuery
+{
+    /// World-space start point.
+    Vector3 start_;
+    /// World-space end point.
+    Vector3 end_;
+    /// How far off the navigation mesh the points can be.
+    Vector3 extents_{Vector3::ONE};
+    /// Query filter, or null to use the default filter of the navigation mesh.
+    const dtQueryFilter* filter_{};
+};
+
+/// State of a time-sliced path request.
+enum NavigationPathRequestState
+{
+    NAVPATHREQUEST_INVALID = 0,
+    NAVPATHREQUEST_PENDING,
+    NAVPATHREQUEST_COMPLETE,
+    NAVPATHREQUEST_FAILED
+};
+
 /// Navigation mesh component. Collects the navigation geometry from child nodes with the Navigable component and responds to path queries.
 class URHO3D_API NavigationMesh : public Component
 {
@@ -186,6 +212,33 @@ public:
     void FindPath
         (ea::vector<NavigationPathPoint>& dest, const Vector3& start, const Vector3& end, const Vector3& extents = Vector3::ONE,
             const dtQueryFilter* filter = nullptr);
+    /// Find paths for multiple queries, in parallel on the work queue threads. Results are stored in the order of the queries and are empty for failed queries. Must be called from the main thread.
+    void FindPaths(ea::vector<ea::vector<NavigationPathPoint>>& dest, const ea::vector<NavigationPathQuery>& queries);
+    /// Submit a path request that is searched over several updates with time slicing. Return request ID.
+    unsigned RequestPath(const NavigationPathQuery& query);
+    /// Advance the time-sliced path requests in the order of submission, using at most the given total number of search iterations.
+    void UpdatePathRequests(unsigned maxIterations);
+    /// Return state of a time-sliced path request. Once complete or failed, the path is returned and the request ID is released.
+    NavigationPathRequestState GetPathRequestResult(unsigned requestId, ea::vector<NavigationPathPoint>& dest);
+    /// Cancel a time-sliced path request.
+    void CancelPathRequest(unsigned requestId);
+    /// Return number of time-sliced path requests not yet retrieved.
+    /// @property
+    unsigned GetNumPathRequests() const;
+    /// Set maximum number of path corridors cached for reuse by path queries between the same start and end polygons. Zero disables the cache.
+    /// @property
+    void SetPathCacheSize(unsigned size);
+    /// Return maximum number of cached path corridors.
+    /// @property
+    unsigned GetPathCacheSize() const;
+    /// Clear cached path corridors.
+    void ClearPathCache();
+    /// Set whether long paths are found with a hierarchical search over the tile borders first. Speeds up queries across many tiles at the cost of slightly less optimal paths.
+    /// @property
+    void SetHierarchicalPathfinding(bool enable);
+    /// Return whether hierarchical path finding is enabled.
+    /// @property
+    bool GetHierarchicalPathfinding() const { return pathHierarchy_ != nullptr; }
     /// Return a random point on the navigation mesh.
     Vector3 GetRandomPoint(const dtQueryFilter* filter = nullptr, dtPolyRef* randomRef = nullptr);
     /// Return a random point on the navigation mesh within a circle. The circle radius is only a guideline and in practice the returned point may be further away.
@@ -336,6 +389,10 @@ protected:
     bool InitializeQuery();
     /// Release the navigation mesh and the query.
     virtual void ReleaseNavigationMesh();
+    /// Snapshot the state used by path queries.
+    void InitializePathQueryContext(PathQueryContext& context);
+    /// Add path corridor to the cache.
+    void AddCachedPath(const PathCacheKey& key, ea::vector<dtPolyRef> polys);
 
     /// Identifying name for this navigation mesh.
     ea::string meshName_;
@@ -347,6 +404,10 @@ protected:
     ea::unique_ptr<dtQueryFilter> queryFilter_;
     /// Temporary data for finding a path.
     ea::unique_ptr<FindPathData> pathData_;
+    /// Query pool, path cache and time-sliced requests.
+    ea::unique_ptr<PathQueryData> pathQueries_;
+    /// Hierarchical path finding graph, or null if disabled.
+    ea::unique_ptr<NavigationPathHierarchy> pathHierarchy_;
     /// Tile size.
     int tileSize_;
     /// Cell size.
@@ -0,0 +1,403 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Navigation/NavigationPathHierarchy.h"
+
+#include <EASTL/heap.h>
+#include <EASTL/sort.h>
+
+#include <Detour/DetourNavMesh.h>
+#include <Detour/DetourNavMeshQuery.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+/// Minimum distance in tiles between the start and the end of the path to use the hierarchical search.
+static const int MIN_HIERARCHICAL_TILE_DISTANCE = 2;
+
+/// Open list entry, ordered by estimated total cost.
+struct PathHierarchyOpenNode
+{
+    /// Estimated total cost.
+    float cost_;
+    /// Node.
+    dtPolyRef ref_;
+
+    /// Compare for min-heap.
+    bool operator <(const PathHierarchyOpenNode& rhs) const { return cost_ > rhs.cost_; }
+};
+
+/// Search state of a node.
+struct PathHierarchySearchNode
+{
+    /// Cost from the start.
+    float cost_;
+    /// Previous node, zero for the nodes reached from the start polygon.
+    dtPolyRef parent_;
+    /// Closed flag.
+    bool closed_;
+};
+
+/// Return polygon center.
+static Vector3 GetPolyCenter(const dtMeshTile* tile, const dtPoly* poly)
+{
+    Vector3 center;
+    for (unsigned i = 0; i < poly->vertCount; ++i)
+        center += Vector3(&tile->verts[poly->verts[i] * 3]);
+    return poly->vertCount ? center / (float)poly->vertCount : center;
+}
+
+/// Return centers of all polygons of the tile.
+static void GetPolyCenters(const dtMeshTile* tile, ea::vector<Vector3>& centers)
+{
+    centers.resize(tile->header->polyCount);
+    for (int i = 0; i < tile->header->polyCount; ++i)
+        centers[i] = GetPolyCenter(tile, &tile->polys[i]);
+}
+
+/// Compute travel costs from the polygon to all polygons of its tile, without leaving the tile.
+static void SearchTile(const dtNavMesh* navMesh, const dtMeshTile* tile, const ea::vector<Vector3>& centers,
+    unsigned polyIndex, const Vector3& position, ea::vector<float>& costs)
+{
+    const unsigned tileIndex = navMesh->decodePolyIdTile(navMesh->getPolyRefBase(tile));
+    costs.assign(centers.size(), M_INFINITY);
+    costs[polyIndex] = 0.0f;
+
+    ea::vector<ea::pair<float, unsigned>> openList;
+    openList.emplace_back(0.0f, polyIndex);
+    const auto compare = [](const ea::pair<float, unsigned>& lhs, const ea::pair<float, unsigned>& rhs) { return lhs.first > rhs.first; };
+
+    while (!openList.empty())
+    {
+        ea::pop_heap(openList.begin(), openList.end(), compare);
+        const float cost = openList.back().first;
+        const unsigned index = openList.back().second;
+        openList.pop_back();
+        if (cost > costs[index])
+            continue;
+
+        const Vector3& from = index == polyIndex ? position : centers[index];
+        const dtPoly& poly = tile->polys[index];
+        for (unsigned link = poly.firstLink; link != DT_NULL_LINK; link = tile->links[link].next)
+        {
+            const dtPolyRef neighbourRef = tile->links[link].ref;
+            if (!neighbourRef || navMesh->decodePolyIdTile(neighbourRef) != tileIndex)
+                continue;
+
+            const unsigned neighbourIndex = navMesh->decodePolyIdPoly(neighbourRef);
+            const float neighbourCost = cost + (centers[neighbourIndex] - from).Length();
+            if (neighbourCost < costs[neighbourIndex])
+            {
+                costs[neighbourIndex] = neighbourCost;
+                openList.emplace_back(neighbourCost, neighbourIndex);
+                ea::push_heap(openList.begin(), openList.end(), compare);
+            }
+        }
+    }
+}
+
+void NavigationPathHierarchy::Update(const dtNavMesh* navMesh)
+{
+    if (navMesh != navMesh_ || !navMesh || (int)tiles_.size() != navMesh->getMaxTiles())
+    {
+        Clear();
+        navMesh_ = navMesh;
+        if (navMesh_)
+            tiles_.resize(navMesh_->getMaxTiles());
+    }
+
+    if (!navMesh_)
+        return;
+
+    // Find modified tiles by their salt, which is incremented each time a tile is removed
+    ea::vector<int> modifiedTiles;
+    for (int i = 0; i < navMesh_->getMaxTiles(); ++i)
+    {
+        const dtMeshTile* tile = navMesh_->getTile(i);
+        const unsigned salt = tile->header ? tile->salt : 0;
+        if (salt != tiles_[i].salt_)
+            modifiedTiles.push_back(i);
+    }
+
+    if (modifiedTiles.empty())
+        return;
+
+    // Border polygons of the neighbour tiles gain or lose links to the modified tiles, rebuild them too
+    ea::vector<int> rebuildTiles = modifiedTiles;
+    for (int tileIndex : modifiedTiles)
+    {
+        const dtMeshTile* tile = navMesh_->getTile(tileIndex);
+        const int x = tile->header ? tile->header->x : tiles_[tileIndex].x_;
+        const int y = tile->header ? tile->header->y : tiles_[tileIndex].y_;
+        for (int dy = -1; dy <= 1; ++dy)
+        {
+            for (int dx = -1; dx <= 1; ++dx)
+            {
+                static const int MAX_NEIGHBOUR_TILES = 32;
+                const dtMeshTile* neighbours[MAX_NEIGHBOUR_TILES];
+                const int numNeighbours = navMesh_->getTilesAt(x + dx, y + dy, neighbours, MAX_NEIGHBOUR_TILES);
+                for (int i = 0; i < numNeighbours; ++i)
+                    rebuildTiles.push_back(navMesh_->decodePolyIdTile(navMesh_->getPolyRefBase(neighbours[i])));
+            }
+        }
+    }
+
+    ea::sort(rebuildTiles.begin(), rebuildTiles.end());
+    rebuildTiles.erase(ea::unique(rebuildTiles.begin(), rebuildTiles.end()), rebuildTiles.end());
+    for (int tileIndex : rebuildTiles)
+        RebuildTile(tileIndex);
+}
+
+void NavigationPathHierarchy::Clear()
+{
+    navMesh_ = nullptr;
+    tiles_.clear();
+    nodes_.clear();
+}
+
+void NavigationPathHierarchy::RebuildTile(int tileIndex)
+{
+    TileNodes& tileNodes = tiles_[tileIndex];
+    for (dtPolyRef ref : tileNodes.nodes_)
+        nodes_.erase(ref);
+    tileNodes.nodes_.clear();
+
+    const dtMeshTile* tile = navMesh_->getTile(tileIndex);
+    if (!tile->header)
+    {
+        tileNodes.salt_ = 0;
+        return;
+    }
+
+    tileNodes.salt_ = tile->salt;
+    tileNodes.x_ = tile->header->x;
+    tileNodes.y_ = tile->header->y;
+
+    // Border polygons have links to the polygons of other tiles
+    const dtPolyRef base = navMesh_->getPolyRefBase(tile);
+    ea::vector<unsigned> borderPolys;
+    for (int i = 0; i < tile->header->polyCount; ++i)
+    {
+        const dtPoly& poly = tile->polys[i];
+        for (unsigned link = poly.firstLink; link != DT_NULL_LINK; link = tile->links[link].next)
+        {
+            const dtPolyRef neighbourRef = tile->links[link].ref;
+            if (neighbourRef && (int)navMesh_->decodePolyIdTile(neighbourRef) != tileIndex)
+            {
+                borderPolys.push_back(i);
+                break;
+            }
+        }
+    }
+
+    if (borderPolys.empty())
+        return;
+
+    ea::vector<Vector3> centers;
+    GetPolyCenters(tile, centers);
+
+    ea::vector<float> costs;
+    for (unsigned polyIndex : borderPolys)
+    {
+        const dtPolyRef ref = base | (dtPolyRef)polyIndex;
+        Node& node = nodes_[ref];
+        node.position_ = centers[polyIndex];
+        node.edges_.clear();
+
+        // Edges across the tile border
+        const dtPoly& poly = tile->polys[polyIndex];
+        for (unsigned link = poly.firstLink; link != DT_NULL_LINK; link = tile->links[link].next)
+        {
+            const dtPolyRef neighbourRef = tile->links[link].ref;
+            if (!neighbourRef || (int)navMesh_->decodePolyIdTile(neighbourRef) == tileIndex)
+                continue;
+
+            const dtMeshTile* neighbourTile = nullptr;
+            const dtPoly* neighbourPoly = nullptr;
+            navMesh_->getTileAndPolyByRefUnsafe(neighbourRef, &neighbourTile, &neighbourPoly);
+            node.edges_.push_back(Edge{neighbourRef, (GetPolyCenter(neighbourTile, neighbourPoly) - node.position_).Length()});
+        }
+
+        // Edges to the other border polygons reachable inside the tile
+        SearchTile(navMesh_, tile, centers, polyIndex, centers[polyIndex], costs);
+        for (unsigned otherIndex : borderPolys)
+        {
+            if (otherIndex != polyIndex && costs[otherIndex] != M_INFINITY)
+                node.edges_.push_back(Edge{base | (dtPolyRef)otherIndex, costs[otherIndex]});
+        }
+
+        tileNodes.nodes_.push_back(ref);
+    }
+}
+
+bool NavigationPathHierarchy::FindPath(dtNavMeshQuery* navMeshQuery, dtPolyRef startRef, dtPolyRef endRef,
+    const Vector3& startPos, const Vector3& endPos, const dtQueryFilter* filter, dtPolyRef* path, int& pathCount, int maxPath) const
+{
+    pathCount = 0;
+    if (!navMesh_ || maxPath < 2)
+        return false;
+
+    const dtMeshTile* startTile = nullptr;
+    const dtMeshTile* endTile = nullptr;
+    const dtPoly* poly = nullptr;
+    if (dtStatusFailed(navMesh_->getTileAndPolyByRef(startRef, &startTile, &poly))
+        || dtStatusFailed(navMesh_->getTileAndPolyByRef(endRef, &endTile, &poly)))
+        return false;
+
+    const int tileDistance = Max(Abs(startTile->header->x - endTile->header->x), Abs(startTile->header->y - endTile->header->y));
+    if (tileDistance < MIN_HIERARCHICAL_TILE_DISTANCE)
+        return false;
+
+    const unsigned startTileIndex = navMesh_->decodePolyIdTile(startRef);
+    const unsigned endTileIndex = navMesh_->decodePolyIdTile(endRef);
+    if (tiles_[startTileIndex].nodes_.empty() || tiles_[endTileIndex].nodes_.empty())
+        return false;
+
+    // Connect the start and the end polygons to the border polygons of their tiles
+    ea::vector<Vector3> centers;
+    ea::vector<float> startCosts;
+    GetPolyCenters(startTile, centers);
+    SearchTile(navMesh_, startTile, centers, navMesh_->decodePolyIdPoly(startRef), startPos, startCosts);
+
+    ea::vector<float> endCosts;
+    GetPolyCenters(endTile, centers);
+    SearchTile(navMesh_, endTile, centers, navMesh_->decodePolyIdPoly(endRef), endPos, endCosts);
+
+    // A* search over the graph. The end polygon is represented by the zero reference
+    ea::unordered_map<dtPolyRef, PathHierarchySearchNode> searchNodes;
+    ea::vector<PathHierarchyOpenNode> openList;
+    for (dtPolyRef ref : tiles_[startTileIndex].nodes_)
+    {
+        const float cost = startCosts[navMesh_->decodePolyIdPoly(ref)];
+        if (cost == M_INFINITY)
+            continue;
+
+        searchNodes[ref] = PathHierarchySearchNode{cost, 0, false};
+        openList.push_back(PathHierarchyOpenNode{cost + (nodes_.at(ref).position_ - endPos).Length(), ref});
+        ea::push_heap(openList.begin(), openList.end());
+    }
+
+    float endCost = M_INFINITY;
+    dtPolyRef endParent = 0;
+    bool found = false;
+    while (!openList.empty())
+    {
+        ea::pop_heap(openList.begin(), openList.end());
+        const dtPolyRef ref = openList.back().ref_;
+        openList.pop_back();
+
+        if (!ref)
+        {
+            found = true;
+            break;
+        }
+
+        PathHierarchySearchNode& searchNode = searchNodes[ref];
+        if (searchNode.closed_)
+            continue;
+        searchNode.closed_ = true;
+        const float cost = searchNode.cost_;
+
+        if (navMesh_->decodePolyIdTile(ref) == endTileIndex)
+        {
+            const float totalCost = cost + endCosts[navMesh_->decodePolyIdPoly(ref)];
+            if (totalCost < endCost)
+            {
+                endCost = totalCost;
+                endParent = ref;
+                openList.push_back(PathHierarchyOpenNode{totalCost, 0});
+                ea::push_heap(openList.begin(), openList.end());
+            }
+        }
+
+        const auto nodeIter = nodes_.find(ref);
+        if (nodeIter == nodes_.end())
+            continue;
+
+        for (const Edge& edge : nodeIter->second.edges_)
+        {
+            const auto targetIter = nodes_.find(edge.target_);
+            if (targetIter == nodes_.end())
+                continue;
+
+            const float targetCost = cost + edge.cost_;
+            auto searchIter = searchNodes.find(edge.target_);
+            if (searchIter == searchNodes.end())
+                searchIter = searchNodes.emplace(edge.target_, PathHierarchySearchNode{M_INFINITY, 0, false}).first;
+            else if (searchIter->second.closed_ || targetCost >= searchIter->second.cost_)
+                continue;
+
+            searchIter->second.cost_ = targetCost;
+            searchIter->second.parent_ = ref;
+            openList.push_back(PathHierarchyOpenNode{targetCost + (targetIter->second.position_ - endPos).Length(), edge.target_});
+            ea::push_heap(openList.begin(), openList.end());
+        }
+    }
+
+    if (!found)
+        return false;
+
+    ea::vector<dtPolyRef> waypoints;
+    for (dtPolyRef ref = endParent; ref; ref = searchNodes[ref].parent_)
+        waypoints.push_back(ref);
+    ea::reverse(waypoints.begin(), waypoints.end());
+    waypoints.push_back(endRef);
+
+    // Refine the path between consecutive nodes with local searches
+    path[0] = startRef;
+    pathCount = 1;
+    Vector3 fromPos = startPos;
+    for (dtPolyRef toRef : waypoints)
+    {
+        const dtPolyRef fromRef = path[pathCount - 1];
+        if (fromRef == toRef)
+            continue;
+
+        const Vector3 toPos = toRef == endRef ? endPos : nodes_.at(toRef).position_;
+        const bool crossesBorder = navMesh_->decodePolyIdTile(fromRef) != navMesh_->decodePolyIdTile(toRef);
+        if (crossesBorder)
+        {
+            if (pathCount >= maxPath)
+                return false;
+            path[pathCount++] = toRef;
+        }
+        else
+        {
+            // The search result starts with the last polygon of the path so far
+            int numPolys = 0;
+            navMeshQuery->findPath(fromRef, toRef, &fromPos.x_, &toPos.x_, filter, path + pathCount - 1, &numPolys,
+                maxPath - pathCount + 1);
+            if (!numPolys || path[pathCount + numPolys - 2] != toRef)
+                return false;
+            pathCount += numPolys - 1;
+        }
+        fromPos = toPos;
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,97 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
+
+#include "../Math/Vector3.h"
+#include "../Navigation/NavigationMesh.h"
+
+class dtNavMesh;
+class dtNavMeshQuery;
+class dtQueryFilter;
+
+namespace Urho3D
+{
+
+/// Abstract graph over the navigation mesh tiles for hierarchical path finding. Nodes are the polygons on the tile borders. They are connected by the shortest paths inside the tiles and by the links across the tile borders. Long path queries search the graph first and then refine the path between consecutive nodes with local searches.
+/// @nobind
+class URHO3D_API NavigationPathHierarchy
+{
+public:
+    /// Rebuild the graph for the tiles added, removed or rebuilt since the last update. Tiles are compared by their salt, so the check is cheap when nothing has changed. Must not be called while path queries are running.
+    void Update(const dtNavMesh* navMesh);
+    /// Remove all nodes.
+    void Clear();
+    /// Find path corridor between polygons. Return false if the start and end are too close for the hierarchical search or if it has failed, in which case the regular search should be used. Safe to call concurrently with different query objects.
+    bool FindPath(dtNavMeshQuery* navMeshQuery, dtPolyRef startRef, dtPolyRef endRef, const Vector3& startPos, const Vector3& endPos,
+        const dtQueryFilter* filter, dtPolyRef* path, int& pathCount, int maxPath) const;
+
+    /// Return number of nodes in the graph.
+    unsigned GetNumNodes() const { return nodes_.size(); }
+
+private:
+    /// Graph edge.
+    struct Edge
+    {
+        /// Target node.
+        dtPolyRef target_;
+        /// Travel cost.
+        float cost_;
+    };
+
+    /// Graph node.
+    struct Node
+    {
+        /// Polygon center.
+        Vector3 position_;
+        /// Outgoing edges.
+        ea::vector<Edge> edges_;
+    };
+
+    /// Nodes of one tile.
+    struct TileNodes
+    {
+        /// Salt of the tile when the nodes were built, zero if the tile was empty.
+        unsigned salt_{};
+        /// Tile location.
+        int x_{};
+        /// Tile location.
+        int y_{};
+        /// Border polygons.
+        ea::vector<dtPolyRef> nodes_;
+    };
+
+    /// Rebuild nodes and edges of the tile.
+    void RebuildTile(int tileIndex);
+
+    /// Navigation mesh the graph was built for.
+    const dtNavMesh* navMesh_{};
+    /// Per tile nodes, indexed like the navigation mesh tiles.
+    ea::vector<TileNodes> tiles_;
+    /// Nodes.
+    ea::unordered_map<dtPolyRef, Node> nodes_;
+};
+
+}
@@ -24,6 +24,7 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../IO/Compression.h"
 #include "../IO/File.h"
 #include "../IO/FileSystem.h"
 #include "../IO/Log.h"
@@ -57,8 +58,28 @@ namespace Urho3D
 {
 
 static const int STATS_INTERVAL_MSEC = 2000;
+/// Number of replication updates between re-evaluations of node relevancy for interest management.
+static const unsigned RELEVANCY_UPDATE_INTERVAL = 10;
+
+/// Number of sent controls kept on the client for prediction replay.
+static const unsigned MAX_CONTROLS_HISTORY = 64;
+/// Number of received controls that may be queued on the server.
+static const unsigned MAX_CONTROLS_QUEUE = 64;
+
+/// Bytes reserved for SLikeNet headers when deriving the packet size limit from MTU.
+static const int PACKET_HEADER_RESERVE = 64;
+/// Packet size limit when MTU is not known.
+static const int DEFAULT_PACKET_SIZE_LIMIT = 1024;
+
+/// Maximum number of package fragments sent to a client per update, shared between all package uploads.
+static const unsigned MAX_PACKAGE_FRAGMENTS_PER_UPDATE = 256;
+
+/// Guards replication states and weak references of shared nodes and components when connections are updated from worker threads.
+static Mutex replicationStateMutex;
 
 PackageDownload::PackageDownload() :
+    receivedFragments_(0),
+    fileSize_(0),
     totalFragments_(0),
     checksum_(0),
     initiated_(false)
@@ -81,7 +102,7 @@ Connection::Connection(Context* context) :
     sceneLoaded_(false),
     logStatistics_(false),
     address_(nullptr),
-    packedMessageLimit_(1024)
+    packedMessageLimit_(0)
 {
 }
 
@@ -102,6 +123,7 @@ void Connection::Initialize(bool isClient, const SLNet::AddressOrGUID& address,
     sceneState_.connection_ = this;
     port_ = address.systemAddress.GetPort();
     SetAddressOrGUID(address);
+    UpdatePacketSizeLimit();
 }
 
 void Connection::RegisterObject(Context* context)
@@ -140,7 +162,7 @@ void Connection::SendMessage(int msgID, bool reliable, bool inOrder, const unsig
     PacketType type = GetPacketType(reliable, inOrder);
     VectorBuffer& buffer = outgoingBuffer_[type];
 
-    if (buffer.GetSize() + numBytes >= packedMessageLimit_)
+    if (buffer.GetSize() + numBytes >= (unsigned)packetSizeLimit_)
         SendBuffer(type);
 
     if (buffer.GetSize() == 0)
@@ -149,9 +171,18 @@ void Connection::SendMessage(int msgID, bool reliable, bool inOrder, const unsig
         buffer.WriteUInt((unsigned int)MSG_PACKED_MESSAGE);
     }
 
-    buffer.WriteUInt((unsigned int) msgID);
-    buffer.WriteUInt(numBytes);
+    // Small messages are common, so keep the per-message header compact
+    const unsigned startSize = buffer.GetSize();
+    buffer.WriteVLE((unsigned) msgID);
+    buffer.WriteVLE(numBytes);
     buffer.Write(data, numBytes);
+
+    if (collectStatistics_)
+    {
+        NetworkTrafficStats& stats = messageStats_[msgID];
+        ++stats.count_;
+        stats.bytes_ += buffer.GetSize() - startSize;
+    }
 }
 
 void Connection::SendRemoteEvent(StringHash eventType, bool inOrder, const VariantMap& eventData)
@@ -208,6 +239,7 @@ void Connection::SetScene(Scene* newScene)
     if (isClient_)
     {
         sceneState_.Clear();
+        irrelevantNodes_.clear();
 
         // When scene is assigned on the server, instruct the client to load it. This may require downloading packages
         const ea::vector<SharedPtr<PackageFile> >& packages = scene_->GetRequiredPackageFiles();
@@ -242,6 +274,25 @@ void Connection::SetControls(const Controls& newControls)
     controls_ = newControls;
 }
 
+void Connection::SetBufferControls(bool enable)
+{
+    bufferControls_ = enable;
+    if (!bufferControls_)
+        controlsQueue_.clear();
+}
+
+bool Connection::PopControls(Controls& controls)
+{
+    if (controlsQueue_.empty())
+        return false;
+
+    timeStamp_ = controlsQueue_.front().first;
+    SetControls(controlsQueue_.front().second);
+    controlsQueue_.erase(controlsQueue_.begin());
+    controls = controls_;
+    return true;
+}
+
 void Connection::SetPosition(const Vector3& position)
 {
     position_ = position;
@@ -249,6 +300,11 @@ void Connection::SetPosition(const Vector3& position)
         sendMode_ = OPSM_POSITION;
 }
 
+void Connection::SetInterestDistance(float distance)
+{
+    interestDistance_ = Max(distance, 0.0f);
+}
+
 void Connection::SetRotation(const Quaternion& rotation)
 {
     rotation_ = rotation;
@@ -266,6 +322,19 @@ void Connection::SetLogStatistics(bool enable)
     logStatistics_ = enable;
 }
 
+void Connection::SetCollectStatistics(bool enable)
+{
+    collectStatistics_ = enable;
+}
+
+void Connection::ResetStatistics()
+{
+    messageStats_.clear();
+    replicationStats_.clear();
+    for (unsigned& bucket : rttHistogram_)
+        bucket = 0;
+}
+
 void Connection::Disconnect(int waitMSec)
 {
     peer_->CloseConnection(*address_, true);
@@ -276,6 +345,8 @@ void Connection::SendServerUpdate()
     if (!scene_ || !sceneLoaded_)
         return;
 
+    UpdateRelevancy();
+
     // Always check the root node (scene) first so that the scene-wide components get sent first,
     // and all other replicated nodes get added to the dirty set for sending the initial state
     unsigned sceneID = scene_->GetID();
@@ -293,6 +364,19 @@ void Connection::SendServerUpdate()
     }
 }
 
+void Connection::BuildServerUpdate()
+{
+    HiresTimer buildTimer;
+
+    deferSend_ = true;
+    SendServerUpdate();
+    SendRemoteEvents();
+    SendPackages();
+    deferSend_ = false;
+
+    updateBuildTime_ = buildTimer.GetUSec(false);
+}
+
 void Connection::SendClientUpdate()
 {
     if (!scene_ || !sceneLoaded_)
@@ -303,6 +387,7 @@ void Connection::SendClientUpdate()
     msg_.WriteFloat(controls_.yaw_);
     msg_.WriteFloat(controls_.pitch_);
     msg_.WriteVariantMap(controls_.extraData_);
+    msg_.WriteUInt(controls_.sampleTime_);
     msg_.WriteUByte(timeStamp_);
     if (sendMode_ >= OPSM_POSITION)
         msg_.WriteVector3(position_);
@@ -310,6 +395,11 @@ void Connection::SendClientUpdate()
         msg_.WritePackedQuaternion(rotation_);
     SendMessage(MSG_CONTROLS, false, false, msg_, CONTROLS_CONTENT_ID);
 
+    // Remember sent controls for replaying them on server corrections
+    if (controlsHistory_.size() >= MAX_CONTROLS_HISTORY)
+        controlsHistory_.erase(controlsHistory_.begin());
+    controlsHistory_.emplace_back(timeStamp_, controls_);
+
     ++timeStamp_;
 }
 
@@ -335,6 +425,12 @@ void Connection::SendRemoteEvents()
         packetCounterTimer_.Reset();
         packetCounter_ = tempPacketCounter_;
         tempPacketCounter_ = IntVector2::ZERO;
+
+        if (collectStatistics_)
+        {
+            const auto bucket = (unsigned)(GetRoundTripTime() / RTT_HISTOGRAM_BUCKET_MSEC);
+            ++rttHistogram_[Min(bucket, NUM_RTT_HISTOGRAM_BUCKETS - 1)];
+        }
     }
 
     if (remoteEvents_.empty())
@@ -365,11 +461,15 @@ void Connection::SendRemoteEvents()
 
 void Connection::SendPackages()
 {
-    while (!uploads_.empty())
-    {
-        unsigned char buffer[PACKAGE_FRAGMENT_SIZE];
+    unsigned char buffer[PACKAGE_FRAGMENT_SIZE];
+    // Worst case LZ4 compressed size of a fragment
+    unsigned char compressBuffer[PACKAGE_FRAGMENT_SIZE + PACKAGE_FRAGMENT_SIZE / 255 + 16];
 
-        for (auto i = uploads_.begin(); i != uploads_.end();)
+    // Send a limited number of fragments per update, alternating between uploads so that they progress in parallel
+    unsigned numFragmentsLeft = MAX_PACKAGE_FRAGMENTS_PER_UPDATE;
+    while (!uploads_.empty() && numFragmentsLeft)
+    {
+        for (auto i = uploads_.begin(); i != uploads_.end() && numFragmentsLeft;)
         {
             auto current = i++;
             PackageUpload& upload = current->second;
@@ -379,12 +479,25 @@ void Connection::SendPackages()
 
             msg_.Clear();
             msg_.WriteStringHash(current->first);
-            msg_.WriteUInt(upload.fragment_++);
-            msg_.Write(buffer, fragmentSize);
-            SendMessage(MSG_PACKAGEDATA, true, false, msg_);
+
+            // Package data is often already compressed, so send raw data unless compression actually helps
+            const unsigned compressedSize = fragmentSize ? CompressData(compressBuffer, buffer, fragmentSize) : 0;
+            if (compressedSize && compressedSize < fragmentSize)
+            {
+                msg_.WriteUInt(upload.fragment_++ | PACKAGE_FRAGMENT_COMPRESSED);
+                msg_.Write(compressBuffer, compressedSize);
+            }
+            else
+            {
+                msg_.WriteUInt(upload.fragment_++);
+                msg_.Write(buffer, fragmentSize);
+            }
+            // Fragments are sent in order, so that the client can resume an interrupted download
+            SendMessage(MSG_PACKAGEDATA, true, true, msg_);
+            --numFragmentsLeft;
 
             // Check if upload finished
-            if (upload.fragment_ == upload.totalFragments_)
+            if (upload.fragment_ >= upload.totalFragments_)
                 uploads_.erase(current);
         }
     }
@@ -396,6 +509,16 @@ void Connection::SendBuffer(PacketType type)
     if (buffer.GetSize() == 0)
         return;
 
+    if (deferSend_)
+        deferredPackets_.emplace_back(type, buffer.GetBuffer());
+    else
+        SendPacket(type, buffer.GetData(), buffer.GetSize());
+
+    buffer.Clear();
+}
+
+void Connection::SendPacket(PacketType type, const unsigned char* data, unsigned numBytes)
+{
     PacketReliability reliability = PacketReliability::UNRELIABLE;
     if (type == PT_UNRELIABLE_ORDERED)
         reliability = PacketReliability::UNRELIABLE_SEQUENCED;
@@ -406,21 +529,45 @@ void Connection::SendBuffer(PacketType type)
     if (type == PT_RELIABLE_UNORDERED)
         reliability = PacketReliability::RELIABLE;
 
+    if (bandwidthLimit_)
+    {
+        // Unreliable data is superseded by later updates anyway, so it is what gets dropped when over the limit
+        if (bandwidthBudget_ < 0.0f && (type == PT_UNRELIABLE_UNORDERED || type == PT_UNRELIABLE_ORDERED))
+        {
+            ++numDroppedPackets_;
+            return;
+        }
+        bandwidthBudget_ -= numBytes;
+    }
+
     if (peer_) {
-        peer_->Send((const char *) buffer.GetData(), (int) buffer.GetSize(), HIGH_PRIORITY, reliability, (char) 0,
+        peer_->Send((const char *) data, (int) numBytes, HIGH_PRIORITY, reliability, (char) 0,
                     *address_, false);
         tempPacketCounter_.y_++;
     }
-
-    buffer.Clear();
 }
 
 void Connection::SendAllBuffers()
 {
+    if (bandwidthLimit_)
+    {
+        // Refill the budget, allowing bursts of up to one second worth of data
+        const float elapsed = bandwidthTimer_.GetMSec(true) / 1000.0f;
+        bandwidthBudget_ = Min(bandwidthBudget_ + bandwidthLimit_ * elapsed, (float)bandwidthLimit_);
+    }
+
+    // Packets completed during the update build precede the partially filled buffers
+    for (const auto& packet : deferredPackets_)
+        SendPacket(packet.first, packet.second.data(), packet.second.size());
+    deferredPackets_.clear();
+
     SendBuffer(PT_RELIABLE_ORDERED);
     SendBuffer(PT_RELIABLE_UNORDERED);
     SendBuffer(PT_UNRELIABLE_ORDERED);
     SendBuffer(PT_UNRELIABLE_UNORDERED);
+
+    // The MTU may be renegotiated, refresh the limit for the next update
+    UpdatePacketSizeLimit();
 }
 
 void Connection::ProcessPendingLatestData()
@@ -473,8 +620,13 @@ bool Connection::ProcessMessage(int msgID, MemoryBuffer& buffer)
     }
 
     while (!buffer.IsEof()) {
-        msgID = buffer.ReadUInt();
-        unsigned int packetSize = buffer.ReadUInt();
+        msgID = buffer.ReadVLE();
+        unsigned int packetSize = buffer.ReadVLE();
+        if (packetSize > buffer.GetSize() - buffer.GetPosition())
+        {
+            URHO3D_LOGWARNING("Discarding truncated message from " + ToString());
+            break;
+        }
         MemoryBuffer msg(buffer.GetData() + buffer.GetPosition(), packetSize);
         buffer.Seek(buffer.GetPosition() + packetSize);
 
@@ -821,6 +973,13 @@ void Connection::ProcessPackageDownload(int msgID, MemoryBuffer& msg)
         else
         {
             ea::string name = msg.ReadString();
+            unsigned resumeFragments = 0;
+            unsigned resumeChecksum = 0;
+            if (!msg.IsEof())
+            {
+                resumeFragments = msg.ReadUInt();
+                resumeChecksum = msg.ReadUInt();
+            }
 
             if (!scene_)
             {
@@ -854,11 +1013,26 @@ void Connection::ProcessPackageDownload(int msgID, MemoryBuffer& msg)
                         return;
                     }
 
-                    URHO3D_LOGINFO("Transmitting package file " + name + " to client " + ToString());
+                    const unsigned totalFragments = (file->GetSize() + PACKAGE_FRAGMENT_SIZE - 1) / PACKAGE_FRAGMENT_SIZE;
+
+                    // Resume only if the fragments the client already has match the package
+                    if (resumeFragments >= totalFragments ||
+                        GetFileChecksum(file, resumeFragments * PACKAGE_FRAGMENT_SIZE) != resumeChecksum)
+                        resumeFragments = 0;
+                    file->Seek(resumeFragments * PACKAGE_FRAGMENT_SIZE);
+
+                    if (resumeFragments)
+                    {
+                        URHO3D_LOGINFO("Resuming transmission of package file " + name + " to client " + ToString() + " from fragment " +
+                            ea::to_string(resumeFragments));
+                    }
+                    else
+                        URHO3D_LOGINFO("Transmitting package file " + name + " to client " + ToString());
 
-                    uploads_[nameHash].file_ = file;
-                    uploads_[nameHash].fragment_ = 0;
-                    uploads_[nameHash].totalFragments_ = (file->GetSize() + PACKAGE_FRAGMENT_SIZE - 1) / PACKAGE_FRAGMENT_SIZE;
+                    PackageUpload& upload = uploads_[nameHash];
+                    upload.file_ = file;
+                    upload.fragment_ = resumeFragments;
+                    upload.totalFragments_ = totalFragments;
                     return;
                 }
             }
@@ -895,12 +1069,10 @@ void Connection::ProcessPackageDownload(int msgID, MemoryBuffer& msg)
                 return;
             }
 
-            // If file has not yet been opened, try to open now. Prepend the checksum to the filename to allow multiple versions
+            // If file has not yet been opened, try to open now
             if (!download.file_)
             {
-                download.file_ = new File(context_,
-                    GetSubsystem<Network>()->GetPackageCacheDir() + ToStringHex(download.checksum_) + "_" + download.name_,
-                    FILE_WRITE);
+                download.file_ = new File(context_, GetPackageDownloadFileName(download), FILE_WRITE);
                 if (!download.file_->IsOpen())
                 {
                     OnPackageDownloadFailed(download.name_);
@@ -908,39 +1080,68 @@ void Connection::ProcessPackageDownload(int msgID, MemoryBuffer& msg)
                 }
             }
 
+            unsigned index = msg.ReadUInt();
+            const bool compressed = (index & PACKAGE_FRAGMENT_COMPRESSED) != 0;
+            index &= ~PACKAGE_FRAGMENT_COMPRESSED;
+
+            // The server restarts from the beginning if the partially downloaded fragments did not match
+            if (index == 0)
+                download.receivedFragments_ = 0;
+            if (index != download.receivedFragments_ || index >= download.totalFragments_)
+            {
+                URHO3D_LOGERROR("Received out of order fragment for package " + download.name_);
+                OnPackageDownloadFailed(download.name_);
+                return;
+            }
+
             // Write the fragment data to the proper index
             unsigned char buffer[PACKAGE_FRAGMENT_SIZE];
-            unsigned index = msg.ReadUInt();
-            unsigned fragmentSize = msg.GetSize() - msg.GetPosition();
+            const unsigned fragmentSize = Min(download.fileSize_ - index * PACKAGE_FRAGMENT_SIZE, PACKAGE_FRAGMENT_SIZE);
+            const unsigned dataSize = msg.GetSize() - msg.GetPosition();
+            if (compressed)
+            {
+                if (DecompressData(buffer, msg.GetData() + msg.GetPosition(), fragmentSize) != dataSize)
+                {
+                    URHO3D_LOGERROR("Received corrupt fragment for package " + download.name_);
+                    OnPackageDownloadFailed(download.name_);
+                    return;
+                }
+            }
+            else if (dataSize != fragmentSize || msg.Read(buffer, fragmentSize) != fragmentSize)
+            {
+                URHO3D_LOGERROR("Received corrupt fragment for package " + download.name_);
+                OnPackageDownloadFailed(download.name_);
+                return;
+            }
 
-            msg.Read(buffer, fragmentSize);
             download.file_->Seek(index * PACKAGE_FRAGMENT_SIZE);
             download.file_->Write(buffer, fragmentSize);
-            download.receivedFragments_.insert(index);
+            ++download.receivedFragments_;
 
             // Check if all fragments received
-            if (download.receivedFragments_.size() == download.totalFragments_)
+            if (download.receivedFragments_ == download.totalFragments_)
             {
+                download.file_->Close();
+
+                // Verify the package before using it, as it may have been resumed from an earlier partial download
+                SharedPtr<PackageFile> package(new PackageFile(context_, download.file_->GetName()));
+                if (package->GetTotalSize() != download.fileSize_ || package->GetChecksum() != download.checksum_)
+                {
+                    URHO3D_LOGERROR("Downloaded package " + download.name_ + " does not match the server package");
+                    package.Reset();
+                    GetSubsystem<FileSystem>()->Delete(download.file_->GetName());
+                    OnPackageDownloadFailed(download.name_);
+                    return;
+                }
+
                 URHO3D_LOGINFO("Package " + download.name_ + " downloaded successfully");
 
-                // Instantiate the package and add to the resource system, as we will need it to load the scene
-                download.file_->Close();
-                GetSubsystem<ResourceCache>()->AddPackageFile(download.file_->GetName(), 0);
+                // Add the package to the resource system, as we will need it to load the scene
+                GetSubsystem<ResourceCache>()->AddPackageFile(package, 0);
 
-                // Then start the next download if there are more
                 downloads_.erase(i);
                 if (downloads_.empty())
                     OnPackagesReady();
-                else
-                {
-                    PackageDownload& nextDownload = downloads_.begin()->second;
-
-                    URHO3D_LOGINFO("Requesting package " + nextDownload.name_ + " from server");
-                    msg_.Clear();
-                    msg_.WriteString(nextDownload.name_);
-                    SendMessage(MSG_REQUESTPACKAGE, true, true, msg_);
-                    nextDownload.initiated_ = true;
-                }
             }
         }
         break;
@@ -984,9 +1185,21 @@ void Connection::ProcessControls(int msgID, MemoryBuffer& msg)
     newControls.yaw_ = msg.ReadFloat();
     newControls.pitch_ = msg.ReadFloat();
     newControls.extraData_ = msg.ReadVariantMap();
+    newControls.sampleTime_ = msg.ReadUInt();
 
-    SetControls(newControls);
-    timeStamp_ = msg.ReadUByte();
+    const unsigned char timeStamp = msg.ReadUByte();
+    if (bufferControls_)
+    {
+        // Drop the oldest input rather than the newest if the application does not keep up
+        if (controlsQueue_.size() >= MAX_CONTROLS_QUEUE)
+            controlsQueue_.erase(controlsQueue_.begin());
+        controlsQueue_.emplace_back(timeStamp, ea::move(newControls));
+    }
+    else
+    {
+        SetControls(newControls);
+        timeStamp_ = timeStamp;
+    }
 
     // Client may or may not send observer position & rotation for interest management
     if (!msg.IsEof())
@@ -1043,7 +1256,12 @@ void Connection::ProcessRemoteEvent(int msgID, MemoryBuffer& msg)
             return;
         }
 
-        VariantMap eventData = msg.ReadVariantMap();
+        // Skip parsing the event data if nobody listens
+        if (!HasEventReceivers(eventType))
+            return;
+
+        VariantMap& eventData = GetEventDataMap();
+        msg.ReadVariantMap(eventData);
         eventData[P_CONNECTION] = this;
         SendEvent(eventType, eventData);
     }
@@ -1063,13 +1281,17 @@ void Connection::ProcessRemoteEvent(int msgID, MemoryBuffer& msg)
             return;
         }
 
-        VariantMap eventData = msg.ReadVariantMap();
         Node* sender = scene_->GetNode(nodeID);
         if (!sender)
         {
             URHO3D_LOGWARNING("Missing sender for remote node event, discarding");
             return;
         }
+        if (!sender->HasEventReceivers(eventType))
+            return;
+
+        VariantMap& eventData = GetEventDataMap();
+        msg.ReadVariantMap(eventData);
         eventData[P_CONNECTION] = this;
         sender->SendEvent(eventType, eventData);
     }
@@ -1096,6 +1318,32 @@ float Connection::GetRoundTripTime() const
     return 0.0f;
 }
 
+bool Connection::GetControlsSince(unsigned char timeStamp, ea::vector<Controls>& controls) const
+{
+    controls.clear();
+
+    // Search backwards, as the timestamp wraps around and the newest match is the relevant one
+    for (unsigned i = controlsHistory_.size(); i-- > 0;)
+    {
+        if (controlsHistory_[i].first == timeStamp)
+        {
+            for (unsigned j = i + 1; j < controlsHistory_.size(); ++j)
+                controls.push_back(controlsHistory_[j].second);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+float Connection::GetLagCompensationTime() const
+{
+    // The client sees the server state half a round trip late, plus one update interval of interpolation
+    auto* network = GetSubsystem<Network>();
+    const float updateInterval = network && network->GetUpdateFps() > 0 ? 1.0f / network->GetUpdateFps() : 0.0f;
+    return GetRoundTripTime() * 0.0005f + updateInterval;
+}
+
 unsigned Connection::GetLastHeardTime() const
 {
     return const_cast<Timer&>(lastHeardTimer_).GetMSec(false);
@@ -1160,7 +1408,7 @@ float Connection::GetDownloadProgress() const
         downloads_.end(); ++i)
     {
         if (i->second.initiated_)
-            return (float)i->second.receivedFragments_.size() / (float)i->second.totalFragments_;
+            return (float)i->second.receivedFragments_ / (float)i->second.totalFragments_;
     }
     return 1.0f;
 }
@@ -1198,7 +1446,28 @@ void Connection::ConfigureNetworkSimulator(int latencyMs, float packetLoss)
 
 void Connection::SetPacketSizeLimit(int limit)
 {
-    packedMessageLimit_ = limit;
+    packedMessageLimit_ = Max(limit, 0);
+    UpdatePacketSizeLimit();
+}
+
+void Connection::UpdatePacketSizeLimit()
+{
+    if (packedMessageLimit_)
+    {
+        packetSizeLimit_ = packedMessageLimit_;
+        return;
+    }
+
+    // Leave room for the SLikeNet datagram and message headers, so that packets are not split
+    const int mtu = peer_ && address_ ? peer_->GetMTUSize(address_->systemAddress) : 0;
+    packetSizeLimit_ = mtu > PACKET_HEADER_RESERVE ? mtu - PACKET_HEADER_RESERVE : DEFAULT_PACKET_SIZE_LIMIT;
+}
+
+void Connection::SetBandwidthLimit(int bytesPerSec)
+{
+    bandwidthLimit_ = Max(bytesPerSec, 0);
+    bandwidthBudget_ = (float)bandwidthLimit_;
+    bandwidthTimer_.Reset();
 }
 
 void Connection::HandleAsyncLoadFinished(StringHash eventType, VariantMap& eventData)
@@ -1225,7 +1494,26 @@ void Connection::ProcessNode(unsigned nodeID)
     {
         // Replication state found: the node is either be existing or removed
         Node* node = i->second.node_;
-        if (!node)
+        if (node && !IsNodeRelevant(node))
+        {
+            // Node left the interest distance: remove from the client, but keep tracking it for re-entering
+            MutexLock<Mutex> lock(replicationStateMutex);
+            NodeReplicationState& nodeState = i->second;
+            for (auto& componentState : nodeState.componentStates_)
+            {
+                if (componentState.second.component_)
+                    componentState.second.component_->RemoveReplicationState(&componentState.second);
+            }
+            node->RemoveReplicationState(&nodeState);
+
+            msg_.Clear();
+            msg_.WriteNetID(nodeID);
+            SendMessage(MSG_REMOVENODE, true, true, msg_);
+            sceneState_.nodeStates_.erase(i);
+            sceneState_.dirtyNodes_.erase(nodeID);
+            irrelevantNodes_.insert(nodeID);
+        }
+        else if (!node)
         {
             msg_.Clear();
             msg_.WriteNetID(nodeID);
@@ -1234,6 +1522,8 @@ void Connection::ProcessNode(unsigned nodeID)
             // would be enough. However, this may be better due to the client not possibly having updated parenting
             // information at the time of receiving this message
             SendMessage(MSG_REMOVENODE, true, true, msg_);
+
+            MutexLock<Mutex> lock(replicationStateMutex);
             sceneState_.nodeStates_.erase(nodeID);
         }
         else
@@ -1243,7 +1533,13 @@ void Connection::ProcessNode(unsigned nodeID)
     {
         // Replication state not found: this is a new node
         Node* node = scene_->GetNode(nodeID);
-        if (node)
+        if (node && !IsNodeRelevant(node))
+        {
+            // Do not create the node on the client until it enters the interest distance
+            sceneState_.dirtyNodes_.erase(nodeID);
+            irrelevantNodes_.insert(nodeID);
+        }
+        else if (node)
             ProcessNewNode(node);
         else
         {
@@ -1268,10 +1564,13 @@ void Connection::ProcessNewNode(Node* node)
     msg_.WriteNetID(node->GetID());
 
     NodeReplicationState& nodeState = sceneState_.nodeStates_[node->GetID()];
-    nodeState.connection_ = this;
-    nodeState.sceneState_ = &sceneState_;
-    nodeState.node_ = node;
-    node->AddReplicationState(&nodeState);
+    {
+        MutexLock<Mutex> lock(replicationStateMutex);
+        nodeState.connection_ = this;
+        nodeState.sceneState_ = &sceneState_;
+        nodeState.node_ = node;
+        node->AddReplicationState(&nodeState);
+    }
 
     // Write node's attributes
     node->WriteInitialDeltaUpdate(msg_, timeStamp_);
@@ -1285,6 +1584,8 @@ void Connection::ProcessNewNode(Node* node)
         msg_.WriteVariant(i->second);
     }
 
+    unsigned componentBytes = 0;
+
     // Write node's components
     msg_.WriteVLE(node->GetNumNetworkComponents());
     const ea::vector<SharedPtr<Component> >& components = node->GetComponents();
@@ -1296,22 +1597,112 @@ void Connection::ProcessNewNode(Node* node)
             continue;
 
         ComponentReplicationState& componentState = nodeState.componentStates_[component->GetID()];
-        componentState.connection_ = this;
-        componentState.nodeState_ = &nodeState;
-        componentState.component_ = component;
-        component->AddReplicationState(&componentState);
+        {
+            MutexLock<Mutex> lock(replicationStateMutex);
+            componentState.connection_ = this;
+            componentState.nodeState_ = &nodeState;
+            componentState.component_ = component;
+            component->AddReplicationState(&componentState);
+        }
 
+        const unsigned startSize = msg_.GetSize();
         msg_.WriteStringHash(component->GetType());
         msg_.WriteNetID(component->GetID());
         component->WriteInitialDeltaUpdate(msg_, timeStamp_);
+
+        if (collectStatistics_)
+        {
+            const unsigned numBytes = msg_.GetSize() - startSize;
+            AddReplicationStatistics(component->GetType(), numBytes, component->GetNetworkAttributes(), nullptr, AM_NET);
+            componentBytes += numBytes;
+        }
     }
 
+    if (collectStatistics_)
+        AddReplicationStatistics(node->GetType(), msg_.GetSize() - componentBytes, node->GetNetworkAttributes(), nullptr, AM_NET);
+
     SendMessage(MSG_CREATENODE, true, true, msg_);
 
     nodeState.markedDirty_ = false;
     sceneState_.dirtyNodes_.erase(node->GetID());
 }
 
+void Connection::AddReplicationStatistics(StringHash type, unsigned numBytes, const ea::vector<AttributeInfo>* attributes,
+    const DirtyBits* dirtyAttributes, AttributeMode mode)
+{
+    NetworkTrafficStats& stats = replicationStats_[type];
+    ++stats.count_;
+    stats.bytes_ += numBytes;
+
+    if (!attributes)
+        return;
+    if (stats.attributeUpdates_.size() < attributes->size())
+        stats.attributeUpdates_.resize(attributes->size());
+    for (unsigned i = 0; i < attributes->size(); ++i)
+    {
+        if (dirtyAttributes ? dirtyAttributes->IsSet(i) : (attributes->at(i).mode_ & mode) == mode)
+            ++stats.attributeUpdates_[i];
+    }
+}
+
+bool Connection::IsNodeRelevant(Node* node) const
+{
+    if (interestDistance_ <= 0.0f || node == scene_ || node->GetOwner() == this)
+        return true;
+
+    // Whole top-level hierarchies enter and leave relevance together, so that parents always exist on the client
+    Node* root = node;
+    while (root->GetParent() && root->GetParent() != scene_)
+        root = root->GetParent();
+    if (root->GetOwner() == this)
+        return true;
+
+    return (root->GetWorldPosition() - position_).LengthSquared() <= interestDistance_ * interestDistance_;
+}
+
+void Connection::UpdateRelevancy()
+{
+    if (interestDistance_ <= 0.0f)
+    {
+        // Interest management was disabled: send everything held back
+        if (!irrelevantNodes_.empty())
+        {
+            sceneState_.dirtyNodes_.insert(irrelevantNodes_.begin(), irrelevantNodes_.end());
+            irrelevantNodes_.clear();
+        }
+        return;
+    }
+
+    if (++relevancyUpdateCounter_ < RELEVANCY_UPDATE_INTERVAL)
+        return;
+    relevancyUpdateCounter_ = 0;
+
+    URHO3D_PROFILE("UpdateRelevancy");
+
+    // Nodes entering relevance are processed as new nodes
+    for (auto i = irrelevantNodes_.begin(); i != irrelevantNodes_.end();)
+    {
+        Node* node = scene_->GetNode(*i);
+        if (!node)
+            i = irrelevantNodes_.erase(i);
+        else if (IsNodeRelevant(node))
+        {
+            sceneState_.dirtyNodes_.insert(*i);
+            i = irrelevantNodes_.erase(i);
+        }
+        else
+            ++i;
+    }
+
+    // Static nodes leaving relevance are not dirtied otherwise, so check all replicated nodes
+    for (auto& item : sceneState_.nodeStates_)
+    {
+        Node* node = item.second.node_;
+        if (node && !IsNodeRelevant(node))
+            sceneState_.dirtyNodes_.insert(item.first);
+    }
+}
+
 void Connection::ProcessExistingNode(Node* node, NodeReplicationState& nodeState)
 {
     // Process depended upon nodes first, if they are dirty
@@ -1355,6 +1746,8 @@ void Connection::ProcessExistingNode(Node* node, NodeReplicationState& nodeState
             msg_.Clear();
             msg_.WriteNetID(node->GetID());
             node->WriteLatestDataUpdate(msg_, timeStamp_);
+            if (collectStatistics_)
+                AddReplicationStatistics(node->GetType(), msg_.GetSize(), attributes, nullptr, AM_LATESTDATA);
 
             SendMessage(MSG_NODELATESTDATA, true, false, msg_, node->GetID());
         }
@@ -1386,6 +1779,9 @@ void Connection::ProcessExistingNode(Node* node, NodeReplicationState& nodeState
                 }
             }
 
+            if (collectStatistics_)
+                AddReplicationStatistics(node->GetType(), msg_.GetSize(), attributes, &nodeState.dirtyAttributes_, AM_NET);
+
             SendMessage(MSG_NODEDELTAUPDATE, true, true, msg_);
 
             nodeState.dirtyAttributes_.ClearAll();
@@ -1407,6 +1803,8 @@ void Connection::ProcessExistingNode(Node* node, NodeReplicationState& nodeState
             msg_.WriteNetID(current->first);
 
             SendMessage(MSG_REMOVECOMPONENT, true, true, msg_);
+
+            MutexLock<Mutex> lock(replicationStateMutex);
             nodeState.componentStates_.erase(current);
         }
         else
@@ -1433,6 +1831,8 @@ void Connection::ProcessExistingNode(Node* node, NodeReplicationState& nodeState
                     msg_.Clear();
                     msg_.WriteNetID(component->GetID());
                     component->WriteLatestDataUpdate(msg_, timeStamp_);
+                    if (collectStatistics_)
+                        AddReplicationStatistics(component->GetType(), msg_.GetSize(), attributes, nullptr, AM_LATESTDATA);
 
                     SendMessage(MSG_COMPONENTLATESTDATA, true, false, msg_, component->GetID());
                 }
@@ -1443,6 +1843,11 @@ void Connection::ProcessExistingNode(Node* node, NodeReplicationState& nodeState
                     msg_.Clear();
                     msg_.WriteNetID(component->GetID());
                     component->WriteDeltaUpdate(msg_, componentState.dirtyAttributes_, timeStamp_);
+                    if (collectStatistics_)
+                    {
+                        AddReplicationStatistics(component->GetType(), msg_.GetSize(), attributes,
+                            &componentState.dirtyAttributes_, AM_NET);
+                    }
 
                     SendMessage(MSG_COMPONENTDELTAUPDATE, true, true, msg_);
 
@@ -1469,10 +1874,13 @@ void Connection::ProcessExistingNode(Node* node, NodeReplicationState& nodeState
             {
                 // New component
                 ComponentReplicationState& componentState = nodeState.componentStates_[component->GetID()];
-                componentState.connection_ = this;
-                componentState.nodeState_ = &nodeState;
-                componentState.component_ = component;
-                component->AddReplicationState(&componentState);
+                {
+                    MutexLock<Mutex> lock(replicationStateMutex);
+                    componentState.connection_ = this;
+                    componentState.nodeState_ = &nodeState;
+                    componentState.component_ = component;
+                    component->AddReplicationState(&componentState);
+                }
 
                 msg_.Clear();
                 msg_.WriteNetID(node->GetID());
@@ -1568,25 +1976,70 @@ void Connection::RequestPackage(const ea::string& name, unsigned fileSize, unsig
 
     PackageDownload& download = downloads_[nameHash];
     download.name_ = name;
+    download.fileSize_ = fileSize;
     download.totalFragments_ = (fileSize + PACKAGE_FRAGMENT_SIZE - 1) / PACKAGE_FRAGMENT_SIZE;
     download.checksum_ = checksum;
 
-    // Start download now only if no existing downloads, else wait for the existing ones to finish
-    if (downloads_.size() == 1)
+    // Resume a partial download of the same package version left in the download cache
+    unsigned resumeChecksum = 0;
+    const ea::string fileName = GetPackageDownloadFileName(download);
+    if (GetSubsystem<FileSystem>()->FileExists(fileName))
+    {
+        SharedPtr<File> file(new File(context_, fileName, FILE_READWRITE));
+        if (file->IsOpen() && file->GetSize() < fileSize)
+        {
+            download.receivedFragments_ = file->GetSize() / PACKAGE_FRAGMENT_SIZE;
+            resumeChecksum = GetFileChecksum(file, download.receivedFragments_ * PACKAGE_FRAGMENT_SIZE);
+            download.file_ = file;
+        }
+    }
+
+    // Downloads are requested all at once, the server interleaves their data
+    if (download.receivedFragments_)
     {
+        URHO3D_LOGINFO("Resuming package " + name + " download from server at fragment " +
+            ea::to_string(download.receivedFragments_));
+    }
+    else
         URHO3D_LOGINFO("Requesting package " + name + " from server");
-        msg_.Clear();
-        msg_.WriteString(name);
-        SendMessage(MSG_REQUESTPACKAGE, true, true, msg_);
-        download.initiated_ = true;
+    msg_.Clear();
+    msg_.WriteString(name);
+    msg_.WriteUInt(download.receivedFragments_);
+    msg_.WriteUInt(resumeChecksum);
+    SendMessage(MSG_REQUESTPACKAGE, true, true, msg_);
+    download.initiated_ = true;
+}
+
+ea::string Connection::GetPackageDownloadFileName(const PackageDownload& download) const
+{
+    // Prepend the checksum to the filename to allow multiple versions
+    return GetSubsystem<Network>()->GetPackageCacheDir() + ToStringHex(download.checksum_) + "_" + download.name_;
+}
+
+unsigned Connection::GetFileChecksum(File* file, unsigned size)
+{
+    unsigned char buffer[PACKAGE_FRAGMENT_SIZE];
+    unsigned checksum = 0;
+
+    file->Seek(0);
+    while (size)
+    {
+        const unsigned numBytes = file->Read(buffer, Min(size, PACKAGE_FRAGMENT_SIZE));
+        if (!numBytes)
+            break;
+        for (unsigned i = 0; i < numBytes; ++i)
+            checksum = SDBMHash(checksum, buffer[i]);
+        size -= numBytes;
     }
+
+    return checksum;
 }
 
 void Connection::SendPackageError(const ea::string& name)
 {
     msg_.Clear();
     msg_.WriteStringHash(name);
-    SendMessage(MSG_PACKAGEDATA, true, false, msg_);
+    SendMessage(MSG_PACKAGEDATA, true, true, msg_);
 }
 
 void Connection::OnSceneLoadFailed()
@@ -1661,7 +2114,16 @@ void Connection::ProcessPackageInfo(int msgID, MemoryBuffer& msg)
 
 void Connection::ProcessUnknownMessage(int msgID, MemoryBuffer& msg)
 {
-    // If message was not handled internally, forward as an event
+    // If message was not handled internally, pass to the registered handler or forward as an event
+    if (const NetworkMessageHandler* handler = GetSubsystem<Network>()->GetMessageHandler(msgID))
+    {
+        (*handler)(this, msg);
+        return;
+    }
+
+    if (!HasEventReceivers(E_NETWORKMESSAGE))
+        return;
+
     using namespace NetworkMessage;
 
     VariantMap& eventData = GetEventDataMap();
@@ -73,10 +73,12 @@ struct PackageDownload
 
     /// Destination file.
     SharedPtr<File> file_;
-    /// Already received fragments.
-    ea::hash_set<unsigned> receivedFragments_;
+    /// Number of fragments already received. Fragments are received in order.
+    unsigned receivedFragments_;
     /// Package name.
     ea::string name_;
+    /// Package file size.
+    unsigned fileSize_;
     /// Total number of fragments.
     unsigned totalFragments_;
     /// Checksum.
@@ -99,6 +101,22 @@ struct PackageUpload
     unsigned totalFragments_;
 };
 
+/// Accumulated outgoing traffic of one network message ID or replicated object type.
+struct NetworkTrafficStats
+{
+    /// Number of messages sent.
+    unsigned count_{};
+    /// Total bytes sent, including the packed message headers.
+    unsigned long long bytes_{};
+    /// Number of times each network attribute was sent, by attribute index. Only used for replicated object types.
+    ea::vector<unsigned> attributeUpdates_;
+};
+
+/// Number of round trip time histogram buckets. The last bucket also collects all longer round trips.
+static const unsigned NUM_RTT_HISTOGRAM_BUCKETS = 16;
+/// Width of a round trip time histogram bucket in milliseconds.
+static const unsigned RTT_HISTOGRAM_BUCKET_MSEC = 20;
+
 /// Send modes for observer position/rotation. Activated by the client setting either position or rotation.
 enum ObserverPositionSendMode
 {
@@ -112,7 +130,8 @@ enum PacketType {
     PT_UNRELIABLE_UNORDERED,
     PT_UNRELIABLE_ORDERED,
     PT_RELIABLE_UNORDERED,
-    PT_RELIABLE_ORDERED
+    PT_RELIABLE_ORDERED,
+    MAX_PACKET_TYPES
 };
 
 /// %Connection to a remote network host.
@@ -148,12 +167,20 @@ public:
     void SetIdentity(const VariantMap& identity);
     /// Set new controls.
     void SetControls(const Controls& newControls);
+    /// Set whether controls received from the client are queued for PopControls() instead of replacing the current controls immediately. When enabled, the timestamp sent back to the client is that of the last consumed controls, so that client-side prediction replays only unprocessed input. Used on the server only.
+    /// @property
+    void SetBufferControls(bool enable);
+    /// Consume the oldest queued controls received from the client, making them the current controls. Return false if none are queued.
+    bool PopControls(Controls& controls);
     /// Set the observer position for interest management, to be sent to the server.
     /// @property
     void SetPosition(const Vector3& position);
     /// Set the observer rotation for interest management, to be sent to the server. Note: not used by the NetworkPriority component.
     /// @property
     void SetRotation(const Quaternion& rotation);
+    /// Set the distance from the observer position beyond which nodes are not replicated to this connection. Nodes are created and removed on the client as they enter and leave this distance. Zero (default) replicates all nodes.
+    /// @property
+    void SetInterestDistance(float distance);
     /// Set the connection pending status. Called by Network.
     void SetConnectPending(bool connectPending);
     /// Set whether to log data in/out statistics.
@@ -169,6 +196,8 @@ public:
     void SendRemoteEvents();
     /// Send package files to client. Called by network.
     void SendPackages();
+    /// Build scene update, remote event and package messages without sending any packets. Packets are queued until SendAllBuffers(). Called by Network, possibly from a worker thread.
+    void BuildServerUpdate();
     /// Send out buffered messages by their type
     void SendBuffer(PacketType type);
     /// Send out all buffered messages
@@ -196,6 +225,21 @@ public:
     /// Return the controls timestamp, sent from client to server along each control update.
     unsigned char GetTimeStamp() const { return timeStamp_; }
 
+    /// Return whether received controls are queued.
+    /// @property
+    bool GetBufferControls() const { return bufferControls_; }
+
+    /// Return number of queued controls received from the client.
+    /// @property
+    unsigned GetNumBufferedControls() const { return controlsQueue_.size(); }
+
+    /// Return controls sent to the server after the one with the given timestamp, oldest first. The timestamp is the one received along server attribute updates, for example in E_INTERCEPTNETWORKUPDATE. Used on the client to replay unacknowledged input after a server correction. Return false if the timestamp is no longer in the history.
+    bool GetControlsSince(unsigned char timeStamp, ea::vector<Controls>& controls) const;
+
+    /// Return how far in the past, in seconds, the client sees the server scene. Used on the server for lag compensation, see TransformHistory.
+    /// @property
+    float GetLagCompensationTime() const;
+
     /// Return the observer position sent by the client for interest management.
     /// @property
     const Vector3& GetPosition() const { return position_; }
@@ -204,6 +248,10 @@ public:
     /// @property
     const Quaternion& GetRotation() const { return rotation_; }
 
+    /// Return the interest management distance.
+    /// @property
+    float GetInterestDistance() const { return interestDistance_; }
+
     /// Return whether is a client connection.
     /// @property
     bool IsClient() const { return isClient_; }
@@ -256,6 +304,27 @@ public:
     /// @property
     int GetPacketsOutPerSec() const;
 
+    /// Return time in microseconds spent building the last server update for this connection.
+    /// @property
+    long long GetUpdateBuildTime() const { return updateBuildTime_; }
+
+    /// Set whether to collect detailed traffic statistics: bytes per message ID and per replicated node or component type, and a round trip time histogram.
+    /// @property
+    void SetCollectStatistics(bool enable);
+    /// Clear collected traffic statistics.
+    void ResetStatistics();
+    /// Return whether detailed traffic statistics are collected.
+    /// @property
+    bool GetCollectStatistics() const { return collectStatistics_; }
+    /// Return outgoing traffic by message ID.
+    /// @nobind
+    const ea::unordered_map<int, NetworkTrafficStats>& GetMessageStatistics() const { return messageStats_; }
+    /// Return outgoing replication traffic by node or component type.
+    /// @nobind
+    const ea::unordered_map<StringHash, NetworkTrafficStats>& GetReplicationStatistics() const { return replicationStats_; }
+    /// Return number of round trip time samples in a histogram bucket. Sampled once per second while statistics are collected.
+    unsigned GetRoundTripTimeHistogram(unsigned bucket) const { return bucket < NUM_RTT_HISTOGRAM_BUCKETS ? rttHistogram_[bucket] : 0; }
+
     /// Return an address:port string.
     ea::string ToString() const;
     /// Return number of package downloads remaining.
@@ -272,8 +341,21 @@ public:
 
     /// Set network simulation parameters. Called by Network.
     void ConfigureNetworkSimulator(int latencyMs, float packetLoss);
-    /// Buffered packet size limit, when reached, packet is sent out immediately
+    /// Buffered packet size limit, when reached, packet is sent out immediately. Zero (default) derives the limit from the connection MTU, so that packets are not split.
     void SetPacketSizeLimit(int limit);
+    /// Set outgoing bandwidth limit in bytes per second. When exceeded, unreliable packets are dropped while reliable ones are still sent. Zero (default) disables.
+    /// @property
+    void SetBandwidthLimit(int bytesPerSec);
+
+    /// Return effective buffered packet size limit.
+    /// @property
+    int GetPacketSizeLimit() const { return packetSizeLimit_; }
+    /// Return outgoing bandwidth limit in bytes per second.
+    /// @property
+    int GetBandwidthLimit() const { return bandwidthLimit_; }
+    /// Return number of unreliable packets dropped due to the bandwidth limit.
+    /// @property
+    unsigned GetNumDroppedPackets() const { return numDroppedPackets_; }
 
     /// Current controls.
     Controls controls_;
@@ -305,8 +387,19 @@ private:
     void ProcessNode(unsigned nodeID);
     /// Process a node that the client has not yet received.
     void ProcessNewNode(Node* node);
+    /// Update the effective packet size limit.
+    void UpdatePacketSizeLimit();
+    /// Send a packet to the remote host.
+    void SendPacket(PacketType type, const unsigned char* data, unsigned numBytes);
     /// Process a node that the client has already received.
     void ProcessExistingNode(Node* node, NodeReplicationState& nodeState);
+    /// Add a sent replication message to the statistics of a node or component type. Dirty attributes are null when all attributes of the given mode were sent.
+    void AddReplicationStatistics(StringHash type, unsigned numBytes, const ea::vector<AttributeInfo>* attributes,
+        const DirtyBits* dirtyAttributes, AttributeMode mode);
+    /// Return whether a node is within the interest distance.
+    bool IsNodeRelevant(Node* node) const;
+    /// Periodically re-evaluate relevancy of all nodes, marking those that enter or leave the interest distance dirty.
+    void UpdateRelevancy();
     /// Process a SyncPackagesInfo message from server.
     void ProcessPackageInfo(int msgID, MemoryBuffer& msg);
     /// Process unknown message. All unknown messages are forwarded as an events
@@ -315,6 +408,10 @@ private:
     bool RequestNeededPackages(unsigned numPackages, MemoryBuffer& msg);
     /// Initiate a package download.
     void RequestPackage(const ea::string& name, unsigned fileSize, unsigned checksum);
+    /// Return the download cache file name for a package download.
+    ea::string GetPackageDownloadFileName(const PackageDownload& download) const;
+    /// Return checksum of the first bytes of a file, for verifying partially downloaded packages.
+    static unsigned GetFileChecksum(File* file, unsigned size);
     /// Send an error reply for a package download.
     void SendPackageError(const ea::string& name);
     /// Handle scene load failure on the server or client.
@@ -338,6 +435,12 @@ private:
     ea::unordered_map<unsigned, ea::vector<unsigned char> > componentLatestData_;
     /// Node ID's to process during a replication update.
     ea::hash_set<unsigned> nodesToProcess_;
+    /// Node ID's outside the interest distance, not replicated to the client.
+    ea::hash_set<unsigned> irrelevantNodes_;
+    /// Interest management distance. Zero disables.
+    float interestDistance_{};
+    /// Replication updates since the last relevancy re-evaluation.
+    unsigned relevancyUpdateCounter_{};
     /// Reusable message buffer.
     VectorBuffer msg_;
     /// Queued remote events.
@@ -374,10 +477,40 @@ private:
     Timer packetCounterTimer_;
     /// Last heard timer, resets when new packet is incoming.
     Timer lastHeardTimer_;
-    /// Outgoing packet buffer which can contain multiple messages
-    ea::unordered_map<int, VectorBuffer> outgoingBuffer_;
-    /// Outgoing packet size limit
+    /// Outgoing packet buffers by type which can contain multiple messages
+    VectorBuffer outgoingBuffer_[MAX_PACKET_TYPES];
+    /// Outgoing packet size limit set by the user, or zero to derive from MTU.
     int packedMessageLimit_;
+    /// Effective outgoing packet size limit.
+    int packetSizeLimit_{1024};
+    /// Outgoing bandwidth limit in bytes per second.
+    int bandwidthLimit_{};
+    /// Bytes that may still be sent within the bandwidth limit.
+    float bandwidthBudget_{};
+    /// Bandwidth budget refill timer.
+    Timer bandwidthTimer_;
+    /// Number of packets dropped due to the bandwidth limit.
+    unsigned numDroppedPackets_{};
+    /// Packets completed while building the server update, sent from the main thread by SendAllBuffers().
+    ea::vector<ea::pair<PacketType, ByteVector> > deferredPackets_;
+    /// Whether completed packets are deferred instead of sent.
+    bool deferSend_{};
+    /// Time in microseconds spent building the last server update.
+    long long updateBuildTime_{};
+    /// Controls sent to the server with their timestamps, oldest first. Used on the client for prediction replay.
+    ea::vector<ea::pair<unsigned char, Controls> > controlsHistory_;
+    /// Controls received from the client with their timestamps, oldest first. Used on the server when controls are buffered.
+    ea::vector<ea::pair<unsigned char, Controls> > controlsQueue_;
+    /// Whether received controls are queued.
+    bool bufferControls_{};
+    /// Whether detailed traffic statistics are collected.
+    bool collectStatistics_{};
+    /// Outgoing traffic by message ID.
+    ea::unordered_map<int, NetworkTrafficStats> messageStats_;
+    /// Outgoing replication traffic by node or component type.
+    ea::unordered_map<StringHash, NetworkTrafficStats> replicationStats_;
+    /// Round trip time histogram.
+    unsigned rttHistogram_[NUM_RTT_HISTOGRAM_BUCKETS]{};
 };
 
 }
@@ -0,0 +1,258 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Profiler.h"
+#include "../Core/Thread.h"
+#include "../Core/Timer.h"
+#include "../IO/Log.h"
+#include "../Network/HttpClient.h"
+#include "../Network/HttpRequest.h"
+
+#include <Civetweb/civetweb.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+/// Time in milliseconds after which an idle connection is closed instead of reused, as servers drop idle connections on their own.
+static const unsigned IDLE_CONNECTION_TIMEOUT = 10000;
+
+/// HTTP client worker thread.
+class HttpClientWorker : public Thread, public RefCounted
+{
+public:
+    /// Construct.
+    explicit HttpClientWorker(HttpClient* owner) :
+        Thread("HttpClientWorker"),
+        owner_(owner)
+    {
+    }
+
+    /// Execute requests until stopped.
+    void ThreadFunction() override
+    {
+        URHO3D_PROFILE_THREAD("HttpClient Thread");
+        owner_->ProcessRequests();
+    }
+
+private:
+    /// HTTP client.
+    HttpClient* owner_;
+};
+
+static ea::string GetConnectionKey(const ea::string& host, int port, bool useSsl)
+{
+    return Format("{}://{}:{}", useSsl ? "https" : "http", host, port);
+}
+
+HttpClient::HttpClient(unsigned numWorkers, unsigned maxIdleConnections) :
+    maxIdleConnections_(maxIdleConnections)
+{
+#ifdef URHO3D_SSL
+    static bool sslInitialized = false;
+    if (!sslInitialized)
+    {
+        mg_init_library(MG_FEATURES_TLS);
+        sslInitialized = true;
+    }
+#endif
+
+#ifdef URHO3D_THREADING
+    for (unsigned i = 0; i < Max(numWorkers, 1u); ++i)
+    {
+        SharedPtr<HttpClientWorker> worker(new HttpClientWorker(this));
+        if (worker->Run())
+            workers_.push_back(worker);
+    }
+#endif
+}
+
+HttpClient::~HttpClient()
+{
+    ea::deque<SharedPtr<HttpRequest>> queue;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        queue.swap(queue_);
+    }
+    queueCondition_.notify_all();
+
+    for (HttpRequest* request : queue)
+        request->Cancel("HTTP client was destroyed");
+
+    for (HttpClientWorker* worker : workers_)
+        worker->Stop();
+    workers_.clear();
+
+    for (IdleConnection& idleConnection : idleConnections_)
+        mg_close_connection(idleConnection.connection_);
+    idleConnections_.clear();
+}
+
+void HttpClient::EnqueueRequest(HttpRequest* request)
+{
+    if (!request)
+        return;
+
+    if (workers_.empty())
+    {
+        URHO3D_LOGERROR("HTTP request will not execute as threading is disabled");
+        request->Cancel("Threading is disabled");
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(SharedPtr<HttpRequest>(request));
+    }
+    queueCondition_.notify_one();
+}
+
+void HttpClient::SetMaxIdleConnections(unsigned count)
+{
+    ea::vector<mg_connection*> closedConnections;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        maxIdleConnections_ = count;
+        while (idleConnections_.size() > maxIdleConnections_)
+        {
+            closedConnections.push_back(idleConnections_.front().connection_);
+            idleConnections_.erase(idleConnections_.begin());
+        }
+    }
+
+    for (mg_connection* connection : closedConnections)
+        mg_close_connection(connection);
+}
+
+unsigned HttpClient::GetMaxIdleConnections() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return maxIdleConnections_;
+}
+
+unsigned HttpClient::GetNumIdleConnections() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return idleConnections_.size();
+}
+
+unsigned HttpClient::GetNumQueuedRequests() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+void HttpClient::ProcessRequests()
+{
+    for (;;)
+    {
+        SharedPtr<HttpRequest> request;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            queueCondition_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (stopping_)
+                return;
+
+            request = queue_.front();
+            queue_.pop_front();
+        }
+
+        // Skip requests nobody is waiting for anymore
+        if (request->Refs() > 1)
+            request->Execute(this);
+    }
+}
+
+mg_connection* HttpClient::AcquireConnection(const ea::string& host, int port, bool useSsl, bool allowReuse, bool& reused,
+    char* errorBuffer, unsigned errorBufferSize)
+{
+    reused = false;
+    if (allowReuse)
+    {
+        const ea::string key = GetConnectionKey(host, port, useSsl);
+        const unsigned now = Time::GetSystemTime();
+        mg_connection* connection = nullptr;
+        ea::vector<mg_connection*> expiredConnections;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto i = idleConnections_.begin(); i != idleConnections_.end();)
+            {
+                if (now - i->idleSince_ > IDLE_CONNECTION_TIMEOUT)
+                {
+                    expiredConnections.push_back(i->connection_);
+                    i = idleConnections_.erase(i);
+                }
+                else if (!connection && i->key_ == key)
+                {
+                    connection = i->connection_;
+                    i = idleConnections_.erase(i);
+                }
+                else
+                    ++i;
+            }
+        }
+
+        for (mg_connection* expiredConnection : expiredConnections)
+            mg_close_connection(expiredConnection);
+
+        if (connection)
+        {
+            reused = true;
+            return connection;
+        }
+    }
+
+    // Opening the connection may block due to DNS query
+    return mg_connect_client(host.c_str(), port, useSsl ? 1 : 0, errorBuffer, errorBufferSize);
+}
+
+void HttpClient::ReleaseConnection(const ea::string& host, int port, bool useSsl, mg_connection* connection, bool keepAlive)
+{
+    if (!connection)
+        return;
+
+    mg_connection* closedConnection = connection;
+    if (keepAlive && !stopping_)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (maxIdleConnections_ > 0)
+        {
+            closedConnection = nullptr;
+            if (idleConnections_.size() >= maxIdleConnections_)
+            {
+                closedConnection = idleConnections_.front().connection_;
+                idleConnections_.erase(idleConnections_.begin());
+            }
+            idleConnections_.push_back(IdleConnection{GetConnectionKey(host, port, useSsl), connection, Time::GetSystemTime()});
+        }
+    }
+
+    if (closedConnection)
+        mg_close_connection(closedConnection);
+}
+
+}
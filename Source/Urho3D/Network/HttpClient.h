@@ -0,0 +1,109 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+/// \file
+
+#pragma once
+
+#include "../Container/Ptr.h"
+#include "../Container/RefCounted.h"
+
+#include <EASTL/deque.h>
+#include <EASTL/vector.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+struct mg_connection;
+
+namespace Urho3D
+{
+
+class HttpClientWorker;
+class HttpRequest;
+
+/// Shared HTTP client. Executes requests on a bounded pool of worker threads and keeps idle connections alive for reuse.
+class URHO3D_API HttpClient : public RefCounted
+{
+    friend class HttpClientWorker;
+    friend class HttpRequest;
+
+public:
+    /// Construct and start the worker threads.
+    HttpClient(unsigned numWorkers, unsigned maxIdleConnections);
+    /// Destruct. Cancel queued requests, stop the worker threads and close idle connections.
+    ~HttpClient() override;
+
+    /// Queue a request for execution on a worker thread.
+    void EnqueueRequest(HttpRequest* request);
+    /// Set maximum number of idle connections kept alive for reuse. Zero disables connection reuse.
+    void SetMaxIdleConnections(unsigned count);
+
+    /// Return number of worker threads.
+    unsigned GetNumWorkers() const { return workers_.size(); }
+    /// Return maximum number of idle connections kept alive for reuse.
+    unsigned GetMaxIdleConnections() const;
+    /// Return number of idle connections currently kept alive.
+    unsigned GetNumIdleConnections() const;
+    /// Return number of requests waiting for a free worker.
+    unsigned GetNumQueuedRequests() const;
+
+private:
+    /// Idle keep-alive connection.
+    struct IdleConnection
+    {
+        /// Host, port and protocol of the connection.
+        ea::string key_;
+        /// Connection object.
+        mg_connection* connection_{};
+        /// System time when the connection became idle.
+        unsigned idleSince_{};
+    };
+
+    /// Execute queued requests until stopped. Called from the worker threads.
+    void ProcessRequests();
+    /// Take an idle connection to the host if allowed and available, or open a new one. Called from the worker threads.
+    mg_connection* AcquireConnection(const ea::string& host, int port, bool useSsl, bool allowReuse, bool& reused, char* errorBuffer, unsigned errorBufferSize);
+    /// Return a connection after a request. Kept alive for reuse if possible, closed otherwise. Called from the worker threads.
+    void ReleaseConnection(const ea::string& host, int port, bool useSsl, mg_connection* connection, bool keepAlive);
+    /// Return whether the client is shutting down.
+    bool IsStopping() const { return stopping_; }
+
+    /// Worker threads.
+    ea::vector<SharedPtr<HttpClientWorker>> workers_;
+    /// Requests waiting for a free worker.
+    ea::deque<SharedPtr<HttpRequest>> queue_;
+    /// Idle connections, oldest first.
+    ea::vector<IdleConnection> idleConnections_;
+    /// Maximum number of idle connections.
+    unsigned maxIdleConnections_;
+    /// Mutex for the queue and the idle connections.
+    mutable std::mutex mutex_;
+    /// Condition signaled when a request is queued or the client is shutting down.
+    std::condition_variable queueCondition_;
+    /// Shutdown flag.
+    std::atomic<bool> stopping_{};
+};
+
+}
@@ -25,6 +25,7 @@
 #include "../Core/Profiler.h"
 #include "../Core/Timer.h"
 #include "../IO/Log.h"
+#include "../Network/HttpClient.h"
 #include "../Network/HttpRequest.h"
 
 #include <Civetweb/civetweb.h>
@@ -43,7 +44,7 @@ HttpRequest::HttpRequest(const ea::string& url, const ea::string& verb, const ea
     headers_(headers),
     postData_(postData),
     state_(HTTP_INITIALIZING),
-    httpReadBuffer_(new unsigned char[READ_BUFFER_SIZE]),
+    statusCode_(0),
     readBuffer_(new unsigned char[READ_BUFFER_SIZE]),
     readPosition_(0),
     writePosition_(0)
@@ -53,32 +54,13 @@ HttpRequest::HttpRequest(const ea::string& url, const ea::string& verb, const ea
     size_ = M_MAX_UNSIGNED;
 
     URHO3D_LOGDEBUG("HTTP " + verb_ + " request to URL " + url_);
-
-#ifdef URHO3D_SSL
-    static bool sslInitialized = false;
-    if (!sslInitialized)
-    {
-        mg_init_library(MG_FEATURES_TLS);
-        sslInitialized = true;
-    }
-#endif
-
-#ifdef URHO3D_THREADING
-    // Start the worker thread to actually create the connection and read the response data.
-    Run();
-#else
-    URHO3D_LOGERROR("HTTP request will not execute as threading is disabled");
-#endif
 }
 
-HttpRequest::~HttpRequest()
-{
-    Stop();
-}
+HttpRequest::~HttpRequest() = default;
 
-void HttpRequest::ThreadFunction()
+void HttpRequest::Execute(HttpClient* client)
 {
-    URHO3D_PROFILE_THREAD("HttpRequest Thread");
+    URHO3D_PROFILE("ExecuteHttpRequest");
 
     ea::string protocol = "http";
     ea::string host;
@@ -101,48 +83,61 @@ void HttpRequest::ThreadFunction()
         host = host.substr(0, pathStart);
     }
 
+    const bool useSsl = protocol.comparei("https") >= 0;
     unsigned portStart = host.find(':');
     if (portStart != ea::string::npos)
     {
         port = ToInt(host.substr(portStart + 1));
         host = host.substr(0, portStart);
-    } else if (protocol.comparei("https") >= 0)
+    } else if (useSsl)
         port = 443;
 
     char errorBuffer[ERROR_BUFFER_SIZE];
     memset(errorBuffer, 0, sizeof(errorBuffer));
 
-    ea::string headersStr;
+    bool hasConnectionHeader = false;
+    ea::string request = Format("{} {} HTTP/1.1\r\nHost: {}\r\n", verb_, path, host);
     for (unsigned i = 0; i < headers_.size(); ++i)
     {
         // Trim and only add non-empty header strings
         ea::string header = headers_[i].trimmed();
         if (header.length())
-            headersStr += header + "\r\n";
+        {
+            hasConnectionHeader |= header.starts_with("Connection:", false);
+            request += header + "\r\n";
+        }
     }
-
-    // Initiate the connection. This may block due to DNS query
+    if (!hasConnectionHeader)
+        request += "Connection: keep-alive\r\n";
+    if (!postData_.empty())
+        request += Format("Content-Length: {}\r\n", postData_.length());
+    request += "\r\n";
+    request += postData_;
+
+    // Send the request, preferring an idle connection to the same host. A pooled connection may have been
+    // closed by the server in the meantime, so retry once on a fresh connection if it fails
     mg_connection* connection = nullptr;
-
-    if (postData_.empty())
-    {
-        connection = mg_download(host.c_str(), port, protocol.comparei("https") >= 0 ? 1 : 0, errorBuffer, sizeof(errorBuffer),
-            "%s %s HTTP/1.0\r\n"
-            "Host: %s\r\n"
-            "%s"
-            "\r\n", verb_.c_str(), path.c_str(), host.c_str(), headersStr.c_str());
-    }
-    else
+    for (unsigned attempt = 0; attempt < 2 && !connection; ++attempt)
     {
-        connection = mg_download(host.c_str(), port, protocol.comparei("https") >= 0 ? 1 : 0, errorBuffer, sizeof(errorBuffer),
-            "%s %s HTTP/1.0\r\n"
-            "Host: %s\r\n"
-            "%s"
-            "Content-Length: %d\r\n"
-            "\r\n"
-            "%s", verb_.c_str(), path.c_str(), host.c_str(), headersStr.c_str(), postData_.length(), postData_.c_str());
+        bool reused = false;
+        connection = client->AcquireConnection(host, port, useSsl, attempt == 0, reused, errorBuffer, sizeof(errorBuffer));
+        if (!connection)
+            break;
+
+        if (mg_write(connection, request.data(), request.length()) != (int)request.length())
+            snprintf(errorBuffer, sizeof(errorBuffer), "Error sending request");
+        else if (mg_get_response(connection, errorBuffer, sizeof(errorBuffer), -1) >= 0)
+            break;
+
+        mg_close_connection(connection);
+        connection = nullptr;
+        if (!reused)
+            break;
     }
 
+    const mg_response_info* responseInfo = connection ? mg_get_response_info(connection) : nullptr;
+    const long long contentLength = responseInfo ? responseInfo->content_length : -1;
+
     {
         MutexLock lock(mutex_);
         state_ = connection ? HTTP_OPEN : HTTP_ERROR;
@@ -153,55 +148,57 @@ void HttpRequest::ThreadFunction()
             error_ = ea::string(&errorBuffer[0]);
             return;
         }
-    }
 
-    // Loop while should run, read data from the connection, copy to the main thread buffer if there is space
-    while (shouldRun_)
-    {
-        // Read less than full buffer to be able to distinguish between full and empty ring buffer. Reading may block
-        int bytesRead = mg_read(connection, httpReadBuffer_.get(), READ_BUFFER_SIZE / 4);
-        if (bytesRead <= 0)
-            break;
+        statusCode_ = responseInfo ? responseInfo->status_code : 0;
+    }
 
-        mutex_.Acquire();
+    // The connection can be reused only when the server keeps it open and the whole body is consumed
+    const char* connectionHeader = mg_get_header(connection, "Connection");
+    bool keepAlive = responseInfo && responseInfo->http_version && ea::string(responseInfo->http_version) == "1.1"
+        && contentLength >= 0 && !(connectionHeader && ea::string(connectionHeader).comparei("close") == 0);
 
-        // Wait until enough space in the main thread's ring buffer
-        for (;;)
+    // Read data from the connection directly into the free part of the main thread's ring buffer
+    long long totalRead = 0;
+    for (;;)
+    {
+        unsigned writePosition;
+        unsigned spaceInBuffer;
         {
-            unsigned spaceInBuffer = READ_BUFFER_SIZE - ((writePosition_ - readPosition_) & (READ_BUFFER_SIZE - 1));
-            if ((int)spaceInBuffer > bytesRead || !shouldRun_)
-                break;
-
-            mutex_.Release();
-            Time::Sleep(5);
-            mutex_.Acquire();
+            MutexLock lock(mutex_);
+            // Leave one byte unused to be able to distinguish between full and empty ring buffer
+            spaceInBuffer = READ_BUFFER_SIZE - 1 - ((writePosition_ - readPosition_) & (READ_BUFFER_SIZE - 1));
+            writePosition = writePosition_;
         }
 
-        if (!shouldRun_)
+        // Stop if nobody is going to read the response anymore or the client is shutting down
+        if (Refs() == 1 || client->IsStopping())
         {
-            mutex_.Release();
+            keepAlive = false;
             break;
         }
 
-        if (writePosition_ + bytesRead <= READ_BUFFER_SIZE)
-            memcpy(readBuffer_.get() + writePosition_, httpReadBuffer_.get(), (size_t)bytesRead);
-        else
+        // Wait until there is space in the ring buffer
+        if (!spaceInBuffer)
         {
-            // Handle ring buffer wrap
-            unsigned part1 = READ_BUFFER_SIZE - writePosition_;
-            unsigned part2 = bytesRead - part1;
-            memcpy(readBuffer_.get() + writePosition_, httpReadBuffer_.get(), part1);
-            memcpy(readBuffer_.get(), httpReadBuffer_.get() + part1, part2);
+            Time::Sleep(5);
+            continue;
         }
 
+        // Reading may block. The main thread only touches the used part of the buffer, so no lock is needed
+        unsigned readSize = Min(spaceInBuffer, READ_BUFFER_SIZE - writePosition);
+        int bytesRead = mg_read(connection, readBuffer_.get() + writePosition, readSize);
+        if (bytesRead <= 0)
+            break;
+
+        totalRead += bytesRead;
+
+        MutexLock lock(mutex_);
         writePosition_ += bytesRead;
         writePosition_ &= READ_BUFFER_SIZE - 1;
-
-        mutex_.Release();
     }
 
-    // Close the connection
-    mg_close_connection(connection);
+    // Return the connection to the pool or close it
+    client->ReleaseConnection(host, port, useSsl, connection, keepAlive && totalRead == contentLength);
 
     {
         MutexLock lock(mutex_);
@@ -209,6 +206,13 @@ void HttpRequest::ThreadFunction()
     }
 }
 
+void HttpRequest::Cancel(const ea::string& error)
+{
+    MutexLock lock(mutex_);
+    state_ = HTTP_ERROR;
+    error_ = error;
+}
+
 unsigned HttpRequest::Read(void* dest, unsigned size)
 {
 #ifdef URHO3D_THREADING
@@ -299,6 +303,12 @@ unsigned HttpRequest::GetAvailableSize() const
     return CheckAvailableSizeAndEof().first;
 }
 
+int HttpRequest::GetStatusCode() const
+{
+    MutexLock lock(mutex_);
+    return statusCode_;
+}
+
 ea::pair<unsigned, bool> HttpRequest::CheckAvailableSizeAndEof() const
 {
     unsigned size = (writePosition_ - readPosition_) & (READ_BUFFER_SIZE - 1);
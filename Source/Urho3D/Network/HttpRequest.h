@@ -28,7 +28,6 @@
 
 #include "../Core/Mutex.h"
 #include "../Container/RefCounted.h"
-#include "../Core/Thread.h"
 #include "../IO/Deserializer.h"
 
 namespace Urho3D
@@ -43,18 +42,19 @@ enum HttpRequestState
     HTTP_CLOSED
 };
 
-/// An HTTP connection with response data stream.
-class URHO3D_API HttpRequest : public RefCounted, public Deserializer, public Thread
+class HttpClient;
+
+/// An HTTP connection with response data stream. Executed by the worker threads of an HttpClient.
+class URHO3D_API HttpRequest : public RefCounted, public Deserializer
 {
+    friend class HttpClient;
+
 public:
-    /// Construct with parameters.
+    /// Construct with parameters. The request does not execute until queued to an HttpClient.
     HttpRequest(const ea::string& url, const ea::string& verb, const ea::vector<ea::string>& headers, const ea::string& postData);
-    /// Destruct. Release the connection object.
+    /// Destruct.
     ~HttpRequest() override;
 
-    /// Process the connection in the worker thread until closed.
-    void ThreadFunction() override;
-
     /// Read response data from the HTTP connection and return number of bytes actually read. While the connection is open, will block while trying to read the specified size. To avoid blocking, only read up to as many bytes as GetAvailableSize() returns.
     unsigned Read(void* dest, unsigned size) override;
     /// Set position from the beginning of the stream. Not supported.
@@ -79,12 +79,19 @@ public:
     /// Return amount of bytes in the read buffer.
     /// @property
     unsigned GetAvailableSize() const;
+    /// Return HTTP status code of the response, or 0 if no response has been received.
+    /// @property
+    int GetStatusCode() const;
 
     /// Return whether connection is in the open state.
     /// @property
     bool IsOpen() const { return GetState() == HTTP_OPEN; }
 
 private:
+    /// Send the request and stream the response data into the read buffer. Called from an HttpClient worker thread.
+    void Execute(HttpClient* client);
+    /// Move to the error state without executing.
+    void Cancel(const ea::string& error);
     /// Check for available read data in buffer and whether end has been reached. Must only be called when the mutex is held by the main thread.
     ea::pair<unsigned, bool> CheckAvailableSizeAndEof() const;
 
@@ -100,11 +107,11 @@ private:
     ea::string postData_;
     /// Connection state.
     HttpRequestState state_;
+    /// HTTP status code of the response.
+    int statusCode_;
     /// Mutex for synchronizing the worker and the main thread.
     mutable Mutex mutex_;
-    /// Read buffer for the worker thread.
-    ea::shared_array<unsigned char> httpReadBuffer_;
-    /// Read buffer for the main thread.
+    /// Ring buffer the worker thread reads response data into directly and the main thread reads it from.
     ea::shared_array<unsigned char> readBuffer_;
     /// Read buffer read cursor.
     unsigned readPosition_;
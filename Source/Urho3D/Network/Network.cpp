@@ -25,17 +25,20 @@
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
 #include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
 #include "../Engine/EngineEvents.h"
 #include "../IO/FileSystem.h"
 #include "../Input/InputEvents.h"
 #include "../IO/IOEvents.h"
 #include "../IO/Log.h"
 #include "../IO/MemoryBuffer.h"
+#include "../Network/HttpClient.h"
 #include "../Network/HttpRequest.h"
 #include "../Network/Network.h"
 #include "../Network/NetworkEvents.h"
 #include "../Network/NetworkPriority.h"
 #include "../Network/Protocol.h"
+#include "../Network/TransformHistory.h"
 #include "../Scene/Scene.h"
 
 #include <slikenet/MessageIdentifiers.h>
@@ -192,6 +195,10 @@ static const char* RAKNET_MESSAGEID_STRINGS[] = {
 
 static const int DEFAULT_UPDATE_FPS = 30;
 static const int SERVER_TIMEOUT_TIME = 10000;
+/// Number of worker threads executing HTTP requests.
+static const unsigned NUM_HTTP_WORKERS = 4;
+/// Maximum number of idle HTTP connections kept alive for reuse.
+static const unsigned MAX_IDLE_HTTP_CONNECTIONS = 8;
 
 Network::Network(Context* context) :
     Object(context),
@@ -605,6 +612,20 @@ void Network::UnregisterRemoteEvent(StringHash eventType)
     allowedRemoteEvents_.erase(eventType);
 }
 
+void Network::SetMessageHandler(int msgID, NetworkMessageHandler handler)
+{
+    if (handler)
+        messageHandlers_[msgID] = ea::move(handler);
+    else
+        messageHandlers_.erase(msgID);
+}
+
+const NetworkMessageHandler* Network::GetMessageHandler(int msgID) const
+{
+    auto i = messageHandlers_.find(msgID);
+    return i != messageHandlers_.end() ? &i->second : nullptr;
+}
+
 void Network::UnregisterAllRemoteEvents()
 {
     allowedRemoteEvents_.clear();
@@ -642,9 +663,17 @@ SharedPtr<HttpRequest> Network::MakeHttpRequest(const ea::string& url, const ea:
 
     // The initialization of the request will take time, can not know at this point if it has an error or not
     SharedPtr<HttpRequest> request(new HttpRequest(url, verb, headers, postData));
+    GetHttpClient()->EnqueueRequest(request);
     return request;
 }
 
+HttpClient* Network::GetHttpClient()
+{
+    if (!httpClient_)
+        httpClient_ = new HttpClient(NUM_HTTP_WORKERS, MAX_IDLE_HTTP_CONNECTIONS);
+    return httpClient_;
+}
+
 void Network::BanAddress(const ea::string& address)
 {
     rakPeer_->AddToBanList(address.c_str(), 0);
@@ -888,6 +917,8 @@ void Network::Update(float timeStep)
 {
     URHO3D_PROFILE("UpdateNetwork");
 
+    numProcessedPackets_ = 0;
+
     //Process all incoming messages for the server
     if (rakPeer_->IsActive())
     {
@@ -895,6 +926,7 @@ void Network::Update(float timeStep)
         {
             HandleIncomingPacket(packet, true);
             rakPeer_->DeallocatePacket(packet);
+            ++numProcessedPackets_;
         }
     }
 
@@ -905,6 +937,7 @@ void Network::Update(float timeStep)
         {
             HandleIncomingPacket(packet, false);
             rakPeerClient_->DeallocatePacket(packet);
+            ++numProcessedPackets_;
         }
     }
 }
@@ -943,14 +976,36 @@ void Network::PostUpdate(float timeStep)
             {
                 URHO3D_PROFILE("SendServerUpdate");
 
-                // Then send server updates for each client connection
+                // Then build server updates for each client connection. Connections only read the prepared scenes
+                // and write to their own buffers, so they can be built in parallel
+                updateConnections_.clear();
                 for (auto i = clientConnections_.begin(); i != clientConnections_.end(); ++i)
+                    updateConnections_.push_back(i->second);
+
+                HiresTimer buildTimer;
+                const auto buildUpdates = [this](unsigned begin, unsigned end, unsigned)
                 {
-                    i->second->SendServerUpdate();
-                    i->second->SendRemoteEvents();
-                    i->second->SendPackages();
-                    i->second->SendAllBuffers();
+                    for (unsigned i = begin; i < end; ++i)
+                        updateConnections_[i]->BuildServerUpdate();
+                };
+
+                auto* workQueue = GetSubsystem<WorkQueue>();
+                if (threadedServerUpdate_ && workQueue && updateConnections_.size() > 1)
+                    workQueue->ParallelFor(updateConnections_.size(), 1, buildUpdates);
+                else
+                    buildUpdates(0, updateConnections_.size(), 0);
+                serverUpdateBuildTime_ = buildTimer.GetUSec(false);
+
+                // Send the packets from the main thread only
+                float bytesOutPerSec = 0.0f;
+                for (Connection* connection : updateConnections_)
+                {
+                    connection->SendAllBuffers();
+                    bytesOutPerSec += connection->GetBytesOutPerSec();
                 }
+
+                URHO3D_PROFILE_VALUE("Server update build time (us)", (int64_t)serverUpdateBuildTime_);
+                URHO3D_PROFILE_VALUE("Server data out (B/s)", bytesOutPerSec);
             }
         }
 
@@ -960,6 +1015,9 @@ void Network::PostUpdate(float timeStep)
             serverConnection_->SendClientUpdate();
             serverConnection_->SendRemoteEvents();
             serverConnection_->SendAllBuffers();
+
+            URHO3D_PROFILE_VALUE("Client round trip time (ms)", serverConnection_->GetRoundTripTime());
+            URHO3D_PROFILE_VALUE("Client data in (B/s)", serverConnection_->GetBytesInPerSec());
         }
 
         // Notify that the update was sent
@@ -1035,6 +1093,7 @@ unsigned long Network::GetEndpointHash(const SLNet::AddressOrGUID& endpoint)
 void RegisterNetworkLibrary(Context* context)
 {
     NetworkPriority::RegisterObject(context);
+    TransformHistory::RegisterObject(context);
     Connection::RegisterObject(context);
 }
 
@@ -28,13 +28,19 @@
 #include "../IO/VectorBuffer.h"
 #include "../Network/Connection.h"
 
+#include <functional>
+
 namespace Urho3D
 {
 
+class HttpClient;
 class HttpRequest;
 class MemoryBuffer;
 class Scene;
 
+/// Handler for a custom network message. Parses the message directly from the received packet memory.
+using NetworkMessageHandler = std::function<void(Connection* connection, MemoryBuffer& message)>;
+
 /// %Network subsystem. Manages client-server communications using the UDP protocol.
 class URHO3D_API Network : public Object
 {
@@ -89,6 +95,9 @@ public:
     /// Set network update FPS.
     /// @property
     void SetUpdateFps(int fps);
+    /// Set whether server update messages for client connections are built in parallel on worker threads. Packets are always sent from the main thread.
+    /// @property
+    void SetThreadedServerUpdate(bool enable) { threadedServerUpdate_ = enable; }
     /// Set simulated latency in milliseconds. This adds a fixed delay before sending each packet.
     /// @property
     void SetSimulatedLatency(int ms);
@@ -101,19 +110,41 @@ public:
     void UnregisterRemoteEvent(StringHash eventType);
     /// Unregister all remote events.
     void UnregisterAllRemoteEvents();
+    /// Set handler for a custom message ID. The handler is called instead of sending E_NETWORKMESSAGE, without copying the message data. Empty handler removes.
+    /// @nobind
+    void SetMessageHandler(int msgID, NetworkMessageHandler handler);
+    /// Return handler for a custom message ID, or null if none.
+    /// @nobind
+    const NetworkMessageHandler* GetMessageHandler(int msgID) const;
     /// Set the package download cache directory.
     /// @property
     void SetPackageCacheDir(const ea::string& path);
     /// Trigger all client connections in the specified scene to download a package file from the server. Can be used to download additional resource packages when clients are already joined in the scene. The package must have been added as a requirement to the scene, or else the eventual download will fail.
     void SendPackageToClients(Scene* scene, PackageFile* package);
     /// Perform an HTTP request to the specified URL. Empty verb defaults to a GET request. Return a request object which can be used to read the response data.
+    /// The request is queued to the shared HTTP client, which reuses keep-alive connections to the same host.
     SharedPtr<HttpRequest> MakeHttpRequest(const ea::string& url, const ea::string& verb = EMPTY_STRING, const ea::vector<ea::string>& headers = ea::vector<ea::string>(), const ea::string& postData = EMPTY_STRING);
     /// Ban specific IP addresses.
     void BanAddress(const ea::string& address);
+    /// Return the shared HTTP client used by MakeHttpRequest. Created on first use.
+    /// @nobind
+    HttpClient* GetHttpClient();
     /// Return network update FPS.
     /// @property
     int GetUpdateFps() const { return updateFps_; }
 
+    /// Return whether server update messages are built in parallel on worker threads.
+    /// @property
+    bool GetThreadedServerUpdate() const { return threadedServerUpdate_; }
+
+    /// Return time in microseconds spent building server update messages for all client connections in the last update.
+    /// @property
+    long long GetServerUpdateBuildTime() const { return serverUpdateBuildTime_; }
+
+    /// Return number of incoming packets processed in the last update.
+    /// @property
+    unsigned GetNumProcessedPackets() const { return numProcessedPackets_; }
+
     /// Return simulated latency in milliseconds.
     /// @property
     int GetSimulatedLatency() const { return simulatedLatency_; }
@@ -171,10 +202,20 @@ private:
     ea::unordered_map<unsigned long, SharedPtr<Connection> > clientConnections_;
     /// Allowed remote events.
     ea::hash_set<StringHash> allowedRemoteEvents_;
+    /// Custom message handlers by message ID.
+    ea::unordered_map<int, NetworkMessageHandler> messageHandlers_;
     /// Remote event fixed blacklist.
     ea::hash_set<StringHash> blacklistedRemoteEvents_;
     /// Networked scenes.
     ea::hash_set<Scene*> networkScenes_;
+    /// Client connections being updated.
+    ea::vector<Connection*> updateConnections_;
+    /// Whether server update messages are built on worker threads.
+    bool threadedServerUpdate_{true};
+    /// Time in microseconds spent building the last server update messages.
+    long long serverUpdateBuildTime_{};
+    /// Number of incoming packets processed in the last update.
+    unsigned numProcessedPackets_{};
     /// Update FPS.
     int updateFps_;
     /// Simulated latency (send delay) in milliseconds.
@@ -187,6 +228,8 @@ private:
     float updateAcc_;
     /// Package cache directory.
     ea::string packageCacheDir_;
+    /// Shared HTTP client.
+    SharedPtr<HttpClient> httpClient_;
     /// Whether we started as server or not.
     bool isServer_;
     /// Server/Client password used for connecting.
@@ -31,7 +31,7 @@ static const int MSG_IDENTITY = 0x87;
 static const int MSG_CONTROLS = 0x88;
 /// Client->server: scene has been loaded and client is ready to proceed.
 static const int MSG_SCENELOADED = 0x89;
-/// Client->server: request a package file.
+/// Client->server: request a package file, optionally resuming from a number of fragments already received along with their checksum.
 static const int MSG_REQUESTPACKAGE = 0x8A;
 
 /// Server->client: package file data fragment.
@@ -74,5 +74,7 @@ static const int MSG_USER = 0x200;
 static const unsigned CONTROLS_CONTENT_ID = 1;
 /// Package file fragment size.
 static const unsigned PACKAGE_FRAGMENT_SIZE = 1024;
+/// Flag in package data fragment index indicating LZ4-compressed fragment data.
+static const unsigned PACKAGE_FRAGMENT_COMPRESSED = 0x80000000;
 
 }
@@ -0,0 +1,134 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Core/Timer.h"
+#include "../Network/NetworkEvents.h"
+#include "../Network/TransformHistory.h"
+#include "../Scene/Node.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+extern const char* NETWORK_CATEGORY;
+
+static const float DEFAULT_HISTORY_LENGTH = 1.0f;
+
+TransformHistory::TransformHistory(Context* context) :
+    Component(context),
+    historyLength_(DEFAULT_HISTORY_LENGTH)
+{
+}
+
+TransformHistory::~TransformHistory() = default;
+
+void TransformHistory::RegisterObject(Context* context)
+{
+    context->RegisterFactory<TransformHistory>(NETWORK_CATEGORY);
+
+    URHO3D_ACCESSOR_ATTRIBUTE("History Length", GetHistoryLength, SetHistoryLength, float, DEFAULT_HISTORY_LENGTH, AM_DEFAULT);
+}
+
+void TransformHistory::SetHistoryLength(float length)
+{
+    historyLength_ = Max(length, 0.0f);
+}
+
+void TransformHistory::ClearHistory()
+{
+    records_.clear();
+}
+
+bool TransformHistory::GetWorldTransform(float timeAgo, Vector3& position, Quaternion& rotation) const
+{
+    if (records_.empty())
+        return false;
+
+    const float time = GetSubsystem<Time>()->GetElapsedTime() - Max(timeAgo, 0.0f);
+
+    // Clamp to the recorded range
+    if (time <= records_.front().time_ || records_.size() == 1)
+    {
+        position = records_.front().position_;
+        rotation = records_.front().rotation_;
+        return true;
+    }
+    if (time >= records_.back().time_)
+    {
+        position = records_.back().position_;
+        rotation = records_.back().rotation_;
+        return true;
+    }
+
+    // Find the pair of records around the time
+    auto next = ea::upper_bound(records_.begin(), records_.end(), time,
+        [](float value, const Record& record) { return value < record.time_; });
+    auto prev = next - 1;
+
+    const float span = next->time_ - prev->time_;
+    const float t = span > M_EPSILON ? (time - prev->time_) / span : 1.0f;
+    position = prev->position_.Lerp(next->position_, t);
+    rotation = prev->rotation_.Slerp(next->rotation_, t);
+    return true;
+}
+
+Vector3 TransformHistory::GetWorldPosition(float timeAgo) const
+{
+    Vector3 position;
+    Quaternion rotation;
+    if (GetWorldTransform(timeAgo, position, rotation))
+        return position;
+    return node_ ? node_->GetWorldPosition() : Vector3::ZERO;
+}
+
+void TransformHistory::OnSceneSet(Scene* scene)
+{
+    if (scene)
+        SubscribeToEvent(E_NETWORKUPDATE, URHO3D_HANDLER(TransformHistory, HandleNetworkUpdate));
+    else
+    {
+        UnsubscribeFromEvent(E_NETWORKUPDATE);
+        records_.clear();
+    }
+}
+
+void TransformHistory::HandleNetworkUpdate(StringHash eventType, VariantMap& eventData)
+{
+    if (!node_ || !IsEnabledEffective())
+        return;
+
+    const float time = GetSubsystem<Time>()->GetElapsedTime();
+
+    // Drop records older than the history length, keeping one for interpolating at the far end
+    unsigned numExpired = 0;
+    while (numExpired + 1 < records_.size() && records_[numExpired + 1].time_ < time - historyLength_)
+        ++numExpired;
+    records_.erase(records_.begin(), records_.begin() + numExpired);
+
+    records_.push_back({ time, node_->GetWorldPosition(), node_->GetWorldRotation() });
+}
+
+}
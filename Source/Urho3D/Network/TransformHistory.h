@@ -0,0 +1,90 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Scene/Component.h"
+
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+/// Server-side history of node world transforms, recorded on each network update. Used for lag compensation: hit tests for a client are performed against the transforms the client was seeing, see Connection::GetLagCompensationTime().
+class URHO3D_API TransformHistory : public Component
+{
+    URHO3D_OBJECT(TransformHistory, Component);
+
+public:
+    /// Construct.
+    explicit TransformHistory(Context* context);
+    /// Destruct.
+    ~TransformHistory() override;
+    /// Register object factory.
+    /// @nobind
+    static void RegisterObject(Context* context);
+
+    /// Set history length in seconds.
+    /// @property
+    void SetHistoryLength(float length);
+    /// Remove all recorded transforms.
+    void ClearHistory();
+
+    /// Return history length in seconds.
+    /// @property
+    float GetHistoryLength() const { return historyLength_; }
+
+    /// Return number of recorded transforms.
+    /// @property
+    unsigned GetNumRecords() const { return records_.size(); }
+
+    /// Return interpolated world transform the given number of seconds in the past. Clamped to the recorded history. Return false if nothing is recorded.
+    bool GetWorldTransform(float timeAgo, Vector3& position, Quaternion& rotation) const;
+    /// Return interpolated world position the given number of seconds in the past, or the current position if nothing is recorded.
+    Vector3 GetWorldPosition(float timeAgo) const;
+
+protected:
+    /// Handle scene being assigned.
+    void OnSceneSet(Scene* scene) override;
+
+private:
+    /// Recorded world transform.
+    struct Record
+    {
+        /// Elapsed time when recorded.
+        float time_;
+        /// World position.
+        Vector3 position_;
+        /// World rotation.
+        Quaternion rotation_;
+    };
+
+    /// Handle network update by recording the current transform.
+    void HandleNetworkUpdate(StringHash eventType, VariantMap& eventData);
+
+    /// Recorded transforms, oldest first.
+    ea::vector<Record> records_;
+    /// History length in seconds.
+    float historyLength_;
+};
+
+}
@@ -32,8 +32,10 @@
 #include "../Graphics/Model.h"
 #include "../Graphics/Terrain.h"
 #include "../Graphics/VertexBuffer.h"
+#include "../IO/FileSystem.h"
 #include "../IO/Log.h"
 #include "../Physics/CollisionShape.h"
+#include "../Physics/CookedCollisionGeometry.h"
 #include "../Physics/PhysicsUtils.h"
 #include "../Physics/PhysicsWorld.h"
 #include "../Physics/RigidBody.h"
@@ -49,6 +51,7 @@
 #include <Bullet/BulletCollision/CollisionShapes/btConvexHullShape.h>
 #include <Bullet/BulletCollision/CollisionShapes/btCylinderShape.h>
 #include <Bullet/BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h>
+#include <Bullet/BulletCollision/CollisionShapes/btOptimizedBvh.h>
 #include <Bullet/BulletCollision/CollisionShapes/btScaledBvhTriangleMeshShape.h>
 #include <Bullet/BulletCollision/CollisionShapes/btSphereShape.h>
 #include <Bullet/BulletCollision/CollisionShapes/btTriangleIndexVertexArray.h>
@@ -196,10 +199,27 @@ private:
     ea::vector<ea::shared_array<unsigned char> > dataArrays_;
 };
 
-TriangleMeshData::TriangleMeshData(Model* model, unsigned lodLevel)
+TriangleMeshData::TriangleMeshData(Model* model, unsigned lodLevel, CookedCollisionGeometry* cookedGeometry)
 {
     meshInterface_ = ea::make_unique<TriangleMeshInterface>(model, lodLevel);
-    shape_ = ea::make_unique<btBvhTriangleMeshShape>(meshInterface_.get(), meshInterface_->useQuantize_, true);
+
+    btOptimizedBvh* bvh = nullptr;
+    if (cookedGeometry)
+    {
+        unsigned numTriangles = 0;
+        for (int i = 0; i < meshInterface_->getNumSubParts(); ++i)
+            numTriangles += meshInterface_->getIndexedMeshArray()[i].m_numTriangles;
+        bvh = cookedGeometry->GetTriangleMeshBvh(lodLevel, numTriangles, meshInterface_->useQuantize_);
+    }
+
+    if (bvh)
+    {
+        cookedGeometry_ = cookedGeometry;
+        shape_ = ea::make_unique<btBvhTriangleMeshShape>(meshInterface_.get(), meshInterface_->useQuantize_, false);
+        shape_->setOptimizedBvh(bvh);
+    }
+    else
+        shape_ = ea::make_unique<btBvhTriangleMeshShape>(meshInterface_.get(), meshInterface_->useQuantize_, true);
 
     infoMap_ = ea::make_unique<btTriangleInfoMap>();
     btGenerateInternalEdgeInfo(shape_.get(), infoMap_.get());
@@ -224,11 +244,32 @@ GImpactMeshData::GImpactMeshData(CustomGeometry* custom)
     meshInterface_ = ea::make_unique<TriangleMeshInterface>(custom);
 }
 
-ConvexData::ConvexData(Model* model, unsigned lodLevel)
+ConvexData::ConvexData(Model* model, unsigned lodLevel, CookedCollisionGeometry* cookedGeometry)
 {
     ea::vector<Vector3> vertices;
     unsigned numGeometries = model->GetNumGeometries();
 
+    for (unsigned i = 0; i < numGeometries; ++i)
+    {
+        if (Geometry* geometry = model->GetGeometry(i, lodLevel))
+            sourceVertexCount_ += geometry->GetVertexCount();
+    }
+
+    if (cookedGeometry)
+    {
+        if (const CookedConvexHull* hull = cookedGeometry->GetConvexHull(lodLevel, sourceVertexCount_))
+        {
+            vertexCount_ = hull->vertices_.size();
+            vertexData_ = new Vector3[vertexCount_];
+            memcpy(vertexData_.get(), hull->vertices_.data(), vertexCount_ * sizeof(Vector3));
+
+            indexCount_ = hull->indices_.size();
+            indexData_ = new unsigned[indexCount_];
+            memcpy(indexData_.get(), hull->indices_.data(), indexCount_ * sizeof(unsigned));
+            return;
+        }
+    }
+
     for (unsigned i = 0; i < numGeometries; ++i)
     {
         Geometry* geometry = model->GetGeometry(i, lodLevel);
@@ -319,7 +360,8 @@ HeightfieldData::HeightfieldData(Terrain* terrain, unsigned lodLevel) :
     spacing_(terrain->GetSpacing()),
     size_(terrain->GetNumVertices()),
     minHeight_(0.0f),
-    maxHeight_(0.0f)
+    maxHeight_(0.0f),
+    skip_(1)
 {
     if (heightData_)
     {
@@ -354,6 +396,7 @@ HeightfieldData::HeightfieldData(Terrain* terrain, unsigned lodLevel) :
             size_ = lodSize;
             spacing_ = lodSpacing;
             heightData_ = lodHeightData;
+            skip_ = skip;
         }
 
         auto points = (unsigned)(size_.x_ * size_.y_);
@@ -368,6 +411,53 @@ HeightfieldData::HeightfieldData(Terrain* terrain, unsigned lodLevel) :
     }
 }
 
+bool HeightfieldData::UpdateRegion(Terrain* terrain, const IntRect& region)
+{
+    const ea::shared_array<float>& terrainHeightData = terrain->GetHeightData();
+    if (!heightData_ || !terrainHeightData)
+        return false;
+
+    const IntVector2& numVertices = terrain->GetNumVertices();
+    float newMinHeight = minHeight_;
+    float newMaxHeight = maxHeight_;
+
+    if (skip_ == 1)
+    {
+        // LOD level 0 shares the height data with the terrain, only the range needs to be checked
+        if (heightData_ != terrainHeightData || size_ != numVertices)
+            return false;
+
+        for (int y = region.top_; y <= region.bottom_; ++y)
+        {
+            for (int x = region.left_; x <= region.right_; ++x)
+            {
+                const float height = heightData_[y * size_.x_ + x];
+                newMinHeight = Min(newMinHeight, height);
+                newMaxHeight = Max(newMaxHeight, height);
+            }
+        }
+    }
+    else
+    {
+        // Copy the changed samples of the reduced resolution data
+        const int startX = (region.left_ + (int)skip_ - 1) / (int)skip_;
+        const int startY = (region.top_ + (int)skip_ - 1) / (int)skip_;
+        for (int dY = startY; dY < size_.y_ && dY * (int)skip_ <= region.bottom_; ++dY)
+        {
+            for (int dX = startX; dX < size_.x_ && dX * (int)skip_ <= region.right_; ++dX)
+            {
+                const float height = terrainHeightData[dY * skip_ * numVertices.x_ + dX * skip_];
+                heightData_[dY * size_.x_ + dX] = height;
+                newMinHeight = Min(newMinHeight, height);
+                newMaxHeight = Max(newMaxHeight, height);
+            }
+        }
+    }
+
+    // Bullet centers the heightfield on the height range, so it can not grow in place
+    return newMinHeight >= minHeight_ && newMaxHeight <= maxHeight_;
+}
+
 bool HasDynamicBuffers(Model* model, unsigned lodLevel)
 {
     unsigned numGeometries = model->GetNumGeometries();
@@ -394,14 +484,15 @@ bool HasDynamicBuffers(Model* model, unsigned lodLevel)
     return false;
 }
 
-CollisionGeometryData* CreateCollisionGeometryData(ShapeType shapeType, Model* model, unsigned lodLevel)
+CollisionGeometryData* CreateCollisionGeometryData(ShapeType shapeType, Model* model, unsigned lodLevel,
+    CookedCollisionGeometry* cookedGeometry)
 {
     switch (shapeType)
     {
     case SHAPE_TRIANGLEMESH:
-        return new TriangleMeshData(model, lodLevel);
+        return new TriangleMeshData(model, lodLevel, cookedGeometry);
     case SHAPE_CONVEXHULL:
-        return new ConvexData(model, lodLevel);
+        return new ConvexData(model, lodLevel, cookedGeometry);
     case SHAPE_GIMPACTMESH:
         return new GImpactMeshData(model, lodLevel);
     default:
@@ -912,6 +1003,7 @@ void CollisionShape::OnNodeSet(Node* node)
 
         // Terrain collision shape depends on the terrain component's geometry updates. Subscribe to them
         SubscribeToEvent(node, E_TERRAINCREATED, URHO3D_HANDLER(CollisionShape, HandleTerrainCreated));
+        SubscribeToEvent(node, E_TERRAINMODIFIED, URHO3D_HANDLER(CollisionShape, HandleTerrainModified));
     }
 }
 
@@ -1122,7 +1214,13 @@ void CollisionShape::UpdateCachedGeometryShape(CollisionGeometryDataCache& cache
             geometry_ = cachedGeometry->second;
         else
         {
-            geometry_ = CreateCollisionGeometryData(shapeType_, model_, lodLevel_);
+            // Prefer precooked hull and BVH data stored alongside the model
+            auto* resourceCache = GetSubsystem<ResourceCache>();
+            const ea::string cookedName = ReplaceExtension(model_->GetName(), COOKED_COLLISION_EXTENSION);
+            auto* cookedGeometry = (shapeType_ == SHAPE_TRIANGLEMESH || shapeType_ == SHAPE_CONVEXHULL) && resourceCache->Exists(cookedName)
+                ? resourceCache->GetResource<CookedCollisionGeometry>(cookedName) : nullptr;
+
+            geometry_ = CreateCollisionGeometryData(shapeType_, model_, lodLevel_, cookedGeometry);
             assert(geometry_);
             // Check if model has dynamic buffers, do not cache in that case
             if (!HasDynamicBuffers(model_, lodLevel_))
@@ -1206,6 +1304,40 @@ void CollisionShape::HandleTerrainCreated(StringHash eventType, VariantMap& even
     }
 }
 
+void CollisionShape::HandleTerrainModified(StringHash eventType, VariantMap& eventData)
+{
+    if (shapeType_ != SHAPE_TERRAIN)
+        return;
+
+    using namespace TerrainModified;
+
+    auto* terrain = GetComponent<Terrain>();
+    auto* heightfield = static_cast<HeightfieldData*>(geometry_.Get());
+    const IntRect region = eventData[P_REGION].GetIntRect();
+    if (!terrain || !heightfield || !shape_ || !heightfield->UpdateRegion(terrain, region))
+    {
+        UpdateShape();
+        NotifyRigidBody();
+        return;
+    }
+
+    // Heights were changed in place. Wake up the bodies above the changed region so that they react to it
+    if (physicsWorld_ && node_)
+    {
+        const IntVector2& numVertices = terrain->GetNumVertices();
+        BoundingBox box;
+        box.Merge(terrain->HeightMapToWorld(IntVector2(region.left_, numVertices.y_ - 1 - region.top_)));
+        box.Merge(terrain->HeightMapToWorld(IntVector2(region.right_, numVertices.y_ - 1 - region.bottom_)));
+        box.min_.y_ = -M_LARGE_VALUE;
+        box.max_.y_ = M_LARGE_VALUE;
+
+        ea::vector<RigidBody*> bodies;
+        physicsWorld_->GetRigidBodies(bodies, box);
+        for (RigidBody* body : bodies)
+            body->Activate();
+    }
+}
+
 void CollisionShape::HandleModelReloadFinished(StringHash eventType, VariantMap& eventData)
 {
     if (physicsWorld_)
@@ -41,6 +41,7 @@ struct btTriangleInfoMap;
 namespace Urho3D
 {
 
+class CookedCollisionGeometry;
 class CustomGeometry;
 class Geometry;
 class Model;
@@ -76,11 +77,13 @@ using CollisionGeometryDataCache = ea::unordered_map<ea::pair<Model*, unsigned>,
 /// Triangle mesh geometry data.
 struct TriangleMeshData : public CollisionGeometryData
 {
-    /// Construct from a model.
-    TriangleMeshData(Model* model, unsigned lodLevel);
+    /// Construct from a model. Uses the precooked BVH if one matching the model is available.
+    TriangleMeshData(Model* model, unsigned lodLevel, CookedCollisionGeometry* cookedGeometry = nullptr);
     /// Construct from a custom geometry.
     explicit TriangleMeshData(CustomGeometry* custom);
 
+    /// Precooked geometry which owns the BVH, if used.
+    SharedPtr<CookedCollisionGeometry> cookedGeometry_;
     /// Bullet triangle mesh interface.
     ea::unique_ptr<TriangleMeshInterface> meshInterface_;
     /// Bullet triangle mesh collision shape.
@@ -104,8 +107,8 @@ struct GImpactMeshData : public CollisionGeometryData
 /// Convex hull geometry data.
 struct ConvexData : public CollisionGeometryData
 {
-    /// Construct from a model.
-    ConvexData(Model* model, unsigned lodLevel);
+    /// Construct from a model. Uses the precooked hull if one matching the model is available.
+    ConvexData(Model* model, unsigned lodLevel, CookedCollisionGeometry* cookedGeometry = nullptr);
     /// Construct from a custom geometry.
     explicit ConvexData(CustomGeometry* custom);
 
@@ -120,6 +123,8 @@ struct ConvexData : public CollisionGeometryData
     ea::shared_array<unsigned> indexData_;
     /// Number of indices.
     unsigned indexCount_{};
+    /// Number of source vertices the hull was built from.
+    unsigned sourceVertexCount_{};
 };
 
 /// Heightfield geometry data.
@@ -127,6 +132,8 @@ struct HeightfieldData : public CollisionGeometryData
 {
     /// Construct from a terrain.
     HeightfieldData(Terrain* terrain, unsigned lodLevel);
+    /// Copy changed terrain heights within a region of terrain vertices. Return false if the heights exceed the original height range, in which case the collision shape must be recreated.
+    bool UpdateRegion(Terrain* terrain, const IntRect& region);
 
     /// Height data. On LOD level 0 the original height data will be used.
     ea::shared_array<float> heightData_;
@@ -138,6 +145,8 @@ struct HeightfieldData : public CollisionGeometryData
     float minHeight_;
     /// Maximum height.
     float maxHeight_;
+    /// Terrain vertex step between heightfield samples, depends on the LOD level.
+    unsigned skip_;
 };
 
 /// Physics collision shape component.
@@ -298,6 +307,8 @@ private:
         const Vector3& scale, const Vector3& position, const Quaternion& rotation);
     /// Update terrain collision shape from the terrain component.
     void HandleTerrainCreated(StringHash eventType, VariantMap& eventData);
+    /// Update terrain collision shape heights after a region of the terrain has changed.
+    void HandleTerrainModified(StringHash eventType, VariantMap& eventData);
     /// Update trimesh or convex shape after a model has reloaded itself.
     void HandleModelReloadFinished(StringHash eventType, VariantMap& eventData);
     /// Mark shape dirty.
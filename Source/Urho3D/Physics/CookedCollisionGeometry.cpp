@@ -0,0 +1,238 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Core/Profiler.h"
+#include "../Graphics/Model.h"
+#include "../IO/Deserializer.h"
+#include "../IO/Log.h"
+#include "../IO/Serializer.h"
+#include "../Physics/CollisionShape.h"
+#include "../Physics/CookedCollisionGeometry.h"
+
+#include <Bullet/BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h>
+#include <Bullet/BulletCollision/CollisionShapes/btOptimizedBvh.h>
+#include <Bullet/BulletCollision/CollisionShapes/btTriangleIndexVertexArray.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+extern const char* PHYSICS_CATEGORY;
+
+static const unsigned BVH_DATA_ALIGNMENT = 16;
+
+static unsigned GetNumTriangles(const btBvhTriangleMeshShape* shape)
+{
+    const auto* meshInterface = static_cast<const btTriangleIndexVertexArray*>(shape->getMeshInterface());
+    unsigned numTriangles = 0;
+    for (int i = 0; i < meshInterface->getNumSubParts(); ++i)
+        numTriangles += meshInterface->getIndexedMeshArray()[i].m_numTriangles;
+    return numTriangles;
+}
+
+void CookedCollisionGeometry::AlignedDeleter::operator()(unsigned char* data) const
+{
+    btAlignedFree(data);
+}
+
+CookedCollisionGeometry::CookedCollisionGeometry(Context* context) :
+    Resource(context)
+{
+}
+
+CookedCollisionGeometry::~CookedCollisionGeometry() = default;
+
+void CookedCollisionGeometry::RegisterObject(Context* context)
+{
+    context->RegisterFactory<CookedCollisionGeometry>(PHYSICS_CATEGORY);
+}
+
+bool CookedCollisionGeometry::BeginLoad(Deserializer& source)
+{
+    if (source.ReadFileID() != "UCOL")
+    {
+        URHO3D_LOGERROR(source.GetName() + " is not a valid cooked collision geometry file");
+        return false;
+    }
+
+    lodLevels_.clear();
+    lodLevels_.resize(source.ReadUInt());
+
+    for (LodLevel& lodLevel : lodLevels_)
+    {
+        CookedConvexHull& hull = lodLevel.hull_;
+        hull.sourceVertexCount_ = source.ReadUInt();
+        hull.vertices_.resize(source.ReadUInt());
+        source.Read(hull.vertices_.data(), hull.vertices_.size() * sizeof(Vector3));
+        hull.indices_.resize(source.ReadUInt());
+        source.Read(hull.indices_.data(), hull.indices_.size() * sizeof(unsigned));
+
+        lodLevel.bvhTriangles_ = source.ReadUInt();
+        lodLevel.bvhQuantized_ = source.ReadBool();
+        const unsigned bvhSize = source.ReadUInt();
+        if (!bvhSize)
+            continue;
+
+        // Bullet fixes up the BVH pointers inside the buffer, so it needs a writable aligned copy
+        AllocateBvh(lodLevel, bvhSize);
+        if (source.Read(lodLevel.bvhData_.get(), bvhSize) != bvhSize)
+        {
+            URHO3D_LOGERROR("Truncated BVH data in " + source.GetName());
+            return false;
+        }
+        lodLevel.bvh_ = btOptimizedBvh::deSerializeInPlace(lodLevel.bvhData_.get(), bvhSize, false);
+        if (!lodLevel.bvh_ || lodLevel.bvh_->isQuantized() != lodLevel.bvhQuantized_)
+        {
+            URHO3D_LOGERROR("Invalid BVH data in " + source.GetName());
+            lodLevel.bvh_ = nullptr;
+            lodLevel.bvhData_.reset();
+        }
+    }
+
+    unsigned memoryUse = sizeof(CookedCollisionGeometry) + lodLevels_.size() * sizeof(LodLevel);
+    for (const LodLevel& lodLevel : lodLevels_)
+    {
+        memoryUse += lodLevel.hull_.vertices_.size() * sizeof(Vector3) + lodLevel.hull_.indices_.size() * sizeof(unsigned);
+        memoryUse += lodLevel.bvhData_ ? lodLevel.bvhSize_ : 0;
+    }
+    SetMemoryUse(memoryUse);
+    return true;
+}
+
+bool CookedCollisionGeometry::Save(Serializer& dest) const
+{
+    if (!dest.WriteFileID("UCOL"))
+    {
+        URHO3D_LOGERROR("Can not save cooked collision geometry " + GetName());
+        return false;
+    }
+
+    dest.WriteUInt(lodLevels_.size());
+    for (const LodLevel& lodLevel : lodLevels_)
+    {
+        const CookedConvexHull& hull = lodLevel.hull_;
+        dest.WriteUInt(hull.sourceVertexCount_);
+        dest.WriteUInt(hull.vertices_.size());
+        dest.Write(hull.vertices_.data(), hull.vertices_.size() * sizeof(Vector3));
+        dest.WriteUInt(hull.indices_.size());
+        dest.Write(hull.indices_.data(), hull.indices_.size() * sizeof(unsigned));
+
+        dest.WriteUInt(lodLevel.bvhTriangles_);
+        dest.WriteBool(lodLevel.bvhQuantized_);
+        // The live BVH contains pointers into its buffer, so serialize a clean copy
+        ea::unique_ptr<unsigned char, AlignedDeleter> bvhData;
+        if (lodLevel.bvh_)
+        {
+            bvhData.reset(static_cast<unsigned char*>(btAlignedAlloc(lodLevel.bvhSize_, BVH_DATA_ALIGNMENT)));
+            if (!lodLevel.bvh_->serializeInPlace(bvhData.get(), lodLevel.bvhSize_, false))
+                bvhData.reset();
+        }
+
+        if (bvhData)
+        {
+            dest.WriteUInt(lodLevel.bvhSize_);
+            dest.Write(bvhData.get(), lodLevel.bvhSize_);
+        }
+        else
+            dest.WriteUInt(0);
+    }
+
+    return true;
+}
+
+bool CookedCollisionGeometry::Cook(Model* model)
+{
+    if (!model)
+    {
+        URHO3D_LOGERROR("Null model, can not cook collision geometry");
+        return false;
+    }
+
+    URHO3D_PROFILE("CookCollisionGeometry");
+
+    unsigned numLodLevels = 0;
+    for (unsigned i = 0; i < model->GetNumGeometries(); ++i)
+        numLodLevels = Max(numLodLevels, model->GetNumGeometryLodLevels(i));
+
+    lodLevels_.clear();
+    lodLevels_.resize(numLodLevels);
+
+    for (unsigned i = 0; i < numLodLevels; ++i)
+    {
+        LodLevel& lodLevel = lodLevels_[i];
+
+        ConvexData convex(model, i);
+        lodLevel.hull_.sourceVertexCount_ = convex.sourceVertexCount_;
+        lodLevel.hull_.vertices_.assign(convex.vertexData_.get(), convex.vertexData_.get() + convex.vertexCount_);
+        lodLevel.hull_.indices_.assign(convex.indexData_.get(), convex.indexData_.get() + convex.indexCount_);
+
+        TriangleMeshData triMesh(model, i);
+        btOptimizedBvh* bvh = triMesh.shape_->getOptimizedBvh();
+        if (!bvh)
+            continue;
+
+        lodLevel.bvhTriangles_ = GetNumTriangles(triMesh.shape_.get());
+        lodLevel.bvhQuantized_ = bvh->isQuantized();
+
+        const unsigned bvhSize = bvh->calculateSerializeBufferSize();
+        AllocateBvh(lodLevel, bvhSize);
+        if (!bvh->serializeInPlace(lodLevel.bvhData_.get(), bvhSize, false))
+        {
+            URHO3D_LOGERROR("Failed to serialize BVH of " + model->GetName());
+            return false;
+        }
+        lodLevel.bvh_ = btOptimizedBvh::deSerializeInPlace(lodLevel.bvhData_.get(), bvhSize, false);
+    }
+
+    return true;
+}
+
+const CookedConvexHull* CookedCollisionGeometry::GetConvexHull(unsigned lodLevel, unsigned sourceVertexCount) const
+{
+    if (lodLevel >= lodLevels_.size())
+        return nullptr;
+
+    const CookedConvexHull& hull = lodLevels_[lodLevel].hull_;
+    return hull.sourceVertexCount_ == sourceVertexCount && !hull.vertices_.empty() ? &hull : nullptr;
+}
+
+btOptimizedBvh* CookedCollisionGeometry::GetTriangleMeshBvh(unsigned lodLevel, unsigned numTriangles, bool quantized) const
+{
+    if (lodLevel >= lodLevels_.size())
+        return nullptr;
+
+    const LodLevel& data = lodLevels_[lodLevel];
+    return data.bvhTriangles_ == numTriangles && data.bvhQuantized_ == quantized ? data.bvh_ : nullptr;
+}
+
+void CookedCollisionGeometry::AllocateBvh(LodLevel& lodLevel, unsigned size)
+{
+    lodLevel.bvhSize_ = size;
+    lodLevel.bvhData_.reset(static_cast<unsigned char*>(btAlignedAlloc(size, BVH_DATA_ALIGNMENT)));
+    lodLevel.bvh_ = nullptr;
+}
+
+}
@@ -0,0 +1,112 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Math/Vector3.h"
+#include "../Resource/Resource.h"
+
+#include <EASTL/unique_ptr.h>
+
+class btOptimizedBvh;
+
+namespace Urho3D
+{
+
+class Model;
+
+/// File extension of cooked collision geometry, stored alongside the model with the same base name.
+static const char* COOKED_COLLISION_EXTENSION = ".collision";
+
+/// Precooked convex hull.
+struct CookedConvexHull
+{
+    /// Number of source vertices the hull was built from. Used to detect stale data.
+    unsigned sourceVertexCount_{};
+    /// Hull vertices.
+    ea::vector<Vector3> vertices_;
+    /// Hull triangle indices.
+    ea::vector<unsigned> indices_;
+};
+
+/// Precooked collision geometry of a model: convex hulls and triangle mesh BVHs per LOD level. Loaded automatically by CollisionShape instead of building them at runtime.
+class URHO3D_API CookedCollisionGeometry : public Resource
+{
+    URHO3D_OBJECT(CookedCollisionGeometry, Resource);
+
+public:
+    /// Construct.
+    explicit CookedCollisionGeometry(Context* context);
+    /// Destruct.
+    ~CookedCollisionGeometry() override;
+    /// Register object factory.
+    /// @nobind
+    static void RegisterObject(Context* context);
+
+    /// Load resource from stream. May be called from a worker thread. Return true if successful.
+    bool BeginLoad(Deserializer& source) override;
+    /// Save resource. Return true if successful.
+    bool Save(Serializer& dest) const override;
+
+    /// Build convex hulls and triangle mesh BVHs for all LOD levels of a model. Return true if successful.
+    bool Cook(Model* model);
+
+    /// Return number of LOD levels.
+    unsigned GetNumLodLevels() const { return lodLevels_.size(); }
+    /// Return convex hull for LOD level if it matches the source vertex count, or null.
+    const CookedConvexHull* GetConvexHull(unsigned lodLevel, unsigned sourceVertexCount) const;
+    /// Return triangle mesh BVH for LOD level if it matches the triangle count and quantization mode, or null. The BVH is owned by the resource.
+    /// @nobind
+    btOptimizedBvh* GetTriangleMeshBvh(unsigned lodLevel, unsigned numTriangles, bool quantized) const;
+
+private:
+    /// Deleter for 16-byte aligned BVH storage.
+    struct AlignedDeleter
+    {
+        void operator()(unsigned char* data) const;
+    };
+
+    /// Cooked data of one LOD level.
+    struct LodLevel
+    {
+        /// Convex hull.
+        CookedConvexHull hull_;
+        /// Number of triangles the BVH was built from.
+        unsigned bvhTriangles_{};
+        /// BVH quantization flag.
+        bool bvhQuantized_{};
+        /// BVH serialized size.
+        unsigned bvhSize_{};
+        /// Aligned BVH storage, deserialized in place.
+        ea::unique_ptr<unsigned char, AlignedDeleter> bvhData_;
+        /// BVH inside the storage.
+        btOptimizedBvh* bvh_{};
+    };
+
+    /// Allocate BVH storage for a LOD level.
+    static void AllocateBvh(LodLevel& lodLevel, unsigned size);
+
+    /// LOD levels.
+    ea::vector<LodLevel> lodLevels_;
+};
+
+}
@@ -27,17 +27,21 @@
 #include "../Core/Context.h"
 #include "../Core/Mutex.h"
 #include "../Core/Profiler.h"
+#include "../Core/Thread.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Model.h"
 #include "../IO/Log.h"
 #include "../Math/Ray.h"
 #include "../Physics/CollisionShape.h"
 #include "../Physics/Constraint.h"
+#include "../Physics/CookedCollisionGeometry.h"
 #include "../Physics/PhysicsEvents.h"
 #include "../Physics/PhysicsUtils.h"
 #include "../Physics/PhysicsWorld.h"
 #include "../Physics/RaycastVehicle.h"
 #include "../Physics/RigidBody.h"
+#include "../Physics/SoundOcclusion.h"
 #include "../Scene/Scene.h"
 #include "../Scene/SceneEvents.h"
 
@@ -49,6 +53,11 @@
 #include <Bullet/BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h>
 #include <Bullet/BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h>
 #include <Bullet/BulletDynamics/Dynamics/btDiscreteDynamicsWorld.h>
+#if BT_THREADSAFE
+#include <Bullet/BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <Bullet/BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
+#include <Bullet/BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#endif
 
 
 extern ContactAddedCallback gContactAddedCallback;
@@ -61,6 +70,8 @@ extern const char* SUBSYSTEM_CATEGORY;
 
 static const int MAX_SOLVER_ITERATIONS = 256;
 static const Vector3 DEFAULT_GRAVITY = Vector3(0.0f, -9.81f, 0.0f);
+static const unsigned CAST_BATCH_SIZE = 16;
+static const float SIMULATION_LOD_INTERVAL = 0.25f;
 
 PhysicsWorldConfig PhysicsWorld::config;
 
@@ -98,6 +109,145 @@ static bool CustomMaterialCombinerCallback(btManifoldPoint& cp, const btCollisio
     return true;
 }
 
+#if BT_THREADSAFE
+/// Bullet task scheduler which runs parallel loops on the work queue. Falls back to serial execution outside the main thread and for nested loops.
+class WorkQueueTaskScheduler : public btITaskScheduler
+{
+public:
+    /// Construct.
+    WorkQueueTaskScheduler() : btITaskScheduler("WorkQueue") {}
+
+    /// Set work queue to use for the following simulation steps.
+    void SetWorkQueue(WorkQueue* workQueue) { workQueue_ = workQueue; }
+
+    /// Return maximum number of threads.
+    int getMaxNumThreads() const override { return BT_MAX_THREAD_COUNT; }
+    /// Return number of threads, including the main thread.
+    int getNumThreads() const override { return workQueue_ ? Min(workQueue_->GetNumThreads() + 1, BT_MAX_THREAD_COUNT) : 1; }
+    /// Set number of threads. Thread count is controlled by the work queue.
+    void setNumThreads(int numThreads) override {}
+
+    /// Execute parallel loop.
+    void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) override
+    {
+        if (!CanRunParallel(iBegin, iEnd, grainSize))
+        {
+            body.forLoop(iBegin, iEnd);
+            return;
+        }
+
+        running_ = true;
+        workQueue_->ParallelFor(iEnd - iBegin, grainSize, [&](unsigned begin, unsigned end, unsigned)
+        {
+            body.forLoop(iBegin + begin, iBegin + end);
+        });
+        running_ = false;
+    }
+
+    /// Execute parallel loop and sum the results.
+    btScalar parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body) override
+    {
+        if (!CanRunParallel(iBegin, iEnd, grainSize))
+            return body.sumLoop(iBegin, iEnd);
+
+        // One partial sum per thread, the work queue passes thread index 0 for the main thread
+        partialSums_.clear();
+        partialSums_.resize(workQueue_->GetNumThreads() + 1, btScalar(0));
+
+        running_ = true;
+        workQueue_->ParallelFor(iEnd - iBegin, grainSize, [&](unsigned begin, unsigned end, unsigned threadIndex)
+        {
+            partialSums_[threadIndex] += body.sumLoop(iBegin + begin, iBegin + end);
+        });
+        running_ = false;
+
+        btScalar sum(0);
+        for (btScalar partialSum : partialSums_)
+            sum += partialSum;
+        return sum;
+    }
+
+private:
+    /// Return whether the loop should be distributed to the work queue.
+    bool CanRunParallel(int iBegin, int iEnd, int grainSize) const
+    {
+        return workQueue_ && workQueue_->GetNumThreads() && !running_ && iEnd - iBegin > grainSize && Thread::IsMainThread();
+    }
+
+    /// Work queue.
+    WeakPtr<WorkQueue> workQueue_;
+    /// Partial sums for parallelSum.
+    ea::vector<btScalar> partialSums_;
+    /// Whether a parallel loop is currently running.
+    bool running_{};
+};
+
+static WorkQueueTaskScheduler& GetWorkQueueTaskScheduler()
+{
+    static WorkQueueTaskScheduler taskScheduler;
+    return taskScheduler;
+}
+#endif
+
+static void ClosestRaycast(btCollisionWorld* world, PhysicsRaycastResult& result, const Ray& ray, float maxDistance, unsigned collisionMask)
+{
+    btCollisionWorld::ClosestRayResultCallback
+        rayCallback(ToBtVector3(ray.origin_), ToBtVector3(ray.origin_ + maxDistance * ray.direction_));
+    rayCallback.m_collisionFilterGroup = (short)0xffff;
+    rayCallback.m_collisionFilterMask = (short)collisionMask;
+
+    world->rayTest(rayCallback.m_rayFromWorld, rayCallback.m_rayToWorld, rayCallback);
+
+    if (rayCallback.hasHit())
+    {
+        result.position_ = ToVector3(rayCallback.m_hitPointWorld);
+        result.normal_ = ToVector3(rayCallback.m_hitNormalWorld);
+        result.distance_ = (result.position_ - ray.origin_).Length();
+        result.hitFraction_ = rayCallback.m_closestHitFraction;
+        result.body_ = static_cast<RigidBody*>(rayCallback.m_collisionObject->getUserPointer());
+    }
+    else
+    {
+        result.position_ = Vector3::ZERO;
+        result.normal_ = Vector3::ZERO;
+        result.distance_ = M_INFINITY;
+        result.hitFraction_ = 0.0f;
+        result.body_ = nullptr;
+    }
+}
+
+static void ClosestSphereCast(btCollisionWorld* world, PhysicsRaycastResult& result, const Ray& ray, float radius, float maxDistance,
+    unsigned collisionMask)
+{
+    btSphereShape shape(radius);
+    Vector3 endPos = ray.origin_ + maxDistance * ray.direction_;
+
+    btCollisionWorld::ClosestConvexResultCallback
+        convexCallback(ToBtVector3(ray.origin_), ToBtVector3(endPos));
+    convexCallback.m_collisionFilterGroup = (short)0xffff;
+    convexCallback.m_collisionFilterMask = (short)collisionMask;
+
+    world->convexSweepTest(&shape, btTransform(btQuaternion::getIdentity(), convexCallback.m_convexFromWorld),
+        btTransform(btQuaternion::getIdentity(), convexCallback.m_convexToWorld), convexCallback);
+
+    if (convexCallback.hasHit())
+    {
+        result.body_ = static_cast<RigidBody*>(convexCallback.m_hitCollisionObject->getUserPointer());
+        result.position_ = ToVector3(convexCallback.m_hitPointWorld);
+        result.normal_ = ToVector3(convexCallback.m_hitNormalWorld);
+        result.distance_ = convexCallback.m_closestHitFraction * (endPos - ray.origin_).Length();
+        result.hitFraction_ = convexCallback.m_closestHitFraction;
+    }
+    else
+    {
+        result.body_ = nullptr;
+        result.position_ = Vector3::ZERO;
+        result.normal_ = Vector3::ZERO;
+        result.distance_ = M_INFINITY;
+        result.hitFraction_ = 0.0f;
+    }
+}
+
 void RemoveCachedGeometryImpl(CollisionGeometryDataCache& cache, Model* model)
 {
     for (auto i = cache.begin(); i != cache.end();)
@@ -159,20 +309,8 @@ PhysicsWorld::PhysicsWorld(Context* context) :
     else
         collisionConfiguration_ = new btDefaultCollisionConfiguration();
 
-    collisionDispatcher_ = ea::make_unique<btCollisionDispatcher>(collisionConfiguration_);
-    btGImpactCollisionAlgorithm::registerAlgorithm(static_cast<btCollisionDispatcher*>(collisionDispatcher_.get()));
-
     broadphase_ = ea::make_unique<btDbvtBroadphase>();
-    solver_ = ea::make_unique<btSequentialImpulseConstraintSolver>();
-    world_ = ea::make_unique<btDiscreteDynamicsWorld>(collisionDispatcher_.get(), broadphase_.get(), solver_.get(), collisionConfiguration_);
-
-    world_->setGravity(ToBtVector3(DEFAULT_GRAVITY));
-    world_->getDispatchInfo().m_useContinuous = true;
-    world_->getSolverInfo().m_splitImpulse = false; // Disable by default for performance
-    world_->setDebugDrawer(this);
-    world_->setInternalTickCallback(InternalPreTickCallback, static_cast<void*>(this), true);
-    world_->setInternalTickCallback(InternalTickCallback, static_cast<void*>(this), false);
-    world_->setSynchronizeAllMotionStates(true);
+    CreateWorld();
 }
 
 PhysicsWorld::~PhysicsWorld()
@@ -191,6 +329,7 @@ PhysicsWorld::~PhysicsWorld()
     }
 
     world_.reset();
+    solverMt_.reset();
     solver_.reset();
     broadphase_.reset();
     collisionDispatcher_.reset();
@@ -213,6 +352,11 @@ void PhysicsWorld::RegisterObject(Context* context)
     URHO3D_ATTRIBUTE("Interpolation", bool, interpolation_, true, AM_FILE);
     URHO3D_ATTRIBUTE("Internal Edge Utility", bool, internalEdge_, true, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Split Impulse", GetSplitImpulse, SetSplitImpulse, bool, false, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Multithreaded", GetMultithreaded, SetMultithreaded, bool, false, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("LOD Sleep Distance", GetLodSleepDistance, SetLodSleepDistance, float, 0.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("LOD Freeze Distance", GetLodFreezeDistance, SetLodFreezeDistance, float, 0.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("LOD Sleep Threshold Scale", GetLodSleepThresholdScale, SetLodSleepThresholdScale, float,
+        DEFAULT_LOD_SLEEP_THRESHOLD_SCALE, AM_DEFAULT);
 }
 
 bool PhysicsWorld::isVisible(const btVector3& aabbMin, const btVector3& aabbMax)
@@ -270,9 +414,16 @@ void PhysicsWorld::Update(float timeStep)
     else if (maxSubSteps_ > 0)
         maxSubSteps = Min(maxSubSteps, maxSubSteps_);
 
+    UpdateSimulationLod(timeStep);
+
     delayedWorldTransforms_.clear();
     simulating_ = true;
 
+#if BT_THREADSAFE
+    if (multithreaded_)
+        GetWorkQueueTaskScheduler().SetWorkQueue(GetSubsystem<WorkQueue>());
+#endif
+
     if (interpolation_)
         world_->stepSimulation(timeStep, maxSubSteps, internalTimeStep);
     else
@@ -288,29 +439,131 @@ void PhysicsWorld::Update(float timeStep)
 
     simulating_ = false;
 
-    // Apply delayed (parented) world transforms now
-    while (!delayedWorldTransforms_.empty())
+    ApplyDelayedWorldTransforms();
+}
+
+void PhysicsWorld::UpdateCollisions()
+{
+    world_->performDiscreteCollisionDetection();
+}
+
+void PhysicsWorld::SimulateSteps(unsigned numSteps)
+{
+    URHO3D_PROFILE("SimulatePhysicsSteps");
+
+    const float internalTimeStep = 1.0f / fps_;
+
+#if BT_THREADSAFE
+    if (multithreaded_)
+        GetWorkQueueTaskScheduler().SetWorkQueue(GetSubsystem<WorkQueue>());
+#endif
+
+    delayedWorldTransforms_.clear();
+    simulating_ = true;
+
+    for (unsigned i = 0; i < numSteps; ++i)
+        world_->stepSimulation(internalTimeStep, 0, internalTimeStep);
+
+    simulating_ = false;
+
+    ApplyDelayedWorldTransforms();
+}
+
+void PhysicsWorld::SaveState(Serializer& dest) const
+{
+    unsigned numBodies = 0;
+    for (RigidBody* rigidBody : rigidBodies_)
     {
-        for (auto i = delayedWorldTransforms_.begin();
-             i != delayedWorldTransforms_.end();)
-        {
-            const DelayedWorldTransform& transform = i->second;
+        if (rigidBody->GetBody())
+            ++numBodies;
+    }
 
-            // If parent's transform has already been assigned, can proceed
-            if (!delayedWorldTransforms_.contains(transform.parentRigidBody_))
-            {
-                transform.rigidBody_->ApplyWorldTransform(transform.worldPosition_, transform.worldRotation_);
-                i = delayedWorldTransforms_.erase(i);
-            }
-            else
-                ++i;
-        }
+    dest.WriteVLE(numBodies);
+    for (RigidBody* rigidBody : rigidBodies_)
+    {
+        const btRigidBody* body = rigidBody->GetBody();
+        if (!body)
+            continue;
+
+        const btTransform& transform = body->getWorldTransform();
+        dest.WriteUInt(rigidBody->GetID());
+        dest.WriteVector3(ToVector3(transform.getOrigin()));
+        dest.WriteQuaternion(ToQuaternion(transform.getRotation()));
+        dest.WriteVector3(ToVector3(body->getLinearVelocity()));
+        dest.WriteVector3(ToVector3(body->getAngularVelocity()));
+        dest.WriteUByte((unsigned char)body->getActivationState());
+        dest.WriteFloat(body->getDeactivationTime());
     }
 }
 
-void PhysicsWorld::UpdateCollisions()
+bool PhysicsWorld::RestoreState(Deserializer& source)
 {
-    world_->performDiscreteCollisionDetection();
+    URHO3D_PROFILE("RestorePhysicsState");
+
+    if (simulating_)
+    {
+        URHO3D_LOGERROR("Can not restore physics state during simulation step");
+        return false;
+    }
+
+    Scene* scene = GetScene();
+    if (!scene)
+        return false;
+
+    delayedWorldTransforms_.clear();
+
+    const unsigned numBodies = source.ReadVLE();
+    for (unsigned i = 0; i < numBodies; ++i)
+    {
+        if (source.IsEof())
+        {
+            URHO3D_LOGERROR("Truncated physics state snapshot");
+            return false;
+        }
+
+        const unsigned id = source.ReadUInt();
+        const Vector3 position = source.ReadVector3();
+        const Quaternion rotation = source.ReadQuaternion();
+        const btVector3 linearVelocity = ToBtVector3(source.ReadVector3());
+        const btVector3 angularVelocity = ToBtVector3(source.ReadVector3());
+        const int activationState = source.ReadUByte();
+        const float deactivationTime = source.ReadFloat();
+
+        auto* rigidBody = dynamic_cast<RigidBody*>(scene->GetComponent(id));
+        btRigidBody* body = rigidBody ? rigidBody->GetBody() : nullptr;
+        if (!body)
+            continue;
+
+        const btTransform transform(ToBtQuaternion(rotation), ToBtVector3(position));
+        body->setWorldTransform(transform);
+        body->setInterpolationWorldTransform(transform);
+        body->setLinearVelocity(linearVelocity);
+        body->setAngularVelocity(angularVelocity);
+        body->setInterpolationLinearVelocity(linearVelocity);
+        body->setInterpolationAngularVelocity(angularVelocity);
+        body->clearForces();
+
+        // The motion state ignores inactive bodies, so apply the node transform before restoring the activation state
+        body->forceActivationState(ACTIVE_TAG);
+        rigidBody->setWorldTransform(transform);
+        body->forceActivationState(activationState);
+        body->setDeactivationTime(deactivationTime);
+
+        // Drop cached contacts, as they would warm start the solver with impulses from the discarded timeline
+        if (btBroadphaseProxy* proxy = body->getBroadphaseHandle())
+        {
+            broadphase_->getOverlappingPairCache()->cleanProxyFromPairs(proxy, collisionDispatcher_.get());
+            world_->updateSingleAabb(body);
+        }
+    }
+
+    ApplyDelayedWorldTransforms();
+
+    solver_->reset();
+    if (solverMt_)
+        solverMt_->reset();
+
+    return true;
 }
 
 void PhysicsWorld::SetFps(int fps)
@@ -365,6 +618,35 @@ void PhysicsWorld::SetSplitImpulse(bool enable)
     MarkNetworkUpdate();
 }
 
+void PhysicsWorld::SetMultithreaded(bool enable)
+{
+    if (enable == multithreaded_)
+        return;
+
+    if (simulating_)
+    {
+        URHO3D_LOGERROR("Can not change physics threading mode during simulation step");
+        return;
+    }
+
+    // Vehicles keep a pointer to the Bullet world in their raycaster, so the world can not be replaced under them
+    if (node_)
+    {
+        ea::vector<RaycastVehicle*> vehicles;
+        node_->GetComponents<RaycastVehicle>(vehicles, true);
+        if (!vehicles.empty())
+        {
+            URHO3D_LOGERROR("Can not change physics threading mode while the scene contains vehicles");
+            return;
+        }
+    }
+
+    multithreaded_ = enable;
+    CreateWorld();
+
+    MarkNetworkUpdate();
+}
+
 void PhysicsWorld::SetMaxNetworkAngularVelocity(float velocity)
 {
     maxNetworkAngularVelocity_ = Clamp(velocity, 1.0f, 32767.0f);
@@ -372,6 +654,37 @@ void PhysicsWorld::SetMaxNetworkAngularVelocity(float velocity)
     MarkNetworkUpdate();
 }
 
+void PhysicsWorld::SetLodSleepDistance(float distance)
+{
+    lodSleepDistance_ = Max(distance, 0.0f);
+}
+
+void PhysicsWorld::SetLodFreezeDistance(float distance)
+{
+    lodFreezeDistance_ = Max(distance, 0.0f);
+}
+
+void PhysicsWorld::SetLodSleepThresholdScale(float scale)
+{
+    lodSleepThresholdScale_ = Max(scale, 1.0f);
+}
+
+void PhysicsWorld::AddLodAnchor(Node* node)
+{
+    if (node && !lodAnchors_.contains(WeakPtr<Node>(node)))
+        lodAnchors_.emplace_back(node);
+}
+
+void PhysicsWorld::RemoveLodAnchor(Node* node)
+{
+    lodAnchors_.erase_first(WeakPtr<Node>(node));
+}
+
+void PhysicsWorld::RemoveAllLodAnchors()
+{
+    lodAnchors_.clear();
+}
+
 void PhysicsWorld::Raycast(ea::vector<PhysicsRaycastResult>& result, const Ray& ray, float maxDistance, unsigned collisionMask)
 {
     URHO3D_PROFILE("PhysicsRaycast");
@@ -407,29 +720,7 @@ void PhysicsWorld::RaycastSingle(PhysicsRaycastResult& result, const Ray& ray, f
     if (maxDistance >= M_INFINITY)
         URHO3D_LOGWARNING("Infinite maxDistance in physics raycast is not supported");
 
-    btCollisionWorld::ClosestRayResultCallback
-        rayCallback(ToBtVector3(ray.origin_), ToBtVector3(ray.origin_ + maxDistance * ray.direction_));
-    rayCallback.m_collisionFilterGroup = (short)0xffff;
-    rayCallback.m_collisionFilterMask = (short)collisionMask;
-
-    world_->rayTest(rayCallback.m_rayFromWorld, rayCallback.m_rayToWorld, rayCallback);
-
-    if (rayCallback.hasHit())
-    {
-        result.position_ = ToVector3(rayCallback.m_hitPointWorld);
-        result.normal_ = ToVector3(rayCallback.m_hitNormalWorld);
-        result.distance_ = (result.position_ - ray.origin_).Length();
-        result.hitFraction_ = rayCallback.m_closestHitFraction;
-        result.body_ = static_cast<RigidBody*>(rayCallback.m_collisionObject->getUserPointer());
-    }
-    else
-    {
-        result.position_ = Vector3::ZERO;
-        result.normal_ = Vector3::ZERO;
-        result.distance_ = M_INFINITY;
-        result.hitFraction_ = 0.0f;
-        result.body_ = nullptr;
-    }
+    ClosestRaycast(world_.get(), result, ray, maxDistance, collisionMask);
 }
 
 void PhysicsWorld::RaycastSingleSegmented(PhysicsRaycastResult& result, const Ray& ray, float maxDistance, float segmentDistance, unsigned collisionMask, float overlapDistance)
@@ -491,33 +782,47 @@ void PhysicsWorld::SphereCast(PhysicsRaycastResult& result, const Ray& ray, floa
     if (maxDistance >= M_INFINITY)
         URHO3D_LOGWARNING("Infinite maxDistance in physics sphere cast is not supported");
 
-    btSphereShape shape(radius);
-    Vector3 endPos = ray.origin_ + maxDistance * ray.direction_;
+    ClosestSphereCast(world_.get(), result, ray, radius, maxDistance, collisionMask);
+}
 
-    btCollisionWorld::ClosestConvexResultCallback
-        convexCallback(ToBtVector3(ray.origin_), ToBtVector3(endPos));
-    convexCallback.m_collisionFilterGroup = (short)0xffff;
-    convexCallback.m_collisionFilterMask = (short)collisionMask;
+void PhysicsWorld::CastBatch(ea::vector<PhysicsRaycastResult>& result, const ea::vector<PhysicsCastQuery>& queries)
+{
+    URHO3D_PROFILE("PhysicsCastBatch");
 
-    world_->convexSweepTest(&shape, btTransform(btQuaternion::getIdentity(), convexCallback.m_convexFromWorld),
-        btTransform(btQuaternion::getIdentity(), convexCallback.m_convexToWorld), convexCallback);
+    result.resize(queries.size());
+    if (queries.empty())
+        return;
 
-    if (convexCallback.hasHit())
+    if (simulating_)
     {
-        result.body_ = static_cast<RigidBody*>(convexCallback.m_hitCollisionObject->getUserPointer());
-        result.position_ = ToVector3(convexCallback.m_hitPointWorld);
-        result.normal_ = ToVector3(convexCallback.m_hitNormalWorld);
-        result.distance_ = convexCallback.m_closestHitFraction * (endPos - ray.origin_).Length();
-        result.hitFraction_ = convexCallback.m_closestHitFraction;
+        URHO3D_LOGERROR("Can not perform physics queries during simulation step");
+        return;
     }
-    else
+
+    btDiscreteDynamicsWorld* world = world_.get();
+    const auto processQueries = [&](unsigned begin, unsigned end, unsigned)
     {
-        result.body_ = nullptr;
-        result.position_ = Vector3::ZERO;
-        result.normal_ = Vector3::ZERO;
-        result.distance_ = M_INFINITY;
-        result.hitFraction_ = 0.0f;
+        for (unsigned i = begin; i < end; ++i)
+        {
+            const PhysicsCastQuery& query = queries[i];
+            if (query.radius_ > 0.0f)
+                ClosestSphereCast(world, result[i], query.ray_, query.radius_, query.maxDistance_, query.collisionMask_);
+            else
+                ClosestRaycast(world, result[i], query.ray_, query.maxDistance_, query.collisionMask_);
+        }
+    };
+
+#if BT_THREADSAFE
+    // Broadphase ray tests only use per-call traversal stacks in the thread-safe Bullet build
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    if (workQueue && Thread::IsMainThread())
+    {
+        workQueue->ParallelFor(queries.size(), CAST_BATCH_SIZE, processQueries);
+        return;
     }
+#endif
+
+    processQueries(0, queries.size(), 0);
 }
 
 void PhysicsWorld::ConvexCast(PhysicsRaycastResult& result, CollisionShape* shape, const Vector3& startPos,
@@ -829,6 +1134,194 @@ void PhysicsWorld::PostStep(float timeStep)
     SendEvent(E_PHYSICSPOSTSTEP, eventData);
 }
 
+void PhysicsWorld::CreateWorld()
+{
+    struct CollisionObjectDesc
+    {
+        btCollisionObject* object_;
+        int group_;
+        int mask_;
+        btVector3 gravity_;
+    };
+
+    // Detach constraints and collision objects from the previous world so that they can be moved to the new one
+    ea::vector<ea::pair<btTypedConstraint*, bool>> constraints;
+    ea::vector<CollisionObjectDesc> collisionObjects;
+    btContactSolverInfo solverInfo;
+    btVector3 gravity = ToBtVector3(DEFAULT_GRAVITY);
+    if (world_)
+    {
+        solverInfo = world_->getSolverInfo();
+        gravity = world_->getGravity();
+
+        for (int i = world_->getNumConstraints() - 1; i >= 0; --i)
+        {
+            btTypedConstraint* constraint = world_->getConstraint(i);
+            // Disabled collision between linked bodies is recorded as a constraint reference on the bodies
+            btRigidBody& bodyA = constraint->getRigidBodyA();
+            bool disableCollision = false;
+            for (int j = 0; j < bodyA.getNumConstraintRefs(); ++j)
+            {
+                if (bodyA.getConstraintRef(j) == constraint)
+                {
+                    disableCollision = true;
+                    break;
+                }
+            }
+            constraints.emplace_back(constraint, disableCollision);
+            world_->removeConstraint(constraint);
+        }
+
+        btCollisionObjectArray& objects = world_->getCollisionObjectArray();
+        for (int i = objects.size() - 1; i >= 0; --i)
+        {
+            btCollisionObject* object = objects[i];
+            btBroadphaseProxy* proxy = object->getBroadphaseHandle();
+            btRigidBody* body = btRigidBody::upcast(object);
+            collisionObjects.push_back({object, proxy ? proxy->m_collisionFilterGroup : 0, proxy ? proxy->m_collisionFilterMask : 0,
+                body ? body->getGravity() : btVector3(0.0f, 0.0f, 0.0f)});
+            if (body)
+                world_->removeRigidBody(body);
+            else
+                world_->removeCollisionObject(object);
+        }
+
+        world_.reset();
+    }
+    else
+        solverInfo.m_splitImpulse = false; // Disable by default for performance
+
+    solverMt_.reset();
+    solver_.reset();
+    collisionDispatcher_.reset();
+
+#if BT_THREADSAFE
+    if (multithreaded_)
+    {
+        // Bullet requires the scheduler to be set from the main thread before any Mt world is stepped
+        auto* workQueue = GetSubsystem<WorkQueue>();
+        WorkQueueTaskScheduler& taskScheduler = GetWorkQueueTaskScheduler();
+        taskScheduler.SetWorkQueue(workQueue);
+        if (btGetTaskScheduler() != &taskScheduler)
+            btSetTaskScheduler(&taskScheduler);
+
+        const int numSolvers = taskScheduler.getNumThreads();
+        collisionDispatcher_ = ea::make_unique<btCollisionDispatcherMt>(collisionConfiguration_);
+        solver_ = ea::make_unique<btConstraintSolverPoolMt>(numSolvers);
+        solverMt_ = ea::make_unique<btSequentialImpulseConstraintSolverMt>();
+        world_ = ea::make_unique<btDiscreteDynamicsWorldMt>(collisionDispatcher_.get(), broadphase_.get(),
+            static_cast<btConstraintSolverPoolMt*>(solver_.get()), solverMt_.get(), collisionConfiguration_);
+    }
+    else
+#endif
+    {
+        collisionDispatcher_ = ea::make_unique<btCollisionDispatcher>(collisionConfiguration_);
+        solver_ = ea::make_unique<btSequentialImpulseConstraintSolver>();
+        world_ = ea::make_unique<btDiscreteDynamicsWorld>(collisionDispatcher_.get(), broadphase_.get(), solver_.get(), collisionConfiguration_);
+    }
+
+    btGImpactCollisionAlgorithm::registerAlgorithm(static_cast<btCollisionDispatcher*>(collisionDispatcher_.get()));
+
+    world_->setGravity(gravity);
+    world_->getSolverInfo() = solverInfo;
+    world_->getDispatchInfo().m_useContinuous = true;
+    world_->setDebugDrawer(this);
+    world_->setInternalTickCallback(InternalPreTickCallback, static_cast<void*>(this), true);
+    world_->setInternalTickCallback(InternalTickCallback, static_cast<void*>(this), false);
+    world_->setSynchronizeAllMotionStates(true);
+
+    // Re-add in the original order
+    for (auto i = collisionObjects.rbegin(); i != collisionObjects.rend(); ++i)
+    {
+        if (btRigidBody* body = btRigidBody::upcast(i->object_))
+        {
+            world_->addRigidBody(body, i->group_, i->mask_);
+            // Adding to the world resets gravity, restore possible per-body override
+            body->setGravity(i->gravity_);
+        }
+        else
+            world_->addCollisionObject(i->object_, i->group_, i->mask_);
+    }
+
+    for (auto i = constraints.rbegin(); i != constraints.rend(); ++i)
+        world_->addConstraint(i->first, i->second);
+}
+
+void PhysicsWorld::ApplyDelayedWorldTransforms()
+{
+    while (!delayedWorldTransforms_.empty())
+    {
+        for (auto i = delayedWorldTransforms_.begin();
+             i != delayedWorldTransforms_.end();)
+        {
+            const DelayedWorldTransform& transform = i->second;
+
+            // If parent's transform has already been assigned, can proceed
+            if (!delayedWorldTransforms_.contains(transform.parentRigidBody_))
+            {
+                transform.rigidBody_->ApplyWorldTransform(transform.worldPosition_, transform.worldRotation_);
+                i = delayedWorldTransforms_.erase(i);
+            }
+            else
+                ++i;
+        }
+    }
+}
+
+void PhysicsWorld::UpdateSimulationLod(float timeStep)
+{
+    if ((lodSleepDistance_ <= 0.0f && lodFreezeDistance_ <= 0.0f) || lodAnchors_.empty())
+        return;
+
+    lodTimer_ += timeStep;
+    if (lodTimer_ < SIMULATION_LOD_INTERVAL)
+        return;
+    lodTimer_ = 0.0f;
+
+    URHO3D_PROFILE("UpdateSimulationLod");
+
+    ea::erase_if(lodAnchors_, [](const WeakPtr<Node>& anchor) { return anchor.Expired(); });
+    if (lodAnchors_.empty())
+        return;
+
+    ea::vector<Vector3> anchorPositions;
+    anchorPositions.reserve(lodAnchors_.size());
+    for (const WeakPtr<Node>& anchor : lodAnchors_)
+        anchorPositions.push_back(anchor->GetWorldPosition());
+
+    const float sleepDistanceSquared = lodSleepDistance_ > 0.0f ? lodSleepDistance_ * lodSleepDistance_ : M_INFINITY;
+    const float freezeDistanceSquared = lodFreezeDistance_ > 0.0f ? lodFreezeDistance_ * lodFreezeDistance_ : M_INFINITY;
+    const float thresholdScaleSquared = lodSleepThresholdScale_ * lodSleepThresholdScale_;
+
+    for (RigidBody* rigidBody : rigidBodies_)
+    {
+        btRigidBody* body = rigidBody->GetBody();
+        if (!body || !body->isActive() || body->isStaticOrKinematicObject() || !rigidBody->GetSimulationLod())
+            continue;
+
+        const Vector3 position = ToVector3(body->getWorldTransform().getOrigin());
+        float distanceSquared = M_INFINITY;
+        for (const Vector3& anchorPosition : anchorPositions)
+            distanceSquared = Min(distanceSquared, (position - anchorPosition).LengthSquared());
+
+        if (distanceSquared < sleepDistanceSquared && distanceSquared < freezeDistanceSquared)
+            continue;
+
+        // Bullet keeps the whole island awake if any of its bodies is active, so bodies touching nearby ones stay simulated
+        bool sleep = distanceSquared >= freezeDistanceSquared;
+        if (!sleep)
+        {
+            const float linearThreshold = body->getLinearSleepingThreshold();
+            const float angularThreshold = body->getAngularSleepingThreshold();
+            sleep = body->getLinearVelocity().length2() < linearThreshold * linearThreshold * thresholdScaleSquared &&
+                body->getAngularVelocity().length2() < angularThreshold * angularThreshold * thresholdScaleSquared;
+        }
+
+        if (sleep)
+            body->setActivationState(ISLAND_SLEEPING);
+    }
+}
+
 void PhysicsWorld::SendCollisionEvents()
 {
     URHO3D_PROFILE("SendCollisionEvents");
@@ -1078,10 +1571,12 @@ void PhysicsWorld::SendCollisionEvents()
 void RegisterPhysicsLibrary(Context* context)
 {
     CollisionShape::RegisterObject(context);
+    CookedCollisionGeometry::RegisterObject(context);
     RigidBody::RegisterObject(context);
     Constraint::RegisterObject(context);
     PhysicsWorld::RegisterObject(context);
     RaycastVehicle::RegisterObject(context);
+    SoundOcclusion::RegisterObject(context);
 }
 
 }
@@ -26,6 +26,7 @@
 
 #include "../IO/VectorBuffer.h"
 #include "../Math/BoundingBox.h"
+#include "../Math/Ray.h"
 #include "../Math/Sphere.h"
 #include "../Math/Vector3.h"
 #include "../Scene/Component.h"
@@ -49,7 +50,6 @@ class Deserializer;
 class Constraint;
 class Model;
 class Node;
-class Ray;
 class RigidBody;
 class Scene;
 class Serializer;
@@ -78,6 +78,19 @@ struct URHO3D_API PhysicsRaycastResult
     RigidBody* body_{};
 };
 
+/// Physics query for batched casts. Performs a raycast if radius is zero, otherwise a swept sphere test.
+struct URHO3D_API PhysicsCastQuery
+{
+    /// Query ray.
+    Ray ray_;
+    /// Maximum distance along the ray.
+    float maxDistance_{};
+    /// Sphere radius, or zero for a raycast.
+    float radius_{};
+    /// Collision mask.
+    unsigned collisionMask_{M_MAX_UNSIGNED};
+};
+
 /// Delayed world transform assignment for parented rigidbodies.
 struct DelayedWorldTransform
 {
@@ -121,6 +134,7 @@ struct PhysicsWorldConfig
 
 static const int DEFAULT_FPS = 60;
 static const float DEFAULT_MAX_NETWORK_ANGULAR_VELOCITY = 100.0f;
+static const float DEFAULT_LOD_SLEEP_THRESHOLD_SCALE = 4.0f;
 
 /// Cache of collision geometry data.
 using CollisionGeometryDataCache = ea::unordered_map<ea::pair<Model*, unsigned>, SharedPtr<CollisionGeometryData> >;
@@ -167,6 +181,12 @@ public:
     void Update(float timeStep);
     /// Refresh collisions only without updating dynamics.
     void UpdateCollisions();
+    /// Perform a number of fixed simulation steps immediately, for example to re-simulate after restoring a state snapshot. Sends the usual pre- and post-step events.
+    void SimulateSteps(unsigned numSteps);
+    /// Write a compact snapshot of transforms, velocities and activation states of all rigid bodies.
+    void SaveState(Serializer& dest) const;
+    /// Restore rigid body state from a snapshot. Rigid bodies are matched by component ID; bodies missing from the scene are skipped. Cached contacts are cleared so that re-simulation from the same snapshot is repeatable. Return true if successful.
+    bool RestoreState(Deserializer& source);
     /// Set simulation substeps per second.
     /// @property
     void SetFps(int fps);
@@ -191,8 +211,26 @@ public:
     /// Set split impulse collision mode. This is more accurate, but slower. Disabled by default.
     /// @property
     void SetSplitImpulse(bool enable);
+    /// Set whether to use the multithreaded Bullet world, which runs collision dispatch and constraint solving on the work queue threads. Rebuilds the Bullet world; rigid bodies and constraints are moved to the new world. Has no effect if the engine is built without threading. Disabled by default.
+    /// @property
+    void SetMultithreaded(bool enable);
     /// Set maximum angular velocity for network replication.
     void SetMaxNetworkAngularVelocity(float velocity);
+    /// Set distance from the nearest simulation LOD anchor beyond which slowly moving rigid bodies are put to sleep using scaled rest thresholds. 0 disables, which is the default.
+    /// @property
+    void SetLodSleepDistance(float distance);
+    /// Set distance from the nearest simulation LOD anchor beyond which rigid bodies are put to sleep regardless of velocity. Sleeping bodies wake up on interaction with active bodies. 0 disables, which is the default.
+    /// @property
+    void SetLodFreezeDistance(float distance);
+    /// Set rest threshold multiplier applied to rigid bodies beyond the LOD sleep distance.
+    /// @property
+    void SetLodSleepThresholdScale(float scale);
+    /// Add a node, for example a camera or a client's controlled node, whose position is used as a simulation LOD anchor.
+    void AddLodAnchor(Node* node);
+    /// Remove a simulation LOD anchor.
+    void RemoveLodAnchor(Node* node);
+    /// Remove all simulation LOD anchors.
+    void RemoveAllLodAnchors();
     /// Perform a physics world raycast and return all hits.
     void Raycast
         (ea::vector<PhysicsRaycastResult>& result, const Ray& ray, float maxDistance, unsigned collisionMask = M_MAX_UNSIGNED);
@@ -204,6 +242,8 @@ public:
     /// Perform a physics world swept sphere test and return the closest hit.
     void SphereCast
         (PhysicsRaycastResult& result, const Ray& ray, float radius, float maxDistance, unsigned collisionMask = M_MAX_UNSIGNED);
+    /// Perform a batch of raycasts and swept sphere tests and return the closest hit of each query at the same index. Queries run in parallel on the work queue threads when called from the main thread. Can not be called during the simulation step.
+    void CastBatch(ea::vector<PhysicsRaycastResult>& result, const ea::vector<PhysicsCastQuery>& queries);
     /// Perform a physics world swept convex test using a user-supplied collision shape and return the first hit.
     void ConvexCast(PhysicsRaycastResult& result, CollisionShape* shape, const Vector3& startPos, const Quaternion& startRot,
         const Vector3& endPos, const Quaternion& endRot, unsigned collisionMask = M_MAX_UNSIGNED);
@@ -249,6 +289,10 @@ public:
     /// @property
     bool GetSplitImpulse() const;
 
+    /// Return whether the multithreaded Bullet world is used.
+    /// @property
+    bool GetMultithreaded() const { return multithreaded_; }
+
     /// Return simulation steps per second.
     /// @property
     int GetFps() const { return fps_; }
@@ -256,6 +300,18 @@ public:
     /// Return maximum angular velocity for network replication.
     float GetMaxNetworkAngularVelocity() const { return maxNetworkAngularVelocity_; }
 
+    /// Return simulation LOD sleep distance.
+    /// @property
+    float GetLodSleepDistance() const { return lodSleepDistance_; }
+    /// Return simulation LOD freeze distance.
+    /// @property
+    float GetLodFreezeDistance() const { return lodFreezeDistance_; }
+    /// Return rest threshold multiplier for rigid bodies beyond the LOD sleep distance.
+    /// @property
+    float GetLodSleepThresholdScale() const { return lodSleepThresholdScale_; }
+    /// Return simulation LOD anchors.
+    const ea::vector<WeakPtr<Node>>& GetLodAnchors() const { return lodAnchors_; }
+
     /// Add a rigid body to keep track of. Called by RigidBody.
     void AddRigidBody(RigidBody* body);
     /// Remove a rigid body. Called by RigidBody.
@@ -317,6 +373,12 @@ private:
     void PostStep(float timeStep);
     /// Send accumulated collision events.
     void SendCollisionEvents();
+    /// Apply world transforms of parented rigid bodies which were delayed during the simulation step.
+    void ApplyDelayedWorldTransforms();
+    /// Put rigid bodies far from the simulation LOD anchors to sleep.
+    void UpdateSimulationLod(float timeStep);
+    /// Create the Bullet dispatcher, solver and world for the current threading mode. Moves collision objects and constraints from the previous world, if any.
+    void CreateWorld();
 
     /// Bullet collision configuration.
     btCollisionConfiguration* collisionConfiguration_{};
@@ -326,6 +388,8 @@ private:
     ea::unique_ptr<btBroadphaseInterface> broadphase_;
     /// Bullet constraint solver.
     ea::unique_ptr<btConstraintSolver> solver_;
+    /// Bullet multithreaded constraint solver for large islands. Null in single-threaded mode.
+    ea::unique_ptr<btConstraintSolver> solverMt_;
     /// Bullet physics world.
     ea::unique_ptr<btDiscreteDynamicsWorld> world_;
     /// Extra weak pointer to scene to allow for cleanup in case the world is destroyed before other components.
@@ -362,12 +426,24 @@ private:
     float timeAcc_{};
     /// Maximum angular velocity for network replication.
     float maxNetworkAngularVelocity_{DEFAULT_MAX_NETWORK_ANGULAR_VELOCITY};
+    /// Simulation LOD anchors.
+    ea::vector<WeakPtr<Node>> lodAnchors_;
+    /// Simulation LOD sleep distance.
+    float lodSleepDistance_{};
+    /// Simulation LOD freeze distance.
+    float lodFreezeDistance_{};
+    /// Rest threshold multiplier beyond the LOD sleep distance.
+    float lodSleepThresholdScale_{DEFAULT_LOD_SLEEP_THRESHOLD_SCALE};
+    /// Time accumulator for simulation LOD updates.
+    float lodTimer_{};
     /// Automatic simulation update enabled flag.
     bool updateEnabled_{true};
     /// Interpolation flag.
     bool interpolation_{true};
     /// Use internal edge utility flag.
     bool internalEdge_{true};
+    /// Multithreaded Bullet world flag.
+    bool multithreaded_{};
     /// Applying transforms flag.
     bool applyingTransforms_{};
     /// Simulating flag.
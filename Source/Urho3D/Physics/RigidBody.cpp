@@ -74,6 +74,7 @@ RigidBody::RigidBody(Context* context) :
     kinematic_(false),
     trigger_(false),
     useGravity_(true),
+    simulationLod_(true),
     readdBody_(false),
     inWorld_(false),
     enableMassUpdate_(true),
@@ -126,6 +127,7 @@ void RigidBody::RegisterObject(Context* context)
     URHO3D_ATTRIBUTE_EX("Is Kinematic", bool, kinematic_, MarkBodyDirty, false, AM_DEFAULT);
     URHO3D_ATTRIBUTE_EX("Is Trigger", bool, trigger_, MarkBodyDirty, false, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Gravity Override", GetGravityOverride, SetGravityOverride, Vector3, Vector3::ZERO, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Simulation LOD", GetSimulationLod, SetSimulationLod, bool, true, AM_DEFAULT);
 }
 
 void RigidBody::ApplyAttributes()
@@ -446,6 +448,15 @@ void RigidBody::SetUseGravity(bool enable)
     }
 }
 
+void RigidBody::SetSimulationLod(bool enable)
+{
+    if (enable != simulationLod_)
+    {
+        simulationLod_ = enable;
+        MarkNetworkUpdate();
+    }
+}
+
 void RigidBody::SetGravityOverride(const Vector3& gravity)
 {
     if (gravity != gravityOverride_)
@@ -151,6 +151,9 @@ public:
     void SetCollisionMask(unsigned mask);
     /// Set collision group and mask.
     void SetCollisionLayerAndMask(unsigned layer, unsigned mask);
+    /// Set whether the physics world may put the rigid body to sleep when it is far from all simulation LOD anchors. Enabled by default.
+    /// @property
+    void SetSimulationLod(bool enable);
     /// Set collision event signaling mode. Default is to signal when rigid bodies are active.
     /// @property
     void SetCollisionEventMode(CollisionEventMode mode);
@@ -248,6 +251,10 @@ public:
     /// @property
     bool GetUseGravity() const { return useGravity_; }
 
+    /// Return whether simulation LOD is enabled for the rigid body.
+    /// @property
+    bool GetSimulationLod() const { return simulationLod_; }
+
     /// Return gravity override. If zero (default), uses the physics world's gravity.
     /// @property
     const Vector3& GetGravityOverride() const { return gravityOverride_; }
@@ -356,6 +363,8 @@ private:
     bool trigger_;
     /// Use gravity flag.
     bool useGravity_;
+    /// Simulation LOD flag.
+    bool simulationLod_;
     /// Readd body to world flag.
     bool readdBody_;
     /// Body exists in world flag.
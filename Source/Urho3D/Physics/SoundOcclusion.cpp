@@ -0,0 +1,161 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#include "../Precompiled.h"
+
+#include "../Audio/Audio.h"
+#include "../Audio/SoundListener.h"
+#include "../Audio/SoundSource3D.h"
+#include "../Core/Context.h"
+#include "../Core/Profiler.h"
+#include "../Physics/SoundOcclusion.h"
+#include "../Scene/Node.h"
+#include "../Scene/Scene.h"
+#include "../Scene/SceneEvents.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+static const unsigned DEFAULT_QUERIES_PER_FRAME = 16;
+static const float DEFAULT_SMOOTHING_SPEED = 8.0f;
+static const float DEFAULT_SOURCE_MARGIN = 0.25f;
+
+extern const char* PHYSICS_CATEGORY;
+
+SoundOcclusion::SoundOcclusion(Context* context) :
+    Component(context),
+    queriesPerFrame_(DEFAULT_QUERIES_PER_FRAME),
+    collisionMask_(M_MAX_UNSIGNED),
+    smoothingSpeed_(DEFAULT_SMOOTHING_SPEED),
+    sourceMargin_(DEFAULT_SOURCE_MARGIN)
+{
+}
+
+SoundOcclusion::~SoundOcclusion() = default;
+
+void SoundOcclusion::RegisterObject(Context* context)
+{
+    context->RegisterFactory<SoundOcclusion>(PHYSICS_CATEGORY);
+
+    URHO3D_ACCESSOR_ATTRIBUTE("Is Enabled", IsEnabled, SetEnabled, bool, true, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Queries Per Frame", GetQueriesPerFrame, SetQueriesPerFrame, unsigned, DEFAULT_QUERIES_PER_FRAME, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Collision Mask", GetCollisionMask, SetCollisionMask, unsigned, M_MAX_UNSIGNED, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Smoothing Speed", GetSmoothingSpeed, SetSmoothingSpeed, float, DEFAULT_SMOOTHING_SPEED, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Source Margin", GetSourceMargin, SetSourceMargin, float, DEFAULT_SOURCE_MARGIN, AM_DEFAULT);
+}
+
+void SoundOcclusion::OnSceneSet(Scene* scene)
+{
+    if (scene)
+        SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(SoundOcclusion, HandleScenePostUpdate));
+    else
+        UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
+}
+
+void SoundOcclusion::HandleScenePostUpdate(StringHash eventType, VariantMap& eventData)
+{
+    using namespace ScenePostUpdate;
+
+    if (IsEnabledEffective())
+        UpdateOcclusion(eventData[P_TIMESTEP].GetFloat());
+}
+
+void SoundOcclusion::UpdateOcclusion(float timeStep)
+{
+    Scene* scene = GetScene();
+    auto* audio = GetSubsystem<Audio>();
+    auto* physicsWorld = scene->GetComponent<PhysicsWorld>();
+    if (!audio || !physicsWorld)
+        return;
+
+    SoundListener* listener = audio->GetListener();
+    if (!listener || !listener->IsEnabledEffective() || listener->GetScene() != scene)
+        return;
+
+    URHO3D_PROFILE("UpdateSoundOcclusion");
+
+    // Only sources that can be heard are worth testing
+    audibleSources_.clear();
+    for (SoundSource* source : audio->GetSoundSources())
+    {
+        if (source->GetScene() != scene || !source->IsPlaying() || !source->IsInstanceOf<SoundSource3D>())
+            continue;
+        auto* source3D = static_cast<SoundSource3D*>(source);
+        if (source3D->GetAttenuation() > 0.0f && source3D->GetOcclusionAttenuation() < 1.0f)
+            audibleSources_.push_back(source3D);
+    }
+
+    // Test a limited number of sources per frame in round robin order
+    const Vector3 listenerPosition = listener->GetNode()->GetWorldPosition();
+    const unsigned numQueries = Min(queriesPerFrame_, audibleSources_.size());
+    querySources_.clear();
+    queries_.clear();
+    for (unsigned i = 0; i < numQueries; ++i)
+    {
+        SoundSource3D* source = audibleSources_[(nextQuery_ + i) % audibleSources_.size()];
+        const Vector3 offset = source->GetNode()->GetWorldPosition() - listenerPosition;
+        const float distance = offset.Length();
+
+        if (distance <= sourceMargin_)
+        {
+            targetOcclusion_[WeakPtr<SoundSource3D>(source)] = 0.0f;
+            continue;
+        }
+
+        PhysicsCastQuery& query = queries_.emplace_back();
+        query.ray_ = Ray(listenerPosition, offset / distance);
+        query.maxDistance_ = distance - sourceMargin_;
+        query.collisionMask_ = collisionMask_;
+        querySources_.push_back(source);
+    }
+    nextQuery_ = audibleSources_.empty() ? 0 : (nextQuery_ + numQueries) % audibleSources_.size();
+
+    if (!queries_.empty())
+    {
+        physicsWorld->CastBatch(queryResults_, queries_);
+        for (unsigned i = 0; i < querySources_.size(); ++i)
+            targetOcclusion_[WeakPtr<SoundSource3D>(querySources_[i])] = queryResults_[i].body_ ? 1.0f : 0.0f;
+    }
+
+    // Move occlusion of every audible source towards its latest result
+    const float blend = Min(smoothingSpeed_ * timeStep, 1.0f);
+    for (SoundSource3D* source : audibleSources_)
+    {
+        auto target = targetOcclusion_.find(WeakPtr<SoundSource3D>(source));
+        if (target != targetOcclusion_.end())
+            source->SetOcclusion(Lerp(source->GetOcclusion(), target->second, blend));
+    }
+
+    // Forget removed sources
+    for (auto i = targetOcclusion_.begin(); i != targetOcclusion_.end();)
+    {
+        if (i->first.Expired())
+            i = targetOcclusion_.erase(i);
+        else
+            ++i;
+    }
+}
+
+}
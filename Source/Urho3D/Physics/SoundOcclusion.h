@@ -0,0 +1,108 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#pragma once
+
+#include "../Physics/PhysicsWorld.h"
+#include "../Scene/Component.h"
+
+#include <EASTL/unordered_map.h>
+
+namespace Urho3D
+{
+
+class SoundSource3D;
+
+/// Scene component that estimates occlusion of 3D sound sources by raycasting from the sound listener. Queries are batched through the physics world and spread over several frames.
+class URHO3D_API SoundOcclusion : public Component
+{
+    URHO3D_OBJECT(SoundOcclusion, Component);
+
+public:
+    /// Construct.
+    explicit SoundOcclusion(Context* context);
+    /// Destruct.
+    ~SoundOcclusion() override;
+    /// Register object factory.
+    /// @nobind
+    static void RegisterObject(Context* context);
+
+    /// Set maximum number of sound sources tested per frame. Default 16.
+    /// @property
+    void SetQueriesPerFrame(unsigned count) { queriesPerFrame_ = Max(count, 1u); }
+    /// Set collision mask of occluding geometry.
+    /// @property
+    void SetCollisionMask(unsigned mask) { collisionMask_ = mask; }
+    /// Set rate per second at which occlusion moves towards the latest query result. Default 8.
+    /// @property
+    void SetSmoothingSpeed(float speed) { smoothingSpeed_ = Max(speed, 0.0f); }
+    /// Set distance in front of sound sources ignored by queries, so that their own geometry does not occlude them. Default 0.25.
+    /// @property
+    void SetSourceMargin(float margin) { sourceMargin_ = Max(margin, 0.0f); }
+
+    /// Return maximum number of sound sources tested per frame.
+    /// @property
+    unsigned GetQueriesPerFrame() const { return queriesPerFrame_; }
+    /// Return collision mask of occluding geometry.
+    /// @property
+    unsigned GetCollisionMask() const { return collisionMask_; }
+    /// Return occlusion smoothing speed.
+    /// @property
+    float GetSmoothingSpeed() const { return smoothingSpeed_; }
+    /// Return distance in front of sound sources ignored by queries.
+    /// @property
+    float GetSourceMargin() const { return sourceMargin_; }
+
+protected:
+    /// Handle scene being assigned.
+    void OnSceneSet(Scene* scene) override;
+
+private:
+    /// Handle scene post-update event.
+    void HandleScenePostUpdate(StringHash eventType, VariantMap& eventData);
+    /// Query occlusion of the next sound sources and smooth occlusion of all audible sources.
+    void UpdateOcclusion(float timeStep);
+
+    /// Maximum queries per frame.
+    unsigned queriesPerFrame_;
+    /// Collision mask.
+    unsigned collisionMask_;
+    /// Smoothing speed.
+    float smoothingSpeed_;
+    /// Ignored distance in front of sources.
+    float sourceMargin_;
+    /// Index of the first audible source to test on the next frame.
+    unsigned nextQuery_{};
+    /// Latest query result per sound source.
+    ea::unordered_map<WeakPtr<SoundSource3D>, float> targetOcclusion_;
+    /// Audible sound sources of the current frame.
+    ea::vector<SoundSource3D*> audibleSources_;
+    /// Sound sources queried on the current frame.
+    ea::vector<SoundSource3D*> querySources_;
+    /// Queries of the current frame.
+    ea::vector<PhysicsCastQuery> queries_;
+    /// Query results of the current frame.
+    ea::vector<PhysicsRaycastResult> queryResults_;
+};
+
+}
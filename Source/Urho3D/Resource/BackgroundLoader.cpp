@@ -25,6 +25,7 @@
 #include "../Precompiled.h"
 
 #include "../Core/Context.h"
+#include "../Core/ProcessUtils.h"
 #include "../Core/Profiler.h"
 #include "../IO/Log.h"
 #include "../Resource/BackgroundLoader.h"
@@ -36,78 +37,158 @@
 namespace Urho3D
 {
 
+/// Worker thread of the background loader.
+class BackgroundLoaderThread : public Thread
+{
+public:
+    /// Construct.
+    explicit BackgroundLoaderThread(BackgroundLoader* loader) :
+        loader_(loader)
+    {
+    }
+
+    /// Resource background loading loop.
+    void ThreadFunction() override
+    {
+        URHO3D_PROFILE_THREAD("BackgroundLoader Thread");
+
+        while (shouldRun_)
+        {
+            if (!loader_->LoadNextResource())
+                Time::Sleep(5);
+        }
+    }
+
+private:
+    /// Owner background loader.
+    BackgroundLoader* loader_;
+};
+
 BackgroundLoader::BackgroundLoader(ResourceCache* owner) :
-    owner_(owner)
+    owner_(owner),
+    numThreads_(Clamp(GetNumLogicalCPUs() / 2, 1u, 4u))
 {
 }
 
 BackgroundLoader::~BackgroundLoader()
 {
+    // Stop the workers before the queue they are working on goes away
+    threads_.clear();
+
     MutexLock lock(backgroundLoadMutex_);
 
     backgroundLoadQueue_.clear();
 }
 
-void BackgroundLoader::ThreadFunction()
+void BackgroundLoader::SetNumThreads(unsigned numThreads)
+{
+    numThreads = Max(numThreads, 1u);
+    if (numThreads == numThreads_)
+        return;
+
+    numThreads_ = numThreads;
+    if (threads_.empty())
+        return;
+
+    // Stopping waits for the resource the thread is currently loading
+    if (threads_.size() > numThreads_)
+        threads_.resize(numThreads_);
+    else
+        StartThreads();
+}
+
+void BackgroundLoader::SetMaxConcurrentLoads(StringHash type, unsigned maxLoads)
 {
-    URHO3D_PROFILE_THREAD("BackgroundLoader Thread");
+    MutexLock lock(backgroundLoadMutex_);
+
+    if (maxLoads)
+        maxConcurrentLoads_[type] = maxLoads;
+    else
+        maxConcurrentLoads_.erase(type);
+}
 
-    while (shouldRun_)
+unsigned BackgroundLoader::GetMaxConcurrentLoads(StringHash type) const
+{
+    MutexLock lock(backgroundLoadMutex_);
+
+    auto i = maxConcurrentLoads_.find(type);
+    return i != maxConcurrentLoads_.end() ? i->second : 0;
+}
+
+void BackgroundLoader::StartThreads()
+{
+    while (threads_.size() < numThreads_)
     {
-        backgroundLoadMutex_.Acquire();
+        threads_.push_back(ea::make_unique<BackgroundLoaderThread>(this));
+        threads_.back()->Run();
+    }
+}
 
-        // Search for a queued resource that has not been loaded yet
-        auto i = backgroundLoadQueue_.begin();
-        while (i != backgroundLoadQueue_.end())
-        {
-            if (i->second.resource_->GetAsyncLoadState() == ASYNC_QUEUED)
-                break;
-            else
-                ++i;
-        }
+bool BackgroundLoader::LoadNextResource()
+{
+    backgroundLoadMutex_.Acquire();
 
-        if (i == backgroundLoadQueue_.end())
+    // Search for a queued resource that has not been loaded yet and whose type is below its concurrency limit
+    auto i = backgroundLoadQueue_.begin();
+    while (i != backgroundLoadQueue_.end())
+    {
+        Resource* resource = i->second.resource_;
+        if (resource->GetAsyncLoadState() == ASYNC_QUEUED)
         {
-            // No resources to load found
-            backgroundLoadMutex_.Release();
-            Time::Sleep(5);
+            auto limit = maxConcurrentLoads_.find(resource->GetType());
+            if (limit == maxConcurrentLoads_.end() || numLoading_[resource->GetType()] < limit->second)
+                break;
         }
-        else
-        {
-            BackgroundLoadItem& item = i->second;
-            Resource* resource = item.resource_;
-            // We can be sure that the item is not removed from the queue as long as it is in the
-            // "queued" or "loading" state
-            backgroundLoadMutex_.Release();
-
-            bool success = false;
-            SharedPtr<File> file = owner_->GetFile(resource->GetName(), item.sendEventOnFailure_);
-            if (file)
-            {
-                resource->SetAsyncLoadState(ASYNC_LOADING);
-                success = resource->BeginLoad(*file);
-            }
+        ++i;
+    }
 
-            // Process dependencies now
-            // Need to lock the queue again when manipulating other entries
-            ea::pair<StringHash, StringHash> key = ea::make_pair(resource->GetType(), resource->GetNameHash());
-            backgroundLoadMutex_.Acquire();
-            if (item.dependents_.size())
-            {
-                for (auto i = item.dependents_.begin(); i != item.dependents_.end(); ++i)
-                {
-                    auto j = backgroundLoadQueue_.find(*i);
-                    if (j != backgroundLoadQueue_.end())
-                        j->second.dependencies_.erase(key);
-                }
+    if (i == backgroundLoadQueue_.end())
+    {
+        // No resources to load found
+        backgroundLoadMutex_.Release();
+        return false;
+    }
 
-                item.dependents_.clear();
-            }
+    BackgroundLoadItem& item = i->second;
+    Resource* resource = item.resource_;
+    const StringHash type = resource->GetType();
+    // Claim the resource while still holding the mutex, so that no other worker picks it up. We can be sure that
+    // the item is not removed from the queue as long as it is in the "queued" or "loading" state
+    resource->SetAsyncLoadState(ASYNC_LOADING);
+    ++numLoading_[type];
+    backgroundLoadMutex_.Release();
+
+    bool success = false;
+    SharedPtr<File> file = owner_->GetFile(resource->GetName(), item.sendEventOnFailure_);
+    if (file)
+    {
+        const bool recordLoadGraph = owner_->GetRecordLoadGraph();
+        if (recordLoadGraph)
+            owner_->GetLoadGraph().BeginLoad(resource);
+        success = resource->BeginLoad(*file);
+        if (recordLoadGraph)
+            owner_->GetLoadGraph().EndLoad(resource);
+    }
 
-            resource->SetAsyncLoadState(success ? ASYNC_SUCCESS : ASYNC_FAIL);
-            backgroundLoadMutex_.Release();
+    // Process dependencies now
+    // Need to lock the queue again when manipulating other entries
+    ea::pair<StringHash, StringHash> key = ea::make_pair(type, resource->GetNameHash());
+    MutexLock lock(backgroundLoadMutex_);
+    if (item.dependents_.size())
+    {
+        for (auto j = item.dependents_.begin(); j != item.dependents_.end(); ++j)
+        {
+            auto k = backgroundLoadQueue_.find(*j);
+            if (k != backgroundLoadQueue_.end())
+                k->second.dependencies_.erase(key);
         }
+
+        item.dependents_.clear();
     }
+
+    --numLoading_[type];
+    resource->SetAsyncLoadState(success ? ASYNC_SUCCESS : ASYNC_FAIL);
+    return true;
 }
 
 bool BackgroundLoader::QueueResource(StringHash type, const ea::string& name, bool sendEventOnFailure, Resource* caller)
@@ -118,8 +199,23 @@ bool BackgroundLoader::QueueResource(StringHash type, const ea::string& name, bo
     MutexLock lock(backgroundLoadMutex_);
 
     // Check if already exists in the queue
-    if (backgroundLoadQueue_.find(key) != backgroundLoadQueue_.end())
+    auto existing = backgroundLoadQueue_.find(key);
+    if (existing != backgroundLoadQueue_.end())
+    {
+        // Another resource may be loading the same dependency in parallel: the caller must still wait for it
+        AsyncLoadState state = existing->second.resource_->GetAsyncLoadState();
+        if (caller && (state == ASYNC_QUEUED || state == ASYNC_LOADING))
+        {
+            ea::pair<StringHash, StringHash> callerKey = ea::make_pair(caller->GetType(), caller->GetNameHash());
+            auto j = backgroundLoadQueue_.find(callerKey);
+            if (j != backgroundLoadQueue_.end() && callerKey != key)
+            {
+                existing->second.dependents_.insert(callerKey);
+                j->second.dependencies_.insert(key);
+            }
+        }
         return false;
+    }
 
     BackgroundLoadItem& item = backgroundLoadQueue_[key];
     item.sendEventOnFailure_ = sendEventOnFailure;
@@ -165,9 +261,9 @@ bool BackgroundLoader::QueueResource(StringHash type, const ea::string& name, bo
                        " requested for a background loaded resource but was not in the background load queue");
     }
 
-    // Start the background loader thread now
-    if (!IsStarted())
-        Run();
+    // Start the background loader threads now
+    if (threads_.empty())
+        StartThreads();
 
     return true;
 }
@@ -220,7 +316,7 @@ void BackgroundLoader::WaitForResource(StringHash type, StringHash nameHash)
 
 void BackgroundLoader::FinishResources(int maxMs)
 {
-    if (IsStarted())
+    if (!threads_.empty())
     {
         HiresTimer timer;
 
@@ -270,7 +366,12 @@ void BackgroundLoader::FinishBackgroundLoading(BackgroundLoadItem& item)
         URHO3D_PROFILE("FinishBackgroundLoading");
         URHO3D_PROFILE_ZONENAME(resource->GetTypeName().c_str(), resource->GetTypeName().length());
         URHO3D_LOGDEBUG("Finishing background loaded resource " + resource->GetName());
+        const bool recordLoadGraph = owner_->GetRecordLoadGraph();
+        if (recordLoadGraph)
+            owner_->GetLoadGraph().BeginLoad(resource);
         success = resource->EndLoad();
+        if (recordLoadGraph)
+            owner_->GetLoadGraph().EndLoad(resource);
     }
     resource->SetAsyncLoadState(ASYNC_DONE);
 
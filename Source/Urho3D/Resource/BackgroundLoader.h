@@ -23,7 +23,9 @@
 #pragma once
 
 #include <EASTL/hash_set.h>
+#include <EASTL/unique_ptr.h>
 #include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
 
 #include "../Core/Mutex.h"
 #include "../Container/Ptr.h"
@@ -33,6 +35,7 @@
 namespace Urho3D
 {
 
+class BackgroundLoaderThread;
 class Resource;
 class ResourceCache;
 
@@ -49,20 +52,23 @@ struct URHO3D_API BackgroundLoadItem
     bool sendEventOnFailure_;
 };
 
-/// Background loader of resources. Owned by the ResourceCache.
+/// Background loader of resources. Owned by the ResourceCache. BeginLoad() of independent resources runs in parallel on a pool of worker threads.
 /// @nobind
-class URHO3D_API BackgroundLoader : public RefCounted, public Thread
+class URHO3D_API BackgroundLoader : public RefCounted
 {
+    friend class BackgroundLoaderThread;
+
 public:
     /// Construct.
     explicit BackgroundLoader(ResourceCache* owner);
 
-    /// Destruct. Forcibly clear the load queue.
+    /// Destruct. Stop the worker threads and forcibly clear the load queue.
     ~BackgroundLoader() override;
 
-    /// Resource background loading loop.
-    void ThreadFunction() override;
-
+    /// Set number of worker threads. Threads are started on the first background load request.
+    void SetNumThreads(unsigned numThreads);
+    /// Set maximum number of resources of a type loaded concurrently, for example to limit memory use of large resources. Zero (default) is unlimited.
+    void SetMaxConcurrentLoads(StringHash type, unsigned maxLoads);
     /// Queue loading of a resource. The name must be sanitated to ensure consistent format. Return true if queued (not a duplicate and resource was a known type).
     bool QueueResource(StringHash type, const ea::string& name, bool sendEventOnFailure, Resource* caller);
     /// Wait and finish possible loading of a resource when being requested from the cache.
@@ -72,8 +78,16 @@ public:
 
     /// Return amount of resources in the load queue.
     unsigned GetNumQueuedResources() const;
+    /// Return number of worker threads.
+    unsigned GetNumThreads() const { return numThreads_; }
+    /// Return maximum number of resources of a type loaded concurrently.
+    unsigned GetMaxConcurrentLoads(StringHash type) const;
 
 private:
+    /// Start the worker threads that are not running yet.
+    void StartThreads();
+    /// Begin loading one queued resource on the calling worker thread. Return false if there was none that could be started.
+    bool LoadNextResource();
     /// Finish one background loaded resource.
     void FinishBackgroundLoading(BackgroundLoadItem& item);
 
@@ -83,6 +97,14 @@ private:
     mutable Mutex backgroundLoadMutex_;
     /// Resources that are queued for background loading.
     ea::unordered_map<ea::pair<StringHash, StringHash>, BackgroundLoadItem> backgroundLoadQueue_;
+    /// Worker threads.
+    ea::vector<ea::unique_ptr<BackgroundLoaderThread> > threads_;
+    /// Number of worker threads to use.
+    unsigned numThreads_;
+    /// Concurrency limits by resource type.
+    ea::unordered_map<StringHash, unsigned> maxConcurrentLoads_;
+    /// Number of resources currently in BeginLoad() by resource type.
+    ea::unordered_map<StringHash, unsigned> numLoading_;
 };
 
 }
@@ -959,4 +959,109 @@ void DecompressImageETC(unsigned char* dstImage, const void* blocks, int width,
     }
 }
 
+static unsigned short Pack565(const int* colour)
+{
+    return (unsigned short)(((colour[0] >> 3) << 11) | ((colour[1] >> 2) << 5) | (colour[2] >> 3));
+}
+
+static void CompressColourDXT1(unsigned char* block, const unsigned char* rgba)
+{
+    // find bounding box of block colours
+    int minColour[3] = { 255, 255, 255 };
+    int maxColour[3] = { 0, 0, 0 };
+    int mean[3] = { 0, 0, 0 };
+    for (int i = 0; i < 16; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            const int c = rgba[4 * i + j];
+            minColour[j] = Min(minColour[j], c);
+            maxColour[j] = Max(maxColour[j], c);
+            mean[j] += c;
+        }
+    }
+
+    // pick the box diagonal that follows the colour distribution
+    int covRG = 0;
+    int covRB = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        const int r = rgba[4 * i] * 16 - mean[0];
+        covRG += r * (rgba[4 * i + 1] * 16 - mean[1]);
+        covRB += r * (rgba[4 * i + 2] * 16 - mean[2]);
+    }
+    if (covRG < 0)
+        ea::swap(minColour[1], maxColour[1]);
+    if (covRB < 0)
+        ea::swap(minColour[2], maxColour[2]);
+
+    // inset endpoints to reduce error of extreme colours
+    for (int j = 0; j < 3; ++j)
+    {
+        const int inset = (maxColour[j] - minColour[j]) / 16;
+        maxColour[j] -= inset;
+        minColour[j] += inset;
+    }
+
+    unsigned short a = Pack565(maxColour);
+    unsigned short b = Pack565(minColour);
+    if (a < b)
+    {
+        ea::swap(a, b);
+        for (int j = 0; j < 3; ++j)
+            ea::swap(minColour[j], maxColour[j]);
+    }
+
+    block[0] = (unsigned char)(a & 0xff);
+    block[1] = (unsigned char)(a >> 8);
+    block[2] = (unsigned char)(b & 0xff);
+    block[3] = (unsigned char)(b >> 8);
+    block[4] = block[5] = block[6] = block[7] = 0;
+
+    // single colour block, all indices point to the first endpoint
+    if (a == b)
+        return;
+
+    // project colours onto the endpoint line: palette order is a, b, 2/3 a + 1/3 b, 1/3 a + 2/3 b
+    const int dir[3] = { maxColour[0] - minColour[0], maxColour[1] - minColour[1], maxColour[2] - minColour[2] };
+    const int lengthSquared = Max(1, dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2]);
+    static const unsigned char remap[4] = { 1, 3, 2, 0 };
+    for (int i = 0; i < 16; ++i)
+    {
+        const int dot = (rgba[4 * i] - minColour[0]) * dir[0]
+            + (rgba[4 * i + 1] - minColour[1]) * dir[1]
+            + (rgba[4 * i + 2] - minColour[2]) * dir[2];
+        const int step = Clamp((dot * 3 + lengthSquared / 2) / lengthSquared, 0, 3);
+        block[4 + i / 4] |= remap[step] << (2 * (i % 4));
+    }
+}
+
+void CompressImageDXT1(void* blocks, const unsigned char* rgba, int width, int height)
+{
+    auto* destBlock = reinterpret_cast<unsigned char*>(blocks);
+    for (int y = 0; y < height; y += 4)
+    {
+        for (int x = 0; x < width; x += 4)
+        {
+            // gather block pixels, replicating edge pixels for partial blocks
+            unsigned char sourceRgba[4 * 16];
+            for (int py = 0; py < 4; ++py)
+            {
+                for (int px = 0; px < 4; ++px)
+                {
+                    const int sx = Min(x + px, width - 1);
+                    const int sy = Min(y + py, height - 1);
+                    const unsigned char* sourcePixel = rgba + 4 * (width * sy + sx);
+                    unsigned char* targetPixel = sourceRgba + 4 * (4 * py + px);
+                    for (int i = 0; i < 4; ++i)
+                        targetPixel[i] = sourcePixel[i];
+                }
+            }
+
+            CompressColourDXT1(destBlock, sourceRgba);
+            destBlock += 8;
+        }
+    }
+}
+
 }
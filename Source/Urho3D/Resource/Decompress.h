@@ -34,6 +34,8 @@ URHO3D_API void
 URHO3D_API void DecompressImageETC(unsigned char* dstImage, const void* blocks, int width, int height, bool hasAlpha);
 /// Decompress a PVRTC compressed image to RGBA.
 URHO3D_API void DecompressImagePVRTC(unsigned char* rgba, const void* blocks, int width, int height, CompressedFormat format);
+/// Compress an RGBA image to DXT1. Alpha is ignored. Partial blocks on the image border are padded with edge pixels.
+URHO3D_API void CompressImageDXT1(void* blocks, const unsigned char* rgba, int width, int height);
 /// Flip a compressed block vertically.
 URHO3D_API void FlipBlockVertical(unsigned char* dest, const unsigned char* src, CompressedFormat format);
 /// Flip a compressed block horizontally.
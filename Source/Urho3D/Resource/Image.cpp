@@ -24,6 +24,8 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/Thread.h"
+#include "../Core/WorkQueue.h"
 #include "../IO/File.h"
 #include "../IO/FileSystem.h"
 #include "../IO/Log.h"
@@ -38,6 +40,10 @@
 #include <webp/mux.h>
 #endif
 
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#endif
+
 #include "../DebugNew.h"
 
 #ifndef MAKEFOURCC
@@ -88,6 +94,131 @@ static const unsigned DDS_DXGI_FORMAT_BC3_UNORM_SRGB = 78;
 namespace Urho3D
 {
 
+/// Minimum number of pixels for image processing to be split across worker threads.
+static const int MIN_PARALLEL_IMAGE_PIXELS = 256 * 256;
+
+/// Execute function over image rows [0, numRows), split across the work queue threads when called from the main thread with a large enough image.
+template <class T>
+static void ProcessImageRows(Context* context, int numRows, int numPixels, const T& function)
+{
+    WorkQueue* workQueue = numPixels >= MIN_PARALLEL_IMAGE_PIXELS && Thread::IsMainThread() ? context->GetSubsystem<WorkQueue>() : nullptr;
+    if (!workQueue || !workQueue->GetNumThreads() || numRows <= 1)
+    {
+        function(0, numRows);
+        return;
+    }
+
+    // Several batches per thread so that threads which finish early take over remaining rows
+    const unsigned batchSize = Max(static_cast<unsigned>(numRows) / ((workQueue->GetNumThreads() + 1) * 4), 1u);
+    workQueue->ParallelFor(numRows, batchSize, [&](unsigned begin, unsigned end, unsigned /*threadIndex*/)
+    {
+        function(static_cast<int>(begin), static_cast<int>(end));
+    });
+}
+
+/// Average 2x2 pixel blocks for rows [yBegin, yEnd) of a 2D mip level.
+template <int N>
+static void DownsampleRows2D(unsigned char* pixelDataOut, const unsigned char* pixelDataIn, int widthIn, int widthOut, int yBegin, int yEnd)
+{
+    for (int y = yBegin; y < yEnd; ++y)
+    {
+        const unsigned char* inUpper = &pixelDataIn[(y * 2) * widthIn * N];
+        const unsigned char* inLower = &pixelDataIn[(y * 2 + 1) * widthIn * N];
+        unsigned char* out = &pixelDataOut[y * widthOut * N];
+
+        int x = 0;
+#ifdef URHO3D_SSE
+        if (N == 4)
+        {
+            // Two output pixels at a time. Sums are done in 16 bits, so the result matches the scalar path exactly
+            const __m128i zero = _mm_setzero_si128();
+            for (; x + 2 <= widthOut; x += 2)
+            {
+                const __m128i upper = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&inUpper[x * 8]));
+                const __m128i lower = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&inLower[x * 8]));
+                const __m128i first = _mm_add_epi16(_mm_unpacklo_epi8(upper, zero), _mm_unpacklo_epi8(lower, zero));
+                const __m128i second = _mm_add_epi16(_mm_unpackhi_epi8(upper, zero), _mm_unpackhi_epi8(lower, zero));
+                const __m128i firstSum = _mm_add_epi16(first, _mm_srli_si128(first, 8));
+                const __m128i secondSum = _mm_add_epi16(second, _mm_srli_si128(second, 8));
+                const __m128i result = _mm_srli_epi16(_mm_unpacklo_epi64(firstSum, secondSum), 2);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(&out[x * 4]), _mm_packus_epi16(result, result));
+            }
+        }
+#endif
+        for (; x < widthOut; ++x)
+        {
+            for (int c = 0; c < N; ++c)
+            {
+                const int i = x * 2 * N + c;
+                out[x * N + c] = (unsigned char)(((unsigned)inUpper[i] + inUpper[i + N] + inLower[i] + inLower[i + N]) >> 2);
+            }
+        }
+    }
+}
+
+/// Average 2x2x2 pixel blocks for rows [rowBegin, rowEnd) of a 3D mip level. Rows of all slices are indexed consecutively.
+template <int N>
+static void DownsampleRows3D(unsigned char* pixelDataOut, const unsigned char* pixelDataIn, int widthIn, int heightIn,
+    int widthOut, int heightOut, int rowBegin, int rowEnd)
+{
+    for (int row = rowBegin; row < rowEnd; ++row)
+    {
+        const int z = row / heightOut;
+        const int y = row % heightOut;
+        const unsigned char* inOuter = &pixelDataIn[(z * 2) * widthIn * heightIn * N];
+        const unsigned char* inInner = &pixelDataIn[(z * 2 + 1) * widthIn * heightIn * N];
+        const unsigned char* inOuterUpper = &inOuter[(y * 2) * widthIn * N];
+        const unsigned char* inOuterLower = &inOuter[(y * 2 + 1) * widthIn * N];
+        const unsigned char* inInnerUpper = &inInner[(y * 2) * widthIn * N];
+        const unsigned char* inInnerLower = &inInner[(y * 2 + 1) * widthIn * N];
+        unsigned char* out = &pixelDataOut[z * widthOut * heightOut * N + y * widthOut * N];
+
+        for (int x = 0; x < widthOut; ++x)
+        {
+            for (int c = 0; c < N; ++c)
+            {
+                const int i = x * 2 * N + c;
+                out[x * N + c] = (unsigned char)(((unsigned)inOuterUpper[i] + inOuterUpper[i + N] +
+                                                  inOuterLower[i] + inOuterLower[i + N] +
+                                                  inInnerUpper[i] + inInnerUpper[i + N] +
+                                                  inInnerLower[i] + inInnerLower[i + N]) >> 3);
+            }
+        }
+    }
+}
+
+/// Return whether a compressed format consists of independent 4x4 blocks that can be decompressed in parts.
+static bool IsBlockRowDecompressible(CompressedFormat format)
+{
+    switch (format)
+    {
+    case CF_DXT1:
+    case CF_DXT3:
+    case CF_DXT5:
+    case CF_ETC1:
+    case CF_ETC2_RGB:
+    case CF_ETC2_RGBA:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+/// Decompress rows of 4x4 blocks [blockRowBegin, blockRowEnd) of a 2D compressed level to RGBA.
+static void DecompressBlockRows(unsigned char* dest, const CompressedLevel& level, int blockRowBegin, int blockRowEnd)
+{
+    const int rowBegin = blockRowBegin * 4;
+    const int numRows = Min(level.height_ - rowBegin, (blockRowEnd - blockRowBegin) * 4);
+    unsigned char* destRows = dest + rowBegin * level.width_ * 4;
+    const unsigned char* blocks = level.data_ + blockRowBegin * level.rowSize_;
+
+    if (level.format_ == CF_DXT1 || level.format_ == CF_DXT3 || level.format_ == CF_DXT5)
+        DecompressImageDXT(destRows, blocks, level.width_, numRows, 1, level.format_);
+    else
+        DecompressImageETC(destRows, blocks, level.width_, numRows, level.format_ == CF_ETC2_RGBA);
+}
+
 /// DirectDraw color key definition.
 struct DDColorKey
 {
@@ -800,17 +931,22 @@ bool Image::BeginLoad(Deserializer& source)
             return false;
         }
 
-        // Read the file to buffer.
+        // Read the file to buffer, unless it can be decoded in place.
         size_t dataSize(source.GetSize());
-        ea::shared_array<uint8_t> data(new uint8_t[dataSize]);
-
-        memset(data.get(), 0, sizeof(uint8_t) * dataSize);
-        source.Seek(0);
-        source.Read(data.get(), dataSize);
+        ea::shared_array<uint8_t> dataBuffer;
+        const uint8_t* data = source.GetMemoryData();
+        if (!data)
+        {
+            dataBuffer = new uint8_t[dataSize];
+            memset(dataBuffer.get(), 0, sizeof(uint8_t) * dataSize);
+            source.Seek(0);
+            source.Read(dataBuffer.get(), dataSize);
+            data = dataBuffer.get();
+        }
 
         WebPBitstreamFeatures features;
 
-        if (WebPGetFeatures(data.get(), dataSize, &features) != VP8_STATUS_OK)
+        if (WebPGetFeatures(data, dataSize, &features) != VP8_STATUS_OK)
         {
             URHO3D_LOGERROR("Error reading WebP image: " + source.GetName());
             return false;
@@ -822,11 +958,11 @@ bool Image::BeginLoad(Deserializer& source)
         bool decodeError(false);
         if (features.has_alpha)
         {
-            decodeError = WebPDecodeRGBAInto(data.get(), dataSize, pixelData.get(), imgSize, 4 * features.width) == nullptr;
+            decodeError = WebPDecodeRGBAInto(data, dataSize, pixelData.get(), imgSize, 4 * features.width) == nullptr;
         }
         else
         {
-            decodeError = WebPDecodeRGBInto(data.get(), dataSize, pixelData.get(), imgSize, 3 * features.width) == nullptr;
+            decodeError = WebPDecodeRGBInto(data, dataSize, pixelData.get(), imgSize, 3 * features.width) == nullptr;
         }
         if (decodeError)
         {
@@ -1189,34 +1325,37 @@ bool Image::Resize(int width, int height)
 
     /// \todo Reducing image size does not sample all needed pixels
     ea::shared_array<unsigned char> newData(new unsigned char[width * height * components_]);
-    for (int y = 0; y < height; ++y)
+    ProcessImageRows(context_, height, width * height, [&](int yBegin, int yEnd)
     {
-        for (int x = 0; x < width; ++x)
+        for (int y = yBegin; y < yEnd; ++y)
         {
-            // Calculate float coordinates between 0 - 1 for resampling
-            float xF = (width_ > 1) ? (float)x / (float)(width - 1) : 0.0f;
-            float yF = (height_ > 1) ? (float)y / (float)(height - 1) : 0.0f;
-            unsigned uintColor = GetPixelBilinear(xF, yF).ToUInt();
-            unsigned char* dest = newData.get() + (y * width + x) * components_;
-            auto* src = (unsigned char*)&uintColor;
-
-            switch (components_)
+            for (int x = 0; x < width; ++x)
             {
-            case 4:
-                dest[3] = src[3];
-                // Fall through
-            case 3:
-                dest[2] = src[2];
-                // Fall through
-            case 2:
-                dest[1] = src[1];
-                // Fall through
-            default:
-                dest[0] = src[0];
-                break;
+                // Calculate float coordinates between 0 - 1 for resampling
+                float xF = (width_ > 1) ? (float)x / (float)(width - 1) : 0.0f;
+                float yF = (height_ > 1) ? (float)y / (float)(height - 1) : 0.0f;
+                unsigned uintColor = GetPixelBilinear(xF, yF).ToUInt();
+                unsigned char* dest = newData.get() + (y * width + x) * components_;
+                auto* src = (unsigned char*)&uintColor;
+
+                switch (components_)
+                {
+                case 4:
+                    dest[3] = src[3];
+                    // Fall through
+                case 3:
+                    dest[2] = src[2];
+                    // Fall through
+                case 2:
+                    dest[1] = src[1];
+                    // Fall through
+                default:
+                    dest[0] = src[0];
+                    break;
+                }
             }
         }
-    }
+    });
 
     width_ = width;
     height_ = height;
@@ -1352,8 +1491,41 @@ bool Image::SaveDDS(const ea::string& fileName) const
 
     if (IsCompressed())
     {
-        URHO3D_LOGERROR("Can not save compressed image to DDS");
-        return false;
+        unsigned fourCC = 0;
+        switch (compressedFormat_)
+        {
+        case CF_DXT1: fourCC = FOURCC_DXT1; break;
+        case CF_DXT3: fourCC = FOURCC_DXT3; break;
+        case CF_DXT5: fourCC = FOURCC_DXT5; break;
+        default:
+            URHO3D_LOGERROR("Can not save compressed image to DDS, only DXT formats are supported");
+            return false;
+        }
+
+        if (depth_ > 1 || cubemap_ || array_)
+        {
+            URHO3D_LOGERROR("Can not save compressed 3D, cube or array image to DDS");
+            return false;
+        }
+
+        outFile.WriteFileID("DDS ");
+
+        DDSurfaceDesc2 ddsd;        // NOLINT(hicpp-member-init)
+        memset(&ddsd, 0, sizeof(ddsd));
+        ddsd.dwSize_ = sizeof(ddsd);
+        ddsd.dwFlags_ = 0x00000001l /*DDSD_CAPS*/
+            | 0x00000002l /*DDSD_HEIGHT*/ | 0x00000004l /*DDSD_WIDTH*/ | 0x00020000l /*DDSD_MIPMAPCOUNT*/ | 0x00001000l /*DDSD_PIXELFORMAT*/;
+        ddsd.dwWidth_ = width_;
+        ddsd.dwHeight_ = height_;
+        ddsd.dwMipMapCount_ = numCompressedLevels_;
+        ddsd.ddpfPixelFormat_.dwFlags_ = 0x00000004l /*DDPF_FOURCC*/;
+        ddsd.ddpfPixelFormat_.dwSize_ = sizeof(ddsd.ddpfPixelFormat_);
+        ddsd.ddpfPixelFormat_.dwFourCC_ = fourCC;
+        ddsd.ddsCaps_.dwCaps_ = DDSCAPS_TEXTURE | (numCompressedLevels_ > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0);
+
+        outFile.Write(&ddsd, sizeof(ddsd));
+        outFile.Write(data_.get(), GetMemoryUse());
+        return true;
     }
 
     if (components_ != 4)
@@ -1689,218 +1861,36 @@ SharedPtr<Image> Image::GetNextLevel() const
     // 2D case
     else if (depth_ == 1)
     {
-        switch (components_)
+        ProcessImageRows(context_, heightOut, widthOut * heightOut, [&](int yBegin, int yEnd)
         {
-        case 1:
-            for (int y = 0; y < heightOut; ++y)
-            {
-                const unsigned char* inUpper = &pixelDataIn[(y * 2) * width_];
-                const unsigned char* inLower = &pixelDataIn[(y * 2 + 1) * width_];
-                unsigned char* out = &pixelDataOut[y * widthOut];
-
-                for (int x = 0; x < widthOut; ++x)
-                {
-                    out[x] = (unsigned char)(((unsigned)inUpper[x * 2] + inUpper[x * 2 + 1] +
-                                              inLower[x * 2] + inLower[x * 2 + 1]) >> 2);
-                }
-            }
-            break;
-
-        case 2:
-            for (int y = 0; y < heightOut; ++y)
-            {
-                const unsigned char* inUpper = &pixelDataIn[(y * 2) * width_ * 2];
-                const unsigned char* inLower = &pixelDataIn[(y * 2 + 1) * width_ * 2];
-                unsigned char* out = &pixelDataOut[y * widthOut * 2];
-
-                for (int x = 0; x < widthOut * 2; x += 2)
-                {
-                    out[x] = (unsigned char)(((unsigned)inUpper[x * 2] + inUpper[x * 2 + 2] +
-                                              inLower[x * 2] + inLower[x * 2 + 2]) >> 2);
-                    out[x + 1] = (unsigned char)(((unsigned)inUpper[x * 2 + 1] + inUpper[x * 2 + 3] +
-                                                  inLower[x * 2 + 1] + inLower[x * 2 + 3]) >> 2);
-                }
-            }
-            break;
-
-        case 3:
-            for (int y = 0; y < heightOut; ++y)
-            {
-                const unsigned char* inUpper = &pixelDataIn[(y * 2) * width_ * 3];
-                const unsigned char* inLower = &pixelDataIn[(y * 2 + 1) * width_ * 3];
-                unsigned char* out = &pixelDataOut[y * widthOut * 3];
-
-                for (int x = 0; x < widthOut * 3; x += 3)
-                {
-                    out[x] = (unsigned char)(((unsigned)inUpper[x * 2] + inUpper[x * 2 + 3] +
-                                              inLower[x * 2] + inLower[x * 2 + 3]) >> 2);
-                    out[x + 1] = (unsigned char)(((unsigned)inUpper[x * 2 + 1] + inUpper[x * 2 + 4] +
-                                                  inLower[x * 2 + 1] + inLower[x * 2 + 4]) >> 2);
-                    out[x + 2] = (unsigned char)(((unsigned)inUpper[x * 2 + 2] + inUpper[x * 2 + 5] +
-                                                  inLower[x * 2 + 2] + inLower[x * 2 + 5]) >> 2);
-                }
-            }
-            break;
-
-        case 4:
-            for (int y = 0; y < heightOut; ++y)
+            switch (components_)
             {
-                const unsigned char* inUpper = &pixelDataIn[(y * 2) * width_ * 4];
-                const unsigned char* inLower = &pixelDataIn[(y * 2 + 1) * width_ * 4];
-                unsigned char* out = &pixelDataOut[y * widthOut * 4];
-
-                for (int x = 0; x < widthOut * 4; x += 4)
-                {
-                    out[x] = (unsigned char)(((unsigned)inUpper[x * 2] + inUpper[x * 2 + 4] +
-                                              inLower[x * 2] + inLower[x * 2 + 4]) >> 2);
-                    out[x + 1] = (unsigned char)(((unsigned)inUpper[x * 2 + 1] + inUpper[x * 2 + 5] +
-                                                  inLower[x * 2 + 1] + inLower[x * 2 + 5]) >> 2);
-                    out[x + 2] = (unsigned char)(((unsigned)inUpper[x * 2 + 2] + inUpper[x * 2 + 6] +
-                                                  inLower[x * 2 + 2] + inLower[x * 2 + 6]) >> 2);
-                    out[x + 3] = (unsigned char)(((unsigned)inUpper[x * 2 + 3] + inUpper[x * 2 + 7] +
-                                                  inLower[x * 2 + 3] + inLower[x * 2 + 7]) >> 2);
-                }
+            case 1: DownsampleRows2D<1>(pixelDataOut, pixelDataIn, width_, widthOut, yBegin, yEnd); break;
+            case 2: DownsampleRows2D<2>(pixelDataOut, pixelDataIn, width_, widthOut, yBegin, yEnd); break;
+            case 3: DownsampleRows2D<3>(pixelDataOut, pixelDataIn, width_, widthOut, yBegin, yEnd); break;
+            case 4: DownsampleRows2D<4>(pixelDataOut, pixelDataIn, width_, widthOut, yBegin, yEnd); break;
+            default:
+                assert(false);  // Should never reach here
+                break;
             }
-            break;
-
-        default:
-            assert(false);  // Should never reach here
-            break;
-        }
+        });
     }
     // 3D case
     else
     {
-        switch (components_)
+        ProcessImageRows(context_, depthOut * heightOut, widthOut * heightOut * depthOut, [&](int rowBegin, int rowEnd)
         {
-        case 1:
-            for (int z = 0; z < depthOut; ++z)
-            {
-                const unsigned char* inOuter = &pixelDataIn[(z * 2) * width_ * height_];
-                const unsigned char* inInner = &pixelDataIn[(z * 2 + 1) * width_ * height_];
-
-                for (int y = 0; y < heightOut; ++y)
-                {
-                    const unsigned char* inOuterUpper = &inOuter[(y * 2) * width_];
-                    const unsigned char* inOuterLower = &inOuter[(y * 2 + 1) * width_];
-                    const unsigned char* inInnerUpper = &inInner[(y * 2) * width_];
-                    const unsigned char* inInnerLower = &inInner[(y * 2 + 1) * width_];
-                    unsigned char* out = &pixelDataOut[z * widthOut * heightOut + y * widthOut];
-
-                    for (int x = 0; x < widthOut; ++x)
-                    {
-                        out[x] = (unsigned char)(((unsigned)inOuterUpper[x * 2] + inOuterUpper[x * 2 + 1] +
-                                                  inOuterLower[x * 2] + inOuterLower[x * 2 + 1] +
-                                                  inInnerUpper[x * 2] + inInnerUpper[x * 2 + 1] +
-                                                  inInnerLower[x * 2] + inInnerLower[x * 2 + 1]) >> 3);
-                    }
-                }
-            }
-            break;
-
-        case 2:
-            for (int z = 0; z < depthOut; ++z)
-            {
-                const unsigned char* inOuter = &pixelDataIn[(z * 2) * width_ * height_ * 2];
-                const unsigned char* inInner = &pixelDataIn[(z * 2 + 1) * width_ * height_ * 2];
-
-                for (int y = 0; y < heightOut; ++y)
-                {
-                    const unsigned char* inOuterUpper = &inOuter[(y * 2) * width_ * 2];
-                    const unsigned char* inOuterLower = &inOuter[(y * 2 + 1) * width_ * 2];
-                    const unsigned char* inInnerUpper = &inInner[(y * 2) * width_ * 2];
-                    const unsigned char* inInnerLower = &inInner[(y * 2 + 1) * width_ * 2];
-                    unsigned char* out = &pixelDataOut[z * widthOut * heightOut * 2 + y * widthOut * 2];
-
-                    for (int x = 0; x < widthOut * 2; x += 2)
-                    {
-                        out[x] = (unsigned char)(((unsigned)inOuterUpper[x * 2] + inOuterUpper[x * 2 + 2] +
-                                                  inOuterLower[x * 2] + inOuterLower[x * 2 + 2] +
-                                                  inInnerUpper[x * 2] + inInnerUpper[x * 2 + 2] +
-                                                  inInnerLower[x * 2] + inInnerLower[x * 2 + 2]) >> 3);
-                        out[x + 1] = (unsigned char)(((unsigned)inOuterUpper[x * 2 + 1] + inOuterUpper[x * 2 + 3] +
-                                                      inOuterLower[x * 2 + 1] + inOuterLower[x * 2 + 3] +
-                                                      inInnerUpper[x * 2 + 1] + inInnerUpper[x * 2 + 3] +
-                                                      inInnerLower[x * 2 + 1] + inInnerLower[x * 2 + 3]) >> 3);
-                    }
-                }
-            }
-            break;
-
-        case 3:
-            for (int z = 0; z < depthOut; ++z)
-            {
-                const unsigned char* inOuter = &pixelDataIn[(z * 2) * width_ * height_ * 3];
-                const unsigned char* inInner = &pixelDataIn[(z * 2 + 1) * width_ * height_ * 3];
-
-                for (int y = 0; y < heightOut; ++y)
-                {
-                    const unsigned char* inOuterUpper = &inOuter[(y * 2) * width_ * 3];
-                    const unsigned char* inOuterLower = &inOuter[(y * 2 + 1) * width_ * 3];
-                    const unsigned char* inInnerUpper = &inInner[(y * 2) * width_ * 3];
-                    const unsigned char* inInnerLower = &inInner[(y * 2 + 1) * width_ * 3];
-                    unsigned char* out = &pixelDataOut[z * widthOut * heightOut * 3 + y * widthOut * 3];
-
-                    for (int x = 0; x < widthOut * 3; x += 3)
-                    {
-                        out[x] = (unsigned char)(((unsigned)inOuterUpper[x * 2] + inOuterUpper[x * 2 + 3] +
-                                                  inOuterLower[x * 2] + inOuterLower[x * 2 + 3] +
-                                                  inInnerUpper[x * 2] + inInnerUpper[x * 2 + 3] +
-                                                  inInnerLower[x * 2] + inInnerLower[x * 2 + 3]) >> 3);
-                        out[x + 1] = (unsigned char)(((unsigned)inOuterUpper[x * 2 + 1] + inOuterUpper[x * 2 + 4] +
-                                                      inOuterLower[x * 2 + 1] + inOuterLower[x * 2 + 4] +
-                                                      inInnerUpper[x * 2 + 1] + inInnerUpper[x * 2 + 4] +
-                                                      inInnerLower[x * 2 + 1] + inInnerLower[x * 2 + 4]) >> 3);
-                        out[x + 2] = (unsigned char)(((unsigned)inOuterUpper[x * 2 + 2] + inOuterUpper[x * 2 + 5] +
-                                                      inOuterLower[x * 2 + 2] + inOuterLower[x * 2 + 5] +
-                                                      inInnerUpper[x * 2 + 2] + inInnerUpper[x * 2 + 5] +
-                                                      inInnerLower[x * 2 + 2] + inInnerLower[x * 2 + 5]) >> 3);
-                    }
-                }
-            }
-            break;
-
-        case 4:
-            for (int z = 0; z < depthOut; ++z)
+            switch (components_)
             {
-                const unsigned char* inOuter = &pixelDataIn[(z * 2) * width_ * height_ * 4];
-                const unsigned char* inInner = &pixelDataIn[(z * 2 + 1) * width_ * height_ * 4];
-
-                for (int y = 0; y < heightOut; ++y)
-                {
-                    const unsigned char* inOuterUpper = &inOuter[(y * 2) * width_ * 4];
-                    const unsigned char* inOuterLower = &inOuter[(y * 2 + 1) * width_ * 4];
-                    const unsigned char* inInnerUpper = &inInner[(y * 2) * width_ * 4];
-                    const unsigned char* inInnerLower = &inInner[(y * 2 + 1) * width_ * 4];
-                    unsigned char* out = &pixelDataOut[z * widthOut * heightOut * 4 + y * widthOut * 4];
-
-                    for (int x = 0; x < widthOut * 4; x += 4)
-                    {
-                        out[x] = (unsigned char)(((unsigned)inOuterUpper[x * 2] + inOuterUpper[x * 2 + 4] +
-                                                  inOuterLower[x * 2] + inOuterLower[x * 2 + 4] +
-                                                  inInnerUpper[x * 2] + inInnerUpper[x * 2 + 4] +
-                                                  inInnerLower[x * 2] + inInnerLower[x * 2 + 4]) >> 3);
-                        out[x + 1] = (unsigned char)(((unsigned)inOuterUpper[x * 2 + 1] + inOuterUpper[x * 2 + 5] +
-                                                      inOuterLower[x * 2 + 1] + inOuterLower[x * 2 + 5] +
-                                                      inInnerUpper[x * 2 + 1] + inInnerUpper[x * 2 + 5] +
-                                                      inInnerLower[x * 2 + 1] + inInnerLower[x * 2 + 5]) >> 3);
-                        out[x + 2] = (unsigned char)(((unsigned)inOuterUpper[x * 2 + 2] + inOuterUpper[x * 2 + 6] +
-                                                      inOuterLower[x * 2 + 2] + inOuterLower[x * 2 + 6] +
-                                                      inInnerUpper[x * 2 + 2] + inInnerUpper[x * 2 + 6] +
-                                                      inInnerLower[x * 2 + 2] + inInnerLower[x * 2 + 6]) >> 3);
-                        out[x + 3] = (unsigned char)(((unsigned)inOuterUpper[x * 2 + 3] + inOuterUpper[x * 2 + 7] +
-                                                      inOuterLower[x * 2 + 3] + inOuterLower[x * 2 + 7] +
-                                                      inInnerUpper[x * 2 + 3] + inInnerUpper[x * 2 + 7] +
-                                                      inInnerLower[x * 2 + 3] + inInnerLower[x * 2 + 7]) >> 3);
-                    }
-                }
+            case 1: DownsampleRows3D<1>(pixelDataOut, pixelDataIn, width_, height_, widthOut, heightOut, rowBegin, rowEnd); break;
+            case 2: DownsampleRows3D<2>(pixelDataOut, pixelDataIn, width_, height_, widthOut, heightOut, rowBegin, rowEnd); break;
+            case 3: DownsampleRows3D<3>(pixelDataOut, pixelDataIn, width_, height_, widthOut, heightOut, rowBegin, rowEnd); break;
+            case 4: DownsampleRows3D<4>(pixelDataOut, pixelDataIn, width_, height_, widthOut, heightOut, rowBegin, rowEnd); break;
+            default:
+                assert(false);  // Should never reach here
+                break;
             }
-            break;
-
-        default:
-            assert(false);  // Should never reach here
-            break;
-        }
+        });
     }
 
     return mipImage;
@@ -1931,47 +1921,56 @@ SharedPtr<Image> Image::ConvertToRGBA() const
     SharedPtr<Image> ret(context_->CreateObject<Image>());
     ret->SetSize(width_, height_, depth_, 4);
 
-    const unsigned char* src = data_.get();
-    unsigned char* dest = ret->GetData();
+    const unsigned char* srcData = data_.get();
+    unsigned char* destData = ret->GetData();
+    const int numComponents = components_;
+    const int rowSize = width_;
 
-    switch (components_)
+    ProcessImageRows(context_, height_ * depth_, width_ * height_ * depth_, [&](int rowBegin, int rowEnd)
     {
-    case 1:
-        for (unsigned i = 0; i < static_cast<unsigned>(width_ * height_ * depth_); ++i)
-        {
-            unsigned char pixel = *src++;
-            *dest++ = pixel;
-            *dest++ = pixel;
-            *dest++ = pixel;
-            *dest++ = 255;
-        }
-        break;
+        const unsigned char* src = srcData + rowBegin * rowSize * numComponents;
+        unsigned char* dest = destData + rowBegin * rowSize * 4;
+        const unsigned numPixels = static_cast<unsigned>((rowEnd - rowBegin) * rowSize);
 
-    case 2:
-        for (unsigned i = 0; i < static_cast<unsigned>(width_ * height_ * depth_); ++i)
+        switch (numComponents)
         {
-            unsigned char pixel = *src++;
-            *dest++ = pixel;
-            *dest++ = pixel;
-            *dest++ = pixel;
-            *dest++ = *src++;
-        }
-        break;
+        case 1:
+            for (unsigned i = 0; i < numPixels; ++i)
+            {
+                unsigned char pixel = *src++;
+                *dest++ = pixel;
+                *dest++ = pixel;
+                *dest++ = pixel;
+                *dest++ = 255;
+            }
+            break;
 
-    case 3:
-        for (unsigned i = 0; i < static_cast<unsigned>(width_ * height_ * depth_); ++i)
-        {
-            *dest++ = *src++;
-            *dest++ = *src++;
-            *dest++ = *src++;
-            *dest++ = 255;
-        }
-        break;
+        case 2:
+            for (unsigned i = 0; i < numPixels; ++i)
+            {
+                unsigned char pixel = *src++;
+                *dest++ = pixel;
+                *dest++ = pixel;
+                *dest++ = pixel;
+                *dest++ = *src++;
+            }
+            break;
 
-    default:
-        assert(false);  // Should never reach nere
-        break;
-    }
+        case 3:
+            for (unsigned i = 0; i < numPixels; ++i)
+            {
+                *dest++ = *src++;
+                *dest++ = *src++;
+                *dest++ = *src++;
+                *dest++ = 255;
+            }
+            break;
+
+        default:
+            assert(false);  // Should never reach nere
+            break;
+        }
+    });
 
     return ret;
 }
@@ -2120,11 +2119,86 @@ SharedPtr<Image> Image::GetDecompressedImage() const
 
     auto decompressedImage = MakeShared<Image>(context_);
     decompressedImage->SetSize(compressedLevel.width_, compressedLevel.height_, 4);
-    compressedLevel.Decompress(decompressedImage->GetData());
+
+    // Block formats are decompressed in independent rows of blocks
+    unsigned char* dest = decompressedImage->GetData();
+    if (compressedLevel.depth_ == 1 && IsBlockRowDecompressible(compressedLevel.format_))
+    {
+        const int numBlockRows = (compressedLevel.height_ + 3) / 4;
+        ProcessImageRows(context_, numBlockRows, compressedLevel.width_ * compressedLevel.height_, [&](int blockRowBegin, int blockRowEnd)
+        {
+            DecompressBlockRows(dest, compressedLevel, blockRowBegin, blockRowEnd);
+        });
+    }
+    else
+        compressedLevel.Decompress(dest);
 
     return decompressedImage;
 }
 
+SharedPtr<Image> Image::GetCompressedImage(CompressedFormat format) const
+{
+    if (format != CF_DXT1)
+    {
+        URHO3D_LOGERROR("Only DXT1 image compression is supported");
+        return SharedPtr<Image>();
+    }
+    if (depth_ > 1 || cubemap_ || array_)
+    {
+        URHO3D_LOGERROR("Can not compress 3D, cube or array image");
+        return SharedPtr<Image>();
+    }
+
+    if (IsCompressed())
+    {
+        if (compressedFormat_ == format)
+            return SharedPtr<Image>(const_cast<Image*>(this));
+
+        return GetDecompressedImage()->GetCompressedImage(format);
+    }
+
+    URHO3D_PROFILE("CompressImage");
+
+    // Collect mip chain down to 1x1
+    ea::vector<SharedPtr<Image>> levels;
+    levels.push_back(ConvertToRGBA());
+    if (!levels.back())
+        return SharedPtr<Image>();
+
+    while (levels.back()->GetWidth() > 1 || levels.back()->GetHeight() > 1)
+    {
+        SharedPtr<Image> nextLevel = levels.back()->GetNextLevel();
+        if (!nextLevel)
+            return SharedPtr<Image>();
+        levels.push_back(nextLevel);
+    }
+
+    static const unsigned blockSize = 8;
+    unsigned dataSize = 0;
+    for (const Image* level : levels)
+        dataSize += ((level->GetWidth() + 3) / 4) * ((level->GetHeight() + 3) / 4) * blockSize;
+
+    auto compressedImage = MakeShared<Image>(context_);
+    compressedImage->data_ = new unsigned char[dataSize];
+    compressedImage->width_ = width_;
+    compressedImage->height_ = height_;
+    compressedImage->depth_ = 1;
+    compressedImage->components_ = 3;
+    compressedImage->compressedFormat_ = format;
+    compressedImage->numCompressedLevels_ = levels.size();
+    compressedImage->sRGB_ = sRGB_;
+    compressedImage->SetMemoryUse(dataSize);
+
+    unsigned char* dest = compressedImage->data_.get();
+    for (const Image* level : levels)
+    {
+        CompressImageDXT1(dest, level->GetData(), level->GetWidth(), level->GetHeight());
+        dest += ((level->GetWidth() + 3) / 4) * ((level->GetHeight() + 3) / 4) * blockSize;
+    }
+
+    return compressedImage;
+}
+
 SharedPtr<Image> Image::GetSubimage(const IntRect& rect) const
 {
     if (!data_)
@@ -2353,6 +2427,14 @@ unsigned char* Image::GetImageData(Deserializer& source, int& width, int& height
 {
     unsigned dataSize = source.GetSize();
 
+    // Decode in place when the data is already in memory, such as from a memory mapped package
+    if (const unsigned char* data = source.GetMemoryData())
+    {
+        const unsigned position = source.GetPosition();
+        source.Seek(dataSize);
+        return stbi_load_from_memory(data + position, dataSize - position, &width, &height, (int*)&components, 0);
+    }
+
     ea::shared_array<unsigned char> buffer(new unsigned char[dataSize]);
     source.Read(buffer.get(), dataSize);
     return stbi_load_from_memory(buffer.get(), dataSize, &width, &height, (int*)&components, 0);
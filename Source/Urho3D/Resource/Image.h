@@ -133,7 +133,7 @@ public:
     bool SaveTGA(const ea::string& fileName) const;
     /// Save in JPG format with specified quality. Return true if successful.
     bool SaveJPG(const ea::string& fileName, int quality) const;
-    /// Save in DDS format. Only uncompressed RGBA images are supported. Return true if successful.
+    /// Save in DDS format. Only uncompressed RGBA and DXT compressed images are supported. Return true if successful.
     bool SaveDDS(const ea::string& fileName) const;
     /// Save in WebP format with minimum (fastest) or specified compression. Return true if successful. Fails always if WebP support is not compiled in.
     bool SaveWEBP(const ea::string& fileName, float compression = 0.0f) const;
@@ -201,6 +201,8 @@ public:
     CompressedLevel GetCompressedLevel(unsigned index) const;
     /// Return decompressed image data in RGBA format.
     SharedPtr<Image> GetDecompressedImage() const;
+    /// Return image compressed into the specified format, including full mip chain. Only DXT1 compression of 2D images is supported.
+    SharedPtr<Image> GetCompressedImage(CompressedFormat format) const;
     /// Return subimage from the image by the defined rect or null if failed. 3D images are not supported. You must free the subimage yourself.
     SharedPtr<Image> GetSubimage(const IntRect& rect) const;
     /// Return an SDL surface from the image, or null if failed. Only RGB images are supported. Specify rect to only return partial image. You must free the surface yourself.
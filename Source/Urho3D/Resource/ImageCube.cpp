@@ -26,6 +26,7 @@
 #include "../Core/Context.h"
 #include "../IO/FileSystem.h"
 #include "../IO/Log.h"
+#include "../IO/MemoryBuffer.h"
 #include "../Resource/ResourceCache.h"
 #include "../Resource/XMLFile.h"
 
@@ -175,6 +176,8 @@ bool ImageCube::BeginLoad(Deserializer& source)
     // Face per image
     else
     {
+        // Issue the reads of all faces first so that they are in flight together, then decode in order
+        ea::vector<ea::pair<ea::string, SharedPtr<AsyncFileRead> > > faceReads;
         XMLElement faceElem = textureElem.GetChild("face");
         while (faceElem)
         {
@@ -184,11 +187,25 @@ bool ImageCube::BeginLoad(Deserializer& source)
             if (GetPath(name).empty())
                 name = texPath + name;
 
-            faceImages_.push_back(cache->GetTempResource<Image>(name));
-            cache->StoreResourceDependency(this, name);
-
+            faceReads.emplace_back(name, cache->ReadFileAsync(name));
             faceElem = faceElem.GetNext("face");
         }
+
+        for (auto& faceRead : faceReads)
+        {
+            SharedPtr<Image> faceImage;
+            if (faceRead.second->Wait())
+            {
+                faceImage = MakeShared<Image>(context_);
+                faceImage->SetName(faceRead.first);
+                MemoryBuffer buffer(faceRead.second->GetData());
+                if (!faceImage->Load(buffer))
+                    faceImage.Reset();
+            }
+
+            faceImages_.push_back(faceImage);
+            cache->StoreResourceDependency(this, faceRead.first);
+        }
     }
 
     // Precalculate mip levels if async loading
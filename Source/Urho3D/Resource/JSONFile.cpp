@@ -31,9 +31,13 @@
 #include "../Resource/ResourceCache.h"
 
 #include <rapidjson/document.h>
+#include <rapidjson/memorystream.h>
+#include <rapidjson/reader.h>
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/prettywriter.h>
 
+#include <climits>
+
 #include "../DebugNew.h"
 
 using namespace rapidjson;
@@ -53,61 +57,77 @@ void JSONFile::RegisterObject(Context* context)
     context->RegisterFactory<JSONFile>();
 }
 
-// Convert rapidjson value to JSON value.
-static void ToJSONValue(JSONValue& jsonValue, const rapidjson::Value& rapidjsonValue)
+namespace
 {
-    switch (rapidjsonValue.GetType())
-    {
-    case kNullType:
-        // Reset to null type
-        jsonValue.SetType(JSON_NULL);
-        break;
-
-    case kFalseType:
-        jsonValue = false;
-        break;
 
-    case kTrueType:
-        jsonValue = true;
-        break;
-
-    case kNumberType:
-        if (rapidjsonValue.IsInt())
-            jsonValue = rapidjsonValue.GetInt();
-        else if (rapidjsonValue.IsUint())
-            jsonValue = rapidjsonValue.GetUint();
+/// SAX handler that builds a JSON value directly, without an intermediate rapidjson document.
+class JSONValueBuilder : public BaseReaderHandler<UTF8<>, JSONValueBuilder>
+{
+public:
+    /// Construct with the value to build.
+    explicit JSONValueBuilder(JSONValue& root) : root_(root) {}
+
+    bool Null() { AddValue(JSONValue(JSON_NULL)); return true; }
+    bool Bool(bool value) { AddValue(value); return true; }
+    bool Int(int value) { AddValue(value); return true; }
+    /// Store non-negative numbers that fit as signed integers, as the rapidjson document does.
+    bool Uint(unsigned value)
+    {
+        if (value <= INT_MAX)
+            AddValue(static_cast<int>(value));
         else
-            jsonValue = rapidjsonValue.GetDouble();
-        break;
-
-    case kStringType:
-        jsonValue = rapidjsonValue.GetString();
-        break;
-
-    case kArrayType:
+            AddValue(value);
+        return true;
+    }
+    bool Int64(int64_t value) { AddValue(static_cast<double>(value)); return true; }
+    bool Uint64(uint64_t value) { AddValue(static_cast<double>(value)); return true; }
+    bool Double(double value) { AddValue(value); return true; }
+    bool String(const char* value, SizeType length, bool /*copy*/) { AddValue(ea::string(value, length)); return true; }
+    bool StartObject() { containers_.push_back(&AddValue(JSONValue(JSON_OBJECT))); return true; }
+    bool Key(const char* value, SizeType length, bool /*copy*/) { key_.assign(value, length); return true; }
+    bool EndObject(SizeType /*memberCount*/) { containers_.pop_back(); return true; }
+    bool StartArray() { containers_.push_back(&AddValue(JSONValue(JSON_ARRAY))); return true; }
+    bool EndArray(SizeType /*elementCount*/) { containers_.pop_back(); return true; }
+
+private:
+    /// Add value to the innermost open array or object, or set the root value. Return the stored value.
+    JSONValue& AddValue(JSONValue value)
+    {
+        if (containers_.empty())
         {
-            jsonValue.Resize(rapidjsonValue.Size());
-            for (unsigned i = 0; i < rapidjsonValue.Size(); ++i)
-            {
-                ToJSONValue(jsonValue[i], rapidjsonValue[i]);
-            }
+            root_ = ea::move(value);
+            return root_;
         }
-        break;
 
-    case kObjectType:
+        // Only the innermost container is modified, so the pointers to the outer ones stay valid
+        JSONValue& container = *containers_.back();
+        if (container.IsArray())
         {
-            jsonValue.SetType(JSON_OBJECT);
-            for (rapidjson::Value::ConstMemberIterator i = rapidjsonValue.MemberBegin(); i != rapidjsonValue.MemberEnd(); ++i)
-            {
-                JSONValue& value = jsonValue[ea::string(i->name.GetString())];
-                ToJSONValue(value, i->value);
-            }
+            container.Push(ea::move(value));
+            return container[container.Size() - 1];
         }
-        break;
 
-    default:
-        break;
+        JSONValue& member = container[key_];
+        member = ea::move(value);
+        return member;
     }
+
+    /// Root value.
+    JSONValue& root_;
+    /// Arrays and objects being filled, innermost last.
+    ea::vector<JSONValue*> containers_;
+    /// Key of the next object member.
+    ea::string key_;
+};
+
+/// Parse JSON from a stream into a JSON value. Return true if successful.
+template <unsigned ParseFlags, class Stream> bool ParseJSONValue(JSONValue& value, Stream& stream)
+{
+    JSONValueBuilder builder(value);
+    Reader reader;
+    return !reader.Parse<ParseFlags>(stream, builder).IsError();
+}
+
 }
 
 bool JSONFile::BeginLoad(Deserializer& source)
@@ -119,19 +139,36 @@ bool JSONFile::BeginLoad(Deserializer& source)
         return false;
     }
 
-    ea::shared_array<char> buffer(new char[dataSize + 1]);
-    if (source.Read(buffer.get(), dataSize) != dataSize)
-        return false;
-    buffer[dataSize] = '\0';
+    // Parse straight into the JSON value tree. Data already in memory is parsed without copying, otherwise read
+    // it to a buffer that can be parsed in place
+    static const unsigned parseFlags = kParseCommentsFlag | kParseTrailingCommasFlag;
+    JSONValue root;
+    bool success;
+    if (const unsigned char* memoryData = source.GetMemoryData())
+    {
+        const unsigned position = source.GetPosition();
+        MemoryStream stream(reinterpret_cast<const char*>(memoryData) + position, dataSize - position);
+        success = ParseJSONValue<parseFlags>(root, stream);
+        source.Seek(dataSize);
+    }
+    else
+    {
+        ea::shared_array<char> buffer(new char[dataSize + 1]);
+        if (source.Read(buffer.get(), dataSize) != dataSize)
+            return false;
+        buffer[dataSize] = '\0';
 
-    rapidjson::Document document;
-    if (document.Parse<kParseCommentsFlag | kParseTrailingCommasFlag>(buffer.get()).HasParseError())
+        InsituStringStream stream(buffer.get());
+        success = ParseJSONValue<parseFlags | kParseInsituFlag>(root, stream);
+    }
+
+    if (!success)
     {
         URHO3D_LOGERROR("Could not parse JSON data from " + source.GetName());
         return false;
     }
 
-    ToJSONValue(root_, document);
+    root_ = ea::move(root);
 
     SetMemoryUse(dataSize);
 
@@ -239,15 +276,19 @@ bool JSONFile::FromString(const ea::string & source)
 
 bool JSONFile::ParseJSON(const ea::string& json, JSONValue& value, bool reportError)
 {
-    rapidjson::Document document;
-    if (document.Parse<0>(json.c_str()).HasParseError())
+    StringStream stream(json.c_str());
+    JSONValue result;
+    JSONValueBuilder builder(result);
+    Reader reader;
+    const ParseResult parseResult = reader.Parse<0>(stream, builder);
+    if (parseResult.IsError())
     {
         if (reportError)
-            URHO3D_LOGERRORF("Could not parse JSON data from string with error: %s", document.GetParseError());
+            URHO3D_LOGERRORF("Could not parse JSON data from string with error: %d", parseResult.Code());
 
         return false;
     }
-    ToJSONValue(value, document);
+    value = ea::move(result);
     return true;
 }
 
@@ -29,6 +29,7 @@
 #include "../IO/FileSystem.h"
 #include "../IO/FileWatcher.h"
 #include "../IO/Log.h"
+#include "../IO/MemoryBuffer.h"
 #include "../IO/PackageFile.h"
 #include "../Resource/BackgroundLoader.h"
 #include "../Resource/BinaryFile.h"
@@ -42,6 +43,8 @@
 
 #include "../DebugNew.h"
 
+#include <EASTL/sort.h>
+
 #include <cstdio>
 
 namespace Urho3D
@@ -122,6 +125,7 @@ bool ResourceCache::AddResourceDir(const ea::string& pathName, unsigned priority
         resourceDirs_.insert_at(priority, fixedPath);
     else
         resourceDirs_.push_back(fixedPath);
+    UpdateRelativeResourceDirs();
 
     // If resource auto-reloading active, create a file watcher for the directory
     if (autoReloadResources_)
@@ -146,6 +150,9 @@ bool ResourceCache::AddPackageFile(PackageFile* package, unsigned priority)
         return false;
     }
 
+    if (memoryMapPackages_ && !package->MapMemory())
+        URHO3D_LOGWARNING("Could not map package file " + package->GetName() + " to memory, reading it through file I/O");
+
     if (priority < packages_.size())
         packages_.insert_at(priority, SharedPtr<PackageFile>(package));
     else
@@ -177,6 +184,7 @@ bool ResourceCache::AddManualResource(Resource* resource)
     }
 
     resource->ResetUseTimer();
+    IndexResource(resource);
     resourceGroups_[resource->GetType()].resources_[resource->GetNameHash()] = resource;
     UpdateResourceGroup(resource->GetType());
     return true;
@@ -193,6 +201,7 @@ void ResourceCache::RemoveResourceDir(const ea::string& pathName)
         if (!resourceDirs_[i].comparei(fixedPath))
         {
             resourceDirs_.erase_at(i);
+            UpdateRelativeResourceDirs();
             // Remove the filewatcher with the matching path
             for (unsigned j = 0; j < fileWatchers_.size(); ++j)
             {
@@ -255,6 +264,7 @@ void ResourceCache::ReleaseResource(StringHash type, const ea::string& name, boo
     // If other references exist, do not release, unless forced
     if ((existingRes.Refs() == 1 && existingRes.WeakRefs() == 0) || force)
     {
+        UnindexResource(type, nameHash);
         resourceGroups_[type].resources_.erase(nameHash);
         UpdateResourceGroup(type);
     }
@@ -279,6 +289,7 @@ void ResourceCache::ReleaseResource(const ea::string& resourceName, bool force)
                     // If other references exist, do not release, unless forced
                     if ((current->second.Refs() == 1 && current->second.WeakRefs() == 0) || force)
                     {
+                        UnindexResource(i->first, current->first);
                         j = i->second.resources_.erase(current);
                         released = true;
                         continue;
@@ -307,6 +318,7 @@ void ResourceCache::ReleaseResources(StringHash type, bool force)
             // If other references exist, do not release, unless forced
             if ((current->second.Refs() == 1 && current->second.WeakRefs() == 0) || force)
             {
+                UnindexResource(i->first, current->first);
                 i->second.resources_.erase(current);
                 released = true;
             }
@@ -333,6 +345,7 @@ void ResourceCache::ReleaseResources(StringHash type, const ea::string& partialN
                 // If other references exist, do not release, unless forced
                 if ((current->second.Refs() == 1 && current->second.WeakRefs() == 0) || force)
                 {
+                    UnindexResource(i->first, current->first);
                     i->second.resources_.erase(current);
                     released = true;
                 }
@@ -365,6 +378,7 @@ void ResourceCache::ReleaseResources(const ea::string& partialName, bool force)
                     // If other references exist, do not release, unless forced
                     if ((current->second.Refs() == 1 && current->second.WeakRefs() == 0) || force)
                     {
+                        UnindexResource(i->first, current->first);
                         i->second.resources_.erase(current);
                         released = true;
                     }
@@ -394,6 +408,7 @@ void ResourceCache::ReleaseAllResources(bool force)
                 // If other references exist, do not release, unless forced
                 if ((current->second.Refs() == 1 && current->second.WeakRefs() == 0) || force)
                 {
+                    UnindexResource(i->first, current->first);
                     i->second.resources_.erase(current);
                     released = true;
                 }
@@ -417,13 +432,22 @@ bool ResourceCache::ReloadResource(Resource* resource)
     if (!resource)
         return false;
 
-    resource->SendEvent(E_RELOADSTARTED);
-
-    bool success = false;
     SharedPtr<File> file = GetFile(resource->GetName());
-    if (file)
-        success = resource->Load(*(file.Get()));
+    if (!file)
+    {
+        resource->SendEvent(E_RELOADSTARTED);
+        resource->SendEvent(E_RELOADFAILED);
+        return false;
+    }
 
+    return ReloadResource(resource, *file);
+}
+
+bool ResourceCache::ReloadResource(Resource* resource, Deserializer& source)
+{
+    resource->SendEvent(E_RELOADSTARTED);
+
+    const bool success = resource->Load(source);
     if (success)
     {
         resource->ResetUseTimer();
@@ -480,6 +504,13 @@ void ResourceCache::ReloadResourceWithDependencies(const ea::string& fileName)
 void ResourceCache::SetMemoryBudget(StringHash type, unsigned long long budget)
 {
     resourceGroups_[type].memoryBudget_ = budget;
+    UpdateResourceGroup(type);
+}
+
+void ResourceCache::SetTotalMemoryBudget(unsigned long long budget)
+{
+    totalMemoryBudget_ = budget;
+    EnforceTotalMemoryBudget();
 }
 
 void ResourceCache::SetAutoReloadResources(bool enable)
@@ -496,7 +527,11 @@ void ResourceCache::SetAutoReloadResources(bool enable)
             }
         }
         else
+        {
             fileWatchers_.clear();
+            changedFiles_.clear();
+            changedFileHashes_.clear();
+        }
 
         autoReloadResources_ = enable;
     }
@@ -529,6 +564,23 @@ void ResourceCache::RemoveResourceRouter(ResourceRouter* router)
     }
 }
 
+SharedPtr<AsyncFileRead> ResourceCache::ReadFileAsync(const ea::string& name, bool sendEventOnFailure)
+{
+    SharedPtr<File> file = GetFile(name, sendEventOnFailure);
+    return GetSubsystem<FileSystem>()->ReadFileAsync(file);
+}
+
+void ResourceCache::PrefetchResources(const ea::vector<ea::string>& names)
+{
+    URHO3D_PROFILE("PrefetchResources");
+
+    for (const ea::string& name : names)
+    {
+        if (SharedPtr<File> file = GetFile(name, false))
+            file->Prefetch();
+    }
+}
+
 SharedPtr<File> ResourceCache::GetFile(const ea::string& name, bool sendEventOnFailure)
 {
     MutexLock lock(resourceMutex_);
@@ -581,19 +633,17 @@ Resource* ResourceCache::GetExistingResource(StringHash type, const ea::string&
 {
     ea::string sanitatedName = SanitateResourceName(name);
 
-    if (!Thread::IsMainThread())
-    {
-        URHO3D_LOGERROR("Attempted to get resource " + sanitatedName + " from outside the main thread");
-        return nullptr;
-    }
-
     // If empty name, return null pointer immediately
     if (sanitatedName.empty())
         return nullptr;
 
     StringHash nameHash(sanitatedName);
 
-    const SharedPtr<Resource>& existing = type == StringHash::ZERO ? FindResource(type, nameHash) : FindResource(nameHash);
+    // Other threads must not touch the resource groups, which the main thread modifies without locking
+    if (!Thread::IsMainThread())
+        return FindIndexedResource(type, nameHash);
+
+    const SharedPtr<Resource>& existing = type != StringHash::ZERO ? FindResource(type, nameHash) : FindResource(nameHash);
     return existing;
 }
 
@@ -613,6 +663,9 @@ Resource* ResourceCache::GetResource(StringHash type, const ea::string& name, bo
 
     StringHash nameHash(sanitatedName);
 
+    if (recordLoadGraph_)
+        loadGraph_.AddDependency(nullptr, type, sanitatedName);
+
 #ifdef URHO3D_THREADING
     // Check if the resource is being background loaded but is now needed immediately
     backgroundLoader_->WaitForResource(type, nameHash);
@@ -620,7 +673,11 @@ Resource* ResourceCache::GetResource(StringHash type, const ea::string& name, bo
 
     const SharedPtr<Resource>& existing = FindResource(type, nameHash);
     if (existing)
+    {
+        // Requests count as use for the least recently used order
+        existing->ResetUseTimer();
         return existing;
+    }
 
     SharedPtr<Resource> resource;
     // Make sure the pointer is non-null and is a Resource subclass
@@ -650,7 +707,18 @@ Resource* ResourceCache::GetResource(StringHash type, const ea::string& name, bo
     resource->SetName(sanitatedName);
     resource->SetAbsoluteFileName(file->GetAbsoluteName());
 
-    if (!resource->Load(*(file.Get())))
+    // Let the known dependencies load in the background while this resource is being loaded
+    if (prefetchDependencies_)
+        PrefetchDependencies(sanitatedName);
+
+    if (recordLoadGraph_)
+        loadGraph_.BeginLoad(resource);
+    const bool success = resource->Load(*(file.Get()));
+    if (recordLoadGraph_)
+        loadGraph_.EndLoad(resource);
+    ++numSyncLoads_;
+
+    if (!success)
     {
         // Error should already been logged by corresponding resource descendant class
         if (sendEventOnFailure)
@@ -668,6 +736,7 @@ Resource* ResourceCache::GetResource(StringHash type, const ea::string& name, bo
 
     // Store to cache
     resource->ResetUseTimer();
+    IndexResource(resource);
     resourceGroups_[type].resources_[nameHash] = resource;
     UpdateResourceGroup(type);
 
@@ -682,18 +751,115 @@ bool ResourceCache::BackgroundLoadResource(StringHash type, const ea::string& na
     if (sanitatedName.empty())
         return false;
 
+    if (recordLoadGraph_)
+        loadGraph_.AddDependency(caller, type, sanitatedName);
+
     // First check if already exists as a loaded resource
     StringHash nameHash(sanitatedName);
-    if (FindResource(type, nameHash) != noResource)
+    if (FindIndexedResource(type, nameHash))
         return false;
 
-    return backgroundLoader_->QueueResource(type, sanitatedName, sendEventOnFailure, caller);
+    if (!backgroundLoader_->QueueResource(type, sanitatedName, sendEventOnFailure, caller))
+        return false;
+
+    // Dependencies of a resource being loaded were prefetched together with the resource that requested it
+    if (prefetchDependencies_ && !caller)
+        PrefetchDependencies(sanitatedName);
+    return true;
 #else
     // When threading not supported, fall back to synchronous loading
     return GetResource(type, name, sendEventOnFailure);
 #endif
 }
 
+bool ResourceCache::LoadDependencyManifest(const ea::string& name)
+{
+    SharedPtr<XMLFile> xml = GetTempResource<XMLFile>(name);
+    if (!xml)
+        return false;
+
+    XMLElement rootElem = xml->GetRoot("manifest");
+    if (!rootElem)
+    {
+        URHO3D_LOGERROR("Invalid dependency manifest " + name);
+        return false;
+    }
+
+    MutexLock lock(resourceMutex_);
+    for (XMLElement resourceElem = rootElem.GetChild("resource"); resourceElem; resourceElem = resourceElem.GetNext("resource"))
+    {
+        auto& dependencies = dependencyManifest_[StringHash(resourceElem.GetAttribute("name"))];
+        for (XMLElement dependencyElem = resourceElem.GetChild("dependency"); dependencyElem;
+             dependencyElem = dependencyElem.GetNext("dependency"))
+        {
+            ea::pair<StringHash, ea::string> dependency{
+                StringHash(dependencyElem.GetAttribute("type")), dependencyElem.GetAttribute("name")};
+            if (!dependencies.contains(dependency))
+                dependencies.push_back(ea::move(dependency));
+        }
+    }
+
+    return true;
+}
+
+bool ResourceCache::SaveDependencyManifest(const ea::string& fileName) const
+{
+    XMLFile xml(context_);
+    XMLElement rootElem = xml.CreateRoot("manifest");
+    loadGraph_.SaveManifest(rootElem);
+    return xml.SaveFile(fileName);
+}
+
+void ResourceCache::ClearDependencyManifest()
+{
+    MutexLock lock(resourceMutex_);
+    dependencyManifest_.clear();
+}
+
+void ResourceCache::PrefetchDependencies(const ea::string& name)
+{
+#ifdef URHO3D_THREADING
+    const StringHash nameHash(SanitateResourceName(name));
+
+    // Collect the whole dependency closure first, so that the queue is not locked while holding the resource mutex
+    ea::vector<ea::pair<StringHash, ea::string> > closure;
+    {
+        MutexLock lock(resourceMutex_);
+        if (dependencyManifest_.empty())
+            return;
+
+        ea::hash_set<StringHash> visited;
+        ea::vector<StringHash> pending;
+        visited.insert(nameHash);
+        pending.push_back(nameHash);
+        while (!pending.empty())
+        {
+            auto i = dependencyManifest_.find(pending.back());
+            pending.pop_back();
+            if (i == dependencyManifest_.end())
+                continue;
+
+            for (const auto& dependency : i->second)
+            {
+                const StringHash dependencyHash(dependency.second);
+                if (visited.insert(dependencyHash).second)
+                {
+                    closure.push_back(dependency);
+                    pending.push_back(dependencyHash);
+                }
+            }
+        }
+    }
+
+    // Queue the deepest dependencies first, as everything else ends up waiting for them
+    for (auto i = closure.rbegin(); i != closure.rend(); ++i)
+    {
+        if (!FindIndexedResource(i->first, StringHash(i->second)))
+            backgroundLoader_->QueueResource(i->first, i->second, true, nullptr);
+    }
+#endif
+}
+
 SharedPtr<Resource> ResourceCache::GetTempResource(StringHash type, const ea::string& name, bool sendEventOnFailure)
 {
     ea::string sanitatedName = SanitateResourceName(name);
@@ -748,6 +914,38 @@ SharedPtr<Resource> ResourceCache::GetTempResource(StringHash type, const ea::st
     return resource;
 }
 
+void ResourceCache::SetNumBackgroundLoadThreads(unsigned numThreads)
+{
+#ifdef URHO3D_THREADING
+    backgroundLoader_->SetNumThreads(numThreads);
+#endif
+}
+
+void ResourceCache::SetMaxConcurrentBackgroundLoads(StringHash type, unsigned maxLoads)
+{
+#ifdef URHO3D_THREADING
+    backgroundLoader_->SetMaxConcurrentLoads(type, maxLoads);
+#endif
+}
+
+unsigned ResourceCache::GetNumBackgroundLoadThreads() const
+{
+#ifdef URHO3D_THREADING
+    return backgroundLoader_->GetNumThreads();
+#else
+    return 0;
+#endif
+}
+
+unsigned ResourceCache::GetMaxConcurrentBackgroundLoads(StringHash type) const
+{
+#ifdef URHO3D_THREADING
+    return backgroundLoader_->GetMaxConcurrentLoads(type);
+#else
+    return 0;
+#endif
+}
+
 unsigned ResourceCache::GetNumBackgroundLoadResources() const
 {
 #ifdef URHO3D_THREADING
@@ -877,23 +1075,21 @@ ea::string ResourceCache::GetPreferredResourceDir(const ea::string& path) const
 
 ea::string ResourceCache::SanitateResourceName(const ea::string& name) const
 {
+    if (IsSanitatedResourceName(name))
+        return name;
+
     // Sanitate unsupported constructs from the resource name
     ea::string sanitatedName = GetInternalPath(name);
     sanitatedName.replace("../", "");
     sanitatedName.replace("./", "");
 
     // If the path refers to one of the resource directories, normalize the resource name
-    auto* fileSystem = GetSubsystem<FileSystem>();
     if (resourceDirs_.size())
     {
         ea::string namePath = GetPath(sanitatedName);
-        ea::string exePath = fileSystem->GetProgramDir().replaced("/./", "/");
         for (unsigned i = 0; i < resourceDirs_.size(); ++i)
         {
-            ea::string relativeResourcePath = resourceDirs_[i];
-            if (relativeResourcePath.starts_with(exePath))
-                relativeResourcePath = relativeResourcePath.substr(exePath.length());
-
+            const ea::string& relativeResourcePath = relativeResourceDirs_[i];
             if (namePath.starts_with(resourceDirs_[i], false))
                 namePath = namePath.substr(resourceDirs_[i].length());
             else if (namePath.starts_with(relativeResourcePath, false))
@@ -907,6 +1103,47 @@ ea::string ResourceCache::SanitateResourceName(const ea::string& name) const
     return sanitatedName;
 }
 
+bool ResourceCache::IsSanitatedResourceName(const ea::string& name) const
+{
+    if (name.empty())
+        return true;
+
+    // Leading and trailing spaces and tabs are trimmed
+    const auto isBlank = [](char ch) { return ch == ' ' || ch == '\t'; };
+    if (isBlank(name.front()) || isBlank(name.back()))
+        return false;
+
+    // Backslashes are converted and relative path components are removed
+    if (name.find('\\') != ea::string::npos || name.find("./") != ea::string::npos)
+        return false;
+
+    // Resource directory prefixes are stripped. If none matches the original name, none matches later either
+    for (unsigned i = 0; i < resourceDirs_.size(); ++i)
+    {
+        if (name.starts_with(resourceDirs_[i], false))
+            return false;
+        // Empty relative path matches everything but strips nothing
+        if (!relativeResourceDirs_[i].empty() && name.starts_with(relativeResourceDirs_[i], false))
+            return false;
+    }
+
+    return true;
+}
+
+void ResourceCache::UpdateRelativeResourceDirs()
+{
+    const ea::string exePath = GetSubsystem<FileSystem>()->GetProgramDir().replaced("/./", "/");
+
+    relativeResourceDirs_.clear();
+    for (const ea::string& resourceDir : resourceDirs_)
+    {
+        if (resourceDir.starts_with(exePath))
+            relativeResourceDirs_.push_back(resourceDir.substr(exePath.length()));
+        else
+            relativeResourceDirs_.push_back(resourceDir);
+    }
+}
+
 ea::string ResourceCache::SanitateResourceDirName(const ea::string& name) const
 {
     ea::string fixedPath = AddTrailingSlash(name);
@@ -1042,6 +1279,55 @@ const SharedPtr<Resource>& ResourceCache::FindResource(StringHash nameHash)
     return noResource;
 }
 
+Resource* ResourceCache::FindIndexedResource(StringHash type, StringHash nameHash) const
+{
+    const ResourceIndexShard& shard = GetIndexShard(nameHash);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex_);
+
+    const auto range = shard.resources_.equal_range(nameHash);
+    for (auto i = range.first; i != range.second; ++i)
+    {
+        if (type == StringHash::ZERO || i->second.first == type)
+            return i->second.second;
+    }
+    return nullptr;
+}
+
+void ResourceCache::IndexResource(Resource* resource)
+{
+    const StringHash type = resource->GetType();
+    const StringHash nameHash = resource->GetNameHash();
+    ResourceIndexShard& shard = GetIndexShard(nameHash);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex_);
+
+    const auto range = shard.resources_.equal_range(nameHash);
+    for (auto i = range.first; i != range.second; ++i)
+    {
+        if (i->second.first == type)
+        {
+            i->second.second = resource;
+            return;
+        }
+    }
+    shard.resources_.emplace(nameHash, ea::make_pair(type, resource));
+}
+
+void ResourceCache::UnindexResource(StringHash type, StringHash nameHash)
+{
+    ResourceIndexShard& shard = GetIndexShard(nameHash);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex_);
+
+    const auto range = shard.resources_.equal_range(nameHash);
+    for (auto i = range.first; i != range.second; ++i)
+    {
+        if (i->second.first == type)
+        {
+            shard.resources_.erase(i);
+            return;
+        }
+    }
+}
+
 void ResourceCache::ReleasePackageResources(PackageFile* package, bool force)
 {
     ea::hash_set<StringHash> affectedGroups;
@@ -1061,6 +1347,7 @@ void ResourceCache::ReleasePackageResources(PackageFile* package, bool force)
                 // If other references exist, do not release, unless forced
                 if ((k->second.Refs() == 1 && k->second.WeakRefs() == 0) || force)
                 {
+                    UnindexResource(j->first, k->first);
                     j->second.resources_.erase(k);
                     affectedGroups.insert(j->first);
                 }
@@ -1079,42 +1366,79 @@ void ResourceCache::UpdateResourceGroup(StringHash type)
     if (i == resourceGroups_.end())
         return;
 
-    for (;;)
+    ResourceGroup& group = i->second;
+    unsigned long long totalSize = 0;
+    for (auto j = group.resources_.begin(); j != group.resources_.end(); ++j)
+        totalSize += j->second->GetMemoryUse();
+    group.memoryUse_ = totalSize;
+
+    if (group.memoryBudget_ && group.memoryUse_ > group.memoryBudget_)
+        ReleaseLeastRecentlyUsed(type, group.memoryUse_ - group.memoryBudget_);
+
+    EnforceTotalMemoryBudget();
+}
+
+void ResourceCache::ReleaseLeastRecentlyUsed(StringHash type, unsigned long long memory)
+{
+    struct Candidate
+    {
+        unsigned useTimer_;
+        ResourceGroup* group_;
+        StringHash nameHash_;
+    };
+
+    // Resources referenced outside the cache always return a zero timer and can not be removed. Neither can the
+    // ones just added or requested
+    ea::vector<Candidate> candidates;
+    for (auto i = resourceGroups_.begin(); i != resourceGroups_.end(); ++i)
     {
-        unsigned totalSize = 0;
-        unsigned oldestTimer = 0;
-        auto oldestResource = i->second.resources_.end();
+        if (type != StringHash::ZERO && i->first != type)
+            continue;
 
-        for (auto j = i->second.resources_.begin();
-             j != i->second.resources_.end(); ++j)
+        for (auto j = i->second.resources_.begin(); j != i->second.resources_.end(); ++j)
         {
-            totalSize += j->second->GetMemoryUse();
-            unsigned useTimer = j->second->GetUseTimer();
-            if (useTimer > oldestTimer)
-            {
-                oldestTimer = useTimer;
-                oldestResource = j;
-            }
+            const unsigned useTimer = j->second->GetUseTimer();
+            if (useTimer > 0)
+                candidates.push_back(Candidate{ useTimer, &i->second, j->first });
         }
+    }
 
-        i->second.memoryUse_ = totalSize;
+    ea::sort(candidates.begin(), candidates.end(),
+        [](const Candidate& lhs, const Candidate& rhs) { return lhs.useTimer_ > rhs.useTimer_; });
 
-        // If memory budget defined and is exceeded, remove the oldest resource and loop again
-        // (resources in use always return a zero timer and can not be removed)
-        if (i->second.memoryBudget_ && i->second.memoryUse_ > i->second.memoryBudget_ &&
-            oldestResource != i->second.resources_.end())
-        {
-            URHO3D_LOGDEBUG("Resource group " + oldestResource->second->GetTypeName() + " over memory budget, releasing resource " +
-                     oldestResource->second->GetName());
-            i->second.resources_.erase(oldestResource);
-        }
-        else
+    unsigned long long released = 0;
+    for (const Candidate& candidate : candidates)
+    {
+        if (released >= memory)
             break;
+
+        auto j = candidate.group_->resources_.find(candidate.nameHash_);
+        Resource* resource = j->second;
+        UnindexResource(resource->GetType(), candidate.nameHash_);
+        const unsigned long long memoryUse = resource->GetMemoryUse();
+        URHO3D_LOGDEBUG("Resource group " + resource->GetTypeName() + " over memory budget, releasing resource " +
+            resource->GetName());
+
+        candidate.group_->memoryUse_ -= ea::min(memoryUse, candidate.group_->memoryUse_);
+        released += memoryUse;
+        candidate.group_->resources_.erase(j);
     }
 }
 
+void ResourceCache::EnforceTotalMemoryBudget()
+{
+    if (!totalMemoryBudget_)
+        return;
+
+    const unsigned long long totalUse = GetTotalMemoryUse();
+    if (totalUse > totalMemoryBudget_)
+        ReleaseLeastRecentlyUsed(StringHash::ZERO, totalUse - totalMemoryBudget_);
+}
+
 void ResourceCache::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
 {
+    // Collect file changes until they stop arriving, so that for example a version control checkout is reloaded as
+    // one batch instead of file by file
     for (unsigned i = 0; i < fileWatchers_.size(); ++i)
     {
         FileChange change;
@@ -1127,16 +1451,20 @@ void ResourceCache::HandleBeginFrame(StringHash eventType, VariantMap& eventData
                 continue;
             }
 
-            ReloadResourceWithDependencies(change.fileName_);
+            if (changedFileHashes_.insert(StringHash(change.fileName_)).second)
+                changedFiles_.emplace_back(change.fileName_, fileWatchers_[i]->GetPath() + change.fileName_);
+            fileChangeTimer_.Reset();
+        }
+    }
 
-            // Finally send a general file changed event even if the file was not a tracked resource
-            using namespace FileChanged;
+    if (reloadQueuePosition_ >= reloadQueue_.size() && !changedFiles_.empty() &&
+        fileChangeTimer_.GetMSec(false) >= (unsigned)autoReloadBatchMs_)
+        QueueChangedResources();
 
-            VariantMap& eventData = GetEventDataMap();
-            eventData[P_FILENAME] = fileWatchers_[i]->GetPath() + change.fileName_;
-            eventData[P_RESOURCENAME] = change.fileName_;
-            SendEvent(E_FILECHANGED, eventData);
-        }
+    if (reloadQueuePosition_ < reloadQueue_.size() || !reloadedFiles_.empty())
+    {
+        URHO3D_PROFILE("ReloadChangedResources");
+        ProcessResourceReloads();
     }
 
     // Check for background loaded resources that can be finished
@@ -1146,6 +1474,174 @@ void ResourceCache::HandleBeginFrame(StringHash eventType, VariantMap& eventData
         backgroundLoader_->FinishResources(finishBackgroundResourcesMs_);
     }
 #endif
+
+    // Resources that were referenced at the time they were added may have become unused since, so check the budgets periodically
+    if (memoryBudgetTimer_.GetMSec(false) >= MEMORY_BUDGET_CHECK_INTERVAL_MSEC)
+    {
+        URHO3D_PROFILE("EnforceMemoryBudgets");
+        memoryBudgetTimer_.Reset();
+
+        for (auto i = resourceGroups_.begin(); i != resourceGroups_.end(); ++i)
+        {
+            // With a total budget all groups need up to date memory use
+            if (i->second.memoryBudget_ || totalMemoryBudget_)
+                UpdateResourceGroup(i->first);
+        }
+    }
+}
+
+void ResourceCache::QueueChangedResources()
+{
+    URHO3D_PROFILE("QueueChangedResources");
+
+    // Collect the changed resources and their dependents, like ReloadResourceWithDependencies() does, but only once each
+    ea::vector<SharedPtr<Resource> > resources;
+    ea::unordered_map<StringHash, unsigned> resourceIndices;
+    const auto addResource = [&](const SharedPtr<Resource>& resource)
+    {
+        if (resourceIndices.emplace(resource->GetNameHash(), resources.size()).second)
+            resources.push_back(resource);
+    };
+
+    for (const auto& changedFile : changedFiles_)
+    {
+        const StringHash fileNameHash(changedFile.first);
+        const SharedPtr<Resource>& resource = FindResource(fileNameHash);
+        if (resource)
+            addResource(resource);
+
+        if (!resource || GetExtension(resource->GetName()) == ".xml")
+        {
+            auto j = dependentResources_.find(fileNameHash);
+            if (j != dependentResources_.end())
+            {
+                for (auto k = j->second.begin(); k != j->second.end(); ++k)
+                {
+                    const SharedPtr<Resource>& dependent = FindResource(*k);
+                    if (dependent)
+                        addResource(dependent);
+                }
+            }
+        }
+    }
+
+    // Sort topologically, so that dependencies are reloaded before the resources depending on them
+    ea::vector<ea::vector<unsigned> > dependents(resources.size());
+    ea::vector<unsigned> numDependencies(resources.size());
+    for (unsigned i = 0; i < resources.size(); ++i)
+    {
+        auto j = dependentResources_.find(resources[i]->GetNameHash());
+        if (j == dependentResources_.end())
+            continue;
+
+        for (auto k = j->second.begin(); k != j->second.end(); ++k)
+        {
+            auto dependent = resourceIndices.find(*k);
+            if (dependent != resourceIndices.end() && dependent->second != i)
+            {
+                dependents[i].push_back(dependent->second);
+                ++numDependencies[dependent->second];
+            }
+        }
+    }
+
+    reloadQueue_.clear();
+    reloadQueuePosition_ = 0;
+    ea::vector<bool> queued(resources.size());
+    for (unsigned start = 0; start < resources.size(); ++start)
+    {
+        if (queued[start] || numDependencies[start])
+            continue;
+
+        // Resources whose dependencies have all been queued are queued in turn
+        ea::vector<unsigned> ready{ start };
+        queued[start] = true;
+        while (!ready.empty())
+        {
+            const unsigned index = ready.back();
+            ready.pop_back();
+            reloadQueue_.push_back(PendingReload{ resources[index], nullptr });
+
+            for (unsigned dependent : dependents[index])
+            {
+                if (--numDependencies[dependent] == 0 && !queued[dependent])
+                {
+                    queued[dependent] = true;
+                    ready.push_back(dependent);
+                }
+            }
+        }
+    }
+
+    // Resources in dependency cycles are reloaded last, in any order
+    for (unsigned i = 0; i < resources.size(); ++i)
+    {
+        if (!queued[i])
+            reloadQueue_.push_back(PendingReload{ resources[i], nullptr });
+    }
+
+    URHO3D_LOGDEBUG("Reloading {} resources affected by {} changed files", reloadQueue_.size(), changedFiles_.size());
+    reloadedFiles_ = ea::move(changedFiles_);
+    changedFiles_.clear();
+    changedFileHashes_.clear();
+}
+
+void ResourceCache::ProcessResourceReloads()
+{
+    static const unsigned MAX_RELOAD_READS_IN_FLIGHT = 32;
+
+    auto* fileSystem = GetSubsystem<FileSystem>();
+    HiresTimer timer;
+    const long long maxUSec = autoReloadResourcesMs_ * 1000LL;
+
+    while (reloadQueuePosition_ < reloadQueue_.size())
+    {
+        // Keep the reads of the next resources going in the background while the current ones are parsed
+        const unsigned readEnd = Min(reloadQueuePosition_ + MAX_RELOAD_READS_IN_FLIGHT, reloadQueue_.size());
+        for (unsigned i = reloadQueuePosition_; i < readEnd; ++i)
+        {
+            PendingReload& reload = reloadQueue_[i];
+            if (!reload.read_)
+                reload.read_ = fileSystem->ReadFileAsync(GetFile(reload.resource_->GetName(), false));
+        }
+
+        // Reload at least one resource per frame
+        if (reloadQueuePosition_ > 0 && timer.GetUSec(false) >= maxUSec)
+            break;
+
+        PendingReload& reload = reloadQueue_[reloadQueuePosition_++];
+        URHO3D_LOGDEBUG("Reloading changed resource " + reload.resource_->GetName());
+        if (reload.read_->Wait())
+        {
+            MemoryBuffer buffer(reload.read_->GetData());
+            buffer.SetName(reload.resource_->GetName());
+            ReloadResource(reload.resource_, buffer);
+        }
+        else
+            ReloadResource(reload.resource_);
+        reload = PendingReload{};
+
+        if (timer.GetUSec(false) >= maxUSec)
+            break;
+    }
+
+    if (reloadQueuePosition_ < reloadQueue_.size())
+        return;
+
+    reloadQueue_.clear();
+    reloadQueuePosition_ = 0;
+
+    // Finally send general file changed events, also for the files that were not tracked resources
+    for (const auto& reloadedFile : reloadedFiles_)
+    {
+        using namespace FileChanged;
+
+        VariantMap& eventData = GetEventDataMap();
+        eventData[P_FILENAME] = reloadedFile.second;
+        eventData[P_RESOURCENAME] = reloadedFile.first;
+        SendEvent(E_FILECHANGED, eventData);
+    }
+    reloadedFiles_.clear();
 }
 
 File* ResourceCache::SearchResourceDirs(const ea::string& name)
@@ -1375,9 +1871,11 @@ bool ResourceCache::RenameResource(const ea::string& source, const ea::string& d
                 ignoreResourceAutoReload_.emplace_back(resource->GetName());
             }
 
+            UnindexResource(groupPair.first, resource->GetNameHash());
             groupPair.second.resources_.erase(resource->GetNameHash());
             resource->SetName(newName);
             resource->SetAbsoluteFileName(newNativeFileName);
+            IndexResource(resource);
             groupPair.second.resources_[resource->GetNameHash()] = resource;
             movedAny = true;
 
@@ -1421,6 +1919,11 @@ void ResourceCache::RouteResourceName(ea::string& name, ResourceRequest requestT
 
 void ResourceCache::Clear()
 {
+    for (ResourceIndexShard& shard : resourceIndex_)
+    {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex_);
+        shard.resources_.clear();
+    }
     resourceGroups_.clear();
     dependentResources_.clear();
 }
@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include <EASTL/array.h>
 #include <EASTL/unique_ptr.h>
 #include <EASTL/hash_set.h>
 
@@ -31,16 +32,24 @@
 #include "../Core/Mutex.h"
 #include "../IO/File.h"
 #include "../Resource/Resource.h"
+#include "../Resource/ResourceLoadGraph.h"
+
+#include <shared_mutex>
 
 namespace Urho3D
 {
 
 class BackgroundLoader;
 class FileWatcher;
+class AsyncFileRead;
 class PackageFile;
 
 /// Sets to priority so that a package or file is pushed to the end of the vector.
 static const unsigned PRIORITY_LAST = 0xffffffff;
+/// Number of shards in the thread-safe index of loaded resources.
+static const unsigned NUM_RESOURCE_INDEX_SHARDS = 16;
+/// Interval in milliseconds between checks of the memory budgets for resources that have become unreferenced.
+static const unsigned MEMORY_BUDGET_CHECK_INTERVAL_MSEC = 1000;
 
 /// Container of resources with specific type.
 struct ResourceGroup
@@ -60,6 +69,15 @@ struct ResourceGroup
     ea::unordered_map<StringHash, SharedPtr<Resource> > resources_;
 };
 
+/// Shard of the thread-safe index of loaded resources. Written only from the main thread.
+struct ResourceIndexShard
+{
+    /// Mutex for the readers outside the main thread.
+    mutable std::shared_mutex mutex_;
+    /// Resources and their types by name hash.
+    ea::unordered_multimap<StringHash, ea::pair<StringHash, Resource*> > resources_;
+};
+
 /// Resource request types.
 enum ResourceRequest
 {
@@ -125,12 +143,21 @@ public:
     bool ReloadResource(Resource* resource);
     /// Reload a resource based on filename. Causes also reload of dependent resources if necessary.
     void ReloadResourceWithDependencies(const ea::string& fileName);
-    /// Set memory budget for a specific resource type, default 0 is unlimited.
+    /// Set memory budget for a specific resource type, default 0 is unlimited. When over budget, the least recently used resources that are not referenced outside the cache are released.
     /// @property
     void SetMemoryBudget(StringHash type, unsigned long long budget);
+    /// Set memory budget for all resources together, default 0 is unlimited. Enforced in addition to the per type budgets.
+    /// @property
+    void SetTotalMemoryBudget(unsigned long long budget);
     /// Enable or disable automatic reloading of resources as files are modified. Default false.
     /// @property
     void SetAutoReloadResources(bool enable);
+    /// Set for how many milliseconds file changes must stop arriving before the changed resources are reloaded as one batch.
+    /// @property
+    void SetAutoReloadBatchMs(int ms) { autoReloadBatchMs_ = Max(ms, 0); }
+    /// Set how many milliseconds maximum per frame to spend on reloading changed resources. At least one resource is reloaded per frame.
+    /// @property
+    void SetAutoReloadResourcesMs(int ms) { autoReloadResourcesMs_ = Max(ms, 1); }
     /// Enable or disable returning resources that failed to load. Default false. This may be useful in editing to not lose resource ref attributes.
     /// @property
     void SetReturnFailedResources(bool enable) { returnFailedResources_ = enable; }
@@ -139,9 +166,33 @@ public:
     /// @property
     void SetSearchPackagesFirst(bool value) { searchPackagesFirst_ = value; }
 
+    /// Set whether package files added afterwards are mapped to memory. Files are then opened without file handles and uncompressed resources are parsed in place where the loader supports it.
+    /// @property
+    void SetMemoryMapPackages(bool enable) { memoryMapPackages_ = enable; }
+
     /// Set how many milliseconds maximum per frame to spend on finishing background loaded resources.
     /// @property
     void SetFinishBackgroundResourcesMs(int ms) { finishBackgroundResourcesMs_ = Max(ms, 1); }
+    /// Set number of threads used for background loading. By default half of the logical CPUs, at most 4.
+    /// @property
+    void SetNumBackgroundLoadThreads(unsigned numThreads);
+    /// Set maximum number of resources of a type background loaded concurrently. Zero (default) is unlimited.
+    void SetMaxConcurrentBackgroundLoads(StringHash type, unsigned maxLoads);
+    /// Set whether to record resource loads and their dependencies to the load graph.
+    /// @property
+    void SetRecordLoadGraph(bool enable) { recordLoadGraph_ = enable; }
+    /// Set whether to prefetch the dependencies listed in the dependency manifests in the background when a resource is requested. Default true.
+    /// @property
+    void SetPrefetchDependencies(bool enable) { prefetchDependencies_ = enable; }
+
+    /// Load a dependency manifest, as written by SaveDependencyManifest(), and merge it with the previously loaded ones. Return true if successful.
+    bool LoadDependencyManifest(const ea::string& name);
+    /// Write the dependencies recorded to the load graph as a dependency manifest file. Return true if successful.
+    bool SaveDependencyManifest(const ea::string& fileName) const;
+    /// Forget the loaded dependency manifests.
+    void ClearDependencyManifest();
+    /// Queue background loading of all resources a resource depends on directly or indirectly according to the dependency manifests. Can be called from outside the main thread.
+    void PrefetchDependencies(const ea::string& name);
 
     /// Add a resource router object. By default there is none, so the routing process is skipped.
     void AddResourceRouter(ResourceRouter* router, bool addAsFirst = false);
@@ -150,6 +201,10 @@ public:
 
     /// Open and return a file from the resource load paths or from inside a package file. If not found, use a fallback search with absolute path. Return null if fails. Can be called from outside the main thread.
     SharedPtr<File> GetFile(const ea::string& name, bool sendEventOnFailure = true);
+    /// Open a file like GetFile() and read its contents on the asynchronous I/O threads. The returned request fails if the file is not found. Can be called from outside the main thread.
+    SharedPtr<AsyncFileRead> ReadFileAsync(const ea::string& name, bool sendEventOnFailure = true);
+    /// Hint the operating system to read the files of resources into memory ahead of use, for example the resources of the first scene at startup. Neither blocks nor loads the resources. Can be called from outside the main thread.
+    void PrefetchResources(const ea::vector<ea::string>& names);
     /// Return a resource by type and name. Load if not loaded yet. Return null if not found or if fails, unless SetReturnFailedResources(true) has been called. Can be called only from the main thread.
     Resource* GetResource(StringHash type, const ea::string& name, bool sendEventOnFailure = true);
     /// Load a resource without storing it in the resource cache. Return null if not found or if fails. Can be called from outside the main thread if the resource itself is safe to load completely (it does not possess for example GPU data).
@@ -159,9 +214,11 @@ public:
     /// Return number of pending background-loaded resources.
     /// @property
     unsigned GetNumBackgroundLoadResources() const;
+    /// Return total number of resources loaded synchronously on the main thread by GetResource().
+    unsigned GetNumSyncLoads() const { return numSyncLoads_; }
     /// Return all loaded resources of a specific type.
     void GetResources(ea::vector<Resource*>& result, StringHash type) const;
-    /// Return an already loaded resource of specific type & name, or null if not found. Will not load if does not exist. Specifying zero type will search all types.
+    /// Return an already loaded resource of specific type & name, or null if not found. Will not load if does not exist. Specifying zero type will search all types. Can be called from outside the main thread; in that case the caller must make sure that the resource is not released by the main thread while in use, for example by keeping a reference to it there.
     Resource* GetExistingResource(StringHash type, const ea::string& name);
 
     /// Return all loaded resources.
@@ -198,12 +255,24 @@ public:
     /// Return total memory use for all resources.
     /// @property
     unsigned long long GetTotalMemoryUse() const;
+    /// Return memory budget for all resources together.
+    /// @property
+    unsigned long long GetTotalMemoryBudget() const { return totalMemoryBudget_; }
     /// Return full absolute file name of resource if possible, or empty if not found.
     ea::string GetResourceFileName(const ea::string& name) const;
 
     /// Return whether automatic resource reloading is enabled.
     /// @property
     bool GetAutoReloadResources() const { return autoReloadResources_; }
+    /// Return for how many milliseconds file changes must stop arriving before the changed resources are reloaded.
+    /// @property
+    int GetAutoReloadBatchMs() const { return autoReloadBatchMs_; }
+    /// Return how many milliseconds maximum per frame to spend on reloading changed resources.
+    /// @property
+    int GetAutoReloadResourcesMs() const { return autoReloadResourcesMs_; }
+    /// Return number of changed resources waiting to be reloaded.
+    /// @property
+    unsigned GetNumPendingReloads() const { return changedFiles_.size() + reloadQueue_.size() - reloadQueuePosition_; }
 
     /// Return whether resources that failed to load are returned.
     /// @property
@@ -213,9 +282,29 @@ public:
     /// @property
     bool GetSearchPackagesFirst() const { return searchPackagesFirst_; }
 
+    /// Return whether package files are mapped to memory when added.
+    /// @property
+    bool GetMemoryMapPackages() const { return memoryMapPackages_; }
+
     /// Return how many milliseconds maximum to spend on finishing background loaded resources.
     /// @property
     int GetFinishBackgroundResourcesMs() const { return finishBackgroundResourcesMs_; }
+    /// Return number of threads used for background loading.
+    /// @property
+    unsigned GetNumBackgroundLoadThreads() const;
+    /// Return maximum number of resources of a type background loaded concurrently.
+    unsigned GetMaxConcurrentBackgroundLoads(StringHash type) const;
+    /// Return whether resource loads are recorded to the load graph.
+    /// @property
+    bool GetRecordLoadGraph() const { return recordLoadGraph_; }
+    /// Return whether dependencies listed in the dependency manifests are prefetched.
+    /// @property
+    bool GetPrefetchDependencies() const { return prefetchDependencies_; }
+    /// Return the load graph.
+    /// @nobind
+    ResourceLoadGraph& GetLoadGraph() { return loadGraph_; }
+    /// Return a summary of the recorded loads and of the critical path starting from a resource, or from the most expensive one if empty.
+    ea::string GetLoadGraphReport(const ea::string& name = EMPTY_STRING) const { return loadGraph_.GetReport(name); }
 
     /// Return a resource router by index.
     ResourceRouter* GetResourceRouter(unsigned index) const;
@@ -255,14 +344,45 @@ public:
     void Clear();
 
 private:
+    /// Changed resource waiting to be reloaded.
+    struct PendingReload
+    {
+        /// Resource.
+        SharedPtr<Resource> resource_;
+        /// Read of the resource file, if started.
+        SharedPtr<AsyncFileRead> read_;
+    };
+
+    /// Reload a resource from already opened source data.
+    bool ReloadResource(Resource* resource, Deserializer& source);
+    /// Collect the resources affected by the changed files, sort them so that dependencies are reloaded before their dependents and queue them for reloading.
+    void QueueChangedResources();
+    /// Reload queued resources within the time budget and start the file reads of the next ones.
+    void ProcessResourceReloads();
     /// Find a resource.
     const SharedPtr<Resource>& FindResource(StringHash type, StringHash nameHash);
     /// Find a resource by name only. Searches all type groups.
     const SharedPtr<Resource>& FindResource(StringHash nameHash);
+    /// Find a resource from the thread-safe index. Zero type searches all types. Can be called from any thread.
+    Resource* FindIndexedResource(StringHash type, StringHash nameHash) const;
+    /// Add or replace a resource in the thread-safe index. Must be done before the resource is stored to its group.
+    void IndexResource(Resource* resource);
+    /// Remove a resource from the thread-safe index. Must be done before the resource is erased from its group.
+    void UnindexResource(StringHash type, StringHash nameHash);
+    /// Return the index shard of a resource name.
+    ResourceIndexShard& GetIndexShard(StringHash nameHash) const { return resourceIndex_[nameHash.Value() % NUM_RESOURCE_INDEX_SHARDS]; }
+    /// Recalculate resource directories relative to the program directory after the directory list changes.
+    void UpdateRelativeResourceDirs();
+    /// Return whether the name needs no sanitation, which is the common case for names stored in resources and scenes.
+    bool IsSanitatedResourceName(const ea::string& name) const;
     /// Release resources loaded from a package file.
     void ReleasePackageResources(PackageFile* package, bool force = false);
     /// Update a resource group. Recalculate memory use and release resources if over memory budget.
     void UpdateResourceGroup(StringHash type);
+    /// Release the least recently used unreferenced resources of a type, or of all types if zero, until the requested amount of memory is freed.
+    void ReleaseLeastRecentlyUsed(StringHash type, unsigned long long memory);
+    /// Release resources if over the total memory budget.
+    void EnforceTotalMemoryBudget();
     /// Handle begin frame event. Automatic resource reloads and the finalization of background loaded resources are processed here.
     void HandleBeginFrame(StringHash eventType, VariantMap& eventData);
     /// Search FileSystem for file.
@@ -274,16 +394,24 @@ private:
     mutable Mutex resourceMutex_;
     /// Resources by type.
     ea::unordered_map<StringHash, ResourceGroup> resourceGroups_;
+    /// Thread-safe index of the resources in the resource groups, sharded by name hash.
+    mutable ea::array<ResourceIndexShard, NUM_RESOURCE_INDEX_SHARDS> resourceIndex_;
     /// Resource load directories.
     ea::vector<ea::string> resourceDirs_;
+    /// Resource load directories relative to the program directory, in the same order as resourceDirs_.
+    ea::vector<ea::string> relativeResourceDirs_;
     /// File watchers for resource directories, if automatic reloading enabled.
     ea::vector<SharedPtr<FileWatcher> > fileWatchers_;
     /// Package files.
     ea::vector<SharedPtr<PackageFile> > packages_;
     /// Dependent resources. Only used with automatic reload to eg. trigger reload of a cube texture when any of its faces change.
     ea::unordered_map<StringHash, ea::hash_set<StringHash> > dependentResources_;
+    /// Dependencies of resources by name hash, read from the dependency manifests.
+    ea::unordered_map<StringHash, ea::vector<ea::pair<StringHash, ea::string> > > dependencyManifest_;
     /// Resource background loader.
     SharedPtr<BackgroundLoader> backgroundLoader_;
+    /// Recorded resource loads.
+    ResourceLoadGraph loadGraph_;
     /// Resource routers.
     ea::vector<SharedPtr<ResourceRouter> > resourceRouters_;
     /// Automatic resource reloading flag.
@@ -296,8 +424,40 @@ private:
     mutable bool isRouting_;
     /// How many milliseconds maximum per frame to spend on finishing background loaded resources.
     int finishBackgroundResourcesMs_;
+    /// Whether package files are mapped to memory when added. Enabled by default on Android, where packages are otherwise read from the APK through buffered copies.
+#ifdef __ANDROID__
+    bool memoryMapPackages_{true};
+#else
+    bool memoryMapPackages_{};
+#endif
+    /// Memory budget for all resources together.
+    unsigned long long totalMemoryBudget_{};
+    /// Timer for the periodic memory budget checks.
+    Timer memoryBudgetTimer_;
+    /// Whether resource loads are recorded to the load graph.
+    bool recordLoadGraph_{};
+    /// Whether dependencies from the dependency manifests are prefetched.
+    bool prefetchDependencies_{true};
     /// List of resources that will not be auto-reloaded if reloading event triggers.
     ea::vector<ea::string> ignoreResourceAutoReload_;
+    /// Changed files collected for the next reload batch: resource names and full file names.
+    ea::vector<ea::pair<ea::string, ea::string> > changedFiles_;
+    /// Name hashes of the changed files in the next reload batch.
+    ea::hash_set<StringHash> changedFileHashes_;
+    /// Timer since the last file change.
+    Timer fileChangeTimer_;
+    /// Resources of the current batch being reloaded.
+    ea::vector<PendingReload> reloadQueue_;
+    /// Index of the next resource to reload in the current batch.
+    unsigned reloadQueuePosition_{};
+    /// Total number of resources loaded synchronously by GetResource().
+    unsigned numSyncLoads_{};
+    /// Changed files of the current batch, notified when the batch has been reloaded.
+    ea::vector<ea::pair<ea::string, ea::string> > reloadedFiles_;
+    /// How long file changes must stop arriving before reloading.
+    int autoReloadBatchMs_{200};
+    /// How many milliseconds maximum per frame to spend on reloading changed resources.
+    int autoReloadResourcesMs_{10};
 };
 
 template <class T> T* ResourceCache::GetExistingResource(const ea::string& name)
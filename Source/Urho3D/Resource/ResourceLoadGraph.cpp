@@ -0,0 +1,286 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/StringUtils.h"
+#include "../Resource/Resource.h"
+#include "../Resource/ResourceLoadGraph.h"
+#include "../Resource/XMLElement.h"
+
+#include <EASTL/algorithm.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Load phase in progress on a thread.
+struct ActiveLoad
+{
+    /// Graph recording the load.
+    const ResourceLoadGraph* graph_;
+    /// Generation of the graph records when the load started.
+    unsigned generation_;
+    /// Node index.
+    unsigned index_;
+    /// Start time.
+    long long beginTime_;
+    /// Time spent in nested load phases.
+    long long nestedTime_;
+};
+
+/// Return the load phases in progress on the calling thread, innermost last.
+ea::vector<ActiveLoad>& GetActiveLoads()
+{
+    static thread_local ea::vector<ActiveLoad> activeLoads;
+    return activeLoads;
+}
+
+/// Return innermost load phase of a graph on the calling thread, or null if none.
+ActiveLoad* GetInnermostLoad(const ResourceLoadGraph* graph, unsigned generation)
+{
+    ea::vector<ActiveLoad>& activeLoads = GetActiveLoads();
+    for (auto i = activeLoads.rbegin(); i != activeLoads.rend(); ++i)
+    {
+        if (i->graph_ == graph && i->generation_ == generation)
+            return &*i;
+    }
+    return nullptr;
+}
+
+}
+
+void ResourceLoadGraph::BeginLoad(Resource* resource)
+{
+    MutexLock lock(mutex_);
+    const unsigned index = GetOrCreateNode(resource->GetType(), resource->GetName());
+    nodes_[index].typeName_ = resource->GetTypeName();
+    GetActiveLoads().push_back(ActiveLoad{ this, generation_, index, timer_.GetUSec(false), 0 });
+}
+
+void ResourceLoadGraph::EndLoad(Resource* resource)
+{
+    ea::vector<ActiveLoad>& activeLoads = GetActiveLoads();
+    MutexLock lock(mutex_);
+
+    // Drop the phases that were started before the records were cleared
+    activeLoads.erase(ea::remove_if(activeLoads.begin(), activeLoads.end(), [this](const ActiveLoad& activeLoad)
+        { return activeLoad.graph_ == this && activeLoad.generation_ != generation_; }), activeLoads.end());
+
+    const auto nodeIter = nodeIndices_.find(resource->GetNameHash());
+    if (nodeIter == nodeIndices_.end())
+        return;
+
+    // Phases are normally strictly nested, but search from the innermost one to be safe
+    auto i = ea::find_if(activeLoads.rbegin(), activeLoads.rend(), [&](const ActiveLoad& activeLoad)
+        { return activeLoad.graph_ == this && activeLoad.index_ == nodeIter->second; }).base();
+    if (i == activeLoads.begin())
+        return;
+    --i;
+
+    const long long elapsed = ea::max(timer_.GetUSec(false) - i->beginTime_, 0LL);
+    nodes_[i->index_].loadTime_ += ea::max(elapsed - i->nestedTime_, 0LL);
+    activeLoads.erase(i);
+
+    if (ActiveLoad* parent = GetInnermostLoad(this, generation_))
+        parent->nestedTime_ += elapsed;
+}
+
+void ResourceLoadGraph::AddDependency(Resource* dependent, StringHash type, const ea::string& name)
+{
+    MutexLock lock(mutex_);
+
+    unsigned dependentIndex;
+    if (dependent)
+        dependentIndex = GetOrCreateNode(dependent->GetType(), dependent->GetName());
+    else if (ActiveLoad* activeLoad = GetInnermostLoad(this, generation_))
+        dependentIndex = activeLoad->index_;
+    else
+        return;
+
+    const unsigned index = GetOrCreateNode(type, name);
+    if (index == dependentIndex)
+        return;
+
+    ea::vector<unsigned>& dependencies = nodes_[dependentIndex].dependencies_;
+    if (!dependencies.contains(index))
+        dependencies.push_back(index);
+}
+
+void ResourceLoadGraph::Clear()
+{
+    MutexLock lock(mutex_);
+    nodes_.clear();
+    nodeIndices_.clear();
+    // Phases in progress are ignored when they end
+    ++generation_;
+}
+
+void ResourceLoadGraph::SaveManifest(XMLElement& dest) const
+{
+    MutexLock lock(mutex_);
+
+    for (const ResourceLoadNode& node : nodes_)
+    {
+        if (node.typeName_.empty() || node.dependencies_.empty())
+            continue;
+
+        XMLElement resourceElem = dest.CreateChild("resource");
+        resourceElem.SetAttribute("type", node.typeName_);
+        resourceElem.SetAttribute("name", node.name_);
+
+        for (unsigned index : node.dependencies_)
+        {
+            const ResourceLoadNode& dependency = nodes_[index];
+            // Dependencies that were never loaded have unknown type and can not be prefetched
+            if (dependency.typeName_.empty())
+                continue;
+
+            XMLElement dependencyElem = resourceElem.CreateChild("dependency");
+            dependencyElem.SetAttribute("type", dependency.typeName_);
+            dependencyElem.SetAttribute("name", dependency.name_);
+        }
+    }
+}
+
+ea::vector<unsigned> ResourceLoadGraph::GetCriticalPath(const ea::string& name) const
+{
+    MutexLock lock(mutex_);
+    return CalculateCriticalPath(name);
+}
+
+ea::string ResourceLoadGraph::GetReport(const ea::string& name) const
+{
+    MutexLock lock(mutex_);
+
+    long long totalTime = 0;
+    for (const ResourceLoadNode& node : nodes_)
+        totalTime += node.loadTime_;
+
+    const ea::vector<unsigned> criticalPath = CalculateCriticalPath(name);
+    long long criticalTime = 0;
+    for (unsigned index : criticalPath)
+        criticalTime += nodes_[index].loadTime_;
+
+    ea::string report = Format("{} resources, total load time {:.2f} ms, critical path {:.2f} ms\n",
+        nodes_.size(), totalTime / 1000.0, criticalTime / 1000.0);
+    for (unsigned index : criticalPath)
+    {
+        const ResourceLoadNode& node = nodes_[index];
+        report += Format("{:10.2f} ms  {} {}\n", node.loadTime_ / 1000.0,
+            node.typeName_.empty() ? ea::string("?") : node.typeName_, node.name_);
+    }
+    return report;
+}
+
+ea::vector<ResourceLoadNode> ResourceLoadGraph::GetNodes() const
+{
+    MutexLock lock(mutex_);
+    return nodes_;
+}
+
+unsigned ResourceLoadGraph::GetNumNodes() const
+{
+    MutexLock lock(mutex_);
+    return nodes_.size();
+}
+
+unsigned ResourceLoadGraph::GetOrCreateNode(StringHash type, const ea::string& name)
+{
+    const StringHash nameHash(name);
+    auto i = nodeIndices_.find(nameHash);
+    if (i != nodeIndices_.end())
+        return i->second;
+
+    const unsigned index = nodes_.size();
+    ResourceLoadNode& node = nodes_.emplace_back();
+    node.type_ = type;
+    node.name_ = name;
+    nodeIndices_[nameHash] = index;
+    return index;
+}
+
+ea::vector<unsigned> ResourceLoadGraph::CalculateCriticalPath(const ea::string& name) const
+{
+    static const long long NOT_VISITED = -1;
+    static const long long IN_PROGRESS = -2;
+
+    // Longest total load time of a dependency chain starting from each node, and the next node on that chain
+    ea::vector<long long> pathTimes(nodes_.size(), NOT_VISITED);
+    ea::vector<unsigned> next(nodes_.size(), M_MAX_UNSIGNED);
+
+    const auto calculatePathTime = [&](unsigned index, const auto& self) -> long long
+    {
+        if (pathTimes[index] == IN_PROGRESS)
+            return 0; // Break dependency cycles
+        if (pathTimes[index] != NOT_VISITED)
+            return pathTimes[index];
+
+        pathTimes[index] = IN_PROGRESS;
+        long long maxDependencyTime = 0;
+        for (unsigned dependency : nodes_[index].dependencies_)
+        {
+            const long long dependencyTime = self(dependency, self);
+            if (dependencyTime > maxDependencyTime || next[index] == M_MAX_UNSIGNED)
+            {
+                maxDependencyTime = ea::max(maxDependencyTime, dependencyTime);
+                next[index] = dependency;
+            }
+        }
+        pathTimes[index] = nodes_[index].loadTime_ + maxDependencyTime;
+        return pathTimes[index];
+    };
+
+    unsigned root = M_MAX_UNSIGNED;
+    if (!name.empty())
+    {
+        auto i = nodeIndices_.find(StringHash(name));
+        if (i == nodeIndices_.end())
+            return {};
+        root = i->second;
+        calculatePathTime(root, calculatePathTime);
+    }
+    else
+    {
+        long long maxTime = -1;
+        for (unsigned i = 0; i < nodes_.size(); ++i)
+        {
+            const long long time = calculatePathTime(i, calculatePathTime);
+            if (time > maxTime)
+            {
+                maxTime = time;
+                root = i;
+            }
+        }
+    }
+
+    ea::vector<unsigned> path;
+    for (unsigned index = root; index != M_MAX_UNSIGNED && !path.contains(index); index = next[index])
+        path.push_back(index);
+    return path;
+}
+
+}
@@ -0,0 +1,97 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include <EASTL/string.h>
+#include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
+
+#include "../Core/Mutex.h"
+#include "../Core/Timer.h"
+#include "../Math/StringHash.h"
+
+namespace Urho3D
+{
+
+class Resource;
+class XMLElement;
+
+/// Recorded resource in a load graph.
+struct URHO3D_API ResourceLoadNode
+{
+    /// Resource type.
+    StringHash type_;
+    /// Resource type name. Empty if the resource was requested but never loaded.
+    ea::string typeName_;
+    /// Resource name.
+    ea::string name_;
+    /// Indices of the resources this resource depends on.
+    ea::vector<unsigned> dependencies_;
+    /// Time spent in the load phases of the resource itself, excluding nested loads of dependencies, in microseconds.
+    long long loadTime_{};
+};
+
+/// Recorder of the resources loaded by the resource cache and of the dependencies between them. Used to generate dependency manifests and to find the critical path of a load. Thread-safe.
+/// @nobind
+class URHO3D_API ResourceLoadGraph
+{
+public:
+    /// Record the start of a load phase of a resource on the calling thread. Resources requested on the same thread until the matching EndLoad() become its dependencies.
+    void BeginLoad(Resource* resource);
+    /// Record the end of the load phase of a resource on the calling thread.
+    void EndLoad(Resource* resource);
+    /// Record a dependency on a resource. A null dependent means the resource being loaded on the calling thread, if any.
+    void AddDependency(Resource* dependent, StringHash type, const ea::string& name);
+    /// Clear all records.
+    void Clear();
+
+    /// Write the recorded dependencies as a manifest that can be read by ResourceCache::LoadDependencyManifest().
+    void SaveManifest(XMLElement& dest) const;
+    /// Return the indices of the resources on the critical path, i.e. the chain of dependencies with the largest total load time. Start from the named resource, or from the most expensive chain if empty.
+    ea::vector<unsigned> GetCriticalPath(const ea::string& name = EMPTY_STRING) const;
+    /// Return a human readable summary of the recorded loads and the critical path.
+    ea::string GetReport(const ea::string& name = EMPTY_STRING) const;
+    /// Return copy of the recorded resources.
+    ea::vector<ResourceLoadNode> GetNodes() const;
+    /// Return number of recorded resources.
+    unsigned GetNumNodes() const;
+
+private:
+    /// Return index of the node of a resource, creating it if necessary. Requires the mutex to be held.
+    unsigned GetOrCreateNode(StringHash type, const ea::string& name);
+    /// Calculate the critical path from all nodes. Requires the mutex to be held.
+    ea::vector<unsigned> CalculateCriticalPath(const ea::string& name) const;
+
+    /// Mutex for thread-safe access to the records.
+    mutable Mutex mutex_;
+    /// Recorded resources.
+    ea::vector<ResourceLoadNode> nodes_;
+    /// Node indices by resource name hash.
+    ea::unordered_map<StringHash, unsigned> nodeIndices_;
+    /// Timer for the load phases.
+    HiresTimer timer_;
+    /// Incremented whenever the records are cleared.
+    unsigned generation_{};
+};
+
+}
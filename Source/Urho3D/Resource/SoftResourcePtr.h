@@ -0,0 +1,96 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Resource/ResourceCache.h"
+
+namespace Urho3D
+{
+
+/// Reference to a resource that does not keep it loaded. The resource cache may release the resource when over its memory budget, in which case it is loaded again on the next access.
+/// @nobind
+template <class T> class SoftResourcePtr
+{
+public:
+    /// Construct null.
+    SoftResourcePtr() = default;
+
+    /// Construct from resource cache and resource name. The resource is not loaded until accessed.
+    SoftResourcePtr(ResourceCache* cache, const ea::string& name)
+        : cache_(cache)
+        , name_(name)
+    {
+    }
+
+    /// Construct from a resource stored in the resource cache.
+    SoftResourcePtr(ResourceCache* cache, T* resource)
+        : cache_(cache)
+        , name_(resource ? resource->GetName() : EMPTY_STRING)
+        , resource_(resource)
+    {
+    }
+
+    /// Return the resource, loading it again if it has been released. Return null if not found or if fails. Can be called only from the main thread.
+    T* Get() const
+    {
+        if (!resource_ && cache_ && !name_.empty())
+            resource_ = cache_->template GetResource<T>(name_);
+        return resource_;
+    }
+
+    /// Return the resource if it is loaded, without loading it.
+    T* GetIfLoaded() const { return resource_; }
+
+    /// Return whether the resource is currently loaded.
+    bool IsLoaded() const { return !resource_.Expired(); }
+
+    /// Return resource name.
+    const ea::string& GetName() const { return name_; }
+
+    /// Point to nothing.
+    void Reset()
+    {
+        cache_.Reset();
+        name_.clear();
+        resource_.Reset();
+    }
+
+    /// Dereference the resource, loading it if necessary.
+    T* operator ->() const { return Get(); }
+
+    /// Test for equality with another soft resource pointer.
+    bool operator ==(const SoftResourcePtr<T>& rhs) const { return name_ == rhs.name_; }
+
+    /// Test for inequality with another soft resource pointer.
+    bool operator !=(const SoftResourcePtr<T>& rhs) const { return name_ != rhs.name_; }
+
+private:
+    /// Resource cache.
+    WeakPtr<ResourceCache> cache_;
+    /// Resource name.
+    ea::string name_;
+    /// Resource, if loaded.
+    mutable WeakPtr<T> resource_;
+};
+
+}
@@ -84,11 +84,29 @@ bool XMLFile::BeginLoad(Deserializer& source)
         return false;
     }
 
-    ea::shared_array<char> buffer(new char[dataSize]);
-    if (source.Read(buffer.get(), dataSize) != dataSize)
-        return false;
+    // Avoid an extra copy of the data: parse data already in memory directly, otherwise read it to a buffer that
+    // the document takes over and parses in place
+    bool success;
+    if (const unsigned char* memoryData = source.GetMemoryData())
+    {
+        const unsigned position = source.GetPosition();
+        success = document_->load_buffer(memoryData + position, dataSize - position);
+        source.Seek(dataSize);
+    }
+    else
+    {
+        void* buffer = pugi::get_memory_allocation_function()(ea::max(dataSize, 1u));
+        if (!buffer)
+            return false;
+        if (source.Read(buffer, dataSize) != dataSize)
+        {
+            pugi::get_memory_deallocation_function()(buffer);
+            return false;
+        }
+        success = document_->load_buffer_inplace_own(buffer, dataSize);
+    }
 
-    if (!document_->load_buffer(buffer.get(), dataSize))
+    if (!success)
     {
         URHO3D_LOGERROR("Could not parse XML data from " + source.GetName());
         document_->reset();
@@ -40,6 +40,11 @@ namespace Detail
 namespace
 {
 
+/// Number of floats per vertex in the batch buffer: position, color and texture coordinates.
+static const unsigned RML_BATCH_VERTEX_SIZE = 6;
+/// Maximum number of vertices merged into one batch.
+static const unsigned RML_MAX_BATCH_VERTICES = 65536;
+
 /// Internal RmlUI texture holder.
 struct CachedRmlTexture
 {
@@ -59,6 +64,8 @@ RmlRenderer::RmlRenderer(Context* context)
     : Object(context)
     , vertexBuffer_(context->CreateObject<VertexBuffer>())
     , indexBuffer_(context->CreateObject<IndexBuffer>())
+    , batchVertexBuffer_(context->CreateObject<VertexBuffer>())
+    , batchIndexBuffer_(context->CreateObject<IndexBuffer>())
 {
     InitializeGraphics();
     SubscribeToEvent(E_SCREENMODE, [this](StringHash, VariantMap&) { InitializeGraphics(); });
@@ -129,9 +136,143 @@ void RmlRenderer::RenderCompiledGeometry(Rml::CompiledGeometryHandle geometryHan
 {
     CompiledGeometryForRml* geometry = reinterpret_cast<CompiledGeometryForRml*>(geometryHandle);
 
+    // Geometry under custom transform is clipped by stencil, which can not be merged
+    if (transformEnabled_)
+    {
+        FlushBatch();
+        DrawCompiledGeometry(geometry, translation);
+        return;
+    }
+
+    const unsigned numVertices = geometry->vertexBuffer_->GetVertexCount();
+    const unsigned numIndices = geometry->indexBuffer_->GetIndexCount();
+    const unsigned vertexStart = ReserveBatch(geometry->texture_, numVertices, numIndices);
+
+    const unsigned char* vertexData = geometry->vertexBuffer_->GetShadowData();
+    const unsigned vertexSize = geometry->vertexBuffer_->GetVertexSize();
+    const bool hasTexCoords = geometry->vertexBuffer_->HasElement(TYPE_VECTOR2, SEM_TEXCOORD);
+    float* dest = &batchVertexData_[vertexStart * RML_BATCH_VERTEX_SIZE];
+    for (unsigned i = 0; i < numVertices; ++i)
+    {
+        const auto* src = reinterpret_cast<const float*>(vertexData + i * vertexSize);
+        *dest++ = src[0] + translation.x;
+        *dest++ = src[1] + translation.y;
+        *dest++ = 0.0f;
+        *((unsigned*)dest++) = reinterpret_cast<const unsigned*>(src)[3];
+        *dest++ = hasTexCoords ? src[4] : 0.0f;
+        *dest++ = hasTexCoords ? src[5] : 0.0f;
+    }
+
+    const auto* indexData = reinterpret_cast<const unsigned*>(geometry->indexBuffer_->GetShadowData());
+    unsigned* destIndex = &batchIndexData_[batchIndexData_.size() - numIndices];
+    for (unsigned i = 0; i < numIndices; ++i)
+        *destIndex++ = vertexStart + indexData[i];
+
+    // A batch of one compiled geometry is drawn from its own buffers without upload
+    batchGeometry_ = batchNumDraws_ == 0 ? geometry : nullptr;
+    batchTranslation_ = translation;
+    ++batchNumDraws_;
+}
+
+void RmlRenderer::RenderGeometry(Rml::Vertex* vertices, int num_vertices, int* indices, int num_indices, Rml::TextureHandle texture, const Rml::Vector2f& translation)
+{
+    if (transformEnabled_)
+    {
+        FlushBatch();
+
+        CompiledGeometryForRml geometry;
+        geometry.vertexBuffer_ = vertexBuffer_;
+        geometry.indexBuffer_ = indexBuffer_;
+        CompileGeometry(geometry, vertices, num_vertices, indices, num_indices, texture);
+        DrawCompiledGeometry(&geometry, translation);
+        return;
+    }
+
+    const unsigned vertexStart = ReserveBatch(texture, num_vertices, num_indices);
+
+    float* dest = &batchVertexData_[vertexStart * RML_BATCH_VERTEX_SIZE];
+    for (int i = 0; i < num_vertices; ++i)
+    {
+        *dest++ = vertices[i].position.x + translation.x;
+        *dest++ = vertices[i].position.y + translation.y;
+        *dest++ = 0.0f;
+        *((unsigned*)dest++) = (vertices[i].colour.alpha << 24u) | (vertices[i].colour.blue << 16u) | (vertices[i].colour.green << 8u) | vertices[i].colour.red;
+        *dest++ = vertices[i].tex_coord.x;
+        *dest++ = vertices[i].tex_coord.y;
+    }
+
+    unsigned* destIndex = &batchIndexData_[batchIndexData_.size() - num_indices];
+    for (int i = 0; i < num_indices; ++i)
+        *destIndex++ = vertexStart + (unsigned)indices[i];
+
+    batchGeometry_ = nullptr;
+    ++batchNumDraws_;
+}
+
+void RmlRenderer::ReleaseCompiledGeometry(Rml::CompiledGeometryHandle geometry)
+{
+    // Pending batch owns a copy of the vertex data, so it only has to stop referring to the buffers
+    CompiledGeometryForRml* compiledGeometry = reinterpret_cast<CompiledGeometryForRml*>(geometry);
+    if (batchGeometry_ == compiledGeometry)
+        batchGeometry_ = nullptr;
+    delete compiledGeometry;
+}
+
+void RmlRenderer::FlushBatch()
+{
+    if (batchIndexData_.empty())
+    {
+        batchVertexData_.clear();
+        batchNumDraws_ = 0;
+        batchGeometry_ = nullptr;
+        return;
+    }
+
     // Engine does not render when window is closed or device is lost
     assert(graphics_ && graphics_->IsInitialized() && !graphics_->IsDeviceLost());
 
+    if (batchNumDraws_ == 1 && batchGeometry_)
+        DrawCompiledGeometry(batchGeometry_, batchTranslation_);
+    else
+    {
+        const auto numVertices = (unsigned)(batchVertexData_.size() / RML_BATCH_VERTEX_SIZE);
+        const auto numIndices = (unsigned)batchIndexData_.size();
+
+        if (batchVertexBuffer_->GetVertexCount() < numVertices)
+            batchVertexBuffer_->SetSize(NextPowerOfTwo(numVertices), MASK_POSITION | MASK_COLOR | MASK_TEXCOORD1, true);
+        if (batchIndexBuffer_->GetIndexCount() < numIndices)
+            batchIndexBuffer_->SetSize(NextPowerOfTwo(numIndices), true, true);
+
+        batchVertexBuffer_->SetDataRange(batchVertexData_.data(), 0, numVertices, true);
+        batchIndexBuffer_->SetDataRange(batchIndexData_.data(), 0, numIndices, true);
+
+        PrepareDraw(batchTexture_, Matrix4::IDENTITY);
+        graphics_->SetVertexBuffer(batchVertexBuffer_);
+        graphics_->SetIndexBuffer(batchIndexBuffer_);
+        graphics_->Draw(TRIANGLE_LIST, 0, numIndices, 0, numVertices);
+    }
+
+    batchVertexData_.clear();
+    batchIndexData_.clear();
+    batchNumDraws_ = 0;
+    batchGeometry_ = nullptr;
+}
+
+unsigned RmlRenderer::ReserveBatch(Rml::TextureHandle texture, unsigned numVertices, unsigned numIndices)
+{
+    const unsigned batchVertices = batchVertexData_.size() / RML_BATCH_VERTEX_SIZE;
+    if (batchNumDraws_ > 0 && (texture != batchTexture_ || batchVertices + numVertices > RML_MAX_BATCH_VERTICES))
+        FlushBatch();
+
+    batchTexture_ = texture;
+    const unsigned vertexStart = batchVertexData_.size() / RML_BATCH_VERTEX_SIZE;
+    batchVertexData_.resize(batchVertexData_.size() + numVertices * RML_BATCH_VERTEX_SIZE);
+    batchIndexData_.resize(batchIndexData_.size() + numIndices);
+    return vertexStart;
+}
+
+void RmlRenderer::PrepareDraw(Rml::TextureHandle textureHandle, const Matrix4& model)
+{
     RenderSurface* surface = graphics_->GetRenderTarget(0);
     IntVector2 viewSize = graphics_->GetViewport().Size();
     if (viewSize != lastViewportSize_ || lastViewportHadRenderTarget_ != (surface != nullptr))
@@ -179,7 +320,7 @@ void RmlRenderer::RenderCompiledGeometry(Rml::CompiledGeometryHandle geometryHan
     ShaderVariation* vs;
 
     // Restore texture data if lost
-    CachedRmlTexture* cachedTexture = UnwrapTextureHandle(geometry->texture_);
+    CachedRmlTexture* cachedTexture = UnwrapTextureHandle(textureHandle);
     Texture2D* texture = cachedTexture ? cachedTexture->texture_ : nullptr;
     if (texture && texture->IsDataLost())
     {
@@ -203,16 +344,9 @@ void RmlRenderer::RenderCompiledGeometry(Rml::CompiledGeometryHandle geometryHan
     }
 
     graphics_->SetTexture(0, texture);
-    graphics_->SetVertexBuffer(geometry->vertexBuffer_);
-    graphics_->SetIndexBuffer(geometry->indexBuffer_);
     graphics_->SetShaders(vs, ps);
     graphics_->SetLineAntiAlias(true);
 
-    // Apply translation
-    Matrix4 translate = Matrix4::IDENTITY;
-    translate.SetTranslation(Vector3(translation.x, translation.y, 0.f));
-    Matrix4 model = (matrix_ ? Matrix4(matrix_) : Matrix4::IDENTITY) * translate;
-
     if (graphics_->NeedParameterUpdate(SP_OBJECT, this))
         graphics_->SetShaderParameter(VSP_MODEL, model);
     if (graphics_->NeedParameterUpdate(SP_CAMERA, this))
@@ -223,36 +357,37 @@ void RmlRenderer::RenderCompiledGeometry(Rml::CompiledGeometryHandle geometryHan
     float elapsedTime = context_->GetSubsystem<Time>()->GetElapsedTime();
     graphics_->SetShaderParameter(VSP_ELAPSEDTIME, elapsedTime);
     graphics_->SetShaderParameter(PSP_ELAPSEDTIME, elapsedTime);
-
-    graphics_->Draw(TRIANGLE_LIST, 0, geometry->indexBuffer_->GetIndexCount(), 0, geometry->vertexBuffer_->GetVertexCount());
 }
 
-void RmlRenderer::RenderGeometry(Rml::Vertex* vertices, int num_vertices, int* indices, int num_indices, Rml::TextureHandle texture, const Rml::Vector2f& translation)
+void RmlRenderer::DrawCompiledGeometry(CompiledGeometryForRml* geometry, const Rml::Vector2f& translation)
 {
-    // Could this be optimized?
-    CompiledGeometryForRml geometry;
-    geometry.vertexBuffer_ = vertexBuffer_;
-    geometry.indexBuffer_ = indexBuffer_;
-    CompileGeometry(geometry, vertices, num_vertices, indices, num_indices, texture);
-    RenderCompiledGeometry(reinterpret_cast<Rml::CompiledGeometryHandle>(&geometry), translation);
-}
+    // Engine does not render when window is closed or device is lost
+    assert(graphics_ && graphics_->IsInitialized() && !graphics_->IsDeviceLost());
 
-void RmlRenderer::ReleaseCompiledGeometry(Rml::CompiledGeometryHandle geometry)
-{
-    delete reinterpret_cast<CompiledGeometryForRml*>(geometry);
+    // Apply translation
+    Matrix4 translate = Matrix4::IDENTITY;
+    translate.SetTranslation(Vector3(translation.x, translation.y, 0.f));
+    Matrix4 model = (matrix_ ? Matrix4(matrix_) : Matrix4::IDENTITY) * translate;
+
+    PrepareDraw(geometry->texture_, model);
+    graphics_->SetVertexBuffer(geometry->vertexBuffer_);
+    graphics_->SetIndexBuffer(geometry->indexBuffer_);
+    graphics_->Draw(TRIANGLE_LIST, 0, geometry->indexBuffer_->GetIndexCount(), 0, geometry->vertexBuffer_->GetVertexCount());
 }
 
 void RmlRenderer::EnableScissorRegion(bool enable)
 {
+    if (enable != scissorEnabled_)
+        FlushBatch();
     scissorEnabled_ = enable;
 }
 
 void RmlRenderer::SetScissorRegion(int x, int y, int width, int height)
 {
-    scissor_.left_ = x;
-    scissor_.top_ = y;
-    scissor_.bottom_ = y + height;
-    scissor_.right_ = x + width;
+    const IntRect scissor(x, y, x + width, y + height);
+    if (scissor != scissor_)
+        FlushBatch();
+    scissor_ = scissor;
 }
 
 void RmlRenderer::ApplyScissorRegion(RenderSurface* surface, const IntVector2& viewSize)
@@ -376,12 +511,16 @@ bool RmlRenderer::GenerateTexture(Rml::TextureHandle& handleOut, const Rml::byte
 
 void RmlRenderer::ReleaseTexture(Rml::TextureHandle textureHandle)
 {
+    if (batchNumDraws_ > 0 && textureHandle == batchTexture_)
+        FlushBatch();
+
     CachedRmlTexture* cachedTexture = UnwrapTextureHandle(textureHandle);
     delete cachedTexture;
 }
 
 void RmlRenderer::SetTransform(const Rml::Matrix4f* transform)
 {
+    FlushBatch();
     transformEnabled_ = transform != nullptr;
     matrix_ = transform ? transform->data() : Matrix4::IDENTITY.Data();
 }
@@ -75,10 +75,18 @@ public:
     void ReleaseTexture(Rml::TextureHandle textureHandle) override;
     /// Set or unset a custom transform.
     void SetTransform(const Rml::Matrix4f* transform) override;
+    /// Draw pending merged geometry. Must be called after RmlUi context is rendered.
+    void FlushBatch();
 
 private:
     /// Perform initialization tasks that require graphics subsystem.
     void InitializeGraphics();
+    /// Flush pending geometry if it can not be merged with new geometry, then reserve space for it. Return index of the first reserved vertex.
+    unsigned ReserveBatch(Rml::TextureHandle texture, unsigned numVertices, unsigned numIndices);
+    /// Set render state, shaders and shader parameters for drawing geometry.
+    void PrepareDraw(Rml::TextureHandle texture, const Matrix4& model);
+    /// Draw compiled geometry from its own buffers.
+    void DrawCompiledGeometry(CompiledGeometryForRml* geometry, const Rml::Vector2f& translation);
 
     /// Graphics subsystem instance.
     WeakPtr<Graphics> graphics_;
@@ -92,6 +100,22 @@ private:
     SharedPtr<VertexBuffer> vertexBuffer_;
     /// Temporary buffer used for rendering uncompiled geometry.
     SharedPtr<IndexBuffer> indexBuffer_;
+    /// Buffer for merged geometry.
+    SharedPtr<VertexBuffer> batchVertexBuffer_;
+    /// Buffer for merged geometry.
+    SharedPtr<IndexBuffer> batchIndexBuffer_;
+    /// Pending merged vertex data, translation already applied.
+    ea::vector<float> batchVertexData_;
+    /// Pending merged index data.
+    ea::vector<unsigned> batchIndexData_;
+    /// Texture of pending merged geometry.
+    Rml::TextureHandle batchTexture_{};
+    /// Number of geometry draws merged into pending batch.
+    unsigned batchNumDraws_{};
+    /// Compiled geometry of pending batch if it consists of exactly one compiled geometry draw.
+    CompiledGeometryForRml* batchGeometry_{};
+    /// Translation of the compiled geometry of pending batch.
+    Rml::Vector2f batchTranslation_;
     /// Transform requested by RmlUi. This pointer points either to data owned by RmlUi or to Matrix4::IDENTITY.data().
     const float* matrix_ = nullptr;
     /// Last viewport size.
@@ -600,6 +600,7 @@ void RmlUI::Render()
         graphics->SetRenderTarget(0, (RenderSurface*)nullptr);
 
     rmlContext_->Render();
+    static_cast<Detail::RmlRenderer*>(Rml::GetRenderInterface())->FlushBatch();
 }
 
 void RmlUI::OnDocumentUnload(Rml::ElementDocument* document)
@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Container/FrameAllocator.h"
 #include "../Core/Context.h"
 #include "../IO/Archive.h"
 #include "../IO/ArchiveSerialization.h"
@@ -593,7 +594,7 @@ void Animatable::UpdateAttributeAnimations(float timeStep)
     // Keep weak pointer to self to check for destruction caused by event handling
     WeakPtr<Animatable> self(this);
 
-    ea::vector<ea::string> finishedNames;
+    FrameVector<ea::string> finishedNames;
     for (auto i = attributeAnimationInfos_.begin();
          i != attributeAnimationInfos_.end(); ++i)
     {
@@ -169,6 +169,7 @@ void Component::PrepareNetworkUpdate()
 {
     if (!networkState_)
         AllocateNetworkState();
+    networkState_->InvalidateEncodedUpdates();
 
     const ea::vector<AttributeInfo>* attributes = networkState_->attributes_;
     if (!attributes)
@@ -41,7 +41,11 @@ LogicComponent::LogicComponent(Context* context) :
 {
 }
 
-LogicComponent::~LogicComponent() = default;
+LogicComponent::~LogicComponent()
+{
+    if (threadedUpdateScene_)
+        threadedUpdateScene_->RemoveThreadedUpdateComponent(this);
+}
 
 void LogicComponent::OnSetEnabled()
 {
@@ -64,6 +68,10 @@ void LogicComponent::FixedPostUpdate(float timeStep)
 {
 }
 
+void LogicComponent::ThreadedUpdate(float timeStep)
+{
+}
+
 void LogicComponent::SetUpdateEventMask(UpdateEventFlags mask)
 {
     if (updateEventMask_ != mask)
@@ -95,6 +103,11 @@ void LogicComponent::OnSceneSet(Scene* scene)
     {
         UnsubscribeFromEvent(E_SCENEUPDATE);
         UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
+        if (threadedUpdateScene_)
+        {
+            threadedUpdateScene_->RemoveThreadedUpdateComponent(this);
+            threadedUpdateScene_.Reset();
+        }
 #if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
         UnsubscribeFromEvent(E_PHYSICSPRESTEP);
         UnsubscribeFromEvent(E_PHYSICSPOSTSTEP);
@@ -135,6 +148,21 @@ void LogicComponent::UpdateEventSubscription()
         currentEventMask_ &= ~USE_POSTUPDATE;
     }
 
+    bool needThreadedUpdate = enabled && (updateEventMask_ & USE_THREADEDUPDATE);
+    if (needThreadedUpdate && !(currentEventMask_ & USE_THREADEDUPDATE))
+    {
+        scene->AddThreadedUpdateComponent(this);
+        threadedUpdateScene_ = scene;
+        currentEventMask_ |= USE_THREADEDUPDATE;
+    }
+    else if (!needThreadedUpdate && (currentEventMask_ & USE_THREADEDUPDATE))
+    {
+        if (threadedUpdateScene_)
+            threadedUpdateScene_->RemoveThreadedUpdateComponent(this);
+        threadedUpdateScene_.Reset();
+        currentEventMask_ &= ~USE_THREADEDUPDATE;
+    }
+
 #if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
     Component* world = GetFixedUpdateSource();
     if (!world)
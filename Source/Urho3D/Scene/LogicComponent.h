@@ -42,6 +42,8 @@ enum UpdateEvent : unsigned
     USE_FIXEDUPDATE = 0x4,
     /// Bitmask for using the physics post-update event.
     USE_FIXEDPOSTUPDATE = 0x8,
+    /// Bitmask for using the threaded update, executed on worker threads after the scene update event.
+    USE_THREADEDUPDATE = 0x10,
 };
 URHO3D_FLAGSET(UpdateEvent, UpdateEventFlags);
 
@@ -75,6 +77,8 @@ class URHO3D_API LogicComponent : public Component
     virtual void FixedUpdate(float timeStep);
     /// Called on physics post-update, fixed timestep.
     virtual void FixedPostUpdate(float timeStep);
+    /// Called on scene update from a worker thread, in parallel with components outside this component's top-level node hierarchy. May only read the scene and modify the own node hierarchy; must not create or remove nodes or components, or send events.
+    virtual void ThreadedUpdate(float timeStep);
 
     /// Set what update events should be subscribed to. Use this for optimization: by default all are in use. Note that this is not an attribute and is not saved or network-serialized, therefore it should always be called eg. in the subclass constructor.
     void SetUpdateEventMask(UpdateEventFlags mask);
@@ -110,6 +114,8 @@ private:
     UpdateEventFlags currentEventMask_;
     /// Flag for delayed start.
     bool delayedStartCalled_;
+    /// Scene the component is registered to for threaded update.
+    WeakPtr<Scene> threadedUpdateScene_;
 };
 
 }
@@ -27,6 +27,7 @@
 #include "../IO/Archive.h"
 #include "../IO/ArchiveSerialization.h"
 #include "../IO/Log.h"
+#include "../IO/BitStream.h"
 #include "../IO/MemoryBuffer.h"
 #include "../Resource/XMLFile.h"
 #include "../Resource/JSONFile.h"
@@ -38,6 +39,8 @@
 #include "../Scene/SmoothedTransform.h"
 #include "../Scene/UnknownComponent.h"
 
+#include <EASTL/fixed_vector.h>
+
 #include "../DebugNew.h"
 
 #ifdef _MSC_VER
@@ -47,6 +50,13 @@
 namespace Urho3D
 {
 
+/// Number of dirty ancestors updated without heap allocation.
+static const unsigned MAX_STACK_DIRTY_ANCESTORS = 32;
+/// Bits per component of smallest-three encoded network rotation. Packs the whole rotation into 4 bytes.
+static const unsigned NET_ROTATION_BITS = 10;
+
+URHO3D_IMPLEMENT_POOLED_OBJECT(Node, 256);
+
 Node::Node(Context* context) :
     Animatable(context),
     worldTransform_(Matrix3x4::IDENTITY),
@@ -465,14 +475,17 @@ void Node::SetName(const ea::string& name)
 {
     if (name != impl_->name_)
     {
+        const StringHash oldNameHash = impl_->nameHash_;
         impl_->name_ = name;
         impl_->nameHash_ = name;
 
         MarkNetworkUpdate();
 
-        // Send change event
+        // Update name cache and send change event
         if (scene_)
         {
+            scene_->NodeNameChanged(this, oldNameHash);
+
             using namespace NodeNameChanged;
 
             VariantMap& eventData = GetEventDataMap();
@@ -1434,6 +1447,19 @@ void Node::GetChildrenWithTag(ea::vector<Node*>& dest, const ea::string& tag, bo
                 dest.push_back(i->Get());
         }
     }
+    else if (scene_)
+    {
+        // Filter the scene tag cache instead of walking the subtree
+        if (const ea::vector<Node*>* taggedNodes = scene_->GetTaggedNodes(tag))
+        {
+            Node* self = const_cast<Node*>(this);
+            for (Node* node : *taggedNodes)
+            {
+                if (self == scene_ || node->IsChildOf(self))
+                    dest.push_back(node);
+            }
+        }
+    }
     else
         GetChildrenWithTagRecursive(dest, tag);
 }
@@ -1462,6 +1488,30 @@ Node* Node::GetChild(const char* name, bool recursive) const
 
 Node* Node::GetChild(StringHash nameHash, bool recursive) const
 {
+    if (recursive && scene_ && nameHash != StringHash::ZERO)
+    {
+        // Look up the scene name cache. If the name is unique within the subtree, no walk is needed
+        Node* self = const_cast<Node*>(this);
+        Node* found = nullptr;
+        unsigned numFound = 0;
+        if (const ea::vector<Node*>* namedNodes = scene_->GetNamedNodes(nameHash))
+        {
+            for (Node* node : *namedNodes)
+            {
+                if (self == scene_ || node->IsChildOf(self))
+                {
+                    found = node;
+                    if (++numFound > 1)
+                        break;
+                }
+            }
+        }
+
+        // With several matches, walk the subtree to return the first one in depth-first order
+        if (numFound <= 1)
+            return found;
+    }
+
     for (auto i = children_.begin(); i != children_.end(); ++i)
     {
         if ((*i)->GetNameHash() == nameHash)
@@ -1610,12 +1660,13 @@ void Node::SetNetPositionAttr(const Vector3& value)
 
 void Node::SetNetRotationAttr(const ea::vector<unsigned char>& value)
 {
-    MemoryBuffer buf(value);
+    BitStreamReader reader(value);
+    const Quaternion rotation = reader.ReadQuaternion(NET_ROTATION_BITS);
     auto* transform = GetComponent<SmoothedTransform>();
     if (transform)
-        transform->SetTargetRotation(buf.ReadPackedQuaternion());
+        transform->SetTargetRotation(rotation);
     else
-        SetRotation(buf.ReadPackedQuaternion());
+        SetRotation(rotation);
 }
 
 void Node::SetNetParentAttr(const ea::vector<unsigned char>& value)
@@ -1663,7 +1714,8 @@ const Vector3& Node::GetNetPositionAttr() const
 const ea::vector<unsigned char>& Node::GetNetRotationAttr() const
 {
     impl_->attrBuffer_.Clear();
-    impl_->attrBuffer_.WritePackedQuaternion(rotation_);
+    BitStreamWriter writer(impl_->attrBuffer_.GetBuffer());
+    writer.WriteQuaternion(rotation_, NET_ROTATION_BITS);
     return impl_->attrBuffer_.GetBuffer();
 }
 
@@ -1854,6 +1906,7 @@ void Node::PrepareNetworkUpdate()
     // Then check for node attribute changes
     if (!networkState_)
         AllocateNetworkState();
+    networkState_->InvalidateEncodedUpdates();
 
     const ea::vector<AttributeInfo>* attributes = networkState_->attributes_;
     unsigned numAttributes = attributes->size();
@@ -2237,21 +2290,29 @@ Component* Node::SafeCreateComponent(const ea::string& typeName, StringHash type
 
 void Node::UpdateWorldTransform() const
 {
-    Matrix3x4 transform = GetTransform();
+    // Collect the dirty ancestor chain and update it top-down. This avoids recursing through deep hierarchies and
+    // computes each parent transform only once. Assume the root node (scene) has identity transform
+    ea::fixed_vector<const Node*, MAX_STACK_DIRTY_ANCESTORS> dirtyNodes;
+    for (const Node* node = this; node && node->dirty_; node = node->parent_ != scene_ ? node->parent_ : nullptr)
+        dirtyNodes.push_back(node);
 
-    // Assume the root node (scene) has identity transform
-    if (parent_ == scene_ || !parent_)
-    {
-        worldTransform_ = transform;
-        worldRotation_ = rotation_;
-    }
-    else
+    for (auto i = dirtyNodes.rbegin(); i != dirtyNodes.rend(); ++i)
     {
-        worldTransform_ = parent_->GetWorldTransform() * transform;
-        worldRotation_ = parent_->GetWorldRotation() * rotation_;
-    }
+        const Node* node = *i;
+        const Node* parent = node->parent_;
+        if (parent == scene_ || !parent)
+        {
+            node->worldTransform_ = node->GetTransform();
+            node->worldRotation_ = node->rotation_;
+        }
+        else
+        {
+            node->worldTransform_ = parent->worldTransform_ * node->GetTransform();
+            node->worldRotation_ = parent->worldRotation_ * node->rotation_;
+        }
 
-    dirty_ = false;
+        node->dirty_ = false;
+    }
 }
 
 void Node::RemoveChild(ea::vector<SharedPtr<Node> >::iterator i)
@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include "../Container/ObjectPool.h"
 #include "../IO/VectorBuffer.h"
 #include "../Math/Matrix3x4.h"
 #include "../Scene/Animatable.h"
@@ -75,6 +76,7 @@ struct URHO3D_API NodeImpl
 class URHO3D_API Node : public Animatable
 {
     URHO3D_OBJECT(Node, Animatable);
+    URHO3D_POOLED_OBJECT();
 
     friend class Connection;
 
@@ -574,7 +576,7 @@ public:
     void GetChildrenWithComponent(ea::vector<Node*>& dest, StringHash type, bool recursive = false) const;
     /// Return child scene nodes with a specific component.
     ea::vector<Node*> GetChildrenWithComponent(StringHash type, bool recursive = false) const;
-    /// Return child scene nodes with a specific tag.
+    /// Return child scene nodes with a specific tag. Recursive query uses the scene tag cache when in a scene, in which case nodes are returned in tagging order.
     void GetChildrenWithTag(ea::vector<Node*>& dest, const ea::string& tag, bool recursive = false) const;
     /// Return child scene nodes with a specific tag.
     ea::vector<Node*> GetChildrenWithTag(const ea::string& tag, bool recursive = false) const;
@@ -585,7 +587,7 @@ public:
     Node* GetChild(const ea::string& name, bool recursive = false) const;
     /// Return child scene node by name.
     Node* GetChild(const char* name, bool recursive = false) const;
-    /// Return child scene node by name hash.
+    /// Return child scene node by name hash. Recursive query uses the scene name cache when in a scene.
     Node* GetChild(StringHash nameHash, bool recursive = false) const;
 
     /// Return number of components.
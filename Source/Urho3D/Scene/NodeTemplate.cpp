@@ -0,0 +1,189 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Core/Profiler.h"
+#include "../Resource/Resource.h"
+#include "../Resource/ResourceCache.h"
+#include "../Scene/Component.h"
+#include "../Scene/NodeTemplate.h"
+#include "../Scene/SceneResolver.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+void NodeTemplate::Capture(Node* node)
+{
+    Clear();
+
+    if (!node)
+        return;
+
+    URHO3D_PROFILE("CaptureNodeTemplate");
+
+    CaptureRecursive(node, M_MAX_UNSIGNED);
+}
+
+void NodeTemplate::Clear()
+{
+    nodes_.clear();
+    components_.clear();
+    resources_.clear();
+}
+
+Node* NodeTemplate::Instantiate(Node* parent, const Vector3& position, const Quaternion& rotation, CreateMode mode) const
+{
+    if (!parent || nodes_.empty())
+        return nullptr;
+
+    URHO3D_PROFILE("InstantiateNodeTemplate");
+
+    SceneResolver resolver;
+    ea::vector<Node*> createdNodes(nodes_.size());
+
+    for (unsigned i = 0; i < nodes_.size(); ++i)
+    {
+        const NodeData& nodeData = nodes_[i];
+        Node* nodeParent = nodeData.parent_ == M_MAX_UNSIGNED ? parent : createdNodes[nodeData.parent_];
+        Node* node = nodeParent->CreateChild(0, (mode == REPLICATED && nodeData.replicated_) ? REPLICATED : LOCAL);
+        createdNodes[i] = node;
+        resolver.AddNode(nodeData.id_, node);
+
+        const ea::vector<AttributeInfo>* attributes = node->GetAttributes();
+        for (const AttributeValue& value : nodeData.attributes_)
+            node->OnSetAttribute(attributes->at(value.first), value.second);
+
+        for (unsigned j = nodeData.firstComponent_; j < nodeData.firstComponent_ + nodeData.numComponents_; ++j)
+        {
+            const ComponentData& componentData = components_[j];
+            Component* component = node->CreateComponent(componentData.type_,
+                (mode == REPLICATED && componentData.replicated_) ? REPLICATED : LOCAL);
+            if (!component)
+                continue;
+            resolver.AddComponent(componentData.id_, component);
+
+            const ea::vector<AttributeInfo>* componentAttributes = component->GetAttributes();
+            if (componentAttributes)
+            {
+                for (const AttributeValue& value : componentData.attributes_)
+                {
+                    if (value.first < componentAttributes->size())
+                        component->OnSetAttribute(componentAttributes->at(value.first), value.second);
+                }
+                component->ApplyAttributes();
+            }
+        }
+    }
+
+    Node* root = createdNodes.front();
+    resolver.Resolve();
+    root->SetTransform(position, rotation);
+    root->ApplyAttributes();
+    return root;
+}
+
+void NodeTemplate::CaptureRecursive(Node* node, unsigned parent)
+{
+    const unsigned index = nodes_.size();
+    nodes_.emplace_back();
+    {
+        NodeData& nodeData = nodes_.back();
+        nodeData.parent_ = parent;
+        nodeData.id_ = node->GetID();
+        nodeData.replicated_ = node->IsReplicated();
+        CaptureAttributes(node, nodeData.attributes_);
+        nodeData.firstComponent_ = components_.size();
+    }
+
+    for (Component* component : node->GetComponents())
+    {
+        if (component->IsTemporary())
+            continue;
+
+        ComponentData& componentData = components_.emplace_back();
+        componentData.type_ = component->GetType();
+        componentData.id_ = component->GetID();
+        componentData.replicated_ = component->IsReplicated();
+        CaptureAttributes(component, componentData.attributes_);
+    }
+    nodes_[index].numComponents_ = components_.size() - nodes_[index].firstComponent_;
+
+    for (Node* child : node->GetChildren())
+    {
+        if (!child->IsTemporary())
+            CaptureRecursive(child, index);
+    }
+}
+
+void NodeTemplate::CaptureAttributes(Serializable* serializable, ea::vector<AttributeValue>& dest)
+{
+    const ea::vector<AttributeInfo>* attributes = serializable->GetAttributes();
+    if (!attributes)
+        return;
+
+    for (unsigned i = 0; i < attributes->size(); ++i)
+    {
+        const AttributeInfo& attr = attributes->at(i);
+        // Do not copy network-only attributes, as they may have unintended side effects
+        if (attr.mode_ & AM_FILE)
+        {
+            Variant value;
+            serializable->OnGetAttribute(attr, value);
+            HoldResources(serializable->GetContext(), value);
+            dest.emplace_back(i, ea::move(value));
+        }
+    }
+}
+
+void NodeTemplate::HoldResources(Context* context, const Variant& value)
+{
+    auto* cache = context->GetSubsystem<ResourceCache>();
+    if (!cache)
+        return;
+
+    if (value.GetType() == VAR_RESOURCEREF)
+    {
+        const ResourceRef& ref = value.GetResourceRef();
+        if (!ref.name_.empty())
+        {
+            if (Resource* resource = cache->GetResource(ref.type_, ref.name_, false))
+                resources_.emplace_back(resource);
+        }
+    }
+    else if (value.GetType() == VAR_RESOURCEREFLIST)
+    {
+        const ResourceRefList& refList = value.GetResourceRefList();
+        for (const ea::string& name : refList.names_)
+        {
+            if (name.empty())
+                continue;
+            if (Resource* resource = cache->GetResource(refList.type_, name, false))
+                resources_.emplace_back(resource);
+        }
+    }
+}
+
+}
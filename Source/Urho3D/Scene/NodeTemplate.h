@@ -0,0 +1,107 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Container/Ptr.h"
+#include "../Core/Variant.h"
+#include "../Math/Quaternion.h"
+#include "../Math/Vector3.h"
+#include "../Scene/Node.h"
+
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+class Resource;
+
+/// Flattened snapshot of a node hierarchy for fast repeated instantiation. Stores file attribute values of nodes and
+/// components in depth-first order, so spawning does not have to deserialize anything. Resources referenced by the
+/// captured attributes are kept loaded by the template.
+class URHO3D_API NodeTemplate
+{
+public:
+    /// Capture node with its components and child nodes. Temporary nodes and components are skipped.
+    void Capture(Node* node);
+    /// Reset to empty.
+    void Clear();
+    /// Instantiate as child of parent. Return root node of the copy, or null if the template is empty.
+    Node* Instantiate(Node* parent, const Vector3& position, const Quaternion& rotation, CreateMode mode = REPLICATED) const;
+
+    /// Return whether the template is empty.
+    bool IsEmpty() const { return nodes_.empty(); }
+    /// Return number of captured nodes.
+    unsigned GetNumNodes() const { return nodes_.size(); }
+    /// Return number of captured components.
+    unsigned GetNumComponents() const { return components_.size(); }
+
+private:
+    /// Attribute index and value.
+    using AttributeValue = ea::pair<unsigned, Variant>;
+
+    /// Captured component.
+    struct ComponentData
+    {
+        /// Component type.
+        StringHash type_;
+        /// Original ID.
+        unsigned id_{};
+        /// Whether the component was replicated.
+        bool replicated_{};
+        /// File attribute values.
+        ea::vector<AttributeValue> attributes_;
+    };
+
+    /// Captured node.
+    struct NodeData
+    {
+        /// Index of parent node in the template, or M_MAX_UNSIGNED for the root.
+        unsigned parent_{};
+        /// Original ID.
+        unsigned id_{};
+        /// Whether the node was replicated.
+        bool replicated_{};
+        /// File attribute values.
+        ea::vector<AttributeValue> attributes_;
+        /// First component index.
+        unsigned firstComponent_{};
+        /// Number of components.
+        unsigned numComponents_{};
+    };
+
+    /// Capture node recursively.
+    void CaptureRecursive(Node* node, unsigned parent);
+    /// Capture file attribute values of a serializable.
+    void CaptureAttributes(Serializable* serializable, ea::vector<AttributeValue>& dest);
+    /// Hold a reference to a resource named by an attribute value.
+    void HoldResources(Context* context, const Variant& value);
+
+    /// Nodes in depth-first order.
+    ea::vector<NodeData> nodes_;
+    /// Components of all nodes.
+    ea::vector<ComponentData> components_;
+    /// Resources referenced by captured attributes.
+    ea::vector<SharedPtr<Resource> > resources_;
+};
+
+}
@@ -24,8 +24,10 @@
 
 #include <EASTL/hash_set.h>
 #include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
 
 #include "../Core/Attribute.h"
+#include "../Core/Mutex.h"
 #include "../Math/StringHash.h"
 
 #include <cstring>
@@ -111,6 +113,12 @@ struct URHO3D_API DirtyBits
     /// Return number of set bits.
     unsigned Count() const { return count_; }
 
+    /// Test for equality with another set of bits.
+    bool operator ==(const DirtyBits& rhs) const
+    {
+        return count_ == rhs.count_ && memcmp(data_, rhs.data_, MAX_NETWORK_ATTRIBUTES / 8) == 0;
+    }
+
     /// Bit data.
     unsigned char data_[MAX_NETWORK_ATTRIBUTES / 8]{};
     /// Number of set bits.
@@ -132,6 +140,25 @@ struct URHO3D_API NetworkState
     VariantMap previousVars_;
     /// Bitmask for intercepting network messages. Used on the client only.
     unsigned long long interceptMask_{};
+    /// Encoded delta update attribute data, shared between connections until current values change.
+    ea::vector<unsigned char> encodedDelta_;
+    /// Attribute bits the delta update data was encoded for.
+    DirtyBits encodedDeltaBits_;
+    /// Whether the encoded delta update data is valid.
+    bool encodedDeltaValid_{};
+    /// Encoded latest data attribute data, shared between connections until current values change.
+    ea::vector<unsigned char> encodedLatestData_;
+    /// Whether the encoded latest data is valid.
+    bool encodedLatestDataValid_{};
+    /// Guards the encoded update data when connections are updated from worker threads.
+    SpinLockMutex encodeMutex_;
+
+    /// Invalidate encoded update data. Call when current values are refreshed.
+    void InvalidateEncodedUpdates()
+    {
+        encodedDeltaValid_ = false;
+        encodedLatestDataValid_ = false;
+    }
 };
 
 /// Base class for per-user network replication states.
@@ -37,16 +37,22 @@
 #include "../Resource/JSONFile.h"
 #include "../Scene/CameraViewport.h"
 #include "../Scene/Component.h"
+#include "../Scene/LogicComponent.h"
+#include "../Scene/NodeTemplate.h"
 #include "../Scene/ObjectAnimation.h"
 #include "../Scene/ReplicationState.h"
 #include "../Scene/Scene.h"
 #include "../Scene/SceneEvents.h"
 #include "../Scene/SceneManager.h"
+#include "../Scene/SceneStreamer.h"
 #include "../Scene/SmoothedTransform.h"
 #include "../Scene/SplinePath.h"
 #include "../Scene/UnknownComponent.h"
 #include "../Scene/ValueAnimation.h"
 
+#include <EASTL/shared_ptr.h>
+#include <EASTL/sort.h>
+
 #include "../DebugNew.h"
 
 namespace Urho3D
@@ -199,6 +205,33 @@ bool Scene::Save(Serializer& dest) const
         return false;
 }
 
+bool Scene::SaveAsync(const ea::string& fileName) const
+{
+    URHO3D_PROFILE("SaveSceneAsync");
+
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    if (!workQueue)
+    {
+        URHO3D_LOGERROR("Could not save scene asynchronously, WorkQueue subsystem missing");
+        return false;
+    }
+
+    // Snapshot on the main thread, the scene may change right after returning
+    auto snapshot = ea::make_shared<VectorBuffer>();
+    snapshot->SetName(fileName);
+    if (!Save(*snapshot))
+        return false;
+
+    Context* context = context_;
+    workQueue->AddWorkItem([context, fileName, snapshot]()
+    {
+        File file(context, fileName, FILE_WRITE);
+        if (!file.IsOpen() || file.Write(snapshot->GetData(), snapshot->GetSize()) != snapshot->GetSize())
+            URHO3D_LOGERROR("Could not save scene to " + fileName);
+    });
+    return true;
+}
+
 bool Scene::LoadXML(const XMLElement& source)
 {
     URHO3D_PROFILE("LoadSceneXML");
@@ -679,6 +712,11 @@ Node* Scene::InstantiateJSON(Deserializer& source, const Vector3& position, cons
     return InstantiateJSON(json->GetRoot(), position, rotation, mode);
 }
 
+Node* Scene::Instantiate(const NodeTemplate& source, const Vector3& position, const Quaternion& rotation, CreateMode mode)
+{
+    return source.Instantiate(this, position, rotation, mode);
+}
+
 void Scene::Clear(bool clearReplicated, bool clearLocal)
 {
     StopAsyncLoading();
@@ -804,6 +842,30 @@ bool Scene::GetNodesWithTag(ea::vector<Node*>& dest, const ea::string& tag) cons
         return false;
 }
 
+bool Scene::GetNodesWithName(ea::vector<Node*>& dest, StringHash nameHash) const
+{
+    dest.clear();
+    if (const ea::vector<Node*>* nodes = GetNamedNodes(nameHash))
+    {
+        dest = *nodes;
+        return true;
+    }
+    else
+        return false;
+}
+
+const ea::vector<Node*>* Scene::GetTaggedNodes(StringHash tag) const
+{
+    auto it = taggedNodes_.find(tag);
+    return it != taggedNodes_.end() && !it->second.empty() ? &it->second : nullptr;
+}
+
+const ea::vector<Node*>* Scene::GetNamedNodes(StringHash nameHash) const
+{
+    auto it = namedNodes_.find(nameHash);
+    return it != namedNodes_.end() && !it->second.empty() ? &it->second : nullptr;
+}
+
 Component* Scene::GetComponent(unsigned id) const
 {
     if (IsReplicatedID(id))
@@ -831,6 +893,12 @@ const ea::string& Scene::GetVarName(StringHash hash) const
     return i != varNames_.end() ? i->second : EMPTY_STRING;
 }
 
+TimerHandle Scene::ScheduleCall(float delay, TimerWheel::Callback callback)
+{
+    const auto ticks = static_cast<unsigned long long>(Max(delay, 0.0f) * 1000.0f + 0.5f);
+    return scheduledCalls_.Schedule(ticks, ea::move(callback));
+}
+
 void Scene::Update(float timeStep)
 {
     if (asyncLoading_)
@@ -845,6 +913,15 @@ void Scene::Update(float timeStep)
 
     timeStep *= timeScale_;
 
+    // Call scheduled calls that expire during this step
+    if (scheduledCalls_.GetNumScheduled())
+    {
+        scheduledCallsTime_ += timeStep * 1000.0f;
+        const auto ticks = static_cast<unsigned long long>(scheduledCallsTime_);
+        scheduledCallsTime_ -= static_cast<float>(ticks);
+        scheduledCalls_.Advance(ticks);
+    }
+
     using namespace SceneUpdate;
 
     VariantMap& eventData = GetEventDataMap();
@@ -854,6 +931,9 @@ void Scene::Update(float timeStep)
     // Update variable timestep logic
     SendEvent(E_SCENEUPDATE, eventData);
 
+    // Update variable timestep logic that can run on worker threads
+    UpdateThreadedComponents(timeStep);
+
     // Update scene attribute animation.
     SendEvent(E_ATTRIBUTEANIMATIONUPDATE, eventData);
 
@@ -883,6 +963,70 @@ void Scene::Update(float timeStep)
     elapsedTime_ += timeStep;
 }
 
+void Scene::UpdateThreadedComponents(float timeStep)
+{
+    if (threadedUpdateComponents_.empty())
+        return;
+
+    URHO3D_PROFILE("UpdateThreadedComponents");
+
+    // Group components by their top-level node. Different hierarchies do not share transforms and can be updated in
+    // parallel, while components within one hierarchy are updated sequentially by the same work item
+    threadedUpdateQueue_.clear();
+    for (LogicComponent* component : threadedUpdateComponents_)
+    {
+        // Components that have not had their delayed start yet are skipped until the next frame
+        Node* node = component->GetNode();
+        if (!node || !component->IsDelayedStartCalled())
+            continue;
+
+        while (node->GetParent() && node->GetParent() != this)
+            node = node->GetParent();
+        threadedUpdateQueue_.emplace_back(node, component);
+    }
+
+    if (threadedUpdateQueue_.empty())
+        return;
+
+    ea::sort(threadedUpdateQueue_.begin(), threadedUpdateQueue_.end());
+
+    auto* queue = GetSubsystem<WorkQueue>();
+    BeginThreadedUpdate();
+
+    const unsigned numWorkItems = queue->GetNumThreads() + 1; // Worker threads + main thread
+    const unsigned componentsPerItem = Max(threadedUpdateQueue_.size() / numWorkItems, 1u);
+
+    unsigned start = 0;
+    while (start < threadedUpdateQueue_.size())
+    {
+        // Extend the work item to the end of the last hierarchy it contains
+        unsigned end = Min(start + componentsPerItem, threadedUpdateQueue_.size());
+        while (end < threadedUpdateQueue_.size() && threadedUpdateQueue_[end].first == threadedUpdateQueue_[end - 1].first)
+            ++end;
+
+        queue->AddWorkItem([this, start, end, timeStep]()
+        {
+            for (unsigned i = start; i < end; ++i)
+                threadedUpdateQueue_[i].second->ThreadedUpdate(timeStep);
+        }, M_MAX_UNSIGNED);
+
+        start = end;
+    }
+
+    queue->Complete(M_MAX_UNSIGNED);
+    EndThreadedUpdate();
+}
+
+void Scene::AddThreadedUpdateComponent(LogicComponent* component)
+{
+    threadedUpdateComponents_.insert(component);
+}
+
+void Scene::RemoveThreadedUpdateComponent(LogicComponent* component)
+{
+    threadedUpdateComponents_.erase(component);
+}
+
 void Scene::BeginThreadedUpdate()
 {
     // Check the work queue subsystem whether it actually has created worker threads. If not, do not enter threaded mode.
@@ -1032,6 +1176,10 @@ void Scene::NodeAdded(Node* node)
             taggedNodes_[tags[i]].push_back(node);
     }
 
+    // Cache name, unnamed nodes are not indexed
+    if (!node->GetName().empty())
+        namedNodes_[node->GetNameHash()].push_back(node);
+
     // Add already created components and child nodes now
     const ea::vector<SharedPtr<Component> >& components = node->GetComponents();
     for (auto i = components.begin(); i != components.end(); ++i)
@@ -1051,6 +1199,18 @@ void Scene::NodeTagRemoved(Node* node, const ea::string& tag)
     taggedNodes_[tag].erase_first(node);
 }
 
+void Scene::NodeNameChanged(Node* node, StringHash oldNameHash)
+{
+    if (oldNameHash != StringHash::ZERO)
+    {
+        auto it = namedNodes_.find(oldNameHash);
+        if (it != namedNodes_.end())
+            it->second.erase_first(node);
+    }
+    if (!node->GetName().empty())
+        namedNodes_[node->GetNameHash()].push_back(node);
+}
+
 void Scene::NodeRemoved(Node* node)
 {
     if (!node || node->GetScene() != this)
@@ -1075,6 +1235,14 @@ void Scene::NodeRemoved(Node* node)
             taggedNodes_[tags[i]].erase_first(node);
     }
 
+    // Remove node from name cache
+    if (!node->GetName().empty())
+    {
+        auto it = namedNodes_.find(node->GetNameHash());
+        if (it != namedNodes_.end())
+            it->second.erase_first(node);
+    }
+
     // Remove components and child nodes as well
     const ea::vector<SharedPtr<Component> >& components = node->GetComponents();
     for (auto i = components.begin(); i != components.end(); ++i)
@@ -1632,6 +1800,7 @@ void RegisterSceneLibrary(Context* context)
     UnknownComponent::RegisterObject(context);
     SplinePath::RegisterObject(context);
     SceneManager::RegisterObject(context);
+    SceneStreamer::RegisterObject(context);
     CameraViewport::RegisterObject(context);
 }
 
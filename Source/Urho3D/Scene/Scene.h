@@ -28,6 +28,7 @@
 #include <EASTL/unique_ptr.h>
 
 #include "../Core/Mutex.h"
+#include "../Core/TimerWheel.h"
 #include "../Resource/XMLElement.h"
 #include "../Resource/JSONFile.h"
 #include "../Scene/Node.h"
@@ -37,6 +38,8 @@ namespace Urho3D
 {
 
 class File;
+class LogicComponent;
+class NodeTemplate;
 class PackageFile;
 class Texture2D;
 
@@ -86,8 +89,60 @@ struct AsyncProgress
     unsigned totalNodes_;
 };
 
-/// Index of components in the Scene.
-using SceneComponentIndex = ea::hash_set<Component*>;
+/// Index of components in the Scene. Sparse set: components are kept in a dense array for linear iteration, lookup
+/// map provides constant time removal. Order is not preserved on removal.
+class URHO3D_API SceneComponentIndex
+{
+public:
+    /// Iterator over indexed components.
+    using const_iterator = ea::vector<Component*>::const_iterator;
+
+    /// Add component. Return false if already present.
+    bool insert(Component* component)
+    {
+        if (!indices_.emplace(component, components_.size()).second)
+            return false;
+        components_.push_back(component);
+        return true;
+    }
+
+    /// Remove component. Return false if not present.
+    bool erase(Component* component)
+    {
+        const auto iter = indices_.find(component);
+        if (iter == indices_.end())
+            return false;
+
+        const unsigned index = iter->second;
+        indices_.erase(iter);
+        if (index + 1 != components_.size())
+        {
+            components_[index] = components_.back();
+            indices_[components_[index]] = index;
+        }
+        components_.pop_back();
+        return true;
+    }
+
+    /// Return whether the component is indexed.
+    bool contains(Component* component) const { return indices_.contains(component); }
+    /// Return number of indexed components.
+    unsigned size() const { return components_.size(); }
+    /// Return whether the index is empty.
+    bool empty() const { return components_.empty(); }
+    /// Return begin iterator.
+    const_iterator begin() const { return components_.begin(); }
+    /// Return end iterator.
+    const_iterator end() const { return components_.end(); }
+    /// Return densely packed components.
+    const ea::vector<Component*>& GetComponents() const { return components_; }
+
+private:
+    /// Densely packed components.
+    ea::vector<Component*> components_;
+    /// Position of each component in the dense array.
+    ea::unordered_map<Component*, unsigned> indices_;
+};
 
 /// Root scene node, represents the whole scene.
 class URHO3D_API Scene : public Node
@@ -118,6 +173,13 @@ public:
     const SceneComponentIndex& GetComponentIndex(StringHash componentType);
     /// Return component index for template type. Invalidated when indexed component is added or removed!
     template <class T> const SceneComponentIndex& GetComponentIndex() { return GetComponentIndex(T::GetTypeStatic()); }
+    /// Invoke callback for every indexed component of template type, streaming over the packed index. Components must not be added or removed from the callback.
+    /// @nobind
+    template <class T, class Callback> void ForEach(Callback callback)
+    {
+        for (Component* component : GetComponentIndex(T::GetTypeStatic()).GetComponents())
+            callback(static_cast<T*>(component));
+    }
 
     /// Serialize from/to archive. Return true if successful.
     bool Serialize(Archive& archive) override;
@@ -152,6 +214,8 @@ public:
     bool SaveXML(Serializer& dest, const ea::string& indentation = "\t") const;
     /// Save to a JSON file. Return true if successful.
     bool SaveJSON(Serializer& dest, const ea::string& indentation = "\t") const;
+    /// Save to a binary file in the background. The scene is snapshot into memory immediately and the file is written on a worker thread. Return true if the snapshot succeeded.
+    bool SaveAsync(const ea::string& fileName) const;
     /// Load from a binary file asynchronously. Return true if started successfully. The LOAD_RESOURCES_ONLY mode can also be used to preload resources from object prefab files.
     bool LoadAsync(File* file, LoadMode mode = LOAD_SCENE_AND_RESOURCES);
     /// Load from an XML file asynchronously. Return true if started successfully. The LOAD_RESOURCES_ONLY mode can also be used to preload resources from object prefab files.
@@ -172,6 +236,8 @@ public:
         (const JSONValue& source, const Vector3& position, const Quaternion& rotation, CreateMode mode = REPLICATED);
     /// Instantiate scene content from JSON data. Return root node if successful.
     Node* InstantiateJSON(Deserializer& source, const Vector3& position, const Quaternion& rotation, CreateMode mode = REPLICATED);
+    /// Instantiate scene content from a captured node template without deserializing. Return root node if successful.
+    Node* Instantiate(const NodeTemplate& source, const Vector3& position, const Quaternion& rotation, CreateMode mode = REPLICATED);
 
     /// Clear scene completely of either replicated, local or all nodes and components.
     void Clear(bool clearReplicated = true, bool clearLocal = true);
@@ -193,6 +259,13 @@ public:
     /// Set maximum milliseconds per frame to spend on async scene loading.
     /// @property
     void SetAsyncLoadingMs(int ms);
+    /// Schedule callback to be called once after delay in seconds of scene time, with millisecond resolution.
+    /// Time scale applies and no time passes while scene update is disabled. Return handle for cancelling the call.
+    /// @nobind
+    TimerHandle ScheduleCall(float delay, TimerWheel::Callback callback);
+    /// Cancel scheduled call. Return false if it has already been called or cancelled.
+    /// @nobind
+    bool CancelCall(const TimerHandle& handle) { return scheduledCalls_.Cancel(handle); }
     /// Add a required package file for networking. To be called on the server.
     void AddRequiredPackageFile(PackageFile* package);
     /// Clear required package files.
@@ -215,6 +288,12 @@ public:
     Component* GetComponent(unsigned id) const;
     /// Get nodes with specific tag from the whole scene, return false if empty.
     bool GetNodesWithTag(ea::vector<Node*>& dest, const ea::string& tag)  const;
+    /// Get nodes with specific name from the whole scene, return false if empty.
+    bool GetNodesWithName(ea::vector<Node*>& dest, StringHash nameHash) const;
+    /// Return cached nodes with specific tag, or null if none. Used internally for subtree queries.
+    const ea::vector<Node*>* GetTaggedNodes(StringHash tag) const;
+    /// Return cached nodes with specific non-empty name, or null if none. Used internally for subtree queries.
+    const ea::vector<Node*>* GetNamedNodes(StringHash nameHash) const;
 
     /// Return whether updates are enabled.
     /// @property
@@ -275,6 +354,10 @@ public:
     void EndThreadedUpdate();
     /// Add a component to the delayed dirty notify queue. Is thread-safe.
     void DelayedMarkedDirty(Component* component);
+    /// Add a logic component to be updated from worker threads. Called by LogicComponent.
+    void AddThreadedUpdateComponent(LogicComponent* component);
+    /// Remove a logic component from threaded update. Called by LogicComponent.
+    void RemoveThreadedUpdateComponent(LogicComponent* component);
 
     /// Return threaded update flag.
     bool IsThreadedUpdate() const { return threadedUpdate_; }
@@ -290,6 +373,8 @@ public:
     void NodeTagAdded(Node* node, const ea::string& tag);
     /// Cache node by tag if tag not zero.
     void NodeTagRemoved(Node* node, const ea::string& tag);
+    /// Update node name cache. Used internally in Node::SetName.
+    void NodeNameChanged(Node* node, StringHash oldNameHash);
 
     /// Node added. Assign scene pointer and add to ID map.
     void NodeAdded(Node* node);
@@ -320,6 +405,8 @@ private:
     void HandleUpdate(StringHash eventType, VariantMap& eventData);
     /// Handle a background loaded resource completing.
     void HandleResourceBackgroundLoaded(StringHash eventType, VariantMap& eventData);
+    /// Update logic components that use threaded update in parallel.
+    void UpdateThreadedComponents(float timeStep);
     /// Update asynchronous loading.
     void UpdateAsyncLoading();
     /// Finish asynchronous loading.
@@ -354,6 +441,8 @@ private:
     ea::unordered_map<unsigned, Component*> localComponents_;
     /// Cached tagged nodes by tag.
     ea::unordered_map<StringHash, ea::vector<Node*> > taggedNodes_;
+    /// Cached nodes with non-empty names by name hash.
+    ea::unordered_map<StringHash, ea::vector<Node*> > namedNodes_;
     /// Asynchronous loading progress.
     AsyncProgress asyncProgress_;
     /// Node and component ID resolver for asynchronous loading.
@@ -370,6 +459,10 @@ private:
     ea::hash_set<unsigned> networkUpdateComponents_;
     /// Delayed dirty notification queue for components.
     ea::vector<Component*> delayedDirtyComponents_;
+    /// Logic components that use threaded update.
+    ea::hash_set<LogicComponent*> threadedUpdateComponents_;
+    /// Threaded update components with their top-level node, sorted to group components of the same hierarchy.
+    ea::vector<ea::pair<Node*, LogicComponent*> > threadedUpdateQueue_;
     /// Mutex for the delayed dirty notification queue.
     Mutex sceneMutex_;
     /// Preallocated event data map for smoothing update events.
@@ -390,6 +483,10 @@ private:
     float timeScale_;
     /// Elapsed time accumulator.
     float elapsedTime_;
+    /// Calls scheduled in scene time, one tick per millisecond.
+    TimerWheel scheduledCalls_;
+    /// Scene time in milliseconds not yet advanced on scheduled calls.
+    float scheduledCallsTime_{};
     /// Motion smoothing constant.
     float smoothingConstant_;
     /// Motion smoothing snap threshold.
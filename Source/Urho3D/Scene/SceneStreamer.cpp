@@ -0,0 +1,235 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Core/Profiler.h"
+#include "../Core/Timer.h"
+#include "../Core/WorkQueue.h"
+#include "../IO/File.h"
+#include "../IO/FileSystem.h"
+#include "../IO/Log.h"
+#include "../Resource/ResourceCache.h"
+#include "../Scene/Scene.h"
+#include "../Scene/SceneEvents.h"
+#include "../Scene/SceneResolver.h"
+#include "../Scene/SceneStreamer.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+extern const char* SCENE_CATEGORY;
+
+SceneStreamer::SceneStreamer(Context* context) :
+    Component(context)
+{
+}
+
+SceneStreamer::~SceneStreamer() = default;
+
+void SceneStreamer::RegisterObject(Context* context)
+{
+    context->RegisterFactory<SceneStreamer>(SCENE_CATEGORY);
+
+    URHO3D_ACCESSOR_ATTRIBUTE("Is Enabled", IsEnabled, SetEnabled, bool, true, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Cell Size", GetCellSize, SetCellSize, float, 100.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Load Distance", GetLoadDistance, SetLoadDistance, float, 200.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Unload Distance", GetUnloadDistance, SetUnloadDistance, float, 250.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Cell Prefix", GetCellPrefix, SetCellPrefix, ea::string, ea::string{"Cells/Cell_"}, AM_DEFAULT);
+}
+
+void SceneStreamer::SetFocusNode(Node* node)
+{
+    focusNode_ = node;
+}
+
+bool SceneStreamer::SaveCell(const ea::string& directory, const IntVector2& cell, Node* root) const
+{
+    if (!root)
+        return false;
+
+    const ea::string fileName = AddTrailingSlash(directory) + GetCellFileName(cell);
+    GetSubsystem<FileSystem>()->CreateDirsRecursive(GetPath(fileName));
+
+    File file(context_, fileName, FILE_WRITE);
+    if (!file.IsOpen() || !root->Save(file))
+    {
+        URHO3D_LOGERROR("Could not save scene cell " + fileName);
+        return false;
+    }
+    return true;
+}
+
+void SceneStreamer::UnloadAllCells()
+{
+    for (auto& item : cells_)
+    {
+        if (item.second.root_)
+            item.second.root_->Remove();
+    }
+    cells_.clear();
+}
+
+IntVector2 SceneStreamer::GetCell(const Vector3& position) const
+{
+    return { FloorToInt(position.x_ / cellSize_), FloorToInt(position.z_ / cellSize_) };
+}
+
+ea::string SceneStreamer::GetCellFileName(const IntVector2& cell) const
+{
+    return Format("{}{}_{}.bin", cellPrefix_, cell.x_, cell.y_);
+}
+
+bool SceneStreamer::IsCellLoaded(const IntVector2& cell) const
+{
+    const auto iter = cells_.find(cell);
+    return iter != cells_.end() && iter->second.root_;
+}
+
+void SceneStreamer::OnSceneSet(Scene* scene)
+{
+    if (scene)
+        SubscribeToEvent(scene, E_SCENEUPDATE, URHO3D_HANDLER(SceneStreamer, HandleSceneUpdate));
+    else
+    {
+        UnsubscribeFromEvent(E_SCENEUPDATE);
+        UnloadAllCells();
+    }
+}
+
+void SceneStreamer::HandleSceneUpdate(StringHash eventType, VariantMap& eventData)
+{
+    if (!IsEnabledEffective() || !focusNode_)
+        return;
+
+    URHO3D_PROFILE("UpdateSceneStreamer");
+
+    UpdateCells(focusNode_->GetWorldPosition());
+    InstantiateCells();
+}
+
+float SceneStreamer::GetCellDistanceSquared(const IntVector2& cell, const Vector3& position) const
+{
+    const float minX = cell.x_ * cellSize_;
+    const float minZ = cell.y_ * cellSize_;
+    const float dx = Max(Max(minX - position.x_, position.x_ - (minX + cellSize_)), 0.0f);
+    const float dz = Max(Max(minZ - position.z_, position.z_ - (minZ + cellSize_)), 0.0f);
+    return dx * dx + dz * dz;
+}
+
+void SceneStreamer::UpdateCells(const Vector3& position)
+{
+    // Unload cells that are too far, also dropping pending reads
+    const float unloadDistanceSquared = unloadDistance_ * unloadDistance_;
+    for (auto iter = cells_.begin(); iter != cells_.end();)
+    {
+        if (GetCellDistanceSquared(iter->first, position) > unloadDistanceSquared)
+        {
+            if (iter->second.root_)
+                iter->second.root_->Remove();
+            iter = cells_.erase(iter);
+        }
+        else
+            ++iter;
+    }
+
+    // Request cells within load distance
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    auto* cache = GetSubsystem<ResourceCache>();
+    const float loadDistanceSquared = loadDistance_ * loadDistance_;
+    const IntVector2 minCell = GetCell(position - Vector3(loadDistance_, 0.0f, loadDistance_));
+    const IntVector2 maxCell = GetCell(position + Vector3(loadDistance_, 0.0f, loadDistance_));
+    for (int z = minCell.y_; z <= maxCell.y_; ++z)
+    {
+        for (int x = minCell.x_; x <= maxCell.x_; ++x)
+        {
+            const IntVector2 cell{ x, z };
+            if (cells_.contains(cell) || GetCellDistanceSquared(cell, position) > loadDistanceSquared)
+                continue;
+
+            auto request = ea::make_shared<CellLoadRequest>();
+            cells_[cell].request_ = request;
+
+            const ea::string fileName = GetCellFileName(cell);
+            workQueue->AddWorkItem([cache, fileName, request]()
+            {
+                request->data_.SetName(fileName);
+                SharedPtr<File> file = cache->GetFile(fileName, false);
+                if (file)
+                {
+                    request->data_.SetData(*file, file->GetSize());
+                    request->success_ = request->data_.GetSize() == file->GetSize();
+                }
+                request->finished_.store(true, std::memory_order_release);
+            });
+        }
+    }
+}
+
+void SceneStreamer::InstantiateCells()
+{
+    auto* scene = GetScene();
+    HiresTimer loadTimer;
+    const long long budget = scene->GetAsyncLoadingMs() * 1000LL;
+
+    for (auto& item : cells_)
+    {
+        CellState& state = item.second;
+        if (!state.request_ || !state.request_->finished_.load(std::memory_order_acquire))
+            continue;
+
+        // Missing cell files are remembered as empty cells and not requested again until unloaded
+        if (state.request_->success_)
+            state.root_ = InstantiateCell(*state.request_);
+        state.request_ = nullptr;
+
+        if (loadTimer.GetUSec(false) >= budget)
+            break;
+    }
+}
+
+Node* SceneStreamer::InstantiateCell(CellLoadRequest& request)
+{
+    URHO3D_PROFILE("InstantiateSceneCell");
+
+    SceneResolver resolver;
+    VectorBuffer& source = request.data_;
+    const unsigned nodeID = source.ReadUInt();
+    // Rewrite IDs when merging into the running scene
+    Node* node = GetScene()->CreateChild(0, LOCAL);
+    resolver.AddNode(nodeID, node);
+    if (node->Load(source, resolver, true, true, LOCAL))
+    {
+        resolver.Resolve();
+        node->ApplyAttributes();
+        return node;
+    }
+
+    URHO3D_LOGERROR("Could not load scene cell " + request.data_.GetName());
+    node->Remove();
+    return nullptr;
+}
+
+}
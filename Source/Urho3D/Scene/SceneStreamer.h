@@ -0,0 +1,150 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include "../IO/VectorBuffer.h"
+#include "../Math/Vector2.h"
+#include "../Scene/Component.h"
+
+#include <EASTL/shared_ptr.h>
+#include <EASTL/unordered_map.h>
+
+#include <atomic>
+
+namespace Urho3D
+{
+
+/// Streams a grid of scene cells in and out around a focus node. Each cell is a separate binary node file, as written by
+/// SaveCell(). Cell files are read on worker threads; instantiation into the scene is spread over frames within the
+/// scene's asynchronous loading time budget. Node and component IDs of cells are rewritten on load, so cells merge
+/// into the running scene without conflicts. Cells are created as local nodes.
+class URHO3D_API SceneStreamer : public Component
+{
+    URHO3D_OBJECT(SceneStreamer, Component);
+
+public:
+    /// Construct.
+    explicit SceneStreamer(Context* context);
+    /// Destruct.
+    ~SceneStreamer() override;
+    /// Register object factory.
+    /// @nobind
+    static void RegisterObject(Context* context);
+
+    /// Set node around which cells are streamed.
+    /// @property
+    void SetFocusNode(Node* node);
+    /// Set cell size along X and Z axes.
+    /// @property
+    void SetCellSize(float size) { cellSize_ = Max(size, M_EPSILON); }
+    /// Set distance from the focus within which cells are loaded.
+    /// @property
+    void SetLoadDistance(float distance) { loadDistance_ = Max(distance, 0.0f); }
+    /// Set distance from the focus beyond which cells are unloaded. Should exceed the load distance to avoid thrashing.
+    /// @property
+    void SetUnloadDistance(float distance) { unloadDistance_ = Max(distance, 0.0f); }
+    /// Set resource name prefix of cell files. Cell X, Z is stored in "<prefix>X_Z.bin".
+    /// @property
+    void SetCellPrefix(const ea::string& prefix) { cellPrefix_ = prefix; }
+    /// Save node hierarchy as the file of the given cell. File name is relative to the given directory.
+    bool SaveCell(const ea::string& directory, const IntVector2& cell, Node* root) const;
+    /// Unload all cells.
+    void UnloadAllCells();
+
+    /// Return focus node.
+    /// @property
+    Node* GetFocusNode() const { return focusNode_; }
+    /// Return cell size.
+    /// @property
+    float GetCellSize() const { return cellSize_; }
+    /// Return load distance.
+    /// @property
+    float GetLoadDistance() const { return loadDistance_; }
+    /// Return unload distance.
+    /// @property
+    float GetUnloadDistance() const { return unloadDistance_; }
+    /// Return cell file prefix.
+    /// @property
+    const ea::string& GetCellPrefix() const { return cellPrefix_; }
+    /// Return cell containing the world position.
+    IntVector2 GetCell(const Vector3& position) const;
+    /// Return cell file resource name.
+    ea::string GetCellFileName(const IntVector2& cell) const;
+    /// Return whether the cell is instantiated into the scene.
+    bool IsCellLoaded(const IntVector2& cell) const;
+    /// Return number of cells being loaded or loaded.
+    unsigned GetNumCells() const { return cells_.size(); }
+
+protected:
+    /// Handle scene being assigned.
+    void OnSceneSet(Scene* scene) override;
+
+private:
+    /// Cell file read on a worker thread.
+    struct CellLoadRequest
+    {
+        /// File contents.
+        VectorBuffer data_;
+        /// Whether the file was read successfully.
+        bool success_{};
+        /// Whether the worker has finished.
+        std::atomic<bool> finished_{};
+    };
+
+    /// Streamed cell.
+    struct CellState
+    {
+        /// Pending file read. Null once instantiated.
+        ea::shared_ptr<CellLoadRequest> request_;
+        /// Instantiated cell root.
+        WeakPtr<Node> root_;
+    };
+
+    /// Handle scene update.
+    void HandleSceneUpdate(StringHash eventType, VariantMap& eventData);
+    /// Return squared distance from a position to the nearest point of a cell on the XZ plane.
+    float GetCellDistanceSquared(const IntVector2& cell, const Vector3& position) const;
+    /// Request and unload cells according to the focus position.
+    void UpdateCells(const Vector3& position);
+    /// Instantiate finished cells within the time budget.
+    void InstantiateCells();
+    /// Instantiate cell from file data. Return root node or null on failure.
+    Node* InstantiateCell(CellLoadRequest& request);
+
+    /// Focus node.
+    WeakPtr<Node> focusNode_;
+    /// Cell size.
+    float cellSize_{100.0f};
+    /// Load distance.
+    float loadDistance_{200.0f};
+    /// Unload distance.
+    float unloadDistance_{250.0f};
+    /// Cell file prefix.
+    ea::string cellPrefix_{"Cells/Cell_"};
+    /// Streamed cells.
+    ea::unordered_map<IntVector2, CellState> cells_;
+};
+
+}
@@ -29,6 +29,7 @@
 #include "../IO/FileSystem.h"
 #include "../IO/Log.h"
 #include "../IO/Serializer.h"
+#include "../IO/VectorBuffer.h"
 #include "../Resource/XMLElement.h"
 #include "../Resource/XMLFile.h"
 #include "../Resource/JSONFile.h"
@@ -47,6 +48,35 @@ namespace Urho3D
 
 static const unsigned MAX_STACK_ATTRIBUTE_COUNT = 128;
 
+/// Return size of a fixed-size attribute whose binary serialized form is identical to its in-memory layout, or zero.
+static unsigned GetRawAttributeSize(const AttributeInfo& attr)
+{
+    // Enums may be stored in narrower types and bools are normalized when serialized
+    if (attr.enumNames_)
+        return 0;
+
+    switch (attr.type_)
+    {
+    case VAR_INT: return sizeof(int);
+    case VAR_INT64: return sizeof(long long);
+    case VAR_FLOAT: return sizeof(float);
+    case VAR_DOUBLE: return sizeof(double);
+    case VAR_VECTOR2: return sizeof(Vector2);
+    case VAR_VECTOR3: return sizeof(Vector3);
+    case VAR_VECTOR4: return sizeof(Vector4);
+    case VAR_QUATERNION: return sizeof(Quaternion);
+    case VAR_COLOR: return sizeof(Color);
+    case VAR_RECT: return sizeof(Rect);
+    case VAR_INTRECT: return sizeof(IntRect);
+    case VAR_INTVECTOR2: return sizeof(IntVector2);
+    case VAR_INTVECTOR3: return sizeof(IntVector3);
+    case VAR_MATRIX3: return sizeof(Matrix3);
+    case VAR_MATRIX3X4: return sizeof(Matrix3x4);
+    case VAR_MATRIX4: return sizeof(Matrix4);
+    default: return 0;
+    }
+}
+
 static unsigned RemapAttributeIndex(const ea::vector<AttributeInfo>* attributes, const AttributeInfo& netAttr, unsigned netAttrIndex)
 {
     if (!attributes)
@@ -362,6 +392,23 @@ bool Serializable::Load(Deserializer& source)
             return false;
         }
 
+        // Fast path: read plain member values directly, bypassing Variant
+        if (!setInstanceDefault_ && attr.accessor_)
+        {
+            const unsigned rawSize = GetRawAttributeSize(attr);
+            if (void* rawValue = rawSize ? attr.accessor_->GetMutableValuePtr(this) : nullptr)
+            {
+                if (source.Read(rawValue, rawSize) != rawSize)
+                {
+                    URHO3D_LOGERROR("Could not load " + GetTypeName() + ", stream not open or at end");
+                    return false;
+                }
+                if (attr.mode_ & AM_NET)
+                    MarkNetworkUpdate();
+                continue;
+            }
+        }
+
         Variant varValue = source.ReadVariant(attr.type_, context_);
         OnSetAttribute(attr, varValue);
     }
@@ -383,6 +430,21 @@ bool Serializable::Save(Serializer& dest) const
         if (!attr.ShouldSave())
             continue;
 
+        // Fast path: write plain member values directly, bypassing Variant
+        if (attr.accessor_)
+        {
+            const unsigned rawSize = GetRawAttributeSize(attr);
+            if (const void* rawValue = rawSize ? attr.accessor_->GetValuePtr(this) : nullptr)
+            {
+                if (dest.Write(rawValue, rawSize) != rawSize)
+                {
+                    URHO3D_LOGERROR("Could not save " + GetTypeName() + ", writing to stream failed");
+                    return false;
+                }
+                continue;
+            }
+        }
+
         OnGetAttribute(attr, value);
 
         if (!dest.WriteVariantData(value))
@@ -1001,6 +1063,12 @@ void Serializable::AllocateNetworkState()
     }
 }
 
+void Serializable::RemoveReplicationState(ReplicationState* state)
+{
+    if (networkState_)
+        networkState_->replicationStates_.erase_first(state);
+}
+
 void Serializable::WriteInitialDeltaUpdate(Serializer& dest, unsigned char timeStamp)
 {
     if (!networkState_)
@@ -1049,16 +1117,26 @@ void Serializable::WriteDeltaUpdate(Serializer& dest, const DirtyBits& attribute
 
     unsigned numAttributes = attributes->size();
 
+    // Encode attribute data once per change and share it between all connections that need the same attributes
+    MutexLock<SpinLockMutex> lock(networkState_->encodeMutex_);
+    if (!networkState_->encodedDeltaValid_ || !(networkState_->encodedDeltaBits_ == attributeBits))
+    {
+        VectorBuffer buffer;
+        for (unsigned i = 0; i < numAttributes; ++i)
+        {
+            if (attributeBits.IsSet(i))
+                buffer.WriteVariantData(networkState_->currentValues_[i]);
+        }
+        networkState_->encodedDelta_ = buffer.GetBuffer();
+        networkState_->encodedDeltaBits_ = attributeBits;
+        networkState_->encodedDeltaValid_ = true;
+    }
+
     // First write the change bitfield, then attribute data for changed attributes
     // Note: the attribute bits should not contain LATESTDATA attributes
     dest.WriteUByte(timeStamp);
     dest.Write(attributeBits.data_, (numAttributes + 7) >> 3u);
-
-    for (unsigned i = 0; i < numAttributes; ++i)
-    {
-        if (attributeBits.IsSet(i))
-            dest.WriteVariantData(networkState_->currentValues_[i]);
-    }
+    dest.Write(networkState_->encodedDelta_.data(), networkState_->encodedDelta_.size());
 }
 
 void Serializable::WriteLatestDataUpdate(Serializer& dest, unsigned char timeStamp)
@@ -1075,13 +1153,21 @@ void Serializable::WriteLatestDataUpdate(Serializer& dest, unsigned char timeSta
 
     unsigned numAttributes = attributes->size();
 
-    dest.WriteUByte(timeStamp);
-
-    for (unsigned i = 0; i < numAttributes; ++i)
+    MutexLock<SpinLockMutex> lock(networkState_->encodeMutex_);
+    if (!networkState_->encodedLatestDataValid_)
     {
-        if (attributes->at(i).mode_ & AM_LATESTDATA)
-            dest.WriteVariantData(networkState_->currentValues_[i]);
+        VectorBuffer buffer;
+        for (unsigned i = 0; i < numAttributes; ++i)
+        {
+            if (attributes->at(i).mode_ & AM_LATESTDATA)
+                buffer.WriteVariantData(networkState_->currentValues_[i]);
+        }
+        networkState_->encodedLatestData_ = buffer.GetBuffer();
+        networkState_->encodedLatestDataValid_ = true;
     }
+
+    dest.WriteUByte(timeStamp);
+    dest.Write(networkState_->encodedLatestData_.data(), networkState_->encodedLatestData_.size());
 }
 
 bool Serializable::ReadDeltaUpdate(Deserializer& source)
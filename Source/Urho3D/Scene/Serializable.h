@@ -26,6 +26,7 @@
 #include "../Core/Object.h"
 
 #include <cstddef>
+#include <type_traits>
 
 namespace Urho3D
 {
@@ -119,6 +120,8 @@ public:
     void SetInterceptNetworkUpdate(const ea::string& attributeName, bool enable);
     /// Allocate network attribute state.
     void AllocateNetworkState();
+    /// Stop tracking the object in a replication state.
+    void RemoveReplicationState(ReplicationState* state);
     /// Write initial delta network update.
     void WriteInitialDeltaUpdate(Serializer& dest, unsigned char timeStamp);
     /// Write a delta network update according to dirty attribute bits.
@@ -209,13 +212,67 @@ SharedPtr<AttributeAccessor> MakeVariantAttributeAccessor(TGetFunction getFuncti
     return SharedPtr<AttributeAccessor>(new VariantAttributeAccessorImpl<TClassType, TGetFunction, TSetFunction>(getFunction, setFunction));
 }
 
+/// Template implementation of the member variable attribute accessor. Exposes the address of the member in addition to Variant access.
+template <class TClassType, class TAddressFunction, class TGetFunction, class TSetFunction>
+class MemberAttributeAccessorImpl : public VariantAttributeAccessorImpl<TClassType, TGetFunction, TSetFunction>
+{
+public:
+    /// Construct.
+    MemberAttributeAccessorImpl(TAddressFunction addressFunction, bool writable, TGetFunction getFunction, TSetFunction setFunction) :
+        VariantAttributeAccessorImpl<TClassType, TGetFunction, TSetFunction>(getFunction, setFunction),
+        addressFunction_(addressFunction),
+        writable_(writable)
+    {
+    }
+
+    /// Return address of the member.
+    const void* GetValuePtr(const Serializable* ptr) const override
+    {
+        assert(ptr);
+        return addressFunction_(*const_cast<TClassType*>(static_cast<const TClassType*>(ptr)));
+    }
+
+    /// Return address of the member if it may be written directly.
+    void* GetMutableValuePtr(Serializable* ptr) const override
+    {
+        assert(ptr);
+        return writable_ ? addressFunction_(*static_cast<TClassType*>(ptr)) : nullptr;
+    }
+
+private:
+    /// Address functor.
+    TAddressFunction addressFunction_;
+    /// Whether the member may be written directly.
+    bool writable_;
+};
+
+/// Make member attribute accessor implementation.
+/// \tparam TAddressFunction Functional object with call signature `void* addressFunction(TClassType& self)`, returning null if raw access is not possible.
+template <class TClassType, class TAddressFunction, class TGetFunction, class TSetFunction>
+SharedPtr<AttributeAccessor> MakeMemberAttributeAccessor(TAddressFunction addressFunction, bool writable, TGetFunction getFunction, TSetFunction setFunction)
+{
+    return SharedPtr<AttributeAccessor>(new MemberAttributeAccessorImpl<TClassType, TAddressFunction, TGetFunction, TSetFunction>(
+        addressFunction, writable, getFunction, setFunction));
+}
+
+/// Return address of a member attribute value if the member has exactly the attribute type, null otherwise.
+template <class TAttributeType, class TMemberType> void* GetMemberAttributeAddress(TMemberType& member)
+{
+    if constexpr (std::is_same_v<TAttributeType, TMemberType> && std::is_trivially_copyable_v<TMemberType>)
+        return &member;
+    else
+        return nullptr;
+}
+
 /// Make member attribute accessor.
-#define URHO3D_MAKE_MEMBER_ATTRIBUTE_ACCESSOR(typeName, variable) Urho3D::MakeVariantAttributeAccessor<ClassName>( \
+#define URHO3D_MAKE_MEMBER_ATTRIBUTE_ACCESSOR(typeName, variable) Urho3D::MakeMemberAttributeAccessor<ClassName>( \
+    [](ClassName& self) { return Urho3D::GetMemberAttributeAddress<typeName >(self.variable); }, true, \
     [](const ClassName& self, Urho3D::Variant& value) { value = self.variable; }, \
     [](ClassName& self, const Urho3D::Variant& value) { self.variable = value.Get<typeName>(); })
 
 /// Make member attribute accessor with custom post-set callback.
-#define URHO3D_MAKE_MEMBER_ATTRIBUTE_ACCESSOR_EX(typeName, variable, postSetCallback) Urho3D::MakeVariantAttributeAccessor<ClassName>( \
+#define URHO3D_MAKE_MEMBER_ATTRIBUTE_ACCESSOR_EX(typeName, variable, postSetCallback) Urho3D::MakeMemberAttributeAccessor<ClassName>( \
+    [](ClassName& self) { return Urho3D::GetMemberAttributeAddress<typeName >(self.variable); }, false, \
     [](const ClassName& self, Urho3D::Variant& value) { value = self.variable; }, \
     [](ClassName& self, const Urho3D::Variant& value) { self.variable = value.Get<typeName>(); self.postSetCallback(); })
 
@@ -23,14 +23,20 @@
 
 #include <EASTL/sort.h>
 
+#include "../Core/AllocationStats.h"
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
 #include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
 #include "../Engine/Engine.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Renderer.h"
 #include "../Graphics/GraphicsEvents.h"
+#include "../Graphics/View.h"
 #include "../IO/Log.h"
+#ifdef URHO3D_NETWORK
+#include "../Network/Network.h"
+#endif
 #include "../UI/UI.h"
 #include "../SystemUI/SystemUI.h"
 #include "../SystemUI/DebugHud.h"
@@ -176,6 +182,12 @@ void DebugHud::RenderUI(DebugHudModeFlags mode)
         ui::SetCursorPosX(left_offset);
         ui::Text("Occluders %u", renderer->GetNumOccluders(true));
         ui::SetCursorPosX(left_offset);
+        if (IsAllocationTrackingEnabled())
+        {
+            const AllocationStats allocations = GetFrameAllocationStats();
+            ui::Text("Allocations %llu (%.1f KB)", allocations.numAllocations_, allocations.allocatedBytes_ / 1024.0f);
+            ui::SetCursorPosX(left_offset);
+        }
 
         for (auto i = appStats_.begin(); i != appStats_.end(); ++i)
         {
@@ -184,6 +196,122 @@ void DebugHud::RenderUI(DebugHudModeFlags mode)
         }
     }
 
+#ifdef URHO3D_NETWORK
+    if (mode & DEBUGHUD_SHOW_NETWORK)
+    {
+        if (auto* network = GetSubsystem<Network>())
+        {
+            float left_offset = ui::GetCursorPos().x;
+
+            if (Connection* connection = network->GetServerConnection())
+            {
+                ui::Text("RTT %.1f ms", connection->GetRoundTripTime());
+                ui::SetCursorPosX(left_offset);
+                ui::Text("Data in %.1f KB/s out %.1f KB/s", connection->GetBytesInPerSec() / 1024.0f,
+                    connection->GetBytesOutPerSec() / 1024.0f);
+                ui::SetCursorPosX(left_offset);
+                ui::Text("Packets in %d out %d", connection->GetPacketsInPerSec(), connection->GetPacketsOutPerSec());
+                ui::SetCursorPosX(left_offset);
+            }
+
+            if (network->IsServerRunning())
+            {
+                const ea::vector<SharedPtr<Connection>> connections = network->GetClientConnections();
+                float bytesOut = 0.0f;
+                unsigned droppedPackets = 0;
+                for (Connection* connection : connections)
+                {
+                    bytesOut += connection->GetBytesOutPerSec();
+                    droppedPackets += connection->GetNumDroppedPackets();
+                }
+
+                ui::Text("Clients %u", connections.size());
+                ui::SetCursorPosX(left_offset);
+                ui::Text("Server data out %.1f KB/s", bytesOut / 1024.0f);
+                ui::SetCursorPosX(left_offset);
+                ui::Text("Server update %.2f ms", network->GetServerUpdateBuildTime() / 1000.0f);
+                ui::SetCursorPosX(left_offset);
+                ui::Text("Dropped packets %u", droppedPackets);
+                ui::SetCursorPosX(left_offset);
+            }
+        }
+    }
+#endif
+
+    if (mode & DEBUGHUD_SHOW_RENDER)
+    {
+        float left_offset = ui::GetCursorPos().x;
+
+        const DrawCallStatistics& frameStats = useRendererStats_ ? renderer->GetFrameStatistics() : graphics->GetFrameStatistics();
+        ui::Text("Draws %u (instanced %u, instances %u)", frameStats.numDraws_, frameStats.numInstancedDraws_,
+            frameStats.numInstances_);
+        ui::SetCursorPosX(left_offset);
+        ui::Text("Changes shader %u texture %u state %u", frameStats.numShaderChanges_, frameStats.numTextureChanges_,
+            frameStats.numStateChanges_);
+        ui::SetCursorPosX(left_offset);
+        ui::Text("Uploaded %.1f KB", frameStats.uploadedBytes_ / 1024.0f);
+        ui::SetCursorPosX(left_offset);
+
+        for (unsigned i = 0; i < renderer->GetNumViews(); ++i)
+        {
+            View* view = renderer->GetView(i);
+            if (!view)
+                continue;
+
+            const ViewStatistics& viewStats = view->GetStatistics();
+            const float occlusionEfficacy = viewStats.numOcclusionTested_
+                ? 100.0f * viewStats.numOcclusionCulled_ / viewStats.numOcclusionTested_ : 0.0f;
+
+            ui::Text("View %u: draws %u triangles %u", i, viewStats.drawCalls_.numDraws_, viewStats.drawCalls_.numPrimitives_);
+            ui::SetCursorPosX(left_offset);
+            ui::Text("  Frustum %u occluded %u/%u (%.0f%%) distance %u visible %u lights %u occluders %u",
+                viewStats.numFrustumDrawables_, viewStats.numOcclusionCulled_, viewStats.numOcclusionTested_,
+                occlusionEfficacy, viewStats.numDistanceCulled_, viewStats.numGeometries_, viewStats.numLights_,
+                viewStats.numOccluders_);
+            ui::SetCursorPosX(left_offset);
+            if (viewStats.shadowMaps_.numDraws_)
+            {
+                ui::Text("  ShadowMaps: draws %u shaders %u states %u", viewStats.shadowMaps_.numDraws_,
+                    viewStats.shadowMaps_.numShaderChanges_, viewStats.shadowMaps_.numStateChanges_);
+                ui::SetCursorPosX(left_offset);
+            }
+            for (const RenderPathCommandStatistics& command : viewStats.commands_)
+            {
+                if (!command.drawCalls_.numDraws_)
+                    continue;
+                ui::Text("  %s: draws %u (instanced %u) shaders %u textures %u states %u", command.name_.c_str(),
+                    command.drawCalls_.numDraws_, command.drawCalls_.numInstancedDraws_, command.drawCalls_.numShaderChanges_,
+                    command.drawCalls_.numTextureChanges_, command.drawCalls_.numStateChanges_);
+                ui::SetCursorPosX(left_offset);
+            }
+        }
+    }
+
+    if (mode & DEBUGHUD_SHOW_THREADS)
+    {
+        if (auto* workQueue = GetSubsystem<WorkQueue>())
+        {
+            float left_offset = ui::GetCursorPos().x;
+
+            const WorkQueueStatistics& queueStats = workQueue->GetStatistics();
+            ui::Text("WorkQueue depth %u completes %u non-threaded %u", queueStats.maxQueueDepth_,
+                queueStats.numCompletes_, queueStats.numNonThreadedItems_);
+            ui::SetCursorPosX(left_offset);
+            for (unsigned i = 0; i < queueStats.threads_.size(); ++i)
+            {
+                const WorkQueueThreadStatistics& threadStats = queueStats.threads_[i];
+                const float busyPercent = queueStats.frameUSec_ > 0 ? 100.0f * threadStats.busyUSec_ / queueStats.frameUSec_ : 0.0f;
+                if (i == 0)
+                    ui::Text("  Main: items %u busy %.2f ms wait %.2f ms", threadStats.numItems_,
+                        threadStats.busyUSec_ / 1000.0f, threadStats.idleUSec_ / 1000.0f);
+                else
+                    ui::Text("  Worker %u: items %u busy %.0f%% contention %.2f ms", i, threadStats.numItems_,
+                        busyPercent, threadStats.contentionUSec_ / 1000.0f);
+                ui::SetCursorPosX(left_offset);
+            }
+        }
+    }
+
     if (mode & DEBUGHUD_SHOW_MODE)
     {
         const ImGuiStyle& style = ui::GetStyle();
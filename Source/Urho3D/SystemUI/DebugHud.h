@@ -38,7 +38,10 @@ enum DebugHudMode : unsigned
     DEBUGHUD_SHOW_NONE = 0x0,
     DEBUGHUD_SHOW_STATS = 0x1,
     DEBUGHUD_SHOW_MODE = 0x2,
-    DEBUGHUD_SHOW_ALL = 0x7,
+    DEBUGHUD_SHOW_NETWORK = 0x4,
+    DEBUGHUD_SHOW_RENDER = 0x8,
+    DEBUGHUD_SHOW_THREADS = 0x10,
+    DEBUGHUD_SHOW_ALL = 0x1f,
 };
 URHO3D_FLAGSET(DebugHudMode, DebugHudModeFlags);
 
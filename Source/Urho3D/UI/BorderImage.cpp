@@ -27,6 +27,7 @@
 #include "../Graphics/Technique.h"
 #include "../Resource/ResourceCache.h"
 #include "../UI/BorderImage.h"
+#include "../UI/UI.h"
 
 #include "../DebugNew.h"
 
@@ -77,6 +78,7 @@ void BorderImage::GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& ve
 
 void BorderImage::SetTexture(Texture* texture)
 {
+    MarkBatchesDirty();
     texture_ = texture;
     if (imageRect_ == IntRect::ZERO)
         SetFullImageRect();
@@ -84,6 +86,7 @@ void BorderImage::SetTexture(Texture* texture)
 
 void BorderImage::SetImageRect(const IntRect& rect)
 {
+    MarkBatchesDirty();
     if (rect != IntRect::ZERO)
         imageRect_ = rect;
 }
@@ -96,6 +99,7 @@ void BorderImage::SetFullImageRect()
 
 void BorderImage::SetBorder(const IntRect& rect)
 {
+    MarkBatchesDirty();
     border_.left_ = Max(rect.left_, 0);
     border_.top_ = Max(rect.top_, 0);
     border_.right_ = Max(rect.right_, 0);
@@ -104,6 +108,7 @@ void BorderImage::SetBorder(const IntRect& rect)
 
 void BorderImage::SetImageBorder(const IntRect& rect)
 {
+    MarkBatchesDirty();
     imageBorder_.left_ = Max(rect.left_, 0);
     imageBorder_.top_ = Max(rect.top_, 0);
     imageBorder_.right_ = Max(rect.right_, 0);
@@ -112,31 +117,37 @@ void BorderImage::SetImageBorder(const IntRect& rect)
 
 void BorderImage::SetHoverOffset(const IntVector2& offset)
 {
+    MarkBatchesDirty();
     hoverOffset_ = offset;
 }
 
 void BorderImage::SetHoverOffset(int x, int y)
 {
+    MarkBatchesDirty();
     hoverOffset_ = IntVector2(x, y);
 }
 
 void BorderImage::SetDisabledOffset(const IntVector2& offset)
 {
+    MarkBatchesDirty();
     disabledOffset_ = offset;
 }
 
 void BorderImage::SetDisabledOffset(int x, int y)
 {
+    MarkBatchesDirty();
     disabledOffset_ = IntVector2(x, y);
 }
 
 void BorderImage::SetBlendMode(BlendMode mode)
 {
+    MarkBatchesDirty();
     blendMode_ = mode;
 }
 
 void BorderImage::SetTiled(bool enable)
 {
+    MarkBatchesDirty();
     tiled_ = enable;
 }
 
@@ -153,6 +164,8 @@ void BorderImage::GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& ve
 
     if (material_)
         batch.customMaterial_ = material_;
+    else if (UI* ui = GetSubsystem<UI>())
+        batch.SetTextureAtlas(ui->GetTextureAtlas(), IntRect(imageRect_.Min() + offset, imageRect_.Max() + offset));
 
     // Calculate size of the inner rect, and texture dimensions of the inner rect
     const IntRect& uvBorder = (imageBorder_ == IntRect::ZERO) ? border_ : imageBorder_;
@@ -241,6 +254,7 @@ ResourceRef BorderImage::GetMaterialAttr() const
 
 void BorderImage::SetMaterial(Material* material)
 {
+    MarkBatchesDirty();
     material_ = material;
 }
 
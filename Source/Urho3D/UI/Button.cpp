@@ -192,6 +192,7 @@ void Button::SetRepeatRate(float rate)
 
 void Button::SetPressed(bool enable)
 {
+    MarkBatchesDirty();
     pressed_ = enable;
     SetChildOffset(pressed_ ? pressedChildOffset_ : IntVector2::ZERO);
 }
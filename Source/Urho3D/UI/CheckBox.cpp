@@ -93,6 +93,7 @@ void CheckBox::SetChecked(bool enable)
     if (enable != checked_)
     {
         checked_ = enable;
+        MarkBatchesDirty();
 
         using namespace Toggled;
 
@@ -105,11 +106,13 @@ void CheckBox::SetChecked(bool enable)
 
 void CheckBox::SetCheckedOffset(const IntVector2& offset)
 {
+    MarkBatchesDirty();
     checkedOffset_ = offset;
 }
 
 void CheckBox::SetCheckedOffset(int x, int y)
 {
+    MarkBatchesDirty();
     checkedOffset_ = IntVector2(x, y);
 }
 
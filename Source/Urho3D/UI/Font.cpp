@@ -57,7 +57,9 @@ Font::Font(Context* context) :
     absoluteOffset_(IntVector2::ZERO),
     scaledOffset_(Vector2::ZERO),
     fontType_(FONT_NONE),
-    sdfFont_(false)
+    sdfFont_(false),
+    sdfPointSize_(DEFAULT_SDF_POINT_SIZE),
+    sdfSpread_(0)
 {
 }
 
@@ -97,6 +99,9 @@ bool Font::BeginLoad(Deserializer& source)
     }
 
     ea::string ext = GetExtension(GetName());
+    sdfFont_ = ext == ".sdf";
+    sdfSpread_ = 0;
+
     if (ext == ".ttf" || ext == ".otf" || ext == ".woff")
     {
         fontType_ = FONT_FREETYPE;
@@ -105,8 +110,6 @@ bool Font::BeginLoad(Deserializer& source)
     else if (ext == ".xml" || ext == ".fnt" || ext == ".sdf")
         fontType_ = FONT_BITMAP;
 
-    sdfFont_ = ext == ".sdf";
-
     SetMemoryUse(fontDataSize_);
     return true;
 }
@@ -146,6 +149,9 @@ FontFace* Font::GetFace(float pointSize)
     // For bitmap font type, always return the same font face provided by the font's bitmap file regardless of the actual requested point size
     if (fontType_ == FONT_BITMAP)
         pointSize = 0;
+    // Signed distance field generated from outlines is resolution independent, so one face serves all sizes
+    else if (sdfSpread_ > 0)
+        pointSize = sdfPointSize_;
     else
         pointSize = Clamp(pointSize, MIN_POINT_SIZE, MAX_POINT_SIZE);
 
@@ -218,6 +224,15 @@ void Font::LoadParameters()
         scaledOffset_.x_ = scaledElem.GetFloat("x");
         scaledOffset_.y_ = scaledElem.GetFloat("y");
     }
+
+    XMLElement sdfElem = rootElem.GetChild("sdf");
+    if (sdfElem)
+    {
+        sdfFont_ = true;
+        sdfPointSize_ = sdfElem.HasAttribute("pointsize") ? sdfElem.GetFloat("pointsize") : DEFAULT_SDF_POINT_SIZE;
+        sdfPointSize_ = Clamp(sdfPointSize_, MIN_POINT_SIZE, MAX_POINT_SIZE);
+        sdfSpread_ = Max(sdfElem.HasAttribute("spread") ? sdfElem.GetInt("spread") : DEFAULT_SDF_SPREAD, 1);
+    }
 }
 
 FontFace* Font::GetFaceFreeType(float pointSize)
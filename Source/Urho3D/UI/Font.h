@@ -35,6 +35,8 @@ class FontFace;
 
 static const int FONT_TEXTURE_MIN_SIZE = 128;
 static const int FONT_DPI = 96;
+static const float DEFAULT_SDF_POINT_SIZE = 32.0f;
+static const int DEFAULT_SDF_SPREAD = 4;
 
 /// %Font file type.
 enum FontType
@@ -80,6 +82,12 @@ public:
     /// Is signed distance field font.
     bool IsSDFFont() const { return sdfFont_; }
 
+    /// Return point size at which the signed distance field is generated for FreeType fonts. All requested sizes share this face.
+    float GetSDFPointSize() const { return sdfPointSize_; }
+
+    /// Return distance in pixels covered by the generated signed distance field. Zero if not generated from an outline font.
+    int GetSDFSpread() const { return sdfSpread_; }
+
     /// Return absolute position adjustment for glyphs.
     /// @property
     const IntVector2& GetAbsoluteGlyphOffset() const { return absoluteOffset_; }
@@ -116,6 +124,10 @@ private:
     FontType fontType_;
     /// Signed distance field font flag.
     bool sdfFont_;
+    /// Point size of the signed distance field face generated from FreeType outlines.
+    float sdfPointSize_;
+    /// Spread in pixels of the signed distance field generated from FreeType outlines.
+    int sdfSpread_;
 };
 
 }
@@ -23,6 +23,8 @@
 #include "../Precompiled.h"
 
 #include "../Core/Context.h"
+#include "../Core/Thread.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Texture2D.h"
 #include "../IO/FileSystem.h"
@@ -44,6 +46,11 @@
 namespace Urho3D
 {
 
+/// Number of glyphs rendered at once while loading a font face.
+static const unsigned FONT_GLYPH_RENDER_CHUNK_SIZE = 1024;
+/// Number of glyphs rendered by one worker thread task.
+static const unsigned FONT_GLYPH_RENDER_BATCH_SIZE = 32;
+
 inline float FixedToFloat(FT_Pos value)
 {
     return value / 64.0f;
@@ -109,7 +116,9 @@ bool FontFaceFreeType::Load(const unsigned char* fontData, unsigned fontDataSize
     const FontHintLevel hintLevel = ui->GetFontHintLevel();
     const float subpixelThreshold = ui->GetFontSubpixelThreshold();
 
-    subpixel_ = (hintLevel <= FONT_HINT_LEVEL_LIGHT) && (pointSize <= subpixelThreshold);
+    // Distance fields are scaled when rendered, so subpixel positioning does not apply
+    sdfSpread_ = font_->GetSDFSpread();
+    subpixel_ = !sdfSpread_ && (hintLevel <= FONT_HINT_LEVEL_LIGHT) && (pointSize <= subpixelThreshold);
     oversampling_ = subpixel_ ? ui->GetFontOversampling() : 1;
 
     if (pointSize <= 0)
@@ -188,23 +197,22 @@ bool FontFaceFreeType::Load(const unsigned char* fontData, unsigned fontDataSize
     allocator_.Reset(FONT_TEXTURE_MIN_SIZE, FONT_TEXTURE_MIN_SIZE, textureWidth, textureHeight);
 
     ea::unordered_map<FT_UInt, FT_ULong> charCodes;
+    ea::vector<unsigned> charCodeList;
     FT_UInt glyphIndex;
     FT_ULong charCode = FT_Get_First_Char(face, &glyphIndex);
 
     while (glyphIndex != 0)
     {
-        if (!LoadCharGlyph(charCode, image))
-        {
-            hasMutableGlyph_ = true;
-            break;
-        }
-
         // TODO: FT_Get_Next_Char can return same glyphIndex for different charCode
         charCodes[glyphIndex] = charCode;
+        charCodeList.push_back((unsigned)charCode);
 
         charCode = FT_Get_Next_Char(face, charCode, &glyphIndex);
     }
 
+    if (!LoadCharGlyphs(charCodeList, fontData, fontDataSize, image))
+        hasMutableGlyph_ = true;
+
     SharedPtr<Texture2D> texture = LoadFaceTexture(image);
     if (!texture)
         return false;
@@ -334,7 +342,7 @@ bool FontFaceFreeType::SetupNextTexture(int textureWidth, int textureHeight)
     return true;
 }
 
-void FontFaceFreeType::BoxFilter(unsigned char* dest, size_t destSize, const unsigned char* src, size_t srcSize)
+void FontFaceFreeType::BoxFilter(unsigned char* dest, size_t destSize, const unsigned char* src, size_t srcSize) const
 {
     const int filterSize = oversampling_;
 
@@ -398,14 +406,105 @@ bool FontFaceFreeType::LoadCharGlyph(unsigned charCode, Image* image)
     if (!face_)
         return false;
 
-    auto face = (FT_Face)face_;
-    FT_GlyphSlot slot = face->glyph;
-
     FontGlyph fontGlyph;
-    FT_Error error = FT_Load_Char(face, charCode, loadMode_ | FT_LOAD_RENDER);
+    ea::vector<unsigned char> bitmap;
+    RenderCharGlyph(face_, charCode, fontGlyph, bitmap);
+    return PlaceCharGlyph(charCode, fontGlyph, bitmap, image);
+}
+
+bool FontFaceFreeType::LoadCharGlyphs(const ea::vector<unsigned>& charCodes, const unsigned char* fontData,
+    unsigned fontDataSize, Image* image)
+{
+    auto* workQueue = font_->GetSubsystem<WorkQueue>();
+    const bool threaded = workQueue && workQueue->GetNumThreads() > 0 && Thread::IsMainThread()
+        && charCodes.size() > FONT_GLYPH_RENDER_BATCH_SIZE;
+
+    // FreeType faces may be used from different threads, but each face only from one thread at a time.
+    // The main thread uses the primary face, worker threads create their own on demand.
+    ea::vector<FT_Face> threadFaces(threaded ? workQueue->GetNumThreads() + 1 : 1);
+    threadFaces[0] = (FT_Face)face_;
+    Mutex faceMutex;
+
+    FT_Library library = freeType_->GetLibrary();
+    const auto charSize = (FT_F26Dot6)(pointSize_ * 64);
+
+    ea::vector<FontGlyph> glyphs;
+    ea::vector<ea::vector<unsigned char>> bitmaps;
+    ea::vector<unsigned char> rendered;
+
+    // Render in chunks so that little work is wasted once the image is full
+    bool allPlaced = true;
+    for (unsigned chunkBegin = 0; chunkBegin < charCodes.size() && allPlaced; chunkBegin += FONT_GLYPH_RENDER_CHUNK_SIZE)
+    {
+        const unsigned chunkSize = Min(FONT_GLYPH_RENDER_CHUNK_SIZE, charCodes.size() - chunkBegin);
+        glyphs.assign(chunkSize, FontGlyph{});
+        bitmaps.clear();
+        bitmaps.resize(chunkSize);
+        rendered.assign(chunkSize, 0);
+
+        const auto renderGlyphs = [&](unsigned begin, unsigned end, unsigned threadIndex)
+        {
+            FT_Face& face = threadFaces[threadIndex];
+            if (!face)
+            {
+                MutexLock<Mutex> lock(faceMutex);
+                if (FT_New_Memory_Face(library, fontData, fontDataSize, 0, &face))
+                    face = nullptr;
+                else if (FT_Set_Char_Size(face, 0, charSize, oversampling_ * FONT_DPI, FONT_DPI))
+                {
+                    FT_Done_Face(face);
+                    face = nullptr;
+                }
+            }
+
+            // Glyphs not rendered here are rendered by the main thread below
+            if (!face)
+                return;
+
+            for (unsigned i = begin; i < end; ++i)
+            {
+                RenderCharGlyph(face, charCodes[chunkBegin + i], glyphs[i], bitmaps[i]);
+                rendered[i] = 1;
+            }
+        };
+
+        if (threaded)
+            workQueue->ParallelFor(chunkSize, FONT_GLYPH_RENDER_BATCH_SIZE, renderGlyphs);
+        else
+            renderGlyphs(0, chunkSize, 0);
+
+        for (unsigned i = 0; i < chunkSize; ++i)
+        {
+            const unsigned charCode = charCodes[chunkBegin + i];
+            if (!rendered[i])
+                RenderCharGlyph(face_, charCode, glyphs[i], bitmaps[i]);
+
+            if (!PlaceCharGlyph(charCode, glyphs[i], bitmaps[i], image))
+            {
+                allPlaced = false;
+                break;
+            }
+        }
+    }
+
+    for (unsigned i = 1; i < threadFaces.size(); ++i)
+    {
+        if (threadFaces[i])
+            FT_Done_Face(threadFaces[i]);
+    }
+
+    return allPlaced;
+}
+
+void FontFaceFreeType::RenderCharGlyph(void* face, unsigned charCode, FontGlyph& fontGlyph, ea::vector<unsigned char>& bitmap) const
+{
+    auto ftFace = (FT_Face)face;
+    FT_GlyphSlot slot = ftFace->glyph;
+
+    FT_Error error = FT_Load_Char(ftFace, charCode, loadMode_ | FT_LOAD_RENDER);
     if (error)
     {
-        const char* family = face->family_name ? face->family_name : "NULL";
+        const char* family = ftFace->family_name ? ftFace->family_name : "NULL";
         URHO3D_LOGERRORF("FT_Load_Char failed (family: %s, char code: %u)", family, charCode);
         fontGlyph.texWidth_ = 0;
         fontGlyph.texHeight_ = 0;
@@ -415,33 +514,127 @@ bool FontFaceFreeType::LoadCharGlyph(unsigned charCode, Image* image)
         fontGlyph.offsetY_ = 0;
         fontGlyph.advanceX_ = 0;
         fontGlyph.page_ = 0;
+        bitmap.clear();
+        return;
+    }
+
+    // Note: position within texture will be filled later
+    fontGlyph.texWidth_ = slot->bitmap.width + oversampling_ - 1;
+    fontGlyph.texHeight_ = slot->bitmap.rows;
+    fontGlyph.width_ = slot->bitmap.width + oversampling_ - 1;
+    fontGlyph.height_ = slot->bitmap.rows;
+    fontGlyph.offsetX_ = slot->bitmap_left - (oversampling_ - 1) / 2.0f;
+    fontGlyph.offsetY_ = floorf(ascender_ + 0.5f) - slot->bitmap_top;
+
+    if (subpixel_ && slot->linearHoriAdvance)
+    {
+        // linearHoriAdvance is stored in 16.16 fixed point, not the usual 26.6
+        fontGlyph.advanceX_ = slot->linearHoriAdvance / 65536.0;
     }
     else
     {
-        // Note: position within texture will be filled later
-        fontGlyph.texWidth_ = slot->bitmap.width + oversampling_ - 1;
-        fontGlyph.texHeight_ = slot->bitmap.rows;
-        fontGlyph.width_ = slot->bitmap.width + oversampling_ - 1;
-        fontGlyph.height_ = slot->bitmap.rows;
-        fontGlyph.offsetX_ = slot->bitmap_left - (oversampling_ - 1) / 2.0f;
-        fontGlyph.offsetY_ = floorf(ascender_ + 0.5f) - slot->bitmap_top;
+        // Round to nearest pixel (only necessary when hinting is disabled)
+        fontGlyph.advanceX_ = floorf(FixedToFloat(slot->metrics.horiAdvance) + 0.5f);
+    }
+
+    fontGlyph.width_ /= oversampling_;
+    fontGlyph.offsetX_ /= oversampling_;
+    fontGlyph.advanceX_ /= oversampling_;
+
+    if (fontGlyph.texWidth_ <= 0 || fontGlyph.texHeight_ <= 0)
+    {
+        bitmap.clear();
+        return;
+    }
+
+    const auto pitch = (unsigned)fontGlyph.texWidth_;
+    bitmap.assign(pitch * fontGlyph.texHeight_, 0);
+    unsigned char* dest = bitmap.data();
 
-        if (subpixel_ && slot->linearHoriAdvance)
+    if (slot->bitmap.pixel_mode == FT_PIXEL_MODE_MONO)
+    {
+        for (unsigned y = 0; y < (unsigned)slot->bitmap.rows; ++y)
         {
-            // linearHoriAdvance is stored in 16.16 fixed point, not the usual 26.6
-            fontGlyph.advanceX_ = slot->linearHoriAdvance / 65536.0;
+            unsigned char* src = slot->bitmap.buffer + slot->bitmap.pitch * y;
+            unsigned char* rowDest = dest + (oversampling_ - 1)/2 + y * pitch;
+
+            // Don't do any oversampling, just unpack the bits directly.
+            for (unsigned x = 0; x < (unsigned)slot->bitmap.width; ++x)
+                rowDest[x] = (unsigned char)((src[x >> 3u] & (0x80u >> (x & 7u))) ? 255 : 0);
         }
-        else
+    }
+    else
+    {
+        for (unsigned y = 0; y < (unsigned)slot->bitmap.rows; ++y)
         {
-            // Round to nearest pixel (only necessary when hinting is disabled)
-            fontGlyph.advanceX_ = floorf(FixedToFloat(slot->metrics.horiAdvance) + 0.5f);
+            unsigned char* src = slot->bitmap.buffer + slot->bitmap.pitch * y;
+            unsigned char* rowDest = dest + y * pitch;
+            BoxFilter(rowDest, fontGlyph.texWidth_, src, slot->bitmap.width);
         }
+    }
+
+    if (sdfSpread_ > 0)
+        ConvertToDistanceField(fontGlyph, bitmap);
+}
+
+void FontFaceFreeType::ConvertToDistanceField(FontGlyph& fontGlyph, ea::vector<unsigned char>& bitmap) const
+{
+    const int spread = sdfSpread_;
+    const int width = fontGlyph.texWidth_;
+    const int height = fontGlyph.texHeight_;
+    const int sdfWidth = width + 2 * spread;
+    const int sdfHeight = height + 2 * spread;
+
+    // Threshold coverage into an inside mask with a border of the spread size so that the search needs no bounds checks
+    const int maskWidth = sdfWidth + 2 * spread;
+    const int maskHeight = sdfHeight + 2 * spread;
+    ea::vector<unsigned char> mask((size_t)maskWidth * maskHeight, 0);
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+            mask[(y + 2 * spread) * maskWidth + x + 2 * spread] = bitmap[y * width + x] >= 128 ? 1 : 0;
+    }
+
+    // Brute force search of the nearest texel of opposite state within the spread
+    ea::vector<unsigned char> sdf((size_t)sdfWidth * sdfHeight);
+    const int maxDistanceSquared = spread * spread;
+    for (int y = 0; y < sdfHeight; ++y)
+    {
+        for (int x = 0; x < sdfWidth; ++x)
+        {
+            const unsigned char* center = &mask[(y + spread) * maskWidth + x + spread];
+            const unsigned char inside = *center;
+
+            int bestDistanceSquared = maxDistanceSquared + 1;
+            for (int dy = -spread; dy <= spread; ++dy)
+            {
+                const unsigned char* row = center + dy * maskWidth;
+                for (int dx = -spread; dx <= spread; ++dx)
+                {
+                    if (row[dx] != inside)
+                        bestDistanceSquared = Min(bestDistanceSquared, dx * dx + dy * dy);
+                }
+            }
 
-        fontGlyph.width_ /= oversampling_;
-        fontGlyph.offsetX_ /= oversampling_;
-        fontGlyph.advanceX_ /= oversampling_;
+            // The edge lies halfway between the texel centers
+            const float distance = Min(sqrtf((float)bestDistanceSquared), (float)spread) - 0.5f;
+            const float signedDistance = inside ? distance : -distance;
+            const float value = Clamp(0.5f + 0.5f * signedDistance / spread, 0.0f, 1.0f);
+            sdf[y * sdfWidth + x] = (unsigned char)(value * 255.0f + 0.5f);
+        }
     }
 
+    bitmap = ea::move(sdf);
+    fontGlyph.texWidth_ = (short)sdfWidth;
+    fontGlyph.texHeight_ = (short)sdfHeight;
+    fontGlyph.width_ += 2 * spread;
+    fontGlyph.height_ += 2 * spread;
+    fontGlyph.offsetX_ -= spread;
+    fontGlyph.offsetY_ -= spread;
+}
+
+bool FontFaceFreeType::PlaceCharGlyph(unsigned charCode, FontGlyph& fontGlyph, const ea::vector<unsigned char>& bitmap, Image* image)
+{
     int x = 0, y = 0;
     if (fontGlyph.texWidth_ > 0 && fontGlyph.texHeight_ > 0)
     {
@@ -471,47 +664,18 @@ bool FontFaceFreeType::LoadCharGlyph(unsigned charCode, Image* image)
         fontGlyph.x_ = (short)x;
         fontGlyph.y_ = (short)y;
 
-        unsigned char* dest = nullptr;
-        unsigned pitch = 0;
         if (image)
         {
             fontGlyph.page_ = 0;
-            dest = image->GetData() + fontGlyph.y_ * image->GetWidth() + fontGlyph.x_;
-            pitch = (unsigned)image->GetWidth();
+            const auto imageWidth = (unsigned)image->GetWidth();
+            unsigned char* dest = image->GetData() + fontGlyph.y_ * imageWidth + fontGlyph.x_;
+            for (int row = 0; row < fontGlyph.texHeight_; ++row)
+                memcpy(dest + row * imageWidth, bitmap.data() + row * fontGlyph.texWidth_, (size_t)fontGlyph.texWidth_);
         }
         else
         {
             fontGlyph.page_ = textures_.size() - 1;
-            dest = new unsigned char[fontGlyph.texWidth_ * fontGlyph.texHeight_];
-            pitch = (unsigned)fontGlyph.texWidth_;
-        }
-
-        if (slot->bitmap.pixel_mode == FT_PIXEL_MODE_MONO)
-        {
-            for (unsigned y = 0; y < (unsigned)slot->bitmap.rows; ++y)
-            {
-                unsigned char* src = slot->bitmap.buffer + slot->bitmap.pitch * y;
-                unsigned char* rowDest = dest + (oversampling_ - 1)/2 + y * pitch;
-
-                // Don't do any oversampling, just unpack the bits directly.
-                for (unsigned x = 0; x < (unsigned)slot->bitmap.width; ++x)
-                    rowDest[x] = (unsigned char)((src[x >> 3u] & (0x80u >> (x & 7u))) ? 255 : 0);
-            }
-        }
-        else
-        {
-            for (unsigned y = 0; y < (unsigned)slot->bitmap.rows; ++y)
-            {
-                unsigned char* src = slot->bitmap.buffer + slot->bitmap.pitch * y;
-                unsigned char* rowDest = dest + y * pitch;
-                BoxFilter(rowDest, fontGlyph.texWidth_, src, slot->bitmap.width);
-            }
-        }
-
-        if (!image)
-        {
-            textures_.back()->SetData(0, fontGlyph.x_, fontGlyph.y_, fontGlyph.texWidth_, fontGlyph.texHeight_, dest);
-            delete[] dest;
+            textures_.back()->SetData(0, fontGlyph.x_, fontGlyph.y_, fontGlyph.texWidth_, fontGlyph.texHeight_, bitmap.data());
         }
     }
     else
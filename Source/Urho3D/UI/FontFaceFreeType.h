@@ -52,8 +52,16 @@ private:
     bool SetupNextTexture(int textureWidth, int textureHeight);
     /// Load char glyph.
     bool LoadCharGlyph(unsigned charCode, Image* image = nullptr);
+    /// Rasterize char glyph into a tightly packed bitmap. Does not modify the font face, so different FreeType faces may be used from different threads.
+    void RenderCharGlyph(void* face, unsigned charCode, FontGlyph& fontGlyph, ea::vector<unsigned char>& bitmap) const;
+    /// Allocate space for a rasterized glyph and copy it into the image or the current texture. Return false if out of room in the image.
+    bool PlaceCharGlyph(unsigned charCode, FontGlyph& fontGlyph, const ea::vector<unsigned char>& bitmap, Image* image);
+    /// Rasterize glyphs of char codes on worker threads and place them into the image in order until it is full. Return false if some glyphs did not fit.
+    bool LoadCharGlyphs(const ea::vector<unsigned>& charCodes, const unsigned char* fontData, unsigned fontDataSize, Image* image);
+    /// Replace glyph coverage bitmap with a signed distance field padded by the spread on each side.
+    void ConvertToDistanceField(FontGlyph& fontGlyph, ea::vector<unsigned char>& bitmap) const;
     /// Smooth one row of a horizontally oversampled glyph image.
-    void BoxFilter(unsigned char* dest, size_t destSize, const unsigned char* src, size_t srcSize);
+    void BoxFilter(unsigned char* dest, size_t destSize, const unsigned char* src, size_t srcSize) const;
 
     /// FreeType library.
     SharedPtr<FreeTypeLibrary> freeType_;
@@ -67,6 +75,8 @@ private:
     int oversampling_{};
     /// Ascender.
     float ascender_{};
+    /// Signed distance field spread in pixels, zero if rendering plain coverage.
+    int sdfSpread_{};
     /// Has mutable glyph.
     bool hasMutableGlyph_{};
     /// Glyph area allocator.
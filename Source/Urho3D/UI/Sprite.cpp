@@ -27,6 +27,7 @@
 #include "../Graphics/Technique.h"
 #include "../Resource/ResourceCache.h"
 #include "../UI/Sprite.h"
+#include "../UI/UI.h"
 
 #include "../DebugNew.h"
 
@@ -117,6 +118,8 @@ void Sprite::GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexD
     const IntVector2& size = GetSize();
     UIBatch
         batch(this, blendMode_ == BLEND_REPLACE && !allOpaque ? BLEND_ALPHA : blendMode_, currentScissor, texture_, &vertexData);
+    if (UI* ui = GetSubsystem<UI>())
+        batch.SetTextureAtlas(ui->GetTextureAtlas(), imageRect_);
 
     batch.AddQuad(GetTransform(), 0, 0, size.x_, size.y_, imageRect_.left_, imageRect_.top_, imageRect_.right_ - imageRect_.left_,
         imageRect_.bottom_ - imageRect_.top_);
@@ -193,6 +196,7 @@ void Sprite::SetRotation(float angle)
 
 void Sprite::SetTexture(Texture* texture)
 {
+    MarkBatchesDirty();
     texture_ = texture;
     if (imageRect_ == IntRect::ZERO)
         SetFullImageRect();
@@ -200,6 +204,7 @@ void Sprite::SetTexture(Texture* texture)
 
 void Sprite::SetImageRect(const IntRect& rect)
 {
+    MarkBatchesDirty();
     if (rect != IntRect::ZERO)
         imageRect_ = rect;
 }
@@ -212,6 +217,7 @@ void Sprite::SetFullImageRect()
 
 void Sprite::SetBlendMode(BlendMode mode)
 {
+    MarkBatchesDirty();
     blendMode_ = mode;
 }
 
@@ -59,6 +59,10 @@ Text::Text(Context* context) :
     wordWrap_(false),
     autoLocalizable_(false),
     charLocationsDirty_(true),
+    layoutWrapWidth_(-1),
+    layoutRowSpacing_(0.0f),
+    layoutValidLength_(0),
+    layoutTextLength_(0),
     selectionStart_(0),
     selectionLength_(0),
     textEffect_(TE_NONE),
@@ -285,9 +289,29 @@ bool Text::SetFontSize(float size)
 
 void Text::DecodeToUnicode()
 {
-    unicodeText_.clear();
+    ea::vector<unsigned> unicodeText;
+    unicodeText.reserve(text_.length());
     for (unsigned i = 0; i < text_.length();)
-        unicodeText_.push_back(NextUTF8Char(text_, i));
+        unicodeText.push_back(NextUTF8Char(text_, i));
+
+    // Remember how much of the previous text stays the same, so that its layout can be reused
+    const unsigned commonLength = Min(unicodeText.size(), unicodeText_.size());
+    unsigned unchangedLength = 0;
+    while (unchangedLength < commonLength && unicodeText[unchangedLength] == unicodeText_[unchangedLength])
+        ++unchangedLength;
+    layoutValidLength_ = Min(layoutValidLength_, unchangedLength);
+
+    unicodeText_.swap(unicodeText);
+}
+
+void Text::InvalidateTextLayout()
+{
+    rowWidths_.clear();
+    printText_.clear();
+    printToText_.clear();
+    layoutFace_ = nullptr;
+    layoutValidLength_ = 0;
+    layoutTextLength_ = 0;
 }
 
 void Text::SetText(const ea::string& text)
@@ -370,6 +394,7 @@ void Text::HandleChangeLanguage(StringHash eventType, VariantMap& eventData)
 
 void Text::SetSelection(unsigned start, unsigned length)
 {
+    MarkBatchesDirty();
     selectionStart_ = start;
     selectionLength_ = length;
     ValidateSelection();
@@ -377,37 +402,44 @@ void Text::SetSelection(unsigned start, unsigned length)
 
 void Text::ClearSelection()
 {
+    MarkBatchesDirty();
     selectionStart_ = 0;
     selectionLength_ = 0;
 }
 
 void Text::SetTextEffect(TextEffect textEffect)
 {
+    MarkBatchesDirty();
     textEffect_ = textEffect;
 }
 
 void Text::SetEffectShadowOffset(const IntVector2& offset)
 {
+    MarkBatchesDirty();
     shadowOffset_ = offset;
 }
 
 void Text::SetEffectStrokeThickness(int thickness)
 {
+    MarkBatchesDirty();
     strokeThickness_ = Abs(thickness);
 }
 
 void Text::SetEffectRoundStroke(bool roundStroke)
 {
+    MarkBatchesDirty();
     roundStroke_ = roundStroke;
 }
 
 void Text::SetEffectColor(const Color& effectColor)
 {
+    MarkBatchesDirty();
     effectColor_ = effectColor;
 }
 
 void Text::SetEffectDepthBias(float bias)
 {
+    MarkBatchesDirty();
     effectDepthBias_ = bias;
 }
 
@@ -486,14 +518,15 @@ bool Text::FilterImplicitAttributes(XMLElement& dest) const
 
 void Text::UpdateText(bool onResize)
 {
-    rowWidths_.clear();
-    printText_.clear();
-
     if (font_)
     {
         FontFace* face = font_->GetFace(fontSize_);
         if (!face)
+        {
+            MarkBatchesDirty();
+            InvalidateTextLayout();
             return;
+        }
 
         rowHeight_ = face->GetRowHeight();
 
@@ -502,22 +535,58 @@ void Text::UpdateText(bool onResize)
         int rowWidth = 0;
         auto rowHeight = RoundToInt(rowSpacing_ * rowHeight_);
 
+        // Reuse the previous layout up to the last hard line break within the unchanged part of the text. Layout of a row never
+        // depends on the text after its line break, so appended text, e.g. in logs, only re-measures the last row
+        const int wrapWidth = wordWrap_ ? GetWidth() : -1;
+        unsigned validLength = 0;
+        if (layoutFace_ == face && layoutWrapWidth_ == wrapWidth)
+            validLength = Min(layoutValidLength_, unicodeText_.size());
+        const bool layoutUnchanged = validLength == unicodeText_.size() && layoutTextLength_ == unicodeText_.size() &&
+            layoutRowSpacing_ == rowSpacing_;
+
+        unsigned resumeText = 0;
+        unsigned resumePrint = 0;
+        if (layoutUnchanged)
+        {
+            resumeText = unicodeText_.size();
+            resumePrint = printText_.size();
+        }
+        else
+        {
+            for (unsigned p = printText_.size(); p-- > 0;)
+            {
+                const unsigned t = printToText_[p];
+                if (printText_[p] == '\n' && t < validLength && unicodeText_[t] == '\n')
+                {
+                    resumeText = t + 1;
+                    resumePrint = p + 1;
+                    break;
+                }
+            }
+            MarkBatchesDirty();
+        }
+
+        const unsigned resumeRows = layoutUnchanged ? rowWidths_.size() :
+            (unsigned)ea::count(printText_.begin(), printText_.begin() + resumePrint, '\n');
+        rowWidths_.resize(resumeRows);
+        printText_.resize(resumePrint);
+        printToText_.resize(resumePrint);
+
         // First see if the text must be split up
         if (!wordWrap_)
         {
-            printText_ = unicodeText_;
+            printText_.insert(printText_.end(), unicodeText_.begin() + resumeText, unicodeText_.end());
             printToText_.resize(printText_.size());
-            for (unsigned i = 0; i < printText_.size(); ++i)
+            for (unsigned i = resumePrint; i < printText_.size(); ++i)
                 printToText_[i] = i;
         }
         else
         {
-            int maxWidth = GetWidth();
-            unsigned nextBreak = 0;
-            unsigned lineStart = 0;
-            printToText_.clear();
+            int maxWidth = wrapWidth;
+            unsigned nextBreak = resumeText ? resumeText - 1 : 0;
+            unsigned lineStart = nextBreak;
 
-            for (unsigned i = 0; i < unicodeText_.size(); ++i)
+            for (unsigned i = resumeText; i < unicodeText_.size(); ++i)
             {
                 unsigned j;
                 unsigned c = unicodeText_[i];
@@ -610,8 +679,11 @@ void Text::UpdateText(bool onResize)
         }
 
         rowWidth = 0;
+        for (float previousRowWidth : rowWidths_)
+            width = Max(width, (int)previousRowWidth);
+        height = resumeRows * rowHeight;
 
-        for (unsigned i = 0; i < printText_.size(); ++i)
+        for (unsigned i = resumePrint; i < printText_.size(); ++i)
         {
             unsigned c = printText_[i];
 
@@ -641,6 +713,12 @@ void Text::UpdateText(bool onResize)
             rowWidths_.push_back(rowWidth);
         }
 
+        layoutFace_ = face;
+        layoutWrapWidth_ = wrapWidth;
+        layoutRowSpacing_ = rowSpacing_;
+        layoutValidLength_ = unicodeText_.size();
+        layoutTextLength_ = unicodeText_.size();
+
         // Set at least one row height even if text is empty
         if (!height)
             height = rowHeight;
@@ -658,11 +736,17 @@ void Text::UpdateText(bool onResize)
         }
         SetFixedHeight(height);
 
-        charLocationsDirty_ = true;
+        if (!layoutUnchanged || onResize)
+        {
+            MarkBatchesDirty();
+            charLocationsDirty_ = true;
+        }
     }
     else
     {
         // No font, nothing to render
+        MarkBatchesDirty();
+        InvalidateTextLayout();
         pageGlyphLocations_.clear();
     }
 
@@ -302,6 +302,19 @@ protected:
     void HandleChangeLanguage(StringHash eventType, VariantMap& eventData);
     /// UTF8 to Unicode.
     void DecodeToUnicode();
+    /// Discard the reusable text layout.
+    void InvalidateTextLayout();
+
+    /// Font face used for the last text layout.
+    WeakPtr<FontFace> layoutFace_;
+    /// Wrapping width used for the last text layout, or -1 if word wrap was disabled.
+    int layoutWrapWidth_;
+    /// Row spacing used for the last text layout.
+    float layoutRowSpacing_;
+    /// Number of leading characters unchanged since the last text layout.
+    unsigned layoutValidLength_;
+    /// Number of characters in the last text layout.
+    unsigned layoutTextLength_;
 };
 
 }
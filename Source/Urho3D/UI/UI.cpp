@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Container/FrameAllocator.h"
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
 #include "../Core/Profiler.h"
@@ -48,6 +49,7 @@
 #include "../UI/Font.h"
 #include "../UI/LineEdit.h"
 #include "../UI/ListView.h"
+#include "../UI/VirtualListView.h"
 #include "../UI/MessageBox.h"
 #include "../UI/ProgressBar.h"
 #include "../UI/ScrollBar.h"
@@ -62,7 +64,9 @@
 #include "../UI/Window.h"
 #include "../UI/View3D.h"
 #include "../UI/UIComponent.h"
+#include "../UI/UITextureAtlas.h"
 
+#include <EASTL/sort.h>
 #include <cassert>
 #include <SDL/SDL.h>
 
@@ -86,6 +90,8 @@ const float DEFAULT_DRAGBEGIN_INTERVAL = 0.5f;
 const float DEFAULT_TOOLTIP_DELAY = 0.5f;
 const int DEFAULT_DRAGBEGIN_DISTANCE = 5;
 const int DEFAULT_FONT_TEXTURE_MAX_SIZE = 2048;
+const int UI_TEXTURE_ATLAS_SIZE = 2048;
+const int UI_TEXTURE_ATLAS_MAX_TEXTURE_SIZE = 256;
 
 const char* UI_CATEGORY = "UI";
 
@@ -116,6 +122,9 @@ UI::UI(Context* context) :
     useScreenKeyboard_(false),
 #endif
     useMutableGlyphs_(false),
+    deferredLayout_(false),
+    updatingDeferredLayouts_(false),
+    useTextureAtlas_(false),
     forceAutoHint_(false),
     fontHintLevel_(FONT_HINT_LEVEL_NORMAL),
     fontSubpixelThreshold_(12),
@@ -207,6 +216,7 @@ void UI::SetFocusElement(UIElement* element, bool byKey)
     {
         UIElement* oldFocusElement = focusElement_;
         focusElement_.Reset();
+        oldFocusElement->MarkBatchesDirty();
 
         VariantMap& focusEventData = GetEventDataMap();
         focusEventData[Defocused::P_ELEMENT] = oldFocusElement;
@@ -217,6 +227,7 @@ void UI::SetFocusElement(UIElement* element, bool byKey)
     if (element && element->GetFocusMode() >= FM_FOCUSABLE)
     {
         focusElement_ = element;
+        element->MarkBatchesDirty();
 
         VariantMap& focusEventData = GetEventDataMap();
         focusEventData[Focused::P_ELEMENT] = element;
@@ -323,6 +334,9 @@ void UI::Update(float timeStep)
 
     URHO3D_PROFILE("UpdateUI");
 
+    // Resolve layouts changed outside of the UI update before checking hover and drag
+    UpdateDeferredLayouts();
+
     // Expire hovers
     for (auto i = hoveredElements_.begin(); i !=
         hoveredElements_.end(); ++i)
@@ -402,6 +416,9 @@ void UI::Update(float timeStep)
             {
                 using namespace HoverEnd;
 
+                // Hover state is reset when batches are generated
+                element->MarkBatchesDirty();
+
                 VariantMap& eventData = GetEventDataMap();
                 eventData[P_ELEMENT] = element;
                 element->SendEvent(E_HOVEREND, eventData);
@@ -420,6 +437,9 @@ void UI::RenderUpdate()
 {
     assert(rootElement_ && rootModalElement_ && graphics_);
 
+    // Resolve layouts changed during the update before collecting batches
+    UpdateDeferredLayouts();
+
     URHO3D_PROFILE("GetUIBatches");
 
     uiRendered_ = false;
@@ -464,12 +484,16 @@ void UI::RenderUpdate()
 void UI::Render()
 {
     URHO3D_PROFILE("RenderUI");
+    GPUProfileZone gpuZone(graphics_, "UI");
 
     // If the OS cursor is visible, apply its shape now if changed
     bool osCursorVisible = GetSubsystem<Input>()->IsMouseVisible();
     if (cursor_ && osCursorVisible)
         cursor_->ApplyOSCursorShape();
 
+    // Redraw outdated bitmap caches of UI elements before they are used
+    RenderCachedBitmaps();
+
     SetVertexData(vertexBuffer_, vertexData_);
     SetVertexData(debugVertexBuffer_, debugVertexData_);
 
@@ -628,6 +652,96 @@ void UI::SetUseMutableGlyphs(bool enable)
     }
 }
 
+void UI::SetDeferredLayout(bool enable)
+{
+    if (enable == deferredLayout_)
+        return;
+
+    deferredLayout_ = enable;
+    if (!deferredLayout_)
+        UpdateDeferredLayouts();
+}
+
+bool UI::DeferLayoutUpdate(UIElement* element)
+{
+    if (!deferredLayout_ || updatingDeferredLayouts_)
+        return false;
+
+    // Elements outside of the hierarchy may be measured right after building, so lay them out immediately
+    UIElement* root = element->GetRoot();
+    if (!root || (root != rootElement_ && root != rootModalElement_))
+        return false;
+
+    if (!element->IsLayoutDirty())
+        deferredLayoutElements_.emplace_back(element);
+    return true;
+}
+
+void UI::UpdateDeferredLayouts()
+{
+    if (deferredLayoutElements_.empty())
+        return;
+
+    URHO3D_PROFILE("UpdateDeferredUILayouts");
+
+    // Children first, so that parents see the final minimum sizes. Layout of a parent also updates the children it resizes
+    FrameVector<ea::pair<unsigned, WeakPtr<UIElement> > > elements;
+    elements.reserve(deferredLayoutElements_.size());
+    for (const WeakPtr<UIElement>& element : deferredLayoutElements_)
+    {
+        if (!element)
+            continue;
+        unsigned depth = 0;
+        for (UIElement* parent = element->GetParent(); parent; parent = parent->GetParent())
+            ++depth;
+        elements.emplace_back(depth, element);
+    }
+    deferredLayoutElements_.clear();
+
+    ea::stable_sort(elements.begin(), elements.end(),
+        [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+
+    updatingDeferredLayouts_ = true;
+    for (const auto& item : elements)
+    {
+        UIElement* element = item.second;
+        if (element && element->IsLayoutDirty())
+            element->UpdateLayout();
+    }
+    updatingDeferredLayouts_ = false;
+}
+
+void UI::SetUseTextureAtlas(bool enable)
+{
+    if (enable == useTextureAtlas_)
+        return;
+
+    useTextureAtlas_ = enable;
+    if (!useTextureAtlas_)
+        textureAtlas_.Reset();
+
+    // Cached batches reference the previous textures and UV coordinates
+    for (UIElement* root : {rootElement_.Get(), rootModalElement_.Get()})
+    {
+        if (!root)
+            continue;
+        root->MarkBatchesDirty();
+        ea::vector<UIElement*> children;
+        root->GetChildren(children, true);
+        for (UIElement* child : children)
+            child->MarkBatchesDirty();
+    }
+}
+
+UITextureAtlas* UI::GetTextureAtlas() const
+{
+    if (!useTextureAtlas_)
+        return nullptr;
+    if (!textureAtlas_)
+        textureAtlas_ = MakeShared<UITextureAtlas>(context_, UI_TEXTURE_ATLAS_SIZE, UI_TEXTURE_ATLAS_MAX_TEXTURE_SIZE);
+    return textureAtlas_;
+}
+
 void UI::SetForceAutoHint(bool enable)
 {
     if (enable != forceAutoHint_)
@@ -854,6 +968,7 @@ void UI::Initialize()
 
     vertexBuffer_ = context_->CreateObject<VertexBuffer>();
     debugVertexBuffer_ = context_->CreateObject<VertexBuffer>();
+    bitmapVertexBuffer_ = context_->CreateObject<VertexBuffer>();
 
     initialized_ = true;
 
@@ -1072,6 +1187,127 @@ void UI::GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData,
     if (currentScissor.left_ == currentScissor.right_ || currentScissor.top_ == currentScissor.bottom_)
         return;
 
+    // Draw child elements as a single quad textured with their cached bitmap
+    if (element->GetBitmapCaching())
+    {
+        Texture2D* bitmap = UpdateCachedBitmap(element);
+        if (bitmap)
+        {
+            UIBatch batch(element, BLEND_PREMULALPHA, currentScissor, bitmap, &vertexData);
+            batch.SetColor(Color::WHITE);
+            batch.AddQuad(0.0f, 0.0f, (float)element->GetWidth(), (float)element->GetHeight(), 0, 0, bitmap->GetWidth(),
+                bitmap->GetHeight());
+            UIBatch::AddOrMerge(batch, batches);
+            return;
+        }
+    }
+
+    // Reuse cached batches of child elements if nothing changed
+    if (element->GetBatchCaching())
+    {
+        if (!element->IsBatchCacheValid(currentScissor))
+        {
+            ea::vector<UIBatch> elementBatches;
+            ea::vector<float> elementVertexData;
+            GetChildrenBatches(elementBatches, elementVertexData, element, currentScissor);
+            element->SetCachedBatches(currentScissor, elementBatches, elementVertexData);
+        }
+        element->AppendCachedBatches(batches, vertexData);
+        return;
+    }
+
+    GetChildrenBatches(batches, vertexData, element, currentScissor);
+}
+
+Texture2D* UI::UpdateCachedBitmap(UIElement* element)
+{
+    if (element->IsBitmapCacheValid())
+        return element->GetCachedBitmap();
+
+    const int width = Max(RoundToInt(element->GetWidth() * uiScale_), 1);
+    const int height = Max(RoundToInt(element->GetHeight() * uiScale_), 1);
+
+    Texture2D* bitmap = element->GetCachedBitmap();
+    if (!bitmap || bitmap->GetWidth() != width || bitmap->GetHeight() != height)
+    {
+        SharedPtr<Texture2D> texture = context_->CreateObject<Texture2D>();
+        texture->SetNumLevels(1);
+        texture->SetFilterMode(FILTER_BILINEAR);
+        texture->SetAddressMode(COORD_U, ADDRESS_CLAMP);
+        texture->SetAddressMode(COORD_V, ADDRESS_CLAMP);
+        if (!texture->SetSize(width, height, Graphics::GetRGBAFormat(), TEXTURE_RENDERTARGET))
+        {
+            URHO3D_LOGERROR("Failed to create UI bitmap cache texture");
+            return nullptr;
+        }
+        texture->GetRenderSurface()->SetUpdateMode(SURFACE_MANUALUPDATE);
+        element->SetCachedBitmap(texture);
+        bitmap = texture;
+    }
+
+    // Collect child batches clipped only by the element itself and move them to the texture space
+    const IntVector2& screenPos = element->GetScreenPosition();
+    IntRect scissor(screenPos, screenPos + element->GetSize());
+    ea::vector<UIBatch> elementBatches;
+    ea::vector<float> elementVertexData;
+    GetChildrenBatches(elementBatches, elementVertexData, element, scissor);
+
+    for (unsigned i = 0; i < elementVertexData.size(); i += UI_VERTEX_SIZE)
+    {
+        elementVertexData[i] -= (float)screenPos.x_;
+        elementVertexData[i + 1] -= (float)screenPos.y_;
+    }
+    for (UIBatch& batch : elementBatches)
+    {
+        batch.scissor_.left_ -= screenPos.x_;
+        batch.scissor_.right_ -= screenPos.x_;
+        batch.scissor_.top_ -= screenPos.y_;
+        batch.scissor_.bottom_ -= screenPos.y_;
+    }
+
+    element->SetCachedBatches(scissor, elementBatches, elementVertexData);
+    cachedBitmapElements_.push_back(WeakPtr<UIElement>(element));
+    return bitmap;
+}
+
+void UI::RenderCachedBitmaps()
+{
+    if (cachedBitmapElements_.empty())
+        return;
+
+    URHO3D_PROFILE("RenderUIBitmapCache");
+
+    RenderSurface* renderTarget = graphics_->GetRenderTarget(0);
+    RenderSurface* depthStencil = graphics_->GetDepthStencil();
+    const IntRect viewport = graphics_->GetViewport();
+
+    for (const WeakPtr<UIElement>& element : cachedBitmapElements_)
+    {
+        Texture2D* bitmap = element ? element->GetCachedBitmap() : nullptr;
+        if (!bitmap)
+            continue;
+
+        RenderSurface* surface = bitmap->GetRenderSurface();
+        graphics_->ResetRenderTargets();
+        graphics_->SetDepthStencil(surface->GetLinkedDepthStencil());
+        graphics_->SetRenderTarget(0, surface);
+        graphics_->SetViewport(IntRect(0, 0, surface->GetWidth(), surface->GetHeight()));
+        graphics_->Clear(CLEAR_COLOR, Color::TRANSPARENT_BLACK);
+
+        const ea::vector<UIBatch>& elementBatches = element->GetCachedBatches();
+        SetVertexData(bitmapVertexBuffer_, element->GetCachedVertexData());
+        Render(bitmapVertexBuffer_, elementBatches, 0, elementBatches.size());
+    }
+    cachedBitmapElements_.clear();
+
+    graphics_->ResetRenderTargets();
+    graphics_->SetDepthStencil(depthStencil);
+    graphics_->SetRenderTarget(0, renderTarget);
+    graphics_->SetViewport(viewport);
+}
+
+void UI::GetChildrenBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData, UIElement* element, const IntRect& currentScissor)
+{
     element->SortChildren();
     const ea::vector<SharedPtr<UIElement> >& children = element->GetChildren();
     if (children.empty())
@@ -1292,6 +1528,7 @@ void UI::ProcessHover(const IntVector2& windowCursorPos, MouseButtonFlags button
                 // Begin hover event
                 if (!hoveredElements_.contains(element))
                 {
+                    element->MarkBatchesDirty();
                     SendDragOrHoverEvent(E_HOVERBEGIN, element, cursorPos, IntVector2::ZERO, nullptr);
                     // Exit if element is destroyed by the event handling
                     if (!element)
@@ -1337,6 +1574,7 @@ void UI::ProcessHover(const IntVector2& windowCursorPos, MouseButtonFlags button
             // Begin hover event
             if (!hoveredElements_.contains(element))
             {
+                element->MarkBatchesDirty();
                 SendDragOrHoverEvent(E_HOVERBEGIN, element, cursorPos, IntVector2::ZERO, nullptr);
                 // Exit if element is destroyed by the event handling
                 if (!element)
@@ -2179,6 +2417,7 @@ void RegisterUILibrary(Context* context)
     ScrollBar::RegisterObject(context);
     ScrollView::RegisterObject(context);
     ListView::RegisterObject(context);
+    VirtualListView::RegisterObject(context);
     Menu::RegisterObject(context);
     DropDownList::RegisterObject(context);
     FileSelector::RegisterObject(context);
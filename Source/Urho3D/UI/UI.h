@@ -55,6 +55,7 @@ class XMLElement;
 class XMLFile;
 class RenderSurface;
 class UIComponent;
+class UITextureAtlas;
 
 /// %UI subsystem. Manages the graphical user interface.
 class URHO3D_API UI : public Object
@@ -124,6 +125,12 @@ public:
     /// Set whether to use mutable (eraseable) glyphs to ensure a font face never expands to more than one texture. Default false.
     /// @property
     void SetUseMutableGlyphs(bool enable);
+    /// Set whether layout updates of elements in the %UI hierarchy are postponed and resolved once before the next %UI update or render. Default false.
+    /// @property
+    void SetDeferredLayout(bool enable);
+    /// Set whether to pack small static textures of %BorderImage and %Sprite elements into a shared atlas texture to reduce draw calls. Default false.
+    /// @property
+    void SetUseTextureAtlas(bool enable);
     /// Set whether to force font autohinting instead of using FreeType's TTF bytecode interpreter.
     /// @property
     void SetForceAutoHint(bool enable);
@@ -238,6 +245,23 @@ public:
     /// @property
     bool GetUseMutableGlyphs() const { return useMutableGlyphs_; }
 
+    /// Return whether layout updates are deferred.
+    /// @property
+    bool GetDeferredLayout() const { return deferredLayout_; }
+
+    /// Postpone layout update of the element if deferred layout is enabled and the element is in the %UI hierarchy. Return true if postponed. Used internally by UIElement.
+    bool DeferLayoutUpdate(UIElement* element);
+    /// Perform postponed layout updates, deepest elements first.
+    void UpdateDeferredLayouts();
+
+    /// Return whether small static textures are packed into a shared atlas texture.
+    /// @property
+    bool GetUseTextureAtlas() const { return useTextureAtlas_; }
+
+    /// Return texture atlas used for batching, or null if atlasing is disabled.
+    /// @nobind
+    UITextureAtlas* GetTextureAtlas() const;
+
     /// Return whether is using forced autohinting.
     /// @property
     bool GetForceAutoHint() const { return forceAutoHint_; }
@@ -304,6 +328,12 @@ private:
     void Render(VertexBuffer* buffer, const ea::vector<UIBatch>& batches, unsigned batchStart, unsigned batchEnd);
     /// Generate batches from an UI element recursively. Skip the cursor element.
     void GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData, UIElement* element, IntRect currentScissor);
+    /// Generate batches from child elements of an UI element, ignoring batch cache of the element.
+    void GetChildrenBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData, UIElement* element, const IntRect& currentScissor);
+    /// Return up to date bitmap cache texture of an UI element, queueing it for redraw if needed.
+    Texture2D* UpdateCachedBitmap(UIElement* element);
+    /// Redraw queued bitmap caches of UI elements.
+    void RenderCachedBitmaps();
     /// Return UI element at screen position recursively.
     void GetElementAt(UIElement*& result, UIElement* current, const IntVector2& position, bool enabledOnly);
     /// Return the first element in hierarchy that can alter focus.
@@ -404,6 +434,10 @@ private:
     SharedPtr<VertexBuffer> vertexBuffer_;
     /// UI debug geometry vertex buffer.
     SharedPtr<VertexBuffer> debugVertexBuffer_;
+    /// UI bitmap cache geometry vertex buffer.
+    SharedPtr<VertexBuffer> bitmapVertexBuffer_;
+    /// UI elements with bitmap caches waiting to be redrawn.
+    ea::vector<WeakPtr<UIElement> > cachedBitmapElements_;
     /// UI element query vector.
     ea::vector<UIElement*> tempElements_;
     /// Clipboard text.
@@ -436,6 +470,16 @@ private:
     bool useScreenKeyboard_;
     /// Flag for using mutable (erasable) font glyphs.
     bool useMutableGlyphs_;
+    /// Flag for deferring layout updates.
+    bool deferredLayout_;
+    /// Flag set while postponed layout updates are performed.
+    bool updatingDeferredLayouts_;
+    /// Elements with postponed layout updates.
+    ea::vector<WeakPtr<UIElement> > deferredLayoutElements_;
+    /// Flag for packing small static textures into a shared atlas.
+    bool useTextureAtlas_;
+    /// Texture atlas for batching, created on demand.
+    mutable SharedPtr<UITextureAtlas> textureAtlas_;
     /// Flag for forcing FreeType auto hinting.
     bool forceAutoHint_;
     /// FreeType hinting level (default is FONT_HINT_LEVEL_NORMAL).
@@ -24,7 +24,9 @@
 
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Texture.h"
+#include "../Graphics/Texture2D.h"
 #include "../UI/UIElement.h"
+#include "../UI/UITextureAtlas.h"
 
 #include "../DebugNew.h"
 
@@ -75,6 +77,25 @@ void UIBatch::SetDefaultColor()
     }
 }
 
+void UIBatch::SetTextureAtlas(UITextureAtlas* atlas, const IntRect& texelRect)
+{
+    if (!atlas || !texture_ || customMaterial_)
+        return;
+
+    // Texel coordinates outside of the texture rely on the address mode and cannot be remapped
+    if (texelRect.left_ < 0 || texelRect.top_ < 0 || texelRect.right_ > texture_->GetWidth()
+        || texelRect.bottom_ > texture_->GetHeight())
+        return;
+
+    IntVector2 offset;
+    if (Texture2D* atlasTexture = atlas->GetAtlasRegion(texture_, offset))
+    {
+        texture_ = atlasTexture;
+        invTextureSize_ = Vector2(1.0f / (float)atlasTexture->GetWidth(), 1.0f / (float)atlasTexture->GetHeight());
+        atlasOffset_ = offset;
+    }
+}
+
 void UIBatch::AddQuad(float x, float y, float width, float height, int texOffsetX, int texOffsetY, int texWidth, int texHeight)
 {
     unsigned topLeftColor, topRightColor, bottomLeftColor, bottomRightColor;
@@ -105,6 +126,8 @@ void UIBatch::AddQuad(float x, float y, float width, float height, int texOffset
     float top = y + screenPos.y_ - posAdjust.x_;
     float bottom = top + height;
 
+    texOffsetX += atlasOffset_.x_;
+    texOffsetY += atlasOffset_.y_;
     float leftUV = texOffsetX * invTextureSize_.x_;
     float topUV = texOffsetY * invTextureSize_.y_;
     float rightUV = (texOffsetX + (texWidth ? texWidth : width)) * invTextureSize_.x_;
@@ -187,6 +210,8 @@ void UIBatch::AddQuad(const Matrix3x4& transform, int x, int y, int width, int h
     Vector3 v3 = (transform * Vector3((float)x, (float)y + (float)height, 0.0f)) - posAdjust;
     Vector3 v4 = (transform * Vector3((float)x + (float)width, (float)y + (float)height, 0.0f)) - posAdjust;
 
+    texOffsetX += atlasOffset_.x_;
+    texOffsetY += atlasOffset_.y_;
     float leftUV = ((float)texOffsetX) * invTextureSize_.x_;
     float topUV = ((float)texOffsetY) * invTextureSize_.y_;
     float rightUV = ((float)(texOffsetX + (texWidth ? texWidth : width))) * invTextureSize_.x_;
@@ -282,10 +307,10 @@ void UIBatch::AddQuad(const Matrix3x4& transform, const IntVector2& a, const Int
     Vector3 v3 = (transform * Vector3((float)c.x_, (float)c.y_, 0.0f)) - posAdjust;
     Vector3 v4 = (transform * Vector3((float)d.x_, (float)d.y_, 0.0f)) - posAdjust;
 
-    Vector2 uv1((float)texA.x_ * invTextureSize_.x_, (float)texA.y_ * invTextureSize_.y_);
-    Vector2 uv2((float)texB.x_ * invTextureSize_.x_, (float)texB.y_ * invTextureSize_.y_);
-    Vector2 uv3((float)texC.x_ * invTextureSize_.x_, (float)texC.y_ * invTextureSize_.y_);
-    Vector2 uv4((float)texD.x_ * invTextureSize_.x_, (float)texD.y_ * invTextureSize_.y_);
+    Vector2 uv1((float)(texA.x_ + atlasOffset_.x_) * invTextureSize_.x_, (float)(texA.y_ + atlasOffset_.y_) * invTextureSize_.y_);
+    Vector2 uv2((float)(texB.x_ + atlasOffset_.x_) * invTextureSize_.x_, (float)(texB.y_ + atlasOffset_.y_) * invTextureSize_.y_);
+    Vector2 uv3((float)(texC.x_ + atlasOffset_.x_) * invTextureSize_.x_, (float)(texC.y_ + atlasOffset_.y_) * invTextureSize_.y_);
+    Vector2 uv4((float)(texD.x_ + atlasOffset_.x_) * invTextureSize_.x_, (float)(texD.y_ + atlasOffset_.y_) * invTextureSize_.y_);
 
     unsigned begin = vertexData_->size();
     vertexData_->resize(begin + 6 * UI_VERTEX_SIZE);
@@ -344,10 +369,10 @@ void UIBatch::AddQuad(const Matrix3x4& transform, const IntVector2& a, const Int
     Vector3 v3 = (transform * Vector3((float)c.x_, (float)c.y_, 0.0f)) - posAdjust;
     Vector3 v4 = (transform * Vector3((float)d.x_, (float)d.y_, 0.0f)) - posAdjust;
 
-    Vector2 uv1((float)texA.x_ * invTextureSize_.x_, (float)texA.y_ * invTextureSize_.y_);
-    Vector2 uv2((float)texB.x_ * invTextureSize_.x_, (float)texB.y_ * invTextureSize_.y_);
-    Vector2 uv3((float)texC.x_ * invTextureSize_.x_, (float)texC.y_ * invTextureSize_.y_);
-    Vector2 uv4((float)texD.x_ * invTextureSize_.x_, (float)texD.y_ * invTextureSize_.y_);
+    Vector2 uv1((float)(texA.x_ + atlasOffset_.x_) * invTextureSize_.x_, (float)(texA.y_ + atlasOffset_.y_) * invTextureSize_.y_);
+    Vector2 uv2((float)(texB.x_ + atlasOffset_.x_) * invTextureSize_.x_, (float)(texB.y_ + atlasOffset_.y_) * invTextureSize_.y_);
+    Vector2 uv3((float)(texC.x_ + atlasOffset_.x_) * invTextureSize_.x_, (float)(texC.y_ + atlasOffset_.y_) * invTextureSize_.y_);
+    Vector2 uv4((float)(texD.x_ + atlasOffset_.x_) * invTextureSize_.x_, (float)(texD.y_ + atlasOffset_.y_) * invTextureSize_.y_);
 
     unsigned c1 = colA.ToUInt();
     unsigned c2 = colB.ToUInt();
@@ -35,6 +35,7 @@ class Graphics;
 class Matrix3x4;
 class Texture;
 class UIElement;
+class UITextureAtlas;
 
 static const unsigned UI_VERTEX_SIZE = 6;
 
@@ -51,6 +52,8 @@ public:
     void SetColor(const Color& color, bool overrideAlpha = false);
     /// Restore UI element's default color.
     void SetDefaultColor();
+    /// Replace texture with its region in the atlas if the texture can be packed and the texel rectangle does not wrap. Should be called before adding quads.
+    void SetTextureAtlas(UITextureAtlas* atlas, const IntRect& texelRect);
     /// Add a quad.
     void AddQuad(float x, float y, float width, float height, int texOffsetX, int texOffsetY, int texWidth = 0, int texHeight = 0);
     /// Add a quad using a transform matrix.
@@ -83,6 +86,8 @@ public:
     Texture* texture_{};
     /// Inverse texture size.
     Vector2 invTextureSize_{Vector2::ONE};
+    /// Texel offset of the texture in the atlas.
+    IntVector2 atlasOffset_;
     /// Vertex data.
     ea::vector<float>* vertexData_{};
     /// Vertex data start index.
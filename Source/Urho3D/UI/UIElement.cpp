@@ -26,6 +26,7 @@
 
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
+#include "../Graphics/Texture2D.h"
 #include "../IO/Log.h"
 #include "../Resource/ResourceCache.h"
 #include "../Scene/ObjectAnimation.h"
@@ -144,6 +145,8 @@ void UIElement::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Bring To Back", GetBringToBack, SetBringToBack, bool, true, AM_FILE);
     URHO3D_ACCESSOR_ATTRIBUTE("Clip Children", GetClipChildren, SetClipChildren, bool, false, AM_FILE);
     URHO3D_ACCESSOR_ATTRIBUTE("Use Derived Opacity", GetUseDerivedOpacity, SetUseDerivedOpacity, bool, true, AM_FILE);
+    URHO3D_ACCESSOR_ATTRIBUTE("Cache Batches", GetBatchCaching, SetBatchCaching, bool, false, AM_FILE);
+    URHO3D_ACCESSOR_ATTRIBUTE("Cache As Bitmap", GetBitmapCaching, SetBitmapCaching, bool, false, AM_FILE);
     URHO3D_ENUM_ACCESSOR_ATTRIBUTE("Focus Mode", GetFocusMode, SetFocusMode, FocusMode, focusModes, FM_NOTFOCUSABLE, AM_FILE);
     URHO3D_ENUM_ACCESSOR_ATTRIBUTE("Drag And Drop Mode", GetDragDropMode, SetDragDropMode, DragAndDropModeFlags, dragDropModes, DD_DISABLED, AM_FILE);
     URHO3D_ENUM_ACCESSOR_ATTRIBUTE("Layout Mode", GetLayoutMode, SetLayoutMode, LayoutMode, layoutModes, LM_FREE, AM_FILE);
@@ -160,6 +163,7 @@ void UIElement::ApplyAttributes()
 {
     colorGradient_ = false;
     derivedColorDirty_ = true;
+    MarkBatchesDirty();
 
     for (unsigned i = 1; i < MAX_UIELEMENT_CORNERS; ++i)
     {
@@ -850,6 +854,7 @@ void UIElement::SetColor(const Color& color)
         cornerColor = color;
     colorGradient_ = false;
     derivedColorDirty_ = true;
+    MarkBatchesDirty();
 }
 
 void UIElement::SetColor(Corner corner, const Color& color)
@@ -857,6 +862,7 @@ void UIElement::SetColor(Corner corner, const Color& color)
     colors_[corner] = color;
     colorGradient_ = false;
     derivedColorDirty_ = true;
+    MarkBatchesDirty();
 
     for (unsigned i = 0; i < MAX_UIELEMENT_CORNERS; ++i)
     {
@@ -873,6 +879,7 @@ void UIElement::SetPriority(int priority)
     priority_ = priority;
     if (parent_)
         parent_->sortOrderDirty_ = true;
+    MarkBatchesDirty();
 }
 
 void UIElement::SetOpacity(float opacity)
@@ -909,6 +916,34 @@ void UIElement::SetUseDerivedOpacity(bool enable)
     useDerivedOpacity_ = enable;
 }
 
+void UIElement::SetBatchCaching(bool enable)
+{
+    batchCaching_ = enable;
+    batchesDirty_ = true;
+    if (!batchCaching_)
+    {
+        cachedBatches_.clear();
+        cachedVertexData_.clear();
+    }
+}
+
+void UIElement::SetBitmapCaching(bool enable)
+{
+    bitmapCaching_ = enable;
+    batchesDirty_ = true;
+    if (!bitmapCaching_)
+    {
+        cachedBatches_.clear();
+        cachedVertexData_.clear();
+        cachedBitmap_.Reset();
+    }
+}
+
+void UIElement::SetCachedBitmap(Texture2D* texture)
+{
+    cachedBitmap_ = texture;
+}
+
 void UIElement::SetEnabled(bool enable)
 {
     enabled_ = enable;
@@ -976,6 +1011,8 @@ void UIElement::SetFocus(bool enable)
 
 void UIElement::SetSelected(bool enable)
 {
+    if (enable != selected_)
+        MarkBatchesDirty();
     selected_ = enable;
 }
 
@@ -989,6 +1026,7 @@ void UIElement::SetVisible(bool enable)
     if (enable != visible_)
     {
         visible_ = enable;
+        MarkBatchesDirty();
 
         // Parent's layout may change as a result of visibility change
         if (parent_)
@@ -1122,6 +1160,18 @@ void UIElement::UpdateLayout()
     if (layoutNestingLevel_)
         return;
 
+    // Elements in the UI hierarchy are laid out once per frame by the UI subsystem when deferred layout is enabled
+    auto* ui = GetSubsystem<UI>();
+    if (ui && ui->DeferLayoutUpdate(this))
+    {
+        layoutDirty_ = true;
+        return;
+    }
+
+    layoutDirty_ = false;
+
+    URHO3D_PROFILE("UpdateUILayout");
+
     // Prevent further updates while this update happens
     DisableLayoutUpdate();
 
@@ -1388,6 +1438,7 @@ void UIElement::RemoveChild(UIElement* element, unsigned index)
 
             element->Detach();
             children_.erase_at(i);
+            MarkBatchesDirty();
             UpdateLayout();
             return;
         }
@@ -1415,6 +1466,7 @@ void UIElement::RemoveChildAtIndex(unsigned index)
 
     children_[index]->Detach();
     children_.erase_at(index);
+    MarkBatchesDirty();
     UpdateLayout();
 }
 
@@ -1441,6 +1493,7 @@ void UIElement::RemoveAllChildren()
         (*i++)->Detach();
     }
     children_.clear();
+    MarkBatchesDirty();
     UpdateLayout();
 }
 
@@ -1840,6 +1893,8 @@ void UIElement::SetChildOffset(const IntVector2& offset)
 
 void UIElement::SetHovering(bool enable)
 {
+    if (enable != hovering_)
+        MarkBatchesDirty();
     hovering_ = enable;
 }
 
@@ -1964,13 +2019,61 @@ Animatable* UIElement::FindAttributeAnimationTarget(const ea::string& name, ea::
 }
 
 void UIElement::MarkDirty()
+{
+    // Children are marked below, only parents need explicit update
+    for (UIElement* parent = parent_; parent; parent = parent->parent_)
+        parent->batchesDirty_ = true;
+
+    MarkDirtyRecursive();
+}
+
+void UIElement::MarkDirtyRecursive()
 {
     positionDirty_ = true;
     opacityDirty_ = true;
     derivedColorDirty_ = true;
+    batchesDirty_ = true;
 
     for (auto i = children_.begin(); i != children_.end(); ++i)
-        (*i)->MarkDirty();
+        (*i)->MarkDirtyRecursive();
+}
+
+void UIElement::MarkBatchesDirty()
+{
+    for (UIElement* element = this; element; element = element->parent_)
+        element->batchesDirty_ = true;
+}
+
+void UIElement::SetCachedBatches(const IntRect& currentScissor, ea::vector<UIBatch>& batches, ea::vector<float>& vertexData)
+{
+    cachedBatchesScissor_ = currentScissor;
+    cachedBatches_ = ea::move(batches);
+    cachedVertexData_ = ea::move(vertexData);
+    batchesDirty_ = false;
+}
+
+void UIElement::AppendCachedBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData) const
+{
+    const unsigned vertexOffset = vertexData.size();
+    vertexData.insert(vertexData.end(), cachedVertexData_.begin(), cachedVertexData_.end());
+
+    for (UIBatch batch : cachedBatches_)
+    {
+        batch.vertexData_ = &vertexData;
+        batch.vertexStart_ += vertexOffset;
+        batch.vertexEnd_ += vertexOffset;
+        UIBatch::AddOrMerge(batch, batches);
+    }
+}
+
+bool UIElement::IsBitmapCacheValid() const
+{
+    if (!bitmapCaching_ || batchesDirty_ || !cachedBitmap_ || cachedBitmap_->IsDataLost())
+        return false;
+
+    const float uiScale = GetSubsystem<UI>()->GetScale();
+    return cachedBitmap_->GetWidth() == Max(RoundToInt(size_.x_ * uiScale), 1) &&
+        cachedBitmap_->GetHeight() == Max(RoundToInt(size_.y_ * uiScale), 1);
 }
 
 bool UIElement::RemoveChildXML(XMLElement& parent, const ea::string& name) const
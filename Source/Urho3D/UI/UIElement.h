@@ -122,6 +122,7 @@ class Texture2D;
 class URHO3D_API UIElement : public Animatable
 {
     URHO3D_OBJECT(UIElement, Animatable);
+    URHO3D_SINGLE_THREADED_REFCOUNT();
 
 public:
     /// Construct.
@@ -328,6 +329,12 @@ public:
     /// Set whether parent elements' opacity affects opacity. Default true.
     /// @property
     void SetUseDerivedOpacity(bool enable);
+    /// Set whether to cache rendering batches of child elements. Cached batches are rebuilt only when layout, color, visibility or content of child elements changes. Default false.
+    /// @property
+    void SetBatchCaching(bool enable);
+    /// Set whether to render child elements into a texture and draw it as a single quad. The texture is redrawn only when child elements change. Default false.
+    /// @property
+    void SetBitmapCaching(bool enable);
     /// Set whether reacts to input. Default false, but is enabled by subclasses if applicable.
     /// @property
     void SetEnabled(bool enable);
@@ -384,7 +391,7 @@ public:
     /// Set indent spacing (number of pixels per indentation level).
     /// @property
     void SetIndentSpacing(int indentSpacing);
-    /// Manually update layout. Should not be necessary in most cases, but is provided for completeness.
+    /// Manually update layout. Should not be necessary in most cases, but is provided for completeness. If deferred layout is enabled in the %UI subsystem, the update is postponed until the next %UI update or render.
     void UpdateLayout();
     /// Disable automatic layout update. Should only be used if there are performance problems.
     void DisableLayoutUpdate();
@@ -582,6 +589,13 @@ public:
     /// @property
     bool GetUseDerivedOpacity() const { return useDerivedOpacity_; }
 
+    /// Return whether rendering batches of child elements are cached.
+    /// @property
+    bool GetBatchCaching() const { return batchCaching_; }
+    /// Return whether child elements are cached into a texture.
+    /// @property
+    bool GetBitmapCaching() const { return bitmapCaching_; }
+
     /// Return whether has focus.
     /// @property{get_focus}
     bool HasFocus() const;
@@ -743,6 +757,26 @@ public:
     void AdjustScissor(IntRect& currentScissor);
     /// Get UI rendering batches with a specified offset. Also recurse to child elements.
     void GetBatchesWithOffset(IntVector2& offset, ea::vector<UIBatch>& batches, ea::vector<float>& vertexData, IntRect currentScissor);
+    /// Mark rendering batches of this element and its parents as needing an update. Should be called when appearance of element changes without layout or color change.
+    void MarkBatchesDirty();
+    /// Return whether a deferred layout update is pending.
+    bool IsLayoutDirty() const { return layoutDirty_; }
+    /// Return whether cached batches of child elements are valid for the scissor. Used internally by UI.
+    bool IsBatchCacheValid(const IntRect& currentScissor) const { return batchCaching_ && !batchesDirty_ && cachedBatchesScissor_ == currentScissor; }
+    /// Store cached batches of child elements rendered with the scissor. Used internally by UI.
+    void SetCachedBatches(const IntRect& currentScissor, ea::vector<UIBatch>& batches, ea::vector<float>& vertexData);
+    /// Append cached batches of child elements. Used internally by UI.
+    void AppendCachedBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData) const;
+    /// Return whether the cached bitmap of child elements is up to date. Used internally by UI.
+    bool IsBitmapCacheValid() const;
+    /// Set texture holding the cached bitmap of child elements. Used internally by UI.
+    void SetCachedBitmap(Texture2D* texture);
+    /// Return texture holding the cached bitmap of child elements. Used internally by UI.
+    Texture2D* GetCachedBitmap() const { return cachedBitmap_; }
+    /// Return cached batches of child elements. Used internally by UI.
+    const ea::vector<UIBatch>& GetCachedBatches() const { return cachedBatches_; }
+    /// Return cached vertex data of child elements. Used internally by UI.
+    const ea::vector<float>& GetCachedVertexData() const { return cachedVertexData_; }
 
     /// Return color attribute. Uses just the top-left color.
     const Color& GetColorAttr() const { return colors_[0]; }
@@ -770,6 +804,8 @@ protected:
     Animatable* FindAttributeAnimationTarget(const ea::string& name, ea::string& outName) override;
     /// Mark screen position as needing an update.
     void MarkDirty();
+    /// Mark screen position of this element and child elements as needing an update.
+    void MarkDirtyRecursive();
     /// Remove child XML element by matching attribute name.
     bool RemoveChildXML(XMLElement& parent, const ea::string& name) const;
     /// Remove child XML element by matching attribute name and value.
@@ -835,6 +871,8 @@ protected:
     unsigned resizeNestingLevel_{};
     /// Layout update nesting level to prevent endless loop.
     unsigned layoutNestingLevel_{};
+    /// Deferred layout update pending flag.
+    bool layoutDirty_{};
     /// Layout element maximum size in layout direction.
     int layoutElementMaxSize_{};
     /// Horizontal indentation.
@@ -924,6 +962,20 @@ private:
     TraversalMode traversalMode_{TM_BREADTH_FIRST};
     /// Flag whether node should send child added / removed events by itself.
     bool elementEventSender_{};
+    /// Cache rendering batches of child elements flag.
+    bool batchCaching_{};
+    /// Cache child elements into a texture flag.
+    bool bitmapCaching_{};
+    /// Cached batches dirty flag.
+    bool batchesDirty_{true};
+    /// Scissor used to render cached batches.
+    IntRect cachedBatchesScissor_;
+    /// Cached batches of child elements.
+    ea::vector<UIBatch> cachedBatches_;
+    /// Cached vertex data of child elements.
+    ea::vector<float> cachedVertexData_;
+    /// Texture holding the cached bitmap of child elements.
+    SharedPtr<Texture2D> cachedBitmap_;
     /// XPath query for selecting UI-style.
     static XPathQuery styleXPathQuery_;
     /// Tag list.
@@ -305,6 +305,14 @@ URHO3D_EVENT(E_ITEMDOUBLECLICKED, ItemDoubleClicked)
     URHO3D_PARAM(P_QUALIFIERS, Qualifiers);        // int
 }
 
+/// VirtualListView item element needs to be filled with the data of a new index. Sent only if no item binder callback is set.
+URHO3D_EVENT(E_VIRTUALITEMBIND, VirtualItemBind)
+{
+    URHO3D_PARAM(P_ELEMENT, Element);              // UIElement pointer
+    URHO3D_PARAM(P_ITEM, Item);                    // UIElement pointer
+    URHO3D_PARAM(P_INDEX, Index);                  // int
+}
+
 /// LineEdit or ListView unhandled key pressed.
 URHO3D_EVENT(E_UNHANDLEDKEY, UnhandledKey)
 {
@@ -58,11 +58,13 @@ void UISelectable::GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& v
 
 void UISelectable::SetSelectionColor(const Color& color)
 {
+    MarkBatchesDirty();
     selectionColor_ = color;
 }
 
 void UISelectable::SetHoverColor(const Color& color)
 {
+    MarkBatchesDirty();
     hoverColor_ = color;
 }
 
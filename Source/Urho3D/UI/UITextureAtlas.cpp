@@ -0,0 +1,178 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Graphics/Graphics.h"
+#include "../Graphics/Texture2D.h"
+#include "../IO/Log.h"
+#include "../Resource/Image.h"
+#include "../Resource/ResourceCache.h"
+#include "../UI/UITextureAtlas.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Padding around packed textures. Edge texels are replicated into padding to avoid bleeding when filtering.
+static const int ATLAS_PADDING = 1;
+
+}
+
+UITextureAtlas::UITextureAtlas(Context* context, int size, int maxTextureSize)
+    : Object(context)
+    , size_(size)
+    , maxTextureSize_(Min(maxTextureSize, size - 2 * ATLAS_PADDING))
+{
+    Clear();
+}
+
+UITextureAtlas::~UITextureAtlas() = default;
+
+void UITextureAtlas::Clear()
+{
+    texture_ = nullptr;
+    entries_.clear();
+    allocator_.Reset(size_, size_, 0, 0, false);
+}
+
+Texture2D* UITextureAtlas::GetAtlasRegion(Texture* texture, IntVector2& offset)
+{
+    if (!texture || texture == texture_)
+        return nullptr;
+
+    // Contents are lost with the device, upload them again at the same positions
+    if (texture_ && texture_->IsDataLost())
+        RestoreTexture();
+
+    auto iter = entries_.find(texture);
+    if (iter == entries_.end() || iter->second.texture_.Get() != texture)
+        iter = entries_.insert_or_assign(texture, PackTexture(texture)).first;
+
+    if (!iter->second.packed_)
+        return nullptr;
+
+    offset = iter->second.offset_;
+    return texture_;
+}
+
+SharedPtr<Image> UITextureAtlas::LoadImage(Texture* texture) const
+{
+    auto cache = GetSubsystem<ResourceCache>();
+    SharedPtr<Image> image = cache->GetTempResource<Image>(texture->GetName(), false);
+    if (!image)
+        return nullptr;
+
+    image = image->GetDecompressedImage();
+    if (!image || image->GetWidth() != texture->GetWidth() || image->GetHeight() != texture->GetHeight() || image->GetDepth() > 1)
+        return nullptr;
+
+    return image;
+}
+
+bool UITextureAtlas::UploadImage(const Image* image, const IntVector2& offset)
+{
+    const int width = image->GetWidth();
+    const int height = image->GetHeight();
+    const int paddedWidth = width + 2 * ATLAS_PADDING;
+    const int paddedHeight = height + 2 * ATLAS_PADDING;
+
+    // Copy image with replicated edges
+    ea::vector<unsigned> paddedData(paddedWidth * paddedHeight);
+    for (int py = 0; py < paddedHeight; ++py)
+    {
+        const int sy = Clamp(py - ATLAS_PADDING, 0, height - 1);
+        for (int px = 0; px < paddedWidth; ++px)
+        {
+            const int sx = Clamp(px - ATLAS_PADDING, 0, width - 1);
+            paddedData[py * paddedWidth + px] = image->GetPixelInt(sx, sy);
+        }
+    }
+
+    return texture_->SetData(0, offset.x_ - ATLAS_PADDING, offset.y_ - ATLAS_PADDING,
+        paddedWidth, paddedHeight, paddedData.data());
+}
+
+void UITextureAtlas::RestoreTexture()
+{
+    texture_->ClearDataLost();
+    for (const auto& item : entries_)
+    {
+        const Entry& entry = item.second;
+        if (!entry.packed_ || !entry.texture_)
+            continue;
+
+        if (SharedPtr<Image> image = LoadImage(entry.texture_))
+            UploadImage(image, entry.offset_);
+    }
+}
+
+UITextureAtlas::Entry UITextureAtlas::PackTexture(Texture* texture)
+{
+    Entry entry;
+    entry.texture_ = texture;
+
+    // Only small immutable textures loaded from images can be packed
+    const int width = texture->GetWidth();
+    const int height = texture->GetHeight();
+    if (texture->GetType() != Texture2D::GetTypeStatic() || texture->GetName().empty()
+        || texture->GetUsage() != TEXTURE_STATIC || texture->GetSRGB() || texture->GetFilterMode() != FILTER_DEFAULT
+        || texture->GetFormat() == Graphics::GetAlphaFormat()
+        || width <= 0 || height <= 0 || width > maxTextureSize_ || height > maxTextureSize_)
+        return entry;
+
+    const SharedPtr<Image> image = LoadImage(texture);
+    if (!image)
+        return entry;
+
+    int x{};
+    int y{};
+    if (!allocator_.Allocate(width + 2 * ATLAS_PADDING, height + 2 * ATLAS_PADDING, x, y))
+        return entry;
+
+    if (!texture_)
+    {
+        texture_ = MakeShared<Texture2D>(context_);
+        texture_->SetName("UITextureAtlas");
+        texture_->SetMipsToSkip(QUALITY_LOW, 0);
+        texture_->SetNumLevels(1);
+        texture_->SetAddressMode(COORD_U, ADDRESS_CLAMP);
+        texture_->SetAddressMode(COORD_V, ADDRESS_CLAMP);
+        if (!texture_->SetSize(size_, size_, Graphics::GetRGBAFormat()))
+        {
+            URHO3D_LOGERROR("Cannot create UI texture atlas");
+            texture_ = nullptr;
+            return entry;
+        }
+    }
+
+    entry.offset_ = IntVector2(x + ATLAS_PADDING, y + ATLAS_PADDING);
+    entry.packed_ = UploadImage(image, entry.offset_);
+    return entry;
+}
+
+}
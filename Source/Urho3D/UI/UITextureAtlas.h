@@ -0,0 +1,95 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include "../Core/Object.h"
+#include "../Math/AreaAllocator.h"
+
+#include <EASTL/unordered_map.h>
+
+namespace Urho3D
+{
+
+class Image;
+class Texture;
+class Texture2D;
+
+/// Runtime texture atlas for small %UI textures. Textures are packed on first use so %UI batches with different textures can be merged.
+class URHO3D_API UITextureAtlas : public Object
+{
+    URHO3D_OBJECT(UITextureAtlas, Object);
+
+public:
+    /// Construct.
+    UITextureAtlas(Context* context, int size, int maxTextureSize);
+    /// Destruct.
+    ~UITextureAtlas() override;
+
+    /// Return atlas texture and texel offset of the texture in the atlas, adding texture to the atlas if possible. Return null if the texture cannot be packed.
+    Texture2D* GetAtlasRegion(Texture* texture, IntVector2& offset);
+    /// Remove all textures from the atlas.
+    void Clear();
+
+    /// Return atlas size.
+    int GetSize() const { return size_; }
+    /// Return max size of texture that can be packed.
+    int GetMaxTextureSize() const { return maxTextureSize_; }
+    /// Return atlas texture.
+    Texture2D* GetTexture() const { return texture_; }
+
+private:
+    /// Atlas entry.
+    struct Entry
+    {
+        /// Texture packed in the atlas. Used to detect reuse of pointer by a new texture.
+        WeakPtr<Texture> texture_;
+        /// Offset in the atlas.
+        IntVector2 offset_;
+        /// Whether the texture is packed.
+        bool packed_{};
+    };
+
+    /// Try to pack texture into the atlas.
+    Entry PackTexture(Texture* texture);
+    /// Load image of the texture. Return null if the image doesn't match the texture.
+    SharedPtr<Image> LoadImage(Texture* texture) const;
+    /// Upload image with padding into the atlas.
+    bool UploadImage(const Image* image, const IntVector2& offset);
+    /// Upload all packed textures after the atlas texture has lost its data.
+    void RestoreTexture();
+
+    /// Atlas size.
+    int size_{};
+    /// Max size of texture that can be packed.
+    int maxTextureSize_{};
+    /// Atlas texture.
+    SharedPtr<Texture2D> texture_;
+    /// Allocator of atlas area.
+    AreaAllocator allocator_;
+    /// Entries.
+    ea::unordered_map<Texture*, Entry> entries_;
+};
+
+}
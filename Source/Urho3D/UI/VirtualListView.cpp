@@ -0,0 +1,413 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../UI/Text.h"
+#include "../UI/UI.h"
+#include "../UI/UIEvents.h"
+#include "../UI/VirtualListView.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+extern const char* UI_CATEGORY;
+
+VirtualListView::VirtualListView(Context* context) :
+    ScrollView(context),
+    numItems_(0),
+    itemHeight_(20),
+    selection_(M_MAX_UNSIGNED)
+{
+    resizeContentWidth_ = true;
+
+    auto container = MakeShared<UIElement>(context_);
+    container->SetName("VLV_ItemContainer");
+    container->SetInternal(true);
+    container->SetEnabled(true);
+    container->SetSortChildren(false);
+    SetContentElement(container);
+
+    SubscribeToEvent(this, E_VIEWCHANGED, URHO3D_HANDLER(VirtualListView, HandleViewChanged));
+    SubscribeToEvent(E_UIMOUSECLICK, URHO3D_HANDLER(VirtualListView, HandleUIMouseClick));
+    SubscribeToEvent(E_UIMOUSEDOUBLECLICK, URHO3D_HANDLER(VirtualListView, HandleUIMouseDoubleClick));
+}
+
+VirtualListView::~VirtualListView() = default;
+
+void VirtualListView::RegisterObject(Context* context)
+{
+    context->RegisterFactory<VirtualListView>(UI_CATEGORY);
+
+    URHO3D_COPY_BASE_ATTRIBUTES(ScrollView);
+    URHO3D_ACCESSOR_ATTRIBUTE("Item Height", GetItemHeight, SetItemHeight, int, 20, AM_FILE);
+}
+
+void VirtualListView::OnKey(Key key, MouseButtonFlags buttons, QualifierFlags qualifiers)
+{
+    if (numItems_ && itemHeight_ > 0)
+    {
+        const IntRect& panelBorder = scrollPanel_->GetClipBorder();
+        const int panelHeight = scrollPanel_->GetHeight() - panelBorder.top_ - panelBorder.bottom_;
+        const int pageItems = Max(panelHeight / itemHeight_, 1);
+
+        switch (key)
+        {
+        case KEY_UP:
+            ChangeSelection(-1);
+            return;
+
+        case KEY_DOWN:
+            ChangeSelection(1);
+            return;
+
+        case KEY_PAGEUP:
+            ChangeSelection(-pageItems);
+            return;
+
+        case KEY_PAGEDOWN:
+            ChangeSelection(pageItems);
+            return;
+
+        case KEY_HOME:
+            SetSelection(0);
+            EnsureItemVisibility(0);
+            return;
+
+        case KEY_END:
+            SetSelection(numItems_ - 1);
+            EnsureItemVisibility(numItems_ - 1);
+            return;
+
+        default: break;
+        }
+    }
+
+    ScrollView::OnKey(key, buttons, qualifiers);
+}
+
+void VirtualListView::OnResize(const IntVector2& newSize, const IntVector2& delta)
+{
+    ScrollView::OnResize(newSize, delta);
+    UpdateVisibleItems();
+}
+
+void VirtualListView::SetItemFactory(const VirtualListItemFactory& factory)
+{
+    itemFactory_ = factory;
+
+    // Existing items may be of a different type, so recreate the pool
+    for (UIElement* item : pool_)
+        contentElement_->RemoveChild(item);
+    pool_.clear();
+    boundIndices_.clear();
+    UpdateVisibleItems();
+}
+
+void VirtualListView::SetItemBinder(const VirtualListItemBinder& binder)
+{
+    itemBinder_ = binder;
+    RefreshItems();
+}
+
+void VirtualListView::SetNumItems(unsigned numItems)
+{
+    if (numItems == numItems_)
+        return;
+
+    numItems_ = numItems;
+    if (selection_ != M_MAX_UNSIGNED && selection_ >= numItems_)
+        ClearSelection();
+
+    UpdateContentSize();
+    RefreshItems();
+}
+
+void VirtualListView::SetItemHeight(int height)
+{
+    height = Max(height, 1);
+    if (height == itemHeight_)
+        return;
+
+    itemHeight_ = height;
+    UpdateContentSize();
+    RefreshItems();
+}
+
+void VirtualListView::RefreshItems()
+{
+    boundIndices_.assign(pool_.size(), M_MAX_UNSIGNED);
+    UpdateVisibleItems();
+}
+
+void VirtualListView::SetSelection(unsigned index)
+{
+    if (index >= numItems_)
+        index = M_MAX_UNSIGNED;
+    if (index == selection_)
+        return;
+
+    const unsigned oldSelection = selection_;
+    selection_ = index;
+
+    for (unsigned slot = 0; slot < pool_.size(); ++slot)
+        pool_[slot]->SetSelected(boundIndices_[slot] == selection_);
+
+    using namespace ItemSelected;
+
+    VariantMap& eventData = GetEventDataMap();
+    eventData[P_ELEMENT] = this;
+    if (oldSelection != M_MAX_UNSIGNED)
+    {
+        eventData[P_SELECTION] = oldSelection;
+        SendEvent(E_ITEMDESELECTED, eventData);
+    }
+    if (selection_ != M_MAX_UNSIGNED)
+    {
+        eventData[P_SELECTION] = selection_;
+        SendEvent(E_ITEMSELECTED, eventData);
+    }
+
+    VariantMap& changedEventData = GetEventDataMap();
+    changedEventData[SelectionChanged::P_ELEMENT] = this;
+    SendEvent(E_SELECTIONCHANGED, changedEventData);
+}
+
+void VirtualListView::ChangeSelection(int delta)
+{
+    if (!numItems_)
+        return;
+
+    const int current = selection_ != M_MAX_UNSIGNED ? (int)selection_ : (delta > 0 ? -1 : (int)numItems_);
+    const auto index = (unsigned)Clamp(current + delta, 0, (int)numItems_ - 1);
+    SetSelection(index);
+    EnsureItemVisibility(index);
+}
+
+void VirtualListView::ClearSelection()
+{
+    SetSelection(M_MAX_UNSIGNED);
+}
+
+void VirtualListView::EnsureItemVisibility(unsigned index)
+{
+    if (index >= numItems_)
+        return;
+
+    const IntRect& panelBorder = scrollPanel_->GetClipBorder();
+    const int panelHeight = scrollPanel_->GetHeight() - panelBorder.top_ - panelBorder.bottom_;
+    const int top = (int)index * itemHeight_;
+    const int bottom = top + itemHeight_;
+
+    IntVector2 newView = GetViewPosition();
+    if (top < newView.y_)
+        newView.y_ = top;
+    else if (bottom > newView.y_ + panelHeight)
+        newView.y_ = bottom - panelHeight;
+    SetViewPosition(newView);
+}
+
+UIElement* VirtualListView::GetItem(unsigned index) const
+{
+    if (pool_.empty() || index >= numItems_)
+        return nullptr;
+
+    const unsigned slot = index % pool_.size();
+    return boundIndices_[slot] == index && pool_[slot]->IsVisible() ? pool_[slot].Get() : nullptr;
+}
+
+unsigned VirtualListView::GetItemIndex(UIElement* item) const
+{
+    UIElement* pooledItem = FindPooledItem(item);
+    if (!pooledItem || !pooledItem->IsVisible())
+        return M_MAX_UNSIGNED;
+
+    for (unsigned slot = 0; slot < pool_.size(); ++slot)
+    {
+        if (pool_[slot] == pooledItem)
+            return boundIndices_[slot];
+    }
+    return M_MAX_UNSIGNED;
+}
+
+void VirtualListView::UpdateContentSize()
+{
+    const long long contentHeight = (long long)numItems_ * itemHeight_;
+    contentElement_->SetHeight((int)Min(contentHeight, (long long)M_MAX_INT));
+}
+
+void VirtualListView::UpdateVisibleItems()
+{
+    if (!contentElement_ || itemHeight_ <= 0)
+        return;
+
+    const IntRect& panelBorder = scrollPanel_->GetClipBorder();
+    const int panelHeight = Max(scrollPanel_->GetHeight() - panelBorder.top_ - panelBorder.bottom_, 0);
+
+    // One extra item for the partially visible rows at the top and bottom
+    const unsigned numVisible = Min((unsigned)(panelHeight / itemHeight_ + 2), numItems_);
+    if (pool_.size() < numVisible)
+    {
+        while (pool_.size() < numVisible)
+        {
+            SharedPtr<UIElement> item = CreateItem();
+            if (!item)
+                break;
+            pool_.push_back(item);
+        }
+
+        // Slot assignment depends on the pool size
+        boundIndices_.assign(pool_.size(), M_MAX_UNSIGNED);
+    }
+
+    if (pool_.empty())
+        return;
+
+    const unsigned first = Min((unsigned)(viewPosition_.y_ / itemHeight_), numItems_);
+    const unsigned last = Min(first + Min(numVisible, (unsigned)pool_.size()), numItems_);
+    const int width = contentElement_->GetWidth();
+
+    for (unsigned index = first; index < last; ++index)
+    {
+        const unsigned slot = index % pool_.size();
+        UIElement* item = pool_[slot];
+        if (boundIndices_[slot] != index)
+        {
+            boundIndices_[slot] = index;
+            BindItem(item, index);
+        }
+        item->SetPosition(0, (int)index * itemHeight_);
+        item->SetSize(width, itemHeight_);
+        item->SetSelected(index == selection_);
+        item->SetVisible(true);
+    }
+
+    for (unsigned slot = 0; slot < pool_.size(); ++slot)
+    {
+        const unsigned index = boundIndices_[slot];
+        if (index < first || index >= last)
+            pool_[slot]->SetVisible(false);
+    }
+}
+
+SharedPtr<UIElement> VirtualListView::CreateItem()
+{
+    SharedPtr<UIElement> item;
+    if (itemFactory_)
+        item = itemFactory_(this);
+    else
+        item = MakeShared<Text>(context_);
+
+    if (!item)
+        return nullptr;
+
+    contentElement_->AddChild(item);
+    if (!itemFactory_)
+    {
+        item->SetStyleAuto();
+        item->SetEnabled(true);
+    }
+    return item;
+}
+
+void VirtualListView::BindItem(UIElement* item, unsigned index)
+{
+    if (itemBinder_)
+    {
+        itemBinder_(item, index);
+        return;
+    }
+
+    using namespace VirtualItemBind;
+
+    VariantMap& eventData = GetEventDataMap();
+    eventData[P_ELEMENT] = this;
+    eventData[P_ITEM] = item;
+    eventData[P_INDEX] = index;
+    SendEvent(E_VIRTUALITEMBIND, eventData);
+}
+
+UIElement* VirtualListView::FindPooledItem(UIElement* element) const
+{
+    while (element)
+    {
+        UIElement* parent = element->GetParent();
+        if (parent == contentElement_)
+            return element;
+        element = parent;
+    }
+    return nullptr;
+}
+
+void VirtualListView::HandleViewChanged(StringHash eventType, VariantMap& eventData)
+{
+    UpdateVisibleItems();
+}
+
+void VirtualListView::HandleUIMouseClick(StringHash eventType, VariantMap& eventData)
+{
+    using namespace UIMouseClick;
+
+    auto* element = static_cast<UIElement*>(eventData[P_ELEMENT].GetPtr());
+    UIElement* item = FindPooledItem(element);
+    const unsigned index = GetItemIndex(item);
+    if (index == M_MAX_UNSIGNED)
+        return;
+
+    const int button = eventData[P_BUTTON].GetInt();
+    if (editable_ && button == MOUSEB_LEFT)
+        SetSelection(index);
+
+    VariantMap& clickEventData = GetEventDataMap();
+    clickEventData[ItemClicked::P_ELEMENT] = this;
+    clickEventData[ItemClicked::P_ITEM] = item;
+    clickEventData[ItemClicked::P_SELECTION] = index;
+    clickEventData[ItemClicked::P_BUTTON] = button;
+    clickEventData[ItemClicked::P_BUTTONS] = eventData[P_BUTTONS].GetInt();
+    clickEventData[ItemClicked::P_QUALIFIERS] = eventData[P_QUALIFIERS].GetInt();
+    SendEvent(E_ITEMCLICKED, clickEventData);
+}
+
+void VirtualListView::HandleUIMouseDoubleClick(StringHash eventType, VariantMap& eventData)
+{
+    using namespace UIMouseDoubleClick;
+
+    auto* element = static_cast<UIElement*>(eventData[P_ELEMENT].GetPtr());
+    UIElement* item = FindPooledItem(element);
+    const unsigned index = GetItemIndex(item);
+    if (index == M_MAX_UNSIGNED)
+        return;
+
+    VariantMap& clickEventData = GetEventDataMap();
+    clickEventData[ItemDoubleClicked::P_ELEMENT] = this;
+    clickEventData[ItemDoubleClicked::P_ITEM] = item;
+    clickEventData[ItemDoubleClicked::P_SELECTION] = index;
+    clickEventData[ItemDoubleClicked::P_BUTTON] = eventData[P_BUTTON].GetInt();
+    clickEventData[ItemDoubleClicked::P_BUTTONS] = eventData[P_BUTTONS].GetInt();
+    clickEventData[ItemDoubleClicked::P_QUALIFIERS] = eventData[P_QUALIFIERS].GetInt();
+    SendEvent(E_ITEMDOUBLECLICKED, clickEventData);
+}
+
+}
@@ -0,0 +1,138 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include "../Input/InputConstants.h"
+#include "../UI/ScrollView.h"
+
+#include <functional>
+
+namespace Urho3D
+{
+
+class VirtualListView;
+
+/// Callback that creates a new pooled item element.
+using VirtualListItemFactory = std::function<SharedPtr<UIElement>(VirtualListView* listView)>;
+/// Callback that fills a pooled item element with the data at index.
+using VirtualListItemBinder = std::function<void(UIElement* item, unsigned index)>;
+
+/// Scrollable list %UI element for very large item counts. Items have fixed height and are provided by a data source on demand.
+/// Only a small pool of item elements covering the visible range is created; the elements are recycled while scrolling.
+class URHO3D_API VirtualListView : public ScrollView
+{
+    URHO3D_OBJECT(VirtualListView, ScrollView);
+
+public:
+    /// Construct.
+    explicit VirtualListView(Context* context);
+    /// Destruct.
+    ~VirtualListView() override;
+    /// Register object factory.
+    /// @nobind
+    static void RegisterObject(Context* context);
+
+    /// React to a key press.
+    void OnKey(Key key, MouseButtonFlags buttons, QualifierFlags qualifiers) override;
+    /// React to resize.
+    void OnResize(const IntVector2& newSize, const IntVector2& delta) override;
+
+    /// Set callback that creates item elements. By default %Text elements with automatic style are created.
+    void SetItemFactory(const VirtualListItemFactory& factory);
+    /// Set callback that fills item elements with data. If not set, the VirtualItemBind event is sent instead.
+    void SetItemBinder(const VirtualListItemBinder& binder);
+    /// Set number of items in the data source. Visible items are rebound.
+    /// @property
+    void SetNumItems(unsigned numItems);
+    /// Set height of each item in pixels.
+    /// @property
+    void SetItemHeight(int height);
+    /// Rebind visible items after the data source has changed.
+    void RefreshItems();
+    /// Set selection. M_MAX_UNSIGNED clears it.
+    /// @property
+    void SetSelection(unsigned index);
+    /// Move selection by a delta and clamp at list ends.
+    void ChangeSelection(int delta);
+    /// Clear selection.
+    void ClearSelection();
+    /// Scroll the view so that the item is fully visible.
+    void EnsureItemVisibility(unsigned index);
+
+    /// Return number of items in the data source.
+    /// @property
+    unsigned GetNumItems() const { return numItems_; }
+
+    /// Return height of each item in pixels.
+    /// @property
+    int GetItemHeight() const { return itemHeight_; }
+
+    /// Return selected index, or M_MAX_UNSIGNED if none selected.
+    /// @property
+    unsigned GetSelection() const { return selection_; }
+
+    /// Return item element currently bound to index, or null if the item is not within the visible range.
+    UIElement* GetItem(unsigned index) const;
+    /// Return index an item element is bound to, or M_MAX_UNSIGNED if the element is not a visible item of this list.
+    unsigned GetItemIndex(UIElement* item) const;
+    /// Return number of pooled item elements.
+    /// @property
+    unsigned GetNumPooledItems() const { return pool_.size(); }
+
+private:
+    /// Resize content element to match the item count.
+    void UpdateContentSize();
+    /// Grow the pool to cover the visible range, then position and bind the visible items.
+    void UpdateVisibleItems();
+    /// Create a new pooled item element.
+    SharedPtr<UIElement> CreateItem();
+    /// Fill item element with data.
+    void BindItem(UIElement* item, unsigned index);
+    /// Return pooled item element containing the element, or null.
+    UIElement* FindPooledItem(UIElement* element) const;
+    /// Handle view position change.
+    void HandleViewChanged(StringHash eventType, VariantMap& eventData);
+    /// Handle global UI mouse click to check for selection change.
+    void HandleUIMouseClick(StringHash eventType, VariantMap& eventData);
+    /// Handle global UI mouse doubleclick.
+    void HandleUIMouseDoubleClick(StringHash eventType, VariantMap& eventData);
+
+    /// Item factory callback.
+    VirtualListItemFactory itemFactory_;
+    /// Item binder callback.
+    VirtualListItemBinder itemBinder_;
+    /// Pooled item elements.
+    ea::vector<SharedPtr<UIElement> > pool_;
+    /// Index each pooled item element is bound to, or M_MAX_UNSIGNED.
+    ea::vector<unsigned> boundIndices_;
+    /// Number of items in the data source.
+    unsigned numItems_;
+    /// Item height.
+    int itemHeight_;
+    /// Selected index.
+    unsigned selection_;
+};
+
+}
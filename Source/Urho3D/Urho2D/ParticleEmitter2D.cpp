@@ -240,9 +240,12 @@ void ParticleEmitter2D::UpdateSourceBatches()
     vertex2.uv_ = textureRect.max_;
     vertex3.uv_ = Vector2(textureRect.max_.x_, textureRect.min_.y_);
 
+    // Write the quads directly into the preallocated vertex array
+    vertices.resize(numParticles_ * 4);
+    Vertex2D* dest = vertices.data();
     for (unsigned i = 0; i < numParticles_; ++i)
     {
-        Particle2D& p = particles_[i];
+        const Particle2D& p = particles_[i];
 
         float rotation = -p.rotation_;
         float c = Cos(rotation);
@@ -257,10 +260,11 @@ void ParticleEmitter2D::UpdateSourceBatches()
 
         vertex0.color_ = vertex1.color_ = vertex2.color_ = vertex3.color_ = p.color_.ToUInt();
 
-        vertices.push_back(vertex0);
-        vertices.push_back(vertex1);
-        vertices.push_back(vertex2);
-        vertices.push_back(vertex3);
+        dest[0] = vertex0;
+        dest[1] = vertex1;
+        dest[2] = vertex2;
+        dest[3] = vertex3;
+        dest += 4;
     }
 
     sourceBatchesDirty_ = false;
@@ -319,13 +323,17 @@ void ParticleEmitter2D::Update(float timeStep)
     boundingBoxMinPoint_ = Vector3(M_INFINITY, M_INFINITY, M_INFINITY);
     boundingBoxMaxPoint_ = Vector3(-M_INFINITY, -M_INFINITY, -M_INFINITY);
 
+    // Effect parameters are constant for all particles of this update
+    const bool radial = effect_->GetEmitterType() == EMITTER_TYPE_RADIAL;
+    const Vector2 gravity = effect_->GetGravity() * worldScale;
+
     unsigned particleIndex = 0;
     while (particleIndex < numParticles_)
     {
         Particle2D& particle = particles_[particleIndex];
         if (particle.timeToLive_ > 0.0f)
         {
-            UpdateParticle(particle, timeStep, worldPosition, worldScale);
+            UpdateParticle(particle, timeStep, radial, gravity);
             ++particleIndex;
         }
         else
@@ -346,7 +354,7 @@ void ParticleEmitter2D::Update(float timeStep)
         while (emitParticleTime_ > 0.0f)
         {
             if (EmitParticle(worldPosition, worldAngle, worldScale))
-                UpdateParticle(particles_[numParticles_ - 1], emitParticleTime_, worldPosition, worldScale);
+                UpdateParticle(particles_[numParticles_ - 1], emitParticleTime_, radial, gravity);
 
             emitParticleTime_ -= timeBetweenParticles;
         }
@@ -414,14 +422,14 @@ bool ParticleEmitter2D::EmitParticle(const Vector3& worldPosition, float worldAn
     return true;
 }
 
-void ParticleEmitter2D::UpdateParticle(Particle2D& particle, float timeStep, const Vector3& worldPosition, float worldScale)
+void ParticleEmitter2D::UpdateParticle(Particle2D& particle, float timeStep, bool radial, const Vector2& gravity)
 {
     if (timeStep > particle.timeToLive_)
         timeStep = particle.timeToLive_;
 
     particle.timeToLive_ -= timeStep;
 
-    if (effect_->GetEmitterType() == EMITTER_TYPE_RADIAL)
+    if (radial)
     {
         particle.emitRotation_ += particle.emitRotationDelta_ * timeStep;
         particle.emitRadius_ += particle.emitRadiusDelta_ * timeStep;
@@ -451,8 +459,8 @@ void ParticleEmitter2D::UpdateParticle(Particle2D& particle, float timeStep, con
         tangentialX = -tangentialY * particle.tangentialAcceleration_;
         tangentialY = newY * particle.tangentialAcceleration_;
 
-        particle.velocity_.x_ += (effect_->GetGravity().x_ * worldScale + radialX - tangentialX) * timeStep;
-        particle.velocity_.y_ -= (effect_->GetGravity().y_ * worldScale - radialY + tangentialY) * timeStep;
+        particle.velocity_.x_ += (gravity.x_ + radialX - tangentialX) * timeStep;
+        particle.velocity_.y_ -= (gravity.y_ - radialY + tangentialY) * timeStep;
         particle.position_.x_ += particle.velocity_.x_ * timeStep;
         particle.position_.y_ += particle.velocity_.y_ * timeStep;
     }
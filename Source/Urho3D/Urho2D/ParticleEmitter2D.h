@@ -148,7 +148,7 @@ private:
     /// Emit particle.
     bool EmitParticle(const Vector3& worldPosition, float worldAngle, float worldScale);
     /// Update particle.
-    void UpdateParticle(Particle2D& particle, float timeStep, const Vector3& worldPosition, float worldScale);
+    void UpdateParticle(Particle2D& particle, float timeStep, bool radial, const Vector2& gravity);
 
     /// Particle effect.
     SharedPtr<ParticleEffect2D> effect_;
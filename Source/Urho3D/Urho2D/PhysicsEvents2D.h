@@ -71,6 +71,12 @@ URHO3D_EVENT(E_PHYSICSENDCONTACT2D, PhysicsEndContact2D)
     URHO3D_PARAM(P_SHAPEB, ShapeB);                // CollisionShape2D pointer
 }
 
+/// Physics contacts of one simulation step in batch. Global event sent by PhysicsWorld2D. Contact lists are available from PhysicsWorld2D::GetBeginContacts() and GetEndContacts() while handling the event.
+URHO3D_EVENT(E_PHYSICSCONTACTS2D, PhysicsContacts2D)
+{
+    URHO3D_PARAM(P_WORLD, World);                  // PhysicsWorld2D pointer
+}
+
 /// Node update contact. Sent by scene nodes participating in a collision.
 URHO3D_EVENT(E_NODEUPDATECONTACT2D, NodeUpdateContact2D)
 {
@@ -24,6 +24,7 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Renderer.h"
@@ -45,12 +46,14 @@ extern const char* SUBSYSTEM_CATEGORY;
 static const Vector2 DEFAULT_GRAVITY(0.0f, -9.81f);
 static const int DEFAULT_VELOCITY_ITERATIONS = 8;
 static const int DEFAULT_POSITION_ITERATIONS = 3;
+static const int DEFAULT_FPS_2D = 60;
 
 PhysicsWorld2D::PhysicsWorld2D(Context* context) :
     Component(context),
     gravity_(DEFAULT_GRAVITY),
     velocityIterations_(DEFAULT_VELOCITY_ITERATIONS),
-    positionIterations_(DEFAULT_POSITION_ITERATIONS)
+    positionIterations_(DEFAULT_POSITION_ITERATIONS),
+    fps_(DEFAULT_FPS_2D)
 {
     // Set default debug draw flags
     m_drawFlags = e_shapeBit;
@@ -89,6 +92,10 @@ void PhysicsWorld2D::RegisterObject(Context* context)
         AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Position Iterations", GetPositionIterations, SetPositionIterations, int, DEFAULT_POSITION_ITERATIONS,
         AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Physics FPS", GetFps, SetFps, int, DEFAULT_FPS_2D, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Max Substeps", GetMaxSubSteps, SetMaxSubSteps, int, 0, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Interpolation", GetInterpolation, SetInterpolation, bool, true, AM_FILE);
+    URHO3D_ACCESSOR_ATTRIBUTE("Contact Events", GetContactEvents, SetContactEvents, bool, true, AM_DEFAULT);
 }
 
 void PhysicsWorld2D::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
@@ -133,6 +140,10 @@ void PhysicsWorld2D::EndContact(b2Contact* contact)
 
 void PhysicsWorld2D::PreSolve(b2Contact* contact, const b2Manifold* oldManifold)
 {
+    // Events can not be sent from worker threads
+    if (!contactEvents_ || threadedStepping_)
+        return;
+
     b2Fixture* fixtureA = contact->GetFixtureA();
     b2Fixture* fixtureB = contact->GetFixtureB();
     if (!fixtureA || !fixtureB)
@@ -280,23 +291,122 @@ void PhysicsWorld2D::Update(float timeStep)
 {
     URHO3D_PROFILE("UpdatePhysics2D");
 
+    float internalTimeStep;
+    const unsigned numSteps = CalculateNumSteps(timeStep, internalTimeStep);
+    for (unsigned i = 0; i < numSteps; ++i)
+    {
+        SendStepEvent(E_PHYSICSPRESTEP, internalTimeStep);
+        StepWorld(internalTimeStep, i + 1 == numSteps);
+        SendContactEvents();
+        SendStepEvent(E_PHYSICSPOSTSTEP, internalTimeStep);
+    }
+
+    // Interpolated transforms change even when no step was taken
+    if (numSteps || interpolation_)
+        ApplyWorldTransforms();
+}
+
+void PhysicsWorld2D::UpdateWorlds(const ea::vector<PhysicsWorld2D*>& worlds, float timeStep)
+{
+    if (worlds.empty())
+        return;
+
+    URHO3D_PROFILE("UpdatePhysics2DWorlds");
+
+    ea::vector<unsigned> numSteps(worlds.size());
+    ea::vector<float> internalTimeSteps(worlds.size());
+    for (unsigned i = 0; i < worlds.size(); ++i)
+    {
+        numSteps[i] = worlds[i]->CalculateNumSteps(timeStep, internalTimeSteps[i]);
+        if (numSteps[i])
+            worlds[i]->SendStepEvent(E_PHYSICSPRESTEP, numSteps[i] * internalTimeSteps[i]);
+    }
+
+    // Box2D worlds share no state, so each can be stepped on its own thread
+    auto* workQueue = worlds[0]->GetSubsystem<WorkQueue>();
+    workQueue->ParallelFor(worlds.size(), 1, [&](unsigned begin, unsigned end, unsigned /*threadIndex*/)
+    {
+        for (unsigned i = begin; i < end; ++i)
+        {
+            PhysicsWorld2D* world = worlds[i];
+            world->threadedStepping_ = true;
+            for (unsigned step = 0; step < numSteps[i]; ++step)
+                world->StepWorld(internalTimeSteps[i], step + 1 == numSteps[i]);
+            world->threadedStepping_ = false;
+        }
+    });
+
+    for (unsigned i = 0; i < worlds.size(); ++i)
+    {
+        PhysicsWorld2D* world = worlds[i];
+        world->SendContactEvents();
+        if (numSteps[i])
+            world->SendStepEvent(E_PHYSICSPOSTSTEP, numSteps[i] * internalTimeSteps[i]);
+        if (numSteps[i] || world->interpolation_)
+            world->ApplyWorldTransforms();
+    }
+}
+
+unsigned PhysicsWorld2D::CalculateNumSteps(float timeStep, float& internalTimeStep)
+{
+    if (maxSubSteps_ < 0)
+    {
+        internalTimeStep = timeStep;
+        timeAcc_ = 0.0f;
+        return 1;
+    }
+
+    internalTimeStep = 1.0f / fps_;
+    timeAcc_ += timeStep;
+    auto numSteps = (unsigned)(timeAcc_ * fps_);
+    timeAcc_ -= numSteps * internalTimeStep;
+
+    // Drop the time that can not be simulated within the substep limit
+    if (maxSubSteps_ > 0 && numSteps > (unsigned)maxSubSteps_)
+    {
+        numSteps = maxSubSteps_;
+        timeAcc_ = 0.0f;
+    }
+
+    return numSteps;
+}
+
+void PhysicsWorld2D::StepWorld(float internalTimeStep, bool lastStep)
+{
+    if (lastStep && interpolation_)
+    {
+        for (const WeakPtr<RigidBody2D>& rigidBody : rigidBodies_)
+        {
+            if (rigidBody)
+                rigidBody->StorePreviousTransform();
+        }
+    }
+
+    physicsStepping_ = true;
+    world_->Step(internalTimeStep, velocityIterations_, positionIterations_);
+    physicsStepping_ = false;
+}
+
+void PhysicsWorld2D::SendStepEvent(StringHash eventType, float timeStep)
+{
     using namespace PhysicsPreStep;
 
     VariantMap& eventData = GetEventDataMap();
     eventData[P_WORLD] = this;
     eventData[P_TIMESTEP] = timeStep;
-    SendEvent(E_PHYSICSPRESTEP, eventData);
+    SendEvent(eventType, eventData);
+}
 
-    physicsStepping_ = true;
-    world_->Step(timeStep, velocityIterations_, positionIterations_);
-    physicsStepping_ = false;
+void PhysicsWorld2D::ApplyWorldTransforms()
+{
+    const float interpolation = interpolation_ && maxSubSteps_ >= 0 ? Min(timeAcc_ * fps_, 1.0f) : 1.0f;
 
     // Apply world transforms. Unparented transforms first
     for (unsigned i = 0; i < rigidBodies_.size();)
     {
         if (rigidBodies_[i])
         {
-            rigidBodies_[i]->ApplyWorldTransform();
+            rigidBodies_[i]->ApplyWorldTransform(interpolation);
             ++i;
         }
         else
@@ -324,12 +434,27 @@ void PhysicsWorld2D::Update(float timeStep)
                 ++i;
         }
     }
+}
 
-    SendBeginContactEvents();
-    SendEndContactEvents();
+void PhysicsWorld2D::SendContactEvents()
+{
+    if (beginContactInfos_.empty() && endContactInfos_.empty())
+        return;
+
+    using namespace PhysicsContacts2D;
+
+    VariantMap& eventData = GetEventDataMap();
+    eventData[P_WORLD] = this;
+    SendEvent(E_PHYSICSCONTACTS2D, eventData);
 
-    using namespace PhysicsPostStep;
-    SendEvent(E_PHYSICSPOSTSTEP, eventData);
+    if (contactEvents_)
+    {
+        SendBeginContactEvents();
+        SendEndContactEvents();
+    }
+
+    beginContactInfos_.clear();
+    endContactInfos_.clear();
 }
 
 void PhysicsWorld2D::DrawDebugGeometry()
@@ -427,6 +552,26 @@ void PhysicsWorld2D::SetPositionIterations(int positionIterations)
     positionIterations_ = positionIterations;
 }
 
+void PhysicsWorld2D::SetFps(int fps)
+{
+    fps_ = Clamp(fps, 1, 1000);
+}
+
+void PhysicsWorld2D::SetMaxSubSteps(int num)
+{
+    maxSubSteps_ = num;
+}
+
+void PhysicsWorld2D::SetInterpolation(bool enable)
+{
+    interpolation_ = enable;
+}
+
+void PhysicsWorld2D::SetContactEvents(bool enable)
+{
+    contactEvents_ = enable;
+}
+
 void PhysicsWorld2D::AddRigidBody(RigidBody2D* rigidBody)
 {
     if (!rigidBody)
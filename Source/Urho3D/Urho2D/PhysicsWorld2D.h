@@ -72,6 +72,39 @@ class URHO3D_API PhysicsWorld2D : public Component, public b2ContactListener, pu
     URHO3D_OBJECT(PhysicsWorld2D, Component);
 
 public:
+    /// Contact info.
+    /// @nobind
+    struct ContactInfo
+    {
+        /// Construct.
+        ContactInfo();
+        /// Construct.
+        explicit ContactInfo(b2Contact* contact);
+        /// Write contact info to buffer.
+        const ea::vector<unsigned char>& Serialize(VectorBuffer& buffer) const;
+
+        /// Rigid body A.
+        SharedPtr<RigidBody2D> bodyA_;
+        /// Rigid body B.
+        SharedPtr<RigidBody2D> bodyB_;
+        /// Node A.
+        SharedPtr<Node> nodeA_;
+        /// Node B.
+        SharedPtr<Node> nodeB_;
+        /// Shape A.
+        SharedPtr<CollisionShape2D> shapeA_;
+        /// Shape B.
+        SharedPtr<CollisionShape2D> shapeB_;
+        /// Number of contact points.
+        int numPoints_{};
+        /// Contact normal in world space.
+        Vector2 worldNormal_;
+        /// Contact positions in world space.
+        Vector2 worldPositions_[b2_maxManifoldPoints];
+        /// Contact overlap values.
+        float separations_[b2_maxManifoldPoints]{};
+    };
+
     /// Construct.
     explicit PhysicsWorld2D(Context* context);
     /// Destruct.
@@ -109,6 +142,8 @@ public:
 
     /// Step the simulation forward.
     void Update(float timeStep);
+    /// Step several worlds forward, running their Box2D simulations in parallel on the work queue. Events and transform updates are processed on the main thread afterwards, so pre-step and post-step events are sent once per world for all substeps of the frame and update contact events are not sent. Intended for worlds with automatic update disabled.
+    static void UpdateWorlds(const ea::vector<PhysicsWorld2D*>& worlds, float timeStep);
     /// Add debug geometry to the debug renderer.
     void DrawDebugGeometry();
     /// Enable or disable automatic physics simulation during scene update. Enabled by default.
@@ -153,6 +188,18 @@ public:
     /// Set position iterations.
     /// @property
     void SetPositionIterations(int positionIterations);
+    /// Set simulation substeps per second.
+    /// @property
+    void SetFps(int fps);
+    /// Set maximum number of physics substeps per frame. 0 (default) is unlimited. Positive values cap the amount. Use a negative value to step once per frame with a variable timestep.
+    /// @property
+    void SetMaxSubSteps(int num);
+    /// Set whether to interpolate rigid body transforms between simulation steps.
+    /// @property
+    void SetInterpolation(bool enable);
+    /// Set whether to send begin, end and update events for each contact. When disabled, contacts are reported only in batch by the E_PHYSICSCONTACTS2D event.
+    /// @property
+    void SetContactEvents(bool enable);
     /// Add rigid body.
     void AddRigidBody(RigidBody2D* rigidBody);
     /// Remove rigid body.
@@ -225,6 +272,30 @@ public:
     /// @property
     int GetPositionIterations() const { return positionIterations_; }
 
+    /// Return simulation substeps per second.
+    /// @property
+    int GetFps() const { return fps_; }
+
+    /// Return maximum number of physics substeps per frame.
+    /// @property
+    int GetMaxSubSteps() const { return maxSubSteps_; }
+
+    /// Return whether interpolation between simulation steps is enabled.
+    /// @property
+    bool GetInterpolation() const { return interpolation_; }
+
+    /// Return whether per-contact events are sent.
+    /// @property
+    bool GetContactEvents() const { return contactEvents_; }
+
+    /// Return contacts that began in the last simulation step. Valid while handling E_PHYSICSCONTACTS2D.
+    /// @nobind
+    const ea::vector<ContactInfo>& GetBeginContacts() const { return beginContactInfos_; }
+
+    /// Return contacts that ended in the last simulation step. Valid while handling E_PHYSICSCONTACTS2D.
+    /// @nobind
+    const ea::vector<ContactInfo>& GetEndContacts() const { return endContactInfos_; }
+
     /// Return the Box2D physics world.
     b2World* GetWorld() { return world_.get(); }
 
@@ -240,6 +311,16 @@ protected:
 
     /// Handle the scene subsystem update event, step simulation here.
     void HandleSceneSubsystemUpdate(StringHash eventType, VariantMap& eventData);
+    /// Advance the time accumulator and return number of simulation steps to take and their length.
+    unsigned CalculateNumSteps(float timeStep, float& internalTimeStep);
+    /// Step the Box2D world once. Previous rigid body transforms are stored before the last step of the frame for interpolation.
+    void StepWorld(float internalTimeStep, bool lastStep);
+    /// Send pre-step or post-step event.
+    void SendStepEvent(StringHash eventType, float timeStep);
+    /// Apply rigid body transforms to scene nodes.
+    void ApplyWorldTransforms();
+    /// Send batched and per-contact events for the last simulation step.
+    void SendContactEvents();
     /// Send begin contact events.
     void SendBeginContactEvents();
     /// Send end contact events.
@@ -253,6 +334,12 @@ protected:
     int velocityIterations_{};
     /// Position iterations.
     int positionIterations_{};
+    /// Simulation substeps per second.
+    int fps_{};
+    /// Maximum number of simulation substeps per frame.
+    int maxSubSteps_{};
+    /// Time not yet simulated.
+    float timeAcc_{};
 
     /// Extra weak pointer to scene to allow for cleanup in case the world is destroyed before other components.
     WeakPtr<Scene> scene_;
@@ -267,42 +354,17 @@ protected:
     bool physicsStepping_{};
     /// Applying transforms.
     bool applyingTransforms_{};
+    /// Whether the world is being stepped on a worker thread. Used internally.
+    bool threadedStepping_{};
+    /// Interpolation flag.
+    bool interpolation_{true};
+    /// Per-contact events flag.
+    bool contactEvents_{true};
     /// Rigid bodies.
     ea::vector<WeakPtr<RigidBody2D> > rigidBodies_;
     /// Delayed (parented) world transform assignments.
     ea::unordered_map<RigidBody2D*, DelayedWorldTransform2D> delayedWorldTransforms_;
 
-    /// Contact info.
-    struct ContactInfo
-    {
-        /// Construct.
-        ContactInfo();
-        /// Construct.
-        explicit ContactInfo(b2Contact* contact);
-        /// Write contact info to buffer.
-        const ea::vector<unsigned char>& Serialize(VectorBuffer& buffer) const;
-
-        /// Rigid body A.
-        SharedPtr<RigidBody2D> bodyA_;
-        /// Rigid body B.
-        SharedPtr<RigidBody2D> bodyB_;
-        /// Node A.
-        SharedPtr<Node> nodeA_;
-        /// Node B.
-        SharedPtr<Node> nodeB_;
-        /// Shape A.
-        SharedPtr<CollisionShape2D> shapeA_;
-        /// Shape B.
-        SharedPtr<CollisionShape2D> shapeB_;
-        /// Number of contact points.
-        int numPoints_{};
-        /// Contact normal in world space.
-        Vector2 worldNormal_;
-        /// Contact positions in world space.
-        Vector2 worldPositions_[b2_maxManifoldPoints];
-        /// Contact overlap values.
-        float separations_[b2_maxManifoldPoints]{};
-    };
     /// Begin contact infos.
     ea::vector<ContactInfo> beginContactInfos_;
     /// End contact infos.
@@ -205,8 +205,7 @@ void Renderer2D::UpdateGeometry(const FrameInfo& frame)
                 for (unsigned b = 0; b < sourceBatches.size(); ++b)
                 {
                     const ea::vector<Vertex2D>& vertices = sourceBatches[b]->vertices_;
-                    for (unsigned i = 0; i < vertices.size(); ++i)
-                        dest[i] = vertices[i];
+                    memcpy(dest, vertices.data(), vertices.size() * sizeof(Vertex2D));
                     dest += vertices.size();
                 }
 
@@ -316,7 +315,11 @@ void CheckDrawableVisibilityWork(const WorkItem* item, unsigned threadIndex)
     {
         Drawable2D* drawable = *start++;
         if (renderer->CheckVisibility(drawable))
+        {
             drawable->MarkInView(renderer->frame_);
+            // Generate dirty vertices here so that it is spread over the worker threads
+            drawable->GetSourceBatches();
+        }
     }
 }
 
@@ -340,6 +343,8 @@ void Renderer2D::HandleBeginViewUpdate(StringHash eventType, VariantMap& eventDa
     {
         URHO3D_PROFILE("CheckDrawableVisibility");
 
+        // Visible drawables also update their source batches in the work items
+
         auto* queue = GetSubsystem<WorkQueue>();
         int numWorkItems = queue->GetNumThreads() + 1; // Worker threads + main thread
         int drawablesPerItem = drawables_.size() / numWorkItems;
@@ -36,6 +36,7 @@ class Technique;
 class VertexBuffer;
 struct FrameInfo;
 struct SourceBatch2D;
+struct WorkItem;
 
 /// 2D view batch info.
 /// @nobind
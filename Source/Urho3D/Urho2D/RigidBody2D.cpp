@@ -375,6 +375,7 @@ void RigidBody2D::CreateBody()
 
     body_ = physicsWorld_->GetWorld()->CreateBody(&bodyDef_);
     body_->SetUserData(this);
+    StorePreviousTransform();
 
     for (unsigned i = 0; i < collisionShapes_.size(); ++i)
     {
@@ -418,7 +419,7 @@ void RigidBody2D::ReleaseBody()
     body_ = nullptr;
 }
 
-void RigidBody2D::ApplyWorldTransform()
+void RigidBody2D::ApplyWorldTransform(float interpolation)
 {
     if (!body_ || !node_)
         return;
@@ -434,11 +435,19 @@ void RigidBody2D::ApplyWorldTransform()
     if (!parentRigidBody && (!body_->IsActive() || body_->GetType() == b2_staticBody || !body_->IsAwake()))
         return;
 
-    const b2Transform& transform = body_->GetTransform();
+    // Body angle is continuous, so it can be interpolated directly
+    b2Vec2 position = body_->GetPosition();
+    float angle = body_->GetAngle();
+    if (interpolation < 1.0f)
+    {
+        position = previousPosition_ + interpolation * (position - previousPosition_);
+        angle = previousAngle_ + interpolation * (angle - previousAngle_);
+    }
+
     Vector3 newWorldPosition = node_->GetWorldPosition();
-    newWorldPosition.x_ = transform.p.x;
-    newWorldPosition.y_ = transform.p.y;
-    Quaternion newWorldRotation(transform.q.GetAngle() * M_RADTODEG, Vector3::FORWARD);
+    newWorldPosition.x_ = position.x;
+    newWorldPosition.y_ = position.y;
+    Quaternion newWorldRotation(angle * M_RADTODEG, Vector3::FORWARD);
 
     if (parentRigidBody)
     {
@@ -453,6 +462,15 @@ void RigidBody2D::ApplyWorldTransform()
         ApplyWorldTransform(newWorldPosition, newWorldRotation);
 }
 
+void RigidBody2D::StorePreviousTransform()
+{
+    if (!body_)
+        return;
+
+    previousPosition_ = body_->GetPosition();
+    previousAngle_ = body_->GetAngle();
+}
+
 void RigidBody2D::ApplyWorldTransform(const Vector3& newWorldPosition, const Quaternion& newWorldRotation)
 {
     if (newWorldPosition != node_->GetWorldPosition() || newWorldRotation != node_->GetWorldRotation())
@@ -607,7 +625,11 @@ void RigidBody2D::OnMarkedDirty(Node* node)
         bodyDef_.angle = newAngle;
     }
     else if (newPosition != body_->GetPosition() || newAngle != body_->GetAngle())
+    {
+        // Teleport without interpolating from the old transform
         body_->SetTransform(newPosition, newAngle);
+        StorePreviousTransform();
+    }
 }
 
 }
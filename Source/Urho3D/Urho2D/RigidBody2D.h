@@ -123,8 +123,10 @@ public:
     /// Release body.
     void ReleaseBody();
 
-    /// Apply world transform from the Box2D body. Called by PhysicsWorld2D.
-    void ApplyWorldTransform();
+    /// Apply world transform from the Box2D body, blended from the previous simulation step by the interpolation factor. Called by PhysicsWorld2D.
+    void ApplyWorldTransform(float interpolation = 1.0f);
+    /// Remember the current Box2D body transform as the start of the interpolation. Called by PhysicsWorld2D before the last simulation step of the frame.
+    void StorePreviousTransform();
     /// Apply specified world position & rotation. Called by PhysicsWorld2D.
     void ApplyWorldTransform(const Vector3& newWorldPosition, const Quaternion& newWorldRotation);
     /// Add collision shape.
@@ -208,6 +210,10 @@ private:
     bool useFixtureMass_;
     /// Box2D body.
     b2Body* body_;
+    /// Body position before the last simulation step.
+    b2Vec2 previousPosition_{0.0f, 0.0f};
+    /// Body angle before the last simulation step.
+    float previousAngle_{};
     /// Collision shapes.
     ea::vector<WeakPtr<CollisionShape2D> > collisionShapes_;
     /// Constraints.
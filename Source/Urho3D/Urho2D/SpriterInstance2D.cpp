@@ -115,11 +115,13 @@ bool SpriterInstance::SetAnimation(const ea::string& animationName, LoopMode loo
 void SpriterInstance::setSpatialInfo(const SpatialInfo& spatialInfo)
 {
     this->spatialInfo_ = spatialInfo;
+    evaluationDirty_ = true;
 }
 
 void SpriterInstance::setSpatialInfo(float x, float y, float angle, float scaleX, float scaleY)
 {
     spatialInfo_ = SpatialInfo(x, y, angle, scaleX, scaleY);
+    evaluationDirty_ = true;
 }
 
 void SpriterInstance::Update(float deltaTime)
@@ -127,8 +129,6 @@ void SpriterInstance::Update(float deltaTime)
     if (!animation_)
         return;
 
-    Clear();
-
     float lastTime = currentTime_;
     currentTime_ += deltaTime;
     if (currentTime_ > animation_->length_)
@@ -164,8 +164,14 @@ void SpriterInstance::Update(float deltaTime)
         }
     }
 
+    // Keep the previous result when nothing has changed, e.g. when paused or clamped at the end
+    if (!evaluationDirty_ && mainlineKey_ && currentTime_ == lastTime)
+        return;
+
+    Clear();
     UpdateMainlineKey();
     UpdateTimelineKeys();
+    evaluationDirty_ = false;
 }
 
 void SpriterInstance::OnSetEntity(Entity* entity)
@@ -203,7 +209,7 @@ void SpriterInstance::UpdateTimelineKeys()
     for (unsigned i = 0; i < mainlineKey_->boneRefs_.size(); ++i)
     {
         Ref* ref = mainlineKey_->boneRefs_[i];
-        auto* timelineKey = (BoneTimelineKey*)GetTimelineKey(ref);
+        SpatialTimelineKey* timelineKey = GetTimelineKey(ref);
         if (ref->parent_ >= 0)
         {
             timelineKey->info_ = timelineKey->info_.UnmapFromParent(timelineKeys_[ref->parent_]->info_);
@@ -218,7 +224,7 @@ void SpriterInstance::UpdateTimelineKeys()
     for (unsigned i = 0; i < mainlineKey_->objectRefs_.size(); ++i)
     {
         Ref* ref = mainlineKey_->objectRefs_[i];
-        auto* timelineKey = (SpriteTimelineKey*)GetTimelineKey(ref);
+        auto* timelineKey = static_cast<SpriteTimelineKey*>(GetTimelineKey(ref));
 
         if (ref->parent_ >= 0)
         {
@@ -257,10 +263,10 @@ void SpriterInstance::UpdateMainlineKey()
     }
 }
 
-TimelineKey* SpriterInstance::GetTimelineKey(Ref* ref) const
+SpatialTimelineKey* SpriterInstance::GetTimelineKey(Ref* ref)
 {
     Timeline* timeline = animation_->timelines_[ref->timeline_];
-    TimelineKey* timelineKey = timeline->keys_[ref->key_]->Clone();
+    SpatialTimelineKey* timelineKey = CopyTimelineKey(timeline->keys_[ref->key_]);
     if (timeline->keys_.size() == 1 || timelineKey->curveType_ == INSTANT)
     {
         return timelineKey;
@@ -293,18 +299,35 @@ TimelineKey* SpriterInstance::GetTimelineKey(Ref* ref) const
     return timelineKey;
 }
 
+SpatialTimelineKey* SpriterInstance::CopyTimelineKey(const SpatialTimelineKey* key)
+{
+    if (key->GetObjectType() == BONE)
+    {
+        if (numBoneKeys_ == boneKeyPool_.size())
+            boneKeyPool_.emplace_back(new BoneTimelineKey(key->timeline_));
+        BoneTimelineKey* result = boneKeyPool_[numBoneKeys_++].get();
+        *result = *static_cast<const BoneTimelineKey*>(key);
+        return result;
+    }
+    else
+    {
+        if (numSpriteKeys_ == spriteKeyPool_.size())
+            spriteKeyPool_.emplace_back(new SpriteTimelineKey(key->timeline_));
+        SpriteTimelineKey* result = spriteKeyPool_[numSpriteKeys_++].get();
+        *result = *static_cast<const SpriteTimelineKey*>(key);
+        return result;
+    }
+}
+
 void SpriterInstance::Clear()
 {
     mainlineKey_ = nullptr;
+    evaluationDirty_ = true;
 
-    if (!timelineKeys_.empty())
-    {
-        for (unsigned i = 0; i < timelineKeys_.size(); ++i)
-        {
-            delete timelineKeys_[i];
-        }
-        timelineKeys_.clear();
-    }
+    // Keys stay allocated in the pools for reuse
+    timelineKeys_.clear();
+    numBoneKeys_ = 0;
+    numSpriteKeys_ = 0;
 }
 
 }
@@ -26,6 +26,8 @@
 
 #include "../Urho2D/SpriterData2D.h"
 
+#include <EASTL/unique_ptr.h>
+
 namespace Urho3D
 {
 
@@ -84,8 +86,10 @@ private:
     void UpdateMainlineKey();
     /// Update timeline keys.
     void UpdateTimelineKeys();
-    /// Get timeline key by ref.
-    TimelineKey* GetTimelineKey(Ref* ref) const;
+    /// Get interpolated timeline key by ref.
+    SpatialTimelineKey* GetTimelineKey(Ref* ref);
+    /// Return a pooled copy of a timeline key. Pooled keys are reused on every update to avoid allocations.
+    SpatialTimelineKey* CopyTimelineKey(const SpatialTimelineKey* key);
     /// Clear mainline key and timeline keys.
     void Clear();
 
@@ -107,6 +111,16 @@ private:
     MainlineKey* mainlineKey_{};
     /// Current timeline keys.
     ea::vector<SpatialTimelineKey*> timelineKeys_;
+    /// Whether timeline keys must be evaluated on the next update even if the time has not changed.
+    bool evaluationDirty_{true};
+    /// Pool of bone timeline keys.
+    ea::vector<ea::unique_ptr<BoneTimelineKey> > boneKeyPool_;
+    /// Pool of sprite timeline keys.
+    ea::vector<ea::unique_ptr<SpriteTimelineKey> > spriteKeyPool_;
+    /// Number of bone timeline keys in use.
+    unsigned numBoneKeys_{};
+    /// Number of sprite timeline keys in use.
+    unsigned numSpriteKeys_{};
 };
 
 }
@@ -0,0 +1,220 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Graphics/Material.h"
+#include "../Graphics/Texture2D.h"
+#include "../Scene/Node.h"
+#include "../Urho2D/Renderer2D.h"
+#include "../Urho2D/Sprite2D.h"
+#include "../Urho2D/TileMapChunk2D.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+extern const char* URHO2D_CATEGORY;
+
+TileMapChunk2D::TileMapChunk2D(Context* context) :
+    Drawable2D(context),
+    size_(IntVector2::ZERO)
+{
+}
+
+TileMapChunk2D::~TileMapChunk2D() = default;
+
+void TileMapChunk2D::RegisterObject(Context* context)
+{
+    context->RegisterFactory<TileMapChunk2D>(URHO2D_CATEGORY);
+
+    URHO3D_ACCESSOR_ATTRIBUTE("Is Enabled", IsEnabled, SetEnabled, bool, true, AM_DEFAULT);
+    URHO3D_COPY_BASE_ATTRIBUTES(Drawable2D);
+}
+
+void TileMapChunk2D::SetSize(const IntVector2& size)
+{
+    size_ = VectorMax(size, IntVector2::ZERO);
+    tiles_.clear();
+    tiles_.resize(size_.x_ * size_.y_);
+    MarkTilesDirty();
+}
+
+void TileMapChunk2D::SetTile(int x, int y, Sprite2D* sprite, const Vector2& position, bool flipX, bool flipY, bool swapXY)
+{
+    ChunkTile* tile = GetChunkTile(x, y);
+    if (!tile)
+        return;
+
+    tile->sprite_ = sprite;
+    tile->position_ = position;
+    tile->flipX_ = flipX;
+    tile->flipY_ = flipY;
+    tile->swapXY_ = swapXY;
+    UpdateMaterial(*tile);
+    MarkTilesDirty();
+}
+
+void TileMapChunk2D::SetTileSprite(int x, int y, Sprite2D* sprite)
+{
+    ChunkTile* tile = GetChunkTile(x, y);
+    if (!tile || tile->sprite_ == sprite)
+        return;
+
+    tile->sprite_ = sprite;
+    UpdateMaterial(*tile);
+    MarkTilesDirty();
+}
+
+Sprite2D* TileMapChunk2D::GetTileSprite(int x, int y) const
+{
+    if (x < 0 || x >= size_.x_ || y < 0 || y >= size_.y_)
+        return nullptr;
+
+    return tiles_[y * size_.x_ + x].sprite_;
+}
+
+void TileMapChunk2D::OnSceneSet(Scene* scene)
+{
+    Drawable2D::OnSceneSet(scene);
+
+    // Materials depend on the renderer
+    sourceBatches_.clear();
+    for (ChunkTile& tile : tiles_)
+        UpdateMaterial(tile);
+    MarkTilesDirty();
+}
+
+void TileMapChunk2D::OnWorldBoundingBoxUpdate()
+{
+    boundingBox_.Clear();
+    worldBoundingBox_.Clear();
+
+    for (const SourceBatch2D& sourceBatch : GetSourceBatches())
+    {
+        for (const Vertex2D& vertex : sourceBatch.vertices_)
+            worldBoundingBox_.Merge(vertex.position_);
+    }
+
+    if (worldBoundingBox_.Defined())
+        boundingBox_ = worldBoundingBox_.Transformed(node_->GetWorldTransform().Inverse());
+}
+
+void TileMapChunk2D::OnDrawOrderChanged()
+{
+    for (SourceBatch2D& sourceBatch : sourceBatches_)
+        sourceBatch.drawOrder_ = GetDrawOrder();
+}
+
+void TileMapChunk2D::UpdateSourceBatches()
+{
+    if (!sourceBatchesDirty_)
+        return;
+
+    for (SourceBatch2D& sourceBatch : sourceBatches_)
+        sourceBatch.vertices_.clear();
+
+    const Matrix3x4& worldTransform = node_->GetWorldTransform();
+    const unsigned color = Color::WHITE.ToUInt();
+
+    // Tiles are emitted in row-major order into the source batch of their material
+    for (const ChunkTile& tile : tiles_)
+    {
+        if (tile.batchIndex_ == M_MAX_UNSIGNED)
+            continue;
+
+        Rect drawRect;
+        Rect textureRect;
+        if (!tile.sprite_->GetDrawRectangle(drawRect, tile.flipX_, tile.flipY_) ||
+            !tile.sprite_->GetTextureRectangle(textureRect, tile.flipX_, tile.flipY_))
+            continue;
+
+        Vertex2D vertex0;
+        Vertex2D vertex1;
+        Vertex2D vertex2;
+        Vertex2D vertex3;
+
+        drawRect.min_ += tile.position_;
+        drawRect.max_ += tile.position_;
+        vertex0.position_ = worldTransform * Vector3(drawRect.min_.x_, drawRect.min_.y_, 0.0f);
+        vertex1.position_ = worldTransform * Vector3(drawRect.min_.x_, drawRect.max_.y_, 0.0f);
+        vertex2.position_ = worldTransform * Vector3(drawRect.max_.x_, drawRect.max_.y_, 0.0f);
+        vertex3.position_ = worldTransform * Vector3(drawRect.max_.x_, drawRect.min_.y_, 0.0f);
+
+        vertex0.uv_ = textureRect.min_;
+        (tile.swapXY_ ? vertex3.uv_ : vertex1.uv_) = Vector2(textureRect.min_.x_, textureRect.max_.y_);
+        vertex2.uv_ = textureRect.max_;
+        (tile.swapXY_ ? vertex1.uv_ : vertex3.uv_) = Vector2(textureRect.max_.x_, textureRect.min_.y_);
+
+        vertex0.color_ = vertex1.color_ = vertex2.color_ = vertex3.color_ = color;
+
+        ea::vector<Vertex2D>& vertices = sourceBatches_[tile.batchIndex_].vertices_;
+        vertices.push_back(vertex0);
+        vertices.push_back(vertex1);
+        vertices.push_back(vertex2);
+        vertices.push_back(vertex3);
+    }
+
+    sourceBatchesDirty_ = false;
+}
+
+TileMapChunk2D::ChunkTile* TileMapChunk2D::GetChunkTile(int x, int y)
+{
+    if (x < 0 || x >= size_.x_ || y < 0 || y >= size_.y_)
+        return nullptr;
+
+    return &tiles_[y * size_.x_ + x];
+}
+
+void TileMapChunk2D::UpdateMaterial(ChunkTile& tile)
+{
+    tile.batchIndex_ = M_MAX_UNSIGNED;
+    if (!tile.sprite_ || !renderer_)
+        return;
+
+    Material* material = renderer_->GetMaterial(tile.sprite_->GetTexture(), BLEND_ALPHA);
+    for (unsigned i = 0; i < sourceBatches_.size(); ++i)
+    {
+        if (sourceBatches_[i].material_ == material)
+        {
+            tile.batchIndex_ = i;
+            return;
+        }
+    }
+
+    tile.batchIndex_ = sourceBatches_.size();
+    SourceBatch2D& sourceBatch = sourceBatches_.emplace_back();
+    sourceBatch.owner_ = this;
+    sourceBatch.drawOrder_ = GetDrawOrder();
+    sourceBatch.material_ = material;
+}
+
+void TileMapChunk2D::MarkTilesDirty()
+{
+    sourceBatchesDirty_ = true;
+    worldBoundingBoxDirty_ = true;
+}
+
+}
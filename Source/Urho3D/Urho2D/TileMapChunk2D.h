@@ -0,0 +1,101 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+
+#pragma once
+
+#include "../Urho2D/Drawable2D.h"
+
+namespace Urho3D
+{
+
+class Sprite2D;
+
+/// Drawable of a rectangular block of tiles in a tile map layer. All tiles of the chunk share one node and are culled and batched together.
+class URHO3D_API TileMapChunk2D : public Drawable2D
+{
+    URHO3D_OBJECT(TileMapChunk2D, Drawable2D);
+
+public:
+    /// Construct.
+    explicit TileMapChunk2D(Context* context);
+    /// Destruct.
+    ~TileMapChunk2D() override;
+    /// Register object factory.
+    /// @nobind
+    static void RegisterObject(Context* context);
+
+    /// Set number of tiles in the chunk and clear all tiles.
+    void SetSize(const IntVector2& size);
+    /// Set tile by chunk-local tile index. Position is the node-local position of the tile.
+    void SetTile(int x, int y, Sprite2D* sprite, const Vector2& position, bool flipX = false, bool flipY = false,
+        bool swapXY = false);
+    /// Set sprite of a tile, keeping its position and flipping. Null sprite hides the tile.
+    void SetTileSprite(int x, int y, Sprite2D* sprite);
+
+    /// Return number of tiles in the chunk.
+    const IntVector2& GetSize() const { return size_; }
+    /// Return sprite of a tile.
+    Sprite2D* GetTileSprite(int x, int y) const;
+
+protected:
+    /// Handle scene being assigned.
+    void OnSceneSet(Scene* scene) override;
+    /// Recalculate the world-space bounding box.
+    void OnWorldBoundingBoxUpdate() override;
+    /// Handle draw order changed.
+    void OnDrawOrderChanged() override;
+    /// Update source batches.
+    void UpdateSourceBatches() override;
+
+private:
+    /// Tile of the chunk.
+    struct ChunkTile
+    {
+        /// Sprite.
+        SharedPtr<Sprite2D> sprite_;
+        /// Index of the source batch holding the tile, or M_MAX_UNSIGNED if not drawn.
+        unsigned batchIndex_{M_MAX_UNSIGNED};
+        /// Node-local position.
+        Vector2 position_;
+        /// Flip X.
+        bool flipX_{};
+        /// Flip Y.
+        bool flipY_{};
+        /// Swap X and Y.
+        bool swapXY_{};
+    };
+
+    /// Return tile by chunk-local tile index, or null if out of range.
+    ChunkTile* GetChunkTile(int x, int y);
+    /// Assign a tile to the source batch of its material. Done on the main thread, as vertices may be updated from worker threads.
+    void UpdateMaterial(ChunkTile& tile);
+    /// Mark the vertices of the chunk dirty.
+    void MarkTilesDirty();
+
+    /// Number of tiles in the chunk.
+    IntVector2 size_;
+    /// Tiles in row-major order.
+    ea::vector<ChunkTile> tiles_;
+};
+
+}
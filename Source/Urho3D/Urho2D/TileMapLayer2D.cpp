@@ -28,6 +28,7 @@
 #include "../Scene/Node.h"
 #include "../Urho2D/StaticSprite2D.h"
 #include "../Urho2D/TileMap2D.h"
+#include "../Urho2D/TileMapChunk2D.h"
 #include "../Urho2D/TileMapLayer2D.h"
 #include "../Urho2D/TmxFile2D.h"
 
@@ -36,6 +37,9 @@
 namespace Urho3D
 {
 
+/// Width and height of tile layer chunks in tiles.
+static const int TILE_CHUNK_SIZE = 32;
+
 TileMapLayer2D::TileMapLayer2D(Context* context) :
     Component(context)
 {
@@ -181,6 +185,8 @@ void TileMapLayer2D::Initialize(TileMap2D* tileMap, const TmxLayer2D* tmxLayer)
         }
 
         nodes_.clear();
+        chunks_.clear();
+        numChunksX_ = 0;
     }
 
     tileLayer_ = nullptr;
@@ -226,9 +232,9 @@ void TileMapLayer2D::SetDrawOrder(int drawOrder)
         if (!nodes_[i])
             continue;
 
-        auto* staticSprite = nodes_[i]->GetComponent<StaticSprite2D>();
-        if (staticSprite)
-            staticSprite->SetLayer(drawOrder_);
+        auto* drawable = nodes_[i]->GetDerivedComponent<Drawable2D>();
+        if (drawable)
+            drawable->SetLayer(drawOrder_);
     }
 }
 
@@ -289,15 +295,35 @@ Tile2D* TileMapLayer2D::GetTile(int x, int y) const
     return tileLayer_->GetTile(x, y);
 }
 
-Node* TileMapLayer2D::GetTileNode(int x, int y) const
+void TileMapLayer2D::SetTileSprite(int x, int y, Sprite2D* sprite)
 {
-    if (!tileLayer_)
-        return nullptr;
+    if (!tileLayer_ || x < 0 || x >= tileLayer_->GetWidth() || y < 0 || y >= tileLayer_->GetHeight())
+        return;
+
+    TileMapChunk2D* chunk = chunks_[(y / TILE_CHUNK_SIZE) * numChunksX_ + x / TILE_CHUNK_SIZE];
+    if (!chunk)
+        return;
+
+    const Tile2D* tile = tileLayer_->GetTile(x, y);
+    const int localX = x % TILE_CHUNK_SIZE;
+    const int localY = y % TILE_CHUNK_SIZE;
+    if (sprite && !chunk->GetTileSprite(localX, localY))
+    {
+        // The tile was empty or hidden, so its placement must be set up again
+        chunk->SetTile(localX, localY, sprite, tileMap_->GetInfo().TileIndexToPosition(x, y),
+            tile && tile->GetFlipX(), tile && tile->GetFlipY(), tile && tile->GetSwapXY());
+    }
+    else
+        chunk->SetTileSprite(localX, localY, sprite);
+}
 
-    if (x < 0 || x >= tileLayer_->GetWidth() || y < 0 || y >= tileLayer_->GetHeight())
+Sprite2D* TileMapLayer2D::GetTileSprite(int x, int y) const
+{
+    if (!tileLayer_ || x < 0 || x >= tileLayer_->GetWidth() || y < 0 || y >= tileLayer_->GetHeight())
         return nullptr;
 
-    return nodes_[y * tileLayer_->GetWidth() + x];
+    TileMapChunk2D* chunk = chunks_[(y / TILE_CHUNK_SIZE) * numChunksX_ + x / TILE_CHUNK_SIZE];
+    return chunk ? chunk->GetTileSprite(x % TILE_CHUNK_SIZE, y % TILE_CHUNK_SIZE) : nullptr;
 }
 
 unsigned TileMapLayer2D::GetNumObjects() const
@@ -341,27 +367,42 @@ void TileMapLayer2D::SetTileLayer(const TmxTileLayer2D* tileLayer)
 
     int width = tileLayer->GetWidth();
     int height = tileLayer->GetHeight();
-    nodes_.resize((unsigned) (width * height));
+    numChunksX_ = (width + TILE_CHUNK_SIZE - 1) / TILE_CHUNK_SIZE;
+    const int numChunksY = (height + TILE_CHUNK_SIZE - 1) / TILE_CHUNK_SIZE;
+    nodes_.resize((unsigned)(numChunksX_ * numChunksY));
+    chunks_.resize((unsigned)(numChunksX_ * numChunksY));
 
+    // Tiles are grouped into chunks that are culled and batched as a whole, instead of using a node per tile
     const TileMapInfo2D& info = tileMap_->GetInfo();
-    for (int y = 0; y < height; ++y)
+    for (int chunkY = 0; chunkY < numChunksY; ++chunkY)
     {
-        for (int x = 0; x < width; ++x)
+        for (int chunkX = 0; chunkX < numChunksX_; ++chunkX)
         {
-            const Tile2D* tile = tileLayer->GetTile(x, y);
-            if (!tile)
-                continue;
+            const int startX = chunkX * TILE_CHUNK_SIZE;
+            const int startY = chunkY * TILE_CHUNK_SIZE;
+            const IntVector2 chunkSize(Min(TILE_CHUNK_SIZE, width - startX), Min(TILE_CHUNK_SIZE, height - startY));
 
-            SharedPtr<Node> tileNode(GetNode()->CreateTemporaryChild("Tile"));
-            tileNode->SetPosition(Vector3(info.TileIndexToPosition(x, y)));
+            SharedPtr<Node> chunkNode(GetNode()->CreateTemporaryChild("TileChunk"));
+            auto* chunk = chunkNode->CreateComponent<TileMapChunk2D>();
+            chunk->SetSize(chunkSize);
+            chunk->SetLayer(drawOrder_);
+            chunk->SetOrderInLayer(chunkY * numChunksX_ + chunkX);
 
-            auto* staticSprite = tileNode->CreateComponent<StaticSprite2D>();
-            staticSprite->SetSprite(tile->GetSprite());
-            staticSprite->SetFlip(tile->GetFlipX(), tile->GetFlipY(), tile->GetSwapXY());
-            staticSprite->SetLayer(drawOrder_);
-            staticSprite->SetOrderInLayer(y * width + x);
+            for (int y = 0; y < chunkSize.y_; ++y)
+            {
+                for (int x = 0; x < chunkSize.x_; ++x)
+                {
+                    const Tile2D* tile = tileLayer->GetTile(startX + x, startY + y);
+                    if (!tile)
+                        continue;
+
+                    chunk->SetTile(x, y, tile->GetSprite(), info.TileIndexToPosition(startX + x, startY + y),
+                        tile->GetFlipX(), tile->GetFlipY(), tile->GetSwapXY());
+                }
+            }
 
-            nodes_[y * width + x] = tileNode;
+            nodes_[chunkY * numChunksX_ + chunkX] = chunkNode;
+            chunks_[chunkY * numChunksX_ + chunkX] = chunk;
         }
     }
 }
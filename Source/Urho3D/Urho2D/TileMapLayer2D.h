@@ -34,7 +34,9 @@ namespace Urho3D
 
 class DebugRenderer;
 class Node;
+class Sprite2D;
 class TileMap2D;
+class TileMapChunk2D;
 class TmxImageLayer2D;
 class TmxLayer2D;
 class TmxObjectGroup2D;
@@ -94,10 +96,12 @@ public:
     /// Return height (for tile layer only).
     /// @property
     int GetHeight() const;
-    /// Return tile node (for tile layer only).
-    Node* GetTileNode(int x, int y) const;
     /// Return tile (for tile layer only).
     Tile2D* GetTile(int x, int y) const;
+    /// Set displayed sprite of a tile, overriding the sprite of the tmx tile. Null sprite hides the tile (for tile layer only).
+    void SetTileSprite(int x, int y, Sprite2D* sprite);
+    /// Return displayed sprite of a tile (for tile layer only).
+    Sprite2D* GetTileSprite(int x, int y) const;
 
     /// Return number of tile map objects (for object group only).
     /// @property
@@ -133,8 +137,12 @@ private:
     int drawOrder_{};
     /// Visible.
     bool visible_{true};
-    /// Tile node or image nodes.
+    /// Tile chunk, object or image nodes.
     ea::vector<SharedPtr<Node> > nodes_;
+    /// Tile chunks in row-major order (for tile layer only).
+    ea::vector<WeakPtr<TileMapChunk2D> > chunks_;
+    /// Number of tile chunks per row.
+    int numChunksX_{};
 };
 
 }
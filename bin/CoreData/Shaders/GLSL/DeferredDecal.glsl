@@ -0,0 +1,53 @@
+#include "Uniforms.glsl"
+#include "Samplers.glsl"
+#include "Transform.glsl"
+#include "ScreenPos.glsl"
+
+varying vec4 vScreenPos;
+varying vec3 vFarRay;
+varying vec4 vDecalAxisX;
+varying vec4 vDecalAxisY;
+varying vec4 vDecalAxisZ;
+
+#ifdef COMPILEVS
+vec4 GetDecalAxis(vec3 axis, vec3 origin)
+{
+    // Decal volume is a unit cube, so projection onto its scaled axes gives the position inside the volume
+    axis /= dot(axis, axis);
+    return vec4(axis, -dot(axis, origin));
+}
+#endif
+
+void VS()
+{
+    mat4 modelMatrix = iModelMatrix;
+    vec3 worldPos = GetWorldPos(modelMatrix);
+    gl_Position = GetClipPos(worldPos);
+    vScreenPos = GetScreenPos(gl_Position);
+    vFarRay = GetFarRay(gl_Position) * gl_Position.w;
+
+    vec3 origin = vec3(modelMatrix[0][3], modelMatrix[1][3], modelMatrix[2][3]);
+    vDecalAxisX = GetDecalAxis(vec3(modelMatrix[0][0], modelMatrix[1][0], modelMatrix[2][0]), origin);
+    vDecalAxisY = GetDecalAxis(vec3(modelMatrix[0][1], modelMatrix[1][1], modelMatrix[2][1]), origin);
+    vDecalAxisZ = GetDecalAxis(vec3(modelMatrix[0][2], modelMatrix[1][2], modelMatrix[2][2]), origin);
+}
+
+void PS()
+{
+    float depth = DecodeDepth(texture2DProj(sDepthBuffer, vScreenPos).rgb);
+    vec4 projWorldPos = vec4(vFarRay * depth / vScreenPos.w + cCameraPosPS, 1.0);
+    vec3 decalPos = vec3(dot(vDecalAxisX, projWorldPos), dot(vDecalAxisY, projWorldPos), dot(vDecalAxisZ, projWorldPos));
+
+    // Discard the scene outside of the decal volume
+    if (any(greaterThan(abs(decalPos), vec3(0.5))))
+        discard;
+
+    vec4 diffColor = cMatDiffColor;
+    #ifdef DIFFMAP
+        diffColor *= texture2D(sDiffMap, vec2(decalPos.x + 0.5, 0.5 - decalPos.y));
+    #endif
+
+    // Ambient light was already applied to the viewport by the G-buffer pass, so blend it in for the decal too
+    gl_FragData[0] = vec4(diffColor.rgb * cAmbientColor.rgb, diffColor.a);
+    gl_FragData[1] = diffColor;
+}
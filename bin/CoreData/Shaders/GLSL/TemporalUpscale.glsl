@@ -0,0 +1,58 @@
+#include "Uniforms.glsl"
+#include "Samplers.glsl"
+#include "Transform.glsl"
+#include "ScreenPos.glsl"
+
+#ifdef COMPILEPS
+uniform vec2 cJitterOffset;
+uniform vec2 cSourceInvSize;
+uniform float cTemporalBlend;
+#ifdef REPROJECT
+uniform mat4 cReprojection;
+#endif
+#endif
+
+varying vec2 vScreenPos;
+
+void VS()
+{
+    mat4 modelMatrix = iModelMatrix;
+    vec3 worldPos = GetWorldPos(modelMatrix);
+    gl_Position = GetClipPos(worldPos);
+    vScreenPos = GetScreenPosPreDiv(gl_Position);
+}
+
+void PS()
+{
+    // Sample the scaled down current frame with the camera jitter removed
+    vec2 sourcePos = vScreenPos + cJitterOffset;
+    vec3 current = texture2D(sDiffMap, sourcePos).rgb;
+
+    // Limit the history to the color range of the current neighborhood to reject stale samples
+    vec3 minColor = current;
+    vec3 maxColor = current;
+    for (int y = -1; y <= 1; ++y)
+    {
+        for (int x = -1; x <= 1; ++x)
+        {
+            vec3 neighbor = texture2D(sDiffMap, sourcePos + vec2(float(x), float(y)) * cSourceInvSize).rgb;
+            minColor = min(minColor, neighbor);
+            maxColor = max(maxColor, neighbor);
+        }
+    }
+
+    vec2 historyPos = vScreenPos;
+    #ifdef REPROJECT
+        // Reproject by camera motion using the hardware depth of the current frame
+        float depth = texture2D(sDepthBuffer, sourcePos).r;
+        vec4 prevClipPos = vec4(vScreenPos * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0) * cReprojection;
+        historyPos = prevClipPos.xy / prevClipPos.w * 0.5 + 0.5;
+    #endif
+
+    float blend = cTemporalBlend;
+    if (historyPos.x < 0.0 || historyPos.y < 0.0 || historyPos.x > 1.0 || historyPos.y > 1.0)
+        blend = 1.0;
+
+    vec3 history = clamp(texture2D(sNormalMap, historyPos).rgb, minColor, maxColor);
+    gl_FragColor = vec4(mix(history, current, blend), 1.0);
+}
@@ -0,0 +1,61 @@
+#include "Uniforms.hlsl"
+#include "Samplers.hlsl"
+#include "Transform.hlsl"
+#include "ScreenPos.hlsl"
+
+#ifdef COMPILEVS
+float4 GetDecalAxis(float3 axis, float3 origin)
+{
+    // Decal volume is a unit cube, so projection onto its scaled axes gives the position inside the volume
+    axis /= dot(axis, axis);
+    return float4(axis, -dot(axis, origin));
+}
+#endif
+
+void VS(float4 iPos : POSITION,
+    #ifdef INSTANCED
+        float4x3 iModelInstance : TEXCOORD4,
+    #endif
+    out float4 oScreenPos : TEXCOORD0,
+    out float3 oFarRay : TEXCOORD1,
+    out float4 oDecalAxisX : TEXCOORD2,
+    out float4 oDecalAxisY : TEXCOORD3,
+    out float4 oDecalAxisZ : TEXCOORD4,
+    out float4 oPos : OUTPOSITION)
+{
+    float4x3 modelMatrix = iModelMatrix;
+    float3 worldPos = GetWorldPos(modelMatrix);
+    oPos = GetClipPos(worldPos);
+    oScreenPos = GetScreenPos(oPos);
+    oFarRay = GetFarRay(oPos) * oPos.w;
+
+    float3 origin = modelMatrix[3];
+    oDecalAxisX = GetDecalAxis(modelMatrix[0], origin);
+    oDecalAxisY = GetDecalAxis(modelMatrix[1], origin);
+    oDecalAxisZ = GetDecalAxis(modelMatrix[2], origin);
+}
+
+void PS(float4 iScreenPos : TEXCOORD0,
+    float3 iFarRay : TEXCOORD1,
+    float4 iDecalAxisX : TEXCOORD2,
+    float4 iDecalAxisY : TEXCOORD3,
+    float4 iDecalAxisZ : TEXCOORD4,
+    out float4 oColor : OUTCOLOR0,
+    out float4 oAlbedo : OUTCOLOR1)
+{
+    float depth = Sample2DProj(DepthBuffer, iScreenPos).r;
+    float4 projWorldPos = float4(iFarRay * depth / iScreenPos.w + cCameraPosPS, 1.0);
+    float3 decalPos = float3(dot(iDecalAxisX, projWorldPos), dot(iDecalAxisY, projWorldPos), dot(iDecalAxisZ, projWorldPos));
+
+    // Discard the scene outside of the decal volume
+    clip(0.5 - abs(decalPos));
+
+    float4 diffColor = cMatDiffColor;
+    #ifdef DIFFMAP
+        diffColor *= Sample2D(DiffMap, float2(decalPos.x + 0.5, 0.5 - decalPos.y));
+    #endif
+
+    // Ambient light was already applied to the viewport by the G-buffer pass, so blend it in for the decal too
+    oColor = float4(diffColor.rgb * cAmbientColor.rgb, diffColor.a);
+    oAlbedo = diffColor;
+}
@@ -0,0 +1,77 @@
+#include "Uniforms.hlsl"
+#include "Samplers.hlsl"
+#include "Transform.hlsl"
+#include "ScreenPos.hlsl"
+
+#ifndef D3D11
+
+// D3D9 uniforms
+uniform float2 cJitterOffset;
+uniform float2 cSourceInvSize;
+uniform float cTemporalBlend;
+#ifdef REPROJECT
+uniform float4x4 cReprojection;
+#endif
+
+#else
+
+#ifdef COMPILEPS
+// D3D11 constant buffers
+cbuffer CustomPS : register(b6)
+{
+    float2 cJitterOffset;
+    float2 cSourceInvSize;
+    float cTemporalBlend;
+#ifdef REPROJECT
+    float4x4 cReprojection;
+#endif
+}
+#endif
+
+#endif
+
+void VS(float4 iPos : POSITION,
+    out float2 oScreenPos : TEXCOORD0,
+    out float4 oPos : OUTPOSITION)
+{
+    float4x3 modelMatrix = iModelMatrix;
+    float3 worldPos = GetWorldPos(modelMatrix);
+    oPos = GetClipPos(worldPos);
+    oScreenPos = GetScreenPosPreDiv(oPos);
+}
+
+void PS(float2 iScreenPos : TEXCOORD0,
+    out float4 oColor : OUTCOLOR0)
+{
+    // Sample the scaled down current frame with the camera jitter removed
+    float2 sourcePos = iScreenPos + cJitterOffset;
+    float3 current = Sample2D(DiffMap, sourcePos).rgb;
+
+    // Limit the history to the color range of the current neighborhood to reject stale samples
+    float3 minColor = current;
+    float3 maxColor = current;
+    for (int y = -1; y <= 1; ++y)
+    {
+        for (int x = -1; x <= 1; ++x)
+        {
+            float3 neighbor = Sample2D(DiffMap, sourcePos + float2(x, y) * cSourceInvSize).rgb;
+            minColor = min(minColor, neighbor);
+            maxColor = max(maxColor, neighbor);
+        }
+    }
+
+    float2 historyPos = iScreenPos;
+    #ifdef REPROJECT
+        // Reproject by camera motion using the hardware depth of the current frame
+        float depth = Sample2D(DepthBuffer, sourcePos).r;
+        float4 prevClipPos = mul(float4(iScreenPos.x * 2.0 - 1.0, 1.0 - iScreenPos.y * 2.0, depth, 1.0), cReprojection);
+        historyPos = float2(prevClipPos.x / prevClipPos.w * 0.5 + 0.5, 0.5 - prevClipPos.y / prevClipPos.w * 0.5);
+    #endif
+
+    float blend = cTemporalBlend;
+    if (historyPos.x < 0.0 || historyPos.y < 0.0 || historyPos.x > 1.0 || historyPos.y > 1.0)
+        blend = 1.0;
+
+    float3 history = clamp(Sample2D(NormalMap, historyPos).rgb, minColor, maxColor);
+    oColor = float4(lerp(history, current, blend), 1.0);
+}